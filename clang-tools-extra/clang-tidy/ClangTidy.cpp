@@ -44,9 +44,13 @@
 #include "clang/Tooling/Refactoring.h"
 #include "clang/Tooling/ReplacementsYaml.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/ThreadPool.h"
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <utility>
 
 using namespace clang::ast_matchers;
@@ -562,6 +566,144 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
   return DiagConsumer.take();
 }
 
+namespace {
+// Gives a thread of a parallel run a working directory of its own on top of
+// the file system shared by all threads, which only sees absolute paths. Each
+// compilation sets the working directory to the one of its command.
+class WorkingDirectoryFileSystem : public llvm::vfs::ProxyFileSystem {
+public:
+  WorkingDirectoryFileSystem(IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS,
+                             std::string WorkingDirectory)
+      : ProxyFileSystem(std::move(FS)),
+        WorkingDirectory(std::move(WorkingDirectory)) {}
+
+  llvm::ErrorOr<llvm::vfs::Status> status(const Twine &Path) override {
+    SmallString<256> Absolute;
+    if (std::error_code EC = getAbsolutePath(Path, Absolute))
+      return EC;
+    auto Result = ProxyFileSystem::status(Absolute);
+    if (!Result)
+      return Result;
+    return llvm::vfs::Status::copyWithNewName(*Result, Path);
+  }
+  llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>>
+  openFileForRead(const Twine &Path) override {
+    SmallString<256> Absolute;
+    if (std::error_code EC = getAbsolutePath(Path, Absolute))
+      return EC;
+    return ProxyFileSystem::openFileForRead(Absolute);
+  }
+  llvm::vfs::directory_iterator dir_begin(const Twine &Dir,
+                                          std::error_code &EC) override {
+    SmallString<256> Absolute;
+    if ((EC = getAbsolutePath(Dir, Absolute)))
+      return {};
+    return ProxyFileSystem::dir_begin(Absolute, EC);
+  }
+  llvm::ErrorOr<std::string> getCurrentWorkingDirectory() const override {
+    return WorkingDirectory;
+  }
+  std::error_code setCurrentWorkingDirectory(const Twine &Path) override {
+    SmallString<256> Absolute;
+    if (std::error_code EC = getAbsolutePath(Path, Absolute))
+      return EC;
+    auto Result = ProxyFileSystem::status(Absolute);
+    if (!Result)
+      return Result.getError();
+    if (!Result->isDirectory())
+      return std::make_error_code(std::errc::not_a_directory);
+    WorkingDirectory = Absolute.str();
+    return {};
+  }
+  std::error_code getRealPath(const Twine &Path,
+                              SmallVectorImpl<char> &Output) const override {
+    SmallString<256> Absolute;
+    if (std::error_code EC = getAbsolutePath(Path, Absolute))
+      return EC;
+    return ProxyFileSystem::getRealPath(Absolute, Output);
+  }
+  std::error_code isLocal(const Twine &Path, bool &Result) override {
+    SmallString<256> Absolute;
+    if (std::error_code EC = getAbsolutePath(Path, Absolute))
+      return EC;
+    return ProxyFileSystem::isLocal(Absolute, Result);
+  }
+
+private:
+  std::error_code getAbsolutePath(const Twine &Path,
+                                  SmallVectorImpl<char> &Absolute) const {
+    Path.toVector(Absolute);
+    if (std::error_code EC = makeAbsolute(Absolute))
+      return EC;
+    llvm::sys::path::remove_dots(Absolute);
+    return {};
+  }
+
+  std::string WorkingDirectory;
+};
+} // namespace
+
+std::vector<ClangTidyError> runClangTidyParallel(
+    ClangTidyContext &Context, const CompilationDatabase &Compilations,
+    ArrayRef<std::string> InputFiles, unsigned Jobs,
+    llvm::function_ref<ClangTidyWorkerSetup(
+        llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> RootFS)>
+        CreateWorker,
+    bool EnableCheckProfile, llvm::StringRef StoreCheckProfile) {
+  struct Worker {
+    IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS;
+    std::unique_ptr<ClangTidyContext> Context;
+    std::vector<ClangTidyError> Errors;
+  };
+  Jobs = std::max(1u, std::min<unsigned>(Jobs, InputFiles.size()));
+  // Every translation unit looks up most headers, often in many include
+  // directories, so the threads share the results of these lookups.
+  IntrusiveRefCntPtr<llvm::vfs::FileSystem> SharedFS =
+      new llvm::vfs::CachingFileSystem(
+          llvm::vfs::createPhysicalFileSystem().release());
+  llvm::ErrorOr<std::string> InitialWorkingDir =
+      SharedFS->getCurrentWorkingDirectory();
+  if (!InitialWorkingDir)
+    llvm::report_fatal_error("Cannot get current working path.");
+  std::vector<Worker> Workers(Jobs);
+  for (Worker &W : Workers) {
+    ClangTidyWorkerSetup Setup = CreateWorker(
+        new WorkingDirectoryFileSystem(SharedFS, *InitialWorkingDir));
+    assert(Setup.BaseFS && Setup.OptionsProvider);
+    W.BaseFS = std::move(Setup.BaseFS);
+    W.Context = llvm::make_unique<ClangTidyContext>(
+        std::move(Setup.OptionsProvider),
+        Context.canEnableAnalyzerAlphaCheckers());
+  }
+
+  std::atomic<size_t> NextFile(0);
+  {
+    llvm::ThreadPool Pool(Jobs);
+    for (Worker &W : Workers)
+      Pool.async([&, Current = &W] {
+        for (size_t I; (I = NextFile++) < InputFiles.size();) {
+          std::vector<ClangTidyError> Errors =
+              runClangTidy(*Current->Context, Compilations, InputFiles[I],
+                           Current->BaseFS, EnableCheckProfile,
+                           StoreCheckProfile);
+          Current->Errors.insert(Current->Errors.end(),
+                                 std::make_move_iterator(Errors.begin()),
+                                 std::make_move_iterator(Errors.end()));
+        }
+      });
+    Pool.wait();
+  }
+
+  std::vector<ClangTidyError> Errors;
+  for (Worker &W : Workers) {
+    Context.addStats(W.Context->getStats());
+    Errors.insert(Errors.end(), std::make_move_iterator(W.Errors.begin()),
+                  std::make_move_iterator(W.Errors.end()));
+  }
+  removeDuplicatedErrors(Errors);
+  return Errors;
+}
+
 void handleErrors(llvm::ArrayRef<ClangTidyError> Errors,
                   ClangTidyContext &Context, bool Fix,
                   unsigned &WarningsAsErrorsCount,
@@ -79,6 +79,34 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
              bool EnableCheckProfile = false,
              llvm::StringRef StoreCheckProfile = StringRef());
 
+/// \brief The file system and options of one thread of runClangTidyParallel().
+///
+/// Threads can't share them: options providers are not thread-safe, and each
+/// compilation sets the working directory of the file system.
+struct ClangTidyWorkerSetup {
+  llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS;
+  std::unique_ptr<ClangTidyOptionsProvider> OptionsProvider;
+};
+
+/// \brief Runs the checks like runClangTidy(), on \p Jobs threads of this
+/// process.
+///
+/// \p CreateWorker is called once for each thread, before any file is
+/// processed, and must build its file system on top of the given one. The
+/// threads share a cache of file status, so the include directories are only
+/// searched once for each header. The files are processed in order, by the
+/// next idle thread. Diagnostics in headers included by several files are
+/// reported once, and the statistics of all threads are added to \p Context.
+std::vector<ClangTidyError> runClangTidyParallel(
+    ClangTidyContext &Context,
+    const tooling::CompilationDatabase &Compilations,
+    ArrayRef<std::string> InputFiles, unsigned Jobs,
+    llvm::function_ref<ClangTidyWorkerSetup(
+        llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> RootFS)>
+        CreateWorker,
+    bool EnableCheckProfile = false,
+    llvm::StringRef StoreCheckProfile = StringRef());
+
 // FIXME: This interface will need to be significantly extended to be useful.
 // FIXME: Implement confidence levels for displaying/fixing errors.
 //
@@ -684,12 +684,16 @@ struct EqualClangTidyError {
 };
 } // end anonymous namespace
 
-std::vector<ClangTidyError> ClangTidyDiagnosticConsumer::take() {
-  finalizeLastError();
-
+void removeDuplicatedErrors(std::vector<ClangTidyError> &Errors) {
   std::sort(Errors.begin(), Errors.end(), LessClangTidyError());
   Errors.erase(std::unique(Errors.begin(), Errors.end(), EqualClangTidyError()),
                Errors.end());
+}
+
+std::vector<ClangTidyError> ClangTidyDiagnosticConsumer::take() {
+  finalizeLastError();
+
+  removeDuplicatedErrors(Errors);
   if (RemoveIncompatibleErrors)
     removeIncompatibleErrors();
   return std::move(Errors);
@@ -85,6 +85,15 @@ struct ClangTidyStats {
     return ErrorsIgnoredNOLINT + ErrorsIgnoredCheckFilter +
            ErrorsIgnoredNonUserCode + ErrorsIgnoredLineFilter;
   }
+
+  ClangTidyStats &operator+=(const ClangTidyStats &Other) {
+    ErrorsDisplayed += Other.ErrorsDisplayed;
+    ErrorsIgnoredCheckFilter += Other.ErrorsIgnoredCheckFilter;
+    ErrorsIgnoredNOLINT += Other.ErrorsIgnoredNOLINT;
+    ErrorsIgnoredNonUserCode += Other.ErrorsIgnoredNonUserCode;
+    ErrorsIgnoredLineFilter += Other.ErrorsIgnoredLineFilter;
+    return *this;
+  }
 };
 
 /// \brief Every \c ClangTidyCheck reports errors through a \c DiagnosticsEngine
@@ -165,6 +174,10 @@ public:
   /// counters.
   const ClangTidyStats &getStats() const { return Stats; }
 
+  /// \brief Adds the counters of another context, e.g. one which processed
+  /// other files in parallel.
+  void addStats(const ClangTidyStats &Other) { Stats += Other; }
+
   /// \brief Control profile collection in clang-tidy.
   void setEnableProfiling(bool Profile);
   bool getEnableProfiling() const { return Profile; }
@@ -234,6 +247,10 @@ bool ShouldSuppressDiagnostic(DiagnosticsEngine::Level DiagLevel,
                               const Diagnostic &Info, ClangTidyContext &Context,
                               bool CheckMacroExpansion = true);
 
+/// \brief Sorts \p Errors and removes duplicates, such as the diagnostics in a
+/// header which several translation units include.
+void removeDuplicatedErrors(std::vector<ClangTidyError> &Errors);
+
 /// \brief A diagnostic consumer that turns each \c Diagnostic into a
 /// \c SourceManager-independent \c ClangTidyError.
 //
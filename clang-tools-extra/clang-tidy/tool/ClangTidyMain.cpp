@@ -20,6 +20,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 
 using namespace clang::ast_matchers;
 using namespace clang::driver;
@@ -223,6 +224,14 @@ over the real file system.
                                        cl::value_desc("filename"),
                                        cl::cat(ClangTidyCategory));
 
+static cl::opt<unsigned> Jobs("j", cl::desc(R"(
+Number of files to process in parallel, on threads
+of this process. 0 uses all hardware threads.
+Diagnostics in headers are reported once, however
+many of the files include them.
+)"),
+                              cl::init(1), cl::cat(ClangTidyCategory));
+
 namespace clang {
 namespace tidy {
 
@@ -325,20 +334,29 @@ getVfsFromFile(const std::string &OverlayFile,
   return FS;
 }
 
-static int clangTidyMain(int argc, const char **argv) {
-  llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
-  CommonOptionsParser OptionsParser(argc, argv, ClangTidyCategory,
-                                    cl::ZeroOrMore);
+static llvm::IntrusiveRefCntPtr<vfs::OverlayFileSystem>
+createBaseFS(llvm::IntrusiveRefCntPtr<vfs::FileSystem> RootFS) {
   llvm::IntrusiveRefCntPtr<vfs::OverlayFileSystem> BaseFS(
-      new vfs::OverlayFileSystem(vfs::getRealFileSystem()));
+      new vfs::OverlayFileSystem(std::move(RootFS)));
 
   if (!VfsOverlay.empty()) {
     IntrusiveRefCntPtr<vfs::FileSystem> VfsFromFile =
         getVfsFromFile(VfsOverlay, BaseFS);
     if (!VfsFromFile)
-      return 1;
+      return nullptr;
     BaseFS->pushOverlay(VfsFromFile);
   }
+  return BaseFS;
+}
+
+static int clangTidyMain(int argc, const char **argv) {
+  llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
+  CommonOptionsParser OptionsParser(argc, argv, ClangTidyCategory,
+                                    cl::ZeroOrMore);
+  llvm::IntrusiveRefCntPtr<vfs::OverlayFileSystem> BaseFS =
+      createBaseFS(vfs::getRealFileSystem());
+  if (!BaseFS)
+    return 1;
 
   auto OwningOptionsProvider = createOptionsProvider(BaseFS);
   auto *OptionsProvider = OwningOptionsProvider.get();
@@ -426,9 +444,24 @@ static int clangTidyMain(int argc, const char **argv) {
 
   ClangTidyContext Context(std::move(OwningOptionsProvider),
                            AllowEnablingAnalyzerAlphaCheckers);
-  std::vector<ClangTidyError> Errors =
-      runClangTidy(Context, OptionsParser.getCompilations(), PathList, BaseFS,
-                   EnableCheckProfile, ProfilePrefix);
+  unsigned Threads = Jobs ? Jobs : llvm::hardware_concurrency();
+  std::vector<ClangTidyError> Errors;
+  if (Threads > 1 && PathList.size() > 1) {
+    // The files have been read once already, so creating the file systems
+    // and options providers of the threads can't fail.
+    Errors = runClangTidyParallel(
+        Context, OptionsParser.getCompilations(), PathList, Threads,
+        [](llvm::IntrusiveRefCntPtr<vfs::FileSystem> RootFS) {
+          ClangTidyWorkerSetup Setup;
+          Setup.BaseFS = createBaseFS(std::move(RootFS));
+          Setup.OptionsProvider = createOptionsProvider(Setup.BaseFS);
+          return Setup;
+        },
+        EnableCheckProfile, ProfilePrefix);
+  } else {
+    Errors = runClangTidy(Context, OptionsParser.getCompilations(), PathList,
+                          BaseFS, EnableCheckProfile, ProfilePrefix);
+  }
   bool FoundErrors = llvm::find_if(Errors, [](const ClangTidyError &E) {
                        return E.DiagLevel == ClangTidyError::Error;
                      }) != Errors.end();
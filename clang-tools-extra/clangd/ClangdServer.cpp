@@ -111,8 +111,10 @@ ClangdServer::ClangdServer(const GlobalCompilationDatabase &CDB,
       this->Index = Idx;
     }
   };
-  if (Opts.StaticIndex)
+  if (Opts.StaticIndex) {
+    StaticIdx = Opts.StaticIndex;
     AddIndex(Opts.StaticIndex);
+  }
   if (Opts.BackgroundIndex) {
     BackgroundIdx = llvm::make_unique<BackgroundIndex>(
         Context::current().clone(), FSProvider, CDB,
@@ -142,6 +144,8 @@ void ClangdServer::addDocument(PathRef File, llvm::StringRef Contents,
   Inputs.Opts = std::move(Opts);
   Inputs.Index = Index;
   WorkScheduler.update(File, Inputs, WantDiags);
+  if (BackgroundIdx)
+    BackgroundIdx->boostRelated(File);
 }
 
 void ClangdServer::removeDocument(PathRef File) { WorkScheduler.remove(File); }
@@ -545,6 +549,17 @@ ClangdServer::getUsedBytesPerFile() const {
   return WorkScheduler.getUsedBytesPerFile();
 }
 
+void ClangdServer::profile(MemoryTree &MT) const {
+  WorkScheduler.profile(MT.child("tuscheduler"));
+  MemoryTree &IndexMT = MT.child("index");
+  if (DynamicIdx)
+    IndexMT.child("dynamic").Self = DynamicIdx->estimateMemoryUsage();
+  if (BackgroundIdx)
+    IndexMT.child("background").Self = BackgroundIdx->estimateMemoryUsage();
+  if (StaticIdx)
+    IndexMT.child("static").Self = StaticIdx->estimateMemoryUsage();
+}
+
 LLVM_NODISCARD bool
 ClangdServer::blockUntilIdleForTest(llvm::Optional<double> TimeoutSeconds) {
   return WorkScheduler.blockUntilIdle(timeoutSeconds(TimeoutSeconds)) &&
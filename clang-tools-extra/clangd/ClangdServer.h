@@ -253,9 +253,14 @@ public:
   /// here, as this metric does not account (at least) for:
   ///   - memory occupied by static and dynamic index,
   ///   - memory required for in-flight requests,
-  /// FIXME: those metrics might be useful too, we should add them.
+  /// See profile() for the former.
   std::vector<std::pair<Path, std::size_t>> getUsedBytesPerFile() const;
 
+  /// Adds the estimated memory usage of the open files' ASTs and preambles,
+  /// and of the indexes, to \p MT. The memory required for in-flight requests
+  /// is not accounted for.
+  void profile(MemoryTree &MT) const;
+
   // Blocks the main thread until the server is idle. Only for use in tests.
   // Returns false if the timeout expires.
   LLVM_NODISCARD bool
@@ -277,6 +282,8 @@ private:
   //   - the static index passed to the constructor
   //   - a merged view of a static and dynamic index (MergedIndex)
   const SymbolIndex *Index = nullptr;
+  // If present, the index passed to the constructor. Read via *Index.
+  const SymbolIndex *StaticIdx = nullptr;
   // If present, an index of symbols in open files. Read via *Index.
   std::unique_ptr<FileIndex> DynamicIdx;
   // If present, the new "auto-index" maintained in background threads.
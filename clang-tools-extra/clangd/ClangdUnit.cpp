@@ -40,6 +40,9 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <memory>
@@ -292,7 +295,7 @@ ParsedAST::build(std::unique_ptr<CompilerInvocation> CI,
   // to leak memory in clangd.
   CI->getFrontendOpts().DisableFree = false;
   const PrecompiledPreamble *PreamblePCH =
-      Preamble ? &Preamble->Preamble : nullptr;
+      Preamble ? Preamble->Preamble.get() : nullptr;
 
   StoreDiags ASTDiags;
   std::string Content = Buffer->getBuffer();
@@ -527,7 +530,7 @@ const CanonicalIncludes &ParsedAST::getCanonicalIncludes() const {
   return CanonIncludes;
 }
 
-PreambleData::PreambleData(PrecompiledPreamble Preamble,
+PreambleData::PreambleData(std::shared_ptr<const PrecompiledPreamble> Preamble,
                            std::vector<Diag> Diags, IncludeStructure Includes,
                            std::vector<std::string> MainFileMacros,
                            std::unique_ptr<PreambleFileStatusCache> StatCache,
@@ -565,8 +568,8 @@ buildPreamble(PathRef FileName, CompilerInvocation &CI,
 
   if (OldPreamble &&
       compileCommandsAreEqual(Inputs.CompileCommand, OldCompileCommand) &&
-      OldPreamble->Preamble.CanReuse(CI, ContentsBuffer.get(), Bounds,
-                                     Inputs.FS.get())) {
+      OldPreamble->Preamble->CanReuse(CI, ContentsBuffer.get(), Bounds,
+                                      Inputs.FS.get())) {
     vlog("Reusing preamble for file {0}", llvm::Twine(FileName));
     return OldPreamble;
   }
@@ -612,17 +615,85 @@ buildPreamble(PathRef FileName, CompilerInvocation &CI,
     vlog("Built preamble of size {0} for file {1}", BuiltPreamble->getSize(),
          FileName);
     std::vector<Diag> Diags = PreambleDiagnostics.take();
-    return std::make_shared<PreambleData>(
-        std::move(*BuiltPreamble), std::move(Diags),
-        SerializedDeclsCollector.takeIncludes(),
+    auto Result = std::make_shared<PreambleData>(
+        std::make_shared<PrecompiledPreamble>(std::move(*BuiltPreamble)),
+        std::move(Diags), SerializedDeclsCollector.takeIncludes(),
         SerializedDeclsCollector.takeMainFileMacros(), std::move(StatCache),
         SerializedDeclsCollector.takeCanonicalIncludes());
+    Result->MainFileName = CI.getFrontendOpts().Inputs.front().getFile();
+    return Result;
   } else {
     elog("Could not build a preamble for file {0}", FileName);
     return nullptr;
   }
 }
 
+std::string sharedPreambleKey(PathRef FileName, const CompilerInvocation &CI,
+                              const ParseInputs &Inputs) {
+  auto ContentsBuffer = llvm::MemoryBuffer::getMemBuffer(Inputs.Contents);
+  auto Bounds =
+      ComputePreambleBounds(*CI.getLangOpts(), ContentsBuffer.get(), 0);
+  if (Bounds.Size == 0)
+    return "";
+  // Quoted includes are looked up next to the main file first.
+  llvm::SmallString<128> AbsFileName(FileName);
+  Inputs.FS->makeAbsolute(AbsFileName);
+  llvm::SHA1 Hasher;
+  auto Add = [&](llvm::StringRef Data) {
+    Hasher.update(Data);
+    Hasher.update(llvm::StringRef("\0", 1));
+  };
+  Add(Inputs.Contents.substr(0, Bounds.Size));
+  Add(Bounds.PreambleEndsAtStartOfLine ? "1" : "0");
+  Add(llvm::sys::path::parent_path(AbsFileName));
+  Add(Inputs.CompileCommand.Directory);
+  // Leave out the arguments that only name the file and its outputs.
+  const auto &Args = Inputs.CompileCommand.CommandLine;
+  for (size_t I = 0; I < Args.size(); ++I) {
+    llvm::StringRef Arg = Args[I];
+    if (Arg == Inputs.CompileCommand.Filename || Arg == FileName)
+      continue;
+    if (Arg == "-o" || Arg == "-MF" || Arg == "-MT" || Arg == "-MQ") {
+      ++I;
+      continue;
+    }
+    if (Arg.startswith("-o"))
+      continue;
+    Add(Arg);
+  }
+  return llvm::toHex(Hasher.final());
+}
+
+std::shared_ptr<const PreambleData>
+sharePreamble(PathRef FileName, const CompilerInvocation &CI,
+              const ParseInputs &Inputs, const PreambleData &Shared) {
+  // Entities declared in the preamble region of the main file, and the
+  // diagnostics there, have locations in the file the preamble was built for.
+  if (!Shared.Diags.empty() || !Shared.MainFileMacros.empty())
+    return nullptr;
+  auto ContentsBuffer = llvm::MemoryBuffer::getMemBuffer(Inputs.Contents);
+  auto Bounds =
+      ComputePreambleBounds(*CI.getLangOpts(), ContentsBuffer.get(), 0);
+  if (!Shared.Preamble->CanReuse(CI, ContentsBuffer.get(), Bounds,
+                                 Inputs.FS.get()))
+    return nullptr;
+  vlog("Reusing preamble of {0} for file {1}", Shared.MainFileName,
+       llvm::Twine(FileName));
+
+  llvm::SmallString<32> AbsFileName(FileName);
+  Inputs.FS->makeAbsolute(AbsFileName);
+  std::string MainFileName = CI.getFrontendOpts().Inputs.front().getFile();
+  IncludeStructure Includes = Shared.Includes;
+  Includes.reroot(Shared.MainFileName, MainFileName);
+  auto Result = std::make_shared<PreambleData>(
+      Shared.Preamble, std::vector<Diag>(), std::move(Includes),
+      std::vector<std::string>(),
+      llvm::make_unique<PreambleFileStatusCache>(AbsFileName),
+      Shared.CanonIncludes);
+  Result->MainFileName = std::move(MainFileName);
+  return Result;
+}
+
 llvm::Optional<ParsedAST>
 buildAST(PathRef FileName, std::unique_ptr<CompilerInvocation> Invocation,
          const ParseInputs &Inputs,
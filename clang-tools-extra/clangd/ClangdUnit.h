@@ -46,14 +46,18 @@ namespace clangd {
 
 // Stores Preamble and associated data.
 struct PreambleData {
-  PreambleData(PrecompiledPreamble Preamble, std::vector<Diag> Diags,
-               IncludeStructure Includes,
+  PreambleData(std::shared_ptr<const PrecompiledPreamble> Preamble,
+               std::vector<Diag> Diags, IncludeStructure Includes,
                std::vector<std::string> MainFileMacros,
                std::unique_ptr<PreambleFileStatusCache> StatCache,
                CanonicalIncludes CanonIncludes);
 
   tooling::CompileCommand CompileCommand;
-  PrecompiledPreamble Preamble;
+  // Shared with the data of other files using the same preamble, see
+  // sharePreamble().
+  std::shared_ptr<const PrecompiledPreamble> Preamble;
+  // Clang's name for the main file the preamble is used with.
+  std::string MainFileName;
   std::vector<Diag> Diags;
   // Processes like code completions and go-to-definitions will need #include
   // information, and their compile action skips preamble range.
@@ -152,6 +156,22 @@ buildPreamble(PathRef FileName, CompilerInvocation &CI,
               const ParseInputs &Inputs, bool StoreInMemory,
               PreambleParsedCallback PreambleCallback);
 
+/// Returns a key for the preamble of \p Inputs. Files with equal keys have the
+/// same preamble contents and are compiled in the same directory with the same
+/// flags, so one of them can use the preamble built for another, see
+/// sharePreamble(). Returns an empty string if the file has no preamble.
+std::string sharedPreambleKey(PathRef FileName, const CompilerInvocation &CI,
+                              const ParseInputs &Inputs);
+
+/// Returns the preamble data of \p FileName if it can use the preamble in
+/// \p Shared, built for another file with the same sharedPreambleKey().
+/// The result owns the PCH together with \p Shared. Returns null if the
+/// preamble is out of date, or if it declares something in the main file
+/// which would be attributed to the other file.
+std::shared_ptr<const PreambleData>
+sharePreamble(PathRef FileName, const CompilerInvocation &CI,
+              const ParseInputs &Inputs, const PreambleData &Shared);
+
 /// Build an AST from provided user inputs. This function does not check if
 /// preamble can be reused, as this function expects that \p Preamble is the
 /// result of calling buildPreamble.
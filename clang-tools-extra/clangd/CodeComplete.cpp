@@ -201,6 +201,7 @@ struct CompletionCandidate {
   const Symbol *IndexResult = nullptr;
   const RawIdentifier *IdentifierResult = nullptr;
   llvm::SmallVector<llvm::StringRef, 1> RankedIncludeHeaders;
+  float NameMatch = 0; // Fuzzy match score of Name against the filter.
 
   // Returns a token identifying the overload set this is part of.
   // 0 indicates it's not part of any overload set.
@@ -1088,7 +1089,7 @@ bool semaCodeComplete(std::unique_ptr<CodeCompleteConsumer> Consumer,
   IgnoreDiagnostics DummyDiagsConsumer;
   auto Clang = prepareCompilerInstance(
       std::move(CI),
-      (Input.Preamble && !CompletingInPreamble) ? &Input.Preamble->Preamble
+      (Input.Preamble && !CompletingInPreamble) ? Input.Preamble->Preamble.get()
                                                 : nullptr,
       std::move(ContentsBuffer), std::move(VFS), DummyDiagsConsumer);
   Clang->getPreprocessorOpts().SingleFileParseMode = CompletingInPreamble;
@@ -1522,13 +1523,22 @@ private:
       C.IdentifierResult = IdentifierResult;
       if (C.IndexResult) {
         C.Name = IndexResult->Name;
-        C.RankedIncludeHeaders = getRankedIncludes(*C.IndexResult);
       } else if (C.SemaResult) {
         C.Name = Recorder->getName(*SemaResult);
       } else {
         assert(IdentifierResult);
         C.Name = IdentifierResult->Name;
       }
+      // Completing in a large scope yields many candidates, most of which
+      // don't match the filter. Drop those before working out their includes
+      // and overload sets. The candidates of a bundle share a name, so this is
+      // the same as dropping the bundles that don't match.
+      auto NameMatch = fuzzyScore(C);
+      if (!NameMatch)
+        return;
+      C.NameMatch = *NameMatch;
+      if (C.IndexResult)
+        C.RankedIncludeHeaders = getRankedIncludes(*C.IndexResult);
       if (auto OverloadSet = C.overloadSet(Opts)) {
         auto Ret = BundleLookup.try_emplace(OverloadSet, Bundles.size());
         if (Ret.second)
@@ -1597,10 +1607,7 @@ private:
     Relevance.ContextWords = &ContextWords;
 
     auto &First = Bundle.front();
-    if (auto FuzzyScore = fuzzyScore(First))
-      Relevance.NameMatch = *FuzzyScore;
-    else
-      return;
+    Relevance.NameMatch = First.NameMatch;
     SymbolOrigin Origin = SymbolOrigin::Unknown;
     bool FromIndex = false;
     for (const auto &Candidate : Bundle) {
@@ -124,6 +124,15 @@ void IncludeStructure::recordInclude(llvm::StringRef IncludingName,
   IncludeChildren[Parent].push_back(Child);
 }
 
+void IncludeStructure::reroot(llvm::StringRef From, llvm::StringRef To) {
+  auto It = NameToIndex.find(From);
+  if (From == To || It == NameToIndex.end() || NameToIndex.count(To))
+    return;
+  unsigned Index = It->getValue();
+  NameToIndex.erase(It);
+  NameToIndex[To] = Index;
+}
+
 unsigned IncludeStructure::fileIndex(llvm::StringRef Name) {
   auto R = NameToIndex.try_emplace(Name, RealPathNames.size());
   if (R.second)
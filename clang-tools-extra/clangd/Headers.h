@@ -99,6 +99,10 @@ public:
                      llvm::StringRef IncludedName,
                      llvm::StringRef IncludedRealName);
 
+  // Makes the files included by \p From appear to be included by \p To, for
+  // using the include structure of a preamble with another main file.
+  void reroot(llvm::StringRef From, llvm::StringRef To);
+
 private:
   // Identifying files in a way that persists from preamble build to subsequent
   // builds is surprisingly hard. FileID is unavailable in InclusionDirective(),
@@ -531,6 +531,21 @@ llvm::raw_ostream &operator<<(llvm::raw_ostream &O,
   return O;
 }
 
+std::size_t MemoryTree::total() const {
+  std::size_t Total = Self;
+  for (const auto &C : Children)
+    Total += C.second.total();
+  return Total;
+}
+
+llvm::json::Value toJSON(const MemoryTree &MT) {
+  llvm::json::Object Result{{"_self", int64_t(MT.Self)},
+                            {"_total", int64_t(MT.total())}};
+  for (const auto &C : MT.Children)
+    Result[C.first] = toJSON(C.second);
+  return llvm::json::Value(std::move(Result));
+}
+
 bool operator==(const SymbolDetails &LHS, const SymbolDetails &RHS) {
   return LHS.name == RHS.name && LHS.containerName == RHS.containerName &&
          LHS.USR == RHS.USR && LHS.ID == RHS.ID;
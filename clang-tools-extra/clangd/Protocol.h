@@ -30,6 +30,7 @@
 #include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
 #include <bitset>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -815,6 +816,20 @@ llvm::json::Value toJSON(const SymbolDetails &);
 llvm::raw_ostream &operator<<(llvm::raw_ostream &, const SymbolDetails &);
 bool operator==(const SymbolDetails &, const SymbolDetails &);
 
+/// Estimated memory usage of a component of clangd, broken down into its parts.
+/// This is returned from $/memoryUsage, which is a clangd extension.
+struct MemoryTree {
+  /// Bytes used by the component itself, excluding its children.
+  std::size_t Self = 0;
+  std::map<std::string, MemoryTree> Children;
+
+  /// Returns the child called \p Name, adding it if needed.
+  MemoryTree &child(llvm::StringRef Name) { return Children[Name]; }
+  /// Bytes used by the component and all of its children.
+  std::size_t total() const;
+};
+llvm::json::Value toJSON(const MemoryTree &);
+
 /// The parameters of a Workspace Symbol Request.
 struct WorkspaceSymbolParams {
   /// A non-empty query string
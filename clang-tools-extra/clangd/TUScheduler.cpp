@@ -50,6 +50,7 @@
 #include "index/CanonicalIncludes.h"
 #include "clang/Frontend/CompilerInvocation.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/Support/Errc.h"
@@ -58,6 +59,7 @@
 #include <memory>
 #include <queue>
 #include <thread>
+#include <tuple>
 
 namespace clang {
 namespace clangd {
@@ -76,40 +78,49 @@ llvm::Optional<llvm::StringRef> TUScheduler::getFileBeingProcessedInContext() {
 }
 
 /// An LRU cache of idle ASTs.
-/// Because we want to limit the overall number of these we retain, the cache
-/// owns ASTs (and may evict them) while their workers are idle.
+/// Because we want to limit the overall number and size of these we retain,
+/// the cache owns ASTs (and may evict them) while their workers are idle.
 /// Workers borrow ASTs when active, and return them when done.
 class TUScheduler::ASTCache {
 public:
   using Key = const ASTWorker *;
 
-  ASTCache(unsigned MaxRetainedASTs) : MaxRetainedASTs(MaxRetainedASTs) {}
+  ASTCache(unsigned MaxRetainedASTs, std::size_t MaxRetainedBytes)
+      : MaxRetainedASTs(MaxRetainedASTs), MaxRetainedBytes(MaxRetainedBytes) {}
 
   /// Returns result of getUsedBytes() for the AST cached by \p K.
   /// If no AST is cached, 0 is returned.
   std::size_t getUsedBytes(Key K) {
     std::lock_guard<std::mutex> Lock(Mut);
     auto It = findByKey(K);
-    if (It == LRU.end() || !It->second)
+    if (It == LRU.end())
       return 0;
-    return It->second->getUsedBytes();
+    return It->Bytes;
   }
 
-  /// Store the value in the pool, possibly removing the last used AST.
-  /// The value should not be in the pool when this function is called.
+  /// Store the value in the pool, possibly removing the least recently used
+  /// ASTs. The value should not be in the pool when this function is called.
   void put(Key K, std::unique_ptr<ParsedAST> V) {
     std::unique_lock<std::mutex> Lock(Mut);
     assert(findByKey(K) == LRU.end());
 
-    LRU.insert(LRU.begin(), {K, std::move(V)});
-    if (LRU.size() <= MaxRetainedASTs)
-      return;
-    // We're past the limit, remove the last element.
-    std::unique_ptr<ParsedAST> ForCleanup = std::move(LRU.back().second);
-    LRU.pop_back();
-    // Run the expensive destructor outside the lock.
+    // ASTs don't change while they are idle, so their size is computed once.
+    std::size_t Bytes = V ? V->getUsedBytes() : 0;
+    LRU.insert(LRU.begin(), {K, std::move(V), Bytes});
+    RetainedBytes += Bytes;
+    // Remove the last elements while we're past the limits. The AST that was
+    // just stored is kept, even if it doesn't fit on its own.
+    std::vector<std::unique_ptr<ParsedAST>> ForCleanup;
+    while (LRU.size() > 1 &&
+           (LRU.size() > MaxRetainedASTs ||
+            (MaxRetainedBytes && RetainedBytes > MaxRetainedBytes))) {
+      RetainedBytes -= LRU.back().Bytes;
+      ForCleanup.push_back(std::move(LRU.back().AST));
+      LRU.pop_back();
+    }
+    // Run the expensive destructors outside the lock.
     Lock.unlock();
-    ForCleanup.reset();
+    ForCleanup.clear();
   }
 
   /// Returns the cached value for \p K, or llvm::None if the value is not in
@@ -120,7 +131,8 @@ public:
     auto Existing = findByKey(K);
     if (Existing == LRU.end())
       return None;
-    std::unique_ptr<ParsedAST> V = std::move(Existing->second);
+    std::unique_ptr<ParsedAST> V = std::move(Existing->AST);
+    RetainedBytes -= Existing->Bytes;
     LRU.erase(Existing);
     // GCC 4.8 fails to compile `return V;`, as it tries to call the copy
     // constructor of unique_ptr, so we call the move ctor explicitly to avoid
@@ -129,17 +141,104 @@ public:
   }
 
 private:
-  using KVPair = std::pair<Key, std::unique_ptr<ParsedAST>>;
+  struct Entry {
+    Key K;
+    std::unique_ptr<ParsedAST> AST;
+    std::size_t Bytes; // Result of getUsedBytes() for AST.
+  };
 
-  std::vector<KVPair>::iterator findByKey(Key K) {
-    return llvm::find_if(LRU, [K](const KVPair &P) { return P.first == K; });
+  std::vector<Entry>::iterator findByKey(Key K) {
+    return llvm::find_if(LRU, [K](const Entry &E) { return E.K == K; });
   }
 
   std::mutex Mut;
   unsigned MaxRetainedASTs;
+  std::size_t MaxRetainedBytes; // 0 means no limit.
   /// Items sorted in LRU order, i.e. first item is the most recently accessed
   /// one.
-  std::vector<KVPair> LRU; /* GUARDED_BY(Mut) */
+  std::vector<Entry> LRU;        /* GUARDED_BY(Mut) */
+  std::size_t RetainedBytes = 0; /* GUARDED_BY(Mut) */
+};
+
+/// Preambles by their sharedPreambleKey(), so that files which start with the
+/// same includes and are compiled with the same flags use a single preamble.
+/// A preamble can be found while any file uses it. In addition, the cache owns
+/// the most recently stored preambles up to a total size, so that they outlive
+/// the files that built them for a while.
+class TUScheduler::PreambleCache {
+public:
+  PreambleCache(std::size_t MaxRetainedBytes)
+      : MaxRetainedBytes(MaxRetainedBytes) {}
+
+  /// Returns the preamble stored for \p Key, or null.
+  std::shared_ptr<const PreambleData> get(llvm::StringRef Key) {
+    std::lock_guard<std::mutex> Lock(Mut);
+    auto It = Preambles.find(Key);
+    if (It == Preambles.end())
+      return nullptr;
+    auto Preamble = It->second.lock();
+    if (!Preamble)
+      Preambles.erase(It);
+    return Preamble;
+  }
+
+  /// Stores \p V for \p Key, replacing the previous preamble if any. Possibly
+  /// drops the least recently stored preambles to stay within the size limit.
+  void put(llvm::StringRef Key, std::shared_ptr<const PreambleData> V) {
+    std::unique_lock<std::mutex> Lock(Mut);
+    Preambles[Key] = V;
+    // Forget the preambles that nobody uses anymore.
+    for (auto It = Preambles.begin(); It != Preambles.end();) {
+      auto Next = std::next(It);
+      if (It->second.expired())
+        Preambles.erase(It);
+      It = Next;
+    }
+
+    std::vector<std::shared_ptr<const PreambleData>> ForCleanup;
+    auto Existing = llvm::find_if(
+        LRU, [&](const Entry &E) { return std::get<0>(E) == Key; });
+    if (Existing != LRU.end()) {
+      RetainedBytes -= std::get<1>(*Existing);
+      ForCleanup.push_back(std::move(std::get<2>(*Existing)));
+      LRU.erase(Existing);
+    }
+    std::size_t Size = V->Preamble->getSize();
+    LRU.insert(LRU.begin(), Entry(Key, Size, std::move(V)));
+    RetainedBytes += Size;
+    while (RetainedBytes > MaxRetainedBytes && !LRU.empty()) {
+      RetainedBytes -= std::get<1>(LRU.back());
+      ForCleanup.push_back(std::move(std::get<2>(LRU.back())));
+      LRU.pop_back();
+    }
+    // Run the expensive destructors outside the lock.
+    Lock.unlock();
+    ForCleanup.clear();
+  }
+
+  /// Returns the total size of the retained preambles, except for those in
+  /// \p Excluded.
+  std::size_t getRetainedBytes(
+      const llvm::DenseSet<const PrecompiledPreamble *> &Excluded) {
+    std::lock_guard<std::mutex> Lock(Mut);
+    std::size_t Result = 0;
+    for (const Entry &E : LRU)
+      if (!Excluded.count(std::get<2>(E)->Preamble.get()))
+        Result += std::get<1>(E);
+    return Result;
+  }
+
+private:
+  using Entry =
+      std::tuple<std::string, std::size_t, std::shared_ptr<const PreambleData>>;
+
+  std::mutex Mut;
+  const std::size_t MaxRetainedBytes;
+  /* GUARDED_BY(Mut) */
+  llvm::StringMap<std::weak_ptr<const PreambleData>> Preambles;
+  /// Retained preambles with their sizes, the most recently stored first.
+  std::vector<Entry> LRU;        /* GUARDED_BY(Mut) */
+  std::size_t RetainedBytes = 0; /* GUARDED_BY(Mut) */
 };
 
 namespace {
@@ -158,9 +257,10 @@ class ASTWorkerHandle;
 class ASTWorker {
   friend class ASTWorkerHandle;
   ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
-            TUScheduler::ASTCache &LRUCache, Semaphore &Barrier, bool RunSync,
-            steady_clock::duration UpdateDebounce, bool StorePreamblesInMemory,
-            ParsingCallbacks &Callbacks);
+            TUScheduler::ASTCache &LRUCache,
+            TUScheduler::PreambleCache &SharedPreambles, Semaphore &Barrier,
+            bool RunSync, steady_clock::duration UpdateDebounce,
+            bool StorePreamblesInMemory, ParsingCallbacks &Callbacks);
 
 public:
   /// Create a new ASTWorker and return a handle to it.
@@ -170,7 +270,8 @@ public:
   /// request, it is used to limit the number of actively running threads.
   static ASTWorkerHandle
   create(PathRef FileName, const GlobalCompilationDatabase &CDB,
-         TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
+         TUScheduler::ASTCache &IdleASTs,
+         TUScheduler::PreambleCache &SharedPreambles, AsyncTaskRunner *Tasks,
          Semaphore &Barrier, steady_clock::duration UpdateDebounce,
          bool StorePreamblesInMemory, ParsingCallbacks &Callbacks);
   ~ASTWorker();
@@ -197,6 +298,8 @@ public:
   void waitForFirstPreamble() const;
 
   std::size_t getUsedBytes() const;
+  /// Returns the size of the idle AST, 0 if none is cached.
+  std::size_t getASTBytes() const;
   bool isASTCached() const;
 
 private:
@@ -235,6 +338,8 @@ private:
 
   /// Handles retention of ASTs.
   TUScheduler::ASTCache &IdleASTs;
+  /// Preambles that can be used by several files.
+  TUScheduler::PreambleCache &SharedPreambles;
   const bool RunSync;
   /// Time to wait after an update to see whether another update obsoletes it.
   const steady_clock::duration UpdateDebounce;
@@ -320,12 +425,14 @@ private:
 
 ASTWorkerHandle
 ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
-                  TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
-                  Semaphore &Barrier, steady_clock::duration UpdateDebounce,
+                  TUScheduler::ASTCache &IdleASTs,
+                  TUScheduler::PreambleCache &SharedPreambles,
+                  AsyncTaskRunner *Tasks, Semaphore &Barrier,
+                  steady_clock::duration UpdateDebounce,
                   bool StorePreamblesInMemory, ParsingCallbacks &Callbacks) {
-  std::shared_ptr<ASTWorker> Worker(
-      new ASTWorker(FileName, CDB, IdleASTs, Barrier, /*RunSync=*/!Tasks,
-                    UpdateDebounce, StorePreamblesInMemory, Callbacks));
+  std::shared_ptr<ASTWorker> Worker(new ASTWorker(
+      FileName, CDB, IdleASTs, SharedPreambles, Barrier, /*RunSync=*/!Tasks,
+      UpdateDebounce, StorePreamblesInMemory, Callbacks));
   if (Tasks)
     Tasks->runAsync("worker:" + llvm::sys::path::filename(FileName),
                     [Worker]() { Worker->run(); });
@@ -334,10 +441,13 @@ ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
 }
 
 ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
-                     TUScheduler::ASTCache &LRUCache, Semaphore &Barrier,
-                     bool RunSync, steady_clock::duration UpdateDebounce,
+                     TUScheduler::ASTCache &LRUCache,
+                     TUScheduler::PreambleCache &SharedPreambles,
+                     Semaphore &Barrier, bool RunSync,
+                     steady_clock::duration UpdateDebounce,
                      bool StorePreamblesInMemory, ParsingCallbacks &Callbacks)
-    : IdleASTs(LRUCache), RunSync(RunSync), UpdateDebounce(UpdateDebounce),
+    : IdleASTs(LRUCache), SharedPreambles(SharedPreambles), RunSync(RunSync),
+      UpdateDebounce(UpdateDebounce),
       FileName(FileName), CDB(CDB),
       StorePreambleInMemory(StorePreamblesInMemory),
       Callbacks(Callbacks), Status{TUAction(TUAction::Idle, ""),
@@ -410,13 +520,27 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
 
     std::shared_ptr<const PreambleData> OldPreamble =
         getPossiblyStalePreamble();
-    std::shared_ptr<const PreambleData> NewPreamble = buildPreamble(
-        FileName, *Invocation, OldPreamble, OldCommand, Inputs,
-        StorePreambleInMemory,
-        [this](ASTContext &Ctx, std::shared_ptr<clang::Preprocessor> PP,
-               const CanonicalIncludes &CanonIncludes) {
-          Callbacks.onPreambleAST(FileName, Ctx, std::move(PP), CanonIncludes);
-        });
+    std::string PreambleKey = sharedPreambleKey(FileName, *Invocation, Inputs);
+    std::shared_ptr<const PreambleData> NewPreamble;
+    // Prefer a preamble built by another file over building one. There is no
+    // AST to run the preamble callback on then, the symbols from the headers
+    // were indexed when the other file built it.
+    if (!PreambleKey.empty()) {
+      auto Shared = SharedPreambles.get(PreambleKey);
+      if (Shared && !(OldPreamble && OldPreamble->Preamble == Shared->Preamble))
+        NewPreamble = sharePreamble(FileName, *Invocation, Inputs, *Shared);
+    }
+    if (!NewPreamble)
+      NewPreamble = buildPreamble(
+          FileName, *Invocation, OldPreamble, OldCommand, Inputs,
+          StorePreambleInMemory,
+          [this](ASTContext &Ctx, std::shared_ptr<clang::Preprocessor> PP,
+                 const CanonicalIncludes &CanonIncludes) {
+            Callbacks.onPreambleAST(FileName, Ctx, std::move(PP),
+                                    CanonIncludes);
+          });
+    if (NewPreamble && NewPreamble != OldPreamble && !PreambleKey.empty())
+      SharedPreambles.put(PreambleKey, NewPreamble);
 
     bool CanReuseAST = InputsAreTheSame && (OldPreamble == NewPreamble);
     {
@@ -580,13 +704,17 @@ tooling::CompileCommand ASTWorker::getCurrentCompileCommand() const {
   return FileInputs->CompileCommand;
 }
 
+std::size_t ASTWorker::getASTBytes() const {
+  return IdleASTs.getUsedBytes(this);
+}
+
 std::size_t ASTWorker::getUsedBytes() const {
   // Note that we don't report the size of ASTs currently used for processing
   // the in-flight requests. We used this information for debugging purposes
   // only, so this should be fine.
   std::size_t Result = IdleASTs.getUsedBytes(this);
   if (auto Preamble = getPossiblyStalePreamble())
-    Result += Preamble->Preamble.getSize();
+    Result += Preamble->Preamble->getSize();
   return Result;
 }
 
@@ -831,7 +959,11 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
       Callbacks(Callbacks ? move(Callbacks)
                           : llvm::make_unique<ParsingCallbacks>()),
       Barrier(AsyncThreadsCount),
-      IdleASTs(llvm::make_unique<ASTCache>(RetentionPolicy.MaxRetainedASTs)),
+      IdleASTs(llvm::make_unique<ASTCache>(
+          RetentionPolicy.MaxRetainedASTs,
+          RetentionPolicy.MaxRetainedASTBytes)),
+      SharedPreambles(llvm::make_unique<PreambleCache>(
+          RetentionPolicy.MaxRetainedPreambleBytes)),
       UpdateDebounce(UpdateDebounce) {
   if (0 < AsyncThreadsCount) {
     PreambleTasks.emplace();
@@ -866,7 +998,7 @@ void TUScheduler::update(PathRef File, ParseInputs Inputs,
   if (!FD) {
     // Create a new worker to process the AST-related tasks.
     ASTWorkerHandle Worker = ASTWorker::create(
-        File, CDB, *IdleASTs,
+        File, CDB, *IdleASTs, *SharedPreambles,
         WorkerThreads ? WorkerThreads.getPointer() : nullptr, Barrier,
         UpdateDebounce, StorePreamblesInMemory, *Callbacks);
     FD = std::unique_ptr<FileData>(
@@ -983,6 +1115,20 @@ TUScheduler::getUsedBytesPerFile() const {
   return Result;
 }
 
+void TUScheduler::profile(MemoryTree &MT) const {
+  llvm::DenseSet<const PrecompiledPreamble *> SeenPreambles;
+  for (auto &&PathAndFile : Files) {
+    const ASTWorker &Worker = *PathAndFile.second->Worker;
+    MemoryTree &FileMT = MT.child(PathAndFile.first());
+    FileMT.child("ast").Self = Worker.getASTBytes();
+    if (auto Preamble = Worker.getPossiblyStalePreamble())
+      if (SeenPreambles.insert(Preamble->Preamble.get()).second)
+        FileMT.child("preamble").Self = Preamble->Preamble->getSize();
+  }
+  MT.child("retained_preambles").Self =
+      SharedPreambles->getRetainedBytes(SeenPreambles);
+}
+
 std::vector<Path> TUScheduler::getFilesWithCachedAST() const {
   std::vector<Path> Result;
   for (auto &&PathAndFile : Files) {
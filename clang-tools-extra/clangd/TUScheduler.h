@@ -54,6 +54,13 @@ struct ASTRetentionPolicy {
   /// Maximum number of ASTs to be retained in memory when there are no pending
   /// requests for them.
   unsigned MaxRetainedASTs = 3;
+  /// Maximum total size of the ASTs retained in memory, 0 means no limit. The
+  /// most recently used AST is retained even if it is larger on its own.
+  std::size_t MaxRetainedASTBytes = 0;
+  /// Maximum total size of the recently built preambles to be retained for
+  /// files with the same preamble, once the files that built them are closed
+  /// or have rebuilt them. See sharedPreambleKey().
+  std::size_t MaxRetainedPreambleBytes = 256 * 1024 * 1024;
 };
 
 struct TUAction {
@@ -142,6 +149,12 @@ public:
   /// contain files that currently run something over their AST.
   std::vector<Path> getFilesWithCachedAST() const;
 
+  /// Adds the memory used by the ASTs and preambles of the open files to
+  /// \p MT, keyed by file. A preamble shared by several files is counted for
+  /// one of them. The preambles kept for closed files are under
+  /// "retained_preambles".
+  void profile(MemoryTree &MT) const;
+
   /// Schedule an update for \p File. Adds \p File to a list of tracked files if
   /// \p File was not part of it before. The compile command in \p Inputs is
   /// ignored; worker queries CDB to get the actual compile command.
@@ -211,6 +224,7 @@ public:
   /// Responsible for retaining and rebuilding idle ASTs. An implementation is
   /// an LRU cache.
   class ASTCache;
+  class PreambleCache;
 
   // The file being built/processed in the current thread. This is a hack in
   // order to get the file name into the index implementations. Do not depend on
@@ -226,6 +240,7 @@ private:
   Semaphore Barrier;
   llvm::StringMap<std::unique_ptr<FileData>> Files;
   std::unique_ptr<ASTCache> IdleASTs;
+  std::unique_ptr<PreambleCache> SharedPreambles;
   // None when running tasks synchronously and non-None when running tasks
   // asynchronously.
   llvm::Optional<AsyncTaskRunner> PreambleTasks;
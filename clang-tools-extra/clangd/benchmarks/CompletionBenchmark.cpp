@@ -0,0 +1,90 @@
+//===--- CompletionBenchmark.cpp - Clangd completion benchmarks -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "../ClangdUnit.h"
+#include "../CodeComplete.h"
+#include "../Compiler.h"
+#include "../SourceCode.h"
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include <string>
+
+namespace clang {
+namespace clangd {
+namespace {
+
+const char *Directory = "/clangd-benchmark";
+const char *MainFile = "/clangd-benchmark/main.cpp";
+const char *HeaderFile = "/clangd-benchmark/big.h";
+
+// A header declaring many functions in one namespace, so that completing its
+// members produces a large number of candidates to score and rank.
+std::string buildHeader() {
+  const char *Stems[] = {"get", "set", "make", "find", "update", "remove"};
+  std::string Header = "namespace big {\n";
+  for (unsigned I = 0; I < 50000; ++I)
+    Header += "int " + std::string(Stems[I % 6]) + "Symbol" +
+              std::to_string(I) + "(int);\n";
+  Header += "}\n";
+  return Header;
+}
+
+std::string buildMainFile(llvm::StringRef Query) {
+  return ("#include \"big.h\"\nvoid f() { big::" + Query + " }\n").str();
+}
+
+struct CompletionFixture {
+  CompletionFixture() : FS(new llvm::vfs::InMemoryFileSystem) {
+    FS->addFile(HeaderFile, 0, llvm::MemoryBuffer::getMemBufferCopy(
+                                   buildHeader(), HeaderFile));
+    Inputs.CompileCommand.Directory = Directory;
+    Inputs.CompileCommand.Filename = MainFile;
+    Inputs.CompileCommand.CommandLine = {"clang", "-xc++", MainFile};
+    Inputs.FS = FS;
+    Inputs.Contents = buildMainFile("");
+    auto CI = buildCompilerInvocation(Inputs);
+    if (CI)
+      Preamble = buildPreamble(MainFile, *CI, /*OldPreamble=*/nullptr,
+                               /*OldCompileCommand=*/Inputs.CompileCommand,
+                               Inputs, /*StoreInMemory=*/true,
+                               /*PreambleCallback=*/nullptr);
+  }
+
+  IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> FS;
+  ParseInputs Inputs;
+  std::shared_ptr<const PreambleData> Preamble;
+};
+
+// Builds the preamble once and measures the end-to-end latency of completing
+// after "big::" + Query, including Sema, scoring and ranking.
+static void CodeCompletion(benchmark::State &State, llvm::StringRef Query) {
+  static CompletionFixture Fixture;
+  std::string Contents = buildMainFile(Query);
+  Position Pos = offsetToPosition(Contents, Contents.find(" }\n"));
+  CodeCompleteOptions Opts;
+  Opts.Limit = 100;
+  size_t Items = 0;
+  for (auto _ : State) {
+    auto Result =
+        codeComplete(MainFile, Fixture.Inputs.CompileCommand,
+                     Fixture.Preamble.get(), Contents, Pos, Fixture.FS, Opts);
+    Items = Result.Completions.size();
+    benchmark::DoNotOptimize(Result);
+  }
+  State.counters["Items"] = Items;
+}
+BENCHMARK_CAPTURE(CodeCompletion, AllSymbols, "");
+BENCHMARK_CAPTURE(CodeCompletion, Filtered, "gS12");
+
+} // namespace
+} // namespace clangd
+} // namespace clang
+
+BENCHMARK_MAIN();
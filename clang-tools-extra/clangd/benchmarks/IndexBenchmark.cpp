@@ -10,15 +10,17 @@
 #include "../index/dex/Dex.h"
 #include "benchmark/benchmark.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Regex.h"
 #include <fstream>
+#include <random>
 #include <streambuf>
 #include <string>
 
-const char *IndexFilename;
-const char *RequestsFilename;
+const char *IndexFilename = nullptr;
+const char *RequestsFilename = nullptr;
 
 namespace clang {
 namespace clangd {
@@ -66,6 +68,10 @@ std::vector<FuzzyFindRequest> extractQueriesFromLogs() {
 }
 
 static void MemQueries(benchmark::State &State) {
+  if (!IndexFilename) {
+    State.SkipWithError("no index and requests files given");
+    return;
+  }
   const auto Mem = buildMem();
   const auto Requests = extractQueriesFromLogs();
   for (auto _ : State)
@@ -75,6 +81,10 @@ static void MemQueries(benchmark::State &State) {
 BENCHMARK(MemQueries);
 
 static void DexQueries(benchmark::State &State) {
+  if (!IndexFilename) {
+    State.SkipWithError("no index and requests files given");
+    return;
+  }
   const auto Dex = buildDex();
   const auto Requests = extractQueriesFromLogs();
   for (auto _ : State)
@@ -83,6 +93,58 @@ static void DexQueries(benchmark::State &State) {
 }
 BENCHMARK(DexQueries);
 
+// Returns a Dex of a million symbols named after the words of a small
+// vocabulary, the way large code bases name them, so that the trigrams of
+// short queries have huge and dense posting lists.
+const SymbolIndex &syntheticDex() {
+  static std::unique_ptr<SymbolIndex> Index = [] {
+    const char *Words[] = {"get",    "set",    "is",     "make",    "create",
+                           "find",   "build",  "value",  "type",    "node",
+                           "decl",   "expr",   "stmt",   "context", "index",
+                           "symbol", "file",   "buffer", "range",   "location",
+                           "impl",   "info",   "list",   "map",     "kind"};
+    std::mt19937 Generator(42);
+    SymbolSlab::Builder Symbols;
+    for (unsigned I = 0; I < 1000000; ++I) {
+      std::string Name;
+      for (unsigned J = 0, E = 1 + Generator() % 4; J < E; ++J) {
+        std::string Word = Words[Generator() % llvm::array_lengthof(Words)];
+        if (J)
+          Word[0] = llvm::toUpper(Word[0]);
+        Name += Word;
+      }
+      std::string Scope = "ns" + std::to_string(Generator() % 100) + "::";
+      std::string File = "file:///src/dir" + std::to_string(Generator() % 50) +
+                         "/file" + std::to_string(Generator() % 1000) + ".h";
+      Symbol Sym;
+      Sym.ID = SymbolID(Scope + Name + std::to_string(I));
+      Sym.Name = Name;
+      Sym.Scope = Scope;
+      Sym.CanonicalDeclaration.FileURI = File.c_str();
+      Sym.References = Generator() % 1000;
+      Sym.Flags = Symbol::IndexedForCodeCompletion;
+      Symbols.insert(Sym);
+    }
+    return dex::Dex::build(std::move(Symbols).build(), RefSlab());
+  }();
+  return *Index;
+}
+
+static void DexSyntheticQueries(benchmark::State &State, const char *Query) {
+  const SymbolIndex &Index = syntheticDex();
+  FuzzyFindRequest Request;
+  Request.Query = Query;
+  Request.AnyScope = true;
+  Request.Limit = 100;
+  for (auto _ : State)
+    Index.fuzzyFind(Request, [](const Symbol &S) {});
+}
+BENCHMARK_CAPTURE(DexSyntheticQueries, OneLetter, "g");
+BENCHMARK_CAPTURE(DexSyntheticQueries, TwoLetters, "ge");
+BENCHMARK_CAPTURE(DexSyntheticQueries, Trigram, "get");
+BENCHMARK_CAPTURE(DexSyntheticQueries, Word, "symbol");
+BENCHMARK_CAPTURE(DexSyntheticQueries, Words, "getSymbolInfo");
+
 } // namespace
 } // namespace clangd
 } // namespace clang
@@ -92,19 +154,22 @@ BENCHMARK(DexQueries);
 // in-memory index size and reporting it as time.
 // FIXME(kbobyrev): Create a logger wrapper to suppress debugging info printer.
 int main(int argc, char *argv[]) {
-  if (argc < 3) {
+  // The index and requests files are optional, only the benchmarks of the
+  // synthetic index run without them.
+  if (argc >= 3 && argv[1][0] != '-' && argv[2][0] != '-') {
+    IndexFilename = argv[1];
+    RequestsFilename = argv[2];
+    // Trim first two arguments of the benchmark invocation and pretend no
+    // arguments were passed in the first place.
+    argv[2] = argv[0];
+    argv += 2;
+    argc -= 2;
+  } else if (argc >= 2 && argv[1][0] != '-') {
     llvm::errs() << "Usage: " << argv[0]
-                 << " global-symbol-index.yaml requests.json "
+                 << " [global-symbol-index.yaml requests.json] "
                     "BENCHMARK_OPTIONS...\n";
     return -1;
   }
-  IndexFilename = argv[1];
-  RequestsFilename = argv[2];
-  // Trim first two arguments of the benchmark invocation and pretend no
-  // arguments were passed in the first place.
-  argv[2] = argv[0];
-  argv += 2;
-  argc -= 2;
   ::benchmark::Initialize(&argc, argv);
   ::benchmark::RunSpecifiedBenchmarks();
 }
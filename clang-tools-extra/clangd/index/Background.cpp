@@ -28,6 +28,7 @@
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/Threading.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <memory>
@@ -43,6 +44,10 @@ namespace {
 
 static std::atomic<bool> PreventStarvation = {false};
 
+// After the user opens or edits a file, background priority tasks run on at
+// most ThrottledPoolSize threads for this long.
+constexpr std::chrono::seconds UserActivityWindow(5);
+
 // Resolves URI to file paths with cache.
 class URIToFileCache {
 public:
@@ -142,6 +147,7 @@ BackgroundIndex::BackgroundIndex(
       BuildIndexPeriodMs(BuildIndexPeriodMs),
       SymbolsUpdatedSinceLastIndex(false),
       IndexStorageFactory(std::move(IndexStorageFactory)),
+      ThrottledPoolSize(std::max<unsigned>(1, ThreadPoolSize / 2)),
       CommandsChanged(
           CDB.watch([&](const std::vector<std::string> &ChangedFiles) {
             enqueue(ChangedFiles);
@@ -178,30 +184,48 @@ void BackgroundIndex::run() {
   WithContext Background(BackgroundContext.clone());
   while (true) {
     llvm::Optional<Task> Task;
-    llvm::ThreadPriority Priority;
     {
       std::unique_lock<std::mutex> Lock(QueueMu);
-      QueueCV.wait(Lock, [&] { return ShouldStop || !Queue.empty(); });
-      if (ShouldStop) {
-        Queue.clear();
-        QueueCV.notify_all();
-        return;
+      while (true) {
+        if (ShouldStop) {
+          Queue.clear();
+          Pending.clear();
+          Deferred.clear();
+          QueueCV.notify_all();
+          return;
+        }
+        Deadline Retry = Deadline::infinity();
+        Task = popTaskLocked(Retry);
+        if (Task)
+          break;
+        wait(Lock, QueueCV, Retry);
       }
       ++NumActiveTasks;
-      std::tie(Task, Priority) = std::move(Queue.front());
-      Queue.pop_front();
+      if (Task->ThreadPriority == llvm::ThreadPriority::Background)
+        ++NumActiveBackgroundTasks;
     }
 
-    if (Priority != llvm::ThreadPriority::Default && !PreventStarvation.load())
-      llvm::set_thread_priority(Priority);
-    (*Task)();
-    if (Priority != llvm::ThreadPriority::Default)
+    if (Task->ThreadPriority != llvm::ThreadPriority::Default &&
+        !PreventStarvation.load())
+      llvm::set_thread_priority(Task->ThreadPriority);
+    Task->Run();
+    if (Task->ThreadPriority != llvm::ThreadPriority::Default)
       llvm::set_thread_priority(llvm::ThreadPriority::Default);
 
     {
       std::unique_lock<std::mutex> Lock(QueueMu);
+      if (!Task->Key.empty()) {
+        InFlight.erase(Task->Key);
+        auto It = Deferred.find(Task->Key);
+        if (It != Deferred.end()) {
+          pushTaskLocked(std::move(It->second));
+          Deferred.erase(It);
+        }
+      }
       assert(NumActiveTasks > 0 && "before decrementing");
       --NumActiveTasks;
+      if (Task->ThreadPriority == llvm::ThreadPriority::Background)
+        --NumActiveBackgroundTasks;
     }
     QueueCV.notify_all();
   }
@@ -215,57 +239,156 @@ bool BackgroundIndex::blockUntilIdleForTest(
 }
 
 void BackgroundIndex::enqueue(const std::vector<std::string> &ChangedFiles) {
-  enqueueTask(
-      [this, ChangedFiles] {
-        trace::Span Tracer("BackgroundIndexEnqueue");
-        // We're doing this asynchronously, because we'll read shards here too.
-        log("Enqueueing {0} commands for indexing", ChangedFiles.size());
-        SPAN_ATTACH(Tracer, "files", int64_t(ChangedFiles.size()));
-
-        auto NeedsReIndexing = loadShards(std::move(ChangedFiles));
-        // Run indexing for files that need to be updated.
-        std::shuffle(NeedsReIndexing.begin(), NeedsReIndexing.end(),
-                     std::mt19937(std::random_device{}()));
-        for (auto &Elem : NeedsReIndexing)
-          enqueue(std::move(Elem.first), Elem.second);
-      },
-      llvm::ThreadPriority::Default);
+  Task T;
+  T.Run = [this, ChangedFiles] {
+    trace::Span Tracer("BackgroundIndexEnqueue");
+    // We're doing this asynchronously, because we'll read shards here too.
+    log("Enqueueing {0} commands for indexing", ChangedFiles.size());
+    SPAN_ATTACH(Tracer, "files", int64_t(ChangedFiles.size()));
+
+    auto NeedsReIndexing = loadShards(std::move(ChangedFiles));
+    // Run indexing for files that need to be updated. Tasks of the same
+    // priority keep this order.
+    std::shuffle(NeedsReIndexing.begin(), NeedsReIndexing.end(),
+                 std::mt19937(std::random_device{}()));
+    for (auto &Elem : NeedsReIndexing)
+      enqueue(std::move(Elem));
+  };
+  T.ThreadPriority = llvm::ThreadPriority::Default;
+  T.Priority = QueuePriority::Loading;
+  enqueueTask(std::move(T));
 }
 
-void BackgroundIndex::enqueue(tooling::CompileCommand Cmd,
-                              BackgroundIndexStorage *Storage) {
-  enqueueTask(Bind(
-                  [this, Storage](tooling::CompileCommand Cmd) {
-                    // We can't use llvm::StringRef here since we are going to
-                    // move from Cmd during the call below.
-                    const std::string FileName = Cmd.Filename;
-                    if (auto Error = index(std::move(Cmd), Storage))
-                      elog("Indexing {0} failed: {1}", FileName,
-                           std::move(Error));
-                  },
-                  std::move(Cmd)),
-              llvm::ThreadPriority::Background);
+void BackgroundIndex::enqueue(TUToIndex TU) {
+  Task T;
+  T.Key = getAbsolutePath(TU.Cmd).str();
+  BackgroundIndexStorage *Storage = TU.Storage;
+  T.Run = Bind(
+      [this, Storage](tooling::CompileCommand Cmd) {
+        // We can't use llvm::StringRef here since we are going to
+        // move from Cmd during the call below.
+        const std::string FileName = Cmd.Filename;
+        if (auto Error = index(std::move(Cmd), Storage))
+          elog("Indexing {0} failed: {1}", FileName, std::move(Error));
+      },
+      std::move(TU.Cmd));
+  T.ThreadPriority = llvm::ThreadPriority::Background;
+  T.Priority = TU.Priority;
+  enqueueTask(std::move(T));
 }
 
-void BackgroundIndex::enqueueTask(Task T, llvm::ThreadPriority Priority) {
+void BackgroundIndex::enqueueTask(Task T) {
   {
     std::lock_guard<std::mutex> Lock(QueueMu);
-    auto I = Queue.end();
-    // We first store the tasks with Normal priority in the front of the queue.
-    // Then we store low priority tasks. Normal priority tasks are pretty rare,
-    // they should not grow beyond single-digit numbers, so it is OK to do
-    // linear search and insert after that.
-    if (Priority == llvm::ThreadPriority::Default) {
-      I = llvm::find_if(
-          Queue, [](const std::pair<Task, llvm::ThreadPriority> &Elem) {
-            return Elem.second == llvm::ThreadPriority::Background;
-          });
+    T.Seq = NextSeq++;
+    if (!T.Key.empty()) {
+      auto Inserted = Pending.try_emplace(
+          T.Key,
+          PendingTU{T.Seq, T.Priority, std::chrono::steady_clock::now()});
+      if (!Inserted.second) {
+        // The TU is already queued. The new task supersedes the old one, which
+        // is dropped when it reaches the front of the queue. Keep the higher
+        // priority and the earlier enqueue time.
+        PendingTU &P = Inserted.first->second;
+        P.Seq = T.Seq;
+        P.Priority = T.Priority = std::max(P.Priority, T.Priority);
+      }
     }
-    Queue.insert(I, {std::move(T), Priority});
+    pushTaskLocked(std::move(T));
   }
   QueueCV.notify_all();
 }
 
+bool BackgroundIndex::runsAfter(const Task &L, const Task &R) {
+  if (L.Priority != R.Priority)
+    return L.Priority < R.Priority;
+  return L.Seq > R.Seq;
+}
+
+void BackgroundIndex::pushTaskLocked(Task T) {
+  Queue.push_back(std::move(T));
+  std::push_heap(Queue.begin(), Queue.end(), runsAfter);
+}
+
+llvm::Optional<BackgroundIndex::Task>
+BackgroundIndex::popTaskLocked(Deadline &Retry) {
+  auto Now = std::chrono::steady_clock::now();
+  while (!Queue.empty()) {
+    const Task &Top = Queue.front();
+    if (!Top.Key.empty()) {
+      auto It = Pending.find(Top.Key);
+      if (It == Pending.end() || It->second.Seq != Top.Seq) {
+        // Superseded by a later task for the same TU.
+        std::pop_heap(Queue.begin(), Queue.end(), runsAfter);
+        Queue.pop_back();
+        continue;
+      }
+    }
+    if (Top.ThreadPriority == llvm::ThreadPriority::Background &&
+        NumActiveBackgroundTasks >= ThrottledPoolSize &&
+        Now < LastUserActivity + UserActivityWindow) {
+      Retry = Deadline(LastUserActivity + UserActivityWindow);
+      return llvm::None;
+    }
+
+    std::pop_heap(Queue.begin(), Queue.end(), runsAfter);
+    Task T = std::move(Queue.back());
+    Queue.pop_back();
+    if (T.Key.empty())
+      return std::move(T);
+    if (InFlight.count(T.Key)) {
+      // Run it once the current indexing of the TU finishes, as its results
+      // may already be out of date.
+      Deferred[T.Key] = std::move(T);
+      continue;
+    }
+    auto It = Pending.find(T.Key);
+    InFlight[T.Key] = It->second.Enqueued;
+    Pending.erase(It);
+    return std::move(T);
+  }
+  return llvm::None;
+}
+
+void BackgroundIndex::boostRelated(llvm::StringRef Path) {
+  llvm::StringRef Stem = llvm::sys::path::stem(Path);
+  std::lock_guard<std::mutex> Lock(QueueMu);
+  LastUserActivity = std::chrono::steady_clock::now();
+  bool Boosted = false;
+  auto Boost = [&](Task &T) {
+    if (T.Key.empty() || T.Priority >= QueuePriority::Open ||
+        llvm::sys::path::stem(T.Key) != Stem)
+      return;
+    T.Priority = QueuePriority::Open;
+    auto It = Pending.find(T.Key);
+    if (It != Pending.end() && It->second.Seq == T.Seq)
+      It->second.Priority = QueuePriority::Open;
+    Boosted = true;
+  };
+  for (Task &T : Queue)
+    Boost(T);
+  for (auto &D : Deferred)
+    Boost(D.second);
+  if (Boosted)
+    std::make_heap(Queue.begin(), Queue.end(), runsAfter);
+}
+
+BackgroundIndex::Stats BackgroundIndex::stats() {
+  std::lock_guard<std::mutex> Lock(QueueMu);
+  Stats S;
+  S.QueuedTUs = Pending.size();
+  S.ActiveTUs = InFlight.size();
+  auto Now = std::chrono::steady_clock::now();
+  auto Oldest = Now;
+  for (const auto &P : Pending)
+    Oldest = std::min(Oldest, P.second.Enqueued);
+  for (const auto &F : InFlight)
+    Oldest = std::min(Oldest, F.second);
+  S.Staleness =
+      std::chrono::duration_cast<std::chrono::milliseconds>(Now - Oldest);
+  return S;
+}
+
 /// Given index results from a TU, only update symbols coming from files that
 /// are different or missing from than \p DigestsSnapshot. Also stores new index
 /// information on IndexStorage.
@@ -519,6 +642,7 @@ BackgroundIndex::loadShard(const tooling::CompileCommand &Cmd,
       vlog("Failed to load shard: {0}", CurDependency.Path);
       continue;
     }
+    CurDependency.ShardLoaded = true;
     // These are the edges in the include graph for current dependency.
     for (const auto &I : *Shard->Sources) {
       auto U = URI::parse(I.getKey());
@@ -581,10 +705,9 @@ BackgroundIndex::loadShard(const tooling::CompileCommand &Cmd,
 
 // Goes over each changed file and loads them from index. Returns the list of
 // TUs that had out-of-date/no shards.
-std::vector<std::pair<tooling::CompileCommand, BackgroundIndexStorage *>>
+std::vector<BackgroundIndex::TUToIndex>
 BackgroundIndex::loadShards(std::vector<std::string> ChangedFiles) {
-  std::vector<std::pair<tooling::CompileCommand, BackgroundIndexStorage *>>
-      NeedsReIndexing;
+  std::vector<TUToIndex> NeedsReIndexing;
   // Keeps track of the files that will be reindexed, to make sure we won't
   // re-index same dependencies more than once. Keys are AbsolutePaths.
   llvm::StringSet<> FilesToIndex;
@@ -606,7 +729,12 @@ BackgroundIndex::loadShards(std::vector<std::string> ChangedFiles) {
       // out a minimal set of TUs that will cover all the stale dependencies.
       vlog("Enqueueing TU {0} because its dependency {1} needs re-indexing.",
            Cmd->Filename, Dependency.Path);
-      NeedsReIndexing.push_back({std::move(*Cmd), IndexStorage});
+      // The TU itself is the first of its dependencies.
+      QueuePriority Priority = QueuePriority::Dependent;
+      if (Dependencies.front().NeedsReIndexing)
+        Priority = Dependencies.front().ShardLoaded ? QueuePriority::Edited
+                                                    : QueuePriority::Rest;
+      NeedsReIndexing.push_back({std::move(*Cmd), IndexStorage, Priority});
       // Mark all of this TU's dependencies as to-be-indexed so that we won't
       // try to re-index those.
       for (const auto &Dependency : Dependencies)
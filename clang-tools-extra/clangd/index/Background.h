@@ -21,8 +21,8 @@
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/Threading.h"
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
-#include <deque>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -80,6 +80,21 @@ public:
   // available sometime later.
   void enqueue(const std::vector<std::string> &ChangedFiles);
 
+  // Moves the queued TUs for \p Path, and for the files sharing its stem
+  // (e.g. the source file of a header), to the front of the queue. Called when
+  // a file is opened or edited, which also marks the user as active: while
+  // they are, indexing runs on fewer threads to leave CPU for the editor.
+  void boostRelated(llvm::StringRef Path);
+
+  struct Stats {
+    unsigned QueuedTUs = 0; // Waiting to be indexed.
+    unsigned ActiveTUs = 0; // Being indexed right now.
+    // How long the oldest queued or active TU has been waiting, i.e. for how
+    // long the index is known to be out of date. Zero when idle.
+    std::chrono::milliseconds Staleness{0};
+  };
+  Stats stats();
+
   // Cause background threads to stop after ther current task, any remaining
   // tasks will be discarded.
   void stop();
@@ -122,30 +137,73 @@ private:
   struct Source {
     std::string Path;
     bool NeedsReIndexing;
+    bool ShardLoaded = false;
     Source(llvm::StringRef Path, bool NeedsReIndexing)
         : Path(Path), NeedsReIndexing(NeedsReIndexing) {}
   };
+  // Order in which queued tasks are run, highest first. Tasks of the same
+  // priority run in the order they were enqueued.
+  enum class QueuePriority : unsigned {
+    Rest,      // TUs without a stored shard, e.g. on the first run.
+    Dependent, // TUs whose own shard is fresh but a dependency changed.
+    Edited,    // TUs whose main file changed since it was last indexed.
+    Open,      // TUs related to files open in the editor, see boostRelated().
+    Loading,   // Loading the shards of changed files, cheap and unblocks TUs.
+  };
+  struct TUToIndex {
+    tooling::CompileCommand Cmd;
+    BackgroundIndexStorage *Storage;
+    QueuePriority Priority;
+  };
   // Loads the shards for a single TU and all of its dependencies. Returns the
   // list of sources and whether they need to be re-indexed.
   std::vector<Source> loadShard(const tooling::CompileCommand &Cmd,
                                 BackgroundIndexStorage *IndexStorage,
                                 llvm::StringSet<> &LoadedShards);
   // Tries to load shards for the ChangedFiles.
-  std::vector<std::pair<tooling::CompileCommand, BackgroundIndexStorage *>>
-  loadShards(std::vector<std::string> ChangedFiles);
-  void enqueue(tooling::CompileCommand Cmd, BackgroundIndexStorage *Storage);
+  std::vector<TUToIndex> loadShards(std::vector<std::string> ChangedFiles);
+  void enqueue(TUToIndex TU);
 
   // queue management
-  using Task = std::function<void()>;
+  struct Task {
+    std::function<void()> Run;
+    llvm::ThreadPriority ThreadPriority;
+    QueuePriority Priority;
+    // Absolute path of the TU for indexing tasks, empty otherwise. There is at
+    // most one pending task per key; see Pending.
+    std::string Key;
+    uint64_t Seq; // Stamped by enqueueTask, breaks ties in Priority.
+  };
+  struct PendingTU {
+    uint64_t Seq; // Of the latest task for the TU, older ones are dropped.
+    QueuePriority Priority;
+    std::chrono::steady_clock::time_point Enqueued;
+  };
+  // Whether \p L runs after \p R, orders the Queue heap.
+  static bool runsAfter(const Task &L, const Task &R);
   void run(); // Main loop executed by Thread. Runs tasks from Queue.
-  void enqueueTask(Task T, llvm::ThreadPriority Prioirty);
-  void enqueueLocked(tooling::CompileCommand Cmd,
-                     BackgroundIndexStorage *IndexStorage);
+  void enqueueTask(Task T);
+  // Pops the task to run next, if any may run now. Otherwise sets \p Retry to
+  // the time at which a throttled task may run.
+  llvm::Optional<Task> popTaskLocked(Deadline &Retry);
+  void pushTaskLocked(Task T);
   std::mutex QueueMu;
   unsigned NumActiveTasks = 0; // Only idle when queue is empty *and* no tasks.
+  unsigned NumActiveBackgroundTasks = 0;
+  // Number of threads running background priority tasks while the user is
+  // active, see boostRelated().
+  const unsigned ThrottledPoolSize;
+  std::chrono::steady_clock::time_point LastUserActivity;
   std::condition_variable QueueCV;
   bool ShouldStop = false;
-  std::deque<std::pair<Task, llvm::ThreadPriority>> Queue;
+  uint64_t NextSeq = 0;
+  std::vector<Task> Queue; // A heap, the next task to run is at the front.
+  llvm::StringMap<PendingTU> Pending; // Queued TUs, keyed by Task::Key.
+  // TUs being indexed, mapped to the time they were first enqueued. A task for
+  // one of them is parked in Deferred until the running one finishes, so that
+  // a TU is not indexed twice concurrently.
+  llvm::StringMap<std::chrono::steady_clock::time_point> InFlight;
+  llvm::StringMap<Task> Deferred;
   AsyncTaskRunner ThreadPool;
   GlobalCompilationDatabase::CommandChanged::Subscription CommandsChanged;
 };
@@ -33,15 +33,16 @@ std::shared_ptr<SymbolIndex> SwapIndex::snapshot() const {
 
 bool fromJSON(const llvm::json::Value &Parameters, FuzzyFindRequest &Request) {
   llvm::json::ObjectMapper O(Parameters);
-  int64_t Limit;
+  // A missing or null limit means no limit.
+  llvm::Optional<int64_t> Limit;
   bool OK =
       O && O.map("Query", Request.Query) && O.map("Scopes", Request.Scopes) &&
       O.map("AnyScope", Request.AnyScope) && O.map("Limit", Limit) &&
       O.map("RestrictForCodeCompletion", Request.RestrictForCodeCompletion) &&
       O.map("ProximityPaths", Request.ProximityPaths) &&
       O.map("PreferredTypes", Request.PreferredTypes);
-  if (OK && Limit <= std::numeric_limits<uint32_t>::max())
-    Request.Limit = Limit;
+  if (OK && Limit && *Limit <= std::numeric_limits<uint32_t>::max())
+    Request.Limit = *Limit;
   return OK;
 }
 
@@ -57,6 +58,59 @@ llvm::json::Value toJSON(const FuzzyFindRequest &Request) {
   };
 }
 
+static bool fromJSON(const llvm::json::Value &Value,
+                     llvm::DenseSet<SymbolID> &IDs) {
+  std::vector<std::string> Strings;
+  if (!fromJSON(Value, Strings))
+    return false;
+  for (const auto &S : Strings) {
+    auto ID = SymbolID::fromStr(S);
+    if (!ID) {
+      llvm::consumeError(ID.takeError());
+      return false;
+    }
+    IDs.insert(*ID);
+  }
+  return true;
+}
+
+static llvm::json::Value toJSON(const llvm::DenseSet<SymbolID> &IDs) {
+  llvm::json::Array Result;
+  for (const auto &ID : IDs)
+    Result.push_back(ID.str());
+  return std::move(Result);
+}
+
+bool fromJSON(const llvm::json::Value &Parameters, LookupRequest &Request) {
+  llvm::json::ObjectMapper O(Parameters);
+  return O && O.map("IDs", Request.IDs);
+}
+
+llvm::json::Value toJSON(const LookupRequest &Request) {
+  return llvm::json::Object{{"IDs", toJSON(Request.IDs)}};
+}
+
+bool fromJSON(const llvm::json::Value &Parameters, RefsRequest &Request) {
+  llvm::json::ObjectMapper O(Parameters);
+  int64_t Filter;
+  llvm::Optional<int64_t> Limit;
+  bool OK = O && O.map("IDs", Request.IDs) && O.map("Filter", Filter) &&
+            O.map("Limit", Limit);
+  if (OK)
+    Request.Filter = static_cast<RefKind>(Filter) & RefKind::All;
+  if (OK && Limit && *Limit <= std::numeric_limits<uint32_t>::max())
+    Request.Limit = *Limit;
+  return OK;
+}
+
+llvm::json::Value toJSON(const RefsRequest &Request) {
+  return llvm::json::Object{
+      {"IDs", toJSON(Request.IDs)},
+      {"Filter", static_cast<int64_t>(Request.Filter)},
+      {"Limit", Request.Limit},
+  };
+}
+
 bool SwapIndex::fuzzyFind(const FuzzyFindRequest &R,
                           llvm::function_ref<void(const Symbol &)> CB) const {
   return snapshot()->fuzzyFind(R, CB);
@@ -62,6 +62,8 @@ llvm::json::Value toJSON(const FuzzyFindRequest &Request);
 struct LookupRequest {
   llvm::DenseSet<SymbolID> IDs;
 };
+bool fromJSON(const llvm::json::Value &Value, LookupRequest &Request);
+llvm::json::Value toJSON(const LookupRequest &Request);
 
 struct RefsRequest {
   llvm::DenseSet<SymbolID> IDs;
@@ -71,6 +73,8 @@ struct RefsRequest {
   /// results.
   llvm::Optional<uint32_t> Limit;
 };
+bool fromJSON(const llvm::json::Value &Value, RefsRequest &Request);
+llvm::json::Value toJSON(const RefsRequest &Request);
 
 /// Interface for symbol indexes that can be used for searching or
 /// matching symbols among a set of symbols based on names or unique IDs.
@@ -16,6 +16,8 @@
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MathExtras.h"
 
 namespace clang {
 namespace clangd {
@@ -358,6 +360,108 @@ readRefs(Reader &Data, llvm::ArrayRef<llvm::StringRef> Strings) {
   return Result;
 }
 
+// DEX POSTING LISTS ENCODING
+// A dexi section holds the posting lists of a Dex of the file's symbols, so
+// that an index can be loaded without building them. The chunks of the lists
+// are laid out the way they are in memory, so they are used in place when the
+// file is mapped at a suitable address. The section has:
+//  - NumSymbols: varint
+//  - SymbolOrder[NumSymbols]: varint (symbol position in the "symb" section)
+//  - NumLists: varint
+//  - per list: token kind (uint8), token length (varint), token bytes,
+//    number of chunks (varint)
+//  - zero padding to a multiple of sizeof(dex::Chunk) bytes
+//  - the chunks of the lists in turn, each a uint32 head and payload bytes
+// The section is written right after "meta", which puts the chunks at a
+// multiple of sizeof(dex::Chunk) bytes into the file.
+
+void writePostingLists(const SymbolSlab &Symbols, llvm::raw_ostream &OS) {
+  dex::DexPostingLists PostingLists = dex::buildPostingLists(Symbols);
+  // Make the output deterministic.
+  llvm::sort(PostingLists.Lists,
+             [](const std::pair<dex::Token, llvm::ArrayRef<dex::Chunk>> &L,
+                const std::pair<dex::Token, llvm::ArrayRef<dex::Chunk>> &R) {
+               return std::tie(L.first.TokenKind, L.first.Data) <
+                      std::tie(R.first.TokenKind, R.first.Data);
+             });
+
+  writeVar(PostingLists.SymbolOrder.size(), OS);
+  for (uint32_t Position : PostingLists.SymbolOrder)
+    writeVar(Position, OS);
+  writeVar(PostingLists.Lists.size(), OS);
+  for (const auto &List : PostingLists.Lists) {
+    OS.write(static_cast<uint8_t>(List.first.TokenKind));
+    writeVar(List.first.Data.size(), OS);
+    OS << List.first.Data;
+    writeVar(List.second.size(), OS);
+  }
+  for (uint64_t Pad = llvm::OffsetToAlignment(OS.tell(), sizeof(dex::Chunk));
+       Pad; --Pad)
+    OS.write(0);
+  for (const auto &List : PostingLists.Lists)
+    for (const dex::Chunk &C : List.second) {
+      write32(C.Head, OS);
+      OS.write(reinterpret_cast<const char *>(C.Payload.data()),
+               C.Payload.size());
+    }
+}
+
+llvm::Expected<dex::DexPostingLists> readPostingLists(llvm::StringRef Data,
+                                                      size_t NumSymbols) {
+  Reader R(Data);
+  dex::DexPostingLists Result;
+  if (R.consumeVar() != NumSymbols)
+    return makeError("posting lists don't match the symbols");
+  Result.SymbolOrder.resize(NumSymbols);
+  std::vector<bool> Seen(NumSymbols);
+  for (uint32_t &Position : Result.SymbolOrder) {
+    Position = R.consumeVar();
+    if (Position >= NumSymbols || Seen[Position])
+      return makeError("malformed posting lists symbol order");
+    Seen[Position] = true;
+  }
+
+  std::vector<std::pair<dex::Token, size_t>> Tokens;
+  size_t NumChunks = 0;
+  for (size_t I = 0, NumLists = R.consumeVar(); I < NumLists; ++I) {
+    auto Kind = static_cast<dex::Token::Kind>(R.consume8());
+    llvm::StringRef TokenData = R.consume(R.consumeVar());
+    size_t Size = R.consumeVar();
+    if (R.err() || Size == 0 || Kind > dex::Token::Kind::Sentinel)
+      return makeError("malformed or truncated posting list token");
+    Tokens.emplace_back(dex::Token(Kind, TokenData), Size);
+    NumChunks += Size;
+  }
+  R.consume(llvm::OffsetToAlignment(Data.size() - R.rest().size(),
+                                    sizeof(dex::Chunk)));
+  llvm::StringRef Chunks = R.rest();
+  if (R.err() || Chunks.size() != NumChunks * sizeof(dex::Chunk))
+    return makeError("malformed or truncated posting lists");
+
+  // The chunks are used in place where the layout matches, otherwise decoded.
+  const dex::Chunk *Begin = reinterpret_cast<const dex::Chunk *>(Chunks.data());
+  if (!llvm::sys::IsLittleEndianHost ||
+      reinterpret_cast<uintptr_t>(Begin) % alignof(dex::Chunk)) {
+    Result.ChunkStorage.resize(NumChunks);
+    for (dex::Chunk &C : Result.ChunkStorage) {
+      C.Head = llvm::support::endian::read32le(Chunks.data());
+      std::copy(Chunks.begin() + sizeof(C.Head),
+                Chunks.begin() + sizeof(dex::Chunk), C.Payload.begin());
+      Chunks = Chunks.drop_front(sizeof(dex::Chunk));
+    }
+    Begin = Result.ChunkStorage.data();
+  }
+  for (auto &TokenAndSize : Tokens) {
+    llvm::ArrayRef<dex::Chunk> List(Begin, TokenAndSize.second);
+    // DocIDs are ascending, the last one must name a symbol.
+    if (List.back().decompress().back() >= NumSymbols)
+      return makeError("malformed posting list");
+    Result.Lists.emplace_back(std::move(TokenAndSize.first), List);
+    Begin += TokenAndSize.second;
+  }
+  return std::move(Result);
+}
+
 // FILE ENCODING
 // A file is a RIFF chunk with type 'CdIx'.
 // It contains the sections:
@@ -366,6 +470,7 @@ readRefs(Reader &Data, llvm::ArrayRef<llvm::StringRef> Strings) {
 //   - stri: string table
 //   - symb: symbols
 //   - refs: references to symbols
+//   - dexi: Dex posting lists of the symbols (optional)
 
 // The current versioning scheme is simple - non-current versions are rejected.
 // If you make a breaking change, bump this version number to invalidate stored
@@ -434,6 +539,13 @@ llvm::Expected<IndexFileIn> readRIFF(llvm::StringRef Data) {
       return makeError("malformed or truncated refs");
     Result.Refs = std::move(Refs).build();
   }
+  if (Chunks.count("dexi")) {
+    auto PostingLists = readPostingLists(
+        Chunks.lookup("dexi"), Result.Symbols ? Result.Symbols->size() : 0);
+    if (!PostingLists)
+      return PostingLists.takeError();
+    Result.PostingLists = std::move(*PostingLists);
+  }
   return std::move(Result);
 }
 
@@ -456,6 +568,15 @@ void writeRIFF(const IndexFileOut &Data, llvm::raw_ostream &OS) {
   }
   RIFF.Chunks.push_back({riff::fourCC("meta"), Meta});
 
+  std::string PostingListsSection;
+  if (Data.IncludePostingLists) {
+    {
+      llvm::raw_string_ostream PostingListsOS(PostingListsSection);
+      writePostingLists(*Data.Symbols, PostingListsOS);
+    }
+    RIFF.Chunks.push_back({riff::fourCC("dexi"), PostingListsSection});
+  }
+
   StringTableOut Strings;
   std::vector<Symbol> Symbols;
   for (const auto &Sym : *Data.Symbols) {
@@ -553,7 +674,10 @@ llvm::Expected<IndexFileIn> readIndexFile(llvm::StringRef Data) {
 std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
                                        bool UseDex) {
   trace::Span OverallTracer("LoadIndex");
-  auto Buffer = llvm::MemoryBuffer::getFile(SymbolFilename);
+  // The posting lists stored in the file are used in place, so let the file be
+  // mapped whatever its size: the pages are then shared between processes.
+  auto Buffer = llvm::MemoryBuffer::getFile(SymbolFilename, /*FileSize=*/-1,
+                                            /*RequiresNullTerminator=*/false);
   if (!Buffer) {
     llvm::errs() << "Can't open " << SymbolFilename << "\n";
     return nullptr;
@@ -561,6 +685,7 @@ std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
 
   SymbolSlab Symbols;
   RefSlab Refs;
+  llvm::Optional<dex::DexPostingLists> PostingLists;
   {
     trace::Span Tracer("ParseIndex");
     if (auto I = readIndexFile(Buffer->get()->getBuffer())) {
@@ -568,6 +693,7 @@ std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
         Symbols = std::move(*I->Symbols);
       if (I->Refs)
         Refs = std::move(*I->Refs);
+      PostingLists = std::move(I->PostingLists);
     } else {
       llvm::errs() << "Bad Index: " << llvm::toString(I.takeError()) << "\n";
       return nullptr;
@@ -578,8 +704,14 @@ std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
   size_t NumRefs = Refs.numRefs();
 
   trace::Span Tracer("BuildIndex");
-  auto Index = UseDex ? dex::Dex::build(std::move(Symbols), std::move(Refs))
-                      : MemIndex::build(std::move(Symbols), std::move(Refs));
+  std::unique_ptr<SymbolIndex> Index;
+  if (UseDex && PostingLists)
+    Index = dex::Dex::build(std::move(Symbols), std::move(Refs),
+                            std::move(*PostingLists), std::move(*Buffer));
+  else if (UseDex)
+    Index = dex::Dex::build(std::move(Symbols), std::move(Refs));
+  else
+    Index = MemIndex::build(std::move(Symbols), std::move(Refs));
   vlog("Loaded {0} from {1} with estimated memory usage {2} bytes\n"
        "  - number of symbols: {3}\n"
        "  - number of refs: {4}\n",
@@ -12,6 +12,7 @@
 //  - metadata such as version info
 //  - a string table (which is compressed)
 //  - lists of encoded symbols
+//  - optionally, the posting lists of a Dex index of the symbols
 //
 // The format has a simple versioning scheme: the format version number is
 // written in the file and non-current versions are rejected when reading.
@@ -27,6 +28,7 @@
 #include "Headers.h"
 #include "Index.h"
 #include "index/Symbol.h"
+#include "index/dex/Dex.h"
 #include "llvm/Support/Error.h"
 
 namespace clang {
@@ -43,6 +45,8 @@ struct IndexFileIn {
   llvm::Optional<RefSlab> Refs;
   // Keys are URIs of the source files.
   llvm::Optional<IncludeGraph> Sources;
+  // The Dex posting lists of Symbols, which may point into the file data.
+  llvm::Optional<dex::DexPostingLists> PostingLists;
 };
 // Parse an index file. The input must be a RIFF or YAML file.
 llvm::Expected<IndexFileIn> readIndexFile(llvm::StringRef);
@@ -53,7 +57,8 @@ struct IndexFileOut {
   const RefSlab *Refs = nullptr;
   // Keys are URIs of the source files.
   const IncludeGraph *Sources = nullptr;
-  // TODO: Support serializing Dex posting lists.
+  // Whether to store the Dex posting lists of Symbols (RIFF format only).
+  bool IncludePostingLists = false;
   IndexFileFormat Format = IndexFileFormat::RIFF;
 
   IndexFileOut() = default;
@@ -18,6 +18,7 @@
 #include "llvm/Support/ScopedPrinter.h"
 #include <algorithm>
 #include <queue>
+#include <tuple>
 
 namespace clang {
 namespace clangd {
@@ -29,6 +30,43 @@ std::unique_ptr<SymbolIndex> Dex::build(SymbolSlab Symbols, RefSlab Refs) {
   return llvm::make_unique<Dex>(Data.first, Data.second, std::move(Data), Size);
 }
 
+std::unique_ptr<SymbolIndex>
+Dex::build(SymbolSlab Symbols, RefSlab Refs, DexPostingLists PostingLists,
+           std::unique_ptr<llvm::MemoryBuffer> File) {
+  assert(PostingLists.SymbolOrder.size() == Symbols.size() &&
+         "Posting lists built for other symbols");
+  auto Size = Symbols.bytes() + Refs.bytes() +
+              PostingLists.ChunkStorage.capacity() * sizeof(Chunk);
+  auto Data = std::make_shared<
+      std::tuple<SymbolSlab, RefSlab, DexPostingLists,
+                 std::unique_ptr<llvm::MemoryBuffer>>>(
+      std::move(Symbols), std::move(Refs), std::move(PostingLists),
+      std::move(File));
+  const SymbolSlab &Slab = std::get<0>(*Data);
+  const DexPostingLists &Lists = std::get<2>(*Data);
+
+  // Nothing is computed from the symbols but their qualities, the tokens and
+  // the posting lists are used as they are stored.
+  std::unique_ptr<Dex> Index(new Dex());
+  Index->Corpus = dex::Corpus(Slab.size());
+  Index->Symbols.reserve(Slab.size());
+  Index->SymbolQuality.reserve(Slab.size());
+  for (uint32_t Position : Lists.SymbolOrder) {
+    const Symbol *Sym = &*(Slab.begin() + Position);
+    Index->Symbols.push_back(Sym);
+    Index->SymbolQuality.push_back(quality(*Sym));
+    Index->LookupTable[Sym->ID] = Sym;
+  }
+  for (const auto &TokenAndChunks : Lists.Lists)
+    Index->InvertedIndex.insert(
+        {TokenAndChunks.first, PostingList::fromChunks(TokenAndChunks.second)});
+  for (const auto &Ref : std::get<1>(*Data))
+    Index->Refs.try_emplace(Ref.first, Ref.second);
+  Index->KeepAlive = std::shared_ptr<void>(std::move(Data));
+  Index->BackingDataSize = Size;
+  return std::move(Index);
+}
+
 namespace {
 
 // Mark symbols which are can be used for code completion.
@@ -58,40 +96,78 @@ std::vector<Token> generateSearchTokens(const Symbol &Sym) {
   return Result;
 }
 
-} // namespace
-
-void Dex::buildIndex() {
-  this->Corpus = dex::Corpus(Symbols.size());
+// Sorts Symbols by symbol qualities so that items in the posting lists are
+// stored in the descending order of symbol quality, and sets Quality[I] to the
+// quality of Symbols[I].
+void rankSymbols(std::vector<const Symbol *> &Symbols,
+                 std::vector<float> &Quality) {
   std::vector<std::pair<float, const Symbol *>> ScoredSymbols(Symbols.size());
-
-  for (size_t I = 0; I < Symbols.size(); ++I) {
-    const Symbol *Sym = Symbols[I];
-    LookupTable[Sym->ID] = Sym;
-    ScoredSymbols[I] = {quality(*Sym), Sym};
-  }
-
-  // Symbols are sorted by symbol qualities so that items in the posting lists
-  // are stored in the descending order of symbol quality.
+  for (size_t I = 0; I < Symbols.size(); ++I)
+    ScoredSymbols[I] = {quality(*Symbols[I]), Symbols[I]};
   llvm::sort(ScoredSymbols, std::greater<std::pair<float, const Symbol *>>());
 
-  // SymbolQuality was empty up until now.
-  SymbolQuality.resize(Symbols.size());
-  // Populate internal storage using Symbol + Score pairs.
+  Quality.resize(Symbols.size());
   for (size_t I = 0; I < ScoredSymbols.size(); ++I) {
-    SymbolQuality[I] = ScoredSymbols[I].first;
+    Quality[I] = ScoredSymbols[I].first;
     Symbols[I] = ScoredSymbols[I].second;
   }
+}
 
-  // Populate TempInvertedIndex with lists for index symbols.
+// Returns the DocIDs of Symbols, as ranked by rankSymbols, having each token.
+llvm::DenseMap<Token, std::vector<DocID>>
+invertSymbols(llvm::ArrayRef<const Symbol *> Symbols) {
   llvm::DenseMap<Token, std::vector<DocID>> TempInvertedIndex;
   for (DocID SymbolRank = 0; SymbolRank < Symbols.size(); ++SymbolRank) {
     const auto *Sym = Symbols[SymbolRank];
     for (const auto &Token : generateSearchTokens(*Sym))
       TempInvertedIndex[Token].push_back(SymbolRank);
   }
+  return TempInvertedIndex;
+}
+
+} // namespace
+
+DexPostingLists buildPostingLists(const SymbolSlab &Symbols) {
+  std::vector<const Symbol *> Ranked;
+  Ranked.reserve(Symbols.size());
+  for (const Symbol &Sym : Symbols)
+    Ranked.push_back(&Sym);
+  std::vector<float> Quality;
+  rankSymbols(Ranked, Quality);
+
+  DexPostingLists Result;
+  Result.SymbolOrder.reserve(Ranked.size());
+  for (const Symbol *Sym : Ranked)
+    Result.SymbolOrder.push_back(Sym - &*Symbols.begin());
+
+  // All the chunks are stored together, the lists point into the storage once
+  // it doesn't grow anymore.
+  std::vector<std::pair<Token, size_t>> Offsets;
+  for (const auto &TokenToPostingList : invertSymbols(Ranked)) {
+    Offsets.emplace_back(TokenToPostingList.first, Result.ChunkStorage.size());
+    PostingList List(TokenToPostingList.second);
+    Result.ChunkStorage.insert(Result.ChunkStorage.end(),
+                               List.chunks().begin(), List.chunks().end());
+  }
+  for (size_t I = 0; I < Offsets.size(); ++I) {
+    size_t End = I + 1 < Offsets.size() ? Offsets[I + 1].second
+                                        : Result.ChunkStorage.size();
+    Result.Lists.emplace_back(
+        std::move(Offsets[I].first),
+        llvm::makeArrayRef(Result.ChunkStorage)
+            .slice(Offsets[I].second, End - Offsets[I].second));
+  }
+  return Result;
+}
+
+void Dex::buildIndex() {
+  this->Corpus = dex::Corpus(Symbols.size());
+  rankSymbols(Symbols, SymbolQuality);
+  for (const Symbol *Sym : Symbols)
+    LookupTable[Sym->ID] = Sym;
 
   // Convert lists of items to posting lists.
-  for (const auto &TokenToPostingList : TempInvertedIndex)
+  for (const auto &TokenToPostingList : invertSymbols(Symbols))
     InvertedIndex.insert(
         {TokenToPostingList.first, PostingList(TokenToPostingList.second)});
 }
@@ -27,17 +27,28 @@
 #include "index/Index.h"
 #include "index/MemIndex.h"
 #include "index/SymbolCollector.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 namespace clang {
 namespace clangd {
 namespace dex {
 
+/// The inverted index of a Dex over the symbols of a slab, as stored in an
+/// index file next to the symbols so that loading the file doesn't build it.
+struct DexPostingLists {
+  /// SymbolOrder[I] is the position in the slab of the symbol with DocID I.
+  std::vector<uint32_t> SymbolOrder;
+  /// The encoded posting list of each token.
+  std::vector<std::pair<Token, llvm::ArrayRef<Chunk>>> Lists;
+  /// The chunks of Lists if they are not stored elsewhere, e.g. in the mapped
+  /// index file they are read from.
+  std::vector<Chunk> ChunkStorage;
+};
+
+/// Builds the posting lists a Dex of the symbols in Symbols has.
+DexPostingLists buildPostingLists(const SymbolSlab &Symbols);
+
 /// In-memory Dex trigram-based index implementation.
-// FIXME(kbobyrev): Introduce serialization and deserialization of the symbol
-// index so that it can be loaded from the disk. Since static index is not
-// changed frequently, it's safe to assume that it has to be built only once
-// (when the clangd process starts). Therefore, it can be easier to store built
-// index on disk and then load it if available.
 class Dex : public SymbolIndex {
 public:
   // All data must outlive this index.
@@ -61,6 +72,12 @@ public:
 
   /// Builds an index from slabs. The index takes ownership of the slab.
   static std::unique_ptr<SymbolIndex> build(SymbolSlab, RefSlab);
+  /// Builds an index from slabs and the posting lists stored with them in an
+  /// index file, as returned by \ref buildPostingLists for Symbols. The index
+  /// takes ownership of the slabs, and of the file the lists may point to.
+  static std::unique_ptr<SymbolIndex>
+  build(SymbolSlab, RefSlab, DexPostingLists,
+        std::unique_ptr<llvm::MemoryBuffer> File);
 
   bool
   fuzzyFind(const FuzzyFindRequest &Req,
@@ -75,6 +92,7 @@ public:
   size_t estimateMemoryUsage() const override;
 
 private:
+  Dex() : Corpus(0) {}
   void buildIndex();
   std::unique_ptr<Iterator> iterator(const Token &Tok) const;
   std::unique_ptr<Iterator>
@@ -12,6 +12,11 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MathExtras.h"
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace clang {
 namespace clangd {
@@ -25,10 +30,8 @@ class ChunkIterator : public Iterator {
 public:
   explicit ChunkIterator(const Token *Tok, llvm::ArrayRef<Chunk> Chunks)
       : Tok(Tok), Chunks(Chunks), CurrentChunk(Chunks.begin()) {
-    if (!Chunks.empty()) {
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
-    }
+    if (!Chunks.empty())
+      decompressCurrentChunk();
   }
 
   bool reachedEnd() const override { return CurrentChunk == Chunks.end(); }
@@ -50,14 +53,13 @@ public:
       return;
     advanceToChunk(ID);
     // Try to find ID within current chunk.
-    CurrentID = llvm::bsearch(CurrentID, DecompressedChunk.end(),
-                              [&](const DocID D) { return D >= ID; });
+    CurrentID = findFirstNotLess(ID);
     normalizeCursor();
   }
 
   DocID peek() const override {
     assert(!reachedEnd() && "Posting List iterator can't peek() at the end.");
-    return *CurrentID;
+    return DecompressedChunk[CurrentID];
   }
 
   float consume() override {
@@ -88,14 +90,45 @@ private:
   /// chunk.
   void normalizeCursor() {
     // Invariant is already established if examined chunk is not exhausted.
-    if (CurrentID != std::end(DecompressedChunk))
+    if (CurrentID != DecompressedSize)
       return;
     // Advance to next chunk if current one is exhausted.
     ++CurrentChunk;
     if (CurrentChunk == Chunks.end()) // Reached the end of PostingList.
       return;
-    DecompressedChunk = CurrentChunk->decompress();
-    CurrentID = DecompressedChunk.begin();
+    decompressCurrentChunk();
+  }
+
+  void decompressCurrentChunk() {
+    DecompressedSize = CurrentChunk->decompress(DecompressedChunk.data());
+    CurrentID = 0;
+  }
+
+  /// Returns the position of the first DocID of the current chunk not less
+  /// than ID from the cursor on, or DecompressedSize if there is none.
+  size_t findFirstNotLess(DocID ID) const {
+    size_t I = CurrentID;
+#ifdef __SSE2__
+    // Compare four DocIDs at a time. The DocIDs less than ID are a prefix, so
+    // the first mismatch of a group is the one searched for. SSE2 only has
+    // signed comparisons, the sign bit is flipped to compare unsigned values.
+    const __m128i SignBit = _mm_set1_epi32(0x80000000);
+    const __m128i Target =
+        _mm_xor_si128(_mm_set1_epi32(static_cast<int>(ID)), SignBit);
+    for (; I + 4 <= DecompressedSize; I += 4) {
+      __m128i Docs = _mm_xor_si128(
+          _mm_loadu_si128(
+              reinterpret_cast<const __m128i *>(&DecompressedChunk[I])),
+          SignBit);
+      unsigned Less = _mm_movemask_ps(
+          _mm_castsi128_ps(_mm_cmplt_epi32(Docs, Target)));
+      if (Less != 0xf)
+        return I + llvm::countTrailingOnes(Less);
+    }
+#endif
+    while (I < DecompressedSize && DecompressedChunk[I] < ID)
+      ++I;
+    return I;
   }
 
   /// Advances CurrentChunk to the chunk which might contain ID.
@@ -106,21 +139,21 @@ private:
           llvm::bsearch(CurrentChunk + 1, Chunks.end(),
                         [&](const Chunk &C) { return C.Head >= ID; });
       --CurrentChunk;
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
+      decompressCurrentChunk();
     }
   }
 
   const Token *Tok;
   llvm::ArrayRef<Chunk> Chunks;
   /// Iterator over chunks.
-  /// If CurrentChunk is valid, then DecompressedChunk is
-  /// CurrentChunk->decompress() and CurrentID is a valid (non-end) iterator
-  /// into it.
+  /// If CurrentChunk is valid, then the first DecompressedSize elements of
+  /// DecompressedChunk are CurrentChunk->decompress() and CurrentID is a valid
+  /// (non-end) position in them.
   decltype(Chunks)::const_iterator CurrentChunk;
-  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> DecompressedChunk;
-  /// Iterator over DecompressedChunk.
-  decltype(DecompressedChunk)::iterator CurrentID;
+  std::array<DocID, Chunk::MaxDocs> DecompressedChunk;
+  size_t DecompressedSize = 0;
+  /// Position in DecompressedChunk.
+  size_t CurrentID = 0;
 
   static constexpr size_t ApproxEntriesPerChunk = 15;
 };
@@ -202,25 +235,59 @@ llvm::Optional<DocID> readVByte(llvm::ArrayRef<uint8_t> &Bytes) {
 
 } // namespace
 
-llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
-  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result{Head};
+llvm::SmallVector<DocID, Chunk::MaxDocs> Chunk::decompress() const {
+  DocID Docs[MaxDocs];
+  return llvm::SmallVector<DocID, MaxDocs>(Docs, Docs + decompress(Docs));
+}
+
+size_t Chunk::decompress(DocID *Out) const {
+  static_assert(PayloadSize == 28, "The SIMD decoding assumes 28 bytes");
+  Out[0] = Head;
+#ifdef __SSE2__
+  // Dense posting lists, such as the ones of the trigrams short queries use,
+  // often have all the deltas of a chunk encoded in a single byte. No byte has
+  // the continuation bit then, and the deltas are the bytes before the first
+  // zero, which are prefix summed four at a time.
+  __m128i Low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&Payload[0]));
+  __m128i High =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(&Payload[12]));
+  if (_mm_movemask_epi8(_mm_or_si128(Low, High)) == 0) {
+    const __m128i Zero = _mm_setzero_si128();
+    unsigned Ends = _mm_movemask_epi8(_mm_cmpeq_epi8(Low, Zero)) |
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(High, Zero)) << 12;
+    size_t NumDeltas = Ends ? llvm::countTrailingZeros(Ends) : PayloadSize;
+    __m128i Last = _mm_set1_epi32(static_cast<int>(Head));
+    for (size_t I = 0; I < NumDeltas; I += 4) {
+      uint32_t Bytes;
+      std::memcpy(&Bytes, &Payload[I], sizeof(Bytes));
+      __m128i Deltas = _mm_unpacklo_epi16(
+          _mm_unpacklo_epi8(_mm_cvtsi32_si128(Bytes), Zero), Zero);
+      Deltas = _mm_add_epi32(Deltas, _mm_slli_si128(Deltas, 4));
+      Deltas = _mm_add_epi32(Deltas, _mm_slli_si128(Deltas, 8));
+      Last = _mm_add_epi32(Deltas, Last);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(Out + 1 + I), Last);
+      Last = _mm_shuffle_epi32(Last, 0xff);
+    }
+    return NumDeltas + 1;
+  }
+#endif
+  size_t Size = 1;
   llvm::ArrayRef<uint8_t> Bytes(Payload);
-  DocID Delta;
-  for (DocID Current = Head; !Bytes.empty(); Current += Delta) {
+  for (DocID Current = Head; !Bytes.empty();) {
     auto MaybeDelta = readVByte(Bytes);
     if (!MaybeDelta)
       break;
-    Delta = *MaybeDelta;
-    Result.push_back(Current + Delta);
+    Current += *MaybeDelta;
+    Out[Size++] = Current;
   }
-  return llvm::SmallVector<DocID, Chunk::PayloadSize + 1>{Result};
+  return Size;
 }
 
 PostingList::PostingList(llvm::ArrayRef<DocID> Documents)
-    : Chunks(encodeStream(Documents)) {}
+    : Storage(encodeStream(Documents)) {}
 
 std::unique_ptr<Iterator> PostingList::iterator(const Token *Tok) const {
-  return llvm::make_unique<ChunkIterator>(Tok, Chunks);
+  return llvm::make_unique<ChunkIterator>(Tok, chunks());
 }
 
 } // namespace dex
@@ -26,6 +26,7 @@
 #include "Iterator.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SmallVector.h"
+#include <array>
 #include <cstdint>
 #include <vector>
 
@@ -42,8 +43,13 @@ struct Token;
 struct Chunk {
   /// Keep sizeof(Chunk) == 32.
   static constexpr size_t PayloadSize = 32 - sizeof(DocID);
+  /// The maximum number of DocIDs in a Chunk.
+  static constexpr size_t MaxDocs = PayloadSize + 1;
 
-  llvm::SmallVector<DocID, PayloadSize + 1> decompress() const;
+  llvm::SmallVector<DocID, MaxDocs> decompress() const;
+  /// Writes the DocIDs of the Chunk to Out and returns their number. Out may
+  /// be written past this number, up to MaxDocs elements.
+  size_t decompress(DocID *Out) const;
 
   /// The first element of decompressed Chunk.
   DocID Head;
@@ -60,16 +66,33 @@ class PostingList {
 public:
   explicit PostingList(llvm::ArrayRef<DocID> Documents);
 
+  /// Constructs a posting list over already encoded chunks which are stored
+  /// elsewhere, e.g. in a mapped index file, and must outlive the list.
+  static PostingList fromChunks(llvm::ArrayRef<Chunk> Chunks) {
+    return PostingList(Chunks);
+  }
+
   /// Constructs DocumentIterator over given posting list. DocumentIterator will
   /// go through the chunks and decompress them on-the-fly when necessary.
   /// If given, Tok is only used for the string representation.
   std::unique_ptr<Iterator> iterator(const Token *Tok = nullptr) const;
 
-  /// Returns in-memory size of external storage.
-  size_t bytes() const { return Chunks.capacity() * sizeof(Chunk); }
+  /// Returns the encoded chunks of the list.
+  llvm::ArrayRef<Chunk> chunks() const {
+    return Storage.empty() ? External : llvm::makeArrayRef(Storage);
+  }
+
+  /// Returns in-memory size of external storage. Chunks the list doesn't own
+  /// are not counted.
+  size_t bytes() const { return Storage.capacity() * sizeof(Chunk); }
 
 private:
-  const std::vector<Chunk> Chunks;
+  explicit PostingList(llvm::ArrayRef<Chunk> Chunks) : External(Chunks) {}
+
+  /// The chunks of a list which owns them, or empty.
+  const std::vector<Chunk> Storage;
+  /// The chunks of a list constructed with \ref fromChunks.
+  const llvm::ArrayRef<Chunk> External;
 };
 
 } // namespace dex
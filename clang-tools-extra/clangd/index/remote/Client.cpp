@@ -0,0 +1,142 @@
+//===--- Client.cpp - Index forwarding queries to a server -------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Logger.h"
+#include "Trace.h"
+#include "index/Serialization.h"
+#include "index/remote/Remote.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+class RemoteIndex : public SymbolIndex {
+public:
+  RemoteIndex(llvm::StringRef Address, std::chrono::milliseconds Deadline)
+      : Address(Address), Deadline(Deadline) {}
+
+  bool fuzzyFind(const FuzzyFindRequest &Req,
+                 llvm::function_ref<void(const Symbol &)> Callback)
+      const override {
+    trace::Span Tracer("RemoteIndex fuzzyFind");
+    // If the query failed the results are incomplete.
+    return query("fuzzyFind", toJSON(Req), [&](const IndexFileIn &Results) {
+             if (Results.Symbols)
+               for (const Symbol &S : *Results.Symbols)
+                 Callback(S);
+           }).getValueOr(true);
+  }
+
+  void lookup(const LookupRequest &Req,
+              llvm::function_ref<void(const Symbol &)> Callback)
+      const override {
+    trace::Span Tracer("RemoteIndex lookup");
+    query("lookup", toJSON(Req), [&](const IndexFileIn &Results) {
+      if (Results.Symbols)
+        for (const Symbol &S : *Results.Symbols)
+          Callback(S);
+    });
+  }
+
+  void refs(const RefsRequest &Req,
+            llvm::function_ref<void(const Ref &)> Callback) const override {
+    trace::Span Tracer("RemoteIndex refs");
+    query("refs", toJSON(Req), [&](const IndexFileIn &Results) {
+      if (Results.Refs)
+        for (const auto &Refs : *Results.Refs)
+          for (const Ref &R : Refs.second)
+            Callback(R);
+    });
+  }
+
+  // The index lives on the server.
+  size_t estimateMemoryUsage() const override { return 0; }
+
+private:
+  // Sends a query and passes each batch of results to OnResults as it arrives.
+  // Returns whether the server has more results, or None if the query failed.
+  llvm::Optional<bool>
+  query(llvm::StringRef Method, llvm::json::Value Params,
+        llvm::function_ref<void(const IndexFileIn &)> OnResults) const {
+    std::lock_guard<std::mutex> Lock(Mu);
+    if (!Conn) {
+      auto C = Connection::connect(Address);
+      if (!C) {
+        elog("Remote index: {0}", C.takeError());
+        return llvm::None;
+      }
+      Conn = std::move(*C);
+    }
+
+    std::string Payload;
+    llvm::raw_string_ostream OS(Payload);
+    OS << llvm::json::Value(llvm::json::Object{
+        {"Method", Method},
+        {"Params", std::move(Params)},
+        {"DeadlineMs", static_cast<int64_t>(Deadline.count())},
+    });
+    if (auto Err = Conn.send(FrameKind::Query, OS.str()))
+      return fail(std::move(Err));
+
+    // The server stops the query at the deadline, allow as long again for the
+    // results to get here before giving up on the server.
+    auto GiveUp = std::chrono::steady_clock::now() + 2 * Deadline;
+    while (true) {
+      auto F = Conn.receive(GiveUp);
+      if (!F)
+        return fail(F.takeError());
+      if (F->Kind == FrameKind::Results) {
+        auto Results = readIndexFile(F->Payload);
+        if (!Results)
+          return fail(Results.takeError());
+        OnResults(*Results);
+        continue;
+      }
+      auto End = llvm::json::parse(F->Payload);
+      if (!End)
+        return fail(End.takeError());
+      const auto *Object = End->getAsObject();
+      if (F->Kind != FrameKind::End || !Object)
+        return fail(llvm::make_error<llvm::StringError>(
+            "malformed reply", llvm::inconvertibleErrorCode()));
+      if (auto Error = Object->getString("Error")) {
+        // The connection is still usable.
+        elog("Remote index {0} failed: {1}", Method, *Error);
+        return llvm::None;
+      }
+      return Object->getBoolean("HasMore").getValueOr(false);
+    }
+  }
+
+  // Drops the connection, the next query reconnects.
+  llvm::Optional<bool> fail(llvm::Error Err) const {
+    elog("Remote index: {0}", std::move(Err));
+    Conn.close();
+    return llvm::None;
+  }
+
+  std::string Address;
+  std::chrono::milliseconds Deadline;
+  // Queries are sent one at a time over a single connection.
+  mutable std::mutex Mu;
+  mutable Connection Conn; // GUARDED_BY(Mu)
+};
+
+} // namespace
+
+std::unique_ptr<SymbolIndex> getClient(llvm::StringRef Address,
+                                       std::chrono::milliseconds Deadline) {
+  return llvm::make_unique<RemoteIndex>(Address, Deadline);
+}
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
@@ -0,0 +1,68 @@
+//===--- Remote.h - Index served over the network ----------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A remote index lets many clangd instances share one index server, typically
+// holding the static index of a big codebase, instead of each loading it.
+// The server streams results as the query produces them, and stops when the
+// client's deadline passes. See Transport.h for the protocol.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_REMOTE_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_REMOTE_H
+
+#include "index/Index.h"
+#include "index/remote/Transport.h"
+#include "llvm/ADT/StringRef.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+
+/// Returns an index which forwards queries to the server at \p Address
+/// ("host:port"). The connection is made on the first query, and made again
+/// after errors.
+/// The server stops a query after \p Deadline. The results found until then
+/// are returned, and fuzzyFind() reports there may be more.
+std::unique_ptr<SymbolIndex>
+getClient(llvm::StringRef Address, std::chrono::milliseconds Deadline);
+
+/// Answers the queries of remote index clients from \p Index.
+class IndexServer {
+public:
+  IndexServer(const SymbolIndex &Index, Listener L)
+      : Index(Index), L(std::move(L)) {}
+
+  unsigned port() const { return L.port(); }
+
+  /// Serves clients until shutdown() is called. Each connection is served on
+  /// its own thread.
+  void run();
+  /// Stops accepting connections and drops the connected clients.
+  void shutdown();
+
+private:
+  void serve(Connection &C);
+
+  const SymbolIndex &Index;
+  Listener L;
+  std::atomic<bool> ShuttingDown = {false};
+  std::mutex Mu;
+  std::vector<Connection *> Clients; // GUARDED_BY(Mu)
+};
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
+
+#endif
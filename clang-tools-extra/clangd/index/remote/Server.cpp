@@ -0,0 +1,212 @@
+//===--- Server.cpp - Serving an index to remote clients ---------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Logger.h"
+#include "Threading.h"
+#include "Trace.h"
+#include "index/Serialization.h"
+#include "index/remote/Remote.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+// Results are sent in batches of this many symbols or refs, so that the client
+// can use the first ones while the query is still running.
+constexpr unsigned BatchSize = 256;
+
+// Collects the results of one query and sends them in Results frames.
+class ResultStream {
+public:
+  ResultStream(Connection &C, std::chrono::steady_clock::time_point Deadline)
+      : C(C), Deadline(Deadline) {
+    Symbols.emplace();
+    Refs.emplace();
+  }
+
+  void add(const Symbol &S) {
+    if (accept()) {
+      Symbols->insert(S);
+      if (++Batched == BatchSize)
+        flush();
+    }
+  }
+
+  void add(const Ref &R) {
+    if (accept()) {
+      // The client doesn't get the symbol of each ref, any ID will do.
+      Refs->insert(SymbolID(), R);
+      if (++Batched == BatchSize)
+        flush();
+    }
+  }
+
+  void flush() {
+    if (Batched == 0 || Err)
+      return;
+    SymbolSlab SymbolBatch = std::move(*Symbols).build();
+    RefSlab RefBatch = std::move(*Refs).build();
+    Symbols.emplace();
+    Refs.emplace();
+    Batched = 0;
+    IndexFileOut Out;
+    Out.Symbols = &SymbolBatch;
+    Out.Refs = &RefBatch;
+    std::string Payload;
+    llvm::raw_string_ostream OS(Payload);
+    OS << Out;
+    Err = C.send(FrameKind::Results, OS.str());
+  }
+
+  // Whether some results were dropped because the deadline passed.
+  bool truncated() const { return Truncated; }
+  llvm::Error takeError() { return std::move(Err); }
+
+private:
+  bool accept() {
+    if (Truncated || Err)
+      return false;
+    if (std::chrono::steady_clock::now() > Deadline) {
+      Truncated = true;
+      return false;
+    }
+    return true;
+  }
+
+  Connection &C;
+  std::chrono::steady_clock::time_point Deadline;
+  // Builders can't be assigned, emplace() the next batch instead.
+  llvm::Optional<SymbolSlab::Builder> Symbols;
+  llvm::Optional<RefSlab::Builder> Refs;
+  unsigned Batched = 0;
+  bool Truncated = false;
+  llvm::Error Err = llvm::Error::success();
+};
+
+template <typename Request>
+llvm::Optional<Request> parseParams(const llvm::json::Object &Query) {
+  Request Req;
+  if (const auto *Params = Query.get("Params"))
+    if (fromJSON(*Params, Req))
+      return std::move(Req);
+  return llvm::None;
+}
+
+} // namespace
+
+void IndexServer::run() {
+  AsyncTaskRunner Workers;
+  while (!ShuttingDown) {
+    auto C = L.accept();
+    if (!C) {
+      if (!ShuttingDown)
+        elog("Remote index server: {0}", C.takeError());
+      else
+        llvm::consumeError(C.takeError());
+      break;
+    }
+    auto Client = std::make_shared<Connection>(std::move(*C));
+    {
+      std::lock_guard<std::mutex> Lock(Mu);
+      Clients.push_back(Client.get());
+      // shutdown() may have missed this client.
+      if (ShuttingDown)
+        Client->shutdown();
+    }
+    Workers.runAsync("remote-index-client", [this, Client] {
+      serve(*Client);
+      std::lock_guard<std::mutex> Lock(Mu);
+      Clients.erase(std::find(Clients.begin(), Clients.end(), Client.get()));
+    });
+  }
+  // Workers waits for the clients being served.
+}
+
+void IndexServer::shutdown() {
+  ShuttingDown = true;
+  L.shutdown();
+  std::lock_guard<std::mutex> Lock(Mu);
+  for (Connection *C : Clients)
+    C->shutdown();
+}
+
+void IndexServer::serve(Connection &C) {
+  while (true) {
+    auto F = C.receive();
+    if (!F) {
+      vlog("Remote index client disconnected: {0}", F.takeError());
+      return;
+    }
+    auto Start = std::chrono::steady_clock::now();
+    auto Query = llvm::json::parse(F->Payload);
+    const llvm::json::Object *Object = Query ? Query->getAsObject() : nullptr;
+    if (F->Kind != FrameKind::Query || !Object) {
+      if (!Query)
+        llvm::consumeError(Query.takeError());
+      elog("Remote index client sent a malformed query, disconnecting");
+      return;
+    }
+    auto Deadline = std::chrono::steady_clock::time_point::max();
+    if (auto DeadlineMs = Object->getInteger("DeadlineMs"))
+      Deadline = Start + std::chrono::milliseconds(*DeadlineMs);
+    llvm::StringRef Method = Object->getString("Method").getValueOr("");
+    trace::Span Tracer(("RemoteIndex serve " + Method).str());
+
+    ResultStream Results(C, Deadline);
+    bool HasMore = false;
+    llvm::Optional<std::string> Error;
+    if (Method == "fuzzyFind") {
+      if (auto Req = parseParams<FuzzyFindRequest>(*Object))
+        HasMore = Index.fuzzyFind(*Req, [&](const Symbol &S) {
+          Results.add(S);
+        });
+      else
+        Error = "malformed fuzzyFind request";
+    } else if (Method == "lookup") {
+      if (auto Req = parseParams<LookupRequest>(*Object))
+        Index.lookup(*Req, [&](const Symbol &S) { Results.add(S); });
+      else
+        Error = "malformed lookup request";
+    } else if (Method == "refs") {
+      if (auto Req = parseParams<RefsRequest>(*Object))
+        Index.refs(*Req, [&](const Ref &R) { Results.add(R); });
+      else
+        Error = "malformed refs request";
+    } else {
+      Error = ("unknown method " + Method).str();
+    }
+    Results.flush();
+    if (auto Err = Results.takeError()) {
+      vlog("Remote index client disconnected: {0}", std::move(Err));
+      return;
+    }
+    if (Results.truncated())
+      vlog("Remote index {0} stopped at the client's deadline", Method);
+
+    llvm::json::Object End;
+    if (Error)
+      End["Error"] = std::move(*Error);
+    else
+      End["HasMore"] = HasMore || Results.truncated();
+    std::string Payload;
+    llvm::raw_string_ostream OS(Payload);
+    OS << llvm::json::Value(std::move(End));
+    if (auto Err = C.send(FrameKind::End, OS.str())) {
+      vlog("Remote index client disconnected: {0}", std::move(Err));
+      return;
+    }
+  }
+}
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
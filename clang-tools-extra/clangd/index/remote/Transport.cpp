@@ -0,0 +1,282 @@
+//===--- Transport.cpp - Framed messages over TCP for the remote index ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Transport.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Errno.h"
+#include "llvm/Support/FormatVariadic.h"
+
+#ifdef LLVM_ON_UNIX
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+llvm::Error makeError(const llvm::Twine &Msg) {
+  return llvm::make_error<llvm::StringError>(Msg,
+                                             llvm::inconvertibleErrorCode());
+}
+
+llvm::Error makeErrno(const llvm::Twine &Msg) {
+#ifdef LLVM_ON_UNIX
+  return makeError(Msg + ": " + llvm::sys::StrError());
+#else
+  return makeError(Msg);
+#endif
+}
+
+// Splits "host:port". The host may be bracketed ("[::1]:50051").
+llvm::Error splitAddress(llvm::StringRef Address, std::string &Host,
+                         std::string &Port) {
+  size_t Colon = Address.rfind(':');
+  if (Colon == llvm::StringRef::npos)
+    return makeError("address must have the form host:port: " + Address);
+  llvm::StringRef H = Address.take_front(Colon);
+  if (H.startswith("[") && H.endswith("]"))
+    H = H.drop_front().drop_back();
+  Host = H;
+  Port = Address.drop_front(Colon + 1);
+  return llvm::Error::success();
+}
+
+constexpr size_t HeaderSize = 5;
+// Frames bigger than this are malformed rather than merely large.
+constexpr uint32_t MaxPayloadSize = 1u << 30;
+
+} // namespace
+
+#ifdef LLVM_ON_UNIX
+
+Connection &Connection::operator=(Connection &&Other) {
+  if (this != &Other) {
+    close();
+    FD = Other.FD;
+    Other.FD = -1;
+  }
+  return *this;
+}
+
+void Connection::close() {
+  if (FD >= 0)
+    ::close(FD);
+  FD = -1;
+}
+
+void Connection::shutdown() {
+  if (FD >= 0)
+    ::shutdown(FD, SHUT_RDWR);
+}
+
+llvm::Expected<Connection> Connection::connect(llvm::StringRef Address) {
+  std::string Host, Port;
+  if (auto Err = splitAddress(Address, Host, Port))
+    return std::move(Err);
+  addrinfo Hints = {};
+  Hints.ai_family = AF_UNSPEC;
+  Hints.ai_socktype = SOCK_STREAM;
+  addrinfo *Addresses;
+  if (int Err = getaddrinfo(Host.c_str(), Port.c_str(), &Hints, &Addresses))
+    return makeError(llvm::formatv("can't resolve {0}: {1}", Address,
+                                   gai_strerror(Err)));
+  Connection Result;
+  for (addrinfo *A = Addresses; A && !Result; A = A->ai_next) {
+    int FD = socket(A->ai_family, A->ai_socktype, A->ai_protocol);
+    if (FD < 0)
+      continue;
+    if (::connect(FD, A->ai_addr, A->ai_addrlen) == 0)
+      Result = Connection(FD);
+    else
+      ::close(FD);
+  }
+  freeaddrinfo(Addresses);
+  if (!Result)
+    return makeErrno("can't connect to " + Address);
+  // Queries are small and latency-sensitive.
+  int One = 1;
+  setsockopt(Result.FD, IPPROTO_TCP, TCP_NODELAY, &One, sizeof(One));
+  return std::move(Result);
+}
+
+llvm::Error Connection::send(FrameKind Kind, llvm::StringRef Payload) {
+  char Header[HeaderSize];
+  Header[0] = static_cast<char>(Kind);
+  llvm::support::endian::write32le(Header + 1, Payload.size());
+  for (llvm::StringRef Data : {llvm::StringRef(Header, HeaderSize), Payload}) {
+    while (!Data.empty()) {
+      ssize_t Written = llvm::sys::RetryAfterSignal(
+          -1, ::send, FD, Data.data(), Data.size(), MSG_NOSIGNAL);
+      if (Written < 0)
+        return makeErrno("can't send frame");
+      Data = Data.drop_front(Written);
+    }
+  }
+  return llvm::Error::success();
+}
+
+llvm::Expected<Frame>
+Connection::receive(std::chrono::steady_clock::time_point Deadline) {
+  auto Read = [&](char *Out, size_t Size) -> llvm::Error {
+    while (Size > 0) {
+      if (Deadline != std::chrono::steady_clock::time_point::max()) {
+        auto Timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+            Deadline - std::chrono::steady_clock::now());
+        pollfd P = {FD, POLLIN, 0};
+        int Ready = llvm::sys::RetryAfterSignal(
+            -1, ::poll, &P, 1, std::max<int>(0, Timeout.count()));
+        if (Ready < 0)
+          return makeErrno("can't wait for frame");
+        if (Ready == 0)
+          return makeError("deadline exceeded");
+      }
+      ssize_t Got = llvm::sys::RetryAfterSignal(-1, ::recv, FD, Out, Size, 0);
+      if (Got < 0)
+        return makeErrno("can't receive frame");
+      if (Got == 0)
+        return makeError("connection closed");
+      Out += Got;
+      Size -= Got;
+    }
+    return llvm::Error::success();
+  };
+  char Header[HeaderSize];
+  if (auto Err = Read(Header, HeaderSize))
+    return std::move(Err);
+  Frame Result;
+  Result.Kind = static_cast<FrameKind>(Header[0]);
+  uint32_t Size = llvm::support::endian::read32le(Header + 1);
+  if (Size > MaxPayloadSize)
+    return makeError("malformed frame");
+  Result.Payload.resize(Size);
+  if (auto Err = Read(&Result.Payload[0], Size))
+    return std::move(Err);
+  return std::move(Result);
+}
+
+Listener &Listener::operator=(Listener &&Other) {
+  if (this != &Other) {
+    close();
+    FD = Other.FD;
+    Port = Other.Port;
+    Other.FD = -1;
+  }
+  return *this;
+}
+
+void Listener::close() {
+  if (FD >= 0)
+    ::close(FD);
+  FD = -1;
+}
+
+void Listener::shutdown() {
+  if (FD >= 0)
+    ::shutdown(FD, SHUT_RDWR);
+}
+
+llvm::Expected<Listener> Listener::listen(llvm::StringRef Address) {
+  std::string Host, Port;
+  if (auto Err = splitAddress(Address, Host, Port))
+    return std::move(Err);
+  addrinfo Hints = {};
+  Hints.ai_family = AF_UNSPEC;
+  Hints.ai_socktype = SOCK_STREAM;
+  Hints.ai_flags = AI_PASSIVE;
+  addrinfo *Addresses;
+  if (int Err = getaddrinfo(Host.empty() ? nullptr : Host.c_str(),
+                            Port.c_str(), &Hints, &Addresses))
+    return makeError(llvm::formatv("can't resolve {0}: {1}", Address,
+                                   gai_strerror(Err)));
+  Listener Result;
+  for (addrinfo *A = Addresses; A && Result.FD < 0; A = A->ai_next) {
+    int FD = socket(A->ai_family, A->ai_socktype, A->ai_protocol);
+    if (FD < 0)
+      continue;
+    int One = 1;
+    setsockopt(FD, SOL_SOCKET, SO_REUSEADDR, &One, sizeof(One));
+    if (bind(FD, A->ai_addr, A->ai_addrlen) == 0 && ::listen(FD, 128) == 0)
+      Result.FD = FD;
+    else
+      ::close(FD);
+  }
+  freeaddrinfo(Addresses);
+  if (Result.FD < 0)
+    return makeErrno("can't listen on " + Address);
+
+  sockaddr_storage Bound;
+  socklen_t BoundSize = sizeof(Bound);
+  if (getsockname(Result.FD, reinterpret_cast<sockaddr *>(&Bound),
+                  &BoundSize) == 0) {
+    if (Bound.ss_family == AF_INET)
+      Result.Port = ntohs(reinterpret_cast<sockaddr_in *>(&Bound)->sin_port);
+    else if (Bound.ss_family == AF_INET6)
+      Result.Port =
+          ntohs(reinterpret_cast<sockaddr_in6 *>(&Bound)->sin6_port);
+  }
+  return std::move(Result);
+}
+
+llvm::Expected<Connection> Listener::accept() {
+  int Accepted =
+      llvm::sys::RetryAfterSignal(-1, ::accept, FD, nullptr, nullptr);
+  if (Accepted < 0)
+    return makeErrno("can't accept connection");
+  int One = 1;
+  setsockopt(Accepted, IPPROTO_TCP, TCP_NODELAY, &One, sizeof(One));
+  return Connection(Accepted);
+}
+
+#else // !LLVM_ON_UNIX
+
+Connection &Connection::operator=(Connection &&Other) {
+  FD = Other.FD;
+  Other.FD = -1;
+  return *this;
+}
+void Connection::close() { FD = -1; }
+void Connection::shutdown() {}
+llvm::Expected<Connection> Connection::connect(llvm::StringRef Address) {
+  return makeError("the remote index is not supported on this platform");
+}
+llvm::Error Connection::send(FrameKind, llvm::StringRef) {
+  return makeError("the remote index is not supported on this platform");
+}
+llvm::Expected<Frame>
+Connection::receive(std::chrono::steady_clock::time_point) {
+  return makeError("the remote index is not supported on this platform");
+}
+
+Listener &Listener::operator=(Listener &&Other) {
+  FD = Other.FD;
+  Port = Other.Port;
+  Other.FD = -1;
+  return *this;
+}
+void Listener::close() { FD = -1; }
+void Listener::shutdown() {}
+llvm::Expected<Listener> Listener::listen(llvm::StringRef Address) {
+  return makeError("the remote index is not supported on this platform");
+}
+llvm::Expected<Connection> Listener::accept() {
+  return makeError("the remote index is not supported on this platform");
+}
+
+#endif // LLVM_ON_UNIX
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
@@ -0,0 +1,105 @@
+//===--- Transport.h - Framed messages for the remote index ------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The remote index client and server exchange frames over a TCP connection.
+// A frame is a one byte kind, a 32-bit little-endian payload size and the
+// payload. The client sends one Query frame per request:
+//   {"Method": "fuzzyFind", "Params": {...}, "DeadlineMs": 100}
+// and the server answers with any number of Results frames, each an index
+// file (see Serialization.h) holding the next batch of symbols or refs, and
+// then one End frame:
+//   {"HasMore": false}   or   {"Error": "message"}
+// Results are thus streamed to the client while the query is still running.
+//
+// Sockets are only implemented for POSIX systems. Elsewhere connecting or
+// listening fails with an error.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_TRANSPORT_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_TRANSPORT_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include <chrono>
+#include <string>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+
+enum class FrameKind : char {
+  Query = 'Q',
+  Results = 'R',
+  End = 'E',
+};
+
+struct Frame {
+  FrameKind Kind;
+  std::string Payload;
+};
+
+/// A connected stream socket. Sending and receiving are not synchronized,
+/// callers must not use one connection from several threads at once.
+class Connection {
+public:
+  /// Connects to "host:port".
+  static llvm::Expected<Connection> connect(llvm::StringRef Address);
+
+  Connection() = default;
+  explicit Connection(int FD) : FD(FD) {}
+  Connection(Connection &&Other) : FD(Other.FD) { Other.FD = -1; }
+  Connection &operator=(Connection &&Other);
+  ~Connection() { close(); }
+
+  explicit operator bool() const { return FD >= 0; }
+  void close();
+  /// Makes blocked and future reads fail, from any thread.
+  void shutdown();
+
+  llvm::Error send(FrameKind Kind, llvm::StringRef Payload);
+  /// Receives the next frame. Fails if none arrives before \p Deadline.
+  llvm::Expected<Frame>
+  receive(std::chrono::steady_clock::time_point Deadline =
+              std::chrono::steady_clock::time_point::max());
+
+private:
+  int FD = -1;
+};
+
+/// A socket listening for connections.
+class Listener {
+public:
+  /// Listens on "host:port". Port 0 picks any free port, see port().
+  static llvm::Expected<Listener> listen(llvm::StringRef Address);
+
+  Listener() = default;
+  Listener(Listener &&Other) : FD(Other.FD), Port(Other.Port) {
+    Other.FD = -1;
+  }
+  Listener &operator=(Listener &&Other);
+  ~Listener() { close(); }
+
+  unsigned port() const { return Port; }
+  void close();
+  /// Makes blocked and future accept() calls fail, from any thread.
+  void shutdown();
+
+  /// Waits for the next connection.
+  llvm::Expected<Connection> accept();
+
+private:
+  int FD = -1;
+  unsigned Port = 0;
+};
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
+
+#endif
@@ -0,0 +1,77 @@
+//===--- IndexServer.cpp - Serve an index to remote clangd clients --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This tool loads an index produced by clangd-indexer, like dexp does, and
+// answers the queries of clangd instances started with -remote-index-address.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Logger.h"
+#include "index/Serialization.h"
+#include "index/remote/Remote.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Signals.h"
+
+namespace clang {
+namespace clangd {
+namespace {
+
+llvm::cl::opt<std::string> IndexPath("index-path",
+                                     llvm::cl::desc("Path to the index"),
+                                     llvm::cl::Positional, llvm::cl::Required);
+
+llvm::cl::opt<std::string> ListenAddress(
+    "listen-address",
+    llvm::cl::desc("Address to listen on, as host:port. The server has no "
+                   "authentication, only listen where the clients are "
+                   "trusted."),
+    llvm::cl::init("localhost:50051"));
+
+llvm::cl::opt<Logger::Level> LogLevel(
+    "log", llvm::cl::desc("Verbosity of log messages written to stderr"),
+    llvm::cl::values(clEnumValN(Logger::Error, "error", "Error messages only"),
+                     clEnumValN(Logger::Info, "info",
+                                "High level execution tracing"),
+                     clEnumValN(Logger::Debug, "verbose", "Low level details")),
+    llvm::cl::init(Logger::Info));
+
+static const std::string Overview = R"(
+This is an **experimental** server which answers the symbol index queries of
+clangd instances over the network, so that a big index can be shared by many
+of them instead of each loading it.
+)";
+
+} // namespace
+} // namespace clangd
+} // namespace clang
+
+int main(int argc, const char *argv[]) {
+  using namespace clang::clangd;
+
+  llvm::cl::ParseCommandLineOptions(argc, argv, Overview);
+  llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
+
+  StreamLogger Logger(llvm::errs(), LogLevel);
+  LoggingSession LoggingSession(Logger);
+
+  std::unique_ptr<SymbolIndex> Index = loadIndex(IndexPath, /*UseDex=*/true);
+  if (!Index) {
+    elog("Failed to open the index {0}", IndexPath);
+    return 1;
+  }
+
+  auto L = remote::Listener::listen(ListenAddress);
+  if (!L) {
+    elog("{0}", L.takeError());
+    return 1;
+  }
+  log("Serving {0} on port {1}", IndexPath, L->port());
+  remote::IndexServer Server(*Index, std::move(*L));
+  Server.run();
+  return 0;
+}
@@ -35,6 +35,12 @@ static llvm::cl::opt<IndexFileFormat>
                                        "binary RIFF format")),
            llvm::cl::init(IndexFileFormat::RIFF));
 
+static llvm::cl::opt<bool> PostingLists(
+    "posting-lists",
+    llvm::cl::desc("Store the Dex posting lists of the symbols in the binary "
+                   "index, so that clangd loads it without building them"),
+    llvm::cl::init(false));
+
 class IndexActionFactory : public tooling::FrontendActionFactory {
 public:
   IndexActionFactory(IndexFileIn &Result) : Result(Result) {}
@@ -121,6 +127,7 @@ int main(int argc, const char **argv) {
   // Emit collected data.
   clang::clangd::IndexFileOut Out(Data);
   Out.Format = clang::clangd::Format;
+  Out.IncludePostingLists = clang::clangd::PostingLists;
   llvm::outs() << Out;
   return 0;
 }
@@ -15,6 +15,7 @@
 #include "Transport.h"
 #include "index/Background.h"
 #include "index/Serialization.h"
+#include "index/remote/Remote.h"
 #include "clang/Basic/Version.h"
 #include "clang/Format/Format.h"
 #include "llvm/ADT/Optional.h"
@@ -189,6 +190,19 @@ static llvm::cl::opt<Path> IndexFile(
         "eventually. Don't rely on it."),
     llvm::cl::init(""), llvm::cl::Hidden);
 
+static llvm::cl::opt<std::string> RemoteIndexAddress(
+    "remote-index-address",
+    llvm::cl::desc(
+        "Address (host:port) of a clangd-index-server to use as the static "
+        "index, instead of loading -index-file."),
+    llvm::cl::init(""), llvm::cl::Hidden);
+
+static llvm::cl::opt<int> RemoteIndexDeadline(
+    "remote-index-deadline",
+    llvm::cl::desc("Milliseconds the remote index server may spend on a "
+                   "query before returning the results found so far."),
+    llvm::cl::init(300), llvm::cl::Hidden);
+
 static llvm::cl::opt<bool> EnableBackgroundIndex(
     "background-index",
     llvm::cl::desc(
@@ -204,6 +218,12 @@ static llvm::cl::opt<int> BackgroundIndexRebuildPeriod(
         "symbol index will be updated for each indexed file."),
     llvm::cl::init(5000), llvm::cl::Hidden);
 
+static llvm::cl::opt<unsigned> ASTMemoryLimit(
+    "ast-memory-limit",
+    llvm::cl::desc("Maximum memory, in MiB, used by the ASTs retained for "
+                   "idle files. 0 means only their number is limited."),
+    llvm::cl::init(0), llvm::cl::Hidden);
+
 enum CompileArgsFrom { LSPCompileArgs, FilesystemCompileArgs };
 static llvm::cl::opt<CompileArgsFrom> CompileArgsFrom(
     "compile_args_from", llvm::cl::desc("The source of compile commands"),
@@ -451,9 +471,14 @@ int main(int argc, char *argv[]) {
   Opts.HeavyweightDynamicSymbolIndex = UseDex;
   Opts.BackgroundIndex = EnableBackgroundIndex;
   Opts.BackgroundIndexRebuildPeriodMs = BackgroundIndexRebuildPeriod;
+  Opts.RetentionPolicy.MaxRetainedASTBytes =
+      std::size_t(ASTMemoryLimit) * 1024 * 1024;
   std::unique_ptr<SymbolIndex> StaticIdx;
   std::future<void> AsyncIndexLoad; // Block exit while loading the index.
-  if (EnableIndex && !IndexFile.empty()) {
+  if (EnableIndex && !RemoteIndexAddress.empty()) {
+    StaticIdx = remote::getClient(
+        RemoteIndexAddress, std::chrono::milliseconds(RemoteIndexDeadline));
+  } else if (EnableIndex && !IndexFile.empty()) {
     // Load the index asynchronously. Meanwhile SwapIndex returns no results.
     SwapIndex *Placeholder;
     StaticIdx.reset(Placeholder = new SwapIndex(llvm::make_unique<MemIndex>()));
@@ -163,6 +163,35 @@ TEST_F(BackgroundIndexTest, IndexTwoFiles) {
                        FileURI("unittest:///root/B.cc")}));
 }
 
+TEST_F(BackgroundIndexTest, StatsWhenIdle) {
+  MockFSProvider FS;
+  FS.Files[testPath("root/A.h")] = "void f_h();";
+  FS.Files[testPath("root/A.cc")] = "#include \"A.h\"\nvoid f_cc();";
+  llvm::StringMap<std::string> Storage;
+  size_t CacheHits = 0;
+  MemoryShardStorage MSS(Storage, CacheHits);
+  OverlayCDB CDB(/*Base=*/nullptr);
+  BackgroundIndex Idx(Context::empty(), FS, CDB,
+                      [&](llvm::StringRef) { return &MSS; });
+  // Boosting files that are not queued is a no-op.
+  Idx.boostRelated(testPath("root/A.h"));
+
+  tooling::CompileCommand Cmd;
+  Cmd.Filename = testPath("root/A.cc");
+  Cmd.Directory = testPath("root");
+  Cmd.CommandLine = {"clang++", testPath("root/A.cc")};
+  CDB.setCompileCommand(testPath("root/A.cc"), Cmd);
+  Idx.boostRelated(testPath("root/A.h"));
+
+  ASSERT_TRUE(Idx.blockUntilIdleForTest());
+  EXPECT_THAT(runFuzzyFind(Idx, ""),
+              UnorderedElementsAre(Named("f_h"), Named("f_cc")));
+  auto Stats = Idx.stats();
+  EXPECT_EQ(Stats.QueuedTUs, 0U);
+  EXPECT_EQ(Stats.ActiveTUs, 0U);
+  EXPECT_EQ(Stats.Staleness.count(), 0);
+}
+
 TEST_F(BackgroundIndexTest, ShardStorageTest) {
   MockFSProvider FS;
   FS.Files[testPath("root/A.h")] = R"cpp(
@@ -68,6 +68,31 @@ TEST(DexIterators, DocumentIterator) {
   EXPECT_TRUE(DocIterator->reachedEnd());
 }
 
+TEST(DexIterators, DenseAndSparseChunks) {
+  // Chunks with single byte deltas only, with longer ones, and mixed.
+  std::vector<DocID> Docs;
+  for (DocID I = 0; I < 200; I += 3)
+    Docs.push_back(I);
+  for (DocID I = 200; I < 100000; I += 997)
+    Docs.push_back(I);
+  for (DocID I = 100000, Step = 1; I < 101000;
+       I += Step, Step = Step == 1 ? 200 : 1)
+    Docs.push_back(I);
+  const PostingList L(Docs);
+  auto DocIterator = L.iterator();
+  EXPECT_EQ(consumeIDs(*DocIterator), Docs);
+
+  for (DocID Target : {0U, 1U, 199U, 200U, 5000U, 100000U, 100399U}) {
+    DocIterator = L.iterator();
+    DocIterator->advanceTo(Target);
+    ASSERT_FALSE(DocIterator->reachedEnd());
+    EXPECT_EQ(DocIterator->peek(),
+              *std::lower_bound(Docs.begin(), Docs.end(), Target));
+  }
+  DocIterator->advanceTo(Docs.back() + 1);
+  EXPECT_TRUE(DocIterator->reachedEnd());
+}
+
 TEST(DexIterators, AndTwoLists) {
   Corpus C{10000};
   const PostingList L0({0, 5, 7, 10, 42, 320, 9000});
@@ -0,0 +1,115 @@
+//===-- RemoteIndexTests.cpp  -------------------------*- C++ -*-----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TestIndex.h"
+#include "index/MemIndex.h"
+#include "index/remote/Remote.h"
+#include "llvm/Config/llvm-config.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <thread>
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAre;
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+#ifdef LLVM_ON_UNIX
+
+MATCHER_P(FileURI, F, "") { return llvm::StringRef(arg.Location.FileURI) == F; }
+
+// Runs an index server on a free local port for the duration of a test.
+class ServerThread {
+public:
+  ServerThread(const SymbolIndex &Index) {
+    auto L = Listener::listen("localhost:0");
+    EXPECT_TRUE(bool(L)) << llvm::toString(L.takeError());
+    Server = llvm::make_unique<IndexServer>(Index, std::move(*L));
+    Thread = std::thread([this] { Server->run(); });
+  }
+  ~ServerThread() {
+    Server->shutdown();
+    Thread.join();
+  }
+
+  std::string address() const {
+    return "localhost:" + std::to_string(Server->port());
+  }
+
+private:
+  std::unique_ptr<IndexServer> Server;
+  std::thread Thread;
+};
+
+TEST(RemoteIndexTest, ForwardsQueries) {
+  SymbolSlab::Builder Symbols;
+  // More symbols than fit in one batch of results.
+  for (const auto &S : generateNumSymbols(0, 999))
+    Symbols.insert(S);
+  Symbol Foo = symbol("ns::foo");
+  Symbols.insert(Foo);
+  RefSlab::Builder Refs;
+  Ref R;
+  R.Kind = RefKind::Reference;
+  R.Location.FileURI = "unittest:///a.cc";
+  Refs.insert(Foo.ID, R);
+  R.Location.FileURI = "unittest:///b.cc";
+  Refs.insert(Foo.ID, R);
+  auto Local = MemIndex::build(std::move(Symbols).build(),
+                               std::move(Refs).build());
+
+  ServerThread Server(*Local);
+  auto Remote = getClient(Server.address(), std::chrono::seconds(10));
+
+  FuzzyFindRequest Req;
+  Req.AnyScope = true;
+  bool Incomplete;
+  EXPECT_EQ(match(*Remote, Req, &Incomplete).size(), 1001u);
+  EXPECT_FALSE(Incomplete);
+  Req.Query = "foo";
+  EXPECT_THAT(match(*Remote, Req, &Incomplete), ElementsAre("ns::foo"));
+  Req.Query = "";
+  Req.Limit = 10;
+  EXPECT_EQ(match(*Remote, Req, &Incomplete).size(), 10u);
+  EXPECT_TRUE(Incomplete);
+
+  EXPECT_THAT(lookup(*Remote, Foo.ID), ElementsAre("ns::foo"));
+
+  RefsRequest RefsReq;
+  RefsReq.IDs.insert(Foo.ID);
+  std::vector<Ref> Results;
+  Remote->refs(RefsReq, [&](const Ref &R) { Results.push_back(R); });
+  EXPECT_THAT(Results, UnorderedElementsAre(FileURI("unittest:///a.cc"),
+                                            FileURI("unittest:///b.cc")));
+}
+
+TEST(RemoteIndexTest, ServerUnavailable) {
+  std::string Address;
+  {
+    auto L = Listener::listen("localhost:0");
+    ASSERT_TRUE(bool(L)) << llvm::toString(L.takeError());
+    Address = "localhost:" + std::to_string(L->port());
+  }
+  auto Remote = getClient(Address, std::chrono::seconds(10));
+  FuzzyFindRequest Req;
+  Req.AnyScope = true;
+  bool Incomplete;
+  EXPECT_THAT(match(*Remote, Req, &Incomplete), IsEmpty());
+  EXPECT_TRUE(Incomplete);
+}
+
+#endif // LLVM_ON_UNIX
+
+} // namespace
+} // namespace remote
+} // namespace clangd
+} // namespace clang
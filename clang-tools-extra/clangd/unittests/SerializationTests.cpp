@@ -215,6 +215,40 @@ TEST(SerializationTest, SrcsTest) {
   }
 }
 
+TEST(SerializationTest, PostingListsTest) {
+  auto In = readIndexFile(YAML);
+  EXPECT_TRUE(bool(In)) << In.takeError();
+
+  IndexFileOut Out(*In);
+  Out.Format = IndexFileFormat::RIFF;
+  Out.IncludePostingLists = true;
+  std::string Serialized = llvm::to_string(Out);
+
+  auto In2 = readIndexFile(Serialized);
+  ASSERT_TRUE(bool(In2)) << In2.takeError();
+  ASSERT_TRUE(In2->Symbols);
+  ASSERT_TRUE(In2->PostingLists);
+  EXPECT_EQ(In2->PostingLists->SymbolOrder.size(), In2->Symbols->size());
+
+  // The index using the stored posting lists finds what a built one does.
+  auto Built = dex::Dex::build(std::move(*In->Symbols), RefSlab());
+  auto Loaded = dex::Dex::build(std::move(*In2->Symbols), RefSlab(),
+                                std::move(*In2->PostingLists), nullptr);
+  FuzzyFindRequest Req;
+  Req.Query = "Foo";
+  Req.AnyScope = true;
+  auto Names = [&](const SymbolIndex &Index) {
+    std::vector<std::string> Result;
+    Index.fuzzyFind(Req, [&](const Symbol &Sym) {
+      Result.push_back((Sym.Scope + Sym.Name).str());
+    });
+    return Result;
+  };
+  EXPECT_THAT(Names(*Loaded), testing::ElementsAreArray(Names(*Built)));
+  EXPECT_THAT(Names(*Loaded), UnorderedElementsAre("clang::Foo1",
+                                                   "clang::Foo2"));
+}
+
 } // namespace
 } // namespace clangd
 } // namespace clang
@@ -485,6 +485,31 @@ TEST_F(TUSchedulerTests, EvictedAST) {
               UnorderedElementsAre(Foo, AnyOf(Bar, Baz)));
 }
 
+TEST_F(TUSchedulerTests, EvictsASTsOverMemoryLimit) {
+  ASTRetentionPolicy Policy;
+  Policy.MaxRetainedASTs = 10;
+  // Any AST is larger than this, so only the most recent one is retained.
+  Policy.MaxRetainedASTBytes = 1;
+  TUScheduler S(CDB,
+                /*AsyncThreadsCount=*/getDefaultAsyncThreadsCount(),
+                /*StorePreambleInMemory=*/true, /*ASTCallbacks=*/nullptr,
+                /*UpdateDebounce=*/std::chrono::steady_clock::duration::zero(),
+                Policy);
+
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+  updateWithCallback(S, Foo, "int x;", WantDiagnostics::Yes, [] {});
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  updateWithCallback(S, Bar, "int y;", WantDiagnostics::Yes, [] {});
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_THAT(S.getFilesWithCachedAST(), UnorderedElementsAre(Bar));
+
+  MemoryTree MT;
+  S.profile(MT);
+  EXPECT_EQ(MT.child(Foo).child("ast").Self, 0u);
+  EXPECT_GT(MT.child(Bar).child("ast").Self, 0u);
+}
+
 TEST_F(TUSchedulerTests, EmptyPreamble) {
   TUScheduler S(CDB,
                 /*AsyncThreadsCount=*/4, /*StorePreambleInMemory=*/true,
@@ -508,7 +533,7 @@ TEST_F(TUSchedulerTests, EmptyPreamble) {
       [&](Expected<InputsAndPreamble> Preamble) {
         // We expect to get a non-empty preamble.
         EXPECT_GT(
-            cantFail(std::move(Preamble)).Preamble->Preamble.getBounds().Size,
+            cantFail(std::move(Preamble)).Preamble->Preamble->getBounds().Size,
             0u);
       });
   // Wait for the preamble is being built.
@@ -523,11 +548,51 @@ TEST_F(TUSchedulerTests, EmptyPreamble) {
       [&](Expected<InputsAndPreamble> Preamble) {
         // We expect to get an empty preamble.
         EXPECT_EQ(
-            cantFail(std::move(Preamble)).Preamble->Preamble.getBounds().Size,
+            cantFail(std::move(Preamble)).Preamble->Preamble->getBounds().Size,
             0u);
       });
 }
 
+TEST_F(TUSchedulerTests, SharesPreamblesAcrossFiles) {
+  TUScheduler S(CDB,
+                /*AsyncThreadsCount=*/4, /*StorePreambleInMemory=*/true,
+                /*ASTCallbacks=*/nullptr,
+                /*UpdateDebounce=*/std::chrono::steady_clock::duration::zero(),
+                ASTRetentionPolicy());
+
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+  auto Baz = testPath("baz.cpp");
+  Files[testPath("foo.h")] = "void foo();";
+  Timestamps[testPath("foo.h")] = time_t(0);
+  Files[testPath("baz.h")] = "void baz();";
+  Timestamps[testPath("baz.h")] = time_t(0);
+
+  S.update(Foo, getInputs(Foo, "#include \"foo.h\"\nint x;"),
+           WantDiagnostics::No);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  S.update(Bar, getInputs(Bar, "#include \"foo.h\"\nint y;"),
+           WantDiagnostics::No);
+  S.update(Baz, getInputs(Baz, "#include \"baz.h\"\nint z;"),
+           WantDiagnostics::No);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+
+  std::mutex Mut;
+  llvm::StringMap<const PrecompiledPreamble *> PCHs;
+  for (PathRef File : {Foo, Bar, Baz})
+    S.runWithPreamble(
+        "getPreamble", File, TUScheduler::Stale,
+        [&, File](Expected<InputsAndPreamble> Preamble) {
+          std::lock_guard<std::mutex> Lock(Mut);
+          PCHs[File] = cantFail(std::move(Preamble)).Preamble->Preamble.get();
+        });
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  ASSERT_EQ(PCHs.size(), 3u);
+  EXPECT_NE(PCHs[Foo], nullptr);
+  EXPECT_EQ(PCHs[Foo], PCHs[Bar]);
+  EXPECT_NE(PCHs[Foo], PCHs[Baz]);
+}
+
 TEST_F(TUSchedulerTests, RunWaitsForPreamble) {
   // Testing strategy: we update the file and schedule a few preamble reads at
   // the same time. All reads should get the same non-null preamble.
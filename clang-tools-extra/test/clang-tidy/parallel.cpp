@@ -0,0 +1,16 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t/include %t/a %t/b
+// RUN: echo 'int *HP = 0;' > %t/include/header.h
+// RUN: echo '#include "header.h"' > %t/a/a.cpp
+// RUN: echo 'int *AA = 0;' >> %t/a/a.cpp
+// RUN: echo '#include "header.h"' > %t/b/b.cpp
+// RUN: echo 'int *BB = 0;' >> %t/b/b.cpp
+// The files are compiled in different directories and find the header through
+// relative include paths.
+// RUN: echo '[{"directory": "%/t/a", "command": "clang++ -c -I../include a.cpp", "file": "%/t/a/a.cpp"},' > %t/compile_commands.json
+// RUN: echo ' {"directory": "%/t/b", "command": "clang++ -c -I../include b.cpp", "file": "%/t/b/b.cpp"}]' >> %t/compile_commands.json
+// RUN: clang-tidy -j2 -checks='-*,modernize-use-nullptr' -header-filter=.* -p %t %t/a/a.cpp %t/b/b.cpp 2>&1 | FileCheck %s -implicit-check-not='{{warning|error}}:'
+
+// CHECK-DAG: a.cpp:2:11: warning: use nullptr
+// CHECK-DAG: b.cpp:2:11: warning: use nullptr
+// CHECK-DAG: header.h:1:11: warning: use nullptr
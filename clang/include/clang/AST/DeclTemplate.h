@@ -848,7 +848,13 @@ protected:
     return SpecIterator<EntryType>(isEnd ? Specs.end() : Specs.begin());
   }
 
-  void loadLazySpecializationsImpl() const;
+  /// Load the lazily-loaded specializations from the external source, or
+  /// only the partial specializations if \p OnlyPartial.
+  void loadLazySpecializationsImpl(bool OnlyPartial = false) const;
+
+  /// Load the lazily-loaded specializations which may have the template
+  /// arguments \p Args, that is the ones with the same hash of arguments.
+  void loadLazySpecializationsImpl(ArrayRef<TemplateArgument> Args) const;
 
   template <class EntryType> typename SpecEntryTraits<EntryType>::DeclType*
   findSpecializationImpl(llvm::FoldingSetVector<EntryType> &Specs,
@@ -858,6 +864,41 @@ protected:
   void addSpecializationImpl(llvm::FoldingSetVector<EntryType> &Specs,
                              EntryType *Entry, void *InsertPos);
 
+public:
+  /// A specialization known only by its external declaration ID, along with
+  /// the hash of its template arguments, so that looking up a specialization
+  /// only deserializes the ones which may match.
+  struct LazySpecializationInfo {
+    uint32_t DeclID = ~0U;
+    unsigned ArgsHash = ~0U;
+    bool IsPartial = false;
+
+    LazySpecializationInfo() = default;
+    LazySpecializationInfo(uint32_t ID, unsigned Hash, bool Partial)
+        : DeclID(ID), ArgsHash(Hash), IsPartial(Partial) {}
+
+    bool operator<(const LazySpecializationInfo &Other) const {
+      return DeclID < Other.DeclID;
+    }
+    bool operator==(const LazySpecializationInfo &Other) const {
+      return DeclID == Other.DeclID;
+    }
+  };
+
+  /// Compute the hash of the template arguments of a specialization stored in
+  /// LazySpecializationInfo. The hash only depends on the names of the
+  /// declarations the arguments refer to and the structure of their types, so
+  /// it is the same in the compilation writing an AST file and the ones
+  /// reading it, and it is the same for all the arguments which profile the
+  /// same.
+  static unsigned
+  computeSpecializationArgsHash(ArrayRef<TemplateArgument> Args);
+
+  /// Compute the hash of the template arguments of the class, variable or
+  /// function template specialization \p Spec.
+  static unsigned computeSpecializationArgsHash(const Decl *Spec);
+
+protected:
   struct CommonBase {
     CommonBase() : InstantiatedFromMember(nullptr, false) {}
 
@@ -872,9 +913,9 @@ protected:
     /// If non-null, points to an array of specializations (including
     /// partial specializations) known only by their external declaration IDs.
     ///
-    /// The first value in the array is the number of specializations/partial
-    /// specializations that follow.
-    uint32_t *LazySpecializations = nullptr;
+    /// The DeclID of the first value in the array is the number of
+    /// specializations/partial specializations that follow.
+    LazySpecializationInfo *LazySpecializations = nullptr;
   };
 
   /// Pointer to the common data shared by all declarations of this
@@ -1076,6 +1117,10 @@ public:
   /// Load any lazily-loaded specializations from the external source.
   void LoadLazySpecializations() const;
 
+  /// Load the lazily-loaded specializations which may have the template
+  /// arguments \p Args from the external source.
+  void LoadLazySpecializations(ArrayRef<TemplateArgument> Args) const;
+
   /// Get the underlying function declaration of the template.
   FunctionDecl *getTemplatedDecl() const {
     return static_cast<FunctionDecl *>(TemplatedDecl);
@@ -2169,6 +2214,10 @@ public:
   /// Load any lazily-loaded specializations from the external source.
   void LoadLazySpecializations() const;
 
+  /// Load the lazily-loaded specializations which may have the template
+  /// arguments \p Args from the external source.
+  void LoadLazySpecializations(ArrayRef<TemplateArgument> Args) const;
+
   /// Get the underlying class declarations of the template.
   CXXRecordDecl *getTemplatedDecl() const {
     return static_cast<CXXRecordDecl *>(TemplatedDecl);
@@ -2980,6 +3029,10 @@ public:
   /// Load any lazily-loaded specializations from the external source.
   void LoadLazySpecializations() const;
 
+  /// Load the lazily-loaded specializations which may have the template
+  /// arguments \p Args from the external source.
+  void LoadLazySpecializations(ArrayRef<TemplateArgument> Args) const;
+
   /// Get the underlying variable declarations of the template.
   VarDecl *getTemplatedDecl() const {
     return static_cast<VarDecl *>(TemplatedDecl);
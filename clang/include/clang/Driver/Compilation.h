@@ -22,6 +22,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -124,6 +125,12 @@ class Compilation {
   /// Whether to keep temporary files regardless of -save-temps.
   bool ForceKeepTempFiles = false;
 
+  /// The maximum number of independent jobs ExecuteJobs runs at once.
+  unsigned ParallelJobs = 1;
+
+  /// Serializes the output of the commands executed in parallel.
+  mutable std::mutex OutputMutex;
+
 public:
   Compilation(const Driver &D, const ToolChain &DefaultToolChain,
               llvm::opt::InputArgList *Args,
@@ -280,12 +287,22 @@ public:
 
   /// ExecuteJob - Execute a single job.
   ///
+  /// Up to getParallelJobs() jobs run at once; a job starts once the jobs
+  /// building its inputs have finished.
+  ///
   /// \param FailingCommands - For non-zero results, this will be a vector of
-  /// failing commands and their associated result code.
+  /// failing commands and their associated result code, in the order of the
+  /// jobs.
   void ExecuteJobs(
       const JobList &Jobs,
       SmallVectorImpl<std::pair<int, const Command *>> &FailingCommands) const;
 
+  /// ExecuteJobsInParallel - Execute the jobs of ExecuteJobs on a pool of
+  /// getParallelJobs() threads.
+  void ExecuteJobsInParallel(
+      const JobList &Jobs,
+      SmallVectorImpl<std::pair<int, const Command *>> &FailingCommands) const;
+
   /// initCompilationForDiagnostics - Remove stale state and suppress output
   /// so compilation can be reexecuted to generate additional diagnostic
   /// information (e.g., preprocessed source(s)).
@@ -297,6 +314,9 @@ public:
   /// Return whether an error during the parsing of the input args.
   bool containsError() const { return ContainsError; }
 
+  unsigned getParallelJobs() const { return ParallelJobs; }
+  void setParallelJobs(unsigned N) { ParallelJobs = N; }
+
   /// Redirect - Redirect output of this compilation. Can only be done once.
   ///
   /// \param Redirects - array of optional paths. The array should have a size
@@ -250,6 +250,18 @@ class HeaderSearch {
   /// Entity used to look up stored header file information.
   ExternalHeaderFileInfoSource *ExternalSource = nullptr;
 
+  /// An include guard recorded in the header guard cache, valid as long as
+  /// the header keeps its size and modification time.
+  struct CachedHeaderGuard {
+    off_t Size;
+    time_t ModTime;
+    std::string Macro;
+  };
+
+  /// The include guards of the header guard cache, keyed by file name.
+  llvm::StringMap<CachedHeaderGuard> CachedHeaderGuards;
+  bool CachedHeaderGuardsLoaded = false;
+
   // Various statistics we track for performance analysis.
   unsigned NumIncluded = 0;
   unsigned NumMultiIncludeFileOptzn = 0;
@@ -729,7 +741,19 @@ public:
 
   size_t getTotalMemory() const;
 
+  /// Record the include guards of the headers of this compilation in the
+  /// header guard cache, if any, along with the ones recorded by the other
+  /// compilations.
+  void writeHeaderGuardCache();
+
 private:
+  /// Load the header guard cache if needed and get the recorded include guard
+  /// of \p File, if it has not changed since.
+  const IdentifierInfo *getCachedHeaderGuard(Preprocessor &PP,
+                                             const FileEntry *File);
+
+  void readHeaderGuardCache(llvm::StringMap<CachedHeaderGuard> &Guards) const;
+
   /// Describes what happened when we tried to load a module map file.
   enum LoadModuleMapResult {
     /// The module map file had already been loaded.
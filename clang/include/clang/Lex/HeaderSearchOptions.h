@@ -113,6 +113,11 @@ public:
   /// The directory used for a user build.
   std::string ModuleUserBuildPath;
 
+  /// If non-empty, the file recording the include guards of the headers
+  /// across compilations, so that a header whose guard macro is defined is
+  /// not entered even before it has been lexed once in this compilation.
+  std::string HeaderGuardCachePath;
+
   /// The mapping of module names to prebuilt module files.
   std::map<std::string, std::string> PrebuiltModuleFiles;
 
@@ -7572,6 +7572,24 @@ public:
   /// by some template instantiation.
   llvm::DenseSet<QualType> InstantiatedNonDependentTypes;
 
+  /// The result of substituting the arguments of the preceding template
+  /// parameters into the default argument of a template type parameter.
+  class SubstitutedDefaultArgumentEntry : public llvm::FastFoldingSetNode {
+  public:
+    TypeSourceInfo *Result;
+
+    SubstitutedDefaultArgumentEntry(const llvm::FoldingSetNodeID &ID,
+                                    TypeSourceInfo *Result)
+        : FastFoldingSetNode(ID), Result(Result) {}
+  };
+
+  /// A cache of the default template arguments substituted without any
+  /// diagnostic, keyed by the parameter and the canonical arguments of the
+  /// preceding parameters, so that naming the same specialization again does
+  /// not redo the substitution.
+  llvm::FoldingSet<SubstitutedDefaultArgumentEntry>
+      SubstitutedDefaultArgumentCache;
+
   /// Extra modules inspected when performing a lookup during a template
   /// instantiation. Computed lazily.
   SmallVector<Module*, 16> CodeSynthesisContextLookupModules;
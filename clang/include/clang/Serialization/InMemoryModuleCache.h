@@ -11,12 +11,53 @@
 
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include <ctime>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
 
 namespace clang {
 
+/// Process-wide cache of the contents of the PCM files on disk.
+///
+/// Unlike InMemoryModuleCache, which gives one compilation a consistent view
+/// of its PCMs, this can be shared by the InMemoryModuleCaches of unrelated,
+/// possibly concurrent compilations in the same process, such as the ones of
+/// a build daemon, so that they map a PCM file once instead of each reading
+/// it again.  A file is identified by its unique ID, size and modification
+/// time, so a PCM which is rebuilt is read again.  The contents are released
+/// once no compilation uses them anymore.
+class SharedModuleFileCache
+    : public llvm::ThreadSafeRefCountedBase<SharedModuleFileCache> {
+  using Key = std::tuple<llvm::sys::fs::UniqueID, off_t, time_t>;
+
+  std::mutex Mutex;
+  std::map<Key, std::weak_ptr<llvm::MemoryBuffer>> Buffers;
+
+public:
+  using ReadFn =
+      llvm::function_ref<llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>()>;
+
+  /// Get the contents of the file \p ID of size \p Size last modified at
+  /// \p ModTime, calling \p Read to read it unless another compilation
+  /// already did.
+  ///
+  /// \return a buffer referring to the shared contents, or the error of
+  /// \p Read.
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>
+  getBuffer(llvm::sys::fs::UniqueID ID, off_t Size, time_t ModTime,
+            ReadFn Read);
+
+  /// Get the number of files whose contents are alive in the cache.
+  unsigned getNumBuffers();
+};
+
 /// In-memory cache for modules.
 ///
 /// This is a cache for modules for use across a compilation, sharing state
@@ -44,6 +85,9 @@ class InMemoryModuleCache : public llvm::RefCountedBase<InMemoryModuleCache> {
   /// Cache of buffers.
   llvm::StringMap<PCM> PCMs;
 
+  /// The cache of the PCM files shared with other compilations, if any.
+  llvm::IntrusiveRefCntPtr<SharedModuleFileCache> SharedFiles;
+
 public:
   /// There are four states for a PCM.  It must monotonically increase.
   ///
@@ -100,6 +144,18 @@ public:
   ///
   /// \return true iff state is ToBuild.
   bool shouldBuildPCM(llvm::StringRef Filename) const;
+
+  /// Share the contents of the PCM files read from disk with the other
+  /// compilations using \p Files.
+  void
+  setSharedFileCache(llvm::IntrusiveRefCntPtr<SharedModuleFileCache> Files) {
+    SharedFiles = std::move(Files);
+  }
+
+  /// Get the cache of the PCM files shared with other compilations, if any.
+  SharedModuleFileCache *getSharedFileCache() const {
+    return SharedFiles.get();
+  }
 };
 
 } // end namespace clang
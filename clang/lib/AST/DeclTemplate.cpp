@@ -28,9 +28,12 @@
 #include "llvm/ADT/FoldingSet.h"
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/PointerUnion.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
@@ -182,17 +185,154 @@ RedeclarableTemplateDecl::CommonBase *RedeclarableTemplateDecl::getCommonPtr() c
   return Common;
 }
 
-void RedeclarableTemplateDecl::loadLazySpecializationsImpl() const {
+static void addDeclToSpecializationHash(llvm::FoldingSetNodeID &ID,
+                                        const Decl *D) {
+  if (const auto *ND = dyn_cast_or_null<NamedDecl>(D))
+    if (const IdentifierInfo *II = ND->getIdentifier())
+      ID.AddString(II->getName());
+}
+
+static void addArgToSpecializationHash(llvm::FoldingSetNodeID &ID,
+                                       const TemplateArgument &Arg);
+
+static void addTypeToSpecializationHash(llvm::FoldingSetNodeID &ID,
+                                        QualType T) {
+  if (T.isNull())
+    return;
+  T = T.getCanonicalType();
+  ID.AddInteger(T.getCVRQualifiers());
+  const Type *Ty = T.getTypePtr();
+  ID.AddInteger(Ty->getTypeClass());
+  if (const auto *BT = dyn_cast<BuiltinType>(Ty)) {
+    ID.AddInteger(BT->getKind());
+  } else if (const auto *PT = dyn_cast<PointerType>(Ty)) {
+    addTypeToSpecializationHash(ID, PT->getPointeeType());
+  } else if (const auto *RT = dyn_cast<ReferenceType>(Ty)) {
+    addTypeToSpecializationHash(ID, RT->getPointeeType());
+  } else if (const auto *AT = dyn_cast<ArrayType>(Ty)) {
+    addTypeToSpecializationHash(ID, AT->getElementType());
+  } else if (const auto *TT = dyn_cast<TagType>(Ty)) {
+    const TagDecl *TD = TT->getDecl();
+    addDeclToSpecializationHash(ID, TD);
+    if (const auto *Spec = dyn_cast<ClassTemplateSpecializationDecl>(TD))
+      for (const TemplateArgument &Arg : Spec->getTemplateArgs().asArray())
+        addArgToSpecializationHash(ID, Arg);
+  }
+}
+
+static void addArgToSpecializationHash(llvm::FoldingSetNodeID &ID,
+                                       const TemplateArgument &Arg) {
+  ID.AddInteger(Arg.getKind());
+  switch (Arg.getKind()) {
+  case TemplateArgument::Null:
+  case TemplateArgument::NullPtr:
+  case TemplateArgument::Expression:
+    break;
+  case TemplateArgument::Type:
+    addTypeToSpecializationHash(ID, Arg.getAsType());
+    break;
+  case TemplateArgument::Declaration:
+    addDeclToSpecializationHash(ID, Arg.getAsDecl());
+    break;
+  case TemplateArgument::Integral:
+    Arg.getAsIntegral().Profile(ID);
+    break;
+  case TemplateArgument::Template:
+  case TemplateArgument::TemplateExpansion:
+    addDeclToSpecializationHash(
+        ID, Arg.getAsTemplateOrTemplatePattern().getAsTemplateDecl());
+    break;
+  case TemplateArgument::Pack:
+    for (const TemplateArgument &P : Arg.pack_elements())
+      addArgToSpecializationHash(ID, P);
+    break;
+  }
+}
+
+unsigned RedeclarableTemplateDecl::computeSpecializationArgsHash(
+    ArrayRef<TemplateArgument> Args) {
+  // Unlike the profile of the arguments, the hash cannot use the addresses of
+  // the types and declarations, so it is coarser: arguments which profile the
+  // same always hash the same, while a collision only loads a specialization
+  // which does not match the lookup.
+  llvm::FoldingSetNodeID ID;
+  ID.AddInteger(Args.size());
+  for (const TemplateArgument &Arg : Args)
+    addArgToSpecializationHash(ID, Arg);
+  return ID.ComputeHash();
+}
+
+unsigned
+RedeclarableTemplateDecl::computeSpecializationArgsHash(const Decl *Spec) {
+  if (const auto *CTSD = dyn_cast<ClassTemplateSpecializationDecl>(Spec))
+    return computeSpecializationArgsHash(CTSD->getTemplateArgs().asArray());
+  if (const auto *VTSD = dyn_cast<VarTemplateSpecializationDecl>(Spec))
+    return computeSpecializationArgsHash(VTSD->getTemplateArgs().asArray());
+  return computeSpecializationArgsHash(
+      cast<FunctionDecl>(Spec)->getTemplateSpecializationArgs()->asArray());
+}
+
+/// Load the lazy specializations of \p Common selected by \p Pred, leaving
+/// the other ones to be loaded later.
+static void loadLazySpecializationsIf(
+    const RedeclarableTemplateDecl *D,
+    RedeclarableTemplateDecl::LazySpecializationInfo *&Specs,
+    llvm::function_ref<bool(
+        const RedeclarableTemplateDecl::LazySpecializationInfo &)>
+        Pred) {
+  if (!Specs)
+    return;
+
+  // Take the selected IDs out of the array before loading any of them, as
+  // loading them may add more lazy specializations to the template.
+  SmallVector<uint32_t, 8> IDs;
+  uint32_t N = Specs[0].DeclID, Kept = 0;
+  for (uint32_t I = 1; I <= N; ++I) {
+    if (Pred(Specs[I]))
+      IDs.push_back(Specs[I].DeclID);
+    else
+      Specs[++Kept] = Specs[I];
+  }
+  if (IDs.empty())
+    return;
+  if (Kept)
+    Specs[0].DeclID = Kept;
+  else
+    Specs = nullptr;
+
+  llvm::TimeTraceScope TimeScope("LoadLazySpecializations", [&] {
+    std::string Detail;
+    llvm::raw_string_ostream OS(Detail);
+    D->printQualifiedName(OS);
+    OS << ": " << IDs.size() << " of " << N;
+    return OS.str();
+  });
+  ExternalASTSource *Source = D->getASTContext().getExternalSource();
+  for (uint32_t ID : IDs)
+    (void)Source->GetExternalDecl(ID);
+}
+
+void RedeclarableTemplateDecl::loadLazySpecializationsImpl(
+    bool OnlyPartial) const {
   // Grab the most recent declaration to ensure we've loaded any lazy
   // redeclarations of this template.
   CommonBase *CommonBasePtr = getMostRecentDecl()->getCommonPtr();
-  if (CommonBasePtr->LazySpecializations) {
-    ASTContext &Context = getASTContext();
-    uint32_t *Specs = CommonBasePtr->LazySpecializations;
-    CommonBasePtr->LazySpecializations = nullptr;
-    for (uint32_t I = 0, N = *Specs++; I != N; ++I)
-      (void)Context.getExternalSource()->GetExternalDecl(Specs[I]);
-  }
+  loadLazySpecializationsIf(this, CommonBasePtr->LazySpecializations,
+                            [&](const LazySpecializationInfo &Info) {
+                              return !OnlyPartial || Info.IsPartial;
+                            });
+}
+
+void RedeclarableTemplateDecl::loadLazySpecializationsImpl(
+    ArrayRef<TemplateArgument> Args) const {
+  CommonBase *CommonBasePtr = getMostRecentDecl()->getCommonPtr();
+  if (!CommonBasePtr->LazySpecializations)
+    return;
+  unsigned Hash = computeSpecializationArgsHash(Args);
+  loadLazySpecializationsIf(this, CommonBasePtr->LazySpecializations,
+                            [&](const LazySpecializationInfo &Info) {
+                              return Info.ArgsHash == Hash;
+                            });
 }
 
 template<class EntryType>
@@ -267,6 +407,11 @@ void FunctionTemplateDecl::LoadLazySpecializations() const {
   loadLazySpecializationsImpl();
 }
 
+void FunctionTemplateDecl::LoadLazySpecializations(
+    ArrayRef<TemplateArgument> Args) const {
+  loadLazySpecializationsImpl(Args);
+}
+
 llvm::FoldingSetVector<FunctionTemplateSpecializationInfo> &
 FunctionTemplateDecl::getSpecializations() const {
   LoadLazySpecializations();
@@ -276,13 +421,16 @@ FunctionTemplateDecl::getSpecializations() const {
 FunctionDecl *
 FunctionTemplateDecl::findSpecialization(ArrayRef<TemplateArgument> Args,
                                          void *&InsertPos) {
-  return findSpecializationImpl(getSpecializations(), Args, InsertPos);
+  loadLazySpecializationsImpl(Args);
+  return findSpecializationImpl(getCommonPtr()->Specializations, Args,
+                                InsertPos);
 }
 
 void FunctionTemplateDecl::addSpecialization(
       FunctionTemplateSpecializationInfo *Info, void *InsertPos) {
-  addSpecializationImpl<FunctionTemplateDecl>(getSpecializations(), Info,
-                                              InsertPos);
+  loadLazySpecializationsImpl(Info->TemplateArguments->asArray());
+  addSpecializationImpl<FunctionTemplateDecl>(getCommonPtr()->Specializations,
+                                              Info, InsertPos);
 }
 
 ArrayRef<TemplateArgument> FunctionTemplateDecl::getInjectedTemplateArgs() {
@@ -369,6 +517,11 @@ void ClassTemplateDecl::LoadLazySpecializations() const {
   loadLazySpecializationsImpl();
 }
 
+void ClassTemplateDecl::LoadLazySpecializations(
+    ArrayRef<TemplateArgument> Args) const {
+  loadLazySpecializationsImpl(Args);
+}
+
 llvm::FoldingSetVector<ClassTemplateSpecializationDecl> &
 ClassTemplateDecl::getSpecializations() const {
   LoadLazySpecializations();
@@ -377,7 +530,7 @@ ClassTemplateDecl::getSpecializations() const {
 
 llvm::FoldingSetVector<ClassTemplatePartialSpecializationDecl> &
 ClassTemplateDecl::getPartialSpecializations() {
-  LoadLazySpecializations();
+  loadLazySpecializationsImpl(/*OnlyPartial=*/true);
   return getCommonPtr()->PartialSpecializations;
 }
 
@@ -391,12 +544,16 @@ ClassTemplateDecl::newCommon(ASTContext &C) const {
 ClassTemplateSpecializationDecl *
 ClassTemplateDecl::findSpecialization(ArrayRef<TemplateArgument> Args,
                                       void *&InsertPos) {
-  return findSpecializationImpl(getSpecializations(), Args, InsertPos);
+  loadLazySpecializationsImpl(Args);
+  return findSpecializationImpl(getCommonPtr()->Specializations, Args,
+                                InsertPos);
 }
 
 void ClassTemplateDecl::AddSpecialization(ClassTemplateSpecializationDecl *D,
                                           void *InsertPos) {
-  addSpecializationImpl<ClassTemplateDecl>(getSpecializations(), D, InsertPos);
+  loadLazySpecializationsImpl(D->getTemplateArgs().asArray());
+  addSpecializationImpl<ClassTemplateDecl>(getCommonPtr()->Specializations, D,
+                                           InsertPos);
 }
 
 ClassTemplatePartialSpecializationDecl *
@@ -968,6 +1125,11 @@ void VarTemplateDecl::LoadLazySpecializations() const {
   loadLazySpecializationsImpl();
 }
 
+void VarTemplateDecl::LoadLazySpecializations(
+    ArrayRef<TemplateArgument> Args) const {
+  loadLazySpecializationsImpl(Args);
+}
+
 llvm::FoldingSetVector<VarTemplateSpecializationDecl> &
 VarTemplateDecl::getSpecializations() const {
   LoadLazySpecializations();
@@ -976,7 +1138,7 @@ VarTemplateDecl::getSpecializations() const {
 
 llvm::FoldingSetVector<VarTemplatePartialSpecializationDecl> &
 VarTemplateDecl::getPartialSpecializations() {
-  LoadLazySpecializations();
+  loadLazySpecializationsImpl(/*OnlyPartial=*/true);
   return getCommonPtr()->PartialSpecializations;
 }
 
@@ -990,12 +1152,16 @@ VarTemplateDecl::newCommon(ASTContext &C) const {
 VarTemplateSpecializationDecl *
 VarTemplateDecl::findSpecialization(ArrayRef<TemplateArgument> Args,
                                     void *&InsertPos) {
-  return findSpecializationImpl(getSpecializations(), Args, InsertPos);
+  loadLazySpecializationsImpl(Args);
+  return findSpecializationImpl(getCommonPtr()->Specializations, Args,
+                                InsertPos);
 }
 
 void VarTemplateDecl::AddSpecialization(VarTemplateSpecializationDecl *D,
                                         void *InsertPos) {
-  addSpecializationImpl<VarTemplateDecl>(getSpecializations(), D, InsertPos);
+  loadLazySpecializationsImpl(D->getTemplateArgs().asArray());
+  addSpecializationImpl<VarTemplateDecl>(getCommonPtr()->Specializations, D,
+                                         InsertPos);
 }
 
 VarTemplatePartialSpecializationDecl *
@@ -304,7 +304,12 @@ class MatchASTVisitor : public RecursiveASTVisitor<MatchASTVisitor>,
 public:
   MatchASTVisitor(const MatchFinder::MatchersByType *Matchers,
                   const MatchFinder::MatchFinderOptions &Options)
-      : Matchers(Matchers), Options(Options), ActiveASTContext(nullptr) {}
+      : Matchers(Matchers), Options(Options), ActiveASTContext(nullptr) {
+    // Look up the buckets once, rather than for each matcher on each node.
+    if (Options.CheckProfiling)
+      for (MatchCallback *MC : Matchers->AllCallbacks)
+        BucketByCallback[MC] = &TimeByBucket[MC->getID()];
+  }
 
   ~MatchASTVisitor() override {
     if (Options.CheckProfiling) {
@@ -317,7 +322,7 @@ public:
     TimeBucketRegion Timer;
     for (MatchCallback *MC : Matchers->AllCallbacks) {
       if (EnableCheckProfiling)
-        Timer.setBucket(&TimeByBucket[MC->getID()]);
+        Timer.setBucket(BucketByCallback[MC]);
       MC->onStartOfTranslationUnit();
     }
   }
@@ -327,7 +332,7 @@ public:
     TimeBucketRegion Timer;
     for (MatchCallback *MC : Matchers->AllCallbacks) {
       if (EnableCheckProfiling)
-        Timer.setBucket(&TimeByBucket[MC->getID()]);
+        Timer.setBucket(BucketByCallback[MC]);
       MC->onEndOfTranslationUnit();
     }
   }
@@ -529,6 +534,14 @@ private:
     llvm::TimeRecord *Bucket;
   };
 
+  /// A \c DeclOrStmt matcher, with everything needed to run it on a node.
+  struct FilteredMatcher {
+    const DynTypedMatcher *Matcher;
+    MatchCallback *Callback;
+    /// Null unless profiling.
+    llvm::TimeRecord *Bucket;
+  };
+
   /// Runs all the \p Matchers on \p Node.
   ///
   /// Used by \c matchDispatch() below.
@@ -538,7 +551,7 @@ private:
     TimeBucketRegion Timer;
     for (const auto &MP : Matchers) {
       if (EnableCheckProfiling)
-        Timer.setBucket(&TimeByBucket[MP.second->getID()]);
+        Timer.setBucket(BucketByCallback[MP.second]);
       BoundNodesTreeBuilder Builder;
       if (MP.first.matches(Node, this, &Builder)) {
         MatchVisitor Visitor(ActiveASTContext, MP.second);
@@ -556,29 +569,27 @@ private:
     if (Filter.empty())
       return;
 
-    const bool EnableCheckProfiling = Options.CheckProfiling.hasValue();
+    // Bucket is null unless profiling is enabled.
     TimeBucketRegion Timer;
-    auto &Matchers = this->Matchers->DeclOrStmt;
-    for (unsigned short I : Filter) {
-      auto &MP = Matchers[I];
-      if (EnableCheckProfiling)
-        Timer.setBucket(&TimeByBucket[MP.second->getID()]);
+    for (const FilteredMatcher &M : Filter) {
+      Timer.setBucket(M.Bucket);
       BoundNodesTreeBuilder Builder;
-      if (MP.first.matchesNoKindCheck(DynNode, this, &Builder)) {
-        MatchVisitor Visitor(ActiveASTContext, MP.second);
+      if (M.Matcher->matchesNoKindCheck(DynNode, this, &Builder)) {
+        MatchVisitor Visitor(ActiveASTContext, M.Callback);
         Builder.visitMatches(&Visitor);
       }
     }
   }
 
-  const std::vector<unsigned short> &
+  const std::vector<FilteredMatcher> &
   getFilterForKind(ast_type_traits::ASTNodeKind Kind) {
     auto &Filter = MatcherFiltersMap[Kind];
-    auto &Matchers = this->Matchers->DeclOrStmt;
-    assert((Matchers.size() < USHRT_MAX) && "Too many matchers.");
-    for (unsigned I = 0, E = Matchers.size(); I != E; ++I) {
-      if (Matchers[I].first.canMatchNodesOfKind(Kind)) {
-        Filter.push_back(I);
+    for (const auto &MP : Matchers->DeclOrStmt) {
+      if (MP.first.canMatchNodesOfKind(Kind)) {
+        auto Bucket = BucketByCallback.find(MP.second);
+        Filter.push_back({&MP.first, MP.second,
+                          Bucket == BucketByCallback.end() ? nullptr
+                                                           : Bucket->second});
       }
     }
     return Filter;
@@ -766,6 +777,8 @@ private:
   ///
   /// Used to get the appropriate bucket for each matcher.
   llvm::StringMap<llvm::TimeRecord> TimeByBucket;
+  /// The bucket of each callback in \c TimeByBucket, if profiling.
+  llvm::DenseMap<MatchCallback *, llvm::TimeRecord *> BucketByCallback;
 
   const MatchFinder::MatchersByType *Matchers;
 
@@ -777,7 +790,7 @@ private:
   /// We precalculate a list of matchers that pass the toplevel restrict check.
   /// This also allows us to skip the restrict check at matching time. See
   /// use \c matchesNoKindCheck() above.
-  llvm::DenseMap<ast_type_traits::ASTNodeKind, std::vector<unsigned short>>
+  llvm::DenseMap<ast_type_traits::ASTNodeKind, std::vector<FilteredMatcher>>
       MatcherFiltersMap;
 
   const MatchFinder::MatchFinderOptions &Options;
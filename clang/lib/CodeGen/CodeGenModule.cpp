@@ -2095,6 +2095,14 @@ void CodeGenModule::EmitDeferred() {
 
   // Grab the list of decls to emit. If EmitGlobalDefinition schedules more
   // work, it will not interfere with this.
+  //
+  // These definitions are emitted one after the other. Emitting one queries
+  // and updates the ASTContext (lazy declarations, deserialization, mangling
+  // caches) and the maps of this module, and uniques constants and types in
+  // the LLVMContext, none of which are thread-safe. Its order also decides
+  // which decls become deferred and the order of the functions in the
+  // module. So the bodies cannot be emitted in parallel into separate
+  // modules without making these structures thread-safe first.
   std::vector<GlobalDecl> CurDeclsToEmit;
   CurDeclsToEmit.swap(DeferredDeclsToEmit);
 
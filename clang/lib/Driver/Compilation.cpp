@@ -17,14 +17,17 @@
 #include "clang/Driver/Util.h"
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Option/ArgList.h"
 #include "llvm/Option/OptSpecifier.h"
 #include "llvm/Option/Option.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cassert>
+#include <condition_variable>
 #include <string>
 #include <system_error>
 #include <utility>
@@ -154,6 +157,7 @@ int Compilation::ExecuteCommand(const Command &C,
                                 const Command *&FailingCommand) const {
   if ((getDriver().CCPrintOptions ||
        getArgs().hasArg(options::OPT_v)) && !getDriver().CCGenDiagnostics) {
+    std::lock_guard<std::mutex> Lock(OutputMutex);
     raw_ostream *OS = &llvm::errs();
 
     // Follow gcc implementation of CC_PRINT_OPTIONS; we could also cache the
@@ -186,6 +190,7 @@ int Compilation::ExecuteCommand(const Command &C,
   int Res = C.Execute(Redirects, &Error, &ExecutionFailed);
   if (!Error.empty()) {
     assert(Res && "Error string set with 0 result code!");
+    std::lock_guard<std::mutex> Lock(OutputMutex);
     getDriver().Diag(diag::err_drv_command_failure) << Error;
   }
 
@@ -224,8 +229,101 @@ static bool InputsOk(const Command &C,
   return !ActionFailed(&C.getSource(), FailingCommands);
 }
 
+/// Return the indices of the jobs before \p Jobs[I] that build its inputs,
+/// that is the jobs whose source action is the source action of \p Jobs[I]
+/// or one of its transitive inputs.
+static SmallVector<size_t, 4> getJobDependencies(ArrayRef<const Command *> Jobs,
+                                                 size_t I) {
+  llvm::SmallPtrSet<const Action *, 16> Reachable;
+  SmallVector<const Action *, 16> Worklist = {&Jobs[I]->getSource()};
+  while (!Worklist.empty()) {
+    const Action *A = Worklist.pop_back_val();
+    if (Reachable.insert(A).second)
+      Worklist.append(A->input_begin(), A->input_end());
+  }
+
+  SmallVector<size_t, 4> Deps;
+  for (size_t J = 0; J != I; ++J)
+    if (Reachable.count(&Jobs[J]->getSource()))
+      Deps.push_back(J);
+  return Deps;
+}
+
+void Compilation::ExecuteJobsInParallel(
+    const JobList &Jobs, FailingCommandList &FailingCommands) const {
+  size_t NumPreviousFailures = FailingCommands.size();
+  std::vector<const Command *> Cmds;
+  for (const auto &Job : Jobs)
+    Cmds.push_back(&Job);
+
+  std::vector<SmallVector<size_t, 4>> Deps;
+  for (size_t I = 0, E = Cmds.size(); I != E; ++I)
+    Deps.push_back(getJobDependencies(Cmds, I));
+
+  enum JobState { Pending, Running, Done };
+  std::vector<JobState> States(Cmds.size(), Pending);
+  std::vector<std::pair<int, const Command *>> Results(Cmds.size());
+  std::mutex Mutex;
+  std::condition_variable Finished;
+  unsigned NumRunning = 0;
+
+  llvm::ThreadPool Pool(ParallelJobs);
+  std::unique_lock<std::mutex> Lock(Mutex);
+  for (;;) {
+    bool AnyPending = false;
+    for (size_t I = 0, E = Cmds.size(); I != E && NumRunning < ParallelJobs;
+         ++I) {
+      if (States[I] != Pending)
+        continue;
+      AnyPending = true;
+      if (!llvm::all_of(Deps[I], [&](size_t J) { return States[J] == Done; }))
+        continue;
+      // The failures of the jobs it depends on are all known by now.
+      if (!InputsOk(*Cmds[I], FailingCommands)) {
+        States[I] = Done;
+        continue;
+      }
+      States[I] = Running;
+      ++NumRunning;
+      Pool.async([&, I] {
+        const Command *FailingCommand = nullptr;
+        int Res = ExecuteCommand(*Cmds[I], FailingCommand);
+        std::lock_guard<std::mutex> JobLock(Mutex);
+        if (Res) {
+          Results[I] = std::make_pair(Res, FailingCommand);
+          FailingCommands.push_back(Results[I]);
+        }
+        States[I] = Done;
+        --NumRunning;
+        Finished.notify_one();
+      });
+    }
+    if (!AnyPending && NumRunning == 0)
+      break;
+    // Skipping a job may have made others ready without any job finishing.
+    if (NumRunning == 0)
+      continue;
+    Finished.wait(Lock);
+  }
+  Lock.unlock();
+  Pool.wait();
+
+  // Report the failures in the order of the jobs rather than of completion.
+  FailingCommands.erase(FailingCommands.begin() + NumPreviousFailures,
+                        FailingCommands.end());
+  for (const auto &Result : Results)
+    if (Result.first)
+      FailingCommands.push_back(Result);
+}
+
 void Compilation::ExecuteJobs(const JobList &Jobs,
                               FailingCommandList &FailingCommands) const {
+  // Run the independent jobs at once if asked to, except in cl mode which
+  // stops at the first failure, and when reproducing a crash.
+  if (ParallelJobs > 1 && !TheDriver.IsCLMode() && !ForDiagnostics &&
+      Jobs.size() > 1)
+    return ExecuteJobsInParallel(Jobs, FailingCommands);
+
   // According to UNIX standard, driver need to continue compiling all the
   // inputs on the command line even one of them failed.
   // In all but CLMode, execute all the jobs unless the necessary inputs for the
@@ -1210,6 +1210,15 @@ Compilation *Driver::BuildCompilation(ArrayRef<const char *> ArgList) {
   Compilation *C = new Compilation(*this, TC, UArgs.release(), TranslatedArgs,
                                    ContainsError);
 
+  if (Arg *A = C->getArgs().getLastArg(options::OPT_fparallel_jobs_EQ)) {
+    unsigned N;
+    if (StringRef(A->getValue()).getAsInteger(10, N) || N == 0)
+      Diag(diag::err_drv_invalid_int_value)
+          << A->getAsString(C->getArgs()) << A->getValue();
+    else
+      C->setParallelJobs(N);
+  }
+
   if (!HandleImmediateArgs(*C))
     return C;
 
@@ -3039,6 +3048,12 @@ class OffloadingActionBuilder final {
       // is done in the same step.  Currently, its not too efficient.
       // The host depends on the generated integrated header from the device
       // compilation.
+      // Note that the host compilation cannot reuse the AST of the device one:
+      // -fsycl-is-device defines __SYCL_DEVICE_ONLY__, enables the SYCL
+      // keywords and gives the types address spaces during Sema, so the two
+      // parses of a TU do not build the same AST. Merging the header pass
+      // into the spv pass needs a job producing two outputs, the header and
+      // the device IR, which JobAction cannot describe yet.
       if (CurPhase == phases::Compile) {
         for (Action *&A : SYCLDeviceActions) {
           DeviceCompilerInput =
@@ -2262,12 +2262,15 @@ reformat(const FormatStyle &Style, StringRef Code,
   SmallVector<AnalyzerPass, 4> Passes;
 
   if (Style.Language == FormatStyle::LK_Cpp) {
-    if (Style.FixNamespaceComments)
+    // Each pass lexes and parses the whole file again. These two only change
+    // namespaces and using-declarations, so skip them when there are none,
+    // which earlier passes can't add either.
+    if (Style.FixNamespaceComments && Code.contains("namespace"))
       Passes.emplace_back([&](const Environment &Env) {
         return NamespaceEndCommentsFixer(Env, Expanded).process();
       });
 
-    if (Style.SortUsingDeclarations)
+    if (Style.SortUsingDeclarations && Code.contains("using"))
       Passes.emplace_back([&](const Environment &Env) {
         return UsingDeclarationsSorter(Env, Expanded).process();
       });
@@ -2296,7 +2299,8 @@ reformat(const FormatStyle &Style, StringRef Code,
     if (NewCode) {
       Fixes = Fixes.merge(PassFixes.first);
       Penalty += PassFixes.second;
-      if (I + 1 < E) {
+      // The code and ranges of the next pass only change with the fixes.
+      if (I + 1 < E && !PassFixes.first.empty()) {
         CurrentCode = std::move(*NewCode);
         Env = llvm::make_unique<Environment>(
             *CurrentCode, FileName,
@@ -954,8 +954,11 @@ void FrontendAction::EndSourceFile() {
   CI.getDiagnosticClient().EndSourceFile();
 
   // Inform the preprocessor we are done.
-  if (CI.hasPreprocessor())
+  if (CI.hasPreprocessor()) {
     CI.getPreprocessor().EndSourceFile();
+    // Record the include guards found for the next compilations.
+    CI.getPreprocessor().getHeaderSearchInfo().writeHeaderGuardCache();
+  }
 
   // Finalize the action.
   EndSourceFileAction();
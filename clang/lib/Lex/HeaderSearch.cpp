@@ -34,6 +34,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
@@ -41,6 +42,7 @@
 #include <cstring>
 #include <string>
 #include <system_error>
+#include <tuple>
 #include <utility>
 
 using namespace clang;
@@ -1257,8 +1259,14 @@ bool HeaderSearch::ShouldEnterIncludeFile(Preprocessor &PP,
 
   // Next, check to see if the file is wrapped with #ifndef guards.  If so, and
   // if the macro that guards it is defined, we know the #include has no effect.
-  if (const IdentifierInfo *ControllingMacro
-      = FileInfo.getControllingMacro(ExternalLookup)) {
+  // Before the file is lexed, its guard may still be known from the previous
+  // compilations.
+  const IdentifierInfo *ControllingMacro =
+      FileInfo.getControllingMacro(ExternalLookup);
+  if (!ControllingMacro && !FileInfo.NumIncludes &&
+      !HSOpts->HeaderGuardCachePath.empty())
+    ControllingMacro = getCachedHeaderGuard(PP, File);
+  if (ControllingMacro) {
     // If the header corresponds to a module, check whether the macro is already
     // defined in that module rather than checking in the current set of visible
     // modules.
@@ -1275,6 +1283,100 @@ bool HeaderSearch::ShouldEnterIncludeFile(Preprocessor &PP,
   return true;
 }
 
+void HeaderSearch::readHeaderGuardCache(
+    llvm::StringMap<CachedHeaderGuard> &Guards) const {
+  // The cache is only an optimization, so it is ignored if missing or
+  // malformed. Each line is "<size> <mtime> <macro> <file name>".
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buf =
+      llvm::MemoryBuffer::getFile(HSOpts->HeaderGuardCachePath);
+  if (!Buf)
+    return;
+  SmallVector<StringRef, 0> Lines;
+  (*Buf)->getBuffer().split(Lines, '\n', -1, /*KeepEmpty=*/false);
+  for (StringRef Line : Lines) {
+    StringRef Size, ModTime, Macro;
+    std::tie(Size, Line) = Line.split(' ');
+    std::tie(ModTime, Line) = Line.split(' ');
+    std::tie(Macro, Line) = Line.split(' ');
+    CachedHeaderGuard Guard;
+    unsigned long long SizeVal;
+    long long ModTimeVal;
+    if (Size.getAsInteger(10, SizeVal) ||
+        ModTime.getAsInteger(10, ModTimeVal) || Macro.empty() || Line.empty())
+      continue;
+    Guard.Size = SizeVal;
+    Guard.ModTime = ModTimeVal;
+    Guard.Macro = Macro;
+    Guards[Line] = std::move(Guard);
+  }
+}
+
+const IdentifierInfo *
+HeaderSearch::getCachedHeaderGuard(Preprocessor &PP, const FileEntry *File) {
+  if (!CachedHeaderGuardsLoaded) {
+    CachedHeaderGuardsLoaded = true;
+    readHeaderGuardCache(CachedHeaderGuards);
+  }
+  auto I = CachedHeaderGuards.find(File->getName());
+  if (I == CachedHeaderGuards.end() || I->second.Size != File->getSize() ||
+      I->second.ModTime != File->getModificationTime())
+    return nullptr;
+  return PP.getIdentifierInfo(I->second.Macro);
+}
+
+void HeaderSearch::writeHeaderGuardCache() {
+  if (HSOpts->HeaderGuardCachePath.empty())
+    return;
+
+  // Merge the guards known to this compilation into the current contents of
+  // the cache, which other compilations may have updated since we read it.
+  llvm::StringMap<CachedHeaderGuard> Guards;
+  readHeaderGuardCache(Guards);
+  SmallVector<const FileEntry *, 16> FilesByUID;
+  FileMgr.GetUniqueIDMapping(FilesByUID);
+  bool Changed = false;
+  for (unsigned UID = 0, E = std::min(FilesByUID.size(), FileInfo.size());
+       UID != E; ++UID) {
+    const FileEntry *File = FilesByUID[UID];
+    const IdentifierInfo *Macro = FileInfo[UID].ControllingMacro;
+    if (!File || !Macro)
+      continue;
+    CachedHeaderGuard &Guard = Guards[File->getName()];
+    if (Guard.Macro == Macro->getName() && Guard.Size == File->getSize() &&
+        Guard.ModTime == File->getModificationTime())
+      continue;
+    Guard.Size = File->getSize();
+    Guard.ModTime = File->getModificationTime();
+    Guard.Macro = Macro->getName();
+    Changed = true;
+  }
+  if (!Changed)
+    return;
+
+  // Write the cache to a temporary file renamed over it, so that concurrent
+  // compilations never see a partial cache.
+  int FD;
+  SmallString<128> TempPath;
+  if (llvm::sys::fs::createUniqueFile(HSOpts->HeaderGuardCachePath +
+                                          "-%%%%%%%%",
+                                      FD, TempPath))
+    return;
+  {
+    llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    for (const auto &Entry : Guards)
+      OS << uint64_t(Entry.second.Size) << ' '
+         << int64_t(Entry.second.ModTime) << ' ' << Entry.second.Macro << ' '
+         << Entry.first() << '\n';
+    if (OS.has_error()) {
+      OS.clear_error();
+      llvm::sys::fs::remove(TempPath);
+      return;
+    }
+  }
+  if (llvm::sys::fs::rename(TempPath, HSOpts->HeaderGuardCachePath))
+    llvm::sys::fs::remove(TempPath);
+}
+
 size_t HeaderSearch::getTotalMemory() const {
   return SearchDirs.capacity()
     + llvm::capacity_in_bytes(FileInfo)
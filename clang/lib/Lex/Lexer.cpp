@@ -1626,14 +1626,78 @@ bool Lexer::tryConsumeIdentifierUTF8Char(const char *&CurPtr) {
   return true;
 }
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif __ALTIVEC__
+#include <altivec.h>
+#undef bool
+#endif
+
+/// Return the first character at or after \p CurPtr which is not an identifier
+/// body character [_A-Za-z0-9].  The vector loop does not read past
+/// \p BufferEnd; the scalar one stops at the nul which terminates the buffer.
+static const char *skipIdentifierBody(const char *CurPtr,
+                                      const char *BufferEnd) {
+#ifdef __SSE2__
+  const __m128i LowerCaseBit = _mm_set1_epi8(0x20);
+  const __m128i BeforeA = _mm_set1_epi8('a' - 1);
+  const __m128i AfterZ = _mm_set1_epi8('z' + 1);
+  const __m128i Before0 = _mm_set1_epi8('0' - 1);
+  const __m128i After9 = _mm_set1_epi8('9' + 1);
+  const __m128i Underscores = _mm_set1_epi8('_');
+  while (CurPtr + 16 <= BufferEnd) {
+    __m128i Chars = _mm_loadu_si128((const __m128i *)CurPtr);
+    // Setting the 0x20 bit maps the upper case letters onto the lower case
+    // ones, and nothing else into [a-z].  Non-ASCII bytes are negative in the
+    // signed compares, so they never match.
+    __m128i Lower = _mm_or_si128(Chars, LowerCaseBit);
+    __m128i Letters = _mm_and_si128(_mm_cmpgt_epi8(Lower, BeforeA),
+                                    _mm_cmplt_epi8(Lower, AfterZ));
+    __m128i Digits = _mm_and_si128(_mm_cmpgt_epi8(Chars, Before0),
+                                   _mm_cmplt_epi8(Chars, After9));
+    __m128i Body = _mm_or_si128(_mm_or_si128(Letters, Digits),
+                                _mm_cmpeq_epi8(Chars, Underscores));
+    unsigned Mask = _mm_movemask_epi8(Body);
+    if (Mask != 0xFFFF)
+      return CurPtr + llvm::countTrailingOnes(Mask);
+    CurPtr += 16;
+  }
+#endif
+  while (isIdentifierBody(*CurPtr))
+    ++CurPtr;
+  return CurPtr;
+}
+
+/// Return the first character at or after \p CurPtr which is not horizontal
+/// whitespace, in the same way as skipIdentifierBody.
+static const char *skipHorizontalWhitespace(const char *CurPtr,
+                                            const char *BufferEnd) {
+#ifdef __SSE2__
+  const __m128i Spaces = _mm_set1_epi8(' '), Tabs = _mm_set1_epi8('\t');
+  const __m128i VTabs = _mm_set1_epi8('\v'), FormFeeds = _mm_set1_epi8('\f');
+  while (CurPtr + 16 <= BufferEnd) {
+    __m128i Chars = _mm_loadu_si128((const __m128i *)CurPtr);
+    __m128i Whitespace =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Chars, Spaces),
+                                  _mm_cmpeq_epi8(Chars, Tabs)),
+                     _mm_or_si128(_mm_cmpeq_epi8(Chars, VTabs),
+                                  _mm_cmpeq_epi8(Chars, FormFeeds)));
+    unsigned Mask = _mm_movemask_epi8(Whitespace);
+    if (Mask != 0xFFFF)
+      return CurPtr + llvm::countTrailingOnes(Mask);
+    CurPtr += 16;
+  }
+#endif
+  while (isHorizontalWhitespace(*CurPtr))
+    ++CurPtr;
+  return CurPtr;
+}
+
 bool Lexer::LexIdentifier(Token &Result, const char *CurPtr) {
   // Match [_A-Za-z0-9]*, we have already matched [_A-Za-z$]
   unsigned Size;
-  unsigned char C = *CurPtr++;
-  while (isIdentifierBody(C))
-    C = *CurPtr++;
-
-  --CurPtr;   // Back up over the skipped character.
+  CurPtr = skipIdentifierBody(CurPtr, BufferEnd);
+  unsigned char C = *CurPtr;
 
   // Fast path, no $,\,? in identifier found.  '\' might be an escaped newline
   // or UCN, and ? might be a trigraph for '\', an escaped newline or UCN.
@@ -2184,8 +2248,8 @@ bool Lexer::SkipWhitespace(Token &Result, const char *CurPtr,
   // Skip consecutive spaces efficiently.
   while (true) {
     // Skip horizontal whitespace very aggressively.
-    while (isHorizontalWhitespace(Char))
-      Char = *++CurPtr;
+    CurPtr = skipHorizontalWhitespace(CurPtr, BufferEnd);
+    Char = *CurPtr;
 
     // Otherwise if we have something other than whitespace, we're done.
     if (!isVerticalWhitespace(Char))
@@ -2460,13 +2524,6 @@ static bool isEndOfBlockCommentWithEscapedNewLine(const char *CurPtr,
   return true;
 }
 
-#ifdef __SSE2__
-#include <emmintrin.h>
-#elif __ALTIVEC__
-#include <altivec.h>
-#undef bool
-#endif
-
 /// We have just read from input the / and * characters that started a comment.
 /// Read until we find the * and / characters that terminate the comment.
 /// Note that we don't bother decoding trigraphs or escaped newlines in block
@@ -1267,6 +1267,8 @@ void SYCLIntegrationHeader::emit(raw_ostream &O) {
   O << "template <class KernelNameType> struct KernelInfo;\n";
   O << "\n";
 
+  // The handler passes the descriptors returned by getParamDesc as template
+  // arguments to set the kernel arguments, so these must stay constexpr.
   O << "// Specializations of KernelInfo for kernel function types:\n";
   CurStart = 0;
 
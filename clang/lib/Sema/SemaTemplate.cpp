@@ -4583,12 +4583,40 @@ SubstDefaultTemplateArgument(Sema &SemaRef,
   // If the argument type is dependent, instantiate it now based
   // on the previously-computed template arguments.
   if (ArgType->getType()->isInstantiationDependentType()) {
+    // The substitution happens in the context of the template, so its result
+    // only depends on the arguments of the preceding parameters. Reuse it
+    // when these are not dependent.
+    llvm::FoldingSetNodeID ID;
+    bool Cacheable = true;
+    ID.AddPointer(Param);
+    for (const TemplateArgument &Arg : Converted) {
+      if (Arg.isInstantiationDependent() ||
+          Arg.containsUnexpandedParameterPack()) {
+        Cacheable = false;
+        break;
+      }
+      SemaRef.Context.getCanonicalTemplateArgument(Arg).Profile(
+          ID, SemaRef.Context);
+    }
+
+    void *InsertPos = nullptr;
+    if (Cacheable) {
+      if (Sema::SubstitutedDefaultArgumentEntry *Entry =
+              SemaRef.SubstitutedDefaultArgumentCache.FindNodeOrInsertPos(
+                  ID, InsertPos))
+        return Entry->Result;
+    }
+
     Sema::InstantiatingTemplate Inst(SemaRef, TemplateLoc,
                                      Param, Template, Converted,
                                      SourceRange(TemplateLoc, RAngleLoc));
     if (Inst.isInvalid())
       return nullptr;
 
+    DiagnosticErrorTrap ErrorTrap(SemaRef.getDiagnostics());
+    unsigned NumWarnings = SemaRef.getDiagnostics().getNumWarnings();
+    unsigned NumSFINAEErrors = SemaRef.NumSFINAEErrors;
+
     TemplateArgumentList TemplateArgs(TemplateArgumentList::OnStack, Converted);
 
     // Only substitute for the innermost template argument list.
@@ -4601,6 +4629,20 @@ SubstDefaultTemplateArgument(Sema &SemaRef,
     ArgType =
         SemaRef.SubstType(ArgType, TemplateArgLists,
                           Param->getDefaultArgumentLoc(), Param->getDeclName());
+
+    // Only remember the substitutions which succeeded silently, so that a
+    // diagnostic or a SFINAE failure is reported for each use.
+    if (Cacheable && ArgType && !ErrorTrap.hasErrorOccurred() &&
+        SemaRef.getDiagnostics().getNumWarnings() == NumWarnings &&
+        SemaRef.NumSFINAEErrors == NumSFINAEErrors &&
+        // The substitution may have added other entries.
+        !SemaRef.SubstitutedDefaultArgumentCache.FindNodeOrInsertPos(
+            ID, InsertPos)) {
+      auto *Entry = SemaRef.BumpAlloc.Allocate<
+          Sema::SubstitutedDefaultArgumentEntry>();
+      new (Entry) Sema::SubstitutedDefaultArgumentEntry(ID, ArgType);
+      SemaRef.SubstitutedDefaultArgumentCache.InsertNode(Entry, InsertPos);
+    }
   }
 
   return ArgType;
@@ -361,6 +361,18 @@ void Sema::pushCodeSynthesisContext(CodeSynthesisContext Ctx) {
   Ctx.SavedInNonInstantiationSFINAEContext = InNonInstantiationSFINAEContext;
   InNonInstantiationSFINAEContext = false;
 
+  // Attribute the time spent in the synthesis of nested entities to the
+  // entity which started it.
+  if (CodeSynthesisContexts.empty() && llvm::timeTraceProfilerEnabled()) {
+    llvm::timeTraceProfilerBegin("InstantiationRoot", [&]() {
+      std::string Name;
+      llvm::raw_string_ostream OS(Name);
+      if (auto *ND = dyn_cast_or_null<NamedDecl>(Ctx.Entity))
+        ND->getNameForDiagnostic(OS, getPrintingPolicy(), /*Qualified=*/true);
+      return OS.str();
+    });
+  }
+
   CodeSynthesisContexts.push_back(Ctx);
 
   if (!Ctx.isInstantiationRecord())
@@ -394,6 +406,9 @@ void Sema::popCodeSynthesisContext() {
     LastEmittedCodeSynthesisContextDepth = 0;
 
   CodeSynthesisContexts.pop_back();
+
+  if (CodeSynthesisContexts.empty() && llvm::timeTraceProfilerEnabled())
+    llvm::timeTraceProfilerEnd();
 }
 
 void Sema::InstantiatingTemplate::Clear() {
@@ -7190,13 +7190,18 @@ void ASTReader::CompleteRedeclChain(const Decl *D) {
     }
   }
 
+  // Only the specializations with the same arguments can be redeclarations of
+  // D.
   if (auto *CTSD = dyn_cast<ClassTemplateSpecializationDecl>(D))
-    CTSD->getSpecializedTemplate()->LoadLazySpecializations();
+    CTSD->getSpecializedTemplate()->LoadLazySpecializations(
+        CTSD->getTemplateArgs().asArray());
   if (auto *VTSD = dyn_cast<VarTemplateSpecializationDecl>(D))
-    VTSD->getSpecializedTemplate()->LoadLazySpecializations();
+    VTSD->getSpecializedTemplate()->LoadLazySpecializations(
+        VTSD->getTemplateArgs().asArray());
   if (auto *FD = dyn_cast<FunctionDecl>(D)) {
     if (auto *Template = FD->getPrimaryTemplate())
-      Template->LoadLazySpecializations();
+      Template->LoadLazySpecializations(
+          FD->getTemplateSpecializationArgs()->asArray());
   }
 }
 
@@ -70,6 +70,7 @@
 
 using namespace clang;
 using namespace serialization;
+using LazySpecializationInfo = RedeclarableTemplateDecl::LazySpecializationInfo;
 
 //===----------------------------------------------------------------------===//
 // Declaration deserialization
@@ -260,10 +261,21 @@ namespace clang {
         : Reader(Reader), Record(Record), Loc(Loc), ThisDeclID(thisDeclID),
           ThisDeclLoc(ThisDeclLoc) {}
 
-    template <typename T> static
-    void AddLazySpecializations(T *D,
-                                SmallVectorImpl<serialization::DeclID>& IDs) {
-      if (IDs.empty())
+    void
+    ReadLazySpecializationList(SmallVectorImpl<LazySpecializationInfo> &Infos) {
+      for (unsigned I = 0, Size = Record.readInt(); I != Size; ++I) {
+        DeclID ID = ReadDeclID();
+        unsigned Hash = Record.readInt();
+        bool IsPartial = Record.readInt();
+        Infos.push_back(LazySpecializationInfo(ID, Hash, IsPartial));
+      }
+    }
+
+    template <typename T>
+    static void
+    AddLazySpecializations(T *D,
+                           SmallVectorImpl<LazySpecializationInfo> &Infos) {
+      if (Infos.empty())
         return;
 
       // FIXME: We should avoid this pattern of getting the ASTContext.
@@ -272,14 +284,14 @@ namespace clang {
       auto *&LazySpecializations = D->getCommonPtr()->LazySpecializations;
 
       if (auto &Old = LazySpecializations) {
-        IDs.insert(IDs.end(), Old + 1, Old + 1 + Old[0]);
-        llvm::sort(IDs);
-        IDs.erase(std::unique(IDs.begin(), IDs.end()), IDs.end());
+        Infos.insert(Infos.end(), Old + 1, Old + 1 + Old[0].DeclID);
+        llvm::sort(Infos);
+        Infos.erase(std::unique(Infos.begin(), Infos.end()), Infos.end());
       }
 
-      auto *Result = new (C) serialization::DeclID[1 + IDs.size()];
-      *Result = IDs.size();
-      std::copy(IDs.begin(), IDs.end(), Result + 1);
+      auto *Result = new (C) LazySpecializationInfo[1 + Infos.size()];
+      Result->DeclID = Infos.size();
+      std::copy(Infos.begin(), Infos.end(), Result + 1);
 
       LazySpecializations = Result;
     }
@@ -312,7 +324,7 @@ namespace clang {
     void ReadFunctionDefinition(FunctionDecl *FD);
     void Visit(Decl *D);
 
-    void UpdateDecl(Decl *D, SmallVectorImpl<serialization::DeclID> &);
+    void UpdateDecl(Decl *D, SmallVectorImpl<LazySpecializationInfo> &);
 
     static void setNextObjCCategory(ObjCCategoryDecl *Cat,
                                     ObjCCategoryDecl *Next) {
@@ -2131,9 +2143,9 @@ void ASTDeclReader::VisitClassTemplateDecl(ClassTemplateDecl *D) {
   if (ThisDeclID == Redecl.getFirstID()) {
     // This ClassTemplateDecl owns a CommonPtr; read it to keep track of all of
     // the specializations.
-    SmallVector<serialization::DeclID, 32> SpecIDs;
-    ReadDeclIDList(SpecIDs);
-    ASTDeclReader::AddLazySpecializations(D, SpecIDs);
+    SmallVector<LazySpecializationInfo, 32> SpecInfos;
+    ReadLazySpecializationList(SpecInfos);
+    ASTDeclReader::AddLazySpecializations(D, SpecInfos);
   }
 
   if (D->getTemplatedDecl()->TemplateOrInstantiation) {
@@ -2158,9 +2170,9 @@ void ASTDeclReader::VisitVarTemplateDecl(VarTemplateDecl *D) {
   if (ThisDeclID == Redecl.getFirstID()) {
     // This VarTemplateDecl owns a CommonPtr; read it to keep track of all of
     // the specializations.
-    SmallVector<serialization::DeclID, 32> SpecIDs;
-    ReadDeclIDList(SpecIDs);
-    ASTDeclReader::AddLazySpecializations(D, SpecIDs);
+    SmallVector<LazySpecializationInfo, 32> SpecInfos;
+    ReadLazySpecializationList(SpecInfos);
+    ASTDeclReader::AddLazySpecializations(D, SpecInfos);
   }
 }
 
@@ -2265,9 +2277,9 @@ void ASTDeclReader::VisitFunctionTemplateDecl(FunctionTemplateDecl *D) {
 
   if (ThisDeclID == Redecl.getFirstID()) {
     // This FunctionTemplateDecl owns a CommonPtr; read it.
-    SmallVector<serialization::DeclID, 32> SpecIDs;
-    ReadDeclIDList(SpecIDs);
-    ASTDeclReader::AddLazySpecializations(D, SpecIDs);
+    SmallVector<LazySpecializationInfo, 32> SpecInfos;
+    ReadLazySpecializationList(SpecInfos);
+    ASTDeclReader::AddLazySpecializations(D, SpecInfos);
   }
 }
 
@@ -4006,7 +4018,7 @@ void ASTReader::loadDeclUpdateRecords(PendingUpdateRecord &Record) {
   ProcessingUpdatesRAIIObj ProcessingUpdates(*this);
   DeclUpdateOffsetsMap::iterator UpdI = DeclUpdateOffsets.find(ID);
 
-  SmallVector<serialization::DeclID, 8> PendingLazySpecializationIDs;
+  SmallVector<LazySpecializationInfo, 8> PendingLazySpecializationInfos;
 
   if (UpdI != DeclUpdateOffsets.end()) {
     auto UpdateOffsets = std::move(UpdI->second);
@@ -4032,7 +4044,7 @@ void ASTReader::loadDeclUpdateRecords(PendingUpdateRecord &Record) {
 
       ASTDeclReader Reader(*this, Record, RecordLocation(F, Offset), ID,
                            SourceLocation());
-      Reader.UpdateDecl(D, PendingLazySpecializationIDs);
+      Reader.UpdateDecl(D, PendingLazySpecializationInfos);
 
       // We might have made this declaration interesting. If so, remember that
       // we need to hand it off to the consumer.
@@ -4045,16 +4057,16 @@ void ASTReader::loadDeclUpdateRecords(PendingUpdateRecord &Record) {
     }
   }
   // Add the lazy specializations to the template.
-  assert((PendingLazySpecializationIDs.empty() || isa<ClassTemplateDecl>(D) ||
+  assert((PendingLazySpecializationInfos.empty() || isa<ClassTemplateDecl>(D) ||
           isa<FunctionTemplateDecl>(D) || isa<VarTemplateDecl>(D)) &&
          "Must not have pending specializations");
   if (auto *CTD = dyn_cast<ClassTemplateDecl>(D))
-    ASTDeclReader::AddLazySpecializations(CTD, PendingLazySpecializationIDs);
+    ASTDeclReader::AddLazySpecializations(CTD, PendingLazySpecializationInfos);
   else if (auto *FTD = dyn_cast<FunctionTemplateDecl>(D))
-    ASTDeclReader::AddLazySpecializations(FTD, PendingLazySpecializationIDs);
+    ASTDeclReader::AddLazySpecializations(FTD, PendingLazySpecializationInfos);
   else if (auto *VTD = dyn_cast<VarTemplateDecl>(D))
-    ASTDeclReader::AddLazySpecializations(VTD, PendingLazySpecializationIDs);
-  PendingLazySpecializationIDs.clear();
+    ASTDeclReader::AddLazySpecializations(VTD, PendingLazySpecializationInfos);
+  PendingLazySpecializationInfos.clear();
 
   // Load the pending visible updates for this decl context, if it has any.
   auto I = PendingVisibleUpdates.find(ID);
@@ -4252,7 +4264,8 @@ static void forAllLaterRedecls(DeclT *D, Fn F) {
 }
 
 void ASTDeclReader::UpdateDecl(Decl *D,
-   llvm::SmallVectorImpl<serialization::DeclID> &PendingLazySpecializationIDs) {
+                               llvm::SmallVectorImpl<LazySpecializationInfo>
+                                   &PendingLazySpecializationInfos) {
   while (Record.getIdx() < Record.size()) {
     switch ((DeclUpdateKind)Record.readInt()) {
     case UPD_CXX_ADDED_IMPLICIT_MEMBER: {
@@ -4267,10 +4280,15 @@ void ASTDeclReader::UpdateDecl(Decl *D,
       break;
     }
 
-    case UPD_CXX_ADDED_TEMPLATE_SPECIALIZATION:
+    case UPD_CXX_ADDED_TEMPLATE_SPECIALIZATION: {
       // It will be added to the template's lazy specialization set.
-      PendingLazySpecializationIDs.push_back(ReadDeclID());
+      DeclID ID = ReadDeclID();
+      unsigned Hash = Record.readInt();
+      bool IsPartial = Record.readInt();
+      PendingLazySpecializationInfos.push_back(
+          LazySpecializationInfo(ID, Hash, IsPartial));
       break;
+    }
 
     case UPD_CXX_ADDED_ANONYMOUS_NAMESPACE: {
       auto *Anon = ReadDeclAs<NamespaceDecl>();
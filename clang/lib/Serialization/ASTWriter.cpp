@@ -5224,12 +5224,22 @@ void ASTWriter::WriteDeclUpdatesBlocks(RecordDataImpl &OffsetsRecord) {
 
       switch (Kind) {
       case UPD_CXX_ADDED_IMPLICIT_MEMBER:
-      case UPD_CXX_ADDED_TEMPLATE_SPECIALIZATION:
       case UPD_CXX_ADDED_ANONYMOUS_NAMESPACE:
         assert(Update.getDecl() && "no decl to add?");
         Record.push_back(GetDeclRef(Update.getDecl()));
         break;
 
+      case UPD_CXX_ADDED_TEMPLATE_SPECIALIZATION: {
+        const Decl *Spec = Update.getDecl();
+        assert(Spec && "no decl to add?");
+        Record.push_back(GetDeclRef(Spec));
+        Record.push_back(
+            RedeclarableTemplateDecl::computeSpecializationArgsHash(Spec));
+        Record.push_back(isa<ClassTemplatePartialSpecializationDecl>(Spec) ||
+                         isa<VarTemplatePartialSpecializationDecl>(Spec));
+        break;
+      }
+
       case UPD_CXX_ADDED_FUNCTION_DEFINITION:
         break;
 
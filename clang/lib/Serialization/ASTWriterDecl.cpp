@@ -169,7 +169,8 @@ namespace clang {
     /// Add to the record the first declaration from each module file that
     /// provides a declaration of D. The intent is to provide a sufficient
     /// set such that reloading this set will load all current redeclarations.
-    void AddFirstDeclFromEachModule(const Decl *D, bool IncludeLocal) {
+    llvm::MapVector<ModuleFile *, const Decl *>
+    getFirstDeclFromEachModule(const Decl *D, bool IncludeLocal) {
       llvm::MapVector<ModuleFile*, const Decl*> Firsts;
       // FIXME: We can skip entries that we know are implied by others.
       for (const Decl *R = D->getMostRecentDecl(); R; R = R->getPreviousDecl()) {
@@ -178,7 +179,11 @@ namespace clang {
         else if (IncludeLocal)
           Firsts[nullptr] = R;
       }
-      for (const auto &F : Firsts)
+      return Firsts;
+    }
+
+    void AddFirstDeclFromEachModule(const Decl *D, bool IncludeLocal) {
+      for (const auto &F : getFirstDeclFromEachModule(D, IncludeLocal))
         Record.AddDeclRef(F.second);
     }
 
@@ -211,13 +216,15 @@ namespace clang {
         assert(!Common->LazySpecializations);
       }
 
-      ArrayRef<DeclID> LazySpecializations;
+      ArrayRef<RedeclarableTemplateDecl::LazySpecializationInfo>
+          LazySpecializations;
       if (auto *LS = Common->LazySpecializations)
-        LazySpecializations = llvm::makeArrayRef(LS + 1, LS[0]);
+        LazySpecializations = llvm::makeArrayRef(LS + 1, LS[0].DeclID);
 
       // Add a slot to the record for the number of specializations.
       unsigned I = Record.size();
       Record.push_back(0);
+      unsigned NumSpecs = 0;
 
       // AddFirstDeclFromEachModule might trigger deserialization, invalidating
       // *Specializations iterators.
@@ -229,12 +236,27 @@ namespace clang {
 
       for (auto *D : Specs) {
         assert(D->isCanonicalDecl() && "non-canonical decl in set");
-        AddFirstDeclFromEachModule(D, /*IncludeLocal*/true);
+        unsigned Hash =
+            RedeclarableTemplateDecl::computeSpecializationArgsHash(D);
+        bool IsPartial = isa<ClassTemplatePartialSpecializationDecl>(D) ||
+                         isa<VarTemplatePartialSpecializationDecl>(D);
+        for (const auto &F :
+             getFirstDeclFromEachModule(D, /*IncludeLocal*/ true)) {
+          Record.AddDeclRef(F.second);
+          Record.push_back(Hash);
+          Record.push_back(IsPartial);
+          ++NumSpecs;
+        }
+      }
+      for (const auto &Info : LazySpecializations) {
+        Record.push_back(Info.DeclID);
+        Record.push_back(Info.ArgsHash);
+        Record.push_back(Info.IsPartial);
+        ++NumSpecs;
       }
-      Record.append(LazySpecializations.begin(), LazySpecializations.end());
 
       // Update the size entry we added earlier.
-      Record[I] = Record.size() - I - 1;
+      Record[I] = NumSpecs;
     }
 
     /// Ensure that this template specialization is associated with the specified
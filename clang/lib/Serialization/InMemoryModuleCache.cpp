@@ -11,6 +11,76 @@
 
 using namespace clang;
 
+namespace {
+
+/// A buffer referring to the contents shared by a SharedModuleFileCache,
+/// keeping them alive.
+class SharedBufferRef : public llvm::MemoryBuffer {
+  std::shared_ptr<llvm::MemoryBuffer> Contents;
+
+public:
+  SharedBufferRef(std::shared_ptr<llvm::MemoryBuffer> Contents)
+      : Contents(std::move(Contents)) {
+    init(this->Contents->getBufferStart(), this->Contents->getBufferEnd(),
+         /*RequiresNullTerminator=*/false);
+  }
+
+  llvm::StringRef getBufferIdentifier() const override {
+    return Contents->getBufferIdentifier();
+  }
+
+  BufferKind getBufferKind() const override {
+    return Contents->getBufferKind();
+  }
+};
+
+} // end anonymous namespace
+
+llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>
+SharedModuleFileCache::getBuffer(llvm::sys::fs::UniqueID ID, off_t Size,
+                                 time_t ModTime, ReadFn Read) {
+  Key K(ID, Size, ModTime);
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto I = Buffers.find(K);
+    if (I != Buffers.end())
+      if (std::shared_ptr<llvm::MemoryBuffer> Contents = I->second.lock())
+        return llvm::make_unique<SharedBufferRef>(std::move(Contents));
+  }
+
+  // Read the file without holding the lock, so that the compilations reading
+  // other files are not blocked.
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buf = Read();
+  if (!Buf)
+    return Buf.getError();
+  std::shared_ptr<llvm::MemoryBuffer> Contents = std::move(*Buf);
+
+  std::lock_guard<std::mutex> Lock(Mutex);
+  std::weak_ptr<llvm::MemoryBuffer> &Entry = Buffers[K];
+  // Use the contents read concurrently by another compilation, if any, so
+  // that the compilations keep agreeing on the buffer of a PCM.
+  if (std::shared_ptr<llvm::MemoryBuffer> Existing = Entry.lock())
+    Contents = std::move(Existing);
+  else
+    Entry = Contents;
+
+  // Forget about the contents which are not used anymore.
+  for (auto I = Buffers.begin(); I != Buffers.end();) {
+    if (I->second.expired())
+      I = Buffers.erase(I);
+    else
+      ++I;
+  }
+  return llvm::make_unique<SharedBufferRef>(std::move(Contents));
+}
+
+unsigned SharedModuleFileCache::getNumBuffers() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return llvm::count_if(Buffers, [](const decltype(Buffers)::value_type &E) {
+    return !E.second.expired();
+  });
+}
+
 InMemoryModuleCache::State
 InMemoryModuleCache::getPCMState(llvm::StringRef Filename) const {
   auto I = PCMs.find(Filename);
@@ -179,13 +179,22 @@ ModuleManager::addModule(StringRef FileName, ModuleKind Type,
   } else {
     // Open the AST file.
     llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buf((std::error_code()));
+    auto ReadFile = [&] {
+      // Get a buffer of the file and close the file descriptor when done.
+      return FileMgr.getBufferForFile(NewModule->File,
+                                      /*IsVolatile=*/false,
+                                      /*ShouldClose=*/true);
+    };
     if (FileName == "-") {
       Buf = llvm::MemoryBuffer::getSTDIN();
+    } else if (SharedModuleFileCache *SharedFiles =
+                   getModuleCache().getSharedFileCache()) {
+      // Reuse the contents other compilations of this process read.
+      Buf = SharedFiles->getBuffer(Entry->getUniqueID(), Entry->getSize(),
+                                   Entry->getModificationTime(), ReadFile);
+      Entry->closeFile();
     } else {
-      // Get a buffer of the file and close the file descriptor when done.
-      Buf = FileMgr.getBufferForFile(NewModule->File,
-                                     /*IsVolatile=*/false,
-                                     /*ShouldClose=*/true);
+      Buf = ReadFile();
     }
 
     if (!Buf) {
@@ -0,0 +1,33 @@
+// REQUIRES: x86-registered-target
+// REQUIRES: zlib
+
+// -------
+// Generate files to wrap: one compressible, one too small to benefit from
+// compression.
+//
+// RUN: %python -c "print('0123456789abcdef' * 64)" > %t1.tgt
+// RUN: echo 'x' > %t2.tgt
+//
+// -------
+// Check that the SYCL images are compressed with -compress and marked with
+// the compressed flag (0x80) in the format field, the image which doesn't get
+// smaller is left as is.
+//
+// RUN: clang-offload-wrapper -compress                                           \
+// RUN:   -host=x86_64-pc-linux-gnu                                               \
+// RUN:     -kind=sycl -target=spir64 -format=spirv  %t1.tgt                      \
+// RUN:                -target=xxx    -format=native %t2.tgt                      \
+// RUN:   -o - | llvm-dis | FileCheck %s --check-prefix CHECK-IR
+
+// CHECK-IR: [[SYCL_BIN0:@.+]] = internal unnamed_addr constant [{{[0-9]+}} x i8] c"\01\04\00\00\00\00\00\00
+// CHECK-IR: [[SYCL_BIN1:@.+]] = internal unnamed_addr constant [2 x i8] c"x\0A"
+// CHECK-IR: %__tgt_device_image { i16 1, i8 4, i8 -126, {{.+}} }, %__tgt_device_image { i16 1, i8 4, i8 1, {{.+}} }
+
+// -------
+// Check that the images are not compressed without -compress.
+//
+// RUN: clang-offload-wrapper -host=x86_64-pc-linux-gnu -kind=sycl -format=spirv \
+// RUN:   -o - %t1.tgt | llvm-dis | FileCheck %s --check-prefix CHECK-IR1
+
+// CHECK-IR1: internal unnamed_addr constant [1025 x i8] c"0123456789abcdef
+// CHECK-IR1: { i16 1, i8 4, i8 2,
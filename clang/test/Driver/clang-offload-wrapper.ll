@@ -33,8 +33,10 @@
 // CHECK-HELP: {{.*}}OPTIONS:
 // CHECK-HELP: {{.*}}clang-offload-wrapper options:
 // CHECK-HELP: {{.*}}  -build-opts=<string>    - build options passed to the offload runtime
+// CHECK-HELP: {{.*}}  -compress               - Compress SYCL device binary images with zlib, the runtime decompresses an image when it is first used
 // CHECK-HELP: {{.*}}  -desc-name=<name>       - Specifies offload descriptor symbol name: '.<offload kind>.<name>', and makes it globally visible
 // CHECK-HELP: {{.*}}  -emit-reg-funcs         - Emit [un-]registration functions
+// CHECK-HELP: {{.*}}  -entries=<filename>     - file with the names of the SYCL kernels in the next device binary image, one per line
 // CHECK-HELP: {{.*}}  -format                 - device binary image formats:
 // CHECK-HELP: {{.*}}    =none                 -   not set
 // CHECK-HELP: {{.*}}    =native               -   unknown or native
@@ -159,4 +161,26 @@
 
 // CHECK-IR2: declare void @__UNREGFUNC__
 
+// -------
+// Check the offload entry tables of the SYCL images listing their kernels.
+//
+// RUN: printf 'kernel1\nkernel2\n' > %t1.sym
+// RUN: clang-offload-wrapper -kind sycl -host=x86_64-pc-linux-gnu                \
+// RUN:   -entries=%t1.sym %t1.tgt -format=native %t2.tgt -o - | llvm-dis | FileCheck %s --check-prefix CHECK-IR3
+// CHECK-IR3: [[NAME0:@.+]] = internal unnamed_addr constant [8 x i8] c"kernel1\00"
+// CHECK-IR3: [[NAME1:@.+]] = internal unnamed_addr constant [8 x i8] c"kernel2\00"
+// CHECK-IR3: [[ENTRIES:@.+]] = internal unnamed_addr constant [2 x %__tgt_offload_entry] [%__tgt_offload_entry { i8* null, i8* getelementptr inbounds ([8 x i8], [8 x i8]* [[NAME0]], i64 0, i64 0), i64 0, i32 0, i32 0 }, %__tgt_offload_entry { i8* null, i8* getelementptr inbounds ([8 x i8], [8 x i8]* [[NAME1]], i64 0, i64 0), i64 0, i32 0, i32 0 }]
+// CHECK-IR3: @.sycl_offloading.device_images = {{.+}} %__tgt_offload_entry* getelementptr inbounds ([2 x %__tgt_offload_entry], [2 x %__tgt_offload_entry]* [[ENTRIES]], i64 0, i64 0), %__tgt_offload_entry* getelementptr inbounds ([2 x %__tgt_offload_entry], [2 x %__tgt_offload_entry]* [[ENTRIES]], i64 1, i64 0) }, %__tgt_device_image { {{.+}}, %__tgt_offload_entry* null, %__tgt_offload_entry* null }]
 
+// -------
+// Check that the images with the same contents share their data, whatever
+// their formats.
+//
+// RUN: cp %t1.tgt %t1_copy.tgt
+// RUN: clang-offload-wrapper -kind sycl -host=x86_64-pc-linux-gnu -format=spirv \
+// RUN:   %t1.tgt %t1_copy.tgt -format=native %t1.tgt %t2.tgt -o - | llvm-dis | FileCheck %s --check-prefix CHECK-IR4
+// CHECK-IR4: [[BIN0:@.+]] = internal unnamed_addr constant [24 x i8] c"Content of device file1\0A"
+// CHECK-IR4-NOT: c"Content of device file1\0A"
+// CHECK-IR4: [[BIN3:@.+]] = internal unnamed_addr constant [24 x i8] c"Content of device file2\0A"
+// CHECK-IR4-NOT: c"Content of device file1\0A"
+// CHECK-IR4: @.sycl_offloading.device_images = {{.+}} [24 x i8]* [[BIN0]], i64 1, i64 0), {{.+}} [24 x i8]* [[BIN0]], i64 1, i64 0), {{.+}} [24 x i8]* [[BIN0]], i64 1, i64 0), {{.+}} [24 x i8]* [[BIN3]], i64 1, i64 0), {{.+}} }]
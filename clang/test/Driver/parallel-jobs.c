@@ -0,0 +1,24 @@
+// Check that -fparallel-jobs=N is handled by the driver and not passed to the
+// jobs.
+
+// RUN: %clang -target x86_64-unknown-linux -### -fparallel-jobs=4 -c %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-JOBS %s
+// CHECK-JOBS-NOT: argument unused
+// CHECK-JOBS: "-cc1"
+// CHECK-JOBS-NOT: parallel-jobs
+
+// RUN: %clang -target x86_64-unknown-linux -### -fparallel-jobs=0 -c %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-INVALID %s
+// RUN: %clang -target x86_64-unknown-linux -### -fparallel-jobs=x -c %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-INVALID %s
+// CHECK-INVALID: error: invalid integral value
+
+// The jobs of independent inputs run at once and fail independently.
+// RUN: %clang -fparallel-jobs=2 -fsyntax-only %s %s
+// RUN: not %clang -fparallel-jobs=2 -fsyntax-only -DFAIL %s %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-FAIL %s
+// CHECK-FAIL-COUNT-2: error: unknown type name 'fail'
+
+#ifdef FAIL
+fail x;
+#endif
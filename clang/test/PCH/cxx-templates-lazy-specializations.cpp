@@ -0,0 +1,38 @@
+// Check that looking up a specialization of a template from a PCH only
+// deserializes the specializations which may have the same arguments.
+
+// RUN: %clang_cc1 -std=c++11 -emit-pch -o %t %s
+// RUN: %clang_cc1 -std=c++11 -include-pch %t -verify %s \
+// RUN:   -error-on-deserialized-decl Unused
+
+#ifndef HEADER
+#define HEADER
+
+struct Unused {};
+
+template <typename T> struct S { static const int value = 0; };
+template <> struct S<int> { static const int value = 1; };
+template <> struct S<Unused> { static const int value = 2; };
+template <typename T> struct S<T *> { static const int value = 3; };
+template <typename T> struct S<T &> { static const int value = 4; };
+
+S<long> Long;
+
+template <typename T> int f(T) { return 0; }
+template <> int f<int>(int) { return 1; }
+template <> int f<Unused>(Unused) { return 2; }
+
+#else
+
+// expected-no-diagnostics
+
+static_assert(S<int>::value == 1, "");
+static_assert(S<long>::value == 0, "");
+static_assert(S<unsigned>::value == 0, "");
+static_assert(S<char *>::value == 3, "");
+static_assert(S<int &>::value == 4, "");
+
+int One = f(1);
+int Zero = f(1.0);
+
+#endif
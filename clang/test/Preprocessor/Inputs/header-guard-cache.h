@@ -0,0 +1,4 @@
+#ifndef HEADER_GUARD_CACHE_H
+#define HEADER_GUARD_CACHE_H
+int guarded;
+#endif
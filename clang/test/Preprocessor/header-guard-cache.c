@@ -0,0 +1,18 @@
+// The first compilation records the include guard of the header.
+// RUN: rm -f %t.cache
+// RUN: %clang_cc1 -E -header-guard-cache %t.cache -I %S/Inputs %s -o /dev/null
+// RUN: FileCheck -check-prefix=CACHE -input-file %t.cache %s
+// CACHE: {{[0-9]+ -?[0-9]+}} HEADER_GUARD_CACHE_H {{.*}}header-guard-cache.h
+
+// Without the cache, the header is entered even though its guard is defined.
+// RUN: %clang_cc1 -E -H -DHEADER_GUARD_CACHE_H -I %S/Inputs %s -o /dev/null \
+// RUN:   2>&1 | FileCheck -check-prefix=ENTERED %s
+// ENTERED: header-guard-cache.h
+
+// With the cache, it is skipped without being lexed.
+// RUN: %clang_cc1 -E -H -DHEADER_GUARD_CACHE_H -header-guard-cache %t.cache \
+// RUN:   -I %S/Inputs %s -o /dev/null 2>&1 \
+// RUN:   | FileCheck -allow-empty -check-prefix=SKIPPED %s
+// SKIPPED-NOT: header-guard-cache.h
+
+#include "header-guard-cache.h"
@@ -0,0 +1,31 @@
+// RUN: %clang_cc1 -fsyntax-only -verify -std=c++11 %s
+
+// The substituted default template arguments are reused for the same
+// arguments, but their failures are still reported at each use.
+
+template<bool B, class T = void> struct enable_if {};
+template<class T> struct enable_if<true, T> { typedef T type; };
+
+template<class T> struct is_int { static const bool value = false; };
+template<> struct is_int<int> { static const bool value = true; };
+
+template<class T, class = typename enable_if<is_int<T>::value>::type>
+int f(T); // expected-note 2{{candidate template ignored}}
+
+int a = f(1);
+int b = f(2);
+int c = f(1.0f); // expected-error {{no matching function for call to 'f'}}
+int d = f(2.0f); // expected-error {{no matching function for call to 'f'}}
+
+template<class T, class U = typename T::type> // expected-error 2{{no type named 'type' in 'B'}}
+struct S { U u; };
+
+struct A { typedef int type; };
+struct B {};
+
+S<A> s1;
+S<A> s2;
+static_assert(sizeof(S<A>) == sizeof(int), "");
+
+S<B> s3; // expected-note {{in instantiation of default argument}}
+S<B> s4; // expected-note {{in instantiation of default argument}}
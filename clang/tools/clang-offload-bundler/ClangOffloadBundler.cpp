@@ -39,11 +39,14 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <system_error>
@@ -154,21 +157,29 @@ public:
   /// Read the marker that closes the current bundle.
   virtual void ReadBundleEnd(MemoryBuffer &Input) = 0;
 
-  /// Read the current bundle and write the result into the stream \a OS.
-  virtual void ReadBundle(raw_fd_ostream &OS, MemoryBuffer &Input) = 0;
-
-  /// Read the current bundle and write the result into the file \a FileName.
-  /// The meaning of \a FileName depends on unbundling type - in some
-  /// cases (type="oo") it will contain a list of actual outputs.
-  virtual void ReadBundle(StringRef FileName, MemoryBuffer &Input) {
-    std::error_code EC;
-    raw_fd_ostream OS(FileName, EC);
+  /// Read the current bundle and return its contents, which are a part of
+  /// \a Input.
+  virtual StringRef ReadBundle(MemoryBuffer &Input) = 0;
+
+  /// Read the current bundle and return a task writing the result into the
+  /// file \a FileName. The meaning of \a FileName depends on unbundling type -
+  /// in some cases (type="oo") it will contain a list of actual outputs. The
+  /// tasks of different bundles are independent, they can run concurrently
+  /// while \a Input is alive.
+  virtual std::function<void()> ReadBundle(StringRef FileName,
+                                           MemoryBuffer &Input) {
+    StringRef Bundle = ReadBundle(Input);
+    std::string Name = FileName.str();
+    return [Bundle, Name]() {
+      std::error_code EC;
+      raw_fd_ostream OS(Name, EC);
 
-    if (EC)
-      report_fatal_error(Twine("Can't open file for writing ") +
-                               Twine(FileName) + Twine(": ") +
-                               Twine(EC.message()));
-    ReadBundle(OS, Input);
+      if (EC)
+        report_fatal_error(Twine("Can't open file for writing ") +
+                                 Twine(Name) + Twine(": ") +
+                                 Twine(EC.message()));
+      OS << Bundle;
+    };
   }
 
   /// Write the header of the bundled file to \a OS based on the information
@@ -344,11 +355,10 @@ public:
 
   using FileHandler::ReadBundle; // to avoid hiding via the overload below
 
-  void ReadBundle(raw_fd_ostream &OS, MemoryBuffer &Input) final {
+  StringRef ReadBundle(MemoryBuffer &Input) final {
     assert(CurBundleInfo != BundlesInfo.end() && "Invalid reader info!");
     StringRef FC = Input.getBuffer();
-    OS.write(FC.data() + CurBundleInfo->second.Offset,
-             CurBundleInfo->second.Size);
+    return FC.substr(CurBundleInfo->second.Offset, CurBundleInfo->second.Size);
   }
 
   void WriteHeader(raw_fd_ostream &OS,
@@ -596,17 +606,24 @@ public:
 
   void ReadBundleEnd(MemoryBuffer &Input) final {}
 
-  void ReadBundle(raw_fd_ostream &OS, MemoryBuffer &Input) {
+  StringRef ReadBundle(MemoryBuffer &Input) final {
     llvm_unreachable("must not be called for the ObjectFileHandler");
   }
 
-  virtual void ReadBundle(StringRef OutName,
-                          MemoryBuffer &Input) final override {
+  std::function<void()> ReadBundle(StringRef OutName,
+                                   MemoryBuffer &Input) final {
     assert(CurBundle != TripleToBundleInfo.end() &&
            "all bundles have been read already");
+    const BundleInfo &BI = *CurBundle->second;
+    std::string Name = OutName.str();
+    return [this, &BI, Name, &Input]() { ReadBundle(BI, Name, Input); };
+  }
+
+  /// Extract the bundle described by \a BI into \a OutName.
+  void ReadBundle(const BundleInfo &BI, StringRef OutName,
+                  MemoryBuffer &Input) const {
     // Read content of the section representing the bundle
-    Expected<StringRef> Content =
-      CurBundle->second->BundleSection->getContents();
+    Expected<StringRef> Content = BI.BundleSection->getContents();
     if (!Content) {
       consumeError(Content.takeError());
       return;
@@ -614,7 +631,7 @@ public:
     const char *ObjData = Content->data();
     // Determine the number of "device objects" (or individual bundles
     // concatenated by partial linkage) in the bundle:
-    const auto &SizeVec = CurBundle->second->ObjectSizes;
+    const auto &SizeVec = BI.ObjectSizes;
     auto NumObjects = SizeVec.size();
     bool FileListMode = FilesType == "oo";
 
@@ -919,15 +936,14 @@ protected:
 
   using FileHandler::ReadBundle; // to avoid hiding via the overload below
 
-  void ReadBundle(raw_fd_ostream &OS, MemoryBuffer &Input) final {
+  StringRef ReadBundle(MemoryBuffer &Input) final {
     StringRef FC = Input.getBuffer();
     size_t BundleStart = ReadChars;
 
     // Find end of the bundle.
     size_t BundleEnd = ReadChars = FC.find(BundleEndString, ReadChars);
 
-    StringRef Bundle(&FC.data()[BundleStart], BundleEnd - BundleStart);
-    OS << Bundle;
+    return StringRef(&FC.data()[BundleStart], BundleEnd - BundleStart);
   }
 
   void WriteHeader(raw_fd_ostream &OS,
@@ -1061,9 +1077,12 @@ static bool BundleFiles() {
 // Unbundle the files. Return true if an error was found.
 static bool UnbundleFiles() {
   const StringRef InputFileName = InputFileNames.front();
-  // Open Input file.
+  // Open Input file. None of the handlers needs a null terminated buffer, so
+  // the input can be mapped rather than read, and the bundles are written
+  // straight from the mapping.
   ErrorOr<std::unique_ptr<MemoryBuffer>> CodeOrErr =
-      MemoryBuffer::getFileOrSTDIN(InputFileName);
+      MemoryBuffer::getFileOrSTDIN(InputFileName, /*FileSize=*/-1,
+                                   /*RequiresNullTerminator=*/false);
   if (std::error_code EC = CodeOrErr.getError()) {
     errs() << "error: Can't open file " << InputFileName << ": " << EC.message()
            << "\n";
@@ -1071,6 +1090,14 @@ static bool UnbundleFiles() {
   }
   MemoryBuffer &Input = *CodeOrErr.get();
 
+  // Create a work list that consist of the map triple/output file.
+  StringMap<StringRef> Worklist;
+  auto Output = OutputFileNames.begin();
+  for (auto &Triple : TargetNames) {
+    Worklist[Triple] = *Output;
+    ++Output;
+  }
+
   // Select the right files handler.
   std::unique_ptr<FileHandler> FH;
   FH.reset(CreateFileHandler(Input));
@@ -1082,21 +1109,22 @@ static bool UnbundleFiles() {
   // Seed temporary filename generation with the stem of the input file.
   FH->SetTempFileNameBase(llvm::sys::path::stem(InputFileName));
 
-  // Read the header of the bundled file.
-  FH->ReadHeader(Input);
+  // All the bundled formats carry the magic string, in the header, in the
+  // bundle markers or in the section names. An input without it was not
+  // bundled, so there are no bundles to look for.
+  const bool IsBundled =
+      Input.getBuffer().find(OFFLOAD_BUNDLER_MAGIC_STR) != StringRef::npos;
 
-  // Create a work list that consist of the map triple/output file.
-  StringMap<StringRef> Worklist;
-  auto Output = OutputFileNames.begin();
-  for (auto &Triple : TargetNames) {
-    Worklist[Triple] = *Output;
-    ++Output;
-  }
+  // Read the header of the bundled file.
+  if (IsBundled)
+    FH->ReadHeader(Input);
 
   // Read all the bundles that are in the work list. If we find no bundles we
-  // assume the file is meant for the host target.
+  // assume the file is meant for the host target. The bundles are written
+  // once they were all read, in parallel.
+  std::vector<std::function<void()>> WriteTasks;
   bool FoundHostBundle = false;
-  while (!Worklist.empty()) {
+  while (IsBundled && !Worklist.empty()) {
     StringRef CurTriple = FH->ReadBundleStart(Input);
 
     // We don't have more bundles.
@@ -1111,7 +1139,7 @@ static bool UnbundleFiles() {
     }
 
     // Check if the output file can be opened and copy the bundle to it.
-    FH->ReadBundle(Output->second, Input);
+    WriteTasks.push_back(FH->ReadBundle(Output->second, Input));
     FH->ReadBundleEnd(Input);
     Worklist.erase(Output);
 
@@ -1120,6 +1148,16 @@ static bool UnbundleFiles() {
       FoundHostBundle = true;
   }
 
+  if (WriteTasks.size() > 1) {
+    ThreadPool Pool(
+        std::min<unsigned>(WriteTasks.size(), hardware_concurrency()));
+    for (auto &Task : WriteTasks)
+      Pool.async(Task);
+    Pool.wait();
+  } else if (!WriteTasks.empty()) {
+    WriteTasks.front()();
+  }
+
   // If no bundles were found, assume the input file is the host bundle and
   // create empty files for the remaining targets.
   if (Worklist.size() == TargetNames.size()) {
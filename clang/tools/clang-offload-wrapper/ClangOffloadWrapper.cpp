@@ -20,6 +20,7 @@
 #include "llvm/ADT/IndexedMap.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/Constants.h"
@@ -28,8 +29,11 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Compression.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/raw_ostream.h"
@@ -139,6 +143,13 @@ static cl::list<std::string>
             cl::cat(ClangOffloadWrapperCategory),
             cl::cat(ClangOffloadWrapperCategory));
 
+/// Sets the file with the names of the SYCL kernels in the device binary image.
+static cl::list<std::string>
+    Entries("entries", cl::ZeroOrMore,
+            cl::desc("file with the names of the SYCL kernels in the next "
+                     "device binary image, one per line"),
+            cl::value_desc("filename"), cl::cat(ClangOffloadWrapperCategory));
+
 /// Specifies the target triple of the host wrapper.
 static cl::opt<std::string> Target("host", cl::Optional,
                                    cl::desc("wrapper object target triple"),
@@ -150,6 +161,12 @@ static cl::opt<bool> EmitRegFuncs("emit-reg-funcs", cl::NotHidden,
                                   cl::desc("Emit [un-]registration functions"),
                                   cl::cat(ClangOffloadWrapperCategory));
 
+static cl::opt<bool> Compress(
+    "compress", cl::Optional, cl::init(false),
+    cl::desc("Compress SYCL device binary images with zlib, the runtime "
+             "decompresses an image when it is first used"),
+    cl::cat(ClangOffloadWrapperCategory));
+
 static cl::opt<std::string>
     RegFuncName("reg-func-name", cl::Optional, cl::init("__tgt_register_lib"),
                 cl::desc("Offload descriptor registration function name"),
@@ -218,8 +235,9 @@ public:
   public:
     Image(const llvm::StringRef File_, const llvm::StringRef Manif_,
           const llvm::StringRef Tgt_, BinaryImageFormat Fmt_,
-          const llvm::StringRef Opts_)
-        : File(File_), Manif(Manif_), Tgt(Tgt_), Fmt(Fmt_), Opts(Opts_) {}
+          const llvm::StringRef Opts_, const llvm::StringRef Ents_)
+        : File(File_), Manif(Manif_), Tgt(Tgt_), Fmt(Fmt_), Opts(Opts_),
+          Ents(Ents_) {}
 
     /// Name of the file with actual contents
     const llvm::StringRef File;
@@ -231,6 +249,8 @@ public:
     const BinaryImageFormat Fmt;
     /// Build options
     const llvm::StringRef Opts;
+    /// Name of the file with the kernel names
+    const llvm::StringRef Ents;
 
     friend raw_ostream &operator<<(raw_ostream &Out, const Image &Img);
   };
@@ -250,14 +270,29 @@ private:
   /// Records all created memory buffers for safe auto-gc
   llvm::SmallVector<std::unique_ptr<MemoryBuffer>, 4> AutoGcBufs;
 
+  /// An image data global already added to the module.
+  struct EmbeddedImage {
+    /// Contents of the image file before compression
+    MemoryBuffer *Buf;
+    /// Pointers to the beginning and the end of the image data
+    std::pair<Constant *, Constant *> Data;
+    /// Whether the data is compressed
+    bool Compressed;
+  };
+  /// The embedded images per offload kind and MD5 of the image file contents,
+  /// so that identical images are embedded once.
+  llvm::DenseMap<OffloadKind, llvm::StringMap<EmbeddedImage>> EmbeddedImages;
+
 public:
   void addImage(const OffloadKind Kind, const llvm::StringRef File,
                 const llvm::StringRef Manif, const llvm::StringRef Tgt,
-                const BinaryImageFormat Fmt, const llvm::StringRef Opts) {
+                const BinaryImageFormat Fmt, const llvm::StringRef Opts,
+                const llvm::StringRef Ents) {
     std::unique_ptr<SameKindPack> &Pack = Packs[Kind];
     if (!Pack)
       Pack.reset(new SameKindPack());
-    Pack->emplace_back(llvm::make_unique<Image>(File, Manif, Tgt, Fmt, Opts));
+    Pack->emplace_back(
+        llvm::make_unique<Image>(File, Manif, Tgt, Fmt, Opts, Ents));
   }
 
 private:
@@ -376,6 +411,36 @@ private:
     return PointerType::getUnqual(getBinDescTy());
   }
 
+  // Set in the Format field of a device image on top of the image format when
+  // the image data is compressed. Must match PI_DEVICE_BINARY_FLAG_COMPRESSED
+  // of the SYCL runtime.
+  const uint8_t CompressedFormatFlag = 0x80;
+
+  // Compresses the given buffer with zlib, the result starts with the size of
+  // the original data as a little-endian 64-bit integer. Returns nullptr if
+  // compression doesn't make the image smaller.
+  MemoryBuffer *compressMemBuf(MemoryBuffer *Buf) {
+    SmallVector<char, 0> Compressed;
+    if (Error E = zlib::compress(Buf->getBuffer(), Compressed,
+                                 zlib::BestSizeCompression)) {
+      errs() << "error: can't compress " << Buf->getBufferIdentifier() << ": "
+             << toString(std::move(E)) << "\n";
+      exit(1);
+    }
+    const size_t HeaderSize = sizeof(uint64_t);
+    if (Compressed.size() + HeaderSize >= Buf->getBufferSize())
+      return nullptr;
+
+    std::unique_ptr<WritableMemoryBuffer> Res =
+        WritableMemoryBuffer::getNewUninitMemBuffer(
+            HeaderSize + Compressed.size(), Buf->getBufferIdentifier());
+    support::endian::write64le(Res->getBufferStart(), Buf->getBufferSize());
+    std::copy(Compressed.begin(), Compressed.end(),
+              Res->getBufferStart() + HeaderSize);
+    AutoGcBufs.emplace_back(std::move(Res));
+    return AutoGcBufs.back().get();
+  }
+
   MemoryBuffer *loadFile(llvm::StringRef Name) {
     auto InputOrErr = MemoryBuffer::getFileOrSTDIN(Name);
 
@@ -430,6 +495,48 @@ private:
     return ConstantExpr::getGetElementPtr(Var->getValueType(), Var, ZeroZero);
   }
 
+  // Creates the offload entry table holding the names of the SYCL kernels
+  // listed in the given file, one per line, and returns a pair of pointers to
+  // the beginning and the end of the table.
+  std::pair<Constant *, Constant *> addEntriesToModule(Module &M,
+                                                       MemoryBuffer *Buf,
+                                                       const Twine &Name) {
+    SmallVector<StringRef, 16> Names;
+    Buf->getBuffer().split(Names, '\n', -1, /*KeepEmpty=*/false);
+
+    auto *NullPtr = Constant::getNullValue(Type::getInt8PtrTy(C));
+    auto *Zero = ConstantInt::get(getSizeTTy(), 0u);
+    auto *Zero32 = ConstantInt::get(Type::getInt32Ty(C), 0u);
+    SmallVector<Constant *, 16> EntriesInits;
+    for (StringRef EntryName : Names) {
+      EntryName = EntryName.trim();
+      if (EntryName.empty())
+        continue;
+      auto *Fname = addStringToModule(
+          M, EntryName.str(),
+          Name + Twine(".name.") + Twine(EntriesInits.size()));
+      EntriesInits.push_back(ConstantStruct::get(
+          getEntryTy(), {NullPtr, Fname, Zero, Zero32, Zero32}));
+    }
+    auto *EntriesData = ConstantArray::get(
+        ArrayType::get(getEntryTy(), EntriesInits.size()), EntriesInits);
+    auto *Var = new GlobalVariable(M, EntriesData->getType(), true,
+                                   GlobalVariable::InternalLinkage, EntriesData,
+                                   Name);
+    if (Verbose)
+      errs() << "  global added: " << Var->getName() << "\n";
+    Var->setUnnamedAddr(GlobalValue::UnnamedAddr::Global);
+
+    Constant *ZeroZero[] = {Zero, Zero};
+    auto *EntriesB =
+        ConstantExpr::getGetElementPtr(Var->getValueType(), Var, ZeroZero);
+    auto *Size = ConstantInt::get(getSizeTTy(), EntriesInits.size());
+    Constant *ZeroSize[] = {Zero, Size};
+    auto *EntriesE =
+        ConstantExpr::getGetElementPtr(Var->getValueType(), Var, ZeroSize);
+    return std::make_pair(EntriesB, EntriesE);
+  }
+
   GlobalVariable *createBinDesc(OffloadKind Kind, SameKindPack &Pack) {
     const std::string OffloadKindTag =
         (Twine(".") + offloadKindToString(Kind) + Twine("_offloading.")).str();
@@ -467,7 +574,7 @@ private:
       auto *Fver =
           ConstantInt::get(Type::getInt16Ty(C), DeviceImageStructVersion);
       auto *Fknd = ConstantInt::get(Type::getInt8Ty(C), Kind);
-      auto *Ffmt = ConstantInt::get(Type::getInt8Ty(C), Img.Fmt);
+      uint8_t Fmt = Img.Fmt;
       auto *Ftgt = addStringToModule(
           M, Img.Tgt, Twine(OffloadKindTag) + Twine("target.") + Twine(ImgId));
       auto *Fopt = addStringToModule(
@@ -487,13 +594,53 @@ private:
         exit(1);
       }
       MemoryBuffer *Bin = loadFile(Img.File);
-      std::pair<Constant *, Constant *> Fbin = addMemBufToModule(
-          M, Bin, Twine(OffloadKindTag) + Twine(ImgId) + Twine(".data"));
+
+      // The images with the same contents share a single data global, the
+      // descriptors of all of them point to it.
+      MD5 Hash;
+      Hash.update(Bin->getBuffer());
+      MD5::MD5Result HashRes;
+      Hash.final(HashRes);
+      EmbeddedImage &Same = EmbeddedImages[Kind][HashRes.digest()];
+      std::pair<Constant *, Constant *> Fbin;
+      if (Same.Buf && Same.Buf->getBuffer() == Bin->getBuffer()) {
+        if (Verbose)
+          errs() << "  image data shared with "
+                 << Same.Buf->getBufferIdentifier() << "\n";
+        Fbin = Same.Data;
+        Fmt |= Same.Compressed ? CompressedFormatFlag : 0;
+      } else {
+        MemoryBuffer *Data = Bin;
+        // Only the SYCL runtime knows how to decompress the images.
+        if (Compress && Kind == OffloadKind::SYCL) {
+          if (MemoryBuffer *CBin = compressMemBuf(Bin)) {
+            if (Verbose)
+              errs() << "  image compressed: " << Bin->getBufferSize()
+                     << " -> " << CBin->getBufferSize() << " bytes\n";
+            Data = CBin;
+            Fmt |= CompressedFormatFlag;
+          }
+        }
+        Fbin = addMemBufToModule(
+            M, Data, Twine(OffloadKindTag) + Twine(ImgId) + Twine(".data"));
+        if (!Same.Buf)
+          Same = {Bin, Fbin, Data != Bin};
+      }
+      auto *Ffmt = ConstantInt::get(Type::getInt8Ty(C), Fmt);
+
+      // The SYCL images may list the kernels they contain, the other offload
+      // kinds share the entry table of the descriptor.
+      std::pair<Constant *, Constant *> FEnt(EntriesB, EntriesE);
+      if (Kind == OffloadKind::SYCL && !Img.Ents.empty()) {
+        MemoryBuffer *Ent = loadFile(Img.Ents);
+        FEnt = addEntriesToModule(
+            M, Ent, Twine(OffloadKindTag) + Twine(ImgId) + Twine(".entries"));
+      }
 
       ImagesInits.push_back(ConstantStruct::get(
           getDeviceImageTy(),
           {Fver, Fknd, Ffmt, Ftgt, Fopt, FMnf.first, FMnf.second, Fbin.first,
-           Fbin.second, EntriesB, EntriesE}));
+           Fbin.second, FEnt.first, FEnt.second}));
       ImgId++;
     }
     auto *ImagesData = ConstantArray::get(
@@ -598,6 +745,7 @@ llvm::raw_ostream &operator<<(llvm::raw_ostream &Out,
   Out << "  manifest = " << (Img.Manif.empty() ? "-" : Img.Manif) << "\n";
   Out << "  format   = " << formatToString(Img.Fmt) << "\n";
   Out << "  target   = " << (Img.Tgt.empty() ? "-" : Img.Tgt) << "\n";
+  Out << "  entries  = " << (Img.Ents.empty() ? "-" : Img.Ents) << "\n";
   Out << "  options  = " << (Img.Opts.empty() ? "-" : Img.Opts) << "\n";
   Out << "}\n";
   return Out;
@@ -773,6 +921,10 @@ int main(int argc, const char **argv) {
     errs() << "error: no target specified\n";
     return 1;
   }
+  if (Compress && !zlib::isAvailable()) {
+    errs() << "error: -compress requires the tool built with zlib\n";
+    return 1;
+  }
 
   // Construct BinaryWrapper::Image instances based on command line args and
   // add them to the wrapper
@@ -782,11 +934,12 @@ int main(int argc, const char **argv) {
   llvm::StringRef Tgt = "";
   BinaryImageFormat Fmt = BinaryImageFormat::none;
   llvm::StringRef Opts = "";
+  llvm::StringRef Ents = "";
   llvm::SmallVector<llvm::StringRef, 2> CurInputPair;
 
   ListArgsSequencer<decltype(Inputs), decltype(Kinds), decltype(Formats),
-                    decltype(Targets), decltype(Options)>
-      ArgSeq((size_t)argc, Inputs, Kinds, Formats, Targets, Options);
+                    decltype(Targets), decltype(Options), decltype(Entries)>
+      ArgSeq((size_t)argc, Inputs, Kinds, Formats, Targets, Options, Entries);
   int ID = -1;
 
   do {
@@ -807,8 +960,10 @@ int main(int argc, const char **argv) {
         }
         StringRef File = CurInputPair[0];
         StringRef Manif = CurInputPair.size() > 1 ? CurInputPair[1] : "";
-        Wr.addImage(Knd, File, Manif, Tgt, Fmt, Opts);
+        Wr.addImage(Knd, File, Manif, Tgt, Fmt, Opts, Ents);
         CurInputPair.clear();
+        // Unlike the other options, the entries belong to a single image.
+        Ents = "";
       }
     }
     switch (ID) {
@@ -829,6 +984,9 @@ int main(int argc, const char **argv) {
     case 4: // Options
       Opts = *(ArgSeq.template get<4>());
       break;
+    case 5: // Entries
+      Ents = *(ArgSeq.template get<5>());
+      break;
     default:
       llvm_unreachable("bad option class ID");
     }
@@ -118,6 +118,37 @@ TEST(MatchFinder, CheckProfiling) {
   EXPECT_EQ("MyID", Records.begin()->getKey());
 }
 
+TEST(MatchFinder, CheckProfilingSeparatesCallbacks) {
+  MatchFinder::MatchFinderOptions Options;
+  llvm::StringMap<llvm::TimeRecord> Records;
+  Options.CheckProfiling.emplace(Records);
+  MatchFinder Finder(std::move(Options));
+
+  struct NamedCallback : public MatchFinder::MatchCallback {
+    NamedCallback(StringRef ID) : ID(ID) {}
+    void run(const MatchFinder::MatchResult &Result) override { ++Matches; }
+    StringRef getID() const override { return ID; }
+    StringRef ID;
+    unsigned Matches = 0;
+  } DeclCallback("Decl"), StmtCallback("Stmt"), TypeCallback("Type");
+  Finder.addMatcher(varDecl(), &DeclCallback);
+  Finder.addMatcher(functionDecl(), &DeclCallback);
+  Finder.addMatcher(integerLiteral(), &StmtCallback);
+  Finder.addMatcher(builtinType(), &TypeCallback);
+  std::unique_ptr<FrontendActionFactory> Factory(
+      newFrontendActionFactory(&Finder));
+  ASSERT_TRUE(
+      tooling::runToolOnCode(Factory->create(), "void f() { int x = 1; }"));
+
+  EXPECT_EQ(2u, DeclCallback.Matches);
+  EXPECT_EQ(1u, StmtCallback.Matches);
+  EXPECT_LE(1u, TypeCallback.Matches);
+  EXPECT_EQ(3u, Records.size());
+  EXPECT_EQ(1u, Records.count("Decl"));
+  EXPECT_EQ(1u, Records.count("Stmt"));
+  EXPECT_EQ(1u, Records.count("Type"));
+}
+
 class VerifyStartOfTranslationUnit : public MatchFinder::MatchCallback {
 public:
   VerifyStartOfTranslationUnit() : Called(false) {}
@@ -532,4 +532,24 @@ TEST_F(LexerTest, CharRangeOffByOne) {
   EXPECT_EQ(Lexer::getSourceText(CR, SourceMgr, LangOpts), "MOO"); // Was "MO".
 }
 
+TEST_F(LexerTest, LongIdentifiersAndWhitespace) {
+  // Identifiers and runs of whitespace which span several of the blocks
+  // scanned at once, ending at each offset into a block.
+  for (unsigned Length = 1; Length != 40; ++Length) {
+    std::string Name = "_" + std::string(Length, 'a') + "Z9";
+    std::string Space(Length, ' ');
+    Space[Length / 2] = '\t';
+    std::string Source = Name + Space + Name + ";\n" + Space + Name;
+    std::vector<Token> toks =
+        CheckLex(Source, {tok::identifier, tok::identifier, tok::semi,
+                          tok::identifier});
+    ASSERT_EQ(4u, toks.size());
+    EXPECT_EQ(Name, getSourceText(toks[0], toks[0]));
+    EXPECT_EQ(Name, getSourceText(toks[1], toks[1]));
+    EXPECT_TRUE(toks[1].hasLeadingSpace());
+    EXPECT_EQ(Name, getSourceText(toks[3], toks[3]));
+    EXPECT_TRUE(toks[3].isAtStartOfLine());
+  }
+}
+
 } // anonymous namespace
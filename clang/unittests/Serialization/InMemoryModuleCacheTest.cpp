@@ -116,4 +116,47 @@ TEST(InMemoryModuleCacheTest, finalizePCM) {
   EXPECT_TRUE(Cache.isPCMFinal("B"));
 }
 
+TEST(InMemoryModuleCacheTest, sharedFileCache) {
+  IntrusiveRefCntPtr<SharedModuleFileCache> Files(new SharedModuleFileCache);
+  sys::fs::UniqueID ID(1, 2);
+  unsigned NumReads = 0;
+  auto Read = [&]() -> ErrorOr<std::unique_ptr<MemoryBuffer>> {
+    ++NumReads;
+    return MemoryBuffer::getMemBufferCopy("data:" + std::to_string(NumReads));
+  };
+
+  // The contents are read once while a compilation uses them.
+  auto B1 = Files->getBuffer(ID, 6, 0, Read);
+  auto B2 = Files->getBuffer(ID, 6, 0, Read);
+  ASSERT_TRUE(B1 && B2);
+  EXPECT_EQ(1u, NumReads);
+  EXPECT_EQ((*B1)->getBufferStart(), (*B2)->getBufferStart());
+  EXPECT_EQ("data:1", (*B2)->getBuffer());
+  EXPECT_EQ(1u, Files->getNumBuffers());
+
+  // A file modified since is read again.
+  auto B3 = Files->getBuffer(ID, 6, 1, Read);
+  ASSERT_TRUE(B3);
+  EXPECT_EQ(2u, NumReads);
+  EXPECT_EQ("data:2", (*B3)->getBuffer());
+  EXPECT_EQ(2u, Files->getNumBuffers());
+
+  // The contents are released with their last user.
+  B1->reset();
+  EXPECT_EQ(2u, Files->getNumBuffers());
+  B2->reset();
+  EXPECT_EQ(1u, Files->getNumBuffers());
+  auto B4 = Files->getBuffer(ID, 6, 0, Read);
+  ASSERT_TRUE(B4);
+  EXPECT_EQ(3u, NumReads);
+
+  // The errors of reading the file are returned.
+  auto Failed = Files->getBuffer(sys::fs::UniqueID(3, 4), 6, 0, [] {
+    return ErrorOr<std::unique_ptr<MemoryBuffer>>(
+        std::make_error_code(std::errc::no_such_file_or_directory));
+  });
+  EXPECT_FALSE(Failed);
+  EXPECT_EQ(2u, Files->getNumBuffers());
+}
+
 } // namespace
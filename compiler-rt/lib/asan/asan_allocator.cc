@@ -143,10 +143,13 @@ struct QuarantineCallback {
     atomic_store((atomic_uint8_t*)m, CHUNK_AVAILABLE, memory_order_relaxed);
     CHECK_NE(m->alloc_tid, kInvalidTid);
     CHECK_NE(m->free_tid, kInvalidTid);
-    PoisonShadow(m->Beg(),
-                 RoundUpTo(m->UsedSize(), SHADOW_GRANULARITY),
-                 kAsanHeapLeftRedzoneMagic);
     void *p = reinterpret_cast<void *>(m->AllocBeg());
+    // The secondary allocator unmaps large chunks, which clears their shadow
+    // (see AsanMapUnmapCallback::OnUnmap), so only poison the primary ones.
+    if (get_allocator().FromPrimary(p))
+      PoisonShadow(m->Beg(),
+                   RoundUpTo(m->UsedSize(), SHADOW_GRANULARITY),
+                   kAsanHeapLeftRedzoneMagic);
     if (p != m) {
       uptr *alloc_magic = reinterpret_cast<uptr *>(p);
       CHECK_EQ(alloc_magic[0], kAllocBegMagic);
@@ -0,0 +1,41 @@
+//===-- int_mem.h - Helpers for the memory builtins -------------*- C -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is not part of the interface of this library.
+//
+// The memory builtins (memcpy, memmove, memset and memcmp) are only built with
+// COMPILER_RT_INCLUDE_MEM_BUILTINS, for freestanding targets whose C library
+// does not provide fast ones.  They work a word at a time.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef INT_MEM_H
+#define INT_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The words the destination is accessed with, once it is aligned.  The source
+// is accessed with the unaligned type, as it may not be aligned too: targets
+// that allow misaligned loads do them at once, others a byte at a time.
+typedef uintptr_t mem_word __attribute__((__may_alias__));
+typedef uintptr_t mem_unaligned_word
+    __attribute__((__may_alias__, __aligned__(1)));
+
+#define MEM_WORD_SIZE sizeof(mem_word)
+#define MEM_WORD_MASK (MEM_WORD_SIZE - 1)
+
+static inline mem_word mem_load(const unsigned char *p) {
+  return *(const mem_unaligned_word *)p;
+}
+
+static inline void mem_store(unsigned char *p, mem_word w) {
+  *(mem_word *)p = w;
+}
+
+#endif // INT_MEM_H
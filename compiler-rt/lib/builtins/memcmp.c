@@ -0,0 +1,31 @@
+//===-- memcmp.c - Implement memcmp ---------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements memcmp for the compiler_rt library.
+//
+//===----------------------------------------------------------------------===//
+
+#include "int_mem.h"
+
+// Returns: < 0, 0 or > 0 as the first n bytes of a compare less than, equal
+// to or greater than those of b, as unsigned chars.
+
+int memcmp(const void *a, const void *b, size_t n) {
+  const unsigned char *x = (const unsigned char *)a;
+  const unsigned char *y = (const unsigned char *)b;
+  // Skip the equal words; the bytes of the first different word, if any, are
+  // compared below.
+  for (; n >= MEM_WORD_SIZE && mem_load(x) == mem_load(y);
+       n -= MEM_WORD_SIZE, x += MEM_WORD_SIZE, y += MEM_WORD_SIZE)
+    ;
+  for (; n; n--, x++, y++) {
+    if (*x != *y)
+      return *x - *y;
+  }
+  return 0;
+}
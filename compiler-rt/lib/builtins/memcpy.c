@@ -0,0 +1,45 @@
+//===-- memcpy.c - Implement memcpy ---------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements memcpy for the compiler_rt library.
+//
+//===----------------------------------------------------------------------===//
+
+#include "int_mem.h"
+
+// Copies n bytes from src to dest, which do not overlap.
+
+void *memcpy(void *dest, const void *src, size_t n) {
+  unsigned char *d = (unsigned char *)dest;
+  const unsigned char *s = (const unsigned char *)src;
+  // Below a word, or until the destination is aligned, copy bytes.
+  if (n >= MEM_WORD_SIZE) {
+    for (; (uintptr_t)d & MEM_WORD_MASK; n--)
+      *d++ = *s++;
+    // Then four words at a time, loading them all before storing them, which
+    // lets the compiler use load and store pair instructions.
+    for (; n >= 4 * MEM_WORD_SIZE;
+         n -= 4 * MEM_WORD_SIZE, d += 4 * MEM_WORD_SIZE,
+         s += 4 * MEM_WORD_SIZE) {
+      mem_word w0 = mem_load(s);
+      mem_word w1 = mem_load(s + MEM_WORD_SIZE);
+      mem_word w2 = mem_load(s + 2 * MEM_WORD_SIZE);
+      mem_word w3 = mem_load(s + 3 * MEM_WORD_SIZE);
+      mem_store(d, w0);
+      mem_store(d + MEM_WORD_SIZE, w1);
+      mem_store(d + 2 * MEM_WORD_SIZE, w2);
+      mem_store(d + 3 * MEM_WORD_SIZE, w3);
+    }
+    for (; n >= MEM_WORD_SIZE;
+         n -= MEM_WORD_SIZE, d += MEM_WORD_SIZE, s += MEM_WORD_SIZE)
+      mem_store(d, mem_load(s));
+  }
+  for (; n; n--)
+    *d++ = *s++;
+  return dest;
+}
@@ -0,0 +1,51 @@
+//===-- memmove.c - Implement memmove -------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements memmove for the compiler_rt library.
+//
+//===----------------------------------------------------------------------===//
+
+#include "int_mem.h"
+
+// Copies n bytes from src to dest, which may overlap.
+
+void *memmove(void *dest, const void *src, size_t n) {
+  unsigned char *d = (unsigned char *)dest;
+  const unsigned char *s = (const unsigned char *)src;
+  if (d == s || !n)
+    return dest;
+  // Copy forwards unless dest starts inside src, a word at a time unless they
+  // are less than a word apart.  Each word is loaded before it is stored, so
+  // it does not matter that the words overlap.
+  if ((uintptr_t)d - (uintptr_t)s >= n) {
+    if (n >= MEM_WORD_SIZE && (uintptr_t)s - (uintptr_t)d >= MEM_WORD_SIZE) {
+      for (; (uintptr_t)d & MEM_WORD_MASK; n--)
+        *d++ = *s++;
+      for (; n >= MEM_WORD_SIZE;
+           n -= MEM_WORD_SIZE, d += MEM_WORD_SIZE, s += MEM_WORD_SIZE)
+        mem_store(d, mem_load(s));
+    }
+    for (; n; n--)
+      *d++ = *s++;
+  } else {
+    d += n;
+    s += n;
+    if (n >= MEM_WORD_SIZE && (uintptr_t)d - (uintptr_t)s >= MEM_WORD_SIZE) {
+      for (; (uintptr_t)d & MEM_WORD_MASK; n--)
+        *--d = *--s;
+      for (; n >= MEM_WORD_SIZE; n -= MEM_WORD_SIZE) {
+        d -= MEM_WORD_SIZE;
+        s -= MEM_WORD_SIZE;
+        mem_store(d, mem_load(s));
+      }
+    }
+    for (; n; n--)
+      *--d = *--s;
+  }
+  return dest;
+}
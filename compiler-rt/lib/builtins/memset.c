@@ -0,0 +1,37 @@
+//===-- memset.c - Implement memset ---------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements memset for the compiler_rt library.
+//
+//===----------------------------------------------------------------------===//
+
+#include "int_mem.h"
+
+// Sets n bytes at dest to (unsigned char)c.
+
+void *memset(void *dest, int c, size_t n) {
+  unsigned char *d = (unsigned char *)dest;
+  if (n >= MEM_WORD_SIZE) {
+    // The byte, repeated in every byte of a word.
+    mem_word w = (unsigned char)c * (~(mem_word)0 / 0xFF);
+    for (; (uintptr_t)d & MEM_WORD_MASK; n--)
+      *d++ = (unsigned char)c;
+    for (; n >= 4 * MEM_WORD_SIZE;
+         n -= 4 * MEM_WORD_SIZE, d += 4 * MEM_WORD_SIZE) {
+      mem_store(d, w);
+      mem_store(d + MEM_WORD_SIZE, w);
+      mem_store(d + 2 * MEM_WORD_SIZE, w);
+      mem_store(d + 3 * MEM_WORD_SIZE, w);
+    }
+    for (; n >= MEM_WORD_SIZE; n -= MEM_WORD_SIZE, d += MEM_WORD_SIZE)
+      mem_store(d, w);
+  }
+  for (; n; n--)
+    *d++ = (unsigned char)c;
+  return dest;
+}
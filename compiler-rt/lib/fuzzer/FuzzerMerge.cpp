@@ -19,6 +19,7 @@
 #include <iterator>
 #include <set>
 #include <sstream>
+#include <thread>
 
 namespace fuzzer {
 
@@ -273,19 +274,13 @@ static void WriteNewControlFile(const std::string &CFPath,
   }
 }
 
-// Outer process. Does not call the target code and thus should not fail.
-void CrashResistantMerge(const Vector<std::string> &Args,
-                         const Vector<SizedFile> &OldCorpus,
-                         const Vector<SizedFile> &NewCorpus,
-                         Vector<std::string> *NewFiles,
-                         const Set<uint32_t> &InitialFeatures,
-                         Set<uint32_t> *NewFeatures,
-                         const Set<uint32_t> &InitialCov,
-                         Set<uint32_t> *NewCov,
-                         const std::string &CFPath,
-                         bool V /*Verbose*/) {
-  if (NewCorpus.empty() && OldCorpus.empty()) return;  // Nothing to merge.
-  size_t NumAttempts = 0;
+// Makes the control file at CFPath ready for the inner process, and returns
+// how many times we may have to launch it: once per input left to process.
+// The merge of a valid control file is resumed; otherwise a fresh one is
+// written for the given corpora. Returns 0 if the merge is complete already.
+static size_t PrepareControlFile(const std::string &CFPath,
+                                 const Vector<SizedFile> &OldCorpus,
+                                 const Vector<SizedFile> &NewCorpus, bool V) {
   if (FileSize(CFPath)) {
     VPrintf(V, "MERGE-OUTER: non-empty control file provided: '%s'\n",
            CFPath.c_str());
@@ -299,32 +294,45 @@ void CrashResistantMerge(const Vector<std::string> &Args,
         VPrintf(V, "MERGE-OUTER: '%s' will be skipped as unlucky "
                "(merge has stumbled on it the last time)\n",
                M.LastFailure.c_str());
-      if (M.FirstNotProcessedFile >= M.Files.size()) {
-        VPrintf(
-            V, "MERGE-OUTER: nothing to do, merge has been completed before\n");
-        exit(0);
-      }
-
-      NumAttempts = M.Files.size() - M.FirstNotProcessedFile;
-    } else {
-      VPrintf(V, "MERGE-OUTER: bad control file, will overwrite it\n");
+      return M.Files.size() - std::min(M.FirstNotProcessedFile,
+                                       M.Files.size());
     }
+    VPrintf(V, "MERGE-OUTER: bad control file, will overwrite it\n");
   }
 
-  if (!NumAttempts) {
-    // The supplied control file is empty or bad, create a fresh one.
-    NumAttempts = OldCorpus.size() + NewCorpus.size();
-    VPrintf(V, "MERGE-OUTER: %zd files, %zd in the initial corpus\n",
-            NumAttempts, OldCorpus.size());
-    WriteNewControlFile(CFPath, OldCorpus, NewCorpus);
+  // The supplied control file is empty or bad, create a fresh one.
+  VPrintf(V, "MERGE-OUTER: %zd files, %zd in the initial corpus\n",
+          OldCorpus.size() + NewCorpus.size(), OldCorpus.size());
+  WriteNewControlFile(CFPath, OldCorpus, NewCorpus);
+  return OldCorpus.size() + NewCorpus.size();
+}
+
+// An inner process only records the features and the coverage an input adds
+// to the inputs it has run before it, which depends on where it started: at
+// the start of its shard, or after the input that an earlier one crashed on.
+// Dropping the ones an input shares with any input before it leaves the same
+// ones in every case, so that the merge comes out the same too.
+static void DropFeaturesOfEarlierFiles(Merger *M) {
+  Set<uint32_t> SeenFeatures, SeenCov;
+  Vector<uint32_t> Tmp;
+  for (auto &File : M->Files) {
+    Tmp.clear();
+    for (auto Fe : File.Features)
+      if (SeenFeatures.insert(Fe).second)
+        Tmp.push_back(Fe);
+    File.Features.swap(Tmp);
+    Tmp.clear();
+    for (auto Cov : File.Cov)
+      if (SeenCov.insert(Cov).second)
+        Tmp.push_back(Cov);
+    File.Cov.swap(Tmp);
   }
+}
 
-  // Execute the inner process until it passes.
-  // Every inner process should execute at least one input.
-  Command BaseCmd(Args);
-  BaseCmd.removeFlag("merge");
-  BaseCmd.removeFlag("fork");
-  BaseCmd.removeFlag("collect_data_flow");
+// Executes the inner process until it passes.
+// Every inner process should execute at least one input.
+static void ExecuteInnerMerge(const Command &BaseCmd, const std::string &CFPath,
+                              size_t NumAttempts, bool V) {
   for (size_t Attempt = 1; Attempt <= NumAttempts; Attempt++) {
     Fuzzer::MaybeExitGracefully();
     VPrintf(V, "MERGE-OUTER: attempt %zd\n", Attempt);
@@ -341,15 +349,108 @@ void CrashResistantMerge(const Vector<std::string> &Args,
       break;
     }
   }
-  // Read the control file and do the merge.
+}
+
+// Runs the inner processes of NumShards shards of the inputs at once. Shard
+// number S gets the inputs S, S + NumShards, etc. of the merge, in order, and
+// its own control file, CFPath with ".S" appended. M gets the inputs back in
+// the order of the merge, with what their shard recorded for them.
+static void ParallelInnerMerge(const Command &BaseCmd,
+                               const Vector<SizedFile> &OldCorpus,
+                               const Vector<SizedFile> &NewCorpus,
+                               const std::string &CFPath, size_t NumShards,
+                               bool V, Merger *M) {
+  size_t NumFiles = OldCorpus.size() + NewCorpus.size();
+  Vector<Vector<SizedFile>> OldShards(NumShards), NewShards(NumShards);
+  for (size_t i = 0; i < OldCorpus.size(); i++)
+    OldShards[i % NumShards].push_back(OldCorpus[i]);
+  for (size_t i = 0; i < NewCorpus.size(); i++)
+    NewShards[(OldCorpus.size() + i) % NumShards].push_back(NewCorpus[i]);
+
+  VPrintf(V, "MERGE-OUTER: %zd files, %zd in the initial corpus, "
+          "in %zd shards\n", NumFiles, OldCorpus.size(), NumShards);
+  Vector<std::string> ShardPaths(NumShards);
+  Vector<std::thread> Threads;
+  for (size_t S = 0; S < NumShards; S++) {
+    ShardPaths[S] = CFPath + "." + std::to_string(S);
+    size_t NumAttempts = PrepareControlFile(ShardPaths[S], OldShards[S],
+                                            NewShards[S], /*V=*/false);
+    // The inner processes of the shards would all write to our output.
+    Threads.push_back(std::thread(ExecuteInnerMerge, std::cref(BaseCmd),
+                                  std::cref(ShardPaths[S]), NumAttempts,
+                                  false));
+  }
+  for (auto &T : Threads)
+    T.join();
+
+  Vector<Merger> Shards(NumShards);
+  for (size_t S = 0; S < NumShards; S++) {
+    std::ifstream IF(ShardPaths[S]);
+    Shards[S].ParseOrExit(IF, true);
+    if (Shards[S].Files.size() != OldShards[S].size() + NewShards[S].size()) {
+      Printf("MERGE-OUTER: control file '%s' is for other inputs\n",
+             ShardPaths[S].c_str());
+      exit(1);
+    }
+    if (!Shards[S].LastFailure.empty())
+      VPrintf(V, "MERGE-OUTER: '%s' caused a failure\n",
+              Shards[S].LastFailure.c_str());
+  }
+
+  M->Files.resize(NumFiles);
+  M->NumFilesInFirstCorpus = OldCorpus.size();
+  for (size_t i = 0; i < NumFiles; i++)
+    M->Files[i] = std::move(Shards[i % NumShards].Files[i / NumShards]);
+
+  // The shard control files are only needed to resume an interrupted merge.
+  for (auto &Path : ShardPaths)
+    RemoveFile(Path);
+}
+
+// Outer process. Does not call the target code and thus should not fail.
+void CrashResistantMerge(const Vector<std::string> &Args,
+                         const Vector<SizedFile> &OldCorpus,
+                         const Vector<SizedFile> &NewCorpus,
+                         Vector<std::string> *NewFiles,
+                         const Set<uint32_t> &InitialFeatures,
+                         Set<uint32_t> *NewFeatures,
+                         const Set<uint32_t> &InitialCov,
+                         Set<uint32_t> *NewCov,
+                         const std::string &CFPath,
+                         bool V /*Verbose*/,
+                         size_t NumWorkers) {
+  if (NewCorpus.empty() && OldCorpus.empty()) return;  // Nothing to merge.
+  Command BaseCmd(Args);
+  BaseCmd.removeFlag("merge");
+  BaseCmd.removeFlag("merge_workers");
+  BaseCmd.removeFlag("fork");
+  BaseCmd.removeFlag("collect_data_flow");
+
   Merger M;
-  std::ifstream IF(CFPath);
-  IF.seekg(0, IF.end);
-  VPrintf(V, "MERGE-OUTER: the control file has %zd bytes\n",
-          (size_t)IF.tellg());
-  IF.seekg(0, IF.beg);
-  M.ParseOrExit(IF, true);
-  IF.close();
+  size_t NumShards =
+      std::min(NumWorkers, OldCorpus.size() + NewCorpus.size());
+  if (NumShards > 1) {
+    ParallelInnerMerge(BaseCmd, OldCorpus, NewCorpus, CFPath, NumShards, V,
+                       &M);
+  } else {
+    size_t NumAttempts = PrepareControlFile(CFPath, OldCorpus, NewCorpus, V);
+    if (!NumAttempts) {
+      VPrintf(
+          V, "MERGE-OUTER: nothing to do, merge has been completed before\n");
+      exit(0);
+    }
+    ExecuteInnerMerge(BaseCmd, CFPath, NumAttempts, V);
+
+    // Read the control file and do the merge.
+    std::ifstream IF(CFPath);
+    IF.seekg(0, IF.end);
+    VPrintf(V, "MERGE-OUTER: the control file has %zd bytes\n",
+            (size_t)IF.tellg());
+    IF.seekg(0, IF.beg);
+    M.ParseOrExit(IF, true);
+    IF.close();
+  }
+  DropFeaturesOfEarlierFiles(&M);
   VPrintf(V,
           "MERGE-OUTER: consumed %zdMb (%zdMb rss) to parse the control file\n",
           M.ApproximateMemoryConsumption() >> 20, GetPeakRSSMb());
@@ -34,6 +34,12 @@
 //   It uses a single pass greedy algorithm choosing first the smallest inputs
 //   within the same size the inputs that have more new features.
 //
+//   With several workers, the outer process splits the inputs into shards,
+//   each with its own control file, and runs their inner processes at once.
+//   Before the merge, it drops the features each input shares with the inputs
+//   before it in other shards, which leaves what a single inner process would
+//   have recorded: the result is the same.
+//
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_FUZZER_MERGE_H
@@ -79,7 +85,8 @@ void CrashResistantMerge(const Vector<std::string> &Args,
                          const Set<uint32_t> &InitialCov,
                          Set<uint32_t> *NewCov,
                          const std::string &CFPath,
-                         bool Verbose);
+                         bool Verbose,
+                         size_t NumWorkers);
 
 }  // namespace fuzzer
 
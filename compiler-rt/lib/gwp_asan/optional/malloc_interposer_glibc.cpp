@@ -0,0 +1,140 @@
+//===-- malloc_interposer_glibc.cpp -----------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Puts GWP-ASan in front of the glibc allocator without relinking, for
+// programs that LD_PRELOAD libclang_rt.gwp_asan_malloc. Sampled allocations
+// come from the guarded pool, and everything else, including any aligned
+// allocation, goes on to glibc through its __libc_* entry points.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gwp_asan/guarded_pool_allocator.h"
+#include "gwp_asan/optional/backtrace.h"
+#include "gwp_asan/optional/options_parser.h"
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+
+#define GWP_ASAN_INTERFACE extern "C" __attribute__((visibility("default")))
+
+extern "C" {
+void *__libc_malloc(size_t Size);
+void __libc_free(void *Ptr);
+void *__libc_calloc(size_t NMemB, size_t Size);
+void *__libc_realloc(void *Ptr, size_t Size);
+void *__libc_memalign(size_t Alignment, size_t Size);
+void *__libc_valloc(size_t Size);
+void *__libc_pvalloc(size_t Size);
+}
+
+namespace {
+gwp_asan::GuardedPoolAllocator GuardedAlloc;
+
+void disableAllocator() { GuardedAlloc.disable(); }
+void enableAllocator() { GuardedAlloc.enable(); }
+
+// Allocations made before this runs, by the loader and by the initialisers of
+// the objects loaded ahead of us, never sample, as the allocator starts off
+// disabled.
+__attribute__((constructor)) void initGwpAsanMalloc() {
+  gwp_asan::options::initOptions();
+  gwp_asan::options::Options &Opts = gwp_asan::options::getOptions();
+  Opts.Backtrace = gwp_asan::options::getBacktraceFunction();
+  Opts.PrintBacktrace = gwp_asan::options::getPrintBacktraceFunction();
+  GuardedAlloc.init(Opts);
+  // Keep the pool consistent in the child of a fork() from another thread.
+  pthread_atfork(disableAllocator, enableAllocator, enableAllocator);
+}
+
+bool isPowerOfTwo(size_t X) { return X != 0 && (X & (X - 1)) == 0; }
+} // anonymous namespace
+
+GWP_ASAN_INTERFACE void *malloc(size_t Size) {
+  if (GWP_ASAN_UNLIKELY(GuardedAlloc.shouldSample())) {
+    if (void *Ptr = GuardedAlloc.allocate(Size))
+      return Ptr;
+  }
+  return __libc_malloc(Size);
+}
+
+GWP_ASAN_INTERFACE void free(void *Ptr) {
+  if (GWP_ASAN_UNLIKELY(GuardedAlloc.pointerIsMine(Ptr))) {
+    GuardedAlloc.deallocate(Ptr);
+    return;
+  }
+  __libc_free(Ptr);
+}
+
+GWP_ASAN_INTERFACE void cfree(void *Ptr) { free(Ptr); }
+
+GWP_ASAN_INTERFACE void *calloc(size_t NMemB, size_t Size) {
+  if (GWP_ASAN_UNLIKELY(GuardedAlloc.shouldSample())) {
+    size_t Bytes;
+    // Guarded slots are freshly mapped on every deallocation, so they come
+    // back zeroed.
+    if (!__builtin_mul_overflow(NMemB, Size, &Bytes))
+      if (void *Ptr = GuardedAlloc.allocate(Bytes))
+        return Ptr;
+  }
+  return __libc_calloc(NMemB, Size);
+}
+
+GWP_ASAN_INTERFACE void *realloc(void *Ptr, size_t Size) {
+  if (GWP_ASAN_UNLIKELY(GuardedAlloc.pointerIsMine(Ptr))) {
+    if (Size == 0) {
+      GuardedAlloc.deallocate(Ptr);
+      return nullptr;
+    }
+    size_t OldSize = GuardedAlloc.getSize(Ptr);
+    void *NewPtr = malloc(Size);
+    if (NewPtr) {
+      memcpy(NewPtr, Ptr, OldSize < Size ? OldSize : Size);
+      GuardedAlloc.deallocate(Ptr);
+    }
+    return NewPtr;
+  }
+  return __libc_realloc(Ptr, Size);
+}
+
+GWP_ASAN_INTERFACE void *memalign(size_t Alignment, size_t Size) {
+  return __libc_memalign(Alignment, Size);
+}
+
+GWP_ASAN_INTERFACE void *aligned_alloc(size_t Alignment, size_t Size) {
+  return __libc_memalign(Alignment, Size);
+}
+
+GWP_ASAN_INTERFACE int posix_memalign(void **MemPtr, size_t Alignment,
+                                      size_t Size) {
+  if (!isPowerOfTwo(Alignment) || Alignment % sizeof(void *) != 0)
+    return EINVAL;
+  void *Ptr = __libc_memalign(Alignment, Size);
+  if (!Ptr)
+    return ENOMEM;
+  *MemPtr = Ptr;
+  return 0;
+}
+
+GWP_ASAN_INTERFACE void *valloc(size_t Size) { return __libc_valloc(Size); }
+
+GWP_ASAN_INTERFACE void *pvalloc(size_t Size) { return __libc_pvalloc(Size); }
+
+GWP_ASAN_INTERFACE size_t malloc_usable_size(void *Ptr) {
+  if (GWP_ASAN_UNLIKELY(GuardedAlloc.pointerIsMine(Ptr)))
+    return GuardedAlloc.getSize(Ptr);
+  // glibc has no __libc_ name for this one.
+  typedef size_t (*MallocUsableSize_t)(void *);
+  static MallocUsableSize_t LibcMallocUsableSize = nullptr;
+  if (!LibcMallocUsableSize)
+    LibcMallocUsableSize = reinterpret_cast<MallocUsableSize_t>(
+        dlsym(RTLD_NEXT, "malloc_usable_size"));
+  return LibcMallocUsableSize ? LibcMallocUsableSize(Ptr) : 0;
+}
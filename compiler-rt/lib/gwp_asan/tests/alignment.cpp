@@ -0,0 +1,70 @@
+//===-- alignment.cpp -------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "gwp_asan/tests/harness.h"
+
+#include <stdint.h>
+
+// Allocations go either at the start of their page, or right up against the
+// guard page after it, rounded so that the pointer keeps the alignment that
+// malloc() promises for its size.
+static size_t expectedRightAlignedSize(size_t Size) {
+  if (Size == 3)
+    return 4;
+  if (Size > 4 && Size <= 8)
+    return 8;
+  if (Size > 8 && (Size % 16) != 0)
+    return Size + 16 - (Size % 16);
+  return Size;
+}
+
+TEST_F(CustomGuardedPoolAllocator, AllocationsAreLeftOrRightAligned) {
+  InitNumSlots(1);
+  const uintptr_t PageSize = GPA.maximumAllocationSize();
+  for (size_t Size = 1; Size <= 256; ++Size) {
+    // The choice of side is random, so try each size enough times to see
+    // both with overwhelming probability.
+    bool SawLeft = false, SawRight = false;
+    for (unsigned i = 0; i < 64 && !(SawLeft && SawRight); ++i) {
+      uintptr_t Ptr = reinterpret_cast<uintptr_t>(GPA.allocate(Size));
+      ASSERT_NE(0u, Ptr);
+      if (Ptr % PageSize == 0) {
+        SawLeft = true;
+      } else {
+        SawRight = true;
+        EXPECT_EQ(0u, (Ptr + expectedRightAlignedSize(Size)) % PageSize);
+      }
+      GPA.deallocate(reinterpret_cast<void *>(Ptr));
+    }
+    EXPECT_TRUE(SawLeft);
+    EXPECT_TRUE(SawRight);
+  }
+}
+
+TEST(GuardedPoolAllocator, PerfectlyRightAlign) {
+  gwp_asan::GuardedPoolAllocator GPA;
+  gwp_asan::options::Options Opts;
+  Opts.setDefaults();
+  Opts.MaxSimultaneousAllocations = 1;
+  Opts.PerfectlyRightAlign = true;
+  Opts.Printf = gwp_asan::test::printfToStderr;
+  GPA.init(Opts);
+
+  const uintptr_t PageSize = GPA.maximumAllocationSize();
+  for (size_t Size = 1; Size <= 64; ++Size) {
+    for (unsigned i = 0; i < 8; ++i) {
+      uintptr_t Ptr = reinterpret_cast<uintptr_t>(GPA.allocate(Size));
+      ASSERT_NE(0u, Ptr);
+      if (Ptr % PageSize != 0) {
+        EXPECT_EQ(0u, (Ptr + Size) % PageSize);
+      }
+      GPA.deallocate(reinterpret_cast<void *>(Ptr));
+    }
+  }
+  GPA.uninitTestOnly();
+}
@@ -0,0 +1,49 @@
+//===-- backtrace.cpp -------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "gwp_asan/tests/harness.h"
+
+TEST_F(BacktraceGuardedPoolAllocator, DoubleFree) {
+  void *Ptr = GPA.allocate(1);
+  GPA.deallocate(Ptr);
+
+  std::string DeathRegex = "Double free.*";
+  DeathRegex.append("was deallocated.*");
+  DeathRegex.append("was allocated.*");
+  ASSERT_DEATH(GPA.deallocate(Ptr), DeathRegex);
+}
+
+TEST_F(BacktraceGuardedPoolAllocator, InvalidFree) {
+  char *Ptr = reinterpret_cast<char *>(GPA.allocate(16));
+  ASSERT_DEATH(GPA.deallocate(Ptr + 1), "Invalid \\(wild\\) free.*");
+}
+
+TEST_F(BacktraceGuardedPoolAllocator, UseAfterFree) {
+  char *Ptr = reinterpret_cast<char *>(GPA.allocate(1));
+  GPA.deallocate(Ptr);
+
+  std::string DeathRegex = "Use after free.*";
+  DeathRegex.append("was deallocated.*");
+  DeathRegex.append("was allocated.*");
+  ASSERT_DEATH({ *Ptr = 7; }, DeathRegex);
+}
+
+TEST_F(BacktraceGuardedPoolAllocator, BufferOverflow) {
+  // Try until the allocation lands against the guard page on its right.
+  const uintptr_t PageSize = GPA.maximumAllocationSize();
+  char *Ptr;
+  while (true) {
+    Ptr = reinterpret_cast<char *>(GPA.allocate(16));
+    if (reinterpret_cast<uintptr_t>(Ptr) % PageSize != 0)
+      break;
+    GPA.deallocate(Ptr);
+  }
+
+  ASSERT_DEATH({ Ptr[16] = 7; },
+               "Buffer overflow.*to the right of a 16-byte allocation.*");
+}
@@ -0,0 +1,94 @@
+//===-- harness.h -----------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef GWP_ASAN_TESTS_HARNESS_H_
+#define GWP_ASAN_TESTS_HARNESS_H_
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "gtest/gtest.h"
+
+#include "gwp_asan/guarded_pool_allocator.h"
+#include "gwp_asan/optional/backtrace.h"
+#include "gwp_asan/options.h"
+
+namespace gwp_asan {
+namespace test {
+// The tests can use the libc's printf(), as nothing they do allocates from
+// within the signal handler.
+inline void printfToStderr(const char *Format, ...) {
+  va_list Args;
+  va_start(Args, Format);
+  vfprintf(stderr, Format, Args);
+  va_end(Args);
+}
+} // namespace test
+} // namespace gwp_asan
+
+class DefaultGuardedPoolAllocator : public ::testing::Test {
+public:
+  DefaultGuardedPoolAllocator() {
+    gwp_asan::options::Options Opts;
+    Opts.setDefaults();
+    MaxSimultaneousAllocations = Opts.MaxSimultaneousAllocations;
+
+    Opts.Printf = gwp_asan::test::printfToStderr;
+    GPA.init(Opts);
+  }
+
+  ~DefaultGuardedPoolAllocator() { GPA.uninitTestOnly(); }
+
+protected:
+  gwp_asan::GuardedPoolAllocator GPA;
+  decltype(gwp_asan::options::Options::MaxSimultaneousAllocations)
+      MaxSimultaneousAllocations;
+};
+
+class CustomGuardedPoolAllocator : public ::testing::Test {
+public:
+  void
+  InitNumSlots(decltype(gwp_asan::options::Options::MaxSimultaneousAllocations)
+                   MaxSimultaneousAllocationsArg) {
+    gwp_asan::options::Options Opts;
+    Opts.setDefaults();
+
+    Opts.MaxSimultaneousAllocations = MaxSimultaneousAllocationsArg;
+    MaxSimultaneousAllocations = MaxSimultaneousAllocationsArg;
+
+    Opts.Printf = gwp_asan::test::printfToStderr;
+    GPA.init(Opts);
+  }
+
+  ~CustomGuardedPoolAllocator() { GPA.uninitTestOnly(); }
+
+protected:
+  gwp_asan::GuardedPoolAllocator GPA;
+  decltype(gwp_asan::options::Options::MaxSimultaneousAllocations)
+      MaxSimultaneousAllocations;
+};
+
+class BacktraceGuardedPoolAllocator : public ::testing::Test {
+public:
+  BacktraceGuardedPoolAllocator() {
+    gwp_asan::options::Options Opts;
+    Opts.setDefaults();
+
+    Opts.Printf = gwp_asan::test::printfToStderr;
+    Opts.Backtrace = gwp_asan::options::getBacktraceFunction();
+    Opts.PrintBacktrace = gwp_asan::options::getPrintBacktraceFunction();
+    GPA.init(Opts);
+  }
+
+  ~BacktraceGuardedPoolAllocator() { GPA.uninitTestOnly(); }
+
+protected:
+  gwp_asan::GuardedPoolAllocator GPA;
+};
+
+#endif // GWP_ASAN_TESTS_HARNESS_H_
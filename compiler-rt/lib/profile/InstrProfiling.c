@@ -20,6 +20,8 @@
 
 COMPILER_RT_WEAK uint64_t INSTR_PROF_RAW_VERSION_VAR = INSTR_PROF_RAW_VERSION;
 
+COMPILER_RT_VISIBILITY lprofCounterShard *lprofCounterShards = 0;
+
 COMPILER_RT_VISIBILITY uint64_t __llvm_profile_get_magic(void) {
   return sizeof(void *) == sizeof(uint64_t) ? (INSTR_PROF_RAW_MAGIC_64)
                                             : (INSTR_PROF_RAW_MAGIC_32);
@@ -51,12 +53,25 @@ COMPILER_RT_VISIBILITY uint64_t __llvm_profile_get_version(void) {
   return __llvm_profile_raw_version;
 }
 
+COMPILER_RT_VISIBILITY intptr_t lprofGetCounterBias() {
+#if COMPILER_RT_HAS_COUNTER_RELOCATION
+  if (&INSTR_PROF_PROFILE_COUNTER_BIAS_VAR)
+    return INSTR_PROF_PROFILE_COUNTER_BIAS_VAR;
+#endif
+  return 0;
+}
+
 COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
-  uint64_t *I = __llvm_profile_begin_counters();
-  uint64_t *E = __llvm_profile_end_counters();
+  const intptr_t Bias = lprofGetCounterBias();
+  uint64_t *I = (uint64_t *)((char *)__llvm_profile_begin_counters() + Bias);
+  uint64_t *E = (uint64_t *)((char *)__llvm_profile_end_counters() + Bias);
 
   memset(I, 0, sizeof(uint64_t) * (E - I));
 
+  lprofCounterShard *Shard;
+  for (Shard = lprofCounterShards; Shard; Shard = Shard->Next)
+    memset(Shard->Counters, 0, sizeof(uint64_t) * (E - I));
+
   const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
   const __llvm_profile_data *DataEnd = __llvm_profile_end_data();
   const __llvm_profile_data *DI;
@@ -83,16 +83,23 @@ typedef struct lprofFilename {
    * 2 profile data files. %1m is equivalent to %m. Also %m specifier
    * can only appear once at the end of the name pattern. */
   unsigned MergePoolSize;
+  /* Set by the %c specifier, which asks for the counters to be kept in the
+   * profile file for the whole run instead of being written at exit. */
+  unsigned ContinuousMode;
   ProfileNameSpecifier PNS;
 } lprofFilename;
 
-COMPILER_RT_WEAK lprofFilename lprofCurFilename = {0,   0, 0, 0, {0},
-                                                   {0}, 0, 0, 0, PNS_unknown};
+COMPILER_RT_WEAK lprofFilename lprofCurFilename = {
+    0, 0, 0, 0, {0}, {0}, 0, 0, 0, 0, PNS_unknown};
 
 static int getCurFilenameLength();
 static const char *getCurFilename(char *FilenameBuf, int ForceUseBuf);
 static unsigned doMerging() { return lprofCurFilename.MergePoolSize; }
 
+/* Set once the instrumented code updates the counters in a mapping of the
+ * profile file, after which there is nothing left to write at exit. */
+static unsigned CountersMapped = 0;
+
 /* Return 1 if there is an error, otherwise return  0.  */
 static uint32_t fileWriter(ProfDataWriter *This, ProfDataIOVec *IOVecs,
                            uint32_t NumIOVecs) {
@@ -381,6 +388,8 @@ static int parseFilenamePattern(const char *FilenamePat,
                       FilenamePat);
             return -1;
           }
+      } else if (FilenamePat[I] == 'c') {
+        lprofCurFilename.ContinuousMode = 1;
       } else if (containsMergeSpecifier(FilenamePat, I)) {
         if (MergingEnabled) {
           PROF_WARN("%%m specifier can only be specified once in %s.\n",
@@ -449,7 +458,7 @@ static int getCurFilenameLength() {
     return 0;
 
   if (!(lprofCurFilename.NumPids || lprofCurFilename.NumHosts ||
-        lprofCurFilename.MergePoolSize))
+        lprofCurFilename.MergePoolSize || lprofCurFilename.ContinuousMode))
     return strlen(lprofCurFilename.FilenamePat);
 
   Len = strlen(lprofCurFilename.FilenamePat) +
@@ -473,7 +482,7 @@ static const char *getCurFilename(char *FilenameBuf, int ForceUseBuf) {
     return 0;
 
   if (!(lprofCurFilename.NumPids || lprofCurFilename.NumHosts ||
-        lprofCurFilename.MergePoolSize)) {
+        lprofCurFilename.MergePoolSize || lprofCurFilename.ContinuousMode)) {
     if (!ForceUseBuf)
       return lprofCurFilename.FilenamePat;
 
@@ -507,7 +516,7 @@ static const char *getCurFilename(char *FilenameBuf, int ForceUseBuf) {
         if (FilenamePat[I] != 'm')
           I++;
       }
-      /* Drop any unknown substitutions. */
+      /* Drop %c and any unknown substitutions. */
     } else
       FilenameBuf[J++] = FilenamePat[I];
   FilenameBuf[J] = 0;
@@ -578,6 +587,132 @@ const char *__llvm_profile_get_filename(void) {
   return FilenameBuf;
 }
 
+/* Return 1 if \p File, of \p FileSize bytes, already holds a profile of this
+ * module into which the counters can be mapped, and 0 otherwise. */
+static int isCompatibleProfileFile(FILE *File, uint64_t FileSize) {
+  char *ProfileBuffer;
+  int Compatible;
+
+  if (FileSize < sizeof(__llvm_profile_header))
+    return 0;
+  ProfileBuffer =
+      mmap(NULL, FileSize, PROT_READ, MAP_SHARED | MAP_FILE, fileno(File), 0);
+  if (ProfileBuffer == MAP_FAILED)
+    return 0;
+  Compatible = !__llvm_profile_check_compatibility(ProfileBuffer, FileSize);
+  (void)munmap(ProfileBuffer, FileSize);
+  return Compatible;
+}
+
+/* Move the counters into a shared mapping of the profile file, so that every
+ * update lands in the file as it happens and survives the process getting
+ * killed. The instrumented code reaches them through the counter bias, so it
+ * must be built with -mllvm -runtime-counter-relocation.
+ *
+ * Without merging, the profile is appended to the file and only this process
+ * maps it. With %m, processes of the same module share a single profile whose
+ * counters they all map: the first one in writes it, the next ones only add
+ * in whatever their counters got before this point. Value profiles are not
+ * supported in this mode, and are dropped. */
+static void initializeProfileForContinuousMode(void) {
+#if COMPILER_RT_HAS_COUNTER_RELOCATION
+  const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
+  const __llvm_profile_data *DataEnd = __llvm_profile_end_data();
+  uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  uint64_t *CountersEnd = __llvm_profile_end_counters();
+  /* Match the layout written by lprofWriteDataImpl(). */
+  const uint64_t CountersOffset =
+      sizeof(__llvm_profile_header) +
+      __llvm_profile_get_data_size(DataBegin, DataEnd) *
+          sizeof(__llvm_profile_data);
+  const uint64_t NumCounters = CountersEnd - CountersBegin;
+  const uint64_t PageSize = getpagesize();
+  uint64_t FileSize, ProfileOffset, MapOffset, MapSize, I;
+  int Length, ReuseProfile = 0;
+  const char *Filename;
+  char *FilenameBuf, *Profile;
+  uint64_t *FileCounters;
+  FILE *File;
+
+  if (!&INSTR_PROF_PROFILE_COUNTER_BIAS_VAR) {
+    PROF_WARN("Continuous mode is disabled, counters are written at exit: "
+              "%s\n",
+              "the code was not built with -mllvm -runtime-counter-relocation");
+    return;
+  }
+  if (!NumCounters)
+    return;
+
+  Length = getCurFilenameLength();
+  FilenameBuf = (char *)COMPILER_RT_ALLOCA(Length + 1);
+  Filename = getCurFilename(FilenameBuf, 0);
+  if (!Filename)
+    return;
+
+  createProfileDir(Filename);
+  if (doMerging()) {
+    /* The lock taken here is held until the counters of this process are
+     * added into the file, and released by fclose(). */
+    File = lprofOpenFileEx(Filename);
+    if (!File || fseek(File, 0L, SEEK_END) == -1)
+      goto Error;
+    FileSize = ftell(File);
+    ReuseProfile = isCompatibleProfileFile(File, FileSize);
+    if (!ReuseProfile && FileSize)
+      PROF_WARN("Unable to merge profile data: %s\n",
+                "source profile file is not compatible.");
+    if (!ReuseProfile && COMPILER_RT_FTRUNCATE(File, 0L))
+      goto Error;
+    ProfileOffset = 0;
+  } else {
+    File = fopen(Filename, "a+b");
+    if (!File || fseek(File, 0L, SEEK_END) == -1)
+      goto Error;
+    ProfileOffset = ftell(File);
+  }
+
+  if (!ReuseProfile) {
+    ProfDataWriter FileWriter;
+    initFileWriter(&FileWriter, File);
+    if (fseek(File, ProfileOffset, SEEK_SET) == -1 ||
+        lprofWriteData(&FileWriter, 0, 0) || fflush(File))
+      goto Error;
+  }
+
+  /* Profiles appended after those of other modules need not start on a page
+   * boundary, unlike the mapping. */
+  MapOffset = ProfileOffset & ~(PageSize - 1);
+  MapSize = ProfileOffset - MapOffset + CountersOffset +
+            NumCounters * sizeof(uint64_t);
+  Profile = mmap(NULL, MapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FILE,
+                 fileno(File), MapOffset);
+  if (Profile == MAP_FAILED)
+    goto Error;
+  FileCounters =
+      (uint64_t *)(Profile + (ProfileOffset - MapOffset) + CountersOffset);
+
+  /* A freshly written profile already has the counters of this process. */
+  if (ReuseProfile)
+    for (I = 0; I < NumCounters; I++)
+      FileCounters[I] += CountersBegin[I];
+
+  INSTR_PROF_PROFILE_COUNTER_BIAS_VAR =
+      (intptr_t)FileCounters - (intptr_t)CountersBegin;
+  CountersMapped = 1;
+  fclose(File);
+  return;
+
+Error:
+  PROF_ERR("Continuous mode is disabled, failed to map \"%s\": %s\n",
+           Filename, strerror(errno));
+  if (File)
+    fclose(File);
+#else
+  PROF_WARN("Continuous mode is disabled, counters are written at exit: %s\n",
+            "runtime counter relocation is not supported on this platform");
+#endif
+}
+
 /* This method is invoked by the runtime initialization hook
  * InstrProfilingRuntime.o if it is linked in. Both user specified
  * profile path via -fprofile-instr-generate= and LLVM_PROFILE_FILE
@@ -594,16 +729,19 @@ void __llvm_profile_initialize_file(void) {
     /* Pass CopyFilenamePat = 1, to ensure that the filename would be valid 
        at the  moment when __llvm_profile_write_file() gets executed. */
     parseAndSetFilename(EnvFilenamePat, PNS_environment, 1);
-    return;
-  } else if (hasCommandLineOverrider) {
-    SelectedPat = INSTR_PROF_PROFILE_NAME_VAR;
-    PNS = PNS_command_line;
   } else {
-    SelectedPat = NULL;
-    PNS = PNS_default;
+    if (hasCommandLineOverrider) {
+      SelectedPat = INSTR_PROF_PROFILE_NAME_VAR;
+      PNS = PNS_command_line;
+    } else {
+      SelectedPat = NULL;
+      PNS = PNS_default;
+    }
+    parseAndSetFilename(SelectedPat, PNS, 0);
   }
 
-  parseAndSetFilename(SelectedPat, PNS, 0);
+  if (lprofCurFilename.ContinuousMode)
+    initializeProfileForContinuousMode();
 }
 
 /* This API is directly called by the user application code. It has the
@@ -612,6 +750,12 @@ void __llvm_profile_initialize_file(void) {
  */
 COMPILER_RT_VISIBILITY
 void __llvm_profile_set_filename(const char *FilenamePat) {
+  /* The counters stay in the file they were mapped from. */
+  if (CountersMapped) {
+    PROF_WARN("Profile file name not changed to %s: continuous mode is on.\n",
+              FilenamePat ? FilenamePat : "the default");
+    return;
+  }
   parseAndSetFilename(FilenamePat, PNS_runtime_api, 1);
 }
 
@@ -626,6 +770,10 @@ int __llvm_profile_write_file(void) {
   char *FilenameBuf;
   int PDeathSig = 0;
 
+  /* The profile file is kept up to date as the counters change. */
+  if (CountersMapped)
+    return 0;
+
   if (lprofProfileDumped()) {
     PROF_NOTE("Profile data not written to file: %s.\n", 
               "already written");
@@ -668,7 +816,7 @@ int __llvm_profile_write_file(void) {
 
 COMPILER_RT_VISIBILITY
 int __llvm_profile_dump(void) {
-  if (!doMerging())
+  if (!doMerging() && !CountersMapped)
     PROF_WARN("Later invocation of __llvm_profile_dump can lead to clobbering "
               " of previously dumped profile data : %s. Either use %%m "
               "in profile name or change profile name before dumping.\n",
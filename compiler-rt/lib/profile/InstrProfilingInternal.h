@@ -177,6 +177,37 @@ uint64_t lprofGetLoadModuleSignature();
 unsigned lprofProfileDumped();
 void lprofSetProfileDumped();
 
+/* Return the bias the instrumented code adds to the address of each counter
+ * update, which is non zero only in continuous mode, once the counters have
+ * been moved into a mapping of the profile file. */
+intptr_t lprofGetCounterBias();
+
+#if COMPILER_RT_HAS_COUNTER_RELOCATION
+/* Defined (as 0) by code built with -runtime-counter-relocation. The weak
+ * reference leaves its address null when no such code is linked in. */
+COMPILER_RT_VISIBILITY COMPILER_RT_WEAK extern intptr_t
+    INSTR_PROF_PROFILE_COUNTER_BIAS_VAR; /* __llvm_profile_counter_bias */
+#endif
+
+/* A copy of the counters that one thread updates instead of the shared ones
+ * when the code is built with -sharded-counter-update. Counters[I] adds to
+ * __llvm_profile_begin_counters()[I] when the profile is written. */
+typedef struct lprofCounterShard {
+  struct lprofCounterShard *Next;
+  /* Links the shards of the threads that have exited. */
+  struct lprofCounterShard *NextFree;
+  uint64_t Counters[];
+} lprofCounterShard;
+
+/* All the shards allocated so far, most recent first. Shards are never freed,
+ * so the list can be walked without holding any lock. */
+COMPILER_RT_VISIBILITY extern lprofCounterShard *lprofCounterShards;
+
+/* Allocate a shard for the calling thread, or take over that of a thread that
+ * has exited, and return the bias from the shared counters to it. This is
+ * called by the instrumented code the first time a thread runs it. */
+COMPILER_RT_VISIBILITY intptr_t INSTR_PROF_COUNTER_SHARD_FUNC(void);
+
 COMPILER_RT_VISIBILITY extern void (*FreeHook)(void *);
 COMPILER_RT_VISIBILITY extern uint8_t *DynamicBufferIOBuffer;
 COMPILER_RT_VISIBILITY extern uint32_t VPBufferSize;
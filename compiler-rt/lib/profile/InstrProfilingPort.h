@@ -22,6 +22,7 @@
 /* Need to include <stdio.h> and <io.h> */
 #define COMPILER_RT_FTRUNCATE(f,l) _chsize(_fileno(f),l)
 #define COMPILER_RT_ALWAYS_INLINE __forceinline
+#define COMPILER_RT_THREAD_LOCAL __declspec(thread)
 #elif __GNUC__
 #define COMPILER_RT_ALIGNAS(x) __attribute__((aligned(x)))
 #define COMPILER_RT_VISIBILITY __attribute__((visibility("hidden")))
@@ -29,6 +30,7 @@
 #define COMPILER_RT_ALLOCA __builtin_alloca
 #define COMPILER_RT_FTRUNCATE(f,l) ftruncate(fileno(f),l)
 #define COMPILER_RT_ALWAYS_INLINE inline __attribute((always_inline))
+#define COMPILER_RT_THREAD_LOCAL __thread
 #endif
 
 #if defined(__APPLE__)
@@ -43,6 +45,14 @@
 #define COMPILER_RT_SECTION(Sect) __attribute__((section(Sect)))
 #endif
 
+/* Runtime counter relocation (continuous mode) needs a weak reference to the
+ * counter bias that resolves to null when nothing defines it. */
+#if defined(__ELF__)
+#define COMPILER_RT_HAS_COUNTER_RELOCATION 1
+#else
+#define COMPILER_RT_HAS_COUNTER_RELOCATION 0
+#endif
+
 #define COMPILER_RT_MAX_HOSTLEN 128
 #ifdef __ORBIS__
 #define COMPILER_RT_GETHOSTNAME(Name, Len) ((void)(Name), (void)(Len), (-1))
@@ -0,0 +1,110 @@
+/*===- InstrProfilingShards.c - Per-thread copies of the counters ---------===*\
+|*
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+|* See https://llvm.org/LICENSE.txt for license information.
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+|*
+\*===----------------------------------------------------------------------===*/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "InstrProfiling.h"
+#include "InstrProfilingInternal.h"
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#if defined(__ELF__)
+/* A program that does not link with the thread library never has an exited
+ * thread to take a shard over from, so do not make it link with it. */
+#pragma weak pthread_key_create
+#pragma weak pthread_once
+#pragma weak pthread_setspecific
+#endif
+#endif
+
+/* The bias from the shared counters to the shard of the calling thread, which
+ * the code built with -sharded-counter-update adds to every counter address.
+ * It stays zero until the thread first runs such code. */
+COMPILER_RT_VISIBILITY COMPILER_RT_THREAD_LOCAL intptr_t
+    INSTR_PROF_PROFILE_COUNTER_SHARD_VAR;
+
+/* Shards of the threads that have exited. They keep their counts, and are
+ * given to new threads so that thread churn does not grow memory use. */
+static lprofCounterShard *FreeShards = 0;
+static void *FreeShardsLock = 0;
+
+static void lockFreeShards(void) {
+  while (!COMPILER_RT_BOOL_CMPXCHG(&FreeShardsLock, 0, (void *)1))
+    ;
+}
+
+static void unlockFreeShards(void) {
+  COMPILER_RT_BOOL_CMPXCHG(&FreeShardsLock, (void *)1, 0);
+}
+
+static lprofCounterShard *takeFreeShard(void) {
+  lprofCounterShard *Shard;
+  lockFreeShards();
+  Shard = FreeShards;
+  if (Shard)
+    FreeShards = Shard->NextFree;
+  unlockFreeShards();
+  return Shard;
+}
+
+#if !defined(_WIN32)
+static pthread_key_t ShardKey;
+static pthread_once_t ShardKeyOnce = PTHREAD_ONCE_INIT;
+static int ShardKeyCreated = 0;
+
+static void releaseShard(void *Ptr) {
+  lprofCounterShard *Shard = (lprofCounterShard *)Ptr;
+  /* Any instrumented code the exiting thread still runs, say in another key
+   * destructor, asks for a shard again. */
+  INSTR_PROF_PROFILE_COUNTER_SHARD_VAR = 0;
+  lockFreeShards();
+  Shard->NextFree = FreeShards;
+  FreeShards = Shard;
+  unlockFreeShards();
+}
+
+static void createShardKey(void) {
+  ShardKeyCreated = !pthread_key_create(&ShardKey, releaseShard);
+}
+
+static void registerShard(lprofCounterShard *Shard) {
+#if defined(__ELF__)
+  if (!&pthread_key_create)
+    return;
+#endif
+  pthread_once(&ShardKeyOnce, createShardKey);
+  if (ShardKeyCreated)
+    pthread_setspecific(ShardKey, Shard);
+}
+#else
+static void registerShard(lprofCounterShard *Shard) { (void)Shard; }
+#endif
+
+COMPILER_RT_VISIBILITY intptr_t INSTR_PROF_COUNTER_SHARD_FUNC(void) {
+  const uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  const uint64_t *CountersEnd = __llvm_profile_end_counters();
+  lprofCounterShard *Shard = takeFreeShard();
+
+  if (!Shard) {
+    Shard = (lprofCounterShard *)calloc(
+        1, sizeof(lprofCounterShard) +
+               sizeof(uint64_t) * (CountersEnd - CountersBegin));
+    /* Without a shard, the thread updates the shared counters. */
+    if (!Shard)
+      return 0;
+    do
+      Shard->Next = lprofCounterShards;
+    while (!COMPILER_RT_BOOL_CMPXCHG(&lprofCounterShards, Shard->Next, Shard));
+  }
+
+  registerShard(Shard);
+  INSTR_PROF_PROFILE_COUNTER_SHARD_VAR =
+      (intptr_t)Shard->Counters - (intptr_t)CountersBegin;
+  return INSTR_PROF_PROFILE_COUNTER_SHARD_VAR;
+}
@@ -246,6 +246,38 @@ COMPILER_RT_VISIBILITY int lprofWriteData(ProfDataWriter *Writer,
                             SkipNameDataWrite);
 }
 
+/* Write the counters, adding in those of every thread's shard when the
+ * counters are the ones the shards copy. */
+static int writeCounters(ProfDataWriter *Writer, const uint64_t *CountersBegin,
+                         const uint64_t *CountersEnd) {
+  enum { ChunkSize = 512 };
+  uint64_t Sums[ChunkSize];
+  const uint64_t *Chunk;
+
+  if (!lprofCounterShards || CountersBegin != __llvm_profile_begin_counters() ||
+      CountersEnd != __llvm_profile_end_counters()) {
+    ProfDataIOVec IOVec[] = {
+        {CountersBegin, sizeof(uint64_t), CountersEnd - CountersBegin}};
+    return Writer->Write(Writer, IOVec, 1);
+  }
+
+  for (Chunk = CountersBegin; Chunk < CountersEnd; Chunk += ChunkSize) {
+    const uint64_t Offset = Chunk - CountersBegin;
+    uint64_t I, N = CountersEnd - Chunk;
+    const lprofCounterShard *Shard;
+    if (N > ChunkSize)
+      N = ChunkSize;
+    memcpy(Sums, Chunk, N * sizeof(uint64_t));
+    for (Shard = lprofCounterShards; Shard; Shard = Shard->Next)
+      for (I = 0; I < N; ++I)
+        Sums[I] += Shard->Counters[Offset + I];
+    ProfDataIOVec IOVec[] = {{Sums, sizeof(uint64_t), N}};
+    if (Writer->Write(Writer, IOVec, 1))
+      return -1;
+  }
+  return 0;
+}
+
 COMPILER_RT_VISIBILITY int
 lprofWriteDataImpl(ProfDataWriter *Writer, const __llvm_profile_data *DataBegin,
                    const __llvm_profile_data *DataEnd,
@@ -275,11 +307,18 @@ lprofWriteDataImpl(ProfDataWriter *Writer, const __llvm_profile_data *DataBegin,
   /* Write the data. */
   ProfDataIOVec IOVec[] = {
       {&Header, sizeof(__llvm_profile_header), 1},
-      {DataBegin, sizeof(__llvm_profile_data), DataSize},
-      {CountersBegin, sizeof(uint64_t), CountersSize},
+      {DataBegin, sizeof(__llvm_profile_data), DataSize}};
+  if (Writer->Write(Writer, IOVec, sizeof(IOVec) / sizeof(*IOVec)))
+    return -1;
+
+  if (writeCounters(Writer, CountersBegin, CountersEnd))
+    return -1;
+
+  ProfDataIOVec NamesIOVec[] = {
       {SkipNameDataWrite ? NULL : NamesBegin, sizeof(uint8_t), NamesSize},
       {Zeroes, sizeof(uint8_t), Padding}};
-  if (Writer->Write(Writer, IOVec, sizeof(IOVec) / sizeof(*IOVec)))
+  if (Writer->Write(Writer, NamesIOVec,
+                    sizeof(NamesIOVec) / sizeof(*NamesIOVec)))
     return -1;
 
   return writeValueProfData(Writer, VPDataReader, DataBegin, DataEnd);
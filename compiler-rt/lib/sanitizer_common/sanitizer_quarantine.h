@@ -10,6 +10,9 @@
 // Quarantine caches some specified amount of memory in per-thread caches,
 // then evicts to global FIFO queue. When the queue reaches specified threshold,
 // oldest memory is recycled.
+// Threads hand their caches off to the global queue without taking a lock: the
+// batches are pushed onto a lock-free stack, which the thread that recycles
+// moves into the queue.
 //
 //===----------------------------------------------------------------------===//
 
@@ -90,7 +93,6 @@ class Quarantine {
     atomic_store_relaxed(&min_size_, size / 10 * 9);  // 90% of max size.
     atomic_store_relaxed(&max_cache_size_, cache_size);
 
-    cache_mutex_.Init();
     recycle_mutex_.Init();
   }
 
@@ -113,27 +115,23 @@ class Quarantine {
   }
 
   void NOINLINE Drain(Cache *c, Callback cb) {
-    {
-      SpinMutexLock l(&cache_mutex_);
-      cache_.Transfer(c);
-    }
-    if (cache_.Size() > GetSize() && recycle_mutex_.TryLock())
+    HandOff(c);
+    if (cache_.Size() + atomic_load_relaxed(&handoff_size_) > GetSize() &&
+        recycle_mutex_.TryLock())
       Recycle(atomic_load_relaxed(&min_size_), cb);
   }
 
   void NOINLINE DrainAndRecycle(Cache *c, Callback cb) {
-    {
-      SpinMutexLock l(&cache_mutex_);
-      cache_.Transfer(c);
-    }
+    HandOff(c);
     recycle_mutex_.Lock();
     Recycle(0, cb);
   }
 
-  void PrintStats() const {
+  void PrintStats() {
     // It assumes that the world is stopped, just as the allocator's PrintStats.
     Printf("Quarantine limits: global: %zdMb; thread local: %zdKb\n",
            GetSize() >> 20, GetCacheSize() >> 10);
+    TakeHandOff();
     cache_.PrintStats();
   }
 
@@ -144,37 +142,81 @@ class Quarantine {
   atomic_uintptr_t min_size_;
   atomic_uintptr_t max_cache_size_;
   char pad1_[kCacheLineSize];
-  StaticSpinMutex cache_mutex_;
+  // The batches handed off by the threads, newest first, and their total size.
+  atomic_uintptr_t handoff_;
+  atomic_uintptr_t handoff_size_;
+  char pad2_[kCacheLineSize];
+  // cache_ is only accessed with recycle_mutex_ held.
   StaticSpinMutex recycle_mutex_;
   Cache cache_;
-  char pad2_[kCacheLineSize];
+  char pad3_[kCacheLineSize];
+
+  void HandOff(Cache *c) {
+    uptr size = c->Size();
+    QuarantineBatch *first = nullptr;
+    QuarantineBatch *last = nullptr;
+    while (QuarantineBatch *b = c->DequeueBatch()) {
+      b->next = first;
+      first = b;
+      if (!last)
+        last = b;
+    }
+    if (!first)
+      return;
+    atomic_fetch_add(&handoff_size_, size, memory_order_relaxed);
+    uptr head = atomic_load(&handoff_, memory_order_relaxed);
+    do {
+      last->next = reinterpret_cast<QuarantineBatch *>(head);
+    } while (!atomic_compare_exchange_weak(&handoff_, &head,
+                                           reinterpret_cast<uptr>(first),
+                                           memory_order_release));
+  }
+
+  // Moves the handed off batches into cache_, oldest first.
+  void TakeHandOff() {
+    QuarantineBatch *b = reinterpret_cast<QuarantineBatch *>(
+        atomic_exchange(&handoff_, 0, memory_order_acquire));
+    QuarantineBatch *oldest = nullptr;
+    while (b) {
+      QuarantineBatch *next = b->next;
+      b->next = oldest;
+      oldest = b;
+      b = next;
+    }
+    uptr size = 0;
+    while (oldest) {
+      QuarantineBatch *next = oldest->next;
+      size += oldest->size;
+      cache_.EnqueueBatch(oldest);
+      oldest = next;
+    }
+    atomic_fetch_sub(&handoff_size_, size, memory_order_relaxed);
+  }
 
   void NOINLINE Recycle(uptr min_size, Callback cb) {
     Cache tmp;
-    {
-      SpinMutexLock l(&cache_mutex_);
-      // Go over the batches and merge partially filled ones to
-      // save some memory, otherwise batches themselves (since the memory used
-      // by them is counted against quarantine limit) can overcome the actual
-      // user's quarantined chunks, which diminishes the purpose of the
-      // quarantine.
-      uptr cache_size = cache_.Size();
-      uptr overhead_size = cache_.OverheadSize();
-      CHECK_GE(cache_size, overhead_size);
-      // Do the merge only when overhead exceeds this predefined limit (might
-      // require some tuning). It saves us merge attempt when the batch list
-      // quarantine is unlikely to contain batches suitable for merge.
-      const uptr kOverheadThresholdPercents = 100;
-      if (cache_size > overhead_size &&
-          overhead_size * (100 + kOverheadThresholdPercents) >
-              cache_size * kOverheadThresholdPercents) {
-        cache_.MergeBatches(&tmp);
-      }
-      // Extract enough chunks from the quarantine to get below the max
-      // quarantine size and leave some leeway for the newly quarantined chunks.
-      while (cache_.Size() > min_size) {
-        tmp.EnqueueBatch(cache_.DequeueBatch());
-      }
+    TakeHandOff();
+    // Go over the batches and merge partially filled ones to
+    // save some memory, otherwise batches themselves (since the memory used
+    // by them is counted against quarantine limit) can overcome the actual
+    // user's quarantined chunks, which diminishes the purpose of the
+    // quarantine.
+    uptr cache_size = cache_.Size();
+    uptr overhead_size = cache_.OverheadSize();
+    CHECK_GE(cache_size, overhead_size);
+    // Do the merge only when overhead exceeds this predefined limit (might
+    // require some tuning). It saves us merge attempt when the batch list
+    // quarantine is unlikely to contain batches suitable for merge.
+    const uptr kOverheadThresholdPercents = 100;
+    if (cache_size > overhead_size &&
+        overhead_size * (100 + kOverheadThresholdPercents) >
+            cache_size * kOverheadThresholdPercents) {
+      cache_.MergeBatches(&tmp);
+    }
+    // Extract enough chunks from the quarantine to get below the max
+    // quarantine size and leave some leeway for the newly quarantined chunks.
+    while (cache_.Size() > min_size) {
+      tmp.EnqueueBatch(cache_.DequeueBatch());
     }
     recycle_mutex_.Unlock();
     DoRecycle(&tmp, cb);
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 #include "sanitizer_common/sanitizer_common.h"
 #include "sanitizer_common/sanitizer_quarantine.h"
+#include "sanitizer_pthread_wrappers.h"
 #include "gtest/gtest.h"
 
 #include <stdlib.h>
@@ -176,4 +177,47 @@ TEST(SanitizerCommon, QuarantineCacheMergeBatchesALotOfBatches) {
   DeallocateCache(&to_deallocate);
 }
 
+struct CountingQuarantineCallback {
+  void Recycle(void *m) { atomic_fetch_add(&recycled, 1, memory_order_relaxed); }
+  void *Allocate(uptr size) { return malloc(size); }
+  void Deallocate(void *p) { free(p); }
+
+  static atomic_uintptr_t recycled;
+};
+
+atomic_uintptr_t CountingQuarantineCallback::recycled;
+
+typedef Quarantine<CountingQuarantineCallback, void> CountingQuarantine;
+
+static CountingQuarantine quarantine(LINKER_INITIALIZED);
+static const uptr kNumHandOffThreads = 4;
+static const uptr kNumHandOffChunks = QuarantineBatch::kSize * 8;
+
+static void *QuarantineHandOffWorker(void *arg) {
+  QuarantineCache<CountingQuarantineCallback> cache;
+  CountingQuarantineCallback counting_cb;
+  for (uptr i = 0; i < kNumHandOffChunks; i++)
+    quarantine.Put(&cache, counting_cb, kFakePtr, kBlockSize);
+  quarantine.Drain(&cache, counting_cb);
+  EXPECT_EQ(0UL, cache.Size());
+  return nullptr;
+}
+
+TEST(SanitizerCommon, QuarantineHandOff) {
+  // Make the threads hand off their caches often, and recycle as they go.
+  quarantine.Init(QuarantineBatch::kSize * kBlockSize * 4,
+                  QuarantineBatch::kSize * kBlockSize);
+  pthread_t threads[kNumHandOffThreads];
+  for (uptr i = 0; i < kNumHandOffThreads; i++)
+    PTHREAD_CREATE(&threads[i], 0, QuarantineHandOffWorker, nullptr);
+  for (uptr i = 0; i < kNumHandOffThreads; i++)
+    PTHREAD_JOIN(threads[i], 0);
+
+  // Everything that is still quarantined is recycled now.
+  QuarantineCache<CountingQuarantineCallback> cache;
+  quarantine.DrainAndRecycle(&cache, CountingQuarantineCallback());
+  EXPECT_EQ(kNumHandOffThreads * kNumHandOffChunks,
+            atomic_load_relaxed(&CountingQuarantineCallback::recycled));
+}
+
 }  // namespace __sanitizer
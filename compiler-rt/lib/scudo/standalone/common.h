@@ -141,6 +141,7 @@ bool getRandom(void *Buffer, uptr Length, bool Blocking = false);
 #define MAP_ALLOWNOMEM (1U << 0)
 #define MAP_NOACCESS (1U << 1)
 #define MAP_RESIZABLE (1U << 2)
+#define MAP_MEMTAG (1U << 3)
 
 // Our platform memory mapping use is restricted to 3 scenarios:
 // - reserve memory at a random address (MAP_NOACCESS);
@@ -148,7 +149,8 @@ bool getRandom(void *Buffer, uptr Length, bool Blocking = false);
 // - commit memory at a random address.
 // As such, only a subset of parameters combinations is valid, which is checked
 // by the function implementation. The Data parameter allows to pass opaque
-// platform specific data to the function.
+// platform specific data to the function. MAP_MEMTAG requests memory that can
+// hold memory tags, and must only be used if systemSupportsMemoryTagging().
 // Returns nullptr on error or dies if MAP_ALLOWNOMEM is not specified.
 void *map(void *Addr, uptr Size, const char *Name, uptr Flags = 0,
           MapPlatformData *Data = nullptr);
@@ -0,0 +1,115 @@
+//===-- memtag.h ------------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SCUDO_MEMTAG_H_
+#define SCUDO_MEMTAG_H_
+
+#include "internal_defs.h"
+
+#if SCUDO_LINUX && SCUDO_CAN_USE_MTE
+#include <sys/auxv.h>
+#include <sys/prctl.h>
+#endif
+
+namespace scudo {
+
+// Hooks for hardware memory tagging, which the combined allocator uses to give
+// every Primary backed chunk a random tag, and to clear it on deallocation so
+// that dangling and out of bounds accesses fault. Tags live in the top byte of
+// a pointer, and apply to granules of archMemoryTagGranuleSize() bytes.
+//
+// This is currently only implemented for the AArch64 Memory Tagging Extension,
+// and has to be opted into at compile time with SCUDO_CAN_USE_MTE, as it
+// requires an assembler that knows about the extension. Everywhere else, the
+// hooks compile down to nothing.
+
+#if SCUDO_CAN_USE_MTE
+
+inline constexpr bool archSupportsMemoryTagging() { return true; }
+inline constexpr uptr archMemoryTagGranuleSize() { return 16; }
+
+inline bool systemSupportsMemoryTagging() {
+#if SCUDO_LINUX
+#ifndef HWCAP2_MTE
+#define HWCAP2_MTE (1 << 18)
+#endif
+  return getauxval(AT_HWCAP2) & HWCAP2_MTE;
+#else
+  return false;
+#endif
+}
+
+// Enables checked accesses through tagged pointers for the calling thread (and
+// the threads it creates), with synchronous tag check faults.
+inline void enableMemoryTagChecks() {
+#if SCUDO_LINUX
+#ifndef PR_SET_TAGGED_ADDR_CTRL
+#define PR_SET_TAGGED_ADDR_CTRL 55
+#endif
+#ifndef PR_TAGGED_ADDR_ENABLE
+#define PR_TAGGED_ADDR_ENABLE (1UL << 0)
+#endif
+#ifndef PR_MTE_TCF_SYNC
+#define PR_MTE_TCF_SYNC (1UL << 1)
+#endif
+#ifndef PR_MTE_TAG_SHIFT
+#define PR_MTE_TAG_SHIFT 3
+#endif
+  // Allow every tag but 0, which is the one of untagged memory.
+  prctl(PR_SET_TAGGED_ADDR_CTRL,
+        PR_TAGGED_ADDR_ENABLE | PR_MTE_TCF_SYNC | (0xfffeUL << PR_MTE_TAG_SHIFT),
+        0, 0, 0);
+#endif
+}
+
+inline uptr untagPointer(uptr Ptr) { return Ptr & ((1ULL << 56) - 1); }
+
+// Returns Ptr with a random tag, excluding the ones set in ExcludeMask.
+inline uptr selectRandomTag(uptr Ptr, uptr ExcludeMask) {
+  uptr TaggedPtr;
+  __asm__ __volatile__(".arch_extension mte; irg %[TaggedPtr], %[Ptr], %[Mask]"
+                       : [TaggedPtr] "=r"(TaggedPtr)
+                       : [Ptr] "r"(Ptr), [Mask] "r"(ExcludeMask));
+  return TaggedPtr;
+}
+
+// Sets the tag of the granules in [Begin, End) to the one of Begin. Both must
+// be granule aligned.
+inline void storeTags(uptr Begin, uptr End) {
+  for (uptr P = Begin; P < End; P += archMemoryTagGranuleSize())
+    __asm__ __volatile__(".arch_extension mte; stg %0, [%0]"
+                         :
+                         : "r"(P)
+                         : "memory");
+}
+
+#else
+
+inline constexpr bool archSupportsMemoryTagging() { return false; }
+inline constexpr uptr archMemoryTagGranuleSize() { return 16; }
+inline bool systemSupportsMemoryTagging() { return false; }
+inline void enableMemoryTagChecks() {}
+inline uptr untagPointer(uptr Ptr) { return Ptr; }
+
+inline uptr selectRandomTag(uptr, uptr) {
+  UNREACHABLE("memory tagging not supported");
+}
+
+inline void storeTags(uptr, uptr) {
+  UNREACHABLE("memory tagging not supported");
+}
+
+#endif // SCUDO_CAN_USE_MTE
+
+template <typename T> inline T *untagPointer(T *Ptr) {
+  return reinterpret_cast<T *>(untagPointer(reinterpret_cast<uptr>(Ptr)));
+}
+
+} // namespace scudo
+
+#endif // SCUDO_MEMTAG_H_
@@ -63,7 +63,10 @@ enum MutexState { MtxUnlocked = 0, MtxLocked = 1, MtxSleeping = 2 };
 class BlockingMutex {
 public:
   explicit constexpr BlockingMutex(LinkerInitialized) : OpaqueStorage{0} {}
-  BlockingMutex() { memset(this, 0, sizeof(*this)); }
+  // Constant initializable, so that a mutex living in a static allocator
+  // doesn't pull in a dynamic initializer that could run after the first
+  // allocation.
+  constexpr BlockingMutex() : OpaqueStorage{0} {}
   void wait();
   void wake();
   void lock() {
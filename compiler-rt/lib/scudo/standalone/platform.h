@@ -43,6 +43,15 @@
 #define SCUDO_CAN_USE_PRIMARY64 (SCUDO_WORDSIZE == 64U)
 #endif
 
+// Memory tagging is opt-in, see memtag.h.
+#ifndef SCUDO_CAN_USE_MTE
+#define SCUDO_CAN_USE_MTE 0
+#endif
+
+#if SCUDO_CAN_USE_MTE && !defined(__aarch64__)
+#error "Memory tagging is only supported on AArch64"
+#endif
+
 #ifndef SCUDO_MIN_ALIGNMENT_LOG
 // We force malloc-type functions to be aligned to std::max_align_t, but there
 // is no reason why the minimum alignment for all other functions can't be 8
@@ -55,6 +55,9 @@ public:
 
   static bool canAllocate(uptr Size) { return Size <= SizeClassMap::MaxSize; }
 
+  // Memory tagging is only implemented for 64-bit platforms.
+  bool useMemoryTagging() const { return false; }
+
   void initLinkerInitialized(s32 ReleaseToOsInterval) {
     if (SCUDO_FUCHSIA)
       reportError("SizeClassAllocator32 is not supported on Fuchsia");
@@ -77,6 +80,11 @@ public:
                         (getSizeByClassId(I) >= (PageSize / 32));
     }
     ReleaseToOsIntervalMs = ReleaseToOsInterval;
+    if (ReleaseToOsInterval > 0)
+      atomic_store_relaxed(&NextReleaseAtNs,
+                           getMonotonicTime() +
+                               static_cast<u64>(ReleaseToOsInterval) *
+                                   1000000ULL);
   }
   void init(s32 ReleaseToOsInterval) {
     memset(this, 0, sizeof(*this));
@@ -104,11 +112,12 @@ public:
     DCHECK_LT(ClassId, NumClasses);
     DCHECK_GT(B->getCount(), 0);
     SizeClassInfo *Sci = getSizeClassInfo(ClassId);
-    BlockingMutexLock L(&Sci->Mutex);
-    Sci->FreeList.push_front(B);
-    Sci->Stats.PushedBlocks += B->getCount();
-    if (Sci->CanRelease)
-      releaseToOSMaybe(Sci, ClassId);
+    {
+      BlockingMutexLock L(&Sci->Mutex);
+      Sci->FreeList.push_front(B);
+      Sci->Stats.PushedBlocks += B->getCount();
+    }
+    releaseToOSIfDue();
   }
 
   void disable() {
@@ -154,7 +163,7 @@ public:
     for (uptr I = 1; I < NumClasses; I++) {
       SizeClassInfo *Sci = getSizeClassInfo(I);
       BlockingMutexLock L(&Sci->Mutex);
-      releaseToOSMaybe(Sci, I, /*Force=*/true);
+      releaseToOSMaybe(Sci, I);
     }
   }
 
@@ -177,7 +186,6 @@ private:
     uptr PushedBlocksAtLastRelease;
     uptr RangesReleased;
     uptr LastReleasedBytes;
-    u64 LastReleaseAtNs;
   };
 
   struct ALIGNED(SCUDO_CACHE_LINE_SIZE) SizeClassInfo {
@@ -306,8 +314,6 @@ private:
     DCHECK(B);
     DCHECK_GT(B->getCount(), 0);
     Sci->AllocatedUser += AllocatedUser;
-    if (Sci->CanRelease)
-      Sci->ReleaseInfo.LastReleaseAtNs = getMonotonicTime();
     return B;
   }
 
@@ -324,8 +330,30 @@ private:
            AvailableChunks, Rss >> 10);
   }
 
-  NOINLINE void releaseToOSMaybe(SizeClassInfo *Sci, uptr ClassId,
-                                 bool Force = false) {
+  // Rather than scanning a size class every time a batch is pushed back to
+  // it, free pages are released in a single pass over all the size classes, at
+  // most once per release interval. The pass is done by whichever thread first
+  // pushes a batch past the deadline, while the others carry on.
+  void releaseToOSIfDue() {
+    if (ReleaseToOsIntervalMs <= 0)
+      return;
+    const u64 Now = getMonotonicTime();
+    if (Now < atomic_load_relaxed(&NextReleaseAtNs) || !ReleaseMutex.tryLock())
+      return;
+    atomic_store_relaxed(&NextReleaseAtNs,
+                         Now + static_cast<u64>(ReleaseToOsIntervalMs) *
+                                   1000000ULL);
+    for (uptr I = 1; I < NumClasses; I++) {
+      SizeClassInfo *Sci = getSizeClassInfo(I);
+      if (!Sci->CanRelease)
+        continue;
+      BlockingMutexLock L(&Sci->Mutex);
+      releaseToOSMaybe(Sci, I);
+    }
+    ReleaseMutex.unlock();
+  }
+
+  NOINLINE void releaseToOSMaybe(SizeClassInfo *Sci, uptr ClassId) {
     const uptr BlockSize = getSizeByClassId(ClassId);
     const uptr PageSize = getPageSizeCached();
 
@@ -339,16 +367,6 @@ private:
       return; // Nothing new to release.
     }
 
-    if (!Force) {
-      const s32 IntervalMs = ReleaseToOsIntervalMs;
-      if (IntervalMs < 0)
-        return;
-      if (Sci->ReleaseInfo.LastReleaseAtNs + IntervalMs * 1000000ULL >
-          getMonotonicTime()) {
-        return; // Memory was returned recently.
-      }
-    }
-
     // TODO(kostyak): currently not ideal as we loop over all regions and
     // iterate multiple times over the same freelist if a ClassId spans multiple
     // regions. But it will have to do for now.
@@ -364,7 +382,6 @@ private:
         }
       }
     }
-    Sci->ReleaseInfo.LastReleaseAtNs = getMonotonicTime();
   }
 
   SizeClassInfo SizeClassInfoArray[NumClasses];
@@ -375,6 +392,8 @@ private:
   uptr MinRegionIndex;
   uptr MaxRegionIndex;
   s32 ReleaseToOsIntervalMs;
+  StaticSpinMutex ReleaseMutex;
+  atomic_u64 NextReleaseAtNs;
   // Unless several threads request regions simultaneously from different size
   // classes, the stash rarely contains more than 1 entry.
   static constexpr uptr MaxStashedRegions = 4;
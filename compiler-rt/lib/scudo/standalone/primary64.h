@@ -13,6 +13,7 @@
 #include "common.h"
 #include "list.h"
 #include "local_cache.h"
+#include "memtag.h"
 #include "release.h"
 #include "stats.h"
 #include "string_utils.h"
@@ -37,6 +38,9 @@ namespace scudo {
 //
 // The memory used by this allocator is never unmapped, but can be partially
 // released it the platform allows for it.
+//
+// If the system supports it, user memory is mapped so that it can hold memory
+// tags, in which case useMemoryTagging() returns true.
 
 template <class SizeClassMapT, uptr RegionSizeLog> class SizeClassAllocator64 {
 public:
@@ -53,6 +57,8 @@ public:
 
   static bool canAllocate(uptr Size) { return Size <= SizeClassMap::MaxSize; }
 
+  bool useMemoryTagging() const { return UseMemoryTagging; }
+
   void initLinkerInitialized(s32 ReleaseToOsInterval) {
     // Reserve the space required for the Primary.
     PrimaryBase = reinterpret_cast<uptr>(
@@ -85,6 +91,12 @@ public:
       Region->RandState = getRandomU32(&Seed);
     }
     ReleaseToOsIntervalMs = ReleaseToOsInterval;
+    UseMemoryTagging = systemSupportsMemoryTagging();
+    if (ReleaseToOsInterval > 0)
+      atomic_store_relaxed(&NextReleaseAtNs,
+                           getMonotonicTime() +
+                               static_cast<u64>(ReleaseToOsInterval) *
+                                   1000000ULL);
   }
   void init(s32 ReleaseToOsInterval) {
     memset(this, 0, sizeof(*this));
@@ -111,11 +123,12 @@ public:
   void pushBatch(uptr ClassId, TransferBatch *B) {
     DCHECK_GT(B->getCount(), 0);
     RegionInfo *Region = getRegionInfo(ClassId);
-    BlockingMutexLock L(&Region->Mutex);
-    Region->FreeList.push_front(B);
-    Region->Stats.PushedBlocks += B->getCount();
-    if (Region->CanRelease)
-      releaseToOSMaybe(Region, ClassId);
+    {
+      BlockingMutexLock L(&Region->Mutex);
+      Region->FreeList.push_front(B);
+      Region->Stats.PushedBlocks += B->getCount();
+    }
+    releaseToOSIfDue();
   }
 
   void disable() {
@@ -163,7 +176,7 @@ public:
     for (uptr I = 1; I < NumClasses; I++) {
       RegionInfo *Region = getRegionInfo(I);
       BlockingMutexLock L(&Region->Mutex);
-      releaseToOSMaybe(Region, I, /*Force=*/true);
+      releaseToOSMaybe(Region, I);
     }
   }
 
@@ -184,7 +197,6 @@ private:
     uptr PushedBlocksAtLastRelease;
     uptr RangesReleased;
     uptr LastReleasedBytes;
-    u64 LastReleaseAtNs;
   };
 
   struct ALIGNED(SCUDO_CACHE_LINE_SIZE) RegionInfo {
@@ -206,6 +218,9 @@ private:
   RegionInfo *RegionInfoArray;
   MapPlatformData Data;
   s32 ReleaseToOsIntervalMs;
+  bool UseMemoryTagging;
+  StaticSpinMutex ReleaseMutex;
+  atomic_u64 NextReleaseAtNs;
 
   RegionInfo *getRegionInfo(uptr ClassId) const {
     DCHECK_LT(ClassId, NumClasses);
@@ -268,7 +283,9 @@ private:
         Region->Data = Data;
       if (UNLIKELY(!map(reinterpret_cast<void *>(RegionBeg + MappedUser),
                         UserMapSize, "scudo:primary",
-                        MAP_ALLOWNOMEM | MAP_RESIZABLE, &Region->Data)))
+                        MAP_ALLOWNOMEM | MAP_RESIZABLE |
+                            (UseMemoryTagging ? MAP_MEMTAG : 0),
+                        &Region->Data)))
         return nullptr;
       Region->MappedUser += UserMapSize;
       C->getStats().add(StatMapped, UserMapSize);
@@ -303,8 +320,6 @@ private:
 
     Region->AllocatedUser += AllocatedUser;
     Region->Exhausted = false;
-    if (Region->CanRelease)
-      Region->ReleaseInfo.LastReleaseAtNs = getMonotonicTime();
 
     return B;
   }
@@ -327,8 +342,30 @@ private:
            getRegionBaseByClassId(ClassId));
   }
 
-  NOINLINE void releaseToOSMaybe(RegionInfo *Region, uptr ClassId,
-                                 bool Force = false) {
+  // Rather than scanning a size class every time a batch is pushed back to
+  // it, free pages are released in a single pass over all the size classes, at
+  // most once per release interval. The pass is done by whichever thread first
+  // pushes a batch past the deadline, while the others carry on.
+  void releaseToOSIfDue() {
+    if (ReleaseToOsIntervalMs <= 0)
+      return;
+    const u64 Now = getMonotonicTime();
+    if (Now < atomic_load_relaxed(&NextReleaseAtNs) || !ReleaseMutex.tryLock())
+      return;
+    atomic_store_relaxed(&NextReleaseAtNs,
+                         Now + static_cast<u64>(ReleaseToOsIntervalMs) *
+                                   1000000ULL);
+    for (uptr I = 1; I < NumClasses; I++) {
+      RegionInfo *Region = getRegionInfo(I);
+      if (!Region->CanRelease)
+        continue;
+      BlockingMutexLock L(&Region->Mutex);
+      releaseToOSMaybe(Region, I);
+    }
+    ReleaseMutex.unlock();
+  }
+
+  NOINLINE void releaseToOSMaybe(RegionInfo *Region, uptr ClassId) {
     const uptr BlockSize = getSizeByClassId(ClassId);
     const uptr PageSize = getPageSizeCached();
 
@@ -343,16 +380,6 @@ private:
       return; // Nothing new to release.
     }
 
-    if (!Force) {
-      const s32 IntervalMs = ReleaseToOsIntervalMs;
-      if (IntervalMs < 0)
-        return;
-      if (Region->ReleaseInfo.LastReleaseAtNs + IntervalMs * 1000000ULL >
-          getMonotonicTime()) {
-        return; // Memory was returned recently.
-      }
-    }
-
     ReleaseRecorder Recorder(Region->RegionBeg, &Region->Data);
     releaseFreeMemoryToOS(&Region->FreeList, Region->RegionBeg,
                           roundUpTo(Region->AllocatedUser, PageSize) / PageSize,
@@ -364,7 +391,6 @@ private:
       Region->ReleaseInfo.RangesReleased += Recorder.getReleasedRangesCount();
       Region->ReleaseInfo.LastReleasedBytes = Recorder.getReleasedBytes();
     }
-    Region->ReleaseInfo.LastReleaseAtNs = getMonotonicTime();
   }
 };
 
@@ -0,0 +1,61 @@
+// Mini-benchmark for tsan memory usage: large non-shared heap blocks, written
+// by short-lived threads, generation after generation.
+//
+// Peak RSS is mostly the shadow of the heap, and the traces of the threads.
+// Compare a runtime built with COMPILER_RT_TSAN_SHADOW_COUNT=2 against the
+// default one, and runs with and without TSAN_OPTIONS=memory_limit_mb=N.
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+long len;
+int *a;
+const int kNumIter = 10;
+
+__attribute__((noinline))
+void Run(long idx) {
+  for (long i = 0, n = len; i < n; i++)
+    a[i + idx * n] = i;
+}
+
+void *Thread(void *arg) {
+  long idx = (long)arg;
+  for (int i = 0; i < kNumIter; i++)
+    Run(idx);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  int n_threads = 0;
+  int n_generations = 0;
+  if (argc != 4) {
+    n_threads = 8;
+    n_generations = 8;
+    len = 1 << 24;
+  } else {
+    n_threads = atoi(argv[1]);
+    assert(n_threads > 0 && n_threads <= 64);
+    n_generations = atoi(argv[2]);
+    assert(n_generations > 0);
+    len = atol(argv[3]);
+  }
+  printf("%s: n_threads=%d n_generations=%d len=%ld iter=%d\n",
+         __FILE__, n_threads, n_generations, len, kNumIter);
+  a = new int[n_threads * len];
+  pthread_t *t = new pthread_t[n_threads];
+  for (int g = 0; g < n_generations; g++) {
+    for (int i = 0; i < n_threads; i++)
+      pthread_create(&t[i], 0, Thread, (void*)(long)i);
+    for (int i = 0; i < n_threads; i++)
+      pthread_join(t[i], 0);
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  printf("heap: %ldMB peak RSS: %ldMB\n",
+         n_threads * len * (long)sizeof(int) >> 20, usage.ru_maxrss >> 10);
+  delete [] t;
+  delete [] a;
+  return 0;
+}
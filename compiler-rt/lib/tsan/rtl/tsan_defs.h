@@ -74,7 +74,16 @@ const unsigned kMaxTidInClock = kMaxTid;  // Go does not track freed memory.
 const uptr kShadowStackSize = 64 * 1024;
 
 // Count of shadow values in a shadow cell.
-const uptr kShadowCnt = 4;
+// With TSAN_SHADOW_COUNT=2, shadow memory is half the size, but each 8 bytes
+// of application memory only remember the last 2 accesses to them, so that
+// some races that need an older access to be in the shadow go unnoticed.
+#ifndef TSAN_SHADOW_COUNT
+# define TSAN_SHADOW_COUNT 4
+#endif
+#if TSAN_SHADOW_COUNT != 2 && TSAN_SHADOW_COUNT != 4
+# error "TSAN_SHADOW_COUNT must be 2 or 4"
+#endif
+const uptr kShadowCnt = TSAN_SHADOW_COUNT;
 
 // That many user bytes are mapped onto a single shadow cell.
 const uptr kShadowCell = 8;
@@ -115,6 +124,12 @@ void build_consistency_stats();
 void build_consistency_nostats();
 #endif
 
+#if TSAN_SHADOW_COUNT == 2
+void build_consistency_shadow2();
+#else
+void build_consistency_shadow4();
+#endif
+
 static inline void USED build_consistency() {
 #if SANITIZER_DEBUG
   build_consistency_debug();
@@ -126,6 +141,11 @@ static inline void USED build_consistency() {
 #else
   build_consistency_nostats();
 #endif
+#if TSAN_SHADOW_COUNT == 2
+  build_consistency_shadow2();
+#else
+  build_consistency_shadow4();
+#endif
 }
 
 template<typename T>
@@ -184,6 +184,7 @@ static void BackgroundThread(void *arg) {
       if (last_flush + flags()->flush_memory_ms * kMs2Ns < now) {
         VPrintf(1, "ThreadSanitizer: periodic memory flush\n");
         FlushShadowMemory();
+        ReleaseDeadThreadTraces();
         last_flush = NanoTime();
       }
     }
@@ -197,6 +198,7 @@ static void BackgroundThread(void *arg) {
       if (2 * rss > limit + last_rss) {
         VPrintf(1, "ThreadSanitizer: flushing memory due to RSS\n");
         FlushShadowMemory();
+        ReleaseDeadThreadTraces();
         rss = GetRSS();
         VPrintf(1, "ThreadSanitizer: memory flushed RSS=%llu\n", (u64)rss>>20);
       }
@@ -656,7 +658,7 @@ void MemoryAccessImpl1(ThreadState *thr, uptr addr,
   // consumes almost 4K of stack. Gtest gives only 4K of stack to death test
   // threads, which is not enough for the unrolled loop.
 #if SANITIZER_DEBUG
-  for (int idx = 0; idx < 4; idx++) {
+  for (int idx = 0; idx < (int)kShadowCnt; idx++) {
 #include "tsan_update_shadow_word_inl.h"
   }
 #else
@@ -668,6 +670,7 @@ void MemoryAccessImpl1(ThreadState *thr, uptr addr,
   } else {
 #include "tsan_update_shadow_word_inl.h"
   }
+#if TSAN_SHADOW_COUNT > 2
   idx = 2;
   if (stored) {
 #include "tsan_update_shadow_word_inl.h"
@@ -680,6 +683,7 @@ void MemoryAccessImpl1(ThreadState *thr, uptr addr,
   } else {
 #include "tsan_update_shadow_word_inl.h"
   }
+#endif
 #endif
 
   // we did not find any races and had already stored
@@ -747,8 +751,14 @@ bool ContainsSameAccessFast(u64 *s, u64 a, u64 sync_epoch, bool is_write) {
   // addr0[96:127]      = access[32:63]
   const m128 addr0      = SHUF(access, access, 1, 1, 1, 1);
   // load 4 shadow slots
+  // (or twice the 2 slots of a compact shadow cell, which gives the same
+  // result as checking them once)
   const m128 shadow0    = _mm_load_si128((__m128i*)s);
+#if TSAN_SHADOW_COUNT == 2
+  const m128 shadow1    = shadow0;
+#else
   const m128 shadow1    = _mm_load_si128((__m128i*)s + 1);
+#endif
   // load high parts of 4 shadow slots into addr_vect:
   // addr_vect[0:31]    = shadow0[32:63]
   // addr_vect[32:63]   = shadow0[96:127]
@@ -1090,6 +1100,12 @@ void build_consistency_stats() {}
 void build_consistency_nostats() {}
 #endif
 
+#if TSAN_SHADOW_COUNT == 2
+void build_consistency_shadow2() {}
+#else
+void build_consistency_shadow4() {}
+#endif
+
 }  // namespace __tsan
 
 #if !SANITIZER_GO
@@ -222,6 +222,23 @@ void ThreadFinalize(ThreadState *thr) {
 #endif
 }
 
+#if !SANITIZER_GO
+static void ReleaseTraceIfDead(ThreadContextBase *tctx, void *arg) {
+  if (tctx->status != ThreadStatusDead)
+    return;
+  uptr trace = GetThreadTrace(tctx->tid);
+  ReleaseMemoryPagesToOS(trace, trace + TraceSize() * sizeof(Event));
+}
+
+// Once the shadow has been flushed, it no longer refers to accesses recorded
+// in the traces of the threads that have finished, so a race report never
+// needs them again. A thread that reuses the context writes its trace anew.
+void ReleaseDeadThreadTraces() {
+  ThreadRegistryLock l(ctx->thread_registry);
+  ctx->thread_registry->RunCallbackForEachThreadLocked(ReleaseTraceIfDead, 0);
+}
+#endif
+
 int ThreadCount(ThreadState *thr) {
   uptr result;
   ctx->thread_registry->GetNumberOfThreads(0, 0, &result);
@@ -230,5 +230,72 @@ TEST(BufferQueueTest, GenerationalSupportAcrossThreads) {
   ASSERT_EQ(Counter.load(std::memory_order_acquire), 0);
 }
 
+TEST(BufferQueueTest, Streaming) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 2, Success, true);
+  ASSERT_TRUE(Success);
+  BufferQueue::Buffer B0, B1, B;
+
+  // Released buffers are not handed out again until they have been written
+  // out and recycled.
+  ASSERT_EQ(Buffers.getBuffer(B0), BufferQueue::ErrorCode::Ok);
+  auto *D0 = B0.Data;
+  ASSERT_EQ(Buffers.releaseBuffer(B0), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.getBuffer(B1), BufferQueue::ErrorCode::Ok);
+  auto *D1 = B1.Data;
+  ASSERT_EQ(Buffers.releaseBuffer(B1), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.getBuffer(B), BufferQueue::ErrorCode::NotEnoughMemory);
+
+  // They are taken out in the order they were released.
+  ASSERT_TRUE(Buffers.takeCompletedBuffer(B));
+  ASSERT_EQ(B.Data, D0);
+  Buffers.recycleBuffer(B);
+  ASSERT_TRUE(Buffers.takeCompletedBuffer(B));
+  ASSERT_EQ(B.Data, D1);
+  ASSERT_FALSE(Buffers.takeCompletedBuffer(B));
+
+  // Only the buffer that is yet to be recycled is still "used".
+  auto Count = 0;
+  Buffers.apply([&](const BufferQueue::Buffer &) { ++Count; });
+  ASSERT_EQ(Count, 1);
+  Buffers.recycleBuffer(B);
+
+  ASSERT_EQ(Buffers.getBuffer(B), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(B.Data, D0);
+  ASSERT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+}
+
+TEST(BufferQueueTest, StreamingAcrossThreads) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 4, Success, true);
+  ASSERT_TRUE(Success);
+  std::atomic<int> Released(0);
+  auto F = [&] {
+    BufferQueue::Buffer B;
+    for (int I = 0; I < 100; ++I) {
+      while (Buffers.getBuffer(B) != BufferQueue::ErrorCode::Ok)
+        std::this_thread::yield();
+      ASSERT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+      Released.fetch_add(1, std::memory_order_acq_rel);
+    }
+  };
+  auto T0 = std::async(std::launch::async, F);
+  auto T1 = std::async(std::launch::async, F);
+  int Taken = 0;
+  BufferQueue::Buffer B;
+  while (Taken != 200) {
+    if (Buffers.takeCompletedBuffer(B)) {
+      Buffers.recycleBuffer(B);
+      ++Taken;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  T0.get();
+  T1.get();
+  ASSERT_EQ(Released.load(std::memory_order_acquire), 200);
+  ASSERT_FALSE(Buffers.takeCompletedBuffer(B));
+}
+
 } // namespace
 } // namespace __xray
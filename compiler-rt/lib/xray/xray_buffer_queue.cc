@@ -67,17 +67,95 @@ constexpr size_t kExtentsSize = sizeof(ExtentsPadded);
 
 } // namespace
 
-BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
+bool BufferQueue::IndexRing::init(size_t N, bool Full) {
+  Cells = initArray<Cell>(N);
+  if (Cells == nullptr && N != 0)
+    return false;
+  Capacity = N;
+  for (size_t I = 0; I < N; ++I) {
+    Cells[I].Index = I;
+    atomic_store(&Cells[I].Sequence, Full ? I + 1 : I, memory_order_relaxed);
+  }
+  atomic_store(&Head, 0, memory_order_relaxed);
+  atomic_store(&Tail, Full ? N : 0, memory_order_release);
+  return true;
+}
+
+void BufferQueue::IndexRing::reset() {
+  if (Cells != nullptr)
+    deallocateBuffer(Cells, Capacity);
+  Cells = nullptr;
+  Capacity = 0;
+}
+
+bool BufferQueue::IndexRing::push(size_t Index) {
+  if (Capacity == 0)
+    return false;
+  atomic_uint64_t::Type Pos = atomic_load(&Tail, memory_order_relaxed);
+  while (true) {
+    Cell &C = Cells[Pos % Capacity];
+    atomic_uint64_t::Type Seq = atomic_load(&C.Sequence, memory_order_acquire);
+    auto Diff = static_cast<int64_t>(Seq - Pos);
+    if (Diff == 0) {
+      // On failure, the exchange updates Pos to the current tail.
+      if (atomic_compare_exchange_weak(&Tail, &Pos, Pos + 1,
+                                       memory_order_relaxed)) {
+        C.Index = Index;
+        atomic_store(&C.Sequence, Pos + 1, memory_order_release);
+        return true;
+      }
+    } else if (Diff < 0) {
+      return false;
+    } else {
+      Pos = atomic_load(&Tail, memory_order_relaxed);
+    }
+  }
+}
+
+bool BufferQueue::IndexRing::pop(size_t &Index) {
+  if (Capacity == 0)
+    return false;
+  atomic_uint64_t::Type Pos = atomic_load(&Head, memory_order_relaxed);
+  while (true) {
+    Cell &C = Cells[Pos % Capacity];
+    atomic_uint64_t::Type Seq = atomic_load(&C.Sequence, memory_order_acquire);
+    auto Diff = static_cast<int64_t>(Seq - (Pos + 1));
+    if (Diff == 0) {
+      if (atomic_compare_exchange_weak(&Head, &Pos, Pos + 1,
+                                       memory_order_relaxed)) {
+        Index = C.Index;
+        atomic_store(&C.Sequence, Pos + Capacity, memory_order_release);
+        return true;
+      }
+    } else if (Diff < 0) {
+      return false;
+    } else {
+      Pos = atomic_load(&Head, memory_order_relaxed);
+    }
+  }
+}
+
+BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC, bool S) {
   SpinMutexLock Guard(&Mutex);
 
   if (!finalizing())
     return BufferQueue::ErrorCode::AlreadyInitialized;
 
+  // Wait out the getBuffer() and releaseBuffer() calls that may still be
+  // looking at the buffers we are about to replace. The ones that come after
+  // see Reinitializing, and treat their buffer as one of a past generation.
+  atomic_store(&Reinitializing, 1, memory_order_seq_cst);
+  while (atomic_load(&Users, memory_order_seq_cst) != 0)
+    internal_sched_yield();
+  auto DoneReinitializing = at_scope_exit(
+      [this] { atomic_store(&Reinitializing, 0, memory_order_release); });
+
   cleanupBuffers();
 
   bool Success = false;
   BufferSize = BS;
   BufferCount = BC;
+  Streaming = S;
 
   BackingStore = allocControlBlock(BufferSize, BufferCount);
   if (BackingStore == nullptr)
@@ -106,6 +184,19 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
   if (Buffers == nullptr)
     return BufferQueue::ErrorCode::NotEnoughMemory;
 
+  auto CleanupBuffers = at_scope_exit([&, this] {
+    if (Success)
+      return;
+    deallocateBuffer(Buffers, BufferCount);
+    Buffers = nullptr;
+    Available.reset();
+    Completed.reset();
+  });
+
+  if (!Available.init(BufferCount, true) ||
+      (Streaming && !Completed.init(BufferCount, false)))
+    return BufferQueue::ErrorCode::NotEnoughMemory;
+
   // At this point we increment the generation number to associate the buffers
   // to the new generation.
   atomic_fetch_add(&Generation, 1, memory_order_acq_rel);
@@ -134,47 +225,53 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
     T.Used = false;
   }
 
-  Next = Buffers;
-  First = Buffers;
-  LiveBuffers = 0;
   atomic_store(&Finalizing, 0, memory_order_release);
   Success = true;
   return BufferQueue::ErrorCode::Ok;
 }
 
-BufferQueue::BufferQueue(size_t B, size_t N,
-                         bool &Success) XRAY_NEVER_INSTRUMENT
+BufferQueue::BufferQueue(size_t B, size_t N, bool &Success,
+                         bool S) XRAY_NEVER_INSTRUMENT
     : BufferSize(B),
       BufferCount(N),
       Mutex(),
       Finalizing{1},
+      Reinitializing{0},
+      Users{0},
+      Streaming(S),
       BackingStore(nullptr),
       ExtentsBackingStore(nullptr),
       Buffers(nullptr),
-      Next(Buffers),
-      First(Buffers),
-      LiveBuffers(0),
       Generation{0} {
-  Success = init(B, N) == BufferQueue::ErrorCode::Ok;
+  Success = init(B, N, S) == BufferQueue::ErrorCode::Ok;
+}
+
+size_t BufferQueue::indexOf(const void *Data) const {
+  if (BackingStore == nullptr)
+    return BufferCount;
+  auto *D = static_cast<const char *>(Data);
+  auto *Base = reinterpret_cast<const char *>(&BackingStore->Data);
+  if (D < Base || D >= Base + (BufferCount * BufferSize))
+    return BufferCount;
+  return (D - Base) / BufferSize;
 }
 
 BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
-  if (atomic_load(&Finalizing, memory_order_acquire))
+  atomic_fetch_add(&Users, 1, memory_order_seq_cst);
+  auto DoneUsing = at_scope_exit(
+      [this] { atomic_fetch_sub(&Users, 1, memory_order_release); });
+
+  // init() only replaces the buffers while the queue is finalizing.
+  if (atomic_load(&Finalizing, memory_order_seq_cst))
     return ErrorCode::QueueFinalizing;
 
-  BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (LiveBuffers == BufferCount)
-      return ErrorCode::NotEnoughMemory;
-    B = Next++;
-    if (Next == (Buffers + BufferCount))
-      Next = Buffers;
-    ++LiveBuffers;
-  }
+  size_t Index;
+  if (!Available.pop(Index))
+    return ErrorCode::NotEnoughMemory;
 
   incRefCount(BackingStore);
   incRefCount(ExtentsBackingStore);
+  BufferRep *B = &Buffers[Index];
   Buf = B->Buff;
   Buf.Generation = generation();
   B->Used = true;
@@ -182,39 +279,59 @@ BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
 }
 
 BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
+  atomic_fetch_add(&Users, 1, memory_order_seq_cst);
+  auto DoneUsing = at_scope_exit(
+      [this] { atomic_fetch_sub(&Users, 1, memory_order_release); });
+
+  // A buffer from a past generation only holds references to its own backing
+  // stores.
+  if (atomic_load(&Reinitializing, memory_order_seq_cst) ||
+      Buf.Generation != generation()) {
+    Buffer Stale = Buf;
+    Buf = {};
+    decRefCount(Stale.BackingStore, Stale.Size, Stale.Count);
+    decRefCount(Stale.ExtentsBackingStore, kExtentsSize, Stale.Count);
+    return BufferQueue::ErrorCode::Ok;
+  }
+
   // Check whether the buffer being referred to is within the bounds of the
   // backing store's range.
-  BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (Buf.Generation != generation() || LiveBuffers == 0) {
-      Buf = {};
-      decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
-      decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
-      return BufferQueue::ErrorCode::Ok;
-    }
-
-    if (Buf.Data < &BackingStore->Data ||
-        Buf.Data > &BackingStore->Data + (BufferCount * BufferSize))
-      return BufferQueue::ErrorCode::UnrecognizedBuffer;
+  size_t Index = indexOf(Buf.Data);
+  if (Index == BufferCount)
+    return BufferQueue::ErrorCode::UnrecognizedBuffer;
 
-    --LiveBuffers;
-    B = First++;
-    if (First == (Buffers + BufferCount))
-      First = Buffers;
-  }
-
-  // Now that the buffer has been released, we mark it as "used".
-  B->Buff = Buf;
-  B->Used = true;
+  // Now that the buffer has been released, we mark it as "used". Its extents
+  // live in the queue's own storage already.
+  Buffers[Index].Used = true;
   decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
   decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
-  atomic_store(B->Buff.Extents, atomic_load(Buf.Extents, memory_order_acquire),
-               memory_order_release);
   Buf = {};
+
+  // Every buffer can be in at most one of the rings at a time, which have room
+  // for all of them, so this cannot fail.
+  if (Streaming)
+    Completed.push(Index);
+  else
+    Available.push(Index);
   return ErrorCode::Ok;
 }
 
+bool BufferQueue::takeCompletedBuffer(Buffer &Buf) {
+  size_t Index;
+  if (!Streaming || !Completed.pop(Index))
+    return false;
+  Buf = Buffers[Index].Buff;
+  return true;
+}
+
+void BufferQueue::recycleBuffer(const Buffer &Buf) {
+  size_t Index = indexOf(Buf.Data);
+  if (Index == BufferCount)
+    return;
+  Buffers[Index].Used = false;
+  Available.push(Index);
+}
+
 BufferQueue::ErrorCode BufferQueue::finalize() {
   if (atomic_exchange(&Finalizing, 1, memory_order_acq_rel))
     return ErrorCode::QueueFinalizing;
@@ -225,6 +342,8 @@ void BufferQueue::cleanupBuffers() {
   for (auto B = Buffers, E = Buffers + BufferCount; B != E; ++B)
     B->~BufferRep();
   deallocateBuffer(Buffers, BufferCount);
+  Available.reset();
+  Completed.reset();
   decRefCount(BackingStore, BufferSize, BufferCount);
   decRefCount(ExtentsBackingStore, kExtentsSize, BufferCount);
   BackingStore = nullptr;
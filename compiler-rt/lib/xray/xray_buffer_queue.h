@@ -28,6 +28,12 @@ namespace __xray {
 /// get from or return buffers to the queue. This is one key component of the
 /// "flight data recorder" (FDR) mode to support ongoing XRay function call
 /// trace collection.
+///
+/// Getting and releasing buffers does not take any lock: the buffers that can
+/// be handed out are kept in a lock-free ring, and handed out again least
+/// recently released first, so that a full queue keeps the most history. In
+/// streaming mode, released buffers instead wait in a second ring until a
+/// writer has taken them out, written them down, and recycled them.
 class BufferQueue {
 public:
   /// ControlBlock represents the memory layout of how we interpret the backing
@@ -74,6 +80,32 @@ public:
   };
 
 private:
+  // A bounded multi-producer multi-consumer queue of buffer indices, after
+  // Dmitry Vyukov's: the sequence number of each cell tells pushes and pops
+  // which lap of the ring it is ready for, so that they only ever contend on
+  // a compare-and-swap of the head or the tail.
+  class IndexRing {
+    struct Cell {
+      atomic_uint64_t Sequence;
+      size_t Index;
+    };
+
+    Cell *Cells = nullptr;
+    size_t Capacity = 0;
+    atomic_uint64_t Head{0};
+    atomic_uint64_t Tail{0};
+
+  public:
+    // Makes room for |N| indices, and fills the ring with 0 to N - 1 when
+    // |Full| is true.
+    bool init(size_t N, bool Full);
+    void reset();
+
+    // Both return false, without blocking, when the ring is full or empty.
+    bool push(size_t Index);
+    bool pop(size_t &Index);
+  };
+
   // This models a ForwardIterator. |T| Must be either a `Buffer` or `const
   // Buffer`. Note that we only advance to the "used" buffers, when
   // incrementing, so that at dereference we're always at a valid point.
@@ -137,9 +169,18 @@ private:
   // Amount of pre-allocated buffers.
   size_t BufferCount;
 
+  // Serialises init() against apply().
   SpinMutex Mutex;
   atomic_uint8_t Finalizing;
 
+  // Set while init() replaces the buffers, which it only does once the
+  // getBuffer() and releaseBuffer() calls counted in Users have returned.
+  atomic_uint8_t Reinitializing;
+  atomic_uint64_t Users;
+
+  // Whether released buffers are kept for takeCompletedBuffer().
+  bool Streaming;
+
   // The collocated ControlBlock and buffer storage.
   ControlBlock *BackingStore;
 
@@ -149,15 +190,12 @@ private:
   // A dynamically allocated array of BufferRep instances.
   BufferRep *Buffers;
 
-  // Pointer to the next buffer to be handed out.
-  BufferRep *Next;
-
-  // Pointer to the entry in the array where the next released buffer will be
-  // placed.
-  BufferRep *First;
+  // Indices of the buffers that getBuffer() can hand out.
+  IndexRing Available;
 
-  // Count of buffers that have been handed out through 'getBuffer'.
-  size_t LiveBuffers;
+  // Indices of the buffers released in streaming mode, in the order they were
+  // released, until takeCompletedBuffer() hands them to the writer.
+  IndexRing Completed;
 
   // We use a generation number to identify buffers and which generation they're
   // associated with.
@@ -166,6 +204,10 @@ private:
   /// Releases references to the buffers backed by the current buffer queue.
   void cleanupBuffers();
 
+  /// Returns the index of the buffer whose data starts at |Data|, or
+  /// BufferCount if the queue does not own it.
+  size_t indexOf(const void *Data) const;
+
 public:
   enum class ErrorCode : unsigned {
     Ok,
@@ -194,9 +236,9 @@ public:
     return "unknown error";
   }
 
-  /// Initialise a queue of size |N| with buffers of size |B|. We report success
-  /// through |Success|.
-  BufferQueue(size_t B, size_t N, bool &Success);
+  /// Initialise a queue of size |N| with buffers of size |B|, in streaming mode
+  /// if |S| is true. We report success through |Success|.
+  BufferQueue(size_t B, size_t N, bool &Success, bool S = false);
 
   /// Updates |Buf| to contain the pointer to an appropriate buffer. Returns an
   /// error in case there are no available buffers to return when we will run
@@ -221,13 +263,28 @@ public:
   ErrorCode releaseBuffer(Buffer &Buf);
 
   /// Initializes the buffer queue, starting a new generation. We can re-set the
-  /// size of buffers with |BS| along with the buffer count with |BC|.
+  /// size of buffers with |BS| along with the buffer count with |BC|, and turn
+  /// streaming mode on or off with |S|.
   ///
   /// Returns:
   ///   - ErrorCode::Ok when we successfully initialize the buffer. This
   ///   requires that the buffer queue is previously finalized.
   ///   - ErrorCode::AlreadyInitialized when the buffer queue is not finalized.
-  ErrorCode init(size_t BS, size_t BC);
+  ErrorCode init(size_t BS, size_t BC, bool S = false);
+
+  /// In streaming mode, updates |Buf| to the least recently released buffer
+  /// that has not been taken yet, so that it can be written out. Returns false
+  /// if there is none.
+  ///
+  /// Requirements:
+  ///   - No init() call is in progress, nor will be until recycleBuffer() has
+  ///     been called for |Buf|.
+  bool takeCompletedBuffer(Buffer &Buf);
+
+  /// Makes a buffer that takeCompletedBuffer() handed out, and that has been
+  /// written out since, available to getBuffer() again. It is no longer
+  /// considered "used" until then.
+  void recycleBuffer(const Buffer &Buf);
 
   bool finalizing() const {
     return atomic_load(&Finalizing, memory_order_acquire);
@@ -89,6 +89,12 @@ static atomic_uint64_t TicksPerSec{0};
 static atomic_sint32_t LogFlushStatus = {
     XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING};
 
+// In streaming mode, the log file the writer thread appends the buffers to as
+// threads release them, and the means to stop it at flush time.
+static LogWriter *StreamingLog = nullptr;
+static pthread_t StreamingThread;
+static atomic_uint8_t StopStreaming{0};
+
 // This function will initialize the thread-local data structure used by the FDR
 // logging implementation and return a reference to it. The implementation
 // details require a bit of care to maintain.
@@ -275,6 +281,45 @@ XRayBuffer fdrIterator(const XRayBuffer B) {
   return Result;
 }
 
+// Starting at version 2 of the FDR logging implementation, we only write the
+// records identified by the extents of the buffer. We use the Extents from the
+// Buffer and write that out as the first record in the buffer.  We still use a
+// Metadata record, but fill in the extents instead for the data.
+static void writeBuffer(LogWriter *LW,
+                        const BufferQueue::Buffer &B) XRAY_NEVER_INSTRUMENT {
+  MetadataRecord ExtentsRecord;
+  auto BufferExtents = atomic_load(B.Extents, memory_order_acquire);
+  DCHECK(BufferExtents <= B.Size);
+  ExtentsRecord.Type = uint8_t(RecordType::Metadata);
+  ExtentsRecord.RecordKind =
+      uint8_t(MetadataRecord::RecordKinds::BufferExtents);
+  internal_memcpy(ExtentsRecord.Data, &BufferExtents, sizeof(BufferExtents));
+  if (BufferExtents > 0) {
+    LW->WriteAll(reinterpret_cast<char *>(&ExtentsRecord),
+                 reinterpret_cast<char *>(&ExtentsRecord) +
+                     sizeof(MetadataRecord));
+    LW->WriteAll(reinterpret_cast<char *>(B.Data),
+                 reinterpret_cast<char *>(B.Data) + BufferExtents);
+  }
+}
+
+// The streaming writer thread. It writes out the buffers in the order threads
+// released them, and hands them back to the queue to be filled again. Once
+// asked to stop, it still writes out whatever has been released up to then.
+static void *streamBuffers(void *) XRAY_NEVER_INSTRUMENT {
+  while (true) {
+    bool Stop = atomic_load(&StopStreaming, memory_order_acquire);
+    BufferQueue::Buffer B;
+    while (BQ->takeCompletedBuffer(B)) {
+      writeBuffer(StreamingLog, B);
+      BQ->recycleBuffer(B);
+    }
+    if (Stop)
+      return nullptr;
+    SleepForMillis(fdrFlags()->streaming_interval_ms);
+  }
+}
+
 // Must finalize before flushing.
 XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
   if (atomic_load(&LoggingStatus, memory_order_acquire) !=
@@ -303,6 +348,16 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
   // finalised before attempting to flush the log.
   SleepForMillis(fdrFlags()->grace_period_ms);
 
+  // The streaming writer is done once it has written out what the threads
+  // released during the grace period. We write out the rest ourselves.
+  LogWriter *LW = StreamingLog;
+  if (LW != nullptr) {
+    atomic_store(&StopStreaming, 1, memory_order_release);
+    pthread_join(StreamingThread, nullptr);
+    StreamingLog = nullptr;
+    atomic_store(&StopStreaming, 0, memory_order_release);
+  }
+
   // At this point, we're going to uninstall the iterator implementation, before
   // we decide to do anything further with the global buffer queue.
   __xray_log_remove_buffer_iterator();
@@ -338,17 +393,21 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
   //      (fixed-sized) and let the tools reading the buffers deal with the data
   //      afterwards.
   //
-  LogWriter *LW = LogWriter::Open();
+  // In streaming mode, the writer thread has done the first step and part of
+  // the second already, in the file it has been writing to.
   if (LW == nullptr) {
-    auto Result = XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING;
-    atomic_store(&LogFlushStatus, Result, memory_order_release);
-    return Result;
-  }
+    LW = LogWriter::Open();
+    if (LW == nullptr) {
+      auto Result = XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING;
+      atomic_store(&LogFlushStatus, Result, memory_order_release);
+      return Result;
+    }
 
-  XRayFileHeader Header = fdrCommonHeaderInfo();
-  Header.FdrData = FdrAdditionalHeaderData{BQ->ConfiguredBufferSize()};
-  LW->WriteAll(reinterpret_cast<char *>(&Header),
-               reinterpret_cast<char *>(&Header) + sizeof(Header));
+    XRayFileHeader Header = fdrCommonHeaderInfo();
+    Header.FdrData = FdrAdditionalHeaderData{BQ->ConfiguredBufferSize()};
+    LW->WriteAll(reinterpret_cast<char *>(&Header),
+                 reinterpret_cast<char *>(&Header) + sizeof(Header));
+  }
 
   // Release the current thread's buffer before we attempt to write out all the
   // buffers. This ensures that in case we had only a single thread going, that
@@ -357,27 +416,7 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
   if (TLD.Controller != nullptr)
     TLD.Controller->flush();
 
-  BQ->apply([&](const BufferQueue::Buffer &B) {
-    // Starting at version 2 of the FDR logging implementation, we only write
-    // the records identified by the extents of the buffer. We use the Extents
-    // from the Buffer and write that out as the first record in the buffer.  We
-    // still use a Metadata record, but fill in the extents instead for the
-    // data.
-    MetadataRecord ExtentsRecord;
-    auto BufferExtents = atomic_load(B.Extents, memory_order_acquire);
-    DCHECK(BufferExtents <= B.Size);
-    ExtentsRecord.Type = uint8_t(RecordType::Metadata);
-    ExtentsRecord.RecordKind =
-        uint8_t(MetadataRecord::RecordKinds::BufferExtents);
-    internal_memcpy(ExtentsRecord.Data, &BufferExtents, sizeof(BufferExtents));
-    if (BufferExtents > 0) {
-      LW->WriteAll(reinterpret_cast<char *>(&ExtentsRecord),
-                   reinterpret_cast<char *>(&ExtentsRecord) +
-                       sizeof(MetadataRecord));
-      LW->WriteAll(reinterpret_cast<char *>(B.Data),
-                   reinterpret_cast<char *>(B.Data) + BufferExtents);
-    }
-  });
+  BQ->apply([&](const BufferQueue::Buffer &B) { writeBuffer(LW, B); });
 
   atomic_store(&LogFlushStatus, XRayLogFlushStatus::XRAY_LOG_FLUSHED,
                memory_order_release);
@@ -661,22 +700,55 @@ XRayLogInitStatus fdrLoggingInit(size_t, size_t, void *Options,
   auto BufferSize = FDRFlags.buffer_size;
   auto BufferMax = FDRFlags.buffer_max;
 
+  // In streaming mode, we open the log file and write its header up front, so
+  // that the writer thread only ever appends buffers to it.
+  LogWriter *LW = nullptr;
+  if (FDRFlags.streaming && !FDRFlags.no_file_flush) {
+    LW = LogWriter::Open();
+    if (LW == nullptr) {
+      Report("XRay FDR: Cannot open the log file to stream to; buffers will "
+             "be written out at flush time instead.\n");
+    } else {
+      XRayFileHeader Header = fdrCommonHeaderInfo();
+      Header.FdrData = FdrAdditionalHeaderData{uint64_t(BufferSize)};
+      LW->WriteAll(reinterpret_cast<char *>(&Header),
+                   reinterpret_cast<char *>(&Header) + sizeof(Header));
+    }
+  }
+  bool Streaming = LW != nullptr;
+  auto CloseLog = at_scope_exit([&] {
+    if (LW != nullptr && StreamingLog == nullptr)
+      LogWriter::Close(LW);
+  });
+
   if (BQ == nullptr) {
     bool Success = false;
     BQ = reinterpret_cast<BufferQueue *>(&BufferQueueStorage);
-    new (BQ) BufferQueue(BufferSize, BufferMax, Success);
+    new (BQ) BufferQueue(BufferSize, BufferMax, Success, Streaming);
     if (!Success) {
       Report("BufferQueue init failed.\n");
       return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
     }
   } else {
-    if (BQ->init(BufferSize, BufferMax) != BufferQueue::ErrorCode::Ok) {
+    if (BQ->init(BufferSize, BufferMax, Streaming) !=
+        BufferQueue::ErrorCode::Ok) {
       if (Verbosity())
         Report("Failed to re-initialize global buffer queue. Init failed.\n");
       return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
     }
   }
 
+  if (Streaming) {
+    StreamingLog = LW;
+    if (pthread_create(&StreamingThread, nullptr, streamBuffers, nullptr) !=
+        0) {
+      Report("XRay FDR: Cannot start the streaming writer thread.\n");
+      StreamingLog = nullptr;
+      BQ->finalize();
+      return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
+    }
+  }
+
   static pthread_once_t OnceInit = PTHREAD_ONCE_INIT;
   pthread_once(
       &OnceInit, +[] {
@@ -0,0 +1,62 @@
+// RUN: %clang_builtins -fno-builtin %s %librt -o %t && %run %t
+//===-- memcmp_test.c - Test memcmp ---------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file tests memcmp for the compiler_rt library.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <stdio.h>
+
+int memcmp(const void *a, const void *b, size_t n);
+
+enum { kMaxOffset = 16, kMaxSize = 100 };
+
+unsigned char a[kMaxOffset + kMaxSize];
+unsigned char b[kMaxOffset + kMaxSize];
+
+static int sign(int x) { return (x > 0) - (x < 0); }
+
+int test__memcmp(size_t x, size_t y, size_t n, int expected)
+{
+    int r = sign(memcmp(a + x, b + y, n));
+    if (r != expected)
+        printf("error in memcmp(%zu, %zu, %zu) = %d, expected %d\n",
+               x, y, n, r, expected);
+    return r != expected;
+}
+
+int main()
+{
+    size_t x, y, n, i;
+    for (x = 0; x < kMaxOffset; x++) {
+        for (y = 0; y < kMaxOffset; y++) {
+            for (i = 0; i < kMaxSize; i++) {
+                a[x + i] = (unsigned char)(i * 3);
+                b[y + i] = (unsigned char)(i * 3);
+            }
+            for (n = 0; n < kMaxSize; n++) {
+                if (test__memcmp(x, y, n, 0))
+                    return 1;
+                // Make byte n - 1 differ: the bytes compare as unsigned.
+                if (n == 0)
+                    continue;
+                b[y + n - 1] = 0x80;
+                a[x + n - 1] = 0x7F;
+                if (test__memcmp(x, y, n, -1) || test__memcmp(x, y, n + 1, -1))
+                    return 1;
+                a[x + n - 1] = 0x81;
+                if (test__memcmp(x, y, n, 1))
+                    return 1;
+                a[x + n - 1] = b[y + n - 1] = (unsigned char)((n - 1) * 3);
+            }
+        }
+    }
+    return 0;
+}
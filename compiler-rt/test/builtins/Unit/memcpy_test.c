@@ -0,0 +1,56 @@
+// RUN: %clang_builtins -fno-builtin %s %librt -o %t && %run %t
+//===-- memcpy_test.c - Test memcpy ---------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file tests memcpy for the compiler_rt library.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <stdio.h>
+
+void *memcpy(void *dest, const void *src, size_t n);
+
+enum { kMaxOffset = 16, kMaxSize = 300 };
+
+unsigned char src[kMaxOffset + kMaxSize];
+unsigned char dst[kMaxOffset + kMaxSize + 1];
+
+int test__memcpy(size_t d, size_t s, size_t n)
+{
+    size_t i;
+    for (i = 0; i < sizeof(dst); i++)
+        dst[i] = 0xAA;
+    if (memcpy(dst + d, src + s, n) != dst + d) {
+        printf("error in memcpy(%zu, %zu, %zu): wrong result\n", d, s, n);
+        return 1;
+    }
+    for (i = 0; i < sizeof(dst); i++) {
+        unsigned char expected =
+            (i >= d && i < d + n) ? src[s + i - d] : 0xAA;
+        if (dst[i] != expected) {
+            printf("error in memcpy(%zu, %zu, %zu): dst[%zu] = 0x%X, "
+                   "expected 0x%X\n", d, s, n, i, dst[i], expected);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    size_t d, s, n;
+    for (n = 0; n < sizeof(src); n++)
+        src[n] = (unsigned char)(n * 7 + 1);
+    for (d = 0; d < kMaxOffset; d++)
+        for (s = 0; s < kMaxOffset; s++)
+            for (n = 0; n < kMaxSize; n++)
+                if (test__memcpy(d, s, n))
+                    return 1;
+    return 0;
+}
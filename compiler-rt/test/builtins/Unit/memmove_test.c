@@ -0,0 +1,58 @@
+// RUN: %clang_builtins -fno-builtin %s %librt -o %t && %run %t
+//===-- memmove_test.c - Test memmove -------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file tests memmove for the compiler_rt library.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <stdio.h>
+
+void *memmove(void *dest, const void *src, size_t n);
+
+enum { kMaxOffset = 40, kMaxSize = 200 };
+
+unsigned char buf[kMaxOffset + kMaxSize];
+unsigned char orig[kMaxOffset + kMaxSize];
+
+// Moves within one buffer, so that the source and the destination overlap in
+// every way.
+int test__memmove(size_t d, size_t s, size_t n)
+{
+    size_t i;
+    for (i = 0; i < sizeof(buf); i++)
+        buf[i] = orig[i];
+    if (memmove(buf + d, buf + s, n) != buf + d) {
+        printf("error in memmove(%zu, %zu, %zu): wrong result\n", d, s, n);
+        return 1;
+    }
+    for (i = 0; i < sizeof(buf); i++) {
+        unsigned char expected =
+            (i >= d && i < d + n) ? orig[s + i - d] : orig[i];
+        if (buf[i] != expected) {
+            printf("error in memmove(%zu, %zu, %zu): buf[%zu] = 0x%X, "
+                   "expected 0x%X\n", d, s, n, i, buf[i], expected);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    size_t d, s, n;
+    for (n = 0; n < sizeof(orig); n++)
+        orig[n] = (unsigned char)(n * 7 + 1);
+    for (d = 0; d < kMaxOffset; d++)
+        for (s = 0; s < kMaxOffset; s++)
+            for (n = 0; n < kMaxSize; n++)
+                if (test__memmove(d, s, n))
+                    return 1;
+    return 0;
+}
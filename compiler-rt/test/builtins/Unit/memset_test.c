@@ -0,0 +1,53 @@
+// RUN: %clang_builtins -fno-builtin %s %librt -o %t && %run %t
+//===-- memset_test.c - Test memset ---------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file tests memset for the compiler_rt library.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <stdio.h>
+
+void *memset(void *dest, int c, size_t n);
+
+enum { kMaxOffset = 16, kMaxSize = 300 };
+
+unsigned char dst[kMaxOffset + kMaxSize + 1];
+
+int test__memset(size_t d, int c, size_t n)
+{
+    size_t i;
+    for (i = 0; i < sizeof(dst); i++)
+        dst[i] = 0xAA;
+    if (memset(dst + d, c, n) != dst + d) {
+        printf("error in memset(%zu, %d, %zu): wrong result\n", d, c, n);
+        return 1;
+    }
+    for (i = 0; i < sizeof(dst); i++) {
+        unsigned char expected =
+            (i >= d && i < d + n) ? (unsigned char)c : 0xAA;
+        if (dst[i] != expected) {
+            printf("error in memset(%zu, %d, %zu): dst[%zu] = 0x%X, "
+                   "expected 0x%X\n", d, c, n, i, dst[i], expected);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    size_t d, n;
+    for (d = 0; d < kMaxOffset; d++)
+        for (n = 0; n < kMaxSize; n++)
+            if (test__memset(d, 0, n) || test__memset(d, 0x5C, n) ||
+                test__memset(d, 0x1FF, n))
+                return 1;
+    return 0;
+}
@@ -0,0 +1,27 @@
+// RUN: %clang_profgen -mllvm -runtime-counter-relocation -o %t %s
+// RUN: rm -f %t.profraw
+// RUN: env LLVM_PROFILE_FILE="%c%t.profraw" not --crash %run %t
+// RUN: llvm-profdata show --counts --all-functions %t.profraw | FileCheck %s
+//
+// With %m, every process adds its counts into the same mapped counters.
+// RUN: rm -fr %t.d
+// RUN: env LLVM_PROFILE_FILE="%t.d/%c%m.profraw" not --crash %run %t
+// RUN: env LLVM_PROFILE_FILE="%t.d/%c%m.profraw" not --crash %run %t
+// RUN: llvm-profdata show --counts --all-functions %t.d/*.profraw \
+// RUN:   | FileCheck %s --check-prefix=MERGE
+
+#include <signal.h>
+
+// CHECK-LABEL: foo:
+// CHECK: Function count: 10
+// MERGE-LABEL: foo:
+// MERGE: Function count: 20
+void foo() {}
+
+int main() {
+  for (int I = 0; I < 10; ++I)
+    foo();
+  // Nothing gets written at exit: the counts must already be in the file.
+  raise(SIGKILL);
+  return 0;
+}
@@ -0,0 +1,29 @@
+// RUN: %clang_profgen -mllvm -sharded-counter-update -pthread -o %t %s
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata show --counts --all-functions %t.profraw | FileCheck %s
+
+#include <pthread.h>
+
+// Every thread counts into its own shard, and the shards of the threads of
+// later rounds are those of the threads that exited before them. None of the
+// counts may get lost.
+// CHECK-LABEL: foo:
+// CHECK: Function count: 640000
+void foo() {}
+
+void *work(void *Arg) {
+  for (int I = 0; I < 10000; ++I)
+    foo();
+  return Arg;
+}
+
+int main() {
+  for (int Round = 0; Round < 4; ++Round) {
+    pthread_t Threads[16];
+    for (int I = 0; I < 16; ++I)
+      pthread_create(&Threads[I], 0, work, 0);
+    for (int I = 0; I < 16; ++I)
+      pthread_join(Threads[I], 0);
+  }
+  return 0;
+}
@@ -0,0 +1,17 @@
+// RUN: %clang_profgen -mllvm -sampled-instr-period=4 -o %t %s
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata show --counts --all-functions %t.profraw | FileCheck %s
+
+// Only the 3rd, 7th, 11th and 15th calls to foo() bring the countdown that
+// main() started at back to zero, and each of them is scaled up by 4.
+// CHECK-LABEL: foo:
+// CHECK: Function count: 16
+// CHECK-LABEL: main:
+// CHECK: Function count: 0
+void foo() {}
+
+int main() {
+  for (int I = 0; I < 16; ++I)
+    foo();
+  return 0;
+}
@@ -0,0 +1,45 @@
+// Check that in streaming mode, the buffers are written out as they fill up, so
+// that the log keeps more records than the buffers can hold at once.
+//
+// RUN: rm -rf %t && mkdir %t
+// RUN: %clangxx_xray -g -std=c++11 %s -o %t.exe
+// RUN: XRAY_OPTIONS="patch_premain=false \
+// RUN:    xray_logfile_base=%t/ xray_mode=xray-fdr verbosity=1" \
+// RUN:    XRAY_FDR_OPTIONS="func_duration_threshold_us=0 buffer_size=1024 \
+// RUN:    buffer_max=4 streaming=true streaming_interval_ms=1" \
+// RUN:    %run %t.exe 2>&1 | FileCheck %s
+// RUN: %llvm_xray convert --symbolize --output-format=yaml -instr_map=%t.exe %t/* | \
+// RUN:   grep -c 'function: .*fn.*, .*kind: function-enter' | \
+// RUN:   FileCheck %s --check-prefix TRACE
+// FIXME: Make llvm-xray work on non-x86_64 as well.
+// REQUIRES: x86_64-target-arch
+// REQUIRES: built-in-llvm-tree
+
+#include "xray/xray_log_interface.h"
+#include <cassert>
+#include <unistd.h>
+
+[[clang::xray_always_instrument]] void __attribute__((noinline)) fn() {}
+
+int main(int argc, char *argv[]) {
+  assert(__xray_log_init_mode("xray-fdr", "") ==
+         XRayLogInitStatus::XRAY_LOG_INITIALIZED);
+  __xray_patch();
+
+  // Give the writer the time to keep up, as threads drop their records once
+  // all the buffers wait to be written out.
+  for (int I = 0; I < 2000; ++I) {
+    fn();
+    if (I % 16 == 15)
+      usleep(2000);
+  }
+
+  __xray_unpatch();
+  assert(__xray_log_finalize() == XRAY_LOG_FINALIZED);
+  assert(__xray_log_flushLog() == XRAY_LOG_FLUSHED);
+  return 0;
+  // CHECK: {{.*}}XRay: Log file in '{{.*}}'
+  // CHECK-NOT: Failed
+}
+
+// TRACE: 2000
@@ -1,7 +1,5 @@
 #include <clc/clc.h>
 
-#define __CLC_NATIVE_INTRINSIC exp
-
-#define __CLC_BODY <native_unary_intrinsic.inc>
+#define __CLC_BODY <native_exp.inc>
 #define __FLOAT_ONLY
 #include <clc/math/gentype.inc>
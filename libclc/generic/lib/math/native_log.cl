@@ -22,8 +22,6 @@
 
 #include <clc/clc.h>
 
-#define __CLC_NATIVE_INTRINSIC log
-
-#define __CLC_BODY <native_unary_intrinsic.inc>
+#define __CLC_BODY <native_log.inc>
 #define __FLOAT_ONLY
 #include <clc/math/gentype.inc>
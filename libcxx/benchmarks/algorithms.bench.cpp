@@ -14,14 +14,18 @@
 
 namespace {
 
-enum class ValueType { Uint32, String };
-struct AllValueTypes : EnumValuesAsTuple<AllValueTypes, ValueType, 2> {
-  static constexpr const char* Names[] = {"uint32", "string"};
+enum class ValueType { Uint32, Uint64, Float, String };
+struct AllValueTypes : EnumValuesAsTuple<AllValueTypes, ValueType, 4> {
+  static constexpr const char* Names[] = {"uint32", "uint64", "float",
+                                          "string"};
 };
 
 template <class V>
-using Value =
-    std::conditional_t<V() == ValueType::Uint32, uint32_t, std::string>;
+using Value = std::conditional_t<
+    V() == ValueType::Uint32, uint32_t,
+    std::conditional_t<
+        V() == ValueType::Uint64, uint64_t,
+        std::conditional_t<V() == ValueType::Float, float, std::string> > >;
 
 enum class Order {
   Random,
@@ -29,17 +33,29 @@ enum class Order {
   Descending,
   SingleElement,
   PipeOrgan,
-  Heap
+  Heap,
+  FewUnique,
+  SortedRuns,
+  AlmostSorted
 };
-struct AllOrders : EnumValuesAsTuple<AllOrders, Order, 6> {
-  static constexpr const char* Names[] = {"Random",     "Ascending",
-                                          "Descending", "SingleElement",
-                                          "PipeOrgan",  "Heap"};
+struct AllOrders : EnumValuesAsTuple<AllOrders, Order, 9> {
+  static constexpr const char* Names[] = {"Random",       "Ascending",
+                                          "Descending",   "SingleElement",
+                                          "PipeOrgan",    "Heap",
+                                          "FewUnique",    "SortedRuns",
+                                          "AlmostSorted"};
 };
 
-void fillValues(std::vector<uint32_t>& V, size_t N, Order O) {
+// The number of distinct values in Order::FewUnique inputs.
+const size_t FewUniqueValues = 4;
+
+template <class T>
+void fillValues(std::vector<T>& V, size_t N, Order O) {
   if (O == Order::SingleElement) {
     V.resize(N, 0);
+  } else if (O == Order::FewUnique) {
+    while (V.size() < N)
+      V.push_back(V.size() * FewUniqueValues / N);
   } else {
     while (V.size() < N)
       V.push_back(V.size());
@@ -50,6 +66,13 @@ void fillValues(std::vector<std::string>& V, size_t N, Order O) {
 
   if (O == Order::SingleElement) {
     V.resize(N, getRandomString(1024));
+  } else if (O == Order::FewUnique) {
+    std::vector<std::string> Unique;
+    for (size_t I = 0; I < FewUniqueValues; ++I)
+      Unique.push_back(getRandomString(1024));
+    std::sort(Unique.begin(), Unique.end());
+    while (V.size() < N)
+      V.push_back(Unique[V.size() * FewUniqueValues / N]);
   } else {
     while (V.size() < N)
       V.push_back(getRandomString(1024));
@@ -59,13 +82,26 @@ void fillValues(std::vector<std::string>& V, size_t N, Order O) {
 template <class T>
 void sortValues(T& V, Order O) {
   assert(std::is_sorted(V.begin(), V.end()));
+  std::random_device R;
+  std::mt19937 M(R());
   switch (O) {
-  case Order::Random: {
-    std::random_device R;
-    std::mt19937 M(R());
+  case Order::Random:
+  case Order::FewUnique:
+    std::shuffle(V.begin(), V.end(), M);
+    break;
+  case Order::SortedRuns: {
+    // Sixteen ascending runs of random values.
     std::shuffle(V.begin(), V.end(), M);
+    const size_t Run = std::max<size_t>(1, V.size() / 16);
+    for (size_t I = 0; I < V.size(); I += Run)
+      std::sort(V.begin() + I, V.begin() + std::min(I + Run, V.size()));
     break;
   }
+  case Order::AlmostSorted:
+    // About one element in a hundred out of place.
+    for (size_t I = 0; I < V.size() / 100 + 1; ++I)
+      std::swap(V[M() % V.size()], V[M() % V.size()]);
+    break;
   case Order::Ascending:
     std::sort(V.begin(), V.end());
     break;
@@ -248,6 +284,50 @@ struct PopHeap {
   };
 };
 
+// Linear scans over contiguous ranges of integers, with the match or the
+// difference at the very end.
+template <class T>
+void BM_Find(benchmark::State& state) {
+  std::vector<T> V(state.range(0), T(1));
+  V.back() = T(2);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(std::find(V.begin(), V.end(), T(2)));
+}
+BENCHMARK_TEMPLATE(BM_Find, char)->Range(8, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Find, uint16_t)->Range(8, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Find, uint32_t)->Range(8, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Find, uint64_t)->Range(8, 1 << 18);
+
+template <class T>
+void BM_Count(benchmark::State& state) {
+  std::vector<T> V(state.range(0), T(1));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(std::count(V.begin(), V.end(), T(1)));
+}
+BENCHMARK_TEMPLATE(BM_Count, char)->Range(8, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Count, uint32_t)->Range(8, 1 << 18);
+
+template <class T>
+void BM_Mismatch(benchmark::State& state) {
+  std::vector<T> V1(state.range(0), T(1));
+  std::vector<T> V2 = V1;
+  V2.back() = T(2);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(std::mismatch(V1.begin(), V1.end(), V2.begin()));
+}
+BENCHMARK_TEMPLATE(BM_Mismatch, char)->Range(8, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Mismatch, uint32_t)->Range(8, 1 << 18);
+
+template <class T>
+void BM_Equal(benchmark::State& state) {
+  std::vector<T> V1(state.range(0), T(1));
+  std::vector<T> V2 = V1;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(std::equal(V1.begin(), V1.end(), V2.begin()));
+}
+BENCHMARK_TEMPLATE(BM_Equal, char)->Range(8, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Equal, uint32_t)->Range(8, 1 << 18);
+
 } // namespace
 
 int main(int argc, char** argv) {
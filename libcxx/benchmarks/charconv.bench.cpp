@@ -0,0 +1,94 @@
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "GenerateInput.hpp"
+
+// Doubles spread over the whole exponent range, and short decimals like
+// the ones found in text formats.
+static std::vector<double> getRandomDoubles(size_t N) {
+  std::vector<double> inputs;
+  inputs.reserve(N);
+  while (inputs.size() < N) {
+    uint64_t bits = getRandomInteger<uint64_t>();
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    if (d - d == 0)
+      inputs.push_back(d);
+  }
+  return inputs;
+}
+
+static std::vector<double> getShortDecimals(size_t N) {
+  std::vector<double> inputs;
+  inputs.reserve(N);
+  for (size_t i = 0; i < N; ++i)
+    inputs.push_back(getRandomInteger<int>(0, 1000000) / 1000.0);
+  return inputs;
+}
+
+static std::vector<std::string> getStrings(const std::vector<double>& in) {
+  std::vector<std::string> strings;
+  for (double d : in) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", d);
+    strings.push_back(buf);
+  }
+  return strings;
+}
+
+template <std::vector<double> (*Gen)(size_t)>
+static void BM_ToChars(benchmark::State& state) {
+  std::vector<double> in = Gen(1024);
+  char buf[64];
+  while (state.KeepRunning())
+    for (double d : in)
+      benchmark::DoNotOptimize(std::to_chars(buf, buf + sizeof(buf), d).ptr);
+}
+
+template <std::vector<double> (*Gen)(size_t)>
+static void BM_Snprintf(benchmark::State& state) {
+  std::vector<double> in = Gen(1024);
+  char buf[64];
+  while (state.KeepRunning())
+    for (double d : in)
+      benchmark::DoNotOptimize(std::snprintf(buf, sizeof(buf), "%.17g", d));
+}
+
+template <std::vector<double> (*Gen)(size_t)>
+static void BM_FromChars(benchmark::State& state) {
+  std::vector<std::string> in = getStrings(Gen(1024));
+  while (state.KeepRunning())
+    for (const std::string& s : in) {
+      double d;
+      std::from_chars(s.data(), s.data() + s.size(), d);
+      benchmark::DoNotOptimize(d);
+    }
+}
+
+template <std::vector<double> (*Gen)(size_t)>
+static void BM_Strtod(benchmark::State& state) {
+  std::vector<std::string> in = getStrings(Gen(1024));
+  while (state.KeepRunning())
+    for (const std::string& s : in)
+      benchmark::DoNotOptimize(std::strtod(s.c_str(), nullptr));
+}
+
+#if defined(_LIBCPP_VERSION) || defined(__cpp_lib_to_chars)
+BENCHMARK_TEMPLATE(BM_ToChars, getRandomDoubles);
+BENCHMARK_TEMPLATE(BM_ToChars, getShortDecimals);
+BENCHMARK_TEMPLATE(BM_FromChars, getRandomDoubles);
+BENCHMARK_TEMPLATE(BM_FromChars, getShortDecimals);
+#endif
+BENCHMARK_TEMPLATE(BM_Snprintf, getRandomDoubles);
+BENCHMARK_TEMPLATE(BM_Snprintf, getShortDecimals);
+BENCHMARK_TEMPLATE(BM_Strtod, getRandomDoubles);
+BENCHMARK_TEMPLATE(BM_Strtod, getShortDecimals);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <stdexcept>
+
+#include "benchmark/benchmark.h"
+
+// The cost of a throw grows with the number of frames the unwinder has to
+// step through to reach the handler, so these throw from the bottom of a
+// chain of calls of varying depth and catch at the top.
+
+struct Guard {
+  ~Guard() { benchmark::ClobberMemory(); }
+};
+
+__attribute__((noinline)) static int throwAtDepth(int Depth) {
+  if (Depth == 0)
+    throw std::runtime_error("bottom");
+  int Result = throwAtDepth(Depth - 1);
+  // Keeps the recursion from becoming a loop.
+  benchmark::DoNotOptimize(Result);
+  return Result + 1;
+}
+
+// Each frame also has a destructor to run, so phase two of the unwind stops
+// in every one of them on the way to the handler.
+__attribute__((noinline)) static int throwAtDepthWithCleanups(int Depth) {
+  Guard G;
+  if (Depth == 0)
+    throw std::runtime_error("bottom");
+  int Result = throwAtDepthWithCleanups(Depth - 1);
+  benchmark::DoNotOptimize(Result);
+  return Result + 1;
+}
+
+static void BM_ThrowCatch(benchmark::State& st) {
+  const int Depth = st.range(0);
+  for (auto _ : st) {
+    try {
+      benchmark::DoNotOptimize(throwAtDepth(Depth));
+    } catch (const std::exception& E) {
+      benchmark::DoNotOptimize(&E);
+    }
+  }
+}
+BENCHMARK(BM_ThrowCatch)->RangeMultiplier(4)->Range(1, 256);
+
+static void BM_ThrowCatchWithCleanups(benchmark::State& st) {
+  const int Depth = st.range(0);
+  for (auto _ : st) {
+    try {
+      benchmark::DoNotOptimize(throwAtDepthWithCleanups(Depth));
+    } catch (const std::exception& E) {
+      benchmark::DoNotOptimize(&E);
+    }
+  }
+}
+BENCHMARK(BM_ThrowCatchWithCleanups)->RangeMultiplier(4)->Range(1, 256);
+
+// Several threads throwing at once, which contend for whatever the unwinder
+// shares between them.
+static void BM_ThrowCatchThreaded(benchmark::State& st) {
+  for (auto _ : st) {
+    try {
+      benchmark::DoNotOptimize(throwAtDepth(16));
+    } catch (const std::exception& E) {
+      benchmark::DoNotOptimize(&E);
+    }
+  }
+}
+BENCHMARK(BM_ThrowCatchThreaded)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
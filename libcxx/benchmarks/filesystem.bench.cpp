@@ -3,6 +3,9 @@
 #include "test_iterators.h"
 #include "filesystem_include.hpp"
 
+#include <cstdio>
+#include <string>
+
 static const size_t TestNumInputs = 1024;
 
 
@@ -160,4 +163,44 @@ BENCHMARK_CAPTURE(BM_LexicallyNormal, small_path,
 BENCHMARK_CAPTURE(BM_LexicallyNormal, large_path,
   getRandomPaths, /*PathLen*/32)->RangeMultiplier(2)->Range(2, 256)->Complexity();
 
+// Creates a directory tree of NumDirs directories, each holding
+// FilesPerDir empty files, under a fresh temporary directory.
+struct TemporaryTree {
+  fs::path Root;
+
+  TemporaryTree(int NumDirs, int FilesPerDir) {
+    Root = fs::temp_directory_path() / ("bench-" + getRandomString(16));
+    for (int D = 0; D < NumDirs; ++D) {
+      fs::path Dir = Root / ("dir" + std::to_string(D));
+      fs::create_directories(Dir);
+      for (int F = 0; F < FilesPerDir; ++F)
+        std::fclose(
+            std::fopen((Dir / ("file" + std::to_string(F))).c_str(), "w"));
+    }
+  }
+  ~TemporaryTree() { fs::remove_all(Root); }
+};
+
+void BM_DirectoryIterate(benchmark::State &st) {
+  TemporaryTree Tree(1, st.range(0));
+  const fs::path Dir = Tree.Root / "dir0";
+  while (st.KeepRunning()) {
+    for (const fs::directory_entry &E : fs::directory_iterator(Dir))
+      benchmark::DoNotOptimize(E.is_regular_file());
+  }
+  st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK(BM_DirectoryIterate)->Range(64, 16384);
+
+void BM_RecursiveDirectoryIterate(benchmark::State &st) {
+  TemporaryTree Tree(st.range(0), 256);
+  while (st.KeepRunning()) {
+    for (const fs::directory_entry &E :
+         fs::recursive_directory_iterator(Tree.Root))
+      benchmark::DoNotOptimize(E.path().native().data());
+  }
+  st.SetItemsProcessed(st.iterations() * st.range(0) * (256 + 1));
+}
+BENCHMARK(BM_RecursiveDirectoryIterate)->Range(8, 256);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <map>
+#include <memory_resource>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+// Each benchmark builds and tears down a container per iteration, once with
+// std::allocator and once per pmr resource.  The resources live across
+// iterations the way a long-lived arena would, except the monotonic one,
+// which is released every time around.
+
+enum class Resource { NewDelete, Monotonic, Unsynchronized, Synchronized };
+
+template <class Fn>
+void withResource(benchmark::State& st, Resource R, Fn F) {
+  switch (R) {
+  case Resource::NewDelete:
+    for (auto _ : st)
+      F(std::pmr::new_delete_resource());
+    break;
+  case Resource::Monotonic: {
+    std::pmr::monotonic_buffer_resource Res;
+    for (auto _ : st) {
+      F(&Res);
+      Res.release();
+    }
+    break;
+  }
+  case Resource::Unsynchronized: {
+    std::pmr::unsynchronized_pool_resource Res;
+    for (auto _ : st)
+      F(&Res);
+    break;
+  }
+  case Resource::Synchronized: {
+    static std::pmr::synchronized_pool_resource Res;
+    for (auto _ : st)
+      F(&Res);
+    break;
+  }
+  }
+}
+
+static void BM_VectorPushBack_StdAllocator(benchmark::State& st) {
+  const int N = st.range(0);
+  for (auto _ : st) {
+    std::vector<int> V;
+    for (int I = 0; I != N; ++I)
+      V.push_back(I);
+    benchmark::DoNotOptimize(V.data());
+  }
+}
+BENCHMARK(BM_VectorPushBack_StdAllocator)->Range(8, 1 << 14);
+
+static void BM_VectorPushBack_Pmr(benchmark::State& st, Resource R) {
+  const int N = st.range(0);
+  withResource(st, R, [N](std::pmr::memory_resource* Res) {
+    std::pmr::vector<int> V(Res);
+    for (int I = 0; I != N; ++I)
+      V.push_back(I);
+    benchmark::DoNotOptimize(V.data());
+  });
+}
+BENCHMARK_CAPTURE(BM_VectorPushBack_Pmr, new_delete, Resource::NewDelete)
+    ->Range(8, 1 << 14);
+BENCHMARK_CAPTURE(BM_VectorPushBack_Pmr, monotonic, Resource::Monotonic)
+    ->Range(8, 1 << 14);
+BENCHMARK_CAPTURE(BM_VectorPushBack_Pmr, unsynchronized_pool,
+                  Resource::Unsynchronized)
+    ->Range(8, 1 << 14);
+BENCHMARK_CAPTURE(BM_VectorPushBack_Pmr, synchronized_pool,
+                  Resource::Synchronized)
+    ->Range(8, 1 << 14);
+
+// Node containers make one small allocation per element, which is where the
+// pools and the monotonic resource pay off.
+static void BM_MapInsert_StdAllocator(benchmark::State& st) {
+  const int N = st.range(0);
+  for (auto _ : st) {
+    std::map<int, int> M;
+    for (int I = 0; I != N; ++I)
+      M.emplace(I * 7919 % N, I);
+    benchmark::DoNotOptimize(&M);
+  }
+}
+BENCHMARK(BM_MapInsert_StdAllocator)->Range(8, 1 << 14);
+
+static void BM_MapInsert_Pmr(benchmark::State& st, Resource R) {
+  const int N = st.range(0);
+  withResource(st, R, [N](std::pmr::memory_resource* Res) {
+    std::pmr::map<int, int> M(Res);
+    for (int I = 0; I != N; ++I)
+      M.emplace(I * 7919 % N, I);
+    benchmark::DoNotOptimize(&M);
+  });
+}
+BENCHMARK_CAPTURE(BM_MapInsert_Pmr, new_delete, Resource::NewDelete)
+    ->Range(8, 1 << 14);
+BENCHMARK_CAPTURE(BM_MapInsert_Pmr, monotonic, Resource::Monotonic)
+    ->Range(8, 1 << 14);
+BENCHMARK_CAPTURE(BM_MapInsert_Pmr, unsynchronized_pool,
+                  Resource::Unsynchronized)
+    ->Range(8, 1 << 14);
+BENCHMARK_CAPTURE(BM_MapInsert_Pmr, synchronized_pool, Resource::Synchronized)
+    ->Range(8, 1 << 14);
+
+// Several threads churning nodes through one synchronized pool, against the
+// same work on the global heap.
+static std::pmr::synchronized_pool_resource SharedPool;
+
+static void BM_MapChurnThreaded_StdAllocator(benchmark::State& st) {
+  for (auto _ : st) {
+    std::map<int, int> M;
+    for (int I = 0; I != 256; ++I)
+      M.emplace(I, I);
+    benchmark::DoNotOptimize(&M);
+  }
+}
+BENCHMARK(BM_MapChurnThreaded_StdAllocator)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_MapChurnThreaded_SynchronizedPool(benchmark::State& st) {
+  for (auto _ : st) {
+    std::pmr::map<int, int> M(&SharedPool);
+    for (int I = 0; I != 256; ++I)
+      M.emplace(I, I);
+    benchmark::DoNotOptimize(&M);
+  }
+}
+BENCHMARK(BM_MapChurnThreaded_SynchronizedPool)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <cstdint>
 #include <new>
 #include <vector>
@@ -49,6 +50,23 @@ static void BM_StringFindMatch2(benchmark::State &state) {
 }
 BENCHMARK(BM_StringFindMatch2)->Range(1, MAX_STRING_LEN / 4);
 
+// Benchmark std::count and std::mismatch over the characters of a string.
+static void BM_StringCountChar(benchmark::State &state) {
+  std::string s1(state.range(0), '-');
+  for (auto _ : state)
+    benchmark::DoNotOptimize(std::count(s1.begin(), s1.end(), '-'));
+}
+BENCHMARK(BM_StringCountChar)->Range(8, MAX_STRING_LEN);
+
+static void BM_StringMismatch(benchmark::State &state) {
+  std::string s1(state.range(0), '-');
+  std::string s2 = s1;
+  s2.back() = '*';
+  for (auto _ : state)
+    benchmark::DoNotOptimize(std::mismatch(s1.begin(), s1.end(), s2.begin()));
+}
+BENCHMARK(BM_StringMismatch)->Range(8, MAX_STRING_LEN);
+
 static void BM_StringCtorDefault(benchmark::State &state) {
   for (auto _ : state) {
     std::string Default;
@@ -37,4 +37,57 @@ static void BM_Istream_numbers(benchmark::State &state) {
 }
 
 BENCHMARK(BM_Istream_numbers)->RangeMultiplier(2)->Range(1024, 4096);
+
+// Writes the same numbers the way a logging line would, reusing the stream.
+static void BM_Ostream_integers(benchmark::State &state) {
+  std::ostringstream s;
+  int i = 0;
+  while (state.KeepRunning()) {
+    s.str(std::string());
+    for (int j = 0; j < 10; ++j)
+      s << -6 << ' ' << i++ << ' ' << 5000000L << ' ' << 123456789012ULL << '\n';
+    benchmark::DoNotOptimize(s.str().data());
+  }
+}
+BENCHMARK(BM_Ostream_integers);
+
+static void BM_Ostream_hex(benchmark::State &state) {
+  std::ostringstream s;
+  s << std::hex << std::showbase;
+  unsigned i = 0;
+  while (state.KeepRunning()) {
+    s.str(std::string());
+    for (int j = 0; j < 10; ++j)
+      s << i++ << ' ' << 0xdeadbeefUL << '\n';
+    benchmark::DoNotOptimize(s.str().data());
+  }
+}
+BENCHMARK(BM_Ostream_hex);
+
+// Values with few significant digits, printed with the default precision.
+static void BM_Ostream_doubles_short(benchmark::State &state) {
+  std::ostringstream s;
+  const double a[] = {0.5, 2.25, -100.0, 1e-3, 6.02e23, 3.14159, 42.0, 0.0};
+  while (state.KeepRunning()) {
+    s.str(std::string());
+    for (double d : a)
+      s << d << ' ';
+    benchmark::DoNotOptimize(s.str().data());
+  }
+}
+BENCHMARK(BM_Ostream_doubles_short);
+
+// Values that need rounding to the precision.
+static void BM_Ostream_doubles_rounded(benchmark::State &state) {
+  std::ostringstream s;
+  const double a[] = {1.0 / 3, 2.0 / 3, -1e10 / 7, 0.1 + 0.2};
+  while (state.KeepRunning()) {
+    s.str(std::string());
+    for (double d : a)
+      s << d << ' ';
+    benchmark::DoNotOptimize(s.str().data());
+  }
+}
+BENCHMARK(BM_Ostream_doubles_rounded);
+
 BENCHMARK_MAIN();
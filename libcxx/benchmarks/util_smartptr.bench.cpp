@@ -6,9 +6,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <memory>
 
 #include "benchmark/benchmark.h"
+#include "test_macros.h"
 
 static void BM_SharedPtrCreateDestroy(benchmark::State& st) {
   while (st.KeepRunning()) {
@@ -38,4 +40,53 @@ static void BM_WeakPtrIncDecRef(benchmark::State& st) {
 }
 BENCHMARK(BM_WeakPtrIncDecRef);
 
+// Every thread reads a shared_ptr that one of them replaces now and then.
+// The free functions take one of the striped locks, so readers of the same
+// value serialize on it.
+static std::shared_ptr<int> GlobalPtr = std::make_shared<int>(42);
+
+static void BM_AtomicLoadFreeFunction(benchmark::State& st) {
+  int I = 0;
+  for (auto _ : st) {
+    if (st.thread_index == 0 && ++I % 64 == 0)
+      std::atomic_store(&GlobalPtr, std::make_shared<int>(I));
+    auto sp = std::atomic_load(&GlobalPtr);
+    benchmark::DoNotOptimize(sp.get());
+  }
+}
+BENCHMARK(BM_AtomicLoadFreeFunction)->ThreadRange(1, 8)->UseRealTime();
+
+// Unrelated shared_ptrs, one per thread, that may still share a lock.
+static void BM_AtomicLoadFreeFunctionDistinct(benchmark::State& st) {
+  auto sp = std::make_shared<int>(42);
+  for (auto _ : st) {
+    auto sp2 = std::atomic_load(&sp);
+    benchmark::DoNotOptimize(sp2.get());
+  }
+}
+BENCHMARK(BM_AtomicLoadFreeFunctionDistinct)->ThreadRange(1, 8)->UseRealTime();
+
+#if TEST_STD_VER > 17
+static std::atomic<std::shared_ptr<int> > GlobalAtomicPtr(
+    std::make_shared<int>(42));
+
+static void BM_AtomicSharedPtrLoad(benchmark::State& st) {
+  int I = 0;
+  for (auto _ : st) {
+    if (st.thread_index == 0 && ++I % 64 == 0)
+      GlobalAtomicPtr.store(std::make_shared<int>(I));
+    auto sp = GlobalAtomicPtr.load();
+    benchmark::DoNotOptimize(sp.get());
+  }
+}
+BENCHMARK(BM_AtomicSharedPtrLoad)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_AtomicSharedPtrStore(benchmark::State& st) {
+  auto sp = std::make_shared<int>(42);
+  for (auto _ : st)
+    GlobalAtomicPtr.store(sp);
+}
+BENCHMARK(BM_AtomicSharedPtrStore)->ThreadRange(1, 8)->UseRealTime();
+#endif
+
 BENCHMARK_MAIN();
@@ -7,8 +7,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "charconv"
+#include <float.h>
 #include <string.h>
 
+#include "include/charconv_tables.h"
+
 _LIBCPP_BEGIN_NAMESPACE_STD
 
 namespace __itoa
@@ -173,25 +176,7 @@ __u64toa(uint64_t value, char* buffer)
         const uint32_t v0 = static_cast<uint32_t>(value / 100000000);
         const uint32_t v1 = static_cast<uint32_t>(value % 100000000);
 
-        const uint32_t b0 = v0 / 10000;
-        const uint32_t c0 = v0 % 10000;
-
-        if (v0 < 1000000)
-        {
-            if (v0 < 100000)
-                buffer = append1(buffer, b0);
-            else
-                buffer = append2(buffer, b0);
-        }
-        else
-        {
-            if (v0 < 10000000)
-                buffer = append3(buffer, b0);
-            else
-                buffer = append4(buffer, b0);
-        }
-
-        buffer = append4(buffer, c0);
+        buffer = __u32toa(v0, buffer);
         buffer = append4(buffer, v1 / 10000);
         buffer = append4(buffer, v1 % 10000);
     }
@@ -229,4 +214,1081 @@ __u64toa(uint64_t value, char* buffer)
 
 }  // namespace __itoa
 
+namespace __floating_point
+{
+
+template <class _Tp>
+struct float_traits;
+
+template <>
+struct float_traits<float>
+{
+    using bits_type = uint32_t;
+    static constexpr int mantissaBits = 23;
+    static constexpr int exponentBits = 8;
+    static constexpr int bias = 127;
+    // Largest power of ten that is exact, and the range of exponents outside
+    // which any 19 digit decimal is zero or infinity.
+    static constexpr int maxExactPow10 = 10;
+    static constexpr int minPow10 = -65;
+    static constexpr int maxPow10 = 38;
+    // Exponents for which w * 10^q can be halfway between two floats.
+    static constexpr int minRoundToEven = -17;
+    static constexpr int maxRoundToEven = 10;
+};
+
+template <>
+struct float_traits<double>
+{
+    using bits_type = uint64_t;
+    static constexpr int mantissaBits = 52;
+    static constexpr int exponentBits = 11;
+    static constexpr int bias = 1023;
+    static constexpr int maxExactPow10 = 22;
+    static constexpr int minPow10 = -342;
+    static constexpr int maxPow10 = 308;
+    static constexpr int minRoundToEven = -4;
+    static constexpr int maxRoundToEven = 23;
+};
+
+template <class _Tp>
+inline _LIBCPP_INLINE_VISIBILITY uint64_t
+toBits(_Tp value)
+{
+    typename float_traits<_Tp>::bits_type bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+template <class _Tp>
+inline _LIBCPP_INLINE_VISIBILITY _Tp
+fromBits(uint64_t bits, bool negative)
+{
+    using traits = float_traits<_Tp>;
+    typename traits::bits_type b = static_cast<typename traits::bits_type>(
+        bits | (uint64_t(negative) << (traits::mantissaBits +
+                                       traits::exponentBits)));
+    _Tp value;
+    memcpy(&value, &b, sizeof(b));
+    return value;
+}
+
+template <class _Tp>
+inline _LIBCPP_INLINE_VISIBILITY uint64_t
+infinityBits()
+{
+    using traits = float_traits<_Tp>;
+    return ((uint64_t(1) << traits::exponentBits) - 1) << traits::mantissaBits;
+}
+
+inline _LIBCPP_INLINE_VISIBILITY int
+countLeadingZeros(uint64_t value)
+{
+#if !defined(_LIBCPP_COMPILER_MSVC)
+    return __builtin_clzll(value);
+#else
+    int n = 0;
+    for (; !(value & (uint64_t(1) << 63)); value <<= 1)
+        ++n;
+    return n;
+#endif
+}
+
+// Returns the low half of a * b and stores the high half in hi.
+inline _LIBCPP_INLINE_VISIBILITY uint64_t
+mul128(uint64_t a, uint64_t b, uint64_t& hi)
+{
+#ifndef _LIBCPP_HAS_NO_INT128
+    const __uint128_t product = static_cast<__uint128_t>(a) * b;
+    hi = static_cast<uint64_t>(product >> 64);
+    return static_cast<uint64_t>(product);
+#else
+    const uint64_t aLo = static_cast<uint32_t>(a), aHi = a >> 32;
+    const uint64_t bLo = static_cast<uint32_t>(b), bHi = b >> 32;
+    const uint64_t b00 = aLo * bLo, b01 = aLo * bHi;
+    const uint64_t b10 = aHi * bLo, b11 = aHi * bHi;
+    const uint64_t mid1 = b10 + (b00 >> 32);
+    const uint64_t mid2 = b01 + static_cast<uint32_t>(mid1);
+    hi = b11 + (mid1 >> 32) + (mid2 >> 32);
+    return (mid2 << 32) | static_cast<uint32_t>(b00);
+#endif
+}
+
+// Shortest round-trip digits, after Ulf Adams, "Ryu: fast float-to-string
+// conversion", PLDI 2018. The double tables are precise enough for floats
+// too, so both types share this implementation.
+
+struct decimalFloat
+{
+    uint64_t mantissa;
+    int32_t exponent;  // value = mantissa * 10^exponent
+};
+
+inline _LIBCPP_INLINE_VISIBILITY int32_t
+pow5bits(int32_t e)
+{
+    // ceil(log2(5^e)), or 1 for e == 0.
+    return ((e * 1217359) >> 19) + 1;
+}
+
+inline _LIBCPP_INLINE_VISIBILITY int32_t
+log10Pow2(int32_t e)
+{
+    return (e * 78913) >> 18;
+}
+
+inline _LIBCPP_INLINE_VISIBILITY int32_t
+log10Pow5(int32_t e)
+{
+    return (e * 732923) >> 20;
+}
+
+inline _LIBCPP_INLINE_VISIBILITY bool
+multipleOfPowerOf5(uint64_t value, int32_t p)
+{
+    int32_t count = 0;
+    for (; value % 5 == 0; value /= 5)
+        ++count;
+    return count >= p;
+}
+
+inline _LIBCPP_INLINE_VISIBILITY bool
+multipleOfPowerOf2(uint64_t value, int32_t p)
+{
+    return (value & ((uint64_t(1) << p) - 1)) == 0;
+}
+
+// (m * mul) >> j for a 125 bit mul and 64 < j < 128.
+inline _LIBCPP_INLINE_VISIBILITY uint64_t
+mulShift(uint64_t m, const uint64_t* mul, int32_t j)
+{
+    uint64_t high0, high1;
+    mul128(m, mul[0], high0);
+    const uint64_t low1 = mul128(m, mul[1], high1);
+    const uint64_t sum = high0 + low1;
+    if (sum < high0)
+        ++high1;
+    const int32_t dist = j - 64;
+    return (high1 << (64 - dist)) | (sum >> dist);
+}
+
+template <class _Tp>
+decimalFloat
+shortestDecimal(uint64_t ieeeMantissa, uint32_t ieeeExponent)
+{
+    using traits = float_traits<_Tp>;
+    int32_t e2;
+    uint64_t m2;
+    if (ieeeExponent == 0)
+    {
+        e2 = 1 - traits::bias - traits::mantissaBits - 2;
+        m2 = ieeeMantissa;
+    }
+    else
+    {
+        e2 = static_cast<int32_t>(ieeeExponent) - traits::bias -
+             traits::mantissaBits - 2;
+        m2 = (uint64_t(1) << traits::mantissaBits) | ieeeMantissa;
+    }
+    const bool acceptBounds = (m2 & 1) == 0;
+
+    // The interval of values rounding to m2 * 2^e2 is (mm, mp) * 2^e2, the
+    // bounds being included with an even mantissa.
+    const uint64_t mv = 4 * m2;
+    // The lower bound is closer when m2 is a power of two.
+    const uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+
+    // Scale the bounds by a power of ten, vr = mv * 2^e2 / 10^e10 etc, and
+    // track whether digits removed from vm and vr are all zero.
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool vmIsTrailingZeros = false;
+    bool vrIsTrailingZeros = false;
+    if (e2 >= 0)
+    {
+        const int32_t q = log10Pow2(e2) - (e2 > 3);
+        e10 = q;
+        const int32_t k = 125 + pow5bits(q) - 1;
+        const int32_t i = -e2 + q + k;
+        vr = mulShift(4 * m2, pow5InvSplit[q], i);
+        vp = mulShift(4 * m2 + 2, pow5InvSplit[q], i);
+        vm = mulShift(4 * m2 - 1 - mmShift, pow5InvSplit[q], i);
+        if (q <= 21)
+        {
+            // Only one of mp, mv and mm can be a multiple of 5, if any.
+            if (mv % 5 == 0)
+                vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            else if (acceptBounds)
+                vmIsTrailingZeros = multipleOfPowerOf5(mv - 1 - mmShift, q);
+            else
+                vp -= multipleOfPowerOf5(mv + 2, q);
+        }
+    }
+    else
+    {
+        const int32_t q = log10Pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        const int32_t i = -e2 - q;
+        const int32_t k = pow5bits(i) - 125;
+        const int32_t j = q - k;
+        vr = mulShift(4 * m2, pow5Split[i], j);
+        vp = mulShift(4 * m2 + 2, pow5Split[i], j);
+        vm = mulShift(4 * m2 - 1 - mmShift, pow5Split[i], j);
+        if (q <= 1)
+        {
+            // mv = 4 * m2 always has at least two trailing zero bits, and
+            // mm = mv - 1 - mmShift has one iff mmShift == 1.
+            vrIsTrailingZeros = true;
+            if (acceptBounds)
+                vmIsTrailingZeros = mmShift == 1;
+            else
+                --vp;
+        }
+        else if (q < 63)
+        {
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+        }
+    }
+
+    // Remove digits while the bounds still differ, rounding vr.
+    int32_t removed = 0;
+    uint64_t output;
+    if (vmIsTrailingZeros || vrIsTrailingZeros)
+    {
+        uint32_t lastRemovedDigit = 0;
+        for (; vp / 10 > vm / 10; ++removed)
+        {
+            vmIsTrailingZeros &= vm % 10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = static_cast<uint32_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+        }
+        if (vmIsTrailingZeros)
+        {
+            for (; vm % 10 == 0; ++removed)
+            {
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = static_cast<uint32_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+            }
+        }
+        // Round half to even if the exact value is ...50..0.
+        if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+            lastRemovedDigit = 4;
+        output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) ||
+                       lastRemovedDigit >= 5);
+    }
+    else
+    {
+        // The common case, the bounds are exclusive and vr inexact.
+        bool roundUp = false;
+        for (; vp / 10 > vm / 10; ++removed)
+        {
+            roundUp = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+        }
+        output = vr + (vr == vm || roundUp);
+    }
+    return {output, e10 + removed};
+}
+
+// Writes the integer m2 * 2^e2.
+char*
+writeInteger(uint64_t m2, int32_t e2, char* buffer)
+{
+    if (e2 <= 0)
+        return __itoa::__u64toa(m2 >> -e2, buffer);
+
+    // Base 2^32 limbs, least significant first, of a number up to DBL_MAX.
+    uint32_t limbs[35] = {};
+    const int word = e2 / 32;
+    const int bit = e2 % 32;
+    limbs[word] = static_cast<uint32_t>(m2 << bit);
+    limbs[word + 1] = static_cast<uint32_t>(bit ? m2 >> (32 - bit) : m2 >> 32);
+    limbs[word + 2] = static_cast<uint32_t>(bit ? m2 >> (64 - bit) : 0);
+    int n = word + 3;
+
+    // Its base 10^9 digits, least significant first.
+    uint32_t chunks[35];
+    int nchunks = 0;
+    while (n > 0)
+    {
+        uint64_t remainder = 0;
+        for (int i = n - 1; i >= 0; --i)
+        {
+            const uint64_t current = (remainder << 32) | limbs[i];
+            limbs[i] = static_cast<uint32_t>(current / 1000000000);
+            remainder = current % 1000000000;
+        }
+        chunks[nchunks++] = static_cast<uint32_t>(remainder);
+        while (n > 0 && limbs[n - 1] == 0)
+            --n;
+    }
+
+    buffer = __itoa::__u32toa(chunks[--nchunks], buffer);
+    while (nchunks > 0)
+    {
+        const uint32_t chunk = chunks[--nchunks];
+        char digits[10];
+        const char* end = __itoa::__u32toa(chunk + 1000000000, digits);
+        memcpy(buffer, end - 9, 9);
+        buffer += 9;
+    }
+    return buffer;
+}
+
+inline _LIBCPP_INLINE_VISIBILITY to_chars_result
+writeString(char* first, char* last, const char* s, size_t n)
+{
+    if (static_cast<size_t>(last - first) < n)
+        return {last, errc::value_too_large};
+    memcpy(first, s, n);
+    return {first + n, errc{}};
+}
+
+template <class _Tp>
+to_chars_result
+writeHex(char* first, char* last, uint64_t ieeeMantissa, uint32_t ieeeExponent)
+{
+    using traits = float_traits<_Tp>;
+    // The mantissa padded to whole hex digits.
+    const int digits = (traits::mantissaBits + 3) / 4;
+    uint64_t mantissa = ieeeMantissa << (4 * digits - traits::mantissaBits);
+    int exponent = ieeeExponent ? static_cast<int>(ieeeExponent) - traits::bias
+                                : 1 - traits::bias;
+    if (ieeeExponent == 0 && ieeeMantissa == 0)
+        exponent = 0;
+
+    char buffer[32];
+    char* p = buffer;
+    *p++ = ieeeExponent ? '1' : '0';
+    if (mantissa != 0)
+    {
+        *p++ = '.';
+        for (int shift = 4 * digits - 4; mantissa != 0; shift -= 4)
+        {
+            *p++ = "0123456789abcdef"[mantissa >> shift];
+            mantissa &= (uint64_t(1) << shift) - 1;
+        }
+    }
+    *p++ = 'p';
+    *p++ = exponent < 0 ? '-' : '+';
+    p = __itoa::__u32toa(static_cast<uint32_t>(exponent < 0 ? -exponent
+                                                            : exponent),
+                         p);
+    return writeString(first, last, buffer, p - buffer);
+}
+
+// Implements the overloads taking no precision. Plain picks the shorter of
+// fixed and scientific, preferring fixed.
+template <class _Tp>
+to_chars_result
+toCharsShortest(char* first, char* last, _Tp value, chars_format fmt,
+                bool plain)
+{
+    using traits = float_traits<_Tp>;
+    const uint64_t bits = toBits(value);
+    const uint64_t ieeeMantissa =
+        bits & ((uint64_t(1) << traits::mantissaBits) - 1);
+    const uint32_t ieeeExponent = static_cast<uint32_t>(
+        (bits >> traits::mantissaBits) &
+        ((uint32_t(1) << traits::exponentBits) - 1));
+
+    if (bits >> (traits::mantissaBits + traits::exponentBits))
+    {
+        if (first == last)
+            return {last, errc::value_too_large};
+        *first++ = '-';
+    }
+    if (ieeeExponent == (uint32_t(1) << traits::exponentBits) - 1)
+    {
+        if (ieeeMantissa)
+            return writeString(first, last, "nan", 3);
+        return writeString(first, last, "inf", 3);
+    }
+    if (!plain && fmt == chars_format::hex)
+        return writeHex<_Tp>(first, last, ieeeMantissa, ieeeExponent);
+
+    decimalFloat d = {0, 0};
+    if (ieeeExponent != 0 || ieeeMantissa != 0)
+        d = shortestDecimal<_Tp>(ieeeMantissa, ieeeExponent);
+
+    char digits[20];
+    const int olength =
+        static_cast<int>(__itoa::__u64toa(d.mantissa, digits) - digits);
+    // The exponent of the leading digit.
+    const int x = d.exponent + olength - 1;
+
+    bool fixed;
+    if (plain)
+    {
+        int fixedLength = d.exponent >= 0 ? olength + d.exponent
+                          : x >= 0        ? olength + 1
+                                          : olength + 1 - x;
+        int scientificLength =
+            olength + (olength > 1) + (x <= -100 || x >= 100 ? 5 : 4);
+        fixed = fixedLength <= scientificLength;
+    }
+    else if (fmt == chars_format::general)
+    {
+        // As printf's %g without a precision, which uses fixed notation for
+        // exponents in [-4, 6).
+        fixed = -4 <= x && x < 6;
+    }
+    else
+        fixed = fmt == chars_format::fixed;
+
+    char* p = first;
+    if (!fixed)
+    {
+        // d[.ddd]e+xx
+        const int length = olength + (olength > 1) + (x <= -100 || x >= 100
+                                                          ? 5
+                                                          : 4);
+        if (last - p < length)
+            return {last, errc::value_too_large};
+        *p++ = digits[0];
+        if (olength > 1)
+        {
+            *p++ = '.';
+            memcpy(p, digits + 1, olength - 1);
+            p += olength - 1;
+        }
+        *p++ = 'e';
+        *p++ = x < 0 ? '-' : '+';
+        const int absX = x < 0 ? -x : x;
+        if (absX < 10)
+            *p++ = '0';
+        return {__itoa::__u32toa(static_cast<uint32_t>(absX), p), errc{}};
+    }
+
+    if (d.exponent > 0)
+    {
+        // An integer that has more digits than the shortest representation.
+        // The standard asks for the representation closest to the value
+        // among the shortest, which is then the exact value.
+        const int32_t e2 =
+            (ieeeExponent ? static_cast<int32_t>(ieeeExponent) : 1) -
+            traits::bias - traits::mantissaBits;
+        const uint64_t m2 = ieeeMantissa | (uint64_t(ieeeExponent != 0)
+                                            << traits::mantissaBits);
+        char buffer[320];
+        return writeString(first, last, buffer,
+                           writeInteger(m2, e2, buffer) - buffer);
+    }
+    if (d.exponent == 0)
+        return writeString(first, last, digits, olength);
+    if (x >= 0)
+    {
+        // ddd.ddd
+        if (last - p < olength + 1)
+            return {last, errc::value_too_large};
+        memcpy(p, digits, x + 1);
+        p += x + 1;
+        *p++ = '.';
+        memcpy(p, digits + x + 1, olength - x - 1);
+        return {p + olength - x - 1, errc{}};
+    }
+    // 0.000ddd
+    if (last - p < olength + 1 - x)
+        return {last, errc::value_too_large};
+    *p++ = '0';
+    *p++ = '.';
+    memset(p, '0', -x - 1);
+    p += -x - 1;
+    memcpy(p, digits, olength);
+    return {p + olength, errc{}};
+}
+
+// Correctly rounded parsing.
+
+inline _LIBCPP_INLINE_VISIBILITY bool
+isDigit(char c)
+{
+    return static_cast<unsigned>(c - '0') < 10;
+}
+
+inline _LIBCPP_INLINE_VISIBILITY int
+hexDigit(char c)
+{
+    if (isDigit(c))
+        return c - '0';
+    const unsigned lower = static_cast<unsigned>((c | 0x20) - 'a');
+    return lower < 6 ? static_cast<int>(lower) + 10 : -1;
+}
+
+inline _LIBCPP_INLINE_VISIBILITY bool
+startsWithIgnoringCase(const char* first, const char* last, const char* s)
+{
+    for (; *s; ++first, ++s)
+        if (first == last || (*first | 0x20) != *s)
+            return false;
+    return true;
+}
+
+// The value is exact if it fits the mantissa, and so is a power of ten up
+// to maxExactPow10, then multiplying or dividing rounds correctly. This
+// needs the arithmetic to happen in the precision of _Tp.
+template <class _Tp>
+inline _LIBCPP_INLINE_VISIBILITY bool
+clingerFastPath(uint64_t w, int64_t q, _Tp& value)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    using traits = float_traits<_Tp>;
+    static const _Tp powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                 1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                 1e18, 1e19, 1e20, 1e21, 1e22};
+    if (w > (uint64_t(1) << (traits::mantissaBits + 1)) ||
+        q < -traits::maxExactPow10 || q > traits::maxExactPow10)
+        return false;
+    value = static_cast<_Tp>(w);
+    if (q < 0)
+        value /= powers[-q];
+    else
+        value *= powers[q];
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Rounds w * 10^q for a nonzero w to the bits of the nearest _Tp, after
+// Daniel Lemire, "Number Parsing at a Gigabyte per Second", 2021. Returns
+// false in the rare cases where 128 bits of 5^q are not enough to decide.
+template <class _Tp>
+bool
+eiselLemire(uint64_t w, int64_t q, uint64_t& bits)
+{
+    using traits = float_traits<_Tp>;
+    const int mantissaBits = traits::mantissaBits;
+    if (q < traits::minPow10)
+    {
+        bits = 0;
+        return true;
+    }
+    if (q > traits::maxPow10)
+    {
+        bits = infinityBits<_Tp>();
+        return true;
+    }
+
+    const int lz = countLeadingZeros(w);
+    w <<= lz;
+    const uint64_t* pow5 = pow5Approx128[q + 342];
+    uint64_t high;
+    uint64_t low = mul128(w, pow5[0], high);
+    // Only compute the low part of 5^q in if the bits we need may change.
+    const uint64_t precisionMask = ~uint64_t(0) >> (mantissaBits + 3);
+    if ((high & precisionMask) == precisionMask)
+    {
+        uint64_t high2;
+        mul128(w, pow5[1], high2);
+        low += high2;
+        if (high2 > low)
+            ++high;
+    }
+    // Outside of these exponents, 5^q does not fit the 128 bits.
+    if (low == ~uint64_t(0) && (q < -27 || q > 55))
+        return false;
+
+    const int upperBit = static_cast<int>(high >> 63);
+    const int shift = upperBit + 64 - mantissaBits - 3;
+    uint64_t mantissa = high >> shift;
+    // floor(log2(10^q)) + 63 is ((217706 * q) >> 16) + 63.
+    int32_t power2 = ((217706 * static_cast<int32_t>(q)) >> 16) + 63 +
+                     upperBit - lz + traits::bias;
+
+    if (power2 <= 0)
+    {
+        // Subnormal. Exact halfway cases can't happen at these exponents.
+        if (-power2 + 1 >= 64)
+        {
+            bits = 0;
+            return true;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        // Rounding may have made it the smallest normal number, whose bits
+        // are then just right.
+        bits = mantissa;
+        return true;
+    }
+
+    // With an exactly halfway value, round to even rather than up.
+    if (low <= 1 && q >= traits::minRoundToEven &&
+        q <= traits::maxRoundToEven && (mantissa & 3) == 1 &&
+        (mantissa << shift) == high)
+        mantissa &= ~uint64_t(1);
+
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (uint64_t(2) << mantissaBits))
+    {
+        mantissa = uint64_t(1) << mantissaBits;
+        ++power2;
+    }
+    mantissa &= ~(uint64_t(1) << mantissaBits);
+    if (power2 >= (1 << traits::exponentBits) - 1)
+    {
+        bits = infinityBits<_Tp>();
+        return true;
+    }
+    bits = (static_cast<uint64_t>(power2) << mantissaBits) | mantissa;
+    return true;
+}
+
+// An arbitrary precision decimal 0.d0d1d2... * 10^dp that can be shifted by
+// powers of two, the slow but always correct fallback. Digits beyond
+// maxDigits can't affect the rounding other than by being nonzero.
+class bigDecimal
+{
+public:
+    static constexpr int maxDigits = 800;
+
+    void append(int digit)
+    {
+        if (nd < maxDigits)
+            d[nd++] = static_cast<unsigned char>(digit);
+        else if (digit != 0)
+            trunc = true;
+    }
+
+    void setDecimalPoint(int64_t point)
+    {
+        dp = static_cast<int>(
+            point < -100000 ? -100000 : point > 100000 ? 100000 : point);
+        trim();
+    }
+
+    template <class _Tp>
+    uint64_t toBits()
+    {
+        using traits = float_traits<_Tp>;
+        const int mantissaBits = traits::mantissaBits;
+        const int maxExponent = (1 << traits::exponentBits) - 1;
+        if (nd == 0 || dp < -330)
+            return 0;
+        if (dp > 310)
+            return infinityBits<_Tp>();
+
+        // Scale into [0.5, 1), tracking the binary exponent.
+        static const int powers[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+        int exponent = 0;
+        while (dp > 0)
+        {
+            const int n = dp >= 9 ? 27 : powers[dp];
+            shift(-n);
+            exponent += n;
+        }
+        while (dp < 0 || (dp == 0 && d[0] < 5))
+        {
+            const int n = -dp >= 9 ? 27 : powers[-dp];
+            shift(n);
+            exponent -= n;
+        }
+
+        // The biased exponent of [1, 2), at least 1 for subnormals.
+        int biased = exponent - 1 + traits::bias;
+        if (biased < 1)
+        {
+            shift(biased - 1);
+            biased = 1;
+        }
+        if (biased >= maxExponent)
+            return infinityBits<_Tp>();
+
+        shift(1 + mantissaBits);
+        uint64_t mantissa = roundedInteger();
+        if (mantissa == (uint64_t(2) << mantissaBits))
+        {
+            mantissa >>= 1;
+            if (++biased >= maxExponent)
+                return infinityBits<_Tp>();
+        }
+        if (!(mantissa & (uint64_t(1) << mantissaBits)))
+            biased = 0;
+        return (static_cast<uint64_t>(biased) << mantissaBits) |
+               (mantissa & ((uint64_t(1) << mantissaBits) - 1));
+    }
+
+private:
+    // The largest shift that can't overflow 64 bits.
+    static constexpr int maxShift = 60;
+
+    void trim()
+    {
+        while (nd > 0 && d[nd - 1] == 0)
+            --nd;
+        if (nd == 0)
+            dp = 0;
+    }
+
+    void shift(int k)
+    {
+        if (nd == 0)
+            return;
+        for (; k > maxShift; k -= maxShift)
+            leftShift(maxShift);
+        for (; k < -maxShift; k += maxShift)
+            rightShift(maxShift);
+        if (k > 0)
+            leftShift(k);
+        else if (k < 0)
+            rightShift(-k);
+    }
+
+    void leftShift(int k)
+    {
+        // Multiplying by 2^k adds at most 19 digits. Move the digits out of
+        // the way and write the product right to left over them.
+        memmove(d + 19, d, nd);
+        int w = nd + 19;
+        uint64_t n = 0;
+        for (int r = nd + 18; r >= 19; --r)
+        {
+            n += static_cast<uint64_t>(d[r]) << k;
+            d[--w] = static_cast<unsigned char>(n % 10);
+            n /= 10;
+        }
+        for (; n > 0; n /= 10)
+            d[--w] = static_cast<unsigned char>(n % 10);
+        const int added = 19 - w;
+        memmove(d, d + w, nd + added);
+        nd += added;
+        dp += added;
+        for (; nd > maxDigits; --nd)
+            trunc |= d[nd - 1] != 0;
+        trim();
+    }
+
+    void rightShift(int k)
+    {
+        int r = 0;
+        int w = 0;
+        // Pick up enough leading digits to cover the first shift.
+        uint64_t n = 0;
+        for (; n >> k == 0; ++r)
+        {
+            if (r >= nd)
+            {
+                if (n == 0)
+                {
+                    nd = 0;
+                    return;
+                }
+                for (; n >> k == 0; ++r)
+                    n *= 10;
+                break;
+            }
+            n = n * 10 + d[r];
+        }
+        dp -= r - 1;
+
+        const uint64_t mask = (uint64_t(1) << k) - 1;
+        for (; r < nd; ++r)
+        {
+            const uint64_t digit = n >> k;
+            n &= mask;
+            d[w++] = static_cast<unsigned char>(digit);
+            n = n * 10 + d[r];
+        }
+        for (; n > 0; n *= 10)
+        {
+            const uint64_t digit = n >> k;
+            n &= mask;
+            if (w < maxDigits)
+                d[w++] = static_cast<unsigned char>(digit);
+            else if (digit > 0)
+                trunc = true;
+        }
+        nd = w;
+        trim();
+    }
+
+    uint64_t roundedInteger() const
+    {
+        if (dp > 20)
+            return ~uint64_t(0);
+        uint64_t n = 0;
+        int i = 0;
+        for (; i < dp && i < nd; ++i)
+            n = n * 10 + d[i];
+        for (; i < dp; ++i)
+            n *= 10;
+        if (dp >= 0 && dp < nd)
+        {
+            // Round half to even, unless digits were truncated.
+            if (d[dp] == 5 && dp + 1 == nd)
+                n += trunc || (dp > 0 && d[dp - 1] % 2 == 1);
+            else
+                n += d[dp] >= 5;
+        }
+        return n;
+    }
+
+    int nd = 0;
+    int dp = 0;
+    bool trunc = false;
+    // Room for the digits leftShift() adds before truncating.
+    unsigned char d[maxDigits + 19];
+};
+
+// Rounds m * 2^e2 for a nonzero m, and nonzero bits below if sticky, to the
+// bits of the nearest _Tp.
+template <class _Tp>
+uint64_t
+roundBinary(uint64_t m, int64_t e2, bool sticky)
+{
+    using traits = float_traits<_Tp>;
+    const int lz = countLeadingZeros(m);
+    m <<= lz;
+    e2 -= lz;
+    int64_t biased = e2 + 63 + traits::bias;
+    if (biased >= (1 << traits::exponentBits) - 1)
+        return infinityBits<_Tp>();
+    int64_t shift = 63 - traits::mantissaBits;
+    if (biased < 1)
+    {
+        shift += 1 - biased;
+        biased = 1;
+    }
+    if (shift > 64)
+        return 0;
+    const uint64_t half = uint64_t(1) << (shift - 1);
+    const uint64_t rest = shift == 64 ? m : m & ((half << 1) - 1);
+    uint64_t mantissa = shift == 64 ? 0 : m >> shift;
+    if (rest > half || (rest == half && (sticky || (mantissa & 1))))
+        ++mantissa;
+    const uint64_t bits =
+        (static_cast<uint64_t>(biased - 1) << traits::mantissaBits) + mantissa;
+    return bits >= infinityBits<_Tp>() ? infinityBits<_Tp>() : bits;
+}
+
+// Parses the special values accepted by strtod.
+template <class _Tp>
+from_chars_result
+parseSpecial(const char* first, const char* p, const char* last, bool negative,
+             _Tp& value)
+{
+    using traits = float_traits<_Tp>;
+    if (startsWithIgnoringCase(p, last, "inf"))
+    {
+        p += 3;
+        if (startsWithIgnoringCase(p, last, "inity"))
+            p += 5;
+        value = fromBits<_Tp>(infinityBits<_Tp>(), negative);
+        return {p, errc{}};
+    }
+    if (startsWithIgnoringCase(p, last, "nan"))
+    {
+        p += 3;
+        if (p != last && *p == '(')
+        {
+            const char* q = p + 1;
+            while (q != last && (isDigit(*q) || *q == '_' ||
+                                 static_cast<unsigned>((*q | 0x20) - 'a') < 26))
+                ++q;
+            if (q != last && *q == ')')
+                p = q + 1;
+        }
+        value = fromBits<_Tp>(infinityBits<_Tp>() |
+                                  uint64_t(1) << (traits::mantissaBits - 1),
+                              negative);
+        return {p, errc{}};
+    }
+    return {first, errc::invalid_argument};
+}
+
+// Parses an optional exponent introduced by marker (either case), leaving p
+// alone if there is none.
+inline bool
+parseExponent(const char*& p, const char* last, char marker, int64_t& exponent)
+{
+    if (p == last || (*p | 0x20) != marker)
+        return false;
+    const char* q = p + 1;
+    bool negative = false;
+    if (q != last && (*q == '+' || *q == '-'))
+        negative = *q++ == '-';
+    if (q == last || !isDigit(*q))
+        return false;
+    // Saturates, the value is zero or infinity long before.
+    int64_t e = 0;
+    for (; q != last && isDigit(*q); ++q)
+        if (e < 100000)
+            e = e * 10 + (*q - '0');
+    exponent = negative ? -e : e;
+    p = q;
+    return true;
+}
+
+template <class _Tp>
+from_chars_result
+fromCharsFloatingPoint(const char* first, const char* last, _Tp& value,
+                       chars_format fmt)
+{
+    const char* p = first;
+    const bool negative = p != last && *p == '-';
+    if (negative)
+        ++p;
+    if (p != last && ((*p | 0x20) == 'i' || (*p | 0x20) == 'n'))
+        return parseSpecial(first, p, last, negative, value);
+
+    const bool hex = fmt == chars_format::hex;
+    const int base = hex ? 16 : 10;
+    // Up to 16 hex or 19 decimal digits fit the 64 bit significand, exactly
+    // if none of the digits after them is nonzero.
+    const int maxSignificant = hex ? 16 : 19;
+    uint64_t significand = 0;
+    int used = 0;
+    bool truncated = false;
+    // The number of significant digits before the point, negative for
+    // leading zeros after it.
+    int64_t point = 0;
+    bool any = false;
+    const char* significantBegin = nullptr;
+    bool seenPoint = false;
+    for (; p != last; ++p)
+    {
+        if (*p == '.' && !seenPoint)
+        {
+            seenPoint = true;
+            continue;
+        }
+        const int digit = hex ? hexDigit(*p) : isDigit(*p) ? *p - '0' : -1;
+        if (digit < 0)
+            break;
+        any = true;
+        if (!significantBegin)
+        {
+            if (digit == 0)
+            {
+                point -= seenPoint;
+                continue;
+            }
+            significantBegin = p;
+        }
+        point += !seenPoint;
+        if (used < maxSignificant)
+        {
+            significand = significand * base + digit;
+            ++used;
+        }
+        else
+            truncated |= digit != 0;
+    }
+    if (!any)
+        return {first, errc::invalid_argument};
+    const char* significantEnd = p;
+
+    int64_t exponent = 0;
+    if (hex)
+        parseExponent(p, last, 'p', exponent);
+    else if (static_cast<int>(fmt) & static_cast<int>(chars_format::scientific))
+    {
+        // Only scientific without fixed requires the exponent.
+        if (!parseExponent(p, last, 'e', exponent) &&
+            !(static_cast<int>(fmt) & static_cast<int>(chars_format::fixed)))
+            return {first, errc::invalid_argument};
+    }
+
+    if (!significantBegin)
+    {
+        value = fromBits<_Tp>(0, negative);
+        return {p, errc{}};
+    }
+    if (point > 100000)
+        point = 100000;
+    else if (point < -100000)
+        point = -100000;
+
+    uint64_t bits;
+    if (hex)
+        bits = roundBinary<_Tp>(significand, 4 * (point - used) + exponent,
+                                truncated);
+    else
+    {
+        const int64_t q = point - used + exponent;
+        _Tp result;
+        if (!truncated && clingerFastPath(significand, q, result))
+        {
+            value = negative ? -result : result;
+            return {p, errc{}};
+        }
+        uint64_t upper;
+        // With truncated digits, the value is between significand and
+        // significand + 1 times 10^q. If both round the same, so does it.
+        if (!eiselLemire<_Tp>(significand, q, bits) ||
+            (truncated && (!eiselLemire<_Tp>(significand + 1, q, upper) ||
+                           upper != bits)))
+        {
+            bigDecimal d;
+            for (const char* s = significantBegin; s != significantEnd; ++s)
+                if (*s != '.')
+                    d.append(*s - '0');
+            d.setDecimalPoint(point + exponent);
+            bits = d.toBits<_Tp>();
+        }
+    }
+
+    if (bits == 0 || bits == infinityBits<_Tp>())
+        return {p, errc::result_out_of_range};
+    value = fromBits<_Tp>(bits, negative);
+    return {p, errc{}};
+}
+
+}  // namespace __floating_point
+
+to_chars_result
+to_chars(char* __first, char* __last, float __value)
+{
+    return __floating_point::toCharsShortest(__first, __last, __value,
+                                             chars_format::general, true);
+}
+
+to_chars_result
+to_chars(char* __first, char* __last, double __value)
+{
+    return __floating_point::toCharsShortest(__first, __last, __value,
+                                             chars_format::general, true);
+}
+
+to_chars_result
+to_chars(char* __first, char* __last, float __value, chars_format __fmt)
+{
+    return __floating_point::toCharsShortest(__first, __last, __value, __fmt,
+                                             false);
+}
+
+to_chars_result
+to_chars(char* __first, char* __last, double __value, chars_format __fmt)
+{
+    return __floating_point::toCharsShortest(__first, __last, __value, __fmt,
+                                             false);
+}
+
+from_chars_result
+from_chars(const char* __first, const char* __last, float& __value,
+           chars_format __fmt)
+{
+    return __floating_point::fromCharsFloatingPoint(__first, __last, __value,
+                                                    __fmt);
+}
+
+from_chars_result
+from_chars(const char* __first, const char* __last, double& __value,
+           chars_format __fmt)
+{
+    return __floating_point::fromCharsFloatingPoint(__first, __last, __value,
+                                                    __fmt);
+}
+
 _LIBCPP_END_NAMESPACE_STD
@@ -133,15 +133,17 @@ __shared_weak_count::__get_deleter(const type_info&) const _NOEXCEPT
 
 #if !defined(_LIBCPP_HAS_NO_ATOMIC_HEADER)
 
-_LIBCPP_SAFE_STATIC static const std::size_t __sp_mut_count = 16;
-_LIBCPP_SAFE_STATIC static __libcpp_mutex_t mut_back[__sp_mut_count] =
+// Each mutex gets a cache line of its own so that threads working on
+// unrelated shared_ptrs don't contend on the line even when they take
+// different locks.
+struct alignas(64) __sp_mut_stripe
 {
-    _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER,
-    _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER,
-    _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER,
-    _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER, _LIBCPP_MUTEX_INITIALIZER
+    __libcpp_mutex_t __m = _LIBCPP_MUTEX_INITIALIZER;
 };
 
+_LIBCPP_SAFE_STATIC static const std::size_t __sp_mut_count = 32;
+_LIBCPP_SAFE_STATIC static __sp_mut_stripe mut_back[__sp_mut_count];
+
 _LIBCPP_CONSTEXPR __sp_mut::__sp_mut(void* p) _NOEXCEPT
    : __lx(p)
 {
@@ -174,10 +176,14 @@ __get_sp_mut(const void* p)
 {
     static __sp_mut muts[__sp_mut_count]
     {
-        &mut_back[ 0], &mut_back[ 1], &mut_back[ 2], &mut_back[ 3],
-        &mut_back[ 4], &mut_back[ 5], &mut_back[ 6], &mut_back[ 7],
-        &mut_back[ 8], &mut_back[ 9], &mut_back[10], &mut_back[11],
-        &mut_back[12], &mut_back[13], &mut_back[14], &mut_back[15]
+        &mut_back[ 0].__m, &mut_back[ 1].__m, &mut_back[ 2].__m, &mut_back[ 3].__m,
+        &mut_back[ 4].__m, &mut_back[ 5].__m, &mut_back[ 6].__m, &mut_back[ 7].__m,
+        &mut_back[ 8].__m, &mut_back[ 9].__m, &mut_back[10].__m, &mut_back[11].__m,
+        &mut_back[12].__m, &mut_back[13].__m, &mut_back[14].__m, &mut_back[15].__m,
+        &mut_back[16].__m, &mut_back[17].__m, &mut_back[18].__m, &mut_back[19].__m,
+        &mut_back[20].__m, &mut_back[21].__m, &mut_back[22].__m, &mut_back[23].__m,
+        &mut_back[24].__m, &mut_back[25].__m, &mut_back[26].__m, &mut_back[27].__m,
+        &mut_back[28].__m, &mut_back[29].__m, &mut_back[30].__m, &mut_back[31].__m
     };
     return muts[hash<const void*>()(p) & (__sp_mut_count-1)];
 }
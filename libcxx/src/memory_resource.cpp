@@ -0,0 +1,708 @@
+//===------------------------ memory_resource.cpp -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "memory_resource"
+#include "algorithm"
+#include "bit"
+#include "cstdint"
+#ifndef _LIBCPP_HAS_NO_THREADS
+#include "__threading_support"
+#include "atomic"
+#include "mutex"
+#include "system_error"
+#include "vector"
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace pmr
+{
+
+// memory_resource
+
+memory_resource::~memory_resource() {}
+
+// new_delete_resource, null_memory_resource
+
+namespace
+{
+
+class __new_delete_memory_resource_imp : public memory_resource
+{
+    void* do_allocate(size_t __bytes, size_t __align) override
+        { return _VSTD::__libcpp_allocate(__bytes, __align); }
+
+    void do_deallocate(void* __p, size_t __bytes, size_t __align) override
+        { _VSTD::__libcpp_deallocate(__p, __bytes, __align); }
+
+    bool do_is_equal(const memory_resource& __other) const _NOEXCEPT override
+        { return &__other == this; }
+};
+
+class __null_memory_resource_imp : public memory_resource
+{
+    void* do_allocate(size_t, size_t) override
+        { __throw_bad_alloc(); }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const memory_resource& __other) const _NOEXCEPT override
+        { return &__other == this; }
+};
+
+// The global resources are never destroyed, so that the destructors of other
+// static objects can still give their memory back.
+template <class _Tp>
+union __no_destroy
+{
+    _Tp __value_;
+
+    __no_destroy() : __value_() {}
+    ~__no_destroy() {}
+};
+
+} // namespace
+
+memory_resource* new_delete_resource() _NOEXCEPT
+{
+    static __no_destroy<__new_delete_memory_resource_imp> __res;
+    return &__res.__value_;
+}
+
+memory_resource* null_memory_resource() _NOEXCEPT
+{
+    static __no_destroy<__null_memory_resource_imp> __res;
+    return &__res.__value_;
+}
+
+// get_default_resource, set_default_resource
+
+// A null pointer stands for new_delete_resource(), which keeps the variable
+// constant-initialized and usable before any dynamic initialization runs.
+#ifndef _LIBCPP_HAS_NO_THREADS
+_LIBCPP_SAFE_STATIC static atomic<memory_resource*> __default_res(nullptr);
+#else
+_LIBCPP_SAFE_STATIC static memory_resource* __default_res = nullptr;
+#endif
+
+memory_resource* get_default_resource() _NOEXCEPT
+{
+#ifndef _LIBCPP_HAS_NO_THREADS
+    memory_resource* __r = __default_res.load(memory_order_acquire);
+#else
+    memory_resource* __r = __default_res;
+#endif
+    return __r != nullptr ? __r : new_delete_resource();
+}
+
+memory_resource* set_default_resource(memory_resource* __r) _NOEXCEPT
+{
+#ifndef _LIBCPP_HAS_NO_THREADS
+    memory_resource* __old = __default_res.exchange(__r, memory_order_acq_rel);
+#else
+    memory_resource* __old = __default_res;
+    __default_res = __r;
+#endif
+    return __old != nullptr ? __old : new_delete_resource();
+}
+
+// unsynchronized_pool_resource
+
+namespace
+{
+
+// The smallest pool hands out blocks that can hold a free list link.
+const size_t __min_block_shift = 3;
+const size_t __min_block_size = size_t(1) << __min_block_shift;
+
+// What a zero or oversized pool_options member turns into.
+const size_t __max_blocks_per_chunk_limit = size_t(1) << 20;
+const size_t __largest_pool_block_limit = size_t(1) << 20;
+
+// The first chunk of a pool holds about this many bytes of blocks, and
+// at least one block.
+const size_t __initial_chunk_bytes = 4096;
+
+const size_t __chunk_align = alignof(max_align_t);
+
+inline size_t __ceil_log2(size_t __n)
+{
+    if (__n <= 1)
+        return 0;
+    return numeric_limits<unsigned long long>::digits -
+           _VSTD::__clz(static_cast<unsigned long long>(__n - 1));
+}
+
+inline size_t __round_up(size_t __n, size_t __align)
+{
+    return (__n + __align - 1) & ~(__align - 1);
+}
+
+pool_options __normalize_options(pool_options __opts)
+{
+    if (__opts.max_blocks_per_chunk == 0 ||
+        __opts.max_blocks_per_chunk > __max_blocks_per_chunk_limit)
+        __opts.max_blocks_per_chunk = __max_blocks_per_chunk_limit;
+    if (__opts.largest_required_pool_block == 0 ||
+        __opts.largest_required_pool_block > __largest_pool_block_limit)
+        __opts.largest_required_pool_block = __largest_pool_block_limit;
+    __opts.largest_required_pool_block = size_t(1) << _VSTD::max(
+        __ceil_log2(__opts.largest_required_pool_block), __min_block_shift);
+    return __opts;
+}
+
+// Sits at the end of every chunk of a pool, and links the chunks for release.
+struct __pool_chunk_footer
+{
+    __pool_chunk_footer* __next_;
+    char* __start_;
+};
+
+} // namespace
+
+// The free blocks of one size, and the part of the newest chunk that has not
+// been handed out yet.
+class unsynchronized_pool_resource::__pool
+{
+public:
+    __pool(size_t __block_size, size_t __max_blocks)
+        : __free_(nullptr), __cur_(nullptr), __end_(nullptr), __chunks_(nullptr),
+          __next_blocks_(_VSTD::max<size_t>(1, _VSTD::min(__max_blocks,
+              __initial_chunk_bytes / __block_size))) {}
+
+    void* __allocate(size_t __block_size, size_t __max_blocks,
+                     memory_resource* __upstream)
+    {
+        if (__free_ != nullptr)
+        {
+            void* __r = __free_;
+            __free_ = *static_cast<void**>(__r);
+            return __r;
+        }
+        if (__cur_ == __end_)
+            __grow(__block_size, __max_blocks, __upstream);
+        void* __r = __cur_;
+        __cur_ += __block_size;
+        return __r;
+    }
+
+    void __deallocate(void* __p)
+    {
+        *static_cast<void**>(__p) = __free_;
+        __free_ = __p;
+    }
+
+    void __release(size_t __block_size, size_t __max_blocks,
+                   memory_resource* __upstream)
+    {
+        while (__chunks_ != nullptr)
+        {
+            __pool_chunk_footer* __c = __chunks_;
+            __chunks_ = __c->__next_;
+            size_t __bytes = reinterpret_cast<char*>(__c + 1) - __c->__start_;
+            __upstream->deallocate(__c->__start_, __bytes, __chunk_align);
+        }
+        *this = __pool(__block_size, __max_blocks);
+    }
+
+private:
+    void __grow(size_t __block_size, size_t __max_blocks,
+                memory_resource* __upstream)
+    {
+        // Block sizes are powers of two from 8 up, so the footer after the
+        // last block is suitably aligned.
+        size_t __blocks = _VSTD::min(__next_blocks_,
+            (numeric_limits<size_t>::max() / 2) / __block_size);
+        size_t __bytes = __blocks * __block_size;
+        char* __start = static_cast<char*>(__upstream->allocate(
+            __bytes + sizeof(__pool_chunk_footer), __chunk_align));
+        __pool_chunk_footer* __c =
+            reinterpret_cast<__pool_chunk_footer*>(__start + __bytes);
+        __c->__next_ = __chunks_;
+        __c->__start_ = __start;
+        __chunks_ = __c;
+        __cur_ = __start;
+        __end_ = __start + __bytes;
+        __next_blocks_ = _VSTD::min(__blocks * 2, __max_blocks);
+    }
+
+    void* __free_;
+    char* __cur_;
+    char* __end_;
+    __pool_chunk_footer* __chunks_;
+    size_t __next_blocks_;
+};
+
+// Precedes every allocation too big or too aligned for the pools, so that
+// release() can find them.
+struct unsynchronized_pool_resource::__large_block
+{
+    __large_block* __prev_;
+    __large_block* __next_;
+    size_t __bytes_;
+    size_t __align_;
+
+    static size_t __offset(size_t __align)
+    {
+        return __round_up(sizeof(__large_block),
+                          _VSTD::max(__align, alignof(__large_block)));
+    }
+};
+
+unsynchronized_pool_resource::unsynchronized_pool_resource(
+        const pool_options& __opts, memory_resource* __upstream)
+    : __res_(__upstream), __opts_(__normalize_options(__opts)),
+      __pools_(nullptr),
+      __num_pools_(__ceil_log2(__opts_.largest_required_pool_block) -
+                   __min_block_shift + 1),
+      __large_(nullptr)
+{
+}
+
+unsynchronized_pool_resource::~unsynchronized_pool_resource()
+{
+    release();
+}
+
+void unsynchronized_pool_resource::release()
+{
+    while (__large_ != nullptr)
+    {
+        __large_block* __b = __large_;
+        __large_ = __b->__next_;
+        size_t __offset = __large_block::__offset(__b->__align_);
+        __res_->deallocate(reinterpret_cast<char*>(__b + 1) - __offset,
+                           __b->__bytes_ + __offset,
+                           _VSTD::max(__b->__align_, alignof(__large_block)));
+    }
+    if (__pools_ != nullptr)
+    {
+        for (size_t __i = 0; __i != __num_pools_; ++__i)
+            __pools_[__i].__release(__min_block_size << __i,
+                                    __opts_.max_blocks_per_chunk, __res_);
+        __res_->deallocate(__pools_, __num_pools_ * sizeof(__pool),
+                           alignof(__pool));
+        __pools_ = nullptr;
+    }
+}
+
+void unsynchronized_pool_resource::__init_pools()
+{
+    __pools_ = static_cast<__pool*>(__res_->allocate(
+        __num_pools_ * sizeof(__pool), alignof(__pool)));
+    for (size_t __i = 0; __i != __num_pools_; ++__i)
+        ::new (&__pools_[__i]) __pool(__min_block_size << __i,
+                                      __opts_.max_blocks_per_chunk);
+}
+
+void* unsynchronized_pool_resource::do_allocate(size_t __bytes, size_t __align)
+{
+    if (__bytes <= __opts_.largest_required_pool_block &&
+        __align <= alignof(max_align_t))
+    {
+        // A block is aligned to its size, up to the alignment of its chunk.
+        size_t __i = __ceil_log2(_VSTD::max(_VSTD::max(__bytes, __align),
+                                            __min_block_size)) -
+                     __min_block_shift;
+        if (__pools_ == nullptr)
+            __init_pools();
+        return __pools_[__i].__allocate(__min_block_size << __i,
+                                        __opts_.max_blocks_per_chunk, __res_);
+    }
+
+    size_t __offset = __large_block::__offset(__align);
+    if (__bytes > numeric_limits<size_t>::max() - __offset)
+        __throw_bad_alloc();
+    char* __start = static_cast<char*>(__res_->allocate(
+        __bytes + __offset, _VSTD::max(__align, alignof(__large_block))));
+    __large_block* __b =
+        reinterpret_cast<__large_block*>(__start + __offset) - 1;
+    __b->__prev_ = nullptr;
+    __b->__next_ = __large_;
+    __b->__bytes_ = __bytes;
+    __b->__align_ = __align;
+    if (__large_ != nullptr)
+        __large_->__prev_ = __b;
+    __large_ = __b;
+    return __start + __offset;
+}
+
+void unsynchronized_pool_resource::do_deallocate(void* __p, size_t __bytes,
+                                                 size_t __align)
+{
+    if (__bytes <= __opts_.largest_required_pool_block &&
+        __align <= alignof(max_align_t))
+    {
+        size_t __i = __ceil_log2(_VSTD::max(_VSTD::max(__bytes, __align),
+                                            __min_block_size)) -
+                     __min_block_shift;
+        // The pools of a synchronized_pool_resource get the blocks that
+        // their thread frees, whichever thread allocated them.
+        if (__pools_ == nullptr)
+            __init_pools();
+        __pools_[__i].__deallocate(__p);
+        return;
+    }
+
+    __large_block* __b = static_cast<__large_block*>(__p) - 1;
+    if (__b->__prev_ != nullptr)
+        __b->__prev_->__next_ = __b->__next_;
+    else
+        __large_ = __b->__next_;
+    if (__b->__next_ != nullptr)
+        __b->__next_->__prev_ = __b->__prev_;
+    size_t __offset = __large_block::__offset(__align);
+    __res_->deallocate(static_cast<char*>(__p) - __offset, __bytes + __offset,
+                       _VSTD::max(__align, alignof(__large_block)));
+}
+
+bool unsynchronized_pool_resource::do_is_equal(
+        const memory_resource& __other) const _NOEXCEPT
+{
+    return &__other == this;
+}
+
+// synchronized_pool_resource
+
+#ifndef _LIBCPP_HAS_NO_THREADS
+
+namespace
+{
+
+// The part of synchronized_pool_resource::__thread_pools that the thread
+// exit handler needs.  One reference belongs to the resource and one to
+// the thread using the pools, and a count of one with the resource alive
+// means the pools are free for another thread to adopt.
+struct __thread_pools_base
+{
+    atomic<int> __refs_;
+
+    __thread_pools_base() : __refs_(2) {}
+    virtual ~__thread_pools_base() {}
+
+    void __drop()
+    {
+        if (__refs_.fetch_sub(1, memory_order_acq_rel) == 1)
+            delete this;
+    }
+};
+
+// Every live thread that has allocated from a synchronized_pool_resource
+// keeps one entry per resource it used.
+struct __local_pools_entry
+{
+    const void* __res_;
+    __thread_pools_base* __pools_;
+};
+
+typedef vector<__local_pools_entry> __local_pools_list;
+
+void _LIBCPP_TLS_DESTRUCTOR_CC __local_pools_at_thread_exit(void* __p)
+{
+    __local_pools_list* __l = static_cast<__local_pools_list*>(__p);
+    for (__local_pools_entry& __e : *__l)
+        __e.__pools_->__drop();
+    delete __l;
+}
+
+__libcpp_tls_key __local_pools_key()
+{
+    static __libcpp_tls_key __key = [] {
+        __libcpp_tls_key __k;
+        int __ec = __libcpp_tls_create(&__k, &__local_pools_at_thread_exit);
+        if (__ec)
+            __throw_system_error(__ec,
+                "synchronized_pool_resource thread-local key creation failed");
+        return __k;
+    }();
+    return __key;
+}
+
+// Guards the pools of one thread.  Anyone but their owner only takes it in
+// release(), so it spins instead of sleeping.
+class __pools_guard
+{
+public:
+    explicit __pools_guard(atomic<bool>& __busy) : __busy_(__busy)
+    {
+        while (__busy_.exchange(true, memory_order_acquire))
+            __libcpp_thread_yield();
+    }
+
+    ~__pools_guard() { __busy_.store(false, memory_order_release); }
+
+private:
+    __pools_guard(const __pools_guard&);
+    __pools_guard& operator=(const __pools_guard&);
+
+    atomic<bool>& __busy_;
+};
+
+} // namespace
+
+struct synchronized_pool_resource::__thread_pools : __thread_pools_base
+{
+    __thread_pools(const pool_options& __opts, memory_resource* __upstream)
+        : __pools_(__opts, __upstream), __busy_(false), __next_(nullptr) {}
+
+    unsynchronized_pool_resource __pools_;
+    atomic<bool> __busy_;
+    // The next pools of the same resource, guarded by the resource's mutex.
+    __thread_pools* __next_;
+};
+
+void* synchronized_pool_resource::__locked_upstream::do_allocate(
+        size_t __bytes, size_t __align)
+{
+    lock_guard<mutex> __lk(__mut_);
+    return __res_->allocate(__bytes, __align);
+}
+
+void synchronized_pool_resource::__locked_upstream::do_deallocate(
+        void* __p, size_t __bytes, size_t __align)
+{
+    lock_guard<mutex> __lk(__mut_);
+    __res_->deallocate(__p, __bytes, __align);
+}
+
+bool synchronized_pool_resource::__locked_upstream::do_is_equal(
+        const memory_resource& __other) const _NOEXCEPT
+{
+    return &__other == this;
+}
+
+synchronized_pool_resource::synchronized_pool_resource(
+        const pool_options& __opts, memory_resource* __upstream)
+    : __upstream_(__upstream), __pools_(nullptr),
+      __shared_(__opts, &__upstream_)
+{
+}
+
+synchronized_pool_resource::~synchronized_pool_resource()
+{
+    release();
+    while (__pools_ != nullptr)
+    {
+        __thread_pools* __p = __pools_;
+        __pools_ = __p->__next_;
+        __p->__drop();
+    }
+}
+
+void synchronized_pool_resource::release()
+{
+    lock_guard<mutex> __lk(__mut_);
+    for (__thread_pools* __p = __pools_; __p != nullptr; __p = __p->__next_)
+    {
+        __pools_guard __g(__p->__busy_);
+        __p->__pools_.release();
+    }
+    __shared_.release();
+}
+
+synchronized_pool_resource::__thread_pools*
+synchronized_pool_resource::__local_pools()
+{
+    __libcpp_tls_key __key = __local_pools_key();
+    __local_pools_list* __l =
+        static_cast<__local_pools_list*>(__libcpp_tls_get(__key));
+    if (__l != nullptr)
+    {
+        // An entry whose count has dropped to one outlived its resource,
+        // which may since have been replaced by another at the same address.
+        for (__local_pools_entry& __e : *__l)
+            if (__e.__res_ == this &&
+                __e.__pools_->__refs_.load(memory_order_acquire) == 2)
+                return static_cast<__thread_pools*>(__e.__pools_);
+        __l->erase(_VSTD::remove_if(__l->begin(), __l->end(),
+            [](const __local_pools_entry& __e) {
+                if (__e.__pools_->__refs_.load(memory_order_acquire) != 1)
+                    return false;
+                __e.__pools_->__drop();
+                return true;
+            }), __l->end());
+    }
+    else
+    {
+        unique_ptr<__local_pools_list> __hold(new __local_pools_list);
+        int __ec = __libcpp_tls_set(__key, __hold.get());
+        if (__ec)
+            __throw_system_error(__ec,
+                "synchronized_pool_resource thread-local storage failed");
+        __l = __hold.release();
+    }
+    __l->reserve(__l->size() + 1);
+
+    unique_lock<mutex> __lk(__mut_);
+    __thread_pools* __p = __pools_;
+    for (; __p != nullptr; __p = __p->__next_)
+    {
+        int __expected = 1;
+        if (__p->__refs_.compare_exchange_strong(__expected, 2,
+                                                 memory_order_acq_rel))
+            break;
+    }
+    if (__p == nullptr)
+    {
+        __p = new __thread_pools(__shared_.options(), &__upstream_);
+        __p->__next_ = __pools_;
+        __pools_ = __p;
+    }
+    __lk.unlock();
+
+    __l->push_back(__local_pools_entry{this, __p});
+    return __p;
+}
+
+void* synchronized_pool_resource::do_allocate(size_t __bytes, size_t __align)
+{
+    if (__bytes > __shared_.__opts_.largest_required_pool_block ||
+        __align > alignof(max_align_t))
+    {
+        lock_guard<mutex> __lk(__mut_);
+        return __shared_.allocate(__bytes, __align);
+    }
+    __thread_pools* __p = __local_pools();
+    __pools_guard __g(__p->__busy_);
+    return __p->__pools_.unsynchronized_pool_resource::do_allocate(__bytes,
+                                                                   __align);
+}
+
+void synchronized_pool_resource::do_deallocate(void* __p, size_t __bytes,
+                                               size_t __align)
+{
+    if (__bytes > __shared_.__opts_.largest_required_pool_block ||
+        __align > alignof(max_align_t))
+    {
+        lock_guard<mutex> __lk(__mut_);
+        __shared_.deallocate(__p, __bytes, __align);
+        return;
+    }
+    __thread_pools* __tp = __local_pools();
+    __pools_guard __g(__tp->__busy_);
+    __tp->__pools_.unsynchronized_pool_resource::do_deallocate(__p, __bytes,
+                                                               __align);
+}
+
+#else // _LIBCPP_HAS_NO_THREADS
+
+synchronized_pool_resource::synchronized_pool_resource(
+        const pool_options& __opts, memory_resource* __upstream)
+    : __shared_(__opts, __upstream)
+{
+}
+
+synchronized_pool_resource::~synchronized_pool_resource()
+{
+}
+
+void synchronized_pool_resource::release()
+{
+    __shared_.release();
+}
+
+void* synchronized_pool_resource::do_allocate(size_t __bytes, size_t __align)
+{
+    return __shared_.allocate(__bytes, __align);
+}
+
+void synchronized_pool_resource::do_deallocate(void* __p, size_t __bytes,
+                                               size_t __align)
+{
+    __shared_.deallocate(__p, __bytes, __align);
+}
+
+#endif // _LIBCPP_HAS_NO_THREADS
+
+bool synchronized_pool_resource::do_is_equal(
+        const memory_resource& __other) const _NOEXCEPT
+{
+    return &__other == this;
+}
+
+// monotonic_buffer_resource
+
+struct monotonic_buffer_resource::__chunk_footer
+{
+    __chunk_footer* __next_;
+    char* __start_;
+    size_t __align_;
+};
+
+monotonic_buffer_resource::~monotonic_buffer_resource()
+{
+    release();
+}
+
+void monotonic_buffer_resource::release()
+{
+    while (__chunks_ != nullptr)
+    {
+        __chunk_footer* __c = __chunks_;
+        __chunks_ = __c->__next_;
+        __res_->deallocate(__c->__start_,
+                           reinterpret_cast<char*>(__c + 1) - __c->__start_,
+                           __c->__align_);
+    }
+    __cur_ = __initial_buffer_;
+    __end_ = __initial_buffer_ != nullptr ? __initial_buffer_ + __initial_size_
+                                          : nullptr;
+    __next_size_ = __initial_next_size_;
+}
+
+void* monotonic_buffer_resource::do_allocate(size_t __bytes, size_t __align)
+{
+    if (__cur_ != nullptr)
+    {
+        size_t __space = static_cast<size_t>(__end_ - __cur_);
+        size_t __pad = static_cast<size_t>(
+            -reinterpret_cast<uintptr_t>(__cur_) & (__align - 1));
+        if (__pad <= __space && __bytes <= __space - __pad)
+        {
+            char* __r = __cur_ + __pad;
+            __cur_ = __r + __bytes;
+            return __r;
+        }
+    }
+
+    // The new chunk starts aligned for the request, and ends with the footer.
+    const size_t __max = numeric_limits<size_t>::max();
+    size_t __align_chunk = _VSTD::max(__align, alignof(__chunk_footer));
+    if (__bytes > __max - sizeof(__chunk_footer) - alignof(__chunk_footer))
+        __throw_bad_alloc();
+    size_t __need = __round_up(__bytes, alignof(__chunk_footer)) +
+                    sizeof(__chunk_footer);
+    size_t __size = __round_up(_VSTD::max(__next_size_, __need),
+                               alignof(__chunk_footer));
+    char* __start = static_cast<char*>(__res_->allocate(__size, __align_chunk));
+    __chunk_footer* __c =
+        reinterpret_cast<__chunk_footer*>(__start + __size) - 1;
+    __c->__next_ = __chunks_;
+    __c->__start_ = __start;
+    __c->__align_ = __align_chunk;
+    __chunks_ = __c;
+    __next_size_ = __size <= __max / 2 ? __size * 2 : __size;
+
+    __cur_ = __start + __bytes;
+    __end_ = reinterpret_cast<char*>(__c);
+    return __start;
+}
+
+void monotonic_buffer_resource::do_deallocate(void*, size_t, size_t)
+{
+}
+
+bool monotonic_buffer_resource::do_is_equal(
+        const memory_resource& __other) const _NOEXCEPT
+{
+    return &__other == this;
+}
+
+} // namespace pmr
+
+_LIBCPP_END_NAMESPACE_STD
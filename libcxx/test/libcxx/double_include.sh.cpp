@@ -63,6 +63,7 @@
 #include <deque>
 #include <errno.h>
 #include <exception>
+#include <execution>
 #include <fenv.h>
 #include <filesystem>
 #include <float.h>
@@ -88,6 +89,7 @@
 #include <map>
 #include <math.h>
 #include <memory>
+#include <memory_resource>
 #ifndef _LIBCPP_HAS_NO_THREADS
 #include <mutex>
 #endif
@@ -101,6 +101,8 @@ TEST_MACROS();
 TEST_MACROS();
 #include <exception>
 TEST_MACROS();
+#include <execution>
+TEST_MACROS();
 #include <filesystem>
 TEST_MACROS();
 #include <float.h>
@@ -147,6 +149,8 @@ TEST_MACROS();
 TEST_MACROS();
 #include <memory>
 TEST_MACROS();
+#include <memory_resource>
+TEST_MACROS();
 #ifndef _LIBCPP_HAS_NO_THREADS
 #include <mutex>
 TEST_MACROS();
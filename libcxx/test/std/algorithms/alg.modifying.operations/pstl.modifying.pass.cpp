@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <algorithm>
+
+// template<class ExecutionPolicy, class ForwardIterator1, class ForwardIterator2>
+//   ForwardIterator2 copy(ExecutionPolicy&& exec, ForwardIterator1 first,
+//                         ForwardIterator1 last, ForwardIterator2 result);
+//   (and copy_n, fill, fill_n, and both forms of transform)
+//
+// Ranges large enough to be split into chunks under the parallel policies,
+// with both random access and forward iterators.
+
+#include <algorithm>
+#include <cassert>
+#include <execution>
+#include <functional>
+#include <vector>
+
+#include "test_macros.h"
+#include "test_iterators.h"
+
+template <class Iter, class Policy>
+void test(const Policy& pol, int n)
+{
+    std::vector<int> v(n);
+    for (int i = 0; i < n; ++i)
+        v[i] = i % 1000;
+    std::vector<int> c(n);
+    Iter first(v.data());
+    Iter last(v.data() + n);
+    Iter out(c.data());
+
+    assert(std::copy(pol, first, last, out).base() == c.data() + n);
+    assert(c == v);
+
+    std::fill(pol, out, Iter(c.data() + n), 3);
+    assert(std::count(c.begin(), c.end(), 3) == n);
+    assert(std::fill_n(pol, out, n / 2, 4).base() == c.data() + n / 2);
+    assert(std::count(c.begin(), c.end(), 4) == n / 2);
+    assert(std::count(c.begin(), c.end(), 3) == n - n / 2);
+
+    assert(std::copy_n(pol, first, n / 2, out).base() == c.data() + n / 2);
+    assert(std::equal(c.begin(), c.begin() + n / 2, v.begin()));
+    assert(std::count(c.begin() + n / 2, c.end(), 3) == n - n / 2);
+
+    assert(std::transform(pol, first, last, out, [](int x) { return x + 1; }).base() ==
+           c.data() + n);
+    for (int i = 0; i < n; ++i)
+        assert(c[i] == v[i] + 1);
+    assert(std::transform(pol, first, last, out, out, std::minus<int>()).base() ==
+           c.data() + n);
+    assert(std::count(c.begin(), c.end(), -1) == n);
+}
+
+template <class Policy>
+void test(const Policy& pol)
+{
+    const int sizes[] = {0, 1, 100, 4095, 4096, 5000, 100003};
+    for (int n : sizes)
+    {
+        test<random_access_iterator<int*> >(pol, n);
+        test<forward_iterator<int*> >(pol, n);
+    }
+}
+
+int main(int, char**)
+{
+    test(std::execution::seq);
+    test(std::execution::par);
+    test(std::execution::par_unseq);
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// template<InputIterator Iter, class T>
+//   requires HasEqualTo<Iter::value_type, T>
+//   constexpr Iter::difference_type   // constexpr after C++17
+//   count(Iter first, Iter last, const T& value);
+//
+// Contiguous ranges of integers, longer than the blocks they are counted in,
+// and with values of other integer types.
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class T>
+void test(int n)
+{
+    std::vector<T> v(n, T(1));
+    for (int i = 0; i < n; i += 3)
+        v[i] = T(-1);
+    const long expect = (n + 2) / 3;
+    assert(std::count(v.begin(), v.end(), T(-1)) == expect);
+    assert(std::count(v.data(), v.data() + n, T(-1)) == expect);
+    assert(std::count(v.begin(), v.end(), static_cast<long long>(T(-1))) == expect);
+    assert(std::count(v.begin(), v.end(), 1) == n - expect);
+    assert(std::count(v.begin(), v.end(), 0x100001LL) == 0);
+}
+
+template <class T>
+void test_type()
+{
+    const int sizes[] = {0, 1, 31, 127, 128, 129, 300, 1023, 1024, 1025, 70000};
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        test<T>(sizes[i]);
+}
+
+int main(int, char**)
+{
+    test_type<char>();
+    test_type<signed char>();
+    test_type<unsigned char>();
+    test_type<short>();
+    test_type<unsigned short>();
+    test_type<int>();
+    test_type<unsigned>();
+    test_type<long long>();
+
+    // Every element matches, so each block's counter fills up.
+    std::vector<unsigned char> v(100000, 'x');
+    assert(std::count(v.begin(), v.end(), 'x') == 100000);
+
+  return 0;
+}
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// template<InputIterator Iter1, InputIterator Iter2>
+//   requires HasEqualTo<Iter1::value_type, Iter2::value_type>
+//   constexpr bool     // constexpr after c++17
+//   equal(Iter1 first1, Iter1 last1, Iter2 first2);
+//
+// template<InputIterator Iter1, InputIterator Iter2>
+//   constexpr bool     // constexpr after c++17
+//   equal(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2); // C++14
+//
+// Contiguous ranges of integers, with a difference at every position.
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class T>
+void test()
+{
+    for (int n = 0; n < 40; ++n)
+    {
+        for (int pos = 0; pos <= n; ++pos)
+        {
+            std::vector<T> v1(n, T(-1));
+            std::vector<T> v2 = v1;
+            if (pos < n)
+                v2[pos] = T(1);
+            const bool expect = pos == n;
+            assert(std::equal(v1.data(), v1.data() + n, v2.data()) == expect);
+            assert(std::equal(v1.begin(), v1.end(), v2.begin()) == expect);
+            assert(std::equal(v1.cbegin(), v1.cend(), v2.begin()) == expect);
+#if TEST_STD_VER >= 14
+            assert(std::equal(v1.begin(), v1.end(), v2.begin(), v2.end()) == expect);
+            if (n > 0)
+                assert(!std::equal(v1.begin(), v1.end(), v1.begin(), v1.end() - 1));
+#endif
+        }
+    }
+}
+
+int main(int, char**)
+{
+    test<char>();
+    test<unsigned char>();
+    test<short>();
+    test<int>();
+    test<long long>();
+
+  return 0;
+}
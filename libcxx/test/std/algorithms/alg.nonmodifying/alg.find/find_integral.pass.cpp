@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// template<InputIterator Iter, class T>
+//   requires HasEqualTo<Iter::value_type, T>
+//   constexpr Iter   // constexpr after C++17
+//   find(Iter first, Iter last, const T& value);
+//
+// Contiguous ranges of integers, at every position around the size of the
+// blocks they are searched in, and with values of other integer types.
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class T, class U>
+void test(U value, bool representable)
+{
+    for (int n = 0; n < 80; ++n)
+    {
+        for (int pos = 0; pos <= n; ++pos)
+        {
+            std::vector<T> v(n, T(7));
+            if (pos < n)
+                v[pos] = static_cast<T>(value);
+            const int expect = pos < n && representable ? pos : n;
+            const T* p = v.data();
+            assert(std::find(p, p + n, value) - p == expect);
+            assert(std::find(v.begin(), v.end(), value) - v.begin() == expect);
+            assert(std::find(v.cbegin(), v.cend(), value) - v.cbegin() == expect);
+        }
+    }
+}
+
+template <class T>
+void test_type()
+{
+    test<T>(1, true);
+    test<T>(T(-1), true);
+    test<T>(static_cast<long long>(T(-1)), true);
+    test<T>(0x100001LL, sizeof(T) > 2);
+}
+
+int main(int, char**)
+{
+    test_type<char>();
+    test_type<signed char>();
+    test_type<unsigned char>();
+    test_type<short>();
+    test_type<unsigned short>();
+    test_type<int>();
+    test_type<unsigned>();
+    test_type<long long>();
+    test_type<unsigned long long>();
+
+    // A negative value converts to an unsigned element type both ways.
+    test<unsigned>(-1, true);
+    test<unsigned char>(-1, false);
+    test<unsigned char>(255, true);
+
+    bool b[40] = {};
+    b[33] = true;
+    assert(std::find(b, b + 40, true) == b + 33);
+    assert(std::find(b, b + 40, 1) == b + 33);
+    assert(std::find(b, b + 40, 2) == b + 40);
+
+  return 0;
+}
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// template<InputIterator Iter1, InputIterator Iter2>
+//   requires HasEqualTo<Iter1::value_type, Iter2::value_type>
+//   constexpr pair<Iter1, Iter2>   // constexpr after c++17
+//   mismatch(Iter1 first1, Iter1 last1, Iter2 first2);
+//
+// template<InputIterator Iter1, InputIterator Iter2Pred>
+//   constexpr pair<Iter1, Iter2>   // constexpr after c++17
+//   mismatch(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2); // C++14
+//
+// Contiguous ranges of integers, at every position around the size of the
+// blocks they are compared in.
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class T>
+void test()
+{
+    for (int n = 0; n < 80; ++n)
+    {
+        for (int pos = 0; pos <= n; ++pos)
+        {
+            std::vector<T> v1(n, T(-1));
+            std::vector<T> v2 = v1;
+            if (pos < n)
+                v2[pos] = T(1);
+            const T* p1 = v1.data();
+            const T* p2 = v2.data();
+            assert(std::mismatch(p1, p1 + n, p2).first - p1 == pos);
+            assert(std::mismatch(p1, p1 + n, p2).second - p2 == pos);
+            assert(std::mismatch(v1.begin(), v1.end(), v2.begin()).first - v1.begin() == pos);
+            assert(std::mismatch(v1.begin(), v1.end(), v2.begin()).second - v2.begin() == pos);
+#if TEST_STD_VER >= 14
+            assert(std::mismatch(p1, p1 + n, p2, p2 + n).first - p1 == pos);
+            assert(std::mismatch(v1.begin(), v1.end(), v2.begin(), v2.end()).second - v2.begin() == pos);
+            // The shorter range ends the comparison.
+            const int half = n / 2;
+            const int expect = pos < half ? pos : half;
+            assert(std::mismatch(p1, p1 + n, p2, p2 + half).first - p1 == expect);
+            assert(std::mismatch(p2, p2 + half, p1, p1 + n).first - p2 == expect);
+            assert(std::mismatch(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cbegin() + half).second -
+                   v2.cbegin() == expect);
+#endif
+        }
+    }
+}
+
+int main(int, char**)
+{
+    test<char>();
+    test<unsigned char>();
+    test<short>();
+    test<int>();
+    test<unsigned>();
+    test<long long>();
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <algorithm>
+
+// template<class ExecutionPolicy, class ForwardIterator, class Predicate>
+//   bool all_of(ExecutionPolicy&& exec, ForwardIterator first, ForwardIterator last, Predicate pred);
+//   (and any_of, none_of, for_each, for_each_n, find, find_if, find_if_not,
+//    count, count_if)
+//
+// Ranges large enough to be split into chunks under the parallel policies,
+// with both random access and forward iterators.
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <execution>
+#include <vector>
+
+#include "test_macros.h"
+#include "test_iterators.h"
+
+template <class Iter, class Policy>
+void test(const Policy& pol, int n)
+{
+    std::vector<int> v(n);
+    for (int i = 0; i < n; ++i)
+        v[i] = (i * 7919) % 1000;
+    Iter first(v.data());
+    Iter last(v.data() + n);
+
+    auto small = [](int x) { return x < 990; };
+    assert(std::all_of(pol, first, last, [](int x) { return x < 1000; }));
+    assert(std::all_of(pol, first, last, small) == std::all_of(v.begin(), v.end(), small));
+    assert(std::any_of(pol, first, last, small) == std::any_of(v.begin(), v.end(), small));
+    assert(std::none_of(pol, first, last, small) == std::none_of(v.begin(), v.end(), small));
+    assert(std::none_of(pol, first, last, [](int x) { return x < 0; }));
+
+    assert(std::find(pol, first, last, 999).base() - v.data() ==
+           std::find(v.begin(), v.end(), 999) - v.begin());
+    assert(std::find(pol, first, last, 1000) == last);
+    assert(std::find_if(pol, first, last, [](int x) { return x > 995; }).base() - v.data() ==
+           std::find_if(v.begin(), v.end(), [](int x) { return x > 995; }) - v.begin());
+    assert(std::find_if_not(pol, first, last, small).base() - v.data() ==
+           std::find_if_not(v.begin(), v.end(), small) - v.begin());
+
+    assert(std::count(pol, first, last, 7) == std::count(v.begin(), v.end(), 7));
+    assert(std::count_if(pol, first, last, small) == std::count_if(v.begin(), v.end(), small));
+
+    long expect = 0;
+    for (int i = 0; i < n; ++i)
+        expect += v[i];
+    std::atomic<long> sum(0);
+    std::for_each(pol, first, last, [&](int x) { sum += x; });
+    assert(sum == expect);
+    sum = 0;
+    assert(std::for_each_n(pol, first, n, [&](int x) { sum += x; }) == last);
+    assert(sum == expect);
+}
+
+template <class Policy>
+void test(const Policy& pol)
+{
+    const int sizes[] = {0, 1, 100, 4095, 4096, 5000, 100003};
+    for (int n : sizes)
+    {
+        test<random_access_iterator<int*> >(pol, n);
+        test<forward_iterator<int*> >(pol, n);
+    }
+}
+
+int main(int, char**)
+{
+    test(std::execution::seq);
+    test(std::execution::par);
+    test(std::execution::par_unseq);
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <algorithm>
+
+// template<class ExecutionPolicy, class RandomAccessIterator>
+//   void sort(ExecutionPolicy&& exec, RandomAccessIterator first, RandomAccessIterator last);
+// template<class ExecutionPolicy, class RandomAccessIterator, class Compare>
+//   void sort(ExecutionPolicy&& exec, RandomAccessIterator first, RandomAccessIterator last,
+//             Compare comp);
+//   (and both forms of stable_sort)
+
+#include <algorithm>
+#include <cassert>
+#include <execution>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class Policy>
+void test(const Policy& pol, int n)
+{
+    std::vector<int> v(n);
+    unsigned x = 12345;
+    for (int i = 0; i < n; ++i)
+    {
+        x = x * 1103515245 + 12345;
+        v[i] = (x >> 8) % 1000;
+    }
+
+    std::vector<int> s = v;
+    std::sort(pol, s.begin(), s.end());
+    assert(std::is_sorted(s.begin(), s.end()));
+    std::vector<int> expect = v;
+    std::sort(expect.begin(), expect.end());
+    assert(s == expect);
+
+    s = v;
+    std::sort(pol, s.begin(), s.end(), std::greater<int>());
+    assert(std::is_sorted(s.begin(), s.end(), std::greater<int>()));
+
+    // Equal keys keep their original order.
+    std::vector<std::pair<int, int> > p(n);
+    for (int i = 0; i < n; ++i)
+        p[i] = std::make_pair(v[i] % 10, i);
+    std::vector<std::pair<int, int> > q = p;
+    auto by_key = [](const std::pair<int, int>& a, const std::pair<int, int>& b)
+    {
+        return a.first < b.first;
+    };
+    std::stable_sort(pol, p.begin(), p.end(), by_key);
+    std::stable_sort(q.begin(), q.end(), by_key);
+    assert(p == q);
+
+    s = v;
+    std::stable_sort(pol, s.begin(), s.end());
+    assert(s == expect);
+}
+
+template <class Policy>
+void test(const Policy& pol)
+{
+    const int sizes[] = {0, 1, 2, 100, 4095, 4096, 5000, 100003};
+    for (int n : sizes)
+        test(pol, n);
+}
+
+int main(int, char**)
+{
+    test(std::execution::seq);
+    test(std::execution::par);
+    test(std::execution::par_unseq);
+
+    return 0;
+}
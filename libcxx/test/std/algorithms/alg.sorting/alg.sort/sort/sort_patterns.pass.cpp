@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// template<RandomAccessIterator Iter>
+//   requires ShuffleIterator<Iter>
+//         && LessThanComparable<Iter::value_type>
+//   void
+//   sort(Iter first, Iter last);
+//
+// template<RandomAccessIterator Iter, StrictWeakOrder<auto, Iter::value_type> Compare>
+//   requires ShuffleIterator<Iter>
+//         && CopyConstructible<Compare>
+//   void
+//   sort(Iter first, Iter last, Compare comp);
+//
+// Inputs with the patterns sorting algorithms tend to special-case, or to
+// degrade on, in both arithmetic types and class types, checking the result
+// against stable_sort and the number of comparisons against O(N log N).
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "test_macros.h"
+
+std::mt19937 randomness;
+
+enum Pattern
+{
+    Random,
+    Ascending,
+    Descending,
+    FewUnique,
+    AllEqual,
+    PipeOrgan,
+    SawTooth,
+    AlmostSorted,
+    Interleaved,
+    LastPattern
+};
+
+std::vector<int> make_input(Pattern p, int n)
+{
+    std::vector<int> v(n);
+    for (int i = 0; i < n; ++i)
+    {
+        switch (p)
+        {
+        case Random:       v[i] = static_cast<int>(randomness() % (n + 1)); break;
+        case Ascending:    v[i] = i; break;
+        case Descending:   v[i] = n - i; break;
+        case FewUnique:    v[i] = static_cast<int>(randomness() % 4); break;
+        case AllEqual:     v[i] = 7; break;
+        case PipeOrgan:    v[i] = i < n / 2 ? i : n - i; break;
+        case SawTooth:     v[i] = i % 32; break;
+        case AlmostSorted: v[i] = i; break;
+        case Interleaved:  v[i] = (2 * i) % (n + 1); break;
+        case LastPattern:  break;
+        }
+    }
+    if (p == AlmostSorted && n > 0)
+        for (int k = 0; k < 3; ++k)
+            std::swap(v[randomness() % n], v[randomness() % n]);
+    return v;
+}
+
+struct Wrapped
+{
+    int value;
+    explicit Wrapped(int v = 0) : value(v) {}
+    bool operator==(const Wrapped& other) const { return value == other.value; }
+};
+
+struct CountingLess
+{
+    long* count;
+    explicit CountingLess(long* c) : count(c) {}
+    bool operator()(const Wrapped& x, const Wrapped& y) const
+    {
+        ++*count;
+        return x.value < y.value;
+    }
+};
+
+long log2_ceil(int n)
+{
+    long r = 1;
+    while ((1L << r) < n)
+        ++r;
+    return r;
+}
+
+template <class T, class Compare>
+void test_one(std::vector<T> v, Compare comp)
+{
+    std::vector<T> expect = v;
+    std::stable_sort(expect.begin(), expect.end(), comp);
+    std::sort(v.begin(), v.end(), comp);
+    assert(v == expect);
+}
+
+void test(Pattern p, int n)
+{
+    std::vector<int> in = make_input(p, n);
+    test_one(in, std::less<int>());
+    test_one(in, std::greater<int>());
+
+    std::vector<int> v = in;
+    std::sort(v.begin(), v.end());
+    assert(std::is_sorted(v.begin(), v.end()));
+
+    std::vector<double> d(in.begin(), in.end());
+    std::sort(d.begin(), d.end());
+    assert(std::is_sorted(d.begin(), d.end()));
+    assert(std::equal(d.begin(), d.end(), v.begin()));
+
+    std::vector<Wrapped> w;
+    for (int i = 0; i < n; ++i)
+        w.push_back(Wrapped(in[i]));
+    long count = 0;
+    std::sort(w.begin(), w.end(), CountingLess(&count));
+    for (int i = 0; i < n; ++i)
+        assert(w[i].value == v[i]);
+    assert(count <= 2 * n * log2_ceil(n) + 64);
+}
+
+int main(int, char**)
+{
+    const int sizes[] = {0, 1, 2, 3, 5, 6, 12, 24, 25, 100, 128, 129, 257, 1000, 4099, 65536};
+    for (int p = 0; p < LastPattern; ++p)
+        for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+            test(static_cast<Pattern>(p), sizes[i]);
+
+    return 0;
+}
@@ -1,4 +1,3 @@
-
 //===----------------------------------------------------------------------===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
@@ -7,29 +6,50 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// <execution> feature macros
+// WARNING: This test was generated by generate_feature_test_macro_components.py
+// and should not be edited manually.
+
+// <execution>
 
-/*  Constant                                    Value
-    __cpp_lib_execution                         201603L
+// Test the feature test macros defined by <execution>
 
+/*  Constant               Value
+    __cpp_lib_execution    201603L [C++17]
 */
 
-// XFAIL
-// #include <execution>
-#include <cassert>
+#include <execution>
 #include "test_macros.h"
 
-int main(int, char**)
-{
-//  ensure that the macros that are supposed to be defined in <execution> are defined.
+#if TEST_STD_VER < 14
 
-/*
-#if !defined(__cpp_lib_fooby)
-# error "__cpp_lib_fooby is not defined"
-#elif __cpp_lib_fooby < 201606L
-# error "__cpp_lib_fooby has an invalid value"
-#endif
-*/
+# ifdef __cpp_lib_execution
+#   error "__cpp_lib_execution should not be defined before c++17"
+# endif
+
+#elif TEST_STD_VER == 14
+
+# ifdef __cpp_lib_execution
+#   error "__cpp_lib_execution should not be defined before c++17"
+# endif
+
+#elif TEST_STD_VER == 17
+
+# ifndef __cpp_lib_execution
+#   error "__cpp_lib_execution should be defined in c++17"
+# endif
+# if __cpp_lib_execution != 201603L
+#   error "__cpp_lib_execution should have the value 201603L in c++17"
+# endif
+
+#elif TEST_STD_VER > 17
+
+# ifndef __cpp_lib_execution
+#   error "__cpp_lib_execution should be defined in c++2a"
+# endif
+# if __cpp_lib_execution != 201603L
+#   error "__cpp_lib_execution should have the value 201603L in c++2a"
+# endif
+
+#endif // TEST_STD_VER > 17
 
-  return 0;
-}
+int main(int, char**) { return 0; }
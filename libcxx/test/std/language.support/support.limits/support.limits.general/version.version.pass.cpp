@@ -1005,17 +1005,11 @@
 #   error "__cpp_lib_exchange_function should have the value 201304L in c++17"
 # endif
 
-# if !defined(_LIBCPP_VERSION)
-#   ifndef __cpp_lib_execution
-#     error "__cpp_lib_execution should be defined in c++17"
-#   endif
-#   if __cpp_lib_execution != 201603L
-#     error "__cpp_lib_execution should have the value 201603L in c++17"
-#   endif
-# else // _LIBCPP_VERSION
-#   ifdef __cpp_lib_execution
-#     error "__cpp_lib_execution should not be defined because it is unimplemented in libc++!"
-#   endif
+# ifndef __cpp_lib_execution
+#   error "__cpp_lib_execution should be defined in c++17"
+# endif
+# if __cpp_lib_execution != 201603L
+#   error "__cpp_lib_execution should have the value 201603L in c++17"
 # endif
 
 # ifndef __cpp_lib_filesystem
@@ -1206,17 +1200,11 @@
 #   endif
 # endif
 
-# if !defined(_LIBCPP_VERSION)
-#   ifndef __cpp_lib_memory_resource
-#     error "__cpp_lib_memory_resource should be defined in c++17"
-#   endif
-#   if __cpp_lib_memory_resource != 201603L
-#     error "__cpp_lib_memory_resource should have the value 201603L in c++17"
-#   endif
-# else // _LIBCPP_VERSION
-#   ifdef __cpp_lib_memory_resource
-#     error "__cpp_lib_memory_resource should not be defined because it is unimplemented in libc++!"
-#   endif
+# ifndef __cpp_lib_memory_resource
+#   error "__cpp_lib_memory_resource should be defined in c++17"
+# endif
+# if __cpp_lib_memory_resource != 201603L
+#   error "__cpp_lib_memory_resource should have the value 201603L in c++17"
 # endif
 
 # ifndef __cpp_lib_node_extract
@@ -1696,17 +1684,11 @@
 #   error "__cpp_lib_exchange_function should have the value 201304L in c++2a"
 # endif
 
-# if !defined(_LIBCPP_VERSION)
-#   ifndef __cpp_lib_execution
-#     error "__cpp_lib_execution should be defined in c++2a"
-#   endif
-#   if __cpp_lib_execution != 201603L
-#     error "__cpp_lib_execution should have the value 201603L in c++2a"
-#   endif
-# else // _LIBCPP_VERSION
-#   ifdef __cpp_lib_execution
-#     error "__cpp_lib_execution should not be defined because it is unimplemented in libc++!"
-#   endif
+# ifndef __cpp_lib_execution
+#   error "__cpp_lib_execution should be defined in c++2a"
+# endif
+# if __cpp_lib_execution != 201603L
+#   error "__cpp_lib_execution should have the value 201603L in c++2a"
 # endif
 
 # ifndef __cpp_lib_filesystem
@@ -1927,17 +1909,11 @@
 #   endif
 # endif
 
-# if !defined(_LIBCPP_VERSION)
-#   ifndef __cpp_lib_memory_resource
-#     error "__cpp_lib_memory_resource should be defined in c++2a"
-#   endif
-#   if __cpp_lib_memory_resource != 201603L
-#     error "__cpp_lib_memory_resource should have the value 201603L in c++2a"
-#   endif
-# else // _LIBCPP_VERSION
-#   ifdef __cpp_lib_memory_resource
-#     error "__cpp_lib_memory_resource should not be defined because it is unimplemented in libc++!"
-#   endif
+# ifndef __cpp_lib_memory_resource
+#   error "__cpp_lib_memory_resource should be defined in c++2a"
+# endif
+# if __cpp_lib_memory_resource != 201603L
+#   error "__cpp_lib_memory_resource should have the value 201603L in c++2a"
 # endif
 
 # ifndef __cpp_lib_node_extract
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <numeric>
+
+// template<class ExecutionPolicy, class ForwardIterator, class T, class BinaryOperation>
+//   T reduce(ExecutionPolicy&& exec, ForwardIterator first, ForwardIterator last,
+//            T init, BinaryOperation binary_op);
+//   (and the other forms of reduce and transform_reduce)
+//
+// Ranges large enough to be split into chunks under the parallel policies,
+// with both random access and forward iterators.
+
+#include <numeric>
+#include <cassert>
+#include <execution>
+#include <functional>
+#include <vector>
+
+#include "test_macros.h"
+#include "test_iterators.h"
+
+template <class Iter, class Policy>
+void test(const Policy& pol, int n)
+{
+    std::vector<long> v(n);
+    long sum = 0;
+    long squares = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        v[i] = i % 1000;
+        sum += v[i];
+        squares += v[i] * v[i];
+    }
+    Iter first(v.data());
+    Iter last(v.data() + n);
+
+    assert(std::reduce(pol, first, last) == sum);
+    assert(std::reduce(pol, first, last, 5L) == sum + 5);
+    assert(std::reduce(pol, first, last, 0L, std::plus<long>()) == sum);
+    assert(std::reduce(pol, first, last, 0L, [](long a, long b) { return a > b ? a : b; }) ==
+           (n < 1000 ? n - 1 : 999) * (n > 0));
+
+    assert(std::transform_reduce(pol, first, last, first, 1L) == squares + 1);
+    assert(std::transform_reduce(pol, first, last, first, 0L, std::plus<long>(),
+                                 std::multiplies<long>()) == squares);
+    assert(std::transform_reduce(pol, first, last, 0L, std::plus<long>(),
+                                 [](long x) { return 2 * x; }) == 2 * sum);
+}
+
+template <class Policy>
+void test(const Policy& pol)
+{
+    const int sizes[] = {0, 1, 2, 100, 4095, 4096, 5000, 100003};
+    for (int n : sizes)
+    {
+        test<random_access_iterator<long*> >(pol, n);
+        test<forward_iterator<long*> >(pol, n);
+    }
+}
+
+int main(int, char**)
+{
+    test(std::execution::seq);
+    test(std::execution::par);
+    test(std::execution::par_unseq);
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+// UNSUPPORTED: !libc++ && c++11
+// UNSUPPORTED: !libc++ && c++14
+
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+// XFAIL: with_system_cxx_lib=macosx10.8
+// XFAIL: with_system_cxx_lib=macosx10.7
+
+// <charconv>
+
+// from_chars_result from_chars(const char* first, const char* last,
+//                              float& value,
+//                              chars_format fmt = chars_format::general);
+// from_chars_result from_chars(const char* first, const char* last,
+//                              double& value,
+//                              chars_format fmt = chars_format::general);
+
+#include <charconv>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "test_macros.h"
+
+template <typename T>
+void test(const char* s, T expect, size_t used,
+          std::chars_format fmt = std::chars_format::general)
+{
+    T v = 42;
+    std::from_chars_result r = std::from_chars(s, s + strlen(s), v, fmt);
+    assert(r.ec == std::errc{});
+    assert(r.ptr == s + used);
+    assert(memcmp(&v, &expect, sizeof(v)) == 0);
+}
+
+template <typename T>
+void test_error(const char* s, std::errc ec, size_t used,
+                std::chars_format fmt = std::chars_format::general)
+{
+    T v = 42;
+    std::from_chars_result r = std::from_chars(s, s + strlen(s), v, fmt);
+    assert(r.ec == ec);
+    assert(r.ptr == s + used);
+    assert(v == 42);
+}
+
+int main(int, char**)
+{
+    using std::chars_format;
+    const std::errc invalid = std::errc::invalid_argument;
+    const std::errc range = std::errc::result_out_of_range;
+
+    test("0", 0.0, 1);
+    test("-0", -0.0, 2);
+    test("1.5", 1.5, 3);
+    test(".5", 0.5, 2);
+    test("5.", 5.0, 2);
+    test("0.1", 0.1, 3);
+    test("1e5", 1e5, 3);
+    test("1E-5", 1e-5, 4);
+    test("1e", 1.0, 1);
+    test("1e+", 1.0, 1);
+    test("12abc", 12.0, 2);
+    test("9007199254740993", 9007199254740992.0, 16);
+    test("9007199254740993.0000000000000000001", 9007199254740994.0, 36);
+    test("1.7976931348623157e308", 1.7976931348623157e308, 22);
+    test("2.2250738585072011e-308", 2.2250738585072011e-308, 23);
+    test("4.9406564584124654e-324", 5e-324, 23);
+    test("2.4703282292062328e-324", 5e-324, 23);
+    test("0.000e999999999", 0.0, 15);
+    const double inf = std::numeric_limits<double>::infinity();
+    test("inf", inf, 3);
+    test("-Infinity", -inf, 9);
+    test("infinite", inf, 3);
+
+    test("1.00000005960464477550", 1.0000001f, 22);
+    test("1.000000059604644775390625", 1.0f, 26);
+    test("3.4028235e38", 3.4028235e38f, 12);
+    test("1.4e-45", 1e-45f, 7);
+
+    // A value halfway between two doubles rounds to even, one past it up.
+    test("1.00000000000000011102230246251565404236316680908203125", 1.0, 55);
+    test("1.000000000000000111022302462515654042363166809082031251",
+         1.0000000000000002, 56);
+    char digits[1024] = "0.";
+    memset(digits + 2, '0', 900);
+    strcat(digits, "1e900");
+    test(digits, 0.1, strlen(digits));
+    memset(digits + 2, '0', 900);
+    strcpy(digits + 902, "1e-10");
+    digits[0] = '7';
+    test(digits, 7e-10, strlen(digits));
+
+    test("1e5", 1e5, 3, chars_format::scientific);
+    test("1e5", 1.0, 1, chars_format::fixed);
+    test("1.5", 1.5, 3, chars_format::fixed);
+    test("1p3", 8.0, 3, chars_format::hex);
+    test("1.8", 1.5, 3, chars_format::hex);
+    test("-1.fffffffffffffp+1023", -1.7976931348623157e308, 22,
+         chars_format::hex);
+    test("0.0000000000001p-1022", 5e-324, 21, chars_format::hex);
+    test("0x1p3", 0.0, 1, chars_format::hex);
+    test("1.000001p0", 1.0f, 10, chars_format::hex);
+    test("1.000003p0", 1.0000002f, 10, chars_format::hex);
+
+    double d = 0;
+    const char* nan = "-nan(ind)";
+    std::from_chars_result r = std::from_chars(nan, nan + strlen(nan), d);
+    assert(r.ec == std::errc{});
+    assert(r.ptr == nan + strlen(nan));
+    assert(std::isnan(d) && std::signbit(d));
+
+    test_error<double>("", invalid, 0);
+    test_error<double>(".", invalid, 0);
+    test_error<double>("-", invalid, 0);
+    test_error<double>("e5", invalid, 0);
+    test_error<double>("+1", invalid, 0);
+    test_error<double>(" 1", invalid, 0);
+    test_error<double>("1.5", invalid, 0, chars_format::scientific);
+    test_error<double>("1e400", range, 5);
+    test_error<double>("-1e400", range, 6);
+    test_error<double>("1e-400", range, 6);
+    test_error<double>("1p2000", range, 6, chars_format::hex);
+    test_error<float>("1e39", range, 4);
+    test_error<float>("1e-46", range, 5);
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+// UNSUPPORTED: !libc++ && c++11
+// UNSUPPORTED: !libc++ && c++14
+
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+// XFAIL: with_system_cxx_lib=macosx10.8
+// XFAIL: with_system_cxx_lib=macosx10.7
+
+// <charconv>
+
+// to_chars_result to_chars(char* first, char* last, float value);
+// to_chars_result to_chars(char* first, char* last, double value);
+// to_chars_result to_chars(char* first, char* last, float value,
+//                          chars_format fmt);
+// to_chars_result to_chars(char* first, char* last, double value,
+//                          chars_format fmt);
+
+#include <charconv>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "test_macros.h"
+
+template <typename T>
+void test(T v, const char* expect)
+{
+    char buf[400];
+    const size_t len = strlen(expect);
+
+    std::to_chars_result r = std::to_chars(buf, buf + len - 1, v);
+    assert(r.ptr == buf + len - 1);
+    assert(r.ec == std::errc::value_too_large);
+
+    r = std::to_chars(buf, buf + sizeof(buf), v);
+    assert(r.ec == std::errc{});
+    assert(r.ptr == buf + len);
+    assert(memcmp(buf, expect, len) == 0);
+}
+
+template <typename T>
+void test(T v, std::chars_format fmt, const char* expect)
+{
+    char buf[400];
+    const size_t len = strlen(expect);
+
+    std::to_chars_result r = std::to_chars(buf, buf + len - 1, v, fmt);
+    assert(r.ptr == buf + len - 1);
+    assert(r.ec == std::errc::value_too_large);
+
+    r = std::to_chars(buf, buf + sizeof(buf), v, fmt);
+    assert(r.ec == std::errc{});
+    assert(r.ptr == buf + len);
+    assert(memcmp(buf, expect, len) == 0);
+}
+
+// Checks that the shortest representation reads back as the same value.
+template <typename T>
+void test_round_trip(T v)
+{
+    const std::chars_format formats[] = {
+        std::chars_format::general, std::chars_format::fixed,
+        std::chars_format::scientific, std::chars_format::hex};
+    char buf[400];
+    for (std::chars_format fmt : formats)
+    {
+        std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), v, fmt);
+        assert(r.ec == std::errc{});
+        T back = 0;
+        std::from_chars_result f = std::from_chars(buf, r.ptr, back, fmt);
+        assert(f.ec == std::errc{});
+        assert(f.ptr == r.ptr);
+        assert(memcmp(&back, &v, sizeof(v)) == 0);
+    }
+}
+
+int main(int, char**)
+{
+    using std::chars_format;
+
+    test(0.0, "0");
+    test(-0.0, "-0");
+    test(1.0, "1");
+    test(0.1, "0.1");
+    test(100.0, "100");
+    test(123456.0, "123456");
+    test(0.001, "0.001");
+    test(0.0001, "1e-04");
+    test(1e21, "1e+21");
+    test(1.5e-300, "1.5e-300");
+    test(5e-324, "5e-324");
+    test(1.7976931348623157e308, "1.7976931348623157e+308");
+    test(-2.5, "-2.5");
+    // Fixed notation is shorter, and then the value is printed exactly.
+    test(123456789012345680000.0, "123456789012345683968");
+    test(std::numeric_limits<double>::infinity(), "inf");
+    test(-std::numeric_limits<double>::infinity(), "-inf");
+    test(std::numeric_limits<double>::quiet_NaN(), "nan");
+
+    test(0.1f, "0.1");
+    test(16777216.0f, "16777216");
+    test(3.4028235e38f, "3.4028235e+38");
+    test(1e-45f, "1e-45");
+    test(1.1754944e-38f, "1.1754944e-38");
+
+    test(0.0, chars_format::scientific, "0e+00");
+    test(1.0, chars_format::scientific, "1e+00");
+    test(100.0, chars_format::scientific, "1e+02");
+    test(0.1, chars_format::scientific, "1e-01");
+    test(1e100, chars_format::scientific, "1e+100");
+    test(1234567.0, chars_format::scientific, "1.234567e+06");
+
+    test(0.0001, chars_format::fixed, "0.0001");
+    test(1e-5, chars_format::fixed, "0.00001");
+    test(1e22, chars_format::fixed, "10000000000000000000000");
+    test(1e23, chars_format::fixed, "99999999999999991611392");
+    test(3.4028235e38f, chars_format::fixed,
+         "340282346638528859811704183484516925440");
+
+    // As %g, fixed for exponents in [-4, 6).
+    test(123456.0, chars_format::general, "123456");
+    test(1e6, chars_format::general, "1e+06");
+    test(1234567.0, chars_format::general, "1.234567e+06");
+    test(0.0001, chars_format::general, "0.0001");
+    test(1e-5, chars_format::general, "1e-05");
+
+    test(0.0, chars_format::hex, "0p+0");
+    test(1.0, chars_format::hex, "1p+0");
+    test(0.1, chars_format::hex, "1.999999999999ap-4");
+    test(1e6, chars_format::hex, "1.e848p+19");
+    test(5e-324, chars_format::hex, "0.0000000000001p-1022");
+    test(1.7976931348623157e308, chars_format::hex, "1.fffffffffffffp+1023");
+    test(0.1f, chars_format::hex, "1.99999ap-4");
+    test(1e-45f, chars_format::hex, "0.000002p-126");
+
+    uint64_t state = 88172645463325252u;
+    for (int i = 0; i < 10000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        double d;
+        memcpy(&d, &state, sizeof(d));
+        if (std::isfinite(d))
+            test_round_trip(d);
+        float f;
+        uint32_t bits = static_cast<uint32_t>(state);
+        memcpy(&f, &bits, sizeof(f));
+        if (std::isfinite(f))
+            test_round_trip(f);
+    }
+
+    return 0;
+}
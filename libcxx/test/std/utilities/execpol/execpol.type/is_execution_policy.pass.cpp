@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <execution>
+
+// template<class T> struct is_execution_policy;
+// template<class T> inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+//
+// namespace execution {
+//   inline constexpr sequenced_policy            seq{unspecified};
+//   inline constexpr parallel_policy             par{unspecified};
+//   inline constexpr parallel_unsequenced_policy par_unseq{unspecified};
+//   inline constexpr unsequenced_policy          unseq{unspecified}; // C++20
+// }
+
+#include <execution>
+#include <type_traits>
+
+#include "test_macros.h"
+
+template <class T, bool Expect>
+void test()
+{
+    static_assert(std::is_execution_policy<T>::value == Expect, "");
+    static_assert(std::is_execution_policy_v<T> == Expect, "");
+    static_assert(std::is_base_of<std::integral_constant<bool, Expect>,
+                                  std::is_execution_policy<T> >::value, "");
+}
+
+int main(int, char**)
+{
+    test<std::execution::sequenced_policy, true>();
+    test<std::execution::parallel_policy, true>();
+    test<std::execution::parallel_unsequenced_policy, true>();
+#if TEST_STD_VER > 17
+    test<std::execution::unsequenced_policy, true>();
+#endif
+
+    test<int, false>();
+    test<std::execution::sequenced_policy*, false>();
+    test<std::execution::parallel_policy&, false>();
+    test<const std::execution::parallel_policy, false>();
+
+    static_assert(std::is_same<decltype(std::execution::seq),
+                               const std::execution::sequenced_policy>::value, "");
+    static_assert(std::is_same<decltype(std::execution::par),
+                               const std::execution::parallel_policy>::value, "");
+    static_assert(std::is_same<decltype(std::execution::par_unseq),
+                               const std::execution::parallel_unsequenced_policy>::value, "");
+#if TEST_STD_VER > 17
+    static_assert(std::is_same<decltype(std::execution::unseq),
+                               const std::execution::unsequenced_policy>::value, "");
+#endif
+
+    // The policies can't be default constructed.
+    static_assert(!std::is_default_constructible<std::execution::sequenced_policy>::value, "");
+    static_assert(!std::is_default_constructible<std::execution::parallel_policy>::value, "");
+    static_assert(std::is_copy_constructible<std::execution::parallel_policy>::value, "");
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <memory>
+
+// template <class T> struct atomic<shared_ptr<T>>;
+// template <class T> struct atomic<weak_ptr<T>>;
+
+#include <memory>
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "test_macros.h"
+
+struct Counted
+{
+    static std::atomic<int> alive;
+    int value;
+    explicit Counted(int v) : value(v) { ++alive; }
+    Counted(const Counted& c) : value(c.value) { ++alive; }
+    ~Counted() { --alive; }
+};
+
+std::atomic<int> Counted::alive(0);
+
+void test_shared()
+{
+    typedef std::atomic<std::shared_ptr<Counted> > A;
+    static_assert(std::is_same<A::value_type, std::shared_ptr<Counted> >::value, "");
+    static_assert(!std::is_copy_constructible<A>::value, "");
+    static_assert(!std::is_copy_assignable<A>::value, "");
+    {
+        A a;
+        assert(a.load() == nullptr);
+        A n(nullptr);
+        assert(n.load() == nullptr);
+        assert(!a.is_lock_free() || A::is_always_lock_free);
+    }
+    {
+        std::shared_ptr<Counted> p = std::make_shared<Counted>(1);
+        A a(p);
+        assert(a.load() == p);
+        assert(static_cast<std::shared_ptr<Counted> >(a) == p);
+        assert(p.use_count() == 2);
+
+        std::shared_ptr<Counted> q = std::make_shared<Counted>(2);
+        a.store(q);
+        assert(a.load(std::memory_order_acquire) == q);
+        assert(p.use_count() == 1);
+
+        std::shared_ptr<Counted> r = a.exchange(p);
+        assert(r == q);
+        assert(a.load() == p);
+        a = nullptr;
+        assert(a.load() == nullptr);
+        a = q;
+        assert(a.load() == q);
+    }
+    assert(Counted::alive == 0);
+    {
+        std::shared_ptr<Counted> p = std::make_shared<Counted>(1);
+        std::shared_ptr<Counted> q = std::make_shared<Counted>(2);
+        std::shared_ptr<Counted> w = std::make_shared<Counted>(3);
+        A a(p);
+
+        std::shared_ptr<Counted> e = q;
+        assert(!a.compare_exchange_strong(e, w));
+        assert(e == p);
+        assert(a.load() == p);
+
+        assert(a.compare_exchange_strong(e, w));
+        assert(e == p);
+        assert(a.load() == w);
+
+        // Equal pointers with a different owner don't compare equivalent.
+        std::shared_ptr<Counted> alias(q, w.get());
+        e = alias;
+        assert(!a.compare_exchange_weak(e, p, std::memory_order_acq_rel,
+                                        std::memory_order_acquire));
+        assert(e == w && !e.owner_before(w) && !w.owner_before(e));
+        while (!a.compare_exchange_weak(e, p))
+            ;
+        assert(a.load() == p);
+
+        A empty;
+        std::shared_ptr<Counted> none;
+        assert(empty.compare_exchange_strong(none, q, std::memory_order_seq_cst));
+        assert(empty.load() == q);
+    }
+    assert(Counted::alive == 0);
+}
+
+void test_weak()
+{
+    typedef std::atomic<std::weak_ptr<Counted> > A;
+    static_assert(std::is_same<A::value_type, std::weak_ptr<Counted> >::value, "");
+    {
+        A a;
+        assert(a.load().expired());
+    }
+    {
+        std::shared_ptr<Counted> p = std::make_shared<Counted>(1);
+        std::shared_ptr<Counted> q = std::make_shared<Counted>(2);
+        A a(p);
+        assert(a.load().lock() == p);
+        a = q;
+        assert(a.load().lock() == q);
+        std::weak_ptr<Counted> old = a.exchange(p);
+        assert(old.lock() == q);
+
+        std::weak_ptr<Counted> e = q;
+        assert(!a.compare_exchange_strong(e, q));
+        assert(e.lock() == p);
+        assert(a.compare_exchange_strong(e, q));
+        assert(a.load().lock() == q);
+    }
+    assert(Counted::alive == 0);
+}
+
+// Readers copying the value out while writers replace it must always see a
+// whole value, and every value must be destroyed exactly once.
+void test_concurrent()
+{
+    const int Writers = 2;
+    const int Readers = 4;
+    const int Iterations = 2000;
+    {
+        std::atomic<std::shared_ptr<Counted> > a(std::make_shared<Counted>(0));
+        std::vector<std::thread> threads;
+        for (int t = 0; t < Writers; ++t)
+            threads.push_back(std::thread([&a, t]() {
+                for (int i = 0; i < Iterations; ++i) {
+                    if (i % 2)
+                        a.store(std::make_shared<Counted>(t));
+                    else {
+                        std::shared_ptr<Counted> e = a.load();
+                        a.compare_exchange_strong(e, std::make_shared<Counted>(t));
+                    }
+                }
+            }));
+        for (int t = 0; t < Readers; ++t)
+            threads.push_back(std::thread([&a]() {
+                for (int i = 0; i < Iterations; ++i) {
+                    std::shared_ptr<Counted> p = a.load();
+                    assert(p && p->value >= 0 && p->value < Writers);
+                }
+            }));
+        for (size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+    }
+    assert(Counted::alive == 0);
+}
+
+int main(int, char**)
+{
+    test_shared();
+    test_weak();
+    test_concurrent();
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// template <class T> class polymorphic_allocator;
+
+#include <memory_resource>
+#include <cassert>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+
+namespace pmr = std::pmr;
+
+struct CountingResource : pmr::memory_resource
+{
+    int allocs = 0;
+    int deallocs = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        ++allocs;
+        return pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        ++deallocs;
+        pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+        return &other == this;
+    }
+};
+
+// Takes the allocator as a trailing argument.
+struct Trailing
+{
+    using allocator_type = pmr::polymorphic_allocator<char>;
+    int value;
+    pmr::memory_resource* res;
+    Trailing(int v, const allocator_type& a) : value(v), res(a.resource()) {}
+};
+
+// Takes the allocator after allocator_arg.
+struct Leading
+{
+    using allocator_type = pmr::polymorphic_allocator<char>;
+    int value;
+    pmr::memory_resource* res;
+    Leading(std::allocator_arg_t, const allocator_type& a, int v)
+        : value(v), res(a.resource()) {}
+};
+
+int main(int, char**)
+{
+    static_assert(std::is_same<pmr::polymorphic_allocator<int>::value_type,
+                               int>::value, "");
+    {
+        pmr::polymorphic_allocator<int> a;
+        assert(a.resource() == pmr::get_default_resource());
+    }
+    {
+        CountingResource r;
+        pmr::polymorphic_allocator<int> a(&r);
+        assert(a.resource() == &r);
+        int* p = a.allocate(10);
+        assert(r.allocs == 1);
+        a.deallocate(p, 10);
+        assert(r.deallocs == 1);
+
+        pmr::polymorphic_allocator<double> b(a);
+        assert(b.resource() == &r);
+        assert(a == b);
+        CountingResource r2;
+        assert(a != pmr::polymorphic_allocator<int>(&r2));
+
+        assert(a.select_on_container_copy_construction().resource() ==
+               pmr::get_default_resource());
+    }
+    {
+        // construct passes the allocator on to the element.
+        CountingResource r;
+        pmr::polymorphic_allocator<Trailing> a(&r);
+        Trailing* t = a.allocate(1);
+        a.construct(t, 42);
+        assert(t->value == 42 && t->res == &r);
+        a.destroy(t);
+        a.deallocate(t, 1);
+
+        pmr::polymorphic_allocator<Leading> b(&r);
+        Leading* l = b.allocate(1);
+        b.construct(l, 7);
+        assert(l->value == 7 && l->res == &r);
+        b.destroy(l);
+        b.deallocate(l, 1);
+    }
+    {
+        CountingResource r;
+        using P = std::pair<Trailing, int>;
+        pmr::polymorphic_allocator<P> a(&r);
+        P* p = a.allocate(1);
+        a.construct(p, std::piecewise_construct, std::make_tuple(1),
+                    std::make_tuple(2));
+        assert(p->first.value == 1 && p->first.res == &r && p->second == 2);
+        a.destroy(p);
+        a.construct(p, 3, 4);
+        assert(p->first.value == 3 && p->first.res == &r && p->second == 4);
+        a.destroy(p);
+        a.deallocate(p, 1);
+    }
+    {
+        // The pmr containers hand the resource down to their elements.
+        CountingResource r;
+        {
+            pmr::vector<pmr::string> v(&r);
+            v.emplace_back("a string that does not fit the small buffer");
+            v.push_back("another string that does not fit the small buffer");
+            assert(v[0].get_allocator().resource() == &r);
+            assert(v[1].get_allocator().resource() == &r);
+
+            pmr::map<int, pmr::string> m(&r);
+            m.emplace(1, "yet another string too long for the small buffer");
+            assert(m[1].get_allocator().resource() == &r);
+            assert(m[2].get_allocator().resource() == &r);
+        }
+        assert(r.allocs > 0 && r.allocs == r.deallocs);
+    }
+
+    return 0;
+}
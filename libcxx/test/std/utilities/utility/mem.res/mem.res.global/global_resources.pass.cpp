@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// memory_resource* new_delete_resource() noexcept;
+// memory_resource* null_memory_resource() noexcept;
+// memory_resource* set_default_resource(memory_resource* r) noexcept;
+// memory_resource* get_default_resource() noexcept;
+
+#include <memory_resource>
+#include <cassert>
+#include <new>
+
+#include "test_macros.h"
+
+namespace pmr = std::pmr;
+
+int main(int, char**)
+{
+    ASSERT_NOEXCEPT(pmr::new_delete_resource());
+    ASSERT_NOEXCEPT(pmr::null_memory_resource());
+    ASSERT_NOEXCEPT(pmr::get_default_resource());
+    ASSERT_NOEXCEPT(pmr::set_default_resource(nullptr));
+
+    pmr::memory_resource* nd = pmr::new_delete_resource();
+    pmr::memory_resource* null = pmr::null_memory_resource();
+    assert(nd != nullptr && null != nullptr);
+    assert(nd == pmr::new_delete_resource());
+    assert(null == pmr::null_memory_resource());
+    assert(*nd == *nd);
+    assert(*nd != *null);
+
+    {
+        void* p = nd->allocate(100);
+        assert(p != nullptr);
+        nd->deallocate(p, 100);
+        p = nd->allocate(64, 64);
+        assert(reinterpret_cast<std::uintptr_t>(p) % 64 == 0);
+        nd->deallocate(p, 64, 64);
+    }
+#ifndef TEST_HAS_NO_EXCEPTIONS
+    try {
+        (void)null->allocate(1);
+        assert(false);
+    } catch (const std::bad_alloc&) {
+    }
+#endif
+    null->deallocate(nullptr, 0);
+
+    assert(pmr::get_default_resource() == nd);
+    assert(pmr::set_default_resource(null) == nd);
+    assert(pmr::get_default_resource() == null);
+    assert(pmr::set_default_resource(nullptr) == null);
+    assert(pmr::get_default_resource() == nd);
+    assert(pmr::set_default_resource(nd) == nd);
+    assert(pmr::get_default_resource() == nd);
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// class monotonic_buffer_resource;
+
+#include <memory_resource>
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "test_macros.h"
+
+namespace pmr = std::pmr;
+
+struct CountingResource : pmr::memory_resource
+{
+    int allocs = 0;
+    int deallocs = 0;
+    std::size_t last_size = 0;
+    std::size_t outstanding = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        ++allocs;
+        last_size = bytes;
+        outstanding += bytes;
+        return pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        ++deallocs;
+        outstanding -= bytes;
+        pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+        return &other == this;
+    }
+};
+
+bool is_aligned(void* p, std::size_t align) {
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+int main(int, char**)
+{
+    {
+        pmr::monotonic_buffer_resource m;
+        assert(m.upstream_resource() == pmr::get_default_resource());
+        assert(m == m);
+        pmr::monotonic_buffer_resource m2;
+        assert(m != m2);
+    }
+    {
+        // The initial buffer is used up before the upstream resource.
+        alignas(16) char buffer[256];
+        CountingResource r;
+        pmr::monotonic_buffer_resource m(buffer, sizeof(buffer), &r);
+        char* p1 = static_cast<char*>(m.allocate(10, 1));
+        char* p2 = static_cast<char*>(m.allocate(8, 8));
+        assert(p1 >= buffer && p1 + 10 <= buffer + sizeof(buffer));
+        assert(p2 >= p1 + 10 && p2 + 8 <= buffer + sizeof(buffer));
+        assert(is_aligned(p2, 8));
+        assert(r.allocs == 0);
+
+        // Deallocation does nothing.
+        m.deallocate(p1, 10, 1);
+        assert(m.allocate(10, 1) != p1);
+
+        void* p3 = m.allocate(300, 32);
+        assert(is_aligned(p3, 32));
+        assert(r.allocs == 1);
+        std::size_t first = r.last_size;
+        assert(first >= 300);
+
+        // Each chunk is bigger than the previous one.
+        for (int i = 0; i != 4; ++i)
+            (void)m.allocate(first);
+        assert(r.last_size > first);
+
+        m.release();
+        assert(r.outstanding == 0);
+        assert(r.deallocs == r.allocs);
+        // After release() the initial buffer is reused.
+        assert(m.allocate(10, 1) == buffer);
+    }
+    {
+        CountingResource r;
+        {
+            pmr::monotonic_buffer_resource m(100, &r);
+            (void)m.allocate(1);
+            assert(r.allocs == 1 && r.last_size >= 100);
+            for (int i = 0; i != 1000; ++i) {
+                void* p = m.allocate(i % 64 + 1, std::size_t(1) << (i % 6));
+                assert(is_aligned(p, std::size_t(1) << (i % 6)));
+            }
+        }
+        // Destruction releases everything.
+        assert(r.outstanding == 0);
+    }
+    {
+        // Zero-sized requests still get distinct storage.
+        pmr::monotonic_buffer_resource m(std::size_t(1));
+        void* p = m.allocate(0);
+        assert(p != nullptr);
+    }
+#ifndef TEST_HAS_NO_EXCEPTIONS
+    {
+        char buffer[64];
+        pmr::monotonic_buffer_resource m(buffer, sizeof(buffer),
+                                         pmr::null_memory_resource());
+        (void)m.allocate(32);
+        try {
+            (void)m.allocate(64);
+            assert(false);
+        } catch (const std::bad_alloc&) {
+        }
+    }
+#endif
+    {
+        // Works as the resource of a container.
+        pmr::monotonic_buffer_resource m;
+        pmr::vector<int> v(&m);
+        for (int i = 0; i != 10000; ++i)
+            v.push_back(i);
+        for (int i = 0; i != 10000; ++i)
+            assert(v[i] == i);
+    }
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// class synchronized_pool_resource;
+
+#include <memory_resource>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test_macros.h"
+
+namespace pmr = std::pmr;
+
+// Not thread-safe on its own: the pool resource must serialize its calls.
+struct CountingResource : pmr::memory_resource
+{
+    std::atomic<bool> busy{false};
+    long allocs = 0;
+    long deallocs = 0;
+    std::size_t outstanding = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        assert(!busy.exchange(true));
+        ++allocs;
+        outstanding += bytes;
+        void* p = pmr::new_delete_resource()->allocate(bytes, align);
+        busy = false;
+        return p;
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        assert(!busy.exchange(true));
+        ++deallocs;
+        outstanding -= bytes;
+        pmr::new_delete_resource()->deallocate(p, bytes, align);
+        busy = false;
+    }
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+        return &other == this;
+    }
+};
+
+const int Threads = 4;
+const int Iterations = 2000;
+
+void churn(pmr::memory_resource* r, int seed) {
+    std::vector<std::pair<int*, std::size_t> > live;
+    for (int i = 0; i != Iterations; ++i) {
+        std::size_t n = (i * 7 + seed) % 300 + 1;
+        int* p = static_cast<int*>(r->allocate(n * sizeof(int), alignof(int)));
+        for (std::size_t j = 0; j != n; ++j)
+            p[j] = seed;
+        live.push_back(std::make_pair(p, n));
+        if (i % 3 == 0) {
+            std::pair<int*, std::size_t> q = live[live.size() / 2];
+            live[live.size() / 2] = live.back();
+            live.pop_back();
+            for (std::size_t j = 0; j != q.second; ++j)
+                assert(q.first[j] == seed);
+            r->deallocate(q.first, q.second * sizeof(int), alignof(int));
+        }
+    }
+    for (auto& q : live)
+        r->deallocate(q.first, q.second * sizeof(int), alignof(int));
+}
+
+int main(int, char**)
+{
+    {
+        pmr::synchronized_pool_resource p;
+        assert(p.upstream_resource() == pmr::get_default_resource());
+        assert(p.options().max_blocks_per_chunk > 0);
+        assert(p == p);
+    }
+    {
+        CountingResource r;
+        {
+            pmr::pool_options opts;
+            opts.largest_required_pool_block = 512;
+            pmr::synchronized_pool_resource p(opts, &r);
+            assert(p.upstream_resource() == &r);
+
+            std::vector<std::thread> ts;
+            for (int i = 0; i != Threads; ++i)
+                ts.emplace_back(churn, &p, i);
+            for (auto& t : ts)
+                t.join();
+
+            // A thread that comes later takes over the pools of one that
+            // exited.
+            std::thread(churn, &p, 5).join();
+
+            churn(&p, 6);
+            p.release();
+            assert(r.outstanding == 0);
+            churn(&p, 7);
+        }
+        assert(r.outstanding == 0);
+        assert(r.allocs == r.deallocs);
+    }
+    {
+        // Memory allocated on one thread may be freed on another.
+        CountingResource r;
+        {
+            pmr::synchronized_pool_resource p(&r);
+            std::vector<void*> blocks;
+            std::thread([&] {
+                for (int i = 0; i != 1000; ++i)
+                    blocks.push_back(p.allocate(32));
+            }).join();
+            std::thread t([&] {
+                for (void* b : blocks)
+                    p.deallocate(b, 32);
+            });
+            t.join();
+            for (int i = 0; i != 1000; ++i)
+                (void)p.allocate(32);
+        }
+        assert(r.outstanding == 0);
+    }
+    {
+        // A thread that outlives the resource, and a resource created at the
+        // same address afterwards.
+        std::atomic<int> step(0);
+        alignas(pmr::synchronized_pool_resource)
+            unsigned char storage[sizeof(pmr::synchronized_pool_resource)];
+        pmr::synchronized_pool_resource* p =
+            ::new (storage) pmr::synchronized_pool_resource();
+        std::thread t([&] {
+            p->deallocate(p->allocate(16), 16);
+            step = 1;
+            while (step != 2)
+                std::this_thread::yield();
+            p->deallocate(p->allocate(16), 16);
+            step = 3;
+        });
+        while (step != 1)
+            std::this_thread::yield();
+        p->~synchronized_pool_resource();
+        p = ::new (storage) pmr::synchronized_pool_resource();
+        step = 2;
+        while (step != 3)
+            std::this_thread::yield();
+        t.join();
+        p->~synchronized_pool_resource();
+    }
+    {
+        pmr::synchronized_pool_resource p;
+        std::vector<std::thread> ts;
+        for (int i = 0; i != Threads; ++i)
+            ts.emplace_back([&p, i] {
+                pmr::vector<pmr::string> v(&p);
+                for (int j = 0; j != 500; ++j)
+                    v.emplace_back(100, char('a' + i));
+                for (auto& s : v)
+                    assert(s == pmr::string(100, char('a' + i)));
+            });
+        for (auto& t : ts)
+            t.join();
+    }
+
+    return 0;
+}
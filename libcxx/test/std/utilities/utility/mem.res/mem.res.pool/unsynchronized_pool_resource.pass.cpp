@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// class unsynchronized_pool_resource;
+
+#include <memory_resource>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "test_macros.h"
+
+namespace pmr = std::pmr;
+
+struct CountingResource : pmr::memory_resource
+{
+    int allocs = 0;
+    int deallocs = 0;
+    std::size_t outstanding = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        ++allocs;
+        outstanding += bytes;
+        return pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        ++deallocs;
+        outstanding -= bytes;
+        pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+        return &other == this;
+    }
+};
+
+bool is_aligned(void* p, std::size_t align) {
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+int main(int, char**)
+{
+    {
+        pmr::unsynchronized_pool_resource p;
+        assert(p.upstream_resource() == pmr::get_default_resource());
+        pmr::pool_options opts = p.options();
+        assert(opts.max_blocks_per_chunk > 0);
+        assert(opts.largest_required_pool_block > 0);
+        assert(p == p);
+        pmr::unsynchronized_pool_resource p2;
+        assert(p != p2);
+    }
+    {
+        pmr::pool_options opts;
+        opts.max_blocks_per_chunk = 16;
+        opts.largest_required_pool_block = 100;
+        pmr::unsynchronized_pool_resource p(opts);
+        assert(p.options().max_blocks_per_chunk == 16);
+        assert(p.options().largest_required_pool_block >= 100);
+    }
+    {
+        CountingResource r;
+        pmr::pool_options opts;
+        opts.largest_required_pool_block = 256;
+        pmr::unsynchronized_pool_resource p(opts, &r);
+        assert(p.upstream_resource() == &r);
+        assert(r.allocs == 0);
+
+        // Freed blocks are handed out again.
+        void* a = p.allocate(24);
+        void* b = p.allocate(24);
+        assert(a != b);
+        p.deallocate(a, 24);
+        assert(p.allocate(24) == a);
+        int pooled = r.allocs;
+
+        // Small requests keep coming from the same chunks.
+        std::vector<void*> v;
+        for (int i = 0; i != 100; ++i)
+            v.push_back(p.allocate(16));
+        for (void* q : v)
+            p.deallocate(q, 16);
+        for (int i = 0; i != 100; ++i)
+            (void)p.allocate(16);
+        assert(r.allocs < pooled + 10);
+
+        // Alignment is honoured in the pools and outside them.
+        for (std::size_t align = 1; align <= 64; align *= 2) {
+            void* q = p.allocate(align, align);
+            assert(is_aligned(q, align));
+            p.deallocate(q, align, align);
+        }
+
+        // Oversized requests go upstream and back right away.
+        int before = r.deallocs;
+        void* big = p.allocate(10000);
+        p.deallocate(big, 10000);
+        assert(r.deallocs == before + 1);
+
+        (void)p.allocate(10000);
+        p.release();
+        assert(r.outstanding == 0);
+        assert(r.allocs == r.deallocs);
+
+        // The resource is still usable after release().
+        void* c = p.allocate(24);
+        p.deallocate(c, 24);
+    }
+    {
+        CountingResource r;
+        {
+            pmr::unsynchronized_pool_resource p(&r);
+            pmr::map<int, pmr::vector<int>> m(&p);
+            for (int i = 0; i != 1000; ++i)
+                m[i % 37].push_back(i);
+            for (int i = 0; i != 37; ++i)
+                for (int j = 0; j != int(m[i].size()); ++j)
+                    assert(m[i][j] == i + 37 * j);
+            m.clear();
+        }
+        assert(r.outstanding == 0);
+    }
+
+    return 0;
+}
@@ -174,6 +174,52 @@ static size_t get_cxa_exception_offset() {
   return offset;
 }
 
+// Buffers for exceptions up to this size, header included, all come in this
+// one size, so that a thread can keep the ones it frees for its next throws
+// rather than go back to malloc each time.
+static const size_t cached_buffer_size = 256;
+
+// Precedes every exception buffer, keeping what follows it maximally
+// aligned, and records whether the buffer may be cached.
+struct __attribute__((aligned)) buffer_prefix {
+    bool cacheable;
+};
+
+static void *allocate_buffer(size_t size) {
+    buffer_prefix *prefix = NULL;
+    bool cacheable = size <= cached_buffer_size;
+    if (cacheable) {
+        __cxa_eh_globals *globals = __cxa_get_globals();
+        if (globals->cachedBufferCount != 0)
+            prefix = static_cast<buffer_prefix *>(
+                globals->cachedBuffers[--globals->cachedBufferCount]);
+    }
+    if (NULL == prefix) {
+        prefix = static_cast<buffer_prefix *>(__aligned_malloc_with_fallback(
+            sizeof(buffer_prefix) + (cacheable ? cached_buffer_size : size)));
+        if (NULL == prefix)
+            return NULL;
+        // The emergency pool is too small to leave parked in one thread.
+        prefix->cacheable = cacheable && !__is_fallback_ptr(prefix);
+    }
+    return prefix + 1;
+}
+
+static void free_buffer(void *buffer) {
+    buffer_prefix *prefix = static_cast<buffer_prefix *>(buffer) - 1;
+    if (prefix->cacheable) {
+        // A thread that has never thrown has nowhere to keep the buffer.
+        __cxa_eh_globals *globals = __cxa_get_globals_fast();
+        const unsigned capacity =
+            sizeof(globals->cachedBuffers) / sizeof(globals->cachedBuffers[0]);
+        if (NULL != globals && globals->cachedBufferCount < capacity) {
+            globals->cachedBuffers[globals->cachedBufferCount++] = prefix;
+            return;
+        }
+    }
+    __aligned_free_with_fallback(prefix);
+}
+
 extern "C" {
 
 //  Allocate a __cxa_exception object, and zero-fill it.
@@ -187,8 +233,7 @@ void *__cxa_allocate_exception(size_t thrown_size) throw() {
     // Allocate extra space before the __cxa_exception header to ensure the
     // start of the thrown object is sufficiently aligned.
     size_t header_offset = get_cxa_exception_offset();
-    char *raw_buffer =
-        (char *)__aligned_malloc_with_fallback(header_offset + actual_size);
+    char *raw_buffer = (char *)allocate_buffer(header_offset + actual_size);
     if (NULL == raw_buffer)
         std::terminate();
     __cxa_exception *exception_header =
@@ -204,7 +249,7 @@ void __cxa_free_exception(void *thrown_object) throw() {
     size_t header_offset = get_cxa_exception_offset();
     char *raw_buffer =
         ((char *)cxa_exception_from_thrown_object(thrown_object)) - header_offset;
-    __aligned_free_with_fallback((void *)raw_buffer);
+    free_buffer((void *)raw_buffer);
 }
 
 
@@ -213,7 +258,7 @@ void __cxa_free_exception(void *thrown_object) throw() {
 //  Otherwise, it will work like __cxa_allocate_exception.
 void * __cxa_allocate_dependent_exception () {
     size_t actual_size = sizeof(__cxa_dependent_exception);
-    void *ptr = __aligned_malloc_with_fallback(actual_size);
+    void *ptr = allocate_buffer(actual_size);
     if (NULL == ptr)
         std::terminate();
     std::memset(ptr, 0, actual_size);
@@ -224,7 +269,7 @@ void * __cxa_allocate_dependent_exception () {
 //  This function shall free a dependent_exception.
 //  It does not affect the reference count of the primary exception.
 void __cxa_free_dependent_exception (void * dependent_exception) {
-    __aligned_free_with_fallback(dependent_exception);
+    free_buffer(dependent_exception);
 }
 
 
@@ -106,8 +106,14 @@ struct _LIBCXXABI_HIDDEN __cxa_eh_globals {
 #if defined(_LIBCXXABI_ARM_EHABI)
     __cxa_exception* propagatingExceptions;
 #endif
+    // Exception buffers this thread freed, kept for its next throws.
+    void *              cachedBuffers[4];
+    unsigned int        cachedBufferCount;
 };
 
+// Returns the buffers cached in globals to the heap, when its thread exits.
+_LIBCXXABI_HIDDEN void __release_cached_exception_buffers(__cxa_eh_globals *globals);
+
 extern "C" _LIBCXXABI_FUNC_VIS __cxa_eh_globals * __cxa_get_globals      ();
 extern "C" _LIBCXXABI_FUNC_VIS __cxa_eh_globals * __cxa_get_globals_fast ();
 
@@ -11,9 +11,18 @@
 //===----------------------------------------------------------------------===//
 
 #include "cxa_exception.hpp"
+#include "fallback_malloc.h"
 
 #include <__threading_support>
 
+namespace __cxxabiv1 {
+void __release_cached_exception_buffers(__cxa_eh_globals *globals) {
+    while (globals->cachedBufferCount != 0)
+        __aligned_free_with_fallback(
+            globals->cachedBuffers[--globals->cachedBufferCount]);
+}
+}
+
 #if defined(_LIBCXXABI_HAS_NO_THREADS)
 
 namespace __cxxabiv1 {
@@ -29,8 +38,12 @@ extern "C" {
 namespace __cxxabiv1 {
 
 namespace {
+    struct thread_eh_globals : __cxa_eh_globals {
+        ~thread_eh_globals () { __release_cached_exception_buffers ( this ); }
+    };
+
     __cxa_eh_globals * __globals () {
-        static thread_local __cxa_eh_globals eh_globals;
+        static thread_local thread_eh_globals eh_globals;
         return &eh_globals;
         }
     }
@@ -44,7 +57,6 @@ extern "C" {
 #else
 
 #include "abort_message.h"
-#include "fallback_malloc.h"
 
 //  In general, we treat all threading errors as fatal.
 //  We cannot call std::terminate() because that will in turn
@@ -56,6 +68,7 @@ namespace {
     std::__libcpp_exec_once_flag flag_ = _LIBCPP_EXEC_ONCE_INITIALIZER;
 
     void _LIBCPP_TLS_DESTRUCTOR_CC destruct_ (void *p) {
+        __release_cached_exception_buffers ( static_cast<__cxa_eh_globals*> ( p ) );
         __free_with_fallback ( p );
         if ( 0 != std::__libcpp_tls_set ( key_, NULL ) )
             abort_message("cannot zero out thread value for __cxa_get_globals()");
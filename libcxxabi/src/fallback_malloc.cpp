@@ -251,4 +251,6 @@ void __free_with_fallback(void* ptr) {
     std::free(ptr);
 }
 
+bool __is_fallback_ptr(void* ptr) { return is_fallback_ptr(ptr); }
+
 } // namespace __cxxabiv1
@@ -23,6 +23,9 @@ _LIBCXXABI_HIDDEN void * __calloc_with_fallback(size_t count, size_t size);
 _LIBCXXABI_HIDDEN void __aligned_free_with_fallback(void *ptr);
 _LIBCXXABI_HIDDEN void __free_with_fallback(void *ptr);
 
+// Whether the memory came from the emergency pool rather than malloc
+_LIBCXXABI_HIDDEN bool __is_fallback_ptr(void *ptr);
+
 } // namespace __cxxabiv1
 
 #endif
@@ -54,6 +54,19 @@
 #include <string.h>
 #endif
 
+// On glibc the answers to expensive dynamic_casts and catch matches are
+// remembered, keyed by the addresses of the vtables and type_info's involved.
+// Those addresses can be reused once the object defining them is unloaded,
+// so every answer is tagged with the loader's count of objects added and
+// removed, which only glibc reports.  The strcmp fallback, which reports
+// inconsistencies as it finds them, always searches.
+#if defined(__GLIBC__) && !defined(_LIBCXX_DYNAMIC_FALLBACK)
+#define _LIBCXXABI_USE_CAST_CACHE
+#include <link.h>
+#include <stdint.h>
+#include "include/atomic_support.h"
+#endif
+
 static inline
 bool
 is_equal(const std::type_info* x, const std::type_info* y, bool use_strcmp)
@@ -71,6 +84,128 @@ is_equal(const std::type_info* x, const std::type_info* y, bool use_strcmp)
 namespace __cxxabiv1
 {
 
+#ifdef _LIBCXXABI_USE_CAST_CACHE
+
+namespace
+{
+
+// Searches that follow fewer base class edges than this are about as cheap
+// as asking the loader whether a cached answer is still good.
+const int min_bases_searched_to_cache = 8;
+
+// Returns a number that changes whenever an object is loaded or unloaded,
+// or 0 if the loader doesn't count them.
+uintptr_t
+load_generation()
+{
+    uintptr_t generation = 0;
+    dl_iterate_phdr(
+        [](dl_phdr_info* info, size_t size, void* data) -> int {
+            // The counts are the same in every object's record.
+            if (size >= offsetof(dl_phdr_info, dlpi_subs) + sizeof(info->dlpi_subs))
+                *static_cast<uintptr_t*>(data) =
+                    static_cast<uintptr_t>(info->dlpi_adds + info->dlpi_subs + 1);
+            return 1;
+        },
+        &generation);
+    return generation;
+}
+
+// A direct mapped table from a key of three addresses to the offset a cast
+// or catch applies, or to the cast failing.  Lookups take no lock: each entry
+// has a sequence number that is odd while a writer fills the entry in, and a
+// reader keeps what it copied out only if the number was even before and
+// unchanged after.  A writer that finds an entry busy drops its answer.
+class cast_cache
+{
+public:
+    static bool find(const void* k0, const void* k1, const void* k2,
+                     bool& found, ptrdiff_t& offset);
+    static void add(const void* k0, const void* k1, const void* k2,
+                    bool found, ptrdiff_t offset);
+
+private:
+    static const size_t entry_count = 256;
+
+    struct entry
+    {
+        uintptr_t sequence;
+        uintptr_t key[3];
+        uintptr_t generation;
+        uintptr_t found;
+        ptrdiff_t offset;
+    };
+
+    static entry& entry_for(uintptr_t k0, uintptr_t k1, uintptr_t k2)
+    {
+        uintptr_t hash = (k0 >> 4) ^ (k1 >> 3) ^ (k2 >> 5);
+        hash ^= hash >> 9;
+        return entries[hash % entry_count];
+    }
+
+    // Zero, and so matching no key, until first written.
+    static entry entries[entry_count];
+};
+
+cast_cache::entry cast_cache::entries[cast_cache::entry_count];
+
+bool
+cast_cache::find(const void* k0, const void* k1, const void* k2,
+                 bool& found, ptrdiff_t& offset)
+{
+    const uintptr_t key[3] = {reinterpret_cast<uintptr_t>(k0),
+                              reinterpret_cast<uintptr_t>(k1),
+                              reinterpret_cast<uintptr_t>(k2)};
+    entry& e = entry_for(key[0], key[1], key[2]);
+    uintptr_t sequence = std::__libcpp_atomic_load(&e.sequence, std::_AO_Acquire);
+    if (sequence & 1)
+        return false;
+    for (int i = 0; i < 3; ++i)
+        if (std::__libcpp_atomic_load(&e.key[i], std::_AO_Acquire) != key[i])
+            return false;
+    uintptr_t generation = std::__libcpp_atomic_load(&e.generation, std::_AO_Acquire);
+    uintptr_t entry_found = std::__libcpp_atomic_load(&e.found, std::_AO_Acquire);
+    ptrdiff_t entry_offset = std::__libcpp_atomic_load(&e.offset, std::_AO_Acquire);
+    if (std::__libcpp_atomic_load(&e.sequence, std::_AO_Relaxed) != sequence)
+        return false;
+    // Only ask the loader once the key matches, so misses stay cheap.
+    if (generation == 0 || generation != load_generation())
+        return false;
+    found = entry_found != 0;
+    offset = entry_offset;
+    return true;
+}
+
+void
+cast_cache::add(const void* k0, const void* k1, const void* k2,
+                bool found, ptrdiff_t offset)
+{
+    uintptr_t generation = load_generation();
+    if (generation == 0)
+        return;
+    const uintptr_t key[3] = {reinterpret_cast<uintptr_t>(k0),
+                              reinterpret_cast<uintptr_t>(k1),
+                              reinterpret_cast<uintptr_t>(k2)};
+    entry& e = entry_for(key[0], key[1], key[2]);
+    uintptr_t sequence = std::__libcpp_atomic_load(&e.sequence, std::_AO_Relaxed);
+    if ((sequence & 1) ||
+        !std::__libcpp_atomic_compare_exchange(&e.sequence, &sequence, sequence + 1,
+                                               std::_AO_Acquire, std::_AO_Relaxed))
+        return;
+    // Release stores, so that a reader who sees any of them also sees the
+    // odd sequence number stored before them.
+    for (int i = 0; i < 3; ++i)
+        std::__libcpp_atomic_store(&e.key[i], key[i], std::_AO_Release);
+    std::__libcpp_atomic_store(&e.generation, generation, std::_AO_Release);
+    std::__libcpp_atomic_store(&e.found, uintptr_t(found), std::_AO_Release);
+    std::__libcpp_atomic_store(&e.offset, offset, std::_AO_Release);
+    std::__libcpp_atomic_store(&e.sequence, sequence + 2, std::_AO_Release);
+}
+
+}  // unnamed namespace
+
+#endif  // _LIBCXXABI_USE_CAST_CACHE
+
 // __shim_type_info
 
 __shim_type_info::~__shim_type_info()
@@ -229,10 +364,32 @@ __class_type_info::can_catch(const __shim_type_info* thrown_type,
     if (thrown_class_type == 0)
         return false;
     // bullet 2
-    __dynamic_cast_info info = {thrown_class_type, 0, this, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,};
+#ifdef _LIBCXXABI_USE_CAST_CACHE
+    // The exception object is a complete object of the thrown type, so where
+    // its base is depends on the two types alone.
+    bool cached_found;
+    ptrdiff_t cached_offset;
+    if (adjustedPtr != nullptr &&
+        cast_cache::find(thrown_class_type, this, nullptr, cached_found, cached_offset))
+    {
+        if (cached_found)
+            adjustedPtr = static_cast<char*>(adjustedPtr) + cached_offset;
+        return cached_found;
+    }
+#endif
+    __dynamic_cast_info info = {thrown_class_type, 0, this, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,};
     info.number_of_dst_type = 1;
     thrown_class_type->has_unambiguous_public_base(&info, adjustedPtr, public_path);
-    if (info.path_dst_ptr_to_static_ptr == public_path)
+    bool found = info.path_dst_ptr_to_static_ptr == public_path;
+#ifdef _LIBCXXABI_USE_CAST_CACHE
+    if (adjustedPtr != nullptr &&
+        info.number_of_bases_searched >= min_bases_searched_to_cache)
+        cast_cache::add(thrown_class_type, this, nullptr, found,
+                        found ? static_cast<const char*>(info.dst_ptr_leading_to_static_ptr) -
+                                    static_cast<char*>(adjustedPtr)
+                              : 0);
+#endif
+    if (found)
     {
         adjustedPtr = const_cast<void*>(info.dst_ptr_leading_to_static_ptr);
         return true;
@@ -289,7 +446,10 @@ __si_class_type_info::has_unambiguous_public_base(__dynamic_cast_info* info,
     if (is_equal(this, info->static_type, false))
         process_found_base_class(info, adjustedPtr, path_below);
     else
+    {
+        ++info->number_of_bases_searched;
         __base_type->has_unambiguous_public_base(info, adjustedPtr, path_below);
+    }
 }
 
 void
@@ -297,6 +457,7 @@ __base_class_type_info::has_unambiguous_public_base(__dynamic_cast_info* info,
                                                     void* adjustedPtr,
                                                     int path_below) const
 {
+    ++info->number_of_bases_searched;
     ptrdiff_t offset_to_base = 0;
     if (adjustedPtr != nullptr)
     {
@@ -427,7 +588,7 @@ __pointer_type_info::can_catch(const __shim_type_info* thrown_type,
         dynamic_cast<const __class_type_info*>(thrown_pointer_type->__pointee);
     if (thrown_class_type == 0)
         return false;
-    __dynamic_cast_info info = {thrown_class_type, 0, catch_class_type, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,};
+    __dynamic_cast_info info = {thrown_class_type, 0, catch_class_type, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,};
     info.number_of_dst_type = 1;
     thrown_class_type->has_unambiguous_public_base(&info, adjustedPtr, public_path);
     if (info.path_dst_ptr_to_static_ptr == public_path)
@@ -628,12 +789,23 @@ __dynamic_cast(const void *static_ptr, const __class_type_info *static_type,
     const void* dynamic_ptr = static_cast<const char*>(static_ptr) + offset_to_derived;
     const __class_type_info* dynamic_type = static_cast<const __class_type_info*>(vtable[-1]);
 
+#ifdef _LIBCXXABI_USE_CAST_CACHE
+    // The vtable pointer tells apart both the dynamic type and which of its
+    // subobjects static_ptr points to, even while the object is still being
+    // constructed, and with them where the answer lies relative to static_ptr.
+    bool cached_found;
+    ptrdiff_t cached_offset;
+    if (cast_cache::find(vtable, static_type, dst_type, cached_found, cached_offset))
+        return cached_found ? const_cast<char*>(static_cast<const char*>(static_ptr)) + cached_offset
+                            : nullptr;
+#endif
+
     // Initialize answer to nullptr.  This will be changed from the search
     //    results if a non-null answer is found.  Regardless, this is what will
     //    be returned.
     const void* dst_ptr = 0;
     // Initialize info struct for this search.
-    __dynamic_cast_info info = {dst_type, static_ptr, static_type, src2dst_offset, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,};
+    __dynamic_cast_info info = {dst_type, static_ptr, static_type, src2dst_offset, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,};
 
     // Find out if we can use a giant short cut in the search
     if (is_equal(dynamic_type, dst_type, false))
@@ -703,6 +875,13 @@ __dynamic_cast(const void *static_ptr, const __class_type_info *static_type,
             break;
         }
     }
+#ifdef _LIBCXXABI_USE_CAST_CACHE
+    if (info.number_of_bases_searched >= min_bases_searched_to_cache)
+        cast_cache::add(vtable, static_type, dst_type, dst_ptr != nullptr,
+                        dst_ptr ? static_cast<const char*>(dst_ptr) -
+                                      static_cast<const char*>(static_ptr)
+                                : 0);
+#endif
     return const_cast<void*>(dst_ptr);
 }
 
@@ -1042,6 +1221,7 @@ __si_class_type_info::search_below_dst(__dynamic_cast_info* info,
                 // Zero out found flags
                 info->found_our_static_ptr = false;
                 info->found_any_static_type = false;
+                ++info->number_of_bases_searched;
                 __base_type->search_above_dst(info, current_ptr, current_ptr, public_path, use_strcmp);
                 if (info->found_any_static_type)
                 {
@@ -1077,6 +1257,7 @@ __si_class_type_info::search_below_dst(__dynamic_cast_info* info,
     else
     {
         // This is not a static_type and not a dst_type
+        ++info->number_of_bases_searched;
         __base_type->search_below_dst(info, current_ptr, path_below, use_strcmp);
     }
 }
@@ -1236,7 +1417,10 @@ __si_class_type_info::search_above_dst(__dynamic_cast_info* info,
     if (is_equal(this, info->static_type, use_strcmp))
         process_static_type_above_dst(info, dst_ptr, current_ptr, path_below);
     else
+    {
+        ++info->number_of_bases_searched;
         __base_type->search_above_dst(info, dst_ptr, current_ptr, path_below, use_strcmp);
+    }
 }
 
 // This is the same algorithm as __vmi_class_type_info::search_above_dst but
@@ -1263,6 +1447,7 @@ __base_class_type_info::search_above_dst(__dynamic_cast_info* info,
                                          int path_below,
                                          bool use_strcmp) const
 {
+    ++info->number_of_bases_searched;
     ptrdiff_t offset_to_base = __offset_flags >> __offset_shift;
     if (__offset_flags & __virtual_mask)
     {
@@ -1283,6 +1468,7 @@ __base_class_type_info::search_below_dst(__dynamic_cast_info* info,
                                          int path_below,
                                          bool use_strcmp) const
 {
+    ++info->number_of_bases_searched;
     ptrdiff_t offset_to_base = __offset_flags >> __offset_shift;
     if (__offset_flags & __virtual_mask)
     {
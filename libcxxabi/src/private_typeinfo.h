@@ -110,6 +110,11 @@ struct _LIBCXXABI_HIDDEN __dynamic_cast_info
     bool found_any_static_type;
     // Set whenever a search can be stopped
     bool search_done;
+
+// Data that tells whether the answer is worth caching:
+
+    // Number of base class edges the search followed.
+    int number_of_bases_searched;
 };
 
 // Has no base class
@@ -146,6 +146,17 @@ extern char __exidx_end;
 #define ElfW(type) Elf_##type
 #endif
 
+#if defined(_LIBUNWIND_SUPPORT_DWARF_UNWIND) && defined(__GLIBC__)
+// glibc 2.35 and later find the object holding an address without taking
+// the loader lock, and keep the answer consistent across dlopen and dlclose.
+#if defined(DLFO_STRUCT_HAS_EH_DBASE)
+#define _LIBUNWIND_USE_DL_FIND_OBJECT 1
+#endif
+// Otherwise remember what dl_iterate_phdr() found for the most recently used
+// objects, so that each frame doesn't decode every object's program headers.
+#define _LIBUNWIND_USE_FRAME_HEADER_CACHE 1
+#endif
+
 #endif
 
 namespace libunwind {
@@ -175,6 +186,18 @@ struct UnwindInfoSections {
 #endif
 };
 
+} // namespace libunwind
+
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE)
+#include "FrameHeaderCache.hpp"
+#endif
+
+namespace libunwind {
+
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE)
+static FrameHeaderCache ProcessFrameHeaderCache;
+#endif
+
 
 /// LocalAddressSpace is used as a template parameter to UnwindCursor when
 /// unwinding a thread in the same process.  The wrappers compile away,
@@ -224,6 +247,9 @@ public:
                         unw_word_t *offset);
   bool findUnwindSections(pint_t targetAddr, UnwindInfoSections &info);
   bool findOtherFDE(pint_t targetAddr, pint_t &fde);
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE)
+  static uint32_t loadGeneration();
+#endif
 
   static LocalAddressSpace sThisAddressSpace;
 };
@@ -382,6 +408,26 @@ LocalAddressSpace::getEncodedP(pint_t &addr, pint_t end, uint8_t encoding,
   return result;
 }
 
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE)
+/// Returns a number that changes whenever the loader adds or removes an
+/// object, which anything cached about a code address can be tagged with, or
+/// 0 if the loader doesn't count them.
+inline uint32_t LocalAddressSpace::loadGeneration() {
+  uint32_t generation = 0;
+  dl_iterate_phdr(
+      [](struct dl_phdr_info *pinfo, size_t pinfo_size, void *data) -> int {
+        // The counts are the same in every object's record.
+        if (pinfo_size >=
+            offsetof(dl_phdr_info, dlpi_subs) + sizeof(pinfo->dlpi_subs))
+          *static_cast<uint32_t *>(data) =
+              (uint32_t)(pinfo->dlpi_adds + pinfo->dlpi_subs + 1);
+        return 1;
+      },
+      &generation);
+  return generation;
+}
+#endif
+
 inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
                                                   UnwindInfoSections &info) {
 #ifdef __APPLE__
@@ -468,15 +514,42 @@ inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
   if (info.arm_section && info.arm_section_length)
     return true;
 #elif defined(_LIBUNWIND_ARM_EHABI) || defined(_LIBUNWIND_SUPPORT_DWARF_UNWIND)
+#if defined(_LIBUNWIND_USE_DL_FIND_OBJECT)
+  struct dl_find_object findResult;
+  if (_dl_find_object((void *)targetAddr, &findResult) == 0 &&
+      findResult.dlfo_eh_frame != nullptr) {
+    // The header lies within the object's mapping, which bounds it.
+    uintptr_t mapEnd = (uintptr_t)findResult.dlfo_map_end;
+    uintptr_t ehFrameHdrStart = (uintptr_t)findResult.dlfo_eh_frame;
+    EHHeaderParser<LocalAddressSpace>::EHHeaderInfo hdrInfo;
+    if (EHHeaderParser<LocalAddressSpace>::decodeEHHdr(
+            *this, ehFrameHdrStart, mapEnd, hdrInfo) &&
+        hdrInfo.eh_frame_ptr < mapEnd) {
+      uintptr_t limit = UINT32_MAX;
+      info.dso_base = (uintptr_t)findResult.dlfo_map_start;
+      info.dwarf_index_section = ehFrameHdrStart;
+      info.dwarf_index_section_length =
+          mapEnd - ehFrameHdrStart < limit ? mapEnd - ehFrameHdrStart : limit;
+      info.dwarf_section = hdrInfo.eh_frame_ptr;
+      info.dwarf_section_length = mapEnd - hdrInfo.eh_frame_ptr < limit
+                                      ? mapEnd - hdrInfo.eh_frame_ptr
+                                      : limit;
+      return true;
+    }
+  }
+  // Fall back to walking the objects, which also covers anything
+  // _dl_find_object() doesn't know about.
+#endif
   struct dl_iterate_cb_data {
     LocalAddressSpace *addressSpace;
     UnwindInfoSections *sects;
     uintptr_t targetAddr;
+    bool checkedCache;
   };
 
-  dl_iterate_cb_data cb_data = {this, &info, targetAddr};
+  dl_iterate_cb_data cb_data = {this, &info, targetAddr, false};
   int found = dl_iterate_phdr(
-      [](struct dl_phdr_info *pinfo, size_t, void *data) -> int {
+      [](struct dl_phdr_info *pinfo, size_t pinfo_size, void *data) -> int {
         auto cbdata = static_cast<dl_iterate_cb_data *>(data);
         bool found_obj = false;
         bool found_hdr = false;
@@ -484,6 +557,19 @@ inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
         assert(cbdata);
         assert(cbdata->sects);
 
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE)
+        // The counts the cache checks are the same for every object, so
+        // only the first callback needs to consult it.
+        if (!cbdata->checkedCache) {
+          cbdata->checkedCache = true;
+          if (ProcessFrameHeaderCache.find(pinfo, pinfo_size,
+                                           cbdata->targetAddr, cbdata->sects))
+            return true;
+        }
+#else
+        (void)pinfo_size;
+#endif
+
         if (cbdata->targetAddr < pinfo->dlpi_addr) {
           return false;
         }
@@ -502,7 +588,8 @@ inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
   #if !defined(_LIBUNWIND_SUPPORT_DWARF_INDEX)
    #error "_LIBUNWIND_SUPPORT_DWARF_UNWIND requires _LIBUNWIND_SUPPORT_DWARF_INDEX on this platform."
   #endif
-        size_t object_length;
+        size_t object_length = 0;
+        uintptr_t object_begin = 0;
 #if defined(__ANDROID__)
         Elf_Addr image_base =
             pinfo->dlpi_phnum
@@ -523,6 +610,7 @@ inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
             uintptr_t end = begin + phdr->p_memsz;
             if (cbdata->targetAddr >= begin && cbdata->targetAddr < end) {
               cbdata->sects->dso_base = begin;
+              object_begin = begin;
               object_length = phdr->p_memsz;
               found_obj = true;
             }
@@ -545,6 +633,10 @@ inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
 
         if (found_obj && found_hdr) {
           cbdata->sects->dwarf_section_length = object_length;
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE)
+          ProcessFrameHeaderCache.add(cbdata->sects, object_begin,
+                                      object_begin + object_length);
+#endif
           return true;
         } else {
           return false;
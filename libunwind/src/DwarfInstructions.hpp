@@ -32,9 +32,14 @@ class DwarfInstructions {
 public:
   typedef typename A::pint_t pint_t;
   typedef typename A::sint_t sint_t;
+  typedef typename CFI_Parser<A>::FDE_Info FDE_Info;
+  typedef typename CFI_Parser<A>::CIE_Info CIE_Info;
 
   static int stepWithDwarf(A &addressSpace, pint_t pc, pint_t fdeStart,
                            R &registers);
+  /// Steps with an FDE the caller has already decoded.
+  static int stepWithDwarf(A &addressSpace, pint_t pc, const FDE_Info &fdeInfo,
+                           const CIE_Info &cieInfo, R &registers);
 
 private:
 
@@ -48,8 +53,6 @@ private:
 
   typedef typename CFI_Parser<A>::RegisterLocation  RegisterLocation;
   typedef typename CFI_Parser<A>::PrologInfo        PrologInfo;
-  typedef typename CFI_Parser<A>::FDE_Info          FDE_Info;
-  typedef typename CFI_Parser<A>::CIE_Info          CIE_Info;
 
   static pint_t evaluateExpression(pint_t expression, A &addressSpace,
                                    const R &registers,
@@ -154,82 +157,91 @@ int DwarfInstructions<A, R>::stepWithDwarf(A &addressSpace, pint_t pc,
   FDE_Info fdeInfo;
   CIE_Info cieInfo;
   if (CFI_Parser<A>::decodeFDE(addressSpace, fdeStart, &fdeInfo,
-                               &cieInfo) == NULL) {
-    PrologInfo prolog;
-    if (CFI_Parser<A>::parseFDEInstructions(addressSpace, fdeInfo, cieInfo, pc,
-                                            R::getArch(), &prolog)) {
-      // get pointer to cfa (architecture specific)
-      pint_t cfa = getCFA(addressSpace, prolog, registers);
-
-       // restore registers that DWARF says were saved
-      R newRegisters = registers;
-      pint_t returnAddress = 0;
-      const int lastReg = R::lastDwarfRegNum();
-      assert(static_cast<int>(CFI_Parser<A>::kMaxRegisterNumber) >= lastReg &&
-             "register range too large");
-      assert(lastReg >= (int)cieInfo.returnAddressRegister &&
-             "register range does not contain return address register");
-      for (int i = 0; i <= lastReg; ++i) {
-        if (prolog.savedRegisters[i].location !=
-            CFI_Parser<A>::kRegisterUnused) {
-          if (registers.validFloatRegister(i))
-            newRegisters.setFloatRegister(
-                i, getSavedFloatRegister(addressSpace, registers, cfa,
-                                         prolog.savedRegisters[i]));
-          else if (registers.validVectorRegister(i))
-            newRegisters.setVectorRegister(
-                i, getSavedVectorRegister(addressSpace, registers, cfa,
-                                          prolog.savedRegisters[i]));
-          else if (i == (int)cieInfo.returnAddressRegister)
-            returnAddress = getSavedRegister(addressSpace, registers, cfa,
-                                             prolog.savedRegisters[i]);
-          else if (registers.validRegister(i))
-            newRegisters.setRegister(
-                i, getSavedRegister(addressSpace, registers, cfa,
-                                    prolog.savedRegisters[i]));
-          else
-            return UNW_EBADREG;
-        }
+                               &cieInfo) == NULL)
+    return stepWithDwarf(addressSpace, pc, fdeInfo, cieInfo, registers);
+  return UNW_EBADFRAME;
+}
+
+template <typename A, typename R>
+int DwarfInstructions<A, R>::stepWithDwarf(A &addressSpace, pint_t pc,
+                                           const FDE_Info &fdeInfo,
+                                           const CIE_Info &cieInfo,
+                                           R &registers) {
+  PrologInfo prolog;
+  if (CFI_Parser<A>::parseFDEInstructions(addressSpace, fdeInfo, cieInfo, pc,
+                                          R::getArch(), &prolog)) {
+    // get pointer to cfa (architecture specific)
+    pint_t cfa = getCFA(addressSpace, prolog, registers);
+
+     // restore registers that DWARF says were saved
+    R newRegisters = registers;
+    pint_t returnAddress = 0;
+    const int lastReg = R::lastDwarfRegNum();
+    assert(static_cast<int>(CFI_Parser<A>::kMaxRegisterNumber) >= lastReg &&
+           "register range too large");
+    assert(lastReg >= (int)cieInfo.returnAddressRegister &&
+           "register range does not contain return address register");
+    for (int i = 0; i <= lastReg; ++i) {
+      if (prolog.savedRegisters[i].location !=
+          CFI_Parser<A>::kRegisterUnused) {
+        if (registers.validFloatRegister(i))
+          newRegisters.setFloatRegister(
+              i, getSavedFloatRegister(addressSpace, registers, cfa,
+                                       prolog.savedRegisters[i]));
+        else if (registers.validVectorRegister(i))
+          newRegisters.setVectorRegister(
+              i, getSavedVectorRegister(addressSpace, registers, cfa,
+                                        prolog.savedRegisters[i]));
+        else if (i == (int)cieInfo.returnAddressRegister)
+          returnAddress = getSavedRegister(addressSpace, registers, cfa,
+                                           prolog.savedRegisters[i]);
+        else if (registers.validRegister(i))
+          newRegisters.setRegister(
+              i, getSavedRegister(addressSpace, registers, cfa,
+                                  prolog.savedRegisters[i]));
+        else
+          return UNW_EBADREG;
       }
+    }
 
-      // By definition, the CFA is the stack pointer at the call site, so
-      // restoring SP means setting it to CFA.
-      newRegisters.setSP(cfa);
+    // By definition, the CFA is the stack pointer at the call site, so
+    // restoring SP means setting it to CFA.
+    newRegisters.setSP(cfa);
 
 #if defined(_LIBUNWIND_TARGET_AARCH64)
-      // If the target is aarch64 then the return address may have been signed
-      // using the v8.3 pointer authentication extensions. The original
-      // return address needs to be authenticated before the return address is
-      // restored. autia1716 is used instead of autia as autia1716 assembles
-      // to a NOP on pre-v8.3a architectures.
-      if ((R::getArch() == REGISTERS_ARM64) &&
-          prolog.savedRegisters[UNW_ARM64_RA_SIGN_STATE].value) {
+    // If the target is aarch64 then the return address may have been signed
+    // using the v8.3 pointer authentication extensions. The original
+    // return address needs to be authenticated before the return address is
+    // restored. autia1716 is used instead of autia as autia1716 assembles
+    // to a NOP on pre-v8.3a architectures.
+    if ((R::getArch() == REGISTERS_ARM64) &&
+        prolog.savedRegisters[UNW_ARM64_RA_SIGN_STATE].value) {
 #if !defined(_LIBUNWIND_IS_NATIVE_ONLY)
-        return UNW_ECROSSRASIGNING;
+      return UNW_ECROSSRASIGNING;
 #else
-        register unsigned long long x17 __asm("x17") = returnAddress;
-        register unsigned long long x16 __asm("x16") = cfa;
-
-        // These are the autia1716/autib1716 instructions. The hint instructions
-        // are used here as gcc does not assemble autia1716/autib1716 for pre
-        // armv8.3a targets.
-        if (cieInfo.addressesSignedWithBKey)
-          asm("hint 0xe" : "+r"(x17) : "r"(x16)); // autib1716
-        else
-          asm("hint 0xc" : "+r"(x17) : "r"(x16)); // autia1716
-        returnAddress = x17;
+      register unsigned long long x17 __asm("x17") = returnAddress;
+      register unsigned long long x16 __asm("x16") = cfa;
+
+      // These are the autia1716/autib1716 instructions. The hint instructions
+      // are used here as gcc does not assemble autia1716/autib1716 for pre
+      // armv8.3a targets.
+      if (cieInfo.addressesSignedWithBKey)
+        asm("hint 0xe" : "+r"(x17) : "r"(x16)); // autib1716
+      else
+        asm("hint 0xc" : "+r"(x17) : "r"(x16)); // autia1716
+      returnAddress = x17;
 #endif
-      }
+    }
 #endif
 
 #if defined(_LIBUNWIND_TARGET_SPARC)
-      if (R::getArch() == REGISTERS_SPARC) {
-        // Skip call site instruction and delay slot
-        returnAddress += 8;
-        // Skip unimp instruction if function returns a struct
-        if ((addressSpace.get32(returnAddress) & 0xC1C00000) == 0)
-          returnAddress += 4;
-      }
+    if (R::getArch() == REGISTERS_SPARC) {
+      // Skip call site instruction and delay slot
+      returnAddress += 8;
+      // Skip unimp instruction if function returns a struct
+      if ((addressSpace.get32(returnAddress) & 0xC1C00000) == 0)
+        returnAddress += 4;
+    }
 #endif
 
 #if defined(_LIBUNWIND_TARGET_PPC64)
@@ -237,35 +249,34 @@ int DwarfInstructions<A, R>::stepWithDwarf(A &addressSpace, pint_t pc,
 #define PPC64_ELFV1_R2_OFFSET 40
 #define PPC64_ELFV2_R2_LOAD_INST_ENCODING 0xe8410018u // ld r2,24(r1)
 #define PPC64_ELFV2_R2_OFFSET 24
-      // If the instruction at return address is a TOC (r2) restore,
-      // then r2 was saved and needs to be restored.
-      // ELFv2 ABI specifies that the TOC Pointer must be saved at SP + 24,
-      // while in ELFv1 ABI it is saved at SP + 40.
-      if (R::getArch() == REGISTERS_PPC64 && returnAddress != 0) {
-        pint_t sp = newRegisters.getRegister(UNW_REG_SP);
-        pint_t r2 = 0;
-        switch (addressSpace.get32(returnAddress)) {
-        case PPC64_ELFV1_R2_LOAD_INST_ENCODING:
-          r2 = addressSpace.get64(sp + PPC64_ELFV1_R2_OFFSET);
-          break;
-        case PPC64_ELFV2_R2_LOAD_INST_ENCODING:
-          r2 = addressSpace.get64(sp + PPC64_ELFV2_R2_OFFSET);
-          break;
-        }
-        if (r2)
-          newRegisters.setRegister(UNW_PPC64_R2, r2);
+    // If the instruction at return address is a TOC (r2) restore,
+    // then r2 was saved and needs to be restored.
+    // ELFv2 ABI specifies that the TOC Pointer must be saved at SP + 24,
+    // while in ELFv1 ABI it is saved at SP + 40.
+    if (R::getArch() == REGISTERS_PPC64 && returnAddress != 0) {
+      pint_t sp = newRegisters.getRegister(UNW_REG_SP);
+      pint_t r2 = 0;
+      switch (addressSpace.get32(returnAddress)) {
+      case PPC64_ELFV1_R2_LOAD_INST_ENCODING:
+        r2 = addressSpace.get64(sp + PPC64_ELFV1_R2_OFFSET);
+        break;
+      case PPC64_ELFV2_R2_LOAD_INST_ENCODING:
+        r2 = addressSpace.get64(sp + PPC64_ELFV2_R2_OFFSET);
+        break;
       }
+      if (r2)
+        newRegisters.setRegister(UNW_PPC64_R2, r2);
+    }
 #endif
 
-      // Return address is address after call site instruction, so setting IP to
-      // that does simualates a return.
-      newRegisters.setIP(returnAddress);
+    // Return address is address after call site instruction, so setting IP to
+    // that does simualates a return.
+    newRegisters.setIP(returnAddress);
 
-      // Simulate the step by replacing the register set with the new ones.
-      registers = newRegisters;
+    // Simulate the step by replacing the register set with the new ones.
+    registers = newRegisters;
 
-      return UNW_STEP_SUCCESS;
-    }
+    return UNW_STEP_SUCCESS;
   }
   return UNW_EBADFRAME;
 }
@@ -0,0 +1,136 @@
+//===-FrameHeaderCache.hpp ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//
+// Cache the unwind sections that dl_iterate_phdr() lookups found.
+//===----------------------------------------------------------------------===//
+
+#ifndef __FRAMEHEADER_CACHE_HPP__
+#define __FRAMEHEADER_CACHE_HPP__
+
+#include "config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _LIBUNWIND_DEBUG_FRAMEHEADER_CACHE
+#define _LIBUNWIND_FRAMEHEADERCACHE_TRACE0(x) _LIBUNWIND_LOG0(x)
+#define _LIBUNWIND_FRAMEHEADERCACHE_TRACE(msg, ...)                            \
+  _LIBUNWIND_LOG(msg, __VA_ARGS__)
+#else
+#define _LIBUNWIND_FRAMEHEADERCACHE_TRACE0(x)
+#define _LIBUNWIND_FRAMEHEADERCACHE_TRACE(msg, ...)
+#endif
+
+namespace libunwind {
+
+/// The unwind sections of the objects that recent lookups found, keyed by
+/// the address range of the segment holding the code, most recently used
+/// first.  It is only touched from dl_iterate_phdr() callbacks, which the
+/// loader runs one at a time, and it empties itself whenever the loader's
+/// counts of added or removed objects change, so entries never outlive a
+/// dlopen() or dlclose().
+class _LIBUNWIND_HIDDEN FrameHeaderCache {
+  struct CacheEntry {
+    uintptr_t LowPC;
+    uintptr_t HighPC;
+    UnwindInfoSections Info;
+    CacheEntry *Next;
+  };
+
+  static const size_t kCacheEntryCount = 8;
+
+  // Zero-initialized, since the object is static and has no constructor.
+  CacheEntry *MostRecentlyUsed;
+  CacheEntry *Unused;
+  CacheEntry Entries[kCacheEntryCount];
+  unsigned long long LastAdds;
+  unsigned long long LastSubs;
+  bool Valid;
+
+  void resetCache(unsigned long long Adds, unsigned long long Subs) {
+    _LIBUNWIND_FRAMEHEADERCACHE_TRACE0("FrameHeaderCache reset");
+    MostRecentlyUsed = nullptr;
+    Unused = &Entries[0];
+    for (size_t I = 0; I < kCacheEntryCount - 1; I++)
+      Entries[I].Next = &Entries[I + 1];
+    Entries[kCacheEntryCount - 1].Next = nullptr;
+    LastAdds = Adds;
+    LastSubs = Subs;
+    Valid = true;
+  }
+
+public:
+  /// Looks \p TargetAddr up, given the first object the loader reports.
+  /// Returns false, and leaves \p Info alone, on a miss.
+  bool find(dl_phdr_info *PInfo, size_t PInfoSize, uintptr_t TargetAddr,
+            UnwindInfoSections *Info) {
+    // Loaders that predate the counts can't tell us when to invalidate.
+    if (PInfoSize < offsetof(dl_phdr_info, dlpi_subs) +
+                        sizeof(PInfo->dlpi_subs)) {
+      Valid = false;
+      return false;
+    }
+    if (!Valid || PInfo->dlpi_adds != LastAdds ||
+        PInfo->dlpi_subs != LastSubs) {
+      resetCache(PInfo->dlpi_adds, PInfo->dlpi_subs);
+      return false;
+    }
+
+    CacheEntry *Previous = nullptr;
+    for (CacheEntry *Current = MostRecentlyUsed; Current != nullptr;
+         Previous = Current, Current = Current->Next) {
+      if (Current->LowPC <= TargetAddr && TargetAddr < Current->HighPC) {
+        _LIBUNWIND_FRAMEHEADERCACHE_TRACE(
+            "FrameHeaderCache hit %lx in [%lx - %lx)", TargetAddr,
+            Current->LowPC, Current->HighPC);
+        if (Previous != nullptr) {
+          Previous->Next = Current->Next;
+          Current->Next = MostRecentlyUsed;
+          MostRecentlyUsed = Current;
+        }
+        *Info = Current->Info;
+        return true;
+      }
+    }
+    _LIBUNWIND_FRAMEHEADERCACHE_TRACE("FrameHeaderCache miss for address %lx",
+                                      TargetAddr);
+    return false;
+  }
+
+  /// Remembers the sections of the object whose code spans
+  /// [\p LowPC, \p HighPC), evicting the least recently used entry if the
+  /// cache is full.
+  void add(const UnwindInfoSections *Info, uintptr_t LowPC, uintptr_t HighPC) {
+    if (!Valid)
+      return;
+    CacheEntry *Current;
+    if (Unused != nullptr) {
+      Current = Unused;
+      Unused = Unused->Next;
+    } else {
+      CacheEntry *Previous = nullptr;
+      Current = MostRecentlyUsed;
+      while (Current->Next != nullptr) {
+        Previous = Current;
+        Current = Current->Next;
+      }
+      Previous->Next = nullptr;
+      _LIBUNWIND_FRAMEHEADERCACHE_TRACE("FrameHeaderCache evict [%lx - %lx)",
+                                        Current->LowPC, Current->HighPC);
+    }
+    Current->LowPC = LowPC;
+    Current->HighPC = HighPC;
+    Current->Info = *Info;
+    Current->Next = MostRecentlyUsed;
+    MostRecentlyUsed = Current;
+    _LIBUNWIND_FRAMEHEADERCACHE_TRACE("FrameHeaderCache add [%lx - %lx)",
+                                      LowPC, HighPC);
+  }
+};
+
+} // namespace libunwind
+
+#endif // __FRAMEHEADER_CACHE_HPP__
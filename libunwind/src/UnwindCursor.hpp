@@ -214,6 +214,103 @@ void DwarfFDECache<A>::iterateCacheEntries(void (*func)(
 }
 #endif // defined(_LIBUNWIND_SUPPORT_DWARF_UNWIND)
 
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE) &&                              \
+    defined(_LIBUNWIND_IS_NATIVE_ONLY)
+#define _LIBUNWIND_USE_DWARF_PC_CACHE 1
+#endif
+
+#if defined(_LIBUNWIND_USE_DWARF_PC_CACHE)
+/// Cache of what the unwind tables say about recently unwound pcs: the
+/// procedure info and the decoded FDE and CIE, so that unwinding through a
+/// frame seen before neither searches for nor decodes its FDE.  Entries are
+/// tagged with the loader generation of the cursor that stored them and only
+/// match cursors of the same generation, which retires them all once any
+/// object is loaded or unloaded.
+///
+/// The cache is direct mapped and lock free: each entry carries a sequence
+/// number that is odd while a writer fills it in, and readers copy the entry
+/// out and keep the copy only if the number was even and unchanged across the
+/// copy.  A writer that finds the entry busy just drops its update.
+template <typename A>
+class _LIBUNWIND_HIDDEN DwarfPCCache {
+  typedef typename A::pint_t pint_t;
+
+public:
+  struct value {
+    unw_proc_info_t info;
+    typename CFI_Parser<A>::FDE_Info fdeInfo;
+    typename CFI_Parser<A>::CIE_Info cieInfo;
+  };
+
+  static bool find(pint_t pc, uint32_t generation, value *result);
+  static void add(pint_t pc, uint32_t generation, const value &v);
+
+private:
+  enum {
+    kEntryCount = 256,
+    kValueWords = (sizeof(value) + sizeof(uintptr_t) - 1) / sizeof(uintptr_t)
+  };
+
+  struct entry {
+    uintptr_t sequence;
+    uintptr_t pc;
+    uintptr_t generation;
+    uintptr_t words[kValueWords];
+  };
+
+  static entry &entryFor(pint_t pc) {
+    uintptr_t hash = (uintptr_t)pc ^ ((uintptr_t)pc >> 8);
+    return _entries[hash % kEntryCount];
+  }
+
+  // Zero-initialized, so every entry starts out matching no generation.
+  static entry _entries[kEntryCount];
+};
+
+template <typename A>
+typename DwarfPCCache<A>::entry DwarfPCCache<A>::_entries[kEntryCount];
+
+template <typename A>
+bool DwarfPCCache<A>::find(pint_t pc, uint32_t generation, value *result) {
+  if (generation == 0)
+    return false;
+  entry &e = entryFor(pc);
+  uintptr_t sequence = __atomic_load_n(&e.sequence, __ATOMIC_ACQUIRE);
+  if ((sequence & 1) != 0 ||
+      __atomic_load_n(&e.pc, __ATOMIC_RELAXED) != (uintptr_t)pc ||
+      __atomic_load_n(&e.generation, __ATOMIC_RELAXED) != generation)
+    return false;
+  uintptr_t words[kValueWords];
+  for (size_t i = 0; i < kValueWords; ++i)
+    words[i] = __atomic_load_n(&e.words[i], __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  if (__atomic_load_n(&e.sequence, __ATOMIC_RELAXED) != sequence)
+    return false;
+  memcpy(result, words, sizeof(value));
+  return true;
+}
+
+template <typename A>
+void DwarfPCCache<A>::add(pint_t pc, uint32_t generation, const value &v) {
+  if (generation == 0)
+    return;
+  entry &e = entryFor(pc);
+  uintptr_t sequence = __atomic_load_n(&e.sequence, __ATOMIC_RELAXED);
+  if ((sequence & 1) != 0 ||
+      !__atomic_compare_exchange_n(&e.sequence, &sequence, sequence + 1,
+                                   false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    return;
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  uintptr_t words[kValueWords] = {};
+  memcpy(words, &v, sizeof(value));
+  __atomic_store_n(&e.pc, (uintptr_t)pc, __ATOMIC_RELAXED);
+  __atomic_store_n(&e.generation, (uintptr_t)generation, __ATOMIC_RELAXED);
+  for (size_t i = 0; i < kValueWords; ++i)
+    __atomic_store_n(&e.words[i], words[i], __ATOMIC_RELAXED);
+  __atomic_store_n(&e.sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+#endif // defined(_LIBUNWIND_USE_DWARF_PC_CACHE)
+
 
 #define arrayoffsetof(type, index, field) ((size_t)(&((type *)0)[index].field))
 
@@ -926,11 +1023,27 @@ private:
   bool getInfoFromDwarfSection(pint_t pc, const UnwindInfoSections &sects,
                                             uint32_t fdeSectionOffsetHint=0);
   int stepWithDwarfFDE() {
+#if defined(_LIBUNWIND_USE_DWARF_PC_CACHE)
+    // The frame's FDE was cached under the pc its info was looked up for,
+    // which is one less than the IP for a return address.
+    pint_t pc = (pint_t)this->getReg(UNW_REG_IP);
+    typename DwarfPCCache<A>::value cached;
+    if (findCachedFrame(pc - 1, &cached) || findCachedFrame(pc, &cached))
+      return DwarfInstructions<A, R>::stepWithDwarf(
+          _addressSpace, pc, cached.fdeInfo, cached.cieInfo, _registers);
+#endif
     return DwarfInstructions<A, R>::stepWithDwarf(_addressSpace,
                                               (pint_t)this->getReg(UNW_REG_IP),
                                               (pint_t)_info.unwind_info,
                                               _registers);
   }
+
+#if defined(_LIBUNWIND_USE_DWARF_PC_CACHE)
+  bool findCachedFrame(pint_t pc, typename DwarfPCCache<A>::value *cached) {
+    return DwarfPCCache<A>::find(pc, _loadGeneration, cached) &&
+           cached->info.unwind_info == _info.unwind_info;
+  }
+#endif
 #endif
 
 #if defined(_LIBUNWIND_SUPPORT_COMPACT_UNWIND)
@@ -1149,6 +1262,9 @@ private:
   unw_proc_info_t  _info;
   bool             _unwindInfoMissing;
   bool             _isSignalFrame;
+#if defined(_LIBUNWIND_USE_DWARF_PC_CACHE)
+  uint32_t         _loadGeneration;
+#endif
 };
 
 
@@ -1159,12 +1275,20 @@ UnwindCursor<A, R>::UnwindCursor(unw_context_t *context, A &as)
   static_assert((check_fit<UnwindCursor<A, R>, unw_cursor_t>::does_fit),
                 "UnwindCursor<> does not fit in unw_cursor_t");
   memset(&_info, 0, sizeof(_info));
+#if defined(_LIBUNWIND_USE_DWARF_PC_CACHE)
+  // Read once per unwind rather than per frame: the objects whose code is on
+  // the stack being unwound can't be unloaded while it is.
+  _loadGeneration = A::loadGeneration();
+#endif
 }
 
 template <typename A, typename R>
 UnwindCursor<A, R>::UnwindCursor(A &as, void *)
     : _addressSpace(as), _unwindInfoMissing(false), _isSignalFrame(false) {
   memset(&_info, 0, sizeof(_info));
+#if defined(_LIBUNWIND_USE_DWARF_PC_CACHE)
+  _loadGeneration = 0;
+#endif
   // FIXME
   // fill in _registers from thread arg
 }
@@ -1501,6 +1625,11 @@ bool UnwindCursor<A, R>::getInfoFromDwarfSection(pint_t pc,
       _info.unwind_info_size  = (uint32_t)fdeInfo.fdeLength;
       _info.extra             = (unw_word_t) sects.dso_base;
 
+#if defined(_LIBUNWIND_USE_DWARF_PC_CACHE)
+      typename DwarfPCCache<A>::value cached = {_info, fdeInfo, cieInfo};
+      DwarfPCCache<A>::add(pc, _loadGeneration, cached);
+#endif
+
       // Add to cache (to make next lookup faster) if we had no hint
       // and there was no index.
       if (!foundInCache && (fdeSectionOffsetHint == 0)) {
@@ -1842,6 +1971,14 @@ void UnwindCursor<A, R>::setInfoBasedOnIPRegister(bool isReturnAddress) {
   if (isReturnAddress)
     --pc;
 
+#if defined(_LIBUNWIND_USE_DWARF_PC_CACHE)
+  typename DwarfPCCache<A>::value cached;
+  if (DwarfPCCache<A>::find(pc, _loadGeneration, &cached)) {
+    _info = cached.info;
+    return;
+  }
+#endif
+
   // Ask address space object to find unwind sections for this pc.
   UnwindInfoSections sects;
   if (_addressSpace.findUnwindSections(pc, sects)) {
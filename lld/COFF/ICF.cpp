@@ -261,9 +261,14 @@ void ICF::run(ArrayRef<Chunk *> Vec) {
       for (SectionChunk *SC : MC->Sections)
         SC->Class[0] = NextId++;
 
-  // Initially, we use hash values to partition sections.
+  // Initially, we use hash values to partition sections. equalsConstant()
+  // requires the types and offsets of the relocations to be equal, so they are
+  // hashed along with the contents.
   parallelForEach(Chunks, [&](SectionChunk *SC) {
-    SC->Class[0] = xxHash64(SC->getContents());
+    uint64_t Hash = xxHash64(SC->getContents());
+    for (const coff_relocation &R : SC->getRelocs())
+      Hash = hash_combine(Hash, uint16_t(R.Type), uint32_t(R.VirtualAddress));
+    SC->Class[0] = Hash;
   });
 
   // Combine the hashes of the sections referenced by each section into its
@@ -193,6 +193,10 @@ private:
   /// Cached to prevent repeated load attempts.
   std::map<codeview::GUID, std::string> MissingTypeServerPDBs;
 
+  /// Global hashes of the type records of the objects without a .debug$H
+  /// section, computed in parallel before the types are merged.
+  llvm::DenseMap<ObjFile *, std::vector<GloballyHashedType>> OwnedGHashes;
+
   // For statistics
   uint64_t GlobalSymbols = 0;
   uint64_t ModuleSymbols = 0;
@@ -394,9 +398,14 @@ PDBLinker::mergeDebugT(ObjFile *File, CVIndexMap *ObjectIndexMap) {
   if (Config->DebugGHashes) {
     ArrayRef<GloballyHashedType> Hashes;
     std::vector<GloballyHashedType> OwnedHashes;
-    if (Optional<ArrayRef<uint8_t>> DebugH = getDebugH(File))
+    auto It = OwnedGHashes.find(File);
+    if (It != OwnedGHashes.end()) {
+      OwnedHashes = std::move(It->second);
+      OwnedGHashes.erase(It);
+      Hashes = OwnedHashes;
+    } else if (Optional<ArrayRef<uint8_t>> DebugH = getDebugH(File)) {
       Hashes = getHashesFromDebugH(*DebugH);
-    else {
+    } else {
       OwnedHashes = GloballyHashedType::hashTypes(Types);
       Hashes = OwnedHashes;
     }
@@ -1287,6 +1296,26 @@ void PDBLinker::addObjectsToPDB() {
 
   createModuleDBI(Builder);
 
+  // The objects are merged in order so that the type indices do not depend on
+  // the number of threads, but the hashes of their type records only depend on
+  // the records, so they can be computed in parallel beforehand. Objects using
+  // precompiled headers or type servers are left to mergeDebugT().
+  if (Config->DebugGHashes) {
+    std::vector<ObjFile *> Files;
+    for (ObjFile *File : ObjFile::Instances)
+      if (File->DebugTypesObj && !getDebugH(File) &&
+          (File->DebugTypesObj->Kind == TpiSource::Regular ||
+           File->DebugTypesObj->Kind == TpiSource::PCH))
+        Files.push_back(File);
+
+    std::vector<std::vector<GloballyHashedType>> Hashes(Files.size());
+    parallelForEachN(0, Files.size(), [&](size_t I) {
+      Hashes[I] = GloballyHashedType::hashTypes(*Files[I]->DebugTypes);
+    });
+    for (size_t I = 0, E = Files.size(); I != E; ++I)
+      OwnedGHashes[Files[I]] = std::move(Hashes[I]);
+  }
+
   for (ObjFile *File : ObjFile::Instances)
     addObjFile(File);
 
@@ -28,7 +28,7 @@
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/RandomNumberGenerator.h"
-#include "llvm/Support/xxhash.h"
+#include "llvm/Support/TreeHash.h"
 #include <algorithm>
 #include <cstdio>
 #include <map>
@@ -1707,7 +1707,8 @@ void Writer::writeBuildId() {
       Config->MinGW && Config->Debug && Config->PDBPath.empty();
 
   if (Config->Repro || GenerateSyntheticBuildId)
-    Hash = xxHash64(OutputFileData);
+    Hash = treeHashXXHash64(arrayRefFromStringRef(OutputFileData),
+                            ThreadsEnabled);
 
   if (Config->Repro)
     Timestamp = static_cast<uint32_t>(Hash);
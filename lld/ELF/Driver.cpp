@@ -48,6 +48,8 @@
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSwitch.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/ProfileData/SampleProfReader.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/LEB128.h"
@@ -665,25 +667,35 @@ static std::pair<bool, bool> getPackDynRelocs(opt::InputArgList &Args) {
   return {false, false};
 }
 
-static void readCallGraph(MemoryBufferRef MB) {
-  // Build a map from symbol name to section
+// Build a map from symbol name to symbol for the call graphs read from files.
+static DenseMap<StringRef, Symbol *> getCallGraphSymbols() {
   DenseMap<StringRef, Symbol *> Map;
   for (InputFile *File : ObjectFiles)
     for (Symbol *Sym : File->getSymbols())
       Map[Sym->getName()] = Sym;
+  return Map;
+}
 
-  auto FindSection = [&](StringRef Name) -> InputSectionBase * {
-    Symbol *Sym = Map.lookup(Name);
-    if (!Sym) {
-      if (Config->WarnSymbolOrdering)
-        warn(MB.getBufferIdentifier() + ": no such symbol: " + Name);
-      return nullptr;
-    }
-    maybeWarnUnorderableSymbol(Sym);
-
-    if (Defined *DR = dyn_cast_or_null<Defined>(Sym))
-      return dyn_cast_or_null<InputSectionBase>(DR->Section);
+static InputSectionBase *
+findCallGraphSection(const DenseMap<StringRef, Symbol *> &Map, StringRef Name,
+                     StringRef Source) {
+  Symbol *Sym = Map.lookup(Name);
+  if (!Sym) {
+    if (Config->WarnSymbolOrdering)
+      warn(Source + ": no such symbol: " + Name);
     return nullptr;
+  }
+  maybeWarnUnorderableSymbol(Sym);
+
+  if (Defined *DR = dyn_cast_or_null<Defined>(Sym))
+    return dyn_cast_or_null<InputSectionBase>(DR->Section);
+  return nullptr;
+}
+
+static void readCallGraph(MemoryBufferRef MB) {
+  DenseMap<StringRef, Symbol *> Map = getCallGraphSymbols();
+  auto FindSection = [&](StringRef Name) {
+    return findCallGraphSection(Map, Name, MB.getBufferIdentifier());
   };
 
   for (StringRef Line : args::getLines(MB)) {
@@ -702,6 +714,48 @@ static void readCallGraph(MemoryBufferRef MB) {
   }
 }
 
+static void addSampledCalls(const DenseMap<StringRef, Symbol *> &Map,
+                            InputSectionBase *From,
+                            const sampleprof::FunctionSamples &FS,
+                            StringRef Source) {
+  for (const auto &Body : FS.getBodySamples())
+    for (const StringMapEntry<uint64_t> &Target : Body.second.getCallTargets())
+      if (InputSectionBase *To =
+              findCallGraphSection(Map, Target.getKey(), Source))
+        Config->CallGraphProfile[std::make_pair(From, To)] += Target.getValue();
+
+  for (const auto &Callsite : FS.getCallsiteSamples())
+    for (const auto &Inlined : Callsite.second)
+      addSampledCalls(Map, From, Inlined.second, Source);
+}
+
+// Add the calls recorded by a sample profile to the call graph. Each call
+// target of a sampled line is a call from the function the line was compiled
+// into, which is the outermost function for the lines of inlined callees.
+static void readCallGraphFromSampleProfile(MemoryBufferRef MB) {
+  LLVMContext Context;
+  std::unique_ptr<MemoryBuffer> Buffer =
+      MemoryBuffer::getMemBuffer(MB, /*RequiresNullTerminator=*/false);
+  ErrorOr<std::unique_ptr<sampleprof::SampleProfileReader>> ReaderOrErr =
+      sampleprof::SampleProfileReader::create(Buffer, Context);
+  if (std::error_code EC = ReaderOrErr.getError()) {
+    error(MB.getBufferIdentifier() + ": " + EC.message());
+    return;
+  }
+  sampleprof::SampleProfileReader &Reader = **ReaderOrErr;
+  if (std::error_code EC = Reader.read()) {
+    error(MB.getBufferIdentifier() + ": " + EC.message());
+    return;
+  }
+
+  DenseMap<StringRef, Symbol *> Map = getCallGraphSymbols();
+  for (const StringMapEntry<sampleprof::FunctionSamples> &Entry :
+       Reader.getProfiles())
+    if (InputSectionBase *From = findCallGraphSection(
+            Map, Entry.getKey(), MB.getBufferIdentifier()))
+      addSampledCalls(Map, From, Entry.getValue(), MB.getBufferIdentifier());
+}
+
 template <class ELFT> static void readCallGraphsFromObjectFiles() {
   for (auto File : ObjectFiles) {
     auto *Obj = cast<ObjFile<ELFT>>(File);
@@ -867,6 +921,8 @@ static void readConfigs(opt::InputArgList &Args) {
   Config->Target1Rel = Args.hasFlag(OPT_target1_rel, OPT_target1_abs, false);
   Config->Target2 = getTarget2(Args);
   Config->ThinLTOCacheDir = Args.getLastArgValue(OPT_thinlto_cache_dir);
+  Config->ThinLTOCacheSharded = Args.hasArg(OPT_thinlto_cache_sharded);
+  Config->ThinLTODistributor = Args.getLastArgValue(OPT_thinlto_distributor);
   Config->ThinLTOCachePolicy = CHECK(
       parseCachePruningPolicy(Args.getLastArgValue(OPT_thinlto_cache_policy)),
       "--thinlto-cache-policy: invalid cache policy");
@@ -979,6 +1035,9 @@ static void readConfigs(opt::InputArgList &Args) {
     if (Args.hasArg(OPT_call_graph_ordering_file))
       error("--symbol-ordering-file and --call-graph-order-file "
             "may not be used together");
+    if (Args.hasArg(OPT_call_graph_sample_profile))
+      error("--symbol-ordering-file and --call-graph-sample-profile "
+            "may not be used together");
     if (Optional<MemoryBufferRef> Buffer = readFile(Arg->getValue())){
       Config->SymbolOrderingFile = getSymbolOrderingFile(*Buffer);
       // Also need to disable CallGraphProfileSort to prevent
@@ -1558,6 +1617,15 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &Args) {
   // symbols that we need to the symbol table. This process might
   // add files to the link, via autolinking, these files are always
   // appended to the Files vector.
+  //
+  // Symbols must be inserted in command line order for the resolution to be
+  // deterministic, but the names of the symbols of the object files can be
+  // hashed in parallel beforehand.
+  parallelForEach(Files, [](InputFile *File) {
+    if (auto *Obj = dyn_cast<ObjFile<ELFT>>(File))
+      if (Obj->EKind == Config->EKind)
+        Obj->initializeSymbolKeys();
+  });
   for (size_t I = 0; I < Files.size(); ++I)
     parseFile(Files[I]);
 
@@ -1732,6 +1800,9 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &Args) {
     if (auto *Arg = Args.getLastArg(OPT_call_graph_ordering_file))
       if (Optional<MemoryBufferRef> Buffer = readFile(Arg->getValue()))
         readCallGraph(*Buffer);
+    if (auto *Arg = Args.getLastArg(OPT_call_graph_sample_profile))
+      if (Optional<MemoryBufferRef> Buffer = readFile(Arg->getValue()))
+        readCallGraphFromSampleProfile(*Buffer);
     readCallGraphsFromObjectFiles<ELFT>();
   }
 
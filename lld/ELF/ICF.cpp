@@ -79,6 +79,7 @@
 #include "SyntheticSections.h"
 #include "Writer.h"
 #include "lld/Common/Threads.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Object/ELF.h"
@@ -422,6 +423,18 @@ void ICF<ELFT>::forEachClass(llvm::function_ref<void(size_t, size_t)> Fn) {
   ++Cnt;
 }
 
+// Returns the hash of the parts of a section compared by equalsConstant() which
+// do not depend on other sections: the contents and the offsets and types of
+// the relocations. Hashing the relocations too keeps the initial classes small.
+template <class ELFT, class RelTy>
+static uint32_t getConstantHash(InputSection *IS, ArrayRef<RelTy> Rels) {
+  uint64_t Hash = xxHash64(IS->data());
+  for (const RelTy &Rel : Rels)
+    Hash = hash_combine(Hash, uint64_t(Rel.r_offset),
+                        Rel.getType(Config->IsMips64EL));
+  return Hash;
+}
+
 // Combine the hashes of the sections referenced by the given section into its
 // hash.
 template <class ELFT, class RelTy>
@@ -453,7 +466,10 @@ template <class ELFT> void ICF<ELFT>::run() {
 
   // Initially, we use hash values to partition sections.
   parallelForEach(Sections, [&](InputSection *S) {
-    S->Class[0] = xxHash64(S->data());
+    if (S->AreRelocsRela)
+      S->Class[0] = getConstantHash<ELFT>(S, S->template relas<ELFT>());
+    else
+      S->Class[0] = getConstantHash<ELFT>(S, S->template rels<ELFT>());
   });
 
   for (unsigned Cnt = 0; Cnt != 2; ++Cnt) {
@@ -23,6 +23,7 @@
 #include "llvm/LTO/LTO.h"
 #include "llvm/MC/StringTableBuilder.h"
 #include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Object/IRObjectFile.h"
 #include "llvm/Support/ARMAttributeParser.h"
 #include "llvm/Support/ARMBuildAttributes.h"
 #include "llvm/Support/Path.h"
@@ -403,6 +404,50 @@ void ObjFile<ELFT>::parse(
   initializeSymbols();
 }
 
+// Computes the symbol table keys of the global symbols, which is mostly the
+// hashing of their names, so that parse() only has to insert them. This only
+// reads the file, so that it can be done for all the object files in parallel
+// before they are parsed in order. Errors are left for parse() to report.
+template <class ELFT> void ObjFile<ELFT>::initializeSymbolKeys() {
+  const ELFFile<ELFT> &Obj = this->getObj();
+  Expected<ArrayRef<Elf_Shdr>> SectionsOrErr = Obj.sections();
+  if (!SectionsOrErr) {
+    consumeError(SectionsOrErr.takeError());
+    return;
+  }
+
+  for (const Elf_Shdr &Sec : *SectionsOrErr) {
+    if (Sec.sh_type != SHT_SYMTAB)
+      continue;
+    Expected<typename ELFT::SymRange> SymsOrErr = Obj.symbols(&Sec);
+    if (!SymsOrErr) {
+      consumeError(SymsOrErr.takeError());
+      return;
+    }
+    Expected<StringRef> StringTableOrErr =
+        Obj.getStringTableForSymtab(Sec, *SectionsOrErr);
+    if (!StringTableOrErr) {
+      consumeError(StringTableOrErr.takeError());
+      return;
+    }
+
+    uint32_t FirstGlobal = Sec.sh_info;
+    if (FirstGlobal == 0 || FirstGlobal > SymsOrErr->size())
+      return;
+    SymbolKeys.reserve(SymsOrErr->size() - FirstGlobal);
+    for (const Elf_Sym &Sym : SymsOrErr->slice(FirstGlobal)) {
+      Expected<StringRef> NameOrErr = Sym.getName(*StringTableOrErr);
+      if (!NameOrErr) {
+        consumeError(NameOrErr.takeError());
+        SymbolKeys.clear();
+        return;
+      }
+      SymbolKeys.push_back(SymbolTable::getKey(*NameOrErr));
+    }
+    return;
+  }
+}
+
 // Sections with SHT_GROUP and comdat bits define comdat section groups.
 // They are identified and deduplicated by group name. This function
 // returns a group name.
@@ -917,6 +962,9 @@ template <class ELFT> void ObjFile<ELFT>::initializeSymbols() {
   this->Symbols.reserve(this->getELFSyms<ELFT>().size());
   for (const Elf_Sym &Sym : this->getELFSyms<ELFT>())
     this->Symbols.push_back(createSymbol(&Sym));
+
+  // The keys are only needed to insert the symbols.
+  SymbolKeys = std::vector<CachedHashStringRef>();
 }
 
 template <class ELFT> Symbol *ObjFile<ELFT>::createSymbol(const Elf_Sym *Sym) {
@@ -946,18 +994,26 @@ template <class ELFT> Symbol *ObjFile<ELFT>::createSymbol(const Elf_Sym *Sym) {
 
   StringRef Name = CHECK(Sym->getName(this->StringTable), this);
 
+  // Use the key computed by initializeSymbolKeys() if there is one.
+  size_t KeyIdx = Sym - this->getGlobalELFSyms<ELFT>().begin();
+  auto AddSymbol = [&](const Symbol &New) {
+    if (KeyIdx < SymbolKeys.size())
+      return Symtab->addSymbol(New, SymbolKeys[KeyIdx]);
+    return Symtab->addSymbol(New);
+  };
+
   if (Sym->st_shndx == SHN_UNDEF)
-    return Symtab->addSymbol(Undefined{this, Name, Binding, StOther, Type});
+    return AddSymbol(Undefined{this, Name, Binding, StOther, Type});
 
   if (Sec == &InputSection::Discarded)
-    return Symtab->addSymbol(Undefined{this, Name, Binding, StOther, Type,
-                                       /*DiscardedSecIdx=*/SecIdx});
+    return AddSymbol(Undefined{this, Name, Binding, StOther, Type,
+                               /*DiscardedSecIdx=*/SecIdx});
 
   if (Sym->st_shndx == SHN_COMMON) {
     if (Value == 0 || Value >= UINT32_MAX)
       fatal(toString(this) + ": common symbol '" + Name +
             "' has invalid alignment: " + Twine(Value));
-    return Symtab->addSymbol(
+    return AddSymbol(
         CommonSymbol{this, Name, Binding, StOther, Type, Value, Size});
   }
 
@@ -967,7 +1023,7 @@ template <class ELFT> Symbol *ObjFile<ELFT>::createSymbol(const Elf_Sym *Sym) {
   case STB_GLOBAL:
   case STB_WEAK:
   case STB_GNU_UNIQUE:
-    return Symtab->addSymbol(
+    return AddSymbol(
         Defined{this, Name, Binding, StOther, Type, Value, Size, Sec});
   }
 }
@@ -1461,10 +1517,12 @@ InputFile *LazyObjFile::fetch() {
 template <class ELFT> void LazyObjFile::parse() {
   // A lazy object file wraps either a bitcode file or an ELF file.
   if (isBitcode(this->MB)) {
-    std::unique_ptr<lto::InputFile> Obj =
-        CHECK(lto::InputFile::create(this->MB), this);
-    for (const lto::InputFile::Symbol &Sym : Obj->symbols()) {
-      if (Sym.isUndefined())
+    // The symbols are read from the irsymtab of the file, the lto::InputFile
+    // is only created if the file is fetched. These are the symbols of the
+    // lto::InputFile, which skips the local and format specific ones.
+    IRSymtabFile Obj = CHECK(readIRSymtab(this->MB), this);
+    for (const irsymtab::Reader::SymbolRef &Sym : Obj.TheReader.symbols()) {
+      if (!Sym.isGlobal() || Sym.isFormatSpecific() || Sym.isUndefined())
         continue;
       Symtab->addSymbol(LazyObject{*this, Saver.save(Sym.getName())});
     }
@@ -201,6 +201,8 @@ public:
   void parse(llvm::DenseMap<llvm::CachedHashStringRef, const InputFile *>
                  &ComdatGroups);
 
+  void initializeSymbolKeys();
+
   StringRef getShtGroupSignature(ArrayRef<Elf_Shdr> Sections,
                                  const Elf_Shdr &Sec);
 
@@ -274,6 +276,10 @@ private:
   // .shstrtab contents.
   StringRef SectionStringTable;
 
+  // The symbol table keys of the global symbols, computed ahead of parse() by
+  // initializeSymbolKeys(). Empty if they have not been computed.
+  std::vector<llvm::CachedHashStringRef> SymbolKeys;
+
   // Debugging information to retrieve source file and line for error
   // reporting. Linker may find reasonable number of errors in a
   // single object file, so we cache debugging information in order to
@@ -31,6 +31,8 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/Threading.h"
 #include <algorithm>
 #include <cstddef>
 #include <memory>
@@ -122,6 +124,30 @@ static lto::Config createConfig() {
   return C;
 }
 
+// Compiles a ThinLTO module with the program given by --thinlto-distributor,
+// which can run the backend on another machine.
+static Error runDistributor(StringRef ModulePath, StringRef IndexPath,
+                            StringRef OutputPath) {
+  std::string ErrMsg;
+  StringRef Args[] = {Config->ThinLTODistributor, ModulePath, IndexPath,
+                      OutputPath};
+  int Ret = sys::ExecuteAndWait(Config->ThinLTODistributor, Args,
+                                /*Env=*/None, /*Redirects=*/{},
+                                /*SecondsToWait=*/0, /*MemoryLimit=*/0,
+                                &ErrMsg);
+  if (Ret < 0)
+    return make_error<StringError>("unable to run " +
+                                       Config->ThinLTODistributor + ": " +
+                                       ErrMsg,
+                                   inconvertibleErrorCode());
+  if (Ret != 0)
+    return make_error<StringError>(Config->ThinLTODistributor +
+                                       " failed for " + ModulePath +
+                                       " with exit code " + Twine(Ret),
+                                   inconvertibleErrorCode());
+  return Error::success();
+}
+
 BitcodeCompiler::BitcodeCompiler() {
   // Initialize IndexFile.
   if (!Config->ThinLTOIndexOnlyArg.empty())
@@ -134,6 +160,11 @@ BitcodeCompiler::BitcodeCompiler() {
     Backend = lto::createWriteIndexesThinBackend(
         Config->ThinLTOPrefixReplace.first, Config->ThinLTOPrefixReplace.second,
         Config->ThinLTOEmitImportsFiles, IndexFile.get(), OnIndexWrite);
+  } else if (!Config->ThinLTODistributor.empty()) {
+    unsigned Jobs = Config->ThinLTOJobs != -1U
+                        ? Config->ThinLTOJobs
+                        : llvm::heavyweight_hardware_concurrency();
+    Backend = lto::createDistributedThinBackend(Jobs, runDistributor);
   } else if (Config->ThinLTOJobs != -1U) {
     Backend = lto::createInProcessThinBackend(Config->ThinLTOJobs);
   }
@@ -243,7 +274,8 @@ std::vector<InputFile *> BitcodeCompiler::compile() {
         lto::localCache(Config->ThinLTOCacheDir,
                         [&](size_t Task, std::unique_ptr<MemoryBuffer> MB) {
                           Files[Task] = std::move(MB);
-                        }));
+                        },
+                        Config->ThinLTOCacheSharded));
 
   if (!BitcodeFiles.empty())
     checkError(LTOObj->run(
@@ -16,6 +16,13 @@
 //   0020100e 00000000     0                 local
 //   00201005 00000000     0                 f(int)
 //
+// The map is meant to be read by people and is not enough to patch an output
+// file in place when an input changes: it has no record of the relocations
+// against each section, nor of the contents of the synthetic sections (GOT,
+// PLT, dynamic relocations, .eh_frame_hdr, merged strings) which depend on all
+// the inputs. An incremental link mode would need such a database along with
+// padding reserved in every output section.
+//
 //===----------------------------------------------------------------------===//
 
 #include "MapFile.h"
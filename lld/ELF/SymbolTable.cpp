@@ -86,8 +86,7 @@ static uint8_t getMinVisibility(uint8_t VA, uint8_t VB) {
   return std::min(VA, VB);
 }
 
-// Find an existing symbol or create a new one.
-Symbol *SymbolTable::insert(StringRef Name) {
+CachedHashStringRef SymbolTable::getKey(StringRef Name) {
   // <name>@@<version> means the symbol is the default version. In that
   // case <name>@@<version> will be used to resolve references to <name>.
   //
@@ -97,8 +96,14 @@ Symbol *SymbolTable::insert(StringRef Name) {
   size_t Pos = Name.find('@');
   if (Pos != StringRef::npos && Pos + 1 < Name.size() && Name[Pos + 1] == '@')
     Name = Name.take_front(Pos);
+  return CachedHashStringRef(Name);
+}
+
+// Find an existing symbol or create a new one.
+Symbol *SymbolTable::insert(StringRef Name) { return insert(getKey(Name)); }
 
-  auto P = SymMap.insert({CachedHashStringRef(Name), (int)SymVector.size()});
+Symbol *SymbolTable::insert(CachedHashStringRef Key) {
+  auto P = SymMap.insert({Key, (int)SymVector.size()});
   int &SymIndex = P.first->second;
   bool IsNew = P.second;
   bool Traced = false;
@@ -132,6 +137,12 @@ Symbol *SymbolTable::addSymbol(const Symbol &New) {
   return Old;
 }
 
+Symbol *SymbolTable::addSymbol(const Symbol &New, CachedHashStringRef Key) {
+  Symbol *Old = Symtab->insert(Key);
+  resolveSymbol(Old, New);
+  return Old;
+}
+
 static void addUndefined(Symbol *Old, const Undefined &New) {
   // An undefined symbol with non default visibility must be satisfied
   // in the same DSO.
@@ -45,9 +45,15 @@ public:
 
   ArrayRef<Symbol *> getSymbols() const { return SymVector; }
 
+  // Returns the key of a symbol name in the symbol table, which is the name
+  // without its default version.
+  static llvm::CachedHashStringRef getKey(StringRef Name);
+
   Symbol *insert(StringRef Name);
+  Symbol *insert(llvm::CachedHashStringRef Key);
 
   Symbol *addSymbol(const Symbol &New);
+  Symbol *addSymbol(const Symbol &New, llvm::CachedHashStringRef Key);
 
   void fetchLazy(Symbol *Sym);
 
@@ -2467,17 +2467,23 @@ createSymbols(ArrayRef<std::vector<GdbIndexSection::NameAttrEntry>> NameAttrs,
     }
   });
 
+  // The maps are no longer needed. Free them before flattening the symbols to
+  // lower the peak memory usage, which is dominated by the symbols.
+  Map = {};
+
   size_t NumSymbols = 0;
   for (ArrayRef<GdbSymbol> V : Symbols)
     NumSymbols += V.size();
 
   // The return type is a flattened vector, so we'll copy each vector
-  // contents to Ret.
+  // contents to Ret, freeing each shard as soon as it has been moved.
   std::vector<GdbSymbol> Ret;
   Ret.reserve(NumSymbols);
-  for (std::vector<GdbSymbol> &Vec : Symbols)
+  for (std::vector<GdbSymbol> &Vec : Symbols) {
     for (GdbSymbol &Sym : Vec)
       Ret.push_back(std::move(Sym));
+    Vec = {};
+  }
 
   // CU vectors and symbol names are adjacent in the output file.
   // We can compute their offsets in the output file now.
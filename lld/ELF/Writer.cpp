@@ -25,8 +25,7 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/RandomNumberGenerator.h"
-#include "llvm/Support/SHA1.h"
-#include "llvm/Support/xxhash.h"
+#include "llvm/Support/TreeHash.h"
 #include <climits>
 
 using namespace llvm;
@@ -1609,12 +1608,19 @@ template <class ELFT> void Writer<ELFT>::finalizeSections() {
   // earlier.
   finalizeSynthetic(In.EhFrame);
 
-  for (Symbol *S : Symtab->getSymbols())
+  // Each symbol only depends on itself, so this can be done in parallel.
+  parallelForEach(Symtab->getSymbols(), [](Symbol *S) {
     if (!S->IsPreemptible)
       S->IsPreemptible = computeIsPreemptible(*S);
+  });
 
   // Scan relocations. This must be done after every symbol is declared so that
   // we can correctly decide if a dynamic relocation is needed.
+  //
+  // The scan is serial: the GOT and PLT slots are numbered in the order in
+  // which the relocations are seen, and processing a relocation may turn its
+  // symbol into a copy-relocated or canonical PLT definition, which changes
+  // how the later relocations to the same symbol are processed.
   if (!Config->Relocatable)
     forEachRelSec(scanRelocations<ELFT>);
 
@@ -2495,39 +2501,6 @@ template <class ELFT> void Writer<ELFT>::writeSections() {
       Sec->writeTo<ELFT>(Out::BufferStart + Sec->Offset);
 }
 
-// Split one uint8 array into small pieces of uint8 arrays.
-static std::vector<ArrayRef<uint8_t>> split(ArrayRef<uint8_t> Arr,
-                                            size_t ChunkSize) {
-  std::vector<ArrayRef<uint8_t>> Ret;
-  while (Arr.size() > ChunkSize) {
-    Ret.push_back(Arr.take_front(ChunkSize));
-    Arr = Arr.drop_front(ChunkSize);
-  }
-  if (!Arr.empty())
-    Ret.push_back(Arr);
-  return Ret;
-}
-
-// Computes a hash value of Data using a given hash function.
-// In order to utilize multiple cores, we first split data into 1MB
-// chunks, compute a hash for each chunk, and then compute a hash value
-// of the hash values.
-static void
-computeHash(llvm::MutableArrayRef<uint8_t> HashBuf,
-            llvm::ArrayRef<uint8_t> Data,
-            std::function<void(uint8_t *Dest, ArrayRef<uint8_t> Arr)> HashFn) {
-  std::vector<ArrayRef<uint8_t>> Chunks = split(Data, 1024 * 1024);
-  std::vector<uint8_t> Hashes(Chunks.size() * HashBuf.size());
-
-  // Compute hash values.
-  parallelForEachN(0, Chunks.size(), [&](size_t I) {
-    HashFn(Hashes.data() + I * HashBuf.size(), Chunks[I]);
-  });
-
-  // Write to the final output buffer.
-  HashFn(HashBuf.data(), Hashes);
-}
-
 template <class ELFT> void Writer<ELFT>::writeBuildId() {
   if (!In.BuildId || !In.BuildId->getParent())
     return;
@@ -2537,25 +2510,22 @@ template <class ELFT> void Writer<ELFT>::writeBuildId() {
     return;
   }
 
-  // Compute a hash of all sections of the output file.
+  // Compute a hash of all sections of the output file. In order to utilize
+  // multiple cores, it is the hash of the hashes of its 1MB chunks.
   std::vector<uint8_t> BuildId(In.BuildId->HashSize);
   llvm::ArrayRef<uint8_t> Buf{Out::BufferStart, size_t(FileSize)};
 
   switch (Config->BuildId) {
   case BuildIdKind::Fast:
-    computeHash(BuildId, Buf, [](uint8_t *Dest, ArrayRef<uint8_t> Arr) {
-      write64le(Dest, xxHash64(Arr));
-    });
+    write64le(BuildId.data(), treeHashXXHash64(Buf, ThreadsEnabled));
     break;
   case BuildIdKind::Md5:
-    computeHash(BuildId, Buf, [&](uint8_t *Dest, ArrayRef<uint8_t> Arr) {
-      memcpy(Dest, MD5::hash(Arr).data(), In.BuildId->HashSize);
-    });
+    memcpy(BuildId.data(), treeHashMD5(Buf, ThreadsEnabled).data(),
+           In.BuildId->HashSize);
     break;
   case BuildIdKind::Sha1:
-    computeHash(BuildId, Buf, [&](uint8_t *Dest, ArrayRef<uint8_t> Arr) {
-      memcpy(Dest, SHA1::hash(Arr).data(), In.BuildId->HashSize);
-    });
+    memcpy(BuildId.data(), treeHashSHA1(Buf, ThreadsEnabled).data(),
+           In.BuildId->HashSize);
     break;
   case BuildIdKind::Uuid:
     if (auto EC = llvm::getRandomBytes(BuildId.data(), In.BuildId->HashSize))
@@ -0,0 +1,60 @@
+# REQUIRES: x86
+
+# RUN: llvm-mc -filetype=obj -triple=x86_64-unknown-linux %s -o %t
+# RUN: ld.lld -e A %t -o %t2
+# RUN: llvm-nm --numeric-sort %t2 | FileCheck %s --check-prefix=NOSORT
+
+# The calls of the lines of D, inlined into A, are calls from A.
+# RUN: echo "A:1000:0" > %t.prof
+# RUN: echo " 1: 100 B:100" >> %t.prof
+# RUN: echo " 2: 10 C:10" >> %t.prof
+# RUN: echo " 3: D:50" >> %t.prof
+# RUN: echo "  1: 50 E:50" >> %t.prof
+# RUN: echo " 4: 5 F:5" >> %t.prof
+# RUN: ld.lld -e A %t --call-graph-sample-profile=%t.prof \
+# RUN:   --print-symbol-order=%t.order -o %t2 2>&1 | FileCheck %s --check-prefix=WARN
+# RUN: FileCheck %s --check-prefix=ORDER < %t.order
+# RUN: llvm-nm --numeric-sort %t2 | FileCheck %s
+
+# RUN: not ld.lld -e A %t --call-graph-sample-profile=%t.prof \
+# RUN:   --symbol-ordering-file=%t.order -o %t2 2>&1 | FileCheck %s --check-prefix=ERR
+
+# NOSORT:      T C
+# NOSORT-NEXT: T E
+# NOSORT-NEXT: T B
+# NOSORT-NEXT: T A
+
+# WARN: warning: {{.*}}.prof: no such symbol: F
+
+# B, E then C are merged into the cluster of A, hottest edge first.
+# ORDER:      A
+# ORDER-NEXT: B
+# ORDER-NEXT: E
+# ORDER-NEXT: C
+
+# CHECK:      T A
+# CHECK-NEXT: T B
+# CHECK-NEXT: T E
+# CHECK-NEXT: T C
+
+# ERR: error: --symbol-ordering-file and --call-graph-sample-profile may not be used together
+
+    .section    .text.C,"ax",@progbits
+    .globl  C
+C:
+    retq
+
+    .section    .text.E,"ax",@progbits
+    .globl  E
+E:
+    retq
+
+    .section    .text.B,"ax",@progbits
+    .globl  B
+B:
+    retq
+
+    .section    .text.A,"ax",@progbits
+    .globl  A
+A:
+    retq
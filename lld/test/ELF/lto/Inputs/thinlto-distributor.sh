@@ -0,0 +1,8 @@
+#!/bin/sh
+# Stands in for a ThinLTO distributor: logs the command line to the file named
+# by $DISTRIBUTOR_LOG, checks that the bitcode and the index it is given exist
+# and compiles the module locally.
+echo "$# $@" >> "$DISTRIBUTOR_LOG"
+test -s "$1" || { echo "no bitcode file $1" >&2; exit 1; }
+test -s "$2" || { echo "no index file $2" >&2; exit 1; }
+exec llc -filetype=obj "$1" -o "$3"
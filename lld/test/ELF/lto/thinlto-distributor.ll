@@ -0,0 +1,37 @@
+; REQUIRES: x86
+; UNSUPPORTED: system-windows
+
+; RUN: opt -module-summary %s -o %t1.o
+; RUN: opt -module-summary %p/Inputs/thinlto-distributor.ll -o %t2.o
+
+; Each module is compiled by the distributor, with its own index, and the
+; objects it produces are linked.
+; RUN: rm -f %t.log
+; RUN: env DISTRIBUTOR_LOG=%t.log ld.lld --thinlto-jobs=1 \
+; RUN:   --thinlto-distributor=%p/Inputs/thinlto-distributor.sh \
+; RUN:   -shared %t1.o %t2.o -o %t3
+; RUN: FileCheck %s --check-prefix=LOG < %t.log
+; RUN: llvm-nm %t3 | FileCheck %s --check-prefix=NM
+
+; LOG-DAG: 3 {{.*}}1.o {{.*}}thinlto-index{{.*}}.thinlto.bc {{.*}}thinlto-object{{.*}}.o
+; LOG-DAG: 3 {{.*}}2.o {{.*}}thinlto-index{{.*}}.thinlto.bc {{.*}}thinlto-object{{.*}}.o
+
+; NM: T f
+; NM: T g
+
+; The failures of the distributor are reported.
+; RUN: not ld.lld --thinlto-distributor=%t.missing -shared %t1.o %t2.o \
+; RUN:   -o %t3 2>&1 | FileCheck %s --check-prefix=ERR
+
+; ERR: error: unable to run {{.*}}.missing
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+declare void @g()
+
+define void @f() {
+entry:
+  call void @g()
+  ret void
+}
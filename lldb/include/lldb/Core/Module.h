@@ -527,6 +527,22 @@ public:
 
   void PreloadSymbols();
 
+  /// Check whether lookups may search the debug information of the module.
+  ///
+  /// With symbols.load-on-demand, the debug information of a module is only
+  /// parsed and indexed once a lookup needs it, see EnableDebugInfo().
+  bool IsDebugInfoEnabled() const;
+
+  /// Let lookups search the debug information of the module.
+  ///
+  /// \param[in] reason
+  ///     What the lookup that needed the debug information was for.
+  void EnableDebugInfo(llvm::StringRef reason);
+
+  /// Get what the debug information of the module was first needed for, or
+  /// an empty string if no lookup enabled it.
+  std::string GetDebugInfoReason() const;
+
   void SetSymbolFileFileSpec(const FileSpec &file);
 
   const llvm::sys::TimePoint<> &GetModificationTime() const {
@@ -1014,6 +1030,8 @@ protected:
   std::atomic<bool> m_did_load_objfile{false};
   std::atomic<bool> m_did_load_symbol_vendor{false};
   std::atomic<bool> m_did_set_uuid{false};
+  std::atomic<bool> m_debug_info_enabled{false};
+  std::string m_debug_info_reason; ///< Set before m_debug_info_enabled.
   mutable bool m_file_has_changed : 1,
       m_first_file_changed_log : 1; /// See if the module was modified after it
                                     /// was initially opened.
@@ -1072,6 +1090,16 @@ protected:
 private:
   Module(); // Only used internally by CreateJITModule ()
 
+  /// Return true if the debug information of the module may be searched for
+  /// functions of the given name, enabling it if the symbol table has one.
+  bool CanSearchDebugInfoForFunctions(SymbolVendor &symbols, ConstString name,
+                                      lldb::FunctionNameType name_type_mask);
+  /// Return true if the debug information of the module may be searched for
+  /// symbols that match \a regex, enabling it if the symbol table has one.
+  bool CanSearchDebugInfoForRegex(SymbolVendor &symbols,
+                                  const RegularExpression &regex,
+                                  lldb::SymbolType symbol_type);
+
   size_t FindTypes_Impl(
       ConstString name, const CompilerDeclContext *parent_decl_ctx,
       bool append, size_t max_matches,
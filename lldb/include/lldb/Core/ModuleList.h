@@ -52,6 +52,10 @@ public:
   FileSpec GetClangModulesCachePath() const;
   bool SetClangModulesCachePath(llvm::StringRef path);
   bool GetEnableExternalLookup() const;
+  bool GetEnableIndexCache() const;
+  FileSpec GetIndexCachePath() const;
+  bool SetIndexCachePath(llvm::StringRef path);
+  bool GetLoadSymbolsOnDemand() const;
 }; 
 
 /// \class ModuleList ModuleList.h "lldb/Core/ModuleList.h"
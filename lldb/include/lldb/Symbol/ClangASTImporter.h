@@ -210,6 +210,20 @@ public:
   void ForgetDestination(clang::ASTContext *dst_ctx);
   void ForgetSource(clang::ASTContext *dst_ctx, clang::ASTContext *src_ctx);
 
+  struct Statistics {
+    /// The ASTContexts that types are imported into.
+    size_t num_destinations = 0;
+    /// The imported decls whose original decl is known.
+    size_t num_origins = 0;
+    /// The distinct types that were imported, over all the destinations.
+    size_t num_copies = 0;
+    /// The imports that reused the copy an earlier import made of the same
+    /// original type.
+    uint64_t num_reused_copies = 0;
+  };
+
+  Statistics GetStatistics() const;
+
 private:
   struct DeclOrigin {
     DeclOrigin() : ctx(nullptr), decl(nullptr) {}
@@ -235,6 +249,15 @@ private:
 
   typedef std::map<const clang::Decl *, DeclOrigin> OriginMap;
 
+  /// The copy in a destination context of a type, keyed by the decl in the
+  /// AST of the module (or of the expression) that the type comes from.
+  struct DeclCopy {
+    clang::ASTContext *origin_ctx;
+    clang::Decl *decl;
+  };
+
+  typedef llvm::DenseMap<const clang::Decl *, DeclCopy> CopyMap;
+
   /// ASTImporter that intercepts and records the import process of the
   /// underlying ASTImporter.
   ///
@@ -288,6 +311,13 @@ private:
   protected:
     llvm::Expected<clang::Decl *> ImportImpl(clang::Decl *From) override;
 
+    /// Returns the decl that an earlier import, possibly from another source
+    /// context, made in the destination for the original of \p From.
+    clang::Decl *GetExistingCopy(clang::Decl *From);
+
+    /// Records \p to as the copy in the destination of \p original.
+    void RecordCopy(const DeclOrigin &original, clang::Decl *to);
+
   public:
     // A call to "InitDeportWorkQueues" puts the delegate into deport mode.
     // In deport mode, every copied Decl that could require completion is
@@ -337,6 +367,7 @@ private:
     clang::ASTContext *m_dst_ctx;
     DelegateMap m_delegates;
     OriginMap m_origins;
+    CopyMap m_copies;
 
     NamespaceMetaMap m_namespace_maps;
     MapCompleter *m_map_completer;
@@ -394,6 +425,8 @@ private:
       RecordDeclToLayoutMap;
 
   RecordDeclToLayoutMap m_record_decl_to_layout_map;
+
+  uint64_t m_num_reused_copies = 0;
 };
 
 } // namespace lldb_private
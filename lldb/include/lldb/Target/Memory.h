@@ -44,6 +44,11 @@ public:
                       const lldb::DataBufferSP &data_buffer_sp);
 
 protected:
+  // Read the cache line at \a addr from the process, and the lines after it
+  // too when the last miss was on the line before. Returns false if nothing
+  // could be read.
+  bool ReadCacheLines(lldb::addr_t addr, Status &error);
+
   typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
   typedef RangeArray<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
   typedef Range<lldb::addr_t, lldb::addr_t> AddrRange;
@@ -57,6 +62,9 @@ protected:
   InvalidRanges m_invalid_ranges;
   Process &m_process;
   uint32_t m_L2_cache_line_byte_size;
+  uint32_t m_L2_cache_max_read_ahead; // Most cache lines read on one miss
+  uint32_t m_L2_cache_read_ahead;     // Cache lines the next miss reads
+  lldb::addr_t m_L2_cache_next_miss;  // Line after the last lines read
 
 private:
   DISALLOW_COPY_AND_ASSIGN(MemoryCache);
@@ -67,6 +67,7 @@ public:
 
   bool GetDisableMemoryCache() const;
   uint64_t GetMemoryCacheLineSize() const;
+  uint64_t GetMemoryCacheReadAhead() const;
   Args GetExtraStartupCommands() const;
   void SetExtraStartupCommands(const Args &args);
   FileSpec GetPythonOSPluginPath() const;
@@ -12,6 +12,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -34,6 +35,8 @@
 #include "lldb/Utility/Timeout.h"
 #include "lldb/lldb-public.h"
 
+#include "llvm/ADT/StringMap.h"
+
 namespace lldb_private {
 
 OptionEnumValues GetDynamicValueTypes();
@@ -135,6 +138,8 @@ public:
 
   bool GetEnableNotifyAboutFixIts() const;
 
+  bool GetEnableExpressionCache() const;
+
   bool GetEnableSaveObjects() const;
 
   bool GetEnableSyntheticValue() const;
@@ -1046,6 +1051,19 @@ public:
       const EvaluateExpressionOptions &options,
       ValueObject *ctx_obj, Status &error);
 
+  // Returns the user expression cached under \p key, removing it from the
+  // cache, if it was parsed for the context of \p exe_ctx. The caller hands
+  // it back with CacheUserExpression() once it has run.
+  lldb::UserExpressionSP TakeCachedUserExpression(llvm::StringRef key,
+                                                  ExecutionContext &exe_ctx);
+
+  void CacheUserExpression(llvm::StringRef key,
+                           const lldb::UserExpressionSP &expr_sp);
+
+  // Drops the cached user expressions, whose code may refer to modules or to
+  // a process that are gone.
+  void ClearUserExpressionCache();
+
   // Creates a FunctionCaller for the given language, the rest of the
   // parameters have the same meaning as for the FunctionCaller constructor.
   // Since a FunctionCaller can't be
@@ -1294,6 +1312,11 @@ protected:
   typedef std::map<lldb::LanguageType, lldb::REPLSP> REPLMap;
   REPLMap m_repl_map;
 
+  /// Parsed user expressions, keyed by their text and by the options and
+  /// context they were parsed with, see UserExpression::Evaluate().
+  llvm::StringMap<lldb::UserExpressionSP> m_expression_cache;
+  std::mutex m_expression_cache_mutex;
+
   lldb::ClangASTImporterSP m_ast_importer_sp;
   lldb::ClangModulesDeclVendorUP m_clang_modules_decl_vendor_up;
 
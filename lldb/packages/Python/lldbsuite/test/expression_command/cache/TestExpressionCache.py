@@ -0,0 +1,36 @@
+"""
+Test that an expression evaluated again at the same code address reuses its
+parsed code, and still reads the current values of the variables.
+"""
+
+import lldb
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test.decorators import *
+import lldbsuite.test.lldbutil as lldbutil
+
+
+class ExpressionCacheTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def evaluate_at_each_stop(self):
+        self.build()
+        (target, process, thread, bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// break here", lldb.SBFileSpec("main.c"))
+        for expected in range(3):
+            frame = thread.GetFrameAtIndex(0)
+            value = frame.EvaluateExpression("twice(counter) + i")
+            self.assertTrue(value.GetError().Success(), value.GetError())
+            self.assertEqual(value.GetValueAsSigned(), 3 * expected)
+            process.Continue()
+
+    def test_cached(self):
+        """Reused expressions see the values of the current stop."""
+        self.evaluate_at_each_stop()
+
+    def test_not_cached(self):
+        """target.cache-expressions turns the reuse off."""
+        self.runCmd("settings set target.cache-expressions false")
+        self.addTearDownHook(
+            lambda: self.runCmd("settings clear target.cache-expressions"))
+        self.evaluate_at_each_stop()
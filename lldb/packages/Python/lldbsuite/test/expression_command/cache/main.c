@@ -0,0 +1,9 @@
+int counter = 0;
+
+int twice(int value) { return 2 * value; }
+
+int main(void) {
+  for (int i = 0; i < 3; i++)
+    counter += 1; // break here
+  return 0;
+}
@@ -0,0 +1,43 @@
+"""
+Test that symbols.load-on-demand only enables the debug information of a module
+once a lookup needs it, and records why.
+"""
+
+import lldb
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test.decorators import *
+import lldbsuite.test.lldbutil as lldbutil
+
+
+class LoadOnDemandTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NO_DEBUG_INFO_TESTCASE = True
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.runCmd("settings set symbols.load-on-demand true")
+        self.addTearDownHook(
+            lambda: self.runCmd("settings clear symbols.load-on-demand"))
+
+    def test_name_lookup(self):
+        """A function name in the symbol table enables the debug info."""
+        self.build()
+        exe = self.getBuildArtifact("a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+        self.expect("image list -L a.out", substrs=["<not loaded>"])
+
+        lldbutil.run_break_set_by_symbol(self, "bump", num_expected_locations=1)
+        self.expect("image list -L a.out", substrs=["function 'bump'"])
+
+    def test_file_and_line_lookup(self):
+        """A compile unit of the file enables the debug info."""
+        self.build()
+        exe = self.getBuildArtifact("a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line(
+            self, "main.c", line_number("main.c", "// break here"),
+            num_expected_locations=1)
+        self.expect("image list -L a.out", substrs=["file 'main.c'"])
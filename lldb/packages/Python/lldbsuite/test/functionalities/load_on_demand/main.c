@@ -0,0 +1,7 @@
+int global_counter;
+
+int bump(int by) { return global_counter += by; }
+
+int main(int argc, char const *argv[]) {
+  return bump(argc) - argc; // break here
+}
@@ -10,6 +10,8 @@
 #include "lldb/Host/Host.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Symbol/ClangASTImporter.h"
 #include "lldb/Target/Target.h"
 
 using namespace lldb;
@@ -91,6 +93,48 @@ protected:
   }
 };
 
+class CommandObjectStatsMemory : public CommandObjectParsed {
+public:
+  CommandObjectStatsMemory(CommandInterpreter &interpreter)
+      : CommandObjectParsed(interpreter, "memory",
+                            "Report the memory used by the types that "
+                            "expressions import into the scratch AST",
+                            nullptr, eCommandProcessMustBePaused) {}
+
+  ~CommandObjectStatsMemory() override = default;
+
+protected:
+  bool DoExecute(Args &command, CommandReturnObject &result) override {
+    Target *target = GetSelectedOrDummyTarget();
+
+    ClangASTContext *scratch_ast = target->GetScratchClangASTContext(false);
+    if (scratch_ast && scratch_ast->getASTContext()) {
+      clang::ASTContext *ast = scratch_ast->getASTContext();
+      result.AppendMessageWithFormat("Scratch AST memory : %" PRIu64 "\n",
+                                     (uint64_t)ast->getASTAllocatedMemory());
+      result.AppendMessageWithFormat(
+          "Scratch AST side table memory : %" PRIu64 "\n",
+          (uint64_t)ast->getSideTableAllocatedMemory());
+    }
+
+    if (ClangASTImporterSP importer_sp = target->GetClangASTImporter()) {
+      ClangASTImporter::Statistics stats = importer_sp->GetStatistics();
+      result.AppendMessageWithFormat("ASTs importing types : %" PRIu64 "\n",
+                                     (uint64_t)stats.num_destinations);
+      result.AppendMessageWithFormat("Imported decls with an origin : %" PRIu64
+                                     "\n",
+                                     (uint64_t)stats.num_origins);
+      result.AppendMessageWithFormat("Distinct imported types : %" PRIu64 "\n",
+                                     (uint64_t)stats.num_copies);
+      result.AppendMessageWithFormat(
+          "Imports reusing an earlier copy : %" PRIu64 "\n",
+          stats.num_reused_copies);
+    }
+    result.SetStatus(eReturnStatusSuccessFinishResult);
+    return true;
+  }
+};
+
 CommandObjectStats::CommandObjectStats(CommandInterpreter &interpreter)
     : CommandObjectMultiword(interpreter, "statistics",
                              "Print statistics about a debugging session",
@@ -101,6 +145,8 @@ CommandObjectStats::CommandObjectStats(CommandInterpreter &interpreter)
                  CommandObjectSP(new CommandObjectStatsDisable(interpreter)));
   LoadSubCommand("dump",
                  CommandObjectSP(new CommandObjectStatsDump(interpreter)));
+  LoadSubCommand("memory",
+                 CommandObjectSP(new CommandObjectStatsMemory(interpreter)));
 }
 
 CommandObjectStats::~CommandObjectStats() = default;
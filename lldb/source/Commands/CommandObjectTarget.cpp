@@ -2986,6 +2986,7 @@ static constexpr OptionDefinition g_target_modules_list_options[] = {
   { LLDB_OPT_SET_1, false, "mod-time",       'm', OptionParser::eOptionalArgument, nullptr, {}, 0, eArgTypeWidth,               "Display the modification time with optional width of the module." },
   { LLDB_OPT_SET_1, false, "ref-count",      'r', OptionParser::eOptionalArgument, nullptr, {}, 0, eArgTypeWidth,               "Display the reference count if the module is still in the shared module cache." },
   { LLDB_OPT_SET_1, false, "pointer",        'p', OptionParser::eOptionalArgument, nullptr, {}, 0, eArgTypeNone,                "Display the module pointer." },
+  { LLDB_OPT_SET_1, false, "load-reason",    'L', OptionParser::eOptionalArgument, nullptr, {}, 0, eArgTypeWidth,               "Display why the debug information of the module was loaded, with symbols.load-on-demand." },
   { LLDB_OPT_SET_1, false, "global",         'g', OptionParser::eNoArgument,       nullptr, {}, 0, eArgTypeNone,                "Display the modules from the global module list, not just the current target." }
     // clang-format on
 };
@@ -3311,6 +3312,14 @@ protected:
         strm.Printf("%p", static_cast<void *>(module));
         break;
 
+      case 'L': {
+        std::string reason = module->GetDebugInfoReason();
+        if (reason.empty())
+          reason = module->IsDebugInfoEnabled() ? "<always>" : "<not loaded>";
+        strm.Format("{0}", llvm::fmt_align(reason, llvm::AlignStyle::Left,
+                                           width));
+      } break;
+
       case 'u':
         DumpModuleUUID(strm, module);
         break;
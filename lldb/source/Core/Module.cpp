@@ -13,6 +13,7 @@
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/FileSpecList.h"
 #include "lldb/Core/Mangled.h"
+#include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/SearchFilter.h"
 #include "lldb/Core/Section.h"
@@ -56,6 +57,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -466,6 +468,10 @@ uint32_t Module::ResolveSymbolContextForAddress(
         resolve_scope & eSymbolContextBlock ||
         resolve_scope & eSymbolContextLineEntry ||
         resolve_scope & eSymbolContextVariable) {
+      if (!IsDebugInfoEnabled())
+        EnableDebugInfo(llvm::formatv("address {0:x}",
+                                      so_addr.GetFileAddress())
+                            .str());
       resolved_flags |=
           sym_vendor->ResolveSymbolContext(so_addr, resolve_scope, sc);
     }
@@ -591,9 +597,26 @@ uint32_t Module::ResolveSymbolContextsForFileSpec(
   const uint32_t initial_count = sc_list.GetSize();
 
   SymbolVendor *symbols = GetSymbolVendor();
-  if (symbols)
-    symbols->ResolveSymbolContext(file_spec, line, check_inlines, resolve_scope,
-                                  sc_list);
+  if (!symbols)
+    return 0;
+
+  if (!IsDebugInfoEnabled()) {
+    // Without an index, only the names of the compile units tell cheaply
+    // whether the module has lines of the file.
+    const bool full = !file_spec.GetDirectory().IsEmpty();
+    bool found = false;
+    for (size_t i = 0, e = symbols->GetNumCompileUnits(); i < e && !found;
+         ++i) {
+      if (CompUnitSP cu_sp = symbols->GetCompileUnitAtIndex(i))
+        found = FileSpec::Equal(*cu_sp, file_spec, full);
+    }
+    if (!found)
+      return 0;
+    EnableDebugInfo(llvm::formatv("file '{0}'", file_spec).str());
+  }
+
+  symbols->ResolveSymbolContext(file_spec, line, check_inlines, resolve_scope,
+                                sc_list);
 
   return sc_list.GetSize() - initial_count;
 }
@@ -603,17 +626,26 @@ size_t Module::FindGlobalVariables(ConstString name,
                                    size_t max_matches,
                                    VariableList &variables) {
   SymbolVendor *symbols = GetSymbolVendor();
-  if (symbols)
-    return symbols->FindGlobalVariables(name, parent_decl_ctx, max_matches,
-                                        variables);
-  return 0;
+  if (!symbols)
+    return 0;
+  if (!IsDebugInfoEnabled()) {
+    Symtab *symtab = symbols->GetSymtab();
+    if (!symtab ||
+        !symtab->FindFirstSymbolWithNameAndType(name, eSymbolTypeData,
+                                                Symtab::eDebugAny,
+                                                Symtab::eVisibilityAny))
+      return 0;
+    EnableDebugInfo(llvm::formatv("variable '{0}'", name).str());
+  }
+  return symbols->FindGlobalVariables(name, parent_decl_ctx, max_matches,
+                                      variables);
 }
 
 size_t Module::FindGlobalVariables(const RegularExpression &regex,
                                    size_t max_matches,
                                    VariableList &variables) {
   SymbolVendor *symbols = GetSymbolVendor();
-  if (symbols)
+  if (symbols && CanSearchDebugInfoForRegex(*symbols, regex, eSymbolTypeData))
     return symbols->FindGlobalVariables(regex, max_matches, variables);
   return 0;
 }
@@ -815,9 +847,12 @@ size_t Module::FindFunctions(ConstString name,
     LookupInfo lookup_info(name, name_type_mask, eLanguageTypeUnknown);
 
     if (symbols) {
-      symbols->FindFunctions(lookup_info.GetLookupName(), parent_decl_ctx,
-                             lookup_info.GetNameTypeMask(), include_inlines,
-                             append, sc_list);
+      if (CanSearchDebugInfoForFunctions(*symbols,
+                                         lookup_info.GetLookupName(),
+                                         lookup_info.GetNameTypeMask()))
+        symbols->FindFunctions(lookup_info.GetLookupName(), parent_decl_ctx,
+                               lookup_info.GetNameTypeMask(), include_inlines,
+                               append, sc_list);
 
       // Now check our symbol table for symbols that are code symbols if
       // requested
@@ -835,8 +870,9 @@ size_t Module::FindFunctions(ConstString name,
       lookup_info.Prune(sc_list, old_size);
   } else {
     if (symbols) {
-      symbols->FindFunctions(name, parent_decl_ctx, name_type_mask,
-                             include_inlines, append, sc_list);
+      if (CanSearchDebugInfoForFunctions(*symbols, name, name_type_mask))
+        symbols->FindFunctions(name, parent_decl_ctx, name_type_mask,
+                               include_inlines, append, sc_list);
 
       // Now check our symbol table for symbols that are code symbols if
       // requested
@@ -861,7 +897,8 @@ size_t Module::FindFunctions(const RegularExpression &regex,
 
   SymbolVendor *symbols = GetSymbolVendor();
   if (symbols) {
-    symbols->FindFunctions(regex, include_inlines, append, sc_list);
+    if (CanSearchDebugInfoForRegex(*symbols, regex, eSymbolTypeCode))
+      symbols->FindFunctions(regex, include_inlines, append, sc_list);
 
     // Now check our symbol table for symbols that are code symbols if
     // requested
@@ -952,8 +989,10 @@ size_t Module::FindTypes_Impl(
     TypeMap &types) {
   static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
   Timer scoped_timer(func_cat, LLVM_PRETTY_FUNCTION);
+  // Symbol tables do not name types, so only the modules that another lookup
+  // needed the debug information of are searched.
   SymbolVendor *symbols = GetSymbolVendor();
-  if (symbols)
+  if (symbols && IsDebugInfoEnabled())
     return symbols->FindTypes(name, parent_decl_ctx, append, max_matches,
                               searched_symbol_files, types);
   return 0;
@@ -1426,6 +1465,58 @@ void Module::PreloadSymbols() {
   }
 }
 
+bool Module::IsDebugInfoEnabled() const {
+  return m_debug_info_enabled ||
+         !ModuleList::GetGlobalModuleListProperties().GetLoadSymbolsOnDemand();
+}
+
+void Module::EnableDebugInfo(llvm::StringRef reason) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  if (m_debug_info_enabled)
+    return;
+  m_debug_info_reason = reason;
+  m_debug_info_enabled = true;
+
+  Log *log(lldb_private::GetLogIfAnyCategoriesSet(LIBLLDB_LOG_SYMBOLS |
+                                                  LIBLLDB_LOG_MODULES));
+  LLDB_LOG(log, "Module '{0}': enabled debug info for {1}", m_file, reason);
+}
+
+std::string Module::GetDebugInfoReason() const {
+  if (!m_debug_info_enabled)
+    return std::string();
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  return m_debug_info_reason;
+}
+
+bool Module::CanSearchDebugInfoForFunctions(
+    SymbolVendor &symbols, ConstString name,
+    FunctionNameType name_type_mask) {
+  if (IsDebugInfoEnabled())
+    return true;
+  Symtab *symtab = symbols.GetSymtab();
+  SymbolContextList sc_list;
+  if (!symtab || !symtab->FindFunctionSymbols(name, name_type_mask, sc_list))
+    return false;
+  EnableDebugInfo(llvm::formatv("function '{0}'", name).str());
+  return true;
+}
+
+bool Module::CanSearchDebugInfoForRegex(SymbolVendor &symbols,
+                                        const RegularExpression &regex,
+                                        SymbolType symbol_type) {
+  if (IsDebugInfoEnabled())
+    return true;
+  Symtab *symtab = symbols.GetSymtab();
+  std::vector<uint32_t> symbol_indexes;
+  if (!symtab || !symtab->AppendSymbolIndexesMatchingRegExAndType(
+                     regex, symbol_type, symbol_indexes))
+    return false;
+  EnableDebugInfo(
+      llvm::formatv("regular expression '{0}'", regex.GetText()).str());
+  return true;
+}
+
 void Module::SetSymbolFileFileSpec(const FileSpec &file) {
   if (!FileSystem::Instance().Exists(file))
     return;
@@ -32,6 +32,7 @@
 #include "clang/Driver/Driver.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -80,9 +81,29 @@ static constexpr PropertyDefinition g_properties[] = {
     },
     {"clang-modules-cache-path", OptionValue::eTypeFileSpec, true, 0, nullptr,
      {},
-     "The path to the clang modules cache directory (-fmodules-cache-path)."}};
-
-enum { ePropertyEnableExternalLookup, ePropertyClangModulesCachePath };
+     "The path to the clang modules cache directory (-fmodules-cache-path)."},
+    {"enable-index-cache", OptionValue::eTypeBoolean, true, false, nullptr,
+     {},
+     "Save the symbol indexes that lldb builds for modules without "
+     "accelerator tables to the index cache, and load them from there in "
+     "later debug sessions."},
+    {"index-cache-path", OptionValue::eTypeFileSpec, true, 0, nullptr, {},
+     "The path to the directory of the symbol index cache."},
+    {"load-on-demand", OptionValue::eTypeBoolean, true, false, nullptr, {},
+     "Only parse and index the debug information of a module once an address "
+     "in the module is looked up, or its symbol table or the names of its "
+     "compile units match a name or file lookup. Types of a module that no "
+     "lookup hit, and functions and variables in stripped modules, are not "
+     "found. The symbols.load-on-demand setting also disables "
+     "target.preload-symbols."}};
+
+enum {
+  ePropertyEnableExternalLookup,
+  ePropertyClangModulesCachePath,
+  ePropertyEnableIndexCache,
+  ePropertyIndexCachePath,
+  ePropertyLoadOnDemand
+};
 
 } // namespace
 
@@ -94,6 +115,11 @@ ModuleListProperties::ModuleListProperties() {
   llvm::SmallString<128> path;
   clang::driver::Driver::getDefaultModuleCachePath(path);
   SetClangModulesCachePath(path);
+
+  path.clear();
+  llvm::sys::path::system_temp_directory(/*erasedOnReboot=*/false, path);
+  llvm::sys::path::append(path, "lldb", "IndexCache");
+  SetIndexCachePath(path);
 }
 
 bool ModuleListProperties::GetEnableExternalLookup() const {
@@ -114,6 +140,30 @@ bool ModuleListProperties::SetClangModulesCachePath(llvm::StringRef path) {
       nullptr, ePropertyClangModulesCachePath, path);
 }
 
+bool ModuleListProperties::GetEnableIndexCache() const {
+  const uint32_t idx = ePropertyEnableIndexCache;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+FileSpec ModuleListProperties::GetIndexCachePath() const {
+  return m_collection_sp
+      ->GetPropertyAtIndexAsOptionValueFileSpec(nullptr, false,
+                                                ePropertyIndexCachePath)
+      ->GetCurrentValue();
+}
+
+bool ModuleListProperties::SetIndexCachePath(llvm::StringRef path) {
+  return m_collection_sp->SetPropertyAtIndexAsString(
+      nullptr, ePropertyIndexCachePath, path);
+}
+
+bool ModuleListProperties::GetLoadSymbolsOnDemand() const {
+  const uint32_t idx = ePropertyLoadOnDemand;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 
 ModuleList::ModuleList()
     : m_modules(), m_modules_mutex(), m_notifier(nullptr) {}
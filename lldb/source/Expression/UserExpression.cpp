@@ -218,24 +218,36 @@ lldb::ExpressionResults UserExpression::Evaluate(
       language = frame->GetLanguage();
   }
 
-  lldb::UserExpressionSP user_expression_sp(
-      target->GetUserExpressionForLanguage(expr, full_prefix, language,
-                                           desired_type, options, ctx_obj,
-                                           error));
-  if (error.Fail()) {
-    if (log)
-      log->Printf("== [UserExpression::Evaluate] Getting expression: %s ==",
-                  error.AsCString());
-    return lldb::eExpressionSetupError;
-  }
-
-  if (log)
-    log->Printf("== [UserExpression::Evaluate] Parsing expression %s ==",
-                expr.str().c_str());
-
   const bool keep_expression_in_memory = true;
   const bool generate_debug_info = options.GetGenerateDebugInfo();
 
+  // An expression that is evaluated again with the same options, at the same
+  // code address, reuses the code it was compiled to the first time. The name
+  // lookups of the parse would give the same answers, and the values are read
+  // only when it runs. Expressions that mention persistent variables or types
+  // are left out, as those can be redeclared between evaluations, and so are
+  // top level expressions, which declare rather than run anything.
+  std::string cache_key;
+  if (!ctx_obj && execution_policy != eExecutionPolicyTopLevel &&
+      expr.find('$') == llvm::StringRef::npos &&
+      full_prefix.find('$') == llvm::StringRef::npos &&
+      target->GetEnableExpressionCache()) {
+    StreamString key;
+    key.Printf("%d:%d:%d:%d:%d:%zu:", language, desired_type, execution_policy,
+               generate_debug_info, options.IsForUtilityExpr(),
+               full_prefix.size());
+    key.PutCString(full_prefix);
+    key.PutCString(expr);
+    cache_key = key.GetString();
+  } else if (execution_policy == eExecutionPolicyTopLevel) {
+    // The new declarations may shadow what the cached expressions found.
+    target->ClearUserExpressionCache();
+  }
+
+  lldb::UserExpressionSP user_expression_sp;
+  if (!cache_key.empty())
+    user_expression_sp = target->TakeCachedUserExpression(cache_key, exe_ctx);
+
   if (options.InvokeCancelCallback(lldb::eExpressionEvaluationParse)) {
     error.SetErrorString("expression interrupted by callback before parse");
     result_valobj_sp = ValueObjectConstResult::Create(
@@ -244,10 +256,32 @@ lldb::ExpressionResults UserExpression::Evaluate(
   }
 
   DiagnosticManager diagnostic_manager;
+  bool parse_success = false;
 
-  bool parse_success =
-      user_expression_sp->Parse(diagnostic_manager, exe_ctx, execution_policy,
-                                keep_expression_in_memory, generate_debug_info);
+  if (user_expression_sp) {
+    if (log)
+      log->Printf("== [UserExpression::Evaluate] Reusing parsed expression "
+                  "%s ==",
+                  expr.str().c_str());
+    parse_success = true;
+  } else {
+    user_expression_sp.reset(target->GetUserExpressionForLanguage(
+        expr, full_prefix, language, desired_type, options, ctx_obj, error));
+    if (error.Fail()) {
+      if (log)
+        log->Printf("== [UserExpression::Evaluate] Getting expression: %s ==",
+                    error.AsCString());
+      return lldb::eExpressionSetupError;
+    }
+
+    if (log)
+      log->Printf("== [UserExpression::Evaluate] Parsing expression %s ==",
+                  expr.str().c_str());
+
+    parse_success = user_expression_sp->Parse(
+        diagnostic_manager, exe_ctx, execution_policy,
+        keep_expression_in_memory, generate_debug_info);
+  }
 
   // Calculate the fixed expression always, since we need it for errors.
   std::string tmp_fixed_expression;
@@ -275,6 +309,8 @@ lldb::ExpressionResults UserExpression::Evaluate(
       if (parse_success) {
         diagnostic_manager.Clear();
         user_expression_sp = fixed_expression_sp;
+        // The cache key names the text the user wrote, not the fixed one.
+        cache_key.clear();
       } else {
         // If the fixed expression failed to parse, don't tell the user about,
         // that won't help.
@@ -338,6 +374,10 @@ lldb::ExpressionResults UserExpression::Evaluate(
           user_expression_sp->Execute(diagnostic_manager, exe_ctx, options,
                                       user_expression_sp, expr_result);
 
+      if (execution_results == lldb::eExpressionCompleted &&
+          !cache_key.empty())
+        target->CacheUserExpression(cache_key, user_expression_sp);
+
       if (execution_results != lldb::eExpressionCompleted) {
         if (log)
           log->Printf("== [UserExpression::Evaluate] Execution completed "
@@ -13,14 +13,30 @@
 #include "Plugins/SymbolFile/DWARF/LogChannelDWARF.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARFDwo.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Host/FileSystem.h"
 #include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/Timer.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace lldb_private;
 using namespace lldb;
 
+// The cache file starts with the magic, the version and the size of the string
+// table, then holds the string table and the indexes in the order of
+// GetCachedIndexes().
+static const uint32_t g_cache_magic = 0x58444e49; // "INDX"
+static const uint32_t g_cache_version = 1;
+
 void ManualDWARFIndex::Index() {
   if (!m_debug_info)
     return;
@@ -41,6 +57,10 @@ void ManualDWARFIndex::Index() {
   if (units_to_index.empty())
     return;
 
+  FileSpec cache_file = GetCacheFile(units_to_index);
+  if (cache_file && LoadFromCache(cache_file))
+    return;
+
   std::vector<IndexSet> sets(units_to_index.size());
 
   // Keep memory down by clearing DIEs for any units if indexing
@@ -85,6 +105,142 @@ void ManualDWARFIndex::Index() {
                      [&]() { finalize_fn(&IndexSet::globals); },
                      [&]() { finalize_fn(&IndexSet::types); },
                      [&]() { finalize_fn(&IndexSet::namespaces); });
+
+  // The index does not cover the changes of split DWARF files.
+  if (cache_file &&
+      llvm::none_of(units_to_index, [](DWARFUnit *unit) {
+        return unit->GetDwoSymbolFile() != nullptr;
+      }))
+    SaveToCache(cache_file);
+}
+
+FileSpec ManualDWARFIndex::GetCacheFile(llvm::ArrayRef<DWARFUnit *> units) {
+  ModuleListProperties &properties =
+      ModuleList::GetGlobalModuleListProperties();
+  if (!properties.GetEnableIndexCache() || !m_units_to_avoid.empty())
+    return FileSpec();
+
+  // The DWARF may be in a separate symbol file, which has the UUID of the
+  // module but can be rebuilt on its own, so the key of the index uses the
+  // modification time of the file with the DWARF.
+  const UUID &uuid = m_module.GetUUID();
+  ObjectFile *obj_file = units.front()->GetSymbolFileDWARF()->GetObjectFile();
+  if (!uuid.IsValid() || !obj_file)
+    return FileSpec();
+  llvm::sys::TimePoint<> mod_time =
+      FileSystem::Instance().GetModificationTime(obj_file->GetFileSpec());
+  if (mod_time == llvm::sys::TimePoint<>())
+    return FileSpec();
+
+  FileSpec cache_file = properties.GetIndexCachePath();
+  if (!cache_file)
+    return FileSpec();
+  cache_file.AppendPathComponent(
+      llvm::formatv("{0}-{1}.index", uuid.GetAsString(""),
+                    mod_time.time_since_epoch().count())
+          .str());
+  return cache_file;
+}
+
+llvm::ArrayRef<NameToDIE ManualDWARFIndex::IndexSet::*>
+ManualDWARFIndex::GetCachedIndexes() {
+  static NameToDIE IndexSet::*const g_indexes[] = {
+      &IndexSet::function_basenames,   &IndexSet::function_fullnames,
+      &IndexSet::function_methods,     &IndexSet::function_selectors,
+      &IndexSet::objc_class_selectors, &IndexSet::globals,
+      &IndexSet::types,                &IndexSet::namespaces};
+  return g_indexes;
+}
+
+bool ManualDWARFIndex::LoadFromCache(const FileSpec &cache_file) {
+  // Large files are mapped rather than read.
+  auto buffer_or_error = llvm::MemoryBuffer::getFile(
+      cache_file.GetPath(), /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+  if (!buffer_or_error)
+    return false;
+  const llvm::MemoryBuffer &buffer = **buffer_or_error;
+
+  DataExtractor data(buffer.getBufferStart(), buffer.getBufferSize(),
+                     eByteOrderLittle, /*addr_size=*/8);
+  lldb::offset_t offset = 0;
+  if (data.GetU32(&offset) != g_cache_magic ||
+      data.GetU32(&offset) != g_cache_version)
+    return false;
+  const uint32_t strtab_size = data.GetU32(&offset);
+  if (!data.ValidOffsetForDataOfSize(offset, strtab_size) ||
+      (strtab_size && data.GetDataStart()[offset + strtab_size - 1] != '\0'))
+    return false;
+  DataExtractor strtab(data.GetDataStart() + offset, strtab_size,
+                       eByteOrderLittle, /*addr_size=*/8);
+  offset += strtab_size;
+
+  for (NameToDIE IndexSet::*index : GetCachedIndexes()) {
+    if (!(m_set.*index).Decode(data, &offset, strtab)) {
+      m_set = IndexSet();
+      return false;
+    }
+  }
+
+  if (Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO))
+    m_module.LogMessage(log, "ManualDWARFIndex loaded the index from '%s'",
+                        cache_file.GetPath().c_str());
+  return true;
+}
+
+void ManualDWARFIndex::SaveToCache(const FileSpec &cache_file) {
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO);
+
+  // Lay out the names of all the indexes in one string table.
+  llvm::DenseMap<const char *, uint32_t> strtab;
+  std::string strings;
+  for (NameToDIE IndexSet::*index : GetCachedIndexes()) {
+    (m_set.*index).ForEach([&](ConstString name, const DIERef &die_ref) {
+      if (strtab.try_emplace(name.GetCString(), strings.size()).second) {
+        strings.append(name.GetCString(), name.GetLength());
+        strings.push_back('\0');
+      }
+      return true;
+    });
+  }
+
+  // Write a temporary file and rename it, so that a concurrent debug session
+  // never reads a partial index.
+  std::string path = cache_file.GetPath();
+  llvm::SmallString<128> temp_path;
+  int fd;
+  std::error_code ec = llvm::sys::fs::create_directories(
+      cache_file.GetDirectory().GetStringRef());
+  if (!ec)
+    ec = llvm::sys::fs::createUniqueFile(path + "-%%%%%%", fd, temp_path);
+  if (ec) {
+    if (log)
+      m_module.LogMessage(log, "ManualDWARFIndex can't create '%s': %s",
+                          path.c_str(), ec.message().c_str());
+    return;
+  }
+
+  llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+  llvm::support::endian::Writer writer(os, llvm::support::little);
+  writer.write<uint32_t>(g_cache_magic);
+  writer.write<uint32_t>(g_cache_version);
+  writer.write<uint32_t>(strings.size());
+  os << strings;
+  for (NameToDIE IndexSet::*index : GetCachedIndexes())
+    (m_set.*index).Encode(os, strtab);
+  os.close();
+
+  if (os.has_error()) {
+    os.clear_error();
+    ec = std::make_error_code(std::errc::io_error);
+  } else {
+    ec = llvm::sys::fs::rename(temp_path, path);
+  }
+  if (ec) {
+    llvm::sys::fs::remove(temp_path);
+    if (log)
+      m_module.LogMessage(log, "ManualDWARFIndex can't write '%s': %s",
+                          path.c_str(), ec.message().c_str());
+  }
 }
 
 void ManualDWARFIndex::IndexUnit(DWARFUnit &unit, IndexSet &set) {
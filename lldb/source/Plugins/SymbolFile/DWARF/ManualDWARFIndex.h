@@ -11,6 +11,8 @@
 
 #include "Plugins/SymbolFile/DWARF/DWARFIndex.h"
 #include "Plugins/SymbolFile/DWARF/NameToDIE.h"
+#include "lldb/Utility/FileSpec.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseSet.h"
 
 namespace lldb_private {
@@ -57,6 +59,15 @@ private:
   void Index();
   void IndexUnit(DWARFUnit &unit, IndexSet &set);
 
+  /// The indexes of a set, in the order of the cache file.
+  static llvm::ArrayRef<NameToDIE IndexSet::*> GetCachedIndexes();
+  /// Return the file of the index cache for the \p units of this module, or
+  /// an invalid file spec if the index is not to be cached.
+  FileSpec GetCacheFile(llvm::ArrayRef<DWARFUnit *> units);
+  /// Read the index from \p cache_file, which SaveToCache() wrote.
+  bool LoadFromCache(const FileSpec &cache_file);
+  void SaveToCache(const FileSpec &cache_file);
+
   static void
   IndexUnitImpl(DWARFUnit &unit, const lldb::LanguageType cu_language,
                 const DWARFFormValue::FixedFormSizes &fixed_form_sizes,
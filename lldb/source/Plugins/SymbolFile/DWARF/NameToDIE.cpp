@@ -9,6 +9,7 @@
 #include "NameToDIE.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/StreamString.h"
@@ -17,6 +18,8 @@
 #include "DWARFDebugInfoEntry.h"
 #include "SymbolFileDWARF.h"
 
+#include "llvm/Support/EndianStream.h"
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -78,3 +81,41 @@ void NameToDIE::Append(const NameToDIE &other) {
                  other.m_map.GetValueAtIndexUnchecked(i));
   }
 }
+
+void NameToDIE::Encode(
+    llvm::raw_ostream &os,
+    const llvm::DenseMap<const char *, uint32_t> &strtab) const {
+  llvm::support::endian::Writer writer(os, llvm::support::little);
+  const uint32_t size = m_map.GetSize();
+  writer.write<uint32_t>(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    const DIERef &die_ref = m_map.GetValueAtIndexUnchecked(i);
+    writer.write<uint32_t>(
+        strtab.lookup(m_map.GetCStringAtIndexUnchecked(i).GetCString()));
+    writer.write<uint8_t>(die_ref.section);
+    writer.write<uint32_t>(die_ref.cu_offset);
+    writer.write<uint32_t>(die_ref.die_offset);
+  }
+}
+
+bool NameToDIE::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+                       const DataExtractor &strtab) {
+  // Name, section, unit and DIE offset of an entry.
+  const lldb::offset_t entry_size = 4 + 1 + 4 + 4;
+  const uint32_t size = data.GetU32(offset_ptr);
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, size * entry_size))
+    return false;
+  m_map.Reserve(m_map.GetSize() + size);
+  for (uint32_t i = 0; i < size; ++i) {
+    const char *name = strtab.PeekCStr(data.GetU32(offset_ptr));
+    uint8_t section = data.GetU8(offset_ptr);
+    dw_offset_t cu_offset = data.GetU32(offset_ptr);
+    dw_offset_t die_offset = data.GetU32(offset_ptr);
+    if (!name || section > DIERef::DebugTypes)
+      return false;
+    m_map.Append(ConstString(name),
+                 DIERef(DIERef::Section(section), cu_offset, die_offset));
+  }
+  Finalize();
+  return true;
+}
@@ -15,6 +15,12 @@
 #include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Core/dwarf.h"
 #include "lldb/lldb-defines.h"
+#include "lldb/lldb-forward.h"
+#include "llvm/ADT/DenseMap.h"
+
+namespace llvm {
+class raw_ostream;
+}
 
 class SymbolFileDWARF;
 
@@ -46,6 +52,20 @@ public:
                              const DIERef &die_ref)> const
               &callback) const;
 
+  /// Write the entries to \p os in little endian order. A name is written as
+  /// its offset in \p strtab, which must hold all the names of the map.
+  void Encode(llvm::raw_ostream &os,
+              const llvm::DenseMap<const char *, uint32_t> &strtab) const;
+
+  /// Append the entries that Encode() wrote at \p *offset_ptr in \p data,
+  /// with their names in \p strtab, and finalize the map.
+  ///
+  /// \return
+  ///     False if the entries are truncated or a name is not in \p strtab.
+  bool Decode(const lldb_private::DataExtractor &data,
+              lldb::offset_t *offset_ptr,
+              const lldb_private::DataExtractor &strtab);
+
 protected:
   lldb_private::UniqueCStringMap<DIERef> m_map;
 };
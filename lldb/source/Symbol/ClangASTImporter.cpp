@@ -847,6 +847,27 @@ void ClangASTImporter::ForgetSource(clang::ASTContext *dst_ast,
     else
       ++iter;
   }
+
+  for (CopyMap::iterator iter = md->m_copies.begin();
+       iter != md->m_copies.end(); ++iter) {
+    if (iter->second.origin_ctx == src_ast)
+      md->m_copies.erase(iter);
+  }
+}
+
+ClangASTImporter::Statistics ClangASTImporter::GetStatistics() const {
+  Statistics stats;
+  for (const auto &context_md : m_metadata_map) {
+    // The ASTs of the modules get an entry too, as the source of imports.
+    if (context_md.second->m_delegates.empty() &&
+        context_md.second->m_origins.empty())
+      continue;
+    ++stats.num_destinations;
+    stats.num_origins += context_md.second->m_origins.size();
+    stats.num_copies += context_md.second->m_copies.size();
+  }
+  stats.num_reused_copies = m_num_reused_copies;
+  return stats;
 }
 
 ClangASTImporter::MapCompleter::~MapCompleter() { return; }
@@ -866,9 +887,64 @@ ClangASTImporter::ASTImporterDelegate::ImportImpl(Decl *From) {
     }
   }
 
+  // Every expression imports the types it uses anew, from its own AST. Map
+  // the ones that were imported before to the same copy, so that the scratch
+  // AST does not fill up with duplicates of them.
+  if (clang::Decl *copy = GetExistingCopy(From)) {
+    Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_EXPRESSIONS));
+    LLDB_LOG(log,
+             "    [ClangASTImporter] Reusing ({0}Decl*){1} for (Decl*){2}",
+             copy->getDeclKindName(), static_cast<void *>(copy),
+             static_cast<void *>(From));
+    RegisterImportedDecl(From, copy);
+    ++m_master.m_num_reused_copies;
+    return copy;
+  }
+
   return ASTImporter::ImportImpl(From);
 }
 
+clang::Decl *
+ClangASTImporter::ASTImporterDelegate::GetExistingCopy(clang::Decl *From) {
+  if (!isa<TagDecl>(From) && !isa<ObjCInterfaceDecl>(From))
+    return nullptr;
+
+  ASTContextMetadataSP to_context_md =
+      m_master.MaybeGetContextMetadata(&getToContext());
+  if (!to_context_md)
+    return nullptr;
+
+  // A decl that was itself imported stands for the decl it was imported from,
+  // which is the same for all the expressions that use the type.
+  const clang::Decl *original = From;
+  if (ASTContextMetadataSP from_context_md =
+          m_master.MaybeGetContextMetadata(m_source_ctx)) {
+    OriginMap::iterator origin_iter = from_context_md->m_origins.find(From);
+    if (origin_iter != from_context_md->m_origins.end())
+      original = origin_iter->second.decl;
+  }
+
+  CopyMap::iterator copy_iter = to_context_md->m_copies.find(original);
+  if (copy_iter == to_context_md->m_copies.end())
+    return nullptr;
+
+  clang::Decl *copy = copy_iter->second.decl;
+  if (copy->getKind() != From->getKind())
+    return nullptr;
+  return copy;
+}
+
+void ClangASTImporter::ASTImporterDelegate::RecordCopy(
+    const DeclOrigin &original, clang::Decl *to) {
+  if (!isa<TagDecl>(to) && !isa<ObjCInterfaceDecl>(to))
+    return;
+
+  ASTContextMetadataSP to_context_md =
+      m_master.GetContextMetadata(&to->getASTContext());
+  to_context_md->m_copies.insert(
+      std::make_pair(original.decl, DeclCopy{original.ctx, to}));
+}
+
 void ClangASTImporter::ASTImporterDelegate::InitDeportWorkQueues(
     std::set<clang::NamedDecl *> *decls_to_deport,
     std::set<clang::NamedDecl *> *decls_already_deported) {
@@ -1074,6 +1150,9 @@ void ClangASTImporter::ASTImporterDelegate::Imported(clang::Decl *from,
           to_context_md->m_origins[to] = origin_iter->second;
       }
 
+      if (origin_iter->second.ctx != &to->getASTContext())
+        RecordCopy(origin_iter->second, to);
+
       ImporterDelegateSP direct_completer =
           m_master.GetDelegate(&to->getASTContext(), origin_iter->second.ctx);
 
@@ -1107,6 +1186,8 @@ void ClangASTImporter::ASTImporterDelegate::Imported(clang::Decl *from,
         to_context_md->m_origins[to] = DeclOrigin(m_source_ctx, from);
       }
 
+      RecordCopy(DeclOrigin(m_source_ctx, from), to);
+
       if (log)
         log->Printf("    [ClangASTImporter] Decl has no origin information in "
                     "(ASTContext*)%p",
@@ -1129,6 +1210,7 @@ void ClangASTImporter::ASTImporterDelegate::Imported(clang::Decl *from,
     }
   } else {
     to_context_md->m_origins[to] = DeclOrigin(m_source_ctx, from);
+    RecordCopy(DeclOrigin(m_source_ctx, from), to);
 
     if (log)
       log->Printf("    [ClangASTImporter] Sourced origin "
@@ -13,6 +13,7 @@
 #include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/State.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <memory>
 
@@ -23,7 +24,9 @@ using namespace lldb_private;
 MemoryCache::MemoryCache(Process &process)
     : m_mutex(), m_L1_cache(), m_L2_cache(), m_invalid_ranges(),
       m_process(process),
-      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()) {}
+      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()),
+      m_L2_cache_max_read_ahead(process.GetMemoryCacheReadAhead()),
+      m_L2_cache_read_ahead(1), m_L2_cache_next_miss(LLDB_INVALID_ADDRESS) {}
 
 // Destructor
 MemoryCache::~MemoryCache() {}
@@ -35,6 +38,9 @@ void MemoryCache::Clear(bool clear_invalid_ranges) {
   if (clear_invalid_ranges)
     m_invalid_ranges.Clear();
   m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+  m_L2_cache_max_read_ahead = m_process.GetMemoryCacheReadAhead();
+  m_L2_cache_read_ahead = 1;
+  m_L2_cache_next_miss = LLDB_INVALID_ADDRESS;
 }
 
 void MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src,
@@ -224,17 +230,8 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
 
       if (bytes_left > 0) {
         assert((curr_addr % cache_line_byte_size) == 0);
-        std::unique_ptr<DataBufferHeap> data_buffer_heap_up(
-            new DataBufferHeap(cache_line_byte_size, 0));
-        size_t process_bytes_read = m_process.ReadMemoryFromInferior(
-            curr_addr, data_buffer_heap_up->GetBytes(),
-            data_buffer_heap_up->GetByteSize(), error);
-        if (process_bytes_read == 0)
+        if (!ReadCacheLines(curr_addr, error))
           return dst_len - bytes_left;
-
-        if (process_bytes_read != cache_line_byte_size)
-          data_buffer_heap_up->SetByteSize(process_bytes_read);
-        m_L2_cache[curr_addr] = DataBufferSP(data_buffer_heap_up.release());
         // We have read data and put it into the cache, continue through the
         // loop again to get the data out of the cache...
       }
@@ -244,6 +241,53 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
   return dst_len - bytes_left;
 }
 
+bool MemoryCache::ReadCacheLines(addr_t addr, Status &error) {
+  const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+
+  // Misses on consecutive lines, as when data formatters walk through a large
+  // container, or an unwinder up the stack, read twice as many lines each
+  // time. Stop at the lines that are cached or known not to be readable.
+  if (addr == m_L2_cache_next_miss)
+    m_L2_cache_read_ahead = std::min(2 * m_L2_cache_read_ahead,
+                                     std::max(m_L2_cache_max_read_ahead, 1u));
+  else
+    m_L2_cache_read_ahead = 1;
+  uint32_t num_lines = 1;
+  while (num_lines < m_L2_cache_read_ahead) {
+    const addr_t line_addr =
+        addr + static_cast<addr_t>(num_lines) * cache_line_byte_size;
+    if (line_addr < addr || m_L2_cache.count(line_addr) ||
+        m_invalid_ranges.FindEntryThatContains(line_addr))
+      break;
+    ++num_lines;
+  }
+
+  DataBufferHeap data(num_lines * cache_line_byte_size, 0);
+  size_t bytes_read = m_process.ReadMemoryFromInferior(
+      addr, data.GetBytes(), data.GetByteSize(), error);
+  // Some stubs fail the whole read when its end is not readable.
+  if (bytes_read == 0 && num_lines > 1) {
+    num_lines = 1;
+    m_L2_cache_read_ahead = 1;
+    error.Clear();
+    bytes_read = m_process.ReadMemoryFromInferior(
+        addr, data.GetBytes(), cache_line_byte_size, error);
+  }
+  if (bytes_read == 0)
+    return false;
+
+  for (size_t offset = 0; offset < bytes_read; offset += cache_line_byte_size) {
+    const size_t line_size =
+        std::min<size_t>(cache_line_byte_size, bytes_read - offset);
+    m_L2_cache[addr + offset] = std::make_shared<DataBufferHeap>(
+        data.GetBytes() + offset, line_size);
+  }
+  m_L2_cache_next_miss = bytes_read == data.GetByteSize()
+                             ? addr + bytes_read
+                             : LLDB_INVALID_ADDRESS;
+  return true;
+}
+
 AllocatedBlock::AllocatedBlock(lldb::addr_t addr, uint32_t byte_size,
                                uint32_t permissions, uint32_t chunk_size)
     : m_range(addr, byte_size), m_permissions(permissions),
@@ -139,6 +139,10 @@ static constexpr PropertyDefinition g_properties[] = {
      {}, "If true, detach will attempt to keep the process stopped."},
     {"memory-cache-line-size", OptionValue::eTypeUInt64, false, 512, nullptr,
      {}, "The memory cache line size"},
+    {"memory-cache-read-ahead", OptionValue::eTypeUInt64, false, 32, nullptr,
+     {}, "The largest number of memory cache lines that misses on consecutive "
+     "cache lines read at once. Each such miss doubles the number of lines "
+     "read, so scanning a large object takes few requests to the process."},
     {"optimization-warnings", OptionValue::eTypeBoolean, false, true, nullptr,
      {}, "If true, warn when stopped in code that is optimized where "
          "stepping and variable availability may not behave as expected."},
@@ -159,6 +163,7 @@ enum {
   ePropertyStopOnSharedLibraryEvents,
   ePropertyDetachKeepsStopped,
   ePropertyMemCacheLineSize,
+  ePropertyMemCacheReadAhead,
   ePropertyWarningOptimization,
   ePropertyStopOnExec,
   ePropertyUtilityExpressionTimeout,
@@ -206,6 +211,12 @@ uint64_t ProcessProperties::GetMemoryCacheLineSize() const {
       nullptr, idx, g_properties[idx].default_uint_value);
 }
 
+uint64_t ProcessProperties::GetMemoryCacheReadAhead() const {
+  const uint32_t idx = ePropertyMemCacheReadAhead;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_properties[idx].default_uint_value);
+}
+
 Args ProcessProperties::GetExtraStartupCommands() const {
   Args args;
   const uint32_t idx = ePropertyExtraStartCommand;
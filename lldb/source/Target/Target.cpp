@@ -187,6 +187,7 @@ void Target::DeleteCurrentProcess() {
     m_process_sp->Finalize();
 
     CleanupProcess();
+    ClearUserExpressionCache();
 
     m_process_sp.reset();
   }
@@ -1420,6 +1421,7 @@ void Target::ClearModules(bool delete_locations) {
   m_images.Clear();
   m_scratch_type_system_map.Clear();
   m_ast_importer_sp.reset();
+  ClearUserExpressionCache();
 }
 
 void Target::DidExec() {
@@ -1660,6 +1662,7 @@ void Target::ModulesDidLoad(ModuleList &module_list) {
     if (m_process_sp) {
       m_process_sp->ModulesDidLoad(module_list);
     }
+    ClearUserExpressionCache();
     BroadcastEvent(eBroadcastBitModulesLoaded,
                    new TargetEventData(this->shared_from_this(), module_list));
   }
@@ -1686,6 +1689,7 @@ void Target::SymbolsDidLoad(ModuleList &module_list) {
 void Target::ModulesDidUnload(ModuleList &module_list, bool delete_locations) {
   if (m_valid && module_list.GetSize()) {
     UnloadModuleSections(module_list);
+    ClearUserExpressionCache();
     m_breakpoint_list.UpdateBreakpoints(module_list, false, delete_locations);
     m_internal_breakpoint_list.UpdateBreakpoints(module_list, false,
                                                  delete_locations);
@@ -2120,7 +2124,9 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
 
         // Preload symbols outside of any lock, so hopefully we can do this for
         // each library in parallel.
-        if (GetPreloadSymbols())
+        if (GetPreloadSymbols() &&
+            !ModuleList::GetGlobalModuleListProperties()
+                 .GetLoadSymbolsOnDemand())
           module_sp->PreloadSymbols();
 
         if (old_module_sp &&
@@ -2243,6 +2249,41 @@ UserExpression *Target::GetUserExpressionForLanguage(
   return user_expr;
 }
 
+// Beyond this many entries the cache starts over, rather than keeping around
+// the JIT code of expressions that are not evaluated anymore.
+static const size_t g_max_cached_expressions = 64;
+
+lldb::UserExpressionSP
+Target::TakeCachedUserExpression(llvm::StringRef key,
+                                 ExecutionContext &exe_ctx) {
+  std::lock_guard<std::mutex> guard(m_expression_cache_mutex);
+  auto pos = m_expression_cache.find(key);
+  if (pos == m_expression_cache.end())
+    return lldb::UserExpressionSP();
+
+  // The entry leaves the cache while it runs, so that an expression evaluated
+  // from within its own execution is parsed anew rather than reentered.
+  lldb::UserExpressionSP user_expression_sp = pos->second;
+  m_expression_cache.erase(pos);
+  if (!user_expression_sp->MatchesContext(exe_ctx))
+    return lldb::UserExpressionSP();
+  return user_expression_sp;
+}
+
+void Target::CacheUserExpression(llvm::StringRef key,
+                                 const lldb::UserExpressionSP &expr_sp) {
+  std::lock_guard<std::mutex> guard(m_expression_cache_mutex);
+  if (m_expression_cache.size() >= g_max_cached_expressions &&
+      !m_expression_cache.count(key))
+    m_expression_cache.clear();
+  m_expression_cache[key] = expr_sp;
+}
+
+void Target::ClearUserExpressionCache() {
+  std::lock_guard<std::mutex> guard(m_expression_cache_mutex);
+  m_expression_cache.clear();
+}
+
 FunctionCaller *Target::GetFunctionCallerForLanguage(
     lldb::LanguageType language, const CompilerType &return_type,
     const Address &function_address, const ValueList &arg_value_list,
@@ -3346,6 +3387,9 @@ static constexpr PropertyDefinition g_properties[] = {
      {}, "Print the fixed expression text."},
     {"save-jit-objects", OptionValue::eTypeBoolean, false, false, nullptr,
      {}, "Save intermediate object files generated by the LLVM JIT"},
+    {"cache-expressions", OptionValue::eTypeBoolean, false, true, nullptr,
+     {}, "Reuse the parsed and JIT-compiled code of an expression when it is "
+     "evaluated again with the same options at the same code address."},
     {"max-children-count", OptionValue::eTypeSInt64, false, 256, nullptr,
      {}, "Maximum number of children to expand in any level of depth."},
     {"max-string-summary-length", OptionValue::eTypeSInt64, false, 1024,
@@ -3482,6 +3526,7 @@ enum {
   ePropertyAutoApplyFixIts,
   ePropertyNotifyAboutFixIts,
   ePropertySaveObjects,
+  ePropertyCacheExpressions,
   ePropertyMaxChildrenCount,
   ePropertyMaxSummaryLength,
   ePropertyMaxMemReadSize,
@@ -3918,6 +3963,12 @@ bool TargetProperties::GetEnableAutoApplyFixIts() const {
       nullptr, idx, g_properties[idx].default_uint_value != 0);
 }
 
+bool TargetProperties::GetEnableExpressionCache() const {
+  const uint32_t idx = ePropertyCacheExpressions;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 bool TargetProperties::GetEnableNotifyAboutFixIts() const {
   const uint32_t idx = ePropertyNotifyAboutFixIts;
   return m_collection_sp->GetPropertyAtIndexAsBoolean(
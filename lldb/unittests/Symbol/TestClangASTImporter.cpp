@@ -0,0 +1,99 @@
+//===-- TestClangASTImporter.cpp --------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Symbol/ClangASTImporter.h"
+#include "lldb/Symbol/ClangUtil.h"
+
+using namespace clang;
+using namespace lldb;
+using namespace lldb_private;
+
+class TestClangASTImporter : public testing::Test {
+public:
+  static void SetUpTestCase() {
+    FileSystem::Initialize();
+    HostInfo::Initialize();
+  }
+
+  static void TearDownTestCase() {
+    HostInfo::Terminate();
+    FileSystem::Terminate();
+  }
+
+protected:
+  std::unique_ptr<ClangASTContext> CreateAST() {
+    return llvm::make_unique<ClangASTContext>(
+        HostInfo::GetTargetTriple().c_str());
+  }
+
+  CompilerType CreateRecord(ClangASTContext &ast, const char *name) {
+    CompilerType int_type =
+        ClangASTContext::GetBasicType(ast.getASTContext(), eBasicTypeInt);
+    CompilerType record_type =
+        ast.CreateRecordType(nullptr, lldb::eAccessPublic, name,
+                             clang::TTK_Struct, lldb::eLanguageTypeC, nullptr);
+    ClangASTContext::StartTagDeclarationDefinition(record_type);
+    ast.AddFieldToRecordType(record_type, "field", int_type, eAccessPublic, 0);
+    ClangASTContext::CompleteTagDeclarationDefinition(record_type);
+    return record_type;
+  }
+
+  // Imports the type into a new expression AST, and deports it from there to
+  // the scratch AST, the way the result of an expression is persisted.
+  RecordDecl *Persist(ClangASTImporter &importer, ClangASTContext &scratch_ast,
+                      const CompilerType &type) {
+    std::unique_ptr<ClangASTContext> expr_ast = CreateAST();
+    CompilerType expr_type = importer.CopyType(*expr_ast, type);
+    EXPECT_TRUE(expr_type.IsValid());
+
+    lldb::opaque_compiler_type_t scratch_type = importer.DeportType(
+        scratch_ast.getASTContext(), expr_ast->getASTContext(),
+        expr_type.GetOpaqueQualType());
+    importer.ForgetSource(scratch_ast.getASTContext(),
+                          expr_ast->getASTContext());
+    importer.ForgetDestination(expr_ast->getASTContext());
+    return ClangASTContext::GetAsRecordDecl(
+        CompilerType(&scratch_ast, scratch_type));
+  }
+};
+
+TEST_F(TestClangASTImporter, DeportReusesEarlierCopy) {
+  std::unique_ptr<ClangASTContext> module_ast = CreateAST();
+  std::unique_ptr<ClangASTContext> scratch_ast = CreateAST();
+  CompilerType record_type = CreateRecord(*module_ast, "Record");
+
+  ClangASTImporter importer;
+  RecordDecl *first = Persist(importer, *scratch_ast, record_type);
+  ASSERT_NE(nullptr, first);
+  EXPECT_EQ(0u, importer.GetStatistics().num_reused_copies);
+
+  RecordDecl *second = Persist(importer, *scratch_ast, record_type);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(1u, importer.GetStatistics().num_reused_copies);
+}
+
+TEST_F(TestClangASTImporter, DistinctTypesAreNotMerged) {
+  std::unique_ptr<ClangASTContext> module_ast = CreateAST();
+  std::unique_ptr<ClangASTContext> scratch_ast = CreateAST();
+  CompilerType first_type = CreateRecord(*module_ast, "First");
+  CompilerType second_type = CreateRecord(*module_ast, "Second");
+
+  ClangASTImporter importer;
+  RecordDecl *first = Persist(importer, *scratch_ast, first_type);
+  RecordDecl *second = Persist(importer, *scratch_ast, second_type);
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(0u, importer.GetStatistics().num_reused_copies);
+  EXPECT_EQ(2u, importer.GetStatistics().num_copies);
+}
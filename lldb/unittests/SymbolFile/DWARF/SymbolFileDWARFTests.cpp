@@ -13,8 +13,10 @@
 #include "llvm/DebugInfo/PDB/PDBSymbolExe.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 
 #include "Plugins/ObjectFile/PECOFF/ObjectFilePECOFF.h"
+#include "Plugins/SymbolFile/DWARF/NameToDIE.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARF.h"
 #include "Plugins/SymbolFile/PDB/SymbolFilePDB.h"
 #include "TestingSupport/TestUtilities.h"
@@ -28,6 +30,7 @@
 #include "lldb/Symbol/LineTable.h"
 #include "lldb/Symbol/SymbolVendor.h"
 #include "lldb/Utility/ArchSpec.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/FileSpec.h"
 
 using namespace lldb_private;
@@ -76,3 +79,48 @@ TEST_F(SymbolFileDWARFTests, TestAbilitiesForDWARF) {
   uint32_t expected_abilities = SymbolFile::kAllAbilities;
   EXPECT_EQ(expected_abilities, symfile->CalculateAbilities());
 }
+
+TEST_F(SymbolFileDWARFTests, TestNameToDIEEncodeDecode) {
+  NameToDIE map;
+  map.Insert(ConstString("main"), DIERef(DIERef::DebugInfo, 0x0b, 0x2d));
+  map.Insert(ConstString("foo"), DIERef(DIERef::DebugTypes, 0x40, 0x51));
+  map.Insert(ConstString("main"), DIERef(DIERef::DebugInfo, 0x60, 0x7a));
+  map.Finalize();
+
+  llvm::DenseMap<const char *, uint32_t> strtab;
+  std::string strings;
+  map.ForEach([&](ConstString name, const DIERef &die_ref) {
+    if (strtab.try_emplace(name.GetCString(), strings.size()).second) {
+      strings += name.GetStringRef();
+      strings.push_back('\0');
+    }
+    return true;
+  });
+  std::string encoded;
+  llvm::raw_string_ostream os(encoded);
+  map.Encode(os, strtab);
+  os.flush();
+
+  DataExtractor data(encoded.data(), encoded.size(), lldb::eByteOrderLittle,
+                     8);
+  DataExtractor strtab_data(strings.data(), strings.size(),
+                            lldb::eByteOrderLittle, 8);
+  lldb::offset_t offset = 0;
+  NameToDIE decoded;
+  ASSERT_TRUE(decoded.Decode(data, &offset, strtab_data));
+  EXPECT_EQ(encoded.size(), offset);
+
+  DIEArray dies;
+  EXPECT_EQ(2u, decoded.Find(ConstString("main"), dies));
+  dies.clear();
+  ASSERT_EQ(1u, decoded.Find(ConstString("foo"), dies));
+  EXPECT_EQ(DIERef::DebugTypes, dies[0].section);
+  EXPECT_EQ(0x40u, dies[0].cu_offset);
+  EXPECT_EQ(0x51u, dies[0].die_offset);
+
+  DataExtractor truncated(encoded.data(), encoded.size() - 1,
+                          lldb::eByteOrderLittle, 8);
+  offset = 0;
+  NameToDIE partial;
+  EXPECT_FALSE(partial.Decode(truncated, &offset, strtab_data));
+}
@@ -94,6 +94,12 @@ bool isSpirvText(std::string &Img);
 std::unique_ptr<SPIRVModule> readSpirvModule(std::istream &IS,
                                              std::string &ErrMsg);
 
+/// \brief Load SPIR-V from memory as a SPIRVModule. The binary format is
+/// decoded in place, without copying the input.
+/// \returns null on failure.
+std::unique_ptr<SPIRVModule> readSpirvModule(llvm::StringRef Input,
+                                             std::string &ErrMsg);
+
 } // End namespace SPIRV
 
 namespace llvm {
@@ -102,11 +108,29 @@ namespace llvm {
 /// \returns true if succeeds.
 bool writeSpirv(Module *M, std::ostream &OS, std::string &ErrMsg);
 
+/// \brief Translate the entry points of the LLVM module named in EntryPoints,
+/// and the functions and variables they depend on, to SPIR-V and write to
+/// ostream. M itself is left unchanged.
+/// \returns true if succeeds.
+bool writeSpirv(Module *M, ArrayRef<std::string> EntryPoints, std::ostream &OS,
+                std::string &ErrMsg);
+
+/// \brief Compute a hash of the content of F and of the functions and
+/// variables it depends on. An entry point whose hash did not change since it
+/// was last written does not need to be translated again. The hash may also
+/// change with unrelated changes of the metadata of the module.
+uint64_t getSpirvContentHash(const Function &F);
+
 /// \brief Load SPIR-V from istream and translate to LLVM module.
 /// \returns true if succeeds.
 bool readSpirv(LLVMContext &C, std::istream &IS, Module *&M,
                std::string &ErrMsg);
 
+/// \brief Load SPIR-V from memory and translate to LLVM module.
+/// \returns true if succeeds.
+bool readSpirv(LLVMContext &C, StringRef Input, Module *&M,
+               std::string &ErrMsg);
+
 /// \brief Convert a SPIRVModule into LLVM IR.
 /// \returns null on failure.
 std::unique_ptr<Module>
@@ -139,7 +163,7 @@ ModulePass *createOCL21ToSPIRV();
 ModulePass *createOCLTypeToSPIRV();
 
 /// Create a pass for lowering cast instructions of i1 type.
-ModulePass *createSPIRVLowerBool();
+FunctionPass *createSPIRVLowerBool();
 
 /// Create a pass for lowering constant expressions to instructions.
 ModulePass *createSPIRVLowerConstExpr();
@@ -152,7 +176,7 @@ ModulePass *createSPIRVLowerOCLBlocks();
 
 /// Create a pass for lowering llvm.memmove to llvm.memcpys with a temporary
 /// variable.
-ModulePass *createSPIRVLowerMemmove();
+FunctionPass *createSPIRVLowerMemmove();
 
 /// Create a pass for regularize LLVM module to be translated to SPIR-V.
 ModulePass *createSPIRVRegularizeLLVM();
@@ -55,9 +55,10 @@ cl::opt<bool> SPIRVLowerBoolValidate(
     "spvbool-validate",
     cl::desc("Validate module after lowering boolean instructions for SPIR-V"));
 
-class SPIRVLowerBool : public ModulePass, public InstVisitor<SPIRVLowerBool> {
+class SPIRVLowerBool : public FunctionPass,
+                       public InstVisitor<SPIRVLowerBool> {
 public:
-  SPIRVLowerBool() : ModulePass(ID), Context(nullptr) {
+  SPIRVLowerBool() : FunctionPass(ID), Context(nullptr) {
     initializeSPIRVLowerBoolPass(*PassRegistry::getPassRegistry());
   }
   void replace(Instruction *I, Instruction *NewI) {
@@ -103,16 +104,16 @@ public:
       replace(&I, Sel);
     }
   }
-  bool runOnModule(Module &M) override {
-    Context = &M.getContext();
-    visit(M);
+  bool runOnFunction(Function &F) override {
+    Context = &F.getContext();
+    visit(F);
 
     if (SPIRVLowerBoolValidate) {
-      LLVM_DEBUG(dbgs() << "After SPIRVLowerBool:\n" << M);
+      LLVM_DEBUG(dbgs() << "After SPIRVLowerBool:\n" << F);
       std::string Err;
       raw_string_ostream ErrorOS(Err);
-      if (verifyModule(M, &ErrorOS)) {
-        Err = std::string("Fails to verify module: ") + Err;
+      if (verifyFunction(F, &ErrorOS)) {
+        Err = std::string("Fails to verify function: ") + ErrorOS.str();
         report_fatal_error(Err.c_str(), false);
       }
     }
@@ -131,4 +132,4 @@ char SPIRVLowerBool::ID = 0;
 INITIALIZE_PASS(SPIRVLowerBool, "spvbool",
                 "Lower instructions with bool operands", false, false)
 
-ModulePass *llvm::createSPIRVLowerBool() { return new SPIRVLowerBool(); }
+FunctionPass *llvm::createSPIRVLowerBool() { return new SPIRVLowerBool(); }
@@ -57,10 +57,10 @@ cl::opt<bool> SPIRVLowerMemmoveValidate(
     cl::desc("Validate module after lowering llvm.memmove instructions into "
              "llvm.memcpy"));
 
-class SPIRVLowerMemmove : public ModulePass,
+class SPIRVLowerMemmove : public FunctionPass,
                           public InstVisitor<SPIRVLowerMemmove> {
 public:
-  SPIRVLowerMemmove() : ModulePass(ID), Context(nullptr) {
+  SPIRVLowerMemmove() : FunctionPass(ID), Context(nullptr) {
     initializeSPIRVLowerMemmovePass(*PassRegistry::getPassRegistry());
   }
   virtual void visitMemMoveInst(MemMoveInst &I) {
@@ -107,17 +107,17 @@ public:
     I.dropAllReferences();
     I.eraseFromParent();
   }
-  bool runOnModule(Module &M) override {
-    Context = &M.getContext();
-    Mod = &M;
-    visit(M);
+  bool runOnFunction(Function &F) override {
+    Context = &F.getContext();
+    Mod = F.getParent();
+    visit(F);
 
     if (SPIRVLowerMemmoveValidate) {
-      LLVM_DEBUG(dbgs() << "After SPIRVLowerMemmove:\n" << M);
+      LLVM_DEBUG(dbgs() << "After SPIRVLowerMemmove:\n" << F);
       std::string Err;
       raw_string_ostream ErrorOS(Err);
-      if (verifyModule(M, &ErrorOS)) {
-        Err = std::string("Fails to verify module: ") + Err;
+      if (verifyFunction(F, &ErrorOS)) {
+        Err = std::string("Fails to verify function: ") + ErrorOS.str();
         report_fatal_error(Err.c_str(), false);
       }
     }
@@ -137,4 +137,6 @@ char SPIRVLowerMemmove::ID = 0;
 INITIALIZE_PASS(SPIRVLowerMemmove, "spvmemmove",
                 "Lower llvm.memmove into llvm.memcpy", false, false)
 
-ModulePass *llvm::createSPIRVLowerMemmove() { return new SPIRVLowerMemmove(); }
+FunctionPass *llvm::createSPIRVLowerMemmove() {
+  return new SPIRVLowerMemmove();
+}
@@ -52,6 +52,8 @@
 
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/IRBuilder.h"
@@ -61,10 +63,14 @@
 #include "llvm/IR/Metadata.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
+#include "llvm/Linker/Linker.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #include <algorithm>
 #include <cstdlib>
@@ -95,6 +101,11 @@ cl::opt<bool> SPIRVGenKernelArgNameMD(
     cl::desc("Enable generating OpenCL kernel argument name "
              "metadata"));
 
+cl::opt<unsigned> SPIRVReaderThreads(
+    "spirv-reader-threads", cl::init(1),
+    cl::desc("Number of threads translating the function bodies of a SPIR-V "
+             "module in parallel"));
+
 // Prefix for placeholder global variable name.
 const char *KPlaceholderPrefix = "placeholder.";
 
@@ -541,7 +552,45 @@ bool SPIRVToLLVM::isSPIRVCmpInstTransToLLVMInst(SPIRVInstruction *BI) const {
   return isCmpOpCode(OC) && !(OC >= OpLessOrGreater && OC <= OpUnordered);
 }
 
+// Returns true if V is translated to a global value shared by the shards of
+// a parallel translation: it is defined in one shard and declared in the
+// others. The other global values are private to each shard.
+static bool isSharedGlobal(const SPIRVValue *V) {
+  if (V->getOpCode() == OpFunction)
+    return static_cast<const SPIRVFunction *>(V)->getNumBasicBlock() != 0;
+  if (V->getOpCode() != OpVariable)
+    return false;
+  auto BVar = static_cast<const SPIRVVariable *>(V);
+  if (BVar->getStorageClass() == StorageClassFunction || BVar->isBuiltin())
+    return false;
+  // Internal constants are duplicated in the shards using them.
+  return !BVar->isConstant() || !BVar->getInitializer() ||
+         BVar->getLinkageType() != LinkageTypeInternal;
+}
+
+// Returns the name of a shared global value with internal linkage in the
+// shards, where it is external to be linked with the other shards.
+static std::string getShardName(const SPIRVValue *V) {
+  return V->getName() + ".spirv.shard." + std::to_string(V->getId());
+}
+
+// Adjusts the name and the linkage of the shared global value V for
+// translating a shard.
+static void adjustShardLinkage(const SPIRVValue *V, bool IsDefinition,
+                               std::string &Name,
+                               GlobalValue::LinkageTypes &Linkage) {
+  if (GlobalValue::isLocalLinkage(Linkage)) {
+    Name = getShardName(V);
+    Linkage = GlobalValue::ExternalLinkage;
+  } else if (!IsDefinition) {
+    Linkage = GlobalValue::ExternalLinkage;
+  }
+}
+
 void SPIRVToLLVM::setName(llvm::Value *V, SPIRVValue *BV) {
+  // The global values of a shard are named when they are created.
+  if (ShardBodies && isa<GlobalValue>(V))
+    return;
   auto Name = BV->getName();
   if (!Name.empty() && (!V->hasName() || Name != V->getName()))
     V->setName(Name);
@@ -1149,6 +1198,8 @@ Value *SPIRVToLLVM::transValueWithoutDecoration(SPIRVValue *BV, Function *F,
 
   // Translation of non-instruction values
   switch (OC) {
+  // LLVM IR has no specialization constants, they take their default value.
+  case OpSpecConstant:
   case OpConstant: {
     SPIRVConstant *BConst = static_cast<SPIRVConstant *>(BV);
     SPIRVType *BT = BV->getType();
@@ -1185,9 +1236,11 @@ Value *SPIRVToLLVM::transValueWithoutDecoration(SPIRVValue *BV, Function *F,
     }
   }
 
+  case OpSpecConstantTrue:
   case OpConstantTrue:
     return mapValue(BV, ConstantInt::getTrue(*Context));
 
+  case OpSpecConstantFalse:
   case OpConstantFalse:
     return mapValue(BV, ConstantInt::getFalse(*Context));
 
@@ -1260,15 +1313,22 @@ Value *SPIRVToLLVM::transValueWithoutDecoration(SPIRVValue *BV, Function *F,
     auto Ty = transType(BVar->getType()->getPointerElementType());
     bool IsConst = BVar->isConstant();
     llvm::GlobalValue::LinkageTypes LinkageTy = transLinkageType(BVar);
+    std::string Name = BV->getName();
+    bool IsDefinition = true;
+    if (ShardBodies && isSharedGlobal(BVar)) {
+      IsDefinition = ShardDefinesVariables;
+      adjustShardLinkage(BVar, IsDefinition, Name, LinkageTy);
+    }
     Constant *Initializer = nullptr;
     SPIRVValue *Init = BVar->getInitializer();
-    if (Init)
+    // A declared variable is defined in another shard.
+    if (Init && IsDefinition)
       Initializer = dyn_cast<Constant>(transValue(Init, F, BB, false));
     else if (LinkageTy == GlobalValue::CommonLinkage)
       // In LLVM variables with common linkage type must be initilized by 0
       Initializer = Constant::getNullValue(Ty);
-    else if (BVar->getStorageClass() ==
-             SPIRVStorageClassKind::StorageClassWorkgroup)
+    else if (IsDefinition && BVar->getStorageClass() ==
+                                 SPIRVStorageClassKind::StorageClassWorkgroup)
       Initializer = dyn_cast<Constant>(UndefValue::get(Ty));
 
     SPIRVStorageClassKind BS = BVar->getStorageClass();
@@ -1278,7 +1338,7 @@ Value *SPIRVToLLVM::transValueWithoutDecoration(SPIRVValue *BV, Function *F,
     }
     auto AddrSpace = SPIRSPIRVAddrSpaceMap::rmap(BS);
     auto LVar = new GlobalVariable(*M, Ty, IsConst, LinkageTy, Initializer,
-                                   BV->getName(), 0,
+                                   Name, 0,
                                    GlobalVariable::NotThreadLocal, AddrSpace);
     LVar->setUnnamedAddr((IsConst && Ty->isArrayTy() &&
                           Ty->getArrayElementType()->isIntegerTy(8))
@@ -1786,9 +1846,13 @@ Function *SPIRVToLLVM::transFunction(SPIRVFunction *BF) {
 
   auto IsKernel = BM->isEntryPoint(ExecutionModelKernel, BF->getId());
   auto Linkage = IsKernel ? GlobalValue::ExternalLinkage : transLinkageType(BF);
+  std::string Name = BF->getName();
+  const bool HasBody = !ShardBodies || ShardBodies->count(BF);
+  if (ShardBodies && isSharedGlobal(BF))
+    adjustShardLinkage(BF, HasBody, Name, Linkage);
   FunctionType *FT = dyn_cast<FunctionType>(transType(BF->getFunctionType()));
   Function *F = cast<Function>(
-      mapValue(BF, Function::Create(FT, Linkage, BF->getName(), M)));
+      mapValue(BF, Function::Create(FT, Linkage, Name, M)));
   mapFunction(BF, F);
   if (!F->isIntrinsic()) {
     F->setCallingConv(IsKernel ? CallingConv::SPIR_KERNEL
@@ -1823,6 +1887,8 @@ Function *SPIRVToLLVM::transFunction(SPIRVFunction *BF) {
     F->addAttribute(AttributeList::ReturnIndex,
                     SPIRSPIRVFuncParamAttrMap::rmap(Kind));
   });
+  if (!HasBody)
+    return F;
 
   // Creating all basic blocks before creating instructions.
   for (size_t I = 0, E = BF->getNumBasicBlock(); I != E; ++I) {
@@ -2474,7 +2540,7 @@ bool SPIRVToLLVM::transKernelMetadata() {
     SPIRVFunction *BF = BM->getFunction(I);
     Function *F = static_cast<Function *>(getTranslatedValue(BF));
     assert(F && "Invalid translated function");
-    if (F->getCallingConv() != CallingConv::SPIR_KERNEL)
+    if (F->getCallingConv() != CallingConv::SPIR_KERNEL || F->isDeclaration())
       continue;
 
     // Generate metadata for kernel_arg_address_spaces
@@ -3001,6 +3067,7 @@ Instruction *SPIRVToLLVM::transOCLRelational(SPIRVInstruction *I,
 
 std::unique_ptr<SPIRVModule> readSpirvModule(std::istream &IS,
                                              std::string &ErrMsg) {
+  TimeTraceScope Scope("DecodeSPIRV", "");
   std::unique_ptr<SPIRVModule> BM(SPIRVModule::createSPIRVModule());
 
   IS >> *BM;
@@ -3011,17 +3078,40 @@ std::unique_ptr<SPIRVModule> readSpirvModule(std::istream &IS,
   return BM;
 }
 
+std::unique_ptr<SPIRVModule> readSpirvModule(StringRef Input,
+                                             std::string &ErrMsg) {
+#ifdef _SPIRV_SUPPORT_TEXT_FMT
+  if (SPIRVUseTextFormat) {
+    std::istringstream IS(Input.str());
+    return readSpirvModule(IS, ErrMsg);
+  }
+#endif
+  TimeTraceScope Scope("DecodeSPIRV", "");
+  std::unique_ptr<SPIRVModule> BM(SPIRVModule::createSPIRVModule());
+
+  SPIRVInputStream IS(Input.begin(), Input.end());
+  IS >> *BM;
+  if (!BM->isModuleValid()) {
+    BM->getError(ErrMsg);
+    return nullptr;
+  }
+  return BM;
+}
+
 } // namespace SPIRV
 
-std::unique_ptr<Module>
-llvm::convertSpirvToLLVM(LLVMContext &C, SPIRVModule &BM, std::string &ErrMsg) {
+// Translates the whole SPIR-V module, or the shard of it with the function
+// bodies in Bodies if not null. Returns null on failure.
+static std::unique_ptr<Module>
+translateShard(LLVMContext &C, SPIRVModule &BM,
+               const SPIRVToLLVM::SPIRVFunctionSet *Bodies,
+               bool DefineVariables) {
   std::unique_ptr<Module> M(new Module("", C));
   SPIRVToLLVM BTL(M.get(), &BM);
+  BTL.setShard(Bodies, DefineVariables);
 
-  if (!BTL.translate()) {
-    BM.getError(ErrMsg);
+  if (!BTL.translate())
     return nullptr;
-  }
 
   llvm::legacy::PassManager PassMgr;
   PassMgr.add(createSPIRVToOCL20());
@@ -3031,10 +3121,96 @@ llvm::convertSpirvToLLVM(LLVMContext &C, SPIRVModule &BM, std::string &ErrMsg) {
   return M;
 }
 
-bool llvm::readSpirv(LLVMContext &C, std::istream &IS, Module *&M,
-                     std::string &ErrMsg) {
-  std::unique_ptr<SPIRVModule> BM(readSpirvModule(IS, ErrMsg));
+// Translates the function bodies of the SPIR-V module in NumThreads shards in
+// parallel. The LLVM contexts are not thread safe, so every shard is
+// translated in a context of its own and passed back to C as bitcode, where
+// the shards are linked together. The first shard is translated in C and
+// defines the global variables, the other shards only declare them.
+static std::unique_ptr<Module> translateInParallel(LLVMContext &C,
+                                                   SPIRVModule &BM,
+                                                   unsigned NumThreads) {
+  std::vector<SPIRVToLLVM::SPIRVFunctionSet> Bodies(NumThreads);
+  unsigned NumBodies = 0;
+  for (unsigned I = 0, E = BM.getNumFunctions(); I != E; ++I) {
+    SPIRVFunction *BF = BM.getFunction(I);
+    if (BF->getNumBasicBlock())
+      Bodies[NumBodies++ % NumThreads].insert(BF);
+  }
+  // The debug info is translated for the whole module at once.
+  if (NumBodies < 2 || !BM.getDebugInstVec().empty())
+    return translateShard(C, BM, nullptr, true);
+  const unsigned NumShards = std::min(NumThreads, NumBodies);
+
+  std::vector<SmallString<0>> Bitcode(NumShards);
+  std::vector<char> Failed(NumShards, false);
+  std::unique_ptr<Module> M;
+  {
+    ThreadPool Pool(NumShards - 1);
+    for (unsigned I = 1; I < NumShards; ++I)
+      Pool.async([&, I]() {
+        LLVMContext ShardC;
+        std::unique_ptr<Module> Shard =
+            translateShard(ShardC, BM, &Bodies[I], false);
+        if (!Shard) {
+          Failed[I] = true;
+          return;
+        }
+        // The module wide metadata are the same in all the shards, they are
+        // kept from the first one only.
+        std::vector<NamedMDNode *> ModuleMD;
+        for (NamedMDNode &NMD : Shard->named_metadata())
+          if (NMD.getName() != "llvm.module.flags")
+            ModuleMD.push_back(&NMD);
+        for (NamedMDNode *NMD : ModuleMD)
+          Shard->eraseNamedMetadata(NMD);
+        raw_svector_ostream OS(Bitcode[I]);
+        WriteBitcodeToFile(*Shard, OS);
+      });
+    M = translateShard(C, BM, &Bodies[0], true);
+    Pool.wait();
+  }
+  if (!M || std::find(Failed.begin(), Failed.end(), true) != Failed.end())
+    return nullptr;
 
+  Linker L(*M);
+  for (unsigned I = 1; I < NumShards; ++I) {
+    Expected<std::unique_ptr<Module>> Shard =
+        parseBitcodeFile(MemoryBufferRef(Bitcode[I], ""), C);
+    if (!Shard)
+      report_fatal_error(toString(Shard.takeError()));
+    if (L.linkInModule(std::move(*Shard)))
+      report_fatal_error("Failed to link the SPIR-V translation shards");
+  }
+
+  // Give back their names and internal linkage to the shared global values.
+  auto Restore = [&](const SPIRVValue *V) {
+    if (GlobalValue *GV = M->getNamedValue(getShardName(V))) {
+      GV->setLinkage(GlobalValue::InternalLinkage);
+      GV->setName(V->getName());
+    }
+  };
+  for (unsigned I = 0, E = BM.getNumFunctions(); I != E; ++I)
+    Restore(BM.getFunction(I));
+  for (unsigned I = 0, E = BM.getNumVariables(); I != E; ++I)
+    Restore(BM.getVariable(I));
+  return M;
+}
+
+std::unique_ptr<Module>
+llvm::convertSpirvToLLVM(LLVMContext &C, SPIRVModule &BM, std::string &ErrMsg) {
+  TimeTraceScope Scope("TranslateSPIRV", "");
+  std::unique_ptr<Module> M =
+      SPIRVReaderThreads > 1 ? translateInParallel(C, BM, SPIRVReaderThreads)
+                             : translateShard(C, BM, nullptr, true);
+  if (!M) {
+    BM.getError(ErrMsg);
+    return nullptr;
+  }
+  return M;
+}
+
+static bool translateSpirv(LLVMContext &C, std::unique_ptr<SPIRVModule> BM,
+                           Module *&M, std::string &ErrMsg) {
   if (!BM)
     return false;
 
@@ -3048,3 +3224,13 @@ bool llvm::readSpirv(LLVMContext &C, std::istream &IS, Module *&M,
 
   return true;
 }
+
+bool llvm::readSpirv(LLVMContext &C, std::istream &IS, Module *&M,
+                     std::string &ErrMsg) {
+  return translateSpirv(C, readSpirvModule(IS, ErrMsg), M, ErrMsg);
+}
+
+bool llvm::readSpirv(LLVMContext &C, StringRef Input, Module *&M,
+                     std::string &ErrMsg) {
+  return translateSpirv(C, readSpirvModule(Input, ErrMsg), M, ErrMsg);
+}
@@ -47,6 +47,8 @@
 #include "llvm/IR/GlobalValue.h" // llvm::GlobalValue::LinkageTypes
 #include "llvm/IR/Metadata.h"    // llvm::Metadata
 
+#include <unordered_set>
+
 namespace llvm {
 class Module;
 class Type;
@@ -86,6 +88,18 @@ public:
   bool translate();
   bool transAddressingModel();
 
+  typedef std::unordered_set<const SPIRVFunction *> SPIRVFunctionSet;
+
+  /// Restricts the translation to a shard of the module, for the shards to be
+  /// translated in parallel and linked together. Only the bodies of the
+  /// functions in Bodies are translated, the other functions are declared.
+  /// The global variables shared by the shards are defined only if
+  /// DefineVariables is true, and declared otherwise.
+  void setShard(const SPIRVFunctionSet *Bodies, bool DefineVariables) {
+    ShardBodies = Bodies;
+    ShardDefinesVariables = DefineVariables;
+  }
+
   Value *transValue(SPIRVValue *, Function *F, BasicBlock *,
                     bool CreatePlaceHolder = true);
   Value *transValueWithoutDecoration(SPIRVValue *, Function *F, BasicBlock *,
@@ -199,6 +213,8 @@ private:
   SPIRVBlockToLLVMStructMap BlockMap;
   SPIRVToLLVMPlaceholderMap PlaceholderMap;
   std::unique_ptr<SPIRVToLLVMDbgTran> DbgTran;
+  const SPIRVFunctionSet *ShardBodies = nullptr;
+  bool ShardDefinesVariables = true;
 
   Type *mapType(SPIRVType *BT, Type *T);
 
@@ -55,6 +55,7 @@
 
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/IR/Constants.h"
@@ -66,6 +67,7 @@
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/ModuleSlotTracker.h"
 #include "llvm/IR/Operator.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/Pass.h"
@@ -73,8 +75,11 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Transforms/Utils.h" // loop-simplify pass
+#include "llvm/Transforms/Utils/Cloning.h"
 
 #include <cstdlib>
 #include <functional>
@@ -1384,9 +1389,12 @@ SPIRVValue *LLVMToSPIRV::transCallInst(CallInst *CI, SPIRVBasicBlock *BB) {
     return oclTransSpvcCastSampler(CI, BB);
 
   if (oclIsBuiltin(MangledName, &DemangledName) ||
-      isDecoratedSPIRVFunc(F, &DemangledName))
+      isDecoratedSPIRVFunc(F, &DemangledName)) {
+    if (getSPIRVFuncOC(DemangledName) == OpSpecConstant)
+      return transSpecConstant(CI);
     if (auto BV = transBuiltinToInst(DemangledName, MangledName, CI, BB))
       return BV;
+  }
 
   SmallVector<std::string, 2> Dec;
   if (isBuiltinTransToExtInst(CI->getCalledFunction(), &ExtSetKind, &ExtOp,
@@ -1405,6 +1413,41 @@ SPIRVValue *LLVMToSPIRV::transCallInst(CallInst *CI, SPIRVBasicBlock *BB) {
       BB);
 }
 
+SPIRVValue *LLVMToSPIRV::transSpecConstant(CallInst *CI) {
+  auto *SpecId = dyn_cast<ConstantInt>(CI->getArgOperand(0));
+  Value *Default = CI->getArgOperand(1);
+  if (!BM->getErrorLog().checkError(
+          SpecId && (isa<ConstantInt>(Default) || isa<ConstantFP>(Default)) &&
+              Default->getType() == CI->getType(),
+          SPIRVEC_InvalidModule,
+          "__spirv_SpecConstant expects a constant SpecId and default value"))
+    return nullptr;
+
+  SPIRVWord Id = SpecId->getZExtValue();
+  SPIRVType *Ty = transType(CI->getType());
+  SPIRVValue *&BV = SpecConstants[Id];
+  if (BV) {
+    // All the uses of a SpecId get the same value, so they share the constant.
+    if (!BM->getErrorLog().checkError(
+            BV->getType() == Ty, SPIRVEC_InvalidModule,
+            "SpecId " + std::to_string(Id) + " is used with different types"))
+      return nullptr;
+    return BV;
+  }
+
+  uint64_t Bits = 0;
+  if (auto *C = dyn_cast<ConstantInt>(Default))
+    Bits = C->getZExtValue();
+  else
+    Bits = cast<ConstantFP>(Default)
+               ->getValueAPF()
+               .bitcastToAPInt()
+               .getZExtValue();
+  BV = BM->addSpecConstant(Ty, Bits);
+  BV->addDecorate(DecorationSpecId, Id);
+  return BV;
+}
+
 bool LLVMToSPIRV::transAddressingMode() {
   Triple TargetTriple(M->getTargetTriple());
 
@@ -1933,10 +1976,93 @@ bool llvm::writeSpirv(Module *M, std::ostream &OS, std::string &ErrMsg) {
 
   if (BM->getError(ErrMsg) != SPIRVEC_Success)
     return false;
+  TimeTraceScope Scope("EncodeSPIRV", "");
   OS << *BM;
   return true;
 }
 
+// Adds to Deps the global values V depends on, looking through constants.
+static void collectDeps(const Value *V, SetVector<const GlobalValue *> &Deps,
+                        SmallPtrSetImpl<const Constant *> &Visited) {
+  const auto *C = dyn_cast<Constant>(V);
+  if (!C || !Visited.insert(C).second)
+    return;
+  if (const auto *GV = dyn_cast<GlobalValue>(C)) {
+    Deps.insert(GV);
+    return;
+  }
+  for (const Value *Op : C->operands())
+    collectDeps(Op, Deps, Visited);
+}
+
+// Returns Roots and all the global values they depend on directly or
+// indirectly, in a deterministic order.
+static SetVector<const GlobalValue *>
+getDependencies(ArrayRef<const GlobalValue *> Roots) {
+  SetVector<const GlobalValue *> Res(Roots.begin(), Roots.end());
+  SmallPtrSet<const Constant *, 32> Visited;
+  // Res grows while it is being walked, so index it rather than iterate it.
+  for (size_t I = 0; I < Res.size(); ++I) {
+    const GlobalValue *GV = Res[I];
+    if (const auto *F = dyn_cast<Function>(GV)) {
+      for (const BasicBlock &BB : *F)
+        for (const Instruction &Inst : BB)
+          for (const Value *Op : Inst.operands())
+            collectDeps(Op, Res, Visited);
+    } else if (const auto *Var = dyn_cast<GlobalVariable>(GV)) {
+      if (Var->hasInitializer())
+        collectDeps(Var->getInitializer(), Res, Visited);
+    } else if (const auto *A = dyn_cast<GlobalIndirectSymbol>(GV)) {
+      collectDeps(A->getIndirectSymbol(), Res, Visited);
+    }
+  }
+  return Res;
+}
+
+bool llvm::writeSpirv(Module *M, ArrayRef<std::string> EntryPoints,
+                      std::ostream &OS, std::string &ErrMsg) {
+  SmallVector<const GlobalValue *, 8> Roots;
+  for (const std::string &Name : EntryPoints) {
+    const Function *F = M->getFunction(Name);
+    if (!F || F->isDeclaration()) {
+      ErrMsg = "Entry point " + Name + " is not defined in the module";
+      return false;
+    }
+    Roots.push_back(F);
+  }
+  SetVector<const GlobalValue *> Deps = getDependencies(Roots);
+
+  // The translation runs on a copy holding the definitions of the
+  // dependencies only, the other global values are dropped.
+  ValueToValueMapTy VMap;
+  std::unique_ptr<Module> Subset = CloneModule(
+      *M, VMap, [&](const GlobalValue *GV) { return Deps.count(GV) != 0; });
+  SmallVector<GlobalValue *, 16> Unused;
+  for (GlobalValue &GV : Subset->global_values())
+    if (GV.isDeclaration() && GV.use_empty())
+      Unused.push_back(&GV);
+  for (GlobalValue *GV : Unused)
+    GV->eraseFromParent();
+
+  return writeSpirv(Subset.get(), OS, ErrMsg);
+}
+
+uint64_t llvm::getSpirvContentHash(const Function &F) {
+  const GlobalValue *Root = &F;
+  ModuleSlotTracker MST(F.getParent());
+  MD5 Hash;
+  std::string Str;
+  for (const GlobalValue *GV : getDependencies(Root)) {
+    Str.clear();
+    raw_string_ostream OS(Str);
+    GV->print(OS, MST);
+    Hash.update(OS.str());
+  }
+  MD5::MD5Result Result;
+  Hash.final(Result);
+  return Result.low();
+}
+
 bool llvm::regularizeLlvmForSpirv(Module *M, std::string &ErrMsg) {
   std::unique_ptr<SPIRVModule> BM(SPIRVModule::createSPIRVModule());
   legacy::PassManager PassMgr;
@@ -130,6 +130,8 @@ private:
   SPIRVWord SrcLangVer;
   std::unique_ptr<LLVMToSPIRVDbgTran> DbgTran;
   std::unique_ptr<CallGraph> CG;
+  /// The specialization constants per SpecId.
+  std::map<SPIRVWord, SPIRVValue *> SpecConstants;
 
   SPIRVType *mapType(Type *T, SPIRVType *BT);
   SPIRVValue *mapValue(Value *V, SPIRVValue *BV);
@@ -171,6 +173,9 @@ private:
                          Function *F);
 
   SPIRVValue *transSpcvCast(CallInst *CI, SPIRVBasicBlock *BB);
+  /// Translate a call of __spirv_SpecConstant(SpecId, Default) to the
+  /// specialization constant with this SpecId and default value.
+  SPIRVValue *transSpecConstant(CallInst *CI);
   SPIRVValue *oclTransSpvcCastSampler(CallInst *CI, SPIRVBasicBlock *BB);
   SPIRV::SPIRVInstruction *transUnaryInst(UnaryInstruction *U,
                                           SPIRVBasicBlock *BB);
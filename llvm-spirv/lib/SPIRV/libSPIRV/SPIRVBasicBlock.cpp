@@ -54,7 +54,7 @@ SPIRVBasicBlock::SPIRVBasicBlock(SPIRVId TheId, SPIRVFunction *Func)
   validate();
 }
 
-SPIRVDecoder SPIRVBasicBlock::getDecoder(std::istream &IS) {
+SPIRVDecoder SPIRVBasicBlock::getDecoder(SPIRVInputStream &IS) {
   return SPIRVDecoder(IS, *this);
 }
 
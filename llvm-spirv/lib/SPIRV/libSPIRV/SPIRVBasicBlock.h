@@ -54,7 +54,7 @@ public:
 
   SPIRVBasicBlock() : SPIRVValue(OpLabel), ParentF(NULL) { setAttr(); }
 
-  SPIRVDecoder getDecoder(std::istream &IS) override;
+  SPIRVDecoder getDecoder(SPIRVInputStream &IS) override;
   SPIRVFunction *getParent() const { return ParentF; }
   size_t getNumInst() const { return InstVec.size(); }
   SPIRVInstruction *getInst(size_t I) const { return InstVec[I]; }
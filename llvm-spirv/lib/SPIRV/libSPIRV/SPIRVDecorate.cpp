@@ -107,7 +107,7 @@ void SPIRVDecorate::setWordCount(SPIRVWord Count) {
   Literals.resize(WordCount - FixedWC);
 }
 
-void SPIRVDecorate::decode(std::istream &I) {
+void SPIRVDecorate::decode(SPIRVInputStream &I) {
   SPIRVDecoder Decoder = getDecoder(I);
   Decoder >> Target >> Dec;
   switch (Dec) {
@@ -146,7 +146,7 @@ void SPIRVMemberDecorate::setWordCount(SPIRVWord Count) {
   Literals.resize(WordCount - FixedWC);
 }
 
-void SPIRVMemberDecorate::decode(std::istream &I) {
+void SPIRVMemberDecorate::decode(SPIRVInputStream &I) {
   SPIRVDecoder Decoder = getDecoder(I);
   Decoder >> Target >> MemberNumber >> Dec;
   switch (Dec) {
@@ -164,7 +164,7 @@ void SPIRVMemberDecorate::decode(std::istream &I) {
 
 void SPIRVDecorationGroup::encode(spv_ostream &O) const { getEncoder(O) << Id; }
 
-void SPIRVDecorationGroup::decode(std::istream &I) {
+void SPIRVDecorationGroup::decode(SPIRVInputStream &I) {
   getDecoder(I) >> Id;
   Module->addDecorationGroup(this);
 }
@@ -178,7 +178,7 @@ void SPIRVGroupDecorateGeneric::encode(spv_ostream &O) const {
   getEncoder(O) << DecorationGroup << Targets;
 }
 
-void SPIRVGroupDecorateGeneric::decode(std::istream &I) {
+void SPIRVGroupDecorateGeneric::decode(SPIRVInputStream &I) {
   getDecoder(I) >> DecorationGroup >> Targets;
   Module->addGroupDecorateGeneric(this);
 }
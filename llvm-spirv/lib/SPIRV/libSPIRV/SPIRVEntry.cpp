@@ -121,7 +121,7 @@ SPIRVEncoder SPIRVEntry::getEncoder(spv_ostream &O) const {
   return SPIRVEncoder(O);
 }
 
-SPIRVDecoder SPIRVEntry::getDecoder(std::istream &I) {
+SPIRVDecoder SPIRVEntry::getDecoder(SPIRVInputStream &I) {
   return SPIRVDecoder(I, *Module);
 }
 
@@ -200,7 +200,7 @@ void SPIRVEntry::encodeWordCountOpCode(spv_ostream &O) const {
 // The word count and op code has already been read before calling this
 // function for creating the SPIRVEntry. Therefore the input stream only
 // contains the remaining part of the words for the SPIRVEntry.
-void SPIRVEntry::decode(std::istream &I) { assert(0 && "Not implemented"); }
+void SPIRVEntry::decode(SPIRVInputStream &I) { assert(0 && "Not implemented"); }
 
 std::vector<SPIRVValue *>
 SPIRVEntry::getValues(const std::vector<SPIRVId> &IdVec) const {
@@ -431,7 +431,7 @@ spv_ostream &operator<<(spv_ostream &O, const SPIRVEntry &E) {
   return O;
 }
 
-std::istream &operator>>(std::istream &I, SPIRVEntry &E) {
+SPIRVInputStream &operator>>(SPIRVInputStream &I, SPIRVEntry &E) {
   E.decode(I);
   return I;
 }
@@ -448,7 +448,7 @@ void SPIRVEntryPoint::encode(spv_ostream &O) const {
   getEncoder(O) << ExecModel << Target << Name << Variables;
 }
 
-void SPIRVEntryPoint::decode(std::istream &I) {
+void SPIRVEntryPoint::decode(SPIRVInputStream &I) {
   getDecoder(I) >> ExecModel >> Target >> Name >> Variables;
   Module->setName(getOrCreateTarget(), Name);
   Module->addEntryPoint(ExecModel, Target);
@@ -458,7 +458,7 @@ void SPIRVExecutionMode::encode(spv_ostream &O) const {
   getEncoder(O) << Target << ExecMode << WordLiterals;
 }
 
-void SPIRVExecutionMode::decode(std::istream &I) {
+void SPIRVExecutionMode::decode(SPIRVInputStream &I) {
   getDecoder(I) >> Target >> ExecMode;
   switch (ExecMode) {
   case ExecutionModeLocalSize:
@@ -494,7 +494,7 @@ SPIRVName::SPIRVName(const SPIRVEntry *TheTarget, const std::string &TheStr)
 
 void SPIRVName::encode(spv_ostream &O) const { getEncoder(O) << Target << Str; }
 
-void SPIRVName::decode(std::istream &I) {
+void SPIRVName::decode(SPIRVInputStream &I) {
   getDecoder(I) >> Target >> Str;
   Module->setName(getOrCreateTarget(), Str);
 }
@@ -510,7 +510,7 @@ void SPIRVLine::encode(spv_ostream &O) const {
   getEncoder(O) << FileName << Line << Column;
 }
 
-void SPIRVLine::decode(std::istream &I) {
+void SPIRVLine::decode(SPIRVInputStream &I) {
   getDecoder(I) >> FileName >> Line >> Column;
   std::shared_ptr<const SPIRVLine> L(this);
   Module->setCurrentLine(L);
@@ -543,7 +543,7 @@ void SPIRVExtInstImport::encode(spv_ostream &O) const {
   getEncoder(O) << Id << Str;
 }
 
-void SPIRVExtInstImport::decode(std::istream &I) {
+void SPIRVExtInstImport::decode(SPIRVInputStream &I) {
   getDecoder(I) >> Id >> Str;
   Module->importBuiltinSetWithId(Str, Id);
 }
@@ -557,7 +557,7 @@ void SPIRVMemoryModel::encode(spv_ostream &O) const {
   getEncoder(O) << Module->getAddressingModel() << Module->getMemoryModel();
 }
 
-void SPIRVMemoryModel::decode(std::istream &I) {
+void SPIRVMemoryModel::decode(SPIRVInputStream &I) {
   SPIRVAddressingModelKind AddrModel;
   SPIRVMemoryModelKind MemModel;
   getDecoder(I) >> AddrModel >> MemModel;
@@ -579,7 +579,7 @@ void SPIRVSource::encode(spv_ostream &O) const {
   getEncoder(O) << Language << Ver;
 }
 
-void SPIRVSource::decode(std::istream &I) {
+void SPIRVSource::decode(SPIRVInputStream &I) {
   SourceLanguage Lang = SourceLanguageUnknown;
   SPIRVWord Ver = SPIRVWORD_MAX;
   getDecoder(I) >> Lang >> Ver;
@@ -592,7 +592,7 @@ SPIRVSourceExtension::SPIRVSourceExtension(SPIRVModule *M,
 
 void SPIRVSourceExtension::encode(spv_ostream &O) const { getEncoder(O) << S; }
 
-void SPIRVSourceExtension::decode(std::istream &I) {
+void SPIRVSourceExtension::decode(SPIRVInputStream &I) {
   getDecoder(I) >> S;
   Module->getSourceExtension().insert(S);
 }
@@ -602,7 +602,7 @@ SPIRVExtension::SPIRVExtension(SPIRVModule *M, const std::string &SS)
 
 void SPIRVExtension::encode(spv_ostream &O) const { getEncoder(O) << S; }
 
-void SPIRVExtension::decode(std::istream &I) {
+void SPIRVExtension::decode(SPIRVInputStream &I) {
   getDecoder(I) >> S;
   Module->getExtension().insert(S);
 }
@@ -614,7 +614,7 @@ SPIRVCapability::SPIRVCapability(SPIRVModule *M, SPIRVCapabilityKind K)
 
 void SPIRVCapability::encode(spv_ostream &O) const { getEncoder(O) << Kind; }
 
-void SPIRVCapability::decode(std::istream &I) {
+void SPIRVCapability::decode(SPIRVInputStream &I) {
   getDecoder(I) >> Kind;
   Module->addCapability(Kind);
 }
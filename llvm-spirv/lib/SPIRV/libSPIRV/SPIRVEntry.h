@@ -56,6 +56,7 @@ namespace SPIRV {
 class SPIRVModule;
 class SPIRVEncoder;
 class SPIRVDecoder;
+class SPIRVInputStream;
 class SPIRVType;
 class SPIRVValue;
 class SPIRVDecorate;
@@ -69,7 +70,7 @@ class SPIRVExtInst;
 // Used inside class definition.
 #define _SPIRV_DCL_ENCDEC                                                      \
   void encode(spv_ostream &O) const override;                                  \
-  void decode(std::istream &I) override;
+  void decode(SPIRVInputStream &I) override;
 
 #define _REQ_SPIRV_VER(Version)                                                \
   SPIRVWord getRequiredSPIRVVersion() const override { return Version; }
@@ -78,51 +79,51 @@ class SPIRVExtInst;
 // Used out side of class definition.
 #define _SPIRV_IMP_ENCDEC0(Ty)                                                 \
   void Ty::encode(spv_ostream &O) const {}                                     \
-  void Ty::decode(std::istream &I) {}
+  void Ty::decode(SPIRVInputStream &I) {}
 #define _SPIRV_IMP_ENCDEC1(Ty, x)                                              \
   void Ty::encode(spv_ostream &O) const { getEncoder(O) << (x); }              \
-  void Ty::decode(std::istream &I) { getDecoder(I) >> (x); }
+  void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> (x); }
 #define _SPIRV_IMP_ENCDEC2(Ty, x, y)                                           \
   void Ty::encode(spv_ostream &O) const { getEncoder(O) << (x) << (y); }       \
-  void Ty::decode(std::istream &I) { getDecoder(I) >> (x) >> (y); }
+  void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> (x) >> (y); }
 #define _SPIRV_IMP_ENCDEC3(Ty, x, y, z)                                        \
   void Ty::encode(spv_ostream &O) const {                                      \
     getEncoder(O) << (x) << (y) << (z);                                        \
   }                                                                            \
-  void Ty::decode(std::istream &I) { getDecoder(I) >> (x) >> (y) >> (z); }
+  void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> (x) >> (y) >> (z); }
 #define _SPIRV_IMP_ENCDEC4(Ty, x, y, z, u)                                     \
   void Ty::encode(spv_ostream &O) const {                                      \
     getEncoder(O) << (x) << (y) << (z) << (u);                                 \
   }                                                                            \
-  void Ty::decode(std::istream &I) {                                           \
+  void Ty::decode(SPIRVInputStream &I) {                                           \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u);                                 \
   }
 #define _SPIRV_IMP_ENCDEC5(Ty, x, y, z, u, v)                                  \
   void Ty::encode(spv_ostream &O) const {                                      \
     getEncoder(O) << (x) << (y) << (z) << (u) << (v);                          \
   }                                                                            \
-  void Ty::decode(std::istream &I) {                                           \
+  void Ty::decode(SPIRVInputStream &I) {                                           \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u) >> (v);                          \
   }
 #define _SPIRV_IMP_ENCDEC6(Ty, x, y, z, u, v, w)                               \
   void Ty::encode(spv_ostream &O) const {                                      \
     getEncoder(O) << (x) << (y) << (z) << (u) << (v) << (w);                   \
   }                                                                            \
-  void Ty::decode(std::istream &I) {                                           \
+  void Ty::decode(SPIRVInputStream &I) {                                           \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u) >> (v) >> (w);                   \
   }
 #define _SPIRV_IMP_ENCDEC7(Ty, x, y, z, u, v, w, r)                            \
   void Ty::encode(spv_ostream &O) const {                                      \
     getEncoder(O) << (x) << (y) << (z) << (u) << (v) << (w) << (r);            \
   }                                                                            \
-  void Ty::decode(std::istream &I) {                                           \
+  void Ty::decode(SPIRVInputStream &I) {                                           \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u) >> (v) >> (w) >> (r);            \
   }
 #define _SPIRV_IMP_ENCDEC8(Ty, x, y, z, u, v, w, r, s)                         \
   void Ty::encode(spv_ostream &O) const {                                      \
     getEncoder(O) << (x) << (y) << (z) << (u) << (v) << (w) << (r) << (s);     \
   }                                                                            \
-  void Ty::decode(std::istream &I) {                                           \
+  void Ty::decode(SPIRVInputStream &I) {                                           \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u) >> (v) >> (w) >> (r) >> (s);     \
   }
 #define _SPIRV_IMP_ENCDEC9(Ty, x, y, z, u, v, w, r, s, t)                      \
@@ -130,7 +131,7 @@ class SPIRVExtInst;
     getEncoder(O) << (x) << (y) << (z) << (u) << (v) << (w) << (r) << (s)      \
                   << (t);                                                      \
   }                                                                            \
-  void Ty::decode(std::istream &I) {                                           \
+  void Ty::decode(SPIRVInputStream &I) {                                           \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u) >> (v) >> (w) >> (r) >> (s) >>   \
         (t);                                                                   \
   }
@@ -139,51 +140,51 @@ class SPIRVExtInst;
 // Used inside class definition.
 #define _SPIRV_DEF_ENCDEC0                                                     \
   void encode(spv_ostream &O) const override {}                                \
-  void decode(std::istream &I) override {}
+  void decode(SPIRVInputStream &I) override {}
 #define _SPIRV_DEF_ENCDEC1(x)                                                  \
   void encode(spv_ostream &O) const override { getEncoder(O) << (x); }         \
-  void decode(std::istream &I) override { getDecoder(I) >> (x); }
+  void decode(SPIRVInputStream &I) override { getDecoder(I) >> (x); }
 #define _SPIRV_DEF_ENCDEC2(x, y)                                               \
   void encode(spv_ostream &O) const override { getEncoder(O) << (x) << (y); }  \
-  void decode(std::istream &I) override { getDecoder(I) >> (x) >> (y); }
+  void decode(SPIRVInputStream &I) override { getDecoder(I) >> (x) >> (y); }
 #define _SPIRV_DEF_ENCDEC3(x, y, z)                                            \
   void encode(spv_ostream &O) const override {                                 \
     getEncoder(O) << (x) << (y) << (z);                                        \
   }                                                                            \
-  void decode(std::istream &I) override { getDecoder(I) >> (x) >> (y) >> (z); }
+  void decode(SPIRVInputStream &I) override { getDecoder(I) >> (x) >> (y) >> (z); }
 #define _SPIRV_DEF_ENCDEC4(x, y, z, u)                                         \
   void encode(spv_ostream &O) const override {                                 \
     getEncoder(O) << (x) << (y) << (z) << (u);                                 \
   }                                                                            \
-  void decode(std::istream &I) override {                                      \
+  void decode(SPIRVInputStream &I) override {                                      \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u);                                 \
   }
 #define _SPIRV_DEF_ENCDEC5(x, y, z, u, v)                                      \
   void encode(spv_ostream &O) const override {                                 \
     getEncoder(O) << (x) << (y) << (z) << (u) << (v);                          \
   }                                                                            \
-  void decode(std::istream &I) override {                                      \
+  void decode(SPIRVInputStream &I) override {                                      \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u) >> (v);                          \
   }
 #define _SPIRV_DEF_ENCDEC6(x, y, z, u, v, w)                                   \
   void encode(spv_ostream &O) const override {                                 \
     getEncoder(O) << (x) << (y) << (z) << (u) << (v) << (w);                   \
   }                                                                            \
-  void decode(std::istream &I) override {                                      \
+  void decode(SPIRVInputStream &I) override {                                      \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u) >> (v) >> (w);                   \
   }
 #define _SPIRV_DEF_ENCDEC7(x, y, z, u, v, w, r)                                \
   void encode(spv_ostream &O) const override {                                 \
     getEncoder(O) << (x) << (y) << (z) << (u) << (v) << (w) << (r);            \
   }                                                                            \
-  void decode(std::istream &I) override {                                      \
+  void decode(SPIRVInputStream &I) override {                                      \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u) >> (v) >> (w) >> (r);            \
   }
 #define _SPIRV_DEF_ENCDEC8(x, y, z, u, v, w, r, s)                             \
   void encode(spv_ostream &O) const override {                                 \
     getEncoder(O) << (x) << (y) << (z) << (u) << (v) << (w) << (r) << (s);     \
   }                                                                            \
-  void decode(std::istream &I) override {                                      \
+  void decode(SPIRVInputStream &I) override {                                      \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u) >> (v) >> (w) >> (r) >> (s);     \
   }
 #define _SPIRV_DEF_ENCDEC9(x, y, z, u, v, w, r, s, t)                          \
@@ -191,7 +192,7 @@ class SPIRVExtInst;
     getEncoder(O) << (x) << (y) << (z) << (u) << (v) << (w) << (r) << (s)      \
                   << (t);                                                      \
   }                                                                            \
-  void decode(std::istream &I) override {                                      \
+  void decode(SPIRVInputStream &I) override {                                      \
     getDecoder(I) >> (x) >> (y) >> (z) >> (u) >> (v) >> (w) >> (r) >> (s) >>   \
         (t);                                                                   \
   }
@@ -276,7 +277,7 @@ public:
   SPIRVType *getValueType(SPIRVId TheId) const;
   std::vector<SPIRVType *> getValueTypes(const std::vector<SPIRVId> &) const;
 
-  virtual SPIRVDecoder getDecoder(std::istream &);
+  virtual SPIRVDecoder getDecoder(SPIRVInputStream &);
   virtual SPIRVEncoder getEncoder(spv_ostream &) const;
   SPIRVErrorLog &getErrorLog() const;
   SPIRVId getId() const {
@@ -358,7 +359,7 @@ public:
                                                     unsigned ExtOp);
 
   friend spv_ostream &operator<<(spv_ostream &O, const SPIRVEntry &E);
-  friend std::istream &operator>>(std::istream &I, SPIRVEntry &E);
+  friend SPIRVInputStream &operator>>(SPIRVInputStream &I, SPIRVEntry &E);
   virtual void encodeLine(spv_ostream &O) const;
   virtual void encodeAll(spv_ostream &O) const;
   virtual void encodeName(spv_ostream &O) const;
@@ -366,7 +367,7 @@ public:
   virtual void encodeDecorate(spv_ostream &O) const;
   virtual void encodeWordCountOpCode(spv_ostream &O) const;
   virtual void encode(spv_ostream &O) const;
-  virtual void decode(std::istream &I);
+  virtual void decode(SPIRVInputStream &I);
 
   friend class SPIRVDecoder;
 
@@ -747,9 +748,6 @@ _SPIRV_OP(Nop)
 _SPIRV_OP(SourceContinued)
 _SPIRV_OP(TypeMatrix)
 _SPIRV_OP(TypeRuntimeArray)
-_SPIRV_OP(SpecConstantTrue)
-_SPIRV_OP(SpecConstantFalse)
-_SPIRV_OP(SpecConstant)
 _SPIRV_OP(SpecConstantComposite)
 _SPIRV_OP(Image)
 _SPIRV_OP(ImageTexelPointer)
@@ -66,7 +66,7 @@ void SPIRVFunctionParameter::foreachAttr(
   }
 }
 
-SPIRVDecoder SPIRVFunction::getDecoder(std::istream &IS) {
+SPIRVDecoder SPIRVFunction::getDecoder(SPIRVInputStream &IS) {
   return SPIRVDecoder(IS, *this);
 }
 
@@ -89,7 +89,7 @@ void SPIRVFunction::encodeExecutionModes(spv_ostream &O) const {
     O << *I.second;
 }
 
-void SPIRVFunction::decode(std::istream &I) {
+void SPIRVFunction::decode(SPIRVInputStream &I) {
   SPIRVDecoder Decoder = getDecoder(I);
   Decoder >> Type >> Id >> FCtrlMask >> FuncType;
   Module->addFunction(this);
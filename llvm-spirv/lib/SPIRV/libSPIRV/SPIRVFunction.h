@@ -96,7 +96,7 @@ public:
       : SPIRVValue(OpFunction), FuncType(NULL),
         FCtrlMask(FunctionControlMaskNone) {}
 
-  SPIRVDecoder getDecoder(std::istream &IS) override;
+  SPIRVDecoder getDecoder(SPIRVInputStream &IS) override;
   SPIRVTypeFunction *getFunctionType() const { return FuncType; }
   SPIRVWord getFuncCtlMask() const { return FCtrlMask; }
   size_t getNumBasicBlock() const { return BBVec.size(); }
@@ -362,7 +362,7 @@ protected:
       E << Id;
     E << Ops;
   }
-  void decode(std::istream &I) override {
+  void decode(SPIRVInputStream &I) override {
     auto D = getDecoder(I);
     if (hasType())
       D >> Type;
@@ -529,7 +529,7 @@ protected:
     getEncoder(O) << PtrId << ValId << MemoryAccess;
   }
 
-  void decode(std::istream &I) override {
+  void decode(SPIRVInputStream &I) override {
     getDecoder(I) >> PtrId >> ValId >> MemoryAccess;
     memoryAccessUpdate(MemoryAccess);
   }
@@ -581,7 +581,7 @@ protected:
     getEncoder(O) << Type << Id << PtrId << MemoryAccess;
   }
 
-  void decode(std::istream &I) override {
+  void decode(SPIRVInputStream &I) override {
     getDecoder(I) >> Type >> Id >> PtrId >> MemoryAccess;
     memoryAccessUpdate(MemoryAccess);
   }
@@ -1436,7 +1436,7 @@ public:
     }
     getEncoder(O) << Args;
   }
-  void decode(std::istream &I) override {
+  void decode(SPIRVInputStream &I) override {
     getDecoder(I) >> Type >> Id >> ExtSetId;
     setExtSetKindById();
     switch (ExtSetKind) {
@@ -1671,7 +1671,7 @@ protected:
     getEncoder(O) << Target << Source << MemoryAccess;
   }
 
-  void decode(std::istream &I) override {
+  void decode(SPIRVInputStream &I) override {
     getDecoder(I) >> Target >> Source >> MemoryAccess;
     memoryAccessUpdate(MemoryAccess);
   }
@@ -1727,7 +1727,7 @@ protected:
     getEncoder(O) << Target << Source << Size << MemoryAccess;
   }
 
-  void decode(std::istream &I) override {
+  void decode(SPIRVInputStream &I) override {
     getDecoder(I) >> Target >> Source >> Size >> MemoryAccess;
     memoryAccessUpdate(MemoryAccess);
   }
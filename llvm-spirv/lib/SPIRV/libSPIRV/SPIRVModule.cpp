@@ -47,6 +47,7 @@
 #include "SPIRVType.h"
 #include "SPIRVValue.h"
 
+#include <iterator>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -245,6 +246,7 @@ public:
   SPIRVValue *addFloatConstant(SPIRVTypeFloat *, float) override;
   SPIRVValue *addIntegerConstant(SPIRVTypeInt *, uint64_t) override;
   SPIRVValue *addNullConstant(SPIRVType *) override;
+  SPIRVValue *addSpecConstant(SPIRVType *, uint64_t) override;
   SPIRVValue *addUndef(SPIRVType *TheType) override;
   SPIRVValue *addSamplerConstant(SPIRVType *TheType, SPIRVWord AddrMode,
                                  SPIRVWord ParametricMode,
@@ -369,6 +371,7 @@ public:
   // I/O functions
   friend spv_ostream &operator<<(spv_ostream &O, SPIRVModule &M);
   friend std::istream &operator>>(std::istream &I, SPIRVModule &M);
+  friend SPIRVInputStream &operator>>(SPIRVInputStream &I, SPIRVModule &M);
 
 private:
   SPIRVErrorLog ErrLog;
@@ -384,7 +387,8 @@ private:
   SPIRVAddressingModelKind AddrModel;
   SPIRVMemoryModelKind MemoryModel;
 
-  typedef std::map<SPIRVId, SPIRVEntry *> SPIRVIdToEntryMap;
+  // The ids of a module are dense, from 1 up to its bound.
+  typedef std::vector<SPIRVEntry *> SPIRVIdToEntryMap;
   typedef std::set<SPIRVEntry *> SPIRVEntrySet;
   typedef std::set<SPIRVId> SPIRVIdSet;
   typedef std::vector<SPIRVId> SPIRVIdVec;
@@ -408,7 +412,7 @@ private:
 
   SPIRVForwardPointerVec ForwardPointerVec;
   SPIRVTypeVec TypeVec;
-  SPIRVIdToEntryMap IdEntryMap;
+  SPIRVIdToEntryMap IdEntryMap; // Indexed by id, null for the unused ids
   SPIRVFunctionVector FuncVec;
   SPIRVConstantVector ConstVec;
   SPIRVVariableVec VariableVec;
@@ -432,6 +436,7 @@ private:
   std::vector<SPIRVExtInst *> DebugInstVec;
 
   void layoutEntry(SPIRVEntry *Entry);
+  void mapId(SPIRVId Id, SPIRVEntry *Entry);
 };
 
 SPIRVModuleImpl::~SPIRVModuleImpl() {
@@ -439,7 +444,7 @@ SPIRVModuleImpl::~SPIRVModuleImpl() {
     delete I;
 
   for (auto I : IdEntryMap)
-    delete I.second;
+    delete I;
 
   for (auto C : CapMap)
     delete C.second;
@@ -610,7 +615,7 @@ SPIRVEntry *SPIRVModuleImpl::addEntry(SPIRVEntry *Entry) {
         assert(Mapped == Entry && "Id used twice");
       }
     } else
-      IdEntryMap[Id] = Entry;
+      mapId(Id, Entry);
   } else {
     // Entry of OpLine will be deleted by std::shared_ptr automatically.
     if (Entry->getOpCode() != OpLine)
@@ -646,14 +651,19 @@ bool SPIRVModuleImpl::exist(SPIRVId Id) const { return exist(Id, nullptr); }
 
 bool SPIRVModuleImpl::exist(SPIRVId Id, SPIRVEntry **Entry) const {
   assert(Id != SPIRVID_INVALID && "Invalid Id");
-  SPIRVIdToEntryMap::const_iterator Loc = IdEntryMap.find(Id);
-  if (Loc == IdEntryMap.end())
+  if (Id >= IdEntryMap.size() || !IdEntryMap[Id])
     return false;
   if (Entry)
-    *Entry = Loc->second;
+    *Entry = IdEntryMap[Id];
   return true;
 }
 
+void SPIRVModuleImpl::mapId(SPIRVId Id, SPIRVEntry *Entry) {
+  if (Id >= IdEntryMap.size())
+    IdEntryMap.resize(Id + 1, nullptr);
+  IdEntryMap[Id] = Entry;
+}
+
 // If Id is invalid, returns the next available id.
 // Otherwise returns the given id and adjust the next available id by increment.
 SPIRVId SPIRVModuleImpl::getId(SPIRVId Id, unsigned Increment) {
@@ -667,9 +677,8 @@ SPIRVId SPIRVModuleImpl::getId(SPIRVId Id, unsigned Increment) {
 
 SPIRVEntry *SPIRVModuleImpl::getEntry(SPIRVId Id) const {
   assert(Id != SPIRVID_INVALID && "Invalid Id");
-  SPIRVIdToEntryMap::const_iterator Loc = IdEntryMap.find(Id);
-  assert(Loc != IdEntryMap.end() && "Id is not in map");
-  return Loc->second;
+  assert(Id < IdEntryMap.size() && IdEntryMap[Id] && "Id is not in map");
+  return IdEntryMap[Id];
 }
 
 SPIRVExtInstSetKind SPIRVModuleImpl::getBuiltinSet(SPIRVId SetId) const {
@@ -932,13 +941,12 @@ SPIRVEntry *SPIRVModuleImpl::replaceForward(SPIRVForward *Forward,
   SPIRVId Id = Entry->getId();
   SPIRVId ForwardId = Forward->getId();
   if (ForwardId == Id)
-    IdEntryMap[Id] = Entry;
+    mapId(Id, Entry);
   else {
-    auto Loc = IdEntryMap.find(Id);
-    assert(Loc != IdEntryMap.end());
-    IdEntryMap.erase(Loc);
+    assert(exist(Id));
+    IdEntryMap[Id] = nullptr;
     Entry->setId(ForwardId);
-    IdEntryMap[ForwardId] = Entry;
+    mapId(ForwardId, Entry);
   }
   // Annotations include name, decorations, execution modes
   Entry->takeAnnotations(Forward);
@@ -950,9 +958,8 @@ void SPIRVModuleImpl::eraseInstruction(SPIRVInstruction *I,
                                        SPIRVBasicBlock *BB) {
   SPIRVId Id = I->getId();
   BB->eraseInstruction(I);
-  auto Loc = IdEntryMap.find(Id);
-  assert(Loc != IdEntryMap.end());
-  IdEntryMap.erase(Loc);
+  assert(exist(Id));
+  IdEntryMap[Id] = nullptr;
   delete I;
 }
 
@@ -970,6 +977,18 @@ SPIRVValue *SPIRVModuleImpl::addConstant(SPIRVType *Ty, uint64_t V) {
   return addConstant(new SPIRVConstant(this, Ty, getId(), V));
 }
 
+// Unlike the other constants, specialization constants are never shared, each
+// has its own SpecId.
+SPIRVValue *SPIRVModuleImpl::addSpecConstant(SPIRVType *Ty, uint64_t V) {
+  if (Ty->isTypeBool()) {
+    if (V)
+      return addConstant(new SPIRVSpecConstantTrue(this, Ty, getId()));
+    else
+      return addConstant(new SPIRVSpecConstantFalse(this, Ty, getId()));
+  }
+  return addConstant(new SPIRVSpecConstant(this, Ty, getId(), V));
+}
+
 SPIRVValue *SPIRVModuleImpl::addIntegerConstant(SPIRVTypeInt *Ty, uint64_t V) {
   if (Ty->getBitWidth() == 32) {
     unsigned I32 = static_cast<unsigned>(V);
@@ -1536,7 +1555,7 @@ void SPIRVModuleImpl::addUnknownStructField(SPIRVTypeStruct *Struct, unsigned I,
   UnknownStructFieldMap[Struct].push_back(std::make_pair(I, ID));
 }
 
-std::istream &operator>>(std::istream &I, SPIRVModule &M) {
+SPIRVInputStream &operator>>(SPIRVInputStream &I, SPIRVModule &M) {
   SPIRVDecoder Decoder(I, M);
   SPIRVModuleImpl &MI = *static_cast<SPIRVModuleImpl *>(&M);
   // Disable automatic capability filling.
@@ -1587,6 +1606,22 @@ std::istream &operator>>(std::istream &I, SPIRVModule &M) {
   return I;
 }
 
+std::istream &operator>>(std::istream &I, SPIRVModule &M) {
+#ifdef _SPIRV_SUPPORT_TEXT_FMT
+  if (SPIRVUseTextFormat) {
+    SPIRVInputStream IS(I);
+    IS >> M;
+    return I;
+  }
+#endif
+  // The binary format is decoded from memory, so read the whole stream first.
+  std::vector<char> Buf((std::istreambuf_iterator<char>(I)),
+                        std::istreambuf_iterator<char>());
+  SPIRVInputStream IS(Buf.data(), Buf.data() + Buf.size());
+  IS >> M;
+  return I;
+}
+
 SPIRVModule *SPIRVModule::createSPIRVModule() { return new SPIRVModuleImpl; }
 
 SPIRVValue *SPIRVModuleImpl::getValue(SPIRVId TheId) const {
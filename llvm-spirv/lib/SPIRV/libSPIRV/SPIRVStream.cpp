@@ -82,11 +82,29 @@ static void readQuotedString(std::istream &IS, std::string &Str) {
 bool SPIRVUseTextFormat = false;
 #endif
 
-SPIRVDecoder::SPIRVDecoder(std::istream &InputStream, SPIRVFunction &F)
+llvm::StringRef SPIRVInputStream::readString() {
+  const size_t Size = End - Cur;
+  const char *Zero = static_cast<const char *>(std::memchr(Cur, '\0', Size));
+  const size_t Len = Zero ? Zero - Cur : Size;
+  llvm::StringRef Str(Cur, Len);
+  // Skip the terminating zero and the padding.
+  const size_t Padded = (Len + sizeof(SPIRVWord)) & ~(sizeof(SPIRVWord) - 1);
+  if (!Zero || Padded > Size) {
+    Cur = End;
+    EndReached = true;
+  } else {
+    assert(std::all_of(Zero, Cur + Padded, [](char C) { return C == '\0'; }) &&
+           "Invalid string in SPIRV");
+    Cur += Padded;
+  }
+  return Str;
+}
+
+SPIRVDecoder::SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVFunction &F)
     : IS(InputStream), M(*F.getModule()), WordCount(0), OpCode(OpNop),
       Scope(&F) {}
 
-SPIRVDecoder::SPIRVDecoder(std::istream &InputStream, SPIRVBasicBlock &BB)
+SPIRVDecoder::SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVBasicBlock &BB)
     : IS(InputStream), M(*BB.getModule()), WordCount(0), OpCode(OpNop),
       Scope(&BB) {}
 
@@ -100,7 +118,7 @@ template <class T> const SPIRVDecoder &decode(const SPIRVDecoder &I, T &V) {
 #ifdef _SPIRV_SUPPORT_TEXT_FMT
   if (SPIRVUseTextFormat) {
     std::string W;
-    I.IS >> W;
+    *I.IS.getTextStream() >> W;
     V = getNameMap(V).rmap(W);
     SPIRVDBG(spvdbgs() << "Read word: W = " << W << " V = " << V << '\n');
     return I;
@@ -139,24 +157,14 @@ SPIRV_DEF_ENCDEC(LinkageType)
 const SPIRVDecoder &operator>>(const SPIRVDecoder &I, std::string &Str) {
 #ifdef _SPIRV_SUPPORT_TEXT_FMT
   if (SPIRVUseTextFormat) {
-    readQuotedString(I.IS, Str);
+    readQuotedString(*I.IS.getTextStream(), Str);
     SPIRVDBG(spvdbgs() << "Read string: \"" << Str << "\"\n");
     return I;
   }
 #endif
 
-  uint64_t Count = 0;
-  char Ch;
-  while (I.IS.get(Ch) && Ch != '\0') {
-    Str += Ch;
-    ++Count;
-  }
-  Count = (Count + 1) % 4;
-  Count = Count ? 4 - Count : 0;
-  for (; Count; --Count) {
-    I.IS >> Ch;
-    assert(Ch == '\0' && "Invalid string in SPIRV");
-  }
+  llvm::StringRef S = I.IS.readString();
+  Str.append(S.data(), S.size());
   SPIRVDBG(spvdbgs() << "Read string: \"" << Str << "\"\n");
   return I;
 }
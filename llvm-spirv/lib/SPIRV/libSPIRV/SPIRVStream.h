@@ -43,8 +43,10 @@
 #include "SPIRVDebug.h"
 #include "SPIRVExtInst.h"
 #include "SPIRVModule.h"
+#include "llvm/ADT/StringRef.h"
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <string>
@@ -64,19 +66,64 @@ extern bool SPIRVUseTextFormat;
 class SPIRVFunction;
 class SPIRVBasicBlock;
 
+/// Input of SPIRVDecoder. The binary format is decoded straight from memory,
+/// which must outlive the stream: the words are read in place and the literal
+/// strings are returned as views of the memory. The textual format is parsed
+/// from a std::istream.
+class SPIRVInputStream {
+public:
+  SPIRVInputStream(const char *Begin, const char *End)
+      : Cur(Begin), End(End), TextIS(nullptr), EndReached(false) {}
+  explicit SPIRVInputStream(std::istream &IS)
+      : Cur(nullptr), End(nullptr), TextIS(&IS), EndReached(false) {}
+
+  /// Returns the stream the textual format is parsed from, or null if the
+  /// input is binary.
+  std::istream *getTextStream() const { return TextIS; }
+
+  /// Reads the next word of the binary input. Returns false and sets the end
+  /// of input flag if there is no complete word left.
+  bool readWord(SPIRVWord &W) {
+    if (static_cast<size_t>(End - Cur) < sizeof(W)) {
+      Cur = End;
+      EndReached = true;
+      return false;
+    }
+    std::memcpy(&W, Cur, sizeof(W));
+    Cur += sizeof(W);
+    return true;
+  }
+
+  /// Reads a null-terminated literal string of the binary input padded with
+  /// zeros to a word boundary and returns a view of it.
+  llvm::StringRef readString();
+
+  // The end of input and failure states follow the std::istream ones: they
+  // are set by a read past the end.
+  bool eof() const { return TextIS ? TextIS->eof() : EndReached; }
+  bool fail() const { return TextIS ? TextIS->fail() : EndReached; }
+  bool bad() const { return TextIS && TextIS->bad(); }
+
+private:
+  const char *Cur;
+  const char *End;
+  std::istream *TextIS;
+  bool EndReached;
+};
+
 class SPIRVDecoder {
 public:
-  SPIRVDecoder(std::istream &InputStream, SPIRVModule &Module)
+  SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVModule &Module)
       : IS(InputStream), M(Module), WordCount(0), OpCode(OpNop), Scope(NULL) {}
-  SPIRVDecoder(std::istream &InputStream, SPIRVFunction &F);
-  SPIRVDecoder(std::istream &InputStream, SPIRVBasicBlock &BB);
+  SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVFunction &F);
+  SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVBasicBlock &BB);
 
   void setScope(SPIRVEntry *);
   bool getWordCountAndOpCode();
   SPIRVEntry *getEntry();
   void validate() const;
 
-  std::istream &IS;
+  SPIRVInputStream &IS;
   SPIRVModule &M;
   SPIRVWord WordCount;
   Op OpCode;
@@ -96,8 +143,8 @@ class SPIRVNL {
 
 template <typename T>
 const SPIRVDecoder &decodeBinary(const SPIRVDecoder &I, T &V) {
-  uint32_t W;
-  I.IS.read(reinterpret_cast<char *>(&W), sizeof(W));
+  SPIRVWord W = 0;
+  I.IS.readWord(W);
   V = static_cast<T>(W);
   SPIRVDBG(spvdbgs() << "Read word: W = " << W << " V = " << V << '\n');
   return I;
@@ -108,7 +155,7 @@ const SPIRVDecoder &operator>>(const SPIRVDecoder &I, T &V) {
 #ifdef _SPIRV_SUPPORT_TEXT_FMT
   if (SPIRVUseTextFormat) {
     uint32_t W;
-    I.IS >> W;
+    *I.IS.getTextStream() >> W;
     V = static_cast<T>(W);
     SPIRVDBG(spvdbgs() << "Read word: W = " << W << " V = " << V << '\n');
     return I;
@@ -230,7 +230,7 @@ void SPIRVTypeForwardPointer::encode(spv_ostream &O) const {
   getEncoder(O) << Pointer << SC;
 }
 
-void SPIRVTypeForwardPointer::decode(std::istream &I) {
+void SPIRVTypeForwardPointer::decode(SPIRVInputStream &I) {
   auto Decoder = getDecoder(I);
   SPIRVId PointerId;
   Decoder >> PointerId >> SC;
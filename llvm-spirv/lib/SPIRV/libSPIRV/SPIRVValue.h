@@ -139,11 +139,7 @@ public:
   // Complete constructor for integer constant
   SPIRVConstant(SPIRVModule *M, SPIRVType *TheType, SPIRVId TheId,
                 uint64_t TheValue)
-      : SPIRVValue(M, 0, OpConstant, TheType, TheId) {
-    Union.UInt64Val = TheValue;
-    recalculateWordCount();
-    validate();
-  }
+      : SPIRVConstant(M, TheType, TheId, TheValue, OpConstant) {}
   // Complete constructor for float constant
   SPIRVConstant(SPIRVModule *M, SPIRVType *TheType, SPIRVId TheId,
                 float TheValue)
@@ -161,12 +157,24 @@ public:
     validate();
   }
   // Incomplete constructor
-  SPIRVConstant() : SPIRVValue(OpConstant), NumWords(0) {}
+  SPIRVConstant() : SPIRVConstant(OpConstant) {}
   uint64_t getZExtIntValue() const { return Union.UInt64Val; }
   float getFloatValue() const { return Union.FloatVal; }
   double getDoubleValue() const { return Union.DoubleVal; }
 
 protected:
+  // Complete constructor for a constant of opcode OC from the bits of its
+  // value
+  SPIRVConstant(SPIRVModule *M, SPIRVType *TheType, SPIRVId TheId,
+                uint64_t TheValue, Op OC)
+      : SPIRVValue(M, 0, OC, TheType, TheId) {
+    Union.UInt64Val = TheValue;
+    recalculateWordCount();
+    validate();
+  }
+  // Incomplete constructor for a constant of opcode OC
+  explicit SPIRVConstant(Op OC) : SPIRVValue(OC), NumWords(0) {}
+
   void recalculateWordCount() {
     NumWords = Type->getBitWidth() / 32;
     if (NumWords < 1)
@@ -186,7 +194,7 @@ protected:
     SPIRVValue::setWordCount(WordCount);
     NumWords = WordCount - 3;
   }
-  void decode(std::istream &I) override {
+  void decode(SPIRVInputStream &I) override {
     getDecoder(I) >> Type >> Id;
     for (unsigned J = 0; J < NumWords; ++J)
       getDecoder(I) >> Union.Words[J];
@@ -202,6 +210,18 @@ protected:
   } Union;
 };
 
+// A specialization constant, whose value may be set when the module is
+// specialized, identified by its SpecId decoration.
+class SPIRVSpecConstant : public SPIRVConstant {
+public:
+  // Complete constructor from the bits of the default value
+  SPIRVSpecConstant(SPIRVModule *M, SPIRVType *TheType, SPIRVId TheId,
+                    uint64_t TheValue)
+      : SPIRVConstant(M, TheType, TheId, TheValue, OpSpecConstant) {}
+  // Incomplete constructor
+  SPIRVSpecConstant() : SPIRVConstant(OpSpecConstant) {}
+};
+
 template <Op OC> class SPIRVConstantEmpty : public SPIRVValue {
 public:
   // Complete constructor
@@ -234,6 +254,8 @@ protected:
 
 typedef SPIRVConstantBool<OpConstantTrue> SPIRVConstantTrue;
 typedef SPIRVConstantBool<OpConstantFalse> SPIRVConstantFalse;
+typedef SPIRVConstantBool<OpSpecConstantTrue> SPIRVSpecConstantTrue;
+typedef SPIRVConstantBool<OpSpecConstantFalse> SPIRVSpecConstantFalse;
 
 class SPIRVConstantNull : public SPIRVConstantEmpty<OpConstantNull> {
 public:
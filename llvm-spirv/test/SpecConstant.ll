@@ -0,0 +1,49 @@
+; RUN: llvm-as %s -o %t.bc
+; RUN: llvm-spirv %t.bc -spirv-text -o - | FileCheck %s --check-prefix=CHECK-SPIRV
+; RUN: llvm-spirv %t.bc -o %t.spv
+; RUN: llvm-spirv -r %t.spv -o %t.rev.bc
+; RUN: llvm-dis < %t.rev.bc | FileCheck %s --check-prefix=CHECK-LLVM
+
+; Each __spirv_SpecConstant call becomes a specialization constant decorated
+; with its SpecId, the calls reading the same SpecId sharing one constant. The
+; reverse translation replaces the constants with their default values.
+
+; CHECK-SPIRV-DAG: Decorate [[I32:[0-9]+]] SpecId 1
+; CHECK-SPIRV-DAG: Decorate [[F32:[0-9]+]] SpecId 2
+; CHECK-SPIRV-DAG: Decorate [[BOOL:[0-9]+]] SpecId 3
+; CHECK-SPIRV-NOT: SpecId
+; CHECK-SPIRV-DAG: SpecConstant {{[0-9]+}} [[I32]] 42
+; CHECK-SPIRV-DAG: SpecConstant {{[0-9]+}} [[F32]] 1069547520
+; CHECK-SPIRV-DAG: SpecConstantTrue {{[0-9]+}} [[BOOL]]
+; CHECK-SPIRV-NOT: FunctionCall
+
+; CHECK-LLVM-NOT: __spirv_SpecConstant
+; CHECK-LLVM: store i32 42, i32 addrspace(1)*
+; CHECK-LLVM: store float 1.500000e+00, float addrspace(1)*
+; CHECK-LLVM: {{(zext|select) i1 true}}
+; CHECK-LLVM: store i32 42, i32 addrspace(1)*
+; CHECK-LLVM-NOT: __spirv_SpecConstant
+
+target datalayout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:256-v256:256-v512:512-v1024:1024-n8:16:32:64"
+target triple = "spir64-unknown-unknown"
+
+define spir_kernel void @foo(i32 addrspace(1)* %i, float addrspace(1)* %f, i8 addrspace(1)* %b) {
+entry:
+  %0 = call i32 @_Z20__spirv_SpecConstantii(i32 1, i32 42)
+  store i32 %0, i32 addrspace(1)* %i, align 4
+  %1 = call float @_Z20__spirv_SpecConstantif(i32 2, float 1.500000e+00)
+  store float %1, float addrspace(1)* %f, align 4
+  %2 = call zeroext i1 @_Z20__spirv_SpecConstantib(i32 3, i1 zeroext true)
+  %3 = zext i1 %2 to i8
+  store i8 %3, i8 addrspace(1)* %b, align 1
+  %4 = call i32 @_Z20__spirv_SpecConstantii(i32 1, i32 42)
+  %arrayidx = getelementptr inbounds i32, i32 addrspace(1)* %i, i64 1
+  store i32 %4, i32 addrspace(1)* %arrayidx, align 4
+  ret void
+}
+
+declare i32 @_Z20__spirv_SpecConstantii(i32, i32)
+
+declare float @_Z20__spirv_SpecConstantif(i32, float)
+
+declare zeroext i1 @_Z20__spirv_SpecConstantib(i32, i1 zeroext)
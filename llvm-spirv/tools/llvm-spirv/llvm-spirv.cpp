@@ -57,6 +57,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/ToolOutputFile.h"
 
 #ifndef _SPIRV_SUPPORT_TEXT_FMT
@@ -93,6 +94,23 @@ static cl::opt<bool>
     IsRegularization("s",
                      cl::desc("Regularize LLVM to be representable by SPIR-V"));
 
+static cl::list<std::string>
+    EntryPoints("spirv-entry-points", cl::CommaSeparated,
+                cl::desc("Translate only the named entry points and what they "
+                         "depend on"),
+                cl::value_desc("kernel,..."));
+
+static cl::opt<bool>
+    TimeTrace("time-trace",
+              cl::desc("Record the time spent in the translation steps and "
+                       "passes in Chrome trace event format"));
+
+static cl::opt<std::string>
+    TimeTraceFile("time-trace-file",
+                  cl::desc("Time trace output file, <output>.time.json by "
+                           "default"),
+                  cl::value_desc("filename"));
+
 #ifdef _SPIRV_SUPPORT_TEXT_FMT
 namespace SPIRV {
 // Use textual format for SPIRV.
@@ -137,12 +155,17 @@ static int convertLLVMToSPIRV() {
   }
 
   std::string Err;
+  auto Write = [&](std::ostream &OS) {
+    if (EntryPoints.empty())
+      return writeSpirv(M.get(), OS, Err);
+    return writeSpirv(M.get(), EntryPoints, OS, Err);
+  };
   bool Success = false;
   if (OutputFile != "-") {
     std::ofstream OutFile(OutputFile, std::ios::binary);
-    Success = writeSpirv(M.get(), OutFile, Err);
+    Success = Write(OutFile);
   } else {
-    Success = writeSpirv(M.get(), std::cout, Err);
+    Success = Write(std::cout);
   }
 
   if (!Success) {
@@ -154,11 +177,16 @@ static int convertLLVMToSPIRV() {
 
 static int convertSPIRVToLLVM() {
   LLVMContext Context;
-  std::ifstream IFS(InputFile, std::ios::binary);
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MB =
+      MemoryBuffer::getFileOrSTDIN(InputFile);
+  if (!MB) {
+    errs() << "Fails to open input file: " << MB.getError().message() << '\n';
+    return -1;
+  }
   Module *M;
   std::string Err;
 
-  if (!readSpirv(Context, IFS, M, Err)) {
+  if (!readSpirv(Context, (*MB)->getBuffer(), M, Err)) {
     errs() << "Fails to load SPIR-V as LLVM Module: " << Err << '\n';
     return -1;
   }
@@ -259,13 +287,7 @@ static int regularizeLLVM() {
   return 0;
 }
 
-int main(int Ac, char **Av) {
-  EnablePrettyStackTrace();
-  sys::PrintStackTraceOnErrorSignal(Av[0]);
-  PrettyStackTraceProgram X(Ac, Av);
-
-  cl::ParseCommandLineOptions(Ac, Av, "LLVM/SPIR-V translator");
-
+static int translate() {
 #ifdef _SPIRV_SUPPORT_TEXT_FMT
   if (ToText && (ToBinary || IsReverse || IsRegularization)) {
     errs() << "Cannot use -to-text with -to-binary, -r, -s\n";
@@ -296,3 +318,30 @@ int main(int Ac, char **Av) {
 
   return 0;
 }
+
+int main(int Ac, char **Av) {
+  EnablePrettyStackTrace();
+  sys::PrintStackTraceOnErrorSignal(Av[0]);
+  PrettyStackTraceProgram X(Ac, Av);
+
+  cl::ParseCommandLineOptions(Ac, Av, "LLVM/SPIR-V translator");
+
+  if (TimeTrace)
+    timeTraceProfilerInitialize();
+  int Ret = translate();
+  if (TimeTrace) {
+    if (TimeTraceFile.empty())
+      TimeTraceFile = (OutputFile.empty() || OutputFile == "-")
+                          ? std::string("llvm-spirv.time.json")
+                          : OutputFile + ".time.json";
+    std::error_code EC;
+    raw_fd_ostream OS(TimeTraceFile, EC, sys::fs::F_Text);
+    if (EC) {
+      errs() << "Fails to open time trace file: " << EC.message() << '\n';
+      return -1;
+    }
+    timeTraceProfilerWrite(OS);
+    timeTraceProfilerCleanup();
+  }
+  return Ret;
+}
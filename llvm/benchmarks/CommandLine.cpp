@@ -0,0 +1,75 @@
+//===- CommandLine.cpp - Registration of command line options -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures the cost of constructing options, which is what the static
+// constructors of a tool pay at startup, and of the first parse of a command
+// line, which registers them with the parser.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static std::vector<std::string> makeNames(unsigned NumOptions) {
+  std::vector<std::string> Names;
+  for (unsigned I = 0; I != NumOptions; ++I)
+    Names.push_back(("bench-option-" + Twine(I)).str());
+  return Names;
+}
+
+static std::vector<std::unique_ptr<cl::opt<bool>>>
+createOptions(const std::vector<std::string> &Names) {
+  std::vector<std::unique_ptr<cl::opt<bool>>> Options;
+  for (const std::string &Name : Names)
+    Options.push_back(llvm::make_unique<cl::opt<bool>>(
+        StringRef(Name), cl::desc("A benchmark option"), cl::Hidden));
+  return Options;
+}
+
+static void removeOptions(std::vector<std::unique_ptr<cl::opt<bool>>> &Opts) {
+  for (auto &Opt : Opts)
+    Opt->removeArgument();
+  Opts.clear();
+}
+
+static void BM_ConstructOptions(benchmark::State &State) {
+  std::vector<std::string> Names = makeNames(State.range(0));
+  for (auto _ : State) {
+    auto Options = createOptions(Names);
+    State.PauseTiming();
+    removeOptions(Options);
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(State.iterations() * Names.size());
+}
+BENCHMARK(BM_ConstructOptions)->Arg(100)->Arg(1000);
+
+static void BM_ConstructAndParse(benchmark::State &State) {
+  std::vector<std::string> Names = makeNames(State.range(0));
+  const char *Args[] = {"bench", "-bench-option-0"};
+  for (auto _ : State) {
+    auto Options = createOptions(Names);
+    cl::ParseCommandLineOptions(2, Args, "", &nulls());
+    State.PauseTiming();
+    cl::ResetAllOptionOccurrences();
+    removeOptions(Options);
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(State.iterations() * Names.size());
+}
+BENCHMARK(BM_ConstructAndParse)->Arg(100)->Arg(1000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,138 @@
+//===- IRMemory.cpp - Memory footprint of the IR read from bitcode --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Reads the bitcode files given on the command line, or a generated module if
+// there is none, and reports the time to read them along with the memory used
+// by their IR, to measure changes to the representation of the IR:
+//
+//   IRMemory [benchmark options] a.bc b.bc...
+//
+// The counters are the bytes allocated while reading a module in a fresh
+// context, which discards the names of the values as the LTO links do, and
+// the bytes of these per instruction and the part of them used by the Uses of
+// the instructions.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+
+static void BM_ReadBitcode(benchmark::State &State, MemoryBufferRef Buffer) {
+  size_t Bytes = 0, Instructions = 0, Uses = 0;
+  for (auto _ : State) {
+    LLVMContext Context;
+    Context.setDiscardValueNames(true);
+    size_t Before = sys::Process::GetMallocUsage();
+    Expected<std::unique_ptr<Module>> M = parseBitcodeFile(Buffer, Context);
+    if (!M) {
+      State.SkipWithError(toString(M.takeError()).c_str());
+      return;
+    }
+    Bytes = sys::Process::GetMallocUsage() - Before;
+
+    State.PauseTiming();
+    Instructions = Uses = 0;
+    for (const Function &F : **M)
+      for (const BasicBlock &BB : F)
+        for (const Instruction &I : BB) {
+          ++Instructions;
+          Uses += I.getNumOperands();
+        }
+    M->reset();
+    State.ResumeTiming();
+  }
+
+  State.counters["IRBytes"] = Bytes;
+  State.counters["Instructions"] = Instructions;
+  State.counters["BytesPerInstruction"] =
+      Instructions ? double(Bytes) / Instructions : 0;
+  State.counters["UseBytes"] = Uses * sizeof(Use);
+}
+
+/// Write the bitcode of a module of functions of arithmetic, memory accesses
+/// and calls in a loop.
+static std::unique_ptr<MemoryBuffer> createBitcode() {
+  LLVMContext Context;
+  Module M("generated.bc", Context);
+  Type *Int64Ty = Type::getInt64Ty(Context);
+  FunctionType *FTy =
+      FunctionType::get(Int64Ty, {Int64Ty, Int64Ty->getPointerTo()}, false);
+  Function *Prev = nullptr;
+  for (unsigned I = 0; I != 1000; ++I) {
+    Function *F = Function::Create(FTy, GlobalValue::ExternalLinkage,
+                                   "f" + Twine(I), M);
+    BasicBlock *Entry = BasicBlock::Create(Context, "entry", F);
+    BasicBlock *Loop = BasicBlock::Create(Context, "loop", F);
+    BasicBlock *Exit = BasicBlock::Create(Context, "exit", F);
+    IRBuilder<> B(Entry);
+    B.CreateBr(Loop);
+
+    B.SetInsertPoint(Loop);
+    PHINode *IV = B.CreatePHI(Int64Ty, 2);
+    PHINode *Sum = B.CreatePHI(Int64Ty, 2);
+    Value *Ptr = B.CreateGEP(Int64Ty, F->arg_begin() + 1, IV);
+    Value *V = B.CreateLoad(Int64Ty, Ptr);
+    for (unsigned J = 0; J != 20; ++J)
+      V = B.CreateAdd(B.CreateMul(V, IV), B.getInt64(J));
+    if (Prev)
+      V = B.CreateCall(Prev, {V, F->arg_begin() + 1});
+    B.CreateStore(V, Ptr);
+    Value *NewSum = B.CreateAdd(Sum, V);
+    Value *Next = B.CreateAdd(IV, B.getInt64(1));
+    B.CreateCondBr(B.CreateICmpULT(Next, F->arg_begin()), Loop, Exit);
+    IV->addIncoming(B.getInt64(0), Entry);
+    IV->addIncoming(Next, Loop);
+    Sum->addIncoming(B.getInt64(0), Entry);
+    Sum->addIncoming(NewSum, Loop);
+
+    B.SetInsertPoint(Exit);
+    B.CreateRet(NewSum);
+    Prev = F;
+  }
+
+  SmallString<0> Buffer;
+  raw_svector_ostream OS(Buffer);
+  WriteBitcodeToFile(M, OS);
+  return MemoryBuffer::getMemBufferCopy(Buffer, M.getModuleIdentifier());
+}
+
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+
+  std::vector<std::unique_ptr<MemoryBuffer>> Buffers;
+  for (int I = 1; I < argc; ++I) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+        MemoryBuffer::getFile(argv[I]);
+    if (!BufferOrErr) {
+      errs() << argv[I] << ": " << BufferOrErr.getError().message() << '\n';
+      return 1;
+    }
+    Buffers.push_back(std::move(*BufferOrErr));
+  }
+  if (Buffers.empty())
+    Buffers.push_back(createBitcode());
+
+  for (const std::unique_ptr<MemoryBuffer> &Buffer : Buffers)
+    benchmark::RegisterBenchmark(
+        ("BM_ReadBitcode/" + Buffer->getBufferIdentifier()).str().c_str(),
+        BM_ReadBitcode, Buffer->getMemBufferRef())
+        ->Unit(benchmark::kMillisecond);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,72 @@
+//===- SpecialCaseList.cpp - Lookups in a large special case list ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures inSection lookups of function names in a generated list with the
+// mix of rules of the sanitizer ignorelists: exact names, prefix globs, other
+// globs and a few regexes.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SpecialCaseList.h"
+
+using namespace llvm;
+
+static std::unique_ptr<SpecialCaseList> createList(unsigned NumRules,
+                                                   bool WithRegexes) {
+  std::string List = "[address]\n";
+  for (unsigned I = 0; I != NumRules; ++I) {
+    switch (I % 4) {
+    case 0:
+      List += ("fun:_ZN4name" + Twine(I) + "Ev\n").str();
+      break;
+    case 1:
+      List += ("fun:_ZN9namespace" + Twine(I) + "*\n").str();
+      break;
+    case 2:
+      List += ("fun:*method" + Twine(I) + "*\n").str();
+      break;
+    case 3:
+      List += ("src:lib/dir" + Twine(I) + "/*.cpp\n").str();
+      break;
+    }
+  }
+  if (WithRegexes)
+    List += "fun:(_ZN3foo|_ZN3bar)[0-9]+\n";
+  std::unique_ptr<MemoryBuffer> MB = MemoryBuffer::getMemBuffer(List);
+  std::string Error;
+  std::unique_ptr<SpecialCaseList> SCL =
+      SpecialCaseList::create(MB.get(), Error);
+  if (!SCL)
+    report_fatal_error(Error);
+  return SCL;
+}
+
+static void BM_InSection(benchmark::State &State, bool WithRegexes) {
+  unsigned NumRules = State.range(0);
+  std::unique_ptr<SpecialCaseList> SCL = createList(NumRules, WithRegexes);
+  std::vector<std::string> Queries;
+  for (unsigned I = 0; I != 1000; ++I)
+    Queries.push_back(
+        ("_ZN7unknown" + Twine(I * 7919 % NumRules) + "Ev").str());
+  Queries.push_back("_ZN9namespace1foo");
+  Queries.push_back("_ZN3bar42");
+
+  for (auto _ : State)
+    for (const std::string &Query : Queries)
+      benchmark::DoNotOptimize(SCL->inSection("address", "fun", Query));
+  State.SetItemsProcessed(State.iterations() * Queries.size());
+}
+
+BENCHMARK_CAPTURE(BM_InSection, globs, false)->Range(64, 64 << 10);
+BENCHMARK_CAPTURE(BM_InSection, globs_and_regexes, true)->Range(64, 64 << 10);
+
+BENCHMARK_MAIN();
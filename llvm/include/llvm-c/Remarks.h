@@ -30,7 +30,7 @@ extern "C" {
  * @{
  */
 
-#define REMARKS_API_VERSION 0
+#define REMARKS_API_VERSION 1
 
 /**
  * The type of the emitted remark.
@@ -229,6 +229,20 @@ typedef struct LLVMRemarkOpaqueParser *LLVMRemarkParserRef;
 extern LLVMRemarkParserRef LLVMRemarkParserCreateYAML(const void *Buf,
                                                       uint64_t Size);
 
+/**
+ * Creates a remark parser that can be used to parse the buffer located in \p
+ * Buf of size \p Size bytes, in the binary remark format.
+ *
+ * \p Buf cannot be `NULL`.
+ *
+ * This function should be paired with LLVMRemarkParserDispose() to avoid
+ * leaking resources.
+ *
+ * \since REMARKS_API_VERSION=1
+ */
+extern LLVMRemarkParserRef LLVMRemarkParserCreateBinary(const void *Buf,
+                                                        uint64_t Size);
+
 /**
  * Returns the next remark in the file.
  *
@@ -0,0 +1,336 @@
+//===- CompactStringMap.h - Open addressed string map -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the CompactStringMap class, a drop-in replacement of
+// StringMap probing groups of control bytes.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_COMPACTSTRINGMAP_H
+#define LLVM_ADT_COMPACTSTRINGMAP_H
+
+#include "llvm/ADT/StringMap.h"
+#include <cstring>
+
+namespace llvm {
+
+/// CompactStringMapImpl - This is the base class of CompactStringMap that is
+/// shared among all of its instantiations.
+///
+/// Every bucket has a control byte, holding 7 bits of the hash of the key of
+/// the bucket, or telling that the bucket is empty or a tombstone. The buckets
+/// are probed by groups of 16 with the control bytes only, the same group at
+/// once with SSE2, so the entries are only read for the keys whose 7 bits of
+/// hash match, almost always the key looked up.
+class CompactStringMapImpl {
+protected:
+  // Array of NumBuckets pointers to entries, null pointers are holes.
+  // TheTable[NumBuckets] contains a sentinel value for easy iteration. Followed
+  // by an array of the actual hash values as unsigned integers, and by the
+  // array of the control bytes.
+  StringMapEntryBase **TheTable = nullptr;
+  unsigned NumBuckets = 0;
+  unsigned NumItems = 0;
+  unsigned NumTombstones = 0;
+  unsigned ItemSize;
+
+protected:
+  explicit CompactStringMapImpl(unsigned itemSize) : ItemSize(itemSize) {}
+  CompactStringMapImpl(CompactStringMapImpl &&RHS)
+      : TheTable(RHS.TheTable), NumBuckets(RHS.NumBuckets),
+        NumItems(RHS.NumItems), NumTombstones(RHS.NumTombstones),
+        ItemSize(RHS.ItemSize) {
+    RHS.TheTable = nullptr;
+    RHS.NumBuckets = 0;
+    RHS.NumItems = 0;
+    RHS.NumTombstones = 0;
+  }
+
+  CompactStringMapImpl(unsigned InitSize, unsigned ItemSize);
+  unsigned RehashTable(unsigned BucketNo = 0);
+
+  /// LookupBucketFor - Look up the bucket that the specified string should end
+  /// up in.  If it already exists as a key in the map, the Item pointer for the
+  /// specified bucket will be non-null.  Otherwise, it will be null or a
+  /// tombstone, and the bucket must be filled by the caller.
+  unsigned LookupBucketFor(StringRef Key);
+
+  /// FindKey - Look up the bucket that contains the specified key. If it exists
+  /// in the map, return the bucket number of the key.  Otherwise return -1.
+  /// This does not modify the map.
+  int FindKey(StringRef Key) const;
+
+  /// RemoveKey - Remove the specified StringMapEntry from the table, but do not
+  /// delete it.  This aborts if the value isn't in the table.
+  void RemoveKey(StringMapEntryBase *V);
+
+  /// RemoveKey - Remove the StringMapEntry for the specified key from the
+  /// table, returning it.  If the key is not in the table, this returns null.
+  StringMapEntryBase *RemoveKey(StringRef Key);
+
+  /// Allocate the table with the specified number of buckets and otherwise
+  /// setup the map as empty.
+  void init(unsigned Size);
+
+  /// Empties all the buckets, their entries have been destroyed.
+  void clearTable();
+
+  unsigned *getHashTable() const {
+    return reinterpret_cast<unsigned *>(TheTable + NumBuckets + 1);
+  }
+  uint8_t *getControlBytes() const {
+    return reinterpret_cast<uint8_t *>(getHashTable() + NumBuckets + 1);
+  }
+
+  /// The size of the allocation of the table for \p NumBuckets buckets.
+  static size_t getTableSize(unsigned NumBuckets) {
+    return (NumBuckets + 1) *
+           (sizeof(StringMapEntryBase *) + sizeof(unsigned) + sizeof(uint8_t));
+  }
+
+public:
+  static StringMapEntryBase *getTombstoneVal() {
+    return StringMapImpl::getTombstoneVal();
+  }
+
+  unsigned getNumBuckets() const { return NumBuckets; }
+  unsigned getNumItems() const { return NumItems; }
+
+  bool empty() const { return NumItems == 0; }
+  unsigned size() const { return NumItems; }
+
+  void swap(CompactStringMapImpl &Other) {
+    std::swap(TheTable, Other.TheTable);
+    std::swap(NumBuckets, Other.NumBuckets);
+    std::swap(NumItems, Other.NumItems);
+    std::swap(NumTombstones, Other.NumTombstones);
+  }
+};
+
+/// CompactStringMap - A StringMap whose lookups probe the control bytes of
+/// CompactStringMapImpl. Its entries and iterators are the ones of StringMap,
+/// so that switching a StringMap to it only changes the type of the map. As in
+/// StringMap, the entries are allocated out of the table and don't move when
+/// the table grows.
+template <typename ValueTy, typename AllocatorTy = MallocAllocator>
+class CompactStringMap : public CompactStringMapImpl {
+  AllocatorTy Allocator;
+
+public:
+  using MapEntryTy = StringMapEntry<ValueTy>;
+
+  CompactStringMap()
+      : CompactStringMapImpl(static_cast<unsigned>(sizeof(MapEntryTy))) {}
+
+  explicit CompactStringMap(unsigned InitialSize)
+      : CompactStringMapImpl(InitialSize,
+                             static_cast<unsigned>(sizeof(MapEntryTy))) {}
+
+  explicit CompactStringMap(AllocatorTy A)
+      : CompactStringMapImpl(static_cast<unsigned>(sizeof(MapEntryTy))),
+        Allocator(A) {}
+
+  CompactStringMap(unsigned InitialSize, AllocatorTy A)
+      : CompactStringMapImpl(InitialSize,
+                             static_cast<unsigned>(sizeof(MapEntryTy))),
+        Allocator(A) {}
+
+  CompactStringMap(std::initializer_list<std::pair<StringRef, ValueTy>> List)
+      : CompactStringMapImpl(List.size(),
+                             static_cast<unsigned>(sizeof(MapEntryTy))) {
+    for (const auto &P : List) {
+      insert(P);
+    }
+  }
+
+  CompactStringMap(CompactStringMap &&RHS)
+      : CompactStringMapImpl(std::move(RHS)),
+        Allocator(std::move(RHS.Allocator)) {}
+
+  CompactStringMap(const CompactStringMap &RHS)
+      : CompactStringMapImpl(static_cast<unsigned>(sizeof(MapEntryTy))),
+        Allocator(RHS.Allocator) {
+    if (RHS.empty())
+      return;
+
+    // Copy the hash values and the control bytes of RHS along with its
+    // buckets, tombstones included.
+    init(RHS.NumBuckets);
+    memcpy(getHashTable(), RHS.getHashTable(),
+           getTableSize(NumBuckets) -
+               (NumBuckets + 1) * sizeof(StringMapEntryBase *));
+
+    NumItems = RHS.NumItems;
+    NumTombstones = RHS.NumTombstones;
+    for (unsigned I = 0, E = NumBuckets; I != E; ++I) {
+      StringMapEntryBase *Bucket = RHS.TheTable[I];
+      if (!Bucket || Bucket == getTombstoneVal()) {
+        TheTable[I] = Bucket;
+        continue;
+      }
+
+      TheTable[I] = MapEntryTy::Create(
+          static_cast<MapEntryTy *>(Bucket)->getKey(), Allocator,
+          static_cast<MapEntryTy *>(Bucket)->getValue());
+    }
+  }
+
+  CompactStringMap &operator=(CompactStringMap RHS) {
+    CompactStringMapImpl::swap(RHS);
+    std::swap(Allocator, RHS.Allocator);
+    return *this;
+  }
+
+  ~CompactStringMap() {
+    if (!empty()) {
+      for (unsigned I = 0, E = NumBuckets; I != E; ++I) {
+        StringMapEntryBase *Bucket = TheTable[I];
+        if (Bucket && Bucket != getTombstoneVal())
+          static_cast<MapEntryTy *>(Bucket)->Destroy(Allocator);
+      }
+    }
+    free(TheTable);
+  }
+
+  AllocatorTy &getAllocator() { return Allocator; }
+  const AllocatorTy &getAllocator() const { return Allocator; }
+
+  using key_type = const char *;
+  using mapped_type = ValueTy;
+  using value_type = StringMapEntry<ValueTy>;
+  using size_type = size_t;
+
+  using const_iterator = StringMapConstIterator<ValueTy>;
+  using iterator = StringMapIterator<ValueTy>;
+
+  iterator begin() { return iterator(TheTable, NumBuckets == 0); }
+  iterator end() { return iterator(TheTable + NumBuckets, true); }
+  const_iterator begin() const {
+    return const_iterator(TheTable, NumBuckets == 0);
+  }
+  const_iterator end() const {
+    return const_iterator(TheTable + NumBuckets, true);
+  }
+
+  iterator_range<StringMapKeyIterator<ValueTy>> keys() const {
+    return make_range(StringMapKeyIterator<ValueTy>(begin()),
+                      StringMapKeyIterator<ValueTy>(end()));
+  }
+
+  iterator find(StringRef Key) {
+    int Bucket = FindKey(Key);
+    if (Bucket == -1) return end();
+    return iterator(TheTable + Bucket, true);
+  }
+
+  const_iterator find(StringRef Key) const {
+    int Bucket = FindKey(Key);
+    if (Bucket == -1) return end();
+    return const_iterator(TheTable + Bucket, true);
+  }
+
+  /// lookup - Return the entry for the specified key, or a default
+  /// constructed value if no such entry exists.
+  ValueTy lookup(StringRef Key) const {
+    const_iterator it = find(Key);
+    if (it != end())
+      return it->second;
+    return ValueTy();
+  }
+
+  /// Lookup the ValueTy for the \p Key, or create a default constructed value
+  /// if the key is not in the map.
+  ValueTy &operator[](StringRef Key) { return try_emplace(Key).first->second; }
+
+  /// count - Return 1 if the element is in the map, 0 otherwise.
+  size_type count(StringRef Key) const {
+    return find(Key) == end() ? 0 : 1;
+  }
+
+  /// insert - Insert the specified key/value pair into the map.  If the key
+  /// already exists in the map, return false and ignore the request, otherwise
+  /// insert it and return true.
+  bool insert(MapEntryTy *KeyValue) {
+    unsigned BucketNo = LookupBucketFor(KeyValue->getKey());
+    StringMapEntryBase *&Bucket = TheTable[BucketNo];
+    if (Bucket && Bucket != getTombstoneVal())
+      return false; // Already exists in map.
+
+    if (Bucket == getTombstoneVal())
+      --NumTombstones;
+    Bucket = KeyValue;
+    ++NumItems;
+    assert(NumItems + NumTombstones <= NumBuckets);
+
+    RehashTable();
+    return true;
+  }
+
+  /// insert - Inserts the specified key/value pair into the map if the key
+  /// isn't already in the map. The bool component of the returned pair is true
+  /// if and only if the insertion takes place, and the iterator component of
+  /// the pair points to the element with key equivalent to the key of the pair.
+  std::pair<iterator, bool> insert(std::pair<StringRef, ValueTy> KV) {
+    return try_emplace(KV.first, std::move(KV.second));
+  }
+
+  /// Emplace a new element for the specified key into the map if the key isn't
+  /// already in the map. The bool component of the returned pair is true
+  /// if and only if the insertion takes place, and the iterator component of
+  /// the pair points to the element with key equivalent to the key of the pair.
+  template <typename... ArgsTy>
+  std::pair<iterator, bool> try_emplace(StringRef Key, ArgsTy &&... Args) {
+    unsigned BucketNo = LookupBucketFor(Key);
+    StringMapEntryBase *&Bucket = TheTable[BucketNo];
+    if (Bucket && Bucket != getTombstoneVal())
+      return std::make_pair(iterator(TheTable + BucketNo, false),
+                            false); // Already exists in map.
+
+    if (Bucket == getTombstoneVal())
+      --NumTombstones;
+    Bucket = MapEntryTy::Create(Key, Allocator, std::forward<ArgsTy>(Args)...);
+    ++NumItems;
+    assert(NumItems + NumTombstones <= NumBuckets);
+
+    BucketNo = RehashTable(BucketNo);
+    return std::make_pair(iterator(TheTable + BucketNo, false), true);
+  }
+
+  // clear - Empties out the CompactStringMap
+  void clear() {
+    if (empty()) return;
+
+    for (unsigned I = 0, E = NumBuckets; I != E; ++I) {
+      StringMapEntryBase *Bucket = TheTable[I];
+      if (Bucket && Bucket != getTombstoneVal())
+        static_cast<MapEntryTy *>(Bucket)->Destroy(Allocator);
+    }
+    clearTable();
+  }
+
+  /// remove - Remove the specified key/value pair from the map, but do not
+  /// erase it.  This aborts if the key is not in the map.
+  void remove(MapEntryTy *KeyValue) { RemoveKey(KeyValue); }
+
+  void erase(iterator I) {
+    MapEntryTy &V = *I;
+    remove(&V);
+    V.Destroy(Allocator);
+  }
+
+  bool erase(StringRef Key) {
+    iterator I = find(Key);
+    if (I == end()) return false;
+    erase(I);
+    return true;
+  }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_COMPACTSTRINGMAP_H
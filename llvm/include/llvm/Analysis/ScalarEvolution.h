@@ -1908,6 +1908,12 @@ private:
   /// allocated. This is used by releaseMemory to locate them all and call
   /// their destructors.
   SCEVUnknown *FirstUnknown = nullptr;
+
+  /// The number of getSCEV queries answered from ValueExprMap and the number
+  /// which had to build their expression, reported with the number of
+  /// expressions when the analysis is destroyed.
+  unsigned NumSCEVCacheHits = 0;
+  unsigned NumSCEVCacheMisses = 0;
 };
 
 /// Analysis pass that exposes the \c ScalarEvolution for a function.
@@ -35,6 +35,14 @@ class raw_pwrite_stream;
 /// BCOSs is not empty.
 ///
 /// \returns M if OSs.size() == 1, otherwise returns std::unique_ptr<Module>().
+///
+/// The unit of parallelism is a partition rather than a function because the
+/// code of the functions of a module is not independent: instruction selection
+/// and the AsmPrinter share the LLVMContext, the MCContext with its symbols
+/// and sections, and the MachineModuleInfo, and the streamer emits the global
+/// state (constant pools, jump tables, debug info) of all the functions of a
+/// module into one object. Each partition gets its own context and target
+/// machine, which the linker merges back into the equivalent of one object.
 std::unique_ptr<Module>
 splitCodeGen(std::unique_ptr<Module> M, ArrayRef<raw_pwrite_stream *> OSs,
              ArrayRef<llvm::raw_pwrite_stream *> BCOSs,
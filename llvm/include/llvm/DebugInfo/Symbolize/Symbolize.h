@@ -42,6 +42,10 @@ public:
     std::string DefaultArch;
     std::vector<std::string> DsymHints;
     std::string FallbackDebugPath;
+    /// The size in bytes of the binaries kept loaded between queries past
+    /// which the caches are flushed before loading a new module, or 0 to keep
+    /// all of them.
+    uint64_t MaxCacheSize = 0;
 
     Options(FunctionNameKind PrintFunctions = FunctionNameKind::LinkageName,
             bool UseSymbolTable = true, bool Demangle = true,
@@ -117,6 +121,9 @@ private:
   std::map<std::pair<std::string, std::string>, std::unique_ptr<ObjectFile>>
       ObjectForUBPathAndArch;
 
+  /// The total size of the binaries in BinaryForPath.
+  uint64_t CacheSize = 0;
+
   Options Opts;
 };
 
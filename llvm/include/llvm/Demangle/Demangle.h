@@ -46,6 +46,10 @@ std::string demangle(const std::string &MangledName);
 /// "Partial" demangler. This supports demangling a string into an AST
 /// (typically an intermediate stage in itaniumDemangle) and querying certain
 /// properties or partially printing the demangled name.
+///
+/// The memory of the AST is kept from one partialDemangle call to the next, so
+/// reusing a demangler, along with the output buffer passed to finishDemangle,
+/// is cheaper than calling itaniumDemangle for each name of a large batch.
 struct ItaniumPartialDemangler {
   ItaniumPartialDemangler();
 
@@ -83,6 +83,16 @@ public:
   /// symbol in them is requested.
   static Optional<GlobalValueSet> compileWholeModule(GlobalValueSet Requested);
 
+  /// Speculation function. Given a partition that is about to be compiled,
+  /// returns the global values of the same module that should be compiled
+  /// ahead of their first call.
+  using SpeculateFunction =
+      std::function<GlobalValueSet(const GlobalValueSet &Partition)>;
+
+  /// Off-the-shelf speculation which compiles the functions called directly
+  /// from the partition.
+  static GlobalValueSet speculateDirectCallees(const GlobalValueSet &Partition);
+
   /// Construct a CompileOnDemandLayer.
   CompileOnDemandLayer(ExecutionSession &ES, IRLayer &BaseLayer,
                         LazyCallThroughManager &LCTMgr,
@@ -91,6 +101,14 @@ public:
   /// Sets the partition function.
   void setPartitionFunction(PartitionFunction Partition);
 
+  /// Sets the speculation function, or clears it if Speculate is empty.
+  ///
+  /// Speculated symbols are looked up as soon as the partition that calls
+  /// them is compiled, which compiles them (and, in turn, their own
+  /// speculated symbols) without blocking the current thread only if the
+  /// ExecutionSession dispatches materialization to other threads.
+  void setSpeculateFunction(SpeculateFunction Speculate);
+
   /// Emits the given module. This should not be called by clients: it will be
   /// called by the JIT when a definition added via the add method is requested.
   void emit(MaterializationResponsibility R, ThreadSafeModule TSM) override;
@@ -127,6 +145,7 @@ private:
   IndirectStubsManagerBuilder BuildIndirectStubsManager;
   PerDylibResourcesMap DylibResources;
   PartitionFunction Partition = compileRequested;
+  SpeculateFunction Speculate;
   SymbolLinkagePromoter PromoteSymbols;
 };
 
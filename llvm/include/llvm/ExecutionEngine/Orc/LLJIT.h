@@ -161,6 +161,17 @@ public:
     CODLayer->setPartitionFunction(std::move(Partition));
   }
 
+  /// Sets the speculation function, which picks the functions to compile on
+  /// the compile threads ahead of their first call.
+  ///
+  /// Ignored if this instance has no compile threads, since the speculated
+  /// functions would then be compiled on the execution thread.
+  void
+  setSpeculateFunction(CompileOnDemandLayer::SpeculateFunction Speculate) {
+    if (CompileThreads)
+      CODLayer->setSpeculateFunction(std::move(Speculate));
+  }
+
   /// Add a module to be lazily compiled to JITDylib JD.
   Error addLazyIRModule(JITDylib &JD, ThreadSafeModule M);
 
@@ -188,6 +199,7 @@ public:
   Optional<JITTargetMachineBuilder> JTMB;
   CreateObjectLinkingLayerFunction CreateObjectLinkingLayer;
   unsigned NumCompileThreads = 0;
+  ObjectCache *ObjCache = nullptr;
 
   /// Called prior to JIT class construcion to fix up defaults.
   Error prepareForConstruction();
@@ -235,6 +247,16 @@ public:
     return impl();
   }
 
+  /// Set an ObjectCache for the compile layer to query before compiling a
+  /// module, and to store the objects it compiles in (e.g. an
+  /// OnDiskObjectCache). The cache must outlive the JIT instance.
+  ///
+  /// If this method is not called, every module is compiled.
+  SetterImpl &setObjectCache(ObjectCache *ObjCache) {
+    impl().ObjCache = ObjCache;
+    return impl();
+  }
+
   /// Create an instance of the JIT.
   Expected<std::unique_ptr<JITType>> create() {
     if (auto Err = impl().prepareForConstruction())
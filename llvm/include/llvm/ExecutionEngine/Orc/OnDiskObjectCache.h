@@ -0,0 +1,74 @@
+//===- OnDiskObjectCache.h - Content-addressed JIT object cache -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// An ObjectCache that keeps the objects compiled by a JIT in a directory, so
+// that other instances and processes can reuse them.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_ONDISKOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_ONDISKOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/Error.h"
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+
+class MemoryBuffer;
+class Module;
+
+namespace orc {
+
+class JITTargetMachineBuilder;
+
+/// An ObjectCache that stores objects in a directory, under a hash of the
+/// bitcode of their module and of the configuration of the target machine.
+///
+/// Processes that use the same directory compile each distinct module once.
+/// Cached objects are memory mapped read-only from their files, so that the
+/// processes loading the same object share its pages. Entries are written
+/// to a temporary file first and then renamed, so concurrent writers and
+/// readers never see a partial object.
+///
+/// The cache may be shared by concurrent compile threads.
+class OnDiskObjectCache : public ObjectCache {
+public:
+  /// Create a cache in CacheDir, which is created if it does not exist, for
+  /// the objects compiled by the target machines that JTMB builds.
+  static Expected<std::unique_ptr<OnDiskObjectCache>>
+  Create(StringRef CacheDir, const JITTargetMachineBuilder &JTMB);
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+private:
+  OnDiskObjectCache(std::string CacheDir, std::string TargetKey)
+      : CacheDir(std::move(CacheDir)), TargetKey(std::move(TargetKey)) {}
+
+  std::string getKey(const Module &M);
+  std::string getEntryPath(StringRef Key);
+
+  std::string CacheDir;
+  std::string TargetKey;
+
+  // Keys of the modules that missed the cache, to store their objects under
+  // once they are compiled without hashing them again.
+  std::mutex PendingKeysMutex;
+  DenseMap<const Module *, std::string> PendingKeys;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_ONDISKOBJECTCACHE_H
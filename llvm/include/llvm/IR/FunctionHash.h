@@ -0,0 +1,45 @@
+//===- llvm/IR/FunctionHash.h - Content hash of a function ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+/// @file
+/// This file declares computeFunctionHash, a hash of the contents of a function
+/// which can be used as the key of a cache of the results of optimizing it.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_IR_FUNCTIONHASH_H
+#define LLVM_IR_FUNCTIONHASH_H
+
+#include <array>
+#include <cstdint>
+
+namespace llvm {
+
+class Function;
+
+/// The SHA1 of the contents of a function, in the format of the module hashes.
+using FunctionHash = std::array<uint32_t, 5>;
+
+/// Compute the hash of \p F. Functions with the same hash have the same
+/// attributes, arguments, blocks and instructions, including their metadata
+/// and debug locations, which are hashed by contents. The globals referenced by
+/// the function are hashed by name along with what a function pass may observe
+/// of them: the type and attributes of a function, and the initializer of a
+/// constant variable. Unlike FunctionComparator::functionHash, the hash does
+/// not depend on the numbering of the metadata of the module, the order of the
+/// other functions or the memory layout of the process, so it is stable across
+/// runs of the compiler.
+///
+/// The hash does not cover the callers of the function nor the bodies of its
+/// callees, so it only identifies the result of passes looking at the function
+/// alone.
+FunctionHash computeFunctionHash(const Function &F);
+
+} // end namespace llvm
+
+#endif // LLVM_IR_FUNCTIONHASH_H
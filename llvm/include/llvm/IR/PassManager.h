@@ -1278,6 +1278,15 @@ using ModuleAnalysisManagerFunctionProxy =
 /// Note that although function passes can access module analyses, module
 /// analyses are not invalidated while the function passes are running, so they
 /// may be stale.  Function analyses will not be stale.
+///
+/// The functions are still visited one at a time on the calling thread. Even
+/// passes following the above principles create types, constants and metadata
+/// uniqued in the LLVMContext shared by all the functions, and update the use
+/// lists of the globals and constants they reference, none of which is
+/// synchronized. The analysis manager and the pass instrumentation are not
+/// thread-safe either. Running a function pipeline in parallel needs the
+/// functions to be in modules of different contexts, as splitCodeGen does for
+/// code generation.
 template <typename FunctionPassT>
 class ModuleToFunctionPassAdaptor
     : public PassInfoMixin<ModuleToFunctionPassAdaptor<FunctionPassT>> {
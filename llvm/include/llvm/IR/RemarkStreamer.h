@@ -14,11 +14,14 @@
 #define LLVM_IR_REMARKSTREAMER_H
 
 #include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/Remarks/BinaryRemarkSerializer.h"
+#include "llvm/Remarks/RemarkFormat.h"
 #include "llvm/Remarks/RemarkStringTable.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Regex.h"
 #include "llvm/Support/YAMLTraits.h"
 #include "llvm/Support/raw_ostream.h"
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -32,20 +35,30 @@ class RemarkStreamer {
   /// The regex used to filter remarks based on the passes that emit them.
   Optional<Regex> PassFilter;
 
+  /// The format the remarks are emitted in.
+  remarks::Format RemarkFormat;
+
   /// The YAML streamer.
   yaml::Output YAMLOutput;
 
+  /// The binary serializer, used instead of the YAML streamer for the binary
+  /// format.
+  std::unique_ptr<remarks::BinarySerializer> BinaryOutput;
+
   /// The string table containing all the unique strings used in the output.
   /// The table will be serialized in a section to be consumed after the
   /// compilation.
   remarks::StringTable StrTab;
 
 public:
-  RemarkStreamer(StringRef Filename, raw_ostream& OS);
+  RemarkStreamer(StringRef Filename, raw_ostream &OS,
+                 remarks::Format RemarkFormat = remarks::Format::YAML);
   /// Return the filename that the remark diagnostics are emitted to.
   StringRef getFilename() const { return Filename; }
   /// Return stream that the remark diagnostics are emitted to.
   raw_ostream &getStream() { return OS; }
+  /// Return the format that the remark diagnostics are emitted in.
+  remarks::Format getFormat() const { return RemarkFormat; }
   /// Set a pass filter based on a regex \p Filter.
   /// Returns an error if the regex is invalid.
   Error setFilter(StringRef Filter);
@@ -30,8 +30,14 @@ using AddBufferFn =
 /// Create a local file system cache which uses the given cache directory and
 /// file callback. This function also creates the cache directory if it does not
 /// already exist.
+///
+/// If \p Sharded is true, the entries are stored in subdirectories named after
+/// the first two characters of their keys, which keeps the directories small
+/// when the cache is shared by many machines, for instance over NFS. Either
+/// way, an entry is committed by renaming a temporary file of its directory.
 Expected<NativeObjectCache> localCache(StringRef CacheDirectoryPath,
-                                       AddBufferFn AddBuffer);
+                                       AddBufferFn AddBuffer,
+                                       bool Sharded = false);
 
 } // namespace lto
 } // namespace llvm
@@ -246,6 +246,20 @@ ThinBackend createWriteIndexesThinBackend(std::string OldPrefix,
                                           raw_fd_ostream *LinkedObjectsFile,
                                           IndexWriteCallback OnWrite);
 
+/// Runs the backend job of a module out of process, for instance on a remote
+/// machine: it compiles the bitcode file \p ModulePath with the individual
+/// summary index \p IndexPath into the native object file \p OutputPath, as
+/// clang -fthinlto-index does. It is called from several threads at once.
+using DistributedBackendFn = std::function<Error(
+    StringRef ModulePath, StringRef IndexPath, StringRef OutputPath)>;
+
+/// This ThinBackend writes each module and its individual index to temporary
+/// files and hands them to \p RunJob, at most \p ParallelismLevel at a time
+/// and largest modules first. The objects are looked up in and added to the
+/// cache of the link like the ones of the in-process backend.
+ThinBackend createDistributedThinBackend(unsigned ParallelismLevel,
+                                         DistributedBackendFn RunJob);
+
 /// This class implements a resolution-based interface to LLVM's LTO
 /// functionality. It supports regular LTO, parallel LTO code generation and
 /// ThinLTO. You can use it from a linker in the following way:
@@ -10,6 +10,7 @@
 #define LLVM_LINKER_IRMOVER_H
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include <functional>
 
@@ -51,12 +52,20 @@ public:
     // The set of identified but non opaque structures in the composite module.
     DenseSet<StructType *, StructTypeKeyInfo> NonOpaqueStructTypes;
 
+    // Whether each type seen so far is free of identified structures. It is
+    // shared by all the source modules since such types are uniqued by the
+    // context.
+    DenseMap<Type *, bool> ContainsNoIdentifiedStruct;
+
   public:
     void addNonOpaque(StructType *Ty);
     void switchToNonOpaque(StructType *Ty);
     void addOpaque(StructType *Ty);
     StructType *findNonOpaque(ArrayRef<Type *> ETypes, bool IsPacked);
     bool hasType(StructType *Ty);
+    /// Returns true if Ty is made of uniqued types only, so that it maps to
+    /// itself whatever the source module.
+    bool mapsToItself(Type *Ty);
   };
 
   IRMover(Module &M);
@@ -184,6 +184,12 @@ private:
 
   /// Perform one layout iteration and return true if any offsets
   /// were adjusted.
+  ///
+  /// The sections are relaxed one after the other: relaxing a fragment
+  /// evaluates its fixups against the layout of the sections of the symbols
+  /// they refer to, which MCAsmLayout computes lazily, and the relaxed
+  /// instructions are encoded by the shared MCCodeEmitter and may allocate in
+  /// the MCContext, none of which may be used from several threads.
   bool layoutOnce(MCAsmLayout &Layout);
 
   /// Perform one layout iteration of the given section and return true
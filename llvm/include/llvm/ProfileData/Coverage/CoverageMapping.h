@@ -510,6 +510,9 @@ class CoverageMapping {
   std::vector<FunctionRecord> Functions;
   std::vector<std::pair<std::string, uint64_t>> FuncHashMismatches;
 
+  /// If not empty, the files whose functions are loaded.
+  StringSet<> SourceFiles;
+
   CoverageMapping() = default;
 
   /// Add a function record corresponding to \p Record.
@@ -520,16 +523,21 @@ public:
   CoverageMapping(const CoverageMapping &) = delete;
   CoverageMapping &operator=(const CoverageMapping &) = delete;
 
-  /// Load the coverage mapping using the given readers.
+  /// Load the coverage mapping using the given readers. If \p SourceFiles is
+  /// non-empty, only the functions with code in one of these files are kept,
+  /// which saves the memory of the others when only a few files are shown.
   static Expected<std::unique_ptr<CoverageMapping>>
   load(ArrayRef<std::unique_ptr<CoverageMappingReader>> CoverageReaders,
-       IndexedInstrProfReader &ProfileReader);
+       IndexedInstrProfReader &ProfileReader,
+       ArrayRef<StringRef> SourceFiles = None);
 
   /// Load the coverage mapping from the given object files and profile. If
   /// \p Arches is non-empty, it must specify an architecture for each object.
+  /// \p SourceFiles is as for the other overload.
   static Expected<std::unique_ptr<CoverageMapping>>
   load(ArrayRef<StringRef> ObjectFilenames, StringRef ProfileFilename,
-       ArrayRef<StringRef> Arches = None);
+       ArrayRef<StringRef> Arches = None,
+       ArrayRef<StringRef> SourceFiles = None);
 
   /// The number of functions that couldn't have their profiles mapped.
   ///
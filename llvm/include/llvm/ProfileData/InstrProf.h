@@ -78,6 +78,12 @@ inline StringRef getInstrProfValueRangeProfFuncName() {
   return INSTR_PROF_VALUE_RANGE_PROF_FUNC_STR;
 }
 
+/// Return the name of the profile runtime entry point that allocates the
+/// calling thread's shard of the counters and returns its bias.
+inline StringRef getInstrProfCounterShardFuncName() {
+  return INSTR_PROF_COUNTER_SHARD_FUNC_STR;
+}
+
 /// Return the name prefix of variables containing instrumented function names.
 inline StringRef getInstrProfNameVarPrefix() { return "__profn_"; }
 
@@ -151,6 +157,26 @@ inline StringRef getInstrProfRuntimeHookVarName() {
   return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_RUNTIME_VAR);
 }
 
+/// Return the name of the variable holding the bias that is added to counter
+/// addresses when runtime counter relocation is enabled. The profile runtime
+/// sets it to move the counters into a mapping of the profile file.
+inline StringRef getInstrProfCounterBiasVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_BIAS_VAR);
+}
+
+/// Return the name of the thread-local countdown that decides which function
+/// invocations update the counters when sampled instrumentation is enabled.
+inline StringRef getInstrProfSamplingVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_SAMPLING_VAR);
+}
+
+/// Return the name of the thread-local bias that is added to counter addresses
+/// when counter updates are sharded, so that each thread updates its own copy
+/// of the counters. The profile runtime defines it.
+inline StringRef getInstrProfCounterShardVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_SHARD_VAR);
+}
+
 /// Return the name of the compiler generated function that references the
 /// runtime hook variable. The function is a weak global.
 inline StringRef getInstrProfRuntimeHookVarUseFuncName() {
@@ -0,0 +1,73 @@
+//===-- BinaryRemarkSerializer.h - Binary remark format ---------*- C++/-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file provides a serializer for the binary remark format.
+//
+// A file of binary remarks starts with BinaryMagic and the version of the
+// format as a ULEB128, followed by the remarks, one after the other:
+//
+//   Type:         ULEB128 value of remarks::Type
+//   PassName:     string
+//   RemarkName:   string
+//   FunctionName: string
+//   Flags:        byte, BinaryHasLoc | BinaryHasHotness
+//   Loc:          string file, ULEB128 line, ULEB128 column, if BinaryHasLoc
+//   Hotness:      ULEB128, if BinaryHasHotness
+//   NumArgs:      ULEB128, followed by the arguments
+//
+// and each argument is a key string, a value string, a flags byte and a
+// location if the flags have BinaryHasLoc.
+//
+// The strings are deduplicated: each string is written as the ULEB128 ID of
+// the string. The first use of a string has the next unused ID, and this ID is
+// followed by the ULEB128 length and the bytes of the string. The file is
+// written and read in a single pass, and the parser refers to the strings in
+// place.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_REMARKS_BINARY_REMARK_SERIALIZER_H
+#define LLVM_REMARKS_BINARY_REMARK_SERIALIZER_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkStringTable.h"
+
+namespace llvm {
+
+class raw_ostream;
+
+namespace remarks {
+
+constexpr StringRef BinaryMagic("RMRKBIN", 7);
+constexpr uint64_t BinaryVersion = 0;
+
+/// The flags of a remark or of an argument.
+enum : uint8_t { BinaryHasLoc = 1 << 0, BinaryHasHotness = 1 << 1 };
+
+/// Serializes remarks to a stream in the binary format, as they are emitted.
+struct BinarySerializer {
+  /// The stream the remarks are written to.
+  raw_ostream &OS;
+  /// The strings written so far, by ID.
+  StringTable StrTab;
+
+  /// Write the header of the format to \p OS.
+  BinarySerializer(raw_ostream &OS);
+  /// Write \p Remark and the strings seen for the first time.
+  void emit(const Remark &Remark);
+
+private:
+  void emitString(StringRef Str);
+  void emitLoc(const RemarkLocation &Loc);
+};
+
+} // end namespace remarks
+} // end namespace llvm
+
+#endif /* LLVM_REMARKS_BINARY_REMARK_SERIALIZER_H */
@@ -30,7 +30,8 @@ struct Parser {
   std::unique_ptr<ParserImpl> Impl;
 
   /// Create a parser parsing \p Buffer to Remark objects.
-  /// This constructor should be only used for parsing YAML remarks.
+  /// The remarks are parsed from the binary format if \p Buffer starts with
+  /// remarks::BinaryMagic, from YAML otherwise.
   Parser(StringRef Buffer);
 
   /// Create a parser parsing \p Buffer to Remark objects, using \p StrTabBuf as
@@ -38,6 +39,9 @@ struct Parser {
   /// This constructor should be only used for parsing YAML remarks.
   Parser(StringRef Buffer, StringRef StrTabBuf);
 
+  /// Create a parser using the implementation \p Impl.
+  explicit Parser(std::unique_ptr<ParserImpl> Impl);
+
   // Needed because ParserImpl is an incomplete type.
   ~Parser();
 
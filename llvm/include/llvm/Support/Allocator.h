@@ -112,6 +112,34 @@ public:
   void PrintStats() const {}
 };
 
+/// MappedMemoryAllocator - Allocates whole pages of memory mapped from the
+/// system, hinting huge pages for the allocations of 2 MB or more. It is meant
+/// to provide the slabs of a BumpPtrAllocatorImpl holding a lot of memory,
+/// whose accesses would otherwise miss the TLB a lot.
+class MappedMemoryAllocator : public AllocatorBase<MappedMemoryAllocator> {
+  bool HugePages;
+
+public:
+  explicit MappedMemoryAllocator(bool HugePages = true)
+      : HugePages(HugePages) {}
+
+  void Reset() {}
+
+  /// The allocations are page aligned, \p Alignment must be at most the page
+  /// size.
+  LLVM_ATTRIBUTE_RETURNS_NONNULL void *Allocate(size_t Size, size_t Alignment);
+
+  // Pull in base class overloads.
+  using AllocatorBase<MappedMemoryAllocator>::Allocate;
+
+  void Deallocate(const void *Ptr, size_t Size);
+
+  // Pull in base class overloads.
+  using AllocatorBase<MappedMemoryAllocator>::Deallocate;
+
+  void PrintStats() const {}
+};
+
 namespace detail {
 
 // We call out to an external function to actually print the message as the
@@ -433,6 +461,11 @@ private:
 /// parameters.
 typedef BumpPtrAllocatorImpl<> BumpPtrAllocator;
 
+/// A BumpPtrAllocator with slabs of 2 MB of mapped memory, backed by huge
+/// pages where the system provides them.
+typedef BumpPtrAllocatorImpl<MappedMemoryAllocator, 2 * 1024 * 1024>
+    MappedBumpPtrAllocator;
+
 /// A BumpPtrAllocator that allows only elements of a specific type to be
 /// allocated.
 ///
@@ -352,7 +352,9 @@ protected:
 public:
   virtual ~Option() = default;
 
-  // addArgument - Register this argument with the commandline system.
+  // addArgument - Register this argument with the commandline system. The
+  // option is only added to its subcommands the first time the parser needs
+  // them, e.g. when the command line is parsed.
   //
   void addArgument();
 
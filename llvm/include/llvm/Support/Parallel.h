@@ -41,6 +41,11 @@ struct is_execution_policy
 constexpr sequential_execution_policy seq{};
 constexpr parallel_execution_policy par{};
 
+/// The number of threads running the parallel algorithms, the number of
+/// hardware threads if 0. It is read when the first parallel algorithm
+/// starts, so it must be set before that. It is ignored with ConcRT.
+extern unsigned ThreadCount;
+
 namespace detail {
 
 #if LLVM_ENABLE_THREADS
@@ -69,6 +74,11 @@ public:
     std::unique_lock<std::mutex> lock(Mutex);
     Cond.wait(lock, [&] { return Count == 0; });
   }
+
+  bool isReady() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
+  }
 };
 
 class TaskGroup {
@@ -81,7 +91,9 @@ public:
 
   void spawn(std::function<void()> f);
 
-  void sync() const { L.sync(); }
+  /// Waits for the spawned tasks, running pending tasks meanwhile if the
+  /// executor allows it, so that nested groups can run in parallel.
+  void sync() const;
 };
 
 #if defined(_MSC_VER)
@@ -69,6 +69,11 @@ public:
   /// allocated space.
   static size_t GetMallocUsage();
 
+  /// Return the resident set size of the process, the amount of its memory
+  /// currently in physical memory, or 0 if it can't be determined on this
+  /// platform.
+  static size_t GetResidentMemoryUsage();
+
   /// This static function will set \p user_time to the amount of CPU time
   /// spent in user (non-kernel) mode and \p sys_time to the amount of CPU
   /// time spent in system (kernel) mode.  If the operating system does not
@@ -123,8 +123,17 @@ protected:
 
   private:
     StringMap<unsigned> Strings;
+    // The globs which end with their only '*', by their literal prefix, and
+    // the sorted lengths of these prefixes.
+    StringMap<unsigned> Prefixes;
+    std::vector<size_t> PrefixLengths;
     TrigramIndex Trigrams;
+    // The other globs that only use '*' are matched without a Regex.
+    std::vector<std::pair<std::string, unsigned>> Globs;
     std::vector<std::pair<std::unique_ptr<Regex>, unsigned>> RegExes;
+    // The regexes too complex for the trigram index, which would defeat it
+    // for all the other rules.
+    std::vector<std::pair<std::unique_ptr<Regex>, unsigned>> UnindexedRegExes;
   };
 
   using SectionEntries = StringMap<StringMap<Matcher>>;
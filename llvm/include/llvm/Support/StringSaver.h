@@ -13,6 +13,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Allocator.h"
+#include <memory>
 
 namespace llvm {
 
@@ -53,5 +54,27 @@ public:
   StringRef save(const std::string &S) { return save(StringRef(S)); }
 };
 
+/// Saves strings in its own stable storage and returns a StringRef with a
+/// stable character pointer. Saving the same string yields the same StringRef,
+/// also when the strings are saved from several threads at the same time.
+///
+/// Compared to UniqueStringSaver, it is thread-safe: the strings are in shards
+/// picked by their hash, each with its own storage and lock, and the strings
+/// already saved are found without taking the lock.
+class ConcurrentUniqueStringSaver final {
+  struct Shard;
+  std::unique_ptr<Shard[]> Shards;
+
+public:
+  ConcurrentUniqueStringSaver();
+  ~ConcurrentUniqueStringSaver();
+
+  // All returned strings are null-terminated: *save(S).end() == 0.
+  StringRef save(const char *S) { return save(StringRef(S)); }
+  StringRef save(StringRef S);
+  StringRef save(const Twine &S) { return save(StringRef(S.str())); }
+  StringRef save(const std::string &S) { return save(StringRef(S)); }
+};
+
 }
 #endif
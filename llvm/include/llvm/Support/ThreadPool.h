@@ -13,6 +13,7 @@
 #ifndef LLVM_SUPPORT_THREAD_POOL_H
 #define LLVM_SUPPORT_THREAD_POOL_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/thread.h"
 
@@ -20,19 +21,24 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <queue>
 #include <utility>
+#include <vector>
 
 namespace llvm {
 
+class ThreadPoolTaskGroup;
+
 /// A ThreadPool for asynchronous parallel execution on a defined number of
 /// threads.
 ///
 /// The pool keeps a vector of threads alive, waiting on a condition variable
-/// for some work to become available.
+/// for some work to become available. The queued tasks are run by decreasing
+/// priority, the tasks of the same priority in submission order.
 class ThreadPool {
 public:
   using TaskTy = std::function<void()>;
@@ -54,47 +60,164 @@ public:
   inline std::shared_future<void> async(Function &&F, Args &&... ArgList) {
     auto Task =
         std::bind(std::forward<Function>(F), std::forward<Args>(ArgList)...);
-    return asyncImpl(std::move(Task));
+    return asyncImpl(std::move(Task), nullptr, 0);
   }
 
   /// Asynchronous submission of a task to the pool. The returned future can be
   /// used to wait for the task to finish and is *non-blocking* on destruction.
   template <typename Function>
   inline std::shared_future<void> async(Function &&F) {
-    return asyncImpl(std::forward<Function>(F));
+    return asyncImpl(std::forward<Function>(F), nullptr, 0);
+  }
+
+  /// Same as async() but the task is started before the queued tasks of lower
+  /// \p Priority, async() submits tasks of priority 0.
+  template <typename Function, typename... Args>
+  inline std::shared_future<void>
+  asyncWithPriority(uint64_t Priority, Function &&F, Args &&... ArgList) {
+    auto Task =
+        std::bind(std::forward<Function>(F), std::forward<Args>(ArgList)...);
+    return asyncImpl(std::move(Task), nullptr, Priority);
+  }
+
+  /// Same as async() but the task is started before the queued tasks of lower
+  /// \p Priority, async() submits tasks of priority 0.
+  template <typename Function>
+  inline std::shared_future<void> asyncWithPriority(uint64_t Priority,
+                                                    Function &&F) {
+    return asyncImpl(std::forward<Function>(F), nullptr, Priority);
   }
 
   /// Blocking wait for all the threads to complete and the queue to be empty.
   /// It is an error to try to add new tasks while blocking on this call.
   void wait();
 
+  /// Blocking wait for the tasks of \p Group to complete. When called from a
+  /// task of the pool, the calling thread runs the queued tasks meanwhile, so
+  /// that it doesn't deadlock waiting for tasks that no thread is free to run.
+  void wait(ThreadPoolTaskGroup &Group);
+
+  /// Removes the tasks not started yet from the queue, their futures are made
+  /// ready with a std::future_error. Returns the number of removed tasks.
+  /// Without LLVM_ENABLE_THREADS, a cancelled task still runs if its future is
+  /// waited for.
+  size_t cancel();
+
+  /// Same as cancel() for the tasks of \p Group only.
+  size_t cancel(ThreadPoolTaskGroup &Group);
+
 private:
+  friend class ThreadPoolTaskGroup;
+
+  struct QueuedTask {
+    PackagedTaskTy Task;
+    /// The group of the task, nullptr if it is in none.
+    const ThreadPoolTaskGroup *Group;
+    uint64_t Priority;
+    /// Submission number, orders the tasks of the same priority.
+    uint64_t Seq;
+  };
+
+  /// Orders the queued tasks so that the task to run next is on top of the
+  /// heap.
+  static bool runsAfter(const QueuedTask &LHS, const QueuedTask &RHS) {
+    if (LHS.Priority != RHS.Priority)
+      return LHS.Priority < RHS.Priority;
+    return LHS.Seq > RHS.Seq;
+  }
+
+  /// Removes the task to run next from the queue, which must not be empty.
+  /// Must be called with QueueLock held.
+  QueuedTask popTask();
+
+  /// Accounts for the completion of a task of \p Group, which may be nullptr.
+  /// Must be called with QueueLock held. Returns true if it was the last task
+  /// of the group.
+  bool completeTask(const ThreadPoolTaskGroup *Group);
+
   /// Asynchronous submission of a task to the pool. The returned future can be
   /// used to wait for the task to finish and is *non-blocking* on destruction.
-  std::shared_future<void> asyncImpl(TaskTy F);
+  std::shared_future<void> asyncImpl(TaskTy F,
+                                     const ThreadPoolTaskGroup *Group,
+                                     uint64_t Priority);
+
+  /// Removes the queued tasks of \p Group, or all of them if it is nullptr.
+  size_t cancelImpl(const ThreadPoolTaskGroup *Group);
+
+#if LLVM_ENABLE_THREADS
+  /// Runs the queued tasks on the calling thread until the pool is destroyed
+  /// or, if \p WaitingForGroup is not null, until the tasks of that group are
+  /// all complete.
+  void processTasks(const ThreadPoolTaskGroup *WaitingForGroup);
+
+  /// Returns true if the calling thread is one of the threads of the pool.
+  bool isWorkerThread() const;
+#endif
 
   /// Threads in flight
   std::vector<llvm::thread> Threads;
 
-  /// Tasks waiting for execution in the pool.
-  std::queue<PackagedTaskTy> Tasks;
+  /// Tasks waiting for execution in the pool, a heap with the task to run
+  /// next on top.
+  std::vector<QueuedTask> Tasks;
+
+  /// The number of tasks submitted so far.
+  uint64_t NextSeq = 0;
+
+  /// The number of queued and running tasks per group, the groups with none
+  /// are not in the map.
+  DenseMap<const ThreadPoolTaskGroup *, unsigned> GroupTasks;
 
-  /// Locking and signaling for accessing the Tasks queue.
+  /// Locking and signaling for accessing the Tasks queue. The queue, the state
+  /// of the groups and ActiveThreads are guarded by QueueLock.
   std::mutex QueueLock;
   std::condition_variable QueueCondition;
 
-  /// Locking and signaling for job completion
-  std::mutex CompletionLock;
+  /// Signaling for job completion
   std::condition_variable CompletionCondition;
 
   /// Keep track of the number of thread actually busy
-  std::atomic<unsigned> ActiveThreads;
+  unsigned ActiveThreads;
 
 #if LLVM_ENABLE_THREADS // avoids warning for unused variable
   /// Signal for the destruction of the pool, asking thread to exit.
   bool EnableFlag;
 #endif
 };
+
+/// A group of tasks of a ThreadPool, which can be waited for or cancelled
+/// independently of the other tasks of the pool.
+class ThreadPoolTaskGroup {
+public:
+  /// The group submits its tasks to \p Pool.
+  explicit ThreadPoolTaskGroup(ThreadPool &Pool) : Pool(Pool) {}
+
+  /// Blocking destructor: waits for the tasks of the group to complete.
+  ~ThreadPoolTaskGroup() { wait(); }
+
+  /// Same as ThreadPool::async() with the task in the group.
+  template <typename Function>
+  inline std::shared_future<void> async(Function &&F) {
+    return Pool.asyncImpl(std::forward<Function>(F), this, 0);
+  }
+
+  /// Same as ThreadPool::asyncWithPriority() with the task in the group.
+  template <typename Function>
+  inline std::shared_future<void> asyncWithPriority(uint64_t Priority,
+                                                    Function &&F) {
+    return Pool.asyncImpl(std::forward<Function>(F), this, Priority);
+  }
+
+  /// Blocking wait for the tasks of the group to complete.
+  void wait() { Pool.wait(*this); }
+
+  /// Removes the tasks of the group not started yet from the queue. Returns
+  /// the number of removed tasks.
+  size_t cancel() { return Pool.cancel(*this); }
+
+private:
+  ThreadPool &Pool;
+};
 }
 
 #endif // LLVM_SUPPORT_THREAD_POOL_H
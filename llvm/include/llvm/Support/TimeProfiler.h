@@ -32,12 +32,16 @@ inline bool timeTraceProfilerEnabled() {
 /// Write profiling data to output file.
 /// Data produced is JSON, in Chrome "Trace Event" format, see
 /// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
+/// The sections of every thread are in a lane of their own, together with
+/// counters of the memory usage and of the statistics sampled along the way.
+/// The other threads must have ended their sections.
 void timeTraceProfilerWrite(raw_pwrite_stream &OS);
 
 /// Manually begin a time section, with the given \p Name and \p Detail.
 /// Profiler copies the string data, so the pointers can be given into
 /// temporaries. Time sections can be hierarchical; every Begin must have a
-/// matching End pair but they can nest.
+/// matching End pair on the same thread but they can nest. Several threads
+/// can trace their sections at the same time.
 void timeTraceProfilerBegin(StringRef Name, StringRef Detail);
 void timeTraceProfilerBegin(StringRef Name,
                             llvm::function_ref<std::string()> Detail);
@@ -0,0 +1,42 @@
+//===- llvm/Support/TreeHash.h - Parallel hashing of large data -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the tree hashes of data: the data is split in chunks
+// hashed in parallel, and the hash of the data is the hash of the hashes of the
+// chunks. The tree hash of some data differs from its plain hash.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_TREEHASH_H
+#define LLVM_SUPPORT_TREEHASH_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include <array>
+#include <cstdint>
+
+namespace llvm {
+
+/// Computes into \p Hash the tree hash of \p Data with \p HashFn, hashing the
+/// chunks of \p ChunkSize bytes in parallel if \p Parallel. \p HashFn writes
+/// Hash.size() bytes of hash of a chunk of data to \p Dest.
+void treeHash(MutableArrayRef<uint8_t> Hash, ArrayRef<uint8_t> Data,
+              function_ref<void(uint8_t *Dest, ArrayRef<uint8_t> Chunk)> HashFn,
+              bool Parallel = true, size_t ChunkSize = 1024 * 1024);
+
+/// The tree hashes of \p Data with the hash functions of Support, by chunks of
+/// 1 MB. The xxHash64 of the chunks are concatenated in little endian.
+uint64_t treeHashXXHash64(ArrayRef<uint8_t> Data, bool Parallel = true);
+std::array<uint8_t, 16> treeHashMD5(ArrayRef<uint8_t> Data,
+                                    bool Parallel = true);
+std::array<uint8_t, 20> treeHashSHA1(ArrayRef<uint8_t> Data,
+                                     bool Parallel = true);
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_TREEHASH_H
@@ -45,6 +45,10 @@ class TrigramIndex {
   /// that matches the query. Returns false, if it's not sure.
   bool isDefinitelyOut(StringRef Query) const;
 
+  /// Returns false if Regex uses features the index can't handle, so that
+  /// inserting it would defeat the index.
+  static bool canIndex(StringRef Regex);
+
   /// Returned true, iff the heuristic is defeated and not useful.
   /// In this case isDefinitelyOut always returns false.
   bool isDefeated() { return Defeated; }
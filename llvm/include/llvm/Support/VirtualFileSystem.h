@@ -18,6 +18,7 @@
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Chrono.h"
@@ -29,6 +30,7 @@
 #include <cstdint>
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <stack>
 #include <string>
 #include <system_error>
@@ -395,6 +397,38 @@ private:
   virtual void anchor();
 };
 
+/// A file system that caches the results of status queries on another file
+/// system.
+///
+/// Both the successful lookups and the ones that failed because the file
+/// does not exist are cached, so a file which is known to be missing is not
+/// opened either. The cache is keyed by absolute path and is safe to use from
+/// several threads, so one instance can be shared by all the compiler
+/// instances of a process. Changes to the underlying file system are not
+/// noticed until the affected entries are invalidated.
+class CachingFileSystem : public ProxyFileSystem {
+public:
+  explicit CachingFileSystem(IntrusiveRefCntPtr<FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  llvm::ErrorOr<Status> status(const Twine &Path) override;
+  llvm::ErrorOr<std::unique_ptr<File>>
+  openFileForRead(const Twine &Path) override;
+
+  /// Forgets the cached status of \p Path.
+  void invalidate(const Twine &Path);
+  /// Forgets all the cached statuses.
+  void invalidateAll();
+
+private:
+  /// Returns the cache key of \p Path, or false if it has none.
+  bool getCacheKey(const Twine &Path, SmallVectorImpl<char> &Key) const;
+
+  /// The cached statuses, None for files that do not exist.
+  StringMap<Optional<Status>> Cache;
+  mutable std::mutex CacheMutex;
+};
+
 namespace detail {
 
 class InMemoryDirectory;
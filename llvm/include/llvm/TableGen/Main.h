@@ -13,6 +13,8 @@
 #ifndef LLVM_TABLEGEN_MAIN_H
 #define LLVM_TABLEGEN_MAIN_H
 
+#include "llvm/ADT/StringRef.h"
+
 namespace llvm {
 
 class raw_ostream;
@@ -24,6 +26,12 @@ using TableGenMainFn = bool (raw_ostream &OS, RecordKeeper &Records);
 
 int TableGenMain(char *argv0, TableGenMainFn *MainFn);
 
+/// Write Contents to Filename, unless the file already holds exactly these
+/// contents, so that the files which depend on it aren't rebuilt.
+/// Returns true on error, false otherwise.
+bool writeFileIfChanged(const char *argv0, StringRef Filename,
+                        StringRef Contents);
+
 } // end namespace llvm
 
 #endif // LLVM_TABLEGEN_MAIN_H
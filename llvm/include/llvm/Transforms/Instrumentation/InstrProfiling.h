@@ -56,6 +56,7 @@ private:
     }
   };
   DenseMap<GlobalVariable *, PerFunctionProfileData> ProfileDataMap;
+  DenseMap<const Function *, Instruction *> FunctionToProfileBiasMap;
   std::vector<GlobalValue *> UsedVars;
   std::vector<GlobalVariable *> ReferencedNames;
   GlobalVariable *NamesVar;
@@ -87,12 +88,38 @@ private:
   /// Count the number of instrumented value sites for the function.
   void computeNumValueSiteCounts(InstrProfValueProfileInst *Ins);
 
+  /// Make only one in every sampling period invocations of \p F update its
+  /// counters, by switching on entry between its instrumented body and a copy
+  /// of it without the profiling intrinsics. Returns true if \p F changed.
+  bool sampleFunction(Function &F);
+
+  /// Get the thread-local countdown to the next sampled function invocation,
+  /// creating it if necessary.
+  GlobalVariable *getOrCreateSamplingCountdown();
+
+  /// Record the sampling period in the profile version variable, from which
+  /// the profile readers scale the counts back up.
+  void emitSamplingPeriod();
+
   /// Replace instrprof_value_profile with a call to runtime library.
   void lowerValueProfileInst(InstrProfValueProfileInst *Ins);
 
   /// Replace instrprof_increment with an increment of the appropriate value.
   void lowerIncrement(InstrProfIncrementInst *Inc);
 
+  /// Compute the address of the counter value that this profiling instruction
+  /// acts on, biased when runtime counter relocation or sharded counter
+  /// updates are enabled.
+  Value *getCounterAddress(InstrProfIncrementInst *Inc);
+
+  /// Compute the bias to the calling thread's shard of the counters on entry
+  /// to \p F, asking the runtime for a shard if the thread has none yet.
+  PHINode *getCounterShardBias(Function *F);
+
+  /// Get the variable holding the runtime counter relocation bias, creating
+  /// it if necessary.
+  GlobalVariable *getOrCreateCounterBias();
+
   /// Force emitting of name vars for unused functions.
   void lowerCoverageData(GlobalVariable *CoverageNamesVar);
 
@@ -145,6 +145,9 @@ STATISTIC(NumTripCountsNotComputed,
           "Number of loops without predictable loop counts");
 STATISTIC(NumBruteForceTripCountsComputed,
           "Number of loops with trip counts computed by force");
+STATISTIC(NumSCEVExpressions, "Number of unique SCEV expressions created");
+STATISTIC(NumUnknownsOverExpressionLimit,
+          "Number of values left unanalyzed by the expression limit");
 
 static cl::opt<unsigned>
 MaxBruteForceIterations("scalar-evolution-max-iterations", cl::ReallyHidden,
@@ -216,6 +219,12 @@ static cl::opt<unsigned>
                   cl::desc("Size of the expression which is considered huge"),
                   cl::init(4096));
 
+static cl::opt<unsigned> MaxSCEVExpressions(
+    "scalar-evolution-max-expressions", cl::Hidden,
+    cl::desc("Maximum number of unique expressions per function past which "
+             "new instructions are left unanalyzed (0 = no limit)"),
+    cl::init(0));
+
 //===----------------------------------------------------------------------===//
 //                           SCEV class definitions
 //===----------------------------------------------------------------------===//
@@ -3897,7 +3906,16 @@ const SCEV *ScalarEvolution::getSCEV(Value *V) {
 
   const SCEV *S = getExistingSCEV(V);
   if (S == nullptr) {
-    S = createSCEV(V);
+    ++NumSCEVCacheMisses;
+    // Past the expression limit, describe new instructions as unknowns rather
+    // than analyzing them: this is always correct, merely imprecise, and bounds
+    // the memory and time spent on functions with thousands of recurrences.
+    if (MaxSCEVExpressions && UniqueSCEVs.size() >= MaxSCEVExpressions &&
+        isa<Instruction>(V)) {
+      ++NumUnknownsOverExpressionLimit;
+      S = getUnknown(V);
+    } else
+      S = createSCEV(V);
     // During PHI resolution, it is possible to create two SCEVs for the same
     // V, so it is needed to double check whether V->S is inserted into
     // ValueExprMap before insert S->{V, 0} into ExprValueMap.
@@ -3920,7 +3938,8 @@ const SCEV *ScalarEvolution::getSCEV(Value *V) {
           !isa<GetElementPtrInst>(V))
         ExprValueMap[Stripped].insert({V, Offset});
     }
-  }
+  } else
+    ++NumSCEVCacheHits;
   return S;
 }
 
@@ -11340,11 +11359,21 @@ ScalarEvolution::ScalarEvolution(ScalarEvolution &&Arg)
       SCEVAllocator(std::move(Arg.SCEVAllocator)),
       LoopUsers(std::move(Arg.LoopUsers)),
       PredicatedSCEVRewrites(std::move(Arg.PredicatedSCEVRewrites)),
-      FirstUnknown(Arg.FirstUnknown) {
+      FirstUnknown(Arg.FirstUnknown), NumSCEVCacheHits(Arg.NumSCEVCacheHits),
+      NumSCEVCacheMisses(Arg.NumSCEVCacheMisses) {
   Arg.FirstUnknown = nullptr;
+  Arg.NumSCEVCacheHits = Arg.NumSCEVCacheMisses = 0;
 }
 
 ScalarEvolution::~ScalarEvolution() {
+  if (NumSCEVCacheHits || NumSCEVCacheMisses) {
+    NumSCEVExpressions += UniqueSCEVs.size();
+    LLVM_DEBUG(dbgs() << "SCEV: " << F.getName() << ": " << UniqueSCEVs.size()
+                      << " expressions, " << NumSCEVCacheHits << " of "
+                      << NumSCEVCacheHits + NumSCEVCacheMisses
+                      << " getSCEV queries cached\n");
+  }
+
   // Iterate through all the SCEVUnknown instances and call their
   // destructors, so that they release their references to their values.
   for (SCEVUnknown *U = FirstUnknown; U;) {
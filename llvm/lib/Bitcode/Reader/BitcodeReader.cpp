@@ -70,6 +70,7 @@
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -92,12 +93,83 @@ static cl::opt<bool> PrintSummaryGUIDs(
     cl::desc(
         "Print the global id for each value when reading the module summary"));
 
+static cl::opt<bool> ParallelFunctionDecode(
+    "bitcode-parallel-function-decode", cl::init(false), cl::Hidden,
+    cl::desc("Decode the records of function blocks on several threads ahead "
+             "of materializing the functions"));
+
 namespace {
 
 enum {
   SWITCH_INST_MAGIC = 0x4B5 // May 2012 => 1205 => Hex
 };
 
+/// The number of function blocks decoded together by the parallel decoding.
+const unsigned FunctionDecodeBatchSize = 128;
+
+/// The records of a function block decoded ahead of its parsing. The cursor
+/// used for the decoding is independent of the reader's one, so that the
+/// blocks of several functions are decoded in parallel. The nested blocks are
+/// not decoded, only their positions are saved and they are read from the
+/// stream while the body is parsed, as these build constants and metadata.
+struct DecodedFunctionBlock {
+  struct Entry {
+    /// The code of a record, or the ID of a nested block.
+    unsigned Code;
+    bool IsSubBlock;
+    /// The bit after the ID of a nested block.
+    uint64_t SubBlockBit;
+    /// The operands of a record in Operands.
+    unsigned OperandsBegin, OperandsEnd;
+  };
+
+  std::vector<Entry> Entries;
+  std::vector<uint64_t> Operands;
+  /// The bit of the end of the block, possibly before abbreviations.
+  uint64_t EndBit = 0;
+};
+
+/// Decode the records of the function block at \p Bit of \p Stream, or
+/// return null when the block is malformed. In that case, the block is
+/// parsed from the stream, which reports the error.
+std::unique_ptr<DecodedFunctionBlock>
+decodeFunctionBlock(const BitstreamCursor &Stream, uint64_t Bit) {
+  BitstreamCursor Cursor(Stream);
+  Cursor.JumpToBit(Bit);
+  if (Cursor.EnterSubBlock(bitc::FUNCTION_BLOCK_ID))
+    return nullptr;
+
+  auto Decoded = llvm::make_unique<DecodedFunctionBlock>();
+  SmallVector<uint64_t, 64> Record;
+  while (true) {
+    uint64_t EntryBit = Cursor.GetCurrentBitNo();
+    BitstreamEntry Entry = Cursor.advance();
+    switch (Entry.Kind) {
+    case BitstreamEntry::Error:
+      return nullptr;
+    case BitstreamEntry::EndBlock:
+      Decoded->EndBit = EntryBit;
+      return Decoded;
+    case BitstreamEntry::SubBlock:
+      Decoded->Entries.push_back(
+          {Entry.ID, true, Cursor.GetCurrentBitNo(), 0, 0});
+      if (Cursor.SkipBlock())
+        return nullptr;
+      continue;
+    case BitstreamEntry::Record:
+      break;
+    }
+
+    Record.clear();
+    unsigned Code = Cursor.readRecord(Entry.ID, Record);
+    unsigned Begin = Decoded->Operands.size();
+    Decoded->Operands.insert(Decoded->Operands.end(), Record.begin(),
+                             Record.end());
+    Decoded->Entries.push_back(
+        {Code, false, 0, Begin, unsigned(Decoded->Operands.size())});
+  }
+}
+
 } // end anonymous namespace
 
 static Error error(const Twine &Message) {
@@ -493,6 +565,11 @@ class BitcodeReader : public BitcodeReaderBase, public GVMaterializer {
   /// where to find deferred function body in the stream.
   DenseMap<Function*, uint64_t> DeferredFunctionInfo;
 
+  /// The function blocks decoded ahead of their parsing, when decoding them in
+  /// parallel.
+  DenseMap<Function *, std::unique_ptr<DecodedFunctionBlock>>
+      DecodedFunctionBlocks;
+
   /// When Metadata block is initially scanned when parsing the module, we may
   /// choose to defer parsing of the metadata. This vector contains info about
   /// which Metadata blocks are deferred.
@@ -671,6 +748,9 @@ private:
   Error rememberAndSkipMetadata();
   Error typeCheckLoadStoreInst(Type *ValType, Type *PtrType);
   Error parseFunctionBody(Function *F);
+  /// Decode the blocks of \p F and the next functions of the module to be
+  /// materialized in parallel.
+  void decodeFunctionBlocks(Function *F);
   Error globalCleanup();
   Error resolveGlobalAndIndirectSymbolInits();
   Error parseUseLists();
@@ -3454,11 +3534,34 @@ Error BitcodeReader::parseFunctionBody(Function *F) {
 
   std::vector<OperandBundleDef> OperandBundles;
 
+  // Read the records decoded ahead if any, otherwise from the stream.
+  std::unique_ptr<DecodedFunctionBlock> Decoded;
+  auto DFBI = DecodedFunctionBlocks.find(F);
+  if (DFBI != DecodedFunctionBlocks.end()) {
+    Decoded = std::move(DFBI->second);
+    DecodedFunctionBlocks.erase(DFBI);
+  }
+  unsigned NextDecoded = 0;
+  auto readEntry = [&]() {
+    if (!Decoded)
+      return Stream.advance();
+    if (NextDecoded == Decoded->Entries.size()) {
+      Stream.JumpToBit(Decoded->EndBit);
+      return Stream.advance();
+    }
+    const DecodedFunctionBlock::Entry &E = Decoded->Entries[NextDecoded];
+    if (!E.IsSubBlock)
+      return BitstreamEntry::getRecord(0);
+    ++NextDecoded;
+    Stream.JumpToBit(E.SubBlockBit);
+    return BitstreamEntry::getSubBlock(E.Code);
+  };
+
   // Read all the records.
   SmallVector<uint64_t, 64> Record;
 
   while (true) {
-    BitstreamEntry Entry = Stream.advance();
+    BitstreamEntry Entry = readEntry();
 
     switch (Entry.Kind) {
     case BitstreamEntry::Error:
@@ -3506,7 +3609,15 @@ Error BitcodeReader::parseFunctionBody(Function *F) {
     // Read a record.
     Record.clear();
     Instruction *I = nullptr;
-    unsigned BitCode = Stream.readRecord(Entry.ID, Record);
+    unsigned BitCode;
+    if (Decoded) {
+      const DecodedFunctionBlock::Entry &E = Decoded->Entries[NextDecoded++];
+      Record.append(Decoded->Operands.begin() + E.OperandsBegin,
+                    Decoded->Operands.begin() + E.OperandsEnd);
+      BitCode = E.Code;
+    } else {
+      BitCode = Stream.readRecord(Entry.ID, Record);
+    }
     switch (BitCode) {
     default: // Default behavior: reject
       return error("Invalid value");
@@ -4826,6 +4937,28 @@ Error BitcodeReader::findFunctionInStream(
   return Error::success();
 }
 
+void BitcodeReader::decodeFunctionBlocks(Function *F) {
+  // The functions are mostly materialized in the order of the module, decode
+  // the following ones whose bodies have been seen in the stream.
+  std::vector<std::pair<Function *, uint64_t>> Blocks;
+  for (auto I = F->getIterator(), E = TheModule->end();
+       I != E && Blocks.size() < FunctionDecodeBatchSize; ++I) {
+    if (!I->isMaterializable() || DecodedFunctionBlocks.count(&*I))
+      continue;
+    uint64_t Bit = DeferredFunctionInfo.lookup(&*I);
+    if (Bit)
+      Blocks.push_back({&*I, Bit});
+  }
+
+  std::vector<std::unique_ptr<DecodedFunctionBlock>> Decoded(Blocks.size());
+  parallel::for_each_n(parallel::par, size_t(0), Blocks.size(), [&](size_t I) {
+    Decoded[I] = decodeFunctionBlock(Stream, Blocks[I].second);
+  });
+  for (size_t I = 0, E = Blocks.size(); I != E; ++I)
+    if (Decoded[I])
+      DecodedFunctionBlocks[Blocks[I].first] = std::move(Decoded[I]);
+}
+
 SyncScope::ID BitcodeReader::getDecodedSyncScopeID(unsigned Val) {
   if (Val == SyncScope::SingleThread || Val == SyncScope::System)
     return SyncScope::ID(Val);
@@ -4856,6 +4989,9 @@ Error BitcodeReader::materialize(GlobalValue *GV) {
   if (Error Err = materializeMetadata())
     return Err;
 
+  if (ParallelFunctionDecode && !DecodedFunctionBlocks.count(F))
+    decodeFunctionBlocks(F);
+
   // Move the bit stream to the saved position of the deferred function body.
   Stream.JumpToBit(DFII->second);
 
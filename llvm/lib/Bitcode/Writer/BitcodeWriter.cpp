@@ -67,6 +67,7 @@
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TreeHash.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -92,6 +93,10 @@ cl::opt<bool> WriteRelBFToSummary(
 
 extern FunctionSummary::ForceSummaryHotnessType ForceSummaryEdgesCold;
 
+/// The module blocks larger than this are hashed by chunks of this size in
+/// parallel, the module hash then being their tree hash.
+static const size_t ModuleHashChunkSize = 1024 * 1024;
+
 namespace {
 
 /// These are manifest constants used by the bitcode writer. They do not need to
@@ -4087,8 +4092,13 @@ void ModuleBitcodeWriter::writeModuleHash(size_t BlockStartPos) {
   // MODULE_CODE_HASH: [5*i32]
   if (GenerateHash) {
     uint32_t Vals[5];
-    Hasher.update(ArrayRef<uint8_t>((const uint8_t *)&(Buffer)[BlockStartPos],
-                                    Buffer.size() - BlockStartPos));
+    ArrayRef<uint8_t> Block((const uint8_t *)&(Buffer)[BlockStartPos],
+                            Buffer.size() - BlockStartPos);
+    // The large modules are hashed by chunks in parallel.
+    if (Block.size() > ModuleHashChunkSize)
+      Hasher.update(treeHashSHA1(Block));
+    else
+      Hasher.update(Block);
     StringRef Hash = Hasher.result();
     for (int Pos = 0; Pos < 20; Pos += 4) {
       Vals[Pos / 4] = support::endian::read32be(Hash.data() + Pos);
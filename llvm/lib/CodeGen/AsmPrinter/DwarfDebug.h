@@ -307,6 +307,13 @@ class DwarfDebug : public DebugHandlerBase {
   StringRef CompilationDir;
 
   /// Holder for the file specific debug information.
+  ///
+  /// The DIE trees of the units are kept until endModule instead of being
+  /// emitted as each function completes: later functions still add children
+  /// to the DIEs of earlier ones (member declarations of types, abstract
+  /// variables and labels of inlined subprograms), and the offsets of the DIEs
+  /// and the numbers of their abbreviations are only known once the whole unit
+  /// is sized in computeSizeAndOffsets.
   DwarfFile InfoHolder;
 
   /// Holders for the various debug information flags that we might need to
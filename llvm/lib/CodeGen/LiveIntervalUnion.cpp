@@ -124,8 +124,12 @@ collectInterferingVRegs(unsigned MaxInterferingRegs) {
   if (!CheckedFirstInterference) {
     CheckedFirstInterference = true;
 
-    // Quickly skip interference check for empty sets.
-    if (LR->empty() || LiveUnion->empty()) {
+    // Quickly skip interference check for empty sets, and for a union whose
+    // segments all lie before or after LR, which is common for the physical
+    // registers of large functions and saves the lookup in the map.
+    if (LR->empty() || LiveUnion->empty() ||
+        LR->beginIndex() >= LiveUnion->getMap().stop() ||
+        LR->endIndex() <= LiveUnion->getMap().start()) {
       SeenAllInterferences = true;
       return 0;
     }
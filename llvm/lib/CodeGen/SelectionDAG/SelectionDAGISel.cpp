@@ -738,6 +738,46 @@ void SelectionDAGISel::ComputeLiveOutVRegInfo() {
   } while (!Worklist.empty());
 }
 
+namespace {
+
+/// The size of the DAG of a block and the wall time spent in the phases of its
+/// selection, reported as the "BlockStats" analysis remark of sdagisel so that
+/// the blocks taking the most time in instruction selection can be ranked.
+struct ISelBlockStats {
+  bool Enabled;
+  unsigned InitialNodes = 0;
+  unsigned LegalNodes = 0;
+  unsigned Combines = 0;
+  unsigned LegalizeRounds = 0;
+  double CombineTime = 0;
+  double LegalizeTime = 0;
+  double SelectTime = 0;
+  double ScheduleTime = 0;
+
+  ISelBlockStats(bool Enabled) : Enabled(Enabled) {}
+};
+
+/// Adds the wall time of its scope to a time of ISelBlockStats if these are
+/// enabled.
+class ISelPhaseTimer {
+  double *Time;
+  TimeRecord Start;
+
+public:
+  ISelPhaseTimer(const ISelBlockStats &Stats, double &Time)
+      : Time(Stats.Enabled ? &Time : nullptr) {
+    if (this->Time)
+      Start = TimeRecord::getCurrentTime(true);
+  }
+  ~ISelPhaseTimer() {
+    if (Time)
+      *Time += TimeRecord::getCurrentTime(false).getWallTime() -
+               Start.getWallTime();
+  }
+};
+
+} // end anonymous namespace
+
 void SelectionDAGISel::CodeGenAndEmitDAG() {
   StringRef GroupName = "sdag";
   StringRef GroupDescription = "Instruction Selection and Scheduling";
@@ -751,6 +791,10 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   // Pre-type legalization allow creation of any node types.
   CurDAG->NewNodesMustHaveLegalTypes = false;
 
+  ISelBlockStats Stats(ORE->allowExtraAnalysis("sdagisel"));
+  if (Stats.Enabled)
+    Stats.InitialNodes = CurDAG->allnodes_size();
+
 #ifndef NDEBUG
   MatchFilterBB = (FilterDAGBasicBlockName.empty() ||
                    FilterDAGBasicBlockName ==
@@ -777,6 +821,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   {
     NamedRegionTimer T("combine1", "DAG Combining 1", GroupName,
                        GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer PT(Stats, Stats.CombineTime);
+    ++Stats.Combines;
     CurDAG->Combine(BeforeLegalizeTypes, AA, OptLevel);
   }
 
@@ -799,6 +845,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   {
     NamedRegionTimer T("legalize_types", "Type Legalization", GroupName,
                        GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer PT(Stats, Stats.LegalizeTime);
+    ++Stats.LegalizeRounds;
     Changed = CurDAG->LegalizeTypes();
   }
 
@@ -823,6 +871,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
     {
       NamedRegionTimer T("combine_lt", "DAG Combining after legalize types",
                          GroupName, GroupDescription, TimePassesIsEnabled);
+      ISelPhaseTimer PT(Stats, Stats.CombineTime);
+      ++Stats.Combines;
       CurDAG->Combine(AfterLegalizeTypes, AA, OptLevel);
     }
 
@@ -840,6 +890,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   {
     NamedRegionTimer T("legalize_vec", "Vector Legalization", GroupName,
                        GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer PT(Stats, Stats.LegalizeTime);
+    ++Stats.LegalizeRounds;
     Changed = CurDAG->LegalizeVectors();
   }
 
@@ -852,6 +904,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
     {
       NamedRegionTimer T("legalize_types2", "Type Legalization 2", GroupName,
                          GroupDescription, TimePassesIsEnabled);
+      ISelPhaseTimer PT(Stats, Stats.LegalizeTime);
+      ++Stats.LegalizeRounds;
       CurDAG->LegalizeTypes();
     }
 
@@ -867,6 +921,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
     {
       NamedRegionTimer T("combine_lv", "DAG Combining after legalize vectors",
                          GroupName, GroupDescription, TimePassesIsEnabled);
+      ISelPhaseTimer PT(Stats, Stats.CombineTime);
+      ++Stats.Combines;
       CurDAG->Combine(AfterLegalizeVectorOps, AA, OptLevel);
     }
 
@@ -887,6 +943,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   {
     NamedRegionTimer T("legalize", "DAG Legalization", GroupName,
                        GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer PT(Stats, Stats.LegalizeTime);
+    ++Stats.LegalizeRounds;
     CurDAG->Legalize();
   }
 
@@ -907,6 +965,8 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   {
     NamedRegionTimer T("combine2", "DAG Combining 2", GroupName,
                        GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer PT(Stats, Stats.CombineTime);
+    ++Stats.Combines;
     CurDAG->Combine(AfterLegalizeDAG, AA, OptLevel);
   }
 
@@ -926,11 +986,15 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   if (ViewISelDAGs && MatchFilterBB)
     CurDAG->viewGraph("isel input for " + BlockName);
 
+  if (Stats.Enabled)
+    Stats.LegalNodes = CurDAG->allnodes_size();
+
   // Third, instruction select all of the operations to machine code, adding the
   // code to the MachineBasicBlock.
   {
     NamedRegionTimer T("isel", "Instruction Selection", GroupName,
                        GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer PT(Stats, Stats.SelectTime);
     DoInstructionSelection();
   }
 
@@ -947,6 +1011,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   {
     NamedRegionTimer T("sched", "Instruction Scheduling", GroupName,
                        GroupDescription, TimePassesIsEnabled);
+    ISelPhaseTimer PT(Stats, Stats.ScheduleTime);
     Scheduler->Run(CurDAG, FuncInfo->MBB);
   }
 
@@ -977,6 +1042,28 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
     delete Scheduler;
   }
 
+  if (Stats.Enabled) {
+    const BasicBlock *LLVMBB = FirstMBB->getBasicBlock();
+    DebugLoc DL;
+    for (const Instruction &I : *LLVMBB)
+      if ((DL = I.getDebugLoc()))
+        break;
+    ORE->emit([&]() {
+      auto Ms = [](double Seconds) { return float(Seconds * 1000); };
+      return OptimizationRemarkAnalysis("sdagisel", "BlockStats", DL, LLVMBB)
+             << "selected " << ore::NV("InitialNodes", Stats.InitialNodes)
+             << " nodes, " << ore::NV("LegalNodes", Stats.LegalNodes)
+             << " after legalization, with "
+             << ore::NV("Combines", Stats.Combines) << " combines and "
+             << ore::NV("LegalizeRounds", Stats.LegalizeRounds)
+             << " legalization rounds, in ms: combine "
+             << ore::NV("CombineTime", Ms(Stats.CombineTime)) << ", legalize "
+             << ore::NV("LegalizeTime", Ms(Stats.LegalizeTime)) << ", select "
+             << ore::NV("SelectTime", Ms(Stats.SelectTime)) << ", schedule "
+             << ore::NV("ScheduleTime", Ms(Stats.ScheduleTime));
+    });
+  }
+
   // Free the SelectionDAG state, now that we're finished with it.
   CurDAG->clear();
 }
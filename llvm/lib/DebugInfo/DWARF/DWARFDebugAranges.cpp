@@ -11,6 +11,7 @@
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFDebugArangeSet.h"
 #include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/WithColor.h"
 #include <algorithm>
 #include <cassert>
@@ -50,16 +51,29 @@ void DWARFDebugAranges::generate(DWARFContext *CTX) {
   // Generate aranges from DIEs: even if .debug_aranges section is present,
   // it may describe only a small subset of compilation units, so we need to
   // manually build aranges for the rest of them.
-  for (const auto &CU : CTX->compile_units()) {
-    uint32_t CUOffset = CU->getOffset();
-    if (ParsedCUOffsets.insert(CUOffset).second) {
-      Expected<DWARFAddressRangesVector> CURanges = CU->collectAddressRanges();
-      if (!CURanges)
-        WithColor::error() << toString(CURanges.takeError()) << '\n';
-      else
-        for (const auto &R : *CURanges)
-          appendRange(CUOffset, R.LowPC, R.HighPC);
-    }
+  std::vector<DWARFUnit *> Units;
+  for (const auto &CU : CTX->compile_units())
+    if (ParsedCUOffsets.insert(CU->getOffset()).second)
+      Units.push_back(CU.get());
+
+  // The units are decoded in parallel. They only share the abbreviations,
+  // which are looked up beforehand so that decoding a unit only reads the
+  // sections and writes to the unit.
+  for (DWARFUnit *U : Units)
+    U->getAbbreviations();
+  std::vector<Optional<Expected<DWARFAddressRangesVector>>> UnitRanges(
+      Units.size());
+  parallel::for_each_n(parallel::par, size_t(0), Units.size(), [&](size_t I) {
+    UnitRanges[I] = Units[I]->collectAddressRanges();
+  });
+
+  for (size_t I = 0, E = Units.size(); I != E; ++I) {
+    Expected<DWARFAddressRangesVector> &CURanges = *UnitRanges[I];
+    if (!CURanges)
+      WithColor::error() << toString(CURanges.takeError()) << '\n';
+    else
+      for (const auto &R : *CURanges)
+        appendRange(Units[I]->getOffset(), R.LowPC, R.HighPC);
   }
 
   construct();
@@ -140,6 +140,7 @@ void LLVMSymbolizer::flush() {
   BinaryForPath.clear();
   ObjectPairForPathArch.clear();
   Modules.clear();
+  CacheSize = 0;
 }
 
 namespace {
@@ -346,6 +347,7 @@ LLVMSymbolizer::getOrCreateObject(const std::string &Path,
       return BinOrErr.takeError();
     }
     Bin = BinOrErr->getBinary();
+    CacheSize += Bin->getData().size();
     BinaryForPath.insert(std::make_pair(Path, std::move(BinOrErr.get())));
   } else {
     Bin = I->second.getBinary();
@@ -384,6 +386,11 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName,
   if (I != Modules.end()) {
     return I->second.get();
   }
+  // Rather than keep every binary symbolized so far loaded, start over once
+  // they add up to the cache size. This invalidates the modules returned
+  // before, which the callers only use for the query they made.
+  if (Opts.MaxCacheSize && CacheSize > Opts.MaxCacheSize)
+    flush();
   std::string BinaryName = ModuleName;
   std::string ArchName = Opts.DefaultArch;
   size_t ColonPos = ModuleName.find_last_of(':');
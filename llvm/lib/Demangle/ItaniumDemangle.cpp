@@ -323,6 +323,78 @@ public:
 
 using Demangler = itanium_demangle::ManglingParser<DefaultAllocator>;
 
+namespace {
+/// The allocator of ItaniumPartialDemangler, which demangles many names one
+/// after the other: unlike DefaultAllocator it keeps its blocks when it is
+/// reset, so that the next name reuses them instead of allocating again.
+class ReusableAllocator {
+  static constexpr size_t BlockSize = 4096;
+
+  // The blocks, the ones before NextBlock are in use.
+  std::vector<char *> Blocks;
+  size_t NextBlock = 0;
+  char *Current = nullptr;
+  size_t Left = 0;
+  // The allocations larger than a block, freed on reset.
+  std::vector<void *> Massive;
+
+  static void *allocateOrDie(size_t N) {
+    void *P = std::malloc(N);
+    if (P == nullptr)
+      std::terminate();
+    return P;
+  }
+
+public:
+  ReusableAllocator() = default;
+  ReusableAllocator(const ReusableAllocator &) = delete;
+  ReusableAllocator &operator=(const ReusableAllocator &) = delete;
+
+  ~ReusableAllocator() {
+    reset();
+    for (char *Block : Blocks)
+      std::free(Block);
+  }
+
+  void reset() {
+    for (void *P : Massive)
+      std::free(P);
+    Massive.clear();
+    NextBlock = 0;
+    Current = nullptr;
+    Left = 0;
+  }
+
+  void *allocate(size_t N) {
+    N = (N + 15u) & ~15u;
+    if (N > BlockSize) {
+      Massive.push_back(allocateOrDie(N));
+      return Massive.back();
+    }
+    if (N > Left) {
+      if (NextBlock == Blocks.size())
+        Blocks.push_back(static_cast<char *>(allocateOrDie(BlockSize)));
+      Current = Blocks[NextBlock++];
+      Left = BlockSize;
+    }
+    void *P = Current;
+    Current += N;
+    Left -= N;
+    return P;
+  }
+
+  template<typename T, typename ...Args> T *makeNode(Args &&...args) {
+    return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+  }
+
+  void *allocateNodeArray(size_t sz) {
+    return allocate(sizeof(Node *) * sz);
+  }
+};
+} // unnamed namespace
+
+using PartialDemangler = itanium_demangle::ManglingParser<ReusableAllocator>;
+
 char *llvm::itaniumDemangle(const char *MangledName, char *Buf,
                             size_t *N, int *Status) {
   if (MangledName == nullptr || (Buf != nullptr && N == nullptr)) {
@@ -356,10 +428,10 @@ char *llvm::itaniumDemangle(const char *MangledName, char *Buf,
 }
 
 ItaniumPartialDemangler::ItaniumPartialDemangler()
-    : RootNode(nullptr), Context(new Demangler{nullptr, nullptr}) {}
+    : RootNode(nullptr), Context(new PartialDemangler{nullptr, nullptr}) {}
 
 ItaniumPartialDemangler::~ItaniumPartialDemangler() {
-  delete static_cast<Demangler *>(Context);
+  delete static_cast<PartialDemangler *>(Context);
 }
 
 ItaniumPartialDemangler::ItaniumPartialDemangler(
@@ -377,7 +449,7 @@ operator=(ItaniumPartialDemangler &&Other) {
 
 // Demangle MangledName into an AST, storing it into this->RootNode.
 bool ItaniumPartialDemangler::partialDemangle(const char *MangledName) {
-  Demangler *Parser = static_cast<Demangler *>(Context);
+  PartialDemangler *Parser = static_cast<PartialDemangler *>(Context);
   size_t Len = std::strlen(MangledName);
   Parser->reset(MangledName, MangledName + Len);
   RootNode = Parser->parse();
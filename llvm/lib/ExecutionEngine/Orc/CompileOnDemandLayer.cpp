@@ -7,6 +7,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/IR/Mangler.h"
 #include "llvm/IR/Module.h"
 
@@ -107,6 +109,22 @@ CompileOnDemandLayer::compileWholeModule(GlobalValueSet Requested) {
   return None;
 }
 
+CompileOnDemandLayer::GlobalValueSet
+CompileOnDemandLayer::speculateDirectCallees(const GlobalValueSet &Partition) {
+  GlobalValueSet Callees;
+  for (auto *GV : Partition) {
+    auto *F = dyn_cast<Function>(GV);
+    if (!F)
+      continue;
+    for (auto &I : instructions(*F))
+      if (auto *Call = dyn_cast<CallBase>(&I))
+        if (auto *Callee = Call->getCalledFunction())
+          if (!Callee->isDeclaration())
+            Callees.insert(Callee);
+  }
+  return Callees;
+}
+
 CompileOnDemandLayer::CompileOnDemandLayer(
     ExecutionSession &ES, IRLayer &BaseLayer, LazyCallThroughManager &LCTMgr,
     IndirectStubsManagerBuilder BuildIndirectStubsManager)
@@ -117,6 +135,10 @@ void CompileOnDemandLayer::setPartitionFunction(PartitionFunction Partition) {
   this->Partition = std::move(Partition);
 }
 
+void CompileOnDemandLayer::setSpeculateFunction(SpeculateFunction Speculate) {
+  this->Speculate = std::move(Speculate);
+}
+
 void CompileOnDemandLayer::emit(MaterializationResponsibility R,
                                 ThreadSafeModule TSM) {
   assert(TSM.getModule() && "Null module");
@@ -285,6 +307,17 @@ void CompileOnDemandLayer::emitPartition(
 
   expandPartition(*GVsToExtract);
 
+  // Collect the symbols to compile ahead of their first call. Those in the
+  // partition are compiled right away anyway.
+  SymbolNameSet SymbolsToSpeculate;
+  if (Speculate) {
+    MangleAndInterner Mangle(ES, TSM.getModule()->getDataLayout());
+    for (auto *GV : Speculate(*GVsToExtract))
+      if (!GVsToExtract->count(GV) && !GV->isDeclaration() &&
+          !GV->hasLocalLinkage() && !GV->hasAppendingLinkage())
+        SymbolsToSpeculate.insert(Mangle(GV->getName()));
+  }
+
   // Extract the requested partiton (plus any necessary aliases) and
   // put the rest back into the impl dylib.
   auto ShouldExtract = [&](const GlobalValue &GV) -> bool {
@@ -295,6 +328,23 @@ void CompileOnDemandLayer::emitPartition(
   R.replace(llvm::make_unique<PartitioningIRMaterializationUnit>(
       ES, std::move(TSM), R.getVModuleKey(), *this));
 
+  // Now that the rest of the module is back in the impl dylib, ask for the
+  // speculated symbols without waiting for them. A later call that needs one
+  // of them joins the compilation already under way.
+  if (!SymbolsToSpeculate.empty())
+    ES.lookup(
+        JITDylibSearchList({{&R.getTargetJITDylib(), true}}),
+        std::move(SymbolsToSpeculate),
+        [&ES](Expected<SymbolMap> Result) {
+          if (!Result)
+            ES.reportError(Result.takeError());
+        },
+        [&ES](Error Err) {
+          if (Err)
+            ES.reportError(std::move(Err));
+        },
+        NoDependenciesToRegister);
+
   BaseLayer.emit(std::move(R), std::move(ExtractedTSM));
 }
 
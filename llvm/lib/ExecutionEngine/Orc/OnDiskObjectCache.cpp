@@ -0,0 +1,132 @@
+//===------ OnDiskObjectCache.cpp - Content-addressed JIT object cache ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/OnDiskObjectCache.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+namespace orc {
+
+Expected<std::unique_ptr<OnDiskObjectCache>>
+OnDiskObjectCache::Create(StringRef CacheDir,
+                          const JITTargetMachineBuilder &JTMB) {
+  if (auto EC = sys::fs::create_directories(CacheDir))
+    return errorCodeToError(EC);
+
+  // Everything, besides the module, that changes the object code. The object
+  // format may also change between LLVM versions.
+  std::string TargetKey;
+  {
+    raw_string_ostream KeyStream(TargetKey);
+    const TargetOptions &Options = JTMB.getOptions();
+    KeyStream << LLVM_VERSION_STRING << '\0' << JTMB.getTargetTriple().str()
+              << '\0' << JTMB.getCPU() << '\0'
+              << JTMB.getFeatures().getString() << '\0'
+              << static_cast<int>(JTMB.getCodeGenOptLevel()) << ' '
+              << (JTMB.getRelocationModel()
+                      ? static_cast<int>(*JTMB.getRelocationModel())
+                      : -1)
+              << ' '
+              << (JTMB.getCodeModel() ? static_cast<int>(*JTMB.getCodeModel())
+                                      : -1)
+              << ' ' << Options.UnsafeFPMath << Options.NoInfsFPMath
+              << Options.NoNaNsFPMath << Options.NoSignedZerosFPMath
+              << Options.EmulatedTLS << Options.ExplicitEmulatedTLS << ' '
+              << static_cast<int>(Options.FloatABIType) << ' '
+              << static_cast<int>(Options.AllowFPOpFusion) << ' '
+              << static_cast<int>(Options.ExceptionModel);
+  }
+
+  return std::unique_ptr<OnDiskObjectCache>(
+      new OnDiskObjectCache(CacheDir.str(), std::move(TargetKey)));
+}
+
+void OnDiskObjectCache::notifyObjectCompiled(const Module *M,
+                                             MemoryBufferRef Obj) {
+  std::string Key;
+  {
+    std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+    auto I = PendingKeys.find(M);
+    if (I != PendingKeys.end()) {
+      Key = std::move(I->second);
+      PendingKeys.erase(I);
+    }
+  }
+  if (Key.empty())
+    Key = getKey(*M);
+
+  // Failing to store an object only costs a compile later, so errors are
+  // dropped.
+  SmallString<128> TempModel(CacheDir);
+  sys::path::append(TempModel, "tmp-%%%%%%%%.o");
+  auto Temp = sys::fs::TempFile::create(TempModel);
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+
+  {
+    raw_fd_ostream TempStream(Temp->FD, /*shouldClose=*/false);
+    TempStream << Obj.getBuffer();
+  }
+
+  // On POSIX systems this atomically replaces an entry that another process
+  // stored in the meantime, which holds the same object.
+  if (auto Err = Temp->keep(getEntryPath(Key))) {
+    consumeError(std::move(Err));
+    consumeError(Temp->discard());
+  }
+}
+
+std::unique_ptr<MemoryBuffer> OnDiskObjectCache::getObject(const Module *M) {
+  std::string Key = getKey(*M);
+
+  // Large enough objects are mapped rather than read, and the linking layers
+  // do not write to them, so their pages are shared between processes.
+  auto ObjOrErr = MemoryBuffer::getFile(getEntryPath(Key), /*FileSize=*/-1,
+                                        /*RequiresNullTerminator=*/false);
+  if (ObjOrErr)
+    return std::move(*ObjOrErr);
+
+  std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+  PendingKeys[M] = std::move(Key);
+  return nullptr;
+}
+
+std::string OnDiskObjectCache::getKey(const Module &M) {
+  SmallVector<char, 0> Bitcode;
+  {
+    raw_svector_ostream BitcodeStream(Bitcode);
+    WriteBitcodeToFile(M, BitcodeStream);
+  }
+
+  SHA1 Hasher;
+  Hasher.update(TargetKey);
+  Hasher.update(StringRef(Bitcode.data(), Bitcode.size()));
+  return toHex(Hasher.result(), /*LowerCase=*/true);
+}
+
+std::string OnDiskObjectCache::getEntryPath(StringRef Key) {
+  SmallString<128> EntryPath(CacheDir);
+  sys::path::append(EntryPath, Key + ".o");
+  return EntryPath.str();
+}
+
+} // end namespace orc
+} // end namespace llvm
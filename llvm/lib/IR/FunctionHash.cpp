@@ -0,0 +1,509 @@
+//===- FunctionHash.cpp - Content hash of a function ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements computeFunctionHash.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/IR/FunctionHash.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/Comdat.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalIndirectSymbol.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/InlineAsm.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Operator.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/SHA1.h"
+
+using namespace llvm;
+
+namespace {
+
+/// Feeds the contents of a function to a SHA1. The blocks, arguments and
+/// instructions of the function are hashed by their number in the function.
+/// The globals, constants, metadata nodes and structure types are hashed by
+/// contents the first time they are seen and by the number of their first
+/// occurrence afterwards, which also ends the cycles through them.
+class FunctionHasher {
+  SHA1 Hasher;
+  DenseMap<const Value *, unsigned> LocalIDs;
+  DenseMap<const void *, unsigned> SeenIDs;
+  SmallVector<StringRef, 32> MDKindNames;
+  SmallVector<StringRef, 8> SyncScopeNames;
+
+  enum Tag {
+    LocalTag,
+    GlobalTag,
+    ConstantTag,
+    InlineAsmTag,
+    MetadataTag,
+    NoneTag
+  };
+
+  void add(uint64_t V) {
+    uint8_t Bytes[8];
+    support::endian::write64le(Bytes, V);
+    Hasher.update(Bytes);
+  }
+
+  void add(StringRef S) {
+    add(S.size());
+    Hasher.update(S);
+  }
+
+  void add(const APInt &V) {
+    add(V.getBitWidth());
+    for (unsigned I = 0, E = V.getNumWords(); I != E; ++I)
+      add(V.getRawData()[I]);
+  }
+
+  /// Return true and hash the number of \p P if it was seen before.
+  bool seen(const void *P) {
+    auto Ins = SeenIDs.insert({P, SeenIDs.size()});
+    if (Ins.second)
+      return false;
+    add(Ins.first->second);
+    return true;
+  }
+
+  void addSyncScope(SyncScope::ID SSID) {
+    add(SSID < SyncScopeNames.size() ? SyncScopeNames[SSID] : StringRef());
+  }
+
+  void addAttributes(AttributeList AL) {
+    add(AL.getNumAttrSets());
+    for (unsigned I = AL.index_begin(), E = AL.index_end(); I != E; ++I)
+      add(AL.getAsString(I));
+  }
+
+  void addType(Type *T);
+  void addValue(const Value *V);
+  void addBlock(const BasicBlock *BB);
+  void addGlobal(const GlobalValue *GV);
+  void addConstant(const Constant *C);
+  void addMetadata(const Metadata *MD);
+  void addDebugInfoFields(const MDNode *N);
+  void addMetadataAttachments(ArrayRef<std::pair<unsigned, MDNode *>> MDs);
+  void addInstruction(const Instruction &I);
+
+public:
+  explicit FunctionHasher(LLVMContext &Ctx) {
+    Ctx.getMDKindNames(MDKindNames);
+    Ctx.getSyncScopeNames(SyncScopeNames);
+  }
+
+  void addFunction(const Function &F);
+
+  FunctionHash result() {
+    StringRef Hash = Hasher.result();
+    FunctionHash Result;
+    for (int I = 0; I != 5; ++I)
+      Result[I] = support::endian::read32be(Hash.data() + I * 4);
+    return Result;
+  }
+};
+
+} // end anonymous namespace
+
+void FunctionHasher::addType(Type *T) {
+  add(T->getTypeID());
+  switch (T->getTypeID()) {
+  default:
+    break;
+  case Type::IntegerTyID:
+    add(T->getIntegerBitWidth());
+    break;
+  case Type::PointerTyID:
+    add(T->getPointerAddressSpace());
+    addType(T->getPointerElementType());
+    break;
+  case Type::ArrayTyID:
+    add(T->getArrayNumElements());
+    addType(T->getArrayElementType());
+    break;
+  case Type::VectorTyID:
+    add(T->getVectorNumElements());
+    addType(T->getVectorElementType());
+    break;
+  case Type::FunctionTyID: {
+    auto *FT = cast<FunctionType>(T);
+    add(FT->isVarArg());
+    add(FT->getNumParams());
+    addType(FT->getReturnType());
+    for (Type *Param : FT->params())
+      addType(Param);
+    break;
+  }
+  case Type::StructTyID: {
+    auto *ST = cast<StructType>(T);
+    if (seen(ST))
+      break;
+    add(ST->hasName() ? ST->getName() : StringRef());
+    add(ST->isOpaque());
+    add(ST->isPacked());
+    if (ST->isOpaque())
+      break;
+    add(ST->getNumElements());
+    for (Type *Element : ST->elements())
+      addType(Element);
+    break;
+  }
+  }
+}
+
+void FunctionHasher::addValue(const Value *V) {
+  auto It = LocalIDs.find(V);
+  if (It != LocalIDs.end()) {
+    add(LocalTag);
+    add(It->second);
+  } else if (auto *C = dyn_cast<Constant>(V)) {
+    addConstant(C);
+  } else if (auto *IA = dyn_cast<InlineAsm>(V)) {
+    add(InlineAsmTag);
+    addType(IA->getFunctionType());
+    add(IA->getAsmString());
+    add(IA->getConstraintString());
+    add(IA->hasSideEffects());
+    add(IA->isAlignStack());
+    add(IA->getDialect());
+  } else if (auto *MAV = dyn_cast<MetadataAsValue>(V)) {
+    add(MetadataTag);
+    addMetadata(MAV->getMetadata());
+  } else if (auto *BB = dyn_cast<BasicBlock>(V)) {
+    addBlock(BB);
+  } else {
+    add(NoneTag);
+  }
+}
+
+void FunctionHasher::addBlock(const BasicBlock *BB) {
+  auto It = LocalIDs.find(BB);
+  if (It != LocalIDs.end()) {
+    add(LocalTag);
+    add(It->second);
+    return;
+  }
+
+  // A block of another function, referenced by a blockaddress.
+  add(GlobalTag);
+  add(BB->getParent()->getName());
+  add(std::distance(BB->getParent()->begin(), BB->getIterator()));
+}
+
+void FunctionHasher::addGlobal(const GlobalValue *GV) {
+  add(GlobalTag);
+  if (seen(GV))
+    return;
+  add(GV->getName());
+  addType(GV->getType());
+  addType(GV->getValueType());
+  add(GV->getLinkage());
+  add(GV->getVisibility());
+  add(GV->getDLLStorageClass());
+  add(GV->getThreadLocalMode());
+  add(unsigned(GV->getUnnamedAddr()));
+  if (auto *Callee = dyn_cast<Function>(GV)) {
+    add(Callee->getCallingConv());
+    addAttributes(Callee->getAttributes());
+  } else if (auto *Var = dyn_cast<GlobalVariable>(GV)) {
+    // The initializer of a constant variable may be folded in its loads.
+    add(Var->isConstant());
+    add(Var->getAlignment());
+    if (Var->isConstant() && Var->hasDefinitiveInitializer())
+      addConstant(Var->getInitializer());
+  } else if (auto *GIS = dyn_cast<GlobalIndirectSymbol>(GV)) {
+    addConstant(GIS->getIndirectSymbol());
+  }
+}
+
+void FunctionHasher::addConstant(const Constant *C) {
+  if (auto *GV = dyn_cast<GlobalValue>(C))
+    return addGlobal(GV);
+
+  add(ConstantTag);
+  if (seen(C))
+    return;
+  add(C->getValueID());
+  addType(C->getType());
+  if (auto *CI = dyn_cast<ConstantInt>(C))
+    return add(CI->getValue());
+  if (auto *CFP = dyn_cast<ConstantFP>(C))
+    return add(CFP->getValueAPF().bitcastToAPInt());
+  if (auto *CDS = dyn_cast<ConstantDataSequential>(C))
+    return add(CDS->getRawDataValues());
+  if (auto *BA = dyn_cast<BlockAddress>(C)) {
+    addGlobal(BA->getFunction());
+    return addBlock(BA->getBasicBlock());
+  }
+  if (auto *CE = dyn_cast<ConstantExpr>(C)) {
+    add(CE->getOpcode());
+    add(CE->getRawSubclassOptionalData());
+    if (CE->isCompare())
+      add(CE->getPredicate());
+    if (CE->hasIndices())
+      for (unsigned Index : CE->getIndices())
+        add(Index);
+    if (auto *GEP = dyn_cast<GEPOperator>(CE)) {
+      addType(GEP->getSourceElementType());
+      Optional<unsigned> InRange = GEP->getInRangeIndex();
+      add(InRange ? *InRange + 1 : 0);
+    }
+  }
+  add(C->getNumOperands());
+  for (const Value *Op : C->operands())
+    addValue(Op);
+}
+
+void FunctionHasher::addMetadata(const Metadata *MD) {
+  if (!MD)
+    return add(NoneTag);
+  add(MD->getMetadataID());
+  if (auto *S = dyn_cast<MDString>(MD))
+    return add(S->getString());
+  if (auto *VAM = dyn_cast<ValueAsMetadata>(MD))
+    return addValue(VAM->getValue());
+
+  auto *N = cast<MDNode>(MD);
+  if (seen(N))
+    return;
+  add(N->isDistinct());
+  addDebugInfoFields(N);
+  add(N->getNumOperands());
+  for (const MDOperand &Op : N->operands())
+    addMetadata(Op.get());
+}
+
+/// Hash the fields of the specialized debug info nodes that are not operands.
+void FunctionHasher::addDebugInfoFields(const MDNode *N) {
+  if (auto *Loc = dyn_cast<DILocation>(N)) {
+    add(Loc->getLine());
+    add(Loc->getColumn());
+    add(Loc->isImplicitCode());
+    return;
+  }
+  if (auto *Expr = dyn_cast<DIExpression>(N)) {
+    add(Expr->getNumElements());
+    for (uint64_t Element : Expr->getElements())
+      add(Element);
+    return;
+  }
+  if (auto *Macro = dyn_cast<DIMacroNode>(N)) {
+    add(Macro->getMacinfoType());
+    if (auto *M = dyn_cast<DIMacro>(Macro))
+      add(M->getLine());
+    else if (auto *MF = dyn_cast<DIMacroFile>(Macro))
+      add(MF->getLine());
+    return;
+  }
+
+  auto *DN = dyn_cast<DINode>(N);
+  if (!DN)
+    return;
+  add(DN->getTag());
+  if (auto *Ty = dyn_cast<DIType>(DN)) {
+    add(Ty->getLine());
+    add(Ty->getSizeInBits());
+    add(Ty->getAlignInBits());
+    add(Ty->getOffsetInBits());
+    add(Ty->getFlags());
+    if (auto *BT = dyn_cast<DIBasicType>(Ty)) {
+      add(BT->getEncoding());
+    } else if (auto *DT = dyn_cast<DIDerivedType>(Ty)) {
+      Optional<unsigned> AS = DT->getDWARFAddressSpace();
+      add(AS ? *AS + 1 : 0);
+    } else if (auto *CT = dyn_cast<DICompositeType>(Ty)) {
+      add(CT->getRuntimeLang());
+    } else if (auto *ST = dyn_cast<DISubroutineType>(Ty)) {
+      add(ST->getCC());
+    }
+  } else if (auto *SP = dyn_cast<DISubprogram>(DN)) {
+    add(SP->getLine());
+    add(SP->getScopeLine());
+    add(SP->getVirtualIndex());
+    add(SP->getThisAdjustment());
+    add(SP->getFlags());
+    add(SP->getSPFlags());
+  } else if (auto *LB = dyn_cast<DILexicalBlock>(DN)) {
+    add(LB->getLine());
+    add(LB->getColumn());
+  } else if (auto *LBF = dyn_cast<DILexicalBlockFile>(DN)) {
+    add(LBF->getDiscriminator());
+  } else if (auto *Var = dyn_cast<DIVariable>(DN)) {
+    add(Var->getLine());
+    add(Var->getAlignInBits());
+    if (auto *GV = dyn_cast<DIGlobalVariable>(Var)) {
+      add(GV->isLocalToUnit());
+      add(GV->isDefinition());
+    } else if (auto *LV = dyn_cast<DILocalVariable>(Var)) {
+      add(LV->getArg());
+      add(LV->getFlags());
+    }
+  } else if (auto *File = dyn_cast<DIFile>(DN)) {
+    if (auto Checksum = File->getChecksum())
+      add(Checksum->Kind + 1);
+  } else if (auto *CU = dyn_cast<DICompileUnit>(DN)) {
+    add(CU->getSourceLanguage());
+    add(CU->isOptimized());
+    add(CU->getRuntimeVersion());
+    add(CU->getEmissionKind());
+    add(CU->getDWOId());
+    add(CU->getSplitDebugInlining());
+    add(CU->getDebugInfoForProfiling());
+    add(unsigned(CU->getNameTableKind()));
+    add(CU->getRangesBaseAddress());
+  } else if (auto *SR = dyn_cast<DISubrange>(DN)) {
+    add(SR->getLowerBound());
+  } else if (auto *E = dyn_cast<DIEnumerator>(DN)) {
+    add(E->getValue());
+    add(E->isUnsigned());
+  } else if (auto *NS = dyn_cast<DINamespace>(DN)) {
+    add(NS->getExportSymbols());
+  } else if (auto *CB = dyn_cast<DICommonBlock>(DN)) {
+    add(CB->getLineNo());
+  } else if (auto *L = dyn_cast<DILabel>(DN)) {
+    add(L->getLine());
+  } else if (auto *P = dyn_cast<DIObjCProperty>(DN)) {
+    add(P->getLine());
+    add(P->getAttributes());
+  } else if (auto *IE = dyn_cast<DIImportedEntity>(DN)) {
+    add(IE->getLine());
+  }
+}
+
+void FunctionHasher::addMetadataAttachments(
+    ArrayRef<std::pair<unsigned, MDNode *>> MDs) {
+  add(MDs.size());
+  for (const auto &MD : MDs) {
+    // Custom kinds are numbered in the order they are registered in the
+    // context, hash their names.
+    add(MD.first < MDKindNames.size() ? MDKindNames[MD.first] : StringRef());
+    addMetadata(MD.second);
+  }
+}
+
+void FunctionHasher::addInstruction(const Instruction &I) {
+  add(I.getOpcode());
+  addType(I.getType());
+  add(I.getRawSubclassOptionalData());
+  add(I.getNumOperands());
+  for (const Use &Op : I.operands())
+    addValue(Op);
+
+  if (auto *PN = dyn_cast<PHINode>(&I)) {
+    for (const BasicBlock *BB : PN->blocks())
+      addBlock(BB);
+  } else if (auto *AI = dyn_cast<AllocaInst>(&I)) {
+    addType(AI->getAllocatedType());
+    add(AI->getAlignment());
+    add(AI->isUsedWithInAlloca());
+    add(AI->isSwiftError());
+  } else if (auto *LI = dyn_cast<LoadInst>(&I)) {
+    add(LI->isVolatile());
+    add(LI->getAlignment());
+    add(unsigned(LI->getOrdering()));
+    addSyncScope(LI->getSyncScopeID());
+  } else if (auto *SI = dyn_cast<StoreInst>(&I)) {
+    add(SI->isVolatile());
+    add(SI->getAlignment());
+    add(unsigned(SI->getOrdering()));
+    addSyncScope(SI->getSyncScopeID());
+  } else if (auto *CI = dyn_cast<CmpInst>(&I)) {
+    add(CI->getPredicate());
+  } else if (auto *Call = dyn_cast<CallBase>(&I)) {
+    addType(Call->getFunctionType());
+    add(Call->getCallingConv());
+    addAttributes(Call->getAttributes());
+    if (auto *CI = dyn_cast<CallInst>(Call))
+      add(CI->getTailCallKind());
+    add(Call->getNumOperandBundles());
+    for (unsigned B = 0, E = Call->getNumOperandBundles(); B != E; ++B) {
+      OperandBundleUse Bundle = Call->getOperandBundleAt(B);
+      add(Bundle.getTagName());
+      add(Bundle.Inputs.size());
+    }
+  } else if (auto *GEP = dyn_cast<GetElementPtrInst>(&I)) {
+    addType(GEP->getSourceElementType());
+  } else if (auto *EVI = dyn_cast<ExtractValueInst>(&I)) {
+    for (unsigned Index : EVI->indices())
+      add(Index);
+  } else if (auto *IVI = dyn_cast<InsertValueInst>(&I)) {
+    for (unsigned Index : IVI->indices())
+      add(Index);
+  } else if (auto *FI = dyn_cast<FenceInst>(&I)) {
+    add(unsigned(FI->getOrdering()));
+    addSyncScope(FI->getSyncScopeID());
+  } else if (auto *CXI = dyn_cast<AtomicCmpXchgInst>(&I)) {
+    add(CXI->isVolatile());
+    add(CXI->isWeak());
+    add(unsigned(CXI->getSuccessOrdering()));
+    add(unsigned(CXI->getFailureOrdering()));
+    addSyncScope(CXI->getSyncScopeID());
+  } else if (auto *RMWI = dyn_cast<AtomicRMWInst>(&I)) {
+    add(RMWI->getOperation());
+    add(RMWI->isVolatile());
+    add(unsigned(RMWI->getOrdering()));
+    addSyncScope(RMWI->getSyncScopeID());
+  } else if (auto *LP = dyn_cast<LandingPadInst>(&I)) {
+    add(LP->isCleanup());
+  }
+
+  // The debug location comes first in the attachments.
+  SmallVector<std::pair<unsigned, MDNode *>, 4> MDs;
+  I.getAllMetadata(MDs);
+  addMetadataAttachments(MDs);
+}
+
+void FunctionHasher::addFunction(const Function &F) {
+  addGlobal(&F);
+  add(F.hasGC() ? F.getGC() : "");
+  add(F.getSection());
+  add(F.getAlignment());
+  add(F.hasComdat() ? F.getComdat()->getName() : "");
+  add(F.hasPersonalityFn());
+  if (F.hasPersonalityFn())
+    addConstant(F.getPersonalityFn());
+  add(F.hasPrefixData());
+  if (F.hasPrefixData())
+    addConstant(F.getPrefixData());
+  add(F.hasPrologueData());
+  if (F.hasPrologueData())
+    addConstant(F.getPrologueData());
+  SmallVector<std::pair<unsigned, MDNode *>, 4> MDs;
+  F.getAllMetadata(MDs);
+  addMetadataAttachments(MDs);
+
+  // Number the arguments, blocks and instructions first, the operands of an
+  // instruction may be defined after it.
+  for (const Argument &A : F.args())
+    LocalIDs.insert({&A, LocalIDs.size()});
+  for (const BasicBlock &BB : F) {
+    LocalIDs.insert({&BB, LocalIDs.size()});
+    for (const Instruction &I : BB)
+      LocalIDs.insert({&I, LocalIDs.size()});
+  }
+
+  add(F.size());
+  for (const BasicBlock &BB : F) {
+    add(BB.size());
+    for (const Instruction &I : BB)
+      addInstruction(I);
+  }
+}
+
+FunctionHash llvm::computeFunctionHash(const Function &F) {
+  FunctionHasher Hasher(F.getContext());
+  Hasher.addFunction(F);
+  return Hasher.result();
+}
@@ -1748,6 +1748,7 @@ MPPassManager::runOnModule(Module &M) {
     {
       PassManagerPrettyStackEntry X(MP, M);
       TimeRegion PassTimer(getPassTimer(MP));
+      llvm::TimeTraceScope PassScope("RunPass", MP->getPassName());
 
       LocalChanged |= MP->runOnModule(M);
       if (EmitICRemark) {
@@ -12,13 +12,17 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/IR/RemarkStreamer.h"
+#include "llvm/IR/GlobalValue.h"
 
 using namespace llvm;
 
-RemarkStreamer::RemarkStreamer(StringRef Filename, raw_ostream &OS)
-    : Filename(Filename), OS(OS),
+RemarkStreamer::RemarkStreamer(StringRef Filename, raw_ostream &OS,
+                               remarks::Format RemarkFormat)
+    : Filename(Filename), OS(OS), RemarkFormat(RemarkFormat),
       YAMLOutput(OS, reinterpret_cast<void *>(this)), StrTab() {
   assert(!Filename.empty() && "This needs to be a real filename.");
+  if (RemarkFormat == remarks::Format::Binary)
+    BinaryOutput = llvm::make_unique<remarks::BinarySerializer>(OS);
 }
 
 Error RemarkStreamer::setFilter(StringRef Filter) {
@@ -31,11 +35,60 @@ Error RemarkStreamer::setFilter(StringRef Filter) {
   return Error::success();
 }
 
+static remarks::Type toRemarkType(enum DiagnosticKind Kind) {
+  switch (Kind) {
+  default:
+    return remarks::Type::Unknown;
+  case DK_OptimizationRemark:
+  case DK_MachineOptimizationRemark:
+    return remarks::Type::Passed;
+  case DK_OptimizationRemarkMissed:
+  case DK_MachineOptimizationRemarkMissed:
+    return remarks::Type::Missed;
+  case DK_OptimizationRemarkAnalysis:
+  case DK_MachineOptimizationRemarkAnalysis:
+    return remarks::Type::Analysis;
+  case DK_OptimizationRemarkAnalysisFPCommute:
+    return remarks::Type::AnalysisFPCommute;
+  case DK_OptimizationRemarkAnalysisAliasing:
+    return remarks::Type::AnalysisAliasing;
+  case DK_OptimizationFailure:
+    return remarks::Type::Failure;
+  }
+}
+
+static Optional<remarks::RemarkLocation>
+toRemarkLocation(const DiagnosticLocation &DL) {
+  if (!DL.isValid())
+    return None;
+  return remarks::RemarkLocation{DL.getRelativePath(), DL.getLine(),
+                                 DL.getColumn()};
+}
+
 void RemarkStreamer::emit(const DiagnosticInfoOptimizationBase &Diag) {
   if (Optional<Regex> &Filter = PassFilter)
     if (!Filter->match(Diag.getPassName()))
       return;
 
+  if (BinaryOutput) {
+    // The remark refers to the strings of Diag, it is written right away.
+    SmallVector<remarks::Argument, 8> Args;
+    for (const DiagnosticInfoOptimizationBase::Argument &Arg : Diag.getArgs())
+      Args.push_back({Arg.Key, Arg.Val, toRemarkLocation(Arg.Loc)});
+
+    remarks::Remark R;
+    R.RemarkType = toRemarkType(static_cast<DiagnosticKind>(Diag.getKind()));
+    R.PassName = Diag.getPassName();
+    R.RemarkName = Diag.getRemarkName();
+    R.FunctionName =
+        GlobalValue::dropLLVMManglingEscape(Diag.getFunction().getName());
+    R.Loc = toRemarkLocation(Diag.getLocation());
+    R.Hotness = Diag.getHotness();
+    R.Args = Args;
+    BinaryOutput->emit(R);
+    return;
+  }
+
   DiagnosticInfoOptimizationBase *DiagPtr =
       const_cast<DiagnosticInfoOptimizationBase *>(&Diag);
   YAMLOutput << DiagPtr;
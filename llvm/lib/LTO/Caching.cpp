@@ -28,15 +28,19 @@ using namespace llvm;
 using namespace llvm::lto;
 
 Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
-                                            AddBufferFn AddBuffer) {
+                                            AddBufferFn AddBuffer,
+                                            bool Sharded) {
   if (std::error_code EC = sys::fs::create_directories(CacheDirectoryPath))
     return errorCodeToError(EC);
 
   return [=](unsigned Task, StringRef Key) -> AddStreamFn {
-    // This choice of file name allows the cache to be pruned (see pruneCache()
-    // in include/llvm/Support/CachePruning.h).
+    // This choice of file and shard names allows the cache to be pruned (see
+    // pruneCache() in include/llvm/Support/CachePruning.h).
+    SmallString<64> EntryDir(CacheDirectoryPath);
+    if (Sharded)
+      sys::path::append(EntryDir, Key.take_front(2));
     SmallString<64> EntryPath;
-    sys::path::append(EntryPath, CacheDirectoryPath, "llvmcache-" + Key);
+    sys::path::append(EntryPath, EntryDir, "llvmcache-" + Key);
     // First, see if we have a cache hit.
     int FD;
     SmallString<64> ResultPath;
@@ -129,9 +133,15 @@ Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
     };
 
     return [=](size_t Task) -> std::unique_ptr<NativeObjectStream> {
+      // The shard may not exist yet. Another process may create it first.
+      if (Sharded)
+        if (std::error_code EC = sys::fs::create_directories(EntryDir))
+          report_fatal_error(Twine("Failed to create cache directory ") +
+                             EntryDir + ": " + EC.message() + "\n");
+
       // Write to a temporary to avoid race condition
       SmallString<64> TempFilenameModel;
-      sys::path::append(TempFilenameModel, CacheDirectoryPath, "Thin-%%%%%%.tmp.o");
+      sys::path::append(TempFilenameModel, EntryDir, "Thin-%%%%%%.tmp.o");
       Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
           TempFilenameModel, sys::fs::owner_read | sys::fs::owner_write);
       if (!Temp) {
@@ -30,6 +30,7 @@
 #include "llvm/Linker/IRMover.h"
 #include "llvm/Object/IRObjectFile.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
@@ -1024,6 +1025,19 @@ public:
   virtual Error wait() = 0;
 };
 
+// Collect the GUIDs of the CFI function definitions and declarations of the
+// combined index, which are part of the cache keys of the backend jobs.
+static void collectCfiFunctions(ModuleSummaryIndex &CombinedIndex,
+                                std::set<GlobalValue::GUID> &CfiFunctionDefs,
+                                std::set<GlobalValue::GUID> &CfiFunctionDecls) {
+  for (auto &Name : CombinedIndex.cfiFunctionDefs())
+    CfiFunctionDefs.insert(
+        GlobalValue::getGUID(GlobalValue::dropLLVMManglingEscape(Name)));
+  for (auto &Name : CombinedIndex.cfiFunctionDecls())
+    CfiFunctionDecls.insert(
+        GlobalValue::getGUID(GlobalValue::dropLLVMManglingEscape(Name)));
+}
+
 namespace {
 class InProcessThinBackend : public ThinBackendProc {
   ThreadPool BackendThreadPool;
@@ -1044,12 +1058,7 @@ public:
       : ThinBackendProc(Conf, CombinedIndex, ModuleToDefinedGVSummaries),
         BackendThreadPool(ThinLTOParallelismLevel),
         AddStream(std::move(AddStream)), Cache(std::move(Cache)) {
-    for (auto &Name : CombinedIndex.cfiFunctionDefs())
-      CfiFunctionDefs.insert(
-          GlobalValue::getGUID(GlobalValue::dropLLVMManglingEscape(Name)));
-    for (auto &Name : CombinedIndex.cfiFunctionDecls())
-      CfiFunctionDecls.insert(
-          GlobalValue::getGUID(GlobalValue::dropLLVMManglingEscape(Name)));
+    collectCfiFunctions(CombinedIndex, CfiFunctionDefs, CfiFunctionDecls);
   }
 
   Error runThinLTOBackendThread(
@@ -1100,7 +1109,10 @@ public:
     assert(ModuleToDefinedGVSummaries.count(ModulePath));
     const GVSummaryMapTy &DefinedGlobals =
         ModuleToDefinedGVSummaries.find(ModulePath)->second;
-    BackendThreadPool.async(
+    // The largest modules are the longest to optimize, starting them first
+    // keeps the last ones to complete from starting last.
+    BackendThreadPool.asyncWithPriority(
+        BM.getBuffer().size(),
         [=](BitcodeModule BM, ModuleSummaryIndex &CombinedIndex,
             const FunctionImporter::ImportMapTy &ImportList,
             const FunctionImporter::ExportSetTy &ExportList,
@@ -1234,6 +1246,153 @@ ThinBackend lto::createWriteIndexesThinBackend(
   };
 }
 
+namespace {
+class DistributedThinBackend : public ThinBackendProc {
+  ThreadPool BackendThreadPool;
+  AddStreamFn AddStream;
+  NativeObjectCache Cache;
+  DistributedBackendFn RunJob;
+  std::set<GlobalValue::GUID> CfiFunctionDefs;
+  std::set<GlobalValue::GUID> CfiFunctionDecls;
+
+  Optional<Error> Err;
+  std::mutex ErrMu;
+
+public:
+  DistributedThinBackend(
+      Config &Conf, ModuleSummaryIndex &CombinedIndex,
+      unsigned ParallelismLevel,
+      const StringMap<GVSummaryMapTy> &ModuleToDefinedGVSummaries,
+      AddStreamFn AddStream, NativeObjectCache Cache,
+      DistributedBackendFn RunJob)
+      : ThinBackendProc(Conf, CombinedIndex, ModuleToDefinedGVSummaries),
+        BackendThreadPool(ParallelismLevel), AddStream(std::move(AddStream)),
+        Cache(std::move(Cache)), RunJob(std::move(RunJob)) {
+    collectCfiFunctions(CombinedIndex, CfiFunctionDefs, CfiFunctionDecls);
+  }
+
+  // Writes the individual index of a module, has the job compile the module
+  // with it and streams the resulting object.
+  Error runDistributedJob(AddStreamFn AddStream, unsigned Task,
+                          StringRef ModulePath,
+                          const FunctionImporter::ImportMapTy &ImportList) {
+    std::map<std::string, GVSummaryMapTy> ModuleToSummariesForIndex;
+    gatherImportedSummariesForModule(ModulePath, ModuleToDefinedGVSummaries,
+                                     ImportList, ModuleToSummariesForIndex);
+
+    int IndexFD;
+    SmallString<128> IndexPath, ObjectPath;
+    if (std::error_code EC = sys::fs::createTemporaryFile(
+            "thinlto-index", "thinlto.bc", IndexFD, IndexPath))
+      return errorCodeToError(EC);
+    FileRemover IndexRemover(IndexPath);
+    {
+      raw_fd_ostream OS(IndexFD, /*shouldClose=*/true);
+      WriteIndexToFile(CombinedIndex, OS, &ModuleToSummariesForIndex);
+    }
+
+    if (std::error_code EC =
+            sys::fs::createTemporaryFile("thinlto-object", "o", ObjectPath))
+      return errorCodeToError(EC);
+    FileRemover ObjectRemover(ObjectPath);
+    if (Error E = RunJob(ModulePath, IndexPath, ObjectPath))
+      return E;
+
+    ErrorOr<std::unique_ptr<MemoryBuffer>> ObjectOrErr =
+        MemoryBuffer::getFile(ObjectPath, /*FileSize=*/-1,
+                              /*RequiresNullTerminator=*/false);
+    if (!ObjectOrErr)
+      return errorCodeToError(ObjectOrErr.getError());
+    std::unique_ptr<NativeObjectStream> Stream = AddStream(Task);
+    *Stream->OS << (*ObjectOrErr)->getBuffer();
+    return Error::success();
+  }
+
+  Error runBackend(
+      unsigned Task, BitcodeModule BM,
+      const FunctionImporter::ImportMapTy &ImportList,
+      const FunctionImporter::ExportSetTy &ExportList,
+      const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
+      const GVSummaryMapTy &DefinedGlobals,
+      MapVector<StringRef, BitcodeModule> &ModuleMap) {
+    auto RunThinBackend = [&](AddStreamFn AddStream) -> Error {
+      // The job compiles the module from the file named by its identifier,
+      // which the index refers to. The modules which are not files of their
+      // own, such as the members of archives, are compiled in process.
+      StringRef ModulePath = BM.getModuleIdentifier();
+      if (sys::fs::is_regular_file(ModulePath))
+        return runDistributedJob(AddStream, Task, ModulePath, ImportList);
+
+      LTOLLVMContext BackendContext(Conf);
+      Expected<std::unique_ptr<Module>> MOrErr = BM.parseModule(BackendContext);
+      if (!MOrErr)
+        return MOrErr.takeError();
+      return thinBackend(Conf, Task, AddStream, **MOrErr, CombinedIndex,
+                         ImportList, DefinedGlobals, ModuleMap);
+    };
+
+    auto ModuleID = BM.getModuleIdentifier();
+    if (!Cache || !CombinedIndex.modulePaths().count(ModuleID) ||
+        all_of(CombinedIndex.getModuleHash(ModuleID),
+               [](uint32_t V) { return V == 0; }))
+      return RunThinBackend(AddStream);
+
+    SmallString<40> Key;
+    computeLTOCacheKey(Key, Conf, CombinedIndex, ModuleID, ImportList,
+                       ExportList, ResolvedODR, DefinedGlobals, CfiFunctionDefs,
+                       CfiFunctionDecls);
+    if (AddStreamFn CacheAddStream = Cache(Task, Key))
+      return RunThinBackend(CacheAddStream);
+    return Error::success();
+  }
+
+  Error start(
+      unsigned Task, BitcodeModule BM,
+      const FunctionImporter::ImportMapTy &ImportList,
+      const FunctionImporter::ExportSetTy &ExportList,
+      const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
+      MapVector<StringRef, BitcodeModule> &ModuleMap) override {
+    StringRef ModulePath = BM.getModuleIdentifier();
+    assert(ModuleToDefinedGVSummaries.count(ModulePath));
+    const GVSummaryMapTy &DefinedGlobals =
+        ModuleToDefinedGVSummaries.find(ModulePath)->second;
+    auto Job = [=, &ImportList, &ExportList, &ResolvedODR, &DefinedGlobals,
+                &ModuleMap] {
+      Error E = runBackend(Task, BM, ImportList, ExportList, ResolvedODR,
+                           DefinedGlobals, ModuleMap);
+      if (E) {
+        std::unique_lock<std::mutex> L(ErrMu);
+        if (Err)
+          Err = joinErrors(std::move(*Err), std::move(E));
+        else
+          Err = std::move(E);
+      }
+    };
+    // As in process, the largest modules are started first.
+    BackendThreadPool.asyncWithPriority(BM.getBuffer().size(), std::move(Job));
+    return Error::success();
+  }
+
+  Error wait() override {
+    BackendThreadPool.wait();
+    if (Err)
+      return std::move(*Err);
+    return Error::success();
+  }
+};
+} // end anonymous namespace
+
+ThinBackend lto::createDistributedThinBackend(unsigned ParallelismLevel,
+                                              DistributedBackendFn RunJob) {
+  return [=](Config &Conf, ModuleSummaryIndex &CombinedIndex,
+             const StringMap<GVSummaryMapTy> &ModuleToDefinedGVSummaries,
+             AddStreamFn AddStream, NativeObjectCache Cache) {
+    return llvm::make_unique<DistributedThinBackend>(
+        Conf, CombinedIndex, ParallelismLevel, ModuleToDefinedGVSummaries,
+        AddStream, Cache, RunJob);
+  };
+}
+
 Error LTO::runThinLTO(AddStreamFn AddStream, NativeObjectCache Cache,
                       const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols) {
   if (ThinLTO.ModuleMap.empty())
@@ -239,6 +239,11 @@ Type *TypeMapTy::get(Type *Ty, SmallPtrSet<StructType *, 8> &Visited) {
   // These are types that LLVM itself will unique.
   bool IsUniqued = !isa<StructType>(Ty) || cast<StructType>(Ty)->isLiteral();
 
+  // Skip the walk of the types which were already found to be made of
+  // uniqued types only, in this or an earlier source module.
+  if (IsUniqued && DstStructTypesSet.mapsToItself(Ty))
+    return *Entry = Ty;
+
   if (!IsUniqued) {
     StructType *STy = cast<StructType>(Ty);
     // This is actually a type from the destination module, this can be reached
@@ -1493,6 +1498,20 @@ bool IRMover::IdentifiedStructTypeSet::hasType(StructType *Ty) {
   return I == NonOpaqueStructTypes.end() ? false : *I == Ty;
 }
 
+bool IRMover::IdentifiedStructTypeSet::mapsToItself(Type *Ty) {
+  auto I = ContainsNoIdentifiedStruct.find(Ty);
+  if (I != ContainsNoIdentifiedStruct.end())
+    return I->second;
+
+  // Only the identified structures can be recursive, so this terminates.
+  bool Result = !isa<StructType>(Ty) || cast<StructType>(Ty)->isLiteral();
+  if (Result)
+    Result = all_of(Ty->subtypes(),
+                    [this](Type *Elt) { return mapsToItself(Elt); });
+  ContainsNoIdentifiedStruct[Ty] = Result;
+  return Result;
+}
+
 IRMover::IRMover(Module &M) : Composite(M) {
   TypeFinder StructTypes;
   StructTypes.run(M, /* OnlyNamed */ false);
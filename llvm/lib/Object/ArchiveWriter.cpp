@@ -14,14 +14,16 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Magic.h"
-#include "llvm/IR/LLVMContext.h"
+#include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Object/Archive.h"
+#include "llvm/Object/IRObjectFile.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Object/SymbolicFile.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
@@ -348,28 +350,34 @@ static Expected<std::vector<unsigned>>
 getSymbols(MemoryBufferRef Buf, raw_ostream &SymNames, bool &HasObject) {
   std::vector<unsigned> Ret;
 
-  // In the scenario when LLVMContext is populated SymbolicFile will contain a
-  // reference to it, thus SymbolicFile should be destroyed first.
-  LLVMContext Context;
-  std::unique_ptr<object::SymbolicFile> Obj;
+  // Read the symbols of a bitcode file from its irsymtab, which only parses the
+  // IR when the symbol table of the file is missing or out of date. The flags
+  // and names of its symbols are the ones of the IRObjectFile of the file.
   if (identify_magic(Buf.getBuffer()) == file_magic::bitcode) {
-    auto ObjOrErr = object::SymbolicFile::createSymbolicFile(
-        Buf, file_magic::bitcode, &Context);
-    if (!ObjOrErr) {
+    Expected<object::IRSymtabFile> FOrErr = object::readIRSymtab(Buf);
+    if (!FOrErr) {
       // FIXME: check only for "not an object file" errors.
-      consumeError(ObjOrErr.takeError());
+      consumeError(FOrErr.takeError());
       return Ret;
     }
-    Obj = std::move(*ObjOrErr);
-  } else {
-    auto ObjOrErr = object::SymbolicFile::createSymbolicFile(Buf);
-    if (!ObjOrErr) {
-      // FIXME: check only for "not an object file" errors.
-      consumeError(ObjOrErr.takeError());
-      return Ret;
+
+    HasObject = true;
+    for (const irsymtab::Reader::SymbolRef &Sym : FOrErr->TheReader.symbols()) {
+      if (Sym.isFormatSpecific() || !Sym.isGlobal() || Sym.isUndefined())
+        continue;
+      Ret.push_back(SymNames.tell());
+      SymNames << Sym.getName() << '\0';
     }
-    Obj = std::move(*ObjOrErr);
+    return Ret;
+  }
+
+  auto ObjOrErr = object::SymbolicFile::createSymbolicFile(Buf);
+  if (!ObjOrErr) {
+    // FIXME: check only for "not an object file" errors.
+    consumeError(ObjOrErr.takeError());
+    return Ret;
   }
+  std::unique_ptr<object::SymbolicFile> Obj = std::move(*ObjOrErr);
 
   HasObject = true;
   for (const object::BasicSymbolRef &S : Obj->symbols()) {
@@ -383,10 +391,56 @@ getSymbols(MemoryBufferRef Buf, raw_ostream &SymNames, bool &HasObject) {
   return Ret;
 }
 
+namespace {
+// The symbols of a member, with their offsets relative to the start of Names.
+struct MemberSymbols {
+  SmallString<0> Names;
+  std::vector<unsigned> Offsets;
+  bool HasObject = false;
+  Error Err = Error::success();
+};
+} // end anonymous namespace
+
+// Reads the symbols of all the members in parallel. Each member gets its own
+// name buffer, which the caller appends to the symbol table in the member
+// order, so the archive is the same as if the members were read one by one.
+static Expected<std::vector<MemberSymbols>>
+readMemberSymbols(ArrayRef<NewArchiveMember> NewMembers) {
+  std::vector<MemberSymbols> Ret(NewMembers.size());
+  auto ReadMember = [&](size_t I) {
+    MemberSymbols &S = Ret[I];
+    ErrorAsOutParameter ErrAsOutParam(&S.Err);
+    raw_svector_ostream Names(S.Names);
+    Expected<std::vector<unsigned>> OffsetsOrErr =
+        getSymbols(NewMembers[I].Buf->getMemBufferRef(), Names, S.HasObject);
+    if (Error E = OffsetsOrErr.takeError())
+      S.Err = std::move(E);
+    else
+      S.Offsets = std::move(*OffsetsOrErr);
+  };
+  parallel::for_each_n(parallel::par, size_t(0), NewMembers.size(),
+                       ReadMember);
+
+  // Report the error of the first failing member, whatever the order in which
+  // the members were read.
+  Error Err = Error::success();
+  for (MemberSymbols &S : Ret) {
+    if (!S.Err)
+      continue;
+    if (Err)
+      consumeError(std::move(S.Err));
+    else
+      Err = std::move(S.Err);
+  }
+  if (Err)
+    return std::move(Err);
+  return std::move(Ret);
+}
+
 static Expected<std::vector<MemberData>>
 computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                   object::Archive::Kind Kind, bool Thin, bool Deterministic,
-                  ArrayRef<NewArchiveMember> NewMembers) {
+                  bool NeedSymbols, ArrayRef<NewArchiveMember> NewMembers) {
   static char PaddingData[8] = {'\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n'};
 
   // This ignores the symbol table, but we only need the value mod 8 and the
@@ -396,6 +450,17 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
   std::vector<MemberData> Ret;
   bool HasObject = false;
 
+  // The symbol table is the only user of the symbols, don't parse the members
+  // if it isn't written.
+  std::vector<MemberSymbols> Symbols;
+  if (NeedSymbols) {
+    Expected<std::vector<MemberSymbols>> SymbolsOrErr =
+        readMemberSymbols(NewMembers);
+    if (Error E = SymbolsOrErr.takeError())
+      return std::move(E);
+    Symbols = std::move(*SymbolsOrErr);
+  }
+
   // Deduplicate long member names in the string table and reuse earlier name
   // offsets. This especially saves space for COFF Import libraries where all
   // members have the same name.
@@ -451,7 +516,8 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
       Entry.second = Entry.second > 1 ? 1 : 0;
   }
 
-  for (const NewArchiveMember &M : NewMembers) {
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+    const NewArchiveMember &M = NewMembers[I];
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -477,13 +543,19 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                       ModTime, Buf.getBufferSize() + MemberPadding);
     Out.flush();
 
-    Expected<std::vector<unsigned>> Symbols =
-        getSymbols(Buf, SymNames, HasObject);
-    if (auto E = Symbols.takeError())
-      return std::move(E);
+    std::vector<unsigned> Offsets;
+    if (NeedSymbols) {
+      MemberSymbols &S = Symbols[I];
+      unsigned Base = SymNames.tell();
+      Offsets = std::move(S.Offsets);
+      for (unsigned &Offset : Offsets)
+        Offset += Base;
+      SymNames << S.Names;
+      HasObject |= S.HasObject;
+    }
 
     Pos += Header.size() + Data.size() + Padding.size();
-    Ret.push_back({std::move(*Symbols), std::move(Header), Data, Padding});
+    Ret.push_back({std::move(Offsets), std::move(Header), Data, Padding});
   }
   // If there are no symbols, emit an empty symbol table, to satisfy Solaris
   // tools, older versions of which expect a symbol table in a non-empty
@@ -531,7 +603,8 @@ Error writeArchive(StringRef ArcName, ArrayRef<NewArchiveMember> NewMembers,
   raw_svector_ostream StringTable(StringTableBuf);
 
   Expected<std::vector<MemberData>> DataOrErr = computeMemberData(
-      StringTable, SymNames, Kind, Thin, Deterministic, NewMembers);
+      StringTable, SymNames, Kind, Thin, Deterministic, WriteSymtab,
+      NewMembers);
   if (Error E = DataOrErr.takeError())
     return E;
   std::vector<MemberData> &Data = *DataOrErr;
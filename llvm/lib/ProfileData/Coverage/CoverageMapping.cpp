@@ -16,6 +16,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallBitVector.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -232,6 +233,15 @@ Error CoverageMapping::loadFunctionRecord(
       Record.MappingRegions[0].Count.isZero() && Counts[0] > 0)
     return Error::success();
 
+  // Functions with no code in the files to load are dropped after the lookup
+  // in the profile, so that the count of hash mismatches doesn't depend on the
+  // files.
+  if (!SourceFiles.empty() &&
+      llvm::none_of(Record.Filenames, [&](StringRef Filename) {
+        return SourceFiles.count(Filename);
+      }))
+    return Error::success();
+
   FunctionRecord Function(OrigFuncName, Record.Filenames);
   for (const auto &Region : Record.MappingRegions) {
     Expected<int64_t> ExecutionCount = Ctx.evaluate(Region.Count);
@@ -254,8 +264,10 @@ Error CoverageMapping::loadFunctionRecord(
 
 Expected<std::unique_ptr<CoverageMapping>> CoverageMapping::load(
     ArrayRef<std::unique_ptr<CoverageMappingReader>> CoverageReaders,
-    IndexedInstrProfReader &ProfileReader) {
+    IndexedInstrProfReader &ProfileReader, ArrayRef<StringRef> SourceFiles) {
   auto Coverage = std::unique_ptr<CoverageMapping>(new CoverageMapping());
+  for (StringRef Filename : SourceFiles)
+    Coverage->SourceFiles.insert(Filename);
 
   for (const auto &CoverageReader : CoverageReaders) {
     for (auto RecordOrErr : *CoverageReader) {
@@ -272,7 +284,8 @@ Expected<std::unique_ptr<CoverageMapping>> CoverageMapping::load(
 
 Expected<std::unique_ptr<CoverageMapping>>
 CoverageMapping::load(ArrayRef<StringRef> ObjectFilenames,
-                      StringRef ProfileFilename, ArrayRef<StringRef> Arches) {
+                      StringRef ProfileFilename, ArrayRef<StringRef> Arches,
+                      ArrayRef<StringRef> SourceFiles) {
   auto ProfileReaderOrErr = IndexedInstrProfReader::create(ProfileFilename);
   if (Error E = ProfileReaderOrErr.takeError())
     return std::move(E);
@@ -292,7 +305,7 @@ CoverageMapping::load(ArrayRef<StringRef> ObjectFilenames,
     Readers.push_back(std::move(CoverageReaderOrErr.get()));
     Buffers.push_back(std::move(CovMappingBufOrErr.get()));
   }
-  return load(Readers, *ProfileReader);
+  return load(Readers, *ProfileReader, SourceFiles);
 }
 
 namespace {
@@ -484,6 +484,13 @@ Error RawInstrProfReader<IntPtrT>::readNextRecord(NamedInstrProfRecord &Record)
   if (Error E = readValueProfilingData(Record))
     return error(std::move(E));
 
+  // The counters of a sampled profile only saw one in every sampling period
+  // invocations, so scale them up to estimates of the real counts. Counts
+  // this large saturate rather than wrap around.
+  uint64_t SamplingPeriod = GET_SAMPLING_PERIOD(Version);
+  if (SamplingPeriod > 1)
+    Record.scale(SamplingPeriod, [](instrprof_error) {});
+
   // Iterate.
   advanceData();
   return success();
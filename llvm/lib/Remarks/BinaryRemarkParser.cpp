@@ -0,0 +1,158 @@
+//===- BinaryRemarkParser.cpp ---------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file provides utility methods used by clients that want to use the
+// parser for remarks in the binary format.
+//
+//===----------------------------------------------------------------------===//
+
+#include "BinaryRemarkParser.h"
+#include "llvm/Remarks/BinaryRemarkSerializer.h"
+#include "llvm/Support/LEB128.h"
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+Error BinaryRemarkParser::error(const char *Message) const {
+  return createStringError(std::make_error_code(std::errc::invalid_argument),
+                           "%s at offset %zu.", Message, Offset);
+}
+
+Expected<uint64_t> BinaryRemarkParser::parseULEB() {
+  const uint8_t *Start = Buffer.bytes_begin() + Offset;
+  unsigned Size = 0;
+  const char *ErrorMsg = nullptr;
+  uint64_t Value = decodeULEB128(Start, &Size, Buffer.bytes_end(), &ErrorMsg);
+  if (ErrorMsg)
+    return error(ErrorMsg);
+  Offset += Size;
+  return Value;
+}
+
+Expected<uint8_t> BinaryRemarkParser::parseByte() {
+  if (Offset == Buffer.size())
+    return error("unexpected end of buffer");
+  return Buffer[Offset++];
+}
+
+Expected<StringRef> BinaryRemarkParser::parseString() {
+  Expected<uint64_t> ID = parseULEB();
+  if (!ID)
+    return ID.takeError();
+  if (*ID < Strings.size())
+    return Strings[*ID];
+  if (*ID != Strings.size())
+    return error("invalid string ID");
+
+  // The first use of the string.
+  Expected<uint64_t> Size = parseULEB();
+  if (!Size)
+    return Size.takeError();
+  if (*Size > Buffer.size() - Offset)
+    return error("string past the end of buffer");
+  StringRef Str = Buffer.substr(Offset, *Size);
+  Offset += *Size;
+  Strings.push_back(Str);
+  return Str;
+}
+
+Expected<RemarkLocation> BinaryRemarkParser::parseLoc() {
+  Expected<StringRef> File = parseString();
+  if (!File)
+    return File.takeError();
+  Expected<uint64_t> Line = parseULEB();
+  if (!Line)
+    return Line.takeError();
+  Expected<uint64_t> Column = parseULEB();
+  if (!Column)
+    return Column.takeError();
+  return RemarkLocation{*File, static_cast<unsigned>(*Line),
+                        static_cast<unsigned>(*Column)};
+}
+
+Error BinaryRemarkParser::parseHeader() {
+  if (!Buffer.startswith(BinaryMagic))
+    return error("invalid magic number");
+  Offset = BinaryMagic.size();
+  Expected<uint64_t> Version = parseULEB();
+  if (!Version)
+    return Version.takeError();
+  if (*Version != BinaryVersion)
+    return error("unsupported version");
+  return Error::success();
+}
+
+Expected<const Remark *> BinaryRemarkParser::parseNext() {
+  if (Offset == Buffer.size())
+    return nullptr;
+
+  TheRemark = Remark();
+  TmpArgs.clear();
+
+  Expected<uint64_t> RemarkType = parseULEB();
+  if (!RemarkType)
+    return RemarkType.takeError();
+  if (*RemarkType > static_cast<uint64_t>(Type::LastTypeValue))
+    return error("invalid remark type");
+  TheRemark.RemarkType = static_cast<Type>(*RemarkType);
+
+  for (StringRef *Field : {&TheRemark.PassName, &TheRemark.RemarkName,
+                           &TheRemark.FunctionName}) {
+    Expected<StringRef> Str = parseString();
+    if (!Str)
+      return Str.takeError();
+    *Field = *Str;
+  }
+
+  Expected<uint8_t> Flags = parseByte();
+  if (!Flags)
+    return Flags.takeError();
+  if (*Flags & BinaryHasLoc) {
+    Expected<RemarkLocation> Loc = parseLoc();
+    if (!Loc)
+      return Loc.takeError();
+    TheRemark.Loc = *Loc;
+  }
+  if (*Flags & BinaryHasHotness) {
+    Expected<uint64_t> Hotness = parseULEB();
+    if (!Hotness)
+      return Hotness.takeError();
+    TheRemark.Hotness = *Hotness;
+  }
+
+  Expected<uint64_t> NumArgs = parseULEB();
+  if (!NumArgs)
+    return NumArgs.takeError();
+  // Each argument takes at least three bytes.
+  if (*NumArgs > (Buffer.size() - Offset) / 3)
+    return error("too many arguments");
+  for (uint64_t I = 0; I != *NumArgs; ++I) {
+    Argument Arg;
+    Expected<StringRef> Key = parseString();
+    if (!Key)
+      return Key.takeError();
+    Arg.Key = *Key;
+    Expected<StringRef> Val = parseString();
+    if (!Val)
+      return Val.takeError();
+    Arg.Val = *Val;
+    Expected<uint8_t> ArgFlags = parseByte();
+    if (!ArgFlags)
+      return ArgFlags.takeError();
+    if (*ArgFlags & BinaryHasLoc) {
+      Expected<RemarkLocation> Loc = parseLoc();
+      if (!Loc)
+        return Loc.takeError();
+      Arg.Loc = *Loc;
+    }
+    TmpArgs.push_back(Arg);
+  }
+  TheRemark.Args = TmpArgs;
+
+  return &TheRemark;
+}
@@ -0,0 +1,76 @@
+//===-- BinaryRemarkParser.h - Parser for binary remarks --------*- C++/-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file provides the impementation of the binary remark parser.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_REMARKS_BINARY_REMARK_PARSER_H
+#define LLVM_REMARKS_BINARY_REMARK_PARSER_H
+
+#include "RemarkParserImpl.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Support/Error.h"
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace remarks {
+/// Parses the remarks of a buffer in the binary format, in a single pass. The
+/// strings of the remarks point into the buffer, so nothing is copied.
+struct BinaryRemarkParser {
+  /// The whole buffer being parsed.
+  StringRef Buffer;
+  /// The current position in the buffer.
+  size_t Offset = 0;
+  /// The strings seen so far, by ID.
+  std::vector<StringRef> Strings;
+  /// Storage for the arguments of the current remark.
+  SmallVector<Argument, 8> TmpArgs;
+  /// The latest parsed remark. Invalidated with every call to `parseNext`.
+  Remark TheRemark;
+
+  BinaryRemarkParser(StringRef Buffer) : Buffer(Buffer) {}
+
+  /// Check the magic number and the version at the start of the buffer.
+  Error parseHeader();
+  /// Return the next remark, or nullptr at the end of the buffer.
+  Expected<const Remark *> parseNext();
+
+private:
+  Error error(const char *Message) const;
+  Expected<uint64_t> parseULEB();
+  Expected<uint8_t> parseByte();
+  Expected<StringRef> parseString();
+  Expected<RemarkLocation> parseLoc();
+};
+
+/// Binary to Remark parser.
+struct BinaryParserImpl : public ParserImpl {
+  /// The object parsing the binary remarks.
+  BinaryRemarkParser BinaryParser;
+  /// Set to `true` once the header was checked.
+  bool ParsedHeader = false;
+  /// Set to `true` if we had any errors during parsing.
+  bool HasErrors = false;
+  /// The message of the last error.
+  std::string ErrorString;
+
+  BinaryParserImpl(StringRef Buf)
+      : ParserImpl{ParserImpl::Kind::Binary}, BinaryParser(Buf) {}
+
+  static bool classof(const ParserImpl *PI) {
+    return PI->ParserKind == ParserImpl::Kind::Binary;
+  }
+};
+} // end namespace remarks
+} // end namespace llvm
+
+#endif /* LLVM_REMARKS_BINARY_REMARK_PARSER_H */
@@ -0,0 +1,67 @@
+//===- BinaryRemarkSerializer.cpp -----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file provides the implementation of the binary remark serializer.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Remarks/BinaryRemarkSerializer.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+BinarySerializer::BinarySerializer(raw_ostream &OS) : OS(OS), StrTab() {
+  OS << BinaryMagic;
+  encodeULEB128(BinaryVersion, OS);
+}
+
+void BinarySerializer::emitString(StringRef Str) {
+  size_t NumStrings = StrTab.StrTab.size();
+  unsigned ID = StrTab.add(Str).first;
+  encodeULEB128(ID, OS);
+  // A new string is written in place, after its ID.
+  if (StrTab.StrTab.size() != NumStrings) {
+    encodeULEB128(Str.size(), OS);
+    OS << Str;
+  }
+}
+
+void BinarySerializer::emitLoc(const RemarkLocation &Loc) {
+  emitString(Loc.SourceFilePath);
+  encodeULEB128(Loc.SourceLine, OS);
+  encodeULEB128(Loc.SourceColumn, OS);
+}
+
+void BinarySerializer::emit(const Remark &Remark) {
+  encodeULEB128(static_cast<uint64_t>(Remark.RemarkType), OS);
+  emitString(Remark.PassName);
+  emitString(Remark.RemarkName);
+  emitString(Remark.FunctionName);
+
+  uint8_t Flags = 0;
+  if (Remark.Loc)
+    Flags |= BinaryHasLoc;
+  if (Remark.Hotness)
+    Flags |= BinaryHasHotness;
+  OS.write(Flags);
+  if (Remark.Loc)
+    emitLoc(*Remark.Loc);
+  if (Remark.Hotness)
+    encodeULEB128(*Remark.Hotness, OS);
+
+  encodeULEB128(Remark.Args.size(), OS);
+  for (const Argument &Arg : Remark.Args) {
+    emitString(Arg.Key);
+    emitString(Arg.Val);
+    OS.write(Arg.Loc ? BinaryHasLoc : 0);
+    if (Arg.Loc)
+      emitLoc(*Arg.Loc);
+  }
+}
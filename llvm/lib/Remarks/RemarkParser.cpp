@@ -12,19 +12,29 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Remarks/RemarkParser.h"
+#include "BinaryRemarkParser.h"
 #include "YAMLRemarkParser.h"
 #include "llvm-c/Remarks.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Remarks/BinaryRemarkSerializer.h"
 #include "llvm/Support/CBindingWrapping.h"
 
 using namespace llvm;
 using namespace llvm::remarks;
 
-Parser::Parser(StringRef Buf) : Impl(llvm::make_unique<YAMLParserImpl>(Buf)) {}
+static std::unique_ptr<ParserImpl> createParserImpl(StringRef Buf) {
+  if (Buf.startswith(BinaryMagic))
+    return llvm::make_unique<BinaryParserImpl>(Buf);
+  return llvm::make_unique<YAMLParserImpl>(Buf);
+}
+
+Parser::Parser(StringRef Buf) : Impl(createParserImpl(Buf)) {}
 
 Parser::Parser(StringRef Buf, StringRef StrTabBuf)
     : Impl(llvm::make_unique<YAMLParserImpl>(Buf, StrTabBuf)) {}
 
+Parser::Parser(std::unique_ptr<ParserImpl> Impl) : Impl(std::move(Impl)) {}
+
 Parser::~Parser() = default;
 
 static Expected<const Remark *> getNextYAML(YAMLParserImpl &Impl) {
@@ -53,9 +63,25 @@ static Expected<const Remark *> getNextYAML(YAMLParserImpl &Impl) {
                              "unexpected error while parsing.");
 }
 
+static Expected<const Remark *> getNextBinary(BinaryParserImpl &Impl) {
+  if (!Impl.ParsedHeader) {
+    if (Error E = Impl.BinaryParser.parseHeader())
+      return std::move(E);
+    Impl.ParsedHeader = true;
+  }
+  Expected<const Remark *> RemarkOrErr = Impl.BinaryParser.parseNext();
+  // Don't go on after a malformed remark, in case the user calls getNext
+  // again.
+  if (!RemarkOrErr)
+    Impl.BinaryParser.Offset = Impl.BinaryParser.Buffer.size();
+  return RemarkOrErr;
+}
+
 Expected<const Remark *> Parser::getNext() const {
   if (auto *Impl = dyn_cast<YAMLParserImpl>(this->Impl.get()))
     return getNextYAML(*Impl);
+  if (auto *Impl = dyn_cast<BinaryParserImpl>(this->Impl.get()))
+    return getNextBinary(*Impl);
   llvm_unreachable("Get next called with an unknown parsing implementation.");
 }
 
@@ -93,6 +119,12 @@ extern "C" LLVMRemarkParserRef LLVMRemarkParserCreateYAML(const void *Buf,
       new remarks::Parser(StringRef(static_cast<const char *>(Buf), Size)));
 }
 
+extern "C" LLVMRemarkParserRef LLVMRemarkParserCreateBinary(const void *Buf,
+                                                            uint64_t Size) {
+  return wrap(new remarks::Parser(llvm::make_unique<remarks::BinaryParserImpl>(
+      StringRef(static_cast<const char *>(Buf), Size))));
+}
+
 static void handleYAMLError(remarks::YAMLParserImpl &Impl, Error E) {
   handleAllErrors(
       std::move(E),
@@ -113,7 +145,11 @@ LLVMRemarkParserGetNext(LLVMRemarkParserRef Parser) {
     // Error during parsing.
     if (auto *Impl = dyn_cast<remarks::YAMLParserImpl>(TheParser.Impl.get()))
       handleYAMLError(*Impl, RemarkOrErr.takeError());
-    else
+    else if (auto *Impl =
+                 dyn_cast<remarks::BinaryParserImpl>(TheParser.Impl.get())) {
+      Impl->ErrorString = toString(RemarkOrErr.takeError());
+      Impl->HasErrors = true;
+    } else
       llvm_unreachable("unkown parser implementation.");
     return nullptr;
   }
@@ -128,6 +164,9 @@ extern "C" LLVMBool LLVMRemarkParserHasError(LLVMRemarkParserRef Parser) {
   if (auto *Impl =
           dyn_cast<remarks::YAMLParserImpl>(unwrap(Parser)->Impl.get()))
     return Impl->HasErrors;
+  if (auto *Impl =
+          dyn_cast<remarks::BinaryParserImpl>(unwrap(Parser)->Impl.get()))
+    return Impl->HasErrors;
   llvm_unreachable("unkown parser implementation.");
 }
 
@@ -136,6 +175,9 @@ LLVMRemarkParserGetErrorMessage(LLVMRemarkParserRef Parser) {
   if (auto *Impl =
           dyn_cast<remarks::YAMLParserImpl>(unwrap(Parser)->Impl.get()))
     return Impl->YAMLParser.ErrorStream.str().c_str();
+  if (auto *Impl =
+          dyn_cast<remarks::BinaryParserImpl>(unwrap(Parser)->Impl.get()))
+    return Impl->ErrorString.c_str();
   llvm_unreachable("unkown parser implementation.");
 }
 
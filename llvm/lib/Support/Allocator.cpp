@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/Memory.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace llvm {
@@ -28,6 +30,26 @@ void printBumpPtrAllocatorStats(unsigned NumSlabs, size_t BytesAllocated,
 
 } // End namespace detail.
 
+void *MappedMemoryAllocator::Allocate(size_t Size, size_t Alignment) {
+  assert(Alignment <= sys::Process::getPageSizeEstimate() &&
+         "Mapped memory is only page aligned");
+  (void)Alignment;
+  unsigned Flags = sys::Memory::MF_READ | sys::Memory::MF_WRITE;
+  if (HugePages)
+    Flags |= sys::Memory::MF_HUGE_HINT;
+  std::error_code EC;
+  sys::MemoryBlock Block =
+      sys::Memory::allocateMappedMemory(Size, nullptr, Flags, EC);
+  if (EC || !Block.base())
+    report_bad_alloc_error("Allocation failed");
+  return Block.base();
+}
+
+void MappedMemoryAllocator::Deallocate(const void *Ptr, size_t Size) {
+  sys::MemoryBlock Block(const_cast<void *>(Ptr), Size);
+  sys::Memory::releaseMappedMemory(Block);
+}
+
 void PrintRecyclerStats(size_t Size,
                         size_t Align,
                         size_t FreeListSize) {
@@ -12,6 +12,7 @@
 
 #include "llvm/Support/CachePruning.h"
 
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
@@ -140,6 +141,14 @@ llvm::parseCachePruningPolicy(StringRef PolicyStr) {
   return Policy;
 }
 
+/// Returns true if \p File is a directory of the entries of a sharded cache,
+/// which is named after the first two hexadecimal digits of their keys.
+static bool isShardDirectory(const sys::fs::directory_entry &File) {
+  StringRef Name = sys::path::filename(File.path());
+  return File.type() == sys::fs::file_type::directory_file &&
+         Name.size() == 2 && isHexDigit(Name[0]) && isHexDigit(Name[1]);
+}
+
 /// Prune the cache of files that haven't been accessed in a long time.
 bool llvm::pruneCache(StringRef Path, CachePruningPolicy Policy) {
   using namespace std::chrono;
@@ -204,42 +213,55 @@ bool llvm::pruneCache(StringRef Path, CachePruningPolicy Policy) {
   std::set<FileInfo> FileInfos;
   uint64_t TotalSize = 0;
 
-  // Walk the entire directory cache, looking for unused files.
-  std::error_code EC;
-  SmallString<128> CachePathNative;
-  sys::path::native(Path, CachePathNative);
-  // Walk all of the files within this directory.
-  for (sys::fs::directory_iterator File(CachePathNative, EC), FileEnd;
-       File != FileEnd && !EC; File.increment(EC)) {
+  auto VisitFile = [&](const sys::fs::directory_entry &File) {
     // Ignore any files not beginning with the string "llvmcache-". This
     // includes the timestamp file as well as any files created by the user.
     // This acts as a safeguard against data loss if the user specifies the
     // wrong directory as their cache directory.
-    if (!sys::path::filename(File->path()).startswith("llvmcache-"))
-      continue;
+    if (!sys::path::filename(File.path()).startswith("llvmcache-"))
+      return;
 
     // Look at this file. If we can't stat it, there's nothing interesting
     // there.
-    ErrorOr<sys::fs::basic_file_status> StatusOrErr = File->status();
+    ErrorOr<sys::fs::basic_file_status> StatusOrErr = File.status();
     if (!StatusOrErr) {
-      LLVM_DEBUG(dbgs() << "Ignore " << File->path() << " (can't stat)\n");
-      continue;
+      LLVM_DEBUG(dbgs() << "Ignore " << File.path() << " (can't stat)\n");
+      return;
     }
 
     // If the file hasn't been used recently enough, delete it
     const auto FileAccessTime = StatusOrErr->getLastAccessedTime();
     auto FileAge = CurrentTime - FileAccessTime;
     if (Policy.Expiration != seconds(0) && FileAge > Policy.Expiration) {
-      LLVM_DEBUG(dbgs() << "Remove " << File->path() << " ("
+      LLVM_DEBUG(dbgs() << "Remove " << File.path() << " ("
                         << duration_cast<seconds>(FileAge).count()
                         << "s old)\n");
-      sys::fs::remove(File->path());
-      continue;
+      sys::fs::remove(File.path());
+      return;
     }
 
     // Leave it here for now, but add it to the list of size-based pruning.
     TotalSize += StatusOrErr->getSize();
-    FileInfos.insert({FileAccessTime, StatusOrErr->getSize(), File->path()});
+    FileInfos.insert({FileAccessTime, StatusOrErr->getSize(), File.path()});
+  };
+
+  // Walk the entire directory cache, looking for unused files.
+  std::error_code EC;
+  SmallString<128> CachePathNative;
+  sys::path::native(Path, CachePathNative);
+  // Walk all of the files within this directory.
+  for (sys::fs::directory_iterator File(CachePathNative, EC), FileEnd;
+       File != FileEnd && !EC; File.increment(EC)) {
+    if (!isShardDirectory(*File)) {
+      VisitFile(*File);
+      continue;
+    }
+
+    // Walk the files of the shard of a sharded cache.
+    std::error_code ShardEC;
+    for (sys::fs::directory_iterator ShardFile(File->path(), ShardEC);
+         ShardFile != FileEnd && !ShardEC; ShardFile.increment(ShardEC))
+      VisitFile(*ShardFile);
   }
 
   auto FileInfo = FileInfos.begin();
@@ -150,6 +150,18 @@ public:
   // This collects the different subcommands that have been registered.
   SmallPtrSet<SubCommand *, 4> RegisteredSubCommands;
 
+  // Options and literal options are only queued when they are constructed,
+  // which is mostly during static initialization. They are added to their
+  // SubCommands by registerPendingOptions the first time the parser needs
+  // them, so that the static constructors don't fill the option maps of
+  // tools which never parse a command line.
+  struct PendingOption {
+    Option *Opt;
+    // The name of a literal option, empty for a regular option.
+    StringRef LiteralName;
+  };
+  std::vector<PendingOption> PendingOptions;
+
   CommandLineParser() : ActiveSubCommand(nullptr) {
     registerSubCommand(&*TopLevelSubCommand);
     registerSubCommand(&*AllSubCommands);
@@ -181,6 +193,24 @@ public:
     }
   }
 
+  void queueLiteralOption(Option &Opt, StringRef Name) {
+    if (Opt.hasArgStr())
+      return;
+    PendingOptions.push_back({&Opt, Name});
+  }
+
+  void queueOption(Option *O) { PendingOptions.push_back({O, StringRef()}); }
+
+  void registerPendingOptions() {
+    for (const PendingOption &P : PendingOptions) {
+      if (P.LiteralName.empty())
+        addOption(P.Opt);
+      else
+        addLiteralOption(*P.Opt, P.LiteralName);
+    }
+    PendingOptions.clear();
+  }
+
   void addLiteralOption(Option &Opt, StringRef Name) {
     if (Opt.Subs.empty())
       addLiteralOption(Opt, &*TopLevelSubCommand, Name);
@@ -285,6 +315,7 @@ public:
   }
 
   void removeOption(Option *O) {
+    registerPendingOptions();
     if (O->Subs.empty())
       removeOption(O, &*TopLevelSubCommand);
     else {
@@ -324,6 +355,7 @@ public:
   }
 
   void updateArgStr(Option *O, StringRef NewName) {
+    registerPendingOptions();
     if (O->Subs.empty())
       updateArgStr(O, NewName, &*TopLevelSubCommand);
     else {
@@ -356,6 +388,7 @@ public:
                              (Sub->getName() == sub->getName());
                     }) == 0 &&
            "Duplicate subcommands");
+    registerPendingOptions();
     RegisteredSubCommands.insert(sub);
 
     // For all options that have been registered for all subcommands, add the
@@ -420,7 +453,7 @@ private:
 static ManagedStatic<CommandLineParser> GlobalParser;
 
 void cl::AddLiteralOption(Option &O, StringRef Name) {
-  GlobalParser->addLiteralOption(O, Name);
+  GlobalParser->queueLiteralOption(O, Name);
 }
 
 extrahelp::extrahelp(StringRef Help) : morehelp(Help) {
@@ -428,7 +461,7 @@ extrahelp::extrahelp(StringRef Help) : morehelp(Help) {
 }
 
 void Option::addArgument() {
-  GlobalParser->addOption(this);
+  GlobalParser->queueOption(this);
   FullyInitialized = true;
 }
 
@@ -1205,6 +1238,7 @@ bool cl::ParseCommandLineOptions(int argc, const char *const *argv,
 void CommandLineParser::ResetAllOptionOccurrences() {
   // So that we can parse different command lines multiple times in succession
   // we reset all option values to look like they have never been seen before.
+  registerPendingOptions();
   for (auto SC : RegisteredSubCommands) {
     for (auto &O : SC->OptionsMap)
       O.second->reset();
@@ -1216,6 +1250,7 @@ bool CommandLineParser::ParseCommandLineOptions(int argc,
                                                 StringRef Overview,
                                                 raw_ostream *Errs,
                                                 bool LongOptionsUseDoubleDash) {
+  registerPendingOptions();
   assert(hasOptions() && "No options specified!");
 
   // Expand response files.
@@ -2047,6 +2082,7 @@ public:
   }
 
   void printHelp() {
+    GlobalParser->registerPendingOptions();
     SubCommand *Sub = GlobalParser->getActiveSubCommand();
     auto &OptionsMap = Sub->OptionsMap;
     auto &PositionalOpts = Sub->PositionalOpts;
@@ -2306,6 +2342,7 @@ void CommandLineParser::printOptionValues() {
   if (!PrintOptions && !PrintAllOptions)
     return;
 
+  registerPendingOptions();
   SmallVector<std::pair<const char *, Option *>, 128> Opts;
   sortOpts(ActiveSubCommand->OptionsMap, Opts, /*ShowHidden*/ true);
 
@@ -2411,6 +2448,7 @@ void cl::AddExtraVersionPrinter(VersionPrinterTy func) {
 }
 
 StringMap<Option *> &cl::getRegisteredOptions(SubCommand &Sub) {
+  GlobalParser->registerPendingOptions();
   auto &Subs = GlobalParser->RegisteredSubCommands;
   (void)Subs;
   assert(is_contained(Subs, &Sub));
@@ -2423,6 +2461,7 @@ cl::getRegisteredSubcommands() {
 }
 
 void cl::HideUnrelatedOptions(cl::OptionCategory &Category, SubCommand &Sub) {
+  GlobalParser->registerPendingOptions();
   for (auto &I : Sub.OptionsMap) {
     for (auto &Cat : I.second->Categories) {
       if (Cat != &Category &&
@@ -2434,6 +2473,7 @@ void cl::HideUnrelatedOptions(cl::OptionCategory &Category, SubCommand &Sub) {
 
 void cl::HideUnrelatedOptions(ArrayRef<const cl::OptionCategory *> Categories,
                               SubCommand &Sub) {
+  GlobalParser->registerPendingOptions();
   for (auto &I : Sub.OptionsMap) {
     for (auto &Cat : I.second->Categories) {
       if (find(Categories, Cat) == Categories.end() && Cat != &GenericCategory)
@@ -0,0 +1,308 @@
+//===--- CompactStringMap.cpp - Open addressed string map -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the CompactStringMap class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/CompactStringMap.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/DJB.h"
+#include "llvm/Support/MathExtras.h"
+#include <cassert>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace llvm;
+
+namespace {
+
+// The control bytes of the full buckets are the low 7 bits of the hash of
+// their keys, so their high bit is clear.
+enum : uint8_t { CtrlEmpty = 0x80, CtrlDeleted = 0xfe };
+
+const unsigned GroupWidth = 16;
+
+/// The control bytes of a group of GroupWidth buckets, the queries returning
+/// the mask of the buckets matching.
+class ControlGroup {
+#ifdef __SSE2__
+  __m128i Ctrl;
+
+  uint32_t matchByte(uint8_t Byte) const {
+    return _mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(Byte)), Ctrl));
+  }
+
+public:
+  explicit ControlGroup(const uint8_t *Bytes)
+      : Ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(Bytes))) {}
+
+  uint32_t matchEmptyOrDeleted() const {
+    // Only the empty and deleted control bytes have their high bit set.
+    return _mm_movemask_epi8(Ctrl);
+  }
+#else
+  const uint8_t *Bytes;
+
+  uint32_t matchByte(uint8_t Byte) const {
+    uint32_t Mask = 0;
+    for (unsigned I = 0; I != GroupWidth; ++I)
+      Mask |= uint32_t(Bytes[I] == Byte) << I;
+    return Mask;
+  }
+
+public:
+  explicit ControlGroup(const uint8_t *Bytes) : Bytes(Bytes) {}
+
+  uint32_t matchEmptyOrDeleted() const {
+    uint32_t Mask = 0;
+    for (unsigned I = 0; I != GroupWidth; ++I)
+      Mask |= uint32_t(Bytes[I] >> 7) << I;
+    return Mask;
+  }
+#endif
+
+  uint32_t match(uint8_t Hash) const { return matchByte(Hash); }
+  uint32_t matchEmpty() const { return matchByte(CtrlEmpty); }
+};
+
+/// The sequence of the groups probed for a hash value. The probe amount grows
+/// by one group at each step, so all the groups are visited.
+class ProbeSequence {
+  unsigned Group;
+  unsigned Mask;
+  unsigned ProbeAmt = 0;
+
+public:
+  ProbeSequence(unsigned FullHashValue, unsigned NumBuckets)
+      : Group((FullHashValue >> 7) & (NumBuckets / GroupWidth - 1)),
+        Mask(NumBuckets / GroupWidth - 1) {}
+
+  /// The first bucket of the current group.
+  unsigned getOffset() const { return Group * GroupWidth; }
+
+  void next() { Group = (Group + ++ProbeAmt) & Mask; }
+};
+
+} // end anonymous namespace
+
+static uint8_t getControlHash(unsigned FullHashValue) {
+  return FullHashValue & 0x7f;
+}
+
+/// Returns the number of buckets to allocate to ensure that the map can
+/// accommodate \p NumEntries without need to grow().
+static unsigned getMinBucketToReserveForEntries(unsigned NumEntries) {
+  // Ensure that "NumEntries * 8 <= NumBuckets * 7"
+  if (NumEntries == 0)
+    return 0;
+  return std::max(GroupWidth,
+                  unsigned(PowerOf2Ceil((uint64_t(NumEntries) * 8 + 6) / 7)));
+}
+
+CompactStringMapImpl::CompactStringMapImpl(unsigned InitSize,
+                                           unsigned itemSize) {
+  ItemSize = itemSize;
+
+  // If a size is specified, initialize the table with that many buckets.
+  if (InitSize) {
+    init(getMinBucketToReserveForEntries(InitSize));
+    return;
+  }
+
+  // Otherwise, initialize it with zero buckets to avoid the allocation.
+  TheTable = nullptr;
+  NumBuckets = 0;
+  NumItems = 0;
+  NumTombstones = 0;
+}
+
+void CompactStringMapImpl::init(unsigned InitSize) {
+  assert((InitSize & (InitSize-1)) == 0 &&
+         "Init Size must be a power of 2 or zero!");
+  assert((InitSize == 0 || InitSize >= GroupWidth) &&
+         "Init Size must hold a group of buckets!");
+
+  unsigned NewNumBuckets = InitSize ? InitSize : GroupWidth;
+  NumItems = 0;
+  NumTombstones = 0;
+
+  TheTable = static_cast<StringMapEntryBase **>(
+      safe_calloc(1, getTableSize(NewNumBuckets)));
+
+  // Set the member only if TheTable was successfully allocated
+  NumBuckets = NewNumBuckets;
+  memset(getControlBytes(), CtrlEmpty, NumBuckets);
+
+  // Allocate one extra bucket, set it to look filled so the iterators stop at
+  // end.
+  TheTable[NumBuckets] = (StringMapEntryBase*)2;
+}
+
+void CompactStringMapImpl::clearTable() {
+  memset(TheTable, 0, NumBuckets * sizeof(StringMapEntryBase *));
+  memset(getControlBytes(), CtrlEmpty, NumBuckets);
+  NumItems = 0;
+  NumTombstones = 0;
+}
+
+/// LookupBucketFor - Look up the bucket that the specified string should end
+/// up in.  If it already exists as a key in the map, the Item pointer for the
+/// specified bucket will be non-null.  Otherwise, it will be null or a
+/// tombstone, and the bucket must be filled by the caller.
+unsigned CompactStringMapImpl::LookupBucketFor(StringRef Name) {
+  if (NumBuckets == 0) // Hash table unallocated so far?
+    init(GroupWidth);
+  unsigned FullHashValue = djbHash(Name, 0);
+  uint8_t ControlHash = getControlHash(FullHashValue);
+  unsigned *HashTable = getHashTable();
+  uint8_t *Ctrl = getControlBytes();
+
+  int FirstFree = -1;
+  for (ProbeSequence Seq(FullHashValue, NumBuckets);; Seq.next()) {
+    unsigned Offset = Seq.getOffset();
+    ControlGroup Group(Ctrl + Offset);
+    for (uint32_t Mask = Group.match(ControlHash); Mask; Mask &= Mask - 1) {
+      unsigned BucketNo = Offset + countTrailingZeros(Mask);
+      // Do the comparison like this because Name isn't necessarily
+      // null-terminated!
+      StringMapEntryBase *BucketItem = TheTable[BucketNo];
+      char *ItemStr = (char*)BucketItem+ItemSize;
+      if (LLVM_LIKELY(HashTable[BucketNo] == FullHashValue) &&
+          Name == StringRef(ItemStr, BucketItem->getKeyLength()))
+        return BucketNo;
+    }
+
+    // The key would be in the first empty or deleted bucket, the probing
+    // stops at the first group with an empty bucket.
+    if (FirstFree == -1)
+      if (uint32_t Free = Group.matchEmptyOrDeleted())
+        FirstFree = Offset + countTrailingZeros(Free);
+    if (LLVM_LIKELY(Group.matchEmpty()))
+      break;
+  }
+
+  assert(FirstFree != -1 && "Probing found no empty bucket");
+  HashTable[FirstFree] = FullHashValue;
+  Ctrl[FirstFree] = ControlHash;
+  return FirstFree;
+}
+
+/// FindKey - Look up the bucket that contains the specified key. If it exists
+/// in the map, return the bucket number of the key.  Otherwise return -1.
+/// This does not modify the map.
+int CompactStringMapImpl::FindKey(StringRef Key) const {
+  if (NumBuckets == 0) return -1;  // Really empty table?
+  unsigned FullHashValue = djbHash(Key, 0);
+  uint8_t ControlHash = getControlHash(FullHashValue);
+  const unsigned *HashTable = getHashTable();
+  const uint8_t *Ctrl = getControlBytes();
+
+  for (ProbeSequence Seq(FullHashValue, NumBuckets);; Seq.next()) {
+    unsigned Offset = Seq.getOffset();
+    ControlGroup Group(Ctrl + Offset);
+    for (uint32_t Mask = Group.match(ControlHash); Mask; Mask &= Mask - 1) {
+      unsigned BucketNo = Offset + countTrailingZeros(Mask);
+      StringMapEntryBase *BucketItem = TheTable[BucketNo];
+      char *ItemStr = (char*)BucketItem+ItemSize;
+      if (LLVM_LIKELY(HashTable[BucketNo] == FullHashValue) &&
+          Key == StringRef(ItemStr, BucketItem->getKeyLength()))
+        return BucketNo;
+    }
+    if (LLVM_LIKELY(Group.matchEmpty()))
+      return -1;
+  }
+}
+
+/// RemoveKey - Remove the specified StringMapEntry from the table, but do not
+/// delete it.  This aborts if the value isn't in the table.
+void CompactStringMapImpl::RemoveKey(StringMapEntryBase *V) {
+  const char *VStr = (char*)V + ItemSize;
+  StringMapEntryBase *V2 = RemoveKey(StringRef(VStr, V->getKeyLength()));
+  (void)V2;
+  assert(V == V2 && "Didn't find key?");
+}
+
+/// RemoveKey - Remove the StringMapEntry for the specified key from the
+/// table, returning it.  If the key is not in the table, this returns null.
+StringMapEntryBase *CompactStringMapImpl::RemoveKey(StringRef Key) {
+  int Bucket = FindKey(Key);
+  if (Bucket == -1) return nullptr;
+
+  StringMapEntryBase *Result = TheTable[Bucket];
+  --NumItems;
+
+  // No probing went past a group with an empty bucket, so the bucket can be
+  // emptied rather than become a tombstone.
+  uint8_t *Ctrl = getControlBytes();
+  if (ControlGroup(Ctrl + Bucket / GroupWidth * GroupWidth).matchEmpty()) {
+    TheTable[Bucket] = nullptr;
+    Ctrl[Bucket] = CtrlEmpty;
+    return Result;
+  }
+
+  TheTable[Bucket] = getTombstoneVal();
+  Ctrl[Bucket] = CtrlDeleted;
+  ++NumTombstones;
+  assert(NumItems + NumTombstones <= NumBuckets);
+
+  return Result;
+}
+
+/// RehashTable - Grow the table, redistributing values into the buckets with
+/// the appropriate mod-of-hashtable-size.
+unsigned CompactStringMapImpl::RehashTable(unsigned BucketNo) {
+  // If more than 7/8 of the buckets are full or tombstones, grow the table,
+  // or only rehash it if the tombstones are most of them.
+  if (LLVM_LIKELY((NumItems + NumTombstones) * 8 <= NumBuckets * 7))
+    return BucketNo;
+  unsigned NewSize = NumItems * 16 > NumBuckets * 7 ? NumBuckets * 2
+                                                    : NumBuckets;
+
+  unsigned NewBucketNo = BucketNo;
+  // Allocate one extra bucket which will always be non-empty.  This allows the
+  // iterators to stop at end.
+  auto NewTableArray = static_cast<StringMapEntryBase **>(
+      safe_calloc(1, getTableSize(NewSize)));
+  unsigned *NewHashArray =
+      reinterpret_cast<unsigned *>(NewTableArray + NewSize + 1);
+  uint8_t *NewCtrl = reinterpret_cast<uint8_t *>(NewHashArray + NewSize + 1);
+  memset(NewCtrl, CtrlEmpty, NewSize);
+  NewTableArray[NewSize] = (StringMapEntryBase*)2;
+
+  // Rehash all the items into their new buckets, the first empty one of their
+  // probe sequence, with the hash values already available.
+  unsigned *HashTable = getHashTable();
+  for (unsigned I = 0, E = NumBuckets; I != E; ++I) {
+    StringMapEntryBase *Bucket = TheTable[I];
+    if (!Bucket || Bucket == getTombstoneVal())
+      continue;
+    unsigned FullHash = HashTable[I];
+    ProbeSequence Seq(FullHash, NewSize);
+    uint32_t Empty;
+    while (!(Empty = ControlGroup(NewCtrl + Seq.getOffset()).matchEmpty()))
+      Seq.next();
+
+    unsigned NewBucket = Seq.getOffset() + countTrailingZeros(Empty);
+    NewTableArray[NewBucket] = Bucket;
+    NewHashArray[NewBucket] = FullHash;
+    NewCtrl[NewBucket] = getControlHash(FullHash);
+    if (I == BucketNo)
+      NewBucketNo = NewBucket;
+  }
+
+  free(TheTable);
+
+  TheTable = NewTableArray;
+  NumBuckets = NewSize;
+  NumTombstones = 0;
+  return NewBucketNo;
+}
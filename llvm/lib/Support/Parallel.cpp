@@ -9,13 +9,17 @@
 #include "llvm/Support/Parallel.h"
 #include "llvm/Config/llvm-config.h"
 
+unsigned llvm::parallel::ThreadCount = 0;
+
 #if LLVM_ENABLE_THREADS
 
 #include "llvm/Support/Threading.h"
 
+#include <algorithm>
 #include <atomic>
-#include <stack>
+#include <deque>
 #include <thread>
+#include <vector>
 
 namespace llvm {
 namespace parallel {
@@ -27,7 +31,8 @@ namespace {
 class Executor {
 public:
   virtual ~Executor() = default;
-  virtual void add(std::function<void()> func) = 0;
+  /// Runs \p func some time later, \p Group is the task group spawning it.
+  virtual void add(std::function<void()> func, const TaskGroup *Group) = 0;
 
   static Executor *getDefaultExecutor();
 };
@@ -48,7 +53,7 @@ class ConcRTExecutor : public Executor {
   };
 
 public:
-  virtual void add(std::function<void()> F) {
+  virtual void add(std::function<void()> F, const TaskGroup *) {
     Concurrency::CurrentScheduler::ScheduleTask(
         Taskish::run, new (concurrency::Alloc(sizeof(Taskish))) Taskish(F));
   }
@@ -60,19 +65,21 @@ Executor *Executor::getDefaultExecutor() {
 }
 
 #else
-/// An implementation of an Executor that runs closures on a thread pool
-///   in filo order.
+/// An implementation of an Executor that runs closures on a thread pool.
+/// Every worker has a queue of its own, it runs the tasks it adds in filo
+/// order and, when its queue is empty, steals the oldest tasks of the other
+/// workers, so that the workers don't contend on a single queue.
 class ThreadPoolExecutor : public Executor {
 public:
-  explicit ThreadPoolExecutor(unsigned ThreadCount = hardware_concurrency())
-      : Done(ThreadCount) {
+  explicit ThreadPoolExecutor(unsigned ThreadCount)
+      : Queues(ThreadCount), Done(ThreadCount) {
     // Spawn all but one of the threads in another thread as spawning threads
     // can take a while.
     std::thread([&, ThreadCount] {
-      for (size_t i = 1; i < ThreadCount; ++i) {
-        std::thread([=] { work(); }).detach();
+      for (unsigned I = 1; I < ThreadCount; ++I) {
+        std::thread([=] { work(I); }).detach();
       }
-      work();
+      work(0);
     }).detach();
   }
 
@@ -84,42 +91,137 @@ public:
     // Wait for ~Latch.
   }
 
-  void add(std::function<void()> F) override {
-    std::unique_lock<std::mutex> Lock(Mutex);
-    WorkStack.push(F);
-    Lock.unlock();
-    Cond.notify_one();
+  void add(std::function<void()> F, const TaskGroup *Group) override {
+    // The tasks added by the other threads are spread over the workers.
+    unsigned I = CurrentWorker != NoWorker ? CurrentWorker
+                                           : NextQueue++ % Queues.size();
+    {
+      std::lock_guard<std::mutex> Lock(Queues[I].Mutex);
+      Queues[I].Tasks.push_back({std::move(F), Group});
+    }
+    ++Pending;
+    // Pending is incremented before Sleeping is read and a worker increments
+    // Sleeping before reading Pending, so one of the two sees the other.
+    if (Sleeping > 0) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      Cond.notify_one();
+    }
+  }
+
+  /// Runs on the calling thread a pending task that \p Group spawned.
+  /// Returns false if no task of the group is left in the queues.
+  ///
+  /// The tasks of the group are usually the newest ones of the queue of the
+  /// calling worker, but the threads outside the pool add their tasks on top
+  /// of the queues of the workers and the other workers may add tasks of the
+  /// group too, so all the queues are searched.
+  bool runGroupTask(const TaskGroup *Group) {
+    std::function<void()> F;
+    const unsigned N = Queues.size();
+    const unsigned First = CurrentWorker != NoWorker ? CurrentWorker : 0;
+    for (unsigned I = 0; I < N && !F; ++I) {
+      WorkQueue &Q = Queues[(First + I) % N];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      auto It = std::find_if(Q.Tasks.rbegin(), Q.Tasks.rend(),
+                             [&](const Task &T) { return T.Group == Group; });
+      if (It == Q.Tasks.rend())
+        continue;
+      F = std::move(It->F);
+      Q.Tasks.erase(std::next(It).base());
+      --Pending;
+    }
+    if (!F)
+      return false;
+    F();
+    return true;
   }
 
 private:
-  void work() {
-    while (true) {
+  struct Task {
+    std::function<void()> F;
+    const TaskGroup *Group;
+  };
+
+  struct WorkQueue {
+    std::mutex Mutex;
+    std::deque<Task> Tasks;
+  };
+
+  static constexpr unsigned NoWorker = ~0U;
+
+  // Takes the newest task of the queue of worker Self or, if it's empty, the
+  // oldest task of another queue.
+  bool takeTask(unsigned Self, std::function<void()> &F) {
+    if (Pending == 0)
+      return false;
+    {
+      WorkQueue &Q = Queues[Self];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      if (!Q.Tasks.empty()) {
+        F = std::move(Q.Tasks.back().F);
+        Q.Tasks.pop_back();
+        --Pending;
+        return true;
+      }
+    }
+    const unsigned N = Queues.size();
+    for (unsigned I = 1; I < N; ++I) {
+      WorkQueue &Q = Queues[(Self + I) % N];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      if (!Q.Tasks.empty()) {
+        F = std::move(Q.Tasks.front().F);
+        Q.Tasks.pop_front();
+        --Pending;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void work(unsigned Index) {
+    CurrentWorker = Index;
+    while (!Stop) {
+      std::function<void()> F;
+      if (takeTask(Index, F)) {
+        F();
+        continue;
+      }
       std::unique_lock<std::mutex> Lock(Mutex);
-      Cond.wait(Lock, [&] { return Stop || !WorkStack.empty(); });
-      if (Stop)
-        break;
-      auto Task = WorkStack.top();
-      WorkStack.pop();
-      Lock.unlock();
-      Task();
+      ++Sleeping;
+      Cond.wait(Lock, [&] { return Stop || Pending > 0; });
+      --Sleeping;
     }
     Done.dec();
   }
 
+  /// The index of the worker running on this thread, NoWorker for the threads
+  /// not in the pool.
+  static LLVM_THREAD_LOCAL unsigned CurrentWorker;
+
   std::atomic<bool> Stop{false};
-  std::stack<std::function<void()>> WorkStack;
+  std::vector<WorkQueue> Queues;
+  /// The number of tasks in all the queues.
+  std::atomic<size_t> Pending{0};
+  /// The number of workers waiting on Cond for a task.
+  std::atomic<unsigned> Sleeping{0};
+  std::atomic<unsigned> NextQueue{0};
   std::mutex Mutex;
   std::condition_variable Cond;
   parallel::detail::Latch Done;
 };
 
+LLVM_THREAD_LOCAL unsigned ThreadPoolExecutor::CurrentWorker =
+    ThreadPoolExecutor::NoWorker;
+
 Executor *Executor::getDefaultExecutor() {
-  static ThreadPoolExecutor exec;
+  static ThreadPoolExecutor exec(
+      parallel::ThreadCount ? parallel::ThreadCount : hardware_concurrency());
   return &exec;
 }
 #endif
 }
 
+#if defined(_MSC_VER)
 static std::atomic<int> TaskGroupInstances;
 
 // Latch::sync() called by the dtor may cause one thread to block. If is a dead
@@ -129,13 +231,36 @@ static std::atomic<int> TaskGroupInstances;
 TaskGroup::TaskGroup() : Parallel(TaskGroupInstances++ == 0) {}
 TaskGroup::~TaskGroup() { --TaskGroupInstances; }
 
+void TaskGroup::sync() const { L.sync(); }
+#else
+TaskGroup::TaskGroup() : Parallel(true) {}
+TaskGroup::~TaskGroup() { sync(); }
+
+// A thread waiting for a group runs the tasks of the group no other thread
+// has taken yet, wherever they are queued, then blocks until the taken ones
+// are done. A waiting thread only runs the tasks of the group, so it never
+// waits behind an unrelated task, and the other tasks of the group are
+// running, so nested groups can't deadlock even if every worker is waiting.
+void TaskGroup::sync() const {
+  if (L.isReady())
+    return;
+  auto *Exec =
+      static_cast<ThreadPoolExecutor *>(Executor::getDefaultExecutor());
+  while (!L.isReady() && Exec->runGroupTask(this))
+    ;
+  L.sync();
+}
+#endif
+
 void TaskGroup::spawn(std::function<void()> F) {
   if (Parallel) {
     L.inc();
-    Executor::getDefaultExecutor()->add([&, F] {
-      F();
-      L.dec();
-    });
+    Executor::getDefaultExecutor()->add(
+        [&, F] {
+          F();
+          L.dec();
+        },
+        this);
   } else {
     F();
   }
@@ -18,6 +18,7 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Regex.h"
+#include <algorithm>
 #include <string>
 #include <system_error>
 #include <utility>
@@ -25,6 +26,28 @@
 #include <stdio.h>
 namespace llvm {
 
+/// Returns true if Query matches Glob, whose only special character is '*'.
+static bool matchGlob(StringRef Glob, StringRef Query) {
+  size_t G = 0, Q = 0;
+  // Where to resume after the last '*' when a literal doesn't match.
+  size_t StarG = StringRef::npos, StarQ = 0;
+  while (Q != Query.size()) {
+    if (G != Glob.size() && Glob[G] == '*') {
+      StarG = ++G;
+      StarQ = Q;
+    } else if (G != Glob.size() && Glob[G] == Query[Q]) {
+      ++G;
+      ++Q;
+    } else if (StarG != StringRef::npos) {
+      G = StarG;
+      Q = ++StarQ;
+    } else {
+      return false;
+    }
+  }
+  return Glob.drop_front(G).find_first_not_of('*') == StringRef::npos;
+}
+
 bool SpecialCaseList::Matcher::insert(std::string Regexp,
                                       unsigned LineNumber,
                                       std::string &REError) {
@@ -37,7 +60,31 @@ bool SpecialCaseList::Matcher::insert(std::string Regexp,
     Strings[Regexp] = LineNumber;
     return true;
   }
-  Trigrams.insert(Regexp);
+
+  // The globs are matched directly, as the lists often have many of them.
+  StringRef Glob(Regexp);
+  size_t Star = Glob.find('*');
+  if (Star != StringRef::npos && Regex::isLiteralERE(Glob.take_front(Star))) {
+    if (Star + 1 == Glob.size()) {
+      Prefixes[Glob.drop_back()] = LineNumber;
+      auto It = llvm::lower_bound(PrefixLengths, Star);
+      if (It == PrefixLengths.end() || *It != Star)
+        PrefixLengths.insert(It, Star);
+      return true;
+    }
+    std::string Literals = Glob.str();
+    Literals.erase(std::remove(Literals.begin(), Literals.end(), '*'),
+                   Literals.end());
+    if (Regex::isLiteralERE(Literals)) {
+      Trigrams.insert(Regexp);
+      Globs.emplace_back(std::move(Regexp), LineNumber);
+      return true;
+    }
+  }
+
+  bool Indexed = TrigramIndex::canIndex(Regexp);
+  if (Indexed)
+    Trigrams.insert(Regexp);
 
   // Replace * with .*
   for (size_t pos = 0; (pos = Regexp.find('*', pos)) != std::string::npos;
@@ -52,8 +99,9 @@ bool SpecialCaseList::Matcher::insert(std::string Regexp,
   if (!CheckRE.isValid(REError))
     return false;
 
-  RegExes.emplace_back(
-      std::make_pair(make_unique<Regex>(std::move(CheckRE)), LineNumber));
+  (Indexed ? RegExes : UnindexedRegExes)
+      .emplace_back(
+          std::make_pair(make_unique<Regex>(std::move(CheckRE)), LineNumber));
   return true;
 }
 
@@ -61,9 +109,22 @@ unsigned SpecialCaseList::Matcher::match(StringRef Query) const {
   auto It = Strings.find(Query);
   if (It != Strings.end())
     return It->second;
-  if (Trigrams.isDefinitelyOut(Query))
-    return false;
-  for (auto& RegExKV : RegExes)
+  for (size_t Length : PrefixLengths) {
+    if (Length > Query.size())
+      break;
+    auto PrefixIt = Prefixes.find(Query.take_front(Length));
+    if (PrefixIt != Prefixes.end())
+      return PrefixIt->second;
+  }
+  if (!Trigrams.isDefinitelyOut(Query)) {
+    for (auto &GlobKV : Globs)
+      if (matchGlob(GlobKV.first, Query))
+        return GlobKV.second;
+    for (auto &RegExKV : RegExes)
+      if (RegExKV.first->match(Query))
+        return RegExKV.second;
+  }
+  for (auto &RegExKV : UnindexedRegExes)
     if (RegExKV.first->match(Query))
       return RegExKV.second;
   return 0;
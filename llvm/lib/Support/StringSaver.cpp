@@ -7,6 +7,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/StringSaver.h"
+#include "llvm/Support/xxhash.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 using namespace llvm;
 
@@ -24,3 +28,110 @@ StringRef UniqueStringSaver::save(StringRef S) {
     *R.first = Strings.save(S); // safe replacement with equal value
   return *R.first;
 }
+
+namespace {
+/// A string saved by ConcurrentUniqueStringSaver, its characters follow it.
+struct SavedString {
+  uint64_t Hash;
+  size_t Length;
+
+  StringRef getKey() const {
+    return StringRef(reinterpret_cast<const char *>(this + 1), Length);
+  }
+};
+
+/// The buckets of a shard, linearly probed. The filled buckets are never
+/// changed, so they are read without a lock.
+struct BucketTable {
+  explicit BucketTable(unsigned NumBuckets)
+      : NumBuckets(NumBuckets),
+        Buckets(new std::atomic<const SavedString *>[NumBuckets]) {
+    for (unsigned I = 0; I != NumBuckets; ++I)
+      Buckets[I].store(nullptr, std::memory_order_relaxed);
+  }
+
+  /// Returns the bucket holding S, or the empty bucket S would be in.
+  std::atomic<const SavedString *> &lookup(StringRef S, uint64_t Hash) const {
+    for (unsigned BucketNo = Hash & (NumBuckets - 1);;
+         BucketNo = (BucketNo + 1) & (NumBuckets - 1)) {
+      const SavedString *E = Buckets[BucketNo].load(std::memory_order_acquire);
+      if (!E || (E->Hash == Hash && E->getKey() == S))
+        return Buckets[BucketNo];
+    }
+  }
+
+  const unsigned NumBuckets;
+  std::unique_ptr<std::atomic<const SavedString *>[]> Buckets;
+};
+} // end anonymous namespace
+
+static const unsigned NumStringShardBits = 6;
+
+struct ConcurrentUniqueStringSaver::Shard {
+  /// Guards the members but Table, and the changes of the buckets.
+  std::mutex Mutex;
+  BumpPtrAllocator Alloc;
+  /// The current buckets of the shard.
+  std::atomic<BucketTable *> Table{nullptr};
+  /// All the buckets of the shard, the previous ones being kept for the
+  /// threads still reading them.
+  std::vector<std::unique_ptr<BucketTable>> Tables;
+  unsigned NumItems = 0;
+
+  /// Moves the strings to buckets twice as many.
+  BucketTable *grow() {
+    BucketTable *Old = Table.load(std::memory_order_relaxed);
+    Tables.push_back(llvm::make_unique<BucketTable>(Old ? Old->NumBuckets * 2
+                                                        : 16));
+    BucketTable *New = Tables.back().get();
+    for (unsigned I = 0; Old && I != Old->NumBuckets; ++I)
+      if (const SavedString *E =
+              Old->Buckets[I].load(std::memory_order_relaxed))
+        New->lookup(E->getKey(), E->Hash).store(E, std::memory_order_relaxed);
+    Table.store(New, std::memory_order_release);
+    return New;
+  }
+};
+
+ConcurrentUniqueStringSaver::ConcurrentUniqueStringSaver()
+    : Shards(new Shard[1 << NumStringShardBits]) {}
+
+ConcurrentUniqueStringSaver::~ConcurrentUniqueStringSaver() = default;
+
+StringRef ConcurrentUniqueStringSaver::save(StringRef S) {
+  uint64_t Hash = xxHash64(S);
+  Shard &Sh = Shards[Hash >> (64 - NumStringShardBits)];
+
+  // Most strings are already saved, so look for them first without the lock.
+  // A table being replaced may miss the latest strings, they are looked for
+  // again in the current table with the lock.
+  if (BucketTable *Table = Sh.Table.load(std::memory_order_acquire))
+    if (const SavedString *E =
+            Table->lookup(S, Hash).load(std::memory_order_acquire))
+      return E->getKey();
+
+  std::lock_guard<std::mutex> Lock(Sh.Mutex);
+  BucketTable *Table = Sh.Table.load(std::memory_order_relaxed);
+  if (!Table)
+    Table = Sh.grow();
+  if (const SavedString *E =
+          Table->lookup(S, Hash).load(std::memory_order_relaxed))
+    return E->getKey();
+
+  // Keep the buckets at most 3/4 full.
+  if ((Sh.NumItems + 1) * 4 > Table->NumBuckets * 3)
+    Table = Sh.grow();
+  ++Sh.NumItems;
+
+  auto *E = static_cast<SavedString *>(Sh.Alloc.Allocate(
+      sizeof(SavedString) + S.size() + 1, alignof(SavedString)));
+  E->Hash = Hash;
+  E->Length = S.size();
+  char *P = reinterpret_cast<char *>(E + 1);
+  if (!S.empty())
+    memcpy(P, S.data(), S.size());
+  P[S.size()] = '\0';
+  // Publish the string once its characters are written.
+  Table->lookup(S, Hash).store(E, std::memory_order_release);
+  return E->getKey();
+}
@@ -16,8 +16,55 @@
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
+
 using namespace llvm;
 
+ThreadPool::QueuedTask ThreadPool::popTask() {
+  std::pop_heap(Tasks.begin(), Tasks.end(), runsAfter);
+  QueuedTask Task = std::move(Tasks.back());
+  Tasks.pop_back();
+  return Task;
+}
+
+bool ThreadPool::completeTask(const ThreadPoolTaskGroup *Group) {
+  if (!Group)
+    return false;
+  auto It = GroupTasks.find(Group);
+  assert(It != GroupTasks.end() && "Task of an unknown group");
+  if (--It->second != 0)
+    return false;
+  GroupTasks.erase(It);
+  return true;
+}
+
+size_t ThreadPool::cancel() { return cancelImpl(nullptr); }
+
+size_t ThreadPool::cancel(ThreadPoolTaskGroup &Group) {
+  return cancelImpl(&Group);
+}
+
+size_t ThreadPool::cancelImpl(const ThreadPoolTaskGroup *Group) {
+  // The cancelled tasks are destroyed out of the lock, destroying them makes
+  // their futures ready and wakes up their waiters.
+  std::vector<QueuedTask> Cancelled;
+  {
+    std::unique_lock<std::mutex> LockGuard(QueueLock);
+    auto Removed = std::partition(
+        Tasks.begin(), Tasks.end(),
+        [&](const QueuedTask &Task) { return Group && Task.Group != Group; });
+    for (auto It = Removed; It != Tasks.end(); ++It) {
+      completeTask(It->Group);
+      Cancelled.push_back(std::move(*It));
+    }
+    Tasks.erase(Removed, Tasks.end());
+    std::make_heap(Tasks.begin(), Tasks.end(), runsAfter);
+  }
+  CompletionCondition.notify_all();
+  QueueCondition.notify_all();
+  return Cancelled.size();
+}
+
 #if LLVM_ENABLE_THREADS
 
 // Default to hardware_concurrency
@@ -28,57 +75,80 @@ ThreadPool::ThreadPool(unsigned ThreadCount)
   // Create ThreadCount threads that will loop forever, wait on QueueCondition
   // for tasks to be queued or the Pool to be destroyed.
   Threads.reserve(ThreadCount);
-  for (unsigned ThreadID = 0; ThreadID < ThreadCount; ++ThreadID) {
-    Threads.emplace_back([&] {
-      while (true) {
-        PackagedTaskTy Task;
-        {
-          std::unique_lock<std::mutex> LockGuard(QueueLock);
-          // Wait for tasks to be pushed in the queue
-          QueueCondition.wait(LockGuard,
-                              [&] { return !EnableFlag || !Tasks.empty(); });
-          // Exit condition
-          if (!EnableFlag && Tasks.empty())
-            return;
-          // Yeah, we have a task, grab it and release the lock on the queue
-
-          // We first need to signal that we are active before popping the queue
-          // in order for wait() to properly detect that even if the queue is
-          // empty, there is still a task in flight.
-          {
-            std::unique_lock<std::mutex> LockGuard(CompletionLock);
-            ++ActiveThreads;
-          }
-          Task = std::move(Tasks.front());
-          Tasks.pop();
-        }
-        // Run the task we just grabbed
-        Task();
-
-        {
-          // Adjust `ActiveThreads`, in case someone waits on ThreadPool::wait()
-          std::unique_lock<std::mutex> LockGuard(CompletionLock);
-          --ActiveThreads;
-        }
-
-        // Notify task completion, in case someone waits on ThreadPool::wait()
-        CompletionCondition.notify_all();
-      }
-    });
+  for (unsigned ThreadID = 0; ThreadID < ThreadCount; ++ThreadID)
+    Threads.emplace_back([&] { processTasks(nullptr); });
+}
+
+void ThreadPool::processTasks(const ThreadPoolTaskGroup *WaitingForGroup) {
+  // A thread of the pool waiting for a group runs the queued tasks until the
+  // group is complete, the others until the pool is destroyed.
+  auto IsDone = [&] {
+    return WaitingForGroup ? !GroupTasks.count(WaitingForGroup) : !EnableFlag;
+  };
+  while (true) {
+    QueuedTask Task;
+    {
+      std::unique_lock<std::mutex> LockGuard(QueueLock);
+      // Wait for tasks to be pushed in the queue
+      QueueCondition.wait(LockGuard,
+                          [&] { return IsDone() || !Tasks.empty(); });
+      // Exit condition
+      if (IsDone() && (WaitingForGroup || Tasks.empty()))
+        return;
+      // Yeah, we have a task, grab it and release the lock on the queue
+
+      // We first need to signal that we are active before popping the queue
+      // in order for wait() to properly detect that even if the queue is
+      // empty, there is still a task in flight.
+      ++ActiveThreads;
+      Task = popTask();
+    }
+    // Run the task we just grabbed
+    Task.Task();
+
+    bool GroupComplete;
+    {
+      // Adjust `ActiveThreads`, in case someone waits on ThreadPool::wait()
+      std::unique_lock<std::mutex> LockGuard(QueueLock);
+      --ActiveThreads;
+      GroupComplete = completeTask(Task.Group);
+    }
+
+    // Notify task completion, in case someone waits on ThreadPool::wait()
+    CompletionCondition.notify_all();
+    // The threads of the pool waiting for a group wait on QueueCondition.
+    if (GroupComplete)
+      QueueCondition.notify_all();
   }
 }
 
+bool ThreadPool::isWorkerThread() const {
+  std::thread::id CurrentThreadId = std::this_thread::get_id();
+  for (const llvm::thread &Thread : Threads)
+    if (Thread.get_id() == CurrentThreadId)
+      return true;
+  return false;
+}
+
 void ThreadPool::wait() {
   // Wait for all threads to complete and the queue to be empty
-  std::unique_lock<std::mutex> LockGuard(CompletionLock);
-  // The order of the checks for ActiveThreads and Tasks.empty() matters because
-  // any active threads might be modifying the Tasks queue, and this would be a
-  // race.
+  std::unique_lock<std::mutex> LockGuard(QueueLock);
   CompletionCondition.wait(LockGuard,
                            [&] { return !ActiveThreads && Tasks.empty(); });
 }
 
-std::shared_future<void> ThreadPool::asyncImpl(TaskTy Task) {
+void ThreadPool::wait(ThreadPoolTaskGroup &Group) {
+  if (isWorkerThread()) {
+    processTasks(&Group);
+    return;
+  }
+  std::unique_lock<std::mutex> LockGuard(QueueLock);
+  CompletionCondition.wait(LockGuard, [&] { return !GroupTasks.count(&Group); });
+}
+
+std::shared_future<void> ThreadPool::asyncImpl(TaskTy Task,
+                                               const ThreadPoolTaskGroup *Group,
+                                               uint64_t Priority) {
   /// Wrap the Task in a packaged_task to return a future object.
   PackagedTaskTy PackagedTask(std::move(Task));
   auto Future = PackagedTask.get_future();
@@ -89,7 +159,10 @@ std::shared_future<void> ThreadPool::asyncImpl(TaskTy Task) {
     // Don't allow enqueueing after disabling the pool
     assert(EnableFlag && "Queuing a thread during ThreadPool destruction");
 
-    Tasks.push(std::move(PackagedTask));
+    if (Group)
+      ++GroupTasks[Group];
+    Tasks.push_back({std::move(PackagedTask), Group, Priority, NextSeq++});
+    std::push_heap(Tasks.begin(), Tasks.end(), runsAfter);
   }
   QueueCondition.notify_one();
   return Future.share();
@@ -122,19 +195,33 @@ ThreadPool::ThreadPool(unsigned ThreadCount)
 void ThreadPool::wait() {
   // Sequential implementation running the tasks
   while (!Tasks.empty()) {
-    auto Task = std::move(Tasks.front());
-    Tasks.pop();
-    Task();
+    QueuedTask Task = popTask();
+    Task.Task();
+    completeTask(Task.Group);
+  }
+}
+
+void ThreadPool::wait(ThreadPoolTaskGroup &Group) {
+  // Sequential implementation running the tasks until the group is complete
+  while (GroupTasks.count(&Group) && !Tasks.empty()) {
+    QueuedTask Task = popTask();
+    Task.Task();
+    completeTask(Task.Group);
   }
 }
 
-std::shared_future<void> ThreadPool::asyncImpl(TaskTy Task) {
+std::shared_future<void> ThreadPool::asyncImpl(TaskTy Task,
+                                               const ThreadPoolTaskGroup *Group,
+                                               uint64_t Priority) {
   // Get a Future with launch::deferred execution using std::async
   auto Future = std::async(std::launch::deferred, std::move(Task)).share();
   // Wrap the future so that both ThreadPool::wait() can operate and the
   // returned future can be sync'ed on.
   PackagedTaskTy PackagedTask([Future]() { Future.get(); });
-  Tasks.push(std::move(PackagedTask));
+  if (Group)
+    ++GroupTasks[Group];
+  Tasks.push_back({std::move(PackagedTask), Group, Priority, NextSeq++});
+  std::push_heap(Tasks.begin(), Tasks.end(), runsAfter);
   return Future;
 }
 
@@ -11,12 +11,18 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/TimeProfiler.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/Process.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -30,6 +36,13 @@ static cl::opt<unsigned> TimeTraceGranularity(
         "Minimum time granularity (in microseconds) traced by time profiler"),
     cl::init(500));
 
+static cl::opt<unsigned> TimeTraceCounterInterval(
+    "time-trace-counter-interval",
+    cl::desc("Minimum interval (in microseconds) between the samples of the "
+             "memory usage and statistics traced by time profiler, 0 doesn't "
+             "sample them"),
+    cl::init(10000));
+
 TimeTraceProfiler *TimeTraceProfilerInstance = nullptr;
 
 typedef duration<steady_clock::rep, steady_clock::period> DurationType;
@@ -49,23 +62,25 @@ struct Entry {
         Detail(std::move(Dt)){};
 };
 
-struct TimeTraceProfiler {
-  TimeTraceProfiler() {
-    StartTime = steady_clock::now();
-  }
+/// The sections traced by a single thread.
+struct ThreadTrace {
+  explicit ThreadTrace(unsigned Tid) : Tid(Tid) {}
 
   void begin(std::string Name, llvm::function_ref<std::string()> Detail) {
     Stack.emplace_back(steady_clock::now(), DurationType{}, std::move(Name),
                        Detail());
   }
 
-  void end() {
+  /// Ends the last section, returns true if it is long enough to be recorded.
+  bool end() {
     assert(!Stack.empty() && "Must call begin() first");
     auto &E = Stack.back();
     E.Duration = steady_clock::now() - E.Start;
 
     // Only include sections longer than TimeTraceGranularity msec.
-    if (duration_cast<microseconds>(E.Duration).count() > TimeTraceGranularity)
+    bool Recorded =
+        duration_cast<microseconds>(E.Duration).count() > TimeTraceGranularity;
+    if (Recorded)
       Entries.emplace_back(E);
 
     // Track total time taken by each "name", but only the topmost levels of
@@ -82,35 +97,139 @@ struct TimeTraceProfiler {
     }
 
     Stack.pop_back();
+    return Recorded;
+  }
+
+  /// The thread id of the events, in order of the first section of the thread.
+  const unsigned Tid;
+  SmallVector<Entry, 16> Stack;
+  SmallVector<Entry, 128> Entries;
+  StringMap<CountAndDurationType> CountAndTotalPerName;
+};
+
+/// A sample of the memory usage and the statistics of the process.
+struct CounterSample {
+  time_point<steady_clock> Time;
+  size_t ResidentMemory;
+  size_t MallocMemory;
+  std::vector<std::pair<StringRef, unsigned>> Statistics;
+};
+
+/// Identifies the profiler the trace of each thread belongs to, so that a
+/// thread doesn't use its trace of a previous profiler.
+static std::atomic<unsigned> ProfilerGeneration{0};
+static LLVM_THREAD_LOCAL ThreadTrace *CurrentThreadTrace = nullptr;
+static LLVM_THREAD_LOCAL unsigned CurrentThreadGeneration = 0;
+
+struct TimeTraceProfiler {
+  TimeTraceProfiler() : Generation(++ProfilerGeneration) {
+    StartTime = steady_clock::now();
+    if (TimeTraceCounterInterval)
+      sampleCounters(StartTime);
+  }
+
+  void begin(std::string Name, llvm::function_ref<std::string()> Detail) {
+    getThreadTrace().begin(std::move(Name), Detail);
+  }
+
+  void end() {
+    if (!getThreadTrace().end() || !TimeTraceCounterInterval)
+      return;
+    // The counters are sampled when a section is recorded, at most once per
+    // TimeTraceCounterInterval over all the threads.
+    auto Now = steady_clock::now();
+    int64_t NowUs = duration_cast<microseconds>(Now - StartTime).count();
+    int64_t LastUs = LastSampleUs;
+    if (NowUs - LastUs >= TimeTraceCounterInterval &&
+        LastSampleUs.compare_exchange_strong(LastUs, NowUs))
+      sampleCounters(Now);
+  }
+
+  // Returns the trace of the calling thread, created by its first section.
+  ThreadTrace &getThreadTrace() {
+    if (CurrentThreadTrace && CurrentThreadGeneration == Generation)
+      return *CurrentThreadTrace;
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Threads.push_back(llvm::make_unique<ThreadTrace>(Threads.size()));
+    CurrentThreadTrace = Threads.back().get();
+    CurrentThreadGeneration = Generation;
+    return *CurrentThreadTrace;
+  }
+
+  void sampleCounters(time_point<steady_clock> Now) {
+    CounterSample Sample{Now, sys::Process::GetResidentMemoryUsage(),
+                         sys::Process::GetMallocUsage(),
+                         {}};
+    if (AreStatisticsEnabled())
+      Sample.Statistics = GetStatistics();
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Samples.push_back(std::move(Sample));
   }
 
   void Write(raw_pwrite_stream &OS) {
-    assert(Stack.empty() &&
-           "All profiler sections should be ended when calling Write");
+    if (TimeTraceCounterInterval)
+      sampleCounters(steady_clock::now());
+    std::lock_guard<std::mutex> Lock(Mutex);
     json::OStream J(OS);
     J.objectBegin();
     J.attributeBegin("traceEvents");
     J.arrayBegin();
 
-    // Emit all events for the main flame graph.
-    for (const auto &E : Entries) {
-      auto StartUs = duration_cast<microseconds>(E.Start - StartTime).count();
-      auto DurUs = duration_cast<microseconds>(E.Duration).count();
+    // Emit all events for the main flame graph, one lane per thread, and sum
+    // the totals of all the threads.
+    StringMap<CountAndDurationType> CountAndTotalPerName;
+    for (const auto &T : Threads) {
+      assert(T->Stack.empty() &&
+             "All profiler sections should be ended when calling Write");
+      for (const auto &E : T->Entries) {
+        auto StartUs = duration_cast<microseconds>(E.Start - StartTime).count();
+        auto DurUs = duration_cast<microseconds>(E.Duration).count();
 
-      J.object([&]{
-        J.attribute("pid", 1);
-        J.attribute("tid", 0);
-        J.attribute("ph", "X");
-        J.attribute("ts", StartUs);
-        J.attribute("dur", DurUs);
-        J.attribute("name", E.Name);
-        J.attributeObject("args", [&] { J.attribute("detail", E.Detail); });
-      });
+        J.object([&]{
+          J.attribute("pid", 1);
+          J.attribute("tid", int64_t(T->Tid));
+          J.attribute("ph", "X");
+          J.attribute("ts", StartUs);
+          J.attribute("dur", DurUs);
+          J.attribute("name", E.Name);
+          J.attributeObject("args", [&] { J.attribute("detail", E.Detail); });
+        });
+      }
+      for (const auto &E : T->CountAndTotalPerName) {
+        auto &CountAndTotal = CountAndTotalPerName[E.getKey()];
+        CountAndTotal.first += E.getValue().first;
+        CountAndTotal.second += E.getValue().second;
+      }
+    }
+
+    // Emit the counters, a statistic only when its value changes.
+    StringMap<unsigned> LastStatistics;
+    for (const CounterSample &Sample : Samples) {
+      auto TimeUs = duration_cast<microseconds>(Sample.Time - StartTime).count();
+      auto Counter = [&](StringRef Name, StringRef Arg, int64_t Value) {
+        J.object([&] {
+          J.attribute("pid", 1);
+          J.attribute("ph", "C");
+          J.attribute("ts", TimeUs);
+          J.attribute("name", Name);
+          J.attributeObject("args", [&] { J.attribute(Arg, Value); });
+        });
+      };
+      if (Sample.ResidentMemory)
+        Counter("Resident memory", "bytes", Sample.ResidentMemory);
+      Counter("Malloc memory", "bytes", Sample.MallocMemory);
+      for (const auto &Stat : Sample.Statistics) {
+        auto Last = LastStatistics.insert({Stat.first, Stat.second});
+        if (!Last.second && Last.first->second == Stat.second)
+          continue;
+        Last.first->second = Stat.second;
+        Counter(Stat.first, "value", Stat.second);
+      }
     }
 
     // Emit totals by section name as additional "thread" events, sorted from
     // longest one.
-    int Tid = 1;
+    int Tid = Threads.size();
     std::vector<NameAndCountAndDurationType> SortedTotals;
     SortedTotals.reserve(CountAndTotalPerName.size());
     for (const auto &E : CountAndTotalPerName)
@@ -157,9 +276,12 @@ struct TimeTraceProfiler {
     J.objectEnd();
   }
 
-  SmallVector<Entry, 16> Stack;
-  SmallVector<Entry, 128> Entries;
-  StringMap<CountAndDurationType> CountAndTotalPerName;
+  const unsigned Generation;
+  /// Guards Threads and Samples.
+  std::mutex Mutex;
+  std::vector<std::unique_ptr<ThreadTrace>> Threads;
+  std::vector<CounterSample> Samples;
+  std::atomic<int64_t> LastSampleUs{0};
   time_point<steady_clock> StartTime;
 };
 
@@ -0,0 +1,73 @@
+//===- TreeHash.cpp - Parallel hashing of large data ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/TreeHash.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/xxhash.h"
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+using namespace llvm;
+
+void llvm::treeHash(
+    MutableArrayRef<uint8_t> Hash, ArrayRef<uint8_t> Data,
+    function_ref<void(uint8_t *Dest, ArrayRef<uint8_t> Chunk)> HashFn,
+    bool Parallel, size_t ChunkSize) {
+  assert(ChunkSize && "Chunks can't be empty");
+  const size_t NumChunks = Data.empty() ? 0 : (Data.size() - 1) / ChunkSize + 1;
+  std::vector<uint8_t> Hashes(NumChunks * Hash.size());
+  auto HashChunk = [&](size_t I) {
+    HashFn(Hashes.data() + I * Hash.size(),
+           Data.slice(I * ChunkSize,
+                      std::min(ChunkSize, Data.size() - I * ChunkSize)));
+  };
+  if (Parallel)
+    parallel::for_each_n(parallel::par, size_t(0), NumChunks, HashChunk);
+  else
+    parallel::for_each_n(parallel::seq, size_t(0), NumChunks, HashChunk);
+
+  HashFn(Hash.data(), Hashes);
+}
+
+uint64_t llvm::treeHashXXHash64(ArrayRef<uint8_t> Data, bool Parallel) {
+  uint8_t Hash[8];
+  treeHash(Hash, Data,
+           [](uint8_t *Dest, ArrayRef<uint8_t> Chunk) {
+             support::endian::write64le(Dest, xxHash64(Chunk));
+           },
+           Parallel);
+  return support::endian::read64le(Hash);
+}
+
+std::array<uint8_t, 16> llvm::treeHashMD5(ArrayRef<uint8_t> Data,
+                                          bool Parallel) {
+  std::array<uint8_t, 16> Hash;
+  treeHash(Hash, Data,
+           [](uint8_t *Dest, ArrayRef<uint8_t> Chunk) {
+             std::array<uint8_t, 16> ChunkHash = MD5::hash(Chunk);
+             memcpy(Dest, ChunkHash.data(), ChunkHash.size());
+           },
+           Parallel);
+  return Hash;
+}
+
+std::array<uint8_t, 20> llvm::treeHashSHA1(ArrayRef<uint8_t> Data,
+                                           bool Parallel) {
+  std::array<uint8_t, 20> Hash;
+  treeHash(Hash, Data,
+           [](uint8_t *Dest, ArrayRef<uint8_t> Chunk) {
+             std::array<uint8_t, 20> ChunkHash = SHA1::hash(Chunk);
+             memcpy(Dest, ChunkHash.data(), ChunkHash.size());
+           },
+           Parallel);
+  return Hash;
+}
@@ -29,6 +29,22 @@ static bool isAdvancedMetachar(unsigned Char) {
   return strchr(RegexAdvancedMetachars, Char) != nullptr;
 }
 
+bool TrigramIndex::canIndex(StringRef Regex) {
+  bool Escaped = false;
+  for (unsigned Char : Regex) {
+    if (Escaped) {
+      if (Char >= '1' && Char <= '9')
+        return false;
+      Escaped = false;
+    } else if (Char == '\\') {
+      Escaped = true;
+    } else if (isAdvancedMetachar(Char)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void TrigramIndex::insert(std::string Regex) {
   if (Defeated) return;
   std::set<unsigned> Was;
@@ -517,6 +517,81 @@ directory_iterator OverlayFileSystem::dir_begin(const Twine &Dir,
 
 void ProxyFileSystem::anchor() {}
 
+//===-----------------------------------------------------------------------===/
+// CachingFileSystem implementation
+//===-----------------------------------------------------------------------===/
+
+bool CachingFileSystem::getCacheKey(const Twine &Path,
+                                    SmallVectorImpl<char> &Key) const {
+  Path.toVector(Key);
+  if (makeAbsolute(Key))
+    return false;
+  sys::path::remove_dots(Key);
+  return true;
+}
+
+ErrorOr<Status> CachingFileSystem::status(const Twine &Path) {
+  SmallString<256> Key;
+  if (!getCacheKey(Path, Key))
+    return ProxyFileSystem::status(Path);
+
+  {
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    auto I = Cache.find(Key);
+    if (I != Cache.end()) {
+      if (!I->second)
+        return make_error_code(llvm::errc::no_such_file_or_directory);
+      return Status::copyWithNewName(*I->second, Path);
+    }
+  }
+
+  // Query outside the lock, racing lookups of the same path store the same
+  // result.
+  ErrorOr<Status> S = ProxyFileSystem::status(Path);
+  if (S || S.getError() == llvm::errc::no_such_file_or_directory) {
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    if (S)
+      Cache[Key] = *S;
+    else
+      Cache[Key] = None;
+  }
+  return S;
+}
+
+ErrorOr<std::unique_ptr<File>>
+CachingFileSystem::openFileForRead(const Twine &Path) {
+  SmallString<256> Key;
+  if (!getCacheKey(Path, Key))
+    return ProxyFileSystem::openFileForRead(Path);
+
+  {
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    auto I = Cache.find(Key);
+    if (I != Cache.end() && !I->second)
+      return make_error_code(llvm::errc::no_such_file_or_directory);
+  }
+
+  ErrorOr<std::unique_ptr<File>> F = ProxyFileSystem::openFileForRead(Path);
+  if (F.getError() == llvm::errc::no_such_file_or_directory) {
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    Cache[Key] = None;
+  }
+  return F;
+}
+
+void CachingFileSystem::invalidate(const Twine &Path) {
+  SmallString<256> Key;
+  if (!getCacheKey(Path, Key))
+    return;
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  Cache.erase(Key);
+}
+
+void CachingFileSystem::invalidateAll() {
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  Cache.clear();
+}
+
 namespace llvm {
 namespace vfs {
 
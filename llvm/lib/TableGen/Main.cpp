@@ -77,6 +77,25 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   return 0;
 }
 
+bool llvm::writeFileIfChanged(const char *argv0, StringRef Filename,
+                              StringRef Contents) {
+  // Only updates the file if there are any differences. This prevents
+  // recompilation of all the files depending on it if there aren't any.
+  if (auto ExistingOrErr = MemoryBuffer::getFile(Filename))
+    if (std::move(ExistingOrErr.get())->getBuffer() == Contents)
+      return false;
+
+  std::error_code EC;
+  ToolOutputFile OutFile(Filename, EC, sys::fs::F_Text);
+  if (EC) {
+    reportError(argv0, "error opening " + Filename + ":" + EC.message() + "\n");
+    return true;
+  }
+  OutFile.os() << Contents;
+  OutFile.keep();
+  return false;
+}
+
 int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
   RecordKeeper Records;
 
@@ -114,24 +133,8 @@ int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
       return Ret;
   }
 
-  // Only updates the real output file if there are any differences.
-  // This prevents recompilation of all the files depending on it if there
-  // aren't any.
-  if (auto ExistingOrErr = MemoryBuffer::getFile(OutputFilename))
-    if (std::move(ExistingOrErr.get())->getBuffer() == Out.str())
-      return 0;
-
-  std::error_code EC;
-  ToolOutputFile OutFile(OutputFilename, EC, sys::fs::F_Text);
-  if (EC)
-    return reportError(argv0, "error opening " + OutputFilename + ":" +
-                                  EC.message() + "\n");
-  OutFile.os() << Out.str();
-
   if (ErrorsPrinted > 0)
     return reportError(argv0, Twine(ErrorsPrinted) + " errors.\n");
 
-  // Declare success.
-  OutFile.keep();
-  return 0;
+  return writeFileIfChanged(argv0, OutputFilename, Out.str());
 }
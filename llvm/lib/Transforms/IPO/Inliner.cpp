@@ -1002,15 +1002,32 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
       return FAM.getResult<BlockFrequencyAnalysis>(F);
     };
 
+    // The costs of inlining F into its callers, which shouldInline computes
+    // for each call from F to decide whether to defer it. They only depend on
+    // F and its callers, and only F is changed while its calls are processed,
+    // so they are computed once for all the calls from F until one of them is
+    // inlined.
+    DenseMap<Instruction *, InlineCost> CallerCosts;
+
     auto GetInlineCost = [&](CallSite CS) {
+      bool IsCallToF = CS.getCalledFunction() == &F;
+      if (IsCallToF) {
+        auto It = CallerCosts.find(CS.getInstruction());
+        if (It != CallerCosts.end())
+          return It->second;
+      }
       Function &Callee = *CS.getCalledFunction();
       auto &CalleeTTI = FAM.getResult<TargetIRAnalysis>(Callee);
       bool RemarksEnabled =
           Callee.getContext().getDiagHandlerPtr()->isMissedOptRemarkEnabled(
               DEBUG_TYPE);
-      return getInlineCost(cast<CallBase>(*CS.getInstruction()), Params,
-                           CalleeTTI, GetAssumptionCache, {GetBFI}, PSI,
-                           RemarksEnabled ? &ORE : nullptr);
+      InlineCost IC = getInlineCost(cast<CallBase>(*CS.getInstruction()),
+                                    Params, CalleeTTI, GetAssumptionCache,
+                                    {GetBFI}, PSI,
+                                    RemarksEnabled ? &ORE : nullptr);
+      if (IsCallToF)
+        CallerCosts.insert({CS.getInstruction(), IC});
+      return IC;
     };
 
     // Now process as many calls as we have within this caller in the sequnece.
@@ -1082,6 +1099,7 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
       }
       DidInline = true;
       InlinedCallees.insert(&Callee);
+      CallerCosts.clear();
 
       ++NumInlined;
 
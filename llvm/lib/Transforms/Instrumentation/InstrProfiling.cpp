@@ -34,7 +34,9 @@
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/Pass.h"
@@ -43,7 +45,9 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/ModuleUtils.h"
 #include "llvm/Transforms/Utils/SSAUpdater.h"
 #include <algorithm>
@@ -97,6 +101,27 @@ cl::opt<double> NumCountersPerValueSite(
     // is usually smaller than 2.
     cl::init(1.0));
 
+cl::opt<bool> RuntimeCounterRelocation(
+    "runtime-counter-relocation", cl::ZeroOrMore,
+    cl::desc("Add a bias set by the runtime to the address of every profile "
+             "counter update, so that the counters can be moved into a "
+             "mapping of the profile file (continuous mode)"),
+    cl::init(false));
+
+cl::opt<bool> ShardedCounterUpdate(
+    "sharded-counter-update", cl::ZeroOrMore,
+    cl::desc("Make every thread update its own copy of the profile counters, "
+             "allocated by the runtime and summed up when the profile is "
+             "written"),
+    cl::init(false));
+
+cl::opt<unsigned> SampledInstrPeriod(
+    "sampled-instr-period", cl::ZeroOrMore,
+    cl::desc("Only update the profile counters in one out of this many "
+             "invocations of each instrumented function, rounded down to a "
+             "power of two. 0 and 1 count every invocation"),
+    cl::init(0));
+
 cl::opt<bool> AtomicCounterUpdateAll(
     "instrprof-atomic-counter-update-all", cl::ZeroOrMore,
     cl::desc("Make all profile counter updates atomic (for testing only)"),
@@ -400,25 +425,24 @@ static InstrProfIncrementInst *castToIncrementInst(Instruction *Instr) {
 }
 
 bool InstrProfiling::lowerIntrinsics(Function *F) {
-  bool MadeChange = false;
   PromotionCandidates.clear();
-  for (BasicBlock &BB : *F) {
-    for (auto I = BB.begin(), E = BB.end(); I != E;) {
-      auto Instr = I++;
-      InstrProfIncrementInst *Inc = castToIncrementInst(&*Instr);
-      if (Inc) {
-        lowerIncrement(Inc);
-        MadeChange = true;
-      } else if (auto *Ind = dyn_cast<InstrProfValueProfileInst>(Instr)) {
-        lowerValueProfileInst(Ind);
-        MadeChange = true;
-      }
-    }
-  }
-
-  if (!MadeChange)
+  // Collect the intrinsics up front, as lowering the first increment of a
+  // function may split its entry block.
+  SmallVector<Instruction *, 16> ProfileInsts;
+  for (Instruction &I : instructions(F))
+    if (castToIncrementInst(&I) || isa<InstrProfValueProfileInst>(&I))
+      ProfileInsts.push_back(&I);
+
+  if (ProfileInsts.empty())
     return false;
 
+  for (Instruction *I : ProfileInsts) {
+    if (InstrProfIncrementInst *Inc = castToIncrementInst(I))
+      lowerIncrement(Inc);
+    else
+      lowerValueProfileInst(cast<InstrProfValueProfileInst>(I));
+  }
+
   promoteCounterLoadStores(F);
   return true;
 }
@@ -465,6 +489,120 @@ void InstrProfiling::promoteCounterLoadStores(Function *F) {
   }
 }
 
+/// Return the sampling period of the instrumentation, or 1 when every function
+/// invocation updates the counters.
+static uint32_t getSamplingPeriod() {
+  if (SampledInstrPeriod <= 1)
+    return 1;
+  return PowerOf2Floor(SampledInstrPeriod);
+}
+
+bool InstrProfiling::sampleFunction(Function &F) {
+  SmallVector<Instruction *, 16> ProfileInsts;
+  for (Instruction &I : instructions(F))
+    if (castToIncrementInst(&I) || isa<InstrProfValueProfileInst>(&I))
+      ProfileInsts.push_back(&I);
+  if (ProfileInsts.empty())
+    return false;
+
+  LLVMContext &Ctx = M->getContext();
+  uint32_t Period = getSamplingPeriod();
+  BasicBlock *Entry = &F.getEntryBlock();
+  BasicBlock *Check = BasicBlock::Create(Ctx, "profsample", &F, Entry);
+
+  // Keep the static allocas in the new entry block, where both copies of the
+  // body share them.
+  for (auto I = Entry->begin(), E = Entry->end(); I != E;) {
+    auto *AI = dyn_cast<AllocaInst>(I++);
+    if (AI && isa<ConstantInt>(AI->getArraySize()))
+      AI->moveBefore(*Check, Check->end());
+  }
+
+  // A power of two period makes the countdown wrap around by itself: the
+  // invocation that brings it to zero is sampled.
+  IRBuilder<> Builder(Check);
+  GlobalVariable *Countdown = getOrCreateSamplingCountdown();
+  Value *Count =
+      Builder.CreateLoad(Builder.getInt32Ty(), Countdown, "profsample.count");
+  Value *Next = Builder.CreateAnd(Builder.CreateSub(Count, Builder.getInt32(1)),
+                                  Builder.getInt32(Period - 1));
+  Builder.CreateStore(Next, Countdown);
+  Value *Sampled = Builder.CreateICmpEQ(Next, Builder.getInt32(0),
+                                        "profsample.sampled");
+  MDNode *Weights = MDBuilder(Ctx).createBranchWeights(1, Period - 1);
+
+  // Blocks whose address is taken cannot be duplicated, so the profiling
+  // intrinsics of such a function are made conditional instead.
+  if (any_of(F, [](const BasicBlock &BB) { return BB.hasAddressTaken(); })) {
+    Builder.CreateBr(Entry);
+    for (Instruction *I : ProfileInsts)
+      I->moveBefore(SplitBlockAndInsertIfThen(Sampled, I, false, Weights));
+    return true;
+  }
+
+  // Otherwise the sampled invocations run the original body, and all others
+  // a copy of it without any instrumentation.
+  ValueToValueMapTy VMap;
+  SmallVector<BasicBlock *, 32> Blocks;
+  for (BasicBlock &BB : F)
+    if (&BB != Check)
+      Blocks.push_back(&BB);
+  SmallVector<BasicBlock *, 32> Clones;
+  for (BasicBlock *BB : Blocks) {
+    BasicBlock *Clone = CloneBasicBlock(BB, VMap, ".nosample", &F);
+    VMap[BB] = Clone;
+    Clones.push_back(Clone);
+  }
+  remapInstructionsInBlocks(Clones, VMap);
+  for (Instruction *I : ProfileInsts)
+    cast<Instruction>(VMap[I])->eraseFromParent();
+
+  Builder.CreateCondBr(Sampled, Entry, cast<BasicBlock>(VMap[Entry]), Weights);
+  return true;
+}
+
+GlobalVariable *InstrProfiling::getOrCreateSamplingCountdown() {
+  StringRef VarName = getInstrProfSamplingVarName();
+  if (GlobalVariable *Countdown = M->getNamedGlobal(VarName))
+    return Countdown;
+
+  Type *Int32Ty = Type::getInt32Ty(M->getContext());
+  auto *Countdown = new GlobalVariable(
+      *M, Int32Ty, false, GlobalValue::LinkOnceODRLinkage,
+      Constant::getNullValue(Int32Ty), VarName, nullptr,
+      GlobalVariable::GeneralDynamicTLSModel);
+  Countdown->setVisibility(GlobalVariable::HiddenVisibility);
+  if (TT.supportsCOMDAT())
+    Countdown->setComdat(M->getOrInsertComdat(VarName));
+  return Countdown;
+}
+
+void InstrProfiling::emitSamplingPeriod() {
+  uint64_t Variant = uint64_t(Log2_32(getSamplingPeriod()))
+                     << VARIANT_SAMPLING_SHIFT;
+  StringRef VarName = INSTR_PROF_QUOTE(INSTR_PROF_RAW_VERSION_VAR);
+  Type *Int64Ty = Type::getInt64Ty(M->getContext());
+
+  // IR level instrumentation has already defined the version variable.
+  if (GlobalVariable *Version = M->getNamedGlobal(VarName)) {
+    auto *Init = cast<ConstantInt>(Version->getInitializer());
+    Version->setInitializer(
+        ConstantInt::get(Int64Ty, Init->getZExtValue() | Variant));
+    return;
+  }
+
+  // Otherwise this overrides the runtime's weak definition, like the one
+  // emitted by createIRLevelProfileFlagVar().
+  auto *Version = new GlobalVariable(
+      *M, Int64Ty, true, GlobalValue::WeakAnyLinkage,
+      ConstantInt::get(Int64Ty, INSTR_PROF_RAW_VERSION | Variant), VarName);
+  Version->setVisibility(GlobalValue::DefaultVisibility);
+  if (TT.supportsCOMDAT()) {
+    Version->setLinkage(GlobalValue::ExternalLinkage);
+    Version->setComdat(M->getOrInsertComdat(VarName));
+  }
+}
+
 /// Check if the module contains uses of any profiling intrinsics.
 static bool containsProfilingIntrinsics(Module &M) {
   if (auto *F = M.getFunction(
@@ -488,11 +626,17 @@ bool InstrProfiling::run(Module &M, const TargetLibraryInfo &TLI) {
   NamesVar = nullptr;
   NamesSize = 0;
   ProfileDataMap.clear();
+  FunctionToProfileBiasMap.clear();
   UsedVars.clear();
   getMemOPSizeRangeFromOption(MemOPSizeRange, MemOPSizeRangeStart,
                               MemOPSizeRangeLast);
   TT = Triple(M.getTargetTriple());
 
+  if (RuntimeCounterRelocation && ShardedCounterUpdate)
+    report_fatal_error("sharded counter updates cannot be combined with "
+                       "runtime counter relocation",
+                       false);
+
   // Emit the runtime hook even if no counters are present.
   bool MadeChange = emitRuntimeHook();
 
@@ -520,6 +664,18 @@ bool InstrProfiling::run(Module &M, const TargetLibraryInfo &TLI) {
       static_cast<void>(getOrCreateRegionCounters(FirstProfIncInst));
   }
 
+  if (getSamplingPeriod() > 1) {
+    // The context-sensitive counters would be sampled independently of the
+    // others, and scaled by a period that cannot tell them apart.
+    if (IsCS)
+      report_fatal_error("sampled instrumentation does not support "
+                         "context-sensitive profiles",
+                         false);
+    for (Function &F : M)
+      MadeChange |= sampleFunction(F);
+    emitSamplingPeriod();
+  }
+
   for (Function &F : M)
     MadeChange |= lowerIntrinsics(&F);
 
@@ -623,13 +779,99 @@ void InstrProfiling::lowerValueProfileInst(InstrProfValueProfileInst *Ind) {
   Ind->eraseFromParent();
 }
 
-void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
+Value *InstrProfiling::getCounterAddress(InstrProfIncrementInst *Inc) {
   GlobalVariable *Counters = getOrCreateRegionCounters(Inc);
-
-  IRBuilder<> Builder(Inc);
   uint64_t Index = Inc->getIndex()->getZExtValue();
+  IRBuilder<> Builder(Inc);
   Value *Addr = Builder.CreateConstInBoundsGEP2_64(Counters->getValueType(),
                                                    Counters, 0, Index);
+  if (!RuntimeCounterRelocation && !ShardedCounterUpdate)
+    return Addr;
+
+  // The bias is computed once per function, and the biased addresses are all
+  // computed right after it, in the entry block, so that they dominate any
+  // loop exit the counter updates get promoted to.
+  Type *IntPtrTy = M->getDataLayout().getIntPtrType(M->getContext());
+  Function *F = Inc->getFunction();
+  Instruction *&Bias = FunctionToProfileBiasMap[F];
+  if (!Bias) {
+    if (ShardedCounterUpdate) {
+      Bias = getCounterShardBias(F);
+    } else {
+      IRBuilder<> EntryBuilder(&*F->getEntryBlock().getFirstInsertionPt());
+      Bias = EntryBuilder.CreateLoad(IntPtrTy, getOrCreateCounterBias(),
+                                     "profc_bias");
+    }
+  }
+  if (isa<PHINode>(Bias))
+    Builder.SetInsertPoint(&*Bias->getParent()->getFirstInsertionPt());
+  else
+    Builder.SetInsertPoint(Bias->getNextNode());
+  Value *Add = Builder.CreateAdd(Builder.CreatePtrToInt(Addr, IntPtrTy), Bias);
+  return Builder.CreateIntToPtr(Add, Addr->getType());
+}
+
+PHINode *InstrProfiling::getCounterShardBias(Function *F) {
+  LLVMContext &Ctx = M->getContext();
+  Type *IntPtrTy = M->getDataLayout().getIntPtrType(Ctx);
+  StringRef VarName = getInstrProfCounterShardVarName();
+  GlobalVariable *ShardVar = M->getNamedGlobal(VarName);
+  if (!ShardVar) {
+    ShardVar = new GlobalVariable(*M, IntPtrTy, false,
+                                  GlobalValue::ExternalLinkage, nullptr,
+                                  VarName, nullptr,
+                                  GlobalVariable::GeneralDynamicTLSModel);
+    ShardVar->setVisibility(GlobalVariable::HiddenVisibility);
+  }
+
+  // Split the entry block after its static allocas, so that they stay there.
+  BasicBlock::iterator SplitPt = F->getEntryBlock().getFirstInsertionPt();
+  while (isa<AllocaInst>(SplitPt))
+    ++SplitPt;
+
+  // A zero bias means the thread has no shard yet, which only happens the
+  // first time it runs instrumented code.
+  IRBuilder<> Builder(&*SplitPt);
+  LoadInst *Shard = Builder.CreateLoad(IntPtrTy, ShardVar, "profc_shard");
+  Instruction *Then = SplitBlockAndInsertIfThen(
+      Builder.CreateIsNull(Shard), &*SplitPt, false,
+      MDBuilder(Ctx).createBranchWeights(1, (1U << 20) - 1));
+  Builder.SetInsertPoint(Then);
+  AttributeList AL = AttributeList().addAttribute(
+      Ctx, AttributeList::FunctionIndex, Attribute::NoUnwind);
+  FunctionCallee ShardFunc = M->getOrInsertFunction(
+      getInstrProfCounterShardFuncName(), FunctionType::get(IntPtrTy, false),
+      AL);
+  CallInst *NewShard = Builder.CreateCall(ShardFunc, {}, "profc_newshard");
+
+  Builder.SetInsertPoint(&SplitPt->getParent()->front());
+  PHINode *Bias = Builder.CreatePHI(IntPtrTy, 2, "profc_bias");
+  Bias->addIncoming(Shard, Shard->getParent());
+  Bias->addIncoming(NewShard, Then->getParent());
+  return Bias;
+}
+
+GlobalVariable *InstrProfiling::getOrCreateCounterBias() {
+  StringRef VarName = getInstrProfCounterBiasVarName();
+  if (GlobalVariable *Bias = M->getNamedGlobal(VarName))
+    return Bias;
+
+  // Every instrumented module carries a zero bias, which the runtime of the
+  // enclosing binary or shared library overwrites in continuous mode.
+  Type *IntPtrTy = M->getDataLayout().getIntPtrType(M->getContext());
+  auto *Bias = new GlobalVariable(*M, IntPtrTy, false,
+                                  GlobalValue::LinkOnceODRLinkage,
+                                  Constant::getNullValue(IntPtrTy), VarName);
+  Bias->setVisibility(GlobalVariable::HiddenVisibility);
+  if (TT.supportsCOMDAT())
+    Bias->setComdat(M->getOrInsertComdat(VarName));
+  return Bias;
+}
+
+void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
+  Value *Addr = getCounterAddress(Inc);
+
+  IRBuilder<> Builder(Inc);
 
   if (Options.Atomic || AtomicCounterUpdateAll) {
     Builder.CreateAtomicRMW(AtomicRMWInst::Add, Addr, Inc->getStep(),
@@ -181,6 +181,11 @@ static cl::opt<bool> MaximizeBandwidth(
     cl::desc("Maximize bandwidth when selecting vectorization factor which "
              "will be determined by the smallest type in loop."));
 
+static cl::opt<bool> CostScalarRemainder(
+    "vectorizer-cost-scalar-remainder", cl::init(false), cl::Hidden,
+    cl::desc("With a constant trip count, include the iterations left to the "
+             "scalar epilogue when selecting the vectorization factor."));
+
 static cl::opt<bool> EnableInterleavedMemAccesses(
     "enable-interleaved-mem-accesses", cl::init(false), cl::Hidden,
     cl::desc("Enable vectorization on interleaved memory accesses in a loop"));
@@ -4825,6 +4830,22 @@ LoopVectorizationCostModel::selectVectorizationFactor(unsigned MaxVF) {
     Cost = std::numeric_limits<float>::max();
   }
 
+  // With a small constant trip count, the iterations left to the scalar
+  // epilogue can dominate the run time of the loop, so the factors are
+  // compared by the cost of all the iterations instead of the cost per lane:
+  // a narrower factor which leaves fewer scalar iterations may be cheaper.
+  unsigned TC = 0;
+  if (CostScalarRemainder && !foldTailByMasking())
+    TC = PSE.getSE()->getSmallConstantTripCount(TheLoop);
+  auto getTotalCost = [&](float VectorIterCost, unsigned VF) {
+    unsigned VectorIters = TC / VF;
+    // An epilogue required by the interleave groups runs at least once.
+    if (VectorIters && TC % VF == 0 && requiresScalarEpilogue())
+      --VectorIters;
+    return VectorIters * VectorIterCost + (TC - VectorIters * VF) * ScalarCost;
+  };
+  float TotalCost = TC * Cost;
+
   for (unsigned i = 2; i <= MaxVF; i *= 2) {
     // Notice that the vector loop needs to be executed less times, so
     // we need to divide the cost of the vector loops by the width of
@@ -4839,6 +4860,17 @@ LoopVectorizationCostModel::selectVectorizationFactor(unsigned MaxVF) {
                  << " because it will not generate any vector instructions.\n");
       continue;
     }
+    if (TC) {
+      float LoopCost = getTotalCost(C.first, i);
+      LLVM_DEBUG(dbgs() << "LV: " << TC << " iterations with width " << i
+                        << " cost: " << (int)LoopCost << ".\n");
+      if (LoopCost < TotalCost) {
+        TotalCost = LoopCost;
+        Cost = VectorCost;
+        Width = i;
+      }
+      continue;
+    }
     if (VectorCost < Cost) {
       Cost = VectorCost;
       Width = i;
@@ -14,6 +14,7 @@
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/XRay/BlockIndexer.h"
 #include "llvm/XRay/BlockVerifier.h"
 #include "llvm/XRay/FDRRecordConsumer.h"
@@ -297,44 +298,74 @@ Error loadFDRLog(StringRef Data, bool IsLittleEndian,
       return E;
   }
 
+  // The blocks of each process+thread pair are independent from the others,
+  // so they are verified and expanded in parallel, one pair per task. The
+  // errors and records of the pairs are then taken in order, as if the pairs
+  // were processed one after the other.
+  std::vector<BlockIndexer::Index::value_type *> Threads;
+  for (auto &PTB : Index)
+    Threads.push_back(&PTB);
+  std::vector<Error> Errors;
+  for (size_t I = 0, E = Threads.size(); I != E; ++I)
+    Errors.push_back(Error::success());
+  auto TakeFirstError = [&]() -> Error {
+    Error Result = Error::success();
+    for (Error &E : Errors)
+      if (!Result)
+        Result = std::move(E);
+      else
+        consumeError(std::move(E));
+    return Result;
+  };
+
   // Then we verify the consistency of the blocks.
-  {
-    for (auto &PTB : Index) {
-      auto &Blocks = PTB.second;
-      for (auto &B : Blocks) {
-        BlockVerifier Verifier;
-        for (auto *R : B.Records)
-          if (auto E = R->apply(Verifier))
-            return E;
-        if (auto E = Verifier.verify())
-          return E;
+  parallel::for_each_n(parallel::par, size_t(0), Threads.size(), [&](size_t I) {
+    for (auto &B : Threads[I]->second) {
+      BlockVerifier Verifier;
+      for (auto *R : B.Records)
+        if (auto E = R->apply(Verifier)) {
+          Errors[I] = std::move(E);
+          return;
+        }
+      if (auto E = Verifier.verify()) {
+        Errors[I] = std::move(E);
+        return;
       }
     }
-  }
+  });
+  if (auto E = TakeFirstError())
+    return E;
 
   // This is now the meat of the algorithm. Here we sort the blocks according to
   // the Walltime record in each of the blocks for the same thread. This allows
   // us to more consistently recreate the execution trace in temporal order.
   // After the sort, we then reconstitute `Trace` records using a stateful
   // visitor associated with a single process+thread pair.
-  {
-    for (auto &PTB : Index) {
-      auto &Blocks = PTB.second;
-      llvm::sort(Blocks, [](const BlockIndexer::Block &L,
-                            const BlockIndexer::Block &R) {
-        return (L.WallclockTime->seconds() < R.WallclockTime->seconds() &&
-                L.WallclockTime->nanos() < R.WallclockTime->nanos());
-      });
-      auto Adder = [&](const XRayRecord &R) { Records.push_back(R); };
-      TraceExpander Expander(Adder, FileHeader.Version);
-      for (auto &B : Blocks) {
-        for (auto *R : B.Records)
-          if (auto E = R->apply(Expander))
-            return E;
-      }
-      if (auto E = Expander.flush())
-        return E;
+  std::vector<std::vector<XRayRecord>> ThreadRecords(Threads.size());
+  parallel::for_each_n(parallel::par, size_t(0), Threads.size(), [&](size_t I) {
+    auto &Blocks = Threads[I]->second;
+    llvm::sort(Blocks, [](const BlockIndexer::Block &L,
+                          const BlockIndexer::Block &R) {
+      return (L.WallclockTime->seconds() < R.WallclockTime->seconds() &&
+              L.WallclockTime->nanos() < R.WallclockTime->nanos());
+    });
+    auto Adder = [&](const XRayRecord &R) { ThreadRecords[I].push_back(R); };
+    TraceExpander Expander(Adder, FileHeader.Version);
+    for (auto &B : Blocks) {
+      for (auto *R : B.Records)
+        if (auto E = R->apply(Expander)) {
+          Errors[I] = std::move(E);
+          return;
+        }
     }
+    if (auto E = Expander.flush())
+      Errors[I] = std::move(E);
+  });
+  for (size_t I = 0, E = Threads.size(); I != E; ++I) {
+    if (Errors[I])
+      return TakeFirstError();
+    Records.insert(Records.end(), ThreadRecords[I].begin(),
+                   ThreadRecords[I].end());
   }
 
   return Error::success();
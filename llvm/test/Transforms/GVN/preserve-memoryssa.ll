@@ -0,0 +1,109 @@
+; RUN: opt -S -passes='require<memoryssa>,gvn' -verify-memoryssa < %s | FileCheck %s
+; RUN: opt -S -memoryssa -gvn -verify-memoryssa < %s | FileCheck %s
+; RUN: opt -disable-output -debug-pass-manager -passes='require<memoryssa>,gvn' \
+; RUN:   < %s 2>&1 | FileCheck %s --check-prefix=PM
+
+; GVN keeps an already computed MemorySSA up to date with its changes, which
+; -verify-memoryssa checks after each function, and preserves it.
+
+; PM: Running analysis: MemorySSAAnalysis
+; PM: Running pass: GVN
+; PM-NOT: Invalidating analysis: MemorySSAAnalysis
+; PM: Finished llvm::Module pass manager run.
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-f80:128:128-n8:16:32:64"
+
+%widening = type { i32, i8, i8, i8, i8 }
+
+@w = global %widening zeroinitializer, align 4
+
+declare void @llvm.assume(i1)
+
+; The load of %join is PRE'd into %else.
+define i32 @load_pre(i32* %p, i1 %c) {
+; CHECK-LABEL: @load_pre(
+; CHECK: else:
+; CHECK-NEXT: %v2.pre = load i32, i32* %p
+; CHECK: join:
+; CHECK-NEXT: %v2 = phi i32
+; CHECK-NOT: load
+; CHECK: ret i32 %v2
+entry:
+  br i1 %c, label %if, label %else
+
+if:
+  %v1 = load i32, i32* %p
+  br label %join
+
+else:
+  br label %join
+
+join:
+  %v2 = load i32, i32* %p
+  ret i32 %v2
+}
+
+; The load of %join is PRE'd into the block splitting the critical edge from
+; %entry.
+define i32 @load_pre_critical_edge(i32* %p, i1 %c) {
+; CHECK-LABEL: @load_pre_critical_edge(
+; CHECK: entry.join_crit_edge:
+; CHECK-NEXT: %v2.pre = load i32, i32* %p
+; CHECK: join:
+; CHECK-NEXT: %v2 = phi i32
+; CHECK-NOT: load
+; CHECK: ret i32 %v2
+entry:
+  br i1 %c, label %if, label %join
+
+if:
+  %v1 = load i32, i32* %p
+  br label %join
+
+join:
+  %v2 = load i32, i32* %p
+  ret i32 %v2
+}
+
+; The first load is widened to provide the value of the second one.
+define i32 @load_widening() {
+; CHECK-LABEL: @load_widening(
+; CHECK: load i16, i16*
+; CHECK-NOT: load i8
+; CHECK: ret i32
+entry:
+  %l1 = load i8, i8* getelementptr inbounds (%widening, %widening* @w, i64 0, i32 1), align 4
+  %c1 = zext i8 %l1 to i32
+  %l2 = load i8, i8* getelementptr inbounds (%widening, %widening* @w, i64 0, i32 2), align 1
+  %c2 = zext i8 %l2 to i32
+  %add = add nsw i32 %c1, %c2
+  ret i32 %add
+}
+
+; assume(false) is replaced with a store to null, between two stores.
+define void @assume_false(i32* %p) {
+; CHECK-LABEL: @assume_false(
+; CHECK: store i32 1, i32* %p
+; CHECK-NEXT: store i8 undef, i8* null
+; CHECK-NEXT: store i32 2, i32* %p
+entry:
+  store i32 1, i32* %p
+  call void @llvm.assume(i1 false)
+  store i32 2, i32* %p
+  ret void
+}
+
+; %next is merged into %entry, and its load is replaced with the stored value.
+define i32 @merge_blocks(i32* %p) {
+; CHECK-LABEL: @merge_blocks(
+; CHECK-NEXT: entry:
+; CHECK-NEXT: store i32 1, i32* %p
+; CHECK-NEXT: ret i32 1
+entry:
+  store i32 1, i32* %p
+  br label %next
+
+next:
+  %v = load i32, i32* %p
+  ret i32 %v
+}
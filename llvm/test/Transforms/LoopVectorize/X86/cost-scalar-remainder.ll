@@ -0,0 +1,45 @@
+; RUN: opt < %s -loop-vectorize -force-vector-interleave=1 \
+; RUN:   -vectorizer-min-trip-count=8 -vectorizer-cost-scalar-remainder \
+; RUN:   -S | FileCheck %s --check-prefix=REMAINDER
+; RUN: opt < %s -loop-vectorize -force-vector-interleave=1 \
+; RUN:   -vectorizer-min-trip-count=8 -vectorizer-cost-scalar-remainder=false \
+; RUN:   -S | FileCheck %s --check-prefix=PER-LANE
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; With 12 iterations, VF 8 runs one vector iteration and leaves 4 iterations
+; to the scalar loop, while VF 4 runs 3 vector iterations and no scalar one.
+; Counting the scalar remainder picks VF 4, the cost per lane picks VF 8.
+
+; REMAINDER-LABEL: @add_12(
+; REMAINDER: load <4 x i32>
+; REMAINDER: add nsw <4 x i32>
+; REMAINDER: store <4 x i32>
+; REMAINDER-NOT: <8 x i32>
+
+; PER-LANE-LABEL: @add_12(
+; PER-LANE: load <8 x i32>
+; PER-LANE: add nsw <8 x i32>
+; PER-LANE: store <8 x i32>
+
+define void @add_12(i32* noalias nocapture %a, i32* noalias nocapture readonly %b) #0 {
+entry:
+  br label %for.body
+
+for.body:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %for.body ]
+  %arrayidx = getelementptr inbounds i32, i32* %b, i64 %i
+  %0 = load i32, i32* %arrayidx, align 4
+  %add = add nsw i32 %0, 42
+  %arrayidx2 = getelementptr inbounds i32, i32* %a, i64 %i
+  store i32 %add, i32* %arrayidx2, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %exitcond = icmp eq i64 %i.next, 12
+  br i1 %exitcond, label %for.end, label %for.body
+
+for.end:
+  ret void
+}
+
+attributes #0 = { "target-cpu"="haswell" }
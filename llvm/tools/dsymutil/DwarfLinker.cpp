@@ -2650,6 +2650,20 @@ bool DwarfLinker::link(const DebugMap &Map) {
     LinkContext.CompileUnits.reserve(
         LinkContext.DwarfContext->getNumCompileUnits());
 
+    // Extracting the DIEs of a unit only reads the object and writes to the
+    // unit once its abbreviations are known, so the units are extracted in
+    // parallel ahead of the serial loop below.
+    if (Options.Threads > 1) {
+      for (const auto &CU : LinkContext.DwarfContext->compile_units())
+        CU->getAbbreviations();
+      ThreadPool Pool(Options.Threads);
+      for (const auto &CU : LinkContext.DwarfContext->compile_units()) {
+        DWARFUnit *Unit = CU.get();
+        Pool.async([Unit] { Unit->getUnitDIE(false); });
+      }
+      Pool.wait();
+    }
+
     for (const auto &CU : LinkContext.DwarfContext->compile_units()) {
       updateDwarfVersion(CU->getVersion());
       auto CUDie = CU->getUnitDIE(false);
@@ -154,6 +154,12 @@ static cl::opt<std::string>
                            "names match the given regular expression"),
                   cl::value_desc("regex"));
 
+static cl::opt<std::string>
+    RemarksFormat("pass-remarks-format",
+                  cl::desc("The format used for serializing remarks "
+                           "(yaml or binary)"),
+                  cl::value_desc("format"), cl::init("yaml"));
+
 namespace {
 static ManagedStatic<std::vector<std::string>> RunPassNames;
 
@@ -333,6 +339,12 @@ int main(int argc, char **argv) {
 
   std::unique_ptr<ToolOutputFile> YamlFile;
   if (RemarksFilename != "") {
+    Expected<remarks::Format> Format = remarks::parseFormat(RemarksFormat);
+    if (!Format) {
+      WithColor::error(errs(), argv[0]) << Format.takeError() << '\n';
+      return 1;
+    }
+
     std::error_code EC;
     YamlFile =
         llvm::make_unique<ToolOutputFile>(RemarksFilename, EC, sys::fs::F_None);
@@ -340,8 +352,8 @@ int main(int argc, char **argv) {
       WithColor::error(errs(), argv[0]) << EC.message() << '\n';
       return 1;
     }
-    Context.setRemarkStreamer(
-        llvm::make_unique<RemarkStreamer>(RemarksFilename, YamlFile->os()));
+    Context.setRemarkStreamer(llvm::make_unique<RemarkStreamer>(
+        RemarksFilename, YamlFile->os(), *Format));
 
     if (!RemarksPasses.empty())
       if (Error E = Context.getRemarkStreamer()->setFilter(RemarksPasses)) {
@@ -27,6 +27,7 @@
 #include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/OnDiskObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/OrcRemoteTargetClient.h"
 #include "llvm/ExecutionEngine/OrcMCJITReplacement.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
@@ -113,6 +114,13 @@ namespace {
                "rather than individual functions"),
       cl::init(false));
 
+  cl::opt<bool> SpeculateCallees(
+      "speculate-callees",
+      cl::desc("Compiles the direct callees of each lazily compiled function "
+               "on the compile threads ahead of their first call "
+               "(jit-kind=orc-lazy only)"),
+      cl::init(false));
+
   cl::list<std::string>
       JITDylibs("jd",
                 cl::desc("Specifies the JITDylib to be used for any subsequent "
@@ -786,11 +794,26 @@ int runOrcLazyJIT(const char *ProgName) {
       pointerToJITTargetAddress(exitOnLazyCallThroughFailure));
   Builder.setNumCompileThreads(LazyJITCompileThreads);
 
+  std::unique_ptr<orc::OnDiskObjectCache> ObjCache;
+  if (EnableCacheManager) {
+    if (ObjectCacheDir.empty()) {
+      errs() << "-enable-cache-manager requires -object-cache-dir when used "
+                "with -jit-kind=orc-lazy\n";
+      exit(1);
+    }
+    ObjCache = ExitOnErr(orc::OnDiskObjectCache::Create(
+        ObjectCacheDir, *Builder.getJITTargetMachineBuilder()));
+    Builder.setObjectCache(ObjCache.get());
+  }
+
   auto J = ExitOnErr(Builder.create());
 
   if (PerModuleLazy)
     J->setPartitionFunction(orc::CompileOnDemandLayer::compileWholeModule);
 
+  if (SpeculateCallees)
+    J->setSpeculateFunction(orc::CompileOnDemandLayer::speculateDirectCallees);
+
   auto Dump = createDebugDumper();
 
   J->setLazyCompileTransform([&](orc::ThreadSafeModule TSM,
@@ -908,6 +931,11 @@ void disallowOrcOptions() {
     errs() << "-per-module-lazy requires -jit-kind=orc-lazy\n";
     exit(1);
   }
+
+  if (SpeculateCallees) {
+    errs() << "-speculate-callees requires -jit-kind=orc-lazy\n";
+    exit(1);
+  }
 }
 
 std::unique_ptr<FDRawChannel> launchRemote() {
@@ -475,6 +475,31 @@ static StringRef normalizePath(StringRef Path) {
   return CompareFullPath ? Path : sys::path::filename(Path);
 }
 
+// The number of the members left in Members by their normalized path. Large
+// archives mostly have children which are not named on the command line, the
+// index skips them without a scan of Members for each child.
+static StringMap<unsigned> MemberIndex;
+
+static void buildMemberIndex() {
+  MemberIndex.clear();
+  for (StringRef Path : Members)
+    ++MemberIndex[normalizePath(Path)];
+}
+
+static std::vector<StringRef>::iterator findMember(StringRef Name) {
+  if (!MemberIndex.count(Name))
+    return Members.end();
+  return find_if(
+      Members, [Name](StringRef Path) { return Name == normalizePath(Path); });
+}
+
+static void eraseMember(std::vector<StringRef>::iterator I) {
+  auto Entry = MemberIndex.find(normalizePath(*I));
+  if (--Entry->second == 0)
+    MemberIndex.erase(Entry);
+  Members.erase(I);
+}
+
 // Implement the 'x' operation. This function extracts files back to the file
 // system.
 static void doExtract(StringRef Name, const object::Archive::Child &C) {
@@ -539,6 +564,7 @@ static void performReadOperation(ArchiveOperation Operation,
 
   bool Filter = !Members.empty();
   StringMap<int> MemberCount;
+  buildMemberIndex();
   {
     Error Err = Error::success();
     for (auto &C : OldArchive->children(Err)) {
@@ -547,14 +573,12 @@ static void performReadOperation(ArchiveOperation Operation,
       StringRef Name = NameOrErr.get();
 
       if (Filter) {
-        auto I = find_if(Members, [Name](StringRef Path) {
-          return Name == normalizePath(Path);
-        });
+        auto I = findMember(Name);
         if (I == Members.end())
           continue;
         if (CountParam && ++MemberCount[Name] != CountParam)
           continue;
-        Members.erase(I);
+        eraseMember(I);
       }
 
       switch (Operation) {
@@ -659,8 +683,7 @@ static InsertAction computeInsertAction(ArchiveOperation Operation,
                                         StringMap<int> &MemberCount) {
   if (Operation == QuickAppend || Members.empty())
     return IA_AddOldMember;
-  auto MI = find_if(
-      Members, [Name](StringRef Path) { return Name == normalizePath(Path); });
+  auto MI = findMember(Name);
 
   if (MI == Members.end())
     return IA_AddOldMember;
@@ -715,6 +738,7 @@ computeNewArchiveMembers(ArchiveOperation Operation,
   if (OldArchive) {
     Error Err = Error::success();
     StringMap<int> MemberCount;
+    buildMemberIndex();
     for (auto &Child : OldArchive->children(Err)) {
       int Pos = Ret.size();
       Expected<StringRef> NameOrErr = Child.getName();
@@ -753,7 +777,7 @@ computeNewArchiveMembers(ArchiveOperation Operation,
       // file named member.o it sees; we are not done with member.o the first
       // time we see it in the archive.
       if (MemberI != Members.end() && !CountParam)
-        Members.erase(MemberI);
+        eraseMember(MemberI);
     }
     failIfError(std::move(Err));
   }
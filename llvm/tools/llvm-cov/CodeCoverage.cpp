@@ -351,8 +351,13 @@ std::unique_ptr<CoverageMapping> CodeCoverageTool::load() {
     if (modifiedTimeGT(ObjectFilename, PGOFilename))
       warning("profile data may be out of date - object is newer",
               ObjectFilename);
-  auto CoverageOrErr =
-      CoverageMapping::load(ObjectFilenames, PGOFilename, CoverageArches);
+  // Only the functions of the requested source files are needed, unless their
+  // paths are remapped after loading.
+  std::vector<StringRef> FilesToLoad;
+  if (!PathRemapping)
+    FilesToLoad.assign(SourceFiles.begin(), SourceFiles.end());
+  auto CoverageOrErr = CoverageMapping::load(ObjectFilenames, PGOFilename,
+                                             CoverageArches, FilesToLoad);
   if (Error E = CoverageOrErr.takeError()) {
     error("Failed to load coverage: " + toString(std::move(E)),
           join(ObjectFilenames.begin(), ObjectFilenames.end(), ", "));
@@ -10,6 +10,9 @@
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdlib>
 #include <iostream>
@@ -49,34 +52,68 @@ static cl::opt<bool>
 static cl::alias TypesShort("t", cl::desc("alias for --types"),
                             cl::aliasopt(Types));
 
+static cl::opt<bool>
+    Batch("batch",
+          cl::desc("read all of the standard input, then demangle it on "
+                   "several threads"),
+          cl::init(false));
+
 static cl::list<std::string>
 Decorated(cl::Positional, cl::desc("<mangled>"), cl::ZeroOrMore);
 
-static std::string demangle(llvm::raw_ostream &OS, const std::string &Mangled) {
-  int Status;
+namespace {
+// Demangles names one after the other, reusing the memory of the demangler
+// and the output buffer across the names.
+class NameDemangler {
+  ItaniumPartialDemangler Demangler;
+  char *Buf = nullptr;
+  size_t Capacity = 0;
+
+public:
+  NameDemangler() = default;
+  NameDemangler(const NameDemangler &) = delete;
+  NameDemangler &operator=(const NameDemangler &) = delete;
+  ~NameDemangler() { std::free(Buf); }
+
+  // Returns the demangled name, or nullptr if Mangled isn't a valid name.
+  const char *demangle(const char *Mangled) {
+    if (Demangler.partialDemangle(Mangled))
+      return nullptr;
+    size_t N = Capacity;
+    char *Result = Demangler.finishDemangle(Buf, &N);
+    if (!Result)
+      return nullptr;
+    // N is the length of the name; the buffer is at least as large, and
+    // didn't shrink if it was reallocated.
+    Buf = Result;
+    Capacity = std::max(Capacity, N);
+    return Buf;
+  }
+};
+} // namespace
 
+static std::string demangle(NameDemangler &Demangler,
+                            const std::string &Mangled) {
   const char *DecoratedStr = Mangled.c_str();
   if (StripUnderscore)
     if (DecoratedStr[0] == '_')
       ++DecoratedStr;
   size_t DecoratedLength = strlen(DecoratedStr);
 
-  char *Undecorated = nullptr;
+  const char *Undecorated = nullptr;
 
   if (Types ||
       ((DecoratedLength >= 2 && strncmp(DecoratedStr, "_Z", 2) == 0) ||
        (DecoratedLength >= 4 && strncmp(DecoratedStr, "___Z", 4) == 0)))
-    Undecorated = itaniumDemangle(DecoratedStr, nullptr, nullptr, &Status);
+    Undecorated = Demangler.demangle(DecoratedStr);
 
   if (!Undecorated &&
       (DecoratedLength > 6 && strncmp(DecoratedStr, "__imp_", 6) == 0)) {
-    OS << "import thunk for ";
-    Undecorated = itaniumDemangle(DecoratedStr + 6, nullptr, nullptr, &Status);
+    if ((Undecorated = Demangler.demangle(DecoratedStr + 6)))
+      return std::string("import thunk for ") + Undecorated;
   }
 
-  std::string Result(Undecorated ? Undecorated : Mangled);
-  free(Undecorated);
-  return Result;
+  return Undecorated ? Undecorated : Mangled;
 }
 
 // Split 'Source' on any character that fails to pass 'IsLegalChar'.  The
@@ -116,17 +153,48 @@ static bool IsLegalItaniumChar(char C) {
 // If 'Split' is true, then 'Mangled' is broken into individual words and each
 // word is demangled.  Otherwise, the entire string is treated as a single
 // mangled item.  The result is output to 'OS'.
-static void demangleLine(llvm::raw_ostream &OS, StringRef Mangled, bool Split) {
-  std::string Result;
+static void demangleLine(NameDemangler &Demangler, llvm::raw_ostream &OS,
+                         StringRef Mangled, bool Split) {
   if (Split) {
     SmallVector<std::pair<StringRef, StringRef>, 16> Words;
     SplitStringDelims(Mangled, Words, IsLegalItaniumChar);
     for (const auto &Word : Words)
-      Result += demangle(OS, Word.first) + Word.second.str();
+      OS << demangle(Demangler, Word.first) << Word.second;
   } else
-    Result = demangle(OS, Mangled);
-  OS << Result << '\n';
-  OS.flush();
+    OS << demangle(Demangler, Mangled);
+  OS << '\n';
+}
+
+// Demangles all of the standard input, split in chunks of lines demangled on
+// separate threads, and writes the chunks in order.
+static int demangleBatch(const char *Argv0) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> InputOrErr = MemoryBuffer::getSTDIN();
+  if (!InputOrErr) {
+    WithColor::error(errs(), Argv0) << InputOrErr.getError().message() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  SmallVector<StringRef, 0> Lines;
+  StringRef Input = (*InputOrErr)->getBuffer();
+  if (Input.endswith("\n"))
+    Input = Input.drop_back();
+  if (!Input.empty())
+    Input.split(Lines, '\n');
+
+  const size_t ChunkSize = 4096;
+  size_t NumChunks = (Lines.size() + ChunkSize - 1) / ChunkSize;
+  std::vector<std::string> Chunks(NumChunks);
+  parallel::for_each_n(parallel::par, size_t(0), NumChunks, [&](size_t I) {
+    NameDemangler Demangler;
+    raw_string_ostream OS(Chunks[I]);
+    size_t End = std::min(Lines.size(), (I + 1) * ChunkSize);
+    for (size_t L = I * ChunkSize; L != End; ++L)
+      demangleLine(Demangler, OS, Lines[L], true);
+  });
+
+  for (const std::string &Chunk : Chunks)
+    llvm::outs() << Chunk;
+  return EXIT_SUCCESS;
 }
 
 int main(int argc, char **argv) {
@@ -134,12 +202,20 @@ int main(int argc, char **argv) {
 
   cl::ParseCommandLineOptions(argc, argv, "llvm symbol undecoration tool\n");
 
-  if (Decorated.empty())
-    for (std::string Mangled; std::getline(std::cin, Mangled);)
-      demangleLine(llvm::outs(), Mangled, true);
-  else
-    for (const auto &Symbol : Decorated)
-      demangleLine(llvm::outs(), Symbol, false);
+  NameDemangler Demangler;
+  if (Decorated.empty()) {
+    if (Batch)
+      return demangleBatch(argv[0]);
+    for (std::string Mangled; std::getline(std::cin, Mangled);) {
+      demangleLine(Demangler, llvm::outs(), Mangled, true);
+      llvm::outs().flush();
+    }
+  } else {
+    for (const auto &Symbol : Decorated) {
+      demangleLine(Demangler, llvm::outs(), Symbol, false);
+      llvm::outs().flush();
+    }
+  }
 
   return EXIT_SUCCESS;
 }
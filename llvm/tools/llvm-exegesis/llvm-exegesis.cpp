@@ -85,6 +85,20 @@ static cl::opt<unsigned>
                    cl::desc("number of time to repeat the asm snippet"),
                    cl::cat(BenchmarkOptions), cl::init(10000));
 
+static cl::opt<unsigned>
+    NumShards("num-shards",
+              cl::desc("number of shards to split the snippets to measure "
+                       "into, for as many processes (e.g. each pinned to its "
+                       "own core with taskset) whose benchmark files can then "
+                       "be concatenated"),
+              cl::cat(BenchmarkOptions), cl::init(1));
+
+static cl::opt<unsigned>
+    ShardIndex("shard-index",
+               cl::desc("index of the shard of the snippets to measure, see "
+                        "num-shards"),
+               cl::cat(BenchmarkOptions), cl::init(0));
+
 static cl::opt<bool> IgnoreInvalidSchedClass(
     "ignore-invalid-sched-class",
     cl::desc("ignore instructions that do not define a sched class"),
@@ -406,11 +420,16 @@ void benchmarkMain() {
   if (NumRepetitions == 0)
     llvm::report_fatal_error("--num-repetitions must be greater than zero");
 
+  if (ShardIndex >= NumShards)
+    llvm::report_fatal_error("--shard-index must be less than --num-shards");
+
   // Write to standard output if file is not set.
   if (BenchmarkFile.empty())
     BenchmarkFile = "-";
 
-  for (const BenchmarkCode &Conf : Configurations) {
+  for (size_t I = ShardIndex, E = Configurations.size(); I < E;
+       I += NumShards) {
+    const BenchmarkCode &Conf = Configurations[I];
     InstructionBenchmark Result =
         Runner->runConfiguration(Conf, NumRepetitions, DumpObjectToDisk);
     ExitOnErr(Result.writeYaml(State, BenchmarkFile));
@@ -26,6 +26,8 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/SystemUtils.h"
@@ -110,21 +112,24 @@ static cl::opt<bool> PreserveAssemblyUseListOrder(
 
 static ExitOnError ExitOnErr;
 
-// Read the specified bitcode file in and return it. This routine searches the
-// link path for the specified file to try to find it...
-//
-static std::unique_ptr<Module> loadFile(const char *argv0,
-                                        const std::string &FN,
-                                        LLVMContext &Context,
-                                        bool MaterializeMetadata = true) {
+// Parse the module of the file FN from its contents, which were read with
+// MemoryBuffer::getFileOrSTDIN.
+static std::unique_ptr<Module>
+loadFile(const char *argv0, const std::string &FN,
+         ErrorOr<std::unique_ptr<MemoryBuffer>> FileOrErr, LLVMContext &Context,
+         bool MaterializeMetadata = true) {
   SMDiagnostic Err;
   if (Verbose)
     errs() << "Loading '" << FN << "'\n";
   std::unique_ptr<Module> Result;
-  if (DisableLazyLoad)
-    Result = parseIRFile(FN, Err, Context);
+  if (std::error_code EC = FileOrErr.getError())
+    Err = SMDiagnostic(FN, SourceMgr::DK_Error,
+                       "Could not open input file: " + EC.message());
+  else if (DisableLazyLoad)
+    Result = parseIR(FileOrErr.get()->getMemBufferRef(), Err, Context);
   else
-    Result = getLazyIRFileModule(FN, Err, Context, !MaterializeMetadata);
+    Result = getLazyIRModule(std::move(FileOrErr.get()), Err, Context,
+                             !MaterializeMetadata);
 
   if (!Result) {
     Err.print(argv0, errs());
@@ -139,6 +144,17 @@ static std::unique_ptr<Module> loadFile(const char *argv0,
   return Result;
 }
 
+// Read the specified bitcode file in and return it. This routine searches the
+// link path for the specified file to try to find it...
+//
+static std::unique_ptr<Module> loadFile(const char *argv0,
+                                        const std::string &FN,
+                                        LLVMContext &Context,
+                                        bool MaterializeMetadata = true) {
+  return loadFile(argv0, FN, MemoryBuffer::getFileOrSTDIN(FN), Context,
+                  MaterializeMetadata);
+}
+
 namespace {
 
 /// Helper to load on demand a Module from file and cache it for subsequent
@@ -279,8 +295,45 @@ static bool linkFiles(const char *argv0, LLVMContext &Context, Linker &L,
   unsigned ApplicableFlags = Flags & Linker::Flags::OverrideFromSrc;
   // Similar to some flags, internalization doesn't apply to the first file.
   bool InternalizeLinkedSymbols = false;
-  for (const auto &File : Files) {
-    std::unique_ptr<Module> M = loadFile(argv0, File, Context);
+
+  // The modules are parsed in the context one after the other, but reading
+  // the files doesn't involve the context, so it is done for all of them up
+  // front and in parallel.
+  std::vector<std::unique_ptr<MemoryBuffer>> Buffers(Files.size());
+  std::vector<std::error_code> BufferErrors(Files.size());
+  auto ReadFile = [&](size_t I) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> FileOrErr =
+        MemoryBuffer::getFileOrSTDIN(Files[I]);
+    if (FileOrErr)
+      Buffers[I] = std::move(*FileOrErr);
+    else
+      BufferErrors[I] = FileOrErr.getError();
+  };
+  parallel::for_each_n(parallel::par, size_t(0), Buffers.size(), ReadFile);
+
+  // The summary index is the same for all the files.
+  std::unique_ptr<ModuleSummaryIndex> Index;
+  if (!SummaryIndex.empty()) {
+    Index = ExitOnErr(llvm::getModuleSummaryIndexForFile(SummaryIndex));
+
+    // Conservatively mark all internal values as promoted, since this tool
+    // does not do the ThinLink that would normally determine what values to
+    // promote.
+    for (auto &I : *Index) {
+      for (auto &S : I.second.SummaryList) {
+        if (GlobalValue::isLocalLinkage(S->linkage()))
+          S->setLinkage(GlobalValue::ExternalLinkage);
+      }
+    }
+  }
+
+  for (size_t I = 0, E = Files.size(); I != E; ++I) {
+    const std::string &File = Files[I];
+    ErrorOr<std::unique_ptr<MemoryBuffer>> FileOrErr = std::move(Buffers[I]);
+    if (BufferErrors[I])
+      FileOrErr = BufferErrors[I];
+    std::unique_ptr<Module> M =
+        loadFile(argv0, File, std::move(FileOrErr), Context);
     if (!M.get()) {
       errs() << argv0 << ": ";
       WithColor::error() << " loading file '" << File << "'\n";
@@ -296,22 +349,9 @@ static bool linkFiles(const char *argv0, LLVMContext &Context, Linker &L,
       return false;
     }
 
-    // If a module summary index is supplied, load it so linkInModule can treat
+    // If a module summary index is supplied, use it so linkInModule can treat
     // local functions/variables as exported and promote if necessary.
-    if (!SummaryIndex.empty()) {
-      std::unique_ptr<ModuleSummaryIndex> Index =
-          ExitOnErr(llvm::getModuleSummaryIndexForFile(SummaryIndex));
-
-      // Conservatively mark all internal values as promoted, since this tool
-      // does not do the ThinLink that would normally determine what values to
-      // promote.
-      for (auto &I : *Index) {
-        for (auto &S : I.second.SummaryList) {
-          if (GlobalValue::isLocalLinkage(S->linkage()))
-            S->setLinkage(GlobalValue::ExternalLinkage);
-        }
-      }
-
+    if (Index) {
       // Promotion
       if (renameModuleForThinLTO(*M, *Index))
         return true;
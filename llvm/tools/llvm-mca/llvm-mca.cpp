@@ -51,6 +51,8 @@
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
 
@@ -192,6 +194,14 @@ static cl::opt<bool> EnableBottleneckAnalysis(
     cl::desc("Enable bottleneck analysis (disabled by default)"),
     cl::cat(ViewOptions), cl::init(false));
 
+static cl::opt<unsigned>
+    NumThreads("num-threads",
+               cl::desc("Number of threads analyzing the code regions in "
+                        "parallel (0 = one per core)"),
+               cl::cat(ToolOptions), cl::init(1));
+static cl::alias NumThreadsA("j", cl::desc("Alias for --num-threads"),
+                             cl::aliasopt(NumThreads));
+
 namespace {
 
 const Target *getTarget(const char *ProgName) {
@@ -262,6 +272,120 @@ static bool runPipeline(mca::Pipeline &P) {
   return true;
 }
 
+/// Analyze \p Region and print its report to \p OS. Returns true on success.
+/// This only reads the target description, so the regions may be analyzed
+/// concurrently as long as each of them uses its own instruction printer.
+static bool analyzeRegion(const mca::CodeRegion &Region,
+                          const MCSubtargetInfo &STI, const MCInstrInfo &MCII,
+                          const MCRegisterInfo &MRI,
+                          const MCInstrAnalysis *MCIA, MCInstPrinter &IP,
+                          const mca::PipelineOptions &PO, raw_ostream &OS) {
+  const MCSchedModel &SM = STI.getSchedModel();
+
+  // Create an instruction builder.
+  mca::InstrBuilder IB(STI, MCII, MRI, MCIA);
+
+  // Create a context to control ownership of the pipeline hardware.
+  mca::Context MCA(MRI, STI);
+
+  // Lower the MCInst sequence into an mca::Instruction sequence.
+  ArrayRef<MCInst> Insts = Region.getInstructions();
+  std::vector<std::unique_ptr<mca::Instruction>> LoweredSequence;
+  for (const MCInst &MCI : Insts) {
+    Expected<std::unique_ptr<mca::Instruction>> Inst =
+        IB.createInstruction(MCI);
+    if (!Inst) {
+      if (auto NewE = handleErrors(
+              Inst.takeError(),
+              [&IP, &STI](const mca::InstructionError<MCInst> &IE) {
+                std::string InstructionStr;
+                raw_string_ostream SS(InstructionStr);
+                WithColor::error() << IE.Message << '\n';
+                IP.printInst(&IE.Inst, SS, "", STI);
+                SS.flush();
+                WithColor::note() << "instruction: " << InstructionStr
+                                  << '\n';
+              })) {
+        // Default case.
+        WithColor::error() << toString(std::move(NewE));
+      }
+      return false;
+    }
+
+    LoweredSequence.emplace_back(std::move(Inst.get()));
+  }
+
+  mca::SourceMgr S(LoweredSequence, PrintInstructionTables ? 1 : Iterations);
+
+  if (PrintInstructionTables) {
+    //  Create a pipeline, stages, and a printer.
+    auto P = llvm::make_unique<mca::Pipeline>();
+    P->appendStage(llvm::make_unique<mca::EntryStage>(S));
+    P->appendStage(llvm::make_unique<mca::InstructionTables>(SM));
+    mca::PipelinePrinter Printer(*P);
+
+    // Create the views for this pipeline, execute, and emit a report.
+    if (PrintInstructionInfoView) {
+      Printer.addView(llvm::make_unique<mca::InstructionInfoView>(
+          STI, MCII, Insts, IP));
+    }
+    Printer.addView(
+        llvm::make_unique<mca::ResourcePressureView>(STI, IP, Insts));
+
+    if (!runPipeline(*P))
+      return false;
+
+    Printer.printReport(OS);
+    return true;
+  }
+
+  // Create a basic pipeline simulating an out-of-order backend.
+  auto P = MCA.createDefaultPipeline(PO, IB, S);
+  mca::PipelinePrinter Printer(*P);
+
+  if (PrintSummaryView)
+    Printer.addView(llvm::make_unique<mca::SummaryView>(
+        SM, Insts, DispatchWidth));
+
+  if (EnableBottleneckAnalysis)
+    Printer.addView(llvm::make_unique<mca::BottleneckAnalysis>(SM));
+
+  if (PrintInstructionInfoView)
+    Printer.addView(
+        llvm::make_unique<mca::InstructionInfoView>(STI, MCII, Insts, IP));
+
+  if (PrintDispatchStats)
+    Printer.addView(llvm::make_unique<mca::DispatchStatistics>());
+
+  if (PrintSchedulerStats)
+    Printer.addView(llvm::make_unique<mca::SchedulerStatistics>(STI));
+
+  if (PrintRetireStats)
+    Printer.addView(llvm::make_unique<mca::RetireControlUnitStatistics>(SM));
+
+  if (PrintRegisterFileStats)
+    Printer.addView(llvm::make_unique<mca::RegisterFileStatistics>(STI));
+
+  if (PrintResourcePressureView)
+    Printer.addView(
+        llvm::make_unique<mca::ResourcePressureView>(STI, IP, Insts));
+
+  if (PrintTimelineView) {
+    unsigned TimelineIterations =
+        TimelineMaxIterations ? TimelineMaxIterations : 10;
+    Printer.addView(llvm::make_unique<mca::TimelineView>(
+        STI, IP, Insts, std::min(TimelineIterations, S.getNumIterations()),
+        TimelineMaxCycles));
+  }
+
+  if (!runPipeline(*P))
+    return false;
+
+  Printer.printReport(OS);
+
+  return true;
+}
+
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
 
@@ -396,14 +520,6 @@ int main(int argc, char **argv) {
 
   std::unique_ptr<ToolOutputFile> TOF = std::move(*OF);
 
-  const MCSchedModel &SM = STI->getSchedModel();
-
-  // Create an instruction builder.
-  mca::InstrBuilder IB(*STI, *MCII, *MRI, MCIA.get());
-
-  // Create a context to control ownership of the pipeline hardware.
-  mca::Context MCA(*MRI, *STI);
-
   mca::PipelineOptions PO(MicroOpQueue, DecoderThroughput, DispatchWidth,
                           RegisterFileSize, LoadQueueSize, StoreQueueSize,
                           AssumeNoAlias, EnableBottleneckAnalysis);
@@ -411,118 +527,63 @@ int main(int argc, char **argv) {
   // Number each region in the sequence.
   unsigned RegionIdx = 0;
 
+  // Print the header of each region ahead of its report.
+  std::vector<const mca::CodeRegion *> RegionsToAnalyze;
+  std::vector<std::string> Headers;
   for (const std::unique_ptr<mca::CodeRegion> &Region : Regions) {
     // Skip empty code regions.
     if (Region->empty())
       continue;
 
+    RegionsToAnalyze.push_back(Region.get());
+    Headers.emplace_back();
+    raw_string_ostream HeaderOS(Headers.back());
+
     // Don't print the header of this region if it is the default region, and
     // it doesn't have an end location.
     if (Region->startLoc().isValid() || Region->endLoc().isValid()) {
-      TOF->os() << "\n[" << RegionIdx++ << "] Code Region";
+      HeaderOS << "\n[" << RegionIdx++ << "] Code Region";
       StringRef Desc = Region->getDescription();
       if (!Desc.empty())
-        TOF->os() << " - " << Desc;
-      TOF->os() << "\n\n";
+        HeaderOS << " - " << Desc;
+      HeaderOS << "\n\n";
     }
+  }
 
-    // Lower the MCInst sequence into an mca::Instruction sequence.
-    ArrayRef<MCInst> Insts = Region->getInstructions();
-    std::vector<std::unique_ptr<mca::Instruction>> LoweredSequence;
-    for (const MCInst &MCI : Insts) {
-      Expected<std::unique_ptr<mca::Instruction>> Inst =
-          IB.createInstruction(MCI);
-      if (!Inst) {
-        if (auto NewE = handleErrors(
-                Inst.takeError(),
-                [&IP, &STI](const mca::InstructionError<MCInst> &IE) {
-                  std::string InstructionStr;
-                  raw_string_ostream SS(InstructionStr);
-                  WithColor::error() << IE.Message << '\n';
-                  IP->printInst(&IE.Inst, SS, "", *STI);
-                  SS.flush();
-                  WithColor::note() << "instruction: " << InstructionStr
-                                    << '\n';
-                })) {
-          // Default case.
-          WithColor::error() << toString(std::move(NewE));
-        }
+  if (NumThreads == 1) {
+    for (size_t I = 0, E = RegionsToAnalyze.size(); I != E; ++I) {
+      TOF->os() << Headers[I];
+      if (!analyzeRegion(*RegionsToAnalyze[I], *STI, *MCII, *MRI, MCIA.get(),
+                         *IP, PO, TOF->os()))
         return 1;
-      }
-
-      LoweredSequence.emplace_back(std::move(Inst.get()));
     }
+    TOF->keep();
+    return 0;
+  }
 
-    mca::SourceMgr S(LoweredSequence, PrintInstructionTables ? 1 : Iterations);
-
-    if (PrintInstructionTables) {
-      //  Create a pipeline, stages, and a printer.
-      auto P = llvm::make_unique<mca::Pipeline>();
-      P->appendStage(llvm::make_unique<mca::EntryStage>(S));
-      P->appendStage(llvm::make_unique<mca::InstructionTables>(SM));
-      mca::PipelinePrinter Printer(*P);
-
-      // Create the views for this pipeline, execute, and emit a report.
-      if (PrintInstructionInfoView) {
-        Printer.addView(llvm::make_unique<mca::InstructionInfoView>(
-            *STI, *MCII, Insts, *IP));
-      }
-      Printer.addView(
-          llvm::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
-
-      if (!runPipeline(*P))
-        return 1;
-
-      Printer.printReport(TOF->os());
-      continue;
-    }
-
-    // Create a basic pipeline simulating an out-of-order backend.
-    auto P = MCA.createDefaultPipeline(PO, IB, S);
-    mca::PipelinePrinter Printer(*P);
-
-    if (PrintSummaryView)
-      Printer.addView(llvm::make_unique<mca::SummaryView>(
-          SM, Insts, DispatchWidth));
-
-    if (EnableBottleneckAnalysis)
-      Printer.addView(llvm::make_unique<mca::BottleneckAnalysis>(SM));
-
-    if (PrintInstructionInfoView)
-      Printer.addView(
-          llvm::make_unique<mca::InstructionInfoView>(*STI, *MCII, Insts, *IP));
-
-    if (PrintDispatchStats)
-      Printer.addView(llvm::make_unique<mca::DispatchStatistics>());
-
-    if (PrintSchedulerStats)
-      Printer.addView(llvm::make_unique<mca::SchedulerStatistics>(*STI));
-
-    if (PrintRetireStats)
-      Printer.addView(llvm::make_unique<mca::RetireControlUnitStatistics>(SM));
-
-    if (PrintRegisterFileStats)
-      Printer.addView(llvm::make_unique<mca::RegisterFileStatistics>(*STI));
-
-    if (PrintResourcePressureView)
-      Printer.addView(
-          llvm::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
-
-    if (PrintTimelineView) {
-      unsigned TimelineIterations =
-          TimelineMaxIterations ? TimelineMaxIterations : 10;
-      Printer.addView(llvm::make_unique<mca::TimelineView>(
-          *STI, *IP, Insts, std::min(TimelineIterations, S.getNumIterations()),
-          TimelineMaxCycles));
-    }
+  // Analyze the regions in parallel and print their reports in order, up to
+  // the first region that fails as the serial analysis would.
+  std::vector<std::string> Reports(RegionsToAnalyze.size());
+  std::vector<char> Succeeded(RegionsToAnalyze.size());
+  {
+    ThreadPool Pool(NumThreads ? NumThreads
+                               : llvm::heavyweight_hardware_concurrency());
+    for (size_t I = 0, E = RegionsToAnalyze.size(); I != E; ++I)
+      Pool.async([&, I] {
+        std::unique_ptr<MCInstPrinter> RegionIP(TheTarget->createMCInstPrinter(
+            Triple(TripleName), AssemblerDialect, *MAI, *MCII, *MRI));
+        raw_string_ostream ReportOS(Reports[I]);
+        Succeeded[I] = analyzeRegion(*RegionsToAnalyze[I], *STI, *MCII, *MRI,
+                                     MCIA.get(), *RegionIP, PO, ReportOS);
+      });
+    Pool.wait();
+  }
 
-    if (!runPipeline(*P))
+  for (size_t I = 0, E = RegionsToAnalyze.size(); I != E; ++I) {
+    TOF->os() << Headers[I];
+    if (!Succeeded[I])
       return 1;
-
-    Printer.printReport(TOF->os());
-
-    // Clear the InstrBuilder internal state in preparation for another round.
-    IB.clear();
+    TOF->os() << Reports[I];
   }
 
   TOF->keep();
@@ -842,7 +842,10 @@ public:
                        std::function<bool(const SectionBase &)> ToRemove);
   Error removeSymbols(function_ref<bool(const Symbol &)> ToRemove);
   template <class T, class... Ts> T &addSection(Ts &&... Args) {
-    auto Sec = llvm::make_unique<T>(std::forward<Ts>(Args)...);
+    return static_cast<T &>(
+        addSection(llvm::make_unique<T>(std::forward<Ts>(Args)...)));
+  }
+  SectionBase &addSection(std::unique_ptr<SectionBase> Sec) {
     auto Ptr = Sec.get();
     Sections.emplace_back(std::move(Sec));
     Ptr->Index = Sections.size();
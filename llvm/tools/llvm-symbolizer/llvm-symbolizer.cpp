@@ -138,6 +138,12 @@ static cl::opt<uint64_t>
     ClAdjustVMA("adjust-vma", cl::init(0), cl::value_desc("offset"),
                 cl::desc("Add specified offset to object file addresses"));
 
+static cl::opt<uint64_t>
+    ClCacheSize("cache-size", cl::init(0), cl::value_desc("bytes"),
+                cl::desc("Size of the loaded binaries past which they are "
+                         "unloaded before loading another one (0 = no "
+                         "limit)"));
+
 static cl::list<std::string> ClInputAddresses(cl::Positional,
                                               cl::desc("<input addresses>..."),
                                               cl::ZeroOrMore);
@@ -272,6 +278,7 @@ int main(int argc, char **argv) {
   LLVMSymbolizer::Options Opts(ClPrintFunctions, ClUseSymbolTable, ClDemangle,
                                ClUseRelativeAddress, ClDefaultArch,
                                ClFallbackDebugPath);
+  Opts.MaxCacheSize = ClCacheSize;
 
   for (const auto &hint : ClDsymHint) {
     if (sys::path::extension(hint) == ".dSYM") {
@@ -272,6 +272,12 @@ static cl::opt<std::string>
                            "names match the given regular expression"),
                   cl::value_desc("regex"));
 
+static cl::opt<std::string>
+    RemarksFormat("pass-remarks-format",
+                  cl::desc("The format used for serializing remarks "
+                           "(yaml or binary)"),
+                  cl::value_desc("format"), cl::init("yaml"));
+
 cl::opt<PGOKind>
     PGOKindFlag("pgo-kind", cl::init(NoPGO), cl::Hidden,
                 cl::desc("The kind of profile guided optimization"),
@@ -556,6 +562,12 @@ int main(int argc, char **argv) {
 
   std::unique_ptr<ToolOutputFile> OptRemarkFile;
   if (RemarksFilename != "") {
+    Expected<remarks::Format> Format = remarks::parseFormat(RemarksFormat);
+    if (!Format) {
+      errs() << Format.takeError() << '\n';
+      return 1;
+    }
+
     std::error_code EC;
     OptRemarkFile =
         llvm::make_unique<ToolOutputFile>(RemarksFilename, EC, sys::fs::F_None);
@@ -564,7 +576,7 @@ int main(int argc, char **argv) {
       return 1;
     }
     Context.setRemarkStreamer(llvm::make_unique<RemarkStreamer>(
-        RemarksFilename, OptRemarkFile->os()));
+        RemarksFilename, OptRemarkFile->os(), *Format));
 
     if (!RemarksPasses.empty())
       if (Error E = Context.getRemarkStreamer()->setFilter(RemarksPasses)) {
@@ -0,0 +1,161 @@
+//===-- sycl-split: split SYCL device code per kernel ---------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This program splits a linked SYCL device module into modules holding a
+// group of kernels each, together with everything they reference. For every
+// module it writes <prefix>_<N>.bc and <prefix>_<N>.sym, the latter listing
+// the names of the kernels of the module, one per line. The symbol files are
+// passed to clang-offload-wrapper with -entries, so the SYCL runtime builds
+// only the module holding the launched kernel.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include <algorithm>
+
+using namespace llvm;
+
+static cl::opt<std::string>
+    InputFilename(cl::Positional, cl::desc("<input bitcode file>"),
+                  cl::init("-"), cl::value_desc("filename"));
+
+static cl::opt<std::string> OutputPrefix("o", cl::Required,
+                                         cl::desc("Output files prefix"),
+                                         cl::value_desc("prefix"));
+
+static cl::opt<unsigned>
+    KernelsPerModule("kernels-per-module", cl::init(1),
+                     cl::desc("Maximum number of kernels in an output module, "
+                              "0 puts all of them in a single module"));
+
+// Adds to Deps the global values V depends on, looking through constants.
+static void collectDeps(const Value *V, SetVector<const GlobalValue *> &Deps,
+                        SmallPtrSetImpl<const Constant *> &Visited) {
+  const auto *C = dyn_cast<Constant>(V);
+  if (!C || !Visited.insert(C).second)
+    return;
+  if (const auto *GV = dyn_cast<GlobalValue>(C)) {
+    Deps.insert(GV);
+    return;
+  }
+  for (const Value *Op : C->operands())
+    collectDeps(Op, Deps, Visited);
+}
+
+// Returns the kernels of Kernels and all the global values they reference
+// directly or indirectly.
+static SetVector<const GlobalValue *>
+getClosure(ArrayRef<const Function *> Kernels) {
+  SetVector<const GlobalValue *> Res(Kernels.begin(), Kernels.end());
+  SmallPtrSet<const Constant *, 32> Visited;
+  // Res grows while it is being walked, so index it rather than iterate it.
+  for (size_t I = 0; I < Res.size(); ++I) {
+    const GlobalValue *GV = Res[I];
+    if (const auto *F = dyn_cast<Function>(GV)) {
+      for (const BasicBlock &BB : *F)
+        for (const Instruction &Inst : BB)
+          for (const Value *Op : Inst.operands())
+            collectDeps(Op, Res, Visited);
+    } else if (const auto *Var = dyn_cast<GlobalVariable>(GV)) {
+      if (Var->hasInitializer())
+        collectDeps(Var->getInitializer(), Res, Visited);
+    } else if (const auto *A = dyn_cast<GlobalIndirectSymbol>(GV)) {
+      collectDeps(A->getIndirectSymbol(), Res, Visited);
+    }
+  }
+  return Res;
+}
+
+static std::unique_ptr<ToolOutputFile> openOutput(const std::string &Name) {
+  std::error_code EC;
+  std::unique_ptr<ToolOutputFile> Out(
+      new ToolOutputFile(Name, EC, sys::fs::F_None));
+  if (EC) {
+    errs() << "error: can't open " << Name << ": " << EC.message() << '\n';
+    exit(1);
+  }
+  return Out;
+}
+
+// Writes the module with the definitions of Kernels and their dependencies
+// only, and the list of the kernel names.
+static void writeSplit(const Module &M, ArrayRef<const Function *> Kernels,
+                       unsigned Id) {
+  SetVector<const GlobalValue *> Closure = getClosure(Kernels);
+  ValueToValueMapTy VMap;
+  std::unique_ptr<Module> Split =
+      CloneModule(M, VMap, [&](const GlobalValue *GV) {
+        return Closure.count(GV) != 0;
+      });
+
+  // The global values not in the closure are left as unused declarations.
+  SmallVector<GlobalValue *, 16> Unused;
+  for (GlobalValue &GV : Split->global_values())
+    if (GV.isDeclaration() && GV.use_empty())
+      Unused.push_back(&GV);
+  for (GlobalValue *GV : Unused)
+    GV->eraseFromParent();
+
+  if (verifyModule(*Split, &errs())) {
+    errs() << "error: split module " << Id << " is broken\n";
+    exit(1);
+  }
+  const std::string Prefix = OutputPrefix + "_" + utostr(Id);
+  std::unique_ptr<ToolOutputFile> BC = openOutput(Prefix + ".bc");
+  WriteBitcodeToFile(*Split, BC->os());
+  BC->keep();
+
+  std::unique_ptr<ToolOutputFile> Sym = openOutput(Prefix + ".sym");
+  for (const Function *K : Kernels)
+    Sym->os() << K->getName() << '\n';
+  Sym->keep();
+}
+
+int main(int argc, char **argv) {
+  LLVMContext Context;
+  SMDiagnostic Err;
+  cl::ParseCommandLineOptions(argc, argv, "SYCL device code splitter\n");
+
+  std::unique_ptr<Module> M = parseIRFile(InputFilename, Err, Context);
+  if (!M) {
+    Err.print(argv[0], errs());
+    return 1;
+  }
+
+  SmallVector<const Function *, 16> Kernels;
+  for (const Function &F : *M)
+    if (!F.isDeclaration() && F.getCallingConv() == CallingConv::SPIR_KERNEL)
+      Kernels.push_back(&F);
+  if (Kernels.empty()) {
+    errs() << "error: no kernels in " << InputFilename << '\n';
+    return 1;
+  }
+
+  const size_t GroupSize = KernelsPerModule ? KernelsPerModule.getValue()
+                                            : Kernels.size();
+  unsigned Id = 0;
+  for (size_t I = 0; I < Kernels.size(); I += GroupSize) {
+    ArrayRef<const Function *> Group = makeArrayRef(Kernels).slice(
+        I, std::min(GroupSize, Kernels.size() - I));
+    writeSplit(*M, Group, Id++);
+  }
+  return 0;
+}
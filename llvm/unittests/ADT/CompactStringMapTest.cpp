@@ -0,0 +1,127 @@
+//===- llvm/unittest/ADT/CompactStringMapTest.cpp - CompactStringMap tests ===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/CompactStringMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <string>
+using namespace llvm;
+
+namespace {
+
+TEST(CompactStringMapTest, EmptyMap) {
+  CompactStringMap<int> Map;
+  EXPECT_TRUE(Map.empty());
+  EXPECT_TRUE(Map.begin() == Map.end());
+  EXPECT_EQ(0u, Map.count("key"));
+  EXPECT_TRUE(Map.find("key") == Map.end());
+  EXPECT_FALSE(Map.erase("key"));
+}
+
+TEST(CompactStringMapTest, InsertFindErase) {
+  CompactStringMap<int> Map;
+  EXPECT_TRUE(Map.insert(std::make_pair("a", 1)).second);
+  EXPECT_FALSE(Map.insert(std::make_pair("a", 2)).second);
+  EXPECT_TRUE(Map.try_emplace("b", 3).second);
+  Map[""] = 4;
+  EXPECT_EQ(3u, Map.size());
+  EXPECT_EQ(1, Map.lookup("a"));
+  EXPECT_EQ(3, Map.lookup("b"));
+  EXPECT_EQ(4, Map.lookup(""));
+  EXPECT_EQ("b", Map.find("b")->getKey());
+
+  EXPECT_TRUE(Map.erase("a"));
+  EXPECT_FALSE(Map.erase("a"));
+  EXPECT_EQ(0u, Map.count("a"));
+  EXPECT_EQ(2u, Map.size());
+
+  Map.clear();
+  EXPECT_TRUE(Map.empty());
+  EXPECT_TRUE(Map.begin() == Map.end());
+  EXPECT_EQ(0u, Map.count("b"));
+}
+
+// Grow the table with many keys, erase half of them and reinsert them, the
+// map always holding the same keys as a std::map.
+TEST(CompactStringMapTest, ManyKeys) {
+  CompactStringMap<unsigned> Map;
+  std::map<std::string, unsigned> Expected;
+  const unsigned NumKeys = 5000;
+  for (unsigned I = 0; I != NumKeys; ++I) {
+    Map["key" + utostr(I)] = I;
+    Expected["key" + utostr(I)] = I;
+  }
+  for (unsigned I = 0; I < NumKeys; I += 2) {
+    EXPECT_TRUE(Map.erase("key" + utostr(I)));
+    Expected.erase("key" + utostr(I));
+  }
+  for (unsigned I = 0; I < NumKeys; I += 4) {
+    Map["key" + utostr(I)] = I + 1;
+    Expected["key" + utostr(I)] = I + 1;
+  }
+
+  EXPECT_EQ(Expected.size(), Map.size());
+  for (const auto &KV : Expected)
+    EXPECT_EQ(KV.second, Map.lookup(KV.first));
+  for (unsigned I = 2; I < NumKeys; I += 4)
+    EXPECT_EQ(0u, Map.count("key" + utostr(I)));
+
+  unsigned Count = 0;
+  for (const auto &E : Map) {
+    EXPECT_EQ(Expected[E.getKey()], E.getValue());
+    ++Count;
+  }
+  EXPECT_EQ(Expected.size(), Count);
+}
+
+// The entries don't move when the table grows.
+TEST(CompactStringMapTest, StableEntries) {
+  CompactStringMap<int> Map;
+  StringMapEntry<int> &First = *Map.try_emplace("first", 1).first;
+  for (int I = 0; I != 1000; ++I)
+    Map[utostr(I)] = I;
+  EXPECT_EQ(&First, &*Map.find("first"));
+  EXPECT_EQ(1, First.getValue());
+}
+
+TEST(CompactStringMapTest, CopyAndMove) {
+  CompactStringMap<int> Map;
+  for (int I = 0; I != 100; ++I)
+    Map[utostr(I)] = I;
+  Map.erase("7");
+
+  CompactStringMap<int> Copy(Map);
+  EXPECT_EQ(Map.size(), Copy.size());
+  for (int I = 0; I != 100; ++I)
+    EXPECT_EQ(Map.lookup(utostr(I)), Copy.lookup(utostr(I)));
+  EXPECT_NE(&*Map.find("1"), &*Copy.find("1"));
+
+  CompactStringMap<int> Moved(std::move(Copy));
+  EXPECT_TRUE(Copy.empty());
+  EXPECT_EQ(99u, Moved.size());
+  EXPECT_EQ(42, Moved.lookup("42"));
+
+  Copy = Moved;
+  EXPECT_EQ(99u, Copy.size());
+  EXPECT_EQ(0u, Copy.count("7"));
+}
+
+// The initial size holds as many keys without growing.
+TEST(CompactStringMapTest, InitialSize) {
+  for (unsigned Size : {1u, 14u, 15u, 100u, 1000u}) {
+    CompactStringMap<int> Map(Size);
+    unsigned NumBuckets = Map.getNumBuckets();
+    for (unsigned I = 0; I != Size; ++I)
+      Map[utostr(I)] = I;
+    EXPECT_EQ(NumBuckets, Map.getNumBuckets()) << "Size " << Size;
+  }
+}
+
+} // end anonymous namespace
@@ -14,10 +14,12 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -190,4 +192,59 @@ TEST(BitReaderTest, MaterializeFunctionsForBlockAddrInFunctionAfter) {
   EXPECT_FALSE(verifyModule(*M, &dbgs()));
 }
 
+// Tests that the function blocks decoded in parallel ahead of their parsing
+// give the same functions, whatever the order they are materialized in.
+TEST(BitReaderTest, MaterializeFunctionsDecodedInParallel) {
+  const char *Assembly = "@table = constant i8* blockaddress(@func, %bb)\n"
+                         "@g = global i32 0\n"
+                         "define i32 @f(i32 %x) {\n"
+                         "entry:\n"
+                         "  %a = add i32 %x, 42\n"
+                         "  %c = icmp sgt i32 %a, 100\n"
+                         "  br i1 %c, label %t, label %e\n"
+                         "t:\n"
+                         "  store i32 %a, i32* @g\n"
+                         "  ret i32 %a\n"
+                         "e:\n"
+                         "  %m = call i32 @h(i32 %a)\n"
+                         "  ret i32 %m\n"
+                         "}\n"
+                         "define void @func() {\n"
+                         "  unreachable\n"
+                         "bb:\n"
+                         "  unreachable\n"
+                         "}\n"
+                         "define i32 @h(i32 %y) {\n"
+                         "  %z = mul i32 %y, 3\n"
+                         "  %w = call i32 @f(i32 %z)\n"
+                         "  ret i32 %w\n"
+                         "}\n";
+  auto print = [](const Module &M) {
+    std::string S;
+    raw_string_ostream OS(S);
+    M.print(OS, nullptr);
+    return OS.str();
+  };
+
+  SmallString<1024> Mem;
+  LLVMContext Context;
+  std::unique_ptr<Module> M = getLazyModuleFromAssembly(Context, Mem, Assembly);
+  ASSERT_FALSE(M->materializeAll());
+  std::string Serial = print(*M);
+
+  auto &Opt = *static_cast<cl::opt<bool> *>(
+      cl::getRegisteredOptions()["bitcode-parallel-function-decode"]);
+  Opt = true;
+  Expected<std::unique_ptr<Module>> ModuleOrErr =
+      getLazyBitcodeModule(MemoryBufferRef(Mem.str(), "test"), Context);
+  ASSERT_TRUE(bool(ModuleOrErr));
+  std::unique_ptr<Module> Lazy = std::move(*ModuleOrErr);
+  EXPECT_FALSE(Lazy->getFunction("h")->materialize());
+  EXPECT_TRUE(Lazy->getFunction("f")->empty());
+  ASSERT_FALSE(Lazy->materializeAll());
+  Opt = false;
+  EXPECT_FALSE(verifyModule(*Lazy, &dbgs()));
+  EXPECT_EQ(Serial, print(*Lazy));
+}
+
 } // end namespace
@@ -0,0 +1,80 @@
+//===--- OnDiskObjectCacheTest.cpp - Unit tests for the on-disk cache -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/OnDiskObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class OnDiskObjectCacheTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(
+        sys::fs::createUniqueDirectory("orc-object-cache", CacheDir));
+  }
+
+  void TearDown() override { sys::fs::remove_directories(CacheDir); }
+
+  std::unique_ptr<OnDiskObjectCache> createCache(StringRef CPU) {
+    JITTargetMachineBuilder JTMB(Triple("x86_64-unknown-linux-gnu"));
+    JTMB.setCPU(CPU);
+    auto Cache = OnDiskObjectCache::Create(CacheDir, JTMB);
+    EXPECT_THAT_EXPECTED(Cache, Succeeded());
+    return Cache ? std::move(*Cache) : nullptr;
+  }
+
+  std::unique_ptr<Module> createModule(StringRef FunctionName) {
+    auto M = llvm::make_unique<Module>("M", Context);
+    Function::Create(FunctionType::get(Type::getVoidTy(Context), false),
+                     GlobalValue::ExternalLinkage, FunctionName, M.get());
+    return M;
+  }
+
+  LLVMContext Context;
+  SmallString<128> CacheDir;
+};
+
+TEST_F(OnDiskObjectCacheTest, ObjectsAreSharedBetweenCaches) {
+  auto Cache = createCache("generic");
+  auto M = createModule("foo");
+  EXPECT_EQ(Cache->getObject(M.get()), nullptr);
+  Cache->notifyObjectCompiled(M.get(), MemoryBufferRef("object", "foo"));
+
+  // Another cache on the same directory, as in another process, finds the
+  // object of an identical module.
+  auto OtherCache = createCache("generic");
+  auto OtherM = createModule("foo");
+  auto Obj = OtherCache->getObject(OtherM.get());
+  ASSERT_NE(Obj, nullptr);
+  EXPECT_EQ(Obj->getBuffer(), "object");
+}
+
+TEST_F(OnDiskObjectCacheTest, KeyCoversModuleAndTarget) {
+  auto Cache = createCache("generic");
+  auto M = createModule("foo");
+  EXPECT_EQ(Cache->getObject(M.get()), nullptr);
+  Cache->notifyObjectCompiled(M.get(), MemoryBufferRef("object", "foo"));
+
+  auto OtherM = createModule("bar");
+  EXPECT_EQ(Cache->getObject(OtherM.get()), nullptr);
+
+  auto OtherCPUCache = createCache("haswell");
+  EXPECT_EQ(OtherCPUCache->getObject(M.get()), nullptr);
+}
+
+} // namespace
@@ -0,0 +1,104 @@
+//===- llvm/unittest/IR/FunctionHashTest.cpp - Function hash tests --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/IR/FunctionHash.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+using namespace llvm;
+
+namespace {
+
+const char *Body = "define i32 @f(i32 %x) !dbg !10 {\n"
+                   "entry:\n"
+                   "  %a = add nsw i32 %x, 42, !dbg !12\n"
+                   "  %c = icmp sgt i32 %a, 100\n"
+                   "  br i1 %c, label %t, label %e\n"
+                   "t:\n"
+                   "  %p = phi i32 [ %a, %entry ], [ %r, %t ]\n"
+                   "  %l = load i32, i32* @g, align 4\n"
+                   "  %r = call i32 @h(i32 %l)\n"
+                   "  br label %t\n"
+                   "e:\n"
+                   "  ret i32 %a\n"
+                   "}\n";
+
+const char *Declarations =
+    "@g = constant i32 LINE\n"
+    "declare i32 @h(i32) ATTRS\n"
+    "!llvm.module.flags = !{!0}\n"
+    "!llvm.dbg.cu = !{!1}\n"
+    "!0 = !{i32 2, !\"Debug Info Version\", i32 3}\n"
+    "!1 = distinct !DICompileUnit(language: DW_LANG_C99, file: !2, "
+    "emissionKind: FullDebug)\n"
+    "!2 = !DIFile(filename: \"t.c\", directory: \"/\")\n"
+    "!10 = distinct !DISubprogram(name: \"f\", scope: !2, file: !2, line: 1, "
+    "unit: !1, spFlags: DISPFlagDefinition)\n"
+    "!12 = !DILocation(line: LINE, column: 3, scope: !10)\n";
+
+/// Parse @f along with \p Before, with \p Line as the initializer of @g and
+/// the line of the add and \p Attrs as the attributes of @h.
+std::unique_ptr<Module> parse(LLVMContext &C, StringRef Before,
+                              StringRef Line = "2", StringRef Attrs = "") {
+  std::string Decls = Declarations;
+  for (size_t Pos; (Pos = Decls.find("LINE")) != std::string::npos;)
+    Decls.replace(Pos, 4, Line);
+  Decls.replace(Decls.find("ATTRS"), 5, Attrs);
+  std::string Assembly = (Twine(Before) + Body + Decls).str();
+
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(Assembly, Err, C);
+  if (!M)
+    Err.print("FunctionHashTest", errs());
+  return M;
+}
+
+TEST(FunctionHashTest, SameFunction) {
+  LLVMContext C1, C2;
+  std::unique_ptr<Module> M1 = parse(C1, "");
+  std::unique_ptr<Module> M2 =
+      parse(C2, "define void @other() {\n"
+                "  %x = add i32 1, 2\n"
+                "  ret void\n"
+                "}\n");
+  ASSERT_TRUE(M1 && M2);
+  FunctionHash H = computeFunctionHash(*M1->getFunction("f"));
+  EXPECT_EQ(H, computeFunctionHash(*M2->getFunction("f")));
+  EXPECT_NE(H, computeFunctionHash(*M2->getFunction("other")));
+
+  // The names of the local values don't matter.
+  M1->getFunction("f")->arg_begin()->setName("y");
+  EXPECT_EQ(H, computeFunctionHash(*M1->getFunction("f")));
+}
+
+TEST(FunctionHashTest, ChangedFunction) {
+  LLVMContext C;
+  std::unique_ptr<Module> M = parse(C, "");
+  ASSERT_TRUE(M);
+  FunctionHash H = computeFunctionHash(*M->getFunction("f"));
+
+  // The debug location of the add and the initializer of @g.
+  std::unique_ptr<Module> Line = parse(C, "", "3");
+  ASSERT_TRUE(Line);
+  EXPECT_NE(H, computeFunctionHash(*Line->getFunction("f")));
+
+  // The attributes of the callee.
+  std::unique_ptr<Module> Callee = parse(C, "", "2", "readnone");
+  ASSERT_TRUE(Callee);
+  EXPECT_NE(H, computeFunctionHash(*Callee->getFunction("f")));
+
+  // The flags of an instruction.
+  Function *F = M->getFunction("f");
+  F->getEntryBlock().front().setHasNoSignedWrap(false);
+  EXPECT_NE(H, computeFunctionHash(*F));
+}
+
+} // end anonymous namespace
@@ -228,7 +228,8 @@ struct CoverageMappingTest : ::testing::TestWithParam<std::pair<bool, bool>> {
     ProfileReader = std::move(ReaderOrErr.get());
   }
 
-  Expected<std::unique_ptr<CoverageMapping>> readOutputFunctions() {
+  Expected<std::unique_ptr<CoverageMapping>>
+  readOutputFunctions(ArrayRef<StringRef> SourceFiles) {
     std::vector<std::unique_ptr<CoverageMappingReader>> CoverageReaders;
     if (UseMultipleReaders) {
       for (const auto &OF : OutputFunctions) {
@@ -241,13 +242,14 @@ struct CoverageMappingTest : ::testing::TestWithParam<std::pair<bool, bool>> {
       CoverageReaders.push_back(
           make_unique<CoverageMappingReaderMock>(Funcs));
     }
-    return CoverageMapping::load(CoverageReaders, *ProfileReader);
+    return CoverageMapping::load(CoverageReaders, *ProfileReader, SourceFiles);
   }
 
-  Error loadCoverageMapping(bool EmitFilenames = true) {
+  Error loadCoverageMapping(bool EmitFilenames = true,
+                            ArrayRef<StringRef> SourceFiles = None) {
     readProfCounts();
     writeAndReadCoverageRegions(EmitFilenames);
-    auto CoverageOrErr = readOutputFunctions();
+    auto CoverageOrErr = readOutputFunctions(SourceFiles);
     if (!CoverageOrErr)
       return CoverageOrErr.takeError();
     LoadedCoverage = std::move(CoverageOrErr.get());
@@ -888,6 +890,34 @@ TEST_P(CoverageMappingTest, skip_duplicate_function_record) {
   ASSERT_EQ(3U, NumFuncs);
 }
 
+TEST_P(CoverageMappingTest, load_functions_of_source_files) {
+  ProfileWriter.addRecord({"func1", 0x1234, {1}}, Err);
+  ProfileWriter.addRecord({"func2", 0x1234, {1}}, Err);
+  ProfileWriter.addRecord({"func3", 0x1234, {1, 1}}, Err);
+
+  startFunction("func1", 0x1234);
+  addCMR(Counter::getCounter(0), "file1", 1, 1, 9, 9);
+
+  // This function has no code in file1, it should be skipped.
+  startFunction("func2", 0x1234);
+  addCMR(Counter::getCounter(0), "file2", 1, 1, 9, 9);
+
+  // This function expands code of file1, it should be loaded.
+  startFunction("func3", 0x1234);
+  addCMR(Counter::getCounter(0), "file3", 1, 1, 9, 9);
+  addCMR(Counter::getCounter(1), "file1", 6, 6, 7, 7);
+  addExpansionCMR("file3", "file1", 3, 3, 4, 4);
+
+  EXPECT_THAT_ERROR(loadCoverageMapping(true, {"file1"}), Succeeded());
+
+  std::vector<std::string> Names;
+  for (const auto &Func : LoadedCoverage->getCoveredFunctions())
+    Names.push_back(Func.Name);
+  ASSERT_EQ(2U, Names.size());
+  ASSERT_EQ("func1", Names[0]);
+  ASSERT_EQ("func3", Names[1]);
+}
+
 // FIXME: Use ::testing::Combine() when llvm updates its copy of googletest.
 INSTANTIATE_TEST_CASE_P(ParameterizedCovMapTest, CoverageMappingTest,
                         ::testing::Values(std::pair<bool, bool>({false, false}),
@@ -0,0 +1,130 @@
+//===- unittest/Remarks/BinaryRemarksTest.cpp - Binary remark tests -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Remarks/BinaryRemarkSerializer.h"
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkParser.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+static std::string serialize(ArrayRef<remarks::Remark> Remarks) {
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  remarks::BinarySerializer Serializer(OS);
+  for (const remarks::Remark &R : Remarks)
+    Serializer.emit(R);
+  return OS.str();
+}
+
+static bool parseExpectError(StringRef Buf, const char *Error) {
+  remarks::Parser Parser(Buf);
+  Expected<const remarks::Remark *> Remark = Parser.getNext();
+  EXPECT_FALSE(Remark); // Expect an error here.
+
+  std::string ErrorStr;
+  raw_string_ostream Stream(ErrorStr);
+  handleAllErrors(Remark.takeError(),
+                  [&](const ErrorInfoBase &EIB) { EIB.log(Stream); });
+  return StringRef(Stream.str()).contains(Error);
+}
+
+TEST(BinaryRemarks, RoundTrip) {
+  remarks::Argument Args[] = {
+      {"Callee", "bar", None},
+      {"String", " will not be inlined into ", None},
+      {"Caller", "foo", remarks::RemarkLocation{"file.c", 2, 0}},
+  };
+  remarks::Remark First;
+  First.RemarkType = remarks::Type::Missed;
+  First.PassName = "inline";
+  First.RemarkName = "NoDefinition";
+  First.FunctionName = "foo";
+  First.Loc = remarks::RemarkLocation{"file.c", 3, 12};
+  First.Hotness = 4;
+  First.Args = Args;
+
+  remarks::Remark Second;
+  Second.RemarkType = remarks::Type::Passed;
+  Second.PassName = "inline";
+  Second.RemarkName = "Inlined";
+  Second.FunctionName = "foo";
+
+  remarks::Remark Input[] = {First, Second};
+  std::string Buf = serialize(Input);
+  EXPECT_TRUE(StringRef(Buf).startswith(remarks::BinaryMagic));
+
+  remarks::Parser Parser(Buf);
+  Expected<const remarks::Remark *> RemarkOrErr = Parser.getNext();
+  EXPECT_FALSE(errorToBool(RemarkOrErr.takeError()));
+  ASSERT_TRUE(*RemarkOrErr != nullptr);
+
+  const remarks::Remark &R = **RemarkOrErr;
+  EXPECT_EQ(R.RemarkType, remarks::Type::Missed);
+  EXPECT_EQ(R.PassName, "inline");
+  EXPECT_EQ(R.RemarkName, "NoDefinition");
+  EXPECT_EQ(R.FunctionName, "foo");
+  ASSERT_TRUE(R.Loc);
+  EXPECT_EQ(R.Loc->SourceFilePath, "file.c");
+  EXPECT_EQ(R.Loc->SourceLine, 3U);
+  EXPECT_EQ(R.Loc->SourceColumn, 12U);
+  ASSERT_TRUE(R.Hotness);
+  EXPECT_EQ(*R.Hotness, 4U);
+  ASSERT_EQ(R.Args.size(), 3U);
+  EXPECT_EQ(R.Args[0].Key, "Callee");
+  EXPECT_EQ(R.Args[0].Val, "bar");
+  EXPECT_FALSE(R.Args[0].Loc);
+  EXPECT_EQ(R.Args[1].Val, " will not be inlined into ");
+  EXPECT_EQ(R.Args[2].Key, "Caller");
+  ASSERT_TRUE(R.Args[2].Loc);
+  EXPECT_EQ(R.Args[2].Loc->SourceFilePath, "file.c");
+  EXPECT_EQ(R.Args[2].Loc->SourceLine, 2U);
+  EXPECT_EQ(R.Args[2].Loc->SourceColumn, 0U);
+
+  // The second remark reuses the strings of the first one.
+  RemarkOrErr = Parser.getNext();
+  EXPECT_FALSE(errorToBool(RemarkOrErr.takeError()));
+  ASSERT_TRUE(*RemarkOrErr != nullptr);
+  EXPECT_EQ((*RemarkOrErr)->RemarkType, remarks::Type::Passed);
+  EXPECT_EQ((*RemarkOrErr)->PassName, "inline");
+  EXPECT_EQ((*RemarkOrErr)->RemarkName, "Inlined");
+  EXPECT_EQ((*RemarkOrErr)->FunctionName, "foo");
+  EXPECT_FALSE((*RemarkOrErr)->Loc);
+  EXPECT_FALSE((*RemarkOrErr)->Hotness);
+  EXPECT_TRUE((*RemarkOrErr)->Args.empty());
+
+  RemarkOrErr = Parser.getNext();
+  EXPECT_FALSE(errorToBool(RemarkOrErr.takeError()));
+  EXPECT_EQ(*RemarkOrErr, nullptr);
+}
+
+TEST(BinaryRemarks, Empty) {
+  remarks::Parser Parser(serialize({}));
+  Expected<const remarks::Remark *> RemarkOrErr = Parser.getNext();
+  EXPECT_FALSE(errorToBool(RemarkOrErr.takeError()));
+  EXPECT_EQ(*RemarkOrErr, nullptr);
+}
+
+TEST(BinaryRemarks, Truncated) {
+  remarks::Remark R;
+  R.RemarkType = remarks::Type::Missed;
+  R.PassName = "inline";
+  R.RemarkName = "NoDefinition";
+  R.FunctionName = "foo";
+  // Cut the last string, "foo", in the middle.
+  std::string Buf = serialize(R);
+  EXPECT_TRUE(parseExpectError(StringRef(Buf).drop_back(3),
+                               "string past the end of buffer"));
+}
+
+TEST(BinaryRemarks, BadVersion) {
+  std::string Buf = remarks::BinaryMagic.str();
+  Buf.push_back(1);
+  EXPECT_TRUE(parseExpectError(Buf, "unsupported version"));
+}
@@ -184,4 +184,24 @@ TEST(AllocatorTest, TestBigAlignment) {
   EXPECT_GT(MockSlabAllocator::GetLastSlabSize(), 4096u);
 }
 
+// Test the slabs of mapped memory, small and custom sized, with and without
+// huge pages.
+TEST(AllocatorTest, TestMappedSlabs) {
+  for (bool HugePages : {true, false}) {
+    MappedBumpPtrAllocator Alloc{MappedMemoryAllocator(HugePages)};
+    char *Small = static_cast<char *>(Alloc.Allocate(100, 16));
+    EXPECT_EQ(0u, uintptr_t(Small) & 15);
+    memset(Small, 1, 100);
+    char *Big = static_cast<char *>(Alloc.Allocate(5 << 20, 64));
+    memset(Big, 2, 5 << 20);
+    EXPECT_EQ(2U, Alloc.GetNumSlabs());
+    EXPECT_EQ(1, Small[99]);
+    EXPECT_EQ(2, Big[(5 << 20) - 1]);
+
+    Alloc.Reset();
+    EXPECT_EQ(1U, Alloc.GetNumSlabs());
+    EXPECT_EQ(Small, Alloc.Allocate(100, 16));
+  }
+}
+
 }  // anonymous namespace
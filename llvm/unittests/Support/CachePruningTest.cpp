@@ -8,6 +8,9 @@
 
 #include "llvm/Support/CachePruning.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -94,3 +97,44 @@ TEST(CachePruningPolicyParser, Errors) {
   EXPECT_EQ("Unknown key: 'foo'",
             toString(parseCachePruningPolicy("foo=bar").takeError()));
 }
+
+TEST(CachePruning, ShardedCache) {
+  SmallString<128> CacheDir;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("cache-pruning", CacheDir));
+
+  auto CreateFile = [&](StringRef Dir, StringRef Name) {
+    SmallString<128> Path(CacheDir);
+    sys::path::append(Path, Dir);
+    ASSERT_FALSE(sys::fs::create_directories(Path));
+    sys::path::append(Path, Name);
+    std::error_code EC;
+    raw_fd_ostream OS(Path, EC, sys::fs::F_None);
+    ASSERT_FALSE(EC);
+    OS << "entry";
+  };
+  auto Exists = [&](StringRef Dir, StringRef Name) {
+    SmallString<128> Path(CacheDir);
+    sys::path::append(Path, Dir, Name);
+    return sys::fs::exists(Path);
+  };
+
+  CreateFile("", "llvmcache-ab01");
+  CreateFile("ab", "llvmcache-ab02");
+  CreateFile("ab", "llvmcache-ab03");
+  CreateFile("ab", "other");
+  CreateFile("abc", "llvmcache-abc0");
+
+  CachePruningPolicy Policy;
+  Policy.MaxSizePercentageOfAvailableSpace = 0;
+  Policy.MaxSizeFiles = 1;
+  EXPECT_TRUE(pruneCache(CacheDir, Policy));
+
+  // One of the entries of the cache and its shard is kept, the files which
+  // are not entries are left alone.
+  EXPECT_EQ(1, Exists("", "llvmcache-ab01") + Exists("ab", "llvmcache-ab02") +
+                   Exists("ab", "llvmcache-ab03"));
+  EXPECT_TRUE(Exists("ab", "other"));
+  EXPECT_TRUE(Exists("abc", "llvmcache-abc0"));
+
+  ASSERT_FALSE(sys::fs::remove_directories(CacheDir));
+}
@@ -14,7 +14,11 @@
 #include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <random>
+#include <thread>
 
 uint32_t array[1024 * 1024];
 
@@ -49,4 +53,47 @@ TEST(Parallel, parallel_for) {
   ASSERT_EQ(range[2049], 1u);
 }
 
+TEST(Parallel, nested_parallel_for) {
+  // The tasks of the nested loops run in parallel too, the workers waiting
+  // for a nested loop must not deadlock.
+  std::atomic<uint32_t> count{0};
+  for_each_n(parallel::par, 0, 64, [&count](size_t I) {
+    for_each_n(parallel::par, 0, 64, [&count](size_t J) {
+      for_each_n(parallel::par, 0, 16, [&count](size_t K) { ++count; });
+    });
+  });
+  ASSERT_EQ(count, 64u * 64 * 16);
+}
+
+#if GTEST_HAS_DEATH_TEST
+// Runs nested loops with ThreadCount workers and exits with 0 if they ran all
+// the iterations. The executor reads ThreadCount once, so every call runs in a
+// process of its own.
+static void runNestedLoops(unsigned ThreadCount) {
+  parallel::ThreadCount = ThreadCount;
+  std::atomic<uint32_t> Count{0};
+  for_each_n(parallel::par, 0, 8, [&Count](size_t I) {
+    // The calling thread runs the last outer iteration. Delay it, so that it
+    // adds its tasks on top of the ones of the loops nested by the workers.
+    if (I == 7)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    for_each_n(parallel::par, 0, 64, [&Count](size_t J) {
+      std::this_thread::sleep_for(std::chrono::microseconds(500));
+      ++Count;
+    });
+  });
+  std::exit(Count == 8u * 64 ? 0 : 1);
+}
+
+TEST(ParallelDeathTest, nested_parallel_for_one_thread) {
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  EXPECT_EXIT(runNestedLoops(1), ::testing::ExitedWithCode(0), "");
+}
+
+TEST(ParallelDeathTest, nested_parallel_for_two_threads) {
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  EXPECT_EXIT(runNestedLoops(2), ::testing::ExitedWithCode(0), "");
+}
+#endif
+
 #endif
@@ -243,4 +243,33 @@ TEST_F(SpecialCaseListTest, EscapedSymbols) {
   EXPECT_FALSE(SCL->inSection("", "src", "hello\\\\world"));
 }
 
+TEST_F(SpecialCaseListTest, Globs) {
+  std::unique_ptr<SpecialCaseList> SCL = makeSpecialCaseList("fun:foo*\n"
+                                                             "fun:foobar*\n"
+                                                             "fun:*baz\n"
+                                                             "fun:a*b*c\n"
+                                                             "src:*\n");
+  EXPECT_EQ(1u, SCL->inSectionBlame("", "fun", "foo"));
+  EXPECT_EQ(1u, SCL->inSectionBlame("", "fun", "foobarbaz"));
+  EXPECT_EQ(3u, SCL->inSectionBlame("", "fun", "barbaz"));
+  EXPECT_EQ(4u, SCL->inSectionBlame("", "fun", "abxbc"));
+  EXPECT_EQ(4u, SCL->inSectionBlame("", "fun", "abc"));
+  EXPECT_EQ(0u, SCL->inSectionBlame("", "fun", "fo"));
+  EXPECT_EQ(0u, SCL->inSectionBlame("", "fun", "bazz"));
+  EXPECT_EQ(0u, SCL->inSectionBlame("", "fun", "acb"));
+  EXPECT_EQ(5u, SCL->inSectionBlame("", "src", ""));
+  EXPECT_EQ(5u, SCL->inSectionBlame("", "src", "any/file.c"));
+}
+
+TEST_F(SpecialCaseListTest, ComplexRegexWithGlobs) {
+  // The regex can't be indexed, it must not hide the indexed globs.
+  std::unique_ptr<SpecialCaseList> SCL = makeSpecialCaseList("fun:(ab|cd)ef\n"
+                                                             "fun:*hello*\n");
+  EXPECT_TRUE(SCL->inSection("", "fun", "abef"));
+  EXPECT_TRUE(SCL->inSection("", "fun", "cdef"));
+  EXPECT_TRUE(SCL->inSection("", "fun", "say_hello_world"));
+  EXPECT_FALSE(SCL->inSection("", "fun", "adef"));
+  EXPECT_FALSE(SCL->inSection("", "fun", "hell"));
+}
+
 }
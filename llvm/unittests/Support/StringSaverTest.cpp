@@ -0,0 +1,69 @@
+//===- llvm/unittest/Support/StringSaverTest.cpp - StringSaver tests ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/StringSaver.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(ConcurrentUniqueStringSaverTest, Unique) {
+  ConcurrentUniqueStringSaver Saver;
+  std::string Str = "hello";
+  StringRef Hello = Saver.save(Str);
+  EXPECT_EQ("hello", Hello);
+  EXPECT_NE(Str.data(), Hello.data());
+  EXPECT_EQ('\0', *Hello.end());
+  EXPECT_EQ(Hello.data(), Saver.save(StringRef("hello")).data());
+  EXPECT_NE(Hello.data(), Saver.save("hello!").data());
+  EXPECT_EQ("", Saver.save(""));
+  EXPECT_EQ(Saver.save("").data(), Saver.save(StringRef()).data());
+
+  // The saved strings stay where they are while many more are saved.
+  std::vector<StringRef> Saved;
+  for (unsigned I = 0; I != 10000; ++I)
+    Saved.push_back(Saver.save(utostr(I)));
+  for (unsigned I = 0; I != 10000; ++I) {
+    EXPECT_EQ(utostr(I), Saved[I]);
+    EXPECT_EQ(Saved[I].data(), Saver.save(utostr(I)).data());
+  }
+  EXPECT_EQ(Hello.data(), Saver.save("hello").data());
+}
+
+#if LLVM_ENABLE_THREADS
+// The threads see the same StringRef for the same string whichever saves it
+// first.
+TEST(ConcurrentUniqueStringSaverTest, Threads) {
+  ConcurrentUniqueStringSaver Saver;
+  const unsigned NumThreads = 4, NumStrings = 5000;
+  std::vector<std::vector<StringRef>> Saved(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      for (unsigned I = 0; I != NumStrings; ++I)
+        Saved[T].push_back(Saver.save("str" + utostr((I * (T + 1)) %
+                                                     NumStrings)));
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (unsigned T = 0; T != NumThreads; ++T)
+    for (unsigned I = 0; I != NumStrings; ++I) {
+      StringRef S = Saved[T][I];
+      EXPECT_EQ("str" + utostr((I * (T + 1)) % NumStrings), S);
+      EXPECT_EQ(S.data(), Saver.save(S.str()).data());
+    }
+}
+#endif
+
+} // end anonymous namespace
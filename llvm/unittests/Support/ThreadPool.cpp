@@ -163,3 +163,72 @@ TEST_F(ThreadPoolTest, PoolDestruction) {
   }
   ASSERT_EQ(5, checked_in);
 }
+
+TEST_F(ThreadPoolTest, Priorities) {
+  CHECK_UNSUPPORTED();
+  // Test that the queued tasks start by decreasing priority, the tasks of the
+  // same priority in submission order.
+  std::mutex OrderLock;
+  std::vector<int> Order;
+  auto Record = [&](int I) {
+    std::unique_lock<std::mutex> LockGuard(OrderLock);
+    Order.push_back(I);
+  };
+  ThreadPool Pool(1);
+  Pool.async([this] { waitForMainThread(); });
+  Pool.asyncWithPriority(1, Record, 1);
+  Pool.async(Record, 0);
+  Pool.asyncWithPriority(5, Record, 5);
+  Pool.asyncWithPriority(5, Record, 6);
+  setMainThreadReady();
+  Pool.wait();
+  ASSERT_EQ((std::vector<int>{5, 6, 1, 0}), Order);
+}
+
+TEST_F(ThreadPoolTest, Cancel) {
+  CHECK_UNSUPPORTED();
+  std::atomic_int checked_in{0};
+  ThreadPool Pool(1);
+  Pool.async([this] { waitForMainThread(); });
+  ThreadPoolTaskGroup Group(Pool);
+  std::shared_future<void> Cancelled = Group.async([&] { ++checked_in; });
+  Group.async([&] { ++checked_in; });
+  Pool.async([&] { checked_in += 10; });
+  ASSERT_EQ(2u, Group.cancel());
+  setMainThreadReady();
+  Pool.wait();
+  ASSERT_EQ(10, checked_in);
+  ASSERT_THROW(Cancelled.get(), std::future_error);
+}
+
+TEST_F(ThreadPoolTest, GroupWait) {
+  CHECK_UNSUPPORTED();
+  // Test that waiting for a group doesn't wait for the other tasks.
+  ThreadPool Pool(2);
+  Pool.async([this] { waitForMainThread(); });
+  std::atomic_int checked_in{0};
+  ThreadPoolTaskGroup Group(Pool);
+  Group.async([&] { ++checked_in; });
+  Group.wait();
+  ASSERT_EQ(1, checked_in);
+  setMainThreadReady();
+}
+
+TEST_F(ThreadPoolTest, NestedGroups) {
+  CHECK_UNSUPPORTED();
+  // Test that the tasks waiting for the groups they spawn don't deadlock, even
+  // with more waiting tasks than threads.
+  std::atomic_int checked_in{0};
+  ThreadPool Pool(2);
+  ThreadPoolTaskGroup Outer(Pool);
+  for (size_t i = 0; i < 8; ++i) {
+    Outer.async([&] {
+      ThreadPoolTaskGroup Inner(Pool);
+      for (size_t j = 0; j < 8; ++j)
+        Inner.async([&] { ++checked_in; });
+      Inner.wait();
+    });
+  }
+  Outer.wait();
+  ASSERT_EQ(64, checked_in);
+}
@@ -0,0 +1,64 @@
+//===- llvm/unittest/Support/TreeHashTest.cpp - Tree hash tests -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/TreeHash.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/xxhash.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+std::vector<uint8_t> getData(size_t Size) {
+  std::vector<uint8_t> Data(Size);
+  for (size_t I = 0; I != Size; ++I)
+    Data[I] = I * 7 + (I >> 9);
+  return Data;
+}
+
+// The tree hash is the hash of the hashes of the chunks, whether these are
+// hashed in parallel or not.
+TEST(TreeHashTest, XXHash64) {
+  const size_t ChunkSize = 1024 * 1024;
+  std::vector<uint8_t> Data = getData(3 * ChunkSize + 1000);
+  ArrayRef<uint8_t> Ref(Data);
+  std::vector<uint8_t> Hashes;
+  for (size_t Offset = 0; Offset < Data.size(); Offset += ChunkSize) {
+    uint8_t Hash[8];
+    support::endian::write64le(
+        Hash, xxHash64(Ref.slice(
+                  Offset, std::min(ChunkSize, Data.size() - Offset))));
+    Hashes.insert(Hashes.end(), Hash, Hash + 8);
+  }
+  EXPECT_EQ(32u, Hashes.size());
+  EXPECT_EQ(xxHash64(Hashes), treeHashXXHash64(Data));
+  EXPECT_EQ(xxHash64(Hashes), treeHashXXHash64(Data, /*Parallel=*/false));
+}
+
+TEST(TreeHashTest, SHA1) {
+  std::vector<uint8_t> Data = getData(2 * 1024 * 1024);
+  std::array<uint8_t, 20> Hash = treeHashSHA1(Data);
+  EXPECT_EQ(Hash, treeHashSHA1(Data, /*Parallel=*/false));
+  EXPECT_NE(Hash, SHA1::hash(Data));
+  Data.back() ^= 1;
+  EXPECT_NE(Hash, treeHashSHA1(Data));
+}
+
+TEST(TreeHashTest, SmallData) {
+  std::vector<uint8_t> Data = getData(100);
+  uint8_t Hash[8];
+  support::endian::write64le(Hash, xxHash64(Data));
+  EXPECT_EQ(xxHash64(Hash), treeHashXXHash64(Data));
+  EXPECT_EQ(xxHash64(ArrayRef<uint8_t>()),
+            treeHashXXHash64(ArrayRef<uint8_t>()));
+}
+
+} // end anonymous namespace
@@ -865,6 +865,70 @@ TEST(ProxyFileSystemTest, Basic) {
   EXPECT_FALSE(Local);
 }
 
+namespace {
+// Counts the queries which reach the underlying file system.
+class CountingFileSystem : public vfs::ProxyFileSystem {
+public:
+  explicit CountingFileSystem(IntrusiveRefCntPtr<vfs::FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  ErrorOr<vfs::Status> status(const Twine &Path) override {
+    ++StatusCalls;
+    return ProxyFileSystem::status(Path);
+  }
+  ErrorOr<std::unique_ptr<vfs::File>>
+  openFileForRead(const Twine &Path) override {
+    ++OpenCalls;
+    return ProxyFileSystem::openFileForRead(Path);
+  }
+
+  int StatusCalls = 0;
+  int OpenCalls = 0;
+};
+} // namespace
+
+TEST(CachingFileSystemTest, Basic) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Base(
+      new vfs::InMemoryFileSystem());
+  Base->addFile("/a", 0, MemoryBuffer::getMemBuffer("test"));
+  IntrusiveRefCntPtr<CountingFileSystem> Counter(new CountingFileSystem(Base));
+  vfs::CachingFileSystem CFS(Counter);
+  ASSERT_FALSE(CFS.setCurrentWorkingDirectory("/"));
+
+  auto Stat = CFS.status("/a");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ("/a", Stat->getName());
+  Stat = CFS.status("a");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ("a", Stat->getName());
+  EXPECT_EQ(4u, Stat->getSize());
+  EXPECT_EQ(1, Counter->StatusCalls);
+
+  // Missing files are cached too, and not opened again.
+  EXPECT_TRUE(CFS.status("/b").getError());
+  EXPECT_TRUE(CFS.status("/b").getError());
+  EXPECT_TRUE(CFS.openFileForRead("/b").getError());
+  EXPECT_EQ(2, Counter->StatusCalls);
+  EXPECT_EQ(0, Counter->OpenCalls);
+
+  auto File = CFS.openFileForRead("/a");
+  ASSERT_FALSE(File.getError());
+  EXPECT_EQ("test", (*(*File)->getBuffer("ignored"))->getBuffer());
+  EXPECT_EQ(1, Counter->OpenCalls);
+
+  // The cache is stale until invalidated.
+  Base->addFile("/b", 0, MemoryBuffer::getMemBuffer("new"));
+  EXPECT_TRUE(CFS.status("/b").getError());
+  CFS.invalidate("/b");
+  EXPECT_FALSE(CFS.status("/b").getError());
+  EXPECT_EQ(3, Counter->StatusCalls);
+
+  CFS.invalidateAll();
+  EXPECT_FALSE(CFS.status("/a").getError());
+  EXPECT_FALSE(CFS.status("/b").getError());
+  EXPECT_EQ(5, Counter->StatusCalls);
+}
+
 class InMemoryFileSystemTest : public ::testing::Test {
 protected:
   llvm::vfs::InMemoryFileSystem FS;
@@ -455,8 +455,34 @@ static void FactorNodes(std::unique_ptr<Matcher> &InputMatcherPtr) {
     return;
   }
   
+  // Otherwise, turn each run of neighboring opcode checks into a SwitchOpcode
+  // of its own.  The opcodes of a run are distinct, so at most one of its
+  // options can match and the run can be tried as a single option of the
+  // scope.
+  SmallVector<Matcher*, 32> ScopeOptions;
+  for (unsigned i = 0, e = NewOptionsToMatch.size(); i != e;) {
+    unsigned RunEnd = i;
+    while (RunEnd != e && isa<CheckOpcodeMatcher>(NewOptionsToMatch[RunEnd]))
+      ++RunEnd;
+    if (RunEnd - i < 2) {
+      ScopeOptions.push_back(NewOptionsToMatch[i++]);
+      continue;
+    }
+
+    StringSet<> Opcodes;
+    SmallVector<std::pair<const SDNodeInfo*, Matcher*>, 8> Cases;
+    for (; i != RunEnd; ++i) {
+      CheckOpcodeMatcher *COM = cast<CheckOpcodeMatcher>(NewOptionsToMatch[i]);
+      assert(Opcodes.insert(COM->getOpcode().getEnumName()).second &&
+             "Duplicate opcodes not factored?");
+      Cases.push_back(std::make_pair(&COM->getOpcode(), COM->takeNext()));
+      delete COM;
+    }
+    ScopeOptions.push_back(new SwitchOpcodeMatcher(Cases));
+  }
 
   // Reassemble the Scope node with the adjusted children.
+  NewOptionsToMatch = std::move(ScopeOptions);
   Scope->setNumChildren(NewOptionsToMatch.size());
   for (unsigned i = 0, e = NewOptionsToMatch.size(); i != e; ++i)
     Scope->resetChild(i, NewOptionsToMatch[i]);
@@ -15,6 +15,7 @@
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/TableGen/Error.h"
 #include "llvm/TableGen/Main.h"
 #include "llvm/TableGen/Record.h"
 #include "llvm/TableGen/SetTheory.h"
@@ -137,7 +138,14 @@ cl::opt<bool, true>
                    cl::desc("Time regions of tablegens execution"),
                    cl::location(TimeRegions));
 
-bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
+cl::list<std::string>
+    ExtraOutputs("extra-output",
+                 cl::desc("Also run the backend <action> over the parsed "
+                          "records and write its output to <filename>, "
+                          "which is only rewritten if it changed"),
+                 cl::value_desc("action=filename"), cl::CommaSeparated);
+
+void runAction(ActionType Action, raw_ostream &OS, RecordKeeper &Records) {
   switch (Action) {
   case PrintRecords:
     OS << Records;           // No argument, dump all contents
@@ -248,6 +256,30 @@ bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
     EmitExegesis(Records, OS);
     break;
   }
+}
+
+bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
+  runAction(Action, OS, Records);
+
+  // The extra outputs reuse the records parsed for the main action.
+  for (StringRef Output : ExtraOutputs) {
+    StringRef ActionName, Filename;
+    std::tie(ActionName, Filename) = Output.split('=');
+    ActionType ExtraAction;
+    if (Filename.empty() ||
+        Action.getParser().parse(Action, ActionName, "", ExtraAction)) {
+      errs() << "invalid -extra-output '" << Output
+             << "', expected <action>=<filename>\n";
+      return true;
+    }
+
+    std::string OutString;
+    raw_string_ostream Out(OutString);
+    runAction(ExtraAction, Out, Records);
+    if (ErrorsPrinted > 0 ||
+        writeFileIfChanged("llvm-tblgen", Filename, Out.str()))
+      return true;
+  }
 
   return false;
 }
@@ -109,6 +109,14 @@ struct __tgt_target_table {
       *EntriesEnd; // End of the table with all the entries (non inclusive)
 };
 
+/// This struct records the non-blocking operations issued to a device by one
+/// target region. Queue is the plugin's queue that they are issued to, for
+/// instance a CUstream for CUDA, or NULL before the first of them; the plugin
+/// releases it when it waits for them.
+struct __tgt_async_info {
+  void *Queue;
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
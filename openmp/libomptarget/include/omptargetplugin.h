@@ -84,6 +84,38 @@ int32_t __tgt_rtl_run_target_team_region(int32_t ID, void *Entry, void **Args,
                                          int32_t NumTeams, int32_t ThreadLimit,
                                          uint64_t loop_tripcount);
 
+// The functions below are optional: a plugin provides either all of them or
+// none. The *_async ones only issue the operation to the queue of AsyncInfo,
+// which they set up if its Queue is NULL, after the operations already issued
+// to it. The host memory they read or write must stay valid until
+// __tgt_rtl_synchronize returns. In case of success, they return zero.
+// Otherwise, they return an error code.
+
+// Asynchronous version of __tgt_rtl_data_submit.
+int32_t __tgt_rtl_data_submit_async(int32_t ID, void *TargetPtr, void *HostPtr,
+                                    int64_t Size, __tgt_async_info *AsyncInfo);
+
+// Asynchronous version of __tgt_rtl_data_retrieve.
+int32_t __tgt_rtl_data_retrieve_async(int32_t ID, void *HostPtr,
+                                      void *TargetPtr, int64_t Size,
+                                      __tgt_async_info *AsyncInfo);
+
+// Asynchronous version of __tgt_rtl_run_target_region.
+int32_t __tgt_rtl_run_target_region_async(int32_t ID, void *Entry, void **Args,
+                                          ptrdiff_t *Offsets, int32_t NumArgs,
+                                          __tgt_async_info *AsyncInfo);
+
+// Asynchronous version of __tgt_rtl_run_target_team_region.
+int32_t __tgt_rtl_run_target_team_region_async(
+    int32_t ID, void *Entry, void **Args, ptrdiff_t *Offsets, int32_t NumArgs,
+    int32_t NumTeams, int32_t ThreadLimit, uint64_t loop_tripcount,
+    __tgt_async_info *AsyncInfo);
+
+// Wait for the operations issued to the queue of AsyncInfo to complete, and
+// release the queue, setting Queue to NULL. Nothing needs to be done if Queue
+// is already NULL. Return zero if all of them succeeded, or an error code.
+int32_t __tgt_rtl_synchronize(int32_t ID, __tgt_async_info *AsyncInfo);
+
 #ifdef __cplusplus
 }
 #endif
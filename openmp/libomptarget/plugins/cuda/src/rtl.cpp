@@ -14,6 +14,7 @@
 #include <cstddef>
 #include <cuda.h>
 #include <list>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -111,6 +112,12 @@ public:
   int EnvNumTeams;
   int EnvTeamLimit;
 
+  // Streams of each device that no target region uses. A target region takes
+  // one for its asynchronous operations, and gives it back when it waits for
+  // them.
+  std::vector<std::vector<CUstream>> FreeStreams;
+  std::mutex StreamsMtx;
+
   //static int EnvNumThreads;
   static const int HardTeamLimit = 1<<16; // 64k
   static const int HardThreadLimit = 1024;
@@ -204,6 +211,7 @@ public:
 
     FuncGblEntries.resize(NumberOfDevices);
     Contexts.resize(NumberOfDevices);
+    FreeStreams.resize(NumberOfDevices);
     ThreadsPerBlock.resize(NumberOfDevices);
     BlocksPerGrid.resize(NumberOfDevices);
     WarpSize.resize(NumberOfDevices);
@@ -230,6 +238,20 @@ public:
   }
 
   ~RTLDeviceInfoTy() {
+    // Destroy streams
+    for (size_t i = 0; i < FreeStreams.size(); ++i) {
+      if (FreeStreams[i].empty() ||
+          cuCtxSetCurrent(Contexts[i]) != CUDA_SUCCESS)
+        continue;
+      for (CUstream stream : FreeStreams[i]) {
+        CUresult err = cuStreamDestroy(stream);
+        if (err != CUDA_SUCCESS) {
+          DP("Error when destroying CUDA stream\n");
+          CUDA_ERR_STRING(err);
+        }
+      }
+    }
+
     // Close modules
     for (auto &module : Modules)
       if (module) {
@@ -254,6 +276,36 @@ public:
 
 static RTLDeviceInfoTy DeviceInfo;
 
+// Return the stream that the operations of async_info are issued to: a free
+// stream of the device, or a new one, for the first of them. The context of the
+// device must be current.
+static CUstream getStream(int32_t device_id, __tgt_async_info *async_info) {
+  if (!async_info->Queue) {
+    CUstream stream = nullptr;
+    {
+      std::lock_guard<std::mutex> Lock(DeviceInfo.StreamsMtx);
+      std::vector<CUstream> &Streams = DeviceInfo.FreeStreams[device_id];
+      if (!Streams.empty()) {
+        stream = Streams.back();
+        Streams.pop_back();
+      }
+    }
+    if (!stream) {
+      // The streams do not wait for the work of the default stream, nor the
+      // other way around, so that target regions of different host threads
+      // overlap.
+      CUresult err = cuStreamCreate(&stream, CU_STREAM_NON_BLOCKING);
+      if (err != CUDA_SUCCESS) {
+        DP("Error when creating CUDA stream\n");
+        CUDA_ERR_STRING(err);
+        return nullptr;
+      }
+    }
+    async_info->Queue = stream;
+  }
+  return (CUstream)async_info->Queue;
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -567,8 +619,8 @@ void *__tgt_rtl_data_alloc(int32_t device_id, int64_t size, void *hst_ptr) {
   return vptr;
 }
 
-int32_t __tgt_rtl_data_submit(int32_t device_id, void *tgt_ptr, void *hst_ptr,
-    int64_t size) {
+int32_t __tgt_rtl_data_submit_async(int32_t device_id, void *tgt_ptr,
+    void *hst_ptr, int64_t size, __tgt_async_info *async_info) {
   // Set the context we are using.
   CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
   if (err != CUDA_SUCCESS) {
@@ -577,7 +629,11 @@ int32_t __tgt_rtl_data_submit(int32_t device_id, void *tgt_ptr, void *hst_ptr,
     return OFFLOAD_FAIL;
   }
 
-  err = cuMemcpyHtoD((CUdeviceptr)tgt_ptr, hst_ptr, size);
+  CUstream stream = getStream(device_id, async_info);
+  if (!stream)
+    return OFFLOAD_FAIL;
+
+  err = cuMemcpyHtoDAsync((CUdeviceptr)tgt_ptr, hst_ptr, size, stream);
   if (err != CUDA_SUCCESS) {
     DP("Error when copying data from host to device. Pointers: host = " DPxMOD
        ", device = " DPxMOD ", size = %" PRId64 "\n", DPxPTR(hst_ptr),
@@ -588,8 +644,17 @@ int32_t __tgt_rtl_data_submit(int32_t device_id, void *tgt_ptr, void *hst_ptr,
   return OFFLOAD_SUCCESS;
 }
 
-int32_t __tgt_rtl_data_retrieve(int32_t device_id, void *hst_ptr, void *tgt_ptr,
+int32_t __tgt_rtl_data_submit(int32_t device_id, void *tgt_ptr, void *hst_ptr,
     int64_t size) {
+  __tgt_async_info async_info = {nullptr};
+  int32_t rc = __tgt_rtl_data_submit_async(device_id, tgt_ptr, hst_ptr, size,
+      &async_info);
+  int32_t sync_rc = __tgt_rtl_synchronize(device_id, &async_info);
+  return rc != OFFLOAD_SUCCESS ? rc : sync_rc;
+}
+
+int32_t __tgt_rtl_data_retrieve_async(int32_t device_id, void *hst_ptr,
+    void *tgt_ptr, int64_t size, __tgt_async_info *async_info) {
   // Set the context we are using.
   CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
   if (err != CUDA_SUCCESS) {
@@ -598,7 +663,11 @@ int32_t __tgt_rtl_data_retrieve(int32_t device_id, void *hst_ptr, void *tgt_ptr,
     return OFFLOAD_FAIL;
   }
 
-  err = cuMemcpyDtoH(hst_ptr, (CUdeviceptr)tgt_ptr, size);
+  CUstream stream = getStream(device_id, async_info);
+  if (!stream)
+    return OFFLOAD_FAIL;
+
+  err = cuMemcpyDtoHAsync(hst_ptr, (CUdeviceptr)tgt_ptr, size, stream);
   if (err != CUDA_SUCCESS) {
     DP("Error when copying data from device to host. Pointers: host = " DPxMOD
         ", device = " DPxMOD ", size = %" PRId64 "\n", DPxPTR(hst_ptr),
@@ -609,6 +678,15 @@ int32_t __tgt_rtl_data_retrieve(int32_t device_id, void *hst_ptr, void *tgt_ptr,
   return OFFLOAD_SUCCESS;
 }
 
+int32_t __tgt_rtl_data_retrieve(int32_t device_id, void *hst_ptr, void *tgt_ptr,
+    int64_t size) {
+  __tgt_async_info async_info = {nullptr};
+  int32_t rc = __tgt_rtl_data_retrieve_async(device_id, hst_ptr, tgt_ptr, size,
+      &async_info);
+  int32_t sync_rc = __tgt_rtl_synchronize(device_id, &async_info);
+  return rc != OFFLOAD_SUCCESS ? rc : sync_rc;
+}
+
 int32_t __tgt_rtl_data_delete(int32_t device_id, void *tgt_ptr) {
   // Set the context we are using.
   CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
@@ -627,9 +705,10 @@ int32_t __tgt_rtl_data_delete(int32_t device_id, void *tgt_ptr) {
   return OFFLOAD_SUCCESS;
 }
 
-int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
-    void **tgt_args, ptrdiff_t *tgt_offsets, int32_t arg_num, int32_t team_num,
-    int32_t thread_limit, uint64_t loop_tripcount) {
+int32_t __tgt_rtl_run_target_team_region_async(int32_t device_id,
+    void *tgt_entry_ptr, void **tgt_args, ptrdiff_t *tgt_offsets,
+    int32_t arg_num, int32_t team_num, int32_t thread_limit,
+    uint64_t loop_tripcount, __tgt_async_info *async_info) {
   // Set the context we are using.
   CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
   if (err != CUDA_SUCCESS) {
@@ -638,6 +717,10 @@ int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
     return OFFLOAD_FAIL;
   }
 
+  CUstream stream = getStream(device_id, async_info);
+  if (!stream)
+    return OFFLOAD_FAIL;
+
   // All args are references.
   std::vector<void *> args(arg_num);
   std::vector<void *> ptrs(arg_num);
@@ -725,8 +808,10 @@ int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
   DP("Launch kernel with %d blocks and %d threads\n", cudaBlocksPerGrid,
      cudaThreadsPerBlock);
 
+  // The arguments are copied at launch, so args and ptrs need not outlive it.
   err = cuLaunchKernel(KernelInfo->Func, cudaBlocksPerGrid, 1, 1,
-      cudaThreadsPerBlock, 1, 1, 0 /*bytes of shared memory*/, 0, &args[0], 0);
+      cudaThreadsPerBlock, 1, 1, 0 /*bytes of shared memory*/, stream,
+      &args[0], 0);
   if (err != CUDA_SUCCESS) {
     DP("Device kernel launch failed!\n");
     CUDA_ERR_STRING(err);
@@ -736,18 +821,37 @@ int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
   DP("Launch of entry point at " DPxMOD " successful!\n",
       DPxPTR(tgt_entry_ptr));
 
-  CUresult sync_err = cuCtxSynchronize();
-  if (sync_err != CUDA_SUCCESS) {
+  return OFFLOAD_SUCCESS;
+}
+
+int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
+    void **tgt_args, ptrdiff_t *tgt_offsets, int32_t arg_num, int32_t team_num,
+    int32_t thread_limit, uint64_t loop_tripcount) {
+  __tgt_async_info async_info = {nullptr};
+  int32_t rc = __tgt_rtl_run_target_team_region_async(device_id,
+      tgt_entry_ptr, tgt_args, tgt_offsets, arg_num, team_num, thread_limit,
+      loop_tripcount, &async_info);
+  int32_t sync_rc = __tgt_rtl_synchronize(device_id, &async_info);
+  if (rc != OFFLOAD_SUCCESS)
+    return rc;
+  if (sync_rc != OFFLOAD_SUCCESS) {
     DP("Kernel execution error at " DPxMOD "!\n", DPxPTR(tgt_entry_ptr));
-    CUDA_ERR_STRING(sync_err);
-    return OFFLOAD_FAIL;
-  } else {
-    DP("Kernel execution at " DPxMOD " successful!\n", DPxPTR(tgt_entry_ptr));
+    return sync_rc;
   }
-
+  DP("Kernel execution at " DPxMOD " successful!\n", DPxPTR(tgt_entry_ptr));
   return OFFLOAD_SUCCESS;
 }
 
+int32_t __tgt_rtl_run_target_region_async(int32_t device_id,
+    void *tgt_entry_ptr, void **tgt_args, ptrdiff_t *tgt_offsets,
+    int32_t arg_num, __tgt_async_info *async_info) {
+  // use one team and the default number of threads.
+  const int32_t team_num = 1;
+  const int32_t thread_limit = 0;
+  return __tgt_rtl_run_target_team_region_async(device_id, tgt_entry_ptr,
+      tgt_args, tgt_offsets, arg_num, team_num, thread_limit, 0, async_info);
+}
+
 int32_t __tgt_rtl_run_target_region(int32_t device_id, void *tgt_entry_ptr,
     void **tgt_args, ptrdiff_t *tgt_offsets, int32_t arg_num) {
   // use one team and the default number of threads.
@@ -757,6 +861,36 @@ int32_t __tgt_rtl_run_target_region(int32_t device_id, void *tgt_entry_ptr,
       tgt_offsets, arg_num, team_num, thread_limit, 0);
 }
 
+int32_t __tgt_rtl_synchronize(int32_t device_id, __tgt_async_info *async_info) {
+  if (!async_info->Queue)
+    return OFFLOAD_SUCCESS;
+
+  // Set the context we are using.
+  CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when setting CUDA context\n");
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+
+  CUstream stream = (CUstream)async_info->Queue;
+  err = cuStreamSynchronize(stream);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when synchronizing CUDA stream " DPxMOD "\n", DPxPTR(stream));
+    CUDA_ERR_STRING(err);
+  }
+
+  // Give the stream back even if an operation failed, as nothing is left to
+  // run on it.
+  {
+    std::lock_guard<std::mutex> Lock(DeviceInfo.StreamsMtx);
+    DeviceInfo.FreeStreams[device_id].push_back(stream);
+  }
+  async_info->Queue = nullptr;
+
+  return err == CUDA_SUCCESS ? OFFLOAD_SUCCESS : OFFLOAD_FAIL;
+}
+
 #ifdef __cplusplus
 }
 #endif
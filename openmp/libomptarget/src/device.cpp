@@ -16,6 +16,8 @@
 
 #include <cassert>
 #include <climits>
+#include <cstdlib>
+#include <iterator>
 #include <string>
 
 /// Map between Device ID (i.e. openmp device id) and its DeviceTy.
@@ -25,22 +27,23 @@ int DeviceTy::associatePtr(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size) {
   DataMapMtx.lock();
 
   // Check if entry exists
-  for (auto &HT : HostDataToTargetMap) {
-    if ((uintptr_t)HstPtrBegin == HT.HstPtrBegin) {
-      // Mapping already exists
-      bool isValid = HT.HstPtrBegin == (uintptr_t) HstPtrBegin &&
-                     HT.HstPtrEnd == (uintptr_t) HstPtrBegin + Size &&
-                     HT.TgtPtrBegin == (uintptr_t) TgtPtrBegin;
-      DataMapMtx.unlock();
-      if (isValid) {
-        DP("Attempt to re-associate the same device ptr+offset with the same "
-            "host ptr, nothing to do\n");
-        return OFFLOAD_SUCCESS;
-      } else {
-        DP("Not allowed to re-associate a different device ptr+offset with the "
-            "same host ptr\n");
-        return OFFLOAD_FAIL;
-      }
+  auto search =
+      HostDataToTargetMap.find(HostDataToTargetTy((uintptr_t)HstPtrBegin));
+  if (search != HostDataToTargetMap.end()) {
+    auto &HT = *search;
+    // Mapping already exists
+    bool isValid = HT.HstPtrBegin == (uintptr_t) HstPtrBegin &&
+                   HT.HstPtrEnd == (uintptr_t) HstPtrBegin + Size &&
+                   HT.TgtPtrBegin == (uintptr_t) TgtPtrBegin;
+    DataMapMtx.unlock();
+    if (isValid) {
+      DP("Attempt to re-associate the same device ptr+offset with the same "
+          "host ptr, nothing to do\n");
+      return OFFLOAD_SUCCESS;
+    } else {
+      DP("Not allowed to re-associate a different device ptr+offset with the "
+          "same host ptr\n");
+      return OFFLOAD_FAIL;
     }
   }
 
@@ -59,7 +62,7 @@ int DeviceTy::associatePtr(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size) {
       DPxMOD ", TgtBegin=" DPxMOD "\n", DPxPTR(newEntry.HstPtrBase),
       DPxPTR(newEntry.HstPtrBegin), DPxPTR(newEntry.HstPtrEnd),
       DPxPTR(newEntry.TgtPtrBegin));
-  HostDataToTargetMap.push_front(newEntry);
+  HostDataToTargetMap.insert(newEntry);
 
   DataMapMtx.unlock();
 
@@ -70,20 +73,18 @@ int DeviceTy::disassociatePtr(void *HstPtrBegin) {
   DataMapMtx.lock();
 
   // Check if entry exists
-  for (HostDataToTargetListTy::iterator ii = HostDataToTargetMap.begin();
-      ii != HostDataToTargetMap.end(); ++ii) {
-    if ((uintptr_t)HstPtrBegin == ii->HstPtrBegin) {
-      // Mapping exists
-      if (CONSIDERED_INF(ii->RefCount)) {
-        DP("Association found, removing it\n");
-        HostDataToTargetMap.erase(ii);
-        DataMapMtx.unlock();
-        return OFFLOAD_SUCCESS;
-      } else {
-        DP("Trying to disassociate a pointer which was not mapped via "
-            "omp_target_associate_ptr\n");
-        break;
-      }
+  auto search =
+      HostDataToTargetMap.find(HostDataToTargetTy((uintptr_t)HstPtrBegin));
+  if (search != HostDataToTargetMap.end()) {
+    // Mapping exists
+    if (CONSIDERED_INF(search->RefCount)) {
+      DP("Association found, removing it\n");
+      HostDataToTargetMap.erase(search);
+      DataMapMtx.unlock();
+      return OFFLOAD_SUCCESS;
+    } else {
+      DP("Trying to disassociate a pointer which was not mapped via "
+          "omp_target_associate_ptr\n");
     }
   }
 
@@ -98,15 +99,17 @@ long DeviceTy::getMapEntryRefCnt(void *HstPtrBegin) {
   uintptr_t hp = (uintptr_t)HstPtrBegin;
   long RefCnt = -1;
 
-  DataMapMtx.lock();
-  for (auto &HT : HostDataToTargetMap) {
+  DataMapMtx.lock_shared();
+  // The entry that can contain hp is the last one that begins at or before it.
+  auto upper = HostDataToTargetMap.upper_bound(HostDataToTargetTy(hp));
+  if (upper != HostDataToTargetMap.begin()) {
+    auto &HT = *std::prev(upper);
     if (hp >= HT.HstPtrBegin && hp < HT.HstPtrEnd) {
       DP("DeviceTy::getMapEntry: requested entry found\n");
       RefCnt = HT.RefCount;
-      break;
     }
   }
-  DataMapMtx.unlock();
+  DataMapMtx.unlock_shared();
 
   if (RefCnt < 0) {
     DP("DeviceTy::getMapEntry: requested entry not found\n");
@@ -121,8 +124,20 @@ LookupResult DeviceTy::lookupMapping(void *HstPtrBegin, int64_t Size) {
 
   DP("Looking up mapping(HstPtrBegin=" DPxMOD ", Size=%ld)...\n", DPxPTR(hp),
       Size);
-  for (lr.Entry = HostDataToTargetMap.begin();
-      lr.Entry != HostDataToTargetMap.end(); ++lr.Entry) {
+  // The entries do not overlap, so only the last one that begins at or before
+  // hp can contain it, and otherwise only the next one can overlap the range.
+  auto upper = HostDataToTargetMap.upper_bound(HostDataToTargetTy(hp));
+  lr.Entry = HostDataToTargetMap.end();
+  if (upper != HostDataToTargetMap.begin()) {
+    auto prev = std::prev(upper);
+    if (hp < prev->HstPtrEnd)
+      lr.Entry = prev;
+  }
+  if (lr.Entry == HostDataToTargetMap.end() &&
+      upper != HostDataToTargetMap.end() && (hp+Size) > upper->HstPtrBegin)
+    lr.Entry = upper;
+
+  if (lr.Entry != HostDataToTargetMap.end()) {
     auto &HT = *lr.Entry;
     // Is it contained?
     lr.Flags.IsContained = hp >= HT.HstPtrBegin && hp < HT.HstPtrEnd &&
@@ -131,11 +146,6 @@ LookupResult DeviceTy::lookupMapping(void *HstPtrBegin, int64_t Size) {
     lr.Flags.ExtendsBefore = hp < HT.HstPtrBegin && (hp+Size) > HT.HstPtrBegin;
     // Does it extend beyond the mapped region?
     lr.Flags.ExtendsAfter = hp < HT.HstPtrEnd && (hp+Size) > HT.HstPtrEnd;
-
-    if (lr.Flags.IsContained || lr.Flags.ExtendsBefore ||
-        lr.Flags.ExtendsAfter) {
-      break;
-    }
   }
 
   if (lr.Flags.ExtendsBefore) {
@@ -185,11 +195,11 @@ void *DeviceTy::getOrAllocTgtPtr(void *HstPtrBegin, void *HstPtrBase,
   } else if (Size) {
     // If it is not contained and Size > 0 we should create a new entry for it.
     IsNew = true;
-    uintptr_t tp = (uintptr_t)RTL->data_alloc(RTLDeviceID, Size, HstPtrBegin);
+    uintptr_t tp = (uintptr_t)data_alloc(Size, HstPtrBegin);
     DP("Creating new map entry: HstBase=" DPxMOD ", HstBegin=" DPxMOD ", "
         "HstEnd=" DPxMOD ", TgtBegin=" DPxMOD "\n", DPxPTR(HstPtrBase),
         DPxPTR(HstPtrBegin), DPxPTR((uintptr_t)HstPtrBegin + Size), DPxPTR(tp));
-    HostDataToTargetMap.push_front(HostDataToTargetTy((uintptr_t)HstPtrBase,
+    HostDataToTargetMap.insert(HostDataToTargetTy((uintptr_t)HstPtrBase,
         (uintptr_t)HstPtrBegin, (uintptr_t)HstPtrBegin + Size, tp));
     rc = (void *)tp;
   }
@@ -204,7 +214,11 @@ void *DeviceTy::getOrAllocTgtPtr(void *HstPtrBegin, void *HstPtrBase,
 void *DeviceTy::getTgtPtrBegin(void *HstPtrBegin, int64_t Size, bool &IsLast,
     bool UpdateRefCount) {
   void *rc = NULL;
-  DataMapMtx.lock();
+  // Only take the lock exclusively if the reference count may change.
+  if (UpdateRefCount)
+    DataMapMtx.lock();
+  else
+    DataMapMtx.lock_shared();
   LookupResult lr = lookupMapping(HstPtrBegin, Size);
 
   if (lr.Flags.IsContained || lr.Flags.ExtendsBefore || lr.Flags.ExtendsAfter) {
@@ -225,7 +239,10 @@ void *DeviceTy::getTgtPtrBegin(void *HstPtrBegin, int64_t Size, bool &IsLast,
     IsLast = false;
   }
 
-  DataMapMtx.unlock();
+  if (UpdateRefCount)
+    DataMapMtx.unlock();
+  else
+    DataMapMtx.unlock_shared();
   return rc;
 }
 
@@ -256,7 +273,7 @@ int DeviceTy::deallocTgtPtr(void *HstPtrBegin, int64_t Size, bool ForceDelete) {
       assert(HT.RefCount == 0 && "did not expect a negative ref count");
       DP("Deleting tgt data " DPxMOD " of size %ld\n",
           DPxPTR(HT.TgtPtrBegin), Size);
-      RTL->data_delete(RTLDeviceID, (void *)HT.TgtPtrBegin);
+      data_delete((void *)HT.TgtPtrBegin, HT.HstPtrEnd - HT.HstPtrBegin);
       DP("Removing%s mapping with HstPtrBegin=" DPxMOD ", TgtPtrBegin=" DPxMOD
           ", Size=%ld\n", (ForceDelete ? " (forced)" : ""),
           DPxPTR(HT.HstPtrBegin), DPxPTR(HT.TgtPtrBegin), Size);
@@ -305,21 +322,131 @@ __tgt_target_table *DeviceTy::load_binary(void *Img) {
   return rc;
 }
 
+/// Limits of the memory pools of the devices, from the environment.
+struct MemoryPoolSettingsTy {
+  // Bytes of free blocks a pool keeps (LIBOMPTARGET_MEMORY_POOL_SIZE); 0
+  // disables the pools.
+  int64_t Size;
+  // Largest allocation a pool serves
+  // (LIBOMPTARGET_MEMORY_POOL_MAX_BLOCK_SIZE).
+  int64_t MaxBlockSize;
+
+  MemoryPoolSettingsTy() : Size(256 << 20), MaxBlockSize(32 << 20) {
+    if (char *envStr = getenv("LIBOMPTARGET_MEMORY_POOL_SIZE"))
+      Size = strtoll(envStr, nullptr, 0);
+    if (char *envStr = getenv("LIBOMPTARGET_MEMORY_POOL_MAX_BLOCK_SIZE"))
+      MaxBlockSize = strtoll(envStr, nullptr, 0);
+    DP("Device memory pools keep up to %" PRId64 " bytes of blocks of up to %"
+        PRId64 " bytes\n", Size, MaxBlockSize);
+  }
+};
+
+static const MemoryPoolSettingsTy &getMemoryPoolSettings() {
+  static const MemoryPoolSettingsTy Settings;
+  return Settings;
+}
+
+static const int64_t MinPoolBlockSize = 256;
+
+/// Return the class of the pool blocks that Size bytes are allocated from, or
+/// -1 if the pools do not serve them.
+static int getPoolSizeClass(int64_t Size) {
+  const MemoryPoolSettingsTy &Settings = getMemoryPoolSettings();
+  if (Size <= 0 || Size > Settings.MaxBlockSize || Settings.Size <= 0)
+    return -1;
+  int Class = 0;
+  while ((MinPoolBlockSize << Class) < Size)
+    ++Class;
+  return Class;
+}
+
+// Allocate target memory, from the pool if it holds a block of the size class.
+void *DeviceTy::data_alloc(int64_t Size, void *HstPtrBegin) {
+  int Class = getPoolSizeClass(Size);
+  if (Class >= 0) {
+    int64_t BlockSize = MinPoolBlockSize << Class;
+    MemoryPool.Mtx.lock();
+    if ((size_t)Class < MemoryPool.FreeBlocks.size() &&
+        !MemoryPool.FreeBlocks[Class].empty()) {
+      void *TgtPtrBegin = MemoryPool.FreeBlocks[Class].back();
+      MemoryPool.FreeBlocks[Class].pop_back();
+      MemoryPool.FreeBytes -= BlockSize;
+      MemoryPool.Mtx.unlock();
+      DP("Reusing pooled block " DPxMOD " of %" PRId64 " bytes for %" PRId64
+          " bytes\n", DPxPTR(TgtPtrBegin), BlockSize, Size);
+      return TgtPtrBegin;
+    }
+    MemoryPool.Mtx.unlock();
+    Size = BlockSize;
+  }
+
+  void *TgtPtrBegin = RTL->data_alloc(RTLDeviceID, Size, HstPtrBegin);
+  // The blocks the pool keeps may be what the device is short of.
+  if (!TgtPtrBegin && releasePooledMemory())
+    TgtPtrBegin = RTL->data_alloc(RTLDeviceID, Size, HstPtrBegin);
+  return TgtPtrBegin;
+}
+
+// Free target memory, keeping it in the pool if that has room for it.
+int32_t DeviceTy::data_delete(void *TgtPtrBegin, int64_t Size) {
+  int Class = getPoolSizeClass(Size);
+  if (Class >= 0) {
+    int64_t BlockSize = MinPoolBlockSize << Class;
+    std::lock_guard<std::mutex> LG(MemoryPool.Mtx);
+    if (MemoryPool.FreeBytes + BlockSize <= getMemoryPoolSettings().Size) {
+      if (MemoryPool.FreeBlocks.size() <= (size_t)Class)
+        MemoryPool.FreeBlocks.resize(Class + 1);
+      MemoryPool.FreeBlocks[Class].push_back(TgtPtrBegin);
+      MemoryPool.FreeBytes += BlockSize;
+      return OFFLOAD_SUCCESS;
+    }
+  }
+  return RTL->data_delete(RTLDeviceID, TgtPtrBegin);
+}
+
+bool DeviceTy::releasePooledMemory() {
+  std::vector<std::vector<void *>> FreeBlocks;
+  MemoryPool.Mtx.lock();
+  FreeBlocks.swap(MemoryPool.FreeBlocks);
+  MemoryPool.FreeBytes = 0;
+  MemoryPool.Mtx.unlock();
+
+  bool Released = false;
+  for (auto &Blocks : FreeBlocks) {
+    for (void *TgtPtrBegin : Blocks) {
+      RTL->data_delete(RTLDeviceID, TgtPtrBegin);
+      Released = true;
+    }
+  }
+  if (Released)
+    DP("Released the pooled memory of device %d\n", DeviceID);
+  return Released;
+}
+
 // Submit data to device.
 int32_t DeviceTy::data_submit(void *TgtPtrBegin, void *HstPtrBegin,
-    int64_t Size) {
+    int64_t Size, __tgt_async_info *AsyncInfo) {
+  if (AsyncInfo && RTL->data_submit_async)
+    return RTL->data_submit_async(RTLDeviceID, TgtPtrBegin, HstPtrBegin, Size,
+        AsyncInfo);
   return RTL->data_submit(RTLDeviceID, TgtPtrBegin, HstPtrBegin, Size);
 }
 
 // Retrieve data from device.
 int32_t DeviceTy::data_retrieve(void *HstPtrBegin, void *TgtPtrBegin,
-    int64_t Size) {
+    int64_t Size, __tgt_async_info *AsyncInfo) {
+  if (AsyncInfo && RTL->data_retrieve_async)
+    return RTL->data_retrieve_async(RTLDeviceID, HstPtrBegin, TgtPtrBegin,
+        Size, AsyncInfo);
   return RTL->data_retrieve(RTLDeviceID, HstPtrBegin, TgtPtrBegin, Size);
 }
 
 // Run region on device
 int32_t DeviceTy::run_region(void *TgtEntryPtr, void **TgtVarsPtr,
-    ptrdiff_t *TgtOffsets, int32_t TgtVarsSize) {
+    ptrdiff_t *TgtOffsets, int32_t TgtVarsSize, __tgt_async_info *AsyncInfo) {
+  if (AsyncInfo && RTL->run_region_async)
+    return RTL->run_region_async(RTLDeviceID, TgtEntryPtr, TgtVarsPtr,
+        TgtOffsets, TgtVarsSize, AsyncInfo);
   return RTL->run_region(RTLDeviceID, TgtEntryPtr, TgtVarsPtr, TgtOffsets,
       TgtVarsSize);
 }
@@ -327,11 +454,23 @@ int32_t DeviceTy::run_region(void *TgtEntryPtr, void **TgtVarsPtr,
 // Run team region on device.
 int32_t DeviceTy::run_team_region(void *TgtEntryPtr, void **TgtVarsPtr,
     ptrdiff_t *TgtOffsets, int32_t TgtVarsSize, int32_t NumTeams,
-    int32_t ThreadLimit, uint64_t LoopTripCount) {
+    int32_t ThreadLimit, uint64_t LoopTripCount,
+    __tgt_async_info *AsyncInfo) {
+  if (AsyncInfo && RTL->run_team_region_async)
+    return RTL->run_team_region_async(RTLDeviceID, TgtEntryPtr, TgtVarsPtr,
+        TgtOffsets, TgtVarsSize, NumTeams, ThreadLimit, LoopTripCount,
+        AsyncInfo);
   return RTL->run_team_region(RTLDeviceID, TgtEntryPtr, TgtVarsPtr, TgtOffsets,
       TgtVarsSize, NumTeams, ThreadLimit, LoopTripCount);
 }
 
+// Wait for the operations issued with AsyncInfo.
+int32_t DeviceTy::synchronize(__tgt_async_info *AsyncInfo) {
+  if (!AsyncInfo->Queue || !RTL->synchronize)
+    return OFFLOAD_SUCCESS;
+  return RTL->synchronize(RTLDeviceID, AsyncInfo);
+}
+
 /// Check whether a device has an associated RTL and initialize it if it's not
 /// already initialized.
 bool device_is_ready(int device_num) {
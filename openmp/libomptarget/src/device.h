@@ -18,10 +18,14 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <set>
 #include <vector>
 
+#include <pthread.h>
+
 // Forward declarations.
 struct RTLInfoTy;
+struct __tgt_async_info;
 struct __tgt_bin_desc;
 struct __tgt_target_table;
 
@@ -36,11 +40,17 @@ struct HostDataToTargetTy {
 
   uintptr_t TgtPtrBegin; // target info.
 
-  long RefCount;
+  // The entries are ordered by HstPtrBegin only, so this one may change while
+  // the entry is in the map.
+  mutable long RefCount;
 
   HostDataToTargetTy()
       : HstPtrBase(0), HstPtrBegin(0), HstPtrEnd(0),
         TgtPtrBegin(0), RefCount(0) {}
+  // Key to look up the entries by their begin address.
+  explicit HostDataToTargetTy(uintptr_t B)
+      : HstPtrBase(B), HstPtrBegin(B), HstPtrEnd(B),
+        TgtPtrBegin(0), RefCount(0) {}
   HostDataToTargetTy(uintptr_t BP, uintptr_t B, uintptr_t E, uintptr_t TB)
       : HstPtrBase(BP), HstPtrBegin(B), HstPtrEnd(E),
         TgtPtrBegin(TB), RefCount(1) {}
@@ -48,9 +58,16 @@ struct HostDataToTargetTy {
       long RF)
       : HstPtrBase(BP), HstPtrBegin(B), HstPtrEnd(E),
         TgtPtrBegin(TB), RefCount(RF) {}
+
+  bool operator<(const HostDataToTargetTy &Other) const {
+    return HstPtrBegin < Other.HstPtrBegin;
+  }
 };
 
-typedef std::list<HostDataToTargetTy> HostDataToTargetListTy;
+/// The mapped host ranges do not overlap, so ordering them by their begin
+/// address lets a lookup find the only two that can contain or overlap a range
+/// in logarithmic time.
+typedef std::set<HostDataToTargetTy> HostDataToTargetListTy;
 
 struct LookupResult {
   struct {
@@ -80,6 +97,39 @@ struct PendingCtorDtorListsTy {
 typedef std::map<__tgt_bin_desc *, PendingCtorDtorListsTy>
     PendingCtorsDtorsPerLibrary;
 
+/// Reader/writer lock, so that the lookups that leave the map and the
+/// reference counts unchanged, which most target regions only do, run
+/// concurrently. lock() and unlock() take it exclusively, as for std::mutex.
+class RWMutexTy {
+  pthread_rwlock_t RWLock;
+
+public:
+  RWMutexTy() { pthread_rwlock_init(&RWLock, nullptr); }
+  ~RWMutexTy() { pthread_rwlock_destroy(&RWLock); }
+  RWMutexTy(const RWMutexTy &) = delete;
+  RWMutexTy &operator=(const RWMutexTy &) = delete;
+
+  void lock() { pthread_rwlock_wrlock(&RWLock); }
+  void unlock() { pthread_rwlock_unlock(&RWLock); }
+  void lock_shared() { pthread_rwlock_rdlock(&RWLock); }
+  void unlock_shared() { pthread_rwlock_unlock(&RWLock); }
+};
+
+/// Target memory that the mappings and the (first-)private arrays of a device
+/// have released, for the next ones of a similar size. The blocks of class I
+/// are of (256 << I) bytes.
+struct DeviceMemoryPoolTy {
+  std::vector<std::vector<void *>> FreeBlocks;
+  int64_t FreeBytes;
+  std::mutex Mtx;
+
+  DeviceMemoryPoolTy() : FreeBlocks(), FreeBytes(0), Mtx() {}
+  // As for the mutexes, a copied device starts with an empty pool.
+  DeviceMemoryPoolTy(const DeviceMemoryPoolTy &)
+      : FreeBlocks(), FreeBytes(0), Mtx() {}
+  DeviceMemoryPoolTy &operator=(const DeviceMemoryPoolTy &) { return *this; }
+};
+
 struct DeviceTy {
   int32_t DeviceID;
   RTLInfoTy *RTL;
@@ -94,7 +144,10 @@ struct DeviceTy {
 
   ShadowPtrListTy ShadowPtrMap;
 
-  std::mutex DataMapMtx, PendingGlobalsMtx, ShadowMtx;
+  RWMutexTy DataMapMtx;
+  std::mutex PendingGlobalsMtx, ShadowMtx;
+
+  DeviceMemoryPoolTy MemoryPool;
 
   uint64_t loopTripCnt;
 
@@ -104,7 +157,7 @@ struct DeviceTy {
       : DeviceID(-1), RTL(RTL), RTLDeviceID(-1), IsInit(false), InitFlag(),
         HasPendingGlobals(false), HostDataToTargetMap(),
         PendingCtorsDtors(), ShadowPtrMap(), DataMapMtx(), PendingGlobalsMtx(),
-        ShadowMtx(), loopTripCnt(0), RTLRequiresFlags(0) {}
+        ShadowMtx(), MemoryPool(), loopTripCnt(0), RTLRequiresFlags(0) {}
 
   // The existence of mutexes makes DeviceTy non-copyable. We need to
   // provide a copy constructor and an assignment operator explicitly.
@@ -114,7 +167,7 @@ struct DeviceTy {
         HostDataToTargetMap(d.HostDataToTargetMap),
         PendingCtorsDtors(d.PendingCtorsDtors), ShadowPtrMap(d.ShadowPtrMap),
         DataMapMtx(), PendingGlobalsMtx(),
-        ShadowMtx(), loopTripCnt(d.loopTripCnt),
+        ShadowMtx(), MemoryPool(), loopTripCnt(d.loopTripCnt),
         RTLRequiresFlags(d.RTLRequiresFlags) {}
 
   DeviceTy& operator=(const DeviceTy &d) {
@@ -147,18 +200,37 @@ struct DeviceTy {
   int32_t initOnce();
   __tgt_target_table *load_binary(void *Img);
 
-  int32_t data_submit(void *TgtPtrBegin, void *HstPtrBegin, int64_t Size);
-  int32_t data_retrieve(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size);
+  // These take the memory from the pool, and give it back to it, up to the
+  // limits set by LIBOMPTARGET_MEMORY_POOL_SIZE and
+  // LIBOMPTARGET_MEMORY_POOL_MAX_BLOCK_SIZE. data_delete must be given the
+  // size that data_alloc was.
+  void *data_alloc(int64_t Size, void *HstPtrBegin);
+  int32_t data_delete(void *TgtPtrBegin, int64_t Size);
+
+  // With an AsyncInfo, these do not wait for the operation if the RTL can
+  // issue it asynchronously; synchronize() waits for it.
+  int32_t data_submit(void *TgtPtrBegin, void *HstPtrBegin, int64_t Size,
+      __tgt_async_info *AsyncInfo = nullptr);
+  int32_t data_retrieve(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size,
+      __tgt_async_info *AsyncInfo = nullptr);
 
   int32_t run_region(void *TgtEntryPtr, void **TgtVarsPtr,
-      ptrdiff_t *TgtOffsets, int32_t TgtVarsSize);
+      ptrdiff_t *TgtOffsets, int32_t TgtVarsSize,
+      __tgt_async_info *AsyncInfo = nullptr);
   int32_t run_team_region(void *TgtEntryPtr, void **TgtVarsPtr,
       ptrdiff_t *TgtOffsets, int32_t TgtVarsSize, int32_t NumTeams,
-      int32_t ThreadLimit, uint64_t LoopTripCount);
+      int32_t ThreadLimit, uint64_t LoopTripCount,
+      __tgt_async_info *AsyncInfo = nullptr);
+
+  int32_t synchronize(__tgt_async_info *AsyncInfo);
 
 private:
   // Call to RTL
   void init(); // To be called only via DeviceTy::initOnce()
+
+  // Give the free blocks of the pool back to the RTL. Return whether there
+  // were any.
+  bool releasePooledMemory();
 };
 
 /// Map between Device ID (i.e. openmp device id) and its DeviceTy.
@@ -18,6 +18,7 @@
 #include "rtl.h"
 
 #include <cassert>
+#include <utility>
 #include <vector>
 
 #ifdef OMPTARGET_DEBUG
@@ -134,7 +135,7 @@ static int InitLibrary(DeviceTy& Device) {
         DP("Add mapping from host " DPxMOD " to device " DPxMOD " with size %zu"
             "\n", DPxPTR(CurrHostEntry->addr), DPxPTR(CurrDeviceEntry->addr),
             CurrDeviceEntry->size);
-        Device.HostDataToTargetMap.push_front(HostDataToTargetTy(
+        Device.HostDataToTargetMap.insert(HostDataToTargetTy(
             (uintptr_t)CurrHostEntry->addr /*HstPtrBase*/,
             (uintptr_t)CurrHostEntry->addr /*HstPtrBegin*/,
             (uintptr_t)CurrHostEntry->addr + CurrHostEntry->size /*HstPtrEnd*/,
@@ -209,9 +210,12 @@ static int32_t member_of(int64_t type) {
   return ((type & OMP_TGT_MAPTYPE_MEMBER_OF) >> 48) - 1;
 }
 
-/// Internal function to do the mapping and transfer the data to the device
+/// Internal function to do the mapping and transfer the data to the device.
+/// With an AsyncInfo, the transfers from the mapped host data are not waited
+/// for.
 int target_data_begin(DeviceTy &Device, int32_t arg_num,
-    void **args_base, void **args, int64_t *arg_sizes, int64_t *arg_types) {
+    void **args_base, void **args, int64_t *arg_sizes, int64_t *arg_types,
+    __tgt_async_info *AsyncInfo) {
   // process each input.
   for (int32_t i = 0; i < arg_num; ++i) {
     // Ignore private variables and arrays - there is no mapping for them.
@@ -304,7 +308,8 @@ int target_data_begin(DeviceTy &Device, int32_t arg_num,
       if (copy) {
         DP("Moving %" PRId64 " bytes (hst:" DPxMOD ") -> (tgt:" DPxMOD ")\n",
             data_size, DPxPTR(HstPtrBegin), DPxPTR(TgtPtrBegin));
-        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, data_size);
+        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, data_size,
+            AsyncInfo);
         if (rt != OFFLOAD_SUCCESS) {
           DP("Copying data to device failed.\n");
           return OFFLOAD_FAIL;
@@ -317,6 +322,13 @@ int target_data_begin(DeviceTy &Device, int32_t arg_num,
           DPxPTR(Pointer_TgtPtrBegin), DPxPTR(TgtPtrBegin));
       uint64_t Delta = (uint64_t)HstPtrBegin - (uint64_t)HstPtrBase;
       void *TgtPtrBase = (void *)((uint64_t)TgtPtrBegin - Delta);
+      // TgtPtrBase does not outlive this iteration, so the copy is not issued
+      // to AsyncInfo. The copies that are, which may write the same place
+      // (as that of the enclosing struct), have to be done by then.
+      if (AsyncInfo && Device.synchronize(AsyncInfo) != OFFLOAD_SUCCESS) {
+        DP("Copying data to device failed.\n");
+        return OFFLOAD_FAIL;
+      }
       int rt = Device.data_submit(Pointer_TgtPtrBegin, &TgtPtrBase,
           sizeof(void *));
       if (rt != OFFLOAD_SUCCESS) {
@@ -334,9 +346,78 @@ int target_data_begin(DeviceTy &Device, int32_t arg_num,
   return OFFLOAD_SUCCESS;
 }
 
+/// A section that target_data_end has retrieved, or is about to deallocate.
+/// Its shadow pointers and its mapping are only updated once the data has
+/// arrived.
+struct DataEndSectionTy {
+  void *HstPtrBegin;
+  int64_t DataSize;
+  int64_t ArgType;
+  bool DelEntry;
+  bool ForceDelete;
+};
+
+/// Restore the host pointers of a retrieved section from their shadow copies,
+/// and deallocate the section if it is not mapped any more.
+static int finishDataEnd(DeviceTy &Device, const DataEndSectionTy &Section) {
+  // If we copied back to the host a struct/array containing pointers, we
+  // need to restore the original host pointer values from their shadow
+  // copies. If the struct is going to be deallocated, remove any remaining
+  // shadow pointer entries for this struct.
+  uintptr_t lb = (uintptr_t) Section.HstPtrBegin;
+  uintptr_t ub = (uintptr_t) Section.HstPtrBegin + Section.DataSize;
+  Device.ShadowMtx.lock();
+  for (ShadowPtrListTy::iterator it = Device.ShadowPtrMap.begin();
+       it != Device.ShadowPtrMap.end();) {
+    void **ShadowHstPtrAddr = (void**) it->first;
+
+    // An STL map is sorted on its keys; use this property
+    // to quickly determine when to break out of the loop.
+    if ((uintptr_t) ShadowHstPtrAddr < lb) {
+      ++it;
+      continue;
+    }
+    if ((uintptr_t) ShadowHstPtrAddr >= ub)
+      break;
+
+    // If we copied the struct to the host, we need to restore the pointer.
+    if (Section.ArgType & OMP_TGT_MAPTYPE_FROM) {
+      DP("Restoring original host pointer value " DPxMOD " for host "
+          "pointer " DPxMOD "\n", DPxPTR(it->second.HstPtrVal),
+          DPxPTR(ShadowHstPtrAddr));
+      *ShadowHstPtrAddr = it->second.HstPtrVal;
+    }
+    // If the struct is to be deallocated, remove the shadow entry.
+    if (Section.DelEntry) {
+      DP("Removing shadow pointer " DPxMOD "\n", DPxPTR(ShadowHstPtrAddr));
+      it = Device.ShadowPtrMap.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  Device.ShadowMtx.unlock();
+
+  // Deallocate map
+  if (Section.DelEntry) {
+    int rt = Device.deallocTgtPtr(Section.HstPtrBegin, Section.DataSize,
+        Section.ForceDelete);
+    if (rt != OFFLOAD_SUCCESS) {
+      DP("Deallocating data from device failed.\n");
+      return OFFLOAD_FAIL;
+    }
+  }
+
+  return OFFLOAD_SUCCESS;
+}
+
 /// Internal function to undo the mapping and retrieve the data from the device.
+/// With an AsyncInfo, the retrievals are issued together, and waited for
+/// before the sections are unmapped.
 int target_data_end(DeviceTy &Device, int32_t arg_num, void **args_base,
-    void **args, int64_t *arg_sizes, int64_t *arg_types) {
+    void **args, int64_t *arg_sizes, int64_t *arg_types,
+    __tgt_async_info *AsyncInfo) {
+  std::vector<DataEndSectionTy> Sections;
+
   // process each input.
   for (int32_t i = arg_num - 1; i >= 0; --i) {
     // Ignore private variables and arrays - there is no mapping for them.
@@ -401,7 +482,8 @@ int target_data_end(DeviceTy &Device, int32_t arg_num, void **args_base,
         if (DelEntry || Always || CopyMember) {
           DP("Moving %" PRId64 " bytes (tgt:" DPxMOD ") -> (hst:" DPxMOD ")\n",
               data_size, DPxPTR(TgtPtrBegin), DPxPTR(HstPtrBegin));
-          int rt = Device.data_retrieve(HstPtrBegin, TgtPtrBegin, data_size);
+          int rt = Device.data_retrieve(HstPtrBegin, TgtPtrBegin, data_size,
+              AsyncInfo);
           if (rt != OFFLOAD_SUCCESS) {
             DP("Copying data from device failed.\n");
             return OFFLOAD_FAIL;
@@ -409,54 +491,28 @@ int target_data_end(DeviceTy &Device, int32_t arg_num, void **args_base,
         }
       }
 
-      // If we copied back to the host a struct/array containing pointers, we
-      // need to restore the original host pointer values from their shadow
-      // copies. If the struct is going to be deallocated, remove any remaining
-      // shadow pointer entries for this struct.
-      uintptr_t lb = (uintptr_t) HstPtrBegin;
-      uintptr_t ub = (uintptr_t) HstPtrBegin + data_size;
-      Device.ShadowMtx.lock();
-      for (ShadowPtrListTy::iterator it = Device.ShadowPtrMap.begin();
-           it != Device.ShadowPtrMap.end();) {
-        void **ShadowHstPtrAddr = (void**) it->first;
-
-        // An STL map is sorted on its keys; use this property
-        // to quickly determine when to break out of the loop.
-        if ((uintptr_t) ShadowHstPtrAddr < lb) {
-          ++it;
-          continue;
-        }
-        if ((uintptr_t) ShadowHstPtrAddr >= ub)
-          break;
-
-        // If we copied the struct to the host, we need to restore the pointer.
-        if (arg_types[i] & OMP_TGT_MAPTYPE_FROM) {
-          DP("Restoring original host pointer value " DPxMOD " for host "
-              "pointer " DPxMOD "\n", DPxPTR(it->second.HstPtrVal),
-              DPxPTR(ShadowHstPtrAddr));
-          *ShadowHstPtrAddr = it->second.HstPtrVal;
-        }
-        // If the struct is to be deallocated, remove the shadow entry.
-        if (DelEntry) {
-          DP("Removing shadow pointer " DPxMOD "\n", DPxPTR(ShadowHstPtrAddr));
-          it = Device.ShadowPtrMap.erase(it);
-        } else {
-          ++it;
-        }
-      }
-      Device.ShadowMtx.unlock();
-
-      // Deallocate map
-      if (DelEntry) {
-        int rt = Device.deallocTgtPtr(HstPtrBegin, data_size, ForceDelete);
-        if (rt != OFFLOAD_SUCCESS) {
-          DP("Deallocating data from device failed.\n");
-          return OFFLOAD_FAIL;
-        }
+      DataEndSectionTy Section = {HstPtrBegin, data_size, arg_types[i],
+                                  DelEntry, ForceDelete};
+      if (AsyncInfo) {
+        Sections.push_back(Section);
+      } else if (finishDataEnd(Device, Section) != OFFLOAD_SUCCESS) {
+        return OFFLOAD_FAIL;
       }
     }
   }
 
+  if (Sections.empty())
+    return OFFLOAD_SUCCESS;
+
+  if (Device.synchronize(AsyncInfo) != OFFLOAD_SUCCESS) {
+    DP("Waiting for the data to be copied from device failed.\n");
+    return OFFLOAD_FAIL;
+  }
+  for (const DataEndSectionTy &Section : Sections) {
+    if (finishDataEnd(Device, Section) != OFFLOAD_SUCCESS)
+      return OFFLOAD_FAIL;
+  }
+
   return OFFLOAD_SUCCESS;
 }
 
@@ -548,71 +604,18 @@ static bool isLambdaMapping(int64_t Mapping) {
   return (Mapping & LambdaMapping) == LambdaMapping;
 }
 
-/// performs the same actions as data_begin in case arg_num is
-/// non-zero and initiates run of the offloaded region on the target platform;
-/// if arg_num is non-zero after the region execution is done it also
-/// performs the same action as data_update and data_end above. This function
-/// returns 0 if it was able to transfer the execution to a target and an
-/// integer different from zero otherwise.
-int target(int64_t device_id, void *host_ptr, int32_t arg_num,
-    void **args_base, void **args, int64_t *arg_sizes, int64_t *arg_types,
-    int32_t team_num, int32_t thread_limit, int IsTeamConstruct) {
-  DeviceTy &Device = Devices[device_id];
-
-  // Find the table information in the map or look it up in the translation
-  // tables.
-  TableMap *TM = 0;
-  TblMapMtx.lock();
-  HostPtrToTableMapTy::iterator TableMapIt = HostPtrToTableMap.find(host_ptr);
-  if (TableMapIt == HostPtrToTableMap.end()) {
-    // We don't have a map. So search all the registered libraries.
-    TrlTblMtx.lock();
-    for (HostEntriesBeginToTransTableTy::iterator
-             ii = HostEntriesBeginToTransTable.begin(),
-             ie = HostEntriesBeginToTransTable.end();
-         !TM && ii != ie; ++ii) {
-      // get the translation table (which contains all the good info).
-      TranslationTable *TransTable = &ii->second;
-      // iterate over all the host table entries to see if we can locate the
-      // host_ptr.
-      __tgt_offload_entry *begin = TransTable->HostTable.EntriesBegin;
-      __tgt_offload_entry *end = TransTable->HostTable.EntriesEnd;
-      __tgt_offload_entry *cur = begin;
-      for (uint32_t i = 0; cur < end; ++cur, ++i) {
-        if (cur->addr != host_ptr)
-          continue;
-        // we got a match, now fill the HostPtrToTableMap so that we
-        // may avoid this search next time.
-        TM = &HostPtrToTableMap[host_ptr];
-        TM->Table = TransTable;
-        TM->Index = i;
-        break;
-      }
-    }
-    TrlTblMtx.unlock();
-  } else {
-    TM = &TableMapIt->second;
-  }
-  TblMapMtx.unlock();
-
-  // No map for this host pointer found!
-  if (!TM) {
-    DP("Host ptr " DPxMOD " does not have a matching target pointer.\n",
-       DPxPTR(host_ptr));
-    return OFFLOAD_FAIL;
-  }
-
-  // get target table.
-  TrlTblMtx.lock();
-  assert(TM->Table->TargetsTable.size() > (size_t)device_id &&
-         "Not expecting a device ID outside the table's bounds!");
-  __tgt_target_table *TargetTable = TM->Table->TargetsTable[device_id];
-  TrlTblMtx.unlock();
-  assert(TargetTable && "Global data has not been mapped\n");
-
+/// Issue the transfers and the launch of a target region to AsyncInfo. The
+/// (first-)private arrays it allocates are added to fpArrays with their sizes,
+/// for the caller to free once they have been waited for.
+static int issueTargetRegion(DeviceTy &Device, __tgt_target_table *TargetTable,
+    int32_t Index, int32_t arg_num, void **args_base, void **args,
+    int64_t *arg_sizes, int64_t *arg_types, int32_t team_num,
+    int32_t thread_limit, int IsTeamConstruct,
+    std::vector<std::pair<void *, int64_t>> &fpArrays,
+    __tgt_async_info *AsyncInfo) {
   // Move data to device.
   int rc = target_data_begin(Device, arg_num, args_base, args, arg_sizes,
-      arg_types);
+      arg_types, AsyncInfo);
   if (rc != OFFLOAD_SUCCESS) {
     DP("Call to target_data_begin failed, abort target.\n");
     return OFFLOAD_FAIL;
@@ -621,8 +624,6 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
   std::vector<void *> tgt_args;
   std::vector<ptrdiff_t> tgt_offsets;
 
-  // List of (first-)private arrays allocated for this target region
-  std::vector<void *> fpArrays;
   std::vector<int> tgtArgsPositions(arg_num, -1);
 
   for (int32_t i = 0; i < arg_num; ++i) {
@@ -655,6 +656,12 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
         }
         DP("Update lambda reference (" DPxMOD ") -> [" DPxMOD "]\n",
            DPxPTR(Pointer_TgtPtrBegin), DPxPTR(TgtPtrBegin));
+        // As in target_data_begin, the copy of Pointer_TgtPtrBegin, which
+        // does not outlive this iteration, waits for the lambda to be copied.
+        if (Device.synchronize(AsyncInfo) != OFFLOAD_SUCCESS) {
+          DP("Copying data to device failed.\n");
+          return OFFLOAD_FAIL;
+        }
         int rt = Device.data_submit(TgtPtrBegin, &Pointer_TgtPtrBegin,
                                     sizeof(void *));
         if (rt != OFFLOAD_SUCCESS) {
@@ -676,8 +683,7 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
       TgtBaseOffset = 0;
     } else if (arg_types[i] & OMP_TGT_MAPTYPE_PRIVATE) {
       // Allocate memory for (first-)private array
-      TgtPtrBegin = Device.RTL->data_alloc(Device.RTLDeviceID,
-          arg_sizes[i], HstPtrBegin);
+      TgtPtrBegin = Device.data_alloc(arg_sizes[i], HstPtrBegin);
       if (!TgtPtrBegin) {
         DP ("Data allocation for %sprivate array " DPxMOD " failed, "
             "abort target.\n",
@@ -685,7 +691,7 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
             DPxPTR(HstPtrBegin));
         return OFFLOAD_FAIL;
       }
-      fpArrays.push_back(TgtPtrBegin);
+      fpArrays.push_back(std::make_pair(TgtPtrBegin, arg_sizes[i]));
       TgtBaseOffset = (intptr_t)HstPtrBase - (intptr_t)HstPtrBegin;
 #ifdef OMPTARGET_DEBUG
       void *TgtPtrBase = (void *)((intptr_t)TgtPtrBegin + TgtBaseOffset);
@@ -697,7 +703,8 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
 #endif
       // If first-private, copy data from host
       if (arg_types[i] & OMP_TGT_MAPTYPE_TO) {
-        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, arg_sizes[i]);
+        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, arg_sizes[i],
+            AsyncInfo);
         if (rt != OFFLOAD_SUCCESS) {
           DP ("Copying data to device failed, failed.\n");
           return OFFLOAD_FAIL;
@@ -734,33 +741,24 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
 
   // Launch device execution.
   DP("Launching target execution %s with pointer " DPxMOD " (index=%d).\n",
-      TargetTable->EntriesBegin[TM->Index].name,
-      DPxPTR(TargetTable->EntriesBegin[TM->Index].addr), TM->Index);
+      TargetTable->EntriesBegin[Index].name,
+      DPxPTR(TargetTable->EntriesBegin[Index].addr), Index);
   if (IsTeamConstruct) {
-    rc = Device.run_team_region(TargetTable->EntriesBegin[TM->Index].addr,
+    rc = Device.run_team_region(TargetTable->EntriesBegin[Index].addr,
         &tgt_args[0], &tgt_offsets[0], tgt_args.size(), team_num,
-        thread_limit, ltc);
+        thread_limit, ltc, AsyncInfo);
   } else {
-    rc = Device.run_region(TargetTable->EntriesBegin[TM->Index].addr,
-        &tgt_args[0], &tgt_offsets[0], tgt_args.size());
+    rc = Device.run_region(TargetTable->EntriesBegin[Index].addr,
+        &tgt_args[0], &tgt_offsets[0], tgt_args.size(), AsyncInfo);
   }
   if (rc != OFFLOAD_SUCCESS) {
     DP ("Executing target region abort target.\n");
     return OFFLOAD_FAIL;
   }
 
-  // Deallocate (first-)private arrays
-  for (auto it : fpArrays) {
-    int rt = Device.RTL->data_delete(Device.RTLDeviceID, it);
-    if (rt != OFFLOAD_SUCCESS) {
-      DP("Deallocation of (first-)private arrays failed.\n");
-      return OFFLOAD_FAIL;
-    }
-  }
-
   // Move data from device.
   int rt = target_data_end(Device, arg_num, args_base, args, arg_sizes,
-      arg_types);
+      arg_types, AsyncInfo);
   if (rt != OFFLOAD_SUCCESS) {
     DP("Call to target_data_end failed, abort targe.\n");
     return OFFLOAD_FAIL;
@@ -768,3 +766,92 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
 
   return OFFLOAD_SUCCESS;
 }
+
+/// performs the same actions as data_begin in case arg_num is
+/// non-zero and initiates run of the offloaded region on the target platform;
+/// if arg_num is non-zero after the region execution is done it also
+/// performs the same action as data_update and data_end above. This function
+/// returns 0 if it was able to transfer the execution to a target and an
+/// integer different from zero otherwise.
+int target(int64_t device_id, void *host_ptr, int32_t arg_num,
+    void **args_base, void **args, int64_t *arg_sizes, int64_t *arg_types,
+    int32_t team_num, int32_t thread_limit, int IsTeamConstruct) {
+  DeviceTy &Device = Devices[device_id];
+
+  // Find the table information in the map or look it up in the translation
+  // tables.
+  TableMap *TM = 0;
+  TblMapMtx.lock();
+  HostPtrToTableMapTy::iterator TableMapIt = HostPtrToTableMap.find(host_ptr);
+  if (TableMapIt == HostPtrToTableMap.end()) {
+    // We don't have a map. So search all the registered libraries.
+    TrlTblMtx.lock();
+    for (HostEntriesBeginToTransTableTy::iterator
+             ii = HostEntriesBeginToTransTable.begin(),
+             ie = HostEntriesBeginToTransTable.end();
+         !TM && ii != ie; ++ii) {
+      // get the translation table (which contains all the good info).
+      TranslationTable *TransTable = &ii->second;
+      // iterate over all the host table entries to see if we can locate the
+      // host_ptr.
+      __tgt_offload_entry *begin = TransTable->HostTable.EntriesBegin;
+      __tgt_offload_entry *end = TransTable->HostTable.EntriesEnd;
+      __tgt_offload_entry *cur = begin;
+      for (uint32_t i = 0; cur < end; ++cur, ++i) {
+        if (cur->addr != host_ptr)
+          continue;
+        // we got a match, now fill the HostPtrToTableMap so that we
+        // may avoid this search next time.
+        TM = &HostPtrToTableMap[host_ptr];
+        TM->Table = TransTable;
+        TM->Index = i;
+        break;
+      }
+    }
+    TrlTblMtx.unlock();
+  } else {
+    TM = &TableMapIt->second;
+  }
+  TblMapMtx.unlock();
+
+  // No map for this host pointer found!
+  if (!TM) {
+    DP("Host ptr " DPxMOD " does not have a matching target pointer.\n",
+       DPxPTR(host_ptr));
+    return OFFLOAD_FAIL;
+  }
+
+  // get target table.
+  TrlTblMtx.lock();
+  assert(TM->Table->TargetsTable.size() > (size_t)device_id &&
+         "Not expecting a device ID outside the table's bounds!");
+  __tgt_target_table *TargetTable = TM->Table->TargetsTable[device_id];
+  TrlTblMtx.unlock();
+  assert(TargetTable && "Global data has not been mapped\n");
+
+  // The transfers and the kernel go to one queue of the device, and they are
+  // only waited for before the data is unmapped, instead of one by one.
+  __tgt_async_info AsyncInfo = {nullptr};
+  // List of (first-)private arrays allocated for this target region
+  std::vector<std::pair<void *, int64_t>> fpArrays;
+  int rc = issueTargetRegion(Device, TargetTable, TM->Index, arg_num,
+      args_base, args, arg_sizes, arg_types, team_num, thread_limit,
+      IsTeamConstruct, fpArrays, &AsyncInfo);
+  // If something failed half-way, still wait for what was issued, as it may
+  // use the (first-)private arrays.
+  if (Device.synchronize(&AsyncInfo) != OFFLOAD_SUCCESS) {
+    DP("Waiting for the target region failed.\n");
+    rc = OFFLOAD_FAIL;
+  }
+
+  // Deallocate (first-)private arrays
+  for (auto it : fpArrays) {
+    int rt = Device.data_delete(it.first, it.second);
+    if (rt != OFFLOAD_SUCCESS) {
+      DP("Deallocation of (first-)private arrays failed.\n");
+      rc = OFFLOAD_FAIL;
+    }
+  }
+
+  return rc;
+}
@@ -107,6 +107,26 @@ void RTLsTy::LoadRTLs() {
               dynlib_handle, "__tgt_rtl_run_target_team_region")))
       continue;
 
+    // Optional functions: only use them if the RTL has all of them.
+    if ((*((void**) &R.synchronize) = dlsym(
+              dynlib_handle, "__tgt_rtl_synchronize")) &&
+        (*((void**) &R.data_submit_async) = dlsym(
+              dynlib_handle, "__tgt_rtl_data_submit_async")) &&
+        (*((void**) &R.data_retrieve_async) = dlsym(
+              dynlib_handle, "__tgt_rtl_data_retrieve_async")) &&
+        (*((void**) &R.run_region_async) = dlsym(
+              dynlib_handle, "__tgt_rtl_run_target_region_async")) &&
+        (*((void**) &R.run_team_region_async) = dlsym(
+              dynlib_handle, "__tgt_rtl_run_target_team_region_async"))) {
+      DP("RTL supports asynchronous operations\n");
+    } else {
+      R.synchronize = 0;
+      R.data_submit_async = 0;
+      R.data_retrieve_async = 0;
+      R.run_region_async = 0;
+      R.run_team_region_async = 0;
+    }
+
     // No devices are supported by this RTL?
     if (!(R.NumberOfDevices = R.number_of_devices())) {
       DP("No devices supported in this RTL\n");
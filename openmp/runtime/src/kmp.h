@@ -817,6 +817,7 @@ extern void __kmp_affinity_bind_thread(int which);
 
 extern kmp_affin_mask_t *__kmp_affin_fullMask;
 extern char *__kmp_cpuinfo_file;
+extern int __kmp_affinity_place_distance(int place1, int place2);
 
 #endif /* KMP_AFFINITY_SUPPORTED */
 
@@ -978,6 +979,9 @@ typedef struct kmp_allocator_t {
   kmp_allocator_t *fb_data;
   kmp_uint64 pool_size;
   kmp_uint64 pool_used;
+  omp_alloctrait_value_t partition; // requested NUMA partition of pages
+  bool pinned; // pages are locked in memory
+  bool placed; // pages are mapped and placed by the runtime itself
 } kmp_allocator_t;
 
 extern omp_allocator_handle_t __kmpc_init_allocator(int gtid,
@@ -1738,6 +1742,8 @@ typedef struct dispatch_shared_info {
 #if KMP_USE_HIER_SCHED
   void *hier;
 #endif
+  volatile kmp_int32 adaptive_choice; // schedule of an adaptive loop, 0 = none
+  kmp_uint64 adaptive_start; // time the adaptive loop was started
 #if KMP_USE_HWLOC
   // When linking with libhwloc, the ORDERED EPCC test slows down on big
   // machines (> 48 cores). Performance analysis showed that a cache thrash
@@ -2113,6 +2119,8 @@ typedef enum kmp_tasking_mode {
 extern kmp_tasking_mode_t
     __kmp_tasking_mode; /* determines how/when to execute tasks */
 extern int __kmp_task_stealing_constraint;
+extern int __kmp_task_steal_locality; /* KMP_TASK_STEAL_LOCALITY */
+extern int __kmp_task_steal_local_tries; /* KMP_TASK_STEAL_LOCAL_TRIES */
 #if OMP_40_ENABLED
 extern kmp_int32 __kmp_default_device; // Set via OMP_DEFAULT_DEVICE if
 // specified, defaults to 0 otherwise
@@ -2241,14 +2249,22 @@ struct kmp_dephash_entry {
   kmp_depnode_list_t *last_mtxs;
   kmp_int32 last_flag;
   kmp_lock_t *mtx_lock; /* is referenced by depnodes w/mutexinoutset dep */
-  kmp_dephash_entry_t *next_in_bucket;
 };
 
+/* The probes only read the addresses of the slots, and the entries do not move
+   when the table grows. A slot is empty while its entry is NULL. */
+typedef struct kmp_dephash_slot {
+  kmp_intptr_t addr;
+  kmp_dephash_entry_t *entry;
+} kmp_dephash_slot_t;
+
+/* Open addressing with linear probing; the table doubles before it is half
+   full. */
 typedef struct kmp_dephash {
-  kmp_dephash_entry_t **buckets;
-  size_t size;
+  kmp_dephash_slot_t *slots;
+  size_t size; /* number of slots, a power of two */
+  size_t nelements;
 #ifdef KMP_DEBUG
-  kmp_uint32 nelements;
   kmp_uint32 nconflicts;
 #endif
 } kmp_dephash_t;
@@ -2388,6 +2404,15 @@ typedef struct kmp_base_thread_data {
   kmp_int32 td_deque_ntasks; // Number of tasks in deque
   // GEH: shouldn't this be volatile since used in while-spin?
   kmp_int32 td_deque_last_stolen; // Thread number of last successful steal
+#if KMP_AFFINITY_SUPPORTED && OMP_40_ENABLED
+  // The other threads of the team, nearest first, to pick steal victims from
+  // (see __kmp_find_near_victim). The ones before td_steal_level_end[0] share
+  // the core of td_thr, the ones before td_steal_level_end[1] its package.
+  // td_steal_level_end[0] is -1 until the order is built for the team.
+  kmp_int32 *td_steal_order;
+  kmp_int32 td_steal_order_size; // Allocated length of td_steal_order
+  kmp_int32 td_steal_level_end[2];
+#endif
 #ifdef BUILD_TIED_TASK_STACK
   kmp_task_stack_t td_susp_tied_tasks; // Stack of suspended tied tasks for task
 // scheduling constraint
@@ -2527,6 +2552,7 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
 #endif
 #if OMP_50_ENABLED
   omp_allocator_handle_t th_def_allocator; /* default allocator */
+  void *th_placed_free; /* free placed blocks of custom allocators */
 #endif
   /* The data set by the master at reinit, then R/W by the worker */
   KMP_ALIGN_CACHE int
@@ -3057,6 +3083,7 @@ extern int __kmp_dflt_max_active_levels;
 extern bool __kmp_dflt_max_active_levels_set;
 extern int __kmp_dispatch_num_buffers; /* max possible dynamic loops in
                                           concurrent execution per team */
+extern int __kmp_auto_adaptive; /* KMP_AUTO_ADAPTIVE: tune schedule(auto) */
 #if KMP_NESTED_HOT_TEAMS
 extern int __kmp_hot_teams_mode;
 extern int __kmp_hot_teams_max_level;
@@ -3543,6 +3570,9 @@ extern kmp_team_t *__kmp_reap_team(kmp_team_t *);
 
 extern void __kmp_initialize_bget(kmp_info_t *th);
 extern void __kmp_finalize_bget(kmp_info_t *th);
+#if OMP_50_ENABLED
+extern void __kmp_free_placed_memory(kmp_info_t *th);
+#endif
 
 KMP_EXPORT void *kmpc_malloc(size_t size);
 KMP_EXPORT void *kmpc_aligned_malloc(size_t size, size_t alignment);
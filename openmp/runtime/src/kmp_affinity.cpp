@@ -4083,6 +4083,53 @@ static AddrUnsPair *address2os = NULL;
 static int *procarr = NULL;
 static int __kmp_aff_depth = 0;
 
+// Index in address2os of the first processor of each place, or NULL if the
+// places do not come from the machine topology; and the level of the cores in
+// the addresses.
+static int *__kmp_place_addr = NULL;
+static int __kmp_place_core_level = 0;
+
+static void __kmp_affinity_init_place_topology(int depth) {
+  // The addresses end with the thread level if the cores have several.
+  __kmp_place_core_level = depth - (__kmp_nThreadsPerCore > 1 ? 2 : 1);
+  if (__kmp_place_core_level < 0)
+    __kmp_place_core_level = 0;
+  __kmp_place_addr =
+      (int *)__kmp_allocate(sizeof(int) * __kmp_affinity_num_masks);
+  for (unsigned i = 0; i < __kmp_affinity_num_masks; i++) {
+    int first = KMP_CPU_INDEX(__kmp_affinity_masks, i)->begin();
+    __kmp_place_addr[i] = -1;
+    for (int j = 0; j < __kmp_avail_proc; j++) {
+      if ((int)address2os[j].second == first) {
+        __kmp_place_addr[i] = j;
+        break;
+      }
+    }
+  }
+}
+
+// Return 0 if the first processors of the two places are on the same core, 1
+// if they are in the same package, and 2 if they are not, or if that is not
+// known.
+int __kmp_affinity_place_distance(int place1, int place2) {
+  if (__kmp_place_addr == NULL || place1 < 0 || place2 < 0 ||
+      (unsigned)place1 >= __kmp_affinity_num_masks ||
+      (unsigned)place2 >= __kmp_affinity_num_masks)
+    return 2;
+  int addr1 = __kmp_place_addr[place1];
+  int addr2 = __kmp_place_addr[place2];
+  if (addr1 < 0 || addr2 < 0)
+    return 2;
+  const Address &a = address2os[addr1].first;
+  const Address &b = address2os[addr2].first;
+  if (a.isClose(b, a.depth - 1 - __kmp_place_core_level))
+    return 0;
+  // Without a level above the cores, the machine has a single package.
+  if (__kmp_place_core_level == 0 || a.isClose(b, a.depth - 1))
+    return 1;
+  return 2;
+}
+
 #if KMP_USE_HIER_SCHED
 #define KMP_EXIT_AFF_NONE                                                      \
   KMP_ASSERT(__kmp_affinity_type == affinity_none);                            \
@@ -4654,6 +4701,7 @@ static void __kmp_aux_affinity_initialize(void) {
   }
 
   KMP_CPU_FREE_ARRAY(osId2Mask, maxIndex + 1);
+  __kmp_affinity_init_place_topology(depth);
   machine_hierarchy.init(address2os, __kmp_avail_proc);
 }
 #undef KMP_EXIT_AFF_NONE
@@ -4706,6 +4754,10 @@ void __kmp_affinity_uninitialize(void) {
     __kmp_free(procarr);
     procarr = NULL;
   }
+  if (__kmp_place_addr != NULL) {
+    __kmp_free(__kmp_place_addr);
+    __kmp_place_addr = NULL;
+  }
 #if KMP_USE_HWLOC
   if (__kmp_hwloc_topology != NULL) {
     hwloc_topology_destroy(__kmp_hwloc_topology);
@@ -672,6 +672,17 @@ public:
     }
   }
 
+  /** Smallest factor that splits num children into groups of at most limit,
+      0 if there is none. Splitting by an exact factor keeps every subtree of
+      the barrier inside one core, package, etc., where halving an odd level
+      would let groups straddle the machine's boundaries. */
+  static kmp_uint32 splitFactor(kmp_uint32 num, kmp_uint32 limit) {
+    for (kmp_uint32 f = 2; f < num; ++f)
+      if (num % f == 0 && num / f <= limit)
+        return f;
+    return 0;
+  }
+
   hierarchy_info()
       : maxLevels(7), depth(1), uninitialized(not_initialized), resizing(0) {}
 
@@ -733,14 +744,20 @@ public:
     if (branch < minBranch)
       branch = minBranch;
     for (kmp_uint32 d = 0; d < depth - 1; ++d) { // optimize hierarchy width
-      while (numPerLevel[d] > branch ||
-             (d == 0 && numPerLevel[d] > maxLeaves)) { // max 4 on level 0!
-        if (numPerLevel[d] & 1)
-          numPerLevel[d]++;
-        numPerLevel[d] = numPerLevel[d] >> 1;
+      kmp_uint32 limit = (d == 0 && maxLeaves < branch) ? maxLeaves : branch;
+      while (numPerLevel[d] > limit) { // max 4 on level 0!
+        kmp_uint32 factor = splitFactor(numPerLevel[d], limit);
+        if (factor) {
+          numPerLevel[d] /= factor;
+        } else {
+          if (numPerLevel[d] & 1)
+            numPerLevel[d]++;
+          numPerLevel[d] = numPerLevel[d] >> 1;
+          factor = 2;
+        }
         if (numPerLevel[d + 1] == 1)
           depth++;
-        numPerLevel[d + 1] = numPerLevel[d + 1] << 1;
+        numPerLevel[d + 1] *= factor;
       }
       if (numPerLevel[0] == 1) {
         branch = branch >> 1;
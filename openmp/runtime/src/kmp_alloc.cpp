@@ -14,6 +14,11 @@
 #include "kmp_io.h"
 #include "kmp_wrapper_malloc.h"
 
+#if OMP_50_ENABLED && KMP_OS_LINUX
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
 // Disable bget when it is not used
 #if KMP_USE_BGET
 
@@ -1241,6 +1246,196 @@ static void **mk_hugetlb;
 static void **mk_hbw_hugetlb;
 static void **mk_hbw_preferred_hugetlb;
 
+// Pages of the custom allocators that ask for a NUMA partition or for pinned
+// memory are mapped by the runtime and placed with mbind(2), so this does not
+// need libnuma or memkind.
+#if KMP_OS_LINUX && defined(SYS_mbind) && defined(SYS_get_mempolicy)
+#define KMP_PLACED_ALLOC 1
+#else
+#define KMP_PLACED_ALLOC 0
+#endif
+
+#if KMP_PLACED_ALLOC
+// Memory policies from <linux/mempolicy.h>, not every libc exposes them
+#define KMP_MPOL_PREFERRED 1
+#define KMP_MPOL_BIND 2
+#define KMP_MPOL_INTERLEAVE 3
+#define KMP_MPOL_F_MEMS_ALLOWED (1 << 2)
+
+#define KMP_NUMA_MAX_NODES 1024
+#define KMP_NUMA_MASK_BITS (8 * sizeof(unsigned long))
+#define KMP_NUMA_MASK_WORDS (KMP_NUMA_MAX_NODES / KMP_NUMA_MASK_BITS)
+
+// Freed placed blocks kept per thread, and the largest block worth keeping
+#define KMP_PLACED_FREE_LIST_LIMIT 16
+#define KMP_PLACED_FREE_MAX_SIZE ((size_t)64 * 1024 * 1024)
+
+static unsigned long numa_nodes_allowed[KMP_NUMA_MASK_WORDS];
+static int numa_num_nodes; // number of nodes the process may allocate on
+static size_t placed_page_size;
+
+// Free placed block, the header is written over the start of the block
+typedef struct kmp_placed_free {
+  struct kmp_placed_free *next;
+  size_t size; // size of the mapping
+  omp_alloctrait_value_t partition;
+  bool pinned;
+} kmp_placed_free_t;
+
+static void __kmp_init_placed_alloc() {
+  long rc;
+  int i;
+  memset(numa_nodes_allowed, 0, sizeof(numa_nodes_allowed));
+  numa_num_nodes = 0;
+  placed_page_size = (size_t)getpagesize();
+  rc = syscall(SYS_get_mempolicy, NULL, numa_nodes_allowed,
+               (unsigned long)KMP_NUMA_MAX_NODES + 1, NULL,
+               KMP_MPOL_F_MEMS_ALLOWED);
+  if (rc != 0) {
+    // kernel without NUMA support, pages can still be pinned
+    KE_TRACE(25, ("__kmp_init_placed_alloc: get_mempolicy failed (%d)\n",
+                  errno));
+    return;
+  }
+  for (i = 0; i < KMP_NUMA_MAX_NODES; ++i)
+    if (numa_nodes_allowed[i / KMP_NUMA_MASK_BITS] &
+        (1UL << (i % KMP_NUMA_MASK_BITS)))
+      ++numa_num_nodes;
+  KE_TRACE(25, ("__kmp_init_placed_alloc: %d NUMA nodes allowed\n",
+                numa_num_nodes));
+}
+
+static inline long __kmp_mbind(void *addr, size_t len, int mode,
+                               const unsigned long *mask) {
+  return syscall(SYS_mbind, addr, len, mode, mask,
+                 mask ? (unsigned long)KMP_NUMA_MAX_NODES + 1 : 0, 0);
+}
+
+// Spreads the pages on the allowed nodes in equal contiguous blocks
+static int __kmp_mbind_blocked(void *addr, size_t size) {
+  unsigned long mask[KMP_NUMA_MASK_WORDS];
+  size_t npages = size / placed_page_size;
+  size_t chunk = (npages + numa_num_nodes - 1) / numa_num_nodes;
+  size_t page = 0;
+  int node;
+  for (node = 0; node < KMP_NUMA_MAX_NODES && page < npages; ++node) {
+    if (!(numa_nodes_allowed[node / KMP_NUMA_MASK_BITS] &
+          (1UL << (node % KMP_NUMA_MASK_BITS))))
+      continue;
+    size_t n = npages - page < chunk ? npages - page : chunk;
+    memset(mask, 0, sizeof(mask));
+    mask[node / KMP_NUMA_MASK_BITS] = 1UL << (node % KMP_NUMA_MASK_BITS);
+    if (__kmp_mbind((char *)addr + page * placed_page_size,
+                    n * placed_page_size, KMP_MPOL_BIND, mask))
+      return -1;
+    page += n;
+  }
+  return 0;
+}
+
+// Allocator that cannot be placed falls back to the regular allocations
+static bool __kmp_placed_supported(const kmp_allocator_t *al) {
+  if (al->pinned)
+    return true;
+  if (numa_num_nodes == 0)
+    return false;
+  return al->partition == OMP_ATV_NEAREST ||
+         al->partition == OMP_ATV_BLOCKED ||
+         al->partition == OMP_ATV_INTERLEAVED;
+}
+
+// Small blocks are not worth mappings of their own unless they are pinned
+static inline bool __kmp_use_placed(const kmp_allocator_t *al, size_t size) {
+  return al->placed && (al->pinned || size >= placed_page_size);
+}
+
+static void *__kmp_placed_alloc(kmp_info_t *th, kmp_allocator_t *al,
+                                size_t size) {
+  kmp_placed_free_t **prev;
+  kmp_placed_free_t *b;
+  void *ptr;
+  long rc = 0;
+
+  size = (size + placed_page_size - 1) & ~(placed_page_size - 1);
+  // a block freed by this thread with the same placement can be reused
+  prev = (kmp_placed_free_t **)&th->th.th_placed_free;
+  for (b = *prev; b != NULL; prev = &b->next, b = b->next) {
+    if (b->size == size && b->partition == al->partition &&
+        b->pinned == al->pinned) {
+      *prev = b->next;
+      KE_TRACE(25, ("__kmp_placed_alloc: T#%d reused %p (%d)\n",
+                    __kmp_gtid_from_thread(th), b, (int)size));
+      return b;
+    }
+  }
+
+  ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+             -1, 0);
+  if (ptr == MAP_FAILED)
+    return NULL;
+  if (numa_num_nodes > 0) {
+    switch (al->partition) {
+    case OMP_ATV_INTERLEAVED:
+      rc = __kmp_mbind(ptr, size, KMP_MPOL_INTERLEAVE, numa_nodes_allowed);
+      break;
+    case OMP_ATV_NEAREST:
+      // preferred policy with no nodes is the local node of the first touch
+      rc = __kmp_mbind(ptr, size, KMP_MPOL_PREFERRED, NULL);
+      break;
+    case OMP_ATV_BLOCKED:
+      rc = __kmp_mbind_blocked(ptr, size);
+      break;
+    default:
+      break;
+    }
+  }
+  if (rc == 0 && al->pinned)
+    rc = mlock(ptr, size);
+  if (rc != 0) {
+    KE_TRACE(25, ("__kmp_placed_alloc: placement of %p (%d) failed (%d)\n",
+                  ptr, (int)size, errno));
+    munmap(ptr, size);
+    return NULL;
+  }
+  return ptr;
+}
+
+static void __kmp_placed_free(kmp_info_t *th, kmp_allocator_t *al, void *ptr,
+                              size_t size) {
+  kmp_placed_free_t *b;
+  int count = 0;
+
+  size = (size + placed_page_size - 1) & ~(placed_page_size - 1);
+  if (size <= KMP_PLACED_FREE_MAX_SIZE) {
+    for (b = (kmp_placed_free_t *)th->th.th_placed_free; b != NULL; b = b->next)
+      ++count;
+    if (count < KMP_PLACED_FREE_LIST_LIMIT) {
+      // pages keep their placement and stay locked while in the list
+      b = (kmp_placed_free_t *)ptr;
+      b->next = (kmp_placed_free_t *)th->th.th_placed_free;
+      b->size = size;
+      b->partition = al->partition;
+      b->pinned = al->pinned;
+      th->th.th_placed_free = b;
+      return;
+    }
+  }
+  munmap(ptr, size);
+}
+#endif // KMP_PLACED_ALLOC
+
+void __kmp_free_placed_memory(kmp_info_t *th) {
+#if KMP_PLACED_ALLOC
+  kmp_placed_free_t *b = (kmp_placed_free_t *)th->th.th_placed_free;
+  while (b != NULL) {
+    kmp_placed_free_t *next = b->next;
+    munmap(b, b->size);
+    b = next;
+  }
+#endif
+  th->th.th_placed_free = NULL;
+}
+
 #if KMP_OS_UNIX && KMP_DYNAMIC_LIB
 static inline void chk_kind(void ***pkind) {
   KMP_DEBUG_ASSERT(pkind);
@@ -1251,6 +1446,9 @@ static inline void chk_kind(void ***pkind) {
 #endif
 
 void __kmp_init_memkind() {
+#if KMP_PLACED_ALLOC
+  __kmp_init_placed_alloc();
+#endif
 // as of 2018-07-31 memkind does not support Windows*, exclude it for now
 #if KMP_OS_UNIX && KMP_DYNAMIC_LIB
   // use of statically linked memkind is problematic, as it depends on libnuma
@@ -1351,7 +1549,9 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
     switch (traits[i].key) {
     case OMP_ATK_THREADMODEL:
     case OMP_ATK_ACCESS:
+      break;
     case OMP_ATK_PINNED:
+      al->pinned = (traits[i].value == OMP_ATV_TRUE);
       break;
     case OMP_ATK_ALIGNMENT:
       al->alignment = traits[i].value;
@@ -1370,7 +1570,11 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
       al->fb_data = RCAST(kmp_allocator_t *, traits[i].value);
       break;
     case OMP_ATK_PARTITION:
-      al->memkind = RCAST(void **, traits[i].value);
+      al->partition = (omp_alloctrait_value_t)traits[i].value;
+      KMP_DEBUG_ASSERT(al->partition == OMP_ATV_ENVIRONMENT ||
+                       al->partition == OMP_ATV_NEAREST ||
+                       al->partition == OMP_ATV_BLOCKED ||
+                       al->partition == OMP_ATV_INTERLEAVED);
       break;
     default:
       KMP_ASSERT2(0, "Unexpected allocator trait");
@@ -1388,7 +1592,7 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
   if (__kmp_memkind_available) {
     // Let's use memkind library if available
     if (ms == omp_high_bw_mem_space) {
-      if (al->memkind == (void *)OMP_ATV_INTERLEAVED && mk_hbw_interleave) {
+      if (al->partition == OMP_ATV_INTERLEAVED && mk_hbw_interleave) {
         al->memkind = mk_hbw_interleave;
       } else if (mk_hbw_preferred) {
         // AC: do not try to use MEMKIND_HBW for now, because memkind library
@@ -1403,7 +1607,7 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
         return omp_null_allocator;
       }
     } else {
-      if (al->memkind == (void *)OMP_ATV_INTERLEAVED && mk_interleave) {
+      if (al->partition == OMP_ATV_INTERLEAVED && mk_interleave) {
         al->memkind = mk_interleave;
       } else {
         al->memkind = mk_default;
@@ -1416,6 +1620,14 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
       return omp_null_allocator;
     }
   }
+#if KMP_PLACED_ALLOC
+  // HBW memory is left to memkind, and so is interleaving when memkind can do
+  // it; everything else that asks for placement is placed by the runtime
+  if (ms != omp_high_bw_mem_space && __kmp_placed_supported(al) &&
+      !(al->memkind == mk_interleave && mk_interleave)) {
+    al->placed = true;
+  }
+#endif
   return (omp_allocator_handle_t)al;
 }
 
@@ -1442,6 +1654,32 @@ typedef struct kmp_mem_desc { // Memory block descriptor
 } kmp_mem_desc_t;
 static int alignment = sizeof(void *); // let's align to pointer size
 
+// Allocates the block of a custom allocator
+static void *__kmp_al_alloc(int gtid, kmp_allocator_t *al, size_t size) {
+#if KMP_PLACED_ALLOC
+  if (__kmp_use_placed(al, size))
+    return __kmp_placed_alloc(__kmp_thread_from_gtid(gtid), al, size);
+#endif
+  if (__kmp_memkind_available)
+    return kmp_mk_alloc(*al->memkind, size);
+  return __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), size);
+}
+
+// Frees the block of a custom allocator allocated by __kmp_al_alloc
+static void __kmp_al_free(int gtid, kmp_allocator_t *al, void *ptr,
+                          size_t size) {
+#if KMP_PLACED_ALLOC
+  if (__kmp_use_placed(al, size)) {
+    __kmp_placed_free(__kmp_thread_from_gtid(gtid), al, ptr, size);
+    return;
+  }
+#endif
+  if (__kmp_memkind_available)
+    kmp_mk_free(*al->memkind, ptr);
+  else
+    __kmp_thread_free(__kmp_thread_from_gtid(gtid), ptr);
+}
+
 void *__kmpc_alloc(int gtid, size_t size, omp_allocator_handle_t allocator) {
   void *ptr = NULL;
   kmp_allocator_t *al;
@@ -1490,7 +1728,7 @@ void *__kmpc_alloc(int gtid, size_t size, omp_allocator_handle_t allocator) {
         } // else ptr == NULL;
       } else {
         // pool has enough space
-        ptr = kmp_mk_alloc(*al->memkind, desc.size_a);
+        ptr = __kmp_al_alloc(gtid, al, desc.size_a);
         if (ptr == NULL) {
           if (al->fb == OMP_ATV_DEFAULT_MEM_FB) {
             al = (kmp_allocator_t *)omp_default_mem_alloc;
@@ -1506,7 +1744,7 @@ void *__kmpc_alloc(int gtid, size_t size, omp_allocator_handle_t allocator) {
       }
     } else {
       // custom allocator, pool size not requested
-      ptr = kmp_mk_alloc(*al->memkind, desc.size_a);
+      ptr = __kmp_al_alloc(gtid, al, desc.size_a);
       if (ptr == NULL) {
         if (al->fb == OMP_ATV_DEFAULT_MEM_FB) {
           al = (kmp_allocator_t *)omp_default_mem_alloc;
@@ -1546,16 +1784,36 @@ void *__kmpc_alloc(int gtid, size_t size, omp_allocator_handle_t allocator) {
       } // else ptr == NULL;
     } else {
       // pool has enough space
-      ptr = __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), desc.size_a);
+      ptr = __kmp_al_alloc(gtid, al, desc.size_a);
       if (ptr == NULL && al->fb == OMP_ATV_ABORT_FB) {
         KMP_ASSERT(0); // abort fallback requested
+      } else if (ptr == NULL && al->placed) {
+        // placed pages are gone, the internal alloc may still succeed
+        if (al->fb == OMP_ATV_DEFAULT_MEM_FB) {
+          al = (kmp_allocator_t *)omp_default_mem_alloc;
+          ptr = __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), desc.size_a);
+        } else if (al->fb == OMP_ATV_ALLOCATOR_FB) {
+          KMP_ASSERT(al != al->fb_data);
+          al = al->fb_data;
+          return __kmpc_alloc(gtid, size, (omp_allocator_handle_t)al);
+        }
       } // no sense to look for another fallback because of same internal alloc
     }
   } else {
     // custom allocator, pool size not requested
-    ptr = __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), desc.size_a);
+    ptr = __kmp_al_alloc(gtid, al, desc.size_a);
     if (ptr == NULL && al->fb == OMP_ATV_ABORT_FB) {
       KMP_ASSERT(0); // abort fallback requested
+    } else if (ptr == NULL && al->placed) {
+      // placed pages are gone, the internal alloc may still succeed
+      if (al->fb == OMP_ATV_DEFAULT_MEM_FB) {
+        al = (kmp_allocator_t *)omp_default_mem_alloc;
+        ptr = __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), desc.size_a);
+      } else if (al->fb == OMP_ATV_ALLOCATOR_FB) {
+        KMP_ASSERT(al != al->fb_data);
+        al = al->fb_data;
+        return __kmpc_alloc(gtid, size, (omp_allocator_handle_t)al);
+      }
     } // no sense to look for another fallback because of same internal alloc
   }
   KE_TRACE(10, ("__kmpc_alloc: T#%d %p=alloc(%d)\n", gtid, ptr, desc.size_a));
@@ -1615,7 +1873,7 @@ void __kmpc_free(int gtid, void *ptr, const omp_allocator_handle_t allocator) {
         (void)used; // to suppress compiler warning
         KMP_DEBUG_ASSERT(used >= desc.size_a);
       }
-      kmp_mk_free(*al->memkind, desc.ptr_alloc);
+      __kmp_al_free(gtid, al, desc.ptr_alloc, desc.size_a);
     }
   } else {
     if (oal > kmp_max_mem_alloc && al->pool_size > 0) {
@@ -1624,7 +1882,10 @@ void __kmpc_free(int gtid, void *ptr, const omp_allocator_handle_t allocator) {
       (void)used; // to suppress compiler warning
       KMP_DEBUG_ASSERT(used >= desc.size_a);
     }
-    __kmp_thread_free(__kmp_thread_from_gtid(gtid), desc.ptr_alloc);
+    if (oal > kmp_max_mem_alloc)
+      __kmp_al_free(gtid, al, desc.ptr_alloc, desc.size_a);
+    else
+      __kmp_thread_free(__kmp_thread_from_gtid(gtid), desc.ptr_alloc);
   }
   KE_TRACE(10, ("__kmpc_free: T#%d freed %p (%p)\n", gtid, desc.ptr_alloc,
                 allocator));
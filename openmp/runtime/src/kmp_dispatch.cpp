@@ -759,6 +759,132 @@ void __kmp_dispatch_free_hierarchies(kmp_team_t *team) {
 }
 #endif
 
+/* Adaptive schedule(auto): every loop site (ident_t) tries each candidate
+   schedule in turn, then keeps the one with the smallest time per iteration.
+   The times are refreshed while the site runs its best schedule and all the
+   candidates are tried again every KMP_ADAPTIVE_RETRY invocations, so a site
+   follows the changes of its workload. Teams that run the same site at once
+   may race on its statistics, which only perturbs the measurements. */
+#define KMP_ADAPTIVE_SITES 256 // must be a power of two
+#define KMP_ADAPTIVE_RETRY 256
+enum kmp_adaptive_choice {
+  adaptive_static = 0, // balanced static partition
+  adaptive_dynamic_coarse, // dynamic, 8 chunks per thread
+  adaptive_dynamic_fine, // dynamic, 32 chunks per thread
+  adaptive_guided,
+  adaptive_choices, // number of candidates
+  adaptive_none = adaptive_choices // no site available, use __kmp_auto
+};
+
+typedef struct kmp_adaptive_site {
+  ident_t *volatile loc;
+  kmp_uint32 invocations;
+  kmp_int32 best;
+  kmp_uint64 cost[adaptive_choices]; // time per 1024 iterations, 0 = unknown
+} kmp_adaptive_site_t;
+
+static kmp_adaptive_site_t __kmp_adaptive_sites[KMP_ADAPTIVE_SITES];
+
+// Finds the site of loc, adding it when it is new
+static kmp_adaptive_site_t *__kmp_adaptive_find(ident_t *loc) {
+  kmp_uintptr_t h = (kmp_uintptr_t)loc;
+  h = (h >> 4) ^ (h >> 12);
+  for (int i = 0; i < KMP_ADAPTIVE_SITES; ++i) {
+    kmp_adaptive_site_t *site =
+        &__kmp_adaptive_sites[(h + i) & (KMP_ADAPTIVE_SITES - 1)];
+    ident_t *cur = site->loc;
+    if (cur == loc)
+      return site;
+    if (cur == NULL &&
+        (KMP_COMPARE_AND_STORE_PTR(&site->loc, NULL, loc) || site->loc == loc))
+      return site;
+  }
+  return NULL; // table is full
+}
+
+// The choice shared by the team keeps the site too, as the ident_t passed when
+// the loop ends need not be the one passed when it starts
+#define KMP_ADAPTIVE_CODE(site, choice) ((((site) + 1) << 8) | ((choice) + 1))
+#define KMP_ADAPTIVE_CODE_SITE(code) (((code) >> 8) - 1)
+#define KMP_ADAPTIVE_CODE_CHOICE(code) (((code)&0xff) - 1)
+
+// Picks the schedule of the next invocation of the loop at loc
+static kmp_int32 __kmp_adaptive_choose(ident_t *loc) {
+  kmp_adaptive_site_t *site = __kmp_adaptive_find(loc);
+  if (site == NULL)
+    return KMP_ADAPTIVE_CODE(-1, adaptive_none);
+  kmp_int32 choice;
+  kmp_uint32 phase = site->invocations++ % KMP_ADAPTIVE_RETRY;
+  if (phase < adaptive_choices)
+    choice = phase;
+  else
+    choice = site->best;
+  return KMP_ADAPTIVE_CODE((kmp_int32)(site - __kmp_adaptive_sites), choice);
+}
+
+// Accounts the time of the loop invocation that just completed
+static void __kmp_adaptive_record(kmp_int32 code, kmp_uint64 start,
+                                  kmp_uint64 tc) {
+  kmp_adaptive_site_t *site;
+  kmp_int32 choice = KMP_ADAPTIVE_CODE_CHOICE(code);
+  kmp_uint64 cost, now = KMP_NOW();
+  if (KMP_ADAPTIVE_CODE_SITE(code) < 0 || choice >= adaptive_choices ||
+      start == 0 || tc == 0 || now <= start)
+    return;
+  site = &__kmp_adaptive_sites[KMP_ADAPTIVE_CODE_SITE(code)];
+  cost = (now - start) * 1024 / tc;
+  if (cost == 0)
+    cost = 1;
+  if (site->cost[choice])
+    cost = (3 * site->cost[choice] + cost) / 4;
+  site->cost[choice] = cost;
+  kmp_int32 best = site->best;
+  for (kmp_int32 i = 0; i < adaptive_choices; ++i)
+    if (site->cost[i] &&
+        (!site->cost[best] || site->cost[i] < site->cost[best]))
+      best = i;
+  site->best = best;
+  KD_TRACE(100, ("__kmp_adaptive_record: loc %p choice %d cost "
+                 "%" KMP_UINT64_SPEC " best %d\n",
+                 site->loc, choice, cost, best));
+}
+
+// Maps the choice to the schedule and chunk of the loop
+template <typename T>
+static void __kmp_adaptive_schedule(kmp_int32 choice, T lb, T ub,
+                                    typename traits_t<T>::signed_t st,
+                                    T nproc, enum sched_type *schedule,
+                                    typename traits_t<T>::signed_t *chunk) {
+  typedef typename traits_t<T>::unsigned_t UT;
+  typedef typename traits_t<T>::signed_t ST;
+  UT tc = 0;
+  if (st > 0 && ub >= lb)
+    tc = (UT)(ub - lb) / (UT)st + 1;
+  else if (st < 0 && lb >= ub)
+    tc = (UT)(lb - ub) / (UT)(-st) + 1;
+  switch (choice) {
+  case adaptive_static:
+    *schedule = kmp_sch_static_balanced;
+    break;
+  case adaptive_dynamic_coarse:
+    *schedule = kmp_sch_dynamic_chunked;
+    *chunk = (ST)(tc / ((UT)nproc * 8));
+    break;
+  case adaptive_dynamic_fine:
+    *schedule = kmp_sch_dynamic_chunked;
+    *chunk = (ST)(tc / ((UT)nproc * 32));
+    break;
+  case adaptive_guided:
+    *schedule = kmp_sch_guided_chunked;
+    *chunk = KMP_DEFAULT_CHUNK;
+    break;
+  default:
+    return; // schedule stays as requested
+  }
+  if (*chunk <= 0)
+    *chunk = KMP_DEFAULT_CHUNK;
+}
+
 // UT - unsigned flavor of T, ST - signed flavor of T,
 // DBL - double if sizeof(T)==4, or long double if sizeof(T)==8
 template <typename T>
@@ -876,6 +1002,34 @@ __kmp_dispatch_init(ident_t *loc, int gtid, enum sched_type schedule, T lb,
         &team->t.t_disp_buffer[my_buffer_index % __kmp_dispatch_num_buffers]);
     KD_TRACE(10, ("__kmp_dispatch_init: T#%d my_buffer_index:%d\n", gtid,
                   my_buffer_index));
+
+    enum sched_type base = SCHEDULE_WITHOUT_MODIFIERS(schedule);
+    if (base == kmp_sch_runtime)
+      base = SCHEDULE_WITHOUT_MODIFIERS(team->t.t_sched.r_sched_type);
+    if (__kmp_auto_adaptive && loc != NULL && base == kmp_sch_auto
+#if KMP_USE_HIER_SCHED
+        && !pr->flags.use_hier
+#endif
+        ) {
+      // All threads of the team must run the same schedule, so the first one
+      // to get the buffer picks it for the others
+      kmp_int32 code;
+      __kmp_wait<kmp_uint32>(&sh->buffer_index, my_buffer_index,
+                             __kmp_eq<kmp_uint32> USE_ITT_BUILD_ARG(NULL));
+      code = sh->adaptive_choice;
+      if (code == 0) {
+        code = __kmp_adaptive_choose(loc);
+        if (KMP_COMPARE_AND_STORE_ACQ32(&sh->adaptive_choice, 0, code))
+          sh->adaptive_start = KMP_NOW();
+        else
+          code = sh->adaptive_choice;
+      }
+      __kmp_adaptive_schedule<T>(KMP_ADAPTIVE_CODE_CHOICE(code), lb, ub, st,
+                                 (T)th->th.th_team_nproc, &schedule, &chunk);
+      KD_TRACE(100, ("__kmp_dispatch_init: T#%d adaptive choice:%d "
+                     "schedule:%d\n",
+                     gtid, KMP_ADAPTIVE_CODE_CHOICE(code), schedule));
+    }
   }
 
   __kmp_dispatch_init_algorithm(loc, gtid, pr, schedule, lb, ub, st,
@@ -2094,6 +2248,13 @@ static int __kmp_dispatch_next(ident_t *loc, int gtid, kmp_int32 *p_last,
           }
         }
 #endif
+        if (sh->adaptive_choice) {
+          __kmp_adaptive_record(sh->adaptive_choice, sh->adaptive_start,
+                                pr->u.p.tc);
+          sh->adaptive_choice = 0;
+          sh->adaptive_start = 0;
+        }
+
         /* NOTE: release this buffer to be reused */
 
         KMP_MB(); /* Flush all pending memory write invalidates.  */
@@ -179,6 +179,8 @@ template <typename T> struct dispatch_shared_info_template {
 #if KMP_USE_HIER_SCHED
   kmp_hier_t<T> *hier;
 #endif
+  volatile kmp_int32 adaptive_choice; // schedule of an adaptive loop, 0 = none
+  kmp_uint64 adaptive_start; // time the adaptive loop was started
 #if KMP_USE_HWLOC
   // When linking with libhwloc, the ORDERED EPCC test slowsdown on big
   // machines (> 48 cores). Performance analysis showed that a cache thrash
@@ -128,6 +128,7 @@ int __kmp_dflt_team_nth_ub = 0;
 int __kmp_tp_capacity = 0;
 int __kmp_tp_cached = 0;
 int __kmp_dispatch_num_buffers = KMP_DFLT_DISP_NUM_BUFF;
+int __kmp_auto_adaptive = TRUE;
 int __kmp_dflt_max_active_levels = 1; // Nesting off by default
 bool __kmp_dflt_max_active_levels_set = false; // Don't override set value
 #if KMP_NESTED_HOT_TEAMS
@@ -341,6 +342,10 @@ omp_memspace_handle_t const omp_low_lat_mem_space =
 KMP_BUILD_ASSERT(sizeof(kmp_tasking_flags_t) == 4);
 
 int __kmp_task_stealing_constraint = 1; /* Constrain task stealing by default */
+/* Steal from the threads on the same core, then package, first */
+int __kmp_task_steal_locality = TRUE;
+/* Threads with tasks looked for on each of those levels before going farther */
+int __kmp_task_steal_local_tries = 4;
 
 #ifdef DEBUG_SUSPEND
 int __kmp_suspend_count = 0;
@@ -1080,6 +1080,58 @@ static inline bool __kmp_is_queuing_lock_nestable(kmp_queuing_lock_t *lck) {
   return lck->lk.depth_locked != -1;
 }
 
+#if KMP_USE_FUTEX
+// A waiter spins for the spin budget of the lock, then sleeps on a futex
+// until the releasing thread hands the lock over. The budget follows the
+// waits that a short spin covers, so the waiters of a lock held for long, or
+// that many threads queue on, soon stop burning their cores, and those of a
+// lock held briefly never pay for a system call.
+#define KMP_QUEUING_LOCK_SLEEPING 2
+#define KMP_QUEUING_LOCK_MIN_SPINS (1 << 6)
+#define KMP_QUEUING_LOCK_INIT_SPINS (1 << 10)
+#define KMP_QUEUING_LOCK_MAX_SPINS (1 << 16)
+
+static void __kmp_wait_queuing_lock(kmp_queuing_lock_t *lck,
+                                    volatile kmp_uint32 *spin_here_p,
+                                    kmp_int32 gtid) {
+  kmp_uint32 budget = lck->lk.spin_budget;
+  kmp_uint32 spins = 0;
+
+  if (budget < KMP_QUEUING_LOCK_MIN_SPINS)
+    budget = KMP_QUEUING_LOCK_MIN_SPINS;
+  KMP_FSYNC_SPIN_INIT(lck, CCAST(kmp_uint32 *, spin_here_p));
+  while (TCR_4(*spin_here_p)) {
+    KMP_FSYNC_SPIN_PREPARE(lck);
+    if (spins < budget) {
+      ++spins;
+      KMP_YIELD_OVERSUB();
+      continue;
+    }
+    // Tell the releasing thread to wake this one up.
+    if (!KMP_COMPARE_AND_STORE_ACQ32(RCAST(volatile kmp_int32 *, spin_here_p),
+                                     TRUE, KMP_QUEUING_LOCK_SLEEPING) &&
+        TCR_4(*spin_here_p) != KMP_QUEUING_LOCK_SLEEPING)
+      continue;
+    KA_TRACE(1000, ("__kmp_wait_queuing_lock: lck:%p, T#%d sleeping after %u "
+                    "spins\n",
+                    lck, gtid, spins));
+    syscall(__NR_futex, spin_here_p, FUTEX_WAIT, KMP_QUEUING_LOCK_SLEEPING,
+            NULL, NULL, 0);
+    spins = KMP_QUEUING_LOCK_MAX_SPINS + 1;
+  }
+  KMP_FSYNC_SPIN_ACQUIRED(lck);
+
+  // This thread owns the lock now, so the updates of the budget do not race.
+  if (spins > KMP_QUEUING_LOCK_MAX_SPINS)
+    budget -= budget >> 3;
+  else if (2 * spins > budget)
+    budget += (2 * spins - budget) >> 3;
+  if (budget > KMP_QUEUING_LOCK_MAX_SPINS)
+    budget = KMP_QUEUING_LOCK_MAX_SPINS;
+  lck->lk.spin_budget = budget;
+}
+#endif // KMP_USE_FUTEX
+
 /* Acquire a lock using a the queuing lock implementation */
 template <bool takeTime>
 /* [TLW] The unused template above is left behind because of what BEB believes
@@ -1237,8 +1289,12 @@ __kmp_acquire_queuing_lock_timed_template(kmp_queuing_lock_t *lck,
                 lck, gtid));
 
       KMP_MB();
-      // ToDo: Use __kmp_wait_sleep or similar when blocktime != inf
-      KMP_WAIT(spin_here_p, FALSE, KMP_EQ, lck);
+#if KMP_USE_FUTEX
+      if (__kmp_dflt_blocktime != KMP_MAX_BLOCKTIME)
+        __kmp_wait_queuing_lock(lck, spin_here_p, gtid);
+      else
+#endif
+        KMP_WAIT(spin_here_p, FALSE, KMP_EQ, lck);
 
 #ifdef DEBUG_QUEUING_LOCKS
       TRACE_LOCK(gtid + 1, "acq spin");
@@ -1477,7 +1533,15 @@ int __kmp_release_queuing_lock(kmp_queuing_lock_t *lck, kmp_int32 gtid) {
 
       KMP_MB();
       /* reset spin value */
+#if KMP_USE_FUTEX
+      if (KMP_XCHG_FIXED32(RCAST(volatile kmp_int32 *,
+                                 &head_thr->th.th_spin_here),
+                           FALSE) == KMP_QUEUING_LOCK_SLEEPING)
+        syscall(__NR_futex, &head_thr->th.th_spin_here, FUTEX_WAKE, 1, NULL,
+                NULL, 0);
+#else
       head_thr->th.th_spin_here = FALSE;
+#endif
 
       KA_TRACE(1000, ("__kmp_release_queuing_lock: lck:%p, T#%d exiting: after "
                       "dequeuing\n",
@@ -1527,6 +1591,9 @@ void __kmp_init_queuing_lock(kmp_queuing_lock_t *lck) {
   lck->lk.now_serving = 0;
   lck->lk.owner_id = 0; // no thread owns the lock.
   lck->lk.depth_locked = -1; // >= 0 for nestable locks, -1 for simple locks.
+#if KMP_USE_FUTEX
+  lck->lk.spin_budget = KMP_QUEUING_LOCK_INIT_SPINS;
+#endif
   lck->lk.initialized = lck;
 
   KA_TRACE(1000, ("__kmp_init_queuing_lock: lock %p initialized\n", lck));
@@ -375,6 +375,8 @@ struct kmp_base_queuing_lock {
   kmp_int32 depth_locked; // depth locked, for nested locks only
 
   kmp_lock_flags_t flags; // lock specifics, e.g. critical section lock
+
+  kmp_uint32 spin_budget; // spins of a waiter before it sleeps
 };
 
 typedef struct kmp_base_queuing_lock kmp_base_queuing_lock_t;
@@ -6052,6 +6052,10 @@ static void __kmp_reap_thread(kmp_info_t *thread, int is_root) {
   }
 #endif
 
+#if OMP_50_ENABLED
+  __kmp_free_placed_memory(thread);
+#endif
+
 #if KMP_AFFINITY_SUPPORTED
   if (thread->th.th_affin_mask != NULL) {
     KMP_CPU_FREE(thread->th.th_affin_mask);
@@ -1197,6 +1197,32 @@ static void __kmp_stg_print_task_stealing(kmp_str_buf_t *buffer,
   __kmp_stg_print_int(buffer, name, __kmp_task_stealing_constraint);
 } // __kmp_stg_print_task_stealing
 
+// -----------------------------------------------------------------------------
+// KMP_TASK_STEAL_LOCALITY, KMP_TASK_STEAL_LOCAL_TRIES
+
+static void __kmp_stg_parse_task_steal_locality(char const *name,
+                                                char const *value, void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_task_steal_locality);
+} // __kmp_stg_parse_task_steal_locality
+
+static void __kmp_stg_print_task_steal_locality(kmp_str_buf_t *buffer,
+                                                char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_task_steal_locality);
+} // __kmp_stg_print_task_steal_locality
+
+static void __kmp_stg_parse_task_steal_local_tries(char const *name,
+                                                   char const *value,
+                                                   void *data) {
+  __kmp_stg_parse_int(name, value, 0, KMP_MAX_NTH,
+                      &__kmp_task_steal_local_tries);
+} // __kmp_stg_parse_task_steal_local_tries
+
+static void __kmp_stg_print_task_steal_local_tries(kmp_str_buf_t *buffer,
+                                                   char const *name,
+                                                   void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_task_steal_local_tries);
+} // __kmp_stg_print_task_steal_local_tries
+
 static void __kmp_stg_parse_max_active_levels(char const *name,
                                               char const *value, void *data) {
   kmp_uint64 tmp_dflt = 0;
@@ -1326,6 +1352,18 @@ static void __kmp_stg_print_disp_buffers(kmp_str_buf_t *buffer,
   __kmp_stg_print_int(buffer, name, __kmp_dispatch_num_buffers);
 } // __kmp_stg_print_disp_buffers
 
+// -----------------------------------------------------------------------------
+// KMP_AUTO_ADAPTIVE
+static void __kmp_stg_parse_auto_adaptive(char const *name, char const *value,
+                                          void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_auto_adaptive);
+} // __kmp_stg_parse_auto_adaptive
+
+static void __kmp_stg_print_auto_adaptive(kmp_str_buf_t *buffer,
+                                          char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_auto_adaptive);
+} // __kmp_stg_print_auto_adaptive
+
 #if KMP_NESTED_HOT_TEAMS
 // -----------------------------------------------------------------------------
 // KMP_HOT_TEAMS_MAX_LEVEL, KMP_HOT_TEAMS_MODE
@@ -4791,6 +4829,10 @@ static kmp_setting_t __kmp_stg_table[] = {
      0},
     {"KMP_TASK_STEALING_CONSTRAINT", __kmp_stg_parse_task_stealing,
      __kmp_stg_print_task_stealing, NULL, 0, 0},
+    {"KMP_TASK_STEAL_LOCALITY", __kmp_stg_parse_task_steal_locality,
+     __kmp_stg_print_task_steal_locality, NULL, 0, 0},
+    {"KMP_TASK_STEAL_LOCAL_TRIES", __kmp_stg_parse_task_steal_local_tries,
+     __kmp_stg_print_task_steal_local_tries, NULL, 0, 0},
     {"OMP_MAX_ACTIVE_LEVELS", __kmp_stg_parse_max_active_levels,
      __kmp_stg_print_max_active_levels, NULL, 0, 0},
 #if OMP_40_ENABLED
@@ -4815,6 +4857,8 @@ static kmp_setting_t __kmp_stg_table[] = {
      __kmp_stg_print_wait_policy, NULL, 0, 0},
     {"KMP_DISP_NUM_BUFFERS", __kmp_stg_parse_disp_buffers,
      __kmp_stg_print_disp_buffers, NULL, 0, 0},
+    {"KMP_AUTO_ADAPTIVE", __kmp_stg_parse_auto_adaptive,
+     __kmp_stg_print_auto_adaptive, NULL, 0, 0},
 #if KMP_NESTED_HOT_TEAMS
     {"KMP_HOT_TEAMS_MAX_LEVEL", __kmp_stg_parse_hot_teams_level,
      __kmp_stg_print_hot_teams_level, NULL, 0, 0},
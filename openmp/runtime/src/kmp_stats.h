@@ -157,6 +157,7 @@ enum stats_state_e {
   macro (OMP_task_join_bar, 0, arg)                                            \
   macro (OMP_task_plain_bar, 0, arg)                                           \
   macro (OMP_taskloop_scheduling, 0, arg)                                      \
+  macro (OMP_task_dependences, 0, arg)                                         \
   macro (OMP_plain_barrier, stats_flags_e::logEvent, arg)                      \
   macro (OMP_idle, stats_flags_e::logEvent, arg)                               \
   macro (OMP_fork_barrier, stats_flags_e::logEvent, arg)                       \
@@ -210,6 +211,8 @@ enum stats_state_e {
 //                           construct
 // OMP_taskloop_scheduling -- Time spent scheduling tasks inside a taskloop
 //                            construct
+// OMP_task_dependences   -- Time spent resolving the dependences of a new task
+//                           or of a taskwait with depend clauses
 // OMP_plain_barrier      -- Time spent in a #pragma omp barrier construct or
 //                           inside implicit barrier at end of worksharing
 //                           construct
@@ -14,6 +14,7 @@
 
 #include "kmp.h"
 #include "kmp_io.h"
+#include "kmp_stats.h"
 #include "kmp_wait_release.h"
 #include "kmp_taskdeps.h"
 #if OMPT_SUPPORT
@@ -54,12 +55,29 @@ static inline kmp_depnode_t *__kmp_node_ref(kmp_depnode_t *node) {
   return node;
 }
 
-enum { KMP_DEPHASH_OTHER_SIZE = 97, KMP_DEPHASH_MASTER_SIZE = 997 };
+// Initial number of slots; must be powers of two.
+enum { KMP_DEPHASH_OTHER_SIZE = 64, KMP_DEPHASH_MASTER_SIZE = 1024 };
 
-static inline kmp_int32 __kmp_dephash_hash(kmp_intptr_t addr, size_t hsize) {
-  // TODO alternate to try: set = (((Addr64)(addrUsefulBits * 9.618)) %
-  // m_num_sets );
-  return ((addr >> 6) ^ (addr >> 2)) % hsize;
+static inline size_t __kmp_dephash_hash(kmp_intptr_t addr, size_t hsize) {
+  // The table size is a power of two, so mix the high bits of the address,
+  // which tell the dependences apart, into the low bits the mask keeps.
+  kmp_uint64 h = (kmp_uint64)addr * 0x9E3779B97F4A7C15ULL;
+  return (size_t)(h ^ (h >> 32)) & (hsize - 1);
+}
+
+static kmp_dephash_slot_t *__kmp_dephash_alloc_slots(kmp_info_t *thread,
+                                                     size_t h_size) {
+  kmp_dephash_slot_t *slots;
+#if USE_FAST_MEMORY
+  slots = (kmp_dephash_slot_t *)__kmp_fast_allocate(
+      thread, h_size * sizeof(kmp_dephash_slot_t));
+#else
+  slots = (kmp_dephash_slot_t *)__kmp_thread_malloc(
+      thread, h_size * sizeof(kmp_dephash_slot_t));
+#endif
+  for (size_t i = 0; i < h_size; i++)
+    slots[i].entry = 0;
+  return slots;
 }
 
 static kmp_dephash_t *__kmp_dephash_create(kmp_info_t *thread,
@@ -73,63 +91,91 @@ static kmp_dephash_t *__kmp_dephash_create(kmp_info_t *thread,
   else
     h_size = KMP_DEPHASH_OTHER_SIZE;
 
-  kmp_int32 size =
-      h_size * sizeof(kmp_dephash_entry_t *) + sizeof(kmp_dephash_t);
-
 #if USE_FAST_MEMORY
-  h = (kmp_dephash_t *)__kmp_fast_allocate(thread, size);
+  h = (kmp_dephash_t *)__kmp_fast_allocate(thread, sizeof(kmp_dephash_t));
 #else
-  h = (kmp_dephash_t *)__kmp_thread_malloc(thread, size);
+  h = (kmp_dephash_t *)__kmp_thread_malloc(thread, sizeof(kmp_dephash_t));
 #endif
   h->size = h_size;
+  h->nelements = 0;
 
 #ifdef KMP_DEBUG
-  h->nelements = 0;
   h->nconflicts = 0;
 #endif
-  h->buckets = (kmp_dephash_entry **)(h + 1);
-
-  for (size_t i = 0; i < h_size; i++)
-    h->buckets[i] = 0;
+  h->slots = __kmp_dephash_alloc_slots(thread, h_size);
 
   return h;
 }
 
+// Double the number of slots, moving the entries to their slots in the new
+// table. Only the thread of the task that owns the table accesses it.
+static void __kmp_dephash_grow(kmp_info_t *thread, kmp_dephash_t *h) {
+  size_t old_size = h->size;
+  kmp_dephash_slot_t *old_slots = h->slots;
+
+  h->size = old_size * 2;
+  h->slots = __kmp_dephash_alloc_slots(thread, h->size);
+  for (size_t i = 0; i < old_size; i++) {
+    if (!old_slots[i].entry)
+      continue;
+    size_t j = __kmp_dephash_hash(old_slots[i].addr, h->size);
+    while (h->slots[j].entry)
+      j = (j + 1) & (h->size - 1);
+    h->slots[j] = old_slots[i];
+  }
+  KA_TRACE(40, ("__kmp_dephash_grow: T#%d grew dependence hash %p to %d "
+                "slots for %d entries\n",
+                __kmp_gtid_from_thread(thread), h, (int)h->size,
+                (int)h->nelements));
+
+#if USE_FAST_MEMORY
+  __kmp_fast_free(thread, old_slots);
+#else
+  __kmp_thread_free(thread, old_slots);
+#endif
+}
+
 #define ENTRY_LAST_INS 0
 #define ENTRY_LAST_MTXS 1
 
 static kmp_dephash_entry *
 __kmp_dephash_find(kmp_info_t *thread, kmp_dephash_t *h, kmp_intptr_t addr) {
-  kmp_int32 bucket = __kmp_dephash_hash(addr, h->size);
-
-  kmp_dephash_entry_t *entry;
-  for (entry = h->buckets[bucket]; entry; entry = entry->next_in_bucket)
-    if (entry->addr == addr)
-      break;
+  size_t slot = __kmp_dephash_hash(addr, h->size);
+
+  for (; h->slots[slot].entry; slot = (slot + 1) & (h->size - 1))
+    if (h->slots[slot].addr == addr)
+      return h->slots[slot].entry;
+
+  // Keep the table at most half full, so that lookups probe few slots.
+  if (2 * (h->nelements + 1) > h->size) {
+    __kmp_dephash_grow(thread, h);
+    slot = __kmp_dephash_hash(addr, h->size);
+    while (h->slots[slot].entry)
+      slot = (slot + 1) & (h->size - 1);
+  }
 
-  if (entry == NULL) {
 // create entry. This is only done by one thread so no locking required
+  kmp_dephash_entry_t *entry;
 #if USE_FAST_MEMORY
-    entry = (kmp_dephash_entry_t *)__kmp_fast_allocate(
-        thread, sizeof(kmp_dephash_entry_t));
+  entry = (kmp_dephash_entry_t *)__kmp_fast_allocate(
+      thread, sizeof(kmp_dephash_entry_t));
 #else
-    entry = (kmp_dephash_entry_t *)__kmp_thread_malloc(
-        thread, sizeof(kmp_dephash_entry_t));
+  entry = (kmp_dephash_entry_t *)__kmp_thread_malloc(
+      thread, sizeof(kmp_dephash_entry_t));
 #endif
-    entry->addr = addr;
-    entry->last_out = NULL;
-    entry->last_ins = NULL;
-    entry->last_mtxs = NULL;
-    entry->last_flag = ENTRY_LAST_INS;
-    entry->mtx_lock = NULL;
-    entry->next_in_bucket = h->buckets[bucket];
-    h->buckets[bucket] = entry;
+  entry->addr = addr;
+  entry->last_out = NULL;
+  entry->last_ins = NULL;
+  entry->last_mtxs = NULL;
+  entry->last_flag = ENTRY_LAST_INS;
+  entry->mtx_lock = NULL;
+  h->slots[slot].addr = addr;
+  h->slots[slot].entry = entry;
+  h->nelements++;
 #ifdef KMP_DEBUG
-    h->nelements++;
-    if (entry->next_in_bucket)
-      h->nconflicts++;
+  if (slot != __kmp_dephash_hash(addr, h->size))
+    h->nconflicts++;
 #endif
-  }
   return entry;
 }
 
@@ -359,6 +405,7 @@ static bool __kmp_check_deps(kmp_int32 gtid, kmp_depnode_t *node,
                              kmp_depend_info_t *dep_list,
                              kmp_int32 ndeps_noalias,
                              kmp_depend_info_t *noalias_dep_list) {
+  KMP_TIME_PARTITIONED_BLOCK(OMP_task_dependences);
   int i, n_mtxs = 0;
 #if KMP_DEBUG
   kmp_taskdata_t *taskdata = KMP_TASK_TO_TASKDATA(task);
@@ -56,33 +56,33 @@ static inline void __kmp_depnode_list_free(kmp_info_t *thread,
 static inline void __kmp_dephash_free_entries(kmp_info_t *thread,
                                               kmp_dephash_t *h) {
   for (size_t i = 0; i < h->size; i++) {
-    if (h->buckets[i]) {
-      kmp_dephash_entry_t *next;
-      for (kmp_dephash_entry_t *entry = h->buckets[i]; entry; entry = next) {
-        next = entry->next_in_bucket;
-        __kmp_depnode_list_free(thread, entry->last_ins);
-        __kmp_depnode_list_free(thread, entry->last_mtxs);
-        __kmp_node_deref(thread, entry->last_out);
-        if (entry->mtx_lock) {
-          __kmp_destroy_lock(entry->mtx_lock);
-          __kmp_free(entry->mtx_lock);
-        }
+    kmp_dephash_entry_t *entry = h->slots[i].entry;
+    if (entry) {
+      __kmp_depnode_list_free(thread, entry->last_ins);
+      __kmp_depnode_list_free(thread, entry->last_mtxs);
+      __kmp_node_deref(thread, entry->last_out);
+      if (entry->mtx_lock) {
+        __kmp_destroy_lock(entry->mtx_lock);
+        __kmp_free(entry->mtx_lock);
+      }
 #if USE_FAST_MEMORY
-        __kmp_fast_free(thread, entry);
+      __kmp_fast_free(thread, entry);
 #else
-        __kmp_thread_free(thread, entry);
+      __kmp_thread_free(thread, entry);
 #endif
-      }
-      h->buckets[i] = 0;
+      h->slots[i].entry = 0;
     }
   }
+  h->nelements = 0;
 }
 
 static inline void __kmp_dephash_free(kmp_info_t *thread, kmp_dephash_t *h) {
   __kmp_dephash_free_entries(thread, h);
 #if USE_FAST_MEMORY
+  __kmp_fast_free(thread, h->slots);
   __kmp_fast_free(thread, h);
 #else
+  __kmp_thread_free(thread, h->slots);
   __kmp_thread_free(thread, h);
 #endif
 }
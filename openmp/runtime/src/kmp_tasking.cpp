@@ -2818,6 +2818,81 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
   return task;
 }
 
+#if KMP_AFFINITY_SUPPORTED && OMP_40_ENABLED
+// __kmp_init_steal_order: order the other threads of the team by the distance
+// of their places to the place of the calling thread.
+static void __kmp_init_steal_order(kmp_info_t *thread, kmp_int32 tid,
+                                   kmp_thread_data_t *threads_data,
+                                   kmp_int32 nthreads) {
+  kmp_thread_data_t *thread_data = &threads_data[tid];
+  if (thread_data->td.td_steal_order_size < nthreads - 1) {
+    if (thread_data->td.td_steal_order != NULL)
+      __kmp_free(thread_data->td.td_steal_order);
+    thread_data->td.td_steal_order =
+        (kmp_int32 *)__kmp_allocate((nthreads - 1) * sizeof(kmp_int32));
+    thread_data->td.td_steal_order_size = nthreads - 1;
+  }
+
+  kmp_int32 *order = thread_data->td.td_steal_order;
+  int place = thread->th.th_current_place;
+  kmp_int32 n = 0;
+  for (int distance = 0; distance <= 2; distance++) {
+    for (kmp_int32 i = 0; i < nthreads; i++) {
+      if (i == tid)
+        continue;
+      int victim_place = threads_data[i].td.td_thr->th.th_current_place;
+      if (__kmp_affinity_place_distance(place, victim_place) == distance)
+        order[n++] = i;
+    }
+    if (distance < 2)
+      thread_data->td.td_steal_level_end[distance] = n;
+  }
+  KA_TRACE(20, ("__kmp_init_steal_order: T#%d place %d: %d threads on the "
+                "same core, %d in the same package\n",
+                __kmp_gtid_from_thread(thread), place,
+                thread_data->td.td_steal_level_end[0],
+                thread_data->td.td_steal_level_end[1] -
+                    thread_data->td.td_steal_level_end[0]));
+}
+#endif
+
+// __kmp_find_near_victim: look for a thread with tasks among the threads on
+// the same core as the calling thread, then the same package, peeking at up to
+// __kmp_task_steal_local_tries of each, starting at a random one. Returns the
+// victim's tid, or -1 for a victim to be picked among all the threads.
+static kmp_int32 __kmp_find_near_victim(kmp_info_t *thread, kmp_int32 tid,
+                                        kmp_thread_data_t *threads_data,
+                                        kmp_int32 nthreads) {
+#if KMP_AFFINITY_SUPPORTED && OMP_40_ENABLED
+  if (!__kmp_task_steal_locality || __kmp_task_steal_local_tries <= 0 ||
+      !KMP_AFFINITY_CAPABLE() || thread->th.th_current_place < 0)
+    return -1;
+
+  kmp_thread_data_t *thread_data = &threads_data[tid];
+  if (thread_data->td.td_steal_level_end[0] < 0)
+    __kmp_init_steal_order(thread, tid, threads_data, nthreads);
+
+  kmp_int32 begin = 0;
+  for (int level = 0; level < 2; level++) {
+    kmp_int32 end = thread_data->td.td_steal_level_end[level];
+    kmp_int32 n = end - begin;
+    if (n > 0) {
+      kmp_int32 tries =
+          n < __kmp_task_steal_local_tries ? n : __kmp_task_steal_local_tries;
+      kmp_int32 start = __kmp_get_random(thread) % n;
+      for (kmp_int32 i = 0; i < tries; i++) {
+        kmp_int32 victim_tid =
+            thread_data->td.td_steal_order[begin + (start + i) % n];
+        if (TCR_4(threads_data[victim_tid].td.td_deque_ntasks) != 0)
+          return victim_tid;
+      }
+    }
+    begin = end;
+  }
+#endif
+  return -1;
+}
+
 // __kmp_execute_tasks_template: Choose and execute tasks until either the
 // condition is statisfied (return true) or there are none left (return false).
 //
@@ -2883,6 +2958,12 @@ static inline int __kmp_execute_tasks_template(
         }
         if (victim_tid != -1) { // found last victim
           asleep = 0;
+        } else if (!new_victim &&
+                   (victim_tid = __kmp_find_near_victim(
+                        thread, tid, threads_data, nthreads)) != -1) {
+          // a thread close by has tasks
+          other_thread = threads_data[victim_tid].td.td_thr;
+          asleep = 0;
         } else if (!new_victim) { // no recent steals and we haven't already
           // used a new victim; select a random thread
           do { // Find a different thread to steal work from.
@@ -3222,6 +3303,12 @@ static void __kmp_free_task_deque(kmp_thread_data_t *thread_data) {
     thread_data->td.td_deque = NULL;
     __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
   }
+#if KMP_AFFINITY_SUPPORTED && OMP_40_ENABLED
+  if (thread_data->td.td_steal_order != NULL) {
+    __kmp_free(thread_data->td.td_steal_order);
+    thread_data->td.td_steal_order = NULL;
+  }
+#endif
 
 #ifdef BUILD_TIED_TASK_STACK
   // GEH: Figure out what to do here for td_susp_tied_tasks
@@ -3331,6 +3418,10 @@ static int __kmp_realloc_task_threads_data(kmp_info_t *thread,
         // parallel region will exhibit the same behavior as previous region.
         thread_data->td.td_deque_last_stolen = -1;
       }
+#if KMP_AFFINITY_SUPPORTED && OMP_40_ENABLED
+      // The threads and their places may have changed as well
+      thread_data->td.td_steal_level_end[0] = -1;
+#endif
     }
 
     KMP_MB();
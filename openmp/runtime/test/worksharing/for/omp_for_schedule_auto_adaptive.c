@@ -0,0 +1,101 @@
+// RUN: %libomp-compile && %libomp-run 7
+// RUN: %libomp-run 1 && %libomp-run 2
+// RUN: env KMP_AUTO_ADAPTIVE=false %libomp-run 7
+// RUN: %libomp-compile -DMY_SCHEDULE=runtime && env OMP_SCHEDULE=auto %libomp-run 7
+// RUN: env OMP_SCHEDULE=auto %libomp-run 1
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+// schedule(auto) changes the schedule of each loop site from one invocation
+// to the next while it measures them. Every iteration must still run exactly
+// once whatever the schedule, including in the loops without a barrier, which
+// the threads start while others are in the previous loop.
+
+#ifndef MY_SCHEDULE
+# define MY_SCHEDULE auto
+#endif
+
+#define MAX_N 1000
+// Enough invocations of each site for it to try all the candidate schedules
+// again a few times
+#define NUM_CALLS 300
+#define NUM_LOOPS 4
+
+int a[MAX_N], b[MAX_N], c[MAX_N];
+
+// Makes the iterations uneven, differently from one call to the next, so that
+// the site doesn't settle on one schedule
+void work(int i, int call) {
+  int j;
+  volatile int x = 0;
+  int n = (call & 1) ? i % 16 : (MAX_N - i) % 4;
+  for (j = 0; j < n * 10; j++)
+    x++;
+}
+
+int test_omp_for_schedule_auto_adaptive(int call) {
+  int i;
+  int n = 100 + (call * 37) % (MAX_N - 100);
+
+  for (i = 0; i < MAX_N; i++) {
+    a[i] = 0;
+    b[i] = 0;
+    c[i] = 0;
+  }
+
+  #pragma omp parallel private(i)
+  {
+    int j;
+    for (j = 0; j < NUM_LOOPS; j++) {
+      #pragma omp for schedule(MY_SCHEDULE) nowait
+      for (i = 0; i < n; i++) {
+        work(i, call);
+        #pragma omp atomic
+        a[i]++;
+      }
+      #pragma omp for schedule(MY_SCHEDULE) nowait
+      for (i = n - 1; i >= 0; i -= 2) {
+        work(i, call + 1);
+        #pragma omp atomic
+        b[i]++;
+      }
+      #pragma omp for schedule(MY_SCHEDULE)
+      for (i = 0; i < n; i += 3) {
+        #pragma omp atomic
+        c[i]++;
+      }
+    }
+  }
+
+  for (i = 0; i < MAX_N; i++) {
+    int a_known = i < n ? NUM_LOOPS : 0;
+    int b_known = i < n && (n - 1 - i) % 2 == 0 ? NUM_LOOPS : 0;
+    int c_known = i < n && i % 3 == 0 ? NUM_LOOPS : 0;
+    if (a[i] != a_known || b[i] != b_known || c[i] != c_known) {
+      printf("call %d, n = %d: iteration %d ran a %d (should be %d), "
+             "b %d (should be %d), c %d (should be %d) times\n",
+             call, n, i, a[i], a_known, b[i], b_known, c[i], c_known);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  int call;
+  int num_failed = 0;
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s num_disp_buffers\n", argv[0]);
+    exit(1);
+  }
+  kmp_set_disp_num_buffers(atoi(argv[1]));
+
+  for (call = 0; call < NUM_CALLS; call++) {
+    if (!test_omp_for_schedule_auto_adaptive(call))
+      num_failed++;
+  }
+  return num_failed;
+}
@@ -0,0 +1,468 @@
+//===- ompt-prof.cpp - Profiling tool for the OpenMP runtime ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// libomp-prof is an OMPT tool. Loaded with OMP_TOOL_LIBRARIES=libomp-prof.so,
+// it measures the work, barrier waits and imbalance of every parallel region
+// and the explicit tasks of the program, and writes a summary at exit:
+//
+//   OMP_PROF_OUTPUT        file of the summary, stderr by default
+//   OMP_PROF_TRACE         file of a Chrome trace (chrome://tracing), none by
+//                          default
+//   OMP_PROF_SAMPLE        trace one parallel region in N, 1 by default
+//   OMP_PROF_TRACE_EVENTS  trace events kept per thread, 262144 by default
+//
+// Every thread only writes its own buffers, so the callbacks take no locks.
+// The buffers are merged when the runtime shuts down.
+//
+//===----------------------------------------------------------------------===//
+
+#include <omp-tools.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dlfcn.h>
+
+namespace {
+
+uint64_t getTime() {
+  struct timespec TS;
+  clock_gettime(CLOCK_MONOTONIC, &TS);
+  return (uint64_t)TS.tv_sec * 1000000000 + TS.tv_nsec;
+}
+
+enum EventKind : uint8_t { EK_Region, EK_Barrier, EK_Taskwait, EK_Task };
+
+struct TraceEvent {
+  const void *Codeptr;
+  uint64_t Begin;
+  uint64_t End;
+  EventKind Kind;
+};
+
+/// Statistics of one parallel region (by code address) on one thread.
+struct RegionStats {
+  uint64_t Calls = 0; // on the encountering thread only
+  uint64_t Wall = 0;  // on the encountering thread only
+  uint64_t Tasks = 0; // implicit tasks run by the thread
+  uint64_t Work = 0;  // time in the implicit tasks, out of barriers
+  uint64_t Wait = 0;  // time in the barriers inside the implicit tasks
+};
+
+/// Parallel region instance, allocated by the encountering thread.
+struct Region {
+  const void *Codeptr;
+  uint64_t Begin;
+  bool Traced;
+};
+
+/// Implicit task running on a thread.
+struct Frame {
+  RegionStats *Stats;
+  const void *Codeptr;
+  uint64_t Begin;
+  uint64_t Wait;       // completed waits
+  uint64_t WaitBegin;  // begin of the pending wait, 0 if none
+  TraceEvent LastWait; // the last completed wait, not traced yet
+  bool Traced;
+};
+
+struct ThreadData {
+  unsigned Id;
+  ThreadData *Next;
+  std::unordered_map<const void *, RegionStats> Regions;
+  std::vector<Frame> Frames;
+  std::vector<TraceEvent> Trace;
+  uint64_t Dropped = 0;
+  uint64_t SerialWait = 0; // waits outside of parallel regions
+  uint64_t TasksCreated = 0;
+  uint64_t TasksRun = 0;
+  uint64_t TaskTime = 0;
+  uint64_t TaskBegin = 0; // begin of the running explicit task, 0 if none
+};
+
+/// Marks the task data of the explicit tasks.
+const uint64_t ExplicitTask = 1;
+
+std::atomic<ThreadData *> Threads(nullptr);
+std::atomic<unsigned> NumThreads(0);
+std::atomic<uint64_t> NumRegions(0);
+uint64_t StartTime;
+uint64_t SampleRate = 1;
+size_t MaxTraceEvents = 262144;
+const char *TraceFile = nullptr;
+const char *OutputFile = nullptr;
+
+thread_local ThreadData *ThisThread = nullptr;
+
+ThreadData *getThread() {
+  if (ThisThread)
+    return ThisThread;
+  ThreadData *T = new ThreadData();
+  T->Id = NumThreads++;
+  T->Next = Threads.load(std::memory_order_relaxed);
+  while (!Threads.compare_exchange_weak(T->Next, T, std::memory_order_release,
+                                        std::memory_order_relaxed))
+    ;
+  ThisThread = T;
+  return T;
+}
+
+void addEvent(ThreadData *T, const void *Codeptr, uint64_t Begin, uint64_t End,
+              EventKind Kind) {
+  if (T->Trace.size() >= MaxTraceEvents) {
+    ++T->Dropped;
+    return;
+  }
+  T->Trace.push_back({Codeptr, Begin, End, Kind});
+}
+
+// Trace of the last wait, now known not to be the join barrier of the task
+void flushLastWait(ThreadData *T, Frame &F) {
+  if (F.Traced && F.LastWait.End)
+    addEvent(T, F.LastWait.Codeptr, F.LastWait.Begin, F.LastWait.End,
+             F.LastWait.Kind);
+  F.LastWait.End = 0;
+}
+
+// The implicit task ends when its join barrier starts: the runtime reports
+// the end of the join barrier of the workers only when they are woken up for
+// the next parallel region.
+void endFrame(ThreadData *T, Frame &F, uint64_t Now) {
+  uint64_t End = Now;
+  uint64_t Wait = F.Wait;
+  if (F.WaitBegin) {
+    End = F.WaitBegin;
+  } else if (F.LastWait.End) {
+    End = F.LastWait.Begin;
+    Wait -= F.LastWait.End - F.LastWait.Begin;
+  }
+  if (End < F.Begin)
+    End = F.Begin;
+  F.Stats->Tasks++;
+  F.Stats->Work += End - F.Begin > Wait ? End - F.Begin - Wait : 0;
+  F.Stats->Wait += Wait;
+  if (F.Traced)
+    addEvent(T, F.Codeptr, F.Begin, End, EK_Region);
+}
+
+void onThreadBegin(ompt_thread_t ThreadType, ompt_data_t *Data) {
+  getThread();
+}
+
+void onParallelBegin(ompt_data_t *EncounteringTaskData,
+                     const ompt_frame_t *EncounteringTaskFrame,
+                     ompt_data_t *ParallelData, uint32_t RequestedTeamSize,
+                     int Flags, const void *Codeptr) {
+  Region *R = new Region;
+  R->Codeptr = Codeptr;
+  R->Traced = TraceFile && NumRegions++ % SampleRate == 0;
+  R->Begin = getTime();
+  ParallelData->ptr = R;
+}
+
+void onParallelEnd(ompt_data_t *ParallelData,
+                   ompt_data_t *EncounteringTaskData, int Flags,
+                   const void *Codeptr) {
+  Region *R = static_cast<Region *>(ParallelData->ptr);
+  if (!R)
+    return;
+  RegionStats &S = getThread()->Regions[R->Codeptr];
+  S.Calls++;
+  S.Wall += getTime() - R->Begin;
+  delete R;
+  ParallelData->ptr = nullptr;
+}
+
+void onImplicitTask(ompt_scope_endpoint_t Endpoint, ompt_data_t *ParallelData,
+                    ompt_data_t *TaskData, unsigned int TeamSize,
+                    unsigned int ThreadNum, int Flags) {
+  if (Flags & ompt_task_initial)
+    return;
+  ThreadData *T = getThread();
+  if (Endpoint == ompt_scope_begin) {
+    Region *R = static_cast<Region *>(ParallelData->ptr);
+    Frame F;
+    F.Codeptr = R ? R->Codeptr : nullptr;
+    F.Traced = R ? R->Traced : false;
+    F.Stats = &T->Regions[F.Codeptr];
+    F.Wait = 0;
+    F.WaitBegin = 0;
+    F.LastWait.End = 0;
+    F.Begin = getTime();
+    T->Frames.push_back(F);
+  } else if (!T->Frames.empty()) {
+    endFrame(T, T->Frames.back(), getTime());
+    T->Frames.pop_back();
+  }
+}
+
+void onSyncRegionWait(ompt_sync_region_t Kind, ompt_scope_endpoint_t Endpoint,
+                      ompt_data_t *ParallelData, ompt_data_t *TaskData,
+                      const void *Codeptr) {
+  ThreadData *T = getThread();
+  uint64_t Now = getTime();
+  if (T->Frames.empty()) {
+    static thread_local uint64_t SerialWaitBegin;
+    if (Endpoint == ompt_scope_begin)
+      SerialWaitBegin = Now;
+    else if (SerialWaitBegin)
+      T->SerialWait += Now - SerialWaitBegin;
+    return;
+  }
+  Frame &F = T->Frames.back();
+  if (Endpoint == ompt_scope_begin) {
+    flushLastWait(T, F);
+    F.WaitBegin = Now;
+  } else if (F.WaitBegin) {
+    F.Wait += Now - F.WaitBegin;
+    F.LastWait.Codeptr = Codeptr;
+    F.LastWait.Begin = F.WaitBegin;
+    F.LastWait.End = Now;
+    F.LastWait.Kind = (Kind == ompt_sync_region_taskwait ||
+                       Kind == ompt_sync_region_taskgroup)
+                          ? EK_Taskwait
+                          : EK_Barrier;
+    F.WaitBegin = 0;
+  }
+}
+
+void onTaskCreate(ompt_data_t *EncounteringTaskData,
+                  const ompt_frame_t *EncounteringTaskFrame,
+                  ompt_data_t *NewTaskData, int Flags, int HasDependences,
+                  const void *Codeptr) {
+  if (!(Flags & ompt_task_explicit))
+    return;
+  NewTaskData->value = ExplicitTask;
+  getThread()->TasksCreated++;
+}
+
+void onTaskSchedule(ompt_data_t *PriorTaskData,
+                    ompt_task_status_t PriorTaskStatus,
+                    ompt_data_t *NextTaskData) {
+  ThreadData *T = getThread();
+  uint64_t Now = getTime();
+  if (T->TaskBegin) {
+    T->TaskTime += Now - T->TaskBegin;
+    if (!T->Frames.empty() && T->Frames.back().Traced)
+      addEvent(T, nullptr, T->TaskBegin, Now, EK_Task);
+    T->TaskBegin = 0;
+  }
+  if (PriorTaskData && PriorTaskData->value == ExplicitTask &&
+      PriorTaskStatus == ompt_task_complete)
+    T->TasksRun++;
+  if (NextTaskData && NextTaskData->value == ExplicitTask)
+    T->TaskBegin = Now;
+}
+
+std::string getName(const void *Codeptr) {
+  char Buf[64];
+  Dl_info Info;
+  if (!Codeptr)
+    return "<unknown>";
+  if (dladdr(Codeptr, &Info)) {
+    if (Info.dli_sname) {
+      snprintf(Buf, sizeof(Buf), "+0x%zx",
+               (size_t)((const char *)Codeptr - (const char *)Info.dli_saddr));
+      return std::string(Info.dli_sname) + Buf;
+    }
+    if (Info.dli_fname) {
+      const char *Base = strrchr(Info.dli_fname, '/');
+      snprintf(Buf, sizeof(Buf), "+0x%zx",
+               (size_t)((const char *)Codeptr - (const char *)Info.dli_fbase));
+      return std::string(Base ? Base + 1 : Info.dli_fname) + Buf;
+    }
+  }
+  snprintf(Buf, sizeof(Buf), "%p", Codeptr);
+  return Buf;
+}
+
+double toMsec(uint64_t Nsec) { return Nsec / 1e6; }
+
+struct RegionSummary {
+  const void *Codeptr;
+  RegionStats Total;
+  uint64_t MaxWork = 0;
+  unsigned NumThreads = 0;
+};
+
+void writeSummary(FILE *Out, const std::vector<ThreadData *> &All,
+                  uint64_t Elapsed) {
+  std::unordered_map<const void *, RegionSummary> Regions;
+  uint64_t TasksCreated = 0, TasksRun = 0, TaskTime = 0, SerialWait = 0;
+  uint64_t Dropped = 0;
+  for (ThreadData *T : All) {
+    for (auto &It : T->Regions) {
+      RegionSummary &R = Regions[It.first];
+      const RegionStats &S = It.second;
+      R.Codeptr = It.first;
+      R.Total.Calls += S.Calls;
+      R.Total.Wall += S.Wall;
+      R.Total.Tasks += S.Tasks;
+      R.Total.Work += S.Work;
+      R.Total.Wait += S.Wait;
+      if (S.Tasks) {
+        R.MaxWork = std::max(R.MaxWork, S.Work);
+        R.NumThreads++;
+      }
+    }
+    TasksCreated += T->TasksCreated;
+    TasksRun += T->TasksRun;
+    TaskTime += T->TaskTime;
+    SerialWait += T->SerialWait;
+    Dropped += T->Dropped;
+  }
+
+  std::vector<RegionSummary *> Sorted;
+  for (auto &It : Regions)
+    Sorted.push_back(&It.second);
+  std::sort(Sorted.begin(), Sorted.end(),
+            [](const RegionSummary *A, const RegionSummary *B) {
+              return A->Total.Wall > B->Total.Wall;
+            });
+
+  fprintf(Out, "libomp-prof: %zu threads, %.3f ms\n", All.size(),
+          toMsec(Elapsed));
+  fprintf(Out, "%-40s %8s %7s %12s %12s %12s %9s\n", "parallel region",
+          "calls", "threads", "wall(ms)", "work(ms)", "wait(ms)", "imbalance");
+  for (RegionSummary *R : Sorted) {
+    // Imbalance of the work of the threads: how much the slowest thread
+    // exceeds the average one, over all the calls of the region
+    double Imbalance = 0;
+    if (R->NumThreads && R->Total.Work)
+      Imbalance = 100.0 * ((double)R->MaxWork * R->NumThreads / R->Total.Work -
+                           1.0);
+    fprintf(Out, "%-40s %8" PRIu64 " %7u %12.3f %12.3f %12.3f %8.1f%%\n",
+            getName(R->Codeptr).c_str(), R->Total.Calls, R->NumThreads,
+            toMsec(R->Total.Wall), toMsec(R->Total.Work),
+            toMsec(R->Total.Wait), Imbalance);
+  }
+  fprintf(Out, "explicit tasks: %" PRIu64 " created, %" PRIu64
+               " completed, %.3f ms\n",
+          TasksCreated, TasksRun, toMsec(TaskTime));
+  if (SerialWait)
+    fprintf(Out, "waits outside of parallel regions: %.3f ms\n",
+            toMsec(SerialWait));
+  if (Dropped)
+    fprintf(Out, "trace events dropped: %" PRIu64
+                 " (raise OMP_PROF_TRACE_EVENTS or OMP_PROF_SAMPLE)\n",
+            Dropped);
+}
+
+void writeTrace(FILE *Out, const std::vector<ThreadData *> &All) {
+  static const char *const KindNames[] = {"parallel", "barrier", "taskwait",
+                                          "task"};
+  std::unordered_map<const void *, std::string> Names;
+  bool First = true;
+  fprintf(Out, "{\"traceEvents\":[\n");
+  for (ThreadData *T : All) {
+    fprintf(Out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+                 "\"tid\":%u,\"args\":{\"name\":\"OpenMP thread %u\"}}",
+            First ? "" : ",\n", T->Id, T->Id);
+    First = false;
+    for (const TraceEvent &E : T->Trace) {
+      auto It = Names.find(E.Codeptr);
+      if (It == Names.end())
+        It = Names.emplace(E.Codeptr, getName(E.Codeptr)).first;
+      fprintf(Out, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                   "\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}",
+              E.Kind == EK_Task ? "task" : It->second.c_str(),
+              KindNames[E.Kind], (E.Begin - StartTime) / 1e3,
+              (E.End - E.Begin) / 1e3, T->Id);
+    }
+  }
+  fprintf(Out, "\n],\"displayTimeUnit\":\"ns\"}\n");
+}
+
+FILE *openOutput(const char *Name, FILE *Default) {
+  if (!Name)
+    return Default;
+  FILE *F = fopen(Name, "w");
+  if (!F)
+    fprintf(stderr, "libomp-prof: cannot open %s, using stderr\n", Name);
+  return F ? F : stderr;
+}
+
+int initialize(ompt_function_lookup_t Lookup, int InitialDeviceNum,
+               ompt_data_t *ToolData) {
+  ompt_set_callback_t SetCallback =
+      (ompt_set_callback_t)Lookup("ompt_set_callback");
+  if (!SetCallback)
+    return 0;
+  StartTime = getTime();
+  SetCallback(ompt_callback_thread_begin, (ompt_callback_t)&onThreadBegin);
+  SetCallback(ompt_callback_parallel_begin, (ompt_callback_t)&onParallelBegin);
+  SetCallback(ompt_callback_parallel_end, (ompt_callback_t)&onParallelEnd);
+  SetCallback(ompt_callback_implicit_task, (ompt_callback_t)&onImplicitTask);
+  SetCallback(ompt_callback_sync_region_wait,
+              (ompt_callback_t)&onSyncRegionWait);
+  SetCallback(ompt_callback_task_create, (ompt_callback_t)&onTaskCreate);
+  SetCallback(ompt_callback_task_schedule, (ompt_callback_t)&onTaskSchedule);
+  return 1; // activate the tool
+}
+
+void finalize(ompt_data_t *ToolData) {
+  uint64_t Now = getTime();
+  std::vector<ThreadData *> All;
+  for (ThreadData *T = Threads.load(std::memory_order_acquire); T; T = T->Next)
+    All.push_back(T);
+  std::sort(All.begin(), All.end(), [](const ThreadData *A,
+                                       const ThreadData *B) {
+    return A->Id < B->Id;
+  });
+  // The workers of the last parallel region still wait in its join barrier
+  for (ThreadData *T : All)
+    while (!T->Frames.empty()) {
+      endFrame(T, T->Frames.back(), Now);
+      T->Frames.pop_back();
+    }
+
+  FILE *Out = openOutput(OutputFile, stderr);
+  writeSummary(Out, All, Now - StartTime);
+  if (Out != stderr)
+    fclose(Out);
+  if (TraceFile) {
+    Out = openOutput(TraceFile, stderr);
+    writeTrace(Out, All);
+    if (Out != stderr)
+      fclose(Out);
+  }
+}
+
+uint64_t getEnvInt(const char *Name, uint64_t Default) {
+  const char *Value = getenv(Name);
+  if (!Value || !*Value)
+    return Default;
+  char *End;
+  unsigned long long V = strtoull(Value, &End, 10);
+  if (*End || V == 0) {
+    fprintf(stderr, "libomp-prof: ignoring %s=%s\n", Name, Value);
+    return Default;
+  }
+  return V;
+}
+
+} // namespace
+
+extern "C" ompt_start_tool_result_t *
+ompt_start_tool(unsigned int OmpVersion, const char *RuntimeVersion) {
+  static ompt_start_tool_result_t Result = {&initialize, &finalize, {0}};
+  OutputFile = getenv("OMP_PROF_OUTPUT");
+  TraceFile = getenv("OMP_PROF_TRACE");
+  SampleRate = getEnvInt("OMP_PROF_SAMPLE", SampleRate);
+  MaxTraceEvents = getEnvInt("OMP_PROF_TRACE_EVENTS", MaxTraceEvents);
+  return &Result;
+}
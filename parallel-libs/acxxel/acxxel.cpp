@@ -10,8 +10,10 @@
 #include "config.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace acxxel {
 
@@ -46,6 +48,96 @@ Expected<Platform *> getOpenCLPlatform() {
 Stream::Stream(Stream &&) noexcept = default;
 Stream &Stream::operator=(Stream &&) noexcept = default;
 
+constexpr ptrdiff_t Stream::StagingBufferByteCount;
+
+namespace {
+// Two buffers are enough to overlap filling one of them on the host with the
+// transfer of the other one.
+constexpr int NumStagingBuffers = 2;
+} // namespace
+
+struct Stream::StagingPool {
+  struct Buffer {
+    Buffer(void *Memory, HandleDestructor Destructor, Event &&Done)
+        : Memory(Memory, Destructor), Done(std::move(Done)) {}
+
+    std::unique_ptr<void, HandleDestructor> Memory;
+    // Recorded after the last copy out of the buffer.
+    Event Done;
+    // Whether Done has been recorded at all.
+    bool InUse = false;
+  };
+
+  std::vector<Buffer> Buffers;
+  size_t NextBuffer = 0;
+};
+
+void Stream::destroyStagingPool(StagingPool *Pool) {
+  if (!Pool)
+    return;
+  // The device may still be reading from the buffers.
+  for (StagingPool::Buffer &B : Pool->Buffers)
+    if (B.InUse) {
+      Status S = B.Done.sync();
+      if (S.isError())
+        logWarning("staging buffer sync failed: " + S.getMessage());
+    }
+  delete Pool;
+}
+
+Status Stream::rawStagedCopyHToD(const void *HostSrc, void *DeviceDst,
+                                 ptrdiff_t DeviceDstByteOffset,
+                                 ptrdiff_t ByteCount) {
+  if (!TheStagingPool) {
+    std::unique_ptr<StagingPool, void (*)(StagingPool *)> Pool(
+        new StagingPool, destroyStagingPool);
+    for (int I = 0; I < NumStagingBuffers; ++I) {
+      Expected<void *> MaybeMemory =
+          ThePlatform->rawMallocRegisteredH(StagingBufferByteCount);
+      if (MaybeMemory.isError())
+        return MaybeMemory.getError();
+      HandleDestructor Destructor =
+          ThePlatform->getFreeHostMemoryHandleDestructor();
+      Expected<Event> MaybeEvent = ThePlatform->createEvent(TheDeviceIndex);
+      if (MaybeEvent.isError()) {
+        Destructor(MaybeMemory.getValue());
+        return MaybeEvent.getError();
+      }
+      Pool->Buffers.emplace_back(MaybeMemory.getValue(), Destructor,
+                                 MaybeEvent.takeValue());
+    }
+    TheStagingPool = std::move(Pool);
+  }
+
+  const char *Src = static_cast<const char *>(HostSrc);
+  StagingPool &Pool = *TheStagingPool;
+  for (ptrdiff_t Offset = 0; Offset < ByteCount;
+       Offset += StagingBufferByteCount) {
+    StagingPool::Buffer &B = Pool.Buffers[Pool.NextBuffer];
+    Pool.NextBuffer = (Pool.NextBuffer + 1) % Pool.Buffers.size();
+    if (B.InUse) {
+      Status S = B.Done.sync();
+      if (S.isError())
+        return S;
+      B.InUse = false;
+    }
+    ptrdiff_t ChunkByteCount =
+        std::min(StagingBufferByteCount, ByteCount - Offset);
+    std::memcpy(B.Memory.get(), Src + Offset, ChunkByteCount);
+    Status S = ThePlatform->asyncCopyHToD(B.Memory.get(), DeviceDst,
+                                          DeviceDstByteOffset + Offset,
+                                          ChunkByteCount, TheHandle.get());
+    if (S.isError())
+      return S;
+    S = ThePlatform->enqueueEvent(ThePlatform->getEventHandle(B.Done),
+                                  TheHandle.get());
+    if (S.isError())
+      return S;
+    B.InUse = true;
+  }
+  return Status();
+}
+
 Status Stream::sync() {
   return takeStatusOr(ThePlatform->streamSync(TheHandle.get()));
 }
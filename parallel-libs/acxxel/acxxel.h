@@ -347,6 +347,34 @@ public:
 
   /// \}
 
+  /// \name Staged host to device memory copies.
+  ///
+  /// These functions copy from normal, pageable host memory to device memory
+  /// without blocking on the device. The host data is copied in chunks of
+  /// StagingBufferByteCount bytes into a pool of registered staging buffers
+  /// owned by the stream, and each chunk is enqueued as an asynchronous copy,
+  /// so filling one staging buffer overlaps with the transfer of the other.
+  ///
+  /// The functions return as soon as the whole source has been copied into
+  /// the staging buffers, so the source memory may be reused right away, but
+  /// the copy to the device only completes in stream order.
+  ///
+  /// DeviceDstTy must be convertible to DeviceMemorySpan<T> and HostSrcTy
+  /// must be convertible to Span<const T>.
+  /// \{
+
+  /// The size of each staging buffer of the stream.
+  static constexpr ptrdiff_t StagingBufferByteCount = 1 << 20;
+
+  template <typename HostSrcTy, typename DeviceDstTy>
+  Stream &stagedCopyHToD(HostSrcTy &&HostSrc, DeviceDstTy &&DeviceDst);
+
+  template <typename HostSrcTy, typename DeviceDstTy>
+  Stream &stagedCopyHToD(HostSrcTy &&HostSrc, DeviceDstTy &DeviceDst,
+                         ptrdiff_t ElementCount);
+
+  /// \}
+
   /// Enqueues an operation in the stream to set the bytes of a given device
   /// memory region to a given value.
   ///
@@ -383,7 +411,16 @@ private:
   Stream(Platform *APlatform, int DeviceIndex, void *AHandle,
          HandleDestructor Destructor)
       : ThePlatform(APlatform), TheDeviceIndex(DeviceIndex),
-        TheHandle(AHandle, Destructor) {}
+        TheHandle(AHandle, Destructor),
+        TheStagingPool(nullptr, destroyStagingPool) {}
+
+  // The staging buffers used by stagedCopyHToD, created on first use.
+  struct StagingPool;
+  static void destroyStagingPool(StagingPool *Pool);
+
+  // Copies ByteCount bytes of pageable host memory through the staging pool.
+  Status rawStagedCopyHToD(const void *HostSrc, void *DeviceDst,
+                           ptrdiff_t DeviceDstByteOffset, ptrdiff_t ByteCount);
 
   const Status &setStatus(const Status &S) {
     if (S.isError() && !TheStatus.isError()) {
@@ -410,6 +447,8 @@ private:
   // A handle to the platform-specific handle implementation.
   std::unique_ptr<void, HandleDestructor> TheHandle;
   Status TheStatus;
+
+  std::unique_ptr<StagingPool, void (*)(StagingPool *)> TheStagingPool;
 };
 
 /// A user-created event on a device.
@@ -1003,6 +1042,52 @@ Stream &Stream::syncCopyHToD(HostSrcTy &&HostSrc, DeviceDstTy &DeviceDst,
   return *this;
 }
 
+template <typename HostSrcTy, typename DeviceDstTy>
+Stream &Stream::stagedCopyHToD(HostSrcTy &&HostSrc, DeviceDstTy &&DeviceDst) {
+  using DstElementTy =
+      typename std::remove_reference<DeviceDstTy>::type::value_type;
+  Span<const DstElementTy> HostSrcSpan(HostSrc);
+  DeviceMemorySpan<DstElementTy> DeviceDstSpan(DeviceDst);
+  if (HostSrcSpan.size() != DeviceDstSpan.size()) {
+    setStatus(Status("stagedCopyHToD source element count " +
+                     std::to_string(HostSrcSpan.size()) +
+                     " does not equal destination element count " +
+                     std::to_string(DeviceDstSpan.size())));
+    return *this;
+  }
+  setStatus(rawStagedCopyHToD(HostSrcSpan.data(), DeviceDstSpan.baseHandle(),
+                              DeviceDstSpan.byte_offset(),
+                              DeviceDstSpan.byte_size()));
+  return *this;
+}
+
+template <typename HostSrcTy, typename DeviceDstTy>
+Stream &Stream::stagedCopyHToD(HostSrcTy &&HostSrc, DeviceDstTy &DeviceDst,
+                               ptrdiff_t ElementCount) {
+  using DstElementTy =
+      typename std::remove_reference<DeviceDstTy>::type::value_type;
+  Span<const DstElementTy> HostSrcSpan(HostSrc);
+  DeviceMemorySpan<DstElementTy> DeviceDstSpan(DeviceDst);
+  if (HostSrcSpan.size() < ElementCount) {
+    setStatus(Status("stagedCopyHToD source element count " +
+                     std::to_string(HostSrcSpan.size()) +
+                     " is less than requested element count " +
+                     std::to_string(ElementCount)));
+    return *this;
+  }
+  if (DeviceDstSpan.size() < ElementCount) {
+    setStatus(Status("stagedCopyHToD destination element count " +
+                     std::to_string(DeviceDstSpan.size()) +
+                     " is less than requested element count " +
+                     std::to_string(ElementCount)));
+    return *this;
+  }
+  setStatus(rawStagedCopyHToD(HostSrcSpan.data(), DeviceDstSpan.baseHandle(),
+                              DeviceDstSpan.byte_offset(),
+                              ElementCount * sizeof(DstElementTy)));
+  return *this;
+}
+
 /// Owned device memory.
 ///
 /// Device memory that frees itself when it goes out of scope.
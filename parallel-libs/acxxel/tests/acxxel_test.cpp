@@ -10,10 +10,12 @@
 #include "config.h"
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace {
 
@@ -282,6 +284,27 @@ TEST_P(AcxxelTest, OwnedAsyncCopyHostAndDevice) {
     EXPECT_EQ(A[I], B[I]);
 }
 
+TEST_P(AcxxelTest, StagedCopyHToD) {
+  acxxel::Platform *Platform = GetParam()().takeValue();
+  // Spans more chunks than there are staging buffers.
+  size_t Length =
+      3 * acxxel::Stream::StagingBufferByteCount / sizeof(int) + 5;
+  std::vector<int> A(Length);
+  for (size_t I = 0; I < Length; ++I)
+    A[I] = I;
+  std::vector<int> B(Length);
+  acxxel::DeviceMemory<int> X = Platform->mallocD<int>(Length).takeValue();
+  acxxel::Stream Stream = Platform->createStream().takeValue();
+  EXPECT_FALSE(Stream.stagedCopyHToD(A, X).takeStatus().isError());
+  // The source may be reused as soon as the staged copy returns.
+  std::vector<int> Expected = A;
+  std::fill(A.begin(), A.end(), -1);
+  Stream.syncCopyDToH(X, B);
+  EXPECT_FALSE(Stream.takeStatus().isError());
+  for (size_t I = 0; I < Length; ++I)
+    EXPECT_EQ(Expected[I], B[I]);
+}
+
 TEST_P(AcxxelTest, AsyncCopyDToD) {
   acxxel::Platform *Platform = GetParam()().takeValue();
   int A[] = {0, 1, 2};
@@ -34,6 +34,7 @@ enum class OMPGeneralSchedulingType {
 extern int PollyNumThreads;
 extern OMPGeneralSchedulingType PollyScheduling;
 extern int PollyChunkSize;
+extern int PollyChunksPerThread;
 
 /// Create a scalar do/for-style loop.
 ///
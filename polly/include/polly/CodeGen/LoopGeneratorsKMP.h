@@ -78,6 +78,24 @@ public:
                                               SetVector<Value *> UsedValues,
                                               ValueMapT &VMap) override;
 
+  /// Create a runtime library call to get the number of threads in the team
+  /// executing the current parallel region.
+  ///
+  /// @return A Value ref which holds the number of threads.
+  Value *createCallBoundNumThreads();
+
+  /// Create the chunk size of a dynamically scheduled loop from its trip
+  /// count, such that every thread gets PollyChunksPerThread chunks of about
+  /// the same size. Small chunks balance the load of iterations whose cost
+  /// varies, but every one of them is a call into the runtime.
+  ///
+  /// @param LB               The loop's lower bound.
+  /// @param UB               The loop's (inclusive) upper bound.
+  /// @param Stride           The loop increment.
+  ///
+  /// @return A Value which holds the strictly positive chunk size.
+  Value *createTripCountChunkSize(Value *LB, Value *UB, Value *Stride);
+
   /// Create a runtime library call to get the current global thread number.
   ///
   /// @return A Value ref which holds the current global thread number.
@@ -28,6 +28,7 @@ struct ForceGPURuntimeLinking {
     polly_initContextCL();
     polly_initContextCUDA();
     polly_getKernel(nullptr, nullptr);
+    polly_getKernelFromIL(nullptr, 0, nullptr);
     polly_freeKernel(nullptr);
     polly_copyFromHostToDevice(nullptr, nullptr, 0);
     polly_copyFromDeviceToHost(nullptr, nullptr, 0);
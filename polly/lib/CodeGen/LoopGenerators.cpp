@@ -27,6 +27,7 @@ using namespace polly;
 int polly::PollyNumThreads;
 OMPGeneralSchedulingType polly::PollyScheduling;
 int polly::PollyChunkSize;
+int polly::PollyChunksPerThread;
 
 static cl::opt<int, true>
     XPollyNumThreads("polly-num-threads",
@@ -51,10 +52,19 @@ static cl::opt<OMPGeneralSchedulingType, true> XPollyScheduling(
 
 static cl::opt<int, true>
     XPollyChunkSize("polly-scheduling-chunksize",
-                    cl::desc("Chunksize to use by the OpenMP runtime calls"),
+                    cl::desc("Chunksize to use by the OpenMP runtime calls "
+                             "(0 = derived from the trip count for dynamic "
+                             "and guided scheduling)"),
                     cl::Hidden, cl::location(polly::PollyChunkSize),
                     cl::init(0), cl::Optional, cl::cat(PollyCategory));
 
+static cl::opt<int, true> XPollyChunksPerThread(
+    "polly-scheduling-chunks-per-thread",
+    cl::desc("Number of chunks per thread that the iterations of a dynamically "
+             "scheduled loop are split into, if no chunksize is given"),
+    cl::Hidden, cl::location(polly::PollyChunksPerThread), cl::init(4),
+    cl::Optional, cl::cat(PollyCategory));
+
 // We generate a loop of either of the following structures:
 //
 //              BeforeBB                      BeforeBB
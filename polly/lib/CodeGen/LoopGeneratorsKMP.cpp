@@ -200,6 +200,12 @@ ParallelLoopGeneratorKMP::createSubFn(Value *StrideNotUsed,
     // "DYNAMIC" scheduling types are handled below (including 'runtime')
     {
       UB = AdjustedUB;
+      // Handing out single iterations would make the threads contend for the
+      // runtime's dispatch lock. With 'runtime' scheduling the chunk size of
+      // OMP_SCHEDULE applies instead.
+      if (PollyChunkSize == 0 &&
+          PollyScheduling != OMPGeneralSchedulingType::Runtime)
+        ChunkSize = createTripCountChunkSize(LB, UB, Stride);
       createCallDispatchInit(ID, LB, UB, Stride, ChunkSize);
       Value *HasWork =
           createCallDispatchNext(ID, IsLastPtr, LBPtr, UBPtr, StridePtr);
@@ -269,6 +275,44 @@ ParallelLoopGeneratorKMP::createSubFn(Value *StrideNotUsed,
   return std::make_tuple(IV, SubFn);
 }
 
+Value *ParallelLoopGeneratorKMP::createTripCountChunkSize(Value *LB, Value *UB,
+                                                          Value *Stride) {
+  Value *TripCount = Builder.CreateAdd(
+      Builder.CreateSDiv(Builder.CreateSub(UB, LB), Stride),
+      ConstantInt::get(LongType, 1), "polly.par.tripCount");
+  Value *NumThreads = Builder.CreateSExt(createCallBoundNumThreads(), LongType,
+                                         "polly.par.numThreads");
+  Value *NumChunks = Builder.CreateMul(
+      NumThreads,
+      ConstantInt::get(LongType, std::max<int>(PollyChunksPerThread, 1)),
+      "polly.par.numChunks");
+  Value *ChunkSize =
+      Builder.CreateSDiv(TripCount, NumChunks, "polly.par.tripCountChunkSize");
+  Value *IsTooSmall =
+      Builder.CreateICmp(llvm::CmpInst::Predicate::ICMP_SLT, ChunkSize,
+                         ConstantInt::get(LongType, 1), "polly.par.noChunk");
+  return Builder.CreateSelect(IsTooSmall, ConstantInt::get(LongType, 1),
+                              ChunkSize, "polly.par.chunkSize");
+}
+
+Value *ParallelLoopGeneratorKMP::createCallBoundNumThreads() {
+  const std::string Name = "__kmpc_bound_num_threads";
+  Function *F = M->getFunction(Name);
+
+  // If F is not available, declare it.
+  if (!F) {
+    StructType *IdentTy = M->getTypeByName("struct.ident_t");
+
+    GlobalValue::LinkageTypes Linkage = Function::ExternalLinkage;
+    Type *Params[] = {IdentTy->getPointerTo()};
+
+    FunctionType *Ty = FunctionType::get(Builder.getInt32Ty(), Params, false);
+    F = Function::Create(Ty, Linkage, Name, M);
+  }
+
+  return Builder.CreateCall(F, {SourceLocationInfo});
+}
+
 Value *ParallelLoopGeneratorKMP::createCallGlobalThreadNum() {
   const std::string Name = "__kmpc_global_thread_num";
   Function *F = M->getFunction(Name);
@@ -35,6 +35,10 @@
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "isl/union_map.h"
+#ifdef POLLY_HAS_LLVM_SPIRV
+#include "LLVMSPIRVLib.h"
+#include <sstream>
+#endif
 
 extern "C" {
 #include "ppcg/cuda.h"
@@ -114,6 +118,17 @@ static cl::opt<int>
                cl::desc("Minimal number of compute statements to run on GPU."),
                cl::Hidden, cl::init(10 * 512 * 512));
 
+#ifdef POLLY_HAS_LLVM_SPIRV
+static cl::opt<bool>
+    EmitSPIRV("polly-acc-spirv",
+              cl::desc("Translate SPIR kernels to SPIR-V, which OpenCL 2.1 "
+                       "devices such as the ones SYCL runs on can load"),
+              cl::Hidden, cl::init(false), cl::ZeroOrMore,
+              cl::cat(PollyCategory));
+#else
+static const bool EmitSPIRV = false;
+#endif
+
 extern bool polly::PerfMonitoring;
 
 /// Return  a unique name for a Scop, which is the scop region with the
@@ -715,6 +730,13 @@ private:
   /// @returns A pointer to a kernel object
   Value *createCallGetKernel(Value *Buffer, Value *Entry);
 
+  /// Create a call to get a kernel from a SPIR-V module.
+  ///
+  /// @param Buffer The SPIR-V module, which may contain NUL bytes.
+  /// @param Size   The size of the SPIR-V module in bytes.
+  /// @param Entry  A string that describes the name of the kernel.
+  Value *createCallGetKernelFromIL(Value *Buffer, Value *Size, Value *Entry);
+
   /// Create a call to free a GPU kernel.
   ///
   /// @param GPUKernel THe kernel to free.
@@ -874,6 +896,26 @@ Value *GPUNodeBuilder::createCallGetKernel(Value *Buffer, Value *Entry) {
   return Builder.CreateCall(F, {Buffer, Entry});
 }
 
+Value *GPUNodeBuilder::createCallGetKernelFromIL(Value *Buffer, Value *Size,
+                                                 Value *Entry) {
+  const char *Name = "polly_getKernelFromIL";
+  Module *M = Builder.GetInsertBlock()->getParent()->getParent();
+  Function *F = M->getFunction(Name);
+
+  // If F is not available, declare it.
+  if (!F) {
+    GlobalValue::LinkageTypes Linkage = Function::ExternalLinkage;
+    std::vector<Type *> Args;
+    Args.push_back(Builder.getInt8PtrTy());
+    Args.push_back(Builder.getInt64Ty());
+    Args.push_back(Builder.getInt8PtrTy());
+    FunctionType *Ty = FunctionType::get(Builder.getInt8PtrTy(), Args, false);
+    F = Function::Create(Ty, Linkage, Name, M);
+  }
+
+  return Builder.CreateCall(F, {Buffer, Size, Entry});
+}
+
 Value *GPUNodeBuilder::createCallGetDevicePtr(Value *Allocation) {
   const char *Name = "polly_getDevicePtr";
   Module *M = Builder.GetInsertBlock()->getParent()->getParent();
@@ -1852,7 +1894,12 @@ void GPUNodeBuilder::createKernel(__isl_take isl_ast_node *KernelStmt) {
   std::string Name = getKernelFuncName(Kernel->id);
   Value *KernelString = Builder.CreateGlobalStringPtr(ASMString, Name);
   Value *NameString = Builder.CreateGlobalStringPtr(Name, Name + "_name");
-  Value *GPUKernel = createCallGetKernel(KernelString, NameString);
+  Value *GPUKernel;
+  if (EmitSPIRV && (Arch == GPUArch::SPIR32 || Arch == GPUArch::SPIR64))
+    GPUKernel = createCallGetKernelFromIL(
+        KernelString, Builder.getInt64(ASMString.size()), NameString);
+  else
+    GPUKernel = createCallGetKernel(KernelString, NameString);
 
   Value *GridDimX, *GridDimY;
   std::tie(GridDimX, GridDimY) = getGridSizes(Kernel);
@@ -2328,13 +2375,27 @@ std::string GPUNodeBuilder::createKernelASM() {
     }
     break;
   case GPUArch::SPIR64:
-  case GPUArch::SPIR32:
+  case GPUArch::SPIR32: {
+#ifdef POLLY_HAS_LLVM_SPIRV
+    if (EmitSPIRV) {
+      std::ostringstream SPIRVStream;
+      std::string ErrMsg;
+      if (!writeSpirv(GPUModule.get(), SPIRVStream, ErrMsg)) {
+        errs() << "Failed to translate the kernel to SPIR-V: " << ErrMsg
+               << "\n";
+        BuildSuccessful = false;
+        return "";
+      }
+      return SPIRVStream.str();
+    }
+#endif
     std::string SPIRAssembly;
     raw_string_ostream IROstream(SPIRAssembly);
     IROstream << *GPUModule;
     IROstream.flush();
     return SPIRAssembly;
   }
+  }
 
   std::string ErrMsg;
   auto GPUTarget = TargetRegistry::lookupTarget(GPUTriple.getTriple(), ErrMsg);
@@ -2468,7 +2529,10 @@ std::string GPUNodeBuilder::finalizeKernelFunction() {
 
   std::string Assembly = createKernelASM();
 
-  if (DumpKernelASM)
+  // A SPIR-V module is binary, use -polly-acc-dump-kernel-ir instead.
+  bool IsSPIRV =
+      EmitSPIRV && (Arch == GPUArch::SPIR32 || Arch == GPUArch::SPIR64);
+  if (DumpKernelASM && !IsSPIRV)
     outs() << Assembly << "\n";
 
   GPUModule.release();
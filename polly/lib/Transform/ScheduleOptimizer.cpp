@@ -50,15 +50,23 @@
 #include "polly/DependenceInfo.h"
 #include "polly/LinkAllPasses.h"
 #include "polly/Options.h"
+#include "polly/ScopDetectionDiagnostic.h"
 #include "polly/ScopInfo.h"
 #include "polly/ScopPass.h"
 #include "polly/Simplify.h"
+#include "polly/Support/GICHelper.h"
 #include "polly/Support/ISLOStream.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/Function.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include "isl/ctx.h"
 #include "isl/options.h"
@@ -69,6 +77,7 @@
 #include "isl/union_set.h"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -266,7 +275,24 @@ static cl::opt<bool> OptimizedScops(
              "transformations is applied on the schedule tree"),
     cl::init(false), cl::ZeroOrMore, cl::cat(PollyCategory));
 
+static cl::opt<int> ScheduleComputeOut(
+    "polly-opt-computeout",
+    cl::desc("Bound the isl scheduler by a maximal amount of computational "
+             "steps (0 means no bound). The schedule of a SCoP that runs out "
+             "of them is left unchanged."),
+    cl::Hidden, cl::init(0), cl::ZeroOrMore, cl::cat(PollyCategory));
+
+static cl::opt<std::string> ScheduleCacheDir(
+    "polly-opt-schedule-cache",
+    cl::desc("Directory to keep the schedules computed by the isl scheduler "
+             "in, so that unchanged SCoPs are not scheduled again by later "
+             "compilations"),
+    cl::Hidden, cl::init(""), cl::ZeroOrMore, cl::cat(PollyCategory));
+
 STATISTIC(ScopsProcessed, "Number of scops processed");
+STATISTIC(ScopsComputeOut, "Number of scops the scheduler gave up on "
+                           "because of -polly-opt-computeout");
+STATISTIC(ScheduleCacheHits, "Number of schedules found in the schedule cache");
 STATISTIC(ScopsRescheduled, "Number of scops rescheduled");
 STATISTIC(ScopsOptimized, "Number of scops optimized");
 
@@ -1461,6 +1487,81 @@ static void walkScheduleTreeForStatistics(isl::schedule Schedule, int Version) {
       &Version);
 }
 
+/// Return the file of the schedule cache for the schedule constraints @p SC
+/// and the scheduling options currently set in @p Ctx.
+///
+/// The constraints name the statements and parameters of the SCoP, which are
+/// derived from the IR; the same loop nest compiled again maps to the same
+/// file.
+static std::string getScheduleCacheFile(const isl::schedule_constraints &SC,
+                                        isl_ctx *Ctx) {
+  MD5 Hash;
+  Hash.update(SC.to_str());
+  int Options[] = {isl_options_get_schedule_outer_coincidence(Ctx),
+                   isl_options_get_schedule_serialize_sccs(Ctx),
+                   isl_options_get_schedule_maximize_band_depth(Ctx),
+                   isl_options_get_schedule_max_constant_term(Ctx),
+                   isl_options_get_schedule_max_coefficient(Ctx)};
+  for (int Option : Options)
+    Hash.update(std::to_string(Option) + ";");
+
+  MD5::MD5Result Result;
+  Hash.final(Result);
+
+  SmallString<32> Digest = Result.digest();
+  SmallString<128> File(ScheduleCacheDir);
+  sys::path::append(File, Digest.str() + ".isl");
+  return File.str();
+}
+
+/// Read the schedule cached in @p File, if there is one.
+static isl::schedule loadCachedSchedule(isl::ctx Ctx, StringRef File) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Buffer = MemoryBuffer::getFile(File);
+  if (!Buffer)
+    return nullptr;
+
+  auto OnErrorStatus = isl_options_get_on_error(Ctx.get());
+  isl_options_set_on_error(Ctx.get(), ISL_ON_ERROR_CONTINUE);
+  isl::schedule Schedule(Ctx, (*Buffer)->getBuffer().str());
+  isl_options_set_on_error(Ctx.get(), OnErrorStatus);
+  return Schedule;
+}
+
+/// Write @p Schedule to @p File. The schedule goes to a temporary file first,
+/// so that concurrent compilations never read a partly written one.
+static void saveCachedSchedule(StringRef File, const isl::schedule &Schedule) {
+  if (sys::fs::create_directories(ScheduleCacheDir))
+    return;
+
+  int FD;
+  SmallString<128> TempFile;
+  if (sys::fs::createUniqueFile(File + "-%%%%%%.tmp", FD, TempFile))
+    return;
+
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << Schedule.to_str();
+    if (OS.has_error()) {
+      OS.clear_error();
+      sys::fs::remove(TempFile);
+      return;
+    }
+  }
+
+  if (sys::fs::rename(TempFile, File))
+    sys::fs::remove(TempFile);
+}
+
+/// Emit a remark about the scheduling of @p S.
+static void emitScheduleRemark(Scop &S, StringRef RemarkName,
+                               const Twine &Message) {
+  DebugLoc Begin, End;
+  getDebugLocations(getBBPairForRegion(&S.getRegion()), Begin, End);
+  OptimizationRemarkAnalysis R(DEBUG_TYPE, RemarkName, Begin, S.getEntry());
+  R << Message.str();
+  S.getFunction().getContext().diagnose(R);
+}
+
 bool IslScheduleOptimizer::runOnScop(Scop &S) {
   // Skip SCoPs in case they're already optimised by PPCGCodeGeneration
   if (S.isToBeSkipped())
@@ -1582,15 +1683,53 @@ bool IslScheduleOptimizer::runOnScop(Scop &S) {
   isl_options_set_schedule_max_coefficient(Ctx, MaxCoefficient);
   isl_options_set_tile_scale_tile_loops(Ctx, 0);
 
-  auto OnErrorStatus = isl_options_get_on_error(Ctx);
-  isl_options_set_on_error(Ctx, ISL_ON_ERROR_CONTINUE);
-
   auto SC = isl::schedule_constraints::on_domain(Domain);
   SC = SC.set_proximity(Proximity);
   SC = SC.set_validity(Validity);
   SC = SC.set_coincidence(Validity);
-  auto Schedule = SC.compute_schedule();
-  isl_options_set_on_error(Ctx, OnErrorStatus);
+
+  std::string CacheFile;
+  isl::schedule Schedule;
+  if (!ScheduleCacheDir.empty()) {
+    CacheFile = getScheduleCacheFile(SC, Ctx);
+    Schedule = loadCachedSchedule(S.getIslCtx(), CacheFile);
+    if (Schedule) {
+      ScheduleCacheHits++;
+      emitScheduleRemark(S, "ScheduleCached",
+                         "schedule read from the schedule cache");
+    }
+  }
+
+  if (!Schedule) {
+    auto StartTime = std::chrono::steady_clock::now();
+    bool QuotaExceeded;
+    auto OnErrorStatus = isl_options_get_on_error(Ctx);
+    isl_options_set_on_error(Ctx, ISL_ON_ERROR_CONTINUE);
+    {
+      IslMaxOperationsGuard MaxOpGuard(Ctx, ScheduleComputeOut);
+      Schedule = SC.compute_schedule();
+      QuotaExceeded = MaxOpGuard.hasQuotaExceeded();
+    }
+    isl_options_set_on_error(Ctx, OnErrorStatus);
+    auto Elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - StartTime);
+
+    if (QuotaExceeded) {
+      LLVM_DEBUG(dbgs() << "Scheduler exceeded max_operations\n");
+      ScopsComputeOut++;
+      emitScheduleRemark(S, "ScheduleComputeOut",
+                         "maximal number of operations exceeded during "
+                         "scheduling, after " +
+                             Twine(Elapsed.count()) + " ms");
+      return false;
+    }
+
+    emitScheduleRemark(S, "ScheduleComputed",
+                       "scheduler took " + Twine(Elapsed.count()) + " ms");
+
+    if (Schedule && !CacheFile.empty())
+      saveCachedSchedule(CacheFile, Schedule);
+  }
 
   walkScheduleTreeForStatistics(Schedule, 1);
 
@@ -0,0 +1,69 @@
+; RUN: opt %loadPolly -polly-parallel -polly-codegen -polly-omp-backend=LLVM \
+; RUN:   -polly-scheduling=dynamic -S < %s | FileCheck %s --check-prefix=DERIVED
+; RUN: opt %loadPolly -polly-parallel -polly-codegen -polly-omp-backend=LLVM \
+; RUN:   -polly-scheduling=dynamic -polly-scheduling-chunks-per-thread=8 \
+; RUN:   -S < %s | FileCheck %s --check-prefix=PER-THREAD
+; RUN: opt %loadPolly -polly-parallel -polly-codegen -polly-omp-backend=LLVM \
+; RUN:   -polly-scheduling=dynamic -polly-scheduling-chunksize=16 \
+; RUN:   -S < %s | FileCheck %s --check-prefix=EXPLICIT
+; RUN: opt %loadPolly -polly-parallel -polly-codegen -polly-omp-backend=LLVM \
+; RUN:   -polly-scheduling=runtime -S < %s | FileCheck %s --check-prefix=RUNTIME
+;
+; Check the chunk size passed to __kmpc_dispatch_init_8 by the LLVM OpenMP
+; backend. Without -polly-scheduling-chunksize it is derived from the trip
+; count of the loop and the number of threads in the team.
+;
+;    void foo(float *A) {
+;      for (long i = 0; i < 1024; i++)
+;        A[i] = 1;
+;    }
+;
+; DERIVED-LABEL: define internal void @foo_polly_subfn(i32* %polly.kmpc.global_tid, i32* %polly.kmpc.bound_tid, i64 %polly.kmpc.lb, i64 %polly.kmpc.ub, i64 %polly.kmpc.inc, i8* %polly.kmpc.shared)
+; DERIVED:       %polly.indvar.UBAdjusted = add i64 %polly.kmpc.ub, -1
+; DERIVED:       [[DIFF:%.*]] = sub i64 %polly.indvar.UBAdjusted, %polly.kmpc.lb
+; DERIVED-NEXT:  [[ITERS:%.*]] = sdiv i64 [[DIFF]], %polly.kmpc.inc
+; DERIVED-NEXT:  %polly.par.tripCount = add i64 [[ITERS]], 1
+; DERIVED-NEXT:  [[THREADS:%.*]] = call i32 @__kmpc_bound_num_threads(%struct.ident_t* @.loc.dummy)
+; DERIVED-NEXT:  %polly.par.numThreads = sext i32 [[THREADS]] to i64
+; DERIVED-NEXT:  %polly.par.numChunks = mul i64 %polly.par.numThreads, 4
+; DERIVED-NEXT:  %polly.par.tripCountChunkSize = sdiv i64 %polly.par.tripCount, %polly.par.numChunks
+; DERIVED-NEXT:  %polly.par.noChunk = icmp slt i64 %polly.par.tripCountChunkSize, 1
+; DERIVED-NEXT:  %polly.par.chunkSize = select i1 %polly.par.noChunk, i64 1, i64 %polly.par.tripCountChunkSize
+; DERIVED-NEXT:  call void @__kmpc_dispatch_init_8(%struct.ident_t* @.loc.dummy, i32 %polly.par.global_tid, i32 35, i64 %polly.kmpc.lb, i64 %polly.indvar.UBAdjusted, i64 %polly.kmpc.inc, i64 %polly.par.chunkSize)
+;
+; PER-THREAD-LABEL: define internal void @foo_polly_subfn
+; PER-THREAD:       %polly.par.numChunks = mul i64 %polly.par.numThreads, 8
+; PER-THREAD:       call void @__kmpc_dispatch_init_8(%struct.ident_t* @.loc.dummy, i32 %polly.par.global_tid, i32 35, i64 %polly.kmpc.lb, i64 %polly.indvar.UBAdjusted, i64 %polly.kmpc.inc, i64 %polly.par.chunkSize)
+;
+; EXPLICIT-LABEL: define internal void @foo_polly_subfn
+; EXPLICIT-NOT:   @__kmpc_bound_num_threads
+; EXPLICIT:       call void @__kmpc_dispatch_init_8(%struct.ident_t* @.loc.dummy, i32 %polly.par.global_tid, i32 35, i64 %polly.kmpc.lb, i64 %polly.indvar.UBAdjusted, i64 %polly.kmpc.inc, i64 16)
+;
+; RUNTIME-LABEL: define internal void @foo_polly_subfn
+; RUNTIME-NOT:   @__kmpc_bound_num_threads
+; RUNTIME:       call void @__kmpc_dispatch_init_8(%struct.ident_t* @.loc.dummy, i32 %polly.par.global_tid, i32 37, i64 %polly.kmpc.lb, i64 %polly.indvar.UBAdjusted, i64 %polly.kmpc.inc, i64 1)
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @foo(float* %A) {
+entry:
+  br label %for.cond
+
+for.cond:
+  %i.0 = phi i64 [ 0, %entry ], [ %inc, %for.inc ]
+  %exitcond = icmp ne i64 %i.0, 1024
+  br i1 %exitcond, label %for.body, label %for.end
+
+for.body:
+  %arrayidx = getelementptr inbounds float, float* %A, i64 %i.0
+  store float 1.000000e+00, float* %arrayidx, align 4
+  br label %for.inc
+
+for.inc:
+  %inc = add nsw i64 %i.0, 1
+  br label %for.cond
+
+for.end:
+  ret void
+}
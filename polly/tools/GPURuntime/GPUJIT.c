@@ -156,6 +156,11 @@ typedef cl_program clCreateProgramWithBinaryFcnTy(
     cl_int *ErrcodeRet);
 static clCreateProgramWithBinaryFcnTy *clCreateProgramWithBinaryFcnPtr;
 
+typedef cl_program clCreateProgramWithILFcnTy(cl_context Context,
+                                              const void *IL, size_t Length,
+                                              cl_int *ErrcodeRet);
+static clCreateProgramWithILFcnTy *clCreateProgramWithILFcnPtr;
+
 typedef cl_int clBuildProgramFcnTy(
     cl_program Program, cl_uint NumDevices, const cl_device_id *DeviceList,
     const char *Options,
@@ -289,6 +294,11 @@ static int initialDeviceAPIsCL() {
       (clCreateProgramWithBinaryFcnTy *)getAPIHandleCL(
           Handle, "clCreateProgramWithBinary");
 
+  // clCreateProgramWithIL is only available from OpenCL 2.1 on. Do not
+  // complain about its absence until a SPIR-V kernel is actually loaded.
+  clCreateProgramWithILFcnPtr =
+      (clCreateProgramWithILFcnTy *)dlsym(Handle, "clCreateProgramWithIL");
+
   clBuildProgramFcnPtr =
       (clBuildProgramFcnTy *)getAPIHandleCL(Handle, "clBuildProgram");
 
@@ -465,7 +475,7 @@ static void freeKernelCL(PollyGPUFunction *Kernel) {
 }
 
 static PollyGPUFunction *getKernelCL(const char *BinaryBuffer,
-                                     const char *KernelName) {
+                                     long BinarySize, const char *KernelName) {
   dump_function();
 
   if (!GlobalContext) {
@@ -506,7 +516,17 @@ static PollyGPUFunction *getKernelCL(const char *BinaryBuffer,
 
   cl_int Ret;
 
-  if (HandleOpenCLBeignet) {
+  if (BinarySize >= 0) {
+    // The kernel is a SPIR-V module, which may contain NUL bytes.
+    if (!clCreateProgramWithILFcnPtr) {
+      fprintf(stderr, "The OpenCL runtime does not support SPIR-V kernels.\n");
+      exit(-1);
+    }
+    ((OpenCLKernel *)Function->Kernel)->Program = clCreateProgramWithILFcnPtr(
+        ((OpenCLContext *)GlobalContext->Context)->Context, BinaryBuffer,
+        (size_t)BinarySize, &Ret);
+    checkOpenCLError(Ret, "Failed to create program from SPIR-V.\n");
+  } else if (HandleOpenCLBeignet) {
     // This is a workaround, since clCreateProgramWithLLVMIntel only
     // accepts a filename to a valid llvm-ir file as an argument, instead
     // of accepting the BinaryBuffer directly.
@@ -1631,7 +1651,27 @@ PollyGPUFunction *polly_getKernel(const char *BinaryBuffer,
 #endif /* HAS_LIBCUDART */
 #ifdef HAS_LIBOPENCL
   case RUNTIME_CL:
-    Function = getKernelCL(BinaryBuffer, KernelName);
+    Function = getKernelCL(BinaryBuffer, -1, KernelName);
+    break;
+#endif /* HAS_LIBOPENCL */
+  default:
+    err_runtime();
+  }
+
+  return Function;
+}
+
+PollyGPUFunction *polly_getKernelFromIL(const char *BinaryBuffer,
+                                        long BinarySize,
+                                        const char *KernelName) {
+  dump_function();
+
+  PollyGPUFunction *Function;
+
+  switch (Runtime) {
+#ifdef HAS_LIBOPENCL
+  case RUNTIME_CL:
+    Function = getKernelCL(BinaryBuffer, BinarySize, KernelName);
     break;
 #endif /* HAS_LIBOPENCL */
   default:
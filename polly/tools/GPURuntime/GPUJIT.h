@@ -99,6 +99,11 @@ PollyGPUContext *polly_initContextCUDA();
 PollyGPUContext *polly_initContextCL();
 PollyGPUFunction *polly_getKernel(const char *BinaryBuffer,
                                   const char *KernelName);
+/* Load a kernel from a SPIR-V module of BinarySize bytes. Only the OpenCL
+ * runtime supports this. */
+PollyGPUFunction *polly_getKernelFromIL(const char *BinaryBuffer,
+                                        long BinarySize,
+                                        const char *KernelName);
 void polly_freeKernel(PollyGPUFunction *Kernel);
 void polly_copyFromHostToDevice(void *HostData, PollyGPUDevicePtr *DevData,
                                 long MemSize);
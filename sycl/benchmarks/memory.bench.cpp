@@ -0,0 +1,64 @@
+//==----- memory.bench.cpp - SYCL host and device transfer benchmarks -----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl.hpp>
+
+#include "benchmark/benchmark.h"
+
+#include <vector>
+
+using namespace cl::sycl;
+
+// The explicit copies of the handler go straight to MemoryManager::copy, so
+// these measure the transfer bandwidth of the device plus the command group
+// overhead, which is what the smallest sizes show.
+
+static void BM_CopyHostToDevice(benchmark::State &State) {
+  queue Queue;
+  const size_t Size = State.range(0);
+  std::vector<char> Host(Size, 1);
+  buffer<char, 1> Buf{range<1>(Size)};
+  for (auto _ : State) {
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::discard_write>(CGH);
+      CGH.copy(Host.data(), Acc);
+    });
+    Queue.wait();
+  }
+  State.SetBytesProcessed(State.iterations() * Size);
+}
+BENCHMARK(BM_CopyHostToDevice)
+    ->RangeMultiplier(16)
+    ->Range(4 << 10, 64 << 20)
+    ->UseRealTime();
+
+static void BM_CopyDeviceToHost(benchmark::State &State) {
+  queue Queue;
+  const size_t Size = State.range(0);
+  std::vector<char> Host(Size);
+  buffer<char, 1> Buf{range<1>(Size)};
+  // Make the device copy the most recent one before measuring.
+  Queue.submit([&](handler &CGH) {
+    auto Acc = Buf.get_access<access::mode::discard_write>(CGH);
+    CGH.fill(Acc, char(1));
+  });
+  for (auto _ : State) {
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read>(CGH);
+      CGH.copy(Acc, Host.data());
+    });
+    Queue.wait();
+  }
+  State.SetBytesProcessed(State.iterations() * Size);
+}
+BENCHMARK(BM_CopyDeviceToHost)
+    ->RangeMultiplier(16)
+    ->Range(4 << 10, 64 << 20)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,54 @@
+//==---------- program.bench.cpp - SYCL program build benchmarks ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl.hpp>
+
+#include "benchmark/benchmark.h"
+
+using namespace cl::sycl;
+
+class BuildKernel;
+
+// Defines the kernel the benchmarks build.
+static void runBuildKernel(queue &Queue) {
+  buffer<int, 1> Buf{range<1>(64)};
+  Queue.submit([&](handler &CGH) {
+    auto Acc = Buf.get_access<access::mode::discard_write>(CGH);
+    CGH.parallel_for<BuildKernel>(range<1>(64),
+                                  [=](id<1> I) { Acc[I] = I[0] * 2; });
+  });
+  Queue.wait();
+}
+
+// Each iteration builds the program in a new context, so the in-memory cache
+// of the runtime is always cold. With SYCL_CACHE_DIR set, the JIT is skipped
+// for all the iterations but the first one through the on-disk cache.
+static void BM_ProgramBuildCold(benchmark::State &State) {
+  device Device = default_selector().select_device();
+  for (auto _ : State) {
+    context Context(Device);
+    program Program(Context);
+    Program.build_with_kernel_type<BuildKernel>();
+    benchmark::DoNotOptimize(Program.get_kernel<BuildKernel>());
+  }
+}
+BENCHMARK(BM_ProgramBuildCold)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// The same program built again in a context where it has been built already.
+static void BM_ProgramBuildWarm(benchmark::State &State) {
+  queue Queue;
+  runBuildKernel(Queue);
+  for (auto _ : State) {
+    program Program(Queue.get_context());
+    Program.build_with_kernel_type<BuildKernel>();
+    benchmark::DoNotOptimize(Program.get_kernel<BuildKernel>());
+  }
+}
+BENCHMARK(BM_ProgramBuildWarm)->UseRealTime();
+
+BENCHMARK_MAIN();
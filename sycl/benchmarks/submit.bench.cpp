@@ -0,0 +1,80 @@
+//==----- submit.bench.cpp - SYCL command group submission benchmarks -----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl.hpp>
+
+#include "benchmark/benchmark.h"
+
+#include <vector>
+
+using namespace cl::sycl;
+
+using PlaceholderAccessor =
+    accessor<int, 1, access::mode::read_write, access::target::global_buffer,
+             access::placeholder::true_t>;
+
+// Submits a kernel doing nothing and waits for it, i.e. the latency of the
+// smallest command group from submit to completion.
+static void BM_EmptyKernelSubmit(benchmark::State &State) {
+  queue Queue;
+  for (auto _ : State) {
+    Queue.submit([&](handler &CGH) {
+      CGH.single_task<class EmptyKernel>([]() {});
+    });
+    Queue.wait();
+  }
+}
+BENCHMARK(BM_EmptyKernelSubmit)->UseRealTime();
+
+// The cost of building the graph of a command group with State.range(0)
+// requirements: the accessors are placeholders, so the kernel gets no
+// arguments and the time is spent in the scheduler.
+static void BM_AddCGAccessors(benchmark::State &State) {
+  queue Queue;
+  std::vector<buffer<int, 1>> Buffers;
+  std::vector<PlaceholderAccessor> Accessors;
+  for (int64_t I = 0; I < State.range(0); ++I)
+    Buffers.emplace_back(range<1>(1));
+  for (auto &Buf : Buffers)
+    Accessors.emplace_back(Buf);
+
+  for (auto _ : State) {
+    Queue.submit([&](handler &CGH) {
+      for (auto &Acc : Accessors)
+        CGH.require(Acc);
+      CGH.single_task<class AccessorsKernel>([]() {});
+    });
+    Queue.wait();
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_AddCGAccessors)->RangeMultiplier(4)->Range(1, 256)->UseRealTime();
+
+// A kernel writing a buffer followed by a host accessor of the buffer: the
+// data goes to the device and back at every iteration.
+static void BM_HostAccessorRoundTrip(benchmark::State &State) {
+  queue Queue;
+  buffer<int, 1> Buf{range<1>(State.range(0))};
+  for (auto _ : State) {
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class RoundTripKernel>(
+          Buf.get_range(), [=](id<1> I) { Acc[I] += 1; });
+    });
+    auto HostAcc = Buf.get_access<access::mode::read_write>();
+    benchmark::DoNotOptimize(HostAcc[0]);
+  }
+  State.SetBytesProcessed(State.iterations() * State.range(0) * sizeof(int) *
+                          2);
+}
+BENCHMARK(BM_HostAccessorRoundTrip)
+    ->RangeMultiplier(16)
+    ->Range(1, 1 << 20)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -186,6 +186,28 @@ extern void __spirv_SubgroupBlockWriteINTEL(__global uint32_t *Ptr,
 extern void __spirv_ocl_prefetch(const __global char *Ptr,
                                  size_t NumBytes) noexcept;
 
+// Specialization constant: translated to an OpSpecConstant decorated with
+// SpecId, whose value is set when the program is built.
+#define __SPIRV_SPEC_CONSTANT(Type)                                            \
+  extern Type __spirv_SpecConstant(int SpecId, Type Default) noexcept;
+
+__SPIRV_SPEC_CONSTANT(bool)
+__SPIRV_SPEC_CONSTANT(char)
+__SPIRV_SPEC_CONSTANT(signed char)
+__SPIRV_SPEC_CONSTANT(unsigned char)
+__SPIRV_SPEC_CONSTANT(short)
+__SPIRV_SPEC_CONSTANT(unsigned short)
+__SPIRV_SPEC_CONSTANT(int)
+__SPIRV_SPEC_CONSTANT(unsigned int)
+__SPIRV_SPEC_CONSTANT(long)
+__SPIRV_SPEC_CONSTANT(unsigned long)
+__SPIRV_SPEC_CONSTANT(long long)
+__SPIRV_SPEC_CONSTANT(unsigned long long)
+__SPIRV_SPEC_CONSTANT(float)
+__SPIRV_SPEC_CONSTANT(double)
+
+#undef __SPIRV_SPEC_CONSTANT
+
 #else // if !__SYCL_DEVICE_ONLY__
 
 template <typename dataT>
@@ -21,6 +21,10 @@
 #include <CL/sycl/handler.hpp>
 #include <CL/sycl/id.hpp>
 #include <CL/sycl/image.hpp>
+#include <CL/sycl/intel/command_graph.hpp>
+#include <CL/sycl/intel/group_algorithm.hpp>
+#include <CL/sycl/intel/multi_device_queue.hpp>
+#include <CL/sycl/intel/spec_constant.hpp>
 #include <CL/sycl/intel/sub_group.hpp>
 #include <CL/sycl/item.hpp>
 #include <CL/sycl/kernel.hpp>
@@ -36,4 +40,5 @@
 #include <CL/sycl/sampler.hpp>
 #include <CL/sycl/stream.hpp>
 #include <CL/sycl/types.hpp>
+#include <CL/sycl/usm.hpp>
 #include <CL/sycl/version.hpp>
@@ -440,6 +440,27 @@ public:
   }
 #endif
 
+  template <int Dims = Dimensions,
+            typename = enable_if_t<(Dims > 0) && !IsPlaceH && IsHostBuf>>
+  accessor(buffer<DataT, Dimensions> &BufferRef, range<Dimensions> AccessRange,
+           id<Dimensions> AccessOffset, detail::AsyncHostAccessTag)
+#ifdef __SYCL_DEVICE_ONLY__
+      : impl(AccessOffset, AccessRange, BufferRef.MemRange) {
+  }
+#else
+      : AccessorBaseHost(detail::convertToArrayOfN<3, 0>(AccessOffset),
+                         detail::convertToArrayOfN<3, 1>(AccessRange),
+                         detail::convertToArrayOfN<3, 1>(BufferRef.MemRange),
+                         AccessMode, detail::getSyclObjImpl(BufferRef).get(),
+                         Dimensions, sizeof(DataT)) {
+    detail::AccessorImplHost *Impl = AccessorBaseHost::impl.get();
+    Impl->MPendingEvent =
+        detail::Scheduler::getInstance().addHostAccessor(Impl);
+    Impl->MPending.store(Impl->MPendingEvent != nullptr,
+                         std::memory_order_release);
+  }
+#endif
+
   template <int Dims = Dimensions,
             typename = enable_if_t<
                 (Dims > 0) && (!IsPlaceH && (IsGlobalBuf || IsConstantBuf))>>
@@ -460,6 +481,17 @@ public:
 
   constexpr bool is_placeholder() const { return IsPlaceH; }
 
+#ifndef __SYCL_DEVICE_ONLY__
+  // Waits for the memory of an asynchronous host accessor to become available
+  // on the host. Does nothing for other accessors.
+  template <
+      access::target AccessTarget_ = AccessTarget,
+      typename = enable_if_t<AccessTarget_ == access::target::host_buffer>>
+  void wait() const {
+    AccessorBaseHost::impl->waitPending();
+  }
+#endif
+
   size_t get_size() const { return getMemoryRange().size() * sizeof(DataT); }
 
   size_t get_count() const { return getMemoryRange().size(); }
@@ -128,8 +128,8 @@ public:
          event AvailableEvent = {}) {
 
     size_t BufSize = 0;
-    CHECK_OCL_CODE(clGetMemObjectInfo(MemObject, CL_MEM_SIZE, sizeof(size_t),
-                                      &BufSize, nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetMemObjectInfo)(
+        MemObject, CL_MEM_SIZE, sizeof(size_t), &BufSize, nullptr));
     Range[0] = BufSize / sizeof(T);
     MemRange[0] = BufSize / sizeof(T);
     impl = std::make_shared<detail::buffer_impl<AllocatorT>>(
@@ -200,6 +200,27 @@ public:
                                                           accessOffset);
   }
 
+  // Returns a host accessor without waiting for the memory to become available
+  // on the host, so the host can do other work while the memory is being
+  // transferred. The first access through the accessor, or its wait(), blocks
+  // until the memory is available.
+  template <access::mode mode>
+  accessor<T, dimensions, mode, access::target::host_buffer,
+           access::placeholder::false_t>
+  get_access_async() {
+    return impl->template get_access_async<T, dimensions, mode>(*this, Range,
+                                                                Offset);
+  }
+
+  template <access::mode mode>
+  accessor<T, dimensions, mode, access::target::host_buffer,
+           access::placeholder::false_t>
+  get_access_async(range<dimensions> accessRange,
+                   id<dimensions> accessOffset = {}) {
+    return impl->template get_access_async<T, dimensions, mode>(
+        *this, accessRange, accessOffset);
+  }
+
   template <typename Destination = std::nullptr_t>
   void set_final_data(Destination finalData = nullptr) {
     impl->set_final_data(finalData);
@@ -14,6 +14,7 @@
 #include <CL/sycl/id.hpp>
 #include <CL/sycl/range.hpp>
 
+#include <atomic>
 #include <memory>
 
 namespace cl {
@@ -90,10 +91,26 @@ public:
   void *MData = nullptr;
 
   EventImplPtr BlockingEvent;
+
+  // Event of the command making the memory available to an asynchronous host
+  // accessor, waited for on the first access to the memory.
+  EventImplPtr MPendingEvent;
+  std::atomic<bool> MPending{false};
+
+  void waitPending() {
+    if (!MPending.load(std::memory_order_acquire))
+      return;
+    MPendingEvent->wait(MPendingEvent);
+    MPending.store(false, std::memory_order_release);
+  }
 };
 
 using AccessorImplPtr = std::shared_ptr<AccessorImplHost>;
 
+// Selects the host accessor constructors which don't wait for the memory to
+// become available on the host, the first access to the memory waits instead.
+struct AsyncHostAccessTag {};
+
 class AccessorBaseHost {
 public:
   AccessorBaseHost(id<3> Offset, range<3> AccessRange, range<3> MemoryRange,
@@ -108,12 +125,18 @@ protected:
   id<3> &getOffset() { return impl->MOffset; }
   range<3> &getAccessRange() { return impl->MAccessRange; }
   range<3> &getMemoryRange() { return impl->MMemoryRange; }
-  void *getPtr() { return impl->MData; }
+  void *getPtr() {
+    impl->waitPending();
+    return impl->MData;
+  }
 
   const id<3> &getOffset() const { return impl->MOffset; }
   const range<3> &getAccessRange() const { return impl->MAccessRange; }
   const range<3> &getMemoryRange() const { return impl->MMemoryRange; }
-  void *getPtr() const { return const_cast<void *>(impl->MData); }
+  void *getPtr() const {
+    impl->waitPending();
+    return const_cast<void *>(impl->MData);
+  }
 
   template <class Obj>
   friend decltype(Obj::impl) getSyclObjImpl(const Obj &SyclObject);
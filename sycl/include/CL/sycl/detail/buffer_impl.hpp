@@ -11,6 +11,7 @@
 #include <CL/cl.h>
 #include <CL/sycl/access/access.hpp>
 #include <CL/sycl/context.hpp>
+#include <CL/sycl/detail/accessor_impl.hpp>
 #include <CL/sycl/detail/aligned_allocator.hpp>
 #include <CL/sycl/detail/common.hpp>
 #include <CL/sycl/detail/helpers.hpp>
@@ -22,6 +23,7 @@
 #include <CL/sycl/stl.hpp>
 #include <CL/sycl/types.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <type_traits>
@@ -47,6 +49,9 @@ using cl::sycl::detail::MemoryManager;
 
 template <typename AllocatorT> class buffer_impl : public SYCLMemObjT {
 public:
+  // The alignment of the host memory allocated by buffer_allocator.
+  static constexpr size_t HostPtrAlignment = 64;
+
   buffer_impl(size_t SizeInBytes, const property_list &PropList,
               AllocatorT Allocator = AllocatorT())
       : buffer_impl((void *)nullptr, SizeInBytes, PropList, Allocator) {}
@@ -59,12 +64,14 @@ public:
       return;
 
     set_final_data(reinterpret_cast<char *>(HostData));
-    if (MProps.has_property<property::buffer::use_host_ptr>()) {
+    // The user's memory aligned as the default allocation is used directly,
+    // the devices sharing the memory with the host work on it in place then.
+    if (MProps.has_property<property::buffer::use_host_ptr>() ||
+        reinterpret_cast<std::uintptr_t>(HostData) % HostPtrAlignment == 0) {
       MUserPtr = HostData;
       return;
     }
 
-    // TODO: Reuse user's pointer if it has sufficient alignment.
     MShadowCopy = allocateHostMem();
     MUserPtr = MShadowCopy;
     std::memcpy(MUserPtr, HostData, SizeInBytes);
@@ -183,12 +190,12 @@ public:
           "allowed");
 
     cl_context Context = nullptr;
-    CHECK_OCL_CODE(clGetMemObjectInfo(MInteropMemObject, CL_MEM_CONTEXT,
-                                      sizeof(Context), &Context, nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetMemObjectInfo)(
+        MInteropMemObject, CL_MEM_CONTEXT, sizeof(Context), &Context, nullptr));
     if (MInteropContext->getHandleRef() != Context)
       throw cl::sycl::invalid_parameter_error(
           "Input context must be the same as the context of cl_mem");
-    CHECK_OCL_CODE(clRetainMemObject(MInteropMemObject));
+    CHECK_OCL_CODE(PI_TRACED(clRetainMemObject)(MInteropMemObject));
   }
 
   size_t get_size() const { return MSizeInBytes; }
@@ -206,7 +213,7 @@ public:
     releaseHostMem(MShadowCopy);
 
     if (MOpenCLInterop)
-      CHECK_OCL_CODE_NO_EXC(clReleaseMemObject(MInteropMemObject));
+      CHECK_OCL_CODE_NO_EXC(PI_TRACED(clReleaseMemObject)(MInteropMemObject));
   }
 
   void set_final_data(std::nullptr_t) { MUploadDataFn = nullptr; }
@@ -329,6 +336,16 @@ public:
                                                   accessOffset);
   }
 
+  template <typename T, int Dimensions, access::mode Mode>
+  accessor<T, Dimensions, Mode, access::target::host_buffer,
+           access::placeholder::false_t>
+  get_access_async(buffer<T, Dimensions, AllocatorT> &Buffer,
+                   range<Dimensions> AccessRange, id<Dimensions> AccessOffset) {
+    return accessor<T, Dimensions, Mode, access::target::host_buffer,
+                    access::placeholder::false_t>(
+        Buffer, AccessRange, AccessOffset, AsyncHostAccessTag());
+  }
+
   void *allocateHostMem() override {
     assert(
         !MProps.has_property<property::buffer::use_host_ptr>() &&
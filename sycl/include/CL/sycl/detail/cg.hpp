@@ -10,17 +10,34 @@
 
 #include <CL/sycl/detail/accessor_impl.hpp>
 #include <CL/sycl/detail/helpers.hpp>
+#include <CL/sycl/detail/host_executor.hpp>
+#include <CL/sycl/detail/host_sub_group.hpp>
 #include <CL/sycl/detail/kernel_desc.hpp>
 #include <CL/sycl/id.hpp>
 #include <CL/sycl/kernel.hpp>
 #include <CL/sycl/nd_item.hpp>
 #include <CL/sycl/range.hpp>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <type_traits>
 #include <vector>
 
+// Work-items of a basic parallel_for, as well as work-groups of an nd_range
+// one, can't depend on each other. Defining SYCL_HOST_SIMD_LOOPS tells the
+// compiler so for the innermost loop of the host device execution, which lets
+// it vectorize the loop without proving the iterations independent first.
+#if defined(SYCL_HOST_SIMD_LOOPS) && defined(__clang__)
+#define __SYCL_HOST_SIMD_LOOP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(SYCL_HOST_SIMD_LOOPS) && defined(__GNUC__)
+#define __SYCL_HOST_SIMD_LOOP _Pragma("GCC ivdep")
+#elif defined(SYCL_HOST_SIMD_LOOPS) && defined(_MSC_VER)
+#define __SYCL_HOST_SIMD_LOOP __pragma(loop(ivdep))
+#else
+#define __SYCL_HOST_SIMD_LOOP
+#endif
+
 namespace cl {
 namespace sycl {
 namespace detail {
@@ -86,8 +103,10 @@ public:
 // The pure virtual class aimed to store lambda/functors of any type.
 class HostKernelBase {
 public:
-  // The method executes lambda stored using NDRange passed.
-  virtual void call(const NDRDescT &NDRDesc) = 0;
+  // The method executes lambda stored using NDRange passed. Work-items (or
+  // work-groups for nd_range kernels) are distributed between the host
+  // executor threads if IsParallel is true and run serially otherwise.
+  virtual void call(const NDRDescT &NDRDesc, bool IsParallel) = 0;
   // Return pointer to the lambda object.
   // Used to extract captured variables.
   virtual char *getPtr() = 0;
@@ -100,69 +119,90 @@ class HostKernel : public HostKernelBase {
   using IDBuilder = sycl::detail::Builder;
   KernelType MKernel;
 
+  // Calls Func for every id in Range. The last dimension is the fastest
+  // changing one, as in the linear ids and the accessor memory layout, so the
+  // innermost loop walks the memory contiguously. Consecutive ids are
+  // processed by the same thread.
+  template <class FuncT>
+  static void forEachID(const sycl::range<3> &Range, bool IsParallel,
+                        FuncT Func) {
+    const size_t Size = Range[0] * Range[1] * Range[2];
+    if (Size == 0)
+      return;
+
+    auto RunSubrange = [&Range, &Func](size_t Begin, size_t End) {
+      const size_t RowSize = Range[Dims - 1];
+      sycl::id<Dims> ID;
+      for (size_t Linear = Begin; Linear < End;) {
+        size_t Rest = Linear;
+        for (int I = Dims - 1; I >= 0; --I) {
+          ID[I] = Rest % Range[I];
+          Rest /= Range[I];
+        }
+        // Only the last component changes until the end of the row, this loop
+        // is the one to be vectorized.
+        const size_t RowBegin = ID[Dims - 1];
+        const size_t RowEnd = RowBegin + std::min(RowSize - RowBegin,
+                                                  End - Linear);
+        __SYCL_HOST_SIMD_LOOP
+        for (size_t X = RowBegin; X < RowEnd; ++X) {
+          ID[Dims - 1] = X;
+          Func(ID);
+        }
+        Linear += RowEnd - RowBegin;
+      }
+    };
+
+    if (IsParallel)
+      HostExecutor::parallelFor(Size, RunSubrange);
+    else
+      RunSubrange(0, Size);
+  }
+
 public:
   HostKernel(KernelType Kernel) : MKernel(Kernel) {}
-  void call(const NDRDescT &NDRDesc) override { runOnHost(NDRDesc); }
+  void call(const NDRDescT &NDRDesc, bool IsParallel) override {
+    runOnHost(NDRDesc, IsParallel);
+  }
 
   char *getPtr() override { return reinterpret_cast<char *>(&MKernel); }
 
   template <class ArgT = KernelArgType>
   typename std::enable_if<std::is_same<ArgT, void>::value>::type
-  runOnHost(const NDRDescT &NDRDesc) {
+  runOnHost(const NDRDescT &NDRDesc, bool IsParallel) {
     MKernel();
   }
 
   template <class ArgT = KernelArgType>
   typename std::enable_if<std::is_same<ArgT, sycl::id<Dims>>::value>::type
-  runOnHost(const NDRDescT &NDRDesc) {
-    size_t XYZ[3] = {0};
-    sycl::id<Dims> ID;
-    for (; XYZ[2] < NDRDesc.GlobalSize[2]; ++XYZ[2]) {
-      XYZ[1] = 0;
-      for (; XYZ[1] < NDRDesc.GlobalSize[1]; ++XYZ[1]) {
-        XYZ[0] = 0;
-        for (; XYZ[0] < NDRDesc.GlobalSize[0]; ++XYZ[0]) {
-          for (int I = 0; I < Dims; ++I)
-            ID[I] = XYZ[I];
-          MKernel(ID);
-        }
-      }
-    }
+  runOnHost(const NDRDescT &NDRDesc, bool IsParallel) {
+    forEachID(NDRDesc.GlobalSize, IsParallel,
+              [this](const sycl::id<Dims> &ID) { MKernel(ID); });
   }
 
   template <class ArgT = KernelArgType>
   typename std::enable_if<
       (std::is_same<ArgT, item<Dims, /*Offset=*/false>>::value ||
        std::is_same<ArgT, item<Dims, /*Offset=*/true>>::value)>::type
-  runOnHost(const NDRDescT &NDRDesc) {
-    size_t XYZ[3] = {0};
-    sycl::id<Dims> ID;
+  runOnHost(const NDRDescT &NDRDesc, bool IsParallel) {
     sycl::range<Dims> Range;
     for (int I = 0; I < Dims; ++I)
       Range[I] = NDRDesc.GlobalSize[I];
 
-    for (; XYZ[2] < NDRDesc.GlobalSize[2]; ++XYZ[2]) {
-      XYZ[1] = 0;
-      for (; XYZ[1] < NDRDesc.GlobalSize[1]; ++XYZ[1]) {
-        XYZ[0] = 0;
-        for (; XYZ[0] < NDRDesc.GlobalSize[0]; ++XYZ[0]) {
-          for (int I = 0; I < Dims; ++I)
-            ID[I] = XYZ[I];
-
-          sycl::item<Dims, /*Offset=*/false> Item =
-              IDBuilder::createItem<Dims, false>(Range, ID);
-          MKernel(Item);
-        }
-      }
-    }
+    forEachID(NDRDesc.GlobalSize, IsParallel,
+              [this, &Range](const sycl::id<Dims> &ID) {
+                sycl::item<Dims, /*Offset=*/false> Item =
+                    IDBuilder::createItem<Dims, false>(Range, ID);
+                MKernel(Item);
+              });
   }
 
   template <class ArgT = KernelArgType>
   typename std::enable_if<std::is_same<ArgT, nd_item<Dims>>::value>::type
-  runOnHost(const NDRDescT &NDRDesc) {
+  runOnHost(const NDRDescT &NDRDesc, bool IsParallel) {
     // TODO add offset logic
 
-    sycl::id<3> GroupSize;
+    sycl::range<3> GroupSize;
     for (int I = 0; I < 3; ++I) {
       GroupSize[I] = NDRDesc.GlobalSize[I] / NDRDesc.LocalSize[I];
     }
@@ -176,51 +216,40 @@ public:
       GlobalSize[I] = NDRDesc.GlobalSize[I];
     }
 
-    sycl::id<Dims> GlobalID;
-    sycl::id<Dims> LocalID;
-
-    size_t GroupXYZ[3] = {0};
-    sycl::id<Dims> GroupID;
-    for (; GroupXYZ[2] < GroupSize[2]; ++GroupXYZ[2]) {
-      GroupXYZ[1] = 0;
-      for (; GroupXYZ[1] < GroupSize[1]; ++GroupXYZ[1]) {
-        GroupXYZ[0] = 0;
-        for (; GroupXYZ[0] < GroupSize[0]; ++GroupXYZ[0]) {
-          for (int I = 0; I < Dims; ++I)
-            GroupID[I] = GroupXYZ[I];
-
-          sycl::group<Dims> Group =
-              IDBuilder::createGroup<Dims>(GlobalSize, LocalSize, GroupID);
-          size_t LocalXYZ[3] = {0};
-          for (; LocalXYZ[2] < NDRDesc.LocalSize[2]; ++LocalXYZ[2]) {
-            LocalXYZ[1] = 0;
-            for (; LocalXYZ[1] < NDRDesc.LocalSize[1]; ++LocalXYZ[1]) {
-              LocalXYZ[0] = 0;
-              for (; LocalXYZ[0] < NDRDesc.LocalSize[0]; ++LocalXYZ[0]) {
-
-                for (int I = 0; I < Dims; ++I) {
-                  GlobalID[I] = GroupXYZ[I] * LocalSize[I] + LocalXYZ[I];
-                  LocalID[I] = LocalXYZ[I];
-                }
-                const sycl::item<Dims, /*Offset=*/true> GlobalItem =
-                    IDBuilder::createItem<Dims, true>(GlobalSize, GlobalID,
-                                                      GlobalOffset);
-                const sycl::item<Dims, /*Offset=*/false> LocalItem =
-                    IDBuilder::createItem<Dims, false>(LocalSize, LocalID);
-                const sycl::nd_item<Dims> NDItem =
-                    IDBuilder::createNDItem<Dims>(GlobalItem, LocalItem, Group);
-                MKernel(NDItem);
-              }
-            }
-          }
+    // Work-groups are distributed between the threads, all work-items of a
+    // group are executed by the same thread.
+    const size_t WorkGroupSize = LocalSize.size();
+    forEachID(GroupSize, IsParallel, [&](const sycl::id<Dims> &GroupID) {
+      sycl::group<Dims> Group =
+          IDBuilder::createGroup<Dims>(GlobalSize, LocalSize, GroupID);
+      // The work-items of a sub-group may be interleaved, so each of them
+      // builds its ids from the local linear id.
+      HostSubGroup::runWorkGroup(WorkGroupSize, [&](size_t LocalLinearID) {
+        sycl::id<Dims> GlobalID;
+        sycl::id<Dims> LocalID;
+        for (int I = Dims - 1; I >= 0; --I) {
+          LocalID[I] = LocalLinearID % LocalSize[I];
+          LocalLinearID /= LocalSize[I];
+          GlobalID[I] = GroupID[I] * LocalSize[I] + LocalID[I];
         }
-      }
-    }
+        const sycl::item<Dims, /*Offset=*/true> GlobalItem =
+            IDBuilder::createItem<Dims, true>(GlobalSize, GlobalID,
+                                              GlobalOffset);
+        const sycl::item<Dims, /*Offset=*/false> LocalItem =
+            IDBuilder::createItem<Dims, false>(LocalSize, LocalID);
+        const sycl::nd_item<Dims> NDItem =
+            IDBuilder::createNDItem<Dims>(GlobalItem, LocalItem, Group);
+        MKernel(NDItem);
+      });
+    });
   }
   ~HostKernel() = default;
 };
 
 class stream_impl;
+class event_impl;
+using EventImplPtr = std::shared_ptr<detail::event_impl>;
+
 // The base class for all types of command groups.
 class CG {
 public:
@@ -231,22 +260,29 @@ public:
     COPY_PTR_TO_ACC,
     COPY_ACC_TO_ACC,
     FILL,
-    UPDATE_HOST
+    UPDATE_HOST,
+    COPY_USM,
+    FILL_USM
   };
 
   CG(CGTYPE Type, std::vector<std::vector<char>> ArgsStorage,
      std::vector<detail::AccessorImplPtr> AccStorage,
      std::vector<std::shared_ptr<void>> SharedPtrStorage,
-     std::vector<Requirement *> Requirements)
+     std::vector<Requirement *> Requirements,
+     std::vector<detail::EventImplPtr> Events)
       : MType(Type), MArgsStorage(std::move(ArgsStorage)),
         MAccStorage(std::move(AccStorage)),
         MSharedPtrStorage(std::move(SharedPtrStorage)),
-        MRequirements(std::move(Requirements)) {}
+        MRequirements(std::move(Requirements)), MEvents(std::move(Events)) {}
 
   CG(CG &&CommandGroup) = default;
 
   std::vector<Requirement *> getRequirements() const { return MRequirements; }
 
+  const std::vector<detail::EventImplPtr> &getEvents() const {
+    return MEvents;
+  }
+
   CGTYPE getType() { return MType; }
 
 private:
@@ -262,6 +298,9 @@ private:
   // List of requirements that specify which memory is needed for the command
   // group to be executed.
   std::vector<Requirement *> MRequirements;
+  // List of events the command group depends on in addition to the ones
+  // implied by the requirements.
+  std::vector<detail::EventImplPtr> MEvents;
 };
 
 // The class which represents "execute kernel" command group.
@@ -274,6 +313,7 @@ public:
   std::string MKernelName;
   detail::OSModuleHandle MOSModuleHandle;
   std::vector<std::shared_ptr<detail::stream_impl>> MStreams;
+  SpecConstantValues MSpecConstants;
 
   CGExecKernel(NDRDescT NDRDesc, std::unique_ptr<HostKernelBase> HKernel,
                std::shared_ptr<detail::kernel_impl> SyclKernel,
@@ -281,21 +321,26 @@ public:
                std::vector<detail::AccessorImplPtr> AccStorage,
                std::vector<std::shared_ptr<void>> SharedPtrStorage,
                std::vector<Requirement *> Requirements,
+               std::vector<detail::EventImplPtr> Events,
                std::vector<ArgDesc> Args, std::string KernelName,
                detail::OSModuleHandle OSModuleHandle,
-               std::vector<std::shared_ptr<detail::stream_impl>> Streams)
+               std::vector<std::shared_ptr<detail::stream_impl>> Streams,
+               SpecConstantValues SpecConstants)
       : CG(KERNEL, std::move(ArgsStorage), std::move(AccStorage),
-           std::move(SharedPtrStorage), std::move(Requirements)),
+           std::move(SharedPtrStorage), std::move(Requirements),
+           std::move(Events)),
         MNDRDesc(std::move(NDRDesc)), MHostKernel(std::move(HKernel)),
         MSyclKernel(std::move(SyclKernel)), MArgs(std::move(Args)),
         MKernelName(std::move(KernelName)), MOSModuleHandle(OSModuleHandle),
-        MStreams(std::move(Streams)) {}
+        MStreams(std::move(Streams)),
+        MSpecConstants(std::move(SpecConstants)) {}
 
   std::vector<ArgDesc> getArguments() const { return MArgs; }
   std::string getKernelName() const { return MKernelName; }
   std::vector<std::shared_ptr<detail::stream_impl>> getStreams() const {
     return MStreams;
   }
+  const SpecConstantValues &getSpecConstants() const { return MSpecConstants; }
 };
 
 // The class which represents "copy" command group.
@@ -308,9 +353,11 @@ public:
          std::vector<std::vector<char>> ArgsStorage,
          std::vector<detail::AccessorImplPtr> AccStorage,
          std::vector<std::shared_ptr<void>> SharedPtrStorage,
-         std::vector<Requirement *> Requirements)
+         std::vector<Requirement *> Requirements,
+         std::vector<detail::EventImplPtr> Events)
       : CG(CopyType, std::move(ArgsStorage), std::move(AccStorage),
-           std::move(SharedPtrStorage), std::move(Requirements)),
+           std::move(SharedPtrStorage), std::move(Requirements),
+           std::move(Events)),
         MSrc(Src), MDst(Dst) {}
   void *getSrc() { return MSrc; }
   void *getDst() { return MDst; }
@@ -326,9 +373,11 @@ public:
          std::vector<std::vector<char>> ArgsStorage,
          std::vector<detail::AccessorImplPtr> AccStorage,
          std::vector<std::shared_ptr<void>> SharedPtrStorage,
-         std::vector<Requirement *> Requirements)
+         std::vector<Requirement *> Requirements,
+         std::vector<detail::EventImplPtr> Events)
       : CG(FILL, std::move(ArgsStorage), std::move(AccStorage),
-           std::move(SharedPtrStorage), std::move(Requirements)),
+           std::move(SharedPtrStorage), std::move(Requirements),
+           std::move(Events)),
         MPattern(std::move(Pattern)), MPtr((Requirement *)Ptr) {}
   Requirement *getReqToFill() { return MPtr; }
 };
@@ -341,14 +390,60 @@ public:
   CGUpdateHost(void *Ptr, std::vector<std::vector<char>> ArgsStorage,
                std::vector<detail::AccessorImplPtr> AccStorage,
                std::vector<std::shared_ptr<void>> SharedPtrStorage,
-               std::vector<Requirement *> Requirements)
+               std::vector<Requirement *> Requirements,
+               std::vector<detail::EventImplPtr> Events)
       : CG(UPDATE_HOST, std::move(ArgsStorage), std::move(AccStorage),
-           std::move(SharedPtrStorage), std::move(Requirements)),
+           std::move(SharedPtrStorage), std::move(Requirements),
+           std::move(Events)),
         MPtr((Requirement *)Ptr) {}
 
   Requirement *getReqToUpdate() { return MPtr; }
 };
 
+// The class which represents "copy" command group for USM pointers.
+class CGCopyUSM : public CG {
+  void *MSrc;
+  void *MDst;
+  size_t MLength;
+
+public:
+  CGCopyUSM(void *Src, void *Dst, size_t Length,
+            std::vector<std::vector<char>> ArgsStorage,
+            std::vector<detail::AccessorImplPtr> AccStorage,
+            std::vector<std::shared_ptr<void>> SharedPtrStorage,
+            std::vector<Requirement *> Requirements,
+            std::vector<detail::EventImplPtr> Events)
+      : CG(COPY_USM, std::move(ArgsStorage), std::move(AccStorage),
+           std::move(SharedPtrStorage), std::move(Requirements),
+           std::move(Events)),
+        MSrc(Src), MDst(Dst), MLength(Length) {}
+  void *getSrc() { return MSrc; }
+  void *getDst() { return MDst; }
+  size_t getLength() { return MLength; }
+};
+
+// The class which represents "fill" command group for USM pointers.
+class CGFillUSM : public CG {
+  int MPattern;
+  void *MDst;
+  size_t MLength;
+
+public:
+  CGFillUSM(int Pattern, void *DstPtr, size_t Length,
+            std::vector<std::vector<char>> ArgsStorage,
+            std::vector<detail::AccessorImplPtr> AccStorage,
+            std::vector<std::shared_ptr<void>> SharedPtrStorage,
+            std::vector<Requirement *> Requirements,
+            std::vector<detail::EventImplPtr> Events)
+      : CG(FILL_USM, std::move(ArgsStorage), std::move(AccStorage),
+           std::move(SharedPtrStorage), std::move(Requirements),
+           std::move(Events)),
+        MPattern(Pattern), MDst(DstPtr), MLength(Length) {}
+  void *getDst() { return MDst; }
+  size_t getLength() { return MLength; }
+  int getFill() { return MPattern; }
+};
+
 } // namespace cl
 } // namespace sycl
 } // namespace detail
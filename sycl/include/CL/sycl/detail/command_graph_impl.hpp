@@ -0,0 +1,52 @@
+//==------- command_graph_impl.hpp --- SYCL command graph implementation ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <CL/sycl/detail/event_impl.hpp>
+#include <CL/sycl/detail/queue_impl.hpp>
+#include <CL/sycl/detail/scheduler/scheduler.hpp>
+
+#include <cstddef>
+#include <memory>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+using QueueImplPtr = std::shared_ptr<queue_impl>;
+
+// Holds the commands of the command groups submitted to a queue between
+// beginRecording and endRecording so that they can be enqueued again.
+class command_graph_impl {
+public:
+  ~command_graph_impl();
+
+  void beginRecording(QueueImplPtr Queue);
+
+  void endRecording();
+
+  size_t size() const { return MGraph.MCommands.size(); }
+
+  // Overwrites the value of the argument ArgIndex of the kernel of the
+  // CGIndex-th recorded command group. Only arguments passed by value can be
+  // set.
+  void setArg(size_t CGIndex, int ArgIndex, const void *Arg, size_t Size);
+
+  EventImplPtr replay();
+
+private:
+  QueueImplPtr MQueue;
+  bool MIsRecording = false;
+  bool MIsFinalized = false;
+  Scheduler::RecordedGraph MGraph;
+};
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
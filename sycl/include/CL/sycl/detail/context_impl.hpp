@@ -8,11 +8,14 @@
 
 #pragma once
 #include <CL/sycl/detail/common.hpp>
+#include <CL/sycl/detail/memory_pool.hpp>
+#include <CL/sycl/detail/usm_dispatch.hpp>
 #include <CL/sycl/exception.hpp>
 #include <CL/sycl/info/info_desc.hpp>
 #include <CL/sycl/platform.hpp>
 #include <CL/sycl/stl.hpp>
 
+#include <cassert>
 #include <memory>
 // 4.6.2 Context class
 
@@ -53,6 +56,16 @@ public:
   cl_context &getHandleRef();
   const cl_context &getHandleRef() const;
 
+  // Returns the pool of the device buffers of this context. Must not be
+  // called for the host context.
+  MemoryPool &getMemoryPool() {
+    assert(m_MemoryPool && "Host context has no memory pool");
+    return *m_MemoryPool;
+  }
+
+  // Returns the unified shared memory allocations of this context.
+  USMDispatcher &getUSMDispatch() { return *m_USMDispatch; }
+
 private:
   async_handler m_AsyncHandler;
   vector_class<device> m_Devices;
@@ -60,6 +73,8 @@ private:
   platform m_Platform;
   bool m_OpenCLInterop;
   bool m_HostContext;
+  std::unique_ptr<MemoryPool> m_MemoryPool;
+  std::unique_ptr<USMDispatcher> m_USMDispatch;
 };
 
 } // namespace detail
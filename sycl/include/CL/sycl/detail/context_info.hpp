@@ -22,8 +22,8 @@ template <info::context param> struct get_context_info_cl {
   static RetType _(cl_context ctx) {
     RetType Result = 0;
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetContextInfo(ctx, cl_context_info(param), sizeof(Result),
-                                    &Result, nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetContextInfo)(
+        ctx, cl_context_info(param), sizeof(Result), &Result, nullptr));
     return Result;
   }
 };
@@ -11,7 +11,9 @@
 #include <CL/sycl/detail/device_info.hpp>
 #include <CL/sycl/stl.hpp>
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <mutex>
 
 namespace cl {
 namespace sycl {
@@ -60,15 +62,25 @@ public:
   static vector_class<device>
   get_devices(info::device_type deviceType = info::device_type::all);
 
+  // The info that can't change during the lifetime of the device is queried
+  // once and then returned from the cache.
   template <info::device param>
   typename info::param_traits<info::device, param>::return_type
   get_info() const {
-    if (is_host()) {
-      return get_device_info_host<param>();
+    using RetT = typename info::param_traits<info::device, param>::return_type;
+    if (!isInfoCacheable(param))
+      return queryInfo<param>();
+    {
+      std::lock_guard<std::mutex> Lock(MInfoMutex);
+      auto It = MInfoCache.find(param);
+      if (It != MInfoCache.end())
+        return *static_cast<const RetT *>(It->second.get());
     }
-    return get_device_info<
-        typename info::param_traits<info::device, param>::return_type,
-        param>::_(this->get_handle());
+    std::shared_ptr<void> Value = std::make_shared<RetT>(queryInfo<param>());
+    std::lock_guard<std::mutex> Lock(MInfoMutex);
+    // Another thread may have stored the same value meanwhile.
+    auto It = MInfoCache.emplace(param, std::move(Value)).first;
+    return *static_cast<const RetT *>(It->second.get());
   }
 
   bool is_partition_supported(info::partition_property Prop) const {
@@ -86,6 +98,30 @@ public:
   }
 
   virtual bool has_extension(const string_class &extension_name) const = 0;
+
+private:
+  template <info::device param>
+  typename info::param_traits<info::device, param>::return_type
+  queryInfo() const {
+    if (is_host()) {
+      return get_device_info_host<param>();
+    }
+    return get_device_info<
+        typename info::param_traits<info::device, param>::return_type,
+        param>::_(this->get_handle());
+  }
+
+  // The availability and the reference count may change. The platform is
+  // not kept, as it holds its devices, this one included.
+  static bool isInfoCacheable(info::device Param) {
+    return Param != info::device::is_available &&
+           Param != info::device::reference_count &&
+           Param != info::device::platform;
+  }
+
+  mutable std::mutex MInfoMutex;
+  // The values are of the return types of their parameters.
+  mutable std::map<info::device, std::shared_ptr<void>> MInfoCache;
 };
 
 // TODO: 4.6.4 Partitioning into multiple SYCL devices
@@ -151,17 +187,18 @@ public:
     PI_CALL(RT::piDeviceGetInfo(
       m_device, PI_DEVICE_INFO_PLATFORM, sizeof(plt), &plt, 0));
 
-    // TODO: this possibly will violate common reference semantics,
-    // particularly, equality comparison may fail for two consecutive
-    // get_platform() on the same device, as it compares impl objects.
     return createSyclObjFromImpl<platform>(
-      std::make_shared<platform_impl_pi>(plt));
+        platform_impl_pi::getPlatformImpl(plt));
   }
 
   bool has_extension(const string_class &extension_name) const override {
-    string_class all_extension_names =
-        get_device_info<string_class, info::device::extensions>::_(m_device);
-    return (all_extension_names.find(extension_name) != std::string::npos);
+    const vector_class<string_class> Extensions =
+        get_info<info::device::extensions>();
+    return std::any_of(Extensions.begin(), Extensions.end(),
+                       [&extension_name](const string_class &Extension) {
+                         return Extension.find(extension_name) !=
+                                std::string::npos;
+                       });
   }
 
   vector_class<device>
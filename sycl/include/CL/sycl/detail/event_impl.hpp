@@ -12,6 +12,7 @@
 #include <CL/sycl/detail/event_info.hpp>
 #include <CL/sycl/stl.hpp>
 
+#include <atomic>
 #include <cassert>
 
 namespace cl {
@@ -48,6 +49,10 @@ public:
 
   void waitInternal() const;
 
+  // Returns true if the command the event is associated with is known to be
+  // completed. Doesn't block and doesn't enqueue anything.
+  bool isCompleted() const;
+
   void setComplete();
 
   // Warning. Returned reference will be invalid if event_impl was destroyed.
@@ -63,12 +68,18 @@ public:
 
   void setCommand(void *Command) { m_Command = Command; }
 
+  // Set the ticket of the last stream flush of the kernel, see
+  // stream_impl::flushAsync. Waiting for the event waits for the flush.
+  void setStreamFlushTicket(size_t Ticket) { m_StreamFlushTicket = Ticket; }
+
 private:
   cl_event m_Event = nullptr;
   ContextImplPtr m_Context;
   bool m_OpenCLInterop = false;
   bool m_HostEvent = true;
   void *m_Command = nullptr;
+  // Zero if the kernel has no streams.
+  std::atomic<size_t> m_StreamFlushTicket{0};
 };
 
 } // namespace detail
@@ -22,8 +22,8 @@ template <info::event_profiling Param> struct get_event_profiling_info_cl {
   static RetType _(cl_event Event) {
     RetType Result = 0;
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetEventProfilingInfo(Event, cl_profiling_info(Param),
-                                           sizeof(Result), &Result, nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetEventProfilingInfo)(
+        Event, cl_profiling_info(Param), sizeof(Result), &Result, nullptr));
     return Result;
   }
 };
@@ -34,8 +34,8 @@ template <info::event Param> struct get_event_info_cl {
   static RetType _(cl_event Event) {
     RetType Result = (RetType)0;
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetEventInfo(Event, cl_profiling_info(Param),
-                                  sizeof(Result), &Result, nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetEventInfo)(Event, cl_profiling_info(Param),
+                                             sizeof(Result), &Result, nullptr));
     return Result;
   }
 };
@@ -0,0 +1,40 @@
+//==----------- host_executor.hpp --- SYCL host device executor ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+/// Runs kernels of the host device on a pool of worker threads.
+///
+/// The number of threads is taken from the SYCL_HOST_NUM_THREADS environment
+/// variable and defaults to the number of hardware threads. Setting it to 1
+/// makes the host device execute all kernels serially in the submitting
+/// thread.
+class HostExecutor {
+public:
+  /// Returns the number of threads the kernels are executed on, including
+  /// the calling one.
+  static size_t getNumThreads();
+
+  /// Splits [0, Size) into contiguous subranges and calls Func(Begin, End)
+  /// for each of them, possibly concurrently. Returns when all the subranges
+  /// are processed. If Func throws, the remaining subranges are skipped and
+  /// the first exception is rethrown in the calling thread.
+  static void parallelFor(size_t Size,
+                          const std::function<void(size_t, size_t)> &Func);
+};
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
@@ -0,0 +1,57 @@
+//==---------- host_sub_group.hpp --- SYCL host device sub-groups ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+/// Runs the work-items of the nd_range kernels on the host device in
+/// sub-groups.
+///
+/// A work-group is split into sub-groups of MaxSize work-items consecutive in
+/// the local linear id, the last one may be smaller. The work-items of a
+/// sub-group run in lockstep on fibers of the thread executing the work-group:
+/// a work-item calling a sub-group function switches to the next one, and all
+/// of them continue once every work-item of the sub-group has reached it.
+///
+/// The first work-item of a work-group always runs on a fiber. If it doesn't
+/// call nd_item::get_sub_group(), the rest of the work-group is run directly
+/// on the thread, so the kernels not using sub-groups pay for a single fiber
+/// switch per work-group. The stack size of the fibers defaults to 1 MiB and
+/// can be set in bytes with the SYCL_HOST_SUB_GROUP_STACK_SIZE environment
+/// variable.
+class HostSubGroup {
+public:
+  static constexpr size_t MaxSize = 8;
+
+  /// Calls Func(I) for every local linear id I of a work-group of Size
+  /// work-items and returns when all of them are done. If Func throws, the
+  /// work-items of the failed sub-group still waiting in a sub-group function
+  /// are abandoned without unwinding, and the exception is rethrown.
+  static void runWorkGroup(size_t Size,
+                           const std::function<void(size_t)> &Func);
+
+  /// Records that the running work-item uses sub-groups.
+  static void markUsed();
+
+  /// Copies Size bytes at Data of the running work-item to the storage of its
+  /// sub-group, waits for all the work-items of the sub-group to do the same
+  /// and returns the storage. The data of the work-items is laid out in the
+  /// order of their sub-group local ids, every one takes Size bytes and stays
+  /// valid until the next call.
+  static const char *exchange(const void *Data, size_t Size);
+};
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
@@ -34,6 +34,20 @@ uint8_t getImageNumberChannels(image_channel_order Order);
 // utility function: Returns the number of bytes per image element
 uint8_t getImageElementSize(uint8_t NumChannels, image_channel_type Type);
 
+// utility functions: Return the OpenCL equivalents of the SYCL channel order
+// and type.
+cl_channel_order convertChannelOrder(image_channel_order Order);
+cl_channel_type convertChannelType(image_channel_type Type);
+
+// utility functions: Convert Count texels of the Order and Type format from
+// or to four floats per texel, as read and written by the host accessors.
+// The rgba unorm_int8, rgba fp32 and r fp32 texels are converted with plain
+// loops the compiler vectorizes, the other formats are not supported.
+void convertReadData(image_channel_order Order, image_channel_type Type,
+                     const void *Src, float *Dst, size_t Count);
+void convertWriteData(image_channel_order Order, image_channel_type Type,
+                      const float *Src, void *Dst, size_t Count);
+
 // validImageDataT: cl_int4, cl_uint4, cl_float4, cl_half4
 // To be used in get_access method. Uncomment after get_access is implemented.
 // template <typename T>
@@ -69,6 +83,30 @@ private:
     MSizeInBytes = MSlicePitch * NumSlices;
   }
 
+  cl_image_desc getImageDesc(bool InitFromHostPtr) const {
+    size_t WHD[3] = {1, 1, 1}; // Width, Height, Depth.
+    for (int I = 0; I < Dimensions; I++)
+      WHD[I] = MRange[I];
+
+    cl_image_desc Desc = {};
+    const cl_mem_object_type Types[] = {
+        CL_MEM_OBJECT_IMAGE1D, CL_MEM_OBJECT_IMAGE2D, CL_MEM_OBJECT_IMAGE3D};
+    Desc.image_type = Types[Dimensions - 1];
+    Desc.image_width = WHD[0];
+    Desc.image_height = WHD[1];
+    Desc.image_depth = WHD[2];
+    // The pitches must be 0 if there is no host pointer.
+    if (InitFromHostPtr) {
+      Desc.image_row_pitch = MRowPitch;
+      Desc.image_slice_pitch = (Dimensions == 3) ? MSlicePitch : 0;
+    }
+    return Desc;
+  }
+
+  cl_image_format getImageFormat() const {
+    return {convertChannelOrder(MOrder), convertChannelType(MType)};
+  }
+
   void handleHostData(void *HData) {
     MUserPtr = HData;
     // TO DO:
@@ -268,43 +306,33 @@ public:
     return MProps.get_property<propertyT>();
   }
 
-  // TODO: Implement this function.
+  ~image_impl() { Scheduler::getInstance().removeMemoryObject(this); }
+
   void *allocateHostMem() override {
-    if (true)
-      throw cl::sycl::feature_not_supported(
-          "HostMemoryAllocation Function Not Implemented for image class");
-    return nullptr;
-    // Implementation of the pure virtual function.
+    size_t AllocatorValueSize = sizeof(typename AllocatorT::value_type);
+    size_t AllocationSize = get_size() / AllocatorValueSize;
+    AllocationSize += (get_size() % AllocatorValueSize) ? 1 : 0;
+    return MAllocator.allocate(AllocationSize);
   }
 
-  // TODO: Implement this function.
   void *allocateMem(ContextImplPtr Context, bool InitFromUserData,
                     cl_event &OutEventToWait) override {
-    if (true)
-      throw cl::sycl::feature_not_supported(
-          "MemoryAllocation Function Not Implemented for image class");
-    return nullptr;
-    // Implementation of the pure virtual function.
+    OutEventToWait = nullptr;
+    void *UserPtr = InitFromUserData ? MUserPtr : nullptr;
+    return MemoryManager::allocateMemImage(
+        std::move(Context), this, UserPtr, MHostPtrReadOnly, get_size(),
+        getImageDesc(UserPtr != nullptr), getImageFormat());
   }
 
   MemObjType getType() const override { return MemObjType::IMAGE; }
 
-  // TODO: Implement this function.
   void releaseHostMem(void *Ptr) override {
-    if (true)
-      throw cl::sycl::feature_not_supported(
-          "HostMemoryRelease Function Not Implemented for Image class");
-    return;
-    // Implementation of the pure virtual function.
+    MAllocator.deallocate((typename AllocatorT::pointer)Ptr, get_size());
   }
 
-  // TODO: Implement this function.
   void releaseMem(ContextImplPtr Context, void *MemAllocation) override {
-    if (true)
-      throw cl::sycl::feature_not_supported(
-          "MemoryRelease Function Not Implemented for Image class");
-    return;
-    // Implementation of the pure virtual function.
+    return MemoryManager::releaseMemBuf(Context, this, MemAllocation,
+                                        MUserPtr);
   }
 
 private:
@@ -11,6 +11,9 @@
 #include <CL/sycl/access/access.hpp>
 #include <CL/sycl/detail/os_util.hpp> // for DLL_LOCAL used in int. header
 
+#include <map>
+#include <vector>
+
 namespace cl {
 namespace sycl {
 namespace detail {
@@ -51,6 +54,10 @@ struct kernel_param_desc_t {
   int offset;
 };
 
+// the values of the specialization constants a kernel is launched with, as
+// bytes per SpecId; the program of the kernel is built for these values
+using SpecConstantValues = std::map<unsigned int, std::vector<char>>;
+
 template <class KernelNameType> struct KernelInfo {
   static constexpr unsigned getNumParams() { return 0; }
   static const kernel_param_desc_t &getParamDesc(int Idx) {
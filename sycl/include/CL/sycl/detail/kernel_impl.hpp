@@ -35,13 +35,13 @@ public:
       : ClKernel(ClKernel), Context(SyclContext), ProgramImpl(ProgramImpl),
         IsCreatedFromSource(IsCreatedFromSource) {
     cl_context Context = nullptr;
-    CHECK_OCL_CODE(clGetKernelInfo(ClKernel, CL_KERNEL_CONTEXT, sizeof(Context),
-                                   &Context, nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetKernelInfo)(
+        ClKernel, CL_KERNEL_CONTEXT, sizeof(Context), &Context, nullptr));
     auto ContextImpl = detail::getSyclObjImpl(SyclContext);
     if (ContextImpl->getHandleRef() != Context)
       throw cl::sycl::invalid_parameter_error(
           "Input context must be the same as the context of cl_kernel");
-    CHECK_OCL_CODE(clRetainKernel(ClKernel));
+    CHECK_OCL_CODE(PI_TRACED(clRetainKernel)(ClKernel));
   }
 
   // Host kernel constructor
@@ -53,7 +53,7 @@ public:
     // TODO replace CHECK_OCL_CODE_NO_EXC to CHECK_OCL_CODE and
     // TODO catch an exception and put it to list of asynchronous exceptions
     if (!is_host()) {
-      CHECK_OCL_CODE_NO_EXC(clReleaseKernel(ClKernel));
+      CHECK_OCL_CODE_NO_EXC(PI_TRACED(clReleaseKernel)(ClKernel));
     }
   }
 
@@ -61,7 +61,7 @@ public:
     if (is_host()) {
       throw invalid_object_error("This instance of kernel is a host instance");
     }
-    CHECK_OCL_CODE(clRetainKernel(ClKernel));
+    CHECK_OCL_CODE(PI_TRACED(clRetainKernel)(ClKernel));
     return ClKernel;
   }
 
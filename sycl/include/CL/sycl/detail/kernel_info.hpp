@@ -23,15 +23,15 @@ template <info::kernel Param> struct get_kernel_info_cl<string_class, Param> {
   static string_class _(cl_kernel ClKernel) {
     size_t ResultSize;
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetKernelInfo(ClKernel, cl_kernel_info(Param), 0, nullptr,
-                                   &ResultSize));
+    CHECK_OCL_CODE(PI_TRACED(clGetKernelInfo)(ClKernel, cl_kernel_info(Param),
+                                              0, nullptr, &ResultSize));
     if (ResultSize == 0) {
       return "";
     }
     vector_class<char> Result(ResultSize);
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetKernelInfo(ClKernel, cl_kernel_info(Param), ResultSize,
-                                   Result.data(), nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetKernelInfo)(
+        ClKernel, cl_kernel_info(Param), ResultSize, Result.data(), nullptr));
     return string_class(Result.data());
   }
 };
@@ -40,8 +40,8 @@ template <info::kernel Param> struct get_kernel_info_cl<cl_uint, Param> {
   static cl_uint _(cl_kernel ClKernel) {
     cl_uint Result;
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetKernelInfo(ClKernel, cl_kernel_info(Param),
-                                   sizeof(cl_uint), &Result, nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetKernelInfo)(
+        ClKernel, cl_kernel_info(Param), sizeof(cl_uint), &Result, nullptr));
     return Result;
   }
 };
@@ -53,9 +53,9 @@ struct get_kernel_work_group_info_cl {
   static T _(cl_kernel ClKernel, cl_device_id ClDevice) {
     T Result;
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetKernelWorkGroupInfo(ClKernel, ClDevice,
-                                            cl_kernel_work_group_info(Param),
-                                            sizeof(T), &Result, nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetKernelWorkGroupInfo)(
+        ClKernel, ClDevice, cl_kernel_work_group_info(Param), sizeof(T),
+        &Result, nullptr));
     return Result;
   }
 };
@@ -65,7 +65,7 @@ struct get_kernel_work_group_info_cl<cl::sycl::range<3>, Param> {
   static cl::sycl::range<3> _(cl_kernel ClKernel, cl_device_id ClDevice) {
     size_t Result[3];
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetKernelWorkGroupInfo(
+    CHECK_OCL_CODE(PI_TRACED(clGetKernelWorkGroupInfo)(
         ClKernel, ClDevice, cl_kernel_work_group_info(Param),
         sizeof(size_t) * 3, Result, nullptr));
     return cl::sycl::range<3>(Result[0], Result[1], Result[2]);
@@ -108,7 +108,7 @@ struct get_kernel_sub_group_info_cl {
   static TOut _(cl_kernel ClKernel, cl_device_id ClDevice) {
     TOut Result;
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetKernelSubGroupInfo(
+    CHECK_OCL_CODE(PI_TRACED(clGetKernelSubGroupInfo)(
         ClKernel, ClDevice, cl_kernel_sub_group_info(Param), 0, nullptr,
         sizeof(TOut), &Result, nullptr));
     return Result;
@@ -120,7 +120,7 @@ struct get_kernel_sub_group_info_with_input_cl {
   static TOut _(cl_kernel ClKernel, cl_device_id ClDevice, TIn In) {
     TOut Result;
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetKernelSubGroupInfo(
+    CHECK_OCL_CODE(PI_TRACED(clGetKernelSubGroupInfo)(
         ClKernel, ClDevice, cl_kernel_sub_group_info(Param), sizeof(TIn), &In,
         sizeof(TOut), &Result, nullptr));
     return Result;
@@ -134,7 +134,7 @@ struct get_kernel_sub_group_info_with_input_cl<cl::sycl::range<3>, Param,
                               size_t In) {
     size_t Result[3];
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetKernelSubGroupInfo(
+    CHECK_OCL_CODE(PI_TRACED(clGetKernelSubGroupInfo)(
         ClKernel, ClDevice, cl_kernel_sub_group_info(Param), sizeof(size_t),
         &In, sizeof(size_t) * 3, Result, nullptr));
     return cl::sycl::range<3>(Result[0], Result[1], Result[2]);
@@ -149,7 +149,7 @@ struct get_kernel_sub_group_info_with_input_cl<size_t, Param,
     size_t Input[3] = {In[0], In[1], In[2]};
     size_t Result;
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetKernelSubGroupInfo(
+    CHECK_OCL_CODE(PI_TRACED(clGetKernelSubGroupInfo)(
         ClKernel, ClDevice, cl_kernel_sub_group_info(Param), sizeof(size_t) * 3,
         Input, sizeof(size_t), &Result, nullptr));
     return Result;
@@ -55,7 +55,17 @@ public:
                                  const ContextImplPtr &InteropContext,
                                  cl_event &OutEventToWait);
 
+  // Allocates image in specified context taking into account situations such
+  // as host ptr provided by user. The images with no host pointer are recycled
+  // through the context memory pool.
+  static void *allocateMemImage(ContextImplPtr TargetContext,
+                                SYCLMemObjT *MemObj, void *UserPtr,
+                                bool HostPtrReadOnly, size_t Size,
+                                const cl_image_desc &Desc,
+                                const cl_image_format &Format);
+
   // Releases buffer. TargetContext should be device one(not host).
+  // Images are released the same way.
   static void releaseMemBuf(ContextImplPtr TargetContext, SYCLMemObjT *MemObj,
                             void *MemAllocation, void *UserPtr);
 
@@ -86,6 +96,17 @@ public:
   static void unmap(SYCLMemObjT *SYCLMemObj, void *Mem, QueueImplPtr Queue,
                     void *MappedPtr, std::vector<cl_event> DepEvents,
                     bool UseExclusiveQueue, cl_event &OutEvent);
+
+  // Copies Len bytes between USM allocations of the context of Queue or host
+  // memory.
+  static void copy_usm(const void *SrcMem, QueueImplPtr Queue, size_t Len,
+                       void *DstMem, std::vector<cl_event> DepEvents,
+                       cl_event &OutEvent);
+
+  // Sets Len bytes of a USM allocation of the context of Queue to the byte
+  // Pattern.
+  static void fill_usm(void *Mem, QueueImplPtr Queue, size_t Len, int Pattern,
+                       std::vector<cl_event> DepEvents, cl_event &OutEvent);
 };
 } // namespace detail
 } // namespace sycl
@@ -0,0 +1,122 @@
+//==------------ memory_pool.hpp --- Device memory object pool -------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <CL/sycl/detail/common.hpp>
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+/// Recycles the cl_mem objects of a single context.
+///
+/// Released buffers are kept in the pool and handed out again to subsequent
+/// allocations of the same size class and flags instead of going through the
+/// driver. Sizes are rounded up to size classes, four per power of two, so a
+/// reused buffer is at most 25% larger than requested. Images are only reused
+/// for the allocations of the same format and dimensions.
+///
+/// The total size of the free buffers is kept below the high-water mark: the
+/// buffers released beyond it are freed immediately. The mark defaults to
+/// 256 MiB and can be set in bytes with the SYCL_MEM_POOL_HIGH_WATER_MARK
+/// environment variable, 0 disables the pooling.
+class MemoryPool {
+public:
+  explicit MemoryPool(cl_context Context);
+  ~MemoryPool();
+
+  MemoryPool(const MemoryPool &) = delete;
+  MemoryPool &operator=(const MemoryPool &) = delete;
+
+  /// Returns a buffer of at least Size bytes created with Flags, either a free
+  /// one from the pool or a new one.
+  cl_mem allocate(cl_mem_flags Flags, size_t Size);
+
+  /// Returns an image of Format and Desc created with Flags, either a free one
+  /// from the pool or a new one. Size is the size of the image in bytes.
+  cl_mem allocateImage(cl_mem_flags Flags, const cl_image_format &Format,
+                       const cl_image_desc &Desc, size_t Size);
+
+  /// Returns Mem to the pool. Returns false if Mem was not allocated by the
+  /// pool, in which case the caller is responsible for releasing it.
+  bool release(cl_mem Mem);
+
+  /// Frees the free buffers, the least recently released first, until their
+  /// total size is not greater than TargetSize.
+  void trim(size_t TargetSize = 0);
+
+  /// Returns the total size of the free buffers kept by the pool.
+  size_t getFreeSize() const;
+
+  /// Returns the pool limit of the free buffers total size.
+  size_t getHighWaterMark() const;
+
+  /// Sets the limit of the free buffers total size and trims the pool to it.
+  void setHighWaterMark(size_t Mark);
+
+  /// Returns true if the flags allow to reuse a buffer for an unrelated
+  /// allocation, i.e. the buffer is not bound to any host memory.
+  static bool isPoolable(cl_mem_flags Flags);
+
+private:
+  struct PoolKey {
+    cl_mem_flags Flags;
+    size_t Size;
+    // The image fields are zero for the buffers.
+    cl_mem_object_type ImageType = 0;
+    cl_channel_order Order = 0;
+    cl_channel_type ChannelType = 0;
+    size_t Width = 0;
+    size_t Height = 0;
+    size_t Depth = 0;
+    size_t ArraySize = 0;
+
+    bool operator<(const PoolKey &RHS) const {
+      return std::tie(Flags, Size, ImageType, Order, ChannelType, Width,
+                      Height, Depth, ArraySize) <
+             std::tie(RHS.Flags, RHS.Size, RHS.ImageType, RHS.Order,
+                      RHS.ChannelType, RHS.Width, RHS.Height, RHS.Depth,
+                      RHS.ArraySize);
+    }
+  };
+
+  struct FreeBuffer {
+    cl_mem Mem;
+    // Position in the release order, the smaller the older.
+    size_t Age;
+  };
+
+  static size_t getSizeClass(size_t Size);
+  // Returns a free object of Key or creates a new one of AllocSize bytes with
+  // Create, which has the clCreate* signature without the context.
+  template <typename CreateFn>
+  cl_mem allocateImpl(const PoolKey &Key, size_t AllocSize, CreateFn Create);
+  void trimImpl(size_t TargetSize);
+
+  cl_context MContext;
+  size_t MHighWaterMark;
+  size_t MFreeSize = 0;
+  size_t MReleaseCounter = 0;
+  std::map<PoolKey, std::vector<FreeBuffer>> MFreeBuffers;
+  // All buffers created by the pool and not freed yet, both used and free.
+  std::unordered_map<cl_mem, PoolKey> MOwnedBuffers;
+  mutable std::mutex MMutex;
+};
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
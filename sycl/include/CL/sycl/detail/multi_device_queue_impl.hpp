@@ -0,0 +1,69 @@
+//==--- multi_device_queue_impl.hpp --- SYCL multi-device queue ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <CL/sycl/context.hpp>
+#include <CL/sycl/event.hpp>
+#include <CL/sycl/queue.hpp>
+#include <CL/sycl/stl.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+// Holds a queue per device of a context and the throughput measured for each
+// of them.
+class multi_device_queue_impl {
+public:
+  multi_device_queue_impl(const context &Context,
+                          const async_handler &AsyncHandler);
+
+  const context &getContext() const { return MContext; }
+
+  size_t getNumDevices() const { return MDevices.size(); }
+
+  const queue &getQueue(size_t Index) const;
+
+  vector_class<float> getWeights() const;
+
+  vector_class<std::pair<size_t, size_t>> partition(size_t Size,
+                                                    size_t Granularity) const;
+
+  void addSubmission(size_t DeviceIndex, const event &Event,
+                     size_t WorkItems);
+
+  void wait();
+
+private:
+  struct Submission {
+    event Event;
+    size_t WorkItems;
+  };
+
+  struct DeviceState {
+    queue Queue;
+    // The number of compute units, used until the throughput is measured.
+    float Estimate;
+    // Work-items per nanosecond, 0 if not measured yet.
+    float Throughput;
+    vector_class<Submission> Pending;
+  };
+
+  context MContext;
+  vector_class<DeviceState> MDevices;
+  mutable std::mutex MMutex;
+};
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
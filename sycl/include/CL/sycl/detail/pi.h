@@ -78,8 +78,17 @@ typedef _pi_platform_info           pi_platform_info;
 typedef _pi_device_type             pi_device_type;
 typedef _pi_device_info             pi_device_info;
 
-// Opaque data type for compatibility with OpenMP.
-typedef void * _pi_offload_entry;
+/// Offload entry of a device binary, matching the __tgt_offload_entry
+/// structure generated by the clang-offload-wrapper tool. SYCL uses the name
+/// only: the entries of a device binary are the kernels it contains.
+struct _pi_offload_entry_struct {
+  void *addr;
+  char *name;
+  size_t size;
+  int32_t flags;
+  int32_t reserved;
+};
+typedef _pi_offload_entry_struct * _pi_offload_entry;
 
 /// Types of device binary.
 typedef uint8_t pi_device_binary_type;
@@ -88,6 +97,10 @@ static const uint8_t PI_DEVICE_BINARY_TYPE_NATIVE  = 1; // specific to a device
 // portable binary types go next
 static const uint8_t PI_DEVICE_BINARY_TYPE_SPIRV   = 2;        // SPIR-V
 static const uint8_t PI_DEVICE_BINARY_TYPE_LLVMIR_BITCODE = 3; // LLVM bitcode
+/// Set in the Format field on top of the binary type when the binary data is
+/// compressed with zlib. The data then starts with the size of the
+/// uncompressed binary as a little-endian 64-bit integer.
+static const uint8_t PI_DEVICE_BINARY_FLAG_COMPRESSED = 0x80;
 
 // Device binary descriptor version supported by this library.
 static const uint16_t PI_DEVICE_BINARY_VERSION = 1;
@@ -129,7 +142,8 @@ struct pi_device_binary_struct {
   const unsigned char *BinaryStart;
   /// Pointer to the target code end
   const unsigned char *BinaryEnd;
-  /// the offload entry table (not used, for compatibility with OpenMP)
+  /// the offload entry table naming the kernels in the binary, empty if the
+  /// binary holds all the kernels of the module
   _pi_offload_entry EntriesBegin;
   _pi_offload_entry EntriesEnd;
 };
@@ -12,6 +12,12 @@
 
 #include <CL/sycl/detail/pi.h>
 
+#include <chrono>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
 namespace cl {
 namespace sycl {
 namespace detail {
@@ -54,15 +60,117 @@ void pi_assert(bool condition, const char *message = 0);
 #define PI_ASSERT(cond, msg) \
   pi_assert(condition, "assert @ " __FILE__ ":" _PI_STRINGIZE(__LINE__) msg);
 
+// Tracing of the back-end calls.
+//
+// With the SYCL_BE_TRACE environment variable set, every traced call is
+// printed to the standard output. With SYCL_PI_TRACE_FILE set to a file name,
+// the calls are recorded with their arguments, result, duration and calling
+// thread, and written to that file at the program exit in the Chrome trace
+// event format, which can be loaded into chrome://tracing.
+//
+using pi_clock = std::chrono::steady_clock;
+
+// Returns true if either kind of tracing is enabled.
+bool pi_trace_enabled();
+// Reports the start of the call \p name with the printed arguments \p args.
+void pi_trace_begin(const char *name, const std::string &args);
+// Reports the end of the call started with \ref pi_trace_begin.
+void pi_trace_end(const char *name, const std::string &args,
+                  const std::string &result, pi_clock::time_point start,
+                  pi_clock::time_point end);
+
+template <class T> void pi_print_arg(std::ostream &os, const T &arg) {
+  os << arg;
+}
+template <class T> void pi_print_arg(std::ostream &os, T *arg) {
+  os << static_cast<const void *>(arg);
+}
+template <class R, class... ArgsT>
+void pi_print_arg(std::ostream &os, R (*arg)(ArgsT...)) {
+  os << (arg ? "<function>" : "0");
+}
+inline void pi_print_arg(std::ostream &os, const char *arg) {
+  if (arg)
+    os << '"' << arg << '"';
+  else
+    os << "0";
+}
+
+template <class... ArgsT> std::string pi_print_args(const ArgsT &... args) {
+  std::ostringstream os;
+  const char *separator = "";
+  int expand[] = {0, (os << separator, pi_print_arg(os, args),
+                      separator = ", ", 0)...};
+  (void)expand;
+  return os.str();
+}
+
+// Traces a single call, does nothing if tracing is disabled.
+class pi_trace_scope {
+public:
+  explicit pi_trace_scope(const char *name)
+      : m_name(name), m_enabled(pi_trace_enabled()) {}
+
+  bool enabled() const { return m_enabled; }
+
+  void begin(std::string args = std::string()) {
+    if (!m_enabled)
+      return;
+    m_args = std::move(args);
+    pi_trace_begin(m_name, m_args);
+    m_start = pi_clock::now();
+  }
+
+  template <class R> void end(const R &result) {
+    if (m_enabled)
+      pi_trace_end(m_name, m_args, pi_print_args(result), m_start,
+                   pi_clock::now());
+  }
+
+private:
+  const char *m_name;
+  const bool m_enabled;
+  std::string m_args;
+  pi_clock::time_point m_start;
+};
+
+// Calls a back-end function and traces the call. The parameters have the
+// exact types of the function, so the arguments convert the same way as in a
+// direct call.
+template <class FnT> class pi_traced_call;
+template <class R, class... ParamsT> class pi_traced_call<R (*)(ParamsT...)> {
+public:
+  pi_traced_call(const char *name, R (*fn)(ParamsT...))
+      : m_name(name), m_fn(fn) {}
+
+  R operator()(ParamsT... args) const {
+    pi_trace_scope trace(m_name);
+    if (!trace.enabled())
+      return m_fn(args...);
+    trace.begin(pi_print_args(args...));
+    R result = m_fn(args...);
+    trace.end(result);
+    return result;
+  }
+
+private:
+  const char *m_name;
+  R (*m_fn)(ParamsT...);
+};
+
+// Calls the back-end function \p api traced, e.g.
+//   PI_TRACED(clReleaseEvent)(Event);
+#define PI_TRACED(api)                                                         \
+  ::cl::sycl::detail::pi_traced_call<decltype(&api)>(#api, &api)
+
 // This does the call, the trace and the check for no errors.
 // TODO: remove dependency on CHECK_OCL_CODE.
-// TODO: implement a more mature and controllable tracing of PI calls.
-void pi_trace(const char *format, ...);
-#define PI_CALL(pi_call) {                  \
-  pi_trace("PI ---> %s\n", #pi_call);       \
-  auto __result = (pi_call);                \
-  pi_trace("PI <--- %d\n", __result);       \
-  CHECK_OCL_CODE(__result);                 \
+#define PI_CALL(pi_call) {                                                     \
+  ::cl::sycl::detail::pi_trace_scope __trace(#pi_call);                       \
+  __trace.begin();                                                             \
+  auto __result = (pi_call);                                                   \
+  __trace.end(__result);                                                       \
+  CHECK_OCL_CODE(__result);                                                    \
 }
 
 // Want all the needed casts be explicit, do not define conversion operators.
@@ -13,6 +13,8 @@
 #include <CL/sycl/detail/platform_info.hpp>
 #include <CL/sycl/stl.hpp>
 
+#include <memory>
+
 // 4.6.2 Platform class
 namespace cl {
 namespace sycl {
@@ -23,6 +25,8 @@ class device;
 
 namespace detail {
 
+class device_impl;
+
 class platform_impl {
 public:
   platform_impl() = default;
@@ -73,8 +77,28 @@ public:
 
   static vector_class<platform> get_platforms();
 
+  /// Returns the impl of the native platform found by the discovery, or a new
+  /// one if the discovery didn't find it.
+  static std::shared_ptr<platform_impl_pi>
+  getPlatformImpl(RT::pi_platform Platform);
+
+  /// Returns the impl of the native root device found by the discovery, or
+  /// nullptr if the discovery didn't find it.
+  static std::shared_ptr<device_impl> getDeviceImpl(RT::pi_device Device);
+
 private:
+  // The platforms and their root devices are discovered once per process and
+  // kept until its end, so the platform and device objects are the same
+  // every time and the device info is queried from the driver once.
+  static const vector_class<std::shared_ptr<platform_impl_pi>> &
+  getDiscoveredPlatforms();
+
+  vector_class<device> queryDevices(info::device_type deviceType) const;
+
   RT::pi_platform m_platform = 0;
+  // All the devices of a discovered platform.
+  vector_class<device> m_Devices;
+  bool m_IsDiscovered = false;
 }; // class platform_opencl
 
 // TODO: implement extension management
@@ -82,10 +82,10 @@ public:
         ClPrograms.push_back(Prg->ClProgram);
       }
       cl_int Err = CL_SUCCESS;
-      ClProgram = clLinkProgram(detail::getSyclObjImpl(Context)->getHandleRef(),
-                                ClDevices.size(), ClDevices.data(),
-                                LinkOptions.c_str(), ClPrograms.size(),
-                                ClPrograms.data(), nullptr, nullptr, &Err);
+      ClProgram = PI_TRACED(clLinkProgram)(
+          detail::getSyclObjImpl(Context)->getHandleRef(), ClDevices.size(),
+          ClDevices.data(), LinkOptions.c_str(), ClPrograms.size(),
+          ClPrograms.data(), nullptr, nullptr, &Err);
       CHECK_OCL_CODE_THROW(Err, compile_program_error);
     }
   }
@@ -94,12 +94,13 @@ public:
       : ClProgram(ClProgram), Context(Context), IsLinkable(true) {
     // TODO handle the case when cl_program build is in progress
     cl_uint NumDevices;
-    CHECK_OCL_CODE(clGetProgramInfo(ClProgram, CL_PROGRAM_NUM_DEVICES,
-                                    sizeof(cl_uint), &NumDevices, nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetProgramInfo)(
+        ClProgram, CL_PROGRAM_NUM_DEVICES, sizeof(cl_uint), &NumDevices,
+        nullptr));
     vector_class<cl_device_id> ClDevices(NumDevices);
-    CHECK_OCL_CODE(clGetProgramInfo(ClProgram, CL_PROGRAM_DEVICES,
-                                    sizeof(cl_device_id) * NumDevices,
-                                    ClDevices.data(), nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetProgramInfo)(
+        ClProgram, CL_PROGRAM_DEVICES, sizeof(cl_device_id) * NumDevices,
+        ClDevices.data(), nullptr));
     vector_class<device> SyclContextDevices = Context.get_devices();
 
     // Keep only the subset of the devices (associated with context) that
@@ -116,17 +117,17 @@ public:
     Devices = SyclContextDevices;
     // TODO check build for each device instead
     cl_program_binary_type BinaryType;
-    CHECK_OCL_CODE(clGetProgramBuildInfo(
+    CHECK_OCL_CODE(PI_TRACED(clGetProgramBuildInfo)(
         ClProgram, Devices[0].get(), CL_PROGRAM_BINARY_TYPE,
         sizeof(cl_program_binary_type), &BinaryType, nullptr));
     size_t Size = 0;
-    CHECK_OCL_CODE(clGetProgramBuildInfo(ClProgram, Devices[0].get(),
-                                         CL_PROGRAM_BUILD_OPTIONS, 0, nullptr,
-                                         &Size));
+    CHECK_OCL_CODE(PI_TRACED(clGetProgramBuildInfo)(ClProgram, Devices[0].get(),
+                                                    CL_PROGRAM_BUILD_OPTIONS, 0,
+                                                    nullptr, &Size));
     std::vector<char> OptionsVector(Size);
-    CHECK_OCL_CODE(clGetProgramBuildInfo(ClProgram, Devices[0].get(),
-                                         CL_PROGRAM_BUILD_OPTIONS, Size,
-                                         OptionsVector.data(), nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetProgramBuildInfo)(
+        ClProgram, Devices[0].get(), CL_PROGRAM_BUILD_OPTIONS, Size,
+        OptionsVector.data(), nullptr));
     string_class Options(OptionsVector.begin(), OptionsVector.end());
     switch (BinaryType) {
     case CL_PROGRAM_BINARY_TYPE_NONE:
@@ -143,7 +144,7 @@ public:
       LinkOptions = "";
       BuildOptions = Options;
     }
-    CHECK_OCL_CODE(clRetainProgram(ClProgram));
+    CHECK_OCL_CODE(PI_TRACED(clRetainProgram)(ClProgram));
   }
 
   program_impl(const context &Context, cl_kernel ClKernel)
@@ -155,7 +156,7 @@ public:
     // TODO replace CHECK_OCL_CODE_NO_EXC to CHECK_OCL_CODE and
     // catch an exception and put it to list of asynchronous exceptions
     if (!is_host() && ClProgram != nullptr) {
-      CHECK_OCL_CODE_NO_EXC(clReleaseProgram(ClProgram));
+      CHECK_OCL_CODE_NO_EXC(PI_TRACED(clReleaseProgram)(ClProgram));
     }
   }
 
@@ -164,7 +165,7 @@ public:
     if (is_host()) {
       throw invalid_object_error("This instance of program is a host instance");
     }
-    CHECK_OCL_CODE(clRetainProgram(ClProgram));
+    CHECK_OCL_CODE(PI_TRACED(clRetainProgram)(ClProgram));
     return ClProgram;
   }
 
@@ -176,7 +177,7 @@ public:
     // TODO Check for existence of kernel
     if (!is_host()) {
       OSModuleHandle M = OSUtil::getOSModuleHandle(AddressInThisModule);
-      create_cl_program_with_il(M);
+      create_cl_program_with_il(M, KernelInfo<KernelT>::getName());
       compile(CompileOptions);
     }
     State = program_state::compiled;
@@ -199,7 +200,7 @@ public:
     // TODO Check for existence of kernel
     if (!is_host()) {
       OSModuleHandle M = OSUtil::getOSModuleHandle(AddressInThisModule);
-      create_cl_program_with_il(M);
+      create_cl_program_with_il(M, KernelInfo<KernelT>::getName());
       build(BuildOptions);
     }
     State = program_state::linked;
@@ -221,10 +222,10 @@ public:
     if (!is_host()) {
       vector_class<cl_device_id> ClDevices(get_cl_devices());
       cl_int Err;
-      ClProgram =
-          clLinkProgram(detail::getSyclObjImpl(Context)->getHandleRef(),
-                        ClDevices.size(), ClDevices.data(), LinkOptions.c_str(),
-                        1, &ClProgram, nullptr, nullptr, &Err);
+      ClProgram = PI_TRACED(clLinkProgram)(
+          detail::getSyclObjImpl(Context)->getHandleRef(), ClDevices.size(),
+          ClDevices.data(), LinkOptions.c_str(), 1, &ClProgram, nullptr,
+          nullptr, &Err);
       CHECK_OCL_CODE_THROW(Err, compile_program_error);
       this->LinkOptions = LinkOptions;
       BuildOptions = LinkOptions;
@@ -291,18 +292,18 @@ public:
     vector_class<vector_class<char>> Result;
     if (!is_host()) {
       vector_class<size_t> BinarySizes(Devices.size());
-      CHECK_OCL_CODE(clGetProgramInfo(ClProgram, CL_PROGRAM_BINARY_SIZES,
-                                      sizeof(size_t) * BinarySizes.size(),
-                                      BinarySizes.data(), nullptr));
+      CHECK_OCL_CODE(PI_TRACED(clGetProgramInfo)(
+          ClProgram, CL_PROGRAM_BINARY_SIZES,
+          sizeof(size_t) * BinarySizes.size(), BinarySizes.data(), nullptr));
 
       vector_class<char *> Pointers;
       for (size_t I = 0; I < BinarySizes.size(); ++I) {
         Result.emplace_back(BinarySizes[I]);
         Pointers.push_back(Result[I].data());
       }
-      CHECK_OCL_CODE(clGetProgramInfo(ClProgram, CL_PROGRAM_BINARIES,
-                                      sizeof(char *) * Pointers.size(),
-                                      Pointers.data(), nullptr));
+      CHECK_OCL_CODE(PI_TRACED(clGetProgramInfo)(
+          ClProgram, CL_PROGRAM_BINARIES, sizeof(char *) * Pointers.size(),
+          Pointers.data(), nullptr));
     }
     return Result;
   }
@@ -320,9 +321,11 @@ public:
   program_state get_state() const { return State; }
 
 private:
-  void create_cl_program_with_il(OSModuleHandle M) {
+  void create_cl_program_with_il(OSModuleHandle M,
+                                 const string_class &KernelName) {
     assert(!ClProgram && "This program already has an encapsulated cl_program");
-    ClProgram = ProgramManager::getInstance().createOpenCLProgram(M, Context);
+    ClProgram = ProgramManager::getInstance().createOpenCLProgram(M, Context,
+                                                                  KernelName);
   }
 
   void create_cl_program_with_source(const string_class &Source) {
@@ -330,7 +333,7 @@ private:
     cl_int Err;
     const char *Src = Source.c_str();
     size_t Size = Source.size();
-    ClProgram = clCreateProgramWithSource(
+    ClProgram = PI_TRACED(clCreateProgramWithSource)(
         detail::getSyclObjImpl(Context)->getHandleRef(), 1, &Src, &Size, &Err);
     CHECK_OCL_CODE(Err);
   }
@@ -338,9 +341,9 @@ private:
   void compile(const string_class &Options) {
     vector_class<cl_device_id> ClDevices(get_cl_devices());
     // TODO make the exception message more descriptive
-    if (clCompileProgram(ClProgram, ClDevices.size(), ClDevices.data(),
-                         Options.c_str(), 0, nullptr, nullptr, nullptr,
-                         nullptr) != CL_SUCCESS) {
+    if (PI_TRACED(clCompileProgram)(
+        ClProgram, ClDevices.size(), ClDevices.data(), Options.c_str(), 0,
+        nullptr, nullptr, nullptr, nullptr) != CL_SUCCESS) {
       throw compile_program_error("Program compilation error");
     }
     CompileOptions = Options;
@@ -350,8 +353,9 @@ private:
   void build(const string_class &Options) {
     vector_class<cl_device_id> ClDevices(get_cl_devices());
     // TODO make the exception message more descriptive
-    if (clBuildProgram(ClProgram, ClDevices.size(), ClDevices.data(),
-                       Options.c_str(), nullptr, nullptr) != CL_SUCCESS) {
+    if (PI_TRACED(clBuildProgram)(ClProgram, ClDevices.size(), ClDevices.data(),
+                                  Options.c_str(), nullptr,
+                                  nullptr) != CL_SUCCESS) {
       throw compile_program_error("Program build error");
     }
     BuildOptions = Options;
@@ -367,11 +371,12 @@ private:
 
   bool has_cl_kernel(const string_class &KernelName) const {
     size_t Size;
-    CHECK_OCL_CODE(clGetProgramInfo(ClProgram, CL_PROGRAM_KERNEL_NAMES, 0,
-                                    nullptr, &Size));
+    CHECK_OCL_CODE(PI_TRACED(clGetProgramInfo)(
+        ClProgram, CL_PROGRAM_KERNEL_NAMES, 0, nullptr, &Size));
     string_class ClResult(Size, ' ');
-    CHECK_OCL_CODE(clGetProgramInfo(ClProgram, CL_PROGRAM_KERNEL_NAMES,
-                                    ClResult.size(), &ClResult[0], nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetProgramInfo)(
+        ClProgram, CL_PROGRAM_KERNEL_NAMES, ClResult.size(), &ClResult[0],
+        nullptr));
     // Get rid of the null terminator
     ClResult.pop_back();
     vector_class<string_class> KernelNames(split_string(ClResult, ';'));
@@ -385,7 +390,8 @@ private:
 
   cl_kernel get_cl_kernel(const string_class &KernelName) const {
     cl_int Err;
-    cl_kernel ClKernel = clCreateKernel(ClProgram, KernelName.c_str(), &Err);
+    cl_kernel ClKernel = PI_TRACED(clCreateKernel)(ClProgram,
+                                                   KernelName.c_str(), &Err);
     if (Err == CL_INVALID_KERNEL_NAME) {
       throw invalid_object_error(
           "This instance of program does not contain the kernel requested");
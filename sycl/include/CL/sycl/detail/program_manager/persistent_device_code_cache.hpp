@@ -0,0 +1,58 @@
+//==---- persistent_device_code_cache.hpp --- On-disk device code cache ----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <CL/sycl/detail/common.hpp>
+#include <CL/sycl/stl.hpp>
+
+#include <cstddef>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+/// Stores native device binaries produced by the JIT on the disk, so that
+/// subsequent processes can skip the SPIR-V compilation of the same image.
+///
+/// The cache is switched off by default and is enabled by setting the
+/// SYCL_CACHE_DIR environment variable to a writable directory. Each entry is
+/// a single file named after a key built from the device image contents, the
+/// target device, its driver version and the build options. The total size of
+/// the cache directory is kept below SYCL_CACHE_MAX_SIZE bytes (1 GiB by
+/// default) by removing the least recently used entries.
+class PersistentDeviceCodeCache {
+public:
+  /// Returns true if the persistent cache is enabled for this process.
+  static bool isEnabled();
+
+  /// Builds the cache key of the image [Data, Data + Size) built for
+  /// \p Device with \p BuildOptions.
+  static string_class getKey(const unsigned char *Data, size_t Size,
+                             cl_device_id Device,
+                             const string_class &BuildOptions);
+
+  /// Reads the native binary stored under \p Key into \p Binary. Returns false
+  /// if there is no such entry or it can't be read.
+  static bool getItem(const string_class &Key,
+                      vector_class<unsigned char> &Binary);
+
+  /// Stores the native binary of the built single-device \p Program under
+  /// \p Key and evicts old entries if the cache has grown over its limit.
+  /// Failures are not fatal: the cache is just not updated.
+  static void putItem(const string_class &Key, cl_program Program);
+
+private:
+  static string_class getCacheDir();
+  static size_t getMaxCacheSize();
+  static void evictItems(const string_class &Dir);
+};
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
@@ -10,10 +10,16 @@
 
 #include <CL/sycl/detail/pi.hpp>
 #include <CL/sycl/detail/common.hpp>
+#include <CL/sycl/detail/kernel_desc.hpp>
 #include <CL/sycl/detail/os_util.hpp>
 #include <CL/sycl/stl.hpp>
 
+#include <atomic>
+#include <future>
 #include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 // +++ Entry points referenced by the offload wrapper object {
@@ -49,12 +55,36 @@ public:
   // Can only be called after staticInit is done.
   static ProgramManager &getInstance();
   cl_program createOpenCLProgram(OSModuleHandle M, const context &Context,
+                                 const string_class &KernelName = "",
                                  DeviceImage **I = nullptr) {
-    return loadProgram(M, Context, I);
+    return loadProgram(M, Context, KernelName, SpecConstantValues(), I);
   }
-  cl_program getBuiltOpenCLProgram(OSModuleHandle M, const context &Context);
-  cl_kernel getOrCreateKernel(OSModuleHandle M, const context &Context,
-                              const string_class &KernelName);
+  /// Returns the program of module \p M built for \p Context. If
+  /// \p KernelName is not empty and the device code of the module is split,
+  /// the program is built from the device image holding that kernel only.
+  /// The program is specialized for the values of the specialization
+  /// constants \p SpecConsts, one program being built per set of values.
+  cl_program
+  getBuiltOpenCLProgram(OSModuleHandle M, const context &Context,
+                        const string_class &KernelName = "",
+                        const SpecConstantValues &SpecConsts = {});
+  /// Returns a kernel object for the kernel \p KernelName of module \p M
+  /// built for \p Context. The kernel object is used exclusively by the caller
+  /// until it gives it back with \ref releaseKernel, so threads launching the
+  /// same kernel concurrently don't share kernel arguments. A free cached
+  /// kernel object is returned if there is one, otherwise a new one is created.
+  /// The kernel comes from the program specialized for \p SpecConsts.
+  cl_kernel acquireKernel(OSModuleHandle M, const context &Context,
+                          const string_class &KernelName,
+                          const SpecConstantValues &SpecConsts = {});
+  /// Makes \p Kernel obtained from \ref acquireKernel available again.
+  void releaseKernel(cl_kernel Kernel);
+  /// Returns the number of \ref acquireKernel calls served by a cached kernel
+  /// object.
+  size_t getKernelCacheHits() const { return m_KernelCacheHits; }
+  /// Returns the number of \ref acquireKernel calls that created a new
+  /// kernel object.
+  size_t getKernelCacheMisses() const { return m_KernelCacheMisses; }
   cl_program getClProgramFromClKernel(cl_kernel ClKernel);
 
   void addImages(pi_device_binaries DeviceImages);
@@ -62,14 +92,40 @@ public:
   void debugDumpBinaryImage(const DeviceImage *Img) const;
 
 private:
+  /// Creates a native program from the device image of module \p M most
+  /// suitable for \p Context, among the ones holding \p KernelName if the
+  /// device code is split (see \ref getDeviceImages), with the
+  /// specialization constants set to \p SpecConsts. If
+  /// \p PersistentCacheKey is not null, the
+  /// program may be created from a native binary found in the persistent device
+  /// code cache. In this case \p PersistentCacheKey is set to an empty string,
+  /// otherwise it is set to the key the built program should be stored with,
+  /// or left empty if the program can't be cached.
   RT::pi_program loadProgram(OSModuleHandle M, const context &Context,
-                             DeviceImage **I = nullptr);
+                             const string_class &KernelName,
+                             const SpecConstantValues &SpecConsts,
+                             DeviceImage **I = nullptr,
+                             string_class *PersistentCacheKey = nullptr);
+  /// Returns the device images of module \p M listing \p KernelName in their
+  /// entries, or all the images of the module if there are none, or nullptr
+  /// if the module has no images. Must be called with the
+  /// \ref Sync::getGlobalLock() held.
+  std::vector<DeviceImage *> *getDeviceImages(OSModuleHandle M,
+                                              const string_class &KernelName);
+  /// Returns the image registered for module \p M equal to \p Img, that is
+  /// with the same contents, format, target and build options, or registers
+  /// \p Img and returns it if there is none. Must be called with the
+  /// \ref Sync::getGlobalLock() held.
+  DeviceImage *getRegisteredImage(OSModuleHandle M, DeviceImage *Img);
   void build(cl_program &ClProgram, const string_class &Options = "",
              std::vector<cl_device_id> ClDevices = std::vector<cl_device_id>());
 
-  struct ContextAndModuleLess {
-    bool operator()(const std::pair<context, OSModuleHandle> &LHS,
-                    const std::pair<context, OSModuleHandle> &RHS) const;
+  using ProgramCacheKey =
+      std::tuple<context, const std::vector<DeviceImage *> *,
+                 SpecConstantValues>;
+  struct ProgramCacheKeyLess {
+    bool operator()(const ProgramCacheKey &LHS,
+                    const ProgramCacheKey &RHS) const;
   };
 
   ProgramManager() = default;
@@ -77,9 +133,27 @@ private:
   ProgramManager(ProgramManager const &) = delete;
   ProgramManager &operator=(ProgramManager const &) = delete;
 
-  std::map<std::pair<context, OSModuleHandle>, cl_program, ContextAndModuleLess>
+  /// Built programs per context, set of device images the program is loaded
+  /// from, as returned by \ref getDeviceImages, and values of the
+  /// specialization constants the program is built for. An entry is added by
+  /// the thread that starts the build, the others wait on the future for the
+  /// result. Access must be guarded by \ref m_CachedSpirvProgramsMutex.
+  std::map<ProgramCacheKey, std::shared_future<cl_program>,
+           ProgramCacheKeyLess>
       m_CachedSpirvPrograms;
-  std::map<cl_program, std::map<string_class, cl_kernel>> m_CachedKernels;
+  std::mutex m_CachedSpirvProgramsMutex;
+  /// Kernel objects not in use at the moment, per program and kernel name.
+  /// A program is built for a single context, so kernel objects are never
+  /// shared between contexts.
+  /// Access must be guarded by \ref m_CachedKernelsMutex.
+  std::map<cl_program, std::map<string_class, std::vector<cl_kernel>>>
+      m_CachedKernels;
+  /// The free list of \ref m_CachedKernels each created kernel object returns
+  /// to. Access must be guarded by \ref m_CachedKernelsMutex.
+  std::unordered_map<cl_kernel, std::vector<cl_kernel> *> m_KernelFreeLists;
+  std::mutex m_CachedKernelsMutex;
+  std::atomic<size_t> m_KernelCacheHits{0};
+  std::atomic<size_t> m_KernelCacheMisses{0};
 
   /// Keeps all available device executable images added via \ref addImages.
   /// Organizes the images as a map from a module handle (.exe .dll) to the
@@ -87,10 +161,26 @@ private:
   /// Access must be guarded by the \ref Sync::getGlobalLock()
   std::map<OSModuleHandle, std::unique_ptr<std::vector<DeviceImage *>>>
       m_DeviceImages;
+  /// The device images of split device code per module and name of the
+  /// kernel listed in their entries.
+  /// Access must be guarded by the \ref Sync::getGlobalLock()
+  std::map<std::pair<OSModuleHandle, string_class>,
+           std::unique_ptr<std::vector<DeviceImage *>>>
+      m_KernelImages;
+  /// The images of \ref m_DeviceImages per module and hash of their contents,
+  /// format, target and build options.
+  /// Access must be guarded by the \ref Sync::getGlobalLock()
+  std::map<std::pair<OSModuleHandle, uint64_t>, std::vector<DeviceImage *>>
+      m_ImagesByHash;
   /// Keeps device images not bound to a particular module. Program manager
   /// allocated memory for these images, so they are auto-freed in destructor.
   /// No image can out-live the Program manager.
   std::vector<std::unique_ptr<DeviceImage, ImageDeleter>> m_OrphanDeviceImages;
+  /// Maps the compressed images of \ref m_DeviceImages to their decompressed
+  /// copies kept in \ref m_OrphanDeviceImages. An image is decompressed when
+  /// it is first selected for loading.
+  /// Access must be guarded by the \ref Sync::getGlobalLock()
+  std::map<const DeviceImage *, DeviceImage *> m_DecompressedImages;
 };
 } // namespace detail
 } // namespace sycl
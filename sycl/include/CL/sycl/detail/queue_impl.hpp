@@ -15,13 +15,20 @@
 #include <CL/sycl/handler.hpp>
 #include <CL/sycl/property_list.hpp>
 
+#include <mutex>
+
 namespace cl {
 namespace sycl {
 namespace detail {
 
-// Set max number of queues supported by FPGA RT.
+// Set max number of queues supported by FPGA RT. The default of the limit
+// which can be changed with the SYCL_MAX_NUM_QUEUES environment variable.
 const size_t MaxNumQueues = 256;
 
+// The minimal number of events a queue keeps before it checks which of them
+// are completed.
+const size_t MinEventsRetireSize = 128;
+
 class queue_impl {
 public:
   queue_impl(const device &SyclDevice, async_handler AsyncHandler,
@@ -34,6 +41,9 @@ public:
         m_PropList(PropList), m_HostQueue(m_Device.is_host()) {
     m_OpenCLInterop = !m_HostQueue;
     if (!m_HostQueue) {
+      m_InOrder = m_PropList.has_property<property::queue::in_order>();
+      m_HostUnifiedMemory =
+          m_Device.get_info<info::device::host_unified_memory>();
       m_CommandQueue = createQueue();
     }
   }
@@ -45,22 +55,25 @@ public:
 
     cl_device_id CLDevice = nullptr;
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clGetCommandQueueInfo(m_CommandQueue, CL_QUEUE_DEVICE,
-                                         sizeof(CLDevice), &CLDevice, nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetCommandQueueInfo)(
+        m_CommandQueue, CL_QUEUE_DEVICE, sizeof(CLDevice), &CLDevice, nullptr));
     m_Device = device(CLDevice);
+    cl_command_queue_properties Properties = 0;
+    CHECK_OCL_CODE(PI_TRACED(clGetCommandQueueInfo)(
+        m_CommandQueue, CL_QUEUE_PROPERTIES, sizeof(Properties), &Properties,
+        nullptr));
+    m_InOrder = !(Properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE);
+    m_HostUnifiedMemory =
+        m_Device.get_info<info::device::host_unified_memory>();
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clRetainCommandQueue(m_CommandQueue));
+    CHECK_OCL_CODE(PI_TRACED(clRetainCommandQueue)(m_CommandQueue));
   }
 
-  ~queue_impl() {
-    if (m_OpenCLInterop) {
-      CHECK_OCL_CODE_NO_EXC(clReleaseCommandQueue(m_CommandQueue));
-    }
-  }
+  ~queue_impl();
 
   cl_command_queue get() {
     if (m_OpenCLInterop) {
-      CHECK_OCL_CODE(clRetainCommandQueue(m_CommandQueue));
+      CHECK_OCL_CODE(PI_TRACED(clRetainCommandQueue)(m_CommandQueue));
       return m_CommandQueue;
     }
     throw invalid_object_error(
@@ -73,6 +86,15 @@ public:
 
   bool is_host() const { return m_HostQueue; }
 
+  // Returns true if all the commands of the queue, except the ones using the
+  // exclusive queues, are enqueued to one in-order native queue. Such
+  // commands don't need to wait for each other's events.
+  bool isInOrder() const { return m_InOrder; }
+
+  // Returns true if the device shares the memory with the host, so the
+  // buffers created on top of the host memory need no copies.
+  bool hasHostUnifiedMemory() const { return m_HostUnifiedMemory; }
+
   template <info::queue param>
   typename info::param_traits<info::queue, param>::return_type get_info() const;
 
@@ -99,15 +121,26 @@ public:
     return Event;
   }
 
-  void wait() {
-    // TODO: Make thread safe.
-    for (auto &evnt : m_Events)
-      evnt.wait();
-    m_Events.clear();
-  }
+  // Waits for the events submitted so far. Can be called concurrently with
+  // submissions, which are not waited for then.
+  void wait();
 
   exception_list getExceptionList() const { return m_Exceptions; }
 
+  // Starts recording the commands of the command groups submitted to the
+  // queue into Graph. nullptr stops the recording.
+  void setRecordedGraph(Scheduler::RecordedGraph *Graph) {
+    m_RecordedGraph = Graph;
+  }
+
+  Scheduler::RecordedGraph *getRecordedGraph() const {
+    return m_RecordedGraph;
+  }
+
+  // Adds the event of work enqueued to the queue, so that waiting for the
+  // queue waits for it as well.
+  void addEvent(event Event);
+
   void wait_and_throw() {
     wait();
     throw_asynchronous();
@@ -124,7 +157,7 @@ public:
     cl_command_queue_properties CreationFlags = 0;
 
     // FPGA RT can't handle out of order queue - create in order queue instead
-    if (!m_Device.is_accelerator()) {
+    if (!m_Device.is_accelerator() && !m_InOrder) {
       CreationFlags = CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
     }
 
@@ -138,12 +171,11 @@ public:
 #ifdef CL_VERSION_2_0
     cl_queue_properties CreationFlagProperties[] = {
         CL_QUEUE_PROPERTIES, CreationFlags, 0};
-    Queue = clCreateCommandQueueWithProperties(
-        ClContext, m_Device.get(), CreationFlagProperties,
-        &Error);
+    Queue = PI_TRACED(clCreateCommandQueueWithProperties)(
+        ClContext, m_Device.get(), CreationFlagProperties, &Error);
 #else
-    Queue = clCreateCommandQueue(ClContext, m_Device.get(),
-                                          CreationFlags, &Error);
+    Queue = PI_TRACED(clCreateCommandQueue)(ClContext, m_Device.get(),
+                                            CreationFlags, &Error);
 #endif
     CHECK_OCL_CODE(Error);
     // TODO catch an exception and put it to list of asynchronous exceptions
@@ -153,36 +185,35 @@ public:
 
   // Warning. Returned reference will be invalid if queue_impl was destroyed.
   cl_command_queue &getExclusiveQueueHandleRef() {
-    // To achive parallelism for FPGA with in order execution model with
-    // possibility of two kernels to share data with each other we shall
-    // create a queue for every kernel enqueued.
-    if (m_Queues.size() < MaxNumQueues) {
-      m_Queues.push_back(createQueue());
-      return m_Queues.back();
-    }
-
-    // If the limit of OpenCL queues is going to be exceeded - take the earliest
-    // used queue, wait until it finished and then reuse it.
-    m_QueueNumber %= MaxNumQueues;
-    size_t FreeQueueNum = m_QueueNumber++;
-
-    CHECK_OCL_CODE(clFinish(m_Queues[FreeQueueNum]));
-    return m_Queues[FreeQueueNum];
+    // Commands of the queue can be enqueued from several threads.
+    std::lock_guard<std::mutex> Lock(m_QueuesMutex);
+    return getExclusiveQueueHandleRefImpl();
   }
 
   cl_command_queue &getHandleRef() {
-    if (!m_Device.is_accelerator()) {
+    // The commands of an in-order queue are ordered by the native queue, so
+    // they can't be spread over several ones.
+    if (m_InOrder || !m_Device.is_accelerator()) {
       return m_CommandQueue;
     }
 
+    std::lock_guard<std::mutex> Lock(m_QueuesMutex);
     if (m_Queues.empty()) {
+      // Keep references to the queues valid while the list grows.
+      m_Queues.reserve(getMaxNumQueues());
       m_Queues.push_back(m_CommandQueue);
+      m_LastEvents.push_back(nullptr);
       return m_CommandQueue;
     }
 
-    return getExclusiveQueueHandleRef();
+    return getExclusiveQueueHandleRefImpl();
   }
 
+  // Remembers Event as the latest one enqueued to its native queue, if the
+  // native queue belongs to the pool of the queue. The pool uses it to find
+  // idle native queues.
+  void reportEvent(cl_event Event);
+
   template <typename propertyT> bool has_property() const {
     return m_PropList.has_property<propertyT>();
   }
@@ -192,19 +223,37 @@ public:
   }
 
 private:
+  // Returns the limit of the native queues created for an accelerator.
+  static size_t getMaxNumQueues();
+
+  // Returns an idle native queue of the pool, creates a new one if there is
+  // no such queue and the pool is not full. Has to be called with
+  // m_QueuesMutex locked.
+  cl_command_queue &getExclusiveQueueHandleRefImpl();
+
   template <typename T>
   event submit_impl(T cgf, std::shared_ptr<queue_impl> self) {
     handler Handler(std::move(self), m_HostQueue);
     cgf(Handler);
     event Event = Handler.finalize();
-    // TODO: Make thread safe.
-    m_Events.push_back(Event);
+    addEvent(Event);
+    if (m_RecordedGraph)
+      m_RecordedGraph->MCommands.push_back(
+          static_cast<Command *>(getSyclObjImpl(Event)->getCommand()));
     return Event;
   }
 
   device m_Device;
   context m_Context;
+  // Events of the work submitted to the queue and not known to be completed.
   vector_class<event> m_Events;
+  // The size of m_Events the completed events are removed from it at, so that
+  // the list doesn't grow when the queue is never waited for.
+  size_t m_EventsRetireSize = MinEventsRetireSize;
+  // Guards m_Events and m_EventsRetireSize.
+  std::mutex m_EventsMutex;
+  // The graph the submitted command groups are recorded to, if any.
+  Scheduler::RecordedGraph *m_RecordedGraph = nullptr;
   exception_list m_Exceptions;
   async_handler m_AsyncHandler;
   property_list m_PropList;
@@ -213,11 +262,17 @@ private:
 
   // List of OpenCL queues created for FPGA device from a single SYCL queue.
   vector_class<cl_command_queue> m_Queues;
+  // The latest event enqueued to each of m_Queues, nullptr if not known.
+  vector_class<cl_event> m_LastEvents;
   // Iterator through m_Queues.
   size_t m_QueueNumber = 0;
+  // Guards m_Queues, m_LastEvents and m_QueueNumber.
+  std::mutex m_QueuesMutex;
 
   bool m_OpenCLInterop = false;
   bool m_HostQueue = false;
+  bool m_InOrder = false;
+  bool m_HostUnifiedMemory = false;
 };
 
 } // namespace detail
@@ -0,0 +1,84 @@
+//==------- command_tracer.hpp - SYCL scheduler command timeline -----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <CL/sycl/detail/common.hpp>
+#include <CL/sycl/detail/trace_file.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+class Command;
+
+/// Records the timeline of the scheduler commands.
+///
+/// Enabled by setting the SYCL_COMMAND_TRACE_FILE environment variable to a
+/// file name, see \ref TraceFile.
+///
+/// For every command the timeline shows the time the enqueueing thread spent
+/// in enqueueing it, when its completion was observed on the host and arrows
+/// from the commands it depends on. The execution of the device commands is
+/// shown on the timeline of their native queue, if the SYCL queue was created
+/// with property::queue::enable_profiling. The device timestamps are mapped to
+/// the host clock assuming the command was queued at the start of the enqueue.
+class CommandTracer : public TraceFile {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Returns the tracer, or nullptr if the tracing is disabled.
+  static CommandTracer *get();
+
+  /// Records that the calling thread enqueued Cmd between Start and End.
+  /// Must be called before the commands depending on Cmd are enqueued.
+  void recordEnqueue(const Command *Cmd, Clock::time_point Start,
+                     Clock::time_point End);
+
+private:
+  struct Record {
+    std::string MName;
+    std::string MArgs;
+    unsigned MThread;
+    Clock::time_point MStart;
+    Clock::time_point MEnd;
+    // The records of the commands this one depends on.
+    std::vector<size_t> MDeps;
+    bool MCompleted = false;
+    Clock::time_point MCompletion;
+    // The device execution, if the profiling info is available.
+    bool MHasDeviceTime = false;
+    size_t MDeviceQueue = 0;
+    Clock::time_point MDeviceStart;
+    Clock::time_point MDeviceEnd;
+  };
+
+  explicit CommandTracer(std::string Path) : TraceFile(std::move(Path)) {}
+
+  static void CL_CALLBACK onCompletion(cl_event Event, cl_int Status,
+                                       void *Data);
+  void recordCompletion(size_t Id, cl_event Event);
+  void writeEvents(std::ostream &Stream) override;
+
+  std::vector<Record> MRecords;
+  // The record of the last enqueue of each command.
+  std::unordered_map<const Command *, size_t> MIds;
+  // Indices of the native queues on the device timeline.
+  std::unordered_map<cl_command_queue, size_t> MDeviceQueues;
+};
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
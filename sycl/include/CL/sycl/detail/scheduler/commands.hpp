@@ -10,6 +10,7 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include <CL/sycl/detail/accessor_impl.hpp>
@@ -76,13 +77,22 @@ public:
 
   void addDep(EventImplPtr Event) { MDepsEvents.push_back(std::move(Event)); }
 
-  void addUser(Command *NewUser) { MUsers.push_back(NewUser); }
+  void addUser(Command *NewUser) {
+    // The command can be a dependency of commands working with other memory
+    // objects, these can be added concurrently.
+    std::lock_guard<std::mutex> Lock(MUsersMutex);
+    MUsers.push_back(NewUser);
+  }
 
   // Return type of the command, e.g. Allocate, MemoryCopy.
   CommandType getType() const { return MType; }
 
+  // Returns a short printable name of the command type.
+  static const char *getTypeName(CommandType Type);
+
   // The method checks if the command is enqueued, call enqueueImp if not and
-  // returns CL_SUCCESS on success.
+  // returns CL_SUCCESS on success. If another thread is enqueueing the command
+  // at the moment, the method waits for it to finish.
   cl_int enqueue();
 
   bool isFinished();
@@ -93,6 +103,11 @@ public:
 
   std::shared_ptr<event_impl> getEvent() const { return MEvent; }
 
+  // Makes the already enqueued command ready to be enqueued once more with a
+  // new event. The new execution depends on the events passed instead of the
+  // events of the original dependencies. Used to replay recorded graphs.
+  void prepareForReplay(std::vector<EventImplPtr> DepEvents);
+
 protected:
   EventImplPtr MEvent;
   QueueImplPtr MQueue;
@@ -100,18 +115,30 @@ protected:
 
   std::vector<cl_event> prepareEvents(ContextImplPtr Context);
 
+  // Returns true if the command is enqueued after Dep to the same in-order
+  // native queue, so the order is guaranteed without waiting for the event
+  // of Dep.
+  bool isOrderedByQueue(const Command *Dep) const;
+
   bool MUseExclusiveQueue = false;
 
   // Private interface. Derived classes should implement this method.
   virtual cl_int enqueueImp() = 0;
 
+  // Returns the queue the work of the command is enqueued to.
+  virtual const QueueImplPtr &getWorkerQueue() const { return MQueue; }
+
 public:
   std::vector<DepDesc> MDeps;
   std::vector<Command *> MUsers;
 
 private:
   CommandType MType;
+  // Set once enqueueImp has successfully completed, so that the event of the
+  // command is valid for the commands depending on it.
   std::atomic<bool> MEnqueued;
+  std::mutex MEnqueueMutex;
+  std::mutex MUsersMutex;
 };
 
 // The command enqueues release instance of memory allocated on Host or
@@ -201,8 +228,21 @@ public:
     MAccToUpdate = AccToUpdate;
   }
 
+  // Marks the copy as not needed because the destination already holds the
+  // data. Such command only waits for its dependencies when enqueued.
+  void markRedundant() { MIsRedundant = true; }
+
+  bool isRedundant() const { return MIsRedundant; }
+
 private:
   cl_int enqueueImp() override;
+
+  // Copies between a device and the host are done by the device queue.
+  const QueueImplPtr &getWorkerQueue() const override;
+
+  // Can be set by the graph optimizer while another thread enqueues the
+  // command, either outcome is correct.
+  std::atomic<bool> MIsRedundant{false};
 };
 
 // The command enqueues memory copy between two instances of memory object.
@@ -220,6 +260,9 @@ public:
 
 private:
   cl_int enqueueImp() override;
+
+  // Copies between a device and the host are done by the device queue.
+  const QueueImplPtr &getWorkerQueue() const override;
 };
 
 // The command enqueues execution of kernel or explicit memory operation.
@@ -231,6 +274,8 @@ public:
 
   void flushStreams();
 
+  detail::CG &getCG() const { return *MCommandGroup; }
+
 private:
   // Implementation of enqueueing of ExecCGCommand.
   cl_int enqueueImp() override;
@@ -15,6 +15,7 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace cl {
@@ -61,6 +62,33 @@ public:
 
   QueueImplPtr getDefaultHostQueue() { return DefaultHostQueue; }
 
+  // A sequence of command groups recorded to be executed again without
+  // building the graph for them.
+  struct RecordedGraph {
+    // The commands of the recorded command groups in the submission order.
+    std::vector<Command *> MCommands;
+
+    // The leafs of a memory object used by the recorded commands, as they were
+    // at the end of the recording.
+    struct MemObjLeafs {
+      SYCLMemObjT *MMemObj;
+      std::vector<Command *> MReadLeafs;
+      std::vector<Command *> MWriteLeafs;
+    };
+    std::vector<MemObjLeafs> MLeafs;
+  };
+
+  // Checks that the recorded commands can be replayed and saves the state of
+  // the memory objects they use. Throws feature_not_supported if the graph
+  // contains commands that are not recorded, such as memory copies between
+  // contexts, in between the recorded ones.
+  void finalizeRecording(RecordedGraph &Graph);
+
+  // Enqueues the recorded commands once more. The commands keep their
+  // dependencies on each other, the first commands using a memory object
+  // depend on its latest users. Returns the event of the last command.
+  EventImplPtr replay(RecordedGraph &Graph);
+
 private:
   Scheduler();
   ~Scheduler();
@@ -81,11 +109,16 @@ private:
     Command *addCopyBack(Requirement *Req);
     Command *addHostAccessor(Requirement *Req, EventImplPtr &RetEvent);
 
-    // [Provisional] Optimizes the whole graph.
+    // Optimizes the whole graph, i.e. the subgraphs of the latest commands of
+    // all memory objects.
     void optimize();
 
-    // [Provisional] Optimizes subgraph that consists of command associated with
-    // Event passed and its dependencies.
+    // Optimizes subgraph that consists of command associated with Event passed
+    // and its dependencies. Only the commands which are not enqueued yet are
+    // changed: memory copies to allocations which already hold the up to date
+    // data are turned into empty nodes. Setting SYCL_PRINT_EXECUTION_GRAPH
+    // environment variable dumps the subgraph in DOT format to
+    // graph_<N>_{before,after}_optimize.dot files.
     void optimize(EventImplPtr Event);
 
     // Removes unneeded commands from the graph.
@@ -99,6 +132,9 @@ private:
 
     // The MemObjRecord is created for each memory object used in command
     // groups. There should be only one MemObjRecord for SYCL memory object.
+    // All the graph state of the memory object is guarded by the record's
+    // mutex, so command groups working with different memory objects can be
+    // added to the graph concurrently.
 
     struct MemObjRecord {
       // Used to distinguish one memory object from another.
@@ -116,14 +152,28 @@ private:
       // The flag indicates that the content of the memory object was/will be
       // modified. Used while deciding if copy back needed.
       bool MMemModified;
+
+      // Guards all the fields above and the commands reachable from the
+      // leafs through the dependencies on this memory object.
+      std::mutex MMutex;
     };
 
-    MemObjRecord *getMemObjRecord(SYCLMemObjT *MemObject);
     // Returns pointer to MemObjRecord for pointer to memory object.
     // Return nullptr if there the record is not found.
+    MemObjRecord *getMemObjRecord(SYCLMemObjT *MemObject);
+    // Returns record for the memory object Req refers to, creates it if it
+    // doesn't exist.
     MemObjRecord *getOrInsertMemObjRecord(const QueueImplPtr &Queue,
                                           Requirement *Req);
 
+    // Locks records of all memory objects the requirements passed refer to,
+    // creating the records if needed. The records are always locked in the
+    // same order, so that threads locking intersecting sets of records don't
+    // deadlock.
+    std::vector<std::unique_lock<std::mutex>>
+    lockMemObjRecords(const QueueImplPtr &Queue,
+                      const std::vector<Requirement *> &Reqs);
+
     // Removes MemObjRecord for memory object passed.
     void removeRecordForMemObj(SYCLMemObjT *MemObject);
 
@@ -134,7 +184,10 @@ private:
     void UpdateLeafs(const std::set<Command *> &Cmds, MemObjRecord *Record,
                      Requirement *Req);
 
-    std::vector<MemObjRecord> MMemObjRecords;
+    // Guards the set of records, not the records themselves.
+    std::mutex MMemObjRecordsMutex;
+    std::unordered_map<SYCLMemObjT *, std::unique_ptr<MemObjRecord>>
+        MMemObjRecords;
 
   private:
     // The method inserts memory copy operation from the context where the
@@ -169,13 +222,33 @@ private:
     // Returns pointer to command which failed to enqueue, so this command
     // with all commands that depend on it can be rescheduled.
     static Command *enqueueCommand(Command *Cmd);
+
+    // Hands the command passed over to the background enqueue thread, which
+    // enqueues it with all its dependencies, and returns immediately. If the
+    // command fails to enqueue there, it is left for the next synchronous
+    // enqueue (e.g. waiting for its event) to retry and report the error.
+    static void enqueueCommandAsync(Command *Cmd);
+
+  private:
+    class EnqueueWorker;
   };
 
   void waitForRecordToFinish(GraphBuilder::MemObjRecord *Record);
 
+  // There is no graph-wide lock, the graph builder guards each memory object
+  // record separately.
   GraphBuilder MGraphBuilder;
-  // Use read-write mutex in future.
-  std::mutex MGraphLock;
+
+  // If set, the subgraph of each new command is optimized before it is
+  // enqueued. Can be disabled by setting the SYCL_GRAPH_OPTIMIZE environment
+  // variable to 0.
+  bool MOptimizeGraph = true;
+
+  // If set, command groups are enqueued on the background enqueue thread and
+  // queue::submit returns as soon as the command is added to the graph.
+  // Controlled by the SYCL_ASYNC_ENQUEUE environment variable, disabled by
+  // default.
+  bool MAsyncEnqueue = false;
 
   QueueImplPtr DefaultHostQueue;
 };
@@ -13,6 +13,8 @@
 #include <CL/sycl/device_selector.hpp>
 #include <CL/sycl/queue.hpp>
 
+#include <cstdint>
+
 namespace cl {
 namespace sycl {
 
@@ -93,17 +95,28 @@ public:
         CGH, range<1>(BufferSize_), id<1>(OffsetSize));
   }
 
-  // Method to provide an atomic access to the offset in the stream buffer
+  // Method to provide an atomic access to the offsets in the stream buffer,
+  // see updateOffset
   OffsetAccessorType getOffsetAccessor(handler &CGH) {
     auto OffsetSubBuf = buffer<char, 1>(Buf, id<1>(0), range<1>(OffsetSize));
-    auto ReinterpretedBuf = OffsetSubBuf.reinterpret<unsigned, 1>(range<1>(1));
+    auto ReinterpretedBuf = OffsetSubBuf.reinterpret<unsigned, 1>(range<1>(2));
     return ReinterpretedBuf.get_access<cl::sycl::access::mode::atomic>(
-        CGH, range<1>(1), id<1>(0));
+        CGH, range<1>(2), id<1>(0));
   }
 
-  // Copy stream buffer to the host and print the contents
+  // Copy the streamed data to the host and print it. Only the part of the
+  // buffer holding the data is copied, nothing if the kernel streamed nothing.
   void flush();
 
+  // Flush the stream in the background once its kernel completes, so the
+  // submitting thread doesn't wait for the kernel. The streams are flushed in
+  // the order they are passed. Returns the ticket to wait for the flush with.
+  static size_t flushAsync(std::shared_ptr<stream_impl> Stream);
+
+  // Wait until the flush with the given ticket, and the ones before it, are
+  // done. Waits for all the streams passed to flushAsync so far by default.
+  static void waitForFlushes(size_t Ticket = SIZE_MAX);
+
   size_t get_size() const;
 
   size_t get_max_statement_size() const;
@@ -116,10 +129,10 @@ private:
   // statement till the semicolon
   size_t MaxStatementSize_;
 
-  // Size of the variable which is used as an offset in the stream buffer.
+  // Size of the variables which are used as offsets in the stream buffer.
   // Additinonal memory is allocated in the beginning of the stream buffer for
-  // this variable.
-  static const size_t OffsetSize = sizeof(unsigned);
+  // these variables.
+  static const size_t OffsetSize = 2 * sizeof(unsigned);
 
   // Vector on the host side which is used to initialize the stream buffer
   std::vector<char> Data;
@@ -266,21 +279,30 @@ EnableIfFP<T, unsigned> floatingPointToDecStr(T AbsVal, char *Digits,
   return Offset;
 }
 
-// Helper method to update offset atomically according to the provided
-// operand size of the output operator. Return true if offset is updated and
-// false in case of overflow.
+// Helper method to reserve the place for the operand of the output operator
+// with a single atomic operation, so the work-items writing at the same time
+// don't retry. Return true if the place is reserved and false in case of
+// overflow.
+//
+// OffsetAcc[0] is the end of the reserved places, it keeps growing past the
+// buffer end after an overflow. The places are reserved one after another, so
+// the first one which doesn't fit is the only one starting within the buffer
+// and ending past it, and all the data written ends where it starts. It is
+// stored to OffsetAcc[1] for the flush.
 inline bool updateOffset(stream_impl::OffsetAccessorType &OffsetAcc,
                          stream_impl::AccessorType &Acc, unsigned Size,
                          unsigned &Cur) {
-  unsigned New;
-  do {
-    Cur = OffsetAcc[0].load();
-    if (Acc.get_count() - Cur < Size)
-      // Overflow
-      return false;
-    New = Cur + Size;
-  } while (!OffsetAcc[0].compare_exchange_strong(Cur, New));
-  return true;
+  const unsigned Count = Acc.get_count();
+  // Once the buffer is full the offset isn't increased further, so it can't
+  // wrap around however many writes are dropped.
+  if (OffsetAcc[0].load() > Count)
+    return false;
+  Cur = OffsetAcc[0].fetch_add(Size);
+  if (Cur <= Count && Count - Cur >= Size)
+    return true;
+  if (Cur <= Count)
+    OffsetAcc[1].store(Cur);
+  return false;
 }
 
 inline void write(stream_impl::OffsetAccessorType &OffsetAcc,
@@ -0,0 +1,64 @@
+//==----------- trace_file.hpp - SYCL RT Chrome trace file -----------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+/// Returns a small sequential id of the calling thread, easier to read in the
+/// trace viewer than the native thread ids.
+unsigned getTraceThreadId();
+
+/// Writes Str escaped as the contents of a JSON string.
+void writeJSONEscaped(std::ostream &Stream, const std::string &Str);
+
+/// A timeline written at the program exit in the Chrome trace event format,
+/// which can be loaded into chrome://tracing, to the file named by an
+/// environment variable.
+///
+/// The derived classes collect the events and write them in writeEvents. The
+/// events must not be recorded once the file is written, the ones happening
+/// after that, e.g. in the destructors of static objects, are dropped.
+class TraceFile {
+public:
+  virtual ~TraceFile() = default;
+
+protected:
+  explicit TraceFile(std::string Path) : MPath(std::move(Path)) {}
+
+  /// Returns the file name set by the environment variable EnvVar, or nullptr
+  /// if it is not set, which disables the trace.
+  static const char *getPath(const char *EnvVar);
+
+  /// Makes File written at the program exit. File must never be destroyed,
+  /// the events may be recorded by the destructors of static objects.
+  static void writeAtExit(TraceFile *File);
+
+  /// Writes the events as the elements of the traceEvents array, separated by
+  /// commas. Called with MMutex held.
+  virtual void writeEvents(std::ostream &Stream) = 0;
+
+  /// Guards the events and MWritten.
+  std::mutex MMutex;
+  bool MWritten = false;
+
+private:
+  void write();
+
+  const std::string MPath;
+};
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
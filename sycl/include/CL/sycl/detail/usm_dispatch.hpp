@@ -0,0 +1,133 @@
+//==----------- usm_dispatch.hpp - SYCL USM back-end dispatch --------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <CL/sycl/detail/common.hpp>
+#include <CL/sycl/usm/usm_enums.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+/// Implements the unified shared memory of a single context.
+///
+/// The allocations are done with the cl_intel_unified_shared_memory extension
+/// if the platform provides it, with the OpenCL 2.0 shared virtual memory
+/// otherwise. The SVM allocations are coarse-grained for the device ones and
+/// need fine-grained buffer support of all the devices of the context for the
+/// host and shared ones. The host context allocates all kinds of memory on
+/// the host heap.
+///
+/// The dispatcher keeps track of the live allocations, so that their kind can
+/// be queried and the kernels are told which memory they may access through
+/// the pointers they get.
+class USMDispatcher {
+public:
+  /// Context is nullptr for the host context.
+  USMDispatcher(cl_context Context, cl_platform_id Platform,
+                const std::vector<cl_device_id> &Devices);
+  /// Frees the allocations which are still alive.
+  ~USMDispatcher();
+
+  USMDispatcher(const USMDispatcher &) = delete;
+  USMDispatcher &operator=(const USMDispatcher &) = delete;
+
+  /// Returns true if the back-end of the context supports USM at all.
+  bool isSupported() const { return MBackend != Backend::None; }
+
+  /// Returns Size bytes of memory of the given kind, Device is ignored for
+  /// the host allocations. Returns nullptr if the memory can't be allocated.
+  /// Alignment 0 means the default alignment of the back-end.
+  void *allocate(usm::alloc Kind, cl_device_id Device, size_t Size,
+                 size_t Alignment);
+
+  /// Frees an allocation returned by allocate, does nothing for nullptr.
+  void free(void *Ptr);
+
+  /// Returns the kind of the allocation Ptr points into.
+  usm::alloc getPointerType(const void *Ptr) const;
+
+  /// Returns true if there are live allocations.
+  bool hasAllocations() const { return MNumAllocations != 0; }
+
+  /// Sets the pointer argument Index of the kernel.
+  void setKernelArgPointer(cl_kernel Kernel, cl_uint Index, void *Ptr);
+
+  /// Lets Kernel access the allocations of the context through the pointers
+  /// stored in memory, not only through the pointer arguments.
+  void setKernelIndirectAccess(cl_kernel Kernel);
+
+  /// Enqueues a copy of Size bytes from Src to Dst, any of which may be a USM
+  /// allocation of the context or host memory.
+  void memcpy(cl_command_queue Queue, void *Dst, const void *Src, size_t Size,
+              const std::vector<cl_event> &DepEvents, cl_event &OutEvent);
+
+  /// Enqueues setting Size bytes at Dst to the byte Value.
+  void memset(cl_command_queue Queue, void *Dst, int Value, size_t Size,
+              const std::vector<cl_event> &DepEvents, cl_event &OutEvent);
+
+private:
+  enum class Backend { None, Host, USM, SVM };
+
+  struct Allocation {
+    usm::alloc Kind;
+    size_t Size;
+  };
+
+  // Entry points of the cl_intel_unified_shared_memory extension.
+  using HostMemAllocFn = void *(*)(cl_context, const cl_bitfield *, size_t,
+                                   cl_uint, cl_int *);
+  using DeviceMemAllocFn = void *(*)(cl_context, cl_device_id,
+                                     const cl_bitfield *, size_t, cl_uint,
+                                     cl_int *);
+  using SharedMemAllocFn = void *(*)(cl_context, cl_device_id,
+                                     const cl_bitfield *, size_t, cl_uint,
+                                     cl_int *);
+  using MemFreeFn = cl_int (*)(cl_context, void *);
+  using SetKernelArgMemPointerFn = cl_int (*)(cl_kernel, cl_uint,
+                                              const void *);
+  using EnqueueMemsetFn = cl_int (*)(cl_command_queue, void *, cl_int, size_t,
+                                     cl_uint, const cl_event *, cl_event *);
+  using EnqueueMemcpyFn = cl_int (*)(cl_command_queue, cl_bool, void *,
+                                     const void *, size_t, cl_uint,
+                                     const cl_event *, cl_event *);
+
+  // Returns true if all the entry points of the extension are found.
+  bool loadExtension(cl_platform_id Platform);
+
+  void freeImpl(void *Ptr, usm::alloc Kind);
+
+  cl_context MContext;
+  Backend MBackend = Backend::None;
+  // The SVM back-end can allocate host and shared memory.
+  bool MSVMFineGrain = false;
+
+  HostMemAllocFn MHostMemAlloc = nullptr;
+  DeviceMemAllocFn MDeviceMemAlloc = nullptr;
+  SharedMemAllocFn MSharedMemAlloc = nullptr;
+  MemFreeFn MMemFree = nullptr;
+  SetKernelArgMemPointerFn MSetKernelArgMemPointer = nullptr;
+  EnqueueMemsetFn MEnqueueMemset = nullptr;
+  EnqueueMemcpyFn MEnqueueMemcpy = nullptr;
+
+  // The live allocations by their start address.
+  std::map<const void *, Allocation> MAllocations;
+  std::atomic<size_t> MNumAllocations{0};
+  mutable std::mutex MMutex;
+};
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
@@ -10,6 +10,8 @@
 
 #ifndef __SYCL_DEVICE_ONLY
 
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
 
 namespace cl {
@@ -28,6 +30,17 @@ private:
   std::mutex GlobalLock;
 };
 
+/// Returns the 64-bit FNV-1a hash of [Data, Data + Size) continuing \p Hash.
+/// Unlike std::hash it is stable across runs and library builds.
+inline uint64_t hashBytes(const unsigned char *Data, size_t Size,
+                          uint64_t Hash = 0xcbf29ce484222325ULL) {
+  for (size_t I = 0; I < Size; ++I) {
+    Hash ^= Data[I];
+    Hash *= 0x100000001b3ULL;
+  }
+  return Hash;
+}
+
 } // namespace detail
 } // namespace sycl
 } // namespace cl
@@ -20,6 +20,7 @@
 #include <CL/sycl/detail/scheduler/scheduler.hpp>
 #include <CL/sycl/event.hpp>
 #include <CL/sycl/id.hpp>
+#include <CL/sycl/intel/spec_constant.hpp>
 #include <CL/sycl/kernel.hpp>
 #include <CL/sycl/nd_item.hpp>
 #include <CL/sycl/nd_range.hpp>
@@ -163,9 +164,15 @@ class handler {
   void *MDstPtr = nullptr;
   // Pattern that is used to fill memory object in case command type is fill.
   std::vector<char> MPattern;
+  // Length of the USM memory to copy or fill.
+  size_t MLength = 0;
+  // The events the command group depends on explicitly.
+  std::vector<detail::EventImplPtr> MEvents;
   // Storage for a lambda or function object.
   std::unique_ptr<detail::HostKernelBase> MHostKernel;
   detail::OSModuleHandle MOSModuleHandle;
+  // The values of the specialization constants set for the kernel.
+  detail::SpecConstantValues MSpecConstants;
 
   bool MIsHost = false;
 
@@ -183,30 +190,43 @@ private:
     return Storage;
   }
 
-  // The method extracts and prepares kernel arguments from the lambda using
-  // integration header.
-  void
-  extractArgsAndReqsFromLambda(char *LambdaPtr, size_t KernelArgsNum,
-                               const detail::kernel_param_desc_t *KernelArgs) {
+  // The methods extract and prepare kernel arguments from the lambda using
+  // integration header. The descriptors of the arguments are constant
+  // expressions there, so they are passed as template arguments and each
+  // argument is processed by the code for its kind, without a loop over the
+  // descriptors.
+  template <typename KI, unsigned I>
+  typename std::enable_if<(I == KI::getNumParams())>::type
+  extractArgsAndReqsFromLambda(char *, size_t &) {}
+
+  template <typename KI, unsigned I>
+  typename std::enable_if<(I < KI::getNumParams())>::type
+  extractArgsAndReqsFromLambda(char *LambdaPtr, size_t &IndexShift) {
+    processLambdaArg<KI::getParamDesc(I).kind, KI::getParamDesc(I).info>(
+        LambdaPtr + KI::getParamDesc(I).offset, I, IndexShift);
+    extractArgsAndReqsFromLambda<KI, I + 1>(LambdaPtr, IndexShift);
+  }
+
+  template <detail::kernel_param_kind_t Kind, int Size>
+  void processLambdaArg(void *Ptr, size_t Index, size_t &IndexShift) {
     const bool IsKernelCreatedFromSource = false;
-    size_t IndexShift = 0;
-    for (size_t I = 0; I < KernelArgsNum; ++I) {
-      void *Ptr = LambdaPtr + KernelArgs[I].offset;
-      const detail::kernel_param_kind_t &Kind = KernelArgs[I].kind;
-      const int &Size = KernelArgs[I].info;
-      if (Kind == detail::kernel_param_kind_t::kind_accessor) {
-        // For args kind of accessor Size is information about accessor.
-        // The first 11 bits of Size encodes the accessor target.
-        const access::target AccTarget =
-            static_cast<access::target>(Size & 0x7ff);
-        if (AccTarget == access::target::global_buffer ||
-            AccTarget == access::target::constant_buffer) {
-          detail::AccessorBaseHost *AccBase =
-              static_cast<detail::AccessorBaseHost *>(Ptr);
-          Ptr = detail::getSyclObjImpl(*AccBase).get();
-        }
+    if (Kind == detail::kernel_param_kind_t::kind_accessor) {
+      // For args kind of accessor Size is information about accessor.
+      // The first 11 bits of Size encodes the accessor target.
+      const access::target AccTarget =
+          static_cast<access::target>(Size & 0x7ff);
+      if (AccTarget == access::target::global_buffer ||
+          AccTarget == access::target::constant_buffer) {
+        detail::AccessorBaseHost *AccBase =
+            static_cast<detail::AccessorBaseHost *>(Ptr);
+        Ptr = detail::getSyclObjImpl(*AccBase).get();
       }
-      processArg(Ptr, Kind, Size, I, IndexShift, IsKernelCreatedFromSource);
+      processAccessorArg(Ptr, Size, Index, IndexShift,
+                         IsKernelCreatedFromSource);
+    } else if (Kind == detail::kernel_param_kind_t::kind_sampler) {
+      MArgs.emplace_back(Kind, Ptr, sizeof(sampler), Index + IndexShift);
+    } else {
+      MArgs.emplace_back(Kind, Ptr, Size, Index + IndexShift);
     }
   }
 
@@ -233,6 +253,71 @@ private:
     }
   }
 
+  void processAccessorArg(void *Ptr, const int Size, const size_t Index,
+                          size_t &IndexShift, bool IsKernelCreatedFromSource) {
+    const auto kind_std_layout = detail::kernel_param_kind_t::kind_std_layout;
+    const auto kind_accessor = detail::kernel_param_kind_t::kind_accessor;
+
+    // For args kind of accessor Size is information about accessor.
+    // The first 11 bits of Size encodes the accessor target.
+    const access::target AccTarget = static_cast<access::target>(Size & 0x7ff);
+    switch (AccTarget) {
+    case access::target::global_buffer:
+    case access::target::constant_buffer: {
+      detail::Requirement *AccImpl = static_cast<detail::Requirement *>(Ptr);
+      MArgs.emplace_back(kind_accessor, AccImpl, Size, Index + IndexShift);
+      if (!IsKernelCreatedFromSource) {
+        // Dimensionality of the buffer is 1 when dimensionality of the
+        // accessor is 0.
+        const size_t SizeAccField =
+            sizeof(size_t) * (AccImpl->MDims == 0 ? 1 : AccImpl->MDims);
+        ++IndexShift;
+        MArgs.emplace_back(kind_std_layout, &AccImpl->MAccessRange[0],
+                           SizeAccField, Index + IndexShift);
+        ++IndexShift;
+        MArgs.emplace_back(kind_std_layout, &AccImpl->MMemoryRange[0],
+                           SizeAccField, Index + IndexShift);
+        ++IndexShift;
+        MArgs.emplace_back(kind_std_layout, &AccImpl->MOffset[0],
+                           SizeAccField, Index + IndexShift);
+      }
+      break;
+    }
+    case access::target::local: {
+      detail::LocalAccessorBaseHost *LAcc =
+          static_cast<detail::LocalAccessorBaseHost *>(Ptr);
+      range<3> &Size = LAcc->getSize();
+      const int Dims = LAcc->getNumOfDims();
+      int SizeInBytes = LAcc->getElementSize();
+      for (int I = 0; I < Dims; ++I)
+        SizeInBytes *= Size[I];
+      MArgs.emplace_back(kind_std_layout, nullptr, SizeInBytes,
+                         Index + IndexShift);
+      if (!IsKernelCreatedFromSource) {
+        ++IndexShift;
+        const size_t SizeAccField = Dims * sizeof(Size[0]);
+        MArgs.emplace_back(kind_std_layout, &Size, SizeAccField,
+                           Index + IndexShift);
+        ++IndexShift;
+        MArgs.emplace_back(kind_std_layout, &Size, SizeAccField,
+                           Index + IndexShift);
+        ++IndexShift;
+        MArgs.emplace_back(kind_std_layout, &Size, SizeAccField,
+                           Index + IndexShift);
+      }
+      break;
+    }
+    case access::target::image:
+    case access::target::host_buffer:
+    case access::target::host_image:
+    case access::target::image_array: {
+      throw cl::sycl::invalid_parameter_error(
+          "Unsupported accessor target case.");
+      break;
+    }
+    }
+  }
+
   void processArg(void *Ptr, const detail::kernel_param_kind_t &Kind,
                   const int Size, const size_t Index, size_t &IndexShift,
                   bool IsKernelCreatedFromSource) {
@@ -248,65 +333,8 @@ private:
       break;
     }
     case kind_accessor: {
-      // For args kind of accessor Size is information about accessor.
-      // The first 11 bits of Size encodes the accessor target.
-      const access::target AccTarget =
-          static_cast<access::target>(Size & 0x7ff);
-      switch (AccTarget) {
-      case access::target::global_buffer:
-      case access::target::constant_buffer: {
-        detail::Requirement *AccImpl = static_cast<detail::Requirement *>(Ptr);
-        MArgs.emplace_back(Kind, AccImpl, Size, Index + IndexShift);
-        if (!IsKernelCreatedFromSource) {
-          // Dimensionality of the buffer is 1 when dimensionality of the
-          // accessor is 0.
-          const size_t SizeAccField =
-              sizeof(size_t) * (AccImpl->MDims == 0 ? 1 : AccImpl->MDims);
-          ++IndexShift;
-          MArgs.emplace_back(kind_std_layout, &AccImpl->MAccessRange[0],
-                             SizeAccField, Index + IndexShift);
-          ++IndexShift;
-          MArgs.emplace_back(kind_std_layout, &AccImpl->MMemoryRange[0],
-                             SizeAccField, Index + IndexShift);
-          ++IndexShift;
-          MArgs.emplace_back(kind_std_layout, &AccImpl->MOffset[0],
-                             SizeAccField, Index + IndexShift);
-        }
-        break;
-      }
-      case access::target::local: {
-        detail::LocalAccessorBaseHost *LAcc =
-            static_cast<detail::LocalAccessorBaseHost *>(Ptr);
-        range<3> &Size = LAcc->getSize();
-        const int Dims = LAcc->getNumOfDims();
-        int SizeInBytes = LAcc->getElementSize();
-        for (int I = 0; I < Dims; ++I)
-          SizeInBytes *= Size[I];
-        MArgs.emplace_back(kind_std_layout, nullptr, SizeInBytes,
-                           Index + IndexShift);
-        if (!IsKernelCreatedFromSource) {
-          ++IndexShift;
-          const size_t SizeAccField = Dims * sizeof(Size[0]);
-          MArgs.emplace_back(kind_std_layout, &Size, SizeAccField,
-                             Index + IndexShift);
-          ++IndexShift;
-          MArgs.emplace_back(kind_std_layout, &Size, SizeAccField,
-                             Index + IndexShift);
-          ++IndexShift;
-          MArgs.emplace_back(kind_std_layout, &Size, SizeAccField,
-                             Index + IndexShift);
-        }
-        break;
-      }
-      case access::target::image:
-      case access::target::host_buffer:
-      case access::target::host_image:
-      case access::target::image_array: {
-        throw cl::sycl::invalid_parameter_error(
-            "Unsupported accessor target case.");
-        break;
-      }
-      }
+      processAccessorArg(Ptr, Size, Index, IndexShift,
+                         IsKernelCreatedFromSource);
       break;
     }
     case kind_sampler: {
@@ -343,8 +371,9 @@ private:
           std::move(MNDRDesc), std::move(MHostKernel), std::move(MSyclKernel),
           std::move(MArgsStorage), std::move(MAccStorage),
           std::move(MSharedPtrStorage), std::move(MRequirements),
-          std::move(MArgs), std::move(MKernelName), std::move(MOSModuleHandle),
-          std::move(MStreamStorage)));
+          std::move(MEvents), std::move(MArgs), std::move(MKernelName),
+          std::move(MOSModuleHandle),
+          std::move(MStreamStorage), std::move(MSpecConstants)));
       break;
     case detail::CG::COPY_ACC_TO_PTR:
     case detail::CG::COPY_PTR_TO_ACC:
@@ -352,18 +381,32 @@ private:
       CommandGroup.reset(new detail::CGCopy(
           MCGType, MSrcPtr, MDstPtr, std::move(MArgsStorage),
           std::move(MAccStorage), std::move(MSharedPtrStorage),
-          std::move(MRequirements)));
+          std::move(MRequirements), std::move(MEvents)));
       break;
     case detail::CG::FILL:
       CommandGroup.reset(new detail::CGFill(
           std::move(MPattern), MDstPtr, std::move(MArgsStorage),
           std::move(MAccStorage), std::move(MSharedPtrStorage),
-          std::move(MRequirements)));
+          std::move(MRequirements), std::move(MEvents)));
       break;
     case detail::CG::UPDATE_HOST:
       CommandGroup.reset(new detail::CGUpdateHost(
           MDstPtr, std::move(MArgsStorage), std::move(MAccStorage),
-          std::move(MSharedPtrStorage), std::move(MRequirements)));
+          std::move(MSharedPtrStorage), std::move(MRequirements),
+          std::move(MEvents)));
+      break;
+    case detail::CG::COPY_USM:
+      CommandGroup.reset(new detail::CGCopyUSM(
+          MSrcPtr, MDstPtr, MLength, std::move(MArgsStorage),
+          std::move(MAccStorage), std::move(MSharedPtrStorage),
+          std::move(MRequirements), std::move(MEvents)));
+      break;
+    case detail::CG::FILL_USM:
+      CommandGroup.reset(new detail::CGFillUSM(
+          static_cast<unsigned char>(MPattern[0]), MDstPtr, MLength,
+          std::move(MArgsStorage), std::move(MAccStorage),
+          std::move(MSharedPtrStorage), std::move(MRequirements),
+          std::move(MEvents)));
       break;
     default:
       throw runtime_error("Unhandled type of command group");
@@ -528,6 +571,16 @@ public:
     setArgsHelper(0, std::move(Args)...);
   }
 
+  // Sets the value of the specialization constant SpecId for the kernel of
+  // the command group and returns the object the kernel reads it through. The
+  // program of the kernel is built, and cached, for each set of values.
+  template <unsigned int SpecId, typename T>
+  intel::spec_constant<T, SpecId> set_spec_constant(T Value) {
+    const char *Bytes = reinterpret_cast<const char *>(&Value);
+    MSpecConstants[SpecId].assign(Bytes, Bytes + sizeof(T));
+    return intel::spec_constant<T, SpecId>(Value);
+  }
+
 #ifdef __SYCL_DEVICE_ONLY__
   template <typename KernelName, typename KernelType>
   __attribute__((sycl_kernel)) void kernel_single_task(KernelType KernelFunc) {
@@ -612,8 +665,8 @@ public:
     // header, so don't perform things that require it.
     if (KI::getName() != "") {
       MArgs.clear();
-      extractArgsAndReqsFromLambda(MHostKernel->getPtr(), KI::getNumParams(),
-                                   &KI::getParamDesc(0));
+      size_t IndexShift = 0;
+      extractArgsAndReqsFromLambda<KI, 0>(MHostKernel->getPtr(), IndexShift);
       MKernelName = KI::getName();
       MOSModuleHandle = csd::OSUtil::getOSModuleHandle(KI::getName());
     } else {
@@ -1057,6 +1110,36 @@ public:
       });
     }
   }
+
+  // Makes the command group wait for Event before it is executed, in
+  // addition to the dependencies implied by its accessors. Command groups
+  // working with USM pointers only have no other dependencies.
+  void depends_on(event Event) {
+    MEvents.push_back(detail::getSyclObjImpl(Event));
+  }
+
+  void depends_on(const vector_class<event> &Events) {
+    for (const event &Event : Events)
+      MEvents.push_back(detail::getSyclObjImpl(Event));
+  }
+
+  // Copies Count bytes from Src to Dest. Any of them may point to USM memory
+  // of the context of the queue or to the host memory.
+  void memcpy(void *Dest, const void *Src, size_t Count) {
+    MCGType = detail::CG::COPY_USM;
+    MSrcPtr = const_cast<void *>(Src);
+    MDstPtr = Dest;
+    MLength = Count;
+  }
+
+  // Sets Count bytes at Dest, pointing to USM memory of the context of the
+  // queue, to the byte Value.
+  void memset(void *Dest, int Value, size_t Count) {
+    MCGType = detail::CG::FILL_USM;
+    MDstPtr = Dest;
+    MPattern.assign(1, static_cast<char>(Value));
+    MLength = Count;
+  }
 };
 } // namespace sycl
 } // namespace cl
@@ -0,0 +1,71 @@
+//==----------- command_graph.hpp --- SYCL command graph -------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <CL/sycl/event.hpp>
+#include <CL/sycl/queue.hpp>
+
+#include <cstddef>
+#include <memory>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+class command_graph_impl;
+} // namespace detail
+namespace intel {
+
+/// Records the command groups submitted to a queue so that they can be
+/// executed again without building the dependency graph for them.
+///
+/// The command groups submitted to the queue between begin_recording and
+/// end_recording are executed as usual and are recorded at the same time.
+/// Each replay executes all of them once more in the submission order, the
+/// first ones waiting for the work already submitted for the memory objects
+/// they use. Only the command groups running kernels can be recorded, and
+/// the memory objects they use must be alive while the graph is replayed.
+/// A replay must not be executed concurrently with other submissions using
+/// the same memory objects.
+class command_graph {
+public:
+  command_graph();
+
+  /// Starts recording the command groups submitted to Queue.
+  void begin_recording(queue &Queue);
+
+  /// Stops the recording. After this the graph can be replayed.
+  void end_recording();
+
+  /// Returns the number of the recorded command groups.
+  size_t size() const;
+
+  /// Sets the value of the argument with index ArgIndex of the kernel run by
+  /// the CommandGroupIndex-th recorded command group for the next replays.
+  /// ArgIndex is the index of the kernel argument as passed to the device,
+  /// i.e. the index of the captured variable in a lambda where an accessor
+  /// counts as four arguments. Only arguments passed by value can be set.
+  template <typename T>
+  void set_arg(size_t CommandGroupIndex, int ArgIndex, const T &Arg) {
+    set_arg_impl(CommandGroupIndex, ArgIndex, &Arg, sizeof(T));
+  }
+
+  /// Executes the recorded command groups again. Returns the event of the
+  /// last one.
+  event replay();
+
+private:
+  void set_arg_impl(size_t CommandGroupIndex, int ArgIndex, const void *Arg,
+                    size_t Size);
+
+  std::shared_ptr<detail::command_graph_impl> impl;
+};
+
+} // namespace intel
+} // namespace sycl
+} // namespace cl
@@ -0,0 +1,197 @@
+//==------- group_algorithm.hpp --- SYCL work-group collectives ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <CL/sycl/access/access.hpp>
+#include <CL/sycl/exception.hpp>
+#include <CL/sycl/intel/sub_group.hpp>
+#include <CL/sycl/nd_item.hpp>
+#include <CL/sycl/pointers.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+// Reductions and scans over the work-items of a work-group.
+//
+// With intel::plus, intel::minimum or intel::maximum the collectives map to
+// the SPIR-V OpGroup* instructions at work-group scope:
+//
+//   T Sum = intel::reduce<intel::plus>(NdItem, x);
+//
+// Any other associative operation is combined with sub-group shuffles first,
+// then across the sub-groups through local memory. The caller passes the
+// identity of the operation and the local memory, which must hold one value
+// per sub-group of the work-group:
+//
+//   T Prod = intel::reduce(NdItem, x, T(1), Multiplies(), Scratch);
+//
+// All the work-items of the work-group must call the same collective with
+// the same operation.
+//
+// On the host device the work-items of a work-group only run in lockstep
+// within a sub-group, so the collectives support the work-groups that fit in
+// a single sub-group of detail::HostSubGroup::MaxSize work-items.
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+#ifndef __SYCL_DEVICE_ONLY__
+template <int Dimensions>
+intel::sub_group getHostWorkGroupSubGroup(const nd_item<Dimensions> &NdItem) {
+  if (NdItem.get_local_range().size() > HostSubGroup::MaxSize)
+    throw runtime_error("Work-group collectives on the host device require "
+                        "work-groups that fit in a single sub-group.");
+  return NdItem.get_sub_group();
+}
+#endif
+
+// The inclusive scan of x over the sub-group, with log2(sub-group size)
+// shuffles.
+template <typename T, class BinaryOperation>
+T subGroupInclusiveScan(const intel::sub_group &SG, T x, BinaryOperation Op) {
+  const uint32_t LocalId = SG.get_local_id().get(0);
+  const uint32_t Size = SG.get_local_range().get(0);
+  for (uint32_t Delta = 1; Delta < Size; Delta *= 2) {
+    T Previous = SG.shuffle_up(x, Delta);
+    if (LocalId >= Delta)
+      x = Op(Previous, x);
+  }
+  return x;
+}
+
+enum class GroupScanKind { Reduce, Inclusive, Exclusive };
+
+template <GroupScanKind Kind, typename T, class BinaryOperation,
+          int Dimensions>
+T groupScan(const nd_item<Dimensions> &NdItem, T x, T Identity,
+            BinaryOperation Op, local_ptr<T> Scratch) {
+  intel::sub_group SG = NdItem.get_sub_group();
+  const uint32_t LocalId = SG.get_local_id().get(0);
+  const uint32_t Last = SG.get_local_range().get(0) - 1;
+  const T Inclusive = subGroupInclusiveScan(SG, x, Op);
+  T Result = Inclusive;
+  if (Kind == GroupScanKind::Exclusive) {
+    T Previous = SG.shuffle_up(Inclusive, 1);
+    Result = LocalId == 0 ? Identity : Previous;
+  }
+
+#ifdef __SYCL_DEVICE_ONLY__
+  // Combine the totals of the sub-groups through the local memory.
+  const uint32_t SGId = SG.get_group_id().get(0);
+  const uint32_t NumSGs = SG.get_group_range();
+  if (LocalId == Last)
+    Scratch[SGId] = Inclusive;
+  NdItem.barrier(access::fence_space::local_space);
+  if (Kind == GroupScanKind::Reduce) {
+    Result = Scratch[0];
+    for (uint32_t I = 1; I < NumSGs; ++I)
+      Result = Op(Result, Scratch[I]);
+  } else {
+    // The first work-item turns the totals into the exclusive prefixes of
+    // the sub-groups.
+    if (NdItem.get_local_linear_id() == 0) {
+      T Prefix = Identity;
+      for (uint32_t I = 0; I < NumSGs; ++I) {
+        T Total = Scratch[I];
+        Scratch[I] = Prefix;
+        Prefix = Op(Prefix, Total);
+      }
+    }
+    NdItem.barrier(access::fence_space::local_space);
+    Result = Op(Scratch[SGId], Result);
+  }
+  // The next collective may reuse the local memory.
+  NdItem.barrier(access::fence_space::local_space);
+#else
+  // The work-group is a single sub-group.
+  if (Kind == GroupScanKind::Reduce)
+    Result = SG.shuffle(Inclusive, id<1>(Last));
+#endif
+  return Result;
+}
+
+} // namespace detail
+
+namespace intel {
+
+/* --- built-in operations --- */
+
+template <class BinaryOperation, typename T, int Dimensions>
+T reduce(const nd_item<Dimensions> &NdItem, T x) {
+#ifdef __SYCL_DEVICE_ONLY__
+  return BinaryOperation::template calc<T, __spv::GroupOperation::Reduce,
+                                        __spv::Scope::Workgroup>(x);
+#else
+  return detail::getHostWorkGroupSubGroup(NdItem)
+      .template reduce<T, BinaryOperation>(x);
+#endif
+}
+
+template <class BinaryOperation, typename T, int Dimensions>
+T exclusive_scan(const nd_item<Dimensions> &NdItem, T x) {
+#ifdef __SYCL_DEVICE_ONLY__
+  return BinaryOperation::template calc<
+      T, __spv::GroupOperation::ExclusiveScan, __spv::Scope::Workgroup>(x);
+#else
+  return detail::getHostWorkGroupSubGroup(NdItem)
+      .template exclusive_scan<T, BinaryOperation>(x);
+#endif
+}
+
+template <class BinaryOperation, typename T, int Dimensions>
+T inclusive_scan(const nd_item<Dimensions> &NdItem, T x) {
+#ifdef __SYCL_DEVICE_ONLY__
+  return BinaryOperation::template calc<
+      T, __spv::GroupOperation::InclusiveScan, __spv::Scope::Workgroup>(x);
+#else
+  return detail::getHostWorkGroupSubGroup(NdItem)
+      .template inclusive_scan<T, BinaryOperation>(x);
+#endif
+}
+
+/* --- any associative operation --- */
+/* Scratch holds a value per sub-group of the work-group */
+
+template <typename T, class BinaryOperation, int Dimensions>
+typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+reduce(const nd_item<Dimensions> &NdItem, T x, T Identity, BinaryOperation Op,
+       local_ptr<T> Scratch) {
+#ifndef __SYCL_DEVICE_ONLY__
+  detail::getHostWorkGroupSubGroup(NdItem);
+#endif
+  return detail::groupScan<detail::GroupScanKind::Reduce>(
+      NdItem, x, Identity, Op, Scratch);
+}
+
+template <typename T, class BinaryOperation, int Dimensions>
+typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+exclusive_scan(const nd_item<Dimensions> &NdItem, T x, T Identity,
+               BinaryOperation Op, local_ptr<T> Scratch) {
+#ifndef __SYCL_DEVICE_ONLY__
+  detail::getHostWorkGroupSubGroup(NdItem);
+#endif
+  return detail::groupScan<detail::GroupScanKind::Exclusive>(
+      NdItem, x, Identity, Op, Scratch);
+}
+
+template <typename T, class BinaryOperation, int Dimensions>
+typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+inclusive_scan(const nd_item<Dimensions> &NdItem, T x, T Identity,
+               BinaryOperation Op, local_ptr<T> Scratch) {
+#ifndef __SYCL_DEVICE_ONLY__
+  detail::getHostWorkGroupSubGroup(NdItem);
+#endif
+  return detail::groupScan<detail::GroupScanKind::Inclusive>(
+      NdItem, x, Identity, Op, Scratch);
+}
+
+} // namespace intel
+} // namespace sycl
+} // namespace cl
@@ -0,0 +1,143 @@
+//==-------- multi_device_queue.hpp --- SYCL multi-device execution --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <CL/sycl/context.hpp>
+#include <CL/sycl/device.hpp>
+#include <CL/sycl/event.hpp>
+#include <CL/sycl/handler.hpp>
+#include <CL/sycl/id.hpp>
+#include <CL/sycl/nd_range.hpp>
+#include <CL/sycl/queue.hpp>
+#include <CL/sycl/range.hpp>
+#include <CL/sycl/stl.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+class multi_device_queue_impl;
+} // namespace detail
+namespace intel {
+
+/// Runs a kernel on all the devices of one context, each device executing a
+/// part of the range.
+///
+/// The range is split along its first dimension. The command group function
+/// is called once per part as CGF(CGH, SubRange, Offset) and must request the
+/// accessors of the part with get_access(CGH, SubRange, Offset), so that the
+/// parts don't depend on each other and run concurrently. The kernel runs
+/// over SubRange and indexes these accessors from 0:
+///
+///   MDQueue.submit(range<1>(N), [&](handler &CGH, range<1> SubRange,
+///                                   id<1> Offset) {
+///     auto In = BufIn.get_access<access::mode::read>(CGH, SubRange, Offset);
+///     auto Out =
+///         BufOut.get_access<access::mode::write>(CGH, SubRange, Offset);
+///     CGH.parallel_for<class Scale>(SubRange,
+///                                   [=](id<1> I) { Out[I] = In[I] * 2; });
+///   });
+///
+/// The devices share the memory objects of the context, so the outputs of
+/// the parts are in one allocation which is read back as a whole by the
+/// next host accessor. With an nd_range the parts are whole work-groups.
+///
+/// The parts are proportional to the throughput of the devices, measured in
+/// work-items per second of the kernels waited for by wait(). Until every
+/// device has been measured, the number of compute units is used instead.
+class multi_device_queue {
+public:
+  /// Creates a queue for each device of Devices in a new context.
+  explicit multi_device_queue(const vector_class<device> &Devices,
+                              const async_handler &AsyncHandler = {});
+
+  /// Creates a queue for each device of Context.
+  explicit multi_device_queue(const context &Context,
+                              const async_handler &AsyncHandler = {});
+
+  context get_context() const;
+
+  vector_class<device> get_devices() const;
+
+  /// Returns the queue of the Index-th device.
+  queue get_queue(size_t Index) const;
+
+  /// Returns the share of the range each device gets in the next submit.
+  vector_class<float> get_weights() const;
+
+  /// Splits Range among the devices, see the class description. Returns the
+  /// event of each device which got a part.
+  template <typename T, int Dims>
+  vector_class<event> submit(range<Dims> Range, T CGF) {
+    vector_class<event> Events;
+    const vector_class<std::pair<size_t, size_t>> Parts =
+        partition(Range[0], 1);
+    for (size_t I = 0; I < Parts.size(); ++I) {
+      if (Parts[I].second == 0)
+        continue;
+      range<Dims> SubRange = Range;
+      SubRange[0] = Parts[I].second;
+      id<Dims> Offset;
+      Offset[0] = Parts[I].first;
+      event Event = get_queue(I).submit(
+          [&](handler &CGH) { CGF(CGH, SubRange, Offset); });
+      addSubmission(I, Event, SubRange.size());
+      Events.push_back(Event);
+    }
+    return Events;
+  }
+
+  /// The same for an nd_range, the parts consist of whole work-groups. The
+  /// command group function gets the nd_range of the part, with no offset,
+  /// and the offset of the part.
+  template <typename T, int Dims>
+  vector_class<event> submit(nd_range<Dims> Range, T CGF) {
+    vector_class<event> Events;
+    const range<Dims> GlobalRange = Range.get_global_range();
+    const range<Dims> LocalRange = Range.get_local_range();
+    const vector_class<std::pair<size_t, size_t>> Parts =
+        partition(GlobalRange[0], LocalRange[0]);
+    for (size_t I = 0; I < Parts.size(); ++I) {
+      if (Parts[I].second == 0)
+        continue;
+      range<Dims> SubRange = GlobalRange;
+      SubRange[0] = Parts[I].second;
+      id<Dims> Offset = Range.get_offset();
+      Offset[0] += Parts[I].first;
+      nd_range<Dims> SubNdRange(SubRange, LocalRange);
+      event Event = get_queue(I).submit(
+          [&](handler &CGH) { CGF(CGH, SubNdRange, Offset); });
+      addSubmission(I, Event, SubRange.size());
+      Events.push_back(Event);
+    }
+    return Events;
+  }
+
+  /// Waits for all the submitted parts and updates the measured throughput
+  /// of the devices from their execution time.
+  void wait();
+
+private:
+  // Returns the offset and the size of the part of each device, the sizes
+  // being multiples of Granularity.
+  vector_class<std::pair<size_t, size_t>> partition(size_t Size,
+                                                    size_t Granularity) const;
+
+  void addSubmission(size_t DeviceIndex, const event &Event,
+                     size_t WorkItems);
+
+  std::shared_ptr<detail::multi_device_queue_impl> impl;
+};
+
+} // namespace intel
+} // namespace sycl
+} // namespace cl
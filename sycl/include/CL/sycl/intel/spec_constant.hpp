@@ -0,0 +1,51 @@
+//==---------- spec_constant.hpp --- SYCL specialization constant ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <CL/__spirv/spirv_ops.hpp>
+
+#include <type_traits>
+
+namespace cl {
+namespace sycl {
+class handler;
+namespace intel {
+
+// A value of a kernel which is known when the kernel is launched but not when
+// it is compiled. The device code reads it as a SPIR-V specialization constant
+// with the given SpecId, so the program is built with the value folded in and
+// specialized for it. Objects are returned by handler::set_spec_constant and
+// captured by the kernel.
+template <typename T, unsigned int SpecId> class spec_constant {
+  static_assert(std::is_arithmetic<T>::value,
+                "Specialization constants must be of a scalar type");
+
+public:
+  T get() const {
+#ifdef __SYCL_DEVICE_ONLY__
+    return __spirv_SpecConstant(static_cast<int>(SpecId), T());
+#else
+    return MValue;
+#endif
+  }
+
+  operator T() const { return get(); }
+
+private:
+  explicit spec_constant(T Value) : MValue(Value) {}
+
+  // The value used on the host device.
+  T MValue;
+
+  friend class cl::sycl::handler;
+};
+
+} // namespace intel
+} // namespace sycl
+} // namespace cl
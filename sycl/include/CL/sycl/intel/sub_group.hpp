@@ -28,60 +28,68 @@ template <typename T, std::size_t N>
 struct is_vec<cl::sycl::vec<T, N>> : std::true_type {};
 
 struct minimum {
-  template <typename T, __spv::GroupOperation O>
+  template <typename T, __spv::GroupOperation O,
+            __spv::Scope S = __spv::Scope::Subgroup>
   static typename std::enable_if<
       !std::is_floating_point<T>::value && std::is_signed<T>::value, T>::type
   calc(T x) {
-    return __spirv_GroupSMin(__spv::Scope::Subgroup, O, x);
+    return __spirv_GroupSMin(S, O, x);
   }
 
-  template <typename T, __spv::GroupOperation O>
+  template <typename T, __spv::GroupOperation O,
+            __spv::Scope S = __spv::Scope::Subgroup>
   static typename std::enable_if<
       !std::is_floating_point<T>::value && std::is_unsigned<T>::value, T>::type
   calc(T x) {
-    return __spirv_GroupUMin(__spv::Scope::Subgroup, O, x);
+    return __spirv_GroupUMin(S, O, x);
   }
 
-  template <typename T, __spv::GroupOperation O>
+  template <typename T, __spv::GroupOperation O,
+            __spv::Scope S = __spv::Scope::Subgroup>
   static typename std::enable_if<std::is_floating_point<T>::value, T>::type
   calc(T x) {
-    return __spirv_GroupFMin(__spv::Scope::Subgroup, O, x);
+    return __spirv_GroupFMin(S, O, x);
   }
 };
 
 struct maximum {
-  template <typename T, __spv::GroupOperation O>
+  template <typename T, __spv::GroupOperation O,
+            __spv::Scope S = __spv::Scope::Subgroup>
   static typename std::enable_if<
       !std::is_floating_point<T>::value && std::is_signed<T>::value, T>::type
   calc(T x) {
-    return __spirv_GroupSMax(__spv::Scope::Subgroup, O, x);
+    return __spirv_GroupSMax(S, O, x);
   }
 
-  template <typename T, __spv::GroupOperation O>
+  template <typename T, __spv::GroupOperation O,
+            __spv::Scope S = __spv::Scope::Subgroup>
   static typename std::enable_if<
       !std::is_floating_point<T>::value && std::is_unsigned<T>::value, T>::type
   calc(T x) {
-    return __spirv_GroupUMax(__spv::Scope::Subgroup, O, x);
+    return __spirv_GroupUMax(S, O, x);
   }
 
-  template <typename T, __spv::GroupOperation O>
+  template <typename T, __spv::GroupOperation O,
+            __spv::Scope S = __spv::Scope::Subgroup>
   static typename std::enable_if<std::is_floating_point<T>::value, T>::type
   calc(T x) {
-    return __spirv_GroupFMax(__spv::Scope::Subgroup, O, x);
+    return __spirv_GroupFMax(S, O, x);
   }
 };
 
 struct plus {
-  template <typename T, __spv::GroupOperation O>
+  template <typename T, __spv::GroupOperation O,
+            __spv::Scope S = __spv::Scope::Subgroup>
   static typename std::enable_if<
       !std::is_floating_point<T>::value && std::is_integral<T>::value, T>::type
   calc(T x) {
-    return __spirv_GroupIAdd<T>(__spv::Scope::Subgroup, O, x);
+    return __spirv_GroupIAdd<T>(S, O, x);
   }
-  template <typename T, __spv::GroupOperation O>
+  template <typename T, __spv::GroupOperation O,
+            __spv::Scope S = __spv::Scope::Subgroup>
   static typename std::enable_if<std::is_floating_point<T>::value, T>::type
   calc(T x) {
-    return __spirv_GroupFAdd<T>(__spv::Scope::Subgroup, O, x);
+    return __spirv_GroupFAdd<T>(S, O, x);
   }
 };
 struct sub_group {
@@ -9,138 +9,218 @@
 #pragma once
 
 #include <CL/sycl/access/access.hpp>
+#include <CL/sycl/detail/host_sub_group.hpp>
 #include <CL/sycl/id.hpp>
 #include <CL/sycl/range.hpp>
 #include <CL/sycl/types.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #ifndef __SYCL_DEVICE_ONLY__
 
 namespace cl {
 namespace sycl {
 template <typename T, access::address_space Space> class multi_ptr;
 namespace intel {
-struct minimum {};
-struct maximum {};
-struct plus {};
+struct minimum {
+  template <typename T> static T calc(T x, T y) { return y < x ? y : x; }
+  template <typename T> static T identity() {
+    return std::numeric_limits<T>::has_infinity
+               ? std::numeric_limits<T>::infinity()
+               : std::numeric_limits<T>::max();
+  }
+};
+
+struct maximum {
+  template <typename T> static T calc(T x, T y) { return x < y ? y : x; }
+  template <typename T> static T identity() {
+    return std::numeric_limits<T>::has_infinity
+               ? -std::numeric_limits<T>::infinity()
+               : std::numeric_limits<T>::lowest();
+  }
+};
+
+struct plus {
+  template <typename T> static T calc(T x, T y) { return x + y; }
+  template <typename T> static T identity() { return T(0); }
+};
 
+// The work-items of a sub-group are run in lockstep by
+// detail::HostSubGroup, the collectives exchange the values of all of them
+// and compute the result in every work-item.
 struct sub_group {
   /* --- common interface members --- */
 
-  id<1> get_local_id() const {
-    throw runtime_error("Subgroups are not supported on host device. ");
-  }
-  range<1> get_local_range() const {
-    throw runtime_error("Subgroups are not supported on host device. ");
-  }
+  id<1> get_local_id() const { return id<1>(MLocalId); }
+  range<1> get_local_range() const { return range<1>(MLocalRange); }
 
   range<1> get_max_local_range() const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return range<1>(detail::HostSubGroup::MaxSize);
   }
 
-  id<1> get_group_id() const {
-    throw runtime_error("Subgroups are not supported on host device. ");
-  }
+  id<1> get_group_id() const { return id<1>(MGroupId); }
 
-  size_t get_group_range() const {
-    throw runtime_error("Subgroups are not supported on host device. ");
-  }
+  size_t get_group_range() const { return MGroupRange; }
 
-  size_t get_uniform_group_range() const {
-    throw runtime_error("Subgroups are not supported on host device. ");
-  }
+  size_t get_uniform_group_range() const { return MGroupRange; }
 
   /* --- vote / ballot functions --- */
 
   bool any(bool predicate) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    const char *Data = exchange(predicate);
+    for (size_t I = 0; I < MLocalRange; ++I)
+      if (valueOf<bool>(Data, I))
+        return true;
+    return false;
   }
 
   bool all(bool predicate) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    const char *Data = exchange(predicate);
+    for (size_t I = 0; I < MLocalRange; ++I)
+      if (!valueOf<bool>(Data, I))
+        return false;
+    return true;
   }
 
   /* --- collectives --- */
 
   template <typename T> T broadcast(T x, id<1> local_id) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return valueOf<T>(exchange(x), local_id.get(0));
   }
 
   template <typename T, class BinaryOperation> T reduce(T x) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return fold<T, BinaryOperation>(exchange(x), MLocalRange);
   }
 
   template <typename T, class BinaryOperation> T exclusive_scan(T x) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return fold<T, BinaryOperation>(exchange(x), MLocalId);
   }
 
   template <typename T, class BinaryOperation> T inclusive_scan(T x) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return fold<T, BinaryOperation>(exchange(x), MLocalId + 1);
   }
 
   /* --- one - input shuffles --- */
   /* indices in [0 , sub - group size ) */
 
   template <typename T> T shuffle(T x, id<1> local_id) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return valueOf<T>(exchange(x), local_id.get(0));
   }
 
   template <typename T> T shuffle_down(T x, uint32_t delta) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return shuffle_down(x, x, delta);
   }
   template <typename T> T shuffle_up(T x, uint32_t delta) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return shuffle_up(x, x, delta);
   }
 
   template <typename T> T shuffle_xor(T x, id<1> value) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    const char *Data = exchange(x);
+    const size_t Index = MLocalId ^ value.get(0);
+    return Index < MLocalRange ? valueOf<T>(Data, Index) : x;
   }
 
   /* --- two - input shuffles --- */
   /* indices in [0 , 2* sub - group size ) */
   template <typename T> T shuffle(T x, T y, id<1> local_id) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return select<T>(exchange(Pair<T>{x, y}), local_id.get(0));
   }
   template <typename T>
   T shuffle_down(T current, T next, uint32_t delta) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return select<T>(exchange(Pair<T>{current, next}), MLocalId + delta);
   }
   template <typename T>
   T shuffle_up(T previous, T current, uint32_t delta) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return select<T>(exchange(Pair<T>{previous, current}),
+                  MLocalId + MLocalRange - delta);
   }
 
   /* --- sub - group load / stores --- */
   /* these can map to SIMD or block read / write hardware where available */
   template <typename T, access::address_space Space>
   T load(const multi_ptr<T, Space> src) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    return src.get()[MLocalId];
   }
 
   template <int N, typename T, access::address_space Space>
   vec<T, N> load(const multi_ptr<T, Space> src) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    vec<T, N> Res;
+    T *Elems = reinterpret_cast<T *>(&Res);
+    for (int I = 0; I < N; ++I)
+      Elems[I] = src.get()[I * MLocalRange + MLocalId];
+    return Res;
   }
 
   template <typename T, access::address_space Space>
   void store(multi_ptr<T, Space> dst, T &x) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    dst.get()[MLocalId] = x;
   }
 
   template <int N, typename T, access::address_space Space>
   void store(multi_ptr<T, Space> dst, const vec<T, N> &x) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    const T *Elems = reinterpret_cast<const T *>(&x);
+    for (int I = 0; I < N; ++I)
+      dst.get()[I * MLocalRange + MLocalId] = Elems[I];
   }
 
   /* --- synchronization functions --- */
   void barrier(access::fence_space accessSpace =
                    access::fence_space::global_and_local) const {
-    throw runtime_error("Subgroups are not supported on host device. ");
+    detail::HostSubGroup::exchange(nullptr, 0);
   }
 
 protected:
   template <int dimensions> friend struct cl::sycl::nd_item;
-  sub_group() {
-    throw runtime_error("Subgroups are not supported on host device. ");
-  }
+  sub_group(size_t LocalLinearId, size_t WorkGroupSize)
+      : MLocalId(LocalLinearId % detail::HostSubGroup::MaxSize),
+        MGroupId(LocalLinearId / detail::HostSubGroup::MaxSize),
+        MGroupRange((WorkGroupSize + detail::HostSubGroup::MaxSize - 1) /
+                    detail::HostSubGroup::MaxSize) {
+    MLocalRange = std::min(WorkGroupSize - MGroupId *
+                                               detail::HostSubGroup::MaxSize,
+                           detail::HostSubGroup::MaxSize);
+    detail::HostSubGroup::markUsed();
+  }
+
+private:
+  template <typename T> struct Pair {
+    T First;
+    T Second;
+  };
+
+  template <typename T> const char *exchange(const T &x) const {
+    return detail::HostSubGroup::exchange(&x, sizeof(T));
+  }
+
+  // The data of the work-items is not necessarily aligned for T.
+  template <typename T> static T valueOf(const char *Data, size_t Index) {
+    T Res;
+    std::memcpy(&Res, Data + Index * sizeof(T), sizeof(T));
+    return Res;
+  }
+
+  // Returns the element Index of the concatenation of the first and the
+  // second values of the work-items.
+  template <typename T> T select(const char *Data, size_t Index) const {
+    const Pair<T> P = valueOf<Pair<T>>(
+        Data, Index < MLocalRange ? Index : Index - MLocalRange);
+    return Index < MLocalRange ? P.First : P.Second;
+  }
+
+  // Combines the values of the first Count work-items.
+  template <typename T, class BinaryOperation>
+  static T fold(const char *Data, size_t Count) {
+    T Res = BinaryOperation::template identity<T>();
+    for (size_t I = 0; I < Count; ++I)
+      Res = BinaryOperation::calc(Res, valueOf<T>(Data, I));
+    return Res;
+  }
+
+  size_t MLocalId;
+  size_t MLocalRange;
+  size_t MGroupId;
+  size_t MGroupRange;
 };
 } // namespace intel
 } // namespace sycl
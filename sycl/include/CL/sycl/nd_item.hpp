@@ -48,7 +48,13 @@ template <int dimensions = 1> struct nd_item {
 
   group<dimensions> get_group() const { return Group; }
 
+#ifdef __SYCL_DEVICE_ONLY__
   intel::sub_group get_sub_group() const { return intel::sub_group(); }
+#else
+  intel::sub_group get_sub_group() const {
+    return intel::sub_group(get_local_linear_id(), get_local_range().size());
+  }
+#endif
 
   size_t get_group(int dimension) const { return Group[dimension]; }
 
@@ -40,6 +40,7 @@ class context_bound;
 
 namespace queue {
 class enable_profiling;
+class in_order;
 } // namespace queue
 
 namespace detail {
@@ -58,6 +59,7 @@ enum PropKind {
 
   // Queue properties
   QueueEnableProfiling,
+  QueueInOrder,
 
   PropKindSize
 };
@@ -111,6 +113,7 @@ RegisterProp(PropKind::BufferContextBound, buffer::context_bound);
 
 // Queue
 RegisterProp(PropKind::QueueEnableProfiling, queue::enable_profiling);
+RegisterProp(PropKind::QueueInOrder, queue::in_order);
 
 // Sentinel, needed for automatic build of tuple in property_list.
 RegisterProp(PropKind::PropKindSize, PropBase);
@@ -173,6 +176,10 @@ public:
 namespace queue {
 class enable_profiling
     : public detail::Prop<detail::PropKind::QueueEnableProfiling> {};
+
+// The command groups submitted to the queue are executed in the submission
+// order.
+class in_order : public detail::Prop<detail::PropKind::QueueInOrder> {};
 } // namespace queue
 
 } // namespace property
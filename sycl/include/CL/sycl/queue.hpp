@@ -89,6 +89,16 @@ public:
     return impl->submit(cgf, impl, secondaryQueue.impl);
   }
 
+  // Copies Count bytes from Src to Dest, see handler::memcpy.
+  event memcpy(void *Dest, const void *Src, size_t Count) {
+    return submit([&](handler &CGH) { CGH.memcpy(Dest, Src, Count); });
+  }
+
+  // Sets Count bytes at Dest to Value, see handler::memset.
+  event memset(void *Dest, int Value, size_t Count) {
+    return submit([&](handler &CGH) { CGH.memset(Dest, Value, Count); });
+  }
+
   void wait() { impl->wait(); }
 
   void wait_and_throw() { impl->wait_and_throw(); }
@@ -0,0 +1,100 @@
+//==---------------- usm.hpp - SYCL USM ------------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <CL/sycl/context.hpp>
+#include <CL/sycl/device.hpp>
+#include <CL/sycl/queue.hpp>
+#include <CL/sycl/usm/usm_enums.hpp>
+
+#include <cstddef>
+
+// Unified shared memory: allocations addressed by plain pointers, both in the
+// host code and in kernels, without buffers and accessors.
+//
+//   int *Data = malloc_shared<int>(N, Queue);
+//   Queue.submit([&](handler &CGH) {
+//     CGH.parallel_for<class Kernel>(range<1>(N),
+//                                    [=](id<1> I) { Data[I] = I[0]; });
+//   });
+//   Queue.wait();
+//   free(Data, Queue);
+//
+// The runtime doesn't track the memory the command groups access through the
+// pointers. The order of such command groups is given with
+// handler::depends_on, or by an in-order queue, or by waiting for them.
+//
+// The allocation functions return nullptr if the memory can't be allocated
+// and throw feature_not_supported if the context doesn't support USM.
+
+namespace cl {
+namespace sycl {
+namespace detail {
+namespace usm {
+
+void *alignedAlloc(size_t Alignment, size_t Size, const context &Ctxt,
+                   const device &Dev, cl::sycl::usm::alloc Kind);
+
+} // namespace usm
+} // namespace detail
+
+// Memory of the device Dev.
+void *malloc_device(size_t Size, const device &Dev, const context &Ctxt);
+void *malloc_device(size_t Size, const queue &Q);
+
+// Host memory accessible by all the devices of the context.
+void *malloc_host(size_t Size, const context &Ctxt);
+void *malloc_host(size_t Size, const queue &Q);
+
+// Memory accessible by the host and the device Dev.
+void *malloc_shared(size_t Size, const device &Dev, const context &Ctxt);
+void *malloc_shared(size_t Size, const queue &Q);
+
+// Frees the memory allocated by the functions above, which must not be used
+// by any command group anymore.
+void free(void *Ptr, const context &Ctxt);
+void free(void *Ptr, const queue &Q);
+
+// Returns the kind of the allocation of the context Ptr points into.
+usm::alloc get_pointer_type(const void *Ptr, const context &Ctxt);
+
+// Typed versions of the allocation functions, for Count elements of type T.
+
+template <typename T>
+T *malloc_device(size_t Count, const device &Dev, const context &Ctxt) {
+  return static_cast<T *>(detail::usm::alignedAlloc(
+      alignof(T), Count * sizeof(T), Ctxt, Dev, usm::alloc::device));
+}
+
+template <typename T> T *malloc_device(size_t Count, const queue &Q) {
+  return malloc_device<T>(Count, Q.get_device(), Q.get_context());
+}
+
+template <typename T> T *malloc_host(size_t Count, const context &Ctxt) {
+  return static_cast<T *>(
+      detail::usm::alignedAlloc(alignof(T), Count * sizeof(T), Ctxt,
+                                Ctxt.get_devices()[0], usm::alloc::host));
+}
+
+template <typename T> T *malloc_host(size_t Count, const queue &Q) {
+  return malloc_host<T>(Count, Q.get_context());
+}
+
+template <typename T>
+T *malloc_shared(size_t Count, const device &Dev, const context &Ctxt) {
+  return static_cast<T *>(detail::usm::alignedAlloc(
+      alignof(T), Count * sizeof(T), Ctxt, Dev, usm::alloc::shared));
+}
+
+template <typename T> T *malloc_shared(size_t Count, const queue &Q) {
+  return malloc_shared<T>(Count, Q.get_device(), Q.get_context());
+}
+
+} // namespace sycl
+} // namespace cl
@@ -0,0 +1,25 @@
+//==-------------- usm_enums.hpp - SYCL USM Enums --------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+namespace cl {
+namespace sycl {
+namespace usm {
+
+// The kinds of unified shared memory allocations.
+//   host    - host memory accessible by the devices of the context.
+//   device  - memory of one device, not accessible by the host.
+//   shared  - memory accessible by the host and one device, which may migrate
+//             between them.
+//   unknown - a pointer not allocated by the USM functions of the context.
+enum class alloc { host, device, shared, unknown };
+
+} // namespace usm
+} // namespace sycl
+} // namespace cl
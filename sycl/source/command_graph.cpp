@@ -0,0 +1,38 @@
+//==----------- command_graph.cpp --- SYCL command graph -------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/command_graph_impl.hpp>
+#include <CL/sycl/intel/command_graph.hpp>
+
+namespace cl {
+namespace sycl {
+namespace intel {
+
+command_graph::command_graph()
+    : impl(std::make_shared<detail::command_graph_impl>()) {}
+
+void command_graph::begin_recording(queue &Queue) {
+  impl->beginRecording(detail::getSyclObjImpl(Queue));
+}
+
+void command_graph::end_recording() { impl->endRecording(); }
+
+size_t command_graph::size() const { return impl->size(); }
+
+void command_graph::set_arg_impl(size_t CommandGroupIndex, int ArgIndex,
+                                 const void *Arg, size_t Size) {
+  impl->setArg(CommandGroupIndex, ArgIndex, Arg, Size);
+}
+
+event command_graph::replay() {
+  return detail::createSyclObjFromImpl<event>(impl->replay());
+}
+
+} // namespace intel
+} // namespace sycl
+} // namespace cl
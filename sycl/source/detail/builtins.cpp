@@ -237,148 +237,149 @@ namespace cl {
 namespace __host_std {
 namespace detail {
 
+// The host vectors hold their elements as a plain array, the 3-element ones
+// padded to 4. The helpers unpack the vector arguments into arrays, apply the
+// scalar function to the elements in a loop, which the compiler can unroll and
+// vectorize, and pack the results back. This avoids creating a swizzle object
+// per element.
+template <typename VecT> using elem_t = typename VecT::element_type;
+
+template <int Num, typename VecT>
+inline void unpack(elem_t<VecT> (&Elems)[Num], const VecT &V) {
+  static_assert(sizeof(VecT) >= sizeof(Elems), "Unexpected vector layout");
+  const elem_t<VecT> *Data = reinterpret_cast<const elem_t<VecT> *>(&V);
+  for (int I = 0; I < Num; ++I)
+    Elems[I] = Data[I];
+}
+
+template <int Num, typename VecT>
+inline void pack(VecT &V, const elem_t<VecT> (&Elems)[Num]) {
+  static_assert(sizeof(VecT) >= sizeof(Elems), "Unexpected vector layout");
+  elem_t<VecT> *Data = reinterpret_cast<elem_t<VecT> *>(&V);
+  for (int I = 0; I < Num; ++I)
+    Data[I] = Elems[I];
+}
+
+// N is the index of the last element.
 template <int N> struct helper {
-  template <typename Res, typename Op, typename T1>
-  inline void run_1v(Res &r, Op op, T1 x) {
-    helper<N - 1>().run_1v(r, op, x);
-    r.template swizzle<N>() = op(x.template swizzle<N>());
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2>
-  inline void run_1v_2v(Res &r, Op op, T1 x, T2 y) {
-    helper<N - 1>().run_1v_2v(r, op, x, y);
-    r.template swizzle<N>() =
-        op(x.template swizzle<N>(), y.template swizzle<N>());
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2>
-  inline void run_1v_2s(Res &r, Op op, T1 x, T2 y) {
-    helper<N - 1>().run_1v_2s(r, op, x, y);
-    r.template swizzle<N>() = op(x.template swizzle<N>(), y);
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2, typename T3>
-  inline void run_1v_2s_3s(Res &r, Op op, T1 x, T2 y, T3 z) {
-    helper<N - 1>().run_1v_2s_3s(r, op, x, y, z);
-    r.template swizzle<N>() = op(x.template swizzle<N>(), y, z);
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2>
-  inline void run_1v_2v_rs(Res &r, Op op, T1 x, T2 y) {
-    helper<N - 1>().run_1v_2v_rs(r, op, x, y);
-    op(r, x.template swizzle<N>(), y.template swizzle<N>());
-  }
-
-  template <typename Res, typename Op, typename T1>
-  inline void run_1v_rs(Res &r, Op op, T1 x) {
-    helper<N - 1>().run_1v_rs(r, op, x);
-    op(r, x.template swizzle<N>());
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2>
-  inline void run_1v_2p(Res &r, Op op, T1 x, T2 y) {
-    helper<N - 1>().run_1v_2p(r, op, x, y);
-    // TODO avoid creating a temporary variable
-    typename std::remove_pointer<T2>::type::element_type temp;
-    r.template swizzle<N>() = op(x.template swizzle<N>(), &temp);
-    y->template swizzle<N>() = temp;
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2, typename T3>
-  inline void run_1v_2v_3p(Res &r, Op op, T1 x, T2 y, T3 z) {
-    helper<N - 1>().run_1v_2v_3p(r, op, x, y, z);
-    // TODO avoid creating a temporary variable
-    typename std::remove_pointer<T3>::type::element_type temp;
-    r.template swizzle<N>() =
-        op(x.template swizzle<N>(), y.template swizzle<N>(), &temp);
-    z->template swizzle<N>() = temp;
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2, typename T3>
-  inline void run_1v_2v_3v(Res &r, Op op, T1 x, T2 y, T3 z) {
-    helper<N - 1>().run_1v_2v_3v(r, op, x, y, z);
-    r.template swizzle<N>() =
-        op(x.template swizzle<N>(), y.template swizzle<N>(),
-           z.template swizzle<N>());
-  }
-
-  template <typename Res, typename Op, typename T1>
-  inline void run_1v_sr_or(Res &r, Op op, T1 x) {
-    helper<N - 1>().run_1v_sr_or(r, op, x);
-    r = (op(x.template swizzle<N>()) || r);
-  }
-
-  template <typename Res, typename Op, typename T1>
-  inline void run_1v_sr_and(Res &r, Op op, T1 x) {
-    helper<N - 1>().run_1v_sr_and(r, op, x);
-    r = (op(x.template swizzle<N>()) && r);
-  }
-};
+  static constexpr int Num = N + 1;
 
-template <> struct helper<0> {
   template <typename Res, typename Op, typename T1>
   inline void run_1v(Res &r, Op op, T1 x) {
-    r.template swizzle<0>() = op(x.template swizzle<0>());
+    elem_t<T1> X[Num];
+    unpack(X, x);
+    elem_t<Res> R[Num];
+    for (int I = 0; I < Num; ++I)
+      R[I] = op(X[I]);
+    pack(r, R);
   }
 
   template <typename Res, typename Op, typename T1, typename T2>
   inline void run_1v_2v(Res &r, Op op, T1 x, T2 y) {
-    r.template swizzle<0>() =
-        op(x.template swizzle<0>(), y.template swizzle<0>());
+    elem_t<T1> X[Num];
+    elem_t<T2> Y[Num];
+    unpack(X, x);
+    unpack(Y, y);
+    elem_t<Res> R[Num];
+    for (int I = 0; I < Num; ++I)
+      R[I] = op(X[I], Y[I]);
+    pack(r, R);
   }
 
   template <typename Res, typename Op, typename T1, typename T2>
   inline void run_1v_2s(Res &r, Op op, T1 x, T2 y) {
-    r.template swizzle<0>() = op(x.template swizzle<0>(), y);
+    elem_t<T1> X[Num];
+    unpack(X, x);
+    elem_t<Res> R[Num];
+    for (int I = 0; I < Num; ++I)
+      R[I] = op(X[I], y);
+    pack(r, R);
   }
 
   template <typename Res, typename Op, typename T1, typename T2, typename T3>
   inline void run_1v_2s_3s(Res &r, Op op, T1 x, T2 y, T3 z) {
-    r.template swizzle<0>() = op(x.template swizzle<0>(), y, z);
+    elem_t<T1> X[Num];
+    unpack(X, x);
+    elem_t<Res> R[Num];
+    for (int I = 0; I < Num; ++I)
+      R[I] = op(X[I], y, z);
+    pack(r, R);
   }
 
   template <typename Res, typename Op, typename T1, typename T2>
   inline void run_1v_2v_rs(Res &r, Op op, T1 x, T2 y) {
-    op(r, x.template swizzle<0>(), y.template swizzle<0>());
+    elem_t<T1> X[Num];
+    elem_t<T2> Y[Num];
+    unpack(X, x);
+    unpack(Y, y);
+    for (int I = 0; I < Num; ++I)
+      op(r, X[I], Y[I]);
   }
 
   template <typename Res, typename Op, typename T1>
   inline void run_1v_rs(Res &r, Op op, T1 x) {
-    op(r, x.template swizzle<0>());
+    elem_t<T1> X[Num];
+    unpack(X, x);
+    for (int I = 0; I < Num; ++I)
+      op(r, X[I]);
   }
 
   template <typename Res, typename Op, typename T1, typename T2>
   inline void run_1v_2p(Res &r, Op op, T1 x, T2 y) {
-    // TODO avoid creating a temporary variable
-    typename std::remove_pointer<T2>::type::element_type temp;
-    r.template swizzle<0>() = op(x.template swizzle<0>(), &temp);
-    y->template swizzle<0>() = temp;
+    elem_t<T1> X[Num];
+    unpack(X, x);
+    elem_t<Res> R[Num];
+    elem_t<typename std::remove_pointer<T2>::type> Y[Num];
+    for (int I = 0; I < Num; ++I)
+      R[I] = op(X[I], &Y[I]);
+    pack(r, R);
+    pack(*y, Y);
   }
 
   template <typename Res, typename Op, typename T1, typename T2, typename T3>
   inline void run_1v_2v_3p(Res &r, Op op, T1 x, T2 y, T3 z) {
-    // TODO avoid creating a temporary variable
-    typename std::remove_pointer<T3>::type::element_type temp;
-    r.template swizzle<0>() =
-        op(x.template swizzle<0>(), y.template swizzle<0>(), &temp);
-    z->template swizzle<0>() = temp;
+    elem_t<T1> X[Num];
+    elem_t<T2> Y[Num];
+    unpack(X, x);
+    unpack(Y, y);
+    elem_t<Res> R[Num];
+    elem_t<typename std::remove_pointer<T3>::type> Z[Num];
+    for (int I = 0; I < Num; ++I)
+      R[I] = op(X[I], Y[I], &Z[I]);
+    pack(r, R);
+    pack(*z, Z);
   }
 
   template <typename Res, typename Op, typename T1, typename T2, typename T3>
   inline void run_1v_2v_3v(Res &r, Op op, T1 x, T2 y, T3 z) {
-    r.template swizzle<0>() =
-        op(x.template swizzle<0>(), y.template swizzle<0>(),
-           z.template swizzle<0>());
+    elem_t<T1> X[Num];
+    elem_t<T2> Y[Num];
+    elem_t<T3> Z[Num];
+    unpack(X, x);
+    unpack(Y, y);
+    unpack(Z, z);
+    elem_t<Res> R[Num];
+    for (int I = 0; I < Num; ++I)
+      R[I] = op(X[I], Y[I], Z[I]);
+    pack(r, R);
   }
 
   template <typename Res, typename Op, typename T1>
   inline void run_1v_sr_or(Res &r, Op op, T1 x) {
-    r = op(x.template swizzle<0>());
+    elem_t<T1> X[Num];
+    unpack(X, x);
+    r = op(X[0]);
+    for (int I = 1; I < Num; ++I)
+      r = (op(X[I]) || r);
   }
 
   template <typename Res, typename Op, typename T1>
   inline void run_1v_sr_and(Res &r, Op op, T1 x) {
-    r = op(x.template swizzle<0>());
+    elem_t<T1> X[Num];
+    unpack(X, x);
+    r = op(X[0]);
+    for (int I = 1; I < Num; ++I)
+      r = (op(X[I]) && r);
   }
 };
 } // namespace detail
@@ -0,0 +1,84 @@
+//==------- command_graph_impl.cpp --- SYCL command graph implementation ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/cg.hpp>
+#include <CL/sycl/detail/command_graph_impl.hpp>
+#include <CL/sycl/detail/scheduler/commands.hpp>
+#include <CL/sycl/event.hpp>
+#include <CL/sycl/exception.hpp>
+
+#include <cstring>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+command_graph_impl::~command_graph_impl() {
+  if (MIsRecording)
+    MQueue->setRecordedGraph(nullptr);
+}
+
+void command_graph_impl::beginRecording(QueueImplPtr Queue) {
+  if (MIsRecording || MIsFinalized)
+    throw invalid_object_error("The command graph is already recorded");
+  if (Queue->getRecordedGraph())
+    throw invalid_object_error("The queue is already being recorded");
+  MQueue = std::move(Queue);
+  MQueue->setRecordedGraph(&MGraph);
+  MIsRecording = true;
+}
+
+void command_graph_impl::endRecording() {
+  if (!MIsRecording)
+    throw invalid_object_error("The command graph is not being recorded");
+  MQueue->setRecordedGraph(nullptr);
+  MIsRecording = false;
+  Scheduler::getInstance().finalizeRecording(MGraph);
+  MIsFinalized = true;
+}
+
+void command_graph_impl::setArg(size_t CGIndex, int ArgIndex, const void *Arg,
+                                size_t Size) {
+  if (CGIndex >= MGraph.MCommands.size())
+    throw invalid_parameter_error("Command group index is out of range");
+
+  CG &CommandGroup =
+      static_cast<ExecCGCommand *>(MGraph.MCommands[CGIndex])->getCG();
+  if (CommandGroup.getType() != CG::KERNEL)
+    throw invalid_parameter_error("The command group doesn't run a kernel");
+
+  for (ArgDesc &Desc : static_cast<CGExecKernel &>(CommandGroup).MArgs) {
+    if (Desc.MIndex != ArgIndex)
+      continue;
+    if (Desc.MType != kernel_param_kind_t::kind_std_layout || !Desc.MPtr)
+      throw invalid_parameter_error("Only arguments passed by value can be "
+                                    "set");
+    if (static_cast<size_t>(Desc.MSize) != Size)
+      throw invalid_parameter_error("The argument size doesn't match");
+    // The descriptor points into the kernel functor, so both the device and
+    // the host versions of the kernel see the new value.
+    std::memcpy(Desc.MPtr, Arg, Size);
+    return;
+  }
+  throw invalid_parameter_error("The kernel has no argument with such index");
+}
+
+EventImplPtr command_graph_impl::replay() {
+  if (!MIsFinalized)
+    throw invalid_object_error("The command graph recording is not finished");
+  if (MGraph.MCommands.empty())
+    return std::make_shared<event_impl>();
+
+  EventImplPtr Event = Scheduler::getInstance().replay(MGraph);
+  MQueue->addEvent(createSyclObjFromImpl<event>(Event));
+  return Event;
+}
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
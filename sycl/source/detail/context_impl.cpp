@@ -21,7 +21,9 @@ namespace detail {
 
 context_impl::context_impl(const device &Device, async_handler AsyncHandler)
     : m_AsyncHandler(AsyncHandler), m_Devices(1, Device), m_ClContext(nullptr),
-      m_Platform(), m_OpenCLInterop(false), m_HostContext(true) {}
+      m_Platform(), m_OpenCLInterop(false), m_HostContext(true) {
+  m_USMDispatch.reset(new USMDispatcher(nullptr, nullptr, {}));
+}
 
 context_impl::context_impl(const vector_class<cl::sycl::device> Devices,
                            async_handler AsyncHandler)
@@ -33,10 +35,13 @@ context_impl::context_impl(const vector_class<cl::sycl::device> Devices,
     DeviceIds.push_back(D.get());
   }
   cl_int Err;
-  m_ClContext =
-      clCreateContext(0, DeviceIds.size(), DeviceIds.data(), 0, 0, &Err);
+  m_ClContext = PI_TRACED(clCreateContext)(0, DeviceIds.size(),
+                                           DeviceIds.data(), 0, 0, &Err);
   // TODO catch an exception and put it to list of asynchronous exceptions
   CHECK_OCL_CODE(Err);
+  m_MemoryPool.reset(new MemoryPool(m_ClContext));
+  m_USMDispatch.reset(
+      new USMDispatcher(m_ClContext, m_Platform.get(), DeviceIds));
 }
 
 context_impl::context_impl(cl_context ClContext, async_handler AsyncHandler)
@@ -45,12 +50,12 @@ context_impl::context_impl(cl_context ClContext, async_handler AsyncHandler)
   vector_class<cl_device_id> DeviceIds;
   size_t DevicesBuffer = 0;
   // TODO catch an exception and put it to list of asynchronous exceptions
-  CHECK_OCL_CODE(clGetContextInfo(m_ClContext, CL_CONTEXT_DEVICES, 0, nullptr,
-                                  &DevicesBuffer));
+  CHECK_OCL_CODE(PI_TRACED(clGetContextInfo)(m_ClContext, CL_CONTEXT_DEVICES, 0,
+                                             nullptr, &DevicesBuffer));
   DeviceIds.resize(DevicesBuffer / sizeof(cl_device_id));
   // TODO catch an exception and put it to list of asynchronous exceptions
-  CHECK_OCL_CODE(clGetContextInfo(m_ClContext, CL_CONTEXT_DEVICES,
-                                  DevicesBuffer, &DeviceIds[0], nullptr));
+  CHECK_OCL_CODE(PI_TRACED(clGetContextInfo)(
+      m_ClContext, CL_CONTEXT_DEVICES, DevicesBuffer, &DeviceIds[0], nullptr));
 
   for (auto Dev : DeviceIds) {
     m_Devices.emplace_back(Dev);
@@ -58,13 +63,16 @@ context_impl::context_impl(cl_context ClContext, async_handler AsyncHandler)
   // TODO What if m_Devices if empty? m_Devices[0].get_platform()
   m_Platform = platform(m_Devices[0].get_platform());
   // TODO catch an exception and put it to list of asynchronous exceptions
-  CHECK_OCL_CODE(clRetainContext(m_ClContext));
+  CHECK_OCL_CODE(PI_TRACED(clRetainContext)(m_ClContext));
+  m_MemoryPool.reset(new MemoryPool(m_ClContext));
+  m_USMDispatch.reset(
+      new USMDispatcher(m_ClContext, m_Platform.get(), DeviceIds));
 }
 
 cl_context context_impl::get() const {
   if (m_OpenCLInterop) {
     // TODO catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE(clRetainContext(m_ClContext));
+    CHECK_OCL_CODE(PI_TRACED(clRetainContext)(m_ClContext));
     return m_ClContext;
   }
   throw invalid_object_error(
@@ -76,10 +84,14 @@ platform context_impl::get_platform() const { return m_Platform; }
 vector_class<device> context_impl::get_devices() const { return m_Devices; }
 
 context_impl::~context_impl() {
+  // The pooled buffers and USM allocations must be released before the
+  // context.
+  m_MemoryPool.reset();
+  m_USMDispatch.reset();
   if (m_OpenCLInterop) {
     // TODO replace CHECK_OCL_CODE_NO_EXC to CHECK_OCL_CODE and
     // catch an exception and put it to list of asynchronous exceptions
-    CHECK_OCL_CODE_NO_EXC(clReleaseContext(m_ClContext));
+    CHECK_OCL_CODE_NO_EXC(PI_TRACED(clReleaseContext)(m_ClContext));
   }
 }
 
@@ -10,6 +10,7 @@
 #include <CL/sycl/detail/event_impl.hpp>
 #include <CL/sycl/detail/queue_impl.hpp>
 #include <CL/sycl/detail/scheduler/scheduler.hpp>
+#include <CL/sycl/detail/stream_impl.hpp>
 
 namespace cl {
 namespace sycl {
@@ -21,7 +22,7 @@ bool event_impl::is_host() const { return m_HostEvent || !m_OpenCLInterop; }
 
 cl_event event_impl::get() const {
   if (m_OpenCLInterop) {
-    CHECK_OCL_CODE(clRetainEvent(m_Event));
+    CHECK_OCL_CODE(PI_TRACED(clRetainEvent)(m_Event));
     return m_Event;
   }
   throw invalid_object_error(
@@ -30,22 +31,40 @@ cl_event event_impl::get() const {
 
 event_impl::~event_impl() {
   if (!m_HostEvent) {
-    CHECK_OCL_CODE_NO_EXC(clReleaseEvent(m_Event));
+    CHECK_OCL_CODE_NO_EXC(PI_TRACED(clReleaseEvent)(m_Event));
   }
 }
 
 void event_impl::setComplete() {
-  CHECK_OCL_CODE(clSetUserEventStatus(m_Event, CL_COMPLETE));
+  CHECK_OCL_CODE(PI_TRACED(clSetUserEventStatus)(m_Event, CL_COMPLETE));
 }
 
 void event_impl::waitInternal() const {
   if (!m_HostEvent) {
-    CHECK_OCL_CODE(clWaitForEvents(1, &m_Event));
+    CHECK_OCL_CODE(PI_TRACED(clWaitForEvents)(1, &m_Event));
   }
   // Waiting of host events is NOP so far as all operations on host device
   // are blocking.
 }
 
+bool event_impl::isCompleted() const {
+  // The handle is set by the thread enqueueing the command, it can be read
+  // only after the command is seen enqueued.
+  const Command *Cmd = static_cast<const Command *>(m_Command);
+  if (Cmd && !Cmd->isEnqueued())
+    return false;
+  // Host commands are executed when they are enqueued.
+  if (m_HostEvent)
+    return true;
+  if (!m_Event)
+    return false;
+  cl_int Status = CL_QUEUED;
+  CHECK_OCL_CODE(PI_TRACED(clGetEventInfo)(m_Event,
+                                           CL_EVENT_COMMAND_EXECUTION_STATUS,
+                                           sizeof(Status), &Status, nullptr));
+  return Status == CL_COMPLETE;
+}
+
 cl_event &event_impl::getHandleRef() { return m_Event; }
 
 const ContextImplPtr &event_impl::getContextImpl() { return m_Context; }
@@ -66,15 +85,15 @@ event_impl::event_impl(cl_event CLEvent, const context &SyclContext)
   }
 
   cl_context TempContext;
-  clGetEventInfo(CLEvent, CL_EVENT_CONTEXT, sizeof(cl_context), &TempContext,
-                 nullptr);
+  PI_TRACED(clGetEventInfo)(CLEvent, CL_EVENT_CONTEXT, sizeof(cl_context),
+                            &TempContext, nullptr);
   if (m_Context->getHandleRef() != TempContext) {
     throw cl::sycl::invalid_parameter_error(
         "The syclContext must match the OpenCL context associated with the "
         "clEvent.");
   }
 
-  CHECK_OCL_CODE(clRetainEvent(m_Event));
+  CHECK_OCL_CODE(PI_TRACED(clRetainEvent)(m_Event));
 }
 
 void event_impl::wait(
@@ -86,6 +105,11 @@ void event_impl::wait(
     waitInternal();
   else
     detail::Scheduler::getInstance().waitForEvent(std::move(Self));
+
+  // The streams of the kernel are flushed in the background, the output is
+  // expected to be printed once the event is waited for.
+  if (size_t Ticket = m_StreamFlushTicket.load())
+    stream_impl::waitForFlushes(Ticket);
 }
 
 void event_impl::wait_and_throw(
@@ -0,0 +1,174 @@
+//==----------- host_executor.cpp --- SYCL host device executor ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/host_executor.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+// Each thread gets several chunks on average, so that uneven work-items don't
+// leave the other threads idle at the end of the kernel.
+static constexpr size_t ChunksPerThread = 8;
+
+namespace {
+
+// A single parallelFor call. The chunks are taken by the calling thread and
+// by the workers in any order.
+struct Job {
+  Job(size_t Size, size_t NumChunks,
+      const std::function<void(size_t, size_t)> &Func)
+      : MSize(Size), MNumChunks(NumChunks), MFunc(Func) {}
+
+  // Processes chunks until there are none left. Returns false if there were
+  // no chunks to take.
+  bool work() {
+    bool Worked = false;
+    while (true) {
+      size_t Chunk = MNextChunk.fetch_add(1);
+      if (Chunk >= MNumChunks)
+        return Worked;
+      Worked = true;
+      if (!MFailed.load()) {
+        try {
+          MFunc(MSize * Chunk / MNumChunks, MSize * (Chunk + 1) / MNumChunks);
+        } catch (...) {
+          std::lock_guard<std::mutex> Lock(MMutex);
+          if (!MFailed.exchange(true))
+            MException = std::current_exception();
+        }
+      }
+      if (MDoneChunks.fetch_add(1) + 1 == MNumChunks) {
+        std::lock_guard<std::mutex> Lock(MMutex);
+        MCondVar.notify_all();
+      }
+    }
+  }
+
+  bool isExhausted() const { return MNextChunk.load() >= MNumChunks; }
+
+  void wait() {
+    std::unique_lock<std::mutex> Lock(MMutex);
+    MCondVar.wait(Lock, [this] { return MDoneChunks.load() == MNumChunks; });
+    if (MException)
+      std::rethrow_exception(MException);
+  }
+
+  const size_t MSize;
+  const size_t MNumChunks;
+  const std::function<void(size_t, size_t)> &MFunc;
+  std::atomic<size_t> MNextChunk{0};
+  std::atomic<size_t> MDoneChunks{0};
+  std::atomic<bool> MFailed{false};
+  std::exception_ptr MException;
+  std::mutex MMutex;
+  std::condition_variable MCondVar;
+};
+
+using JobPtr = std::shared_ptr<Job>;
+
+// The worker threads. They are shared by all host queues, jobs submitted
+// concurrently are processed in the submission order.
+class ThreadPool {
+public:
+  explicit ThreadPool(size_t NumWorkers) {
+    for (size_t I = 0; I < NumWorkers; ++I)
+      MWorkers.emplace_back(&ThreadPool::run, this);
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      MStop = true;
+    }
+    MCondVar.notify_all();
+    for (std::thread &Worker : MWorkers)
+      Worker.join();
+  }
+
+  void push(const JobPtr &NewJob) {
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      MJobs.push_back(NewJob);
+    }
+    MCondVar.notify_all();
+  }
+
+private:
+  void run() {
+    std::unique_lock<std::mutex> Lock(MMutex);
+    while (true) {
+      MCondVar.wait(Lock, [this] { return MStop || !MJobs.empty(); });
+      if (MStop)
+        return;
+      JobPtr CurJob = MJobs.front();
+      Lock.unlock();
+      CurJob->work();
+      Lock.lock();
+      // Some other worker may have already removed the job.
+      if (!MJobs.empty() && MJobs.front() == CurJob && CurJob->isExhausted())
+        MJobs.pop_front();
+    }
+  }
+
+  std::mutex MMutex;
+  std::condition_variable MCondVar;
+  std::deque<JobPtr> MJobs;
+  bool MStop = false;
+  std::vector<std::thread> MWorkers;
+};
+
+} // namespace
+
+size_t HostExecutor::getNumThreads() {
+  static const size_t NumThreads = []() -> size_t {
+    if (const char *Val = std::getenv("SYCL_HOST_NUM_THREADS")) {
+      size_t Num = static_cast<size_t>(std::strtoull(Val, nullptr, 10));
+      if (Num > 0)
+        return Num;
+    }
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }();
+  return NumThreads;
+}
+
+void HostExecutor::parallelFor(
+    size_t Size, const std::function<void(size_t, size_t)> &Func) {
+  const size_t NumThreads = getNumThreads();
+  if (NumThreads == 1 || Size <= 1) {
+    if (Size)
+      Func(0, Size);
+    return;
+  }
+
+  // Created on the first use, so that no threads are started by applications
+  // that don't use the host device. The calling thread takes part in the work,
+  // so one worker less is needed.
+  static ThreadPool Pool(NumThreads - 1);
+
+  JobPtr NewJob = std::make_shared<Job>(
+      Size, std::min(Size, NumThreads * ChunksPerThread), Func);
+  Pool.push(NewJob);
+  NewJob->work();
+  NewJob->wait();
+}
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
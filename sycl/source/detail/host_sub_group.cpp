@@ -0,0 +1,418 @@
+//==---------- host_sub_group.cpp --- SYCL host device sub-groups ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/host_sub_group.hpp>
+#include <CL/sycl/exception.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__x86_64__) && defined(__ELF__)
+#define SYCL_HOST_SUB_GROUP_ASM_SWITCH
+#include <cstdint>
+#else
+#include <ucontext.h>
+#endif
+
+#ifndef __has_feature
+#define __has_feature(x) 0
+#endif
+#if defined(__SANITIZE_ADDRESS__) || __has_feature(address_sanitizer)
+#include <sanitizer/asan_interface.h>
+#define SYCL_HOST_SUB_GROUP_UNPOISON(Addr, Size)                              \
+  ASAN_UNPOISON_MEMORY_REGION(Addr, Size)
+#else
+#define SYCL_HOST_SUB_GROUP_UNPOISON(Addr, Size)
+#endif
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+constexpr size_t HostSubGroup::MaxSize;
+
+static constexpr size_t DefaultStackSize = 1024 * 1024;
+
+static size_t getStackSize() {
+  static const size_t Size = []() -> size_t {
+    if (const char *Val = std::getenv("SYCL_HOST_SUB_GROUP_STACK_SIZE")) {
+      size_t Size = static_cast<size_t>(std::strtoull(Val, nullptr, 10));
+      if (Size > 0)
+        return Size;
+    }
+    return DefaultStackSize;
+  }();
+  return Size;
+}
+
+namespace {
+
+// Runs the work-groups of a single thread. Every lane is a fiber running the
+// work-items with the same sub-group local id one after another, the thread
+// itself schedules the lanes of the current sub-group in rounds: each round
+// resumes every lane that is not done with its work-item yet, and the lane
+// runs until it calls a sub-group function or finishes the work-item. So in
+// every round but the first all the lanes pass the same sub-group function.
+class SubGroupRunner {
+public:
+  SubGroupRunner() = default;
+  SubGroupRunner(const SubGroupRunner &) = delete;
+  SubGroupRunner &operator=(const SubGroupRunner &) = delete;
+  ~SubGroupRunner();
+
+  void runWorkGroup(size_t Size, const std::function<void(size_t)> &Func);
+  const char *exchange(const void *Data, size_t Size);
+  void markUsed() { MUsed = true; }
+
+  // The body of the lane fibers, never returns.
+  void runLane(size_t Lane);
+
+private:
+  void createLane(size_t Lane);
+  void destroyLane(size_t Lane);
+  void beginSubGroup(size_t First, size_t NumLanes);
+  void resume(size_t Lane);
+  void yield();
+  // Runs the rounds of the current sub-group starting with the given lane of
+  // the current round until all the lanes are done.
+  void runRounds(size_t Lane);
+  void fail();
+
+#ifdef _WIN32
+  LPVOID MScheduler = nullptr;
+  bool MConvertedThread = false;
+  LPVOID MLanes[HostSubGroup::MaxSize] = {};
+#elif defined(SYCL_HOST_SUB_GROUP_ASM_SWITCH)
+  // The saved stack pointers.
+  void *MScheduler = nullptr;
+  void *MLanes[HostSubGroup::MaxSize] = {};
+  std::unique_ptr<char[]> MStacks[HostSubGroup::MaxSize];
+#else
+  ucontext_t MScheduler;
+  ucontext_t MLanes[HostSubGroup::MaxSize];
+  std::unique_ptr<char[]> MStacks[HostSubGroup::MaxSize];
+#endif
+  bool MHasLanes = false;
+
+  const std::function<void(size_t)> *MFunc = nullptr;
+  // Local linear id of the first work-item of the current sub-group.
+  size_t MFirst = 0;
+  size_t MNumLanes = 0;
+  size_t MCurrent = 0;
+  bool MInLane = false;
+  bool MFinished[HostSubGroup::MaxSize] = {};
+  bool MUsed = false;
+  size_t MRound = 0;
+  // The data is exchanged through two storages used in turns by the rounds:
+  // a lane may pass to the next sub-group function while the lanes resumed
+  // after it still read the data of the previous one.
+  std::vector<char> MStorage[2];
+  std::exception_ptr MError;
+};
+
+} // namespace
+
+static SubGroupRunner &getRunner() {
+  static thread_local std::unique_ptr<SubGroupRunner> Runner;
+  if (!Runner)
+    Runner.reset(new SubGroupRunner());
+  return *Runner;
+}
+
+#ifdef _WIN32
+static VOID CALLBACK laneEntry(LPVOID Lane) {
+  getRunner().runLane(reinterpret_cast<size_t>(Lane));
+}
+
+void SubGroupRunner::createLane(size_t Lane) {
+  if (!MScheduler) {
+    MConvertedThread = !IsThreadAFiber();
+    MScheduler =
+        MConvertedThread ? ConvertThreadToFiber(nullptr) : GetCurrentFiber();
+    if (!MScheduler)
+      throw runtime_error("Failed to create the host sub-group fibers.");
+  }
+  MLanes[Lane] = CreateFiber(getStackSize(), &laneEntry,
+                             reinterpret_cast<LPVOID>(Lane));
+  if (!MLanes[Lane])
+    throw runtime_error("Failed to create the host sub-group fibers.");
+}
+
+void SubGroupRunner::destroyLane(size_t Lane) {
+  if (MLanes[Lane])
+    DeleteFiber(MLanes[Lane]);
+  MLanes[Lane] = nullptr;
+}
+
+void SubGroupRunner::resume(size_t Lane) {
+  MCurrent = Lane;
+  MInLane = true;
+  SwitchToFiber(MLanes[Lane]);
+  MInLane = false;
+}
+
+void SubGroupRunner::yield() { SwitchToFiber(MScheduler); }
+
+SubGroupRunner::~SubGroupRunner() {
+  for (size_t Lane = 0; Lane < HostSubGroup::MaxSize; ++Lane)
+    destroyLane(Lane);
+  if (MConvertedThread)
+    ConvertFiberToThread();
+}
+#elif defined(SYCL_HOST_SUB_GROUP_ASM_SWITCH)
+// swapcontext() saves and restores the signal mask with a system call, which
+// would take most of the time of the sub-group functions. SysV x86-64 only
+// needs the callee-saved registers to be kept over a call.
+//
+// sycl_host_sub_group_switch(From, To) pushes them to the stack of the
+// running fiber, stores its stack pointer to *From and continues the fiber
+// with the stack pointer To. A new fiber starts at
+// sycl_host_sub_group_start, which calls the function in r13 with the
+// argument in r12.
+extern "C" void sycl_host_sub_group_switch(void **From, void *To);
+extern "C" void sycl_host_sub_group_start();
+
+asm(R"(
+  .pushsection .text
+  .p2align 4
+  .hidden sycl_host_sub_group_switch
+  .type sycl_host_sub_group_switch,@function
+sycl_host_sub_group_switch:
+  pushq %rbp
+  pushq %rbx
+  pushq %r12
+  pushq %r13
+  pushq %r14
+  pushq %r15
+  subq $8, %rsp
+  stmxcsr (%rsp)
+  fnstcw 4(%rsp)
+  movq %rsp, (%rdi)
+  movq %rsi, %rsp
+  ldmxcsr (%rsp)
+  fldcw 4(%rsp)
+  addq $8, %rsp
+  popq %r15
+  popq %r14
+  popq %r13
+  popq %r12
+  popq %rbx
+  popq %rbp
+  ret
+  .size sycl_host_sub_group_switch,.-sycl_host_sub_group_switch
+
+  .p2align 4
+  .hidden sycl_host_sub_group_start
+  .type sycl_host_sub_group_start,@function
+sycl_host_sub_group_start:
+  movq %r12, %rdi
+  callq *%r13
+  ud2
+  .size sycl_host_sub_group_start,.-sycl_host_sub_group_start
+  .popsection
+)");
+
+static void laneEntry(size_t Lane) { getRunner().runLane(Lane); }
+
+void SubGroupRunner::createLane(size_t Lane) {
+  const size_t StackSize = getStackSize();
+  if (!MStacks[Lane])
+    MStacks[Lane].reset(new char[StackSize]);
+  // The frames of an abandoned work-item would stay poisoned.
+  SYCL_HOST_SUB_GROUP_UNPOISON(MStacks[Lane].get(), StackSize);
+  // The frame sycl_host_sub_group_switch pops: the default MXCSR and x87
+  // control word, r15, r14, r13, r12, rbx, rbp and the return address. The
+  // stack is 16-byte aligned after the return, as required at the call.
+  const std::uintptr_t Top =
+      reinterpret_cast<std::uintptr_t>(MStacks[Lane].get() + StackSize) &
+      ~std::uintptr_t(15);
+  void **Frame = reinterpret_cast<void **>(Top - 80);
+  const std::uint32_t ControlWords[2] = {0x1F80, 0x037F};
+  std::memcpy(Frame, ControlWords, sizeof(ControlWords));
+  Frame[1] = nullptr;
+  Frame[2] = nullptr;
+  Frame[3] = reinterpret_cast<void *>(&laneEntry);
+  Frame[4] = reinterpret_cast<void *>(Lane);
+  Frame[5] = nullptr;
+  Frame[6] = nullptr;
+  Frame[7] = reinterpret_cast<void *>(&sycl_host_sub_group_start);
+  MLanes[Lane] = Frame;
+}
+
+// The stack is kept for the lane created again in its place.
+void SubGroupRunner::destroyLane(size_t) {}
+
+void SubGroupRunner::resume(size_t Lane) {
+  MCurrent = Lane;
+  MInLane = true;
+  sycl_host_sub_group_switch(&MScheduler, MLanes[Lane]);
+  MInLane = false;
+}
+
+void SubGroupRunner::yield() {
+  sycl_host_sub_group_switch(&MLanes[MCurrent], MScheduler);
+}
+
+SubGroupRunner::~SubGroupRunner() = default;
+#else
+static void laneEntry(int Lane) {
+  getRunner().runLane(static_cast<size_t>(Lane));
+}
+
+void SubGroupRunner::createLane(size_t Lane) {
+  const size_t StackSize = getStackSize();
+  if (!MStacks[Lane])
+    MStacks[Lane].reset(new char[StackSize]);
+  // The frames of an abandoned work-item would stay poisoned.
+  SYCL_HOST_SUB_GROUP_UNPOISON(MStacks[Lane].get(), StackSize);
+  ucontext_t &Ctx = MLanes[Lane];
+  if (getcontext(&Ctx) != 0)
+    throw runtime_error("Failed to create the host sub-group fibers.");
+  Ctx.uc_stack.ss_sp = MStacks[Lane].get();
+  Ctx.uc_stack.ss_size = StackSize;
+  Ctx.uc_link = nullptr;
+  makecontext(&Ctx, reinterpret_cast<void (*)()>(&laneEntry), 1,
+              static_cast<int>(Lane));
+}
+
+// The stack is kept for the lane created again in its place.
+void SubGroupRunner::destroyLane(size_t) {}
+
+void SubGroupRunner::resume(size_t Lane) {
+  MCurrent = Lane;
+  MInLane = true;
+  swapcontext(&MScheduler, &MLanes[Lane]);
+  MInLane = false;
+}
+
+void SubGroupRunner::yield() { swapcontext(&MLanes[MCurrent], &MScheduler); }
+
+SubGroupRunner::~SubGroupRunner() = default;
+#endif
+
+void SubGroupRunner::runLane(size_t Lane) {
+  while (true) {
+    try {
+      (*MFunc)(MFirst + Lane);
+    } catch (...) {
+      if (!MError)
+        MError = std::current_exception();
+    }
+    MFinished[Lane] = true;
+    yield();
+  }
+}
+
+void SubGroupRunner::beginSubGroup(size_t First, size_t NumLanes) {
+  MFirst = First;
+  MNumLanes = NumLanes;
+  MRound = 0;
+  std::fill(MFinished, MFinished + HostSubGroup::MaxSize, false);
+}
+
+void SubGroupRunner::runWorkGroup(size_t Size,
+                                  const std::function<void(size_t)> &Func) {
+  if (Size == 0)
+    return;
+  if (!MHasLanes) {
+    for (size_t Lane = 0; Lane < HostSubGroup::MaxSize; ++Lane)
+      createLane(Lane);
+    MHasLanes = true;
+  }
+  MFunc = &Func;
+  MUsed = false;
+
+  // The first work-item finds out whether the kernel uses sub-groups. It has
+  // to run on a fiber anyway, as it may be the first one of a sub-group to
+  // reach a sub-group function.
+  beginSubGroup(0, std::min(Size, HostSubGroup::MaxSize));
+  resume(0);
+  if (!MUsed && MFinished[0]) {
+    if (MError)
+      fail();
+    for (size_t I = 1; I < Size; ++I)
+      Func(I);
+    return;
+  }
+
+  runRounds(/*Lane=*/1);
+  for (size_t First = HostSubGroup::MaxSize; First < Size;
+       First += HostSubGroup::MaxSize) {
+    beginSubGroup(First, std::min(Size - First, HostSubGroup::MaxSize));
+    runRounds(/*Lane=*/0);
+  }
+}
+
+void SubGroupRunner::runRounds(size_t Lane) {
+  while (true) {
+    for (; Lane < MNumLanes; ++Lane)
+      if (!MFinished[Lane])
+        resume(Lane);
+
+    const size_t NumWaiting =
+        std::count(MFinished, MFinished + MNumLanes, false);
+    if (!MError && NumWaiting != 0 && NumWaiting != MNumLanes)
+      MError = std::make_exception_ptr(runtime_error(
+          "Not all work-items of a sub-group reached a sub-group function."));
+    if (MError)
+      fail();
+    if (NumWaiting == 0)
+      return;
+    ++MRound;
+    Lane = 0;
+  }
+}
+
+void SubGroupRunner::fail() {
+  // The lanes still waiting in a sub-group function can't be resumed, their
+  // work-items are dropped with everything on their stacks.
+  for (size_t Lane = 0; Lane < MNumLanes; ++Lane) {
+    if (!MFinished[Lane]) {
+      destroyLane(Lane);
+      createLane(Lane);
+    }
+  }
+  std::exception_ptr Error = MError;
+  MError = nullptr;
+  std::rethrow_exception(Error);
+}
+
+const char *SubGroupRunner::exchange(const void *Data, size_t Size) {
+  if (!MInLane)
+    throw runtime_error("Sub-group functions on host device require the first "
+                        "work-item of the work-group to get the sub-group.");
+  const size_t Parity = MRound % 2;
+  std::vector<char> &Storage = MStorage[Parity];
+  if (Storage.size() < MNumLanes * Size)
+    Storage.resize(MNumLanes * Size);
+  if (Size)
+    std::memcpy(Storage.data() + MCurrent * Size, Data, Size);
+  yield();
+  return MStorage[Parity].data();
+}
+
+void HostSubGroup::runWorkGroup(size_t Size,
+                                const std::function<void(size_t)> &Func) {
+  getRunner().runWorkGroup(Size, Func);
+}
+
+void HostSubGroup::markUsed() { getRunner().markUsed(); }
+
+const char *HostSubGroup::exchange(const void *Data, size_t Size) {
+  return getRunner().exchange(Data, Size);
+}
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
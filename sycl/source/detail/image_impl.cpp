@@ -8,6 +8,9 @@
 
 #include <CL/sycl/image.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 namespace cl {
 namespace sycl {
 namespace detail {
@@ -76,6 +79,145 @@ uint8_t getImageElementSize(uint8_t NumChannels, image_channel_type Type) {
   return Retval;
 }
 
+cl_channel_order convertChannelOrder(image_channel_order Order) {
+  switch (Order) {
+  case image_channel_order::a:
+    return CL_A;
+  case image_channel_order::r:
+    return CL_R;
+  case image_channel_order::rx:
+    return CL_Rx;
+  case image_channel_order::rg:
+    return CL_RG;
+  case image_channel_order::rgx:
+    return CL_RGx;
+  case image_channel_order::ra:
+    return CL_RA;
+  case image_channel_order::rgb:
+    return CL_RGB;
+  case image_channel_order::rgbx:
+    return CL_RGBx;
+  case image_channel_order::rgba:
+    return CL_RGBA;
+  case image_channel_order::argb:
+    return CL_ARGB;
+  case image_channel_order::bgra:
+    return CL_BGRA;
+  case image_channel_order::intensity:
+    return CL_INTENSITY;
+  case image_channel_order::luminance:
+    return CL_LUMINANCE;
+  case image_channel_order::abgr:
+#ifdef CL_ABGR
+    return CL_ABGR;
+#else
+    throw feature_not_supported(
+        "abgr image channel order requires OpenCL 2.0 headers");
+#endif
+  }
+  assert(!"Unhandled image channel order");
+  return 0;
+}
+
+cl_channel_type convertChannelType(image_channel_type Type) {
+  switch (Type) {
+  case image_channel_type::snorm_int8:
+    return CL_SNORM_INT8;
+  case image_channel_type::snorm_int16:
+    return CL_SNORM_INT16;
+  case image_channel_type::unorm_int8:
+    return CL_UNORM_INT8;
+  case image_channel_type::unorm_int16:
+    return CL_UNORM_INT16;
+  case image_channel_type::unorm_short_565:
+    return CL_UNORM_SHORT_565;
+  case image_channel_type::unorm_short_555:
+    return CL_UNORM_SHORT_555;
+  case image_channel_type::unorm_int_101010:
+    return CL_UNORM_INT_101010;
+  case image_channel_type::signed_int8:
+    return CL_SIGNED_INT8;
+  case image_channel_type::signed_int16:
+    return CL_SIGNED_INT16;
+  case image_channel_type::signed_int32:
+    return CL_SIGNED_INT32;
+  case image_channel_type::unsigned_int8:
+    return CL_UNSIGNED_INT8;
+  case image_channel_type::unsigned_int16:
+    return CL_UNSIGNED_INT16;
+  case image_channel_type::unsigned_int32:
+    return CL_UNSIGNED_INT32;
+  case image_channel_type::fp16:
+    return CL_HALF_FLOAT;
+  case image_channel_type::fp32:
+    return CL_FLOAT;
+  }
+  assert(!"Unhandled image channel type");
+  return 0;
+}
+
+// The loops below work on whole texels with no branches nor calls in their
+// bodies, so that they are vectorized.
+
+static void readRGBAUNormInt8(const uint8_t *Src, float *Dst, size_t Count) {
+  const float Scale = 1.0f / 255.0f;
+  for (size_t I = 0; I < Count * 4; ++I)
+    Dst[I] = Src[I] * Scale;
+}
+
+static void writeRGBAUNormInt8(const float *Src, uint8_t *Dst, size_t Count) {
+  // OpenCL saturates the unorm conversions, NaN converts to 0.
+  for (size_t I = 0; I < Count * 4; ++I) {
+    float Val = std::min(std::max(0.0f, Src[I]), 1.0f);
+    Dst[I] = static_cast<uint8_t>(Val * 255.0f + 0.5f);
+  }
+}
+
+static void readRFloat(const float *Src, float *Dst, size_t Count) {
+  // The missing channels read as (0, 0, 1).
+  for (size_t I = 0; I < Count; ++I) {
+    Dst[4 * I] = Src[I];
+    Dst[4 * I + 1] = 0.0f;
+    Dst[4 * I + 2] = 0.0f;
+    Dst[4 * I + 3] = 1.0f;
+  }
+}
+
+static void writeRFloat(const float *Src, float *Dst, size_t Count) {
+  for (size_t I = 0; I < Count; ++I)
+    Dst[I] = Src[4 * I];
+}
+
+void convertReadData(image_channel_order Order, image_channel_type Type,
+                     const void *Src, float *Dst, size_t Count) {
+  if (Order == image_channel_order::rgba &&
+      Type == image_channel_type::unorm_int8)
+    return readRGBAUNormInt8(static_cast<const uint8_t *>(Src), Dst, Count);
+  if (Order == image_channel_order::rgba && Type == image_channel_type::fp32) {
+    std::memcpy(Dst, Src, Count * 4 * sizeof(float));
+    return;
+  }
+  if (Order == image_channel_order::r && Type == image_channel_type::fp32)
+    return readRFloat(static_cast<const float *>(Src), Dst, Count);
+  throw feature_not_supported(
+      "Host image read not implemented for this image format");
+}
+
+void convertWriteData(image_channel_order Order, image_channel_type Type,
+                      const float *Src, void *Dst, size_t Count) {
+  if (Order == image_channel_order::rgba &&
+      Type == image_channel_type::unorm_int8)
+    return writeRGBAUNormInt8(Src, static_cast<uint8_t *>(Dst), Count);
+  if (Order == image_channel_order::rgba && Type == image_channel_type::fp32) {
+    std::memcpy(Dst, Src, Count * 4 * sizeof(float));
+    return;
+  }
+  if (Order == image_channel_order::r && Type == image_channel_type::fp32)
+    return writeRFloat(Src, static_cast<float *>(Dst), Count);
+  throw feature_not_supported(
+      "Host image write not implemented for this image format");
+}
+
 } // namespace detail
 } // namespace sycl
 } // namespace cl
@@ -22,7 +22,7 @@ namespace detail {
 
 static void waitForEvents(const std::vector<cl_event> &Events) {
   if (!Events.empty())
-    CHECK_OCL_CODE(clWaitForEvents(Events.size(), &Events[0]));
+    CHECK_OCL_CODE(PI_TRACED(clWaitForEvents)(Events.size(), &Events[0]));
 }
 
 void MemoryManager::release(ContextImplPtr TargetContext, SYCLMemObjT *MemObj,
@@ -49,7 +49,8 @@ void MemoryManager::releaseMemBuf(ContextImplPtr TargetContext,
     return;
   }
 
-  CHECK_OCL_CODE(clReleaseMemObject((cl_mem)MemAllocation));
+  if (!TargetContext->getMemoryPool().release((cl_mem)MemAllocation))
+    CHECK_OCL_CODE(PI_TRACED(clReleaseMemObject)((cl_mem)MemAllocation));
 }
 
 void *MemoryManager::allocate(ContextImplPtr TargetContext, SYCLMemObjT *MemObj,
@@ -99,16 +100,107 @@ void *MemoryManager::allocateMemBuffer(ContextImplPtr TargetContext,
   // Create read_write mem object by default to handle arbitrary uses.
   cl_mem_flags CreationFlags = CL_MEM_READ_WRITE;
 
-  if (UserPtr)
-    CreationFlags |=
-        HostPtrReadOnly ? CL_MEM_COPY_HOST_PTR : CL_MEM_USE_HOST_PTR;
+  // Buffers bound to no host memory are recycled through the context pool.
+  if (!UserPtr)
+    return TargetContext->getMemoryPool().allocate(CreationFlags, Size);
+
+  CreationFlags |= HostPtrReadOnly ? CL_MEM_COPY_HOST_PTR : CL_MEM_USE_HOST_PTR;
+  cl_int Error = CL_SUCCESS;
+  cl_mem NewMem = PI_TRACED(clCreateBuffer)(
+      TargetContext->getHandleRef(), CreationFlags, Size, UserPtr, &Error);
+  CHECK_OCL_CODE(Error);
+  return NewMem;
+}
+
+void *MemoryManager::allocateMemImage(ContextImplPtr TargetContext,
+                                      SYCLMemObjT *MemObj, void *UserPtr,
+                                      bool HostPtrReadOnly, size_t Size,
+                                      const cl_image_desc &Desc,
+                                      const cl_image_format &Format) {
+  if (TargetContext->is_host()) {
+    // Can return user pointer directly if it points to writable memory.
+    if (UserPtr && HostPtrReadOnly == false)
+      return UserPtr;
+
+    void *NewMem = MemObj->allocateHostMem();
+
+    // Need to initialize new memory if user provides pointer to read only
+    // memory.
+    if (UserPtr && HostPtrReadOnly == true)
+      std::memcpy((char *)NewMem, (char *)UserPtr, Size);
+    return NewMem;
+  }
+
+  // Create read_write mem object by default to handle arbitrary uses.
+  cl_mem_flags CreationFlags = CL_MEM_READ_WRITE;
+
+  // Images of a fixed format, such as the per-frame ones of a video pipeline,
+  // are reused instead of being created each time.
+  if (!UserPtr) {
+    cl_image_desc PoolDesc = Desc;
+    PoolDesc.image_row_pitch = 0;
+    PoolDesc.image_slice_pitch = 0;
+    return TargetContext->getMemoryPool().allocateImage(CreationFlags, Format,
+                                                        PoolDesc, Size);
+  }
+
+  CreationFlags |= HostPtrReadOnly ? CL_MEM_COPY_HOST_PTR : CL_MEM_USE_HOST_PTR;
   cl_int Error = CL_SUCCESS;
-  cl_mem NewMem = clCreateBuffer(TargetContext->getHandleRef(), CreationFlags,
-                                 Size, UserPtr, &Error);
+  cl_mem NewMem =
+      PI_TRACED(clCreateImage)(TargetContext->getHandleRef(), CreationFlags,
+                               &Format, &Desc, UserPtr, &Error);
   CHECK_OCL_CODE(Error);
   return NewMem;
 }
 
+// Returns true if the device works on HostMem in place when using Mem, i.e.
+// Mem was created with CL_MEM_USE_HOST_PTR on top of HostMem on a device
+// sharing the memory with the host. The copies between the two then only need
+// to synchronize them, which is what mapping and unmapping Mem does.
+static bool isZeroCopy(const QueueImplPtr &Queue, cl_mem Mem,
+                       const char *HostMem, unsigned int DimSrc,
+                       const sycl::range<3> &SrcSize,
+                       const sycl::id<3> &SrcOffset, unsigned int DimDst,
+                       const sycl::range<3> &DstSize,
+                       const sycl::id<3> &DstOffset) {
+  if (!Queue->hasHostUnifiedMemory() || DimSrc != DimDst ||
+      SrcSize != DstSize || SrcOffset != DstOffset)
+    return false;
+  void *HostPtr = nullptr;
+  CHECK_OCL_CODE(PI_TRACED(clGetMemObjectInfo)(
+      Mem, CL_MEM_HOST_PTR, sizeof(HostPtr), &HostPtr, nullptr));
+  return HostPtr == HostMem;
+}
+
+// Synchronizes the region of Mem with the host memory it was created on by
+// mapping and unmapping the region. Sizes and offsets of the first dimension
+// are in bytes.
+static void syncWithHostPtr(cl_command_queue Queue, cl_mem Mem,
+                            cl_map_flags Flags, sycl::range<3> Size,
+                            sycl::range<3> AccessRange, sycl::id<3> Offset,
+                            std::vector<cl_event> &DepEvents,
+                            cl_event &OutEvent) {
+  // Map the smallest linear region covering the accessed one.
+  const size_t RowPitch = Size[0];
+  const size_t SlicePitch = Size[0] * Size[1];
+  const size_t Begin =
+      Offset[2] * SlicePitch + Offset[1] * RowPitch + Offset[0];
+  const size_t End = (Offset[2] + AccessRange[2] - 1) * SlicePitch +
+                     (Offset[1] + AccessRange[1] - 1) * RowPitch + Offset[0] +
+                     AccessRange[0];
+
+  cl_event MapEvent = nullptr;
+  cl_int Error = CL_SUCCESS;
+  void *MappedPtr = PI_TRACED(clEnqueueMapBuffer)(
+      Queue, Mem, /*blocking_map=*/CL_FALSE, Flags, Begin, End - Begin,
+      DepEvents.size(), DepEvents.data(), &MapEvent, &Error);
+  CHECK_OCL_CODE(Error);
+  Error = PI_TRACED(clEnqueueUnmapMemObject)(Queue, Mem, MappedPtr, 1,
+                                             &MapEvent, &OutEvent);
+  CHECK_OCL_CODE_NO_EXC(PI_TRACED(clReleaseEvent)(MapEvent));
+  CHECK_OCL_CODE(Error);
+}
+
 void copyH2D(SYCLMemObjT *SYCLMemObj, char *SrcMem, QueueImplPtr SrcQueue,
              unsigned int DimSrc, sycl::range<3> SrcSize,
              sycl::range<3> SrcAccessRange, sycl::id<3> SrcOffset,
@@ -132,22 +224,31 @@ void copyH2D(SYCLMemObjT *SYCLMemObj, char *SrcMem, QueueImplPtr SrcQueue,
                                  ? TgtQueue->getExclusiveQueueHandleRef()
                                  : TgtQueue->getHandleRef();
 
+  // The device reads the host memory itself, so it only needs the region to
+  // be made visible to the device, not its previous content.
+  if (isZeroCopy(TgtQueue, DstMem, SrcMem, DimSrc, SrcSize, SrcOffset, DimDst,
+                 DstSize, DstOffset)) {
+    syncWithHostPtr(CLQueue, DstMem, CL_MAP_WRITE_INVALIDATE_REGION, DstSize,
+                    DstAccessRange, DstOffset, DepEvents, OutEvent);
+    return;
+  }
+
   if (1 == DimDst && 1 == DimSrc) {
-    CHECK_OCL_CODE(clEnqueueWriteBuffer(
-        CLQueue, DstMem,
-        /*blocking_write=*/CL_FALSE, DstOffset[0], DstAccessRange[0],
-        SrcMem + DstOffset[0], DepEvents.size(), &DepEvents[0], &OutEvent));
+    CHECK_OCL_CODE(PI_TRACED(clEnqueueWriteBuffer)(
+        CLQueue, DstMem, /*blocking_write=*/CL_FALSE, DstOffset[0],
+        DstAccessRange[0], SrcMem + DstOffset[0], DepEvents.size(),
+        &DepEvents[0], &OutEvent));
   } else {
     size_t BufferRowPitch = (1 == DimSrc) ? 0 : SrcSize[0];
     size_t BufferSlicePitch = (3 == DimSrc) ? SrcSize[0] * SrcSize[1] : 0;
 
     size_t HostRowPitch = (1 == DimDst) ? 0 : DstSize[0];
     size_t HostSlicePitch = (3 == DimDst) ? DstSize[0] * DstSize[1] : 0;
-    CHECK_OCL_CODE(clEnqueueWriteBufferRect(
-        CLQueue, DstMem,
-        /*blocking_write=*/CL_FALSE, &DstOffset[0], &SrcOffset[0],
-        &DstAccessRange[0], BufferRowPitch, BufferSlicePitch, HostRowPitch,
-        HostSlicePitch, SrcMem, DepEvents.size(), &DepEvents[0], &OutEvent));
+    CHECK_OCL_CODE(PI_TRACED(clEnqueueWriteBufferRect)(
+        CLQueue, DstMem, /*blocking_write=*/CL_FALSE, &DstOffset[0],
+        &SrcOffset[0], &DstAccessRange[0], BufferRowPitch, BufferSlicePitch,
+        HostRowPitch, HostSlicePitch, SrcMem, DepEvents.size(), &DepEvents[0],
+        &OutEvent));
   }
 }
 
@@ -173,22 +274,29 @@ void copyD2H(SYCLMemObjT *SYCLMemObj, cl_mem SrcMem, QueueImplPtr SrcQueue,
                                  ? SrcQueue->getExclusiveQueueHandleRef()
                                  : SrcQueue->getHandleRef();
 
+  if (isZeroCopy(SrcQueue, SrcMem, DstMem, DimSrc, SrcSize, SrcOffset, DimDst,
+                 DstSize, DstOffset)) {
+    syncWithHostPtr(CLQueue, SrcMem, CL_MAP_READ, SrcSize, SrcAccessRange,
+                    SrcOffset, DepEvents, OutEvent);
+    return;
+  }
+
   if (1 == DimDst && 1 == DimSrc) {
-    CHECK_OCL_CODE(clEnqueueReadBuffer(
-        CLQueue, SrcMem,
-        /*blocking_read=*/CL_FALSE, DstOffset[0], DstAccessRange[0],
-        DstMem + DstOffset[0], DepEvents.size(), &DepEvents[0], &OutEvent));
+    CHECK_OCL_CODE(PI_TRACED(clEnqueueReadBuffer)(
+        CLQueue, SrcMem, /*blocking_read=*/CL_FALSE, DstOffset[0],
+        DstAccessRange[0], DstMem + DstOffset[0], DepEvents.size(),
+        &DepEvents[0], &OutEvent));
   } else {
     size_t BufferRowPitch = (1 == DimSrc) ? 0 : SrcSize[0];
     size_t BufferSlicePitch = (3 == DimSrc) ? SrcSize[0] * SrcSize[1] : 0;
 
     size_t HostRowPitch = (1 == DimDst) ? 0 : DstSize[0];
     size_t HostSlicePitch = (3 == DimDst) ? DstSize[0] * DstSize[1] : 0;
-    CHECK_OCL_CODE(clEnqueueReadBufferRect(
-        CLQueue, SrcMem,
-        /*blocking_read=*/CL_FALSE, &SrcOffset[0], &DstOffset[0],
-        &SrcAccessRange[0], BufferRowPitch, BufferSlicePitch, HostRowPitch,
-        HostSlicePitch, DstMem, DepEvents.size(), &DepEvents[0], &OutEvent));
+    CHECK_OCL_CODE(PI_TRACED(clEnqueueReadBufferRect)(
+        CLQueue, SrcMem, /*blocking_read=*/CL_FALSE, &SrcOffset[0],
+        &DstOffset[0], &SrcAccessRange[0], BufferRowPitch, BufferSlicePitch,
+        HostRowPitch, HostSlicePitch, DstMem, DepEvents.size(), &DepEvents[0],
+        &OutEvent));
   }
 }
 
@@ -214,9 +322,9 @@ void copyD2D(SYCLMemObjT *SYCLMemObj, cl_mem SrcMem, QueueImplPtr SrcQueue,
                                  : SrcQueue->getHandleRef();
 
   if (1 == DimDst && 1 == DimSrc) {
-    CHECK_OCL_CODE(clEnqueueCopyBuffer(
-        CLQueue, SrcMem, DstMem, SrcOffset[0], DstOffset[0],
-        SrcAccessRange[0], DepEvents.size(), &DepEvents[0], &OutEvent));
+    CHECK_OCL_CODE(PI_TRACED(clEnqueueCopyBuffer)(
+        CLQueue, SrcMem, DstMem, SrcOffset[0], DstOffset[0], SrcAccessRange[0],
+        DepEvents.size(), &DepEvents[0], &OutEvent));
   } else {
     size_t BufferRowPitch = (1 == DimSrc) ? 0 : SrcSize[0];
     size_t BufferSlicePitch = (3 == DimSrc) ? SrcSize[0] * SrcSize[1] : 0;
@@ -224,7 +332,7 @@ void copyD2D(SYCLMemObjT *SYCLMemObj, cl_mem SrcMem, QueueImplPtr SrcQueue,
     size_t HostRowPitch = (1 == DimDst) ? 0 : DstSize[0];
     size_t HostSlicePitch = (3 == DimDst) ? DstSize[0] * DstSize[1] : 0;
 
-    CHECK_OCL_CODE(clEnqueueCopyBufferRect(
+    CHECK_OCL_CODE(PI_TRACED(clEnqueueCopyBufferRect)(
         CLQueue, SrcMem, DstMem, &SrcOffset[0], &DstOffset[0],
         &SrcAccessRange[0], BufferRowPitch, BufferSlicePitch, HostRowPitch,
         HostSlicePitch, DepEvents.size(), &DepEvents[0], &OutEvent));
@@ -304,7 +412,7 @@ void MemoryManager::fill(SYCLMemObjT *SYCLMemObj, void *Mem, QueueImplPtr Queue,
   // TODO: Handle images.
 
   if (Dim == 1) {
-    CHECK_OCL_CODE(clEnqueueFillBuffer(
+    CHECK_OCL_CODE(PI_TRACED(clEnqueueFillBuffer)(
         Queue->getHandleRef(), (cl_mem)Mem, Pattern, PatternSize, Offset[0],
         Range[0] * ElementSize, DepEvents.size(), &DepEvents[0], &OutEvent));
     return;
@@ -347,7 +455,7 @@ void *MemoryManager::map(SYCLMemObjT *SYCLMemObj, void *Mem, QueueImplPtr Queue,
   AccessRange[0] *= ElementSize;
 
   cl_int Error = CL_SUCCESS;
-  void *MappedPtr = clEnqueueMapBuffer(
+  void *MappedPtr = PI_TRACED(clEnqueueMapBuffer)(
       Queue->getHandleRef(), (cl_mem)Mem, CL_FALSE, Flags, AccessOffset[0],
       AccessRange[0], DepEvents.size(),
       DepEvents.empty() ? nullptr : &DepEvents[0], &OutEvent, &Error);
@@ -360,7 +468,7 @@ void MemoryManager::unmap(SYCLMemObjT *SYCLMemObj, void *Mem,
                           std::vector<cl_event> DepEvents,
                           bool UseExclusiveQueue, cl_event &OutEvent) {
   cl_int Error = CL_SUCCESS;
-  Error = clEnqueueUnmapMemObject(
+  Error = PI_TRACED(clEnqueueUnmapMemObject)(
       UseExclusiveQueue ? Queue->getExclusiveQueueHandleRef()
                         : Queue->getHandleRef(),
       (cl_mem)Mem, MappedPtr, DepEvents.size(),
@@ -368,6 +476,35 @@ void MemoryManager::unmap(SYCLMemObjT *SYCLMemObj, void *Mem,
   CHECK_OCL_CODE(Error);
 }
 
+void MemoryManager::copy_usm(const void *SrcMem, QueueImplPtr Queue,
+                             size_t Len, void *DstMem,
+                             std::vector<cl_event> DepEvents,
+                             cl_event &OutEvent) {
+  if (!Len)
+    return waitForEvents(DepEvents);
+  if (!SrcMem || !DstMem)
+    throw invalid_parameter_error("NULL pointer argument in memory copy");
+
+  ContextImplPtr Context = detail::getSyclObjImpl(Queue->get_context());
+  Context->getUSMDispatch().memcpy(
+      Queue->is_host() ? nullptr : Queue->getHandleRef(), DstMem, SrcMem, Len,
+      DepEvents, OutEvent);
+}
+
+void MemoryManager::fill_usm(void *Mem, QueueImplPtr Queue, size_t Len,
+                             int Pattern, std::vector<cl_event> DepEvents,
+                             cl_event &OutEvent) {
+  if (!Len)
+    return waitForEvents(DepEvents);
+  if (!Mem)
+    throw invalid_parameter_error("NULL pointer argument in memory fill");
+
+  ContextImplPtr Context = detail::getSyclObjImpl(Queue->get_context());
+  Context->getUSMDispatch().memset(
+      Queue->is_host() ? nullptr : Queue->getHandleRef(), Mem, Pattern, Len,
+      DepEvents, OutEvent);
+}
+
 } // namespace detail
 } // namespace sycl
 } // namespace cl
@@ -0,0 +1,195 @@
+//==------------ memory_pool.cpp --- Device memory object pool -------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/memory_pool.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+static constexpr size_t DefaultHighWaterMark = 256UL * 1024 * 1024;
+static constexpr size_t MinSizeClass = 256;
+
+static size_t getDefaultHighWaterMark() {
+  static const size_t Mark = []() -> size_t {
+    const char *Val = std::getenv("SYCL_MEM_POOL_HIGH_WATER_MARK");
+    if (!Val)
+      return DefaultHighWaterMark;
+    return static_cast<size_t>(std::strtoull(Val, nullptr, 10));
+  }();
+  return Mark;
+}
+
+MemoryPool::MemoryPool(cl_context Context)
+    : MContext(Context), MHighWaterMark(getDefaultHighWaterMark()) {}
+
+MemoryPool::~MemoryPool() {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  trimImpl(0);
+}
+
+bool MemoryPool::isPoolable(cl_mem_flags Flags) {
+  return !(Flags & (CL_MEM_USE_HOST_PTR | CL_MEM_COPY_HOST_PTR |
+                    CL_MEM_ALLOC_HOST_PTR));
+}
+
+size_t MemoryPool::getSizeClass(size_t Size) {
+  if (Size <= MinSizeClass)
+    return MinSizeClass;
+  // Four classes per power of two: round up to a quarter of the largest power
+  // of two not greater than Size.
+  size_t PowerOfTwo = MinSizeClass;
+  while ((PowerOfTwo << 1) <= Size)
+    PowerOfTwo <<= 1;
+  const size_t Granularity = PowerOfTwo / 4;
+  return (Size + Granularity - 1) / Granularity * Granularity;
+}
+
+template <typename CreateFn>
+cl_mem MemoryPool::allocateImpl(const PoolKey &Key, size_t AllocSize,
+                                CreateFn Create) {
+  bool IsPooled = false;
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    IsPooled = MHighWaterMark != 0 && isPoolable(Key.Flags);
+    auto It = MFreeBuffers.find(Key);
+    if (IsPooled && It != MFreeBuffers.end() && !It->second.empty()) {
+      cl_mem Mem = It->second.back().Mem;
+      It->second.pop_back();
+      MFreeSize -= Key.Size;
+      return Mem;
+    }
+  }
+
+  // Buffers that are not going to be reused are created of the exact size.
+  if (IsPooled)
+    AllocSize = Key.Size;
+  cl_int Error = CL_SUCCESS;
+  cl_mem Mem = Create(AllocSize, Error);
+  if (Error == CL_MEM_OBJECT_ALLOCATION_FAILURE ||
+      Error == CL_OUT_OF_RESOURCES) {
+    // The free buffers may be what is holding the device memory.
+    trim();
+    Mem = Create(AllocSize, Error);
+  }
+  CHECK_OCL_CODE(Error);
+
+  if (IsPooled) {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    MOwnedBuffers.emplace(Mem, Key);
+  }
+  return Mem;
+}
+
+cl_mem MemoryPool::allocate(cl_mem_flags Flags, size_t Size) {
+  PoolKey Key;
+  Key.Flags = Flags;
+  Key.Size = getSizeClass(Size);
+  return allocateImpl(Key, Size, [&](size_t AllocSize, cl_int &Error) {
+    return PI_TRACED(clCreateBuffer)(MContext, Flags, AllocSize, nullptr,
+                                     &Error);
+  });
+}
+
+cl_mem MemoryPool::allocateImage(cl_mem_flags Flags,
+                                 const cl_image_format &Format,
+                                 const cl_image_desc &Desc, size_t Size) {
+  // The pitches of an image with no host pointer are set by the driver, so
+  // the format and the dimensions identify the image entirely.
+  PoolKey Key;
+  Key.Flags = Flags;
+  Key.Size = Size;
+  Key.ImageType = Desc.image_type;
+  Key.Order = Format.image_channel_order;
+  Key.ChannelType = Format.image_channel_data_type;
+  Key.Width = Desc.image_width;
+  Key.Height = Desc.image_height;
+  Key.Depth = Desc.image_depth;
+  Key.ArraySize = Desc.image_array_size;
+  return allocateImpl(Key, Size, [&](size_t, cl_int &Error) {
+    return PI_TRACED(clCreateImage)(MContext, Flags, &Format, &Desc, nullptr,
+                                    &Error);
+  });
+}
+
+bool MemoryPool::release(cl_mem Mem) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  auto It = MOwnedBuffers.find(Mem);
+  if (It == MOwnedBuffers.end())
+    return false;
+
+  const PoolKey Key = It->second;
+  if (Key.Size > MHighWaterMark) {
+    MOwnedBuffers.erase(It);
+    CHECK_OCL_CODE(PI_TRACED(clReleaseMemObject)(Mem));
+    return true;
+  }
+
+  MFreeBuffers[Key].push_back({Mem, MReleaseCounter++});
+  MFreeSize += Key.Size;
+  trimImpl(MHighWaterMark);
+  return true;
+}
+
+void MemoryPool::trim(size_t TargetSize) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  trimImpl(TargetSize);
+}
+
+void MemoryPool::trimImpl(size_t TargetSize) {
+  if (MFreeSize <= TargetSize)
+    return;
+
+  struct Candidate {
+    size_t Age;
+    std::vector<FreeBuffer> *Bucket;
+    size_t Size;
+  };
+  std::vector<Candidate> Candidates;
+  for (auto &Bucket : MFreeBuffers)
+    for (const FreeBuffer &Buf : Bucket.second)
+      Candidates.push_back({Buf.Age, &Bucket.second, Bucket.first.Size});
+  std::sort(Candidates.begin(), Candidates.end(),
+            [](const Candidate &LHS, const Candidate &RHS) {
+              return LHS.Age < RHS.Age;
+            });
+
+  // Each bucket is ordered by age too, so its oldest buffer is the first one.
+  for (const Candidate &C : Candidates) {
+    if (MFreeSize <= TargetSize)
+      break;
+    cl_mem Mem = C.Bucket->front().Mem;
+    C.Bucket->erase(C.Bucket->begin());
+    MFreeSize -= C.Size;
+    MOwnedBuffers.erase(Mem);
+    CHECK_OCL_CODE_NO_EXC(PI_TRACED(clReleaseMemObject)(Mem));
+  }
+}
+
+size_t MemoryPool::getFreeSize() const {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  return MFreeSize;
+}
+
+size_t MemoryPool::getHighWaterMark() const {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  return MHighWaterMark;
+}
+
+void MemoryPool::setHighWaterMark(size_t Mark) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MHighWaterMark = Mark;
+  trimImpl(MHighWaterMark);
+}
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
@@ -0,0 +1,163 @@
+//==--- multi_device_queue_impl.cpp --- SYCL multi-device queue ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/multi_device_queue_impl.hpp>
+#include <CL/sycl/detail/queue_impl.hpp>
+#include <CL/sycl/exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+multi_device_queue_impl::multi_device_queue_impl(
+    const context &Context, const async_handler &AsyncHandler)
+    : MContext(Context) {
+  const vector_class<device> Devices = MContext.get_devices();
+  if (Devices.empty())
+    throw invalid_parameter_error("The context has no devices");
+
+  // The throughput is measured with the profiling information of the kernels.
+  const property_list Props =
+      MContext.is_host() ? property_list{}
+                         : property_list{property::queue::enable_profiling()};
+  for (const device &Device : Devices) {
+    queue Queue = createSyclObjFromImpl<queue>(std::make_shared<queue_impl>(
+        Device, MContext, AsyncHandler, Props));
+    const float ComputeUnits =
+        Device.get_info<info::device::max_compute_units>();
+    MDevices.push_back({std::move(Queue), std::max(ComputeUnits, 1.0f), 0, {}});
+  }
+}
+
+const queue &multi_device_queue_impl::getQueue(size_t Index) const {
+  if (Index >= MDevices.size())
+    throw invalid_parameter_error("Device index out of range");
+  return MDevices[Index].Queue;
+}
+
+vector_class<float> multi_device_queue_impl::getWeights() const {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  // The estimates and the throughputs are not comparable, so the throughputs
+  // are only used once all the devices have been measured.
+  const bool AllMeasured =
+      std::all_of(MDevices.begin(), MDevices.end(),
+                  [](const DeviceState &D) { return D.Throughput > 0; });
+  vector_class<float> Weights;
+  float Total = 0;
+  for (const DeviceState &D : MDevices) {
+    Weights.push_back(AllMeasured ? D.Throughput : D.Estimate);
+    Total += Weights.back();
+  }
+  for (float &W : Weights)
+    W /= Total;
+  return Weights;
+}
+
+vector_class<std::pair<size_t, size_t>>
+multi_device_queue_impl::partition(size_t Size, size_t Granularity) const {
+  if (Granularity == 0 || Size % Granularity != 0)
+    throw invalid_parameter_error(
+        "The range is not a multiple of the work-group size");
+
+  const vector_class<float> Weights = getWeights();
+  const size_t Units = Size / Granularity;
+
+  // Round the shares down, then hand out the remaining units by the largest
+  // fractional parts.
+  vector_class<size_t> Counts(Weights.size());
+  vector_class<std::pair<double, size_t>> Fractions;
+  size_t Assigned = 0;
+  for (size_t I = 0; I < Weights.size(); ++I) {
+    const double Share = static_cast<double>(Weights[I]) * Units;
+    Counts[I] = std::min(static_cast<size_t>(Share), Units - Assigned);
+    Assigned += Counts[I];
+    Fractions.push_back({Share - std::floor(Share), I});
+  }
+  std::sort(Fractions.begin(), Fractions.end(),
+            [](const std::pair<double, size_t> &LHS,
+               const std::pair<double, size_t> &RHS) {
+              return LHS.first > RHS.first;
+            });
+  for (size_t I = 0; Assigned < Units; I = (I + 1) % Fractions.size()) {
+    ++Counts[Fractions[I].second];
+    ++Assigned;
+  }
+
+  // Every device runs a part while there are enough units, otherwise an idle
+  // device would never get measured.
+  if (Units >= Counts.size()) {
+    for (size_t &Count : Counts) {
+      if (Count != 0)
+        continue;
+      auto Largest = std::max_element(Counts.begin(), Counts.end());
+      --*Largest;
+      Count = 1;
+    }
+  }
+
+  vector_class<std::pair<size_t, size_t>> Parts;
+  size_t Offset = 0;
+  for (size_t Count : Counts) {
+    Parts.push_back({Offset, Count * Granularity});
+    Offset += Count * Granularity;
+  }
+  return Parts;
+}
+
+void multi_device_queue_impl::addSubmission(size_t DeviceIndex,
+                                            const event &Event,
+                                            size_t WorkItems) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MDevices[DeviceIndex].Pending.push_back({Event, WorkItems});
+}
+
+void multi_device_queue_impl::wait() {
+  vector_class<vector_class<Submission>> Pending(MDevices.size());
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    for (size_t I = 0; I < MDevices.size(); ++I)
+      std::swap(Pending[I], MDevices[I].Pending);
+  }
+
+  vector_class<float> Measured(MDevices.size(), 0);
+  for (size_t I = 0; I < MDevices.size(); ++I) {
+    size_t WorkItems = 0;
+    cl_ulong Duration = 0;
+    for (Submission &S : Pending[I]) {
+      S.Event.wait();
+      // The host device has no profiling information.
+      if (MDevices[I].Queue.is_host())
+        continue;
+      const cl_ulong Start =
+          S.Event.get_profiling_info<info::event_profiling::command_start>();
+      const cl_ulong End =
+          S.Event.get_profiling_info<info::event_profiling::command_end>();
+      WorkItems += S.WorkItems;
+      Duration += End > Start ? End - Start : 0;
+    }
+    if (Duration != 0)
+      Measured[I] = static_cast<float>(WorkItems) / Duration;
+    MDevices[I].Queue.wait_and_throw();
+  }
+
+  std::lock_guard<std::mutex> Lock(MMutex);
+  for (size_t I = 0; I < MDevices.size(); ++I) {
+    if (Measured[I] == 0)
+      continue;
+    // Smooth the variations between the submissions.
+    float &Throughput = MDevices[I].Throughput;
+    Throughput = Throughput == 0 ? Measured[I] : (Throughput + Measured[I]) / 2;
+  }
+}
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
@@ -6,9 +6,16 @@
 //
 //===----------------------------------------------------------------------===//
 #include <CL/sycl/detail/pi.hpp>
-#include <cstdarg>
+#include <CL/sycl/detail/trace_file.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace cl {
 namespace sycl {
@@ -47,15 +54,94 @@ void pi_assert(bool condition, const char *message) {
     pi_die(message);
 }
 
-// TODO: implement a more mature and controllable tracing of PI calls.
-void pi_trace(const char *format, ...) {
-  static bool do_trace = std::getenv("SYCL_BE_TRACE");
-  if (!do_trace)
-    return;
+namespace {
 
-  va_list args;
-  va_start(args, format);
-  vprintf(format, args);
+struct pi_trace_record {
+  std::string name;
+  std::string args;
+  std::string result;
+  pi_clock::time_point start;
+  pi_clock::time_point end;
+  unsigned thread;
+};
+
+// Collects the traced calls and writes them to the SYCL_PI_TRACE_FILE file at
+// the program exit.
+class pi_trace_file : public TraceFile {
+public:
+  static pi_trace_file *get() {
+    static pi_trace_file *instance = []() -> pi_trace_file * {
+      const char *path = getPath("SYCL_PI_TRACE_FILE");
+      if (!path)
+        return nullptr;
+      pi_trace_file *file = new pi_trace_file(path);
+      writeAtExit(file);
+      return file;
+    }();
+    return instance;
+  }
+
+  void add(pi_trace_record record) {
+    std::lock_guard<std::mutex> lock(MMutex);
+    if (!MWritten)
+      m_records.push_back(std::move(record));
+  }
+
+private:
+  explicit pi_trace_file(std::string path) : TraceFile(std::move(path)) {}
+
+  void writeEvents(std::ostream &os) override {
+    // The timestamps are relative to the first call.
+    pi_clock::time_point origin = pi_clock::time_point::max();
+    for (const pi_trace_record &record : m_records)
+      origin = std::min(origin, record.start);
+    auto to_us = [origin](pi_clock::time_point time) {
+      return std::chrono::duration<double, std::micro>(time - origin).count();
+    };
+    const char *separator = "";
+    for (const pi_trace_record &record : m_records) {
+      os << separator << "{\"name\":\"";
+      writeJSONEscaped(os, record.name);
+      os << "\",\"cat\":\"pi\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+         << record.thread << ",\"ts\":" << to_us(record.start)
+         << ",\"dur\":" << to_us(record.end) - to_us(record.start)
+         << ",\"args\":{\"args\":\"";
+      writeJSONEscaped(os, record.args);
+      os << "\",\"result\":\"";
+      writeJSONEscaped(os, record.result);
+      os << "\"}}";
+      separator = ",\n";
+    }
+  }
+
+  std::vector<pi_trace_record> m_records;
+};
+
+bool pi_trace_print_enabled() {
+  static const bool enabled = std::getenv("SYCL_BE_TRACE");
+  return enabled;
+}
+
+} // namespace
+
+bool pi_trace_enabled() {
+  static const bool enabled =
+      pi_trace_print_enabled() || pi_trace_file::get();
+  return enabled;
+}
+
+void pi_trace_begin(const char *name, const std::string &args) {
+  if (pi_trace_print_enabled())
+    std::printf("PI ---> %s(%s)\n", name, args.c_str());
+}
+
+void pi_trace_end(const char *name, const std::string &args,
+                  const std::string &result, pi_clock::time_point start,
+                  pi_clock::time_point end) {
+  if (pi_trace_print_enabled())
+    std::printf("PI <--- %s\n", result.c_str());
+  if (pi_trace_file *file = pi_trace_file::get())
+    file->add({name, args, result, start, end, getTraceThreadId()});
 }
 
 extern "C" {
@@ -6,39 +6,72 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <CL/sycl/detail/device_impl.hpp>
 #include <CL/sycl/detail/platform_impl.hpp>
 #include <CL/sycl/device.hpp>
 
+#include <algorithm>
+#include <iterator>
+
 namespace cl {
 namespace sycl {
 namespace detail {
 
+const vector_class<std::shared_ptr<platform_impl_pi>> &
+platform_impl_pi::getDiscoveredPlatforms() {
+  static const vector_class<std::shared_ptr<platform_impl_pi>> Platforms =
+      []() {
+        vector_class<std::shared_ptr<platform_impl_pi>> Res;
+        pi_uint32 num_platforms = 0;
+        PI_CALL(RT::piPlatformsGet(0, 0, &num_platforms));
+        if (!num_platforms)
+          return Res;
+
+        vector_class<RT::pi_platform> pi_platforms(num_platforms);
+        PI_CALL(RT::piPlatformsGet(num_platforms, pi_platforms.data(), 0));
+        for (RT::pi_platform pi_platform : pi_platforms) {
+          auto Impl = std::make_shared<platform_impl_pi>(pi_platform);
+          Impl->m_Devices = Impl->queryDevices(info::device_type::all);
+          Impl->m_IsDiscovered = true;
+          Res.push_back(Impl);
+        }
+        return Res;
+      }();
+  return Platforms;
+}
+
 vector_class<platform>
 platform_impl_pi::get_platforms() {
   vector_class<platform> platforms;
-
-  pi_uint32 num_platforms = 0;
-  PI_CALL(RT::piPlatformsGet(0, 0, &num_platforms));
   info::device_type forced_type = detail::get_forced_type();
 
-  if (num_platforms) {
-    vector_class<RT::pi_platform> pi_platforms(num_platforms);
-    PI_CALL(RT::piPlatformsGet(num_platforms, pi_platforms.data(), 0));
-
-    for (pi_uint32 i = 0; i < num_platforms; i++) {
+  for (const auto &Impl : getDiscoveredPlatforms()) {
+    platform plt = detail::createSyclObjFromImpl<platform>(Impl);
 
-      platform plt =
-        detail::createSyclObjFromImpl<platform>(
-          std::make_shared<platform_impl_pi>(pi_platforms[i]));
-
-      // Skip platforms which do not contain requested device types
-      if (!plt.get_devices(forced_type).empty())
-        platforms.push_back(plt);
-    }
+    // Skip platforms which do not contain requested device types
+    if (!plt.get_devices(forced_type).empty())
+      platforms.push_back(plt);
   }
   return platforms;
 }
 
+std::shared_ptr<platform_impl_pi>
+platform_impl_pi::getPlatformImpl(RT::pi_platform Platform) {
+  for (const auto &Impl : getDiscoveredPlatforms())
+    if (Impl->m_platform == Platform)
+      return Impl;
+  return std::make_shared<platform_impl_pi>(Platform);
+}
+
+std::shared_ptr<device_impl>
+platform_impl_pi::getDeviceImpl(RT::pi_device Device) {
+  for (const auto &Impl : getDiscoveredPlatforms())
+    for (const device &Dev : Impl->m_Devices)
+      if (getSyclObjImpl(Dev)->get_handle() == Device)
+        return getSyclObjImpl(Dev);
+  return nullptr;
+}
+
 vector_class<device>
 platform_impl_host::get_devices(info::device_type dev_type) const {
   vector_class<device> res;
@@ -49,6 +82,32 @@ platform_impl_host::get_devices(info::device_type dev_type) const {
 
 vector_class<device>
 platform_impl_pi::get_devices(info::device_type deviceType) const {
+  if (!m_IsDiscovered)
+    return queryDevices(deviceType);
+
+  vector_class<device> res;
+  switch (deviceType) {
+  case info::device_type::all:
+    return m_Devices;
+  case info::device_type::cpu:
+  case info::device_type::gpu:
+  case info::device_type::accelerator:
+    std::copy_if(m_Devices.begin(), m_Devices.end(), std::back_inserter(res),
+                 [deviceType](const device &Dev) {
+                   // The type may also have the default device bit set.
+                   return static_cast<pi_uint64>(
+                              Dev.get_info<info::device::device_type>()) &
+                          static_cast<pi_uint64>(deviceType);
+                 });
+    return res;
+  default:
+    // The default and the custom devices are left to the driver.
+    return queryDevices(deviceType);
+  }
+}
+
+vector_class<device>
+platform_impl_pi::queryDevices(info::device_type deviceType) const {
   vector_class<device> res;
   if (deviceType == info::device_type::host)
     return res;
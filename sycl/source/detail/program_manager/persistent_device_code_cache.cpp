@@ -0,0 +1,267 @@
+//==---- persistent_device_code_cache.cpp --- On-disk device code cache ----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/os_util.hpp>
+#include <CL/sycl/detail/program_manager/persistent_device_code_cache.hpp>
+#include <CL/sycl/detail/util.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+
+#if defined(SYCL_RT_OS_LINUX)
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+#elif defined(SYCL_RT_OS_WINDOWS)
+#include <Windows.h>
+#include <direct.h>
+#include <process.h>
+#include <sys/utime.h>
+#endif
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+static constexpr size_t DefaultMaxCacheSize = 1024UL * 1024 * 1024;
+
+static string_class getDeviceInfoString(cl_device_id Device,
+                                        cl_device_info Param) {
+  size_t Size = 0;
+  if (PI_TRACED(clGetDeviceInfo)(Device, Param, 0, nullptr,
+                                 &Size) != CL_SUCCESS ||
+      Size == 0)
+    return "";
+  vector_class<char> Value(Size);
+  if (PI_TRACED(clGetDeviceInfo)(Device, Param, Size, Value.data(), nullptr) !=
+      CL_SUCCESS)
+    return "";
+  return string_class(Value.data());
+}
+
+static string_class toHex(uint64_t Value) {
+  std::ostringstream OS;
+  OS << std::hex << Value;
+  return OS.str();
+}
+
+static bool makeDirectory(const string_class &Dir) {
+#if defined(SYCL_RT_OS_LINUX)
+  return mkdir(Dir.c_str(), 0777) == 0 || errno == EEXIST;
+#elif defined(SYCL_RT_OS_WINDOWS)
+  return _mkdir(Dir.c_str()) == 0 || errno == EEXIST;
+#endif
+}
+
+static int getProcessId() {
+#if defined(SYCL_RT_OS_LINUX)
+  return static_cast<int>(getpid());
+#elif defined(SYCL_RT_OS_WINDOWS)
+  return _getpid();
+#endif
+}
+
+namespace {
+struct CacheItemInfo {
+  string_class Path;
+  size_t Size;
+  time_t LastUse;
+};
+} // namespace
+
+// Returns all complete cache entries in Dir. Temporary files of in-flight
+// writes are skipped.
+static vector_class<CacheItemInfo> getCacheItems(const string_class &Dir) {
+  vector_class<CacheItemInfo> Items;
+#if defined(SYCL_RT_OS_LINUX)
+  DIR *D = opendir(Dir.c_str());
+  if (!D)
+    return Items;
+  while (struct dirent *Entry = readdir(D)) {
+    string_class Name(Entry->d_name);
+    if (Name == "." || Name == ".." || Name.find(".tmp") != string_class::npos)
+      continue;
+    string_class Path = Dir + "/" + Name;
+    struct stat Stat;
+    if (stat(Path.c_str(), &Stat) != 0 || !S_ISREG(Stat.st_mode))
+      continue;
+    Items.push_back({Path, static_cast<size_t>(Stat.st_size), Stat.st_mtime});
+  }
+  closedir(D);
+#elif defined(SYCL_RT_OS_WINDOWS)
+  WIN32_FIND_DATAA Data;
+  HANDLE H = FindFirstFileA((Dir + "\\*").c_str(), &Data);
+  if (H == INVALID_HANDLE_VALUE)
+    return Items;
+  do {
+    string_class Name(Data.cFileName);
+    if ((Data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ||
+        Name.find(".tmp") != string_class::npos)
+      continue;
+    ULARGE_INTEGER Size, Time;
+    Size.LowPart = Data.nFileSizeLow;
+    Size.HighPart = Data.nFileSizeHigh;
+    Time.LowPart = Data.ftLastWriteTime.dwLowDateTime;
+    Time.HighPart = Data.ftLastWriteTime.dwHighDateTime;
+    // FILETIME counts 100ns intervals since 1601, only the ordering matters.
+    Items.push_back({Dir + "\\" + Name, static_cast<size_t>(Size.QuadPart),
+                     static_cast<time_t>(Time.QuadPart / 10000000ULL)});
+  } while (FindNextFileA(H, &Data));
+  FindClose(H);
+#endif
+  return Items;
+}
+
+bool PersistentDeviceCodeCache::isEnabled() {
+  static const bool Enabled = !getCacheDir().empty();
+  return Enabled;
+}
+
+string_class PersistentDeviceCodeCache::getCacheDir() {
+  const char *Dir = std::getenv("SYCL_CACHE_DIR");
+  return Dir ? string_class(Dir) : string_class();
+}
+
+size_t PersistentDeviceCodeCache::getMaxCacheSize() {
+  static const size_t MaxSize = []() -> size_t {
+    const char *Size = std::getenv("SYCL_CACHE_MAX_SIZE");
+    if (!Size)
+      return DefaultMaxCacheSize;
+    return static_cast<size_t>(std::strtoull(Size, nullptr, 10));
+  }();
+  return MaxSize;
+}
+
+string_class
+PersistentDeviceCodeCache::getKey(const unsigned char *Data, size_t Size,
+                                  cl_device_id Device,
+                                  const string_class &BuildOptions) {
+  string_class Target = getDeviceInfoString(Device, CL_DEVICE_NAME) + '\0' +
+                        getDeviceInfoString(Device, CL_DEVICE_VENDOR) + '\0' +
+                        getDeviceInfoString(Device, CL_DRIVER_VERSION) + '\0' +
+                        BuildOptions;
+  uint64_t TargetHash =
+      hashBytes(reinterpret_cast<const unsigned char *>(Target.data()),
+                Target.size());
+  // The image size goes into the key as well, to make collisions of the image
+  // hash even less likely.
+  return toHex(hashBytes(Data, Size)) + "-" + toHex(Size) + "-" +
+         toHex(TargetHash) + ".bin";
+}
+
+bool PersistentDeviceCodeCache::getItem(const string_class &Key,
+                                        vector_class<unsigned char> &Binary) {
+  string_class Path = getCacheDir() + "/" + Key;
+  std::ifstream File(Path, std::ios::binary);
+  if (!File.is_open())
+    return false;
+
+  File.seekg(0, std::ios::end);
+  std::streamoff Size = File.tellg();
+  if (Size <= 0)
+    return false;
+  Binary.resize(static_cast<size_t>(Size));
+  File.seekg(0);
+  File.read(reinterpret_cast<char *>(Binary.data()), Size);
+  if (!File.good())
+    return false;
+  File.close();
+
+  // Refresh the modification time, it serves as the last use time for the
+  // eviction.
+  utime(Path.c_str(), nullptr);
+  return true;
+}
+
+void PersistentDeviceCodeCache::putItem(const string_class &Key,
+                                        cl_program Program) {
+  cl_uint NumDevices = 0;
+  if (PI_TRACED(clGetProgramInfo)(Program, CL_PROGRAM_NUM_DEVICES,
+                                  sizeof(NumDevices), &NumDevices,
+                                  nullptr) != CL_SUCCESS ||
+      NumDevices != 1)
+    return;
+
+  size_t BinarySize = 0;
+  if (PI_TRACED(clGetProgramInfo)(Program, CL_PROGRAM_BINARY_SIZES,
+                                  sizeof(BinarySize), &BinarySize,
+                                  nullptr) != CL_SUCCESS ||
+      BinarySize == 0)
+    return;
+  vector_class<unsigned char> Binary(BinarySize);
+  unsigned char *BinaryPtr = Binary.data();
+  if (PI_TRACED(clGetProgramInfo)(Program, CL_PROGRAM_BINARIES,
+                                  sizeof(BinaryPtr), &BinaryPtr,
+                                  nullptr) != CL_SUCCESS)
+    return;
+
+  string_class Dir = getCacheDir();
+  if (!makeDirectory(Dir))
+    return;
+
+  // Write into a process-private file first and then rename it, so that
+  // concurrent readers never see a partially written entry.
+  string_class Path = Dir + "/" + Key;
+  string_class TmpPath = Path + ".tmp" + std::to_string(getProcessId());
+  {
+    std::ofstream File(TmpPath, std::ios::binary);
+    if (!File.is_open())
+      return;
+    File.write(reinterpret_cast<const char *>(Binary.data()), BinarySize);
+    if (!File.good()) {
+      File.close();
+      std::remove(TmpPath.c_str());
+      return;
+    }
+  }
+#if defined(SYCL_RT_OS_WINDOWS)
+  // Unlike POSIX rename, the Windows one doesn't replace an existing file.
+  std::remove(Path.c_str());
+#endif
+  if (std::rename(TmpPath.c_str(), Path.c_str()) != 0) {
+    std::remove(TmpPath.c_str());
+    return;
+  }
+
+  evictItems(Dir);
+}
+
+void PersistentDeviceCodeCache::evictItems(const string_class &Dir) {
+  vector_class<CacheItemInfo> Items = getCacheItems(Dir);
+  size_t TotalSize = 0;
+  for (const CacheItemInfo &Item : Items)
+    TotalSize += Item.Size;
+
+  size_t MaxSize = getMaxCacheSize();
+  if (TotalSize <= MaxSize)
+    return;
+
+  std::sort(Items.begin(), Items.end(),
+            [](const CacheItemInfo &LHS, const CacheItemInfo &RHS) {
+              return std::tie(LHS.LastUse, LHS.Path) <
+                     std::tie(RHS.LastUse, RHS.Path);
+            });
+  for (const CacheItemInfo &Item : Items) {
+    if (TotalSize <= MaxSize)
+      break;
+    if (std::remove(Item.Path.c_str()) == 0)
+      TotalSize -= Item.Size;
+  }
+}
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
@@ -9,18 +9,25 @@
 #include <CL/sycl/context.hpp>
 #include <CL/sycl/detail/common.hpp>
 #include <CL/sycl/detail/os_util.hpp>
+#include <CL/sycl/detail/program_manager/persistent_device_code_cache.hpp>
 #include <CL/sycl/detail/program_manager/program_manager.hpp>
 #include <CL/sycl/detail/util.hpp>
 #include <CL/sycl/device.hpp>
 #include <CL/sycl/exception.hpp>
 #include <CL/sycl/stl.hpp>
 
+#include <algorithm>
 #include <assert.h>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#ifdef SYCL_HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 namespace cl {
 namespace sycl {
@@ -36,17 +43,17 @@ ProgramManager &ProgramManager::getInstance() {
 
 static cl_device_id getFirstDevice(cl_context Context) {
   cl_uint NumDevices = 0;
-  cl_int Err = clGetContextInfo(Context, CL_CONTEXT_NUM_DEVICES,
-                                sizeof(NumDevices), &NumDevices,
-                                /*param_value_size_ret=*/nullptr);
+  cl_int Err = PI_TRACED(clGetContextInfo)(Context, CL_CONTEXT_NUM_DEVICES,
+                                           sizeof(NumDevices), &NumDevices,
+                                           /*param_value_size_ret=*/nullptr);
   CHECK_OCL_CODE(Err);
   assert(NumDevices > 0 && "Context without devices?");
 
   vector_class<cl_device_id> Devices(NumDevices);
   size_t ParamValueSize = 0;
-  Err = clGetContextInfo(Context, CL_CONTEXT_DEVICES,
-                         sizeof(cl_device_id) * NumDevices, &Devices[0],
-                         &ParamValueSize);
+  Err = PI_TRACED(clGetContextInfo)(Context, CL_CONTEXT_DEVICES,
+                                    sizeof(cl_device_id) * NumDevices,
+                                    &Devices[0], &ParamValueSize);
   CHECK_OCL_CODE(Err);
   assert(ParamValueSize == sizeof(cl_device_id) * NumDevices &&
          "Number of CL_CONTEXT_DEVICES should match CL_CONTEXT_NUM_DEVICES.");
@@ -59,9 +66,9 @@ static cl_program createBinaryProgram(const cl_context Context,
   // FIXME: we don't yet support multiple devices with a single binary.
 #ifndef _NDEBUG
   cl_uint NumDevices = 0;
-  CHECK_OCL_CODE(clGetContextInfo(Context, CL_CONTEXT_NUM_DEVICES,
-                                  sizeof(NumDevices), &NumDevices,
-                                  /*param_value_size_ret=*/nullptr));
+  CHECK_OCL_CODE(PI_TRACED(clGetContextInfo)(Context, CL_CONTEXT_NUM_DEVICES,
+                                             sizeof(NumDevices), &NumDevices,
+                                             /*param_value_size_ret=*/nullptr));
   assert(NumDevices > 0 &&
          "Only a single device is supported for AOT compilation");
 #endif
@@ -69,7 +76,7 @@ static cl_program createBinaryProgram(const cl_context Context,
   cl_device_id Device = getFirstDevice(Context);
   cl_int Err = CL_SUCCESS;
   cl_int BinaryStatus = CL_SUCCESS;
-  cl_program Program = clCreateProgramWithBinary(
+  cl_program Program = PI_TRACED(clCreateProgramWithBinary)(
       Context, 1 /*one binary*/, &Device, &DataLen, &Data, &BinaryStatus, &Err);
   CHECK_OCL_CODE(Err);
 
@@ -80,44 +87,137 @@ static cl_program createSpirvProgram(const cl_context Context,
                                      const unsigned char *Data,
                                      size_t DataLen) {
   cl_int Err = CL_SUCCESS;
-  cl_program ClProgram = clCreateProgramWithIL(Context, Data, DataLen, &Err);
+  cl_program ClProgram = PI_TRACED(clCreateProgramWithIL)(Context, Data,
+                                                          DataLen, &Err);
   CHECK_OCL_CODE(Err);
   return ClProgram;
 }
 
-cl_program ProgramManager::getBuiltOpenCLProgram(OSModuleHandle M,
-                                                 const context &Context) {
-  cl_program &ClProgram = m_CachedSpirvPrograms[std::make_pair(Context, M)];
-  if (!ClProgram) {
-    DeviceImage *Img = nullptr;
-    ClProgram = loadProgram(M, Context, &Img);
-    build(ClProgram, Img->BuildOptions);
+static cl_uint getNumContextDevices(cl_context Context) {
+  cl_uint NumDevices = 0;
+  CHECK_OCL_CODE(PI_TRACED(clGetContextInfo)(Context, CL_CONTEXT_NUM_DEVICES,
+                                             sizeof(NumDevices), &NumDevices,
+                                             /*param_value_size_ret=*/nullptr));
+  return NumDevices;
+}
+
+// Returns the options the program built from the image is built with.
+static string_class getBuildOptions(const DeviceImage *Img) {
+  if (const char *Opts = std::getenv("SYCL_PROGRAM_BUILD_OPTIONS"))
+    return Opts;
+  return Img->BuildOptions ? Img->BuildOptions : "";
+}
+
+// Returns the values SpecConsts in a form suitable for a persistent cache key.
+static string_class encodeSpecConstants(const SpecConstantValues &SpecConsts) {
+  static const char Digits[] = "0123456789abcdef";
+  string_class Res;
+  for (const auto &SpecConst : SpecConsts) {
+    Res += " -spec-constant-" + std::to_string(SpecConst.first) + "=";
+    for (char Byte : SpecConst.second) {
+      Res += Digits[static_cast<unsigned char>(Byte) >> 4];
+      Res += Digits[static_cast<unsigned char>(Byte) & 0xf];
+    }
   }
-  return ClProgram;
+  return Res;
 }
 
-cl_kernel ProgramManager::getOrCreateKernel(OSModuleHandle M,
-                                            const context &Context,
-                                            const string_class &KernelName) {
+cl_program
+ProgramManager::getBuiltOpenCLProgram(OSModuleHandle M, const context &Context,
+                                      const string_class &KernelName,
+                                      const SpecConstantValues &SpecConsts) {
+  std::vector<DeviceImage *> *Imgs = nullptr;
+  {
+    std::lock_guard<std::mutex> Guard(Sync::getGlobalLock());
+    Imgs = getDeviceImages(M, KernelName);
+  }
+  const ProgramCacheKey Key(Context, Imgs, SpecConsts);
+  std::promise<cl_program> BuildPromise;
+  std::shared_future<cl_program> BuildResult;
+  bool IsBuilder = false;
+  {
+    std::lock_guard<std::mutex> Lock(m_CachedSpirvProgramsMutex);
+    auto It = m_CachedSpirvPrograms.find(Key);
+    if (It == m_CachedSpirvPrograms.end()) {
+      BuildResult = BuildPromise.get_future().share();
+      m_CachedSpirvPrograms.emplace(Key, BuildResult);
+      IsBuilder = true;
+    } else {
+      BuildResult = It->second;
+    }
+  }
+
+  // The first thread requesting the program builds it, the others wait for the
+  // result. Builds of programs for other contexts or images are not blocked.
+  if (IsBuilder) {
+    try {
+      DeviceImage *Img = nullptr;
+      string_class PersistentCacheKey;
+      cl_program ClProgram = loadProgram(M, Context, KernelName, SpecConsts,
+                                         &Img, &PersistentCacheKey);
+      build(ClProgram, getBuildOptions(Img));
+      if (!PersistentCacheKey.empty())
+        PersistentDeviceCodeCache::putItem(PersistentCacheKey, ClProgram);
+      BuildPromise.set_value(ClProgram);
+    } catch (...) {
+      // Let the waiting threads see the failure, and the next request retry.
+      {
+        std::lock_guard<std::mutex> Lock(m_CachedSpirvProgramsMutex);
+        m_CachedSpirvPrograms.erase(Key);
+      }
+      BuildPromise.set_exception(std::current_exception());
+    }
+  }
+  return BuildResult.get();
+}
+
+cl_kernel ProgramManager::acquireKernel(OSModuleHandle M,
+                                        const context &Context,
+                                        const string_class &KernelName,
+                                        const SpecConstantValues &SpecConsts) {
   if (DbgProgMgr > 0) {
-    std::cerr << ">>> ProgramManager::getOrCreateKernel(" << M << ", "
+    std::cerr << ">>> ProgramManager::acquireKernel(" << M << ", "
               << getRawSyclObjImpl(Context) << ", " << KernelName << ")\n";
   }
-  cl_program Program = getBuiltOpenCLProgram(M, Context);
-  std::map<string_class, cl_kernel> &KernelsCache = m_CachedKernels[Program];
-  cl_kernel &Kernel = KernelsCache[KernelName];
-  if (!Kernel) {
-    cl_int Err = CL_SUCCESS;
-    Kernel = clCreateKernel(Program, KernelName.c_str(), &Err);
-    CHECK_OCL_CODE(Err);
+  cl_program Program =
+      getBuiltOpenCLProgram(M, Context, KernelName, SpecConsts);
+  std::vector<cl_kernel> *FreeList = nullptr;
+  {
+    std::lock_guard<std::mutex> Lock(m_CachedKernelsMutex);
+    FreeList = &m_CachedKernels[Program][KernelName];
+    if (!FreeList->empty()) {
+      cl_kernel Kernel = FreeList->back();
+      FreeList->pop_back();
+      ++m_KernelCacheHits;
+      return Kernel;
+    }
   }
+
+  // All kernel objects are in use by other threads, or there are none yet.
+  // Create another one rather than wait for them: clCloneKernel would copy the
+  // arguments which are going to be overwritten anyway, and needs OpenCL 2.1.
+  cl_int Err = CL_SUCCESS;
+  cl_kernel Kernel = PI_TRACED(clCreateKernel)(Program, KernelName.c_str(),
+                                               &Err);
+  CHECK_OCL_CODE(Err);
+  ++m_KernelCacheMisses;
+  std::lock_guard<std::mutex> Lock(m_CachedKernelsMutex);
+  m_KernelFreeLists[Kernel] = FreeList;
   return Kernel;
 }
 
+void ProgramManager::releaseKernel(cl_kernel Kernel) {
+  std::lock_guard<std::mutex> Lock(m_CachedKernelsMutex);
+  auto It = m_KernelFreeLists.find(Kernel);
+  assert(It != m_KernelFreeLists.end() &&
+         "The kernel was not acquired from the program manager");
+  It->second->push_back(Kernel);
+}
+
 cl_program ProgramManager::getClProgramFromClKernel(cl_kernel ClKernel) {
   cl_program ClProgram;
-  CHECK_OCL_CODE(clGetKernelInfo(ClKernel, CL_KERNEL_PROGRAM,
-                                 sizeof(cl_program), &ClProgram, nullptr));
+  CHECK_OCL_CODE(PI_TRACED(clGetKernelInfo)(
+      ClKernel, CL_KERNEL_PROGRAM, sizeof(cl_program), &ClProgram, nullptr));
   return ClProgram;
 }
 
@@ -132,25 +232,27 @@ void ProgramManager::build(cl_program &ClProgram, const string_class &Options,
 
   if (!Opts)
     Opts = Options.c_str();
-  if (clBuildProgram(ClProgram, ClDevices.size(), ClDevices.data(),
-                     Opts, nullptr, nullptr) == CL_SUCCESS)
+  if (PI_TRACED(clBuildProgram)(ClProgram, ClDevices.size(), ClDevices.data(),
+                                Opts, nullptr, nullptr) == CL_SUCCESS)
     return;
 
   // Get OpenCL build log and add it to the exception message.
   size_t Size = 0;
   CHECK_OCL_CODE(
-      clGetProgramInfo(ClProgram, CL_PROGRAM_DEVICES, 0, nullptr, &Size));
+      PI_TRACED(clGetProgramInfo)(ClProgram, CL_PROGRAM_DEVICES, 0, nullptr,
+                                  &Size));
 
   std::vector<cl_device_id> DevIds(Size / sizeof(cl_device_id));
-  CHECK_OCL_CODE(clGetProgramInfo(ClProgram, CL_PROGRAM_DEVICES, Size,
-                                  DevIds.data(), nullptr));
+  CHECK_OCL_CODE(PI_TRACED(clGetProgramInfo)(ClProgram, CL_PROGRAM_DEVICES,
+                                             Size, DevIds.data(), nullptr));
   std::string Log;
   for (cl_device_id &DevId : DevIds) {
-    CHECK_OCL_CODE(clGetProgramBuildInfo(ClProgram, DevId, CL_PROGRAM_BUILD_LOG,
-                                         0, nullptr, &Size));
+    CHECK_OCL_CODE(PI_TRACED(clGetProgramBuildInfo)(
+        ClProgram, DevId, CL_PROGRAM_BUILD_LOG, 0, nullptr, &Size));
     std::vector<char> BuildLog(Size);
-    CHECK_OCL_CODE(clGetProgramBuildInfo(ClProgram, DevId, CL_PROGRAM_BUILD_LOG,
-                                         Size, BuildLog.data(), nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetProgramBuildInfo)(ClProgram, DevId,
+                                                    CL_PROGRAM_BUILD_LOG, Size,
+                                                    BuildLog.data(), nullptr));
     device Dev(DevId);
     Log += "\nBuild program fail log for '" +
            Dev.get_info<info::device::name>() + "':\n" + BuildLog.data();
@@ -158,13 +260,54 @@ void ProgramManager::build(cl_program &ClProgram, const string_class &Options,
   throw compile_program_error(Log.c_str());
 }
 
-bool ProgramManager::ContextAndModuleLess::
-operator()(const std::pair<context, OSModuleHandle> &LHS,
-           const std::pair<context, OSModuleHandle> &RHS) const {
-  if (LHS.first != RHS.first)
-    return getRawSyclObjImpl(LHS.first) < getRawSyclObjImpl(RHS.first);
-  return reinterpret_cast<intptr_t>(LHS.second) <
-         reinterpret_cast<intptr_t>(RHS.second);
+bool ProgramManager::ProgramCacheKeyLess::
+operator()(const ProgramCacheKey &LHS, const ProgramCacheKey &RHS) const {
+  if (std::get<0>(LHS) != std::get<0>(RHS))
+    return getRawSyclObjImpl(std::get<0>(LHS)) <
+           getRawSyclObjImpl(std::get<0>(RHS));
+  if (std::get<1>(LHS) != std::get<1>(RHS))
+    return std::less<const std::vector<DeviceImage *> *>()(std::get<1>(LHS),
+                                                           std::get<1>(RHS));
+  return std::get<2>(LHS) < std::get<2>(RHS);
+}
+
+// Returns the hash of the contents, format, target and build options of the
+// device image Img.
+static uint64_t hashImage(const DeviceImage *Img) {
+  auto HashString = [](const char *Str, uint64_t Hash) {
+    return Str ? hashBytes(reinterpret_cast<const unsigned char *>(Str),
+                           std::strlen(Str) + 1, Hash)
+               : Hash;
+  };
+  uint64_t Hash =
+      hashBytes(Img->BinaryStart, Img->BinaryEnd - Img->BinaryStart);
+  Hash = hashBytes(&Img->Format, sizeof(Img->Format), Hash);
+  Hash = HashString(Img->DeviceTargetSpec, Hash);
+  return HashString(Img->BuildOptions, Hash);
+}
+
+// Returns true if the device images LHS and RHS can be used interchangeably.
+static bool isSameImage(const DeviceImage *LHS, const DeviceImage *RHS) {
+  auto SameString = [](const char *L, const char *R) {
+    return L == R || (L && R && std::strcmp(L, R) == 0);
+  };
+  return LHS->Format == RHS->Format &&
+         SameString(LHS->DeviceTargetSpec, RHS->DeviceTargetSpec) &&
+         SameString(LHS->BuildOptions, RHS->BuildOptions) &&
+         LHS->BinaryEnd - LHS->BinaryStart ==
+             RHS->BinaryEnd - RHS->BinaryStart &&
+         std::equal(LHS->BinaryStart, LHS->BinaryEnd, RHS->BinaryStart);
+}
+
+DeviceImage *ProgramManager::getRegisteredImage(OSModuleHandle M,
+                                                DeviceImage *Img) {
+  std::vector<DeviceImage *> &Same =
+      m_ImagesByHash[std::make_pair(M, hashImage(Img))];
+  for (DeviceImage *Other : Same)
+    if (isSameImage(Img, Other))
+      return Other;
+  Same.push_back(Img);
+  return Img;
 }
 
 void ProgramManager::addImages(pi_device_binaries DeviceBinary) {
@@ -173,12 +316,42 @@ void ProgramManager::addImages(pi_device_binaries DeviceBinary) {
   for (int I = 0; I < DeviceBinary->NumDeviceBinaries; I++) {
     pi_device_binary Img = &(DeviceBinary->DeviceBinaries[I]);
     OSModuleHandle M = OSUtil::getOSModuleHandle(Img);
+    // The translation units of a module may carry the same image, only the
+    // first one registered is kept so that it is built just once.
+    DeviceImage *Registered = getRegisteredImage(M, Img);
     auto &Imgs = m_DeviceImages[M];
 
     if (Imgs == nullptr)
       Imgs.reset(new std::vector<DeviceImage *>());
-    Imgs->push_back(Img);
+    if (Registered == Img)
+      Imgs->push_back(Img);
+    else if (DbgProgMgr > 0)
+      std::cerr << "device image " << Img << " is the same as " << Registered
+                << "\n";
+
+    // The images of split device code list the kernels they hold.
+    for (_pi_offload_entry Entry = Img->EntriesBegin; Entry != Img->EntriesEnd;
+         ++Entry) {
+      auto &KernelImgs = m_KernelImages[std::make_pair(M, Entry->name)];
+      if (KernelImgs == nullptr)
+        KernelImgs.reset(new std::vector<DeviceImage *>());
+      if (std::find(KernelImgs->begin(), KernelImgs->end(), Registered) ==
+          KernelImgs->end())
+        KernelImgs->push_back(Registered);
+    }
+  }
+}
+
+std::vector<DeviceImage *> *
+ProgramManager::getDeviceImages(OSModuleHandle M,
+                                const string_class &KernelName) {
+  if (!KernelName.empty()) {
+    auto It = m_KernelImages.find(std::make_pair(M, KernelName));
+    if (It != m_KernelImages.end())
+      return It->second.get();
   }
+  auto It = m_DeviceImages.find(M);
+  return It == m_DeviceImages.end() ? nullptr : It->second.get();
 }
 
 void ProgramManager::debugDumpBinaryImage(const DeviceImage *Img) const {
@@ -211,14 +384,50 @@ struct ImageDeleter {
   }
 };
 
+// Returns a copy of the compressed image Img owning the decompressed data, to
+// be freed with ImageDeleter.
+static DeviceImage *decompressImage(const DeviceImage *Img) {
+#ifdef SYCL_HAVE_ZLIB
+  const size_t HeaderSize = sizeof(uint64_t);
+  if (Img->BinaryEnd < Img->BinaryStart + HeaderSize) {
+    throw runtime_error("Malformed compressed device program image");
+  }
+  uint64_t Size = 0;
+  for (size_t I = 0; I < HeaderSize; ++I)
+    Size |= static_cast<uint64_t>(Img->BinaryStart[I]) << (8 * I);
+
+  std::unique_ptr<unsigned char[]> Data(new unsigned char[Size]);
+  uLongf DataSize = static_cast<uLongf>(Size);
+  const unsigned char *Src = Img->BinaryStart + HeaderSize;
+  if (uncompress(Data.get(), &DataSize, Src,
+                 static_cast<uLong>(Img->BinaryEnd - Src)) != Z_OK ||
+      DataSize != Size) {
+    throw runtime_error("Can't decompress device program image");
+  }
+  auto *Res = new DeviceImage(*Img);
+  Res->Format = Img->Format & ~PI_DEVICE_BINARY_FLAG_COMPRESSED;
+  Res->BinaryStart = Data.release();
+  Res->BinaryEnd = Res->BinaryStart + Size;
+  return Res;
+#else
+  throw runtime_error("Compressed device program images are not supported, "
+                      "the SYCL runtime is built without zlib");
+#endif
+}
+
 RT::pi_program ProgramManager::loadProgram(OSModuleHandle M,
                                            const context &Context,
-                                           DeviceImage **I) {
-  std::lock_guard<std::mutex> Guard(Sync::getGlobalLock());
+                                           const string_class &KernelName,
+                                           const SpecConstantValues &SpecConsts,
+                                           DeviceImage **I,
+                                           string_class *PersistentCacheKey) {
+  // The lock guards the device image lists only, the native program creation
+  // below may run concurrently with other loads.
+  std::unique_lock<std::mutex> Guard(Sync::getGlobalLock());
 
   if (DbgProgMgr > 0) {
     std::cerr << ">>> ProgramManager::loadProgram(" << M << ","
-              << getRawSyclObjImpl(Context) << ")\n";
+              << getRawSyclObjImpl(Context) << "," << KernelName << ")\n";
   }
 
   DeviceImage *Img = nullptr;
@@ -267,18 +476,33 @@ RT::pi_program ProgramManager::loadProgram(OSModuleHandle M,
       std::cerr << "loaded device image from " << Fname << "\n";
     }
   } else {
-    // Take all device images in module M and ask the native runtime under the
-    // given context to choose one it prefers.
-    auto ImgIt = m_DeviceImages.find(M);
+    // Take the device images in module M holding the kernel and ask the
+    // native runtime under the given context to choose one it prefers.
+    std::vector<DeviceImage *> *Imgs = getDeviceImages(M, KernelName);
 
-    if (ImgIt == m_DeviceImages.end()) {
+    if (!Imgs) {
       throw runtime_error("No device program image found");
     }
-    std::vector<DeviceImage *> *Imgs = (ImgIt->second).get();
 
     PI_CALL(RT::piextDeviceSelectBinary(
       0, Imgs->data(), (cl_uint)Imgs->size(), &Img));
 
+    // Only the selected image is decompressed, the others are never paged in.
+    if (Img->Format & PI_DEVICE_BINARY_FLAG_COMPRESSED) {
+      DeviceImage *&Decompressed = m_DecompressedImages[Img];
+      if (!Decompressed) {
+        std::unique_ptr<DeviceImage, ImageDeleter> ImgPtr(decompressImage(Img),
+                                                          ImageDeleter());
+        Decompressed = ImgPtr.get();
+        m_OrphanDeviceImages.emplace_back(std::move(ImgPtr));
+        if (DbgProgMgr > 0) {
+          std::cerr << "decompressed device image " << Img << " to "
+                    << Decompressed << "\n";
+        }
+      }
+      Img = Decompressed;
+    }
+
     if (DbgProgMgr > 0) {
       std::cerr << "available device images:\n";
       debugDumpBinaryImages();
@@ -286,6 +510,8 @@ RT::pi_program ProgramManager::loadProgram(OSModuleHandle M,
       debugDumpBinaryImage(Img);
     }
   }
+  Guard.unlock();
+
   // perform minimal sanity checks on the device image and the descriptor
   if (Img->BinaryEnd < Img->BinaryStart) {
     throw runtime_error("Malformed device program image descriptor");
@@ -358,9 +584,44 @@ RT::pi_program ProgramManager::loadProgram(OSModuleHandle M,
   // Load the selected image
   const cl_context &Ctx = getRawSyclObjImpl(Context)->getHandleRef();
   RT::pi_program Res = nullptr;
-  Res = Format == PI_DEVICE_BINARY_TYPE_SPIRV
-            ? createSpirvProgram(Ctx, Img->BinaryStart, ImgSize)
-            : createBinaryProgram(Ctx, Img->BinaryStart, ImgSize);
+
+  // Only SPIR-V programs can be specialized, native binaries are built with the
+  // default values of the specialization constants already.
+  if (!SpecConsts.empty() && Format != PI_DEVICE_BINARY_TYPE_SPIRV) {
+    throw runtime_error("Specialization constants are only supported for "
+                        "SPIR-V device program images");
+  }
+
+  // A native binary of a SPIR-V image may be available from the persistent
+  // cache. Only single-device contexts are supported, the same as for AOT
+  // binaries.
+  if (PersistentCacheKey && Format == PI_DEVICE_BINARY_TYPE_SPIRV &&
+      PersistentDeviceCodeCache::isEnabled() &&
+      getNumContextDevices(Ctx) == 1) {
+    *PersistentCacheKey = PersistentDeviceCodeCache::getKey(
+        Img->BinaryStart, ImgSize, getFirstDevice(Ctx),
+        getBuildOptions(Img) + encodeSpecConstants(SpecConsts));
+    vector_class<unsigned char> Binary;
+    if (PersistentDeviceCodeCache::getItem(*PersistentCacheKey, Binary)) {
+      if (DbgProgMgr > 0) {
+        std::cerr << "loaded native program from the persistent cache: "
+                  << *PersistentCacheKey << "\n";
+      }
+      Res = createBinaryProgram(Ctx, Binary.data(), Binary.size());
+      // Nothing to store back into the cache.
+      PersistentCacheKey->clear();
+    }
+  }
+  if (!Res && Format == PI_DEVICE_BINARY_TYPE_SPIRV) {
+    Res = createSpirvProgram(Ctx, Img->BinaryStart, ImgSize);
+    // The values must be set before the program is built.
+    for (const auto &SpecConst : SpecConsts)
+      CHECK_OCL_CODE(PI_TRACED(clSetProgramSpecializationConstant)(
+          Res, SpecConst.first, SpecConst.second.size(),
+          SpecConst.second.data()));
+  } else if (!Res) {
+    Res = createBinaryProgram(Ctx, Img->BinaryStart, ImgSize);
+  }
 
   if (I)
     *I = Img;
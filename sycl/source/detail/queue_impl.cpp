@@ -8,17 +8,149 @@
 
 #include <CL/sycl/context.hpp>
 #include <CL/sycl/detail/queue_impl.hpp>
+#include <CL/sycl/detail/stream_impl.hpp>
 #include <CL/sycl/device.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+
 namespace cl {
 namespace sycl {
 namespace detail {
+queue_impl::~queue_impl() {
+  for (size_t I = 0; I < m_Queues.size(); ++I) {
+    if (m_LastEvents[I])
+      CHECK_OCL_CODE_NO_EXC(PI_TRACED(clReleaseEvent)(m_LastEvents[I]));
+    // The first queue of the pool is m_CommandQueue, released below.
+    if (I)
+      CHECK_OCL_CODE_NO_EXC(PI_TRACED(clReleaseCommandQueue)(m_Queues[I]));
+  }
+  if (m_OpenCLInterop) {
+    CHECK_OCL_CODE_NO_EXC(PI_TRACED(clReleaseCommandQueue)(m_CommandQueue));
+  }
+}
+
+size_t queue_impl::getMaxNumQueues() {
+  static const size_t Max = []() -> size_t {
+    if (const char *Val = std::getenv("SYCL_MAX_NUM_QUEUES")) {
+      size_t Num = static_cast<size_t>(std::strtoull(Val, nullptr, 10));
+      if (Num > 0)
+        return Num;
+    }
+    return MaxNumQueues;
+  }();
+  return Max;
+}
+
+cl_command_queue &queue_impl::getExclusiveQueueHandleRefImpl() {
+  // Start searching from the least recently used queue, it is the most
+  // likely to be idle.
+  for (size_t I = 0; I < m_Queues.size(); ++I) {
+    const size_t Num = (m_QueueNumber + I) % m_Queues.size();
+    cl_event &LastEvent = m_LastEvents[Num];
+    if (LastEvent) {
+      cl_int Status = CL_QUEUED;
+      CHECK_OCL_CODE(PI_TRACED(clGetEventInfo)(
+          LastEvent, CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(Status), &Status,
+          nullptr));
+      // Negative values mean an error, the queue is not going to execute the
+      // command anyway.
+      if (Status != CL_COMPLETE && Status > 0)
+        continue;
+      CHECK_OCL_CODE(PI_TRACED(clReleaseEvent)(LastEvent));
+      LastEvent = nullptr;
+    }
+    m_QueueNumber = Num + 1;
+    return m_Queues[Num];
+  }
+
+  // To achive parallelism for FPGA with in order execution model with
+  // possibility of two kernels to share data with each other we shall
+  // create a queue for every kernel enqueued.
+  if (m_Queues.size() < getMaxNumQueues()) {
+    // Keep references to the queues valid while the list grows.
+    m_Queues.reserve(getMaxNumQueues());
+    m_Queues.push_back(createQueue());
+    m_LastEvents.push_back(nullptr);
+    return m_Queues.back();
+  }
+
+  // All the queues are busy and no more can be created. The command is put
+  // after the work of the least recently used queue, the dependencies are
+  // expressed by the events, so there is no need to wait for the queue.
+  m_QueueNumber %= m_Queues.size();
+  return m_Queues[m_QueueNumber++];
+}
+
+void queue_impl::reportEvent(cl_event Event) {
+  std::lock_guard<std::mutex> Lock(m_QueuesMutex);
+  if (m_Queues.empty())
+    return;
+  cl_command_queue CLQueue = nullptr;
+  CHECK_OCL_CODE(PI_TRACED(clGetEventInfo)(Event, CL_EVENT_COMMAND_QUEUE,
+                                           sizeof(CLQueue), &CLQueue, nullptr));
+  auto It = std::find(m_Queues.begin(), m_Queues.end(), CLQueue);
+  if (It == m_Queues.end())
+    return;
+  cl_event &LastEvent = m_LastEvents[It - m_Queues.begin()];
+  CHECK_OCL_CODE(PI_TRACED(clRetainEvent)(Event));
+  if (LastEvent)
+    CHECK_OCL_CODE(PI_TRACED(clReleaseEvent)(LastEvent));
+  LastEvent = Event;
+}
+
+void queue_impl::addEvent(event Event) {
+  std::lock_guard<std::mutex> Lock(m_EventsMutex);
+  m_Events.push_back(std::move(Event));
+  if (m_Events.size() < m_EventsRetireSize)
+    return;
+
+  // Each check removes the completed events, the next one happens when the
+  // list has grown twice, so that the checks take amortized constant time.
+  m_Events.erase(std::remove_if(m_Events.begin(), m_Events.end(),
+                                [](const event &Event) {
+                                  return getSyclObjImpl(Event)->isCompleted();
+                                }),
+                 m_Events.end());
+  m_EventsRetireSize = std::max(MinEventsRetireSize, 2 * m_Events.size());
+}
+
+void queue_impl::wait() {
+  vector_class<event> Events;
+  {
+    std::lock_guard<std::mutex> Lock(m_EventsMutex);
+    Events.swap(m_Events);
+    m_EventsRetireSize = MinEventsRetireSize;
+  }
+  // The events are waited for without the lock held, so that other threads
+  // can keep submitting to the queue. The native events of the queue context
+  // are waited for with a single call instead of a call per event.
+  const ContextImplPtr &Context = getSyclObjImpl(m_Context);
+  vector_class<cl_event> CLEvents;
+  for (event &Event : Events) {
+    const EventImplPtr &EventImpl = getSyclObjImpl(Event);
+    // The handle is valid only after the command is enqueued, the other
+    // events are waited for through the scheduler.
+    const Command *Cmd = static_cast<Command *>(EventImpl->getCommand());
+    if (!EventImpl->is_host() && (!Cmd || Cmd->isEnqueued()) &&
+        EventImpl->getHandleRef() && EventImpl->getContextImpl() == Context)
+      CLEvents.push_back(EventImpl->getHandleRef());
+    else
+      Event.wait();
+  }
+  if (!CLEvents.empty())
+    CHECK_OCL_CODE(PI_TRACED(clWaitForEvents)(CLEvents.size(), &CLEvents[0]));
+  // The output of the streams used by the kernels is printed in the
+  // background, it is expected to be printed by the time the queue is idle.
+  stream_impl::waitForFlushes();
+}
+
 template <> cl_uint queue_impl::get_info<info::queue::reference_count>() const {
   cl_uint result = 0;
   if (!is_host())
-    CHECK_OCL_CODE(clGetCommandQueueInfo(m_CommandQueue,
-                                         CL_QUEUE_REFERENCE_COUNT,
-                                         sizeof(result), &result, nullptr));
+    CHECK_OCL_CODE(PI_TRACED(clGetCommandQueueInfo)(
+        m_CommandQueue, CL_QUEUE_REFERENCE_COUNT, sizeof(result), &result,
+        nullptr));
   return result;
 }
 
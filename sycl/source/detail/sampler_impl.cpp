@@ -22,29 +22,34 @@ sampler_impl::sampler_impl(coordinate_normalization_mode normalizationMode,
 sampler_impl::sampler_impl(cl_sampler clSampler, const context &syclContext) {
 
   m_contextToSampler[syclContext] = clSampler;
-  CHECK_OCL_CODE(clRetainSampler(clSampler));
-  CHECK_OCL_CODE(clGetSamplerInfo(clSampler, CL_SAMPLER_NORMALIZED_COORDS,
-                                  sizeof(cl_bool), &m_CoordNormMode, nullptr));
-  CHECK_OCL_CODE(clGetSamplerInfo(clSampler, CL_SAMPLER_ADDRESSING_MODE,
-                                  sizeof(cl_addressing_mode), &m_AddrMode,
-                                  nullptr));
-  CHECK_OCL_CODE(clGetSamplerInfo(clSampler, CL_SAMPLER_FILTER_MODE,
-                                  sizeof(cl_filter_mode), &m_FiltMode,
-                                  nullptr));
+  CHECK_OCL_CODE(PI_TRACED(clRetainSampler)(clSampler));
+  CHECK_OCL_CODE(PI_TRACED(clGetSamplerInfo)(
+      clSampler, CL_SAMPLER_NORMALIZED_COORDS, sizeof(cl_bool),
+      &m_CoordNormMode, nullptr));
+  CHECK_OCL_CODE(PI_TRACED(clGetSamplerInfo)(
+      clSampler, CL_SAMPLER_ADDRESSING_MODE, sizeof(cl_addressing_mode),
+      &m_AddrMode, nullptr));
+  CHECK_OCL_CODE(PI_TRACED(clGetSamplerInfo)(clSampler, CL_SAMPLER_FILTER_MODE,
+                                             sizeof(cl_filter_mode),
+                                             &m_FiltMode, nullptr));
 }
 
 sampler_impl::~sampler_impl() {
   for (auto &Iter : m_contextToSampler) {
     // TODO replace CHECK_OCL_CODE_NO_EXC to CHECK_OCL_CODE and
     // TODO catch an exception and add it to the list of asynchronous exceptions
-    CHECK_OCL_CODE_NO_EXC(clReleaseSampler(Iter.second));
+    CHECK_OCL_CODE_NO_EXC(PI_TRACED(clReleaseSampler)(Iter.second));
   }
 }
 
 cl_sampler sampler_impl::getOrCreateSampler(const context &Context) {
+  // A sampler is used by every kernel it is passed to, look it up once.
+  auto It = m_contextToSampler.find(Context);
+  if (It != m_contextToSampler.end())
+    return It->second;
+
   cl_int errcode_ret = CL_SUCCESS;
-  if (m_contextToSampler[Context])
-    return m_contextToSampler[Context];
+  cl_sampler clSampler = nullptr;
 
 #if CL_TARGET_OPENCL_VERSION > 120
   const cl_sampler_properties sprops[] = {
@@ -55,16 +60,17 @@ cl_sampler sampler_impl::getOrCreateSampler(const context &Context) {
       CL_SAMPLER_FILTER_MODE,
       static_cast<cl_sampler_properties>(m_FiltMode),
       0};
-  m_contextToSampler[Context] =
-      clCreateSamplerWithProperties(Context.get(), sprops, &errcode_ret);
+  clSampler = PI_TRACED(clCreateSamplerWithProperties)(Context.get(), sprops,
+                                                       &errcode_ret);
 #else
-  m_contextToSampler[Context] =
-      clCreateSampler(Context.get(), static_cast<cl_bool>(m_CoordNormMode),
-                      static_cast<cl_addressing_mode>(m_AddrMode),
-                      static_cast<cl_filter_mode>(m_FiltMode), &errcode_ret);
+  clSampler = PI_TRACED(clCreateSampler)(
+      Context.get(), static_cast<cl_bool>(m_CoordNormMode),
+      static_cast<cl_addressing_mode>(m_AddrMode),
+      static_cast<cl_filter_mode>(m_FiltMode), &errcode_ret);
 #endif
   CHECK_OCL_CODE(errcode_ret);
-  return m_contextToSampler[Context];
+  m_contextToSampler.emplace(Context, clSampler);
+  return clSampler;
 }
 
 addressing_mode sampler_impl::get_addressing_mode() const { return m_AddrMode; }
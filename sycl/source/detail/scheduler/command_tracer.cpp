@@ -0,0 +1,172 @@
+//==------- command_tracer.cpp - SYCL scheduler command timeline -----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/event_impl.hpp>
+#include <CL/sycl/detail/queue_impl.hpp>
+#include <CL/sycl/detail/scheduler/command_tracer.hpp>
+#include <CL/sycl/detail/scheduler/commands.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+CommandTracer *CommandTracer::get() {
+  // Never destroyed, the commands may be enqueued and completed by the
+  // destructors of static objects.
+  static CommandTracer *Instance = []() -> CommandTracer * {
+    const char *Path = getPath("SYCL_COMMAND_TRACE_FILE");
+    if (!Path)
+      return nullptr;
+    CommandTracer *Tracer = new CommandTracer(Path);
+    writeAtExit(Tracer);
+    return Tracer;
+  }();
+  return Instance;
+}
+
+void CommandTracer::recordEnqueue(const Command *Cmd, Clock::time_point Start,
+                                  Clock::time_point End) {
+  Record NewRecord;
+  NewRecord.MName = Command::getTypeName(Cmd->getType());
+  NewRecord.MThread = getTraceThreadId();
+  NewRecord.MStart = Start;
+  NewRecord.MEnd = End;
+
+  const QueueImplPtr &Queue = Cmd->getQueue();
+  std::ostringstream Args;
+  Args << "\"queue\":\"" << (Queue->is_host() ? "host" : "device") << "\"";
+  if (const ExecCGCommand *ExecCmd = dynamic_cast<const ExecCGCommand *>(Cmd))
+    if (ExecCmd->getCG().getType() == CG::KERNEL) {
+      Args << ",\"kernel\":\"";
+      writeJSONEscaped(
+          Args, static_cast<CGExecKernel &>(ExecCmd->getCG()).getKernelName());
+      Args << "\"";
+    }
+  NewRecord.MArgs = Args.str();
+
+  cl_event CLEvent =
+      Queue->is_host() ? nullptr : Cmd->getEvent()->getHandleRef();
+  size_t Id = 0;
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    if (MWritten)
+      return;
+    for (const DepDesc &Dep : Cmd->MDeps) {
+      auto It = MIds.find(Dep.MDepCommand);
+      if (It != MIds.end())
+        NewRecord.MDeps.push_back(It->second);
+    }
+    // The commands executed on the host are done once they are enqueued.
+    if (!CLEvent) {
+      NewRecord.MCompleted = true;
+      NewRecord.MCompletion = End;
+    }
+    Id = MRecords.size();
+    MIds[Cmd] = Id;
+    MRecords.push_back(std::move(NewRecord));
+  }
+
+  if (CLEvent)
+    CHECK_OCL_CODE(PI_TRACED(clSetEventCallback)(
+        CLEvent, CL_COMPLETE, &CommandTracer::onCompletion,
+        reinterpret_cast<void *>(Id)));
+}
+
+void CL_CALLBACK CommandTracer::onCompletion(cl_event Event, cl_int Status,
+                                             void *Data) {
+  if (Status == CL_COMPLETE)
+    get()->recordCompletion(reinterpret_cast<size_t>(Data), Event);
+}
+
+void CommandTracer::recordCompletion(size_t Id, cl_event Event) {
+  const Clock::time_point Completion = Clock::now();
+  // Fails if the queue doesn't have profiling enabled, then only the host
+  // side of the command is shown.
+  cl_ulong Queued = 0, Start = 0, End = 0;
+  auto GetProfilingInfo = [Event](cl_profiling_info Param, cl_ulong &Value) {
+    return PI_TRACED(clGetEventProfilingInfo)(Event, Param, sizeof(Value),
+                                              &Value, nullptr) == CL_SUCCESS;
+  };
+  const bool HasDeviceTime =
+      GetProfilingInfo(CL_PROFILING_COMMAND_QUEUED, Queued) &&
+      GetProfilingInfo(CL_PROFILING_COMMAND_START, Start) &&
+      GetProfilingInfo(CL_PROFILING_COMMAND_END, End);
+  cl_command_queue CLQueue = nullptr;
+  if (HasDeviceTime)
+    CHECK_OCL_CODE_NO_EXC(PI_TRACED(clGetEventInfo)(
+        Event, CL_EVENT_COMMAND_QUEUE, sizeof(CLQueue), &CLQueue, nullptr));
+
+  std::lock_guard<std::mutex> Lock(MMutex);
+  Record &Rec = MRecords[Id];
+  Rec.MCompleted = true;
+  Rec.MCompletion = Completion;
+  if (HasDeviceTime) {
+    Rec.MHasDeviceTime = true;
+    auto QueueIt = MDeviceQueues.emplace(CLQueue, MDeviceQueues.size()).first;
+    Rec.MDeviceQueue = QueueIt->second;
+    Rec.MDeviceStart = Rec.MStart + std::chrono::nanoseconds(Start - Queued);
+    Rec.MDeviceEnd = Rec.MStart + std::chrono::nanoseconds(End - Queued);
+  }
+}
+
+void CommandTracer::writeEvents(std::ostream &Stream) {
+  // The timestamps are relative to the first command.
+  Clock::time_point Origin = Clock::time_point::max();
+  for (const Record &Rec : MRecords)
+    Origin = std::min(Origin, Rec.MStart);
+  auto ToUs = [Origin](Clock::time_point Time) {
+    return std::chrono::duration<double, std::micro>(Time - Origin).count();
+  };
+
+  // The host threads are process 0 and the native queues are process 1.
+  Stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,"
+            "\"args\":{\"name\":\"host\"}},\n"
+         << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+            "\"args\":{\"name\":\"device\"}}";
+  for (size_t Id = 0; Id < MRecords.size(); ++Id) {
+    const Record &Rec = MRecords[Id];
+    Stream << ",\n{\"name\":\"" << Rec.MName
+           << "\",\"cat\":\"enqueue\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+           << Rec.MThread << ",\"ts\":" << ToUs(Rec.MStart)
+           << ",\"dur\":" << ToUs(Rec.MEnd) - ToUs(Rec.MStart)
+           << ",\"args\":{\"id\":" << Id << "," << Rec.MArgs << "}}";
+    if (Rec.MCompleted)
+      Stream << ",\n{\"name\":\"" << Rec.MName
+             << " done\",\"cat\":\"completion\",\"ph\":\"i\",\"s\":\"t\","
+                "\"pid\":0,\"tid\":"
+             << Rec.MThread << ",\"ts\":" << ToUs(Rec.MCompletion)
+             << ",\"args\":{\"id\":" << Id << "}}";
+    if (Rec.MHasDeviceTime)
+      Stream << ",\n{\"name\":\"" << Rec.MName
+             << "\",\"cat\":\"execution\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+             << Rec.MDeviceQueue << ",\"ts\":" << ToUs(Rec.MDeviceStart)
+             << ",\"dur\":" << ToUs(Rec.MDeviceEnd) - ToUs(Rec.MDeviceStart)
+             << ",\"args\":{\"id\":" << Id << "," << Rec.MArgs << "}}";
+    // An arrow from the enqueue of each dependency to the enqueue of this
+    // command, the flow ids only have to be unique.
+    for (size_t DepId : Rec.MDeps) {
+      const Record &Dep = MRecords[DepId];
+      const std::string Flow = std::to_string(DepId) + "_" + std::to_string(Id);
+      Stream << ",\n{\"name\":\"dependency\",\"cat\":\"dependency\","
+                "\"ph\":\"s\",\"id\":\""
+             << Flow << "\",\"pid\":0,\"tid\":" << Dep.MThread
+             << ",\"ts\":" << ToUs(Dep.MStart) << "}";
+      Stream << ",\n{\"name\":\"dependency\",\"cat\":\"dependency\","
+                "\"ph\":\"f\",\"bp\":\"e\",\"id\":\""
+             << Flow << "\",\"pid\":0,\"tid\":" << Rec.MThread
+             << ",\"ts\":" << ToUs(Rec.MStart) << "}";
+    }
+  }
+}
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
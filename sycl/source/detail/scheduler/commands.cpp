@@ -13,11 +13,13 @@
 #include <CL/sycl/detail/memory_manager.hpp>
 #include <CL/sycl/detail/program_manager/program_manager.hpp>
 #include <CL/sycl/detail/queue_impl.hpp>
+#include <CL/sycl/detail/scheduler/command_tracer.hpp>
 #include <CL/sycl/detail/scheduler/commands.hpp>
 #include <CL/sycl/detail/scheduler/scheduler.hpp>
 #include <CL/sycl/detail/stream_impl.hpp>
 #include <CL/sycl/sampler.hpp>
 
+#include <mutex>
 #include <vector>
 
 namespace cl {
@@ -26,7 +28,15 @@ namespace detail {
 
 void EventCompletionClbk(cl_event, cl_int, void *data) {
   // TODO: Handle return values. Store errors to async handler.
-  clSetUserEventStatus((cl_event)data, CL_COMPLETE);
+  PI_TRACED(clSetUserEventStatus)((cl_event)data, CL_COMPLETE);
+}
+
+bool Command::isOrderedByQueue(const Command *Dep) const {
+  // Command groups are always enqueued to the main native queue, other
+  // commands may use the queue of another device or an exclusive one.
+  return Dep && MQueue->isInOrder() && MType == RUN_CG &&
+         Dep->MType == RUN_CG && Dep->MQueue == MQueue &&
+         !MUseExclusiveQueue && !Dep->MUseExclusiveQueue;
 }
 
 // Method prepares cl_event's from list sycl::event's
@@ -34,6 +44,8 @@ std::vector<cl_event> Command::prepareEvents(ContextImplPtr Context) {
   std::vector<cl_event> Result;
   std::vector<EventImplPtr> GlueEvents;
   for (EventImplPtr &Event : MDepsEvents) {
+    if (isOrderedByQueue(static_cast<Command *>(Event->getCommand())))
+      continue;
     // Async work is not supported for host device.
     if (Event->getContextImpl()->is_host()) {
       Event->waitInternal();
@@ -46,19 +58,23 @@ std::vector<cl_event> Command::prepareEvents(ContextImplPtr Context) {
     }
     ContextImplPtr EventContext = Event->getContextImpl();
 
-    // If contexts don't match - connect them using user event
-    if (EventContext != Context && !Context->is_host()) {
+    // If contexts don't match - connect them using user event. The events of
+    // distinct SYCL contexts wrapping one OpenCL context need no connection.
+    if (EventContext != Context && !Context->is_host() &&
+        EventContext->getHandleRef() != Context->getHandleRef()) {
       cl_int Error = CL_SUCCESS;
 
       EventImplPtr GlueEvent(new detail::event_impl());
       GlueEvent->setContextImpl(Context);
 
       cl_event &GlueEventHandle = GlueEvent->getHandleRef();
-      GlueEventHandle = clCreateUserEvent(Context->getHandleRef(), &Error);
+      GlueEventHandle = PI_TRACED(clCreateUserEvent)(Context->getHandleRef(),
+                                                     &Error);
       CHECK_OCL_CODE(Error);
 
-      Error = clSetEventCallback(Event->getHandleRef(), CL_COMPLETE,
-                                 EventCompletionClbk, /*data=*/GlueEventHandle);
+      Error = PI_TRACED(clSetEventCallback)(Event->getHandleRef(), CL_COMPLETE,
+                                            EventCompletionClbk,
+                                            /*data=*/GlueEventHandle);
       CHECK_OCL_CODE(Error);
       GlueEvents.push_back(std::move(GlueEvent));
       Result.push_back(GlueEventHandle);
@@ -78,11 +94,55 @@ Command::Command(CommandType Type, QueueImplPtr Queue, bool UseExclusiveQueue)
   MEvent->setContextImpl(detail::getSyclObjImpl(MQueue->get_context()));
 }
 
+const char *Command::getTypeName(CommandType Type) {
+  switch (Type) {
+  case RUN_CG:
+    return "EXEC CG";
+  case COPY_MEMORY:
+    return "MEMCPY";
+  case ALLOCA:
+    return "ALLOCA";
+  case RELEASE:
+    return "RELEASE";
+  case MAP_MEM_OBJ:
+    return "MAP";
+  case UNMAP_MEM_OBJ:
+    return "UNMAP";
+  }
+  return "UNKNOWN";
+}
+
 cl_int Command::enqueue() {
-  bool Expected = false;
-  if (MEnqueued.compare_exchange_strong(Expected, true))
-    return enqueueImp();
-  return CL_SUCCESS;
+  if (MEnqueued)
+    return CL_SUCCESS;
+
+  std::lock_guard<std::mutex> Lock(MEnqueueMutex);
+  if (MEnqueued)
+    return CL_SUCCESS;
+  CommandTracer *Tracer = CommandTracer::get();
+  const CommandTracer::Clock::time_point Start =
+      Tracer ? CommandTracer::Clock::now() : CommandTracer::Clock::time_point();
+  cl_int Result = enqueueImp();
+  if (CL_SUCCESS == Result) {
+    // Lets the queue know its native queue is busy with the command.
+    const QueueImplPtr &WorkerQueue = getWorkerQueue();
+    if (!WorkerQueue->is_host() && MEvent->getHandleRef())
+      WorkerQueue->reportEvent(MEvent->getHandleRef());
+    if (Tracer)
+      Tracer->recordEnqueue(this, Start, CommandTracer::Clock::now());
+    MEnqueued = true;
+  }
+  return Result;
+}
+
+void Command::prepareForReplay(std::vector<EventImplPtr> DepEvents) {
+  std::lock_guard<std::mutex> Lock(MEnqueueMutex);
+  assert(MEnqueued && "Only executed commands can be replayed");
+  MDepsEvents = std::move(DepEvents);
+  MEvent.reset(new detail::event_impl());
+  MEvent->setCommand(this);
+  MEvent->setContextImpl(detail::getSyclObjImpl(MQueue->get_context()));
+  MEnqueued = false;
 }
 
 cl_int AllocaCommand::enqueueImp() {
@@ -157,26 +217,32 @@ MemCpyCommand::MemCpyCommand(Requirement SrcReq, AllocaCommand *SrcAlloca,
     MEvent->setContextImpl(detail::getSyclObjImpl(MSrcQueue->get_context()));
 }
 
+const QueueImplPtr &MemCpyCommand::getWorkerQueue() const {
+  return MQueue->is_host() ? MSrcQueue : MQueue;
+}
+
 cl_int MemCpyCommand::enqueueImp() {
   std::vector<cl_event> RawEvents;
-  QueueImplPtr Queue = MQueue->is_host() ? MSrcQueue : MQueue;
+  const QueueImplPtr &Queue = getWorkerQueue();
   RawEvents =
       Command::prepareEvents(detail::getSyclObjImpl(Queue->get_context()));
 
   cl_event &Event = MEvent->getHandleRef();
 
-  // Omit copying if mode is discard one.
-  // TODO: Handle this at the graph building time by, for example, creating
-  // empty node instead of memcpy.
+  // Omit copying if mode is discard one or the graph optimizer found that the
+  // destination is up to date.
+  // TODO: Handle discard modes at the graph building time as well.
   if (MDstReq.MAccessMode == access::mode::discard_read_write ||
       MDstReq.MAccessMode == access::mode::discard_write ||
-      MSrcAlloca->getMemAllocation() == MDstAlloca->getMemAllocation()) {
+      MSrcAlloca->getMemAllocation() == MDstAlloca->getMemAllocation() ||
+      MIsRedundant) {
 
     if (!RawEvents.empty()) {
       if (Queue->is_host()) {
-        CHECK_OCL_CODE(clWaitForEvents(RawEvents.size(), &RawEvents[0]));
+        CHECK_OCL_CODE(PI_TRACED(clWaitForEvents)(RawEvents.size(),
+                                                  &RawEvents[0]));
       } else {
-        CHECK_OCL_CODE(clEnqueueMarkerWithWaitList(
+        CHECK_OCL_CODE(PI_TRACED(clEnqueueMarkerWithWaitList)(
             Queue->getHandleRef(), RawEvents.size(), &RawEvents[0], &Event));
       }
     }
@@ -207,7 +273,8 @@ void ExecCGCommand::flushStreams() {
   assert(MCommandGroup->getType() == CG::KERNEL && "Expected kernel");
   for (auto StreamImplPtr :
        ((CGExecKernel *)MCommandGroup.get())->getStreams()) {
-    StreamImplPtr->flush();
+    MEvent->setStreamFlushTicket(
+        stream_impl::flushAsync(std::move(StreamImplPtr)));
   }
 }
 
@@ -222,23 +289,30 @@ MemCpyCommandHost::MemCpyCommandHost(Requirement SrcReq,
     MEvent->setContextImpl(detail::getSyclObjImpl(MSrcQueue->get_context()));
 }
 
+const QueueImplPtr &MemCpyCommandHost::getWorkerQueue() const {
+  return MQueue->is_host() ? MSrcQueue : MQueue;
+}
+
 cl_int MemCpyCommandHost::enqueueImp() {
-  QueueImplPtr Queue = MQueue->is_host() ? MSrcQueue : MQueue;
+  const QueueImplPtr &Queue = getWorkerQueue();
   std::vector<cl_event> RawEvents =
       Command::prepareEvents(detail::getSyclObjImpl(Queue->get_context()));
 
   cl_event &Event = MEvent->getHandleRef();
-  // Omit copying if mode is discard one.
+  // Omit copying if mode is discard one or the memory is copied back to
+  // itself, e.g. the host allocation uses the user pointer.
   // TODO: Handle this at the graph building time by, for example, creating
   // empty node instead of memcpy.
   if (MDstReq.MAccessMode == access::mode::discard_read_write ||
-      MDstReq.MAccessMode == access::mode::discard_write) {
+      MDstReq.MAccessMode == access::mode::discard_write ||
+      MSrcAlloca->getMemAllocation() == MDstAcc->MData) {
 
     if (!RawEvents.empty()) {
       if (Queue->is_host()) {
-        CHECK_OCL_CODE(clWaitForEvents(RawEvents.size(), &RawEvents[0]));
+        CHECK_OCL_CODE(PI_TRACED(clWaitForEvents)(RawEvents.size(),
+                                                  &RawEvents[0]));
       } else {
-        CHECK_OCL_CODE(clEnqueueMarkerWithWaitList(
+        CHECK_OCL_CODE(PI_TRACED(clEnqueueMarkerWithWaitList)(
             Queue->getHandleRef(), RawEvents.size(), &RawEvents[0], &Event));
       }
     }
@@ -327,35 +401,76 @@ cl_int ExecCGCommand::enqueueImp() {
                         Event);
     return CL_SUCCESS;
   }
+  case CG::CGTYPE::COPY_USM: {
+    CGCopyUSM *Copy = (CGCopyUSM *)MCommandGroup.get();
+    MemoryManager::copy_usm(Copy->getSrc(), MQueue, Copy->getLength(),
+                            Copy->getDst(), std::move(RawEvents), Event);
+    return CL_SUCCESS;
+  }
+  case CG::CGTYPE::FILL_USM: {
+    CGFillUSM *Fill = (CGFillUSM *)MCommandGroup.get();
+    MemoryManager::fill_usm(Fill->getDst(), MQueue, Fill->getLength(),
+                            Fill->getFill(), std::move(RawEvents), Event);
+    return CL_SUCCESS;
+  }
   case CG::CGTYPE::KERNEL: {
     CGExecKernel *ExecKernel = (CGExecKernel *)MCommandGroup.get();
 
     NDRDescT &NDRDesc = ExecKernel->MNDRDesc;
 
     if (MQueue->is_host()) {
-      for (ArgDesc &Arg : ExecKernel->MArgs)
+      // The host memory of a local accessor is shared by all work-groups, so
+      // kernels using them can't run the groups concurrently.
+      bool IsParallel = true;
+      for (ArgDesc &Arg : ExecKernel->MArgs) {
         if (kernel_param_kind_t::kind_accessor == Arg.MType) {
           Requirement *Req = (Requirement *)(Arg.MPtr);
           AllocaCommand *AllocaCmd = getAllocaForReq(Req);
           Req->MData = AllocaCmd->getMemAllocation();
-        }
+        } else if (kernel_param_kind_t::kind_std_layout == Arg.MType &&
+                   nullptr == Arg.MPtr)
+          IsParallel = false;
+      }
       if (!RawEvents.empty())
-        CHECK_OCL_CODE(clWaitForEvents(RawEvents.size(), &RawEvents[0]));
-      ExecKernel->MHostKernel->call(NDRDesc);
+        CHECK_OCL_CODE(PI_TRACED(clWaitForEvents)(RawEvents.size(),
+                                                  &RawEvents[0]));
+      ExecKernel->MHostKernel->call(NDRDesc, IsParallel);
       return CL_SUCCESS;
     }
 
     // Run OpenCL kernel
     sycl::context Context = MQueue->get_context();
     cl_kernel Kernel = nullptr;
+    std::unique_lock<std::mutex> Lock;
+    // Gives the kernel object back to the program manager once the arguments
+    // are set and the kernel is enqueued, also if any of them fails.
+    struct KernelReleaser {
+      ~KernelReleaser() {
+        if (MKernel)
+          ProgramManager::getInstance().releaseKernel(MKernel);
+      }
+      cl_kernel MKernel;
+    } Releaser{nullptr};
 
     if (nullptr != ExecKernel->MSyclKernel) {
       assert(ExecKernel->MSyclKernel->get_context() == Context);
       Kernel = ExecKernel->MSyclKernel->getHandleRef();
-    } else
-      Kernel = detail::ProgramManager::getInstance().getOrCreateKernel(
-          ExecKernel->MOSModuleHandle, Context, ExecKernel->MKernelName);
+      // Commands sharing a user provided cl_kernel can be enqueued from
+      // different threads, while OpenCL requires the arguments of a kernel
+      // object not to be set concurrently. Keep arguments setting and the
+      // enqueue together.
+      static std::mutex KernelArgsMutex;
+      Lock = std::unique_lock<std::mutex>(KernelArgsMutex);
+    } else {
+      // The kernel object is not used by anyone else until it is released.
+      Kernel = detail::ProgramManager::getInstance().acquireKernel(
+          ExecKernel->MOSModuleHandle, Context, ExecKernel->MKernelName,
+          ExecKernel->getSpecConstants());
+      Releaser.MKernel = Kernel;
+    }
 
+    USMDispatcher &USMDispatch =
+        detail::getSyclObjImpl(Context)->getUSMDispatch();
     for (ArgDesc &Arg : ExecKernel->MArgs) {
       switch (Arg.MType) {
       case kernel_param_kind_t::kind_accessor: {
@@ -364,11 +479,13 @@ cl_int ExecCGCommand::enqueueImp() {
         cl_mem MemArg = (cl_mem)AllocaCmd->getMemAllocation();
 
         CHECK_OCL_CODE(
-            clSetKernelArg(Kernel, Arg.MIndex, sizeof(cl_mem), &MemArg));
+            PI_TRACED(clSetKernelArg)(Kernel, Arg.MIndex, sizeof(cl_mem),
+                                      &MemArg));
         break;
       }
       case kernel_param_kind_t::kind_std_layout: {
-        CHECK_OCL_CODE(clSetKernelArg(Kernel, Arg.MIndex, Arg.MSize, Arg.MPtr));
+        CHECK_OCL_CODE(PI_TRACED(clSetKernelArg)(Kernel, Arg.MIndex, Arg.MSize,
+                                                 Arg.MPtr));
         break;
       }
       case kernel_param_kind_t::kind_sampler: {
@@ -376,16 +493,24 @@ cl_int ExecCGCommand::enqueueImp() {
         cl_sampler CLSampler =
             detail::getSyclObjImpl(*SamplerPtr)->getOrCreateSampler(Context);
         CHECK_OCL_CODE(
-            clSetKernelArg(Kernel, Arg.MIndex, sizeof(cl_sampler), &CLSampler));
+            PI_TRACED(clSetKernelArg)(Kernel, Arg.MIndex, sizeof(cl_sampler),
+                                      &CLSampler));
+        break;
+      }
+      case kernel_param_kind_t::kind_pointer: {
+        USMDispatch.setKernelArgPointer(Kernel, Arg.MIndex,
+                                        *(void **)Arg.MPtr);
         break;
       }
       default:
         assert(!"Unhandled");
       }
     }
+    // The kernel may get USM pointers inside its arguments as well.
+    USMDispatch.setKernelIndirectAccess(Kernel);
 
     cl_int Error = CL_SUCCESS;
-    Error = clEnqueueNDRangeKernel(
+    Error = PI_TRACED(clEnqueueNDRangeKernel)(
         MQueue->getHandleRef(), Kernel, NDRDesc.Dims, &NDRDesc.GlobalOffset[0],
         &NDRDesc.GlobalSize[0],
         NDRDesc.LocalSize[0] ? &NDRDesc.LocalSize[0] : nullptr,
@@ -7,38 +7,92 @@
 //===----------------------------------------------------------------------===//
 
 #include <CL/sycl/access/access.hpp>
+#include <CL/sycl/detail/context_impl.hpp>
 #include <CL/sycl/detail/event_impl.hpp>
 #include <CL/sycl/detail/memory_manager.hpp>
 #include <CL/sycl/detail/queue_impl.hpp>
 #include <CL/sycl/detail/scheduler/scheduler.hpp>
 #include <CL/sycl/exception.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace cl {
 namespace sycl {
 namespace detail {
 
+// Returns the range of bytes [first, second) of the memory object which
+// contains all the elements accessed through the requirement.
+static std::pair<size_t, size_t> getByteRange(const Requirement *Req) {
+  size_t First = 0;
+  size_t Last = 0;
+  for (unsigned int I = 0; I < Req->MDims; ++I) {
+    First = First * Req->MMemoryRange[I] + Req->MOffset[I];
+    Last = Last * Req->MMemoryRange[I] + Req->MOffset[I] +
+           Req->MAccessRange[I] - 1;
+  }
+  return {First * Req->MElemSize, (Last + 1) * Req->MElemSize};
+}
+
 // The function check whether two requirements overlaps or not. This
 // information can be used to prove that executing two kernels that
 // work on different parts of the memory object in parallel is legal.
 static bool doOverlap(const Requirement *LHS, const Requirement *RHS) {
-  // TODO: Implement check for one dimensional case only. It will be
-  // enough for most of the cases because 2d and 3d sub-buffers cannot
-  // be mapped to OpenCL's ones.
-  return true;
+  for (unsigned int I = 0; I < LHS->MDims; ++I)
+    if (LHS->MAccessRange[I] == 0)
+      return false;
+  for (unsigned int I = 0; I < RHS->MDims; ++I)
+    if (RHS->MAccessRange[I] == 0)
+      return false;
+
+  // Requirements which view the memory object the same way (sub-buffers and
+  // ranged accessors of one buffer) overlap only if they overlap in every
+  // dimension.
+  if (LHS->MDims == RHS->MDims && LHS->MElemSize == RHS->MElemSize &&
+      LHS->MMemoryRange == RHS->MMemoryRange) {
+    for (unsigned int I = 0; I < LHS->MDims; ++I)
+      if (LHS->MOffset[I] + LHS->MAccessRange[I] <= RHS->MOffset[I] ||
+          RHS->MOffset[I] + RHS->MAccessRange[I] <= LHS->MOffset[I])
+        return false;
+    return true;
+  }
+
+  // Otherwise (e.g. reinterpreted buffers) compare the linear byte ranges,
+  // which is conservative for multi-dimensional requirements.
+  const std::pair<size_t, size_t> LHSBytes = getByteRange(LHS);
+  const std::pair<size_t, size_t> RHSBytes = getByteRange(RHS);
+  return LHSBytes.first < RHSBytes.second && RHSBytes.first < LHSBytes.second;
+}
+
+// Returns true if the commands of the two queues can work with the same memory
+// allocations. Distinct SYCL contexts can wrap one OpenCL context, e.g. the
+// ones created with the interoperability constructor, their devices then
+// share the memory objects and need no copies between them.
+static bool isSameCtx(const QueueImplPtr &LHS, const QueueImplPtr &RHS) {
+  const ContextImplPtr LHSContext = getSyclObjImpl(LHS->get_context());
+  const ContextImplPtr RHSContext = getSyclObjImpl(RHS->get_context());
+  if (LHSContext == RHSContext)
+    return true;
+  if (LHSContext->is_host() || RHSContext->is_host())
+    return false;
+  return LHSContext->getHandleRef() == RHSContext->getHandleRef();
 }
 
 // Returns record for the memory objects passed, nullptr if doesn't exist.
 Scheduler::GraphBuilder::MemObjRecord *
 Scheduler::GraphBuilder::getMemObjRecord(SYCLMemObjT *MemObject) {
-  const auto It = std::find_if(MMemObjRecords.begin(), MMemObjRecords.end(),
-                               [MemObject](const MemObjRecord &Record) {
-                                 return Record.MMemObj == MemObject;
-                               });
-  return (MMemObjRecords.end() != It) ? &*It : nullptr;
+  std::lock_guard<std::mutex> Lock(MMemObjRecordsMutex);
+  const auto It = MMemObjRecords.find(MemObject);
+  return (MMemObjRecords.end() != It) ? It->second.get() : nullptr;
 }
 
 // Returns record for the memory object requirement refers to, if doesn't
@@ -47,9 +101,10 @@ Scheduler::GraphBuilder::MemObjRecord *
 Scheduler::GraphBuilder::getOrInsertMemObjRecord(const QueueImplPtr &Queue,
                                                  Requirement *Req) {
   SYCLMemObjT *MemObject = Req->MSYCLMemObj;
-  Scheduler::GraphBuilder::MemObjRecord *Record = getMemObjRecord(MemObject);
-  if (nullptr != Record)
-    return Record;
+  std::lock_guard<std::mutex> Lock(MMemObjRecordsMutex);
+  std::unique_ptr<MemObjRecord> &Record = MMemObjRecords[MemObject];
+  if (Record)
+    return Record.get();
 
   // Construct requirement which describes full buffer because we allocate
   // only full-sized memory objects.
@@ -58,14 +113,27 @@ Scheduler::GraphBuilder::getOrInsertMemObjRecord(const QueueImplPtr &Queue,
                         MemObject, Req->MDims, Req->MElemSize);
 
   AllocaCommand *AllocaCmd = new AllocaCommand(Queue, std::move(AllocaReq));
-  MemObjRecord NewRecord{MemObject,
-                         /*WriteLeafs*/ {AllocaCmd},
-                         /*ReadLeafs*/ {},
-                         {AllocaCmd},
-                         false};
+  Record.reset(new MemObjRecord{MemObject,
+                                /*AllocaCommands*/ {AllocaCmd},
+                                /*ReadLeafs*/ {},
+                                /*WriteLeafs*/ {AllocaCmd},
+                                /*MemModified*/ false});
+  return Record.get();
+}
 
-  MMemObjRecords.push_back(std::move(NewRecord));
-  return &MMemObjRecords.back();
+std::vector<std::unique_lock<std::mutex>>
+Scheduler::GraphBuilder::lockMemObjRecords(
+    const QueueImplPtr &Queue, const std::vector<Requirement *> &Reqs) {
+  std::vector<MemObjRecord *> Records;
+  for (Requirement *Req : Reqs)
+    Records.push_back(getOrInsertMemObjRecord(Queue, Req));
+  std::sort(Records.begin(), Records.end());
+  Records.erase(std::unique(Records.begin(), Records.end()), Records.end());
+
+  std::vector<std::unique_lock<std::mutex>> Locks;
+  for (MemObjRecord *Record : Records)
+    Locks.emplace_back(Record->MMutex);
+  return Locks;
 }
 
 // Helper function which removes all values in Cmds from Leafs
@@ -202,7 +270,7 @@ Command *Scheduler::GraphBuilder::addHostAccessor(Requirement *Req,
   Req->BlockingEvent->setContextImpl(SrcContext);
   cl_event &CLEvent = Req->BlockingEvent->getHandleRef();
   cl_int Error = CL_SUCCESS;
-  CLEvent = clCreateUserEvent(SrcContext->getHandleRef(), &Error);
+  CLEvent = PI_TRACED(clCreateUserEvent)(SrcContext->getHandleRef(), &Error);
   CHECK_OCL_CODE(Error);
 
   // In case of memory is 1 dimensional and located on OpenCL device we
@@ -394,12 +462,13 @@ Command *Scheduler::GraphBuilder::addCGUpdateHost(
 // command. There are several rules used:
 //
 // 1. New and examined commands only read -> can bypass
-// 2. New and examined commands has non-overlapping requirements -> can bypass
+// 2. New and examined commands has non-overlapping requirements -> can bypass,
+//    so writers of disjoint parts of one memory object don't depend on each
+//    other
 // 3. New and examined commands has different contexts -> cannot bypass
 std::set<Command *>
 Scheduler::GraphBuilder::findDepsForReq(MemObjRecord *Record, Requirement *Req,
                                         QueueImplPtr Queue) {
-  sycl::context Context = Queue->get_context();
   std::set<Command *> RetDeps;
   std::set<Command *> Visited;
   const bool ReadOnlyReq = Req->MAccessMode == access::mode::read;
@@ -429,12 +498,15 @@ Scheduler::GraphBuilder::findDepsForReq(MemObjRecord *Record, Requirement *Req,
       CanBypassDep |=
           Dep.MReq->MAccessMode == access::mode::read && ReadOnlyReq;
 
-      // If not overlap
-      CanBypassDep |= !doOverlap(Dep.MReq, Req);
+      // If not overlap. The allocation is never bypassed, every command
+      // needs it.
+      CanBypassDep |= DepCmd->getType() != Command::ALLOCA &&
+                      !doOverlap(Dep.MReq, Req);
 
       // Going through copying memory between contexts is not supported.
+      CanBypassDep &= isSameCtx(Queue, DepCmd->getQueue());
       if (Dep.MDepCommand)
-        CanBypassDep &= Context == Dep.MDepCommand->getQueue()->get_context();
+        CanBypassDep &= isSameCtx(Queue, Dep.MDepCommand->getQueue());
 
       if (!CanBypassDep) {
         RetDeps.insert(DepCmd);
@@ -444,7 +516,7 @@ Scheduler::GraphBuilder::findDepsForReq(MemObjRecord *Record, Requirement *Req,
         break;
       }
 
-      if (Visited.insert(Dep.MDepCommand).second)
+      if (Dep.MDepCommand && Visited.insert(Dep.MDepCommand).second)
         NewAnalyze.push_back(Dep.MDepCommand);
     }
     ToAnalyze.insert(ToAnalyze.end(), NewAnalyze.begin(), NewAnalyze.end());
@@ -457,7 +529,7 @@ AllocaCommand *Scheduler::GraphBuilder::findAllocaForReq(MemObjRecord *Record,
                                                          Requirement *Req,
                                                          QueueImplPtr Queue) {
   auto IsSuitableAlloca = [&Queue](const AllocaCommand *AllocaCmd) {
-    return AllocaCmd->getQueue()->get_context() == Queue->get_context();
+    return isSameCtx(AllocaCmd->getQueue(), Queue);
   };
   const auto It = std::find_if(Record->MAllocaCommands.begin(),
                                Record->MAllocaCommands.end(), IsSuitableAlloca);
@@ -483,11 +555,15 @@ Command *
 Scheduler::GraphBuilder::addCG(std::unique_ptr<detail::CG> CommandGroup,
                                QueueImplPtr Queue) {
   std::vector<Requirement *> Reqs = CommandGroup->getRequirements();
+  const std::vector<EventImplPtr> &Events = CommandGroup->getEvents();
   std::unique_ptr<ExecCGCommand> NewCmd(
       new ExecCGCommand(std::move(CommandGroup), Queue));
   if (!NewCmd)
     throw runtime_error("Out of host memory");
 
+  for (const EventImplPtr &Event : Events)
+    NewCmd->addDep(Event);
+
   for (Requirement *Req : Reqs) {
     MemObjRecord *Record = getOrInsertMemObjRecord(Queue, Req);
     markModifiedIfWrite(Record, Req);
@@ -496,7 +572,7 @@ Scheduler::GraphBuilder::addCG(std::unique_ptr<detail::CG> CommandGroup,
     // If contexts of dependency and new command don't match insert
     // memcpy command.
     for (const Command *Dep : Deps)
-      if (Dep->getQueue()->get_context() != Queue->get_context()) {
+      if (!isSameCtx(Dep->getQueue(), Queue)) {
         // Cannot directly copy memory from OpenCL device to OpenCL device -
         // create to copies device->host and host->device.
         if (!Dep->getQueue()->is_host() && !Queue->is_host())
@@ -526,16 +602,269 @@ Scheduler::GraphBuilder::addCG(std::unique_ptr<detail::CG> CommandGroup,
   return NewCmd.release();
 }
 
+// Returns true if all the elements accessed through Inner are accessed
+// through Outer as well.
+static bool doContain(const Requirement *Outer, const Requirement *Inner) {
+  if (Outer->MDims == Inner->MDims && Outer->MElemSize == Inner->MElemSize &&
+      Outer->MMemoryRange == Inner->MMemoryRange) {
+    for (unsigned int I = 0; I < Outer->MDims; ++I)
+      if (Inner->MOffset[I] < Outer->MOffset[I] ||
+          Inner->MOffset[I] + Inner->MAccessRange[I] >
+              Outer->MOffset[I] + Outer->MAccessRange[I])
+        return false;
+    return true;
+  }
+  // Requirements viewing the memory differently are compared only if Outer
+  // covers the whole memory object.
+  for (unsigned int I = 0; I < Outer->MDims; ++I)
+    if (Outer->MOffset[I] != 0 ||
+        Outer->MAccessRange[I] != Outer->MMemoryRange[I])
+      return false;
+  return true;
+}
+
+static bool isDiscardMode(access::mode Mode) {
+  return Mode == access::mode::discard_write ||
+         Mode == access::mode::discard_read_write;
+}
+
+// Returns true if the copy Cmd makes the destination of Copy hold the same
+// data as its source in the range Copy needs, i.e. Cmd copies between the same
+// two allocations in either direction.
+static bool isEqualizingCopy(const Command *Cmd, const MemCpyCommand *Copy) {
+  const MemCpyCommand *Other = dynamic_cast<const MemCpyCommand *>(Cmd);
+  if (!Other || isDiscardMode(Other->MDstReq.MAccessMode))
+    return false;
+  // The user can modify the memory of the host accessor the copy is done
+  // for, the copy back to the device is needed then.
+  if (Other->MAccToUpdate && Other->MDstReq.MAccessMode != access::mode::read)
+    return false;
+  const bool SameDirection = Other->MSrcAlloca == Copy->MSrcAlloca &&
+                             Other->MDstAlloca == Copy->MDstAlloca;
+  const bool Reverse = Other->MSrcAlloca == Copy->MDstAlloca &&
+                       Other->MDstAlloca == Copy->MSrcAlloca;
+  return (SameDirection || Reverse) &&
+         doContain(&Other->MDstReq, &Copy->MDstReq);
+}
+
+// Returns true if Cmd only reads the memory object.
+static bool isReadOnly(const Command *Cmd, const SYCLMemObjT *MemObj) {
+  for (const DepDesc &Dep : Cmd->MDeps)
+    if (Dep.MReq->MSYCLMemObj == MemObj &&
+        Dep.MReq->MAccessMode != access::mode::read)
+      return false;
+  return true;
+}
+
+// The copy depends on the latest commands working with the memory object in
+// both contexts. If all of them only read it, except for copies between the
+// same two allocations, nothing has modified either allocation since the last
+// such copy and the destination is already up to date.
+static bool isRedundantCopy(const MemCpyCommand *Copy) {
+  if (isDiscardMode(Copy->MDstReq.MAccessMode))
+    return false;
+  const SYCLMemObjT *MemObj = Copy->MDstReq.MSYCLMemObj;
+  bool HasEqualizingCopy = false;
+  for (const DepDesc &Dep : Copy->MDeps) {
+    if (!Dep.MDepCommand)
+      continue;
+    if (isEqualizingCopy(Dep.MDepCommand, Copy))
+      HasEqualizingCopy = true;
+    else if (!isReadOnly(Dep.MDepCommand, MemObj))
+      return false;
+  }
+  return HasEqualizingCopy;
+}
+
+static const char *getAccessModeName(access::mode Mode) {
+  switch (Mode) {
+  case access::mode::read:
+    return "read";
+  case access::mode::write:
+    return "write";
+  case access::mode::read_write:
+    return "read_write";
+  case access::mode::discard_write:
+    return "discard_write";
+  case access::mode::discard_read_write:
+    return "discard_read_write";
+  case access::mode::atomic:
+    return "atomic";
+  }
+  return "unknown";
+}
+
+static void printGraphAsDot(const std::string &FileName,
+                            const std::vector<Command *> &Cmds) {
+  std::ofstream Stream(FileName);
+  Stream << "strict digraph {\n";
+  for (const Command *Cmd : Cmds) {
+    const MemCpyCommand *Copy = dynamic_cast<const MemCpyCommand *>(Cmd);
+    Stream << "  \"" << Cmd << "\" [label=\""
+           << Command::getTypeName(Cmd->getType()) << "\\n"
+           << (Cmd->getQueue()->is_host() ? "host" : "device")
+           << (Copy && Copy->isRedundant() ? "\\nredundant" : "") << "\""
+           << (Cmd->isEnqueued() ? ", style=dashed" : "") << "];\n";
+    for (const DepDesc &Dep : Cmd->MDeps)
+      if (Dep.MDepCommand)
+        Stream << "  \"" << Cmd << "\" -> \"" << Dep.MDepCommand
+               << "\" [label=\"" << Dep.MReq->MSYCLMemObj << "\\n"
+               << getAccessModeName(Dep.MReq->MAccessMode) << "\"];\n";
+  }
+  Stream << "}\n";
+}
+
+static bool isGraphPrintingEnabled() {
+  static const bool Enabled = std::getenv("SYCL_PRINT_EXECUTION_GRAPH");
+  return Enabled;
+}
+
+static bool isFusionReportingEnabled() {
+  static const bool Enabled = std::getenv("SYCL_REPORT_KERNEL_FUSION");
+  return Enabled;
+}
+
+static const CGExecKernel *getKernelCG(const Command *Cmd) {
+  const ExecCGCommand *Exec = dynamic_cast<const ExecCGCommand *>(Cmd);
+  if (!Exec || Exec->getCG().getType() != CG::KERNEL)
+    return nullptr;
+  return static_cast<const CGExecKernel *>(&Exec->getCG());
+}
+
+static bool isSameRange(const NDRDescT &LHS, const NDRDescT &RHS) {
+  if (LHS.Dims != RHS.Dims)
+    return false;
+  for (int I = 0; I < 3; ++I)
+    if (LHS.GlobalSize[I] != RHS.GlobalSize[I] ||
+        LHS.LocalSize[I] != RHS.LocalSize[I] ||
+        LHS.GlobalOffset[I] != RHS.GlobalOffset[I])
+      return false;
+  return true;
+}
+
+// Returns true if Req accesses all of its memory object, without atomics.
+static bool isWholeMemObjAccess(const Requirement *Req) {
+  if (Req->MAccessMode == access::mode::atomic)
+    return false;
+  for (unsigned int I = 0; I < Req->MDims; ++I)
+    if (Req->MOffset[I] != 0 || Req->MAccessRange[I] != Req->MMemoryRange[I])
+      return false;
+  return true;
+}
+
+// Returns the kernel Cmd could be fused with: the only command Cmd waits for,
+// other than allocations, is a kernel of the same queue over the same range,
+// and both access the memory objects they share as a whole. Whether the
+// kernels are element-wise is only known from their code, so these are
+// candidates for the user to check.
+static const Command *getFusionCandidate(const Command *Cmd) {
+  const CGExecKernel *Kernel = getKernelCG(Cmd);
+  if (!Kernel || !Kernel->MStreams.empty())
+    return nullptr;
+  const Command *Prev = nullptr;
+  for (const DepDesc &Dep : Cmd->MDeps) {
+    if (!Dep.MDepCommand || Dep.MDepCommand->getType() == Command::ALLOCA)
+      continue;
+    if (Prev && Prev != Dep.MDepCommand)
+      return nullptr;
+    Prev = Dep.MDepCommand;
+  }
+  const CGExecKernel *PrevKernel = getKernelCG(Prev);
+  if (!PrevKernel || !PrevKernel->MStreams.empty() ||
+      Prev->getQueue() != Cmd->getQueue() ||
+      !isSameRange(PrevKernel->MNDRDesc, Kernel->MNDRDesc))
+    return nullptr;
+
+  const std::vector<Requirement *> PrevReqs = PrevKernel->getRequirements();
+  for (const DepDesc &Dep : Cmd->MDeps) {
+    if (Dep.MDepCommand != Prev)
+      continue;
+    if (!isWholeMemObjAccess(Dep.MReq))
+      return nullptr;
+    for (const Requirement *PrevReq : PrevReqs)
+      if (PrevReq->MSYCLMemObj == Dep.MReq->MSYCLMemObj &&
+          !isWholeMemObjAccess(PrevReq))
+        return nullptr;
+  }
+  return Prev;
+}
+
+// Reports each pair of kernels which could be fused once.
+static void reportFusionCandidate(const Command *Cmd) {
+  const Command *Prev = getFusionCandidate(Cmd);
+  if (!Prev)
+    return;
+  const std::string &Name = getKernelCG(Cmd)->MKernelName;
+  const std::string &PrevName = getKernelCG(Prev)->MKernelName;
+
+  static std::mutex ReportedMutex;
+  static std::set<std::pair<std::string, std::string>> Reported;
+  std::lock_guard<std::mutex> Lock(ReportedMutex);
+  if (!Reported.emplace(PrevName, Name).second)
+    return;
+  std::cerr << "SYCL: kernels '" << PrevName << "' and '" << Name
+            << "' run one after the other over the same range with "
+               "whole-buffer accessors and may be fused\n";
+}
+
+void Scheduler::GraphBuilder::optimize() {
+  std::vector<MemObjRecord *> Records;
+  {
+    std::lock_guard<std::mutex> Lock(MMemObjRecordsMutex);
+    for (auto &Record : MMemObjRecords)
+      Records.push_back(Record.second.get());
+  }
+  for (MemObjRecord *Record : Records) {
+    std::lock_guard<std::mutex> Lock(Record->MMutex);
+    for (Command *Cmd : Record->MReadLeafs)
+      optimize(Cmd->getEvent());
+    for (Command *Cmd : Record->MWriteLeafs)
+      optimize(Cmd->getEvent());
+  }
+}
+
+void Scheduler::GraphBuilder::optimize(EventImplPtr Event) {
+  Command *Root = static_cast<Command *>(Event->getCommand());
+  if (!Root || Root->isEnqueued())
+    return;
+
+  // The enqueued commands can't be changed anymore and so are their
+  // dependencies, only the subgraph in front of them is collected.
+  std::vector<Command *> Cmds{Root};
+  std::set<Command *> Visited{Root};
+  for (size_t I = 0; I < Cmds.size(); ++I)
+    for (const DepDesc &Dep : Cmds[I]->MDeps)
+      if (Dep.MDepCommand && !Dep.MDepCommand->isEnqueued() &&
+          Visited.insert(Dep.MDepCommand).second)
+        Cmds.push_back(Dep.MDepCommand);
+
+  static std::atomic<size_t> GraphCounter{0};
+  const std::string FilePrefix =
+      isGraphPrintingEnabled()
+          ? "graph_" + std::to_string(GraphCounter.fetch_add(1)) + "_"
+          : std::string();
+  if (isGraphPrintingEnabled())
+    printGraphAsDot(FilePrefix + "before_optimize.dot", Cmds);
+
+  for (Command *Cmd : Cmds)
+    if (MemCpyCommand *Copy = dynamic_cast<MemCpyCommand *>(Cmd))
+      if (!Copy->isRedundant() && isRedundantCopy(Copy))
+        Copy->markRedundant();
+
+  if (isFusionReportingEnabled())
+    reportFusionCandidate(Root);
+
+  if (isGraphPrintingEnabled())
+    printGraphAsDot(FilePrefix + "after_optimize.dot", Cmds);
+}
+
 void Scheduler::GraphBuilder::cleanupCommands(bool CleanupReleaseCommands) {
   // TODO: Implement.
 }
 
 void Scheduler::GraphBuilder::removeRecordForMemObj(SYCLMemObjT *MemObject) {
-  const auto It = std::find_if(MMemObjRecords.begin(), MMemObjRecords.end(),
-                               [MemObject](const MemObjRecord &Record) {
-                                 return Record.MMemObj == MemObject;
-                               });
-  MMemObjRecords.erase(It);
+  std::lock_guard<std::mutex> Lock(MMemObjRecordsMutex);
+  MMemObjRecords.erase(MemObject);
 }
 
 } // namespace detail
@@ -10,7 +10,11 @@
 #include <CL/sycl/detail/queue_impl.hpp>
 #include <CL/sycl/detail/scheduler/scheduler.hpp>
 
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace cl {
@@ -42,7 +46,68 @@ void Scheduler::GraphProcessor::waitForEvent(EventImplPtr Event) {
 
   cl_event &CLEvent = Cmd->getEvent()->getHandleRef();
   if (CLEvent)
-    CHECK_OCL_CODE(clWaitForEvents(1, &CLEvent));
+    CHECK_OCL_CODE(PI_TRACED(clWaitForEvents)(1, &CLEvent));
+}
+
+// Owns the background thread enqueueing commands submitted in the
+// asynchronous mode. The commands are processed in the submission order.
+class Scheduler::GraphProcessor::EnqueueWorker {
+public:
+  EnqueueWorker() : MThread(&EnqueueWorker::run, this) {}
+
+  // Enqueues the rest of the pending commands and stops the thread.
+  ~EnqueueWorker() {
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      MStop = true;
+    }
+    MCondVar.notify_one();
+    MThread.join();
+  }
+
+  void push(Command *Cmd) {
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      MPendingCommands.push_back(Cmd);
+    }
+    MCondVar.notify_one();
+  }
+
+private:
+  void run() {
+    std::unique_lock<std::mutex> Lock(MMutex);
+    while (true) {
+      MCondVar.wait(Lock,
+                    [this] { return MStop || !MPendingCommands.empty(); });
+      if (MPendingCommands.empty())
+        return;
+      Command *Cmd = MPendingCommands.front();
+      MPendingCommands.pop_front();
+
+      Lock.unlock();
+      try {
+        // A failed command stays not enqueued, it will be retried and the
+        // error reported by whoever needs the command to be enqueued.
+        enqueueCommand(Cmd);
+      } catch (...) {
+      }
+      Lock.lock();
+    }
+  }
+
+  std::mutex MMutex;
+  std::condition_variable MCondVar;
+  std::deque<Command *> MPendingCommands;
+  bool MStop = false;
+  // Must be the last member, the thread uses all the others.
+  std::thread MThread;
+};
+
+void Scheduler::GraphProcessor::enqueueCommandAsync(Command *Cmd) {
+  // Created on the first use, so that no thread is started in the synchronous
+  // mode.
+  static EnqueueWorker Worker;
+  Worker.push(Cmd);
 }
 
 Command *Scheduler::GraphProcessor::enqueueCommand(Command *Cmd) {
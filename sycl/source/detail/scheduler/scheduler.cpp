@@ -7,13 +7,17 @@
 //===----------------------------------------------------------------------===//
 
 #include "CL/sycl/detail/sycl_mem_obj.hpp"
+#include <CL/sycl/detail/event_impl.hpp>
 #include <CL/sycl/detail/queue_impl.hpp>
 #include <CL/sycl/detail/scheduler/scheduler.hpp>
 #include <CL/sycl/device_selector.hpp>
 
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace cl {
@@ -52,21 +56,49 @@ EventImplPtr Scheduler::addCG(std::unique_ptr<detail::CG> CommandGroup,
                               QueueImplPtr Queue) {
   Command *NewCmd = nullptr;
   const bool IsKernel = CommandGroup->getType() == CG::KERNEL;
-  {
-    std::lock_guard<std::mutex> Lock(MGraphLock);
+  const bool IsUpdateHost = CommandGroup->getType() == CG::UPDATE_HOST;
+  const std::vector<EventImplPtr> Events = CommandGroup->getEvents();
+  if (CommandGroup->getRequirements().empty() && !IsUpdateHost) {
+    // A command group working with USM pointers only uses no memory object,
+    // its dependencies are the explicit ones and there is nothing to track
+    // in the graph.
+    NewCmd = new ExecCGCommand(std::move(CommandGroup), std::move(Queue));
+    for (const EventImplPtr &Event : Events)
+      NewCmd->addDep(Event);
+  } else {
+    // Only the records of the memory objects used by the command group are
+    // locked, command groups using other memory objects don't wait.
+    std::vector<std::unique_lock<std::mutex>> Locks =
+        MGraphBuilder.lockMemObjRecords(IsUpdateHost ? DefaultHostQueue : Queue,
+                                        CommandGroup->getRequirements());
 
-    switch (CommandGroup->getType()) {
-    case CG::UPDATE_HOST:
+    if (IsUpdateHost)
       NewCmd = MGraphBuilder.addCGUpdateHost(std::move(CommandGroup),
                                              DefaultHostQueue);
-      break;
-    default:
+    else
       NewCmd = MGraphBuilder.addCG(std::move(CommandGroup), std::move(Queue));
-    }
+    if (MOptimizeGraph)
+      MGraphBuilder.optimize(NewCmd->getEvent());
+    MGraphBuilder.cleanupCommands();
+  }
 
-    // TODO: Check if lazy mode.
+  // The graph processor doesn't modify the graph, so the command and its
+  // dependencies are enqueued without the records locked.
+  // TODO: Check if lazy mode.
+  if (MAsyncEnqueue) {
+    // The commands of the explicit dependencies were submitted earlier, the
+    // worker enqueues them first.
+    GraphProcessor::enqueueCommandAsync(NewCmd);
+  } else {
+    // The explicit dependencies are not in the graph, their commands must be
+    // enqueued for their events to be valid.
+    for (const EventImplPtr &Event : Events) {
+      Command *FailedCommand =
+          GraphProcessor::enqueueCommand((Command *)Event->getCommand());
+      if (FailedCommand)
+        throw runtime_error("Enqueue process failed.");
+    }
     Command *FailedCommand = GraphProcessor::enqueueCommand(NewCmd);
-    MGraphBuilder.cleanupCommands();
     if (FailedCommand)
       // TODO: Reschedule commands.
       throw runtime_error("Enqueue process failed.");
@@ -79,7 +111,18 @@ EventImplPtr Scheduler::addCG(std::unique_ptr<detail::CG> CommandGroup,
 }
 
 EventImplPtr Scheduler::addCopyBack(Requirement *Req) {
-  Command *NewCmd = MGraphBuilder.addCopyBack(Req);
+  GraphBuilder::MemObjRecord *Record =
+      MGraphBuilder.getMemObjRecord(Req->MSYCLMemObj);
+  if (!Record)
+    return nullptr;
+
+  Command *NewCmd = nullptr;
+  {
+    std::lock_guard<std::mutex> Lock(Record->MMutex);
+    NewCmd = MGraphBuilder.addCopyBack(Req);
+    if (NewCmd && MOptimizeGraph)
+      MGraphBuilder.optimize(NewCmd->getEvent());
+  }
   // Command was not creted because there were no operations with
   // buffer.
   if (!NewCmd)
@@ -94,9 +137,8 @@ EventImplPtr Scheduler::addCopyBack(Requirement *Req) {
 Scheduler::~Scheduler() {
   // TODO: Make running wait and release on destruction configurable?
   // TODO: Process release commands only?
-  //std::lock_guard<std::mutex> lock(MGraphLock);
-  //for (GraphBuilder::MemObjRecord &Record : MGraphBuilder.MMemObjRecords)
-    //waitForRecordToFinish(&Record);
+  //for (auto &Record : MGraphBuilder.MMemObjRecords)
+    //waitForRecordToFinish(Record.second.get());
   //MGraphBuilder.cleanupCommands([>CleanupReleaseCommands = <] true);
 }
 
@@ -105,34 +147,41 @@ Scheduler &Scheduler::getInstance() {
   return instance;
 }
 
+// Dependencies of a command never change once it is added to the graph, so
+// walking them doesn't require any record to be locked.
 std::vector<EventImplPtr> Scheduler::getWaitList(EventImplPtr Event) {
-  std::lock_guard<std::mutex> lock(MGraphLock);
   return GraphProcessor::getWaitList(std::move(Event));
 }
 
 void Scheduler::waitForEvent(EventImplPtr Event) {
-  std::lock_guard<std::mutex> lock(MGraphLock);
   GraphProcessor::waitForEvent(std::move(Event));
 }
 
 void Scheduler::removeMemoryObject(detail::SYCLMemObjT *MemObj) {
-  std::lock_guard<std::mutex> lock(MGraphLock);
-
   GraphBuilder::MemObjRecord *Record = MGraphBuilder.getMemObjRecord(MemObj);
   if (!Record) {
     assert("No operations were performed on the mem object?");
     return;
   }
-  waitForRecordToFinish(Record);
-  MGraphBuilder.cleanupCommands(/*CleanupReleaseCommands = */ true);
+  {
+    std::lock_guard<std::mutex> Lock(Record->MMutex);
+    waitForRecordToFinish(Record);
+    MGraphBuilder.cleanupCommands(/*CleanupReleaseCommands = */ true);
+  }
+  // The record must not be locked when it is destroyed.
   MGraphBuilder.removeRecordForMemObj(MemObj);
 }
 
 EventImplPtr Scheduler::addHostAccessor(Requirement *Req) {
-  std::lock_guard<std::mutex> lock(MGraphLock);
-
   EventImplPtr RetEvent;
-  Command *NewCmd = MGraphBuilder.addHostAccessor(Req, RetEvent);
+  Command *NewCmd = nullptr;
+  {
+    std::vector<std::unique_lock<std::mutex>> Locks =
+        MGraphBuilder.lockMemObjRecords(DefaultHostQueue, {Req});
+    NewCmd = MGraphBuilder.addHostAccessor(Req, RetEvent);
+    if (NewCmd && MOptimizeGraph)
+      MGraphBuilder.optimize(NewCmd->getEvent());
+  }
 
   if (!NewCmd)
     return nullptr;
@@ -143,7 +192,128 @@ EventImplPtr Scheduler::addHostAccessor(Requirement *Req) {
   return RetEvent;
 }
 
+// Returns the memory objects used by the commands passed.
+static std::vector<SYCLMemObjT *>
+getMemObjects(const std::vector<Command *> &Cmds) {
+  std::vector<SYCLMemObjT *> MemObjs;
+  for (const Command *Cmd : Cmds)
+    for (const DepDesc &Dep : Cmd->MDeps)
+      MemObjs.push_back(Dep.MReq->MSYCLMemObj);
+  std::sort(MemObjs.begin(), MemObjs.end());
+  MemObjs.erase(std::unique(MemObjs.begin(), MemObjs.end()), MemObjs.end());
+  return MemObjs;
+}
+
+void Scheduler::finalizeRecording(RecordedGraph &Graph) {
+  const std::set<Command *> Recorded(Graph.MCommands.begin(),
+                                     Graph.MCommands.end());
+  for (const Command *Cmd : Graph.MCommands) {
+    if (Cmd->getType() != Command::RUN_CG ||
+        static_cast<const ExecCGCommand *>(Cmd)->getCG().getType() !=
+            CG::KERNEL)
+      throw feature_not_supported("Only kernels can be recorded to a command "
+                                  "graph");
+    for (const DepDesc &Dep : Cmd->MDeps) {
+      Command *DepCmd = Dep.MDepCommand;
+      if (!DepCmd || Recorded.count(DepCmd))
+        continue;
+      // A command added by the scheduler in between the recorded ones, e.g. a
+      // memory copy to another context, would be skipped by the replay.
+      for (const DepDesc &DepOfDep : DepCmd->MDeps)
+        if (Recorded.count(DepOfDep.MDepCommand))
+          throw feature_not_supported(
+              "Command graph depends on commands which can't be replayed");
+    }
+  }
+
+  Graph.MLeafs.clear();
+  for (SYCLMemObjT *MemObj : getMemObjects(Graph.MCommands)) {
+    GraphBuilder::MemObjRecord *Record = MGraphBuilder.getMemObjRecord(MemObj);
+    assert(Record && "Recorded command uses unknown memory object");
+    std::lock_guard<std::mutex> Lock(Record->MMutex);
+    Graph.MLeafs.push_back({MemObj, Record->MReadLeafs, Record->MWriteLeafs});
+  }
+}
+
+EventImplPtr Scheduler::replay(RecordedGraph &Graph) {
+  if (Graph.MCommands.empty())
+    return nullptr;
+
+  std::vector<GraphBuilder::MemObjRecord *> Records;
+  for (const RecordedGraph::MemObjLeafs &Leafs : Graph.MLeafs) {
+    GraphBuilder::MemObjRecord *Record =
+        MGraphBuilder.getMemObjRecord(Leafs.MMemObj);
+    if (!Record)
+      throw invalid_object_error(
+          "Memory object used by the command graph was destroyed");
+    Records.push_back(Record);
+  }
+  {
+    // The records are locked in the address order, as lockMemObjRecords
+    // does.
+    std::vector<GraphBuilder::MemObjRecord *> SortedRecords = Records;
+    std::sort(SortedRecords.begin(), SortedRecords.end());
+    std::vector<std::unique_lock<std::mutex>> Locks;
+    for (GraphBuilder::MemObjRecord *Record : SortedRecords)
+      Locks.emplace_back(Record->MMutex);
+
+    // The latest users of each memory object, they may be commands of the
+    // previous replay as well as commands submitted after it.
+    std::unordered_map<SYCLMemObjT *, std::vector<EventImplPtr>> LeafEvents;
+    for (GraphBuilder::MemObjRecord *Record : Records) {
+      std::vector<EventImplPtr> &Events = LeafEvents[Record->MMemObj];
+      for (Command *Cmd : Record->MReadLeafs)
+        Events.push_back(Cmd->getEvent());
+      for (Command *Cmd : Record->MWriteLeafs)
+        Events.push_back(Cmd->getEvent());
+    }
+
+    std::set<Command *> Replayed;
+    for (Command *Cmd : Graph.MCommands) {
+      std::vector<EventImplPtr> DepEvents;
+      std::set<SYCLMemObjT *> ExternalMemObjs;
+      for (const DepDesc &Dep : Cmd->MDeps) {
+        if (Replayed.count(Dep.MDepCommand)) {
+          DepEvents.push_back(Dep.MDepCommand->getEvent());
+          continue;
+        }
+        SYCLMemObjT *MemObj = Dep.MReq->MSYCLMemObj;
+        if (ExternalMemObjs.insert(MemObj).second) {
+          const std::vector<EventImplPtr> &Events = LeafEvents[MemObj];
+          DepEvents.insert(DepEvents.end(), Events.begin(), Events.end());
+        }
+      }
+      Cmd->prepareForReplay(std::move(DepEvents));
+      Replayed.insert(Cmd);
+    }
+
+    // The replayed commands are the latest users of the memory objects now,
+    // the following command groups must depend on them.
+    for (size_t I = 0; I < Records.size(); ++I) {
+      Records[I]->MReadLeafs = Graph.MLeafs[I].MReadLeafs;
+      Records[I]->MWriteLeafs = Graph.MLeafs[I].MWriteLeafs;
+    }
+  }
+
+  // Replays are always enqueued synchronously, so that the kernel arguments
+  // can be changed as soon as replay returns.
+  for (Command *Cmd : Graph.MCommands) {
+    Command *FailedCommand = GraphProcessor::enqueueCommand(Cmd);
+    if (FailedCommand)
+      throw runtime_error("Enqueue process failed.");
+    ExecCGCommand *ExecCmd = static_cast<ExecCGCommand *>(Cmd);
+    if (ExecCmd->getCG().getType() == CG::KERNEL)
+      ExecCmd->flushStreams();
+  }
+  return Graph.MCommands.back()->getEvent();
+}
+
 Scheduler::Scheduler() {
+  const char *AsyncEnqueue = std::getenv("SYCL_ASYNC_ENQUEUE");
+  MAsyncEnqueue = AsyncEnqueue && std::string(AsyncEnqueue) != "0";
+  const char *OptimizeGraph = std::getenv("SYCL_GRAPH_OPTIMIZE");
+  MOptimizeGraph = !OptimizeGraph || std::string(OptimizeGraph) != "0";
+
   sycl::device HostDevice;
   DefaultHostQueue = QueueImplPtr(
       new queue_impl(HostDevice, /*AsyncHandler=*/{}, /*PropList=*/{}));
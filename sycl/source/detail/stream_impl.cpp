@@ -7,7 +7,16 @@
 //===----------------------------------------------------------------------===//
 
 #include <CL/sycl/detail/stream_impl.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace cl {
 namespace sycl {
@@ -30,13 +39,116 @@ size_t stream_impl::get_size() const { return BufferSize_; }
 size_t stream_impl::get_max_statement_size() const { return MaxStatementSize_; }
 
 void stream_impl::flush() {
-  // Access the stream buffer on the host. This access guarantees that kernel is
-  // executed and buffer contains streamed data.
+  // Access the offsets on the host first. This access guarantees that kernel
+  // is executed and tells how much data was streamed.
+  unsigned Offsets[2] = {0, 0};
+  {
+    auto OffsetAcc = Buf.get_access<cl::sycl::access::mode::read>(
+        range<1>(OffsetSize), id<1>(0));
+    std::memcpy(Offsets, OffsetAcc.get_pointer(), OffsetSize);
+  }
+  // If the stream overflowed, the data ends where the first write which
+  // didn't fit would have started, see updateOffset.
+  const size_t Size = Offsets[0] > BufferSize_
+                          ? std::min<size_t>(Offsets[1], BufferSize_)
+                          : Offsets[0];
+  if (Size == 0)
+    return;
+
   auto HostAcc = Buf.get_access<cl::sycl::access::mode::read>(
-      range<1>(BufferSize_), id<1>(OffsetSize));
+      range<1>(Size), id<1>(OffsetSize));
+  std::fwrite(HostAcc.get_pointer(), 1, Size, stdout);
+}
+
+// Owns the background thread flushing the streams passed to flushAsync.
+class StreamFlushWorker {
+public:
+  StreamFlushWorker() : MThread(&StreamFlushWorker::run, this) {}
+
+  // Flushes the rest of the pending streams and stops the thread.
+  ~StreamFlushWorker() {
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      MStop = true;
+    }
+    MCondVar.notify_all();
+    MThread.join();
+  }
+
+  // Returns the ticket of the flush, the number of streams pushed so far.
+  size_t push(std::shared_ptr<stream_impl> Stream) {
+    size_t Ticket = 0;
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      MPendingStreams.push_back(std::move(Stream));
+      Ticket = ++MPushed;
+    }
+    MCondVar.notify_all();
+    return Ticket;
+  }
+
+  void wait(size_t Ticket) {
+    // A stream flushed by this thread can't wait for itself.
+    if (std::this_thread::get_id() == MThread.get_id())
+      return;
+    std::unique_lock<std::mutex> Lock(MMutex);
+    Ticket = std::min(Ticket, MPushed);
+    MCondVar.wait(Lock, [this, Ticket] { return MFlushed >= Ticket; });
+  }
+
+private:
+  void run() {
+    std::unique_lock<std::mutex> Lock(MMutex);
+    while (true) {
+      MCondVar.wait(Lock, [this] { return MStop || !MPendingStreams.empty(); });
+      if (MPendingStreams.empty())
+        return;
+      std::shared_ptr<stream_impl> Stream = std::move(MPendingStreams.front());
+      MPendingStreams.pop_front();
 
-  printf("%s", HostAcc.get_pointer());
+      Lock.unlock();
+      try {
+        Stream->flush();
+      } catch (...) {
+        // The errors of the kernel are reported through its queue.
+      }
+      Stream.reset();
+      Lock.lock();
+      ++MFlushed;
+      MCondVar.notify_all();
+    }
+  }
+
+  std::mutex MMutex;
+  std::condition_variable MCondVar;
+  std::deque<std::shared_ptr<stream_impl>> MPendingStreams;
+  // The number of streams pushed and flushed so far.
+  size_t MPushed = 0;
+  size_t MFlushed = 0;
+  bool MStop = false;
+  // Must be the last member, the thread uses all the others.
+  std::thread MThread;
+};
+
+static std::atomic<bool> FlushWorkerStarted{false};
+
+static StreamFlushWorker &getFlushWorker() {
+  // Created on the first use, so that no thread is started if no stream is
+  // used.
+  static StreamFlushWorker Worker;
+  FlushWorkerStarted.store(true, std::memory_order_release);
+  return Worker;
+}
+
+size_t stream_impl::flushAsync(std::shared_ptr<stream_impl> Stream) {
+  return getFlushWorker().push(std::move(Stream));
+}
+
+void stream_impl::waitForFlushes(size_t Ticket) {
+  if (FlushWorkerStarted.load(std::memory_order_acquire))
+    getFlushWorker().wait(Ticket);
 }
+
 } // namespace detail
 } // namespace sycl
 } // namespace cl
@@ -0,0 +1,86 @@
+//==----------- trace_file.cpp - SYCL RT Chrome trace file -----------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/trace_file.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+unsigned getTraceThreadId() {
+  static std::atomic<unsigned> NextId{0};
+  thread_local unsigned Id = NextId++;
+  return Id;
+}
+
+void writeJSONEscaped(std::ostream &Stream, const std::string &Str) {
+  for (char C : Str) {
+    switch (C) {
+    case '"':
+      Stream << "\\\"";
+      break;
+    case '\\':
+      Stream << "\\\\";
+      break;
+    case '\n':
+      Stream << "\\n";
+      break;
+    default:
+      if (static_cast<unsigned char>(C) < 0x20) {
+        char Buf[8];
+        std::snprintf(Buf, sizeof(Buf), "\\u%04x", C);
+        Stream << Buf;
+      } else
+        Stream << C;
+    }
+  }
+}
+
+const char *TraceFile::getPath(const char *EnvVar) {
+  const char *Path = std::getenv(EnvVar);
+  return Path && *Path ? Path : nullptr;
+}
+
+void TraceFile::writeAtExit(TraceFile *File) {
+  // Never destroyed, like the files themselves.
+  static std::mutex *Mutex = new std::mutex;
+  static std::vector<TraceFile *> *Files = new std::vector<TraceFile *>;
+  std::lock_guard<std::mutex> Lock(*Mutex);
+  if (Files->empty())
+    std::atexit([]() {
+      std::lock_guard<std::mutex> Lock(*Mutex);
+      for (TraceFile *File : *Files)
+        File->write();
+    });
+  Files->push_back(File);
+}
+
+void TraceFile::write() {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MWritten = true;
+  std::ofstream Stream(MPath);
+  if (!Stream) {
+    std::cerr << "Can't open the trace file " << MPath << std::endl;
+    return;
+  }
+  Stream << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+  writeEvents(Stream);
+  Stream << "\n]}\n";
+}
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
@@ -0,0 +1,306 @@
+//==----------- usm_dispatch.cpp - SYCL USM back-end dispatch --------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/os_util.hpp>
+#include <CL/sycl/detail/usm_dispatch.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+// The cl_intel_unified_shared_memory values, for the OpenCL headers which
+// don't have the extension yet.
+#ifndef CL_KERNEL_EXEC_INFO_INDIRECT_HOST_ACCESS_INTEL
+#define CL_KERNEL_EXEC_INFO_INDIRECT_HOST_ACCESS_INTEL 0x4200
+#define CL_KERNEL_EXEC_INFO_INDIRECT_DEVICE_ACCESS_INTEL 0x4201
+#define CL_KERNEL_EXEC_INFO_INDIRECT_SHARED_ACCESS_INTEL 0x4202
+#endif
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+// Calls the extension function Fn loaded to the member M<Fn>, traced as the
+// OpenCL one.
+#define USM_TRACED(Fn)                                                         \
+  pi_traced_call<decltype(M##Fn)>("cl" #Fn "INTEL", M##Fn)
+
+USMDispatcher::USMDispatcher(cl_context Context, cl_platform_id Platform,
+                             const std::vector<cl_device_id> &Devices)
+    : MContext(Context) {
+  if (!MContext) {
+    MBackend = Backend::Host;
+    return;
+  }
+  if (loadExtension(Platform)) {
+    MBackend = Backend::USM;
+    return;
+  }
+#ifdef CL_VERSION_2_0
+  // SVM is usable if all the devices support it, host and shared memory need
+  // fine-grained buffers.
+  bool AllSVM = !Devices.empty();
+  bool AllFineGrain = AllSVM;
+  for (cl_device_id Device : Devices) {
+    cl_device_svm_capabilities Caps = 0;
+    if (PI_TRACED(clGetDeviceInfo)(Device, CL_DEVICE_SVM_CAPABILITIES,
+                                   sizeof(Caps), &Caps,
+                                   nullptr) != CL_SUCCESS)
+      Caps = 0;
+    AllSVM &= Caps != 0;
+    AllFineGrain &= (Caps & CL_DEVICE_SVM_FINE_GRAIN_BUFFER) != 0;
+  }
+  if (AllSVM) {
+    MBackend = Backend::SVM;
+    MSVMFineGrain = AllFineGrain;
+  }
+#endif
+}
+
+USMDispatcher::~USMDispatcher() {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  for (const auto &Alloc : MAllocations)
+    freeImpl(const_cast<void *>(Alloc.first), Alloc.second.Kind);
+}
+
+bool USMDispatcher::loadExtension(cl_platform_id Platform) {
+  auto Load = [Platform](const char *Name) {
+    return PI_TRACED(clGetExtensionFunctionAddressForPlatform)(Platform, Name);
+  };
+  MHostMemAlloc = (HostMemAllocFn)Load("clHostMemAllocINTEL");
+  MDeviceMemAlloc = (DeviceMemAllocFn)Load("clDeviceMemAllocINTEL");
+  MSharedMemAlloc = (SharedMemAllocFn)Load("clSharedMemAllocINTEL");
+  MMemFree = (MemFreeFn)Load("clMemFreeINTEL");
+  MSetKernelArgMemPointer =
+      (SetKernelArgMemPointerFn)Load("clSetKernelArgMemPointerINTEL");
+  MEnqueueMemset = (EnqueueMemsetFn)Load("clEnqueueMemsetINTEL");
+  MEnqueueMemcpy = (EnqueueMemcpyFn)Load("clEnqueueMemcpyINTEL");
+  return MHostMemAlloc && MDeviceMemAlloc && MSharedMemAlloc && MMemFree &&
+         MSetKernelArgMemPointer && MEnqueueMemset && MEnqueueMemcpy;
+}
+
+void *USMDispatcher::allocate(usm::alloc Kind, cl_device_id Device,
+                              size_t Size, size_t Alignment) {
+  if (Size == 0)
+    return nullptr;
+
+  void *Ptr = nullptr;
+  cl_int Error = CL_SUCCESS;
+  switch (MBackend) {
+  case Backend::None:
+    throw feature_not_supported(
+        "Unified shared memory is not supported by the platform");
+  case Backend::Host:
+    Ptr = OSUtil::alignedAlloc(
+        std::max(Alignment, alignof(std::max_align_t)), Size);
+    break;
+  case Backend::USM:
+    switch (Kind) {
+    case usm::alloc::host:
+      Ptr = USM_TRACED(HostMemAlloc)(MContext, nullptr, Size, Alignment,
+                                     &Error);
+      break;
+    case usm::alloc::device:
+      Ptr = USM_TRACED(DeviceMemAlloc)(MContext, Device, nullptr, Size,
+                                       Alignment, &Error);
+      break;
+    case usm::alloc::shared:
+      Ptr = USM_TRACED(SharedMemAlloc)(MContext, Device, nullptr, Size,
+                                       Alignment, &Error);
+      break;
+    case usm::alloc::unknown:
+      break;
+    }
+    break;
+  case Backend::SVM:
+#ifdef CL_VERSION_2_0
+    if (Kind == usm::alloc::device)
+      Ptr = PI_TRACED(clSVMAlloc)(MContext, CL_MEM_READ_WRITE, Size,
+                                  Alignment);
+    else if (Kind != usm::alloc::unknown && MSVMFineGrain)
+      Ptr = PI_TRACED(clSVMAlloc)(
+          MContext, CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER, Size,
+          Alignment);
+#endif
+    break;
+  }
+  if (!Ptr || Error != CL_SUCCESS)
+    return nullptr;
+
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MAllocations[Ptr] = Allocation{Kind, Size};
+  ++MNumAllocations;
+  return Ptr;
+}
+
+void USMDispatcher::free(void *Ptr) {
+  if (!Ptr)
+    return;
+  usm::alloc Kind;
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    auto It = MAllocations.find(Ptr);
+    if (It == MAllocations.end())
+      throw invalid_parameter_error(
+          "The pointer is not a USM allocation of the context");
+    Kind = It->second.Kind;
+    MAllocations.erase(It);
+    --MNumAllocations;
+  }
+  freeImpl(Ptr, Kind);
+}
+
+void USMDispatcher::freeImpl(void *Ptr, usm::alloc Kind) {
+  switch (MBackend) {
+  case Backend::None:
+    break;
+  case Backend::Host:
+    OSUtil::alignedFree(Ptr);
+    break;
+  case Backend::USM:
+    CHECK_OCL_CODE_NO_EXC(USM_TRACED(MemFree)(MContext, Ptr));
+    break;
+  case Backend::SVM:
+#ifdef CL_VERSION_2_0
+    // Returns nothing, so it is not traced.
+    clSVMFree(MContext, Ptr);
+#endif
+    break;
+  }
+}
+
+usm::alloc USMDispatcher::getPointerType(const void *Ptr) const {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  // The last allocation starting at or before Ptr is the only one which can
+  // contain it.
+  auto It = MAllocations.upper_bound(Ptr);
+  if (It == MAllocations.begin())
+    return usm::alloc::unknown;
+  --It;
+  const char *Begin = static_cast<const char *>(It->first);
+  if (static_cast<const char *>(Ptr) >= Begin + It->second.Size)
+    return usm::alloc::unknown;
+  return It->second.Kind;
+}
+
+void USMDispatcher::setKernelArgPointer(cl_kernel Kernel, cl_uint Index,
+                                        void *Ptr) {
+  switch (MBackend) {
+  case Backend::USM:
+    CHECK_OCL_CODE(USM_TRACED(SetKernelArgMemPointer)(Kernel, Index, Ptr));
+    return;
+  case Backend::SVM:
+#ifdef CL_VERSION_2_0
+    CHECK_OCL_CODE(PI_TRACED(clSetKernelArgSVMPointer)(Kernel, Index, Ptr));
+    return;
+#endif
+  case Backend::None:
+  case Backend::Host:
+    // Not a USM pointer, e.g. nullptr, it is passed by value.
+    CHECK_OCL_CODE(
+        PI_TRACED(clSetKernelArg)(Kernel, Index, sizeof(Ptr), &Ptr));
+    return;
+  }
+}
+
+void USMDispatcher::setKernelIndirectAccess(cl_kernel Kernel) {
+  if (!hasAllocations())
+    return;
+  switch (MBackend) {
+  case Backend::USM: {
+#ifdef CL_VERSION_2_0
+    const cl_bool True = CL_TRUE;
+    for (cl_uint Param : {CL_KERNEL_EXEC_INFO_INDIRECT_HOST_ACCESS_INTEL,
+                          CL_KERNEL_EXEC_INFO_INDIRECT_DEVICE_ACCESS_INTEL,
+                          CL_KERNEL_EXEC_INFO_INDIRECT_SHARED_ACCESS_INTEL})
+      CHECK_OCL_CODE(PI_TRACED(clSetKernelExecInfo)(Kernel, Param,
+                                                    sizeof(True), &True));
+#endif
+    return;
+  }
+  case Backend::SVM: {
+#ifdef CL_VERSION_2_0
+    // SVM has no such switch, the kernel gets all the live allocations.
+    std::vector<void *> Ptrs;
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      Ptrs.reserve(MAllocations.size());
+      for (const auto &Alloc : MAllocations)
+        Ptrs.push_back(const_cast<void *>(Alloc.first));
+    }
+    if (!Ptrs.empty())
+      CHECK_OCL_CODE(PI_TRACED(clSetKernelExecInfo)(
+          Kernel, CL_KERNEL_EXEC_INFO_SVM_PTRS, Ptrs.size() * sizeof(void *),
+          Ptrs.data()));
+#endif
+    return;
+  }
+  case Backend::None:
+  case Backend::Host:
+    return;
+  }
+}
+
+void USMDispatcher::memcpy(cl_command_queue Queue, void *Dst, const void *Src,
+                           size_t Size, const std::vector<cl_event> &DepEvents,
+                           cl_event &OutEvent) {
+  const cl_uint NumEvents = DepEvents.size();
+  const cl_event *Events = DepEvents.empty() ? nullptr : &DepEvents[0];
+  switch (MBackend) {
+  case Backend::USM:
+    CHECK_OCL_CODE(USM_TRACED(EnqueueMemcpy)(Queue, CL_FALSE, Dst, Src, Size,
+                                             NumEvents, Events, &OutEvent));
+    return;
+  case Backend::SVM:
+#ifdef CL_VERSION_2_0
+    CHECK_OCL_CODE(PI_TRACED(clEnqueueSVMMemcpy)(
+        Queue, CL_FALSE, Dst, Src, Size, NumEvents, Events, &OutEvent));
+    return;
+#endif
+  case Backend::None:
+  case Backend::Host:
+    if (NumEvents)
+      CHECK_OCL_CODE(PI_TRACED(clWaitForEvents)(NumEvents, Events));
+    std::memcpy(Dst, Src, Size);
+    return;
+  }
+}
+
+void USMDispatcher::memset(cl_command_queue Queue, void *Dst, int Value,
+                           size_t Size, const std::vector<cl_event> &DepEvents,
+                           cl_event &OutEvent) {
+  const cl_uint NumEvents = DepEvents.size();
+  const cl_event *Events = DepEvents.empty() ? nullptr : &DepEvents[0];
+  switch (MBackend) {
+  case Backend::USM:
+    CHECK_OCL_CODE(USM_TRACED(EnqueueMemset)(Queue, Dst, Value, Size,
+                                             NumEvents, Events, &OutEvent));
+    return;
+  case Backend::SVM: {
+#ifdef CL_VERSION_2_0
+    const unsigned char Pattern = static_cast<unsigned char>(Value);
+    CHECK_OCL_CODE(PI_TRACED(clEnqueueSVMMemFill)(
+        Queue, Dst, &Pattern, sizeof(Pattern), Size, NumEvents, Events,
+        &OutEvent));
+    return;
+#endif
+  }
+  case Backend::None:
+  case Backend::Host:
+    if (NumEvents)
+      CHECK_OCL_CODE(PI_TRACED(clWaitForEvents)(NumEvents, Events));
+    std::memset(Dst, Value, Size);
+    return;
+  }
+}
+
+#undef USM_TRACED
+
+} // namespace detail
+} // namespace sycl
+} // namespace cl
@@ -25,9 +25,12 @@ void force_type(info::device_type &t, const info::device_type &ft) {
 
 device::device() : impl(std::make_shared<detail::device_host>()) {}
 
-device::device(cl_device_id deviceId)
-    : impl(std::make_shared<detail::device_impl_pi>(
-      detail::pi_cast<detail::RT::pi_device>(deviceId))) {}
+device::device(cl_device_id deviceId) {
+  const auto Device = detail::pi_cast<detail::RT::pi_device>(deviceId);
+  impl = detail::platform_impl_pi::getDeviceImpl(Device);
+  if (!impl)
+    impl = std::make_shared<detail::device_impl_pi>(Device);
+}
 
 device::device(const device_selector &deviceSelector) {
   *this = deviceSelector.select_device();
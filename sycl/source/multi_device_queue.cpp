@@ -0,0 +1,56 @@
+//==-------- multi_device_queue.cpp --- SYCL multi-device execution --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/multi_device_queue_impl.hpp>
+#include <CL/sycl/intel/multi_device_queue.hpp>
+
+namespace cl {
+namespace sycl {
+namespace intel {
+
+multi_device_queue::multi_device_queue(const vector_class<device> &Devices,
+                                       const async_handler &AsyncHandler)
+    : multi_device_queue(context(Devices, AsyncHandler), AsyncHandler) {}
+
+multi_device_queue::multi_device_queue(const context &Context,
+                                       const async_handler &AsyncHandler)
+    : impl(std::make_shared<detail::multi_device_queue_impl>(Context,
+                                                             AsyncHandler)) {}
+
+context multi_device_queue::get_context() const { return impl->getContext(); }
+
+vector_class<device> multi_device_queue::get_devices() const {
+  vector_class<device> Devices;
+  for (size_t I = 0; I < impl->getNumDevices(); ++I)
+    Devices.push_back(impl->getQueue(I).get_device());
+  return Devices;
+}
+
+queue multi_device_queue::get_queue(size_t Index) const {
+  return impl->getQueue(Index);
+}
+
+vector_class<float> multi_device_queue::get_weights() const {
+  return impl->getWeights();
+}
+
+void multi_device_queue::wait() { impl->wait(); }
+
+vector_class<std::pair<size_t, size_t>>
+multi_device_queue::partition(size_t Size, size_t Granularity) const {
+  return impl->partition(Size, Granularity);
+}
+
+void multi_device_queue::addSubmission(size_t DeviceIndex, const event &Event,
+                                       size_t WorkItems) {
+  impl->addSubmission(DeviceIndex, Event, WorkItems);
+}
+
+} // namespace intel
+} // namespace sycl
+} // namespace cl
@@ -18,8 +18,8 @@ namespace sycl {
 platform::platform() : impl(std::make_shared<detail::platform_impl_host>()) {}
 
 platform::platform(cl_platform_id platform_id)
-    : impl(std::make_shared<detail::platform_impl_pi>(
-             detail::pi_cast<detail::RT::pi_platform>(platform_id))) {}
+    : impl(detail::platform_impl_pi::getPlatformImpl(
+          detail::pi_cast<detail::RT::pi_platform>(platform_id))) {}
 
 platform::platform(const device_selector &dev_selector) {
   *this = dev_selector.select_device().get_platform();
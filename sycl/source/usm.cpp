@@ -0,0 +1,66 @@
+//==---------------- usm.cpp - SYCL USM ------------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl/detail/context_impl.hpp>
+#include <CL/sycl/detail/device_impl.hpp>
+#include <CL/sycl/usm.hpp>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+namespace usm {
+
+void *alignedAlloc(size_t Alignment, size_t Size, const context &Ctxt,
+                   const device &Dev, cl::sycl::usm::alloc Kind) {
+  cl_device_id Device = nullptr;
+  if (!Dev.is_host())
+    Device = detail::getSyclObjImpl(Dev)->getHandleRef();
+  return detail::getSyclObjImpl(Ctxt)->getUSMDispatch().allocate(
+      Kind, Device, Size, Alignment);
+}
+
+} // namespace usm
+} // namespace detail
+
+void *malloc_device(size_t Size, const device &Dev, const context &Ctxt) {
+  return detail::usm::alignedAlloc(0, Size, Ctxt, Dev, usm::alloc::device);
+}
+
+void *malloc_device(size_t Size, const queue &Q) {
+  return malloc_device(Size, Q.get_device(), Q.get_context());
+}
+
+void *malloc_host(size_t Size, const context &Ctxt) {
+  return detail::usm::alignedAlloc(0, Size, Ctxt, Ctxt.get_devices()[0],
+                                   usm::alloc::host);
+}
+
+void *malloc_host(size_t Size, const queue &Q) {
+  return malloc_host(Size, Q.get_context());
+}
+
+void *malloc_shared(size_t Size, const device &Dev, const context &Ctxt) {
+  return detail::usm::alignedAlloc(0, Size, Ctxt, Dev, usm::alloc::shared);
+}
+
+void *malloc_shared(size_t Size, const queue &Q) {
+  return malloc_shared(Size, Q.get_device(), Q.get_context());
+}
+
+void free(void *Ptr, const context &Ctxt) {
+  detail::getSyclObjImpl(Ctxt)->getUSMDispatch().free(Ptr);
+}
+
+void free(void *Ptr, const queue &Q) { free(Ptr, Q.get_context()); }
+
+usm::alloc get_pointer_type(const void *Ptr, const context &Ctxt) {
+  return detail::getSyclObjImpl(Ctxt)->getUSMDispatch().getPointerType(Ptr);
+}
+
+} // namespace sycl
+} // namespace cl
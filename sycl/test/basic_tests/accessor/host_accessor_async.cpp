@@ -0,0 +1,59 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+//==------ host_accessor_async.cpp - SYCL asynchronous host accessor -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The asynchronous host accessor gives the results of the kernels submitted
+// before it on the first access, and the kernels submitted after it see the
+// host writes once it is destroyed.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+constexpr int N = 64;
+
+int main() {
+  int Data[N] = {0};
+  {
+    buffer<int, 1> Buf(Data, range<1>(N));
+    queue Queue;
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::write>(CGH);
+      CGH.parallel_for<class async_host_acc_init>(
+          range<1>(N), [=](id<1> Idx) { Acc[Idx] = Idx[0]; });
+    });
+    {
+      auto HostAcc = Buf.get_access_async<access::mode::read_write>();
+      for (int I = 0; I < N; ++I) {
+        assert(HostAcc[I] == I);
+        HostAcc[I] *= 2;
+      }
+    }
+    {
+      auto HostAcc = Buf.get_access_async<access::mode::read>(
+          range<1>(N / 2), id<1>(N / 2));
+      HostAcc.wait();
+      for (int I = 0; I < N / 2; ++I)
+        assert(HostAcc[I] == 2 * (I + N / 2));
+    }
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class async_host_acc_inc>(
+          range<1>(N), [=](id<1> Idx) { Acc[Idx] += 1; });
+    });
+  }
+  for (int I = 0; I < N; ++I)
+    assert(Data[I] == 2 * I + 1);
+  return 0;
+}
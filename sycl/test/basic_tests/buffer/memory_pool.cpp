@@ -0,0 +1,104 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+//==------------ memory_pool.cpp - SYCL device buffer pool test ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl.hpp>
+#include <CL/sycl/detail/context_impl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+static void releaseToPool(detail::MemoryPool &Pool, cl_mem Mem) {
+  bool Released = Pool.release(Mem);
+  assert(Released && "Buffer is not owned by the pool");
+  (void)Released;
+}
+
+int main() {
+  queue Queue;
+  if (Queue.is_host())
+    return 0;
+
+  detail::MemoryPool &Pool =
+      detail::getSyclObjImpl(Queue.get_context())->getMemoryPool();
+  Pool.setHighWaterMark(1024 * 1024);
+
+  // A released buffer is reused by an allocation of the same size class.
+  cl_mem Mem = Pool.allocate(CL_MEM_READ_WRITE, 1000);
+  releaseToPool(Pool, Mem);
+  assert(Pool.getFreeSize() == 1024);
+  cl_mem Reused = Pool.allocate(CL_MEM_READ_WRITE, 1020);
+  assert(Reused == Mem);
+  assert(Pool.getFreeSize() == 0);
+
+  // Buffers of different size classes are not mixed up.
+  cl_mem Other = Pool.allocate(CL_MEM_READ_WRITE, 4096);
+  assert(Other != Reused);
+  releaseToPool(Pool, Reused);
+  releaseToPool(Pool, Other);
+  assert(Pool.getFreeSize() == 1024 + 4096);
+
+  // Sizes are rounded up to a quarter of the power of two below them.
+  cl_mem Rounded = Pool.allocate(CL_MEM_READ_WRITE, 1300);
+  assert(Rounded != Reused && Rounded != Other);
+  releaseToPool(Pool, Rounded);
+  assert(Pool.getFreeSize() == 1024 + 4096 + 1536);
+
+  // The pool doesn't take buffers it has not created.
+  cl_int Error = CL_SUCCESS;
+  cl_mem Foreign = clCreateBuffer(detail::getSyclObjImpl(Queue.get_context())
+                                      ->getHandleRef(),
+                                  CL_MEM_READ_WRITE, 64, nullptr, &Error);
+  assert(Error == CL_SUCCESS);
+  bool Released = Pool.release(Foreign);
+  assert(!Released && "Pool took a foreign buffer");
+  (void)Released;
+  clReleaseMemObject(Foreign);
+
+  // Trimming frees the least recently released buffers first.
+  Pool.trim(4096);
+  assert(Pool.getFreeSize() == 1536);
+  Pool.trim();
+  assert(Pool.getFreeSize() == 0);
+
+  // Buffers released over the high-water mark are freed.
+  Pool.setHighWaterMark(2048);
+  cl_mem Big = Pool.allocate(CL_MEM_READ_WRITE, 4096);
+  releaseToPool(Pool, Big);
+  assert(Pool.getFreeSize() == 0);
+
+  // Buffers of the SYCL runtime go through the pool and keep working.
+  constexpr size_t N = 256;
+  Pool.setHighWaterMark(1024 * 1024);
+  int Result[N] = {0};
+  for (int Iter = 0; Iter < 4; ++Iter) {
+    {
+      buffer<int, 1> Tmp{range<1>(N)};
+      buffer<int, 1> ResultBuf(Result, range<1>(N));
+      Queue.submit([&](handler &CGH) {
+        auto Acc = Tmp.get_access<access::mode::write>(CGH);
+        CGH.parallel_for<class pool_fill>(
+            range<1>(N), [=](id<1> I) { Acc[I] = static_cast<int>(I[0]); });
+      });
+      Queue.submit([&](handler &CGH) {
+        auto In = Tmp.get_access<access::mode::read>(CGH);
+        auto Out = ResultBuf.get_access<access::mode::read_write>(CGH);
+        CGH.parallel_for<class pool_add>(
+            range<1>(N), [=](id<1> I) { Out[I] += In[I]; });
+      });
+    }
+    assert(Pool.getFreeSize() > 0);
+  }
+  for (size_t I = 0; I < N; ++I)
+    assert(Result[I] == static_cast<int>(I) * 4);
+  return 0;
+}
@@ -0,0 +1,50 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: env SYCL_BE_TRACE=1 %CPU_RUN_PLACEHOLDER %t.out %CPU_CHECK_PLACEHOLDER
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+//==------- zero_copy.cpp - SYCL buffer over aligned host memory test ------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The buffer works on the user's memory aligned as the default allocation.
+// The CPU device shares the memory with the host, so the data is synchronized
+// by mapping the buffer instead of copying it.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+constexpr int N = 1024;
+
+int main() {
+  alignas(64) int Data[N];
+  for (int I = 0; I < N; ++I)
+    Data[I] = I;
+  {
+    buffer<int, 1> Buf(Data, range<1>(N));
+    queue Queue;
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class zero_copy_kernel>(
+          range<1>(N), [=](id<1> Idx) { Acc[Idx] *= 2; });
+    });
+    auto HostAcc = Buf.get_access<access::mode::read>();
+    for (int I = 0; I < N; ++I)
+      assert(HostAcc[I] == 2 * I);
+  }
+  for (int I = 0; I < N; ++I)
+    assert(Data[I] == 2 * I);
+  return 0;
+}
+
+// CHECK-NOT: clEnqueueWriteBuffer
+// CHECK: PI ---> clEnqueueMapBuffer({{.+}})
+// CHECK-NOT: clEnqueueReadBuffer
+// CHECK: PI ---> clEnqueueUnmapMemObject({{.+}})
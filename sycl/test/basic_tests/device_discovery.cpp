@@ -0,0 +1,49 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+//==------- device_discovery.cpp - SYCL device discovery snapshot test -----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The platforms and devices are discovered once, so the objects returned by
+// the different queries for the same native handles are equal.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+int main() {
+  const vector_class<device> Devices = device::get_devices();
+  const vector_class<device> DevicesAgain = device::get_devices();
+  assert(Devices.size() == DevicesAgain.size());
+
+  for (size_t I = 0; I < Devices.size(); ++I) {
+    const device &Dev = Devices[I];
+    if (Dev.is_host())
+      continue;
+    assert(Dev == DevicesAgain[I]);
+    assert(Dev.get_platform() == Dev.get_platform());
+    assert(Dev.get_info<info::device::name>() ==
+           DevicesAgain[I].get_info<info::device::name>());
+    assert(Dev.get_info<info::device::max_compute_units>() ==
+           DevicesAgain[I].get_info<info::device::max_compute_units>());
+
+    assert(device(Dev.get()) == Dev);
+
+    cl_platform_id PlatformId = Dev.get_platform().get();
+    assert(platform(PlatformId) == Dev.get_platform());
+  }
+
+  const device Selected = default_selector().select_device();
+  if (!Selected.is_host())
+    assert(Selected == default_selector().select_device());
+  return 0;
+}
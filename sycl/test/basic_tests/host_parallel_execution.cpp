@@ -0,0 +1,79 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: env SYCL_DEVICE_TYPE=HOST SYCL_HOST_NUM_THREADS=1 %t.out
+// RUN: env SYCL_DEVICE_TYPE=HOST SYCL_HOST_NUM_THREADS=3 %t.out
+//==-- host_parallel_execution.cpp - Host device multi-threaded execution --==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Checks that every work-item is executed exactly once with the right ids
+// when the host device spreads the kernel over several threads, and that
+// work-groups are not split between the threads.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+int main() {
+  constexpr size_t X = 37, Y = 5, Z = 3;
+  constexpr size_t LX = 4, LY = 5, LZ = 1;
+  constexpr size_t GX = 8 * LX;
+  queue Queue;
+
+  int IdData[Z][Y][X] = {{{0}}};
+  int ItemData[Z][Y][X] = {{{0}}};
+  int GroupData[Z][Y][GX] = {{{0}}};
+  {
+    buffer<int, 3> IdBuf(&IdData[0][0][0], range<3>(Z, Y, X));
+    buffer<int, 3> ItemBuf(&ItemData[0][0][0], range<3>(Z, Y, X));
+    buffer<int, 3> GroupBuf(&GroupData[0][0][0], range<3>(Z, Y, GX));
+
+    Queue.submit([&](handler &CGH) {
+      auto Acc = IdBuf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class host_parallel_id>(
+          range<3>(Z, Y, X), [=](id<3> I) { Acc[I] += 1; });
+    });
+
+    Queue.submit([&](handler &CGH) {
+      auto Acc = ItemBuf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class host_parallel_item>(
+          range<3>(Z, Y, X), [=](item<3> I) {
+            Acc[I] += static_cast<int>(I.get_linear_id()) + 1;
+          });
+    });
+
+    // Each work-item stores the linear id of the first work-item of its
+    // group, which must be the same for the whole group.
+    Queue.submit([&](handler &CGH) {
+      auto Acc = GroupBuf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class host_parallel_nd_item>(
+          nd_range<3>(range<3>(Z, Y, GX), range<3>(LZ, LY, LX)),
+          [=](nd_item<3> I) {
+            Acc[I.get_global_id()] +=
+                static_cast<int>(I.get_group_linear_id()) + 1;
+          });
+    });
+  }
+
+  for (size_t K = 0; K < Z; ++K)
+    for (size_t J = 0; J < Y; ++J) {
+      for (size_t I = 0; I < X; ++I) {
+        assert(IdData[K][J][I] == 1 && "Work-item executed a wrong number of "
+                                       "times");
+        assert(ItemData[K][J][I] == static_cast<int>((K * Y + J) * X + I) + 1 &&
+               "Wrong item");
+      }
+      for (size_t I = 0; I < GX; ++I) {
+        size_t Group = ((K / LZ) * (Y / LY) + J / LY) * (GX / LX) + I / LX;
+        assert(GroupData[K][J][I] == static_cast<int>(Group) + 1 &&
+               "Wrong group");
+      }
+    }
+  return 0;
+}
@@ -0,0 +1,95 @@
+// RUN: %clang -std=c++11 -O2 -fsycl -DSYCL_HOST_SIMD_LOOPS %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST SYCL_HOST_NUM_THREADS=1 %t.out
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+//==------ host_simd_loops.cpp - Host device inner loop benchmark ---------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Compares the host device execution of the same basic parallel_for taking
+// id<> and item<> arguments with a plain loop over the data, and checks the
+// results. The timings are only printed, they are not checked, as they depend
+// on the machine. The single-thread run shows the cost of the item<>
+// construction and the effect of SYCL_HOST_SIMD_LOOPS on the inner loop alone.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace cl::sycl;
+
+constexpr size_t Rows = 1024;
+constexpr size_t Cols = 1024;
+constexpr int NumRepetitions = 8;
+
+template <typename FuncT> static double measure(FuncT Func) {
+  Func();
+  auto Start = std::chrono::steady_clock::now();
+  for (int I = 0; I < NumRepetitions; ++I)
+    Func();
+  auto End = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(End - Start).count() /
+         NumRepetitions;
+}
+
+static void check(const std::vector<float> &Out) {
+  for (size_t I = 0; I < Rows * Cols; ++I)
+    assert(Out[I] == static_cast<float>(I % 512) * 2.0f + 1.0f &&
+           "Wrong result");
+}
+
+int main() {
+  std::vector<float> In(Rows * Cols);
+  for (size_t I = 0; I < Rows * Cols; ++I)
+    In[I] = static_cast<float>(I % 512);
+  std::vector<float> Out(Rows * Cols, 0.0f);
+
+  queue Queue;
+  const range<2> Range(Rows, Cols);
+  double IdTime, ItemTime;
+  {
+    buffer<float, 2> InBuf(In.data(), Range);
+    buffer<float, 2> OutBuf(Out.data(), Range);
+
+    IdTime = measure([&]() {
+      Queue.submit([&](handler &CGH) {
+        auto InAcc = InBuf.get_access<access::mode::read>(CGH);
+        auto OutAcc = OutBuf.get_access<access::mode::write>(CGH);
+        CGH.parallel_for<class host_simd_id>(Range, [=](id<2> I) {
+          OutAcc[I] = InAcc[I] * 2.0f + 1.0f;
+        });
+      });
+      Queue.wait();
+    });
+
+    ItemTime = measure([&]() {
+      Queue.submit([&](handler &CGH) {
+        auto InAcc = InBuf.get_access<access::mode::read>(CGH);
+        auto OutAcc = OutBuf.get_access<access::mode::write>(CGH);
+        CGH.parallel_for<class host_simd_item>(Range, [=](item<2> I) {
+          OutAcc[I] = InAcc[I] * 2.0f + 1.0f;
+        });
+      });
+      Queue.wait();
+    });
+  }
+  check(Out);
+
+  std::fill(Out.begin(), Out.end(), 0.0f);
+  double LoopTime = measure([&]() {
+    for (size_t I = 0; I < Rows * Cols; ++I)
+      Out[I] = In[I] * 2.0f + 1.0f;
+  });
+  check(Out);
+
+  std::cout << "plain loop: " << LoopTime << " ms" << std::endl;
+  std::cout << "id<2>:      " << IdTime << " ms" << std::endl;
+  std::cout << "item<2>:    " << ItemTime << " ms" << std::endl;
+  return 0;
+}
@@ -0,0 +1,84 @@
+// RUN: %clang -std=c++11 %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: %t.out
+//==------- image_conversion.cpp - SYCL host image texel conversions -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl.hpp>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+using namespace cl::sycl;
+
+int main() {
+  const size_t Count = 37;
+
+  // rgba unorm_int8
+  {
+    uint8_t Texels[Count * 4];
+    for (size_t I = 0; I < Count * 4; ++I)
+      Texels[I] = uint8_t(I * 7);
+    float Values[Count * 4];
+    detail::convertReadData(image_channel_order::rgba,
+                            image_channel_type::unorm_int8, Texels, Values,
+                            Count);
+    for (size_t I = 0; I < Count * 4; ++I)
+      assert(std::fabs(Values[I] - Texels[I] / 255.0f) < 1e-6f);
+
+    uint8_t Written[Count * 4];
+    detail::convertWriteData(image_channel_order::rgba,
+                             image_channel_type::unorm_int8, Values, Written,
+                             Count);
+    for (size_t I = 0; I < Count * 4; ++I)
+      assert(Written[I] == Texels[I]);
+
+    // The values out of [0, 1] saturate.
+    float Saturated[4] = {-1.0f, 2.0f, NAN, 0.5f};
+    detail::convertWriteData(image_channel_order::rgba,
+                             image_channel_type::unorm_int8, Saturated,
+                             Written, 1);
+    assert(Written[0] == 0 && Written[1] == 255 && Written[2] == 0 &&
+           Written[3] == 128);
+  }
+
+  // r fp32
+  {
+    float Texels[Count];
+    for (size_t I = 0; I < Count; ++I)
+      Texels[I] = I * 0.25f;
+    float Values[Count * 4];
+    detail::convertReadData(image_channel_order::r, image_channel_type::fp32,
+                            Texels, Values, Count);
+    for (size_t I = 0; I < Count; ++I)
+      assert(Values[4 * I] == Texels[I] && Values[4 * I + 1] == 0.0f &&
+             Values[4 * I + 2] == 0.0f && Values[4 * I + 3] == 1.0f);
+
+    float Written[Count];
+    detail::convertWriteData(image_channel_order::r, image_channel_type::fp32,
+                             Values, Written, Count);
+    for (size_t I = 0; I < Count; ++I)
+      assert(Written[I] == Texels[I]);
+  }
+
+  // The other formats are not supported.
+  {
+    bool Thrown = false;
+    uint16_t Texel = 0;
+    float Values[4];
+    try {
+      detail::convertReadData(image_channel_order::rgb,
+                              image_channel_type::unorm_short_565, &Texel,
+                              Values, 1);
+    } catch (feature_not_supported &) {
+      Thrown = true;
+    }
+    assert(Thrown);
+  }
+
+  return 0;
+}
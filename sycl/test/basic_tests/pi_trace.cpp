@@ -0,0 +1,45 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_BE_TRACE=1 %CPU_RUN_PLACEHOLDER %t.out %CPU_CHECK_PLACEHOLDER
+// RUN: env SYCL_BE_TRACE=1 %GPU_RUN_PLACEHOLDER %t.out %GPU_CHECK_PLACEHOLDER
+// RUN: env SYCL_BE_TRACE=1 %ACC_RUN_PLACEHOLDER %t.out %ACC_CHECK_PLACEHOLDER
+//==---------- pi_trace.cpp - SYCL back-end calls tracing test -------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The buffer creation, the kernel launch and the wait for it are all traced
+// with their arguments and results.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+int main() {
+  int Data[4] = {0};
+  {
+    buffer<int, 1> Buf(Data, range<1>(4));
+    queue Queue;
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::write>(CGH);
+      CGH.parallel_for<class pi_trace_kernel>(
+          range<1>(4), [=](id<1> Idx) { Acc[Idx] = Idx[0]; });
+    });
+    Queue.wait();
+  }
+  for (int I = 0; I < 4; ++I)
+    assert(Data[I] == I);
+  return 0;
+}
+
+// CHECK: PI ---> clCreateBuffer({{.+}})
+// CHECK-NEXT: PI <--- 0x{{[0-9a-f]+}}
+// CHECK: PI ---> clSetKernelArg({{.+}})
+// CHECK-NEXT: PI <--- 0
+// CHECK: PI ---> clEnqueueNDRangeKernel({{.+}})
+// CHECK-NEXT: PI <--- 0
+// CHECK: PI ---> clWaitForEvents({{.+}})
@@ -0,0 +1,66 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+//==------------ queue_in_order.cpp - SYCL in-order queue test ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+int main() {
+  constexpr size_t N = 16;
+  constexpr unsigned NumIterations = 64;
+
+  unsigned Data[N] = {0};
+  int Other[N] = {0};
+  {
+    queue Queue{property_list{property::queue::in_order()}};
+    assert(Queue.has_property<property::queue::in_order>());
+
+    buffer<unsigned, 1> Buf(Data, range<1>(N));
+    buffer<int, 1> OtherBuf(Other, range<1>(N));
+    for (unsigned I = 0; I < NumIterations; ++I) {
+      // The result depends on the order the kernels are executed in.
+      Queue.submit([&](handler &CGH) {
+        auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+        CGH.parallel_for<class in_order_update>(
+            range<1>(N), [=](id<1> Idx) { Acc[Idx] = Acc[Idx] * 3 + I; });
+      });
+      Queue.submit([&](handler &CGH) {
+        auto Acc = OtherBuf.get_access<access::mode::read_write>(CGH);
+        CGH.parallel_for<class in_order_other>(range<1>(N),
+                                               [=](id<1> Idx) { Acc[Idx]++; });
+      });
+    }
+
+    // The commands working with the buffer on another queue still wait for
+    // the in-order queue ones through the events.
+    queue OtherQueue;
+    OtherQueue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class in_order_other_queue>(
+          range<1>(N), [=](id<1> Idx) { Acc[Idx] -= 1; });
+    });
+    Queue.wait();
+  }
+
+  unsigned Expected = 0;
+  for (unsigned I = 0; I < NumIterations; ++I)
+    Expected = Expected * 3 + I;
+  Expected -= 1;
+  for (size_t I = 0; I < N; ++I) {
+    assert(Data[I] == Expected);
+    assert(Other[I] == static_cast<int>(NumIterations));
+  }
+  return 0;
+}
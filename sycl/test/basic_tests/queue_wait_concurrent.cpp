@@ -0,0 +1,62 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl -lpthread
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+//==--- queue_wait_concurrent.cpp - Submitting and waiting from threads ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Several threads submit to one queue, which is waited for at the same time
+// by another thread. There are enough submissions for the queue to retire
+// the completed events on its own.
+
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+using namespace cl::sycl;
+
+int main() {
+  constexpr size_t NumThreads = 4;
+  constexpr size_t NumIterations = 512;
+
+  queue Queue;
+  int Counters[NumThreads] = {0};
+  {
+    buffer<int, 1> Buf(Counters, range<1>(NumThreads));
+    std::atomic<bool> Done{false};
+
+    std::thread Waiter([&]() {
+      while (!Done.load())
+        Queue.wait();
+    });
+
+    std::vector<std::thread> Submitters;
+    for (size_t T = 0; T < NumThreads; ++T)
+      Submitters.emplace_back([&, T]() {
+        for (size_t I = 0; I < NumIterations; ++I)
+          Queue.submit([&](handler &CGH) {
+            auto Acc = Buf.get_access<access::mode::read_write>(
+                CGH, range<1>(1), id<1>(T));
+            CGH.single_task<class queue_wait_increment>(
+                [=]() { Acc[0] += 1; });
+          });
+      });
+    for (std::thread &Submitter : Submitters)
+      Submitter.join();
+    Done = true;
+    Waiter.join();
+    Queue.wait();
+  }
+
+  for (size_t T = 0; T < NumThreads; ++T)
+    assert(Counters[T] == static_cast<int>(NumIterations));
+  return 0;
+}
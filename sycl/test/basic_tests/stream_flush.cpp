@@ -0,0 +1,61 @@
+// RUN: %clang -std=c++11 -fsycl -lstdc++ %s -o %t.out -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out | FileCheck %s
+// RUN: %GPU_RUN_PLACEHOLDER %t.out %GPU_CHECK_PLACEHOLDER
+// RUN: %ACC_RUN_PLACEHOLDER %t.out %ACC_CHECK_PLACEHOLDER
+//==------------- stream_flush.cpp - SYCL stream flush test ----------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The stream output is printed in the submission order of the kernels by the
+// time the queue is waited for. After the output overflows the stream buffer
+// the rest of the kernel output is dropped. The output of a kernel is also
+// printed by the time its event is waited for.
+
+#include <CL/sycl.hpp>
+
+#include <cstdio>
+
+using namespace cl::sycl;
+
+int main() {
+  queue Queue;
+  Queue.submit([&](handler &CGH) {
+    stream Out(1024, 80, CGH);
+    CGH.single_task<class stream_flush_first>([=]() { Out << "First\n"; });
+  });
+  Queue.submit([&](handler &CGH) {
+    stream Out(1024, 80, CGH);
+    CGH.single_task<class stream_flush_empty>([=]() {});
+  });
+  Queue.submit([&](handler &CGH) {
+    stream Out(16, 16, CGH);
+    CGH.single_task<class stream_flush_overflow>([=]() {
+      Out << "Fits\n";
+      Out << "Does not fit in the buffer\n";
+      Out << "End\n";
+    });
+  });
+  Queue.wait();
+  std::printf("Waited\n");
+  std::fflush(stdout);
+
+  event Event = Queue.submit([&](handler &CGH) {
+    stream Out(1024, 80, CGH);
+    CGH.single_task<class stream_flush_event>([=]() { Out << "Event\n"; });
+  });
+  Event.wait();
+  std::printf("Event waited\n");
+  std::fflush(stdout);
+  return 0;
+}
+
+// CHECK: First
+// CHECK-NEXT: Fits
+// CHECK-NOT: End
+// CHECK-NEXT: Waited
+// CHECK-NEXT: Event
+// CHECK-NEXT: Event waited
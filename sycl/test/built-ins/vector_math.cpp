@@ -202,5 +202,45 @@ int main() {
     assert(i2 == -1); // tgamma of -2.4 is ~-1.1080299470333461
   }
 
+  // fma float8
+  {
+    s::cl_float8 r{ 0 };
+    {
+      s::buffer<s::cl_float8, 1> BufR(&r, s::range<1>(1));
+      s::queue myQueue;
+      myQueue.submit([&](s::handler &cgh) {
+        auto AccR = BufR.get_access<s::access::mode::write>(cgh);
+        cgh.single_task<class fmaF8F8F8>([=]() {
+          s::cl_float8 x{ 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f };
+          AccR[0] = s::fma(x, s::cl_float8{ 2.f }, s::cl_float8{ 1.f });
+        });
+      });
+    }
+    s::cl_float Expected[8] = { 1.f, 3.f, 5.f, 7.f, 9.f, 11.f, 13.f, 15.f };
+    assert(r.s0() == Expected[0] && r.s1() == Expected[1]);
+    assert(r.s2() == Expected[2] && r.s3() == Expected[3]);
+    assert(r.s4() == Expected[4] && r.s5() == Expected[5]);
+    assert(r.s6() == Expected[6] && r.s7() == Expected[7]);
+  }
+
+  // fmax float16
+  {
+    s::cl_float16 r{ 0 };
+    {
+      s::buffer<s::cl_float16, 1> BufR(&r, s::range<1>(1));
+      s::queue myQueue;
+      myQueue.submit([&](s::handler &cgh) {
+        auto AccR = BufR.get_access<s::access::mode::write>(cgh);
+        cgh.single_task<class fmaxF16F16>([=]() {
+          s::cl_float16 x{ 0.f, 1.f, 2.f,  3.f,  4.f,  5.f,  6.f,  7.f,
+                           8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f };
+          AccR[0] = s::fmax(x, s::cl_float16{ 7.5f });
+        });
+      });
+    }
+    assert(r.s0() == 7.5f && r.s7() == 7.5f);
+    assert(r.s8() == 8.f && r.sF() == 15.f);
+  }
+
   return 0;
 }
@@ -0,0 +1,53 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl -lpthread
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+
+//==--- concurrent_build.cpp - SYCL program manager concurrent build test --==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl.hpp>
+#include <CL/sycl/detail/os_util.hpp>
+#include <CL/sycl/detail/program_manager/program_manager.hpp>
+
+#include <cassert>
+#include <thread>
+#include <vector>
+
+using namespace cl::sycl;
+
+int main() {
+  constexpr size_t NumContexts = 2;
+  constexpr size_t NumThreads = 8;
+  context Contexts[NumContexts];
+  cl_program Programs[NumThreads] = {nullptr};
+
+  auto &PM = detail::ProgramManager::getInstance();
+  auto M = detail::OSUtil::ExeModuleHandle;
+
+  // Threads requesting the program for the same context must all get the
+  // single program built once, threads of different contexts build their own.
+  std::vector<std::thread> Threads;
+  for (size_t I = 0; I < NumThreads; ++I)
+    Threads.emplace_back([&, I]() {
+      Programs[I] = PM.getBuiltOpenCLProgram(M, Contexts[I % NumContexts]);
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (size_t I = 0; I < NumThreads; ++I) {
+    assert(Programs[I] != nullptr);
+    assert(Programs[I] == Programs[I % NumContexts]);
+  }
+  assert(Programs[0] != Programs[1]);
+
+  queue q;
+  q.submit([&](handler &cgh) { cgh.single_task<class foo>([]() {}); });
+
+  return 0;
+}
@@ -0,0 +1,42 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: rm -rf %t.cache
+// RUN: env SYCL_CACHE_DIR=%t.cache %CPU_RUN_PLACEHOLDER %t.out
+// RUN: env SYCL_CACHE_DIR=%t.cache %CPU_RUN_PLACEHOLDER %t.out
+// RUN: env SYCL_CACHE_DIR=%t.cache %GPU_RUN_PLACEHOLDER %t.out
+// RUN: env SYCL_CACHE_DIR=%t.cache %GPU_RUN_PLACEHOLDER %t.out
+// RUN: env SYCL_CACHE_DIR=%t.cache SYCL_CACHE_MAX_SIZE=0 %CPU_RUN_PLACEHOLDER %t.out
+
+//==--- persistent_device_code_cache.cpp - SYCL persistent cache test ------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The first run of each device populates the cache, the second one builds the
+// program from the cached native binary. Both must produce the same results.
+// The last run checks that the eviction of all entries doesn't break anything.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+int main() {
+  constexpr size_t N = 16;
+  int Data[N] = {0};
+  {
+    queue Queue;
+    buffer<int, 1> Buf(Data, range<1>(N));
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::write>(CGH);
+      CGH.parallel_for<class persistent_cache_kernel>(
+          range<1>(N), [=](id<1> I) { Acc[I] = I[0] * 2; });
+    });
+  }
+  for (size_t I = 0; I < N; ++I)
+    assert(Data[I] == static_cast<int>(I * 2) && "Wrong result");
+  return 0;
+}
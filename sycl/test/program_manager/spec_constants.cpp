@@ -0,0 +1,77 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+
+//==--- spec_constants.cpp - SYCL specialization constants test ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl.hpp>
+#include <CL/sycl/detail/os_util.hpp>
+#include <CL/sycl/detail/program_manager/program_manager.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+constexpr unsigned int SpecId = 7;
+
+template <typename T> detail::SpecConstantValues makeValues(T Value) {
+  const char *Bytes = reinterpret_cast<const char *>(&Value);
+  detail::SpecConstantValues Values;
+  Values[SpecId].assign(Bytes, Bytes + sizeof(T));
+  return Values;
+}
+
+int runWith(queue &Q, int Value) {
+  int Result = 0;
+  {
+    buffer<int, 1> Buf(&Result, range<1>(1));
+    Q.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::write>(CGH);
+      auto Spec = CGH.set_spec_constant<SpecId>(Value);
+      CGH.single_task<class spec_const_kernel>([=]() { Acc[0] = Spec.get(); });
+    });
+  }
+  return Result;
+}
+
+int main() {
+  queue Q;
+
+  // Each launch sees the value it has been given, not the default one nor the
+  // value of a previous launch.
+  assert(runWith(Q, 1) == 1);
+  assert(runWith(Q, 2) == 2);
+  assert(runWith(Q, 1) == 1);
+
+  if (Q.is_host())
+    return 0;
+
+  // The programs specialized for distinct values are built and cached
+  // separately, the same values always giving the same program.
+  auto &PM = detail::ProgramManager::getInstance();
+  auto M = detail::OSUtil::ExeModuleHandle;
+  context Context = Q.get_context();
+
+  const cl_program ProgramOne =
+      PM.getBuiltOpenCLProgram(M, Context, "", makeValues(1));
+  const cl_program ProgramTwo =
+      PM.getBuiltOpenCLProgram(M, Context, "", makeValues(2));
+  assert(ProgramOne != ProgramTwo);
+  for (size_t I = 0; I < 10; ++I) {
+    assert(PM.getBuiltOpenCLProgram(M, Context, "", makeValues(1)) ==
+           ProgramOne);
+    assert(PM.getBuiltOpenCLProgram(M, Context, "", makeValues(2)) ==
+           ProgramTwo);
+  }
+  assert(PM.getBuiltOpenCLProgram(M, Context) != ProgramOne);
+  assert(PM.getBuiltOpenCLProgram(M, Context) != ProgramTwo);
+
+  return 0;
+}
@@ -0,0 +1,57 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_ASYNC_ENQUEUE=1 SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: env SYCL_ASYNC_ENQUEUE=1 %CPU_RUN_PLACEHOLDER %t.out
+// RUN: env SYCL_ASYNC_ENQUEUE=1 %GPU_RUN_PLACEHOLDER %t.out
+// RUN: env SYCL_ASYNC_ENQUEUE=0 %CPU_RUN_PLACEHOLDER %t.out
+//===- AsyncEnqueue.cpp - Test asynchronous enqueue of commands -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Commands submitted in the asynchronous mode must still be executed in the
+// dependency order, and the results must be available through events, host
+// accessors and buffer destruction.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+int main() {
+  constexpr size_t N = 32;
+  constexpr int NumKernels = 10;
+  int Data[N] = {0};
+  {
+    queue Queue;
+    buffer<int, 1> Buf(Data, range<1>(N));
+    event LastEvent;
+    for (int I = 0; I < NumKernels; ++I)
+      LastEvent = Queue.submit([&](handler &CGH) {
+        auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+        CGH.parallel_for<class async_enqueue_inc>(
+            range<1>(N), [=](id<1> Idx) { Acc[Idx] = Acc[Idx] * 2 + 1; });
+      });
+    LastEvent.wait();
+
+    {
+      auto HostAcc = Buf.get_access<access::mode::read_write>();
+      for (size_t I = 0; I < N; ++I) {
+        assert(HostAcc[I] == (1 << NumKernels) - 1);
+        HostAcc[I] = 0;
+      }
+    }
+
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class async_enqueue_set>(
+          range<1>(N), [=](id<1> Idx) { Acc[Idx] += Idx[0]; });
+    });
+  }
+  for (size_t I = 0; I < N; ++I)
+    assert(Data[I] == static_cast<int>(I));
+  return 0;
+}
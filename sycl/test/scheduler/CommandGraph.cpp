@@ -0,0 +1,93 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+//===- CommandGraph.cpp - Test recording and replaying command groups -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+constexpr size_t N = 32;
+
+// The value is the first field, so it is the kernel argument with index 0.
+class AddKernel {
+public:
+  AddKernel(int Val, accessor<int, 1, access::mode::read_write,
+                              access::target::global_buffer>
+                         Acc)
+      : MVal(Val), MAcc(Acc) {}
+
+  void operator()(id<1> Idx) const { MAcc[Idx] += MVal; }
+
+private:
+  int MVal;
+  accessor<int, 1, access::mode::read_write, access::target::global_buffer>
+      MAcc;
+};
+
+int main() {
+  int Data[N] = {0};
+  int Copy[N] = {0};
+  {
+    queue Queue;
+    buffer<int, 1> Buf(Data, range<1>(N));
+    buffer<int, 1> CopyBuf(Copy, range<1>(N));
+
+    intel::command_graph Graph;
+    Graph.begin_recording(Queue);
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for(range<1>(N), AddKernel(1, Acc));
+    });
+    Queue.submit([&](handler &CGH) {
+      auto Src = Buf.get_access<access::mode::read>(CGH);
+      auto Dst = CopyBuf.get_access<access::mode::write>(CGH);
+      CGH.parallel_for<class command_graph_copy>(
+          range<1>(N), [=](id<1> Idx) { Dst[Idx] = Src[Idx]; });
+    });
+    Graph.end_recording();
+    assert(Graph.size() == 2);
+
+    // Data is 1 after the recording, each replay adds 1 more.
+    for (int I = 0; I < 3; ++I)
+      Graph.replay();
+
+    // Work submitted in between the replays is ordered with them.
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class command_graph_double>(
+          range<1>(N), [=](id<1> Idx) { Acc[Idx] *= 2; });
+    });
+
+    Graph.set_arg(0, 0, 10);
+    Graph.replay().wait();
+
+    auto Acc = CopyBuf.get_access<access::mode::read>();
+    for (size_t I = 0; I < N; ++I)
+      assert(Acc[I] == 4 * 2 + 10);
+
+    bool Thrown = false;
+    try {
+      Graph.set_arg(1, 0, 10);
+    } catch (invalid_parameter_error &) {
+      Thrown = true;
+    }
+    assert(Thrown && "Accessors can't be set as arguments");
+  }
+
+  for (size_t I = 0; I < N; ++I) {
+    assert(Data[I] == 4 * 2 + 10);
+    assert(Copy[I] == 4 * 2 + 10);
+  }
+  return 0;
+}
@@ -0,0 +1,50 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST SYCL_COMMAND_TRACE_FILE=%t.json %t.out
+// RUN: FileCheck %s --input-file %t.json
+//===- CommandTrace.cpp - Test the timeline of the scheduler commands -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Two kernels working with the same buffer are recorded with the allocation
+// they depend on, the second one depends on the first one too.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+int main() {
+  int Data[4] = {0};
+  {
+    buffer<int, 1> Buf(Data, range<1>(4));
+    queue Queue;
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::write>(CGH);
+      CGH.parallel_for<class command_trace_init>(
+          range<1>(4), [=](id<1> Idx) { Acc[Idx] = Idx[0]; });
+    });
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class command_trace_inc>(
+          range<1>(4), [=](id<1> Idx) { Acc[Idx] += 1; });
+    });
+  }
+  for (int I = 0; I < 4; ++I)
+    assert(Data[I] == I + 1);
+  return 0;
+}
+
+// CHECK: {"traceEvents":[
+// CHECK: {"name":"ALLOCA","cat":"enqueue",{{.*}}"args":{"id":[[ALLOCA:[0-9]+]],"queue":"host"}}
+// CHECK: {"name":"ALLOCA done","cat":"completion"
+// CHECK: {"name":"EXEC CG","cat":"enqueue",{{.*}}"args":{"id":[[INIT:[0-9]+]],"queue":"host","kernel":"{{.*}}command_trace_init{{.*}}"}}
+// CHECK: {"name":"dependency",{{.*}}"ph":"s","id":"[[ALLOCA]]_[[INIT]]"
+// CHECK: {"name":"dependency",{{.*}}"ph":"f","bp":"e","id":"[[ALLOCA]]_[[INIT]]"
+// CHECK: {"name":"EXEC CG","cat":"enqueue",{{.*}}"args":{"id":[[INC:[0-9]+]],"queue":"host","kernel":"{{.*}}command_trace_inc{{.*}}"}}
+// CHECK: "id":"[[INIT]]_[[INC]]"
+// CHECK: ]}
@@ -0,0 +1,89 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+//===- DisjointRequirements.cpp - Test deps of disjoint memory regions ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Kernels writing disjoint parts of one buffer, through sub-buffers or ranged
+// accessors, must not depend on each other, while a kernel touching all the
+// parts must depend on all of them.
+
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+using namespace cl::sycl;
+
+static bool dependsOn(event Dependent, event Dependency) {
+  vector_class<event> WaitList = Dependent.get_wait_list();
+  return std::find(WaitList.begin(), WaitList.end(), Dependency) !=
+         WaitList.end();
+}
+
+int main() {
+  constexpr size_t NumParts = 4;
+  constexpr size_t PartSize = 16;
+  constexpr size_t N = NumParts * PartSize;
+
+  std::vector<int> Data(N, 0);
+  std::vector<int> Data2D(N, 0);
+  {
+    queue Queue;
+    buffer<int, 1> Buf(Data.data(), range<1>(N));
+    buffer<int, 2> Buf2D(Data2D.data(), range<2>(NumParts, PartSize));
+
+    std::vector<event> Writers;
+    for (size_t P = 0; P < NumParts; ++P) {
+      buffer<int, 1> SubBuf(Buf, id<1>(P * PartSize), range<1>(PartSize));
+      Writers.push_back(Queue.submit([&](handler &CGH) {
+        auto Acc = SubBuf.get_access<access::mode::write>(CGH);
+        CGH.parallel_for<class disjoint_sub_buffers>(
+            range<1>(PartSize),
+            [=](id<1> I) { Acc[I] = static_cast<int>(P + 1); });
+      }));
+    }
+
+    std::vector<event> Writers2D;
+    for (size_t P = 0; P < NumParts; ++P)
+      Writers2D.push_back(Queue.submit([&](handler &CGH) {
+        auto Acc = Buf2D.get_access<access::mode::write>(
+            CGH, range<2>(1, PartSize), id<2>(P, 0));
+        CGH.parallel_for<class disjoint_ranged_accessors>(
+            range<2>(1, PartSize),
+            [=](id<2> I) { Acc[I] = static_cast<int>(P + 1); });
+      }));
+
+    for (size_t I = 0; I < NumParts; ++I)
+      for (size_t J = 0; J < NumParts; ++J)
+        if (I != J) {
+          assert(!dependsOn(Writers[I], Writers[J]) &&
+                 "Disjoint sub-buffer writers must not depend on each other");
+          assert(!dependsOn(Writers2D[I], Writers2D[J]) &&
+                 "Disjoint accessor writers must not depend on each other");
+        }
+
+    event Reader = Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class disjoint_whole_buffer>(
+          range<1>(N), [=](id<1> I) { Acc[I] *= 10; });
+    });
+    for (event &Writer : Writers)
+      assert(dependsOn(Reader, Writer) &&
+             "Overlapping kernel must depend on all writers");
+  }
+
+  for (size_t I = 0; I < N; ++I) {
+    assert(Data[I] == static_cast<int>(I / PartSize + 1) * 10);
+    assert(Data2D[I] == static_cast<int>(I / PartSize + 1));
+  }
+  return 0;
+}
@@ -0,0 +1,85 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+//==---- MultiDeviceQueue.cpp - Test of a kernel split between devices -----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+using namespace cl::sycl;
+
+int main() {
+  const size_t N = 1024;
+  // All the devices of the platform of the default device.
+  device Device = default_selector().select_device();
+  vector_class<device> Devices =
+      Device.is_host() ? vector_class<device>{Device}
+                       : Device.get_platform().get_devices();
+  intel::multi_device_queue MDQueue(Devices);
+  std::cout << "Running on " << MDQueue.get_devices().size() << " devices"
+            << std::endl;
+
+  buffer<int, 1> BufIn{range<1>(N)};
+  buffer<int, 1> BufOut{range<1>(N)};
+  {
+    auto In = BufIn.get_access<access::mode::discard_write>();
+    for (size_t I = 0; I < N; ++I)
+      In[I] = I;
+  }
+
+  // The second iteration is split by the measured throughput.
+  for (int Iter = 0; Iter < 2; ++Iter) {
+    vector_class<float> Weights = MDQueue.get_weights();
+    float Total = 0;
+    for (float W : Weights)
+      Total += W;
+    assert(std::fabs(Total - 1.0f) < 1e-3f);
+
+    MDQueue.submit(range<1>(N), [&](handler &CGH, range<1> SubRange,
+                                    id<1> Offset) {
+      auto In = BufIn.get_access<access::mode::read>(CGH, SubRange, Offset);
+      auto Out =
+          BufOut.get_access<access::mode::write>(CGH, SubRange, Offset);
+      CGH.parallel_for<class Scale>(
+          SubRange, [=](id<1> I) { Out[I] = In[I] * 2 + Iter; });
+    });
+    MDQueue.wait();
+
+    auto Out = BufOut.get_access<access::mode::read>();
+    for (size_t I = 0; I < N; ++I)
+      assert(Out[I] == int(I * 2 + Iter));
+  }
+
+  // The parts of an nd_range are made of whole work-groups.
+  MDQueue.submit(nd_range<1>(range<1>(N), range<1>(16)),
+                 [&](handler &CGH, nd_range<1> SubRange, id<1> Offset) {
+                   assert(SubRange.get_global_range()[0] % 16 == 0);
+                   auto Out = BufOut.get_access<access::mode::write>(
+                       CGH, SubRange.get_global_range(), Offset);
+                   const size_t Base = Offset[0];
+                   CGH.parallel_for<class Fill>(
+                       SubRange, [=](nd_item<1> Item) {
+                         Out[Item.get_global_id(0)] =
+                             Base + Item.get_global_id(0);
+                       });
+                 });
+  MDQueue.wait();
+
+  auto Out = BufOut.get_access<access::mode::read>();
+  for (size_t I = 0; I < N; ++I)
+    assert(Out[I] == int(I));
+
+  std::cout << "Test passed." << std::endl;
+  return 0;
+}
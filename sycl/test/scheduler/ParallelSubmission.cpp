@@ -0,0 +1,69 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl -lpthread
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+//===- ParallelSubmission.cpp - Test submitting from several threads ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Each thread submits a chain of kernels to its own queue. The threads work
+// with their own buffers and with one buffer shared between all of them, so
+// both the independent and the contended paths of the scheduler are used.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+#include <thread>
+#include <vector>
+
+using namespace cl::sycl;
+
+int main() {
+  constexpr size_t NumThreads = 8;
+  constexpr size_t NumIterations = 16;
+  constexpr size_t N = 64;
+
+  std::vector<int> Results[NumThreads];
+  int Shared[NumThreads] = {0};
+  {
+    buffer<int, 1> SharedBuf(Shared, range<1>(NumThreads));
+
+    auto ThreadFunc = [&](size_t ThreadId) {
+      std::vector<int> &Data = Results[ThreadId];
+      Data.assign(N, 0);
+      queue Queue;
+      {
+        buffer<int, 1> Buf(Data.data(), range<1>(N));
+        for (size_t I = 0; I < NumIterations; ++I) {
+          Queue.submit([&](handler &CGH) {
+            auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+            CGH.parallel_for<class parallel_submission_private>(
+                range<1>(N), [=](id<1> Idx) { Acc[Idx] += 1; });
+          });
+        }
+        Queue.submit([&](handler &CGH) {
+          auto Acc = SharedBuf.get_access<access::mode::read_write>(CGH);
+          CGH.single_task<class parallel_submission_shared>(
+              [=]() { Acc[ThreadId] = static_cast<int>(ThreadId) + 1; });
+        });
+      }
+    };
+
+    std::vector<std::thread> Threads;
+    for (size_t I = 0; I < NumThreads; ++I)
+      Threads.emplace_back(ThreadFunc, I);
+    for (std::thread &T : Threads)
+      T.join();
+  }
+
+  for (size_t T = 0; T < NumThreads; ++T) {
+    assert(Shared[T] == static_cast<int>(T) + 1);
+    for (size_t I = 0; I < N; ++I)
+      assert(Results[T][I] == static_cast<int>(NumIterations));
+  }
+  return 0;
+}
@@ -0,0 +1,90 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: %t.out
+// RUN: env SYCL_GRAPH_OPTIMIZE=0 %t.out
+//===- RedundantCopies.cpp - Test the copies between devices are elided ---===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The buffer is read on two devices in turns, so the copies after the first
+// one are not needed. The data must still be copied once it's modified.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+#include <iostream>
+
+using namespace cl::sycl;
+
+constexpr size_t N = 64;
+
+template <typename Name>
+void sum(queue &Queue, buffer<int, 1> &Buf, buffer<int, 1> &Res,
+         size_t Index) {
+  Queue.submit([&](handler &CGH) {
+    auto In = Buf.get_access<access::mode::read>(CGH);
+    auto Out = Res.get_access<access::mode::write>(CGH);
+    CGH.single_task<Name>([=]() {
+      int Sum = 0;
+      for (size_t I = 0; I < N; ++I)
+        Sum += In[I];
+      Out[Index] = Sum;
+    });
+  });
+}
+
+int main() {
+  host_selector HostSelector;
+  queue HostQueue(HostSelector);
+  queue DevQueue(HostSelector);
+  try {
+    cpu_selector CPUSelector;
+    DevQueue = queue(CPUSelector);
+  } catch (invalid_parameter_error &) {
+    std::cout << "Using 2 host devices." << std::endl;
+  }
+
+  int Data[N];
+  for (size_t I = 0; I < N; ++I)
+    Data[I] = static_cast<int>(I);
+  int Results[5] = {0};
+  int HostSum = 0;
+  {
+    buffer<int, 1> Buf(Data, range<1>(N));
+    buffer<int, 1> Res(Results, range<1>(5));
+
+    sum<class sum_dev_0>(DevQueue, Buf, Res, 0);
+    sum<class sum_host_0>(HostQueue, Buf, Res, 1);
+    sum<class sum_dev_1>(DevQueue, Buf, Res, 2);
+
+    HostQueue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class increment>(range<1>(N),
+                                        [=](id<1> Idx) { Acc[Idx] += 1; });
+    });
+
+    sum<class sum_dev_2>(DevQueue, Buf, Res, 3);
+    sum<class sum_host_1>(HostQueue, Buf, Res, 4);
+
+    {
+      auto Acc = Buf.get_access<access::mode::read>();
+      for (size_t I = 0; I < N; ++I)
+        HostSum += Acc[I];
+    }
+  }
+
+  const int Before = N * (N - 1) / 2;
+  const int After = Before + N;
+  assert(Results[0] == Before);
+  assert(Results[1] == Before);
+  assert(Results[2] == Before);
+  assert(Results[3] == After);
+  assert(Results[4] == After);
+  assert(HostSum == After);
+  for (size_t I = 0; I < N; ++I)
+    assert(Data[I] == static_cast<int>(I) + 1);
+  return 0;
+}
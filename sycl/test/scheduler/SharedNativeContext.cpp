@@ -0,0 +1,54 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_BE_TRACE=1 %CPU_RUN_PLACEHOLDER %t.out %CPU_CHECK_PLACEHOLDER
+//===- SharedNativeContext.cpp - Test contexts wrapping one OpenCL context ===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Queues of two SYCL contexts created over the same OpenCL context share the
+// buffer allocation, so no data goes through the host between their kernels.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+constexpr int N = 16;
+
+int main() {
+  int Data[N] = {0};
+  {
+    queue Queue1{cpu_selector()};
+    cl_context ClContext = Queue1.get_context().get();
+    context Context2(ClContext);
+    clReleaseContext(ClContext);
+    queue Queue2(Context2, cpu_selector());
+
+    buffer<int, 1> Buf{range<1>(N)};
+    Queue1.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::write>(CGH);
+      CGH.parallel_for<class shared_ctx_init>(
+          range<1>(N), [=](id<1> Idx) { Acc[Idx] = Idx[0]; });
+    });
+    Queue2.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.parallel_for<class shared_ctx_inc>(
+          range<1>(N), [=](id<1> Idx) { Acc[Idx] += 1; });
+    });
+
+    auto HostAcc = Buf.get_access<access::mode::read>();
+    for (int I = 0; I < N; ++I)
+      assert(HostAcc[I] == I + 1);
+  }
+  return 0;
+}
+
+// CHECK: PI ---> clEnqueueNDRangeKernel({{.+}})
+// CHECK-NOT: clEnqueueReadBuffer
+// CHECK-NOT: clEnqueueWriteBuffer
+// CHECK-NOT: clCreateUserEvent
+// CHECK: PI ---> clEnqueueNDRangeKernel({{.+}})
@@ -0,0 +1,57 @@
+// >> ---- compile device and host code
+// RUN: %clang -std=c++11 --sycl -Xclang -fsycl-int-header=%t_ihdr.h %s -c -o %t_kernel.bc
+// RUN: %clang -std=c++11 -include %t_ihdr.h -g -c %s -o %t.o
+//
+// >> ---- split device code per kernel
+// RUN: sycl-split %t_kernel.bc -o %t_split
+// RUN: llvm-spirv -o=%t_split_0.spv %t_split_0.bc
+// RUN: llvm-spirv -o=%t_split_1.spv %t_split_1.bc
+//
+// >> ---- wrap the device images with the names of their kernels
+// RUN: clang-offload-wrapper -o %t_wrapper.bc -host=x86_64-pc-linux-gnu -kind=sycl -format=spirv \
+// RUN:   -entries=%t_split_0.sym %t_split_0.spv -entries=%t_split_1.sym %t_split_1.spv
+// RUN: llc -filetype=obj %t_wrapper.bc -o %t_wrapper.o
+//
+// >> ---- link the full hetero app
+// RUN: %clang %t_wrapper.o %t.o -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+
+//==--------- split.cpp - Tests SYCL device code split per kernel ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Every kernel is in a device image of its own, the program of a kernel is
+// built from the image listing it in its entries.
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+
+using namespace cl::sycl;
+
+template <typename KernelName> int run(int Factor) {
+  int Val = 10;
+  {
+    queue Queue;
+    buffer<int, 1> Buf(&Val, 1);
+    Queue.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.single_task<KernelName>([=]() { Acc[0] *= Factor; });
+    });
+  }
+  return Val;
+}
+
+int main() {
+  assert(run<class kernel_a>(2) == 20);
+  assert(run<class kernel_b>(3) == 30);
+  // The program built for the first kernel is reused.
+  assert(run<class kernel_a>(4) == 40);
+  return 0;
+}
@@ -0,0 +1,118 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+//==-------- group_collectives.cpp - SYCL work-group reduce and scan -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "helper.hpp"
+#include <CL/sycl.hpp>
+template <typename T> class sycl_group_builtin;
+template <typename T> class sycl_group_custom;
+using namespace cl::sycl;
+
+template <typename T> struct Add {
+  T operator()(T x, T y) const { return x + y; }
+};
+
+// The work-groups are small enough for the host device to run each of them
+// as a single sub-group.
+template <typename T> void check(queue &Queue, size_t G = 64, size_t L = 8) {
+  try {
+    nd_range<1> NdRange(G, L);
+    buffer<T> redbuf(G);
+    buffer<T> minbuf(G);
+    buffer<T> exbuf(G);
+    buffer<T> inbuf(G);
+    Queue.submit([&](handler &cgh) {
+      auto redacc = redbuf.template get_access<access::mode::read_write>(cgh);
+      auto minacc = minbuf.template get_access<access::mode::read_write>(cgh);
+      auto exacc = exbuf.template get_access<access::mode::read_write>(cgh);
+      auto inacc = inbuf.template get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<sycl_group_builtin<T>>(NdRange, [=](nd_item<1> NdItem) {
+        T x = T(NdItem.get_global_id(0));
+        redacc[NdItem.get_global_id()] = intel::reduce<intel::plus>(NdItem, x);
+        minacc[NdItem.get_global_id()] =
+            intel::reduce<intel::minimum>(NdItem, x);
+        exacc[NdItem.get_global_id()] =
+            intel::exclusive_scan<intel::plus>(NdItem, x);
+        inacc[NdItem.get_global_id()] =
+            intel::inclusive_scan<intel::plus>(NdItem, x);
+      });
+    });
+    auto redacc = redbuf.template get_access<access::mode::read_write>();
+    auto minacc = minbuf.template get_access<access::mode::read_write>();
+    auto exacc = exbuf.template get_access<access::mode::read_write>();
+    auto inacc = inbuf.template get_access<access::mode::read_write>();
+    for (size_t j = 0; j < G; j++) {
+      size_t First = j - j % L;
+      T Total = 0, Prefix = 0;
+      for (size_t i = First; i < First + L; i++) {
+        Total += T(i);
+        if (i < j)
+          Prefix += T(i);
+      }
+      exit_if_not_equal<T>(redacc[j], Total, "reduce_add");
+      exit_if_not_equal<T>(minacc[j], T(First), "reduce_min");
+      exit_if_not_equal<T>(exacc[j], Prefix, "exclusive_scan_add");
+      exit_if_not_equal<T>(inacc[j], Prefix + T(j), "inclusive_scan_add");
+    }
+
+    // The same with an operation that has no group instruction, combined
+    // through sub-group shuffles and local memory.
+    Queue.submit([&](handler &cgh) {
+      auto redacc = redbuf.template get_access<access::mode::read_write>(cgh);
+      auto exacc = exbuf.template get_access<access::mode::read_write>(cgh);
+      auto inacc = inbuf.template get_access<access::mode::read_write>(cgh);
+      accessor<T, 1, access::mode::read_write, access::target::local> Scratch(
+          range<1>(L), cgh);
+      cgh.parallel_for<sycl_group_custom<T>>(NdRange, [=](nd_item<1> NdItem) {
+        T x = T(NdItem.get_global_id(0));
+        redacc[NdItem.get_global_id()] =
+            intel::reduce(NdItem, x, T(0), Add<T>(), Scratch.get_pointer());
+        exacc[NdItem.get_global_id()] = intel::exclusive_scan(
+            NdItem, x, T(0), Add<T>(), Scratch.get_pointer());
+        inacc[NdItem.get_global_id()] = intel::inclusive_scan(
+            NdItem, x, T(0), Add<T>(), Scratch.get_pointer());
+      });
+    });
+    redacc = redbuf.template get_access<access::mode::read_write>();
+    exacc = exbuf.template get_access<access::mode::read_write>();
+    inacc = inbuf.template get_access<access::mode::read_write>();
+    for (size_t j = 0; j < G; j++) {
+      size_t First = j - j % L;
+      T Total = 0, Prefix = 0;
+      for (size_t i = First; i < First + L; i++) {
+        Total += T(i);
+        if (i < j)
+          Prefix += T(i);
+      }
+      exit_if_not_equal<T>(redacc[j], Total, "custom_reduce");
+      exit_if_not_equal<T>(exacc[j], Prefix, "custom_exclusive_scan");
+      exit_if_not_equal<T>(inacc[j], Prefix + T(j), "custom_inclusive_scan");
+    }
+  } catch (exception e) {
+    std::cout << "SYCL exception caught: " << e.what();
+    exit(1);
+  }
+}
+
+int main() {
+  queue Queue;
+  if (!core_sg_supported(Queue.get_device())) {
+    std::cout << "Skipping test\n";
+    return 0;
+  }
+  check<int>(Queue);
+  check<unsigned int>(Queue);
+  check<long>(Queue);
+  check<float>(Queue);
+  std::cout << "Test passed." << std::endl;
+  return 0;
+}
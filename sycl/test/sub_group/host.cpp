@@ -0,0 +1,75 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+//==----------- host.cpp - SYCL sub_group on host device test --*- C++ -*---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The work-items of a host sub-group run in lockstep, so the collectives see
+// the values of all the work-items of the sub-group, the last sub-group of a
+// work-group being smaller.
+
+#include "helper.hpp"
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+
+using namespace cl::sycl;
+
+int main() {
+  queue Queue;
+  if (!Queue.is_host()) {
+    std::cout << "Skipping test\n";
+    return 0;
+  }
+
+  const size_t G = 60, L = 20;
+  buffer<size_t, 2> Buf(range<2>(G, 8));
+  Queue.submit([&](handler &CGH) {
+    auto Acc = Buf.get_access<access::mode::write>(CGH);
+    CGH.parallel_for<class host_sub_group>(
+        nd_range<1>(G, L), [=](nd_item<1> NdItem) {
+          intel::sub_group SG = NdItem.get_sub_group();
+          const size_t GID = NdItem.get_global_id(0);
+          Acc[GID][0] = SG.get_local_range().get(0);
+          Acc[GID][1] = SG.reduce<size_t, intel::plus>(GID);
+          Acc[GID][2] = SG.inclusive_scan<size_t, intel::plus>(GID);
+          Acc[GID][3] = SG.exclusive_scan<size_t, intel::maximum>(GID);
+          Acc[GID][4] = SG.broadcast(GID, id<1>(1));
+          SG.barrier();
+          Acc[GID][5] = SG.shuffle_up(GID, 1);
+          Acc[GID][6] = SG.shuffle_xor(GID, id<1>(1));
+          Acc[GID][7] = SG.all(GID % L < L - 1);
+        });
+  });
+
+  auto Acc = Buf.get_access<access::mode::read>();
+  const size_t SGSize = 8;
+  for (size_t GID = 0; GID < G; ++GID) {
+    const size_t First = GID - GID % L % SGSize;
+    const size_t Size = std::min(SGSize, L - First % L);
+    const size_t LID = GID - First;
+    size_t Sum = 0;
+    for (size_t I = First; I < First + Size; ++I)
+      Sum += I;
+    exit_if_not_equal<size_t>(Acc[GID][0], Size, "local_range");
+    exit_if_not_equal<size_t>(Acc[GID][1], Sum, "reduce");
+    exit_if_not_equal<size_t>(Acc[GID][2], (First + GID) * (LID + 1) / 2,
+                              "inclusive_scan");
+    exit_if_not_equal<size_t>(Acc[GID][3], LID ? GID - 1 : 0,
+                              "exclusive_scan");
+    exit_if_not_equal<size_t>(Acc[GID][4], First + 1, "broadcast");
+    exit_if_not_equal<size_t>(Acc[GID][5], LID ? GID - 1 : First + Size - 1,
+                              "shuffle_up");
+    exit_if_not_equal<size_t>(Acc[GID][6],
+                              (LID ^ 1) < Size ? First + (LID ^ 1) : GID,
+                              "shuffle_xor");
+    exit_if_not_equal<size_t>(Acc[GID][7], First + Size != GID - GID % L + L,
+                              "all");
+  }
+  std::cout << "Test passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,80 @@
+// RUN: %clang -std=c++11 -fsycl %s -o %t.out -lstdc++ -lOpenCL -lsycl
+// RUN: env SYCL_DEVICE_TYPE=HOST %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+//==---------------- usm.cpp - SYCL unified shared memory test -------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <CL/sycl.hpp>
+
+#include <cassert>
+#include <iostream>
+
+using namespace cl::sycl;
+
+int main() {
+  constexpr size_t N = 64;
+  queue Queue;
+  context Context = Queue.get_context();
+
+  int *Shared = nullptr;
+  int *Device = nullptr;
+  try {
+    Shared = malloc_shared<int>(N, Queue);
+    Device = malloc_device<int>(N, Queue);
+  } catch (feature_not_supported &) {
+    std::cout << "Skipping test\n";
+    return 0;
+  }
+  if (!Shared || !Device) {
+    std::cout << "Skipping test\n";
+    free(Shared, Queue);
+    free(Device, Queue);
+    return 0;
+  }
+
+  assert(get_pointer_type(Shared, Context) == usm::alloc::shared);
+  assert(get_pointer_type(Shared + N - 1, Context) == usm::alloc::shared);
+  assert(get_pointer_type(Device, Context) == usm::alloc::device);
+  int Local = 0;
+  assert(get_pointer_type(&Local, Context) == usm::alloc::unknown);
+
+  // The command groups use no accessors, the order of their execution is
+  // given by the events only.
+  event Fill = Queue.memset(Device, 0, N * sizeof(int));
+  event Init = Queue.submit([&](handler &CGH) {
+    CGH.depends_on(Fill);
+    CGH.parallel_for<class usm_init>(range<1>(N), [=](id<1> I) {
+      Device[I[0]] += static_cast<int>(I[0]);
+    });
+  });
+  event Copy = Queue.submit([&](handler &CGH) {
+    CGH.depends_on(Init);
+    CGH.memcpy(Shared, Device, N * sizeof(int));
+  });
+  Queue.submit([&](handler &CGH) {
+    CGH.depends_on(Copy);
+    CGH.parallel_for<class usm_double>(
+        range<1>(N), [=](id<1> I) { Shared[I[0]] *= 2; });
+  });
+  Queue.wait();
+
+  for (size_t I = 0; I < N; ++I) {
+    if (Shared[I] != static_cast<int>(2 * I)) {
+      std::cout << "Wrong value at " << I << ": " << Shared[I] << std::endl;
+      return 1;
+    }
+  }
+
+  free(Shared, Queue);
+  free(Device, Queue);
+  assert(get_pointer_type(Shared, Context) == usm::alloc::unknown);
+  std::cout << "Test passed." << std::endl;
+  return 0;
+}